@@ -9,4 +9,21 @@ namespace onnxruntime {
 // Return true if SSE3 instruction is supported, otherwise return false.
 bool SetDenormalAsZero(bool on);
 
+// Sets flush-to-zero and denormal-as-zero on the current thread for the lifetime of the scope if on is true and they
+// are not set yet, and restores the previous mode on destruction. Does nothing if on is false or SSE3 instructions
+// are not supported.
+class DenormalAsZeroScope {
+ public:
+  explicit DenormalAsZeroScope(bool on);
+  ~DenormalAsZeroScope();
+
+  DenormalAsZeroScope(const DenormalAsZeroScope&) = delete;
+  DenormalAsZeroScope& operator=(const DenormalAsZeroScope&) = delete;
+
+ private:
+  // unused where the mode cannot be set
+  [[maybe_unused]] unsigned int saved_mode_ = 0;
+  [[maybe_unused]] bool restore_ = false;
+};
+
 }  // namespace onnxruntime
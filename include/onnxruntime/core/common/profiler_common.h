@@ -16,6 +16,7 @@ enum EventCategory {
   NODE_EVENT,
   KERNEL_EVENT,
   API_EVENT,
+  MEMORY_EVENT,  // counters, written as chrome tracing "counter events (C)"
   EVENT_CATEGORY_MAX
 };
 
@@ -24,7 +25,8 @@ static constexpr const char* event_category_names_[EVENT_CATEGORY_MAX] = {
     "Session",
     "Node",
     "Kernel",
-    "Api"};
+    "Api",
+    "Memory"};
 
 // Timing record for all events.
 struct EventRecord {
@@ -20,7 +20,10 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  max_cached_chunk_size_bytes(-1),
+                  use_huge_pages(-1),
+                  prefault_memory(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
               int64_t max_power_of_two_extend_bytes)
@@ -29,7 +32,10 @@ struct OrtArenaCfg {
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        max_cached_chunk_size_bytes(-1),
+        use_huge_pages(-1),
+        prefault_memory(-1) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +43,9 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int max_cached_chunk_size_bytes;        // use -1 to allow ORT to choose the default, 0 disables the small chunk cache
+  int use_huge_pages;                     // use -1 to allow ORT to choose the default (0), 1 = back CPU regions with huge pages
+  int prefault_memory;                    // use -1 to allow ORT to choose the default (0), 1 = touch CPU regions when allocated
 };
 
 namespace onnxruntime {
@@ -89,6 +98,14 @@ class IAllocator {
   // By default, the base implementation  just calls Alloc().
   virtual void* Reserve(size_t size) { return Alloc(size); }
 
+  // Stream ordered allocators, e.g. the ones backed by cudaMallocAsync, order their allocations and frees on the
+  // stream of the value being allocated instead of synchronizing. The framework passes that stream to
+  // AllocOnStreamOrdered() when IsStreamOrdered() returns true, and calls ReleaseStreamOrderedBuffers() once the work
+  // of a stream for a run is done and the stream may be released.
+  virtual bool IsStreamOrdered() const { return false; }
+  virtual void* AllocOnStreamOrdered(size_t size, Stream* /*stream*/) { return Alloc(size); }
+  virtual void ReleaseStreamOrderedBuffers(Stream* /*stream*/) {}
+
   const OrtMemoryInfo& Info() const { return memory_info_; };
 
   // Each implementation of IAllocator can override and provide their own implementation
@@ -61,6 +61,14 @@ enum class DataLayout {
   NCHWC,
 };
 
+/**
+   The buffer of an input or output of a run, see IExecutionProvider::UpdateGraphBuffers().
+*/
+struct GraphBuffer {
+  const void* data;
+  size_t size;
+};
+
 class IExecutionProvider {
  protected:
   IExecutionProvider(const std::string& type)
@@ -207,16 +215,32 @@ class IExecutionProvider {
   virtual bool IsGraphCaptureEnabled() const { return false; }
 
   /**
-     Indicate whether the graph has been captured and instantiated. Currently
-     only CUDA execution provider supports it.
+     Indicate whether the graph for <graph_annotation> has been captured and
+     instantiated. Currently only CUDA execution provider supports it.
+     The annotation identifies one of the graphs captured for different runs,
+     see kOrtRunOptionsConfigCudaGraphAnnotation. It is also available to
+     OnRunStart() and OnRunEnd() through the run options of the run.
    */
-  virtual bool IsGraphCaptured() const { return false; }
+  virtual bool IsGraphCaptured(const std::string& /*graph_annotation*/) const { return false; }
 
   /**
-     Run the instantiated graph. Currently only CUDA execution provider supports
-     it.
+     Run the instantiated graph for <graph_annotation>. Currently only CUDA
+     execution provider supports it.
    */
-  virtual common::Status ReplayGraph() { return Status::OK(); }
+  virtual common::Status ReplayGraph(const std::string& /*graph_annotation*/) { return Status::OK(); }
+
+  /**
+     Bind the graph for <graph_annotation> to the buffers of the inputs then the
+     outputs of the run. The first call after the graph was captured records the
+     buffers it was captured with, the next ones update the instantiated graph in
+     place if the buffers changed, so that the caller doesn't need to copy into the
+     captured buffers. Returns an error if the graph can't be updated.
+     Currently only CUDA execution provider supports it.
+   */
+  virtual common::Status UpdateGraphBuffers(const std::string& /*graph_annotation*/,
+                                            const std::vector<GraphBuffer>& /*buffers*/) {
+    return Status::OK();
+  }
 
   /**
      Called when session creation is complete
@@ -85,6 +85,7 @@ class KernelDef {
 
 #ifdef ENABLE_STRIDED_TENSORS
   const std::vector<int>& MayStridedInput() const { return may_strided_inputs_; }
+  int VariadicMayStridedInputOffset() const { return variadic_may_strided_input_offset_; }
   const std::vector<std::pair<int, int>>& MayStridedOutput() const { return may_strided_output_map_; }
 #endif
 
@@ -145,6 +146,9 @@ class KernelDef {
   // An element i means i-th input can be strided tensor.
   std::vector<int> may_strided_inputs_;
 
+  // All the inputs from this offset can be strided tensors, -1 for none. Used by kernels with variadic inputs.
+  int variadic_may_strided_input_offset_ = -1;
+
   // An element <i, j> means j-th output can be a strided tensor, which share the data from i-th input.
   std::vector<std::pair<int, int>> may_strided_output_map_;
 #endif
@@ -265,6 +269,11 @@ class KernelDefBuilder {
    */
   KernelDefBuilder& MayStridedInput(int input_index);
 
+  /**
+     Specify that all the inputs from input_offset can be strided tensors, for variadic inputs.
+   */
+  KernelDefBuilder& VariadicMayStridedInput(int input_offset);
+
   /**
      Specify that the output_index-th output can be strided tensor, and share the data
      from input_index-th input.
@@ -129,6 +129,14 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to return true if UseSharedPrePackedBuffers() restores all the state that PrePack()
+  // sets up for the given input. PrePack() is then skipped when the pre-packed buffers are loaded from the on-disk
+  // cache (see kOrtSessionOptionsConfigPrepackedWeightsCacheDir). Such buffers are read-only file mappings.
+  // @param input_idx: The input index of the tensor in this kernel
+  virtual bool CanSkipPrePackWithSharedBuffers(int /*input_idx*/) const {
+    return false;
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -5,9 +5,14 @@
 
 #include <string>
 #include <atomic>
+#include <memory>
 #include "core/session/onnxruntime_c_api.h"
 #include "core/framework/config_options.h"
 
+namespace onnxruntime {
+struct RunStats;
+}  // namespace onnxruntime
+
 /**
  * Configuration information for a Run call.
  */
@@ -40,6 +45,15 @@ struct OrtRunOptions {
   // /include/onnxruntime/core/session/onnxruntime_run_options_config_keys.h
   onnxruntime::ConfigOptions config_options;
 
+  // Set to collect the resources used by each Run call using this, see RunStats. The stats are those of the last
+  // Run call, so Run calls that overlap should use different instances. Set by OrtApi::RunOptionsEnableRunStats.
+  std::shared_ptr<onnxruntime::RunStats> run_stats;
+
+  // Set to receive the tokens the generation operators produce at each step of the Run calls using this.
+  // Set by OrtApi::RunOptionsSetGenerationTokensCallback.
+  OrtGenerationTokensCallbackFn generation_tokens_callback = nullptr;
+  void* generation_tokens_callback_user_data = nullptr;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 };
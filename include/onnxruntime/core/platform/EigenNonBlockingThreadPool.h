@@ -9,7 +9,9 @@
 
 /* Modifications Copyright (c) Microsoft. */
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #pragma once
 #include "onnxruntime_config.h"
@@ -54,6 +56,14 @@
 #include "core/platform/ort_spin_lock.h"
 #include "core/platform/Barrier.h"
 
+#include <chrono>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 // ORT thread pool overview
 // ------------------------
 //
@@ -78,6 +88,10 @@
 //
 //   This spin-then-block behavior is configured via a flag provided
 //   when creating the thread pool, and by the constant spin_count.
+//   With adaptive spinning, a worker instead spins for about twice
+//   the average time between the starts of parallel sections, and
+//   blocks right away when sections start less often than the
+//   longest spin.  On Linux, blocked workers wait on a futex.
 //
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
@@ -208,6 +222,20 @@ struct PaddingToAvoidFalseSharing {
 4. Note LogStart must pair with either LogEnd or LogEndAndStart, otherwise ORT_ENFORCE will fail;
 5. ThreadPoolProfiler is thread-safe.
 */
+
+// Partitioning and timing of one loop run by ThreadPool::ParallelForFixedBlockSizeScheduling while profiling.
+// Times are in microseconds.
+struct ParallelLoopStat {
+  uint64_t iterations = 0;
+  uint64_t work_items = 0;             // work items, including the caller's, that ran
+  uint64_t blocks = 0;                 // blocks of iterations claimed
+  uint64_t steals = 0;                 // blocks claimed from a shard other than the work item's home shard
+  double elapsed_us = 0;               // from the start of the loop until all work items joined
+  double join_wait_us = 0;             // time the caller waited for other work items after running out of blocks
+  double imbalance_us = 0;             // time between the first and the last work item running out of blocks
+  std::vector<double> worker_busy_us;  // time spent in the loop body by each work item
+};
+
 #ifdef ORT_MINIMAL_BUILD
 class ThreadPoolProfiler {
  public:
@@ -231,6 +259,8 @@ class ThreadPoolProfiler {
   void LogCoreAndBlock(std::ptrdiff_t){};
   void LogThreadId(int){};
   void LogRun(int){};
+  void LogParallelLoop(const ParallelLoopStat&){};
+  bool Enabled() const { return false; }
   std::string DumpChildThreadStat() { return {}; }
 };
 #else
@@ -257,6 +287,8 @@ class ThreadPoolProfiler {
   void LogCoreAndBlock(std::ptrdiff_t block_size);  // called in main thread to log core and block size for task breakdown
   void LogThreadId(int thread_idx);                 // called in child thread to log its id
   void LogRun(int thread_idx);                      // called in child thread to log num of run
+  void LogParallelLoop(const ParallelLoopStat& stat);  // called in main thread to aggregate the stat of a loop
+  bool Enabled() const { return enabled_; }
   std::string DumpChildThreadStat();                // return all child statitics collected so far
 
  private:
@@ -266,11 +298,15 @@ class ThreadPoolProfiler {
     int32_t core_ = -1;
     std::vector<std::ptrdiff_t> blocks_;  // block size determined by cost model
     std::vector<onnxruntime::TimePoint> points_;
+    uint64_t num_loops_ = 0;
+    ParallelLoopStat loops_;        // sum of the loops run since the last reset
+    double loop_capacity_us_ = 0;  // sum of elapsed time times work items, the busy time of perfectly balanced loops
     void LogCore();
     void LogBlockSize(std::ptrdiff_t block_size);
     void LogStart();
     void LogEnd(ThreadPoolEvent);
     void LogEndAndStart(ThreadPoolEvent);
+    void LogParallelLoop(const ParallelLoopStat& stat);
     std::string Reset();
   };
   bool enabled_ = false;
@@ -339,6 +375,13 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
                              unsigned n, std::ptrdiff_t block_size) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
+  // Loops are only timed per block while profiling, to keep the
+  // overhead off the normal path.
+  virtual bool IsProfiling() const = 0;
+  // NUMA node of the calling thread if it is a worker of this pool
+  // assigned to a node, -1 otherwise.
+  virtual int CurrentThreadNumaNode() const = 0;
+  virtual void LogParallelLoop(const ParallelLoopStat& stat) = 0;
 };
 
 class ThreadPoolParallelSection {
@@ -730,6 +773,14 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return profiler_.Stop();
   }
 
+  bool IsProfiling() const override {
+    return profiler_.Enabled();
+  }
+
+  void LogParallelLoop(const ParallelLoopStat& stat) override {
+    profiler_.LogParallelLoop(stat);
+  }
+
   struct Tag {
     constexpr Tag() : v_(0) {
     }
@@ -774,6 +825,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
+        adaptive_spinning_(allow_spinning && thread_options.adaptive_spinning),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
         blocked_(0),
@@ -790,6 +842,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    InitializeNumaNodes(thread_options);
+
     // Eigen::MaxSizeVector has neither essential exception safety features
     // such as swap, nor it is movable. So we have to join threads right here
     // on exception
@@ -819,6 +873,11 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   void Schedule(std::function<void()> fn) override {
     PerThread* pt = GetPerThread();
     int q_idx = Rand(&pt->rand) % num_threads_;
+    if (!numa_node_workers_.empty() && pt->pool == this && worker_numa_node_[pt->thread_id] >= 0) {
+      // Work scheduled from a worker stays on the worker's NUMA node.
+      const auto& node_workers = numa_node_workers_[worker_numa_node_[pt->thread_id]];
+      q_idx = static_cast<int>(node_workers[Rand(&pt->rand) % node_workers.size()]);
+    }
     WorkerData& td = worker_data_[q_idx];
     Queue& q = td.queue;
     fn = q.PushBack(std::move(fn));
@@ -852,6 +911,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     if (!pt.tag.Get()) {
       pt.tag = Tag::GetNext();
     }
+    if (adaptive_spinning_) {
+      RecordParallelSectionStart();
+    }
     ps.dispatch_q_idx = -1;
     ps.dispatch_started = false;
     ps.dispatch_done = false;
@@ -1324,6 +1386,14 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return -1;
   }
 
+  int CurrentThreadNumaNode() const final {
+    const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
+    if (pt->pool == this && pt->thread_id >= 0) {
+      return worker_numa_node_[pt->thread_id];
+    }
+    return -1;
+  }
+
   void EnableSpinning() {
     spin_loop_status_ = SpinLoopStatus::kBusy;
   }
@@ -1415,12 +1485,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     //    need for mutex / condvar operations in the case where the thread pool
     //    remains busy.
 
-    enum class ThreadStatus : uint8_t {
+    // 32 bits wide so that a blocked thread can wait on its status with a futex
+    enum class ThreadStatus : uint32_t {
       Spinning,  // Spinning in the work loop, and other cases (initialization) where
                  // the thread will soon be in the loop
       Active,    // Running user code, not waiting for work
       Blocking,  // In the process of blocking; may no longer notice work pushed to it
-      Blocked,   // Blocked on cv
+      Blocked,   // Blocked on cv, or on a futex on Linux
       Waking,    // Not yet back in the worker loop, but wake-up notification sent
     };
 
@@ -1438,6 +1509,16 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     // any further.
     void EnsureAwake() {
       ThreadStatus seen = GetStatus();
+#if defined(__linux__)
+      // Without the mutex, a thread that is still Blocking is moved to Waking, so that it does not wait, and a
+      // Blocked thread is moved to Waking before its futex is woken up.
+      while ((seen == ThreadStatus::Blocking || seen == ThreadStatus::Blocked) &&
+             !status.compare_exchange_weak(seen, ThreadStatus::Waking)) {
+      }
+      if (seen == ThreadStatus::Blocked) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&status), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+      }
+#else
       if (seen == ThreadStatus::Blocking ||
           seen == ThreadStatus::Blocked) {
         std::unique_lock<OrtMutex> lk(mutex);
@@ -1453,6 +1534,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           cv.notify_one();
         }
       }
+#endif
     }
 
     // State transitions, called only from the thread itself
@@ -1468,8 +1550,25 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       status = ThreadStatus::Spinning;
     }
 
+    // post_block is run if should_block returned true, once the thread is awake again.
     void SetBlocked(std::function<bool()> should_block,
                     std::function<void()> post_block) {
+#if defined(__linux__)
+      assert(GetStatus() == ThreadStatus::Spinning);
+      status.store(ThreadStatus::Blocking);
+      if (should_block()) {
+        // EnsureAwake may have moved the thread to Waking since it checked its queue, it then does not wait
+        ThreadStatus expected = ThreadStatus::Blocking;
+        if (status.compare_exchange_strong(expected, ThreadStatus::Blocked)) {
+          do {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&status), FUTEX_WAIT_PRIVATE,
+                    static_cast<uint32_t>(ThreadStatus::Blocked), nullptr, nullptr, 0);
+          } while (status.load() == ThreadStatus::Blocked);
+        }
+        post_block();
+      }
+      status.store(ThreadStatus::Spinning, std::memory_order_relaxed);
+#else
       std::unique_lock<OrtMutex> lk(mutex);
       assert(GetStatus() == ThreadStatus::Spinning);
       status.store(ThreadStatus::Blocking, std::memory_order_relaxed);
@@ -1481,23 +1580,33 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         post_block();
       }
       status.store(ThreadStatus::Spinning, std::memory_order_relaxed);
+#endif
     }
 
    private:
     std::atomic<ThreadStatus> status{ThreadStatus::Spinning};
+    static_assert(sizeof(std::atomic<ThreadStatus>) == sizeof(uint32_t), "status must be usable as a futex word");
+#if !defined(__linux__)
     OrtMutex mutex;
     OrtCondVar cv;
+#endif
   };
 
   Environment& env_;
   const unsigned num_threads_;
   const bool allow_spinning_;
   const bool set_denormal_as_zero_;
+  const bool adaptive_spinning_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
+  // NUMA node of each worker, or -1 when unknown.
+  std::vector<int> worker_numa_node_;
+  // Workers of each NUMA node; empty unless the workers run on more than one node.
+  std::vector<std::vector<unsigned>> numa_node_workers_;
+
   // SpinLoopStatus indicates whether the main worker spinning (inner) loop should exit immediately when there is
   // no work available (kIdle) or whether it should follow the configured spin-then-block policy (kBusy).
   // This lets the ORT session layer hint to the thread pool that it should stop spinning in between
@@ -1510,6 +1619,41 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // Default is no control over spinning
   std::atomic<SpinLoopStatus> spin_loop_status_{SpinLoopStatus::kBusy};
 
+  // Adaptive spinning: the longest time a worker spins before blocking, and the longest interval between parallel
+  // sections taken into account, so that an idle period doesn't hold off spinning for long once the pool is busy again.
+  static constexpr int64_t kMaxAdaptiveSpinNs = 1000 * 1000;
+  static constexpr int64_t kMaxParallelSectionIntervalNs = 4 * kMaxAdaptiveSpinNs;
+  // Number of spins between two reads of the clock.
+  static constexpr int kSpinsPerClockRead = 64;
+
+  // Start time of the last parallel section and moving average of the intervals between the starts of sections,
+  // updated without synchronization by the threads starting sections.
+  std::atomic<int64_t> last_parallel_section_start_ns_{0};
+  std::atomic<int64_t> parallel_section_interval_ns_{kMaxAdaptiveSpinNs / 2};
+
+  static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void RecordParallelSectionStart() {
+    const int64_t now = NowNs();
+    const int64_t last = last_parallel_section_start_ns_.exchange(now, std::memory_order_relaxed);
+    if (last != 0) {
+      const int64_t interval = std::min(now - last, kMaxParallelSectionIntervalNs);
+      const int64_t average = parallel_section_interval_ns_.load(std::memory_order_relaxed);
+      parallel_section_interval_ns_.store(average + (interval - average) / 8, std::memory_order_relaxed);
+    }
+  }
+
+  // Time a worker spins waiting for work before blocking. Spinning only pays off when the next parallel section is
+  // likely to start before the wake-up of a blocked worker would have completed.
+  int64_t AdaptiveSpinDurationNs() const {
+    const int64_t interval = parallel_section_interval_ns_.load(std::memory_order_relaxed);
+    return interval > kMaxAdaptiveSpinNs ? 0 : std::min(2 * interval, kMaxAdaptiveSpinNs);
+  }
+
   // Wake any blocked workers so that they can cleanly exit WorkerLoop().  For
   // a clean exit, each thread will observe (1) done_ set, indicating that the
   // destructor has been called, (2) all threads blocked, and (3) no
@@ -1543,6 +1687,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       Task t = q.PopFront();
       if (!t) {
         // Spin waiting for work.
+        const int64_t spin_deadline_ns = adaptive_spinning_ ? NowNs() + AdaptiveSpinDurationNs() : 0;
         for (int i = 0; i < spin_count && !done_; i++) {
           if (((i + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
@@ -1554,6 +1699,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
             break;
           }
+          if (adaptive_spinning_ && i % kSpinsPerClockRead == 0 && NowNs() >= spin_deadline_ns) {
+            break;
+          }
           onnxruntime::concurrency::SpinPause();
         }
 
@@ -1611,7 +1759,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
                 }
                 return should_block;
               },
-              // Post-block update (executed only if we blocked)
+              // Post-block update (executed only if the pre-block test returned true)
               [&]() {
                 blocked_--;
               });
@@ -1644,19 +1792,41 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // is that the thread is busy with other work, and we will avoid
   // "snatching" work from a thread which is just about to notice the
   // work itself.
+  //
+  // When the workers span several NUMA nodes, a worker first tries
+  // the workers of its own node: their work is more likely to touch
+  // memory local to the node.  A single attempt (TRY_ONE) stays on
+  // the node, while TRY_ALL falls back to all workers of the pool.
 
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
-    unsigned size = num_threads_;
-    unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
+
+    if (!numa_node_workers_.empty() && pt->pool == this && pt->thread_id >= 0) {
+      const int node = worker_numa_node_[pt->thread_id];
+      if (node >= 0) {
+        const auto& node_workers = numa_node_workers_[node];
+        Task t = StealFrom(node_workers.data(), static_cast<unsigned>(node_workers.size()), steal_kind, r);
+        if (t || steal_kind == StealAttemptKind::TRY_ONE) {
+          return t;
+        }
+      }
+    }
+
+    return StealFrom(nullptr, num_threads_, steal_kind, r);
+  }
+
+  // Steal from the workers in victims[0, size), or from workers [0, size) if victims is null.
+  Task StealFrom(const unsigned* victims, unsigned size, StealAttemptKind steal_kind, unsigned r) {
+    unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
     unsigned victim = r % size;
 
     for (unsigned i = 0; i < num_attempts; i++) {
       assert(victim < size);
-      if (worker_data_[victim].GetStatus() == WorkerData::ThreadStatus::Active) {
-        Task t = worker_data_[victim].queue.PopBack();
+      WorkerData& td = worker_data_[victims ? victims[victim] : victim];
+      if (td.GetStatus() == WorkerData::ThreadStatus::Active) {
+        Task t = td.queue.PopBack();
         if (t) {
           return t;
         }
@@ -1670,6 +1840,46 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return Task();
   }
 
+  // Assign each worker to the NUMA node that holds all logical processors in
+  // its affinity.  Workers without an affinity, or whose affinity spans
+  // several nodes, are not assigned to a node.
+  void InitializeNumaNodes(const ThreadOptions& thread_options) {
+    worker_numa_node_.assign(num_threads_, -1);
+    if (thread_options.affinities.size() < num_threads_) {
+      return;
+    }
+
+    const std::vector<LogicalProcessors> numa_nodes = env_.GetNumaNodes();
+    if (numa_nodes.size() <= 1) {
+      return;
+    }
+
+    std::vector<std::vector<unsigned>> node_workers(numa_nodes.size());
+    for (unsigned i = 0; i < num_threads_; i++) {
+      const LogicalProcessors& affinity = thread_options.affinities[i];
+      if (affinity.empty()) {
+        continue;
+      }
+      for (size_t node = 0; node < numa_nodes.size(); node++) {
+        const LogicalProcessors& node_processors = numa_nodes[node];
+        if (std::all_of(affinity.begin(), affinity.end(), [&node_processors](int processor) {
+              return std::find(node_processors.begin(), node_processors.end(), processor) != node_processors.end();
+            })) {
+          worker_numa_node_[i] = static_cast<int>(node);
+          node_workers[node].push_back(i);
+          break;
+        }
+      }
+    }
+
+    // Stealing is only grouped by node when the workers run on more than one node.
+    const auto nodes_used = std::count_if(node_workers.begin(), node_workers.end(),
+                                          [](const std::vector<unsigned>& workers) { return !workers.empty(); });
+    if (nodes_used > 1) {
+      numa_node_workers_ = std::move(node_workers);
+    }
+  }
+
   int NonEmptyQueueIndex() {
     PerThread* pt = GetPerThread();
     const unsigned size = static_cast<unsigned>(worker_data_.size());
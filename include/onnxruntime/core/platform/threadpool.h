@@ -16,6 +16,7 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 #include <functional>
@@ -135,6 +136,7 @@ class ThreadPoolTempl;
 class ExtendedThreadPoolInterface;
 class LoopCounter;
 class ThreadPoolParallelSection;
+class ThreadPoolCostCalibration;
 
 class ThreadPool {
  public:
@@ -213,6 +215,75 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Caps the value returned by DegreeOfParallelism on the calling thread while the object
+  // is alive, so that loops and MLAS kernels started from this thread split their work
+  // into at most max_degree parts and leave the other threads of the pool idle. This is
+  // used to run a kernel with fewer threads than the pool has, e.g. when tuning CPU
+  // kernels for small shapes. A value of zero or less removes the cap. Limits may be
+  // nested, the innermost one applies.
+
+  class DegreeOfParallelismLimit {
+   public:
+    explicit DegreeOfParallelismLimit(int max_degree);
+    ~DegreeOfParallelismLimit();
+
+   private:
+    int previous_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DegreeOfParallelismLimit);
+  };
+
+  // Marks the work started from the calling thread as low priority while the object is alive:
+  // whenever *higher_priority_runs is non-zero, DegreeOfParallelism returns 1 on this thread, so
+  // loops and MLAS kernels run on the calling thread only and leave the pool to the higher
+  // priority work. The counter is read each time a loop starts, so low priority work yields as
+  // soon as higher priority work begins and takes the pool back when it ends. The counter must
+  // outlive the object. Scopes may be nested, the innermost one applies.
+
+  class LowPriorityScope {
+   public:
+    explicit LowPriorityScope(const std::atomic<int>* higher_priority_runs);
+    ~LowPriorityScope();
+
+   private:
+    const std::atomic<int>* previous_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LowPriorityScope);
+  };
+
+  // Makes the parallel loops started from the calling thread stop early when *terminate_flag is
+  // set while the object is alive. The flag is checked before each block of iterations is
+  // claimed, so a long kernel is interrupted after the blocks in progress complete. The loop
+  // then throws, since the kernel cannot use its partial results, and the executor turns the
+  // exception into the status of the run. Loops are not cancelled in builds without exceptions.
+  // The flag must outlive the object. Scopes may be nested, the innermost one applies.
+
+  class CancellationScope {
+   public:
+    explicit CancellationScope(const bool* terminate_flag);
+    ~CancellationScope();
+
+   private:
+    const bool* previous_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CancellationScope);
+  };
+
+  // Calibrates the cost per unit of the ParallelFor loops started from the calling thread while the
+  // object is alive. Each loop is timed and its measured cost recorded in *calibration for call_site
+  // and the size of the loop; later loops of the same call site and a similar size are split with the
+  // measured cost instead of the estimate passed by the caller. The executor uses the op type of the
+  // kernel as call site. Both must outlive the object, and a null calibration turns calibration off.
+  // Scopes may be nested, the innermost one applies.
+
+  class CostCalibrationScope {
+   public:
+    CostCalibrationScope(ThreadPoolCostCalibration* calibration, const std::string& call_site);
+    ~CostCalibrationScope();
+
+   private:
+    ThreadPoolCostCalibration* previous_calibration_;
+    const std::string* previous_call_site_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CostCalibrationScope);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -360,6 +431,10 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Returns the NUMA node (index in Env::GetNumaNodes()) of the calling thread if it is a worker of tp
+  // whose affinity lies within one node, or -1 otherwise, e.g. for the thread entering a loop.
+  static int CurrentNumaNode(const ThreadPool* tp);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
   // StartProfiling and StopProfiling are not to be consumed as public-facing API
@@ -384,6 +459,10 @@ class ThreadPool {
   // by fn() is safe from concurrent access once RunWithHelp returns.
   void RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size);
 
+  // Returns the number of iterations the calling thread claims at a time in a loop divided in chunks of block_size,
+  // which is smaller on the threads with a lower capacity in ThreadOptions.
+  std::ptrdiff_t ScaleBlockSizeToCurrentThread(std::ptrdiff_t block_size) const;
+
   // Divides the work represented by the range [0, total) into k shards.
   // Calls fn(i*block_size, (i+1)*block_size) from the ith shard (0 <= i < k).
   // Each shard may be executed on a different thread in parallel, depending on
@@ -9,5 +9,11 @@ class IExecutionProvider;
 struct IExecutionProviderFactory {
   virtual ~IExecutionProviderFactory() = default;
   virtual std::unique_ptr<IExecutionProvider> CreateProvider() = 0;
+
+  // Creates the provider with the same options but on device `device_id`, for the replicas of a session.
+  // Returns nullptr if the provider does not support selecting the device.
+  virtual std::unique_ptr<IExecutionProvider> CreateProviderForDevice(int /*device_id*/) {
+    return nullptr;
+  }
 };
 }  // namespace onnxruntime
@@ -70,4 +70,6 @@ struct OrtTensorRTProviderOptionsV2 {
   int trt_ep_context_embed_mode{0};               // Specify EP context embed mode. Default 0 = context is engine cache path, 1 = context is engine binary data
 
   const char* trt_engine_cache_prefix{nullptr};  // specify engine cache prefix
+  int trt_profile_shape_bucketing{0};            // Grow the dynamic shape profile ranges to powers of 2 to reduce engine rebuilds. Default 0 = false, nonzero = true
+  int trt_share_initializers_enable{0};          // Bind initializers also used outside a TRT subgraph as engine inputs instead of baking them into the engine. Default 0 = false, nonzero = true
 };
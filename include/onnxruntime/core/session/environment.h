@@ -10,6 +10,9 @@
 #include "core/platform/threadpool.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/mapped_weight_pager.h"
+#include "core/framework/prepacked_weights_container.h"
+#include "core/framework/shared_initializer_cache.h"
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
@@ -88,6 +91,30 @@ class Environment {
    */
   Status CreateAndRegisterAllocatorV2(const std::string& provider_type, const OrtMemoryInfo& mem_info, const std::unordered_map<std::string, std::string>& options, const OrtArenaCfg* arena_cfg = nullptr);
 
+  /**
+   * Returns the cache through which the sessions created with kOrtSessionOptionsConfigShareInitializersAcrossSessions
+   * share the initializers with identical content.
+   */
+  SharedInitializerCache& GetSharedInitializerCache() const {
+    return *shared_initializer_cache_;
+  }
+
+  /**
+   * Returns the container of the weights pre-packed for the initializers shared through GetSharedInitializerCache().
+   * It lives as long as the environment.
+   */
+  PrepackedWeightsContainer& GetSharedPrepackedWeightsContainer() const {
+    return *shared_prepacked_weights_container_;
+  }
+
+  /**
+   * Returns the pager through which the sessions created with kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes
+   * keep their memory mapped weights under a common budget.
+   */
+  MappedWeightPager& GetMappedWeightPager() const {
+    return *mapped_weight_pager_;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
   Status Initialize(std::unique_ptr<logging::LoggingManager> logging_manager,
@@ -99,5 +126,9 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  std::unique_ptr<SharedInitializerCache> shared_initializer_cache_ = std::make_unique<SharedInitializerCache>();
+  std::unique_ptr<PrepackedWeightsContainer> shared_prepacked_weights_container_ =
+      std::make_unique<PrepackedWeightsContainer>();
+  std::unique_ptr<MappedWeightPager> mapped_weight_pager_ = std::make_unique<MappedWeightPager>();
 };
 }  // namespace onnxruntime
@@ -499,7 +499,8 @@ typedef struct OrtROCMProviderOptions {
         enable_hip_graph{false},
         tunable_op_enable{false},
         tunable_op_tuning_enable{false},
-        tunable_op_max_tuning_duration_ms{} {}
+        tunable_op_max_tuning_duration_ms{},
+        hip_graph_max_num_graphs{8} {}
 #endif
 
   /** \brief ROCM device Id
@@ -568,6 +569,12 @@ typedef struct OrtROCMProviderOptions {
    */
   int tunable_op_max_tuning_duration_ms;
 
+  /** \brief The number of hip graphs kept when enable_hip_graph is set, one per graph annotation of the runs.
+   *   The least recently replayed graph is destroyed to capture a new one. 0 for no bound.
+   *   Defaults to 8.
+   */
+  size_t hip_graph_max_num_graphs;
+
 } OrtROCMProviderOptions;
 
 /** \brief TensorRT Provider Options
@@ -712,6 +719,34 @@ typedef OrtStatus*(ORT_API_CALL* RegisterCustomOpsFn)(OrtSessionOptions* options
  */
 typedef void (*RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status);
 
+/** \brief Callback function for SetBoundOutputShapeChangedCallback
+ *
+ * \param[in] user_data User specific data that passed back to the callback
+ * \param[in] output_name Name of the output that was reallocated
+ * \param[in] previous_shape Shape of the output in the previous run
+ * \param[in] previous_shape_len Number of dimensions of previous_shape
+ * \param[in] new_shape Shape of the output in this run
+ * \param[in] new_shape_len Number of dimensions of new_shape
+ */
+typedef void (*OrtBoundOutputShapeChangedCallbackFn)(void* user_data, const char* output_name,
+                                                     const int64_t* previous_shape, size_t previous_shape_len,
+                                                     const int64_t* new_shape, size_t new_shape_len);
+
+/** \brief Callback function for RunOptionsSetGenerationTokensCallback
+ *
+ * Called by the BeamSearch, GreedySearch and Sampling operators with the tokens generated at each step, on the thread
+ * running the operator. The pointers are only valid during the call.
+ *
+ * \param[in] user_data User specific data that passed back to the callback
+ * \param[in] tokens The next token of each sequence, num_sequences of them. Sequences that are done get the pad token.
+ * \param[in] beam_indices For BeamSearch, the sequence of the previous step that each token extends, as the beams are
+ *   reordered at each step. nullptr for GreedySearch and Sampling.
+ * \param[in] num_sequences Number of sequences: batch_size * num_beams for BeamSearch, batch_size otherwise
+ * \param[in] sequence_length Length of the sequences including the new tokens
+ */
+typedef void (*OrtGenerationTokensCallbackFn)(void* user_data, const int32_t* tokens, const int32_t* beam_indices,
+                                              size_t num_sequences, size_t sequence_length);
+
 /** \brief The C API
  *
  * All C API functions are defined inside this structure as pointers to functions.
@@ -2774,6 +2809,14 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "max_cached_chunk_size_bytes": Freed chunks of allocations up to this size are kept in per-thread caches,
+   *  which serve later allocations of the same size without locking the arena. At most 65536.
+   *  Use 0 to disable the caches, or -1 to allow ORT to choose the default (disabled).
+   * "use_huge_pages": 1 = advise the OS to back the regions of CPU arenas with transparent huge pages (Linux only).
+   *  Use 0 or -1 to leave the regions on regular pages.
+   * "prefault_memory": 1 = write to every page of a region of a CPU arena when it is allocated, so the page faults
+   *  happen when the arena grows (e.g. during the first Run) instead of spread over later runs.
+   *  Use 0 or -1 to leave the pages to be faulted in on first use.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -3591,6 +3634,7 @@ struct OrtApi {
    *   QNN
    *   SNPE
    *   XNNPACK
+   *   CoreML
    *
    * Note: If an execution provider has a dedicated SessionOptionsAppendExecutionProvider_<provider name> function
    *       that should be used to add it.
@@ -3638,6 +3682,16 @@ struct OrtApi {
    * XNNPACK supported keys:
    *   "intra_op_num_threads": number of thread-pool size to use for XNNPACK execution provider.
    *      default value is 0, which means to use the session thread-pool size.
+   *   "shared_weights_cache": set to "1" to share the packed weights of Conv, Gemm and MatMul with the other sessions
+   *      that set it, so sessions of the same model keep one copy of them. Disabled by default.
+   *   "fuse_subgraphs": set to "1" to compile the connected float nodes with static shapes taken by the EP into
+   *      XNNPACK subgraphs, which run as one node. Disabled by default.
+   *
+   * CoreML supported keys:
+   *   "coreml_flags": COREMLFlags bit flags as a decimal number. Default to 0.
+   *   "model_cache_dir": directory to cache the compiled CoreML models in. A compiled model is keyed by a hash of the
+   *      generated CoreML model and the flags, so later sessions of the same model skip the CoreML compilation.
+   *      Stale entries are not removed. Disabled by default.
    *
    * \since Version 1.12.
    */
@@ -4352,6 +4406,9 @@ struct OrtApi {
                   _In_reads_(num_keys) const char* const* provider_options_keys, _In_reads_(num_keys) const char* const* provider_options_values, _In_ size_t num_keys);
 
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
+   *
+   * In sequential execution mode, the run takes place on the inter op thread pool instead when the session has one,
+   * see the session config entry "session.run_async_on_inter_op_pool".
    *
    * \param[in] session
    * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
@@ -4586,6 +4643,102 @@ struct OrtApi {
                   _In_reads_(num_keys) const char* const* provider_options_keys,
                   _In_reads_(num_keys) const char* const* provider_options_values,
                   _In_ size_t num_keys);
+
+  /** \brief Get the sampled kernel latencies of a session as JSON
+   *
+   * Kernel latency sampling is turned on with the session config entry "session.kernel_latency_sampling_interval".
+   * The JSON object holds latency histograms per op type ("op_types") and per kernel ("kernels") of the main graph
+   * and all subgraphs, with the count, total, maximum and estimated p50/p99 latencies in microseconds.
+   * The latencies are collected from all Run calls since the session was created.
+   *
+   * \param[in] session
+   * \param[in] allocator
+   * \param[out] out Null terminated JSON string, allocated using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(SessionGetKernelLatencyMetrics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Get notified when an output bound to a device is reallocated
+   *
+   * Outputs bound with OrtApi::BindOutputToDevice are allocated by the first run and reused by later runs as long as
+   * their shape does not change. When the shape changes, a new buffer is allocated and `callback` is invoked after
+   * the run, from the thread that called OrtApi::RunWithBinding.
+   *
+   * \param[in] binding_ptr
+   * \param[in] callback Callback to invoke, or nullptr to remove it
+   * \param[in] user_data Passed to the callback as is
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(SetBoundOutputShapeChangedCallback, _Inout_ OrtIoBinding* binding_ptr,
+                  _In_opt_ OrtBoundOutputShapeChangedCallbackFn callback, _In_opt_ void* user_data);
+
+  /** \brief Collect the resources used by the Run calls using these run options
+   *
+   * After each Run call, OrtApi::RunOptionsGetRunStats returns the resources it used, without enabling profiling.
+   * Only the work done for the run is counted, also when other runs of the session overlap with it. The stats are
+   * those of the last Run call using the run options, so use different run options for Run calls that overlap.
+   *
+   * \param[in] options
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(RunOptionsEnableRunStats, _Inout_ OrtRunOptions* options);
+
+  /** \brief Get the resources used by the last Run call using the run options as JSON
+   *
+   * The JSON object holds:
+   * - "wall_time_us": duration of the Run call
+   * - "cpu_time_us": CPU time of the thread calling Run and of the thread pool threads while they worked for the run
+   * - "device_time_us": time the devices took for the work of the run, if an execution provider reports it. The CUDA
+   *   execution provider reports it when it runs on one stream, e.g. with a user compute stream or CUDA graphs.
+   * - "kernel_time_us", "num_kernels": sum of the time of the kernels that ran, and their number
+   * - "memcpy_bytes", "num_memcpys": copies between devices
+   * - "allocated_bytes", "num_allocations", "peak_bytes": tensor buffers allocated for the run, and the highest total
+   *   of them alive at the same time
+   *
+   * \param[in] options Run options with OrtApi::RunOptionsEnableRunStats called
+   * \param[in] allocator
+   * \param[out] out Null terminated JSON string, allocated using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(RunOptionsGetRunStats, _In_ const OrtRunOptions* options, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Get the calibration table of a session as JSON
+   *
+   * The calibration is turned on with the session config entry "session.calibration_tensors" and collects the
+   * statistics of the tensors during all Run calls since the session was created. The JSON object holds the
+   * "method" and the "tensors", each with its "name", observed "min" and "max", calibrated "range_min" and
+   * "range_max", and the uint8 "scale" and "zero_point" of the calibrated range extended to include zero.
+   *
+   * \param[in] session
+   * \param[in] allocator
+   * \param[out] out Null terminated JSON string, allocated using `allocator`. Must be freed using `allocator`
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(SessionGetCalibrationTable, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Stream the tokens generated by the BeamSearch, GreedySearch and Sampling operators during Run
+   *
+   * The callback is called with the new tokens after each generation step of the Run calls using the run options,
+   * before the generation completes, so they can be streamed to users. The tokens are read on the host once per step,
+   * with the copy the operators already do to check the end of the sequences, so no additional synchronization with
+   * the device is done. The CUDA BeamSearch operator does not stream its tokens, as they stay on the device.
+   *
+   * \param[in] options
+   * \param[in] callback Called with the tokens of each step. nullptr to stop streaming them.
+   * \param[in] user_data Passed to the callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   */
+  ORT_API2_STATUS(RunOptionsSetGenerationTokensCallback, _Inout_ OrtRunOptions* options,
+                  _In_opt_ OrtGenerationTokensCallbackFn callback, _In_opt_ void* user_data);
 };
 
 /*
@@ -766,6 +766,18 @@ struct RunOptions : detail::Base<OrtRunOptions> {
    * Wraps OrtApi::RunOptionsUnsetTerminate
    */
   RunOptions& UnsetTerminate();
+
+  RunOptions& EnableRunStats();  ///< Wraps OrtApi::RunOptionsEnableRunStats
+
+  /** \brief Returns the resources used by the last Session::Run call using this RunOptions instance as JSON.
+   *
+   * \param allocator to allocate memory for the returned string
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetRunStatsAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::RunOptionsGetRunStats
+
+  RunOptions& SetGenerationTokensCallback(OrtGenerationTokensCallbackFn callback, void* user_data);  ///< Wraps OrtApi::RunOptionsSetGenerationTokensCallback
 };
 
 namespace detail {
@@ -1035,6 +1047,22 @@ struct ConstSessionImpl : Base<T> {
   uint64_t GetProfilingStartTimeNs() const;  ///< Wraps OrtApi::SessionGetProfilingStartTimeNs
   ModelMetadata GetModelMetadata() const;    ///< Wraps OrtApi::SessionGetModelMetadata
 
+  /** \brief Returns the sampled kernel latencies of the session as JSON.
+   *
+   * \param allocator to allocate memory for the returned string
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetKernelLatencyMetricsAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetKernelLatencyMetrics
+
+  /** \brief Returns the calibration table of the session as JSON.
+   *
+   * \param allocator to allocate memory for the returned string
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetCalibrationTableAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetCalibrationTable
+
   TypeInfo GetInputTypeInfo(size_t index) const;                   ///< Wraps OrtApi::SessionGetInputTypeInfo
   TypeInfo GetOutputTypeInfo(size_t index) const;                  ///< Wraps OrtApi::SessionGetOutputTypeInfo
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;  ///< Wraps OrtApi::SessionGetOverridableInitializerTypeInfo
@@ -1848,6 +1876,7 @@ struct IoBindingImpl : ConstIoBindingImpl<T> {
   void ClearBoundOutputs();
   void SynchronizeInputs();
   void SynchronizeOutputs();
+  void SetOutputShapeChangedCallback(OrtBoundOutputShapeChangedCallbackFn callback, void* user_data);  ///< Wraps OrtApi::SetBoundOutputShapeChangedCallback
 };
 
 }  // namespace detail
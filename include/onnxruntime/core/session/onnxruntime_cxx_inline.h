@@ -346,6 +346,12 @@ inline void IoBindingImpl<T>::ClearBoundOutputs() {
   GetApi().ClearBoundOutputs(this->p_);
 }
 
+template <typename T>
+inline void IoBindingImpl<T>::SetOutputShapeChangedCallback(OrtBoundOutputShapeChangedCallbackFn callback,
+                                                            void* user_data) {
+  ThrowOnError(GetApi().SetBoundOutputShapeChangedCallback(this->p_, callback, user_data));
+}
+
 template <typename T>
 inline void IoBindingImpl<T>::SynchronizeInputs() {
   ThrowOnError(GetApi().SynchronizeBoundInputs(this->p_));
@@ -599,6 +605,22 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::EnableRunStats() {
+  ThrowOnError(GetApi().RunOptionsEnableRunStats(p_));
+  return *this;
+}
+
+inline AllocatedStringPtr RunOptions::GetRunStatsAllocated(OrtAllocator* allocator) const {
+  char* out = nullptr;
+  ThrowOnError(GetApi().RunOptionsGetRunStats(p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+inline RunOptions& RunOptions::SetGenerationTokensCallback(OrtGenerationTokensCallbackFn callback, void* user_data) {
+  ThrowOnError(GetApi().RunOptionsSetGenerationTokensCallback(p_, callback, user_data));
+  return *this;
+}
+
 namespace detail {
 
 template <typename T>
@@ -973,6 +995,20 @@ inline uint64_t ConstSessionImpl<T>::GetProfilingStartTimeNs() const {
   return out;
 }
 
+template <typename T>
+inline AllocatedStringPtr ConstSessionImpl<T>::GetKernelLatencyMetricsAllocated(OrtAllocator* allocator) const {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetKernelLatencyMetrics(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+template <typename T>
+inline AllocatedStringPtr ConstSessionImpl<T>::GetCalibrationTableAllocated(OrtAllocator* allocator) const {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetCalibrationTable(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
 template <typename T>
 inline ModelMetadata ConstSessionImpl<T>::GetModelMetadata() const {
   OrtModelMetadata* out;
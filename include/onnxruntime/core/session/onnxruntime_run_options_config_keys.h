@@ -42,3 +42,44 @@ static const char* const kOrtRunOptionsConfigQnnPerfModePostRun = "qnn.htp_perf_
 
 // Set RPC control latency for QNN HTP backend
 static const char* const kOrtRunOptionsConfigQnnRpcControlLatency = "qnn.rpc_control_latency";
+
+// Annotation of the CUDA graph to capture or replay for this run when the session was created with CUDA graph
+// enabled, or of the hip graph with the ROCM EP. Runs with the same annotation share a graph, so the CUDA and ROCM
+// EPs keep one captured graph per annotation,
+// e.g. per batch size of a decoder. The inputs and outputs of the runs sharing a graph must be bound to the same
+// buffers with IOBinding, the graph replays on the buffers it was captured with.
+// By default the annotation is the shapes of the inputs of the run.
+static const char* const kOrtRunOptionsConfigCudaGraphAnnotation = "gpu_graph_id";
+
+// The name of the LoRA adapter to apply in this run, one registered with the session, which must have LoRA target
+// weights set with the session option kOrtSessionOptionsConfigLoraTargetWeights.
+// Switching adapters between runs only changes the tensors fed to the model, the weights are not changed or re-packed.
+// By default no adapter is applied and the run uses the base model.
+static const char* const kOrtRunOptionsConfigLoraAdapter = "lora.adapter";
+
+// The id of the stream this run processes a chunk of, when the session has streaming states set with the session
+// option kOrtSessionOptionsConfigStreamingStates. The states are fed from the previous run of the stream and the state
+// outputs kept for its next run, so they neither need to be fed nor fetched. Inputs that are fed override the states.
+// Runs of the same stream must not overlap. By default the run is not part of a stream.
+static const char* const kOrtRunOptionsConfigStreamId = "session.stream_id";
+
+// Set to '1' to start the stream of this run over from the initial states, e.g. for a new utterance.
+static const char* const kOrtRunOptionsConfigStreamReset = "session.stream_reset";
+
+// Set to '1' to release the states of the stream of this run after it, for the last chunk of a stream.
+static const char* const kOrtRunOptionsConfigStreamEnd = "session.stream_end";
+
+// Priority of this run among the concurrent runs sharing its intra-op thread pool: "low", "normal" or "high".
+// While runs of a higher priority are in flight, the parallel loops and MLAS kernels started by this run execute on
+// its calling thread only, leaving the pool threads to the higher priority runs. The priority is checked each time a
+// loop starts, so low priority runs yield as soon as higher priority runs begin. Runs of the sessions using the
+// global thread pools share their priorities across the process.
+// By default the priority is "low" for sessions with kOrtSessionOptionsGlobalThreadPoolPriority set to "batch" and
+// "normal" otherwise.
+static const char* const kOrtRunOptionsConfigPriority = "run.priority";
+
+// Set to '1' to only execute the nodes needed to produce the outputs fetched by this run, same as
+// RunOptions::only_execute_path_to_fetches. Useful for models with several heads when a run only fetches some of them.
+// The nodes needed for each set of fetched outputs are computed on the first run fetching it and cached by the session.
+// Defaults to '0'.
+static const char* const kOrtRunOptionsConfigOnlyExecutePathToFetches = "run.only_execute_path_to_fetches";
@@ -20,10 +20,91 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// Directory of an on-disk cache of pre-packed weights of CPU kernels.
+// When set, pre-packed buffers are written to this directory after PrePack() and later sessions (in this or other
+// processes) map the cached files instead of pre-packing again. Entries are keyed by kernel, weight contents and
+// CPU features, so a directory can be shared by several models and machines.
+// Only kernels that can restore their state from the pre-packed buffers alone use the cache,
+// see OpKernel::CanSkipPrePackWithSharedBuffers().
+// The default "" disables the cache.
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsCacheDir = "session.prepacked_weights_cache_dir";
+
+// Pre-pack the constant initializers of CPU kernels on the intra-op thread pool during session initialization.
+// The weights of one kernel are still pre-packed in input order on a single thread, different kernels run in parallel.
+// It does not apply when pre-packed weights are shared across sessions or cached on disk.
+// "0": pre-pack on the calling thread (default).
+// "1": pre-pack in parallel.
+static const char* const kOrtSessionOptionsConfigEnableParallelPrepacking = "session.enable_parallel_prepacking";
+
+// Directory of an on-disk cache of the memory patterns traced at runtime.
+// When set, the memory patterns of the main graph are written to this directory whenever inputs of new shapes are
+// seen, and later sessions with the same execution plan start with them instead of tracing them in their first runs.
+// Together with an ORT format model and kOrtSessionOptionsConfigPrepackedWeightsCacheDir this avoids most of the
+// work of the first session of a process that the previous ones already did.
+// Not used with kOrtSessionOptionsConfigMemoryPatternShapeBuckets.
+// The default "" disables the cache.
+static const char* const kOrtSessionOptionsConfigMemoryPatternsCacheDir = "session.memory_patterns_cache_dir";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
 
+// A value of "1" means the initializers of the main graph that are only used by nodes of the CPU EP are shared by
+// content with the other sessions of the env that set this option, so the sessions of models with identical weights,
+// e.g. fine-tuned variants of one base model, store them once. A shared initializer is freed with the last session
+// using it. Unless the session has a user provided pre-packed weights container, the weights pre-packed for the
+// shared initializers are also shared, through a container owned by the env.
+// Initializers with external data and initializers added with AddInitializer are not affected.
+// The default "0" disables the sharing.
+static const char* const kOrtSessionOptionsConfigShareInitializersAcrossSessions =
+    "session.share_initializers_across_sessions";
+
+// The device ids of the replicas of the session, separated by ';', e.g. "1;2;3".
+// The session created with this option is initialized as usual, on the devices set in the options of its execution
+// providers. Each listed id adds a replica of the session whose CUDA and TensorRT execution providers use that device,
+// while the other execution providers are created with the same options. Run calls of the session are dispatched to
+// the replica with the fewest runs in progress. Runs with an IOBinding stay on the session the binding was created
+// for, and the runs of a stream on the session itself.
+// The session and its replicas share their CPU initializers as with kOrtSessionOptionsConfigShareInitializersAcrossSessions.
+// Only supported for sessions created from a model path or a model in memory.
+// By default the session has no replicas.
+static const char* const kOrtSessionOptionsConfigReplicaDeviceIds = "session.replica_device_ids";
+
+// The names of the MatMul weights that LoRA adapters can update, separated by ';', e.g. "q_proj.weight;v_proj.weight".
+// Each must be a constant 2D float initializer of the main graph that is only used as the second input of MatMul nodes,
+// and the model must have IR version 4 or later. The adapters are registered with the session after it is initialized
+// and selected per run with the run option kOrtRunOptionsConfigLoraAdapter. The MatMuls using the target weights run on
+// the CPU EP and are not fused with other nodes.
+// By default no weights are targeted.
+static const char* const kOrtSessionOptionsConfigLoraTargetWeights = "session.lora_target_weights";
+
+// The states that streaming models carry across the runs processing the chunks of a stream, as pairs of a graph input
+// and the graph output with its value for the next chunk, separated by ';', e.g. "h_in:h_out;cache_in:cache_out".
+// Runs select their stream with the run option kOrtRunOptionsConfigStreamId and the session feeds the state inputs
+// with the state outputs of the previous run of the stream, which stay on the device of the nodes consuming them.
+// A stream starts with zeros for the inputs with a static shape and with the default of the overridable initializers.
+// By default the session has no streaming states.
+static const char* const kOrtSessionOptionsConfigStreamingStates = "session.streaming_states";
+
+// Set to '1' to add the hardware event counts of each node to its kernel time event when profiling, as the
+// "hardware_counters" argument: cycles, instructions, last level cache references and misses, and the bytes loaded from
+// memory estimated from the misses. Only supported on Linux, using perf_event_open. The counts are those of all the
+// threads of the process, so use the sequential execution mode. If the counters are not available a warning is logged.
+// The default is '0'.
+static const char* const kOrtSessionOptionsProfileHardwareCounters = "session.profile_hardware_counters";
+
+// Set to '1' to trace the memory of the session's allocators while profiling. The bytes in use and reserved by each
+// arena and its fragmentation are recorded as counter events, the node events get the allocations made by the node,
+// and the live tensors at the peak of each run are recorded in a 'memory_peak' event. The live tensors are only
+// recorded for models that run on a single stream. The default is '0'.
+static const char* const kOrtSessionOptionsProfileMemory = "session.profile_memory";
+
+// Set to '1' to stream spans of the runs, nodes, copies between devices, arena allocations and thread pool work to the
+// native tracer of the platform while they happen, independently of profiling. Only supported on Linux, where they are
+// written to the ftrace trace_marker to be recorded by e.g. Perfetto. Once enabled by a session, tracing stays on for
+// the process. If tracing is not available a warning is logged. The default is '0'.
+static const char* const kOrtSessionOptionsNativeTracing = "session.native_tracing";
+
 // Set to 'ORT' (case sensitive) to load an ORT format model.
 // If unset, model type will default to ONNX unless inferred from filename ('.ort' == ORT format) or bytes to be ORT
 static const char* const kOrtSessionOptionsConfigLoadModelFormat = "session.load_model_format";
@@ -39,6 +120,8 @@ static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save
 // denormal-as-zero is only applied to global OpenMP thread pool, which doesn't support per-session thread pool.
 // Note that an alternative way not using this option at runtime is to train and export a model without denormals
 // and that's recommended because turning this option on may hurt model accuracy.
+// With "1", the mode is also set around the execution of every kernel on the thread running it, so that it applies
+// to threads created otherwise, such as the threads calling Run and the inter-op threads.
 static const char* const kOrtSessionOptionsConfigSetDenormalAsZero = "session.set_denormal_as_zero";
 
 // It controls to run quantization model in QDQ (QuantizelinearDeQuantizelinear) format or not.
@@ -67,6 +150,14 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable fusing float 8 DequantizeLinear and MatMul into GemmFloat8 on CUDA. "0": disable; "1": enable.
+// The default is "0" since GemmFloat8 requires a GPU with float 8 tensor cores (compute capability 8.9 and above).
+static const char* const kOrtSessionOptionsEnableGemmFloat8Fusion = "optimization.enable_gemm_float8_fusion";
+
+// Enable or disable fusing chains of float elementwise operators on the CPU EP into FusedElementwise, which applies
+// the whole chain in a single pass over memory. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableElementwiseFusion = "optimization.enable_elementwise_fusion";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -83,26 +174,111 @@ static const char* const kOrtSessionOptionsDisableAheadOfTimeFunctionInlining =
 // <subgraph string: optimization strategy: number of subgraph to apply>.
 // For example, "Gelu+Cast+:1:0,Dropout+:1:1".
 //   A valid "subgraph string" should be one subgraph representation output by ORT graph transformations.
-//   "optimization strategy" currently has valid values: 0 - disabled, 1 - recompute.
+//   "optimization strategy" currently has valid values: 0 - disabled, 1 - recompute, 2 - recompute with compromise,
+//   3 - offload to host memory.
 //   "number of subgraph to apply" is used to control how many subgraphs to apply optimization, to avoid "oversaving"
 //   the memory.
 static const char* const kOrtSessionOptionsMemoryOptimizerEnabler = "optimization.memory_optimizer_config";
 
 // Specifies the config for detecting subgraphs for memory footprint reduction.
-// The value should be a string contains int separated using commas. The default value is "0:0".
+// The value should be a string contains int separated using colons. The default value is "0:0".
+// The optional third value enables the offload subgraphs, "0": disable; "1": enable. For example, "0:0:1".
 static const char* const kOrtSessionOptionsMemoryOptimizerProbeConfig = "optimization.enable_memory_probe_recompute_config";
+
+// Enables the automatic mode of the memory optimizer, used when "optimization.memory_optimizer_config" is empty.
+// The memory optimizer picks the recompute subgraphs that save the requested stashed activation memory for the least
+// estimated recompute cost.
+// The value should be "<MiB to save>[,<dim param>=<value>]*", for example "2048,batch=32,seq_len=512". The values of
+// the symbolic dimensions are used to compute the activation sizes, the subgraphs with other symbolic dimensions are
+// not considered.
+static const char* const kOrtSessionOptionsMemoryOptimizerBudget = "optimization.memory_optimizer_budget_config";
 #endif
 
 // Enable or disable using device allocator for allocating initialized tensor memory. "1": enable; "0": disable. The default is "0".
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Shape buckets of the memory pattern cache, given as comma separated upper bounds, e.g. "1,2,4,8,16,32,64,128".
+// Requires SessionOptions.enable_mem_pattern. By default memory patterns are cached per exact input shapes, so models
+// with variable batch size or sequence length rarely reuse a pattern. With buckets, every input dimension is rounded
+// up to the smallest bucket that holds it (dimensions above the largest bucket are kept as is) and executions in the
+// same bucket share one pattern. Tensors of an execution are placed in their planned block when they fit, and the
+// bucket is planned again with the largest sizes seen when one doesn't, so the pattern converges to the largest
+// shapes of the bucket. Cache hits and misses are counted, see SessionState::GetMemoryPatternCacheStats().
+// The default "" caches patterns per exact input shapes.
+static const char* const kOrtSessionOptionsConfigMemoryPatternShapeBuckets = "session.memory_pattern_shape_buckets";
+
+// Plan the memory of the main graph ahead of execution if the model has fixed shapes.
+// When all graph inputs and the intermediate tensors have fixed shapes, the offsets of the tensors in the memory
+// pattern buffer are computed during session initialization from their sizes and lifetimes in the execution plan,
+// instead of being traced by the first Run. Runs with the fixed input shapes then place these tensors in a single
+// buffer per device, with a lower peak than a traced pattern. Requires "enable_mem_pattern" and a single execution
+// stream. Tensors without a fixed shape are allocated at runtime as usual.
+// "0": default, memory patterns are traced by the first Run for each input shape.
+// "1": plan memory patterns ahead of execution for models with fixed shapes.
+static const char* const kOrtSessionOptionsConfigStaticMemoryPlanning = "session.static_memory_planning";
+
+// Interval in milliseconds at which a background thread checks the arenas of the session and returns their unused
+// memory to the device, instead of shrinking them as part of a Run with "memory.enable_memory_arena_shrinkage".
+// An arena is shrunk when it did not allocate since the previous check, or when it holds more memory than
+// "session.arena_shrink_high_water_mark_bytes". Only allocation regions that had no memory in use for
+// "session.arena_shrink_unused_time_ms" are released, and concurrent allocations do not wait for the memory to be
+// freed. The same rules as for kOrtRunOptionsConfigEnableMemoryArenaShrinkage apply to the initial region.
+// The default "0" disables the background shrinkage.
+static const char* const kOrtSessionOptionsConfigArenaShrinkCheckIntervalMs = "session.arena_shrink_check_interval_ms";
+
+// Time in milliseconds an allocation region has to be unused before the background shrinkage releases it.
+// The default is "10000".
+static const char* const kOrtSessionOptionsConfigArenaShrinkUnusedTimeMs = "session.arena_shrink_unused_time_ms";
+
+// Size in bytes above which the background shrinkage also shrinks arenas that are in use.
+// The default "0" only shrinks idle arenas.
+static const char* const kOrtSessionOptionsConfigArenaShrinkHighWaterMarkBytes =
+    "session.arena_shrink_high_water_mark_bytes";
+
+// Run the requests of RunAsync on the inter-op thread pool of a session in sequential execution mode, so they do not
+// take threads away from the intra-op thread pool that the kernels parallelize on. The size of the pool is set with
+// the inter-op number of threads. Sessions using the global thread pools always run RunAsync requests on the global
+// inter-op pool in sequential execution mode. Sessions in parallel execution mode use the intra-op pool, as their
+// inter-op pool executes the streams of each run.
+// "0": default, RunAsync requests run on the intra-op thread pool.
+// "1": create an inter-op thread pool for RunAsync requests in sequential execution mode.
+static const char* const kOrtSessionOptionsConfigRunAsyncOnInterOpThreadPool = "session.run_async_on_inter_op_pool";
+
+// Maximum number of rows, along the first dimension of the inputs, of the batches that concurrent Run calls are
+// merged into. Requests with inputs of the same shapes apart from the first dimension are concatenated, run once
+// and get their rows of the outputs back. The model has to process the rows independently of each other.
+// Only requests through the C/C++ API with CPU inputs, no pre-allocated outputs and no run config entries are
+// batched. Requests that can't be batched, or whose batch fails or does not return outputs with the batch
+// dimension, run on their own.
+// The default "0" disables batching.
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching_max_batch_size";
+
+// Time in microseconds the first request of a batch waits for other requests to join it.
+// The default is "1000".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingTimeoutUs = "session.dynamic_batching_timeout_us";
+
+// Maximum number of streams the CPU nodes are partitioned into in parallel execution mode, when no
+// "session.node_partition_config_file" is given. The nodes are placed by critical path list scheduling with costs
+// estimated from the inferred shapes, so independent branches of the graph run in parallel on the inter-op threads.
+// The kernels of all streams share the intra-op thread pool.
+// Defaults to the degree of parallelism of the inter-op thread pool. "1" puts all CPU nodes on a single stream.
+static const char* const kOrtSessionOptionsConfigParallelExecutionCpuStreams = "session.parallel_execution_cpu_streams";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
 static const char* const kOrtSessionOptionsConfigAllowInterOpSpinning = "session.inter_op.allow_spinning";
 static const char* const kOrtSessionOptionsConfigAllowIntraOpSpinning = "session.intra_op.allow_spinning";
 
+// Configure whether the intra_op threads adapt the time they spin before blocking to the load of the thread pool.
+// The threads then spin for about twice the average time between the starts of parallel sections, up to 1 ms, and
+// block right away when sections start less often than that. This keeps the wake-up latency low while the session
+// is busy, without burning the cores between sparse requests. Only applies when intra_op spinning is allowed.
+// "0": default, thread will spin a fixed number of times before blocking
+// "1": thread will adapt the spin duration to the time between parallel sections
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveSpinning = "session.intra_op.adaptive_spinning";
+
 // Key for using model bytes directly for ORT format
 // If a session is created using an input byte array contains the ORT format model data,
 // By default we will copy the model bytes at the time of session creation to ensure the model bytes
@@ -121,6 +297,38 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+/// <summary>
+/// Key for loading the initializers of an ONNX model file lazily.
+/// If set to "1", a model loaded from a file path is mapped into memory. The graph structure is parsed eagerly, but
+/// the raw data of large initializers is not copied. It refers to the mapping until the initializers are converted
+/// to OrtValues during session initialization, where CPU tensors use the mapped data directly.
+/// This reduces load time and peak memory usage for large models that don't use external data.
+/// The model file must not be modified while the session exists.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigLazyLoadInitializers = "session.lazy_load_initializers";
+
+/// <summary>
+/// Key for paging the lazily loaded initializers of the sessions of an env under a memory budget.
+/// A positive value, in bytes, registers the memory mapped model file of the session, see
+/// kOrtSessionOptionsConfigLazyLoadInitializers, with the env and sets the budget for the mapped weights of all the
+/// registered sessions of the env. Once the budget is exceeded the physical pages of the least recently run sessions
+/// are released; the sessions stay initialized and their weights are read back from the file when they run again.
+/// Only CPU tensors using the mapped data are affected. Weights copied to a device or pre-packed are not paged.
+/// The default "0" disables paging for the session.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes = "session.env_weight_paging_budget_bytes";
+
+/// <summary>
+/// Key for backing initializers with a read-only mapping of the model file instead of copies in the CPU arena.
+/// "0": default, an ORT format model loaded from a file is read into memory and its initializers are copied.
+/// "1": an ORT format model loaded from a file is mapped into memory and CPU initializers refer to the mapping,
+///      which is kept until the InferenceSession is destroyed. Pages of the mapping are loaded on first use and
+///      shared between processes that map the same file.
+/// External data of ONNX models is always mapped for initializers placed on CPU. Saving a model with
+/// external initializers aligns large initializers to page boundaries so they can be mapped individually.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigMapInitializersFromFile = "session.map_initializers_from_file";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -152,6 +360,17 @@ static const char* const kOrtSessionOptionsConfigMinimalBuildOptimizations =
 // exclusion, set the value to "".
 static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "ep.nnapi.partitioning_stop_ops";
 
+// Specifies a directory where the NNAPI EP caches the compiled NNAPI models, so that the NNAPI drivers do not compile
+// them again when a session is created for the same model. The directory must exist and be writable by the app.
+// The compilation cache is available since Android API level 29. If not specified, the compiled models are not cached.
+static const char* const kOrtSessionOptionsConfigNnapiEpCompilationCacheDir = "ep.nnapi.compilation_cache_dir";
+
+// Specifies the minimum number of nodes of a NNAPI EP partition when the graph is split in multiple partitions.
+// Smaller partitions are run by the other EPs, as transferring their inputs and outputs to the NNAPI device costs more
+// than it saves. A single partition is always run by the NNAPI EP.
+// The value should be a non-negative integer. The default value is "0", which keeps all the partitions.
+static const char* const kOrtSessionOptionsConfigNnapiEpMinPartitionSize = "ep.nnapi.min_partition_size";
+
 // Enabling dynamic block-sizing for multithreading.
 // With a positive value, thread pool will split a task of N iterations to blocks of size starting from:
 // N / (num_of_threads * dynamic_block_base)
@@ -200,6 +419,22 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Runs the intra op thread pool on one NUMA node, given as the 0-based index of the node among the NUMA nodes that
+// have logical processors. Each thread is attached to the processors of the node, and work stealing between
+// the threads stays on the node. Without intra_op_num_threads, the pool gets one thread per physical core
+// of the node. Memory is allocated local to the node on systems with a first-touch NUMA policy, as the threads
+// of the pool are the first to write to it.
+// This option can't be combined with "session.intra_op_thread_affinities".
+static const char* const kOrtSessionOptionsConfigIntraOpThreadNumaNode = "session.intra_op_thread_numa_node";
+
+// Interval of the always-on kernel latency sampling. With a value N > 0, every N-th execution of each kernel is
+// timed and added to per kernel and per op type latency histograms, which OrtApi::SessionGetKernelLatencyMetrics
+// returns as JSON. Unlike profiling, nothing is written to a file and the cost of unsampled executions is one
+// atomic increment per kernel.
+// The default "0" disables the sampling.
+static const char* const kOrtSessionOptionsConfigKernelLatencySamplingInterval =
+    "session.kernel_latency_sampling_interval";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -228,6 +463,21 @@ static const char* const kDebugLayoutTransformation = "session.debug_layout_tran
 // - "1": CPU EP fallback is disabled.
 static const char* const kOrtSessionOptionsDisableCPUEPFallback = "session.disable_cpu_ep_fallback";
 
+// Graph partitioning assigns nodes greedily in the order of the execution providers. If this option is set to "1",
+// small islands of nodes assigned to a device execution provider are moved back to the CPU EP afterwards when a cost
+// model estimates that the copies they require to and from their neighbours cost more than the device saves.
+// Islands are only moved if the CPU EP has kernels for all of their nodes. Ignored if CPU EP fallback is disabled.
+//
+// Option values:
+// - "0": Keep the greedy assignment. [DEFAULT]
+// - "1": Move the islands that are cheaper on the CPU EP.
+static const char* const kOrtSessionOptionsConfigMergeSmallDeviceIslands = "session.partitioning.merge_small_device_islands";
+
+// Path of a file the node to execution provider assignment chosen by graph partitioning is written to, one
+// "<graph>\t<node name>\t<domain>:<op type>\t<execution provider>" line per node. Nodes of nested subgraphs are
+// listed under the path of the node that owns them. Not written if empty. [DEFAULT: ""]
+static const char* const kOrtSessionOptionsConfigPartitionAssignmentFile = "session.partitioning.assignment_file";
+
 // Use this config when serializing a large model after optimization to specify an external initializers file
 static const char* const kOrtSessionOptionsOptimizedModelExternalInitializersFileName =
     "session.optimized_model_external_initializers_file_name";
@@ -251,8 +501,155 @@ static const char* const kOrtSessionOptionEpContextFilePath = "ep.context_file_p
 // "1": dump the EP context into the Onnx model. (default).
 static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed_mode";
 
+// Share the EP contexts loaded from EP context models with the other sessions of the process that set it.
+// An EP context binary can hold several graphs that share weights, e.g. the prefill and decode graphs of a LLM.
+// The first session loads the binary and leaves the graphs it does not use to the sessions of the other graphs,
+// which then do not load the binary again. Currently supported by the QNN EP.
+// "0": disable. (default)
+// "1": enable.
+static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_contexts";
+
 // Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul.
+// It is available on Linux ARM64 with bf16 support, and on x64 builds that compile the MLAS AVX512_BF16 kernels
+// when the processor has AVX512_BF16, using AMX-BF16 tiles if it has them. The option is ignored otherwise.
 // Option values:
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
+
+// Use the Winograd F(4x4, 3x3) algorithm for fp32 3x3 convolutions with unit strides and dilations in the
+// CPU EP when MLAS expects it to be faster for the convolution shape. The algorithm needs fewer
+// multiplications but rounds differently than the default algorithm, so results differ slightly.
+// Option values:
+// - "0": Winograd convolutions are not used. [DEFAULT]
+// - "1": Winograd convolutions are used when they are expected to be faster.
+static const char* const kOrtSessionOptionsMlasConvWinograd = "mlas.enable_conv_winograd";
+
+// Copy the pre-packed fp32 weights of the CPU MatMul kernel to the memory of each NUMA node, so that the intra-op
+// threads running on a node read the local copy, e.g. during LLM decoding on multi-socket servers. It takes effect
+// for the threads assigned to a single node, e.g. with kOrtSessionOptionsConfigIntraOpThreadAffinities, and costs
+// one more copy of the weights per node. The copies are shared with the pre-packed weights container.
+// Option values:
+// - "0": the weights are not copied. [DEFAULT]
+// - "1": the weights are copied when there are several NUMA nodes.
+static const char* const kOrtSessionOptionsNumaReplicatePrepackedWeights = "mlas.numa_replicate_prepacked_weights";
+
+// Compute the attention scores and context of the CPU QAttention kernel with 8-bit matrix multiplications
+// and a lookup table softmax instead of dequantizing Q, K and V to fp32. Q, K, V and the attention
+// probabilities are quantized dynamically per head, so results differ slightly from the fp32 path.
+// Option values:
+// - "0": QAttention computes the attention in fp32. [DEFAULT]
+// - "1": QAttention computes the attention in int8 when there is no past state.
+static const char* const kOrtSessionOptionsQAttentionInt8Attention = "session.qattention_int8_attention";
+
+// Enable TunableOp in the CPU EP. The CPU EP then uses tuning results for its tunable kernels (fp32 MatMul and
+// Conv), either loaded from the model metadata or found by tuning in this session, instead of the fixed choice
+// of MLAS. Tuning results of the CPU EP are saved to and loaded from the model metadata like those of other EPs.
+// Option values:
+// - "0": TunableOp is disabled in the CPU EP. [DEFAULT]
+// - "1": TunableOp is enabled in the CPU EP.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Tune the kernels of the CPU EP for the shapes they run with when TunableOp is enabled, by timing the degrees of
+// parallelism and algorithms available for the shape the first time a shape is seen.
+// Option values:
+// - "0": Shapes without tuning results use the default kernel. [DEFAULT]
+// - "1": Shapes without tuning results are tuned.
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// Upper bound in milliseconds of the time spent timing each candidate kernel of the CPU EP for a shape.
+// "0" or a negative value means no limit. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
+
+// Quantize the constant fp32/fp16 2D weights of MatMul nodes blockwise to 4 bits when the session is created and run
+// the MatMul nodes as MatMulNBits, on the CPU and CUDA EPs. A full precision model can then be deployed once and run
+// with reduced memory on the hosts that set the option. Weights are quantized asymmetrically, so results differ from
+// the full precision model. The weights pre-packed by MatMulNBits use the on-disk cache of
+// kOrtSessionOptionsConfigPrepackedWeightsCacheDir; saving the optimized model also saves the quantization itself.
+// Option values:
+// - "0": MatMul weights are not quantized. [DEFAULT]
+// - "1": MatMul weights are quantized.
+static const char* const kOrtSessionOptionsMatMulNBitsWeightQuantization = "session.matmul_nbits_weight_quantization";
+
+// Number of elements along K sharing a scale and zero point in the weight quantization above: 16, 32, 64, 128 or 256.
+// [DEFAULT "32"]
+static const char* const kOrtSessionOptionsMatMulNBitsWeightQuantizationBlockSize =
+    "session.matmul_nbits_weight_quantization_block_size";
+
+// accuracy_level attribute of the MatMulNBits nodes added by the weight quantization above, e.g. "4" to compute with
+// int8 activations on the CPU EP. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsMatMulNBitsWeightQuantizationAccuracyLevel =
+    "session.matmul_nbits_weight_quantization_accuracy_level";
+
+// Comma separated names of the MatMul nodes whose weights are not quantized by the weight quantization above.
+// [DEFAULT ""]
+static const char* const kOrtSessionOptionsMatMulNBitsWeightQuantizationExcludedNodes =
+    "session.matmul_nbits_weight_quantization_excluded_nodes";
+
+// Comma separated names of the node outputs to calibrate for static quantization, or "*" for all float outputs.
+// The float and float16 outputs on CPU are observed right after their producer runs in normal Run calls, without
+// adding graph outputs or copying them, and OrtApi::SessionGetCalibrationTable returns their quantization parameters.
+// [DEFAULT ""], which disables the calibration.
+static const char* const kOrtSessionOptionsCalibrationTensors = "session.calibration_tensors";
+
+// Calibration method of the tensors above:
+// - "minmax": the range of all observed values. [DEFAULT]
+// - "percentile": the range clipped to the percentile of the absolute values given by
+//   kOrtSessionOptionsCalibrationPercentile.
+// - "entropy": the range clipped to the threshold minimizing the KL divergence of the quantized distribution.
+// The percentile and entropy methods update a histogram of each tensor in every run.
+static const char* const kOrtSessionOptionsCalibrationMethod = "session.calibration_method";
+
+// Percentile of the "percentile" calibration method, between 0 and 100. [DEFAULT "99.999"]
+static const char* const kOrtSessionOptionsCalibrationPercentile = "session.calibration_percentile";
+
+// Maximum number of threads of the global intra-op thread pool (OrtApi::CreateEnvWithGlobalThreadPools) used by each
+// run of a session that does not use per session threads, including the calling thread. Runs split their parallel
+// loops and MLAS kernels into at most this many parts, so that the sessions sharing the pool do not oversubscribe it.
+// The limit applies to the kernels run by the calling thread, i.e. with the sequential execution mode.
+// "0" means the whole pool. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsGlobalIntraOpThreadQuota = "session.global_intra_op_thread_quota";
+
+// Priority class of the runs of a session on the global intra-op thread pool:
+// - "latency": the runs use the threads allowed by kOrtSessionOptionsGlobalIntraOpThreadQuota. [DEFAULT]
+// - "batch": the runs default to the "low" run priority (kOrtRunOptionsConfigPriority), so their parallel work runs
+//   on the calling thread while runs of "latency" sessions are in flight on the global pool.
+static const char* const kOrtSessionOptionsGlobalThreadPoolPriority = "session.global_thread_pool_priority";
+
+// If "1", the profiler events of the kernels run with profiling enabled record the number of denormal values of their
+// float, double and float16 outputs on CPU as "denormal_output_count", to find the nodes producing denormals, which
+// are much slower to compute with when kOrtSessionOptionsConfigSetDenormalAsZero is not set.
+// Counting reads all those outputs after each kernel. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsConfigProfileDenormals = "session.profile_denormals";
+
+// Comma separated names of node outputs whose producer nodes are memoized across runs. When such a node is fed the
+// same inputs as in an earlier run, its earlier outputs are copied instead of running it, e.g. for the deterministic
+// towers of recommendation models fed the same user features. Constant initializers are not compared, and only nodes
+// with non-string tensor inputs and outputs on CPU are memoized. The nodes shall be deterministic.
+// [DEFAULT ""], which disables the memoization.
+static const char* const kOrtSessionOptionsMemoizedOutputs = "session.memoized_outputs";
+
+// Capacity in bytes of the memoized inputs and outputs of the session, least recently used entries are evicted
+// beyond it. [DEFAULT "67108864"]
+static const char* const kOrtSessionOptionsMemoizationCacheSize = "session.memoization_cache_size";
+
+// Set to "1" to calibrate the cost per unit that kernels estimate for their parallel loops on the intra-op thread
+// pool. Each loop of a kernel is timed, and later loops of the same op type and a similar size are split with the
+// measured cost instead of the estimate. When profiling is enabled, the profile ends with an
+// "intra_op_cost_calibration" event listing the loops whose estimates diverge most from their measured costs first.
+// Only loops started by the thread running the kernel are calibrated. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsIntraOpCostCalibration = "session.intra_op_cost_calibration";
+
+// Memory budget in bytes of a cache of prompt key/value state kept by each GreedySearch and Sampling node on CPU.
+// A prompt that starts with the tokens of an earlier prompt, e.g. a system prompt sent with every request, only runs
+// its tokens after the longest cached prefix through the decoder. It applies to GPT decoders run with batch_size 1,
+// without padding, init_decoder or past_present_share_buffer. The implicit inputs of the decoder subgraph shall not
+// change between runs, as they are not part of the cache key. "0" disables the cache. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsGenerationPrefixCacheBytes = "session.generation_prefix_cache_bytes";
+
+// Maximum number of prompt tokens run by one call of the decoder subgraph of a GreedySearch or Sampling node on CPU.
+// Longer prompts are run in chunks, each attending to the earlier chunks as past state, which bounds the size of the
+// attention and intermediate tensors of a long prompt. Applies under the same conditions as
+// kOrtSessionOptionsGenerationPrefixCacheBytes. "0" runs the whole prompt at once. [DEFAULT "0"]
+static const char* const kOrtSessionOptionsGenerationPrefillChunkSize = "session.generation_prefill_chunk_size";
@@ -9,6 +9,7 @@
 #include "run_options_helper.h"
 #include "session_options_helper.h"
 #include "tensor_helper.h"
+#include <memory>
 #include <string>
 
 Napi::FunctionReference InferenceSessionWrap::constructor;
@@ -31,6 +32,7 @@ Napi::Object InferenceSessionWrap::Init(Napi::Env env, Napi::Object exports) {
   Napi::Function func = DefineClass(
       env, "InferenceSession",
       {InstanceMethod("loadModel", &InferenceSessionWrap::LoadModel), InstanceMethod("run", &InferenceSessionWrap::Run),
+       InstanceMethod("runAsync", &InferenceSessionWrap::RunAsync),
        InstanceMethod("dispose", &InferenceSessionWrap::Dispose),
        InstanceAccessor("inputNames", &InferenceSessionWrap::GetInputNames, nullptr, napi_default, nullptr),
        InstanceAccessor("outputNames", &InferenceSessionWrap::GetOutputNames, nullptr, napi_default, nullptr)});
@@ -46,7 +48,8 @@ Napi::Object InferenceSessionWrap::Init(Napi::Env env, Napi::Object exports) {
 }
 
 InferenceSessionWrap::InferenceSessionWrap(const Napi::CallbackInfo &info)
-    : Napi::ObjectWrap<InferenceSessionWrap>(info), initialized_(false), disposed_(false), session_(nullptr),
+    : Napi::ObjectWrap<InferenceSessionWrap>(info), initialized_(false), disposed_(false), pendingRuns_(0),
+      session_(nullptr),
       defaultRunOptions_(nullptr) {}
 
 Napi::Value InferenceSessionWrap::LoadModel(const Napi::CallbackInfo &info) {
@@ -146,7 +149,7 @@ Napi::Value InferenceSessionWrap::GetOutputNames(const Napi::CallbackInfo &info)
   return scope.Escape(CreateNapiArrayFrom(env, outputNames_));
 }
 
-Napi::Value InferenceSessionWrap::Run(const Napi::CallbackInfo &info) {
+void InferenceSessionWrap::PrepareRun(const Napi::CallbackInfo &info, RunContext &context) {
   Napi::Env env = info.Env();
   ORT_NAPI_THROW_ERROR_IF(!this->initialized_, env, "Session is not initialized.");
   ORT_NAPI_THROW_ERROR_IF(this->disposed_, env, "Session already disposed.");
@@ -156,57 +159,144 @@ Napi::Value InferenceSessionWrap::Run(const Napi::CallbackInfo &info) {
   ORT_NAPI_THROW_TYPEERROR_IF(info.Length() > 2 && (!info[2].IsObject() || info[2].IsNull()), env,
                               "'runOptions' must be an object.");
 
-  Napi::EscapableHandleScope scope(env);
-
   auto feed = info[0].As<Napi::Object>();
   auto fetch = info[1].As<Napi::Object>();
 
-  std::vector<const char *> inputNames_cstr;
-  std::vector<Ort::Value> inputValues;
-  std::vector<const char *> outputNames_cstr;
-  std::vector<Ort::Value> outputValues;
-  std::vector<bool> reuseOutput;
-  size_t inputIndex = 0;
-  size_t outputIndex = 0;
-  OrtMemoryInfo *memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault).release();
+  // tensors of numeric types refer to the memory of the typed arrays directly
+  auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
 
-  try {
-    for (auto &name : inputNames_) {
-      if (feed.Has(name)) {
-        inputIndex++;
-        inputNames_cstr.push_back(name.c_str());
-        auto value = feed.Get(name);
-        inputValues.push_back(NapiValueToOrtValue(env, value, memory_info));
-      }
+  for (auto &name : inputNames_) {
+    if (feed.Has(name)) {
+      context.inputNames.push_back(name.c_str());
+      auto value = feed.Get(name);
+      context.inputValues.push_back(NapiValueToOrtValue(env, value, memoryInfo));
     }
-    for (auto &name : outputNames_) {
-      if (fetch.Has(name)) {
-        outputIndex++;
-        outputNames_cstr.push_back(name.c_str());
-        auto value = fetch.Get(name);
-        reuseOutput.push_back(!value.IsNull());
-        outputValues.emplace_back(value.IsNull() ? Ort::Value{nullptr} : NapiValueToOrtValue(env, value, memory_info));
+  }
+  for (auto &name : outputNames_) {
+    if (fetch.Has(name)) {
+      context.outputNames.push_back(name.c_str());
+      auto value = fetch.Get(name);
+      if (value.IsNull()) {
+        context.outputValues.emplace_back(nullptr);
+        context.preallocatedOutputs.emplace_back();
+      } else {
+        context.outputValues.push_back(NapiValueToOrtValue(env, value, memoryInfo));
+        context.preallocatedOutputs.push_back(Napi::Persistent(value));
       }
     }
+  }
 
-    Ort::RunOptions runOptions{nullptr};
-    if (info.Length() > 2) {
-      runOptions = Ort::RunOptions{};
-      ParseRunOptions(info[2].As<Napi::Object>(), runOptions);
-    }
+  if (info.Length() > 2) {
+    context.runOptions = Ort::RunOptions{};
+    ParseRunOptions(info[2].As<Napi::Object>(), context.runOptions);
+  }
+}
+
+void InferenceSessionWrap::ExecuteRun(RunContext &context) {
+  size_t inputCount = context.inputNames.size();
+  size_t outputCount = context.outputNames.size();
+  session_->Run(context.runOptions == nullptr ? *defaultRunOptions_.get() : context.runOptions,
+                inputCount == 0 ? nullptr : &context.inputNames[0],
+                inputCount == 0 ? nullptr : &context.inputValues[0], inputCount,
+                outputCount == 0 ? nullptr : &context.outputNames[0],
+                outputCount == 0 ? nullptr : &context.outputValues[0], outputCount);
+}
 
-    session_->Run(runOptions == nullptr ? *defaultRunOptions_.get() : runOptions,
-                  inputIndex == 0 ? nullptr : &inputNames_cstr[0], inputIndex == 0 ? nullptr : &inputValues[0],
-                  inputIndex, outputIndex == 0 ? nullptr : &outputNames_cstr[0],
-                  outputIndex == 0 ? nullptr : &outputValues[0], outputIndex);
+Napi::Value InferenceSessionWrap::CreateRunResult(Napi::Env env, RunContext &context) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::Object result = Napi::Object::New(env);
+
+  for (size_t i = 0; i < context.outputNames.size(); i++) {
+    // pre-allocated outputs are written in place, so the given tensor is the result
+    auto &preallocated = context.preallocatedOutputs[i];
+    result.Set(context.outputNames[i],
+               preallocated.IsEmpty() ? OrtValueToNapiValue(env, std::move(context.outputValues[i]))
+                                      : preallocated.Value());
+  }
 
-    Napi::Object result = Napi::Object::New(env);
+  return scope.Escape(result);
+}
 
-    for (size_t i = 0; i < outputIndex; i++) {
-      result.Set(outputNames_[i], OrtValueToNapiValue(env, outputValues[i]));
+Napi::Value InferenceSessionWrap::Run(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::EscapableHandleScope scope(env);
+
+  try {
+    RunContext context;
+    PrepareRun(info, context);
+    ExecuteRun(context);
+    return scope.Escape(CreateRunResult(env, context));
+  } catch (Napi::Error const &e) {
+    throw e;
+  } catch (std::exception const &e) {
+    ORT_NAPI_THROW_ERROR(env, e.what());
+  }
+}
+
+// RunWorker runs the session on a libuv worker thread and settles the promise of runAsync() on the main thread.
+class InferenceSessionWrap::RunWorker : public Napi::AsyncWorker {
+public:
+  RunWorker(Napi::Env env, InferenceSessionWrap *session, Napi::Object sessionObject, Napi::Object feed,
+            std::unique_ptr<RunContext> context)
+      : Napi::AsyncWorker(env, "onnxruntime-node:run"), deferred_(Napi::Promise::Deferred::New(env)),
+        session_(session), context_(std::move(context)) {
+    // keep the session and the typed arrays of the inputs alive until the run completes. Pre-allocated outputs are
+    // referenced by the run context already.
+    sessionObject_ = Napi::Persistent(sessionObject);
+    feed_ = Napi::Persistent(feed);
+    session_->pendingRuns_++;
+  }
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    try {
+      session_->ExecuteRun(*context_);
+    } catch (std::exception const &e) {
+      SetError(e.what());
     }
+  }
 
-    return scope.Escape(result);
+  void OnOK() override {
+    Napi::Env env = Env();
+    session_->pendingRuns_--;
+    try {
+      deferred_.Resolve(session_->CreateRunResult(env, *context_));
+    } catch (Napi::Error const &e) {
+      deferred_.Reject(e.Value());
+    } catch (std::exception const &e) {
+      deferred_.Reject(Napi::Error::New(env, e.what()).Value());
+    }
+  }
+
+  void OnError(Napi::Error const &e) override {
+    session_->pendingRuns_--;
+    deferred_.Reject(e.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred_;
+  InferenceSessionWrap *session_;
+  Napi::ObjectReference sessionObject_;
+  Napi::ObjectReference feed_;
+  std::unique_ptr<RunContext> context_;
+};
+
+Napi::Value InferenceSessionWrap::RunAsync(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::EscapableHandleScope scope(env);
+
+  try {
+    auto context = std::make_unique<RunContext>();
+    PrepareRun(info, *context);
+
+    // the worker is deleted by node-addon-api after the promise is settled
+    auto worker = new RunWorker(env, this, info.This().As<Napi::Object>(), info[0].As<Napi::Object>(),
+                                std::move(context));
+    auto promise = worker->Promise();
+    worker->Queue();
+    return scope.Escape(promise);
   } catch (Napi::Error const &e) {
     throw e;
   } catch (std::exception const &e) {
@@ -218,6 +308,7 @@ Napi::Value InferenceSessionWrap::Dispose(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   ORT_NAPI_THROW_ERROR_IF(!this->initialized_, env, "Session is not initialized.");
   ORT_NAPI_THROW_ERROR_IF(this->disposed_, env, "Session already disposed.");
+  ORT_NAPI_THROW_ERROR_IF(this->pendingRuns_ > 0, env, "Cannot dispose the session while runAsync() is pending.");
 
   this->defaultRunOptions_.reset(nullptr);
   this->session_.reset(nullptr);
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <napi.h>
+#include <vector>
 
 // class InferenceSessionWrap is a N-API object wrapper for native InferenceSession.
 class InferenceSessionWrap : public Napi::ObjectWrap<InferenceSessionWrap> {
@@ -55,6 +56,17 @@ private:
    */
   Napi::Value Run(const Napi::CallbackInfo &info);
 
+  /**
+   * [async] run the model on a libuv worker thread, without blocking the event loop.
+   * @param arg0 input object: all keys must present, value is object
+   * @param arg1 output object: at least one key must present, value can be null.
+   * @param arg2 (optional) run options object
+   * @returns a promise that resolves to the same object as run(). Typed arrays of inputs and pre-allocated outputs
+   * must not be modified until the promise is settled.
+   * @throw error if the arguments are invalid. Errors of the inference reject the promise.
+   */
+  Napi::Value RunAsync(const Napi::CallbackInfo &info);
+
   /**
    * [sync] dispose the session.
    * @param nothing
@@ -63,6 +75,26 @@ private:
    */
   Napi::Value Dispose(const Napi::CallbackInfo &info);
 
+  // inputs, outputs and run options of a single run() or runAsync() call
+  struct RunContext {
+    std::vector<const char *> inputNames;
+    std::vector<Ort::Value> inputValues;
+    std::vector<const char *> outputNames;
+    std::vector<Ort::Value> outputValues;
+    // the JavaScript value of each pre-allocated output, or an empty value
+    std::vector<Napi::Reference<Napi::Value>> preallocatedOutputs;
+    Ort::RunOptions runOptions{nullptr};
+  };
+
+  // validate the arguments of run() or runAsync() and convert them to the run context
+  void PrepareRun(const Napi::CallbackInfo &info, RunContext &context);
+  // call Session::Run with the run context. Does not access any JavaScript value.
+  void ExecuteRun(RunContext &context);
+  // create the result object of run() or runAsync()
+  Napi::Value CreateRunResult(Napi::Env env, RunContext &context);
+
+  class RunWorker;
+
   // private members
 
   // persistent constructor
@@ -71,6 +103,8 @@ private:
   // session objects
   bool initialized_;
   bool disposed_;
+  // number of runAsync() calls that are not settled yet. The session cannot be disposed until they are.
+  size_t pendingRuns_;
   std::unique_ptr<Ort::Session> session_;
   std::unique_ptr<Ort::RunOptions> defaultRunOptions_;
 
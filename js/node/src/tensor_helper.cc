@@ -175,22 +175,25 @@ Ort::Value NapiValueToOrtValue(Napi::Env env, Napi::Value value, OrtMemoryInfo *
                                 "Tensor.data must be a typed array for numeric tensor.");
 
     auto tensorDataTypedArray = tensorDataValue.As<Napi::TypedArray>();
-    auto typedArrayType = tensorDataValue.As<Napi::TypedArray>().TypedArrayType();
+    auto typedArrayType = tensorDataTypedArray.TypedArrayType();
     ORT_NAPI_THROW_TYPEERROR_IF(DATA_TYPE_TYPEDARRAY_MAP[elemType] != typedArrayType, env,
                                 "Tensor.data must be a typed array (", DATA_TYPE_TYPEDARRAY_MAP[elemType], ") for ",
                                 tensorTypeString, " tensors, but got typed array (", typedArrayType, ").");
 
-    char *buffer = reinterpret_cast<char *>(tensorDataTypedArray.ArrayBuffer().Data());
-    size_t bufferByteOffset = tensorDataTypedArray.ByteOffset();
-    // there is a bug in TypedArray::ElementSize(): https://github.com/nodejs/node-addon-api/pull/705
-    // TODO: change to TypedArray::ByteLength() in next node-addon-api release.
-    size_t bufferByteLength = tensorDataTypedArray.ElementLength() * DATA_TYPE_ELEMENT_SIZE_MAP[elemType];
-    return Ort::Value::CreateTensor(memory_info, buffer + bufferByteOffset, bufferByteLength,
+    // get the data pointer from the typed array directly, so that typed arrays backed by a SharedArrayBuffer are
+    // supported as well. The tensor refers to the memory of the typed array without copying it.
+    void *buffer = nullptr;
+    size_t elementLength = 0;
+    napi_status status = napi_get_typedarray_info(env, tensorDataTypedArray, nullptr, &elementLength, &buffer,
+                                                  nullptr, nullptr);
+    NAPI_THROW_IF_FAILED(env, status, Ort::Value(nullptr));
+    size_t bufferByteLength = elementLength * DATA_TYPE_ELEMENT_SIZE_MAP[elemType];
+    return Ort::Value::CreateTensor(memory_info, buffer, bufferByteLength,
                                     dims.empty() ? nullptr : &dims[0], dims.size(), elemType);
   }
 }
 
-Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &value) {
+Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &&value) {
   Napi::EscapableHandleScope scope(env);
   auto returnValue = Napi::Object::New(env);
 
@@ -245,10 +248,24 @@ Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &value) {
     returnValue.Set("data", Napi::Value(env, stringArray));
   } else {
     // number data
-    // TODO: optimize memory
-    auto arrayBuffer = Napi::ArrayBuffer::New(env, size * DATA_TYPE_ELEMENT_SIZE_MAP[elemType]);
-    if (size > 0) {
-      memcpy(arrayBuffer.Data(), value.GetTensorRawData(), size * DATA_TYPE_ELEMENT_SIZE_MAP[elemType]);
+    size_t byteLength = size * DATA_TYPE_ELEMENT_SIZE_MAP[elemType];
+    napi_value arrayBuffer = nullptr;
+    if (byteLength > 0) {
+      // the array buffer takes the ownership of the OrtValue and refers to its data directly
+      auto owner = std::make_unique<Ort::Value>(std::move(value));
+      napi_status status = napi_create_external_arraybuffer(
+          env, owner->GetTensorMutableRawData(), byteLength,
+          [](napi_env /*env*/, void * /*data*/, void *hint) { delete static_cast<Ort::Value *>(hint); }, owner.get(),
+          &arrayBuffer);
+      if (status == napi_ok) {
+        owner.release();
+      } else {
+        // external buffers are not allowed in some runtimes, e.g. Electron. Copy the data instead.
+        arrayBuffer = Napi::ArrayBuffer::New(env, byteLength);
+        memcpy(Napi::ArrayBuffer(env, arrayBuffer).Data(), owner->GetTensorRawData(), byteLength);
+      }
+    } else {
+      arrayBuffer = Napi::ArrayBuffer::New(env, 0);
     }
     napi_value typedArrayData;
     napi_status status =
@@ -11,5 +11,6 @@
 // convert a Javascript OnnxValue object to an OrtValue object
 Ort::Value NapiValueToOrtValue(Napi::Env env, Napi::Value value, OrtMemoryInfo *memory_info);
 
-// convert an OrtValue object to a Javascript OnnxValue object
-Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &value);
+// convert an OrtValue object to a Javascript OnnxValue object. The data of numeric tensors is not copied: the array
+// buffer takes the ownership of the OrtValue instead.
+Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &&value);
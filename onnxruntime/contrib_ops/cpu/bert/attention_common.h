@@ -140,6 +140,12 @@ constexpr const char* kMinSeqLenForFlashAttentionPackedQKV = "ORT_MIN_SEQ_LEN_FL
 // Default value for the above setting.
 constexpr int kDefaultMinSeqLenForFlashAttentionPackedQKV = 513;
 
+// Minimum total sequence length to use tiled attention with online softmax in CPU Attention and MultiHeadAttention.
+// Below it, the full attention probabilities matrix is computed.
+constexpr const char* kMinSeqLenForCpuFlashAttention = "ORT_MIN_SEQ_LEN_CPU_FLASH_ATTENTION";
+// Default value for the above setting.
+constexpr int kDefaultMinSeqLenForCpuFlashAttention = 1024;
+
 // Environment variable to enable loading more KV data in flight in
 // DecoderMaskedMultiHeadAttention/DecoderMaskedSelfAttention kernels
 constexpr const char* kDecoderMaskedAttentionLoadKVDataInFlight = "ORT_DECODER_MASKED_ATTENTION_LOAD_KV_DATA_IN_FLIGHT";
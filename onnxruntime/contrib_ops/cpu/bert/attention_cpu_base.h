@@ -9,6 +9,7 @@
 #include "core/common/common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -16,7 +17,13 @@ namespace contrib {
 class AttentionCPUBase : public AttentionBase {
  protected:
   AttentionCPUBase(const OpKernelInfo& info, bool require_same_hidden_size)
-      : AttentionBase(info, require_same_hidden_size) {}
+      : AttentionBase(info, require_same_hidden_size) {
+    min_seq_len_for_flash_attention_ = ParseEnvironmentVariableWithDefault<int>(
+        attention::kMinSeqLenForCpuFlashAttention, attention::kDefaultMinSeqLenForCpuFlashAttention);
+  }
+
+  // Minimum total sequence length to use the tiled attention that never materializes the BxNxSxT probabilities.
+  int min_seq_len_for_flash_attention_;
 
   template <typename T>
   Status ApplyAttention(const T* Q,                            // Q data with shape BxNxSxH
@@ -36,7 +43,8 @@ class AttentionCPUBase : public AttentionBase {
                         int v_head_size,                       // head size of V (H_v)
                         int v_hidden_size,                     // hidden size of V (D_v)
                         const Tensor* relative_position_bias,  // bias addition in QK. Its size is BxNxSxT
-                        OpKernelContext* context) const {
+                        OpKernelContext* context,
+                        int kv_batch_repeat = 1) const {       // batch entries of Q sharing one batch entry of K/V
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
@@ -53,13 +61,32 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
 
+    const T* past_data = past != nullptr ? past->Data<T>() : nullptr;
+    T* present_data = present != nullptr ? present->MutableData<T>() : nullptr;
+    const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
+    T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
+    const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
+    T* present_value_data = present_value != nullptr ? present_value->MutableData<T>() : nullptr;
+
+    bool causal = (is_unidirectional_ && sequence_length > 1);
+
+    // Long sequences without mask or bias use tiled attention, which keeps memory use independent of S x T.
+    if (mask_index == nullptr && relative_position_bias == nullptr &&
+        total_sequence_length >= min_seq_len_for_flash_attention_) {
+      ComputeFlashAttention(output->MutableData<T>(), Q, K, V, causal,
+                            batch_size, sequence_length, kv_sequence_length, past_sequence_length,
+                            qk_head_size == 0 ? v_head_size : qk_head_size, v_head_size, v_hidden_size,
+                            past_data, past_key_data, past_value_data,
+                            present_data, present_key_data, present_value_data,
+                            allocator, tp, kv_batch_repeat);
+      return Status::OK();
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    bool causal = (is_unidirectional_ && sequence_length > 1);
-
     void* mask_data = nullptr;
     if (mask_index != nullptr || causal) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(T);
@@ -72,13 +99,6 @@ class AttentionCPUBase : public AttentionBase {
     gsl::span<const int64_t> mask_index_dims = mask_index != nullptr
                                                    ? mask_index->Shape().GetDims()
                                                    : gsl::span<const int64_t>{};
-    const T* past_data = past != nullptr ? past->Data<T>() : nullptr;
-    T* present_data = present != nullptr ? present->MutableData<T>() : nullptr;
-    const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
-    T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
-    const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
-    T* present_value_data = present_value != nullptr ? present_value->MutableData<T>() : nullptr;
-
     const T* relative_position_bias_data = nullptr;
     if (relative_position_bias != nullptr) {
       relative_position_bias_data = relative_position_bias->Data<T>();
@@ -88,7 +108,7 @@ class AttentionCPUBase : public AttentionBase {
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data), causal,
                              batch_size, sequence_length, kv_sequence_length, past_sequence_length,
                              qk_head_size == 0 ? v_head_size : qk_head_size, past_data, past_key_data,
-                             present_data, present_key_data, tp, relative_position_bias_data);
+                             present_data, present_key_data, tp, relative_position_bias_data, kv_batch_repeat);
 
     // Compute the attentionScore * Value: out_tmp(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
     auto out_tmp_data =
@@ -99,12 +119,22 @@ class AttentionCPUBase : public AttentionBase {
                             static_cast<T*>(attention_probs), V,
                             batch_size, sequence_length, kv_sequence_length, past_sequence_length,
                             v_head_size, v_hidden_size, past_data, past_value_data,
-                            present_data, present_value_data, tp);
+                            present_data, present_value_data, tp, kv_batch_repeat);
 
     return Status::OK();
   }
 
  private:
+  // Index of the K/V chunk of the (batch, head) chunk i of Q. When K/V hold one batch entry for every
+  // kv_batch_repeat consecutive batch entries of Q (like the cross attention cache shared by the beams of
+  // one batch entry), the chunk of the shared entry is used.
+  std::ptrdiff_t KVChunkIndex(std::ptrdiff_t i, int kv_batch_repeat) const {
+    if (kv_batch_repeat == 1) {
+      return i;
+    }
+    return (i / num_heads_ / kv_batch_repeat) * num_heads_ + i % num_heads_;
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
@@ -127,7 +157,8 @@ class AttentionCPUBase : public AttentionBase {
                              T* present,                                // present state
                              T* present_key,                            // present key only (if not using present state)
                              ThreadPool* tp,                            // thread pool
-                             const T* relative_position_bias_data       // bias addition matrix with shape BxNxSxT
+                             const T* relative_position_bias_data,      // bias addition matrix with shape BxNxSxT
+                             int kv_batch_repeat                        // batch entries of Q sharing one of K
   ) const {
     const int total_sequence_length = past_sequence_length + kv_sequence_length;               // T = P + L
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;    // P x H
@@ -174,7 +205,7 @@ class AttentionCPUBase : public AttentionBase {
                    static_cast<size_t>(sequence_length) * total_sequence_length * sizeof(T));
           }
 
-          const T* k = K + kv_input_chunk_length * i;
+          const T* k = K + kv_input_chunk_length * KVChunkIndex(i, kv_batch_repeat);
           if (nullptr != present) {
             // Concatenate past_K and K : (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
             k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
@@ -223,7 +254,8 @@ class AttentionCPUBase : public AttentionBase {
                                const T* past_value,       // past value only (if not using past state)
                                T* present,                // present state
                                T* present_value,          // present value only (if not using present state)
-                               ThreadPool* tp) const {
+                               ThreadPool* tp,
+                               int kv_batch_repeat) const {  // batch entries of Q sharing one of V
     const int total_sequence_length = past_sequence_length + kv_sequence_length;                   // T = P + L
     const ptrdiff_t past_chunk_length = SafeInt<ptrdiff_t>(past_sequence_length) * v_head_size;    // P x H_v
     const ptrdiff_t q_input_chunk_length = SafeInt<ptrdiff_t>(sequence_length) * v_head_size;      // S x H_v
@@ -243,7 +275,7 @@ class AttentionCPUBase : public AttentionBase {
 
     ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
-        const T* v = V + kv_input_chunk_length * i;
+        const T* v = V + kv_input_chunk_length * KVChunkIndex(i, kv_batch_repeat);
         if (nullptr != present) {
           // Concatenate past_V and V: (BxNx)PxH_v, (BxNx)LxH_v -> (BxNx)TxH_v
           v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
@@ -272,6 +304,191 @@ class AttentionCPUBase : public AttentionBase {
       }
     });
   }
+
+  // Tile sizes of the tiled attention. A Q tile, a K tile, a V tile, the scores tile and the output accumulator
+  // take about 224KB for head size 128, so they stay resident in L2 while the K/V tiles are streamed.
+  static constexpr int kFlashQBlockSize = 64;
+  static constexpr int kFlashKVBlockSize = 128;
+
+  // Helper function to compute attention with tiled Q/K/V and online softmax:
+  //  output(B, S, N, H_v) = Softmax(alpha x Q(B, N, S, H) x K'(B, N, H, T)) x V(B, N, T, H_v)
+  // Each task owns one Q tile of one (batch, head) and keeps a running row max and row sum while it streams over
+  // the K/V tiles, so only a kFlashQBlockSize x kFlashKVBlockSize scores tile exists at any time.
+  template <typename T>
+  void ComputeFlashAttention(T* output,                 // output buffer with size BxSxNxH_v
+                             const T* Q,                // Q data. Its size is BxNxSxH
+                             const T* K,                // k data. Its size is BxNxLxH
+                             const T* V,                // V value with size BxNxLxH_v
+                             bool causal,               // has causal (unidirectional) mask
+                             int batch_size,            // batch size of self-attention
+                             int sequence_length,       // sequence length of self-attention (S)
+                             int kv_sequence_length,    // sequence length of cross-attention (L)
+                             int past_sequence_length,  // sequence length of past state
+                             int head_size,             // head size of Q or K (H)
+                             int v_head_size,           // head size of V (H_v)
+                             int v_hidden_size,         // hidden size of V (D_v)
+                             const T* past,             // past state
+                             const T* past_key,         // past key only (if not using past state)
+                             const T* past_value,       // past value only (if not using past state)
+                             T* present,                // present state
+                             T* present_key,            // present key only (if not using present state)
+                             T* present_value,          // present value only (if not using present state)
+                             AllocatorPtr allocator,
+                             ThreadPool* tp,
+                             int kv_batch_repeat) const {  // batch entries of Q sharing one of K/V
+    const int total_sequence_length = past_sequence_length + kv_sequence_length;                    // T = P + L
+    const size_t k_past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;     // P x H
+    const size_t k_input_chunk_length = static_cast<size_t>(kv_sequence_length) * head_size;      // L x H
+    const size_t k_present_chunk_length = k_past_chunk_length + k_input_chunk_length;            // T x H
+    const size_t v_past_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;   // P x H_v
+    const size_t v_input_chunk_length = static_cast<size_t>(kv_sequence_length) * v_head_size;    // L x H_v
+    const size_t v_present_chunk_length = v_past_chunk_length + v_input_chunk_length;            // T x H_v
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;         // S x H
+    const int loop_len = batch_size * num_heads_;
+
+    // Past and present state hold all the K values followed by all the V values.
+    const T* past_v = past;
+    T* present_v = present;
+    if (nullptr != past) {
+      past_v += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * past_sequence_length * v_head_size;
+    }
+    if (nullptr != present) {
+      present_v += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * total_sequence_length * v_head_size;
+    }
+
+    const T* k_all = K;
+    const T* v_all = V;
+    size_t k_chunk_length = k_input_chunk_length;
+    size_t v_chunk_length = v_input_chunk_length;
+    if (nullptr != present || nullptr != present_key) {
+      // Concatenate past and current K/V : (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
+      const double concat_cost = static_cast<double>(total_sequence_length) * (head_size + v_head_size);
+      ThreadPool::TryParallelFor(tp, loop_len, concat_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const std::ptrdiff_t kv_i = KVChunkIndex(i, kv_batch_repeat);
+          if (nullptr != present) {
+            ConcatStateChunk(past, K + k_input_chunk_length * kv_i, present,
+                             k_past_chunk_length, k_present_chunk_length, i);
+            ConcatStateChunk(past_v, V + v_input_chunk_length * kv_i, present_v,
+                             v_past_chunk_length, v_present_chunk_length, i);
+          } else {
+            ConcatStateChunk(past_key, K + k_input_chunk_length * kv_i, present_key,
+                             k_past_chunk_length, k_present_chunk_length, i);
+            ConcatStateChunk(past_value, V + v_input_chunk_length * kv_i, present_value,
+                             v_past_chunk_length, v_present_chunk_length, i);
+          }
+        }
+      });
+      k_all = nullptr != present ? present : present_key;
+      v_all = nullptr != present ? present_v : present_value;
+      k_chunk_length = k_present_chunk_length;
+      v_chunk_length = v_present_chunk_length;
+      // the present state has a chunk for every batch entry of Q
+      kv_batch_repeat = 1;
+    }
+
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    const int q_block_count = (sequence_length + kFlashQBlockSize - 1) / kFlashQBlockSize;
+    const size_t scratch_length = static_cast<size_t>(kFlashQBlockSize) * (kFlashKVBlockSize + v_head_size + 2);
+
+    const double cost = static_cast<double>(kFlashQBlockSize) * total_sequence_length * (head_size + v_head_size);
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(loop_len) * q_block_count, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      auto scratch_data = allocator->Alloc(scratch_length * sizeof(T));
+      BufferUniquePtr scratch_buffer(scratch_data, BufferDeleter(allocator));
+      // Scores tile (Br x Bc), output accumulator (Br x H_v), running max (Br) and running sum (Br) of each row.
+      T* scores = reinterpret_cast<T*>(scratch_data);
+      T* out_acc = scores + static_cast<size_t>(kFlashQBlockSize) * kFlashKVBlockSize;
+      T* row_max = out_acc + static_cast<size_t>(kFlashQBlockSize) * v_head_size;
+      T* row_sum = row_max + kFlashQBlockSize;
+
+      for (std::ptrdiff_t job = begin; job != end; ++job) {
+        const std::ptrdiff_t i = job / q_block_count;
+        const int q_start = static_cast<int>(job % q_block_count) * kFlashQBlockSize;
+        const int q_rows = std::min(kFlashQBlockSize, sequence_length - q_start);
+
+        const T* q = Q + q_input_chunk_length * i + static_cast<size_t>(q_start) * head_size;
+        const T* k = k_all + k_chunk_length * KVChunkIndex(i, kv_batch_repeat);
+        const T* v = v_all + v_chunk_length * KVChunkIndex(i, kv_batch_repeat);
+
+        // With causal mask, the last row of this Q tile attends to at most P + q_start + q_rows keys.
+        const int kv_end = causal ? std::min(total_sequence_length, past_sequence_length + q_start + q_rows)
+                                  : total_sequence_length;
+
+        for (int r = 0; r < q_rows; r++) {
+          row_max[r] = std::numeric_limits<T>::lowest();
+          row_sum[r] = 0.0f;
+        }
+        memset(out_acc, 0, static_cast<size_t>(q_rows) * v_head_size * sizeof(T));
+
+        for (int kv_start = 0; kv_start < kv_end; kv_start += kFlashKVBlockSize) {
+          const int kv_cols = std::min(kFlashKVBlockSize, kv_end - kv_start);
+
+          // scores(Br x Bc) = alpha x Q(Br x H) x K'(H x Bc)
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, q_rows, kv_cols, head_size, alpha,
+                                      q, head_size, k + static_cast<size_t>(kv_start) * head_size, head_size,
+                                      0.0f, scores, kv_cols, nullptr);
+
+          for (int r = 0; r < q_rows; r++) {
+            T* row = scores + static_cast<size_t>(r) * kv_cols;
+            const int valid_cols = causal
+                                       ? std::min(kv_cols, past_sequence_length + q_start + r + 1 - kv_start)
+                                       : kv_cols;
+            if (valid_cols <= 0) {
+              memset(row, 0, static_cast<size_t>(kv_cols) * sizeof(T));
+              continue;
+            }
+
+            T tile_max = row[0];
+            for (int c = 1; c < valid_cols; c++) {
+              tile_max = std::max(tile_max, row[c]);
+            }
+            const T new_max = std::max(row_max[r], tile_max);
+            const T correction = expf(row_max[r] - new_max);
+
+            for (int c = 0; c < valid_cols; c++) {
+              row[c] -= new_max;
+            }
+            MlasComputeExp(row, row, static_cast<size_t>(valid_cols));
+            T tile_sum = 0.0f;
+            for (int c = 0; c < valid_cols; c++) {
+              tile_sum += row[c];
+            }
+            for (int c = valid_cols; c < kv_cols; c++) {
+              row[c] = 0.0f;
+            }
+
+            row_max[r] = new_max;
+            row_sum[r] = row_sum[r] * correction + tile_sum;
+            if (correction != 1.0f) {
+              T* acc = out_acc + static_cast<size_t>(r) * v_head_size;
+              for (int h = 0; h < v_head_size; h++) {
+                acc[h] *= correction;
+              }
+            }
+          }
+
+          // out_acc(Br x H_v) += scores(Br x Bc) x V(Bc x H_v)
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, q_rows, v_head_size, kv_cols, 1.0f,
+                                      scores, kv_cols, v + static_cast<size_t>(kv_start) * v_head_size, v_head_size,
+                                      1.0f, out_acc, v_head_size, nullptr);
+        }
+
+        // Normalize and transpose: out_acc(Br, H_v) -> output(B, S, N, H_v)
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        for (int r = 0; r < q_rows; r++) {
+          const T inv_sum = 1.0f / row_sum[r];
+          const T* src = out_acc + static_cast<size_t>(r) * v_head_size;
+          T* dest = output + (SafeInt<ptrdiff_t>(batch_index) * sequence_length + q_start + r) * v_hidden_size +
+                    static_cast<ptrdiff_t>(head_index) * v_head_size;
+          for (int h = 0; h < v_head_size; h++) {
+            dest[h] = src[h] * inv_sum;
+          }
+        }
+      }
+    });
+  }
 };
 
 }  // namespace contrib
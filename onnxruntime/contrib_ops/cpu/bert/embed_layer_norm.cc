@@ -40,8 +40,17 @@ EmbedLayerNorm<T>::EmbedLayerNorm(const OpKernelInfo& op_kernel_info)
 
 template <typename T>
 Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
-  ORT_RETURN_IF_ERROR(embed_layer_norm::CheckInputs(context));
   const Tensor* input_ids = context->Input<Tensor>(0);
+
+  // Packed input_ids of shape (token_count) hold the real tokens of all sequences with padding removed.
+  // They are processed as a single sequence of token_count tokens indexed by the explicit position_ids.
+  const bool is_packed = input_ids->Shape().NumDimensions() == 1;
+  if (is_packed) {
+    ORT_RETURN_IF_ERROR(embed_layer_norm::CheckPackedInputs(context));
+  } else {
+    ORT_RETURN_IF_ERROR(embed_layer_norm::CheckInputs(context));
+  }
+
   const Tensor* segment_ids = context->Input<Tensor>(1);  // optional. nullptr if it's distill-bert
   const Tensor* word_embedding = context->Input<Tensor>(2);
   const Tensor* position_embedding = context->Input<Tensor>(3);
@@ -54,17 +63,25 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   const auto& input_dims = input_ids->Shape().GetDims();
   int64_t hidden_size = word_embedding->Shape()[1];
 
-  TensorShape output_shape({input_dims[0], input_dims[1], hidden_size});
+  int batch_size = is_packed ? 1 : static_cast<int>(input_dims[0]);
+  int sequence_length = is_packed ? static_cast<int>(input_dims[0]) : static_cast<int>(input_dims[1]);
+
+  TensorShape output_shape = is_packed ? TensorShape({input_dims[0], hidden_size})
+                                       : TensorShape({input_dims[0], input_dims[1], hidden_size});
   Tensor* output = context->Output(0, output_shape);
 
-  TensorShape mask_index_shape({input_dims[0]});
-  Tensor* mask_index = context->Output(1, mask_index_shape);
+  Tensor* mask_index = nullptr;
+  if (is_packed) {
+    if (context->OutputCount() > 1 && context->Output(1, TensorShape({0})) != nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "mask_index output is not supported for packed input_ids");
+    }
+  } else {
+    TensorShape mask_index_shape({input_dims[0]});
+    mask_index = context->Output(1, mask_index_shape);
+  }
 
   Tensor* embedding_sum = context->Output(2, output_shape);
 
-  int batch_size = static_cast<int>(input_dims[0]);
-  int sequence_length = static_cast<int>(input_dims[1]);
-
   int word_embedding_length = static_cast<int>(word_embedding->Shape()[0]);
   int position_embedding_length = static_cast<int>(position_embedding->Shape()[0]);
   int segment_embedding_length = (nullptr == segment_embedding) ? 0 : static_cast<int>(segment_embedding->Shape()[0]);
@@ -77,7 +94,7 @@ Status EmbedLayerNorm<T>::Compute(OpKernelContext* context) const {
   const T* gamma_data = gamma->Data<T>();
   const T* beta_data = beta->Data<T>();
   const int32_t* position_ids_data = (nullptr == position_ids) ? nullptr : position_ids->Data<int32_t>();
-  const bool broadcast_position_ids = (nullptr != position_ids && position_ids->Shape()[0] == 1) ? true : false;
+  const bool broadcast_position_ids = (!is_packed && nullptr != position_ids && position_ids->Shape()[0] == 1) ? true : false;
   T* output_data = output->MutableData<T>();
   T* embedding_sum_data = (embedding_sum != nullptr) ? embedding_sum->MutableData<T>() : nullptr;
 
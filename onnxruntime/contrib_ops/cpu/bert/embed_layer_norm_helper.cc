@@ -12,47 +12,13 @@ namespace onnxruntime {
 namespace contrib {
 namespace embed_layer_norm {
 
-Status CheckInputs(const OpKernelContext* context, bool quantizedVersion) {
-  const Tensor* input_ids = context->Input<Tensor>(0);
-  const Tensor* segment_ids = context->Input<Tensor>(1);  // optional. nullptr if it's distill-bert
+// Checks the embedding tables and the layer normalization weights.
+static Status CheckEmbeddingInputs(const OpKernelContext* context) {
   const Tensor* word_embedding = context->Input<Tensor>(2);
   const Tensor* position_embedding = context->Input<Tensor>(3);
   const Tensor* segment_embedding = context->Input<Tensor>(4);  // optional. nullptr if it's distill-bert
   const Tensor* gamma = context->Input<Tensor>(5);
   const Tensor* beta = context->Input<Tensor>(6);
-  const Tensor* mask = context->Input<Tensor>(7);  // optional. nullptr if not provided
-
-  if (!quantizedVersion) {
-    const Tensor* position_ids = context->Input<Tensor>(8);  // optional. nullptr if not provided
-
-    if (nullptr != position_ids) {
-      if (input_ids->Shape()[1] != position_ids->Shape()[1]) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                               "input_ids and position_ids shall have same sequence_length");
-      }
-      if (position_ids->Shape()[0] != input_ids->Shape()[0] &&
-          position_ids->Shape()[0] != 1) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                               "position_ids's first dimension shall be 1 or batch_size");
-      }
-    }
-  }
-
-  if (nullptr != segment_ids && input_ids->Shape() != segment_ids->Shape()) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "Input 0 and 1 shall have same shape");
-  }
-
-  if (nullptr != mask && input_ids->Shape() != mask->Shape()) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "Input 0 and 7 (mask) shall have same shape");
-  }
-
-  const auto& input_dims = input_ids->Shape().GetDims();
-  if (input_dims.size() != 2) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                           "input_ids is expected to have 2 dimensions, got ", input_dims.size());
-  }
 
   const auto& word_embedding_dims = word_embedding->Shape().GetDims();
   if (word_embedding_dims.size() != 2) {
@@ -109,6 +75,76 @@ Status CheckInputs(const OpKernelContext* context, bool quantizedVersion) {
   return Status::OK();
 }
 
+Status CheckInputs(const OpKernelContext* context, bool quantizedVersion) {
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const Tensor* segment_ids = context->Input<Tensor>(1);  // optional. nullptr if it's distill-bert
+  const Tensor* mask = context->Input<Tensor>(7);         // optional. nullptr if not provided
+
+  if (!quantizedVersion) {
+    const Tensor* position_ids = context->Input<Tensor>(8);  // optional. nullptr if not provided
+
+    if (nullptr != position_ids) {
+      if (input_ids->Shape()[1] != position_ids->Shape()[1]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "input_ids and position_ids shall have same sequence_length");
+      }
+      if (position_ids->Shape()[0] != input_ids->Shape()[0] &&
+          position_ids->Shape()[0] != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "position_ids's first dimension shall be 1 or batch_size");
+      }
+    }
+  }
+
+  if (nullptr != segment_ids && input_ids->Shape() != segment_ids->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 and 1 shall have same shape");
+  }
+
+  if (nullptr != mask && input_ids->Shape() != mask->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 and 7 (mask) shall have same shape");
+  }
+
+  const auto& input_dims = input_ids->Shape().GetDims();
+  if (input_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input_ids is expected to have 2 dimensions, got ", input_dims.size());
+  }
+
+  return CheckEmbeddingInputs(context);
+}
+
+Status CheckPackedInputs(const OpKernelContext* context) {
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const Tensor* segment_ids = context->Input<Tensor>(1);   // optional. nullptr if it's distill-bert
+  const Tensor* mask = context->Input<Tensor>(7);          // not supported for packed input
+  const Tensor* position_ids = context->Input<Tensor>(8);  // required for packed input
+
+  const auto& input_dims = input_ids->Shape().GetDims();
+  if (input_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Packed input_ids is expected to have 1 dimension, got ", input_dims.size());
+  }
+
+  if (nullptr == position_ids || position_ids->Shape() != input_ids->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "position_ids with the same shape as input_ids is required for packed input_ids");
+  }
+
+  if (nullptr != segment_ids && input_ids->Shape() != segment_ids->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 and 1 shall have same shape");
+  }
+
+  if (nullptr != mask) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "mask is not supported for packed input_ids");
+  }
+
+  return CheckEmbeddingInputs(context);
+}
+
 }  // namespace embed_layer_norm
 }  // namespace contrib
 }  // namespace onnxruntime
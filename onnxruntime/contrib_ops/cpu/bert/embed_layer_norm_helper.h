@@ -14,6 +14,10 @@ namespace embed_layer_norm {
 
 Status CheckInputs(const OpKernelContext* context, bool quantizedVersion = false);
 
+// Checks inputs in packing mode, where input_ids, segment_ids and position_ids have shape (token_count)
+// and only contain the real tokens (see RemovePadding). Only supported by the CPU kernel.
+Status CheckPackedInputs(const OpKernelContext* context);
+
 }  // namespace embed_layer_norm
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,292 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "attention_helper.h"
+
+#include "core/common/common.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class GQAAttentionBase {
+ protected:
+  GQAAttentionBase(const OpKernelInfo& info) {
+    int64_t num_heads = 0;
+    ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+    int64_t kv_num_heads = 0;
+    ORT_ENFORCE(info.GetAttr("kv_num_heads", &kv_num_heads).IsOK() && kv_num_heads > 0 &&
+                num_heads % kv_num_heads == 0);
+    num_heads_ = static_cast<int>(num_heads);
+    kv_num_heads_ = static_cast<int>(kv_num_heads);
+
+    local_window_size_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1));
+    do_rotary_ = info.GetAttrOrDefault<int64_t>("do_rotary", 0) == 1;
+    rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
+    scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+    kv_cache_bit_width_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("kv_cache_bit_width", 0));
+    ORT_ENFORCE(kv_cache_bit_width_ == 0 || kv_cache_bit_width_ == 8, "kv_cache_bit_width shall be 0 or 8.");
+  }
+
+  int num_heads_;     // number of attention heads of Q
+  int kv_num_heads_;  // number of attention heads of K or V
+  int local_window_size_;
+  bool do_rotary_;
+  bool rotary_interleaved_;
+  float scale_;
+  int kv_cache_bit_width_;  // 8 for an int8 KV cache with a scale per token of each kv head, 0 for a cache of T
+
+  // Rotate one head vector of length head_size by the cos/sin cache entries at the given position.
+  // Cache is (M, rotary_dim/2). Dimensions beyond the rotary dimension are copied through.
+  template <typename T>
+  static void ApplyRotary(const T* input,
+                          T* output,
+                          const T* cos_cache,
+                          const T* sin_cache,
+                          int position,
+                          int rotary_dim,
+                          int head_size,
+                          bool interleaved) {
+    static_assert(std::is_same_v<T, float>, "ApplyRotary only supports float.");
+    const int half_rotary_dim = rotary_dim / 2;
+    MlasRotaryEmbedOneRow(input, sin_cache + position * half_rotary_dim, cos_cache + position * half_rotary_dim,
+                          static_cast<size_t>(rotary_dim), interleaved, output);
+    for (int i = rotary_dim; i < head_size; i++) {
+      output[i] = input[i];
+    }
+  }
+
+  // Quantizes one head vector of a token to int8 with a symmetric scale, so a cache row is scale * int8 values.
+  template <typename T>
+  static void QuantizeHeadVector(const T* input, int8_t* output, float* scale, int head_size) {
+    float max_abs = 0.0f;
+    for (int i = 0; i < head_size; i++) {
+      max_abs = std::max(max_abs, std::abs(static_cast<float>(input[i])));
+    }
+    *scale = max_abs / 127.0f;
+    const float inverse_scale = max_abs == 0.0f ? 0.0f : 127.0f / max_abs;
+    for (int i = 0; i < head_size; i++) {
+      output[i] = static_cast<int8_t>(std::nearbyint(static_cast<float>(input[i]) * inverse_scale));
+    }
+  }
+
+  template <typename T>
+  static void DequantizeHeadVectors(const int8_t* input, const float* scales, T* output, int rows, int head_size) {
+    for (int r = 0; r < rows; r++) {
+      const float scale = scales[r];
+      for (int i = 0; i < head_size; i++) {
+        output[r * head_size + i] = static_cast<T>(scale * input[r * head_size + i]);
+      }
+    }
+  }
+
+  // Computes causal grouped query attention. Work is split over (batch, kv_head) pairs: each task appends the
+  // new K/V tokens of its kv head to the present cache and then computes all the query heads that share it,
+  // so the K/V rows of the group stay hot in cache.
+  //
+  // When past and present share one buffer (kv_share_buffer), only the new tokens are written in place at
+  // offset seqlens_k[b]. Otherwise the valid past rows are copied into present before appending.
+  //
+  // With an int8 cache (TCache is int8_t), the new tokens are quantized as they are appended and each task
+  // dequantizes the rows of its kv head once into a scratch buffer that all the query heads of the group read.
+  template <typename T, typename TCache>
+  Status ApplyAttention(const T* query,                  // Q data with shape BxSxD or BxSx(D+2*D_kv) when packed
+                        const T* key,                    // K data with shape BxSxD_kv (nullptr when packed)
+                        const T* value,                  // V data with shape BxSxD_kv (nullptr when packed)
+                        const TCache* past_key,          // past K with shape BxN_kvxS*xH, may alias present_key
+                        const TCache* past_value,        // past V with shape BxN_kvxS*xH, may alias present_value
+                        const float* past_key_scale,     // past K scales with shape BxN_kvxS* for an int8 cache
+                        const float* past_value_scale,   // past V scales with shape BxN_kvxS* for an int8 cache
+                        T* output,                       // output with shape BxSxD
+                        TCache* present_key,             // present K with shape BxN_kvxS'xH
+                        TCache* present_value,           // present V with shape BxN_kvxS'xH
+                        float* present_key_scale,        // present K scales with shape BxN_kvxS' for an int8 cache
+                        float* present_value_scale,      // present V scales with shape BxN_kvxS' for an int8 cache
+                        const int32_t* seqlens_k,        // past sequence length of each batch for token generation
+                        const T* cos_cache,              // cos cache with shape MxR/2, used when do_rotary_
+                        const T* sin_cache,              // sin cache with shape MxR/2, used when do_rotary_
+                        int rotary_dim,                  // rotary dimension (R)
+                        const GroupQueryAttentionParameters& parameters,
+                        AllocatorPtr allocator,
+                        concurrency::ThreadPool* tp) const {
+    constexpr bool quantized_cache = std::is_same<TCache, int8_t>::value;
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int past_buffer_length = parameters.seqlen_past_kv_cache;
+    const int present_buffer_length = parameters.seqlen_present_kv_cache;
+    const bool kv_share_buffer = parameters.kv_share_buffer;
+    const int kv_num_heads = kv_num_heads_;
+    const int num_heads = num_heads_;
+    const int group_size = num_heads / kv_num_heads;
+
+    const int hidden_size = num_heads * head_size;
+    const int kv_hidden_size = kv_num_heads * head_size;
+    // Row stride of one token in the Q and K/V inputs.
+    const int q_stride = parameters.is_packed_qkv ? hidden_size + 2 * kv_hidden_size : hidden_size;
+    const int kv_stride = parameters.is_packed_qkv ? q_stride : kv_hidden_size;
+    const T* k_input = parameters.is_packed_qkv ? query + hidden_size : key;
+    const T* v_input = parameters.is_packed_qkv ? query + hidden_size + kv_hidden_size : value;
+
+    const float alpha = parameters.scale == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : parameters.scale;
+
+    // Q heads in BxNxSxH layout, with rotary applied.
+    size_t q_bytes = SafeInt<size_t>(batch_size) * num_heads * sequence_length * head_size * sizeof(T);
+    auto q_data = allocator->Alloc(q_bytes);
+    BufferUniquePtr q_buffer(q_data, BufferDeleter(allocator));
+    T* q_heads = reinterpret_cast<T*>(q_data);
+
+    // Attention probabilities of each (batch, head) use an SxT slice, where T is at most present_buffer_length.
+    const size_t probs_matrix_size = SafeInt<size_t>(sequence_length) * present_buffer_length;
+    size_t probs_bytes = SafeInt<size_t>(batch_size) * num_heads * probs_matrix_size * sizeof(T);
+    auto probs_data = allocator->Alloc(probs_bytes);
+    BufferUniquePtr probs_buffer(probs_data, BufferDeleter(allocator));
+    T* attention_probs = reinterpret_cast<T*>(probs_data);
+
+    const size_t present_head_size = SafeInt<size_t>(present_buffer_length) * head_size;
+    const size_t past_head_size = SafeInt<size_t>(past_buffer_length) * head_size;
+
+    const int loop_len = batch_size * kv_num_heads;
+    const double cost = static_cast<double>(group_size) * sequence_length * present_buffer_length * head_size * 2;
+    concurrency::ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // the dequantized K and V rows of the kv head, and a rotated row before it is quantized
+      BufferUniquePtr dequant_buffer;
+      [[maybe_unused]] T* k_dequant = nullptr;
+      [[maybe_unused]] T* v_dequant = nullptr;
+      [[maybe_unused]] T* rotated_row = nullptr;
+      if constexpr (quantized_cache) {
+        auto dequant_data = allocator->Alloc((SafeInt<size_t>(present_head_size) * 2 + head_size) * sizeof(T));
+        dequant_buffer = BufferUniquePtr(dequant_data, BufferDeleter(allocator));
+        k_dequant = reinterpret_cast<T*>(dequant_data);
+        v_dequant = k_dequant + present_head_size;
+        rotated_row = v_dequant + present_head_size;
+      }
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int b = static_cast<int>(i / kv_num_heads);
+        const int kv_n = static_cast<int>(i % kv_num_heads);
+        const int past_seqlen = parameters.is_prompt ? 0 : seqlens_k[b];
+        const int total_seqlen = past_seqlen + sequence_length;
+
+        TCache* k_present = present_key + (b * kv_num_heads + kv_n) * present_head_size;
+        TCache* v_present = present_value + (b * kv_num_heads + kv_n) * present_head_size;
+        [[maybe_unused]] float* k_present_scale = nullptr;
+        [[maybe_unused]] float* v_present_scale = nullptr;
+        if constexpr (quantized_cache) {
+          k_present_scale = present_key_scale + (b * kv_num_heads + kv_n) * present_buffer_length;
+          v_present_scale = present_value_scale + (b * kv_num_heads + kv_n) * present_buffer_length;
+        }
+
+        if (!kv_share_buffer && past_seqlen > 0) {
+          const TCache* k_past = past_key + (b * kv_num_heads + kv_n) * past_head_size;
+          const TCache* v_past = past_value + (b * kv_num_heads + kv_n) * past_head_size;
+          memcpy(k_present, k_past, SafeInt<size_t>(past_seqlen) * head_size * sizeof(TCache));
+          memcpy(v_present, v_past, SafeInt<size_t>(past_seqlen) * head_size * sizeof(TCache));
+          if constexpr (quantized_cache) {
+            memcpy(k_present_scale, past_key_scale + (b * kv_num_heads + kv_n) * past_buffer_length,
+                   past_seqlen * sizeof(float));
+            memcpy(v_present_scale, past_value_scale + (b * kv_num_heads + kv_n) * past_buffer_length,
+                   past_seqlen * sizeof(float));
+          }
+        }
+
+        // Append the new tokens after the valid past rows.
+        for (int s = 0; s < sequence_length; s++) {
+          const int position = past_seqlen + s;
+          const T* k_src = k_input + (SafeInt<size_t>(b) * sequence_length + s) * kv_stride + kv_n * head_size;
+          const T* v_src = v_input + (SafeInt<size_t>(b) * sequence_length + s) * kv_stride + kv_n * head_size;
+          TCache* k_dst = k_present + SafeInt<size_t>(position) * head_size;
+          TCache* v_dst = v_present + SafeInt<size_t>(position) * head_size;
+          if constexpr (quantized_cache) {
+            if (do_rotary_) {
+              ApplyRotary(k_src, rotated_row, cos_cache, sin_cache, position, rotary_dim, head_size,
+                          rotary_interleaved_);
+              k_src = rotated_row;
+            }
+            QuantizeHeadVector(k_src, k_dst, k_present_scale + position, head_size);
+            QuantizeHeadVector(v_src, v_dst, v_present_scale + position, head_size);
+          } else {
+            if (do_rotary_) {
+              ApplyRotary(k_src, k_dst, cos_cache, sin_cache, position, rotary_dim, head_size, rotary_interleaved_);
+            } else {
+              memcpy(k_dst, k_src, head_size * sizeof(T));
+            }
+            memcpy(v_dst, v_src, head_size * sizeof(T));
+          }
+        }
+
+        const T* k_attend = nullptr;
+        const T* v_attend = nullptr;
+        if constexpr (quantized_cache) {
+          DequantizeHeadVectors(k_present, k_present_scale, k_dequant, total_seqlen, head_size);
+          DequantizeHeadVectors(v_present, v_present_scale, v_dequant, total_seqlen, head_size);
+          k_attend = k_dequant;
+          v_attend = v_dequant;
+        } else {
+          k_attend = k_present;
+          v_attend = v_present;
+        }
+
+        for (int g = 0; g < group_size; g++) {
+          const int n = kv_n * group_size + g;
+          T* q = q_heads + (SafeInt<size_t>(b) * num_heads + n) * sequence_length * head_size;
+          for (int s = 0; s < sequence_length; s++) {
+            const T* q_src = query + (SafeInt<size_t>(b) * sequence_length + s) * q_stride + n * head_size;
+            if (do_rotary_) {
+              ApplyRotary(q_src, q + s * head_size, cos_cache, sin_cache, past_seqlen + s, rotary_dim, head_size,
+                          rotary_interleaved_);
+            } else {
+              memcpy(q + s * head_size, q_src, head_size * sizeof(T));
+            }
+          }
+
+          // probs(S x T) = alpha * Q(S x H) x K'(H x T), stored with leading dimension T.
+          T* probs = attention_probs + (SafeInt<size_t>(b) * num_heads + n) * probs_matrix_size;
+          math::GemmEx<T, concurrency::ThreadPool>(CblasNoTrans, CblasTrans,
+                                                   sequence_length, total_seqlen, head_size, alpha,
+                                                   q, head_size, k_attend, head_size,
+                                                   0.0f, probs, total_seqlen, nullptr);
+
+          // Causal softmax, optionally restricted to local_window_size_ keys on the left.
+          for (int s = 0; s < sequence_length; s++) {
+            T* row = probs + s * total_seqlen;
+            const int causal_end = past_seqlen + s + 1;
+            const int window_start = (local_window_size_ > 0 && causal_end > local_window_size_ + 1)
+                                         ? causal_end - local_window_size_ - 1
+                                         : 0;
+            for (int t = 0; t < window_start; t++) {
+              row[t] = 0.0f;
+            }
+            ComputeAttentionSoftmaxInplace(row + window_start, 1, causal_end - window_start, nullptr);
+            for (int t = causal_end; t < total_seqlen; t++) {
+              row[t] = 0.0f;
+            }
+          }
+
+          // output(S x H) = probs(S x T) x V(T x H), written directly in BxSxNxH layout.
+          T* out = output + (SafeInt<size_t>(b) * sequence_length * num_heads + n) * head_size;
+          math::GemmEx<T, concurrency::ThreadPool>(CblasNoTrans, CblasNoTrans,
+                                                   sequence_length, head_size, total_seqlen, 1.0f,
+                                                   probs, total_seqlen, v_attend, head_size,
+                                                   0.0f, out, hidden_size, nullptr);
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
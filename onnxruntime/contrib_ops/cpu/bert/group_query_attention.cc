@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/group_query_attention.h"
+#include "contrib_ops/cpu/bert/group_query_attention_helper.h"
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+#include <vector>
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+// These ops are internal-only, so register outside of onnx
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GroupQueryAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T_SCALE", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>())
+        .MayInplace(3, 1)
+        .MayInplace(4, 2)
+        .MayInplace(9, 3)
+        .MayInplace(10, 4),
+    GroupQueryAttention<float>);
+
+template <typename T>
+GroupQueryAttention<T>::GroupQueryAttention(const OpKernelInfo& info) : OpKernel(info), GQAAttentionBase(info) {}
+
+template <typename T>
+Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* query = context->Input<Tensor>(0);
+  const Tensor* key = context->Input<Tensor>(1);
+  const Tensor* value = context->Input<Tensor>(2);
+  const Tensor* past_key = context->Input<Tensor>(3);
+  const Tensor* past_value = context->Input<Tensor>(4);
+  const Tensor* seqlens_k = context->Input<Tensor>(5);
+  const Tensor* total_seqlen = context->Input<Tensor>(6);
+  const Tensor* cos_cache = context->Input<Tensor>(7);
+  const Tensor* sin_cache = context->Input<Tensor>(8);
+
+  GroupQueryAttentionParameters parameters = {};
+  ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
+                                                                key,
+                                                                value,
+                                                                past_key,
+                                                                past_value,
+                                                                cos_cache,
+                                                                sin_cache,
+                                                                &parameters,
+                                                                num_heads_,
+                                                                kv_num_heads_,
+                                                                seqlens_k,
+                                                                total_seqlen,
+                                                                false,
+                                                                scale_));
+  parameters.local_window_size = local_window_size_;
+  parameters.do_rotary = do_rotary_;
+  parameters.rotary_interleaved = rotary_interleaved_;
+
+  if (do_rotary_ && (cos_cache == nullptr || sin_cache == nullptr)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "cos_cache and sin_cache must be provided when do_rotary is set.");
+  }
+  const int rotary_dim = do_rotary_ ? static_cast<int>(cos_cache->Shape()[1]) * 2 : 0;
+
+  const int batch_size = parameters.batch_size;
+  const int sequence_length = parameters.sequence_length;
+
+  TensorShapeVector output_shape(3);
+  output_shape[0] = static_cast<int64_t>(batch_size);
+  output_shape[1] = static_cast<int64_t>(sequence_length);
+  output_shape[2] = static_cast<int64_t>(parameters.hidden_size);
+  Tensor* output = context->Output(0, output_shape);
+
+  std::vector<int64_t> present_dims = {
+      batch_size, parameters.kv_num_heads, parameters.seqlen_present_kv_cache, parameters.head_size};
+  TensorShape present_shape(present_dims);
+  Tensor* present_key = context->Output(1, present_shape);
+  Tensor* present_value = context->Output(2, present_shape);
+  if (present_key == nullptr || present_value == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Outputs 'present_key' and 'present_value' are required by GroupQueryAttention.");
+  }
+
+  const bool quantized_cache = kv_cache_bit_width_ == 8;
+  const MLDataType cache_type = quantized_cache ? DataTypeImpl::GetType<int8_t>() : DataTypeImpl::GetType<T>();
+  if ((past_key != nullptr && past_key->DataType() != cache_type) ||
+      (past_value != nullptr && past_value->DataType() != cache_type)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "past_key and past_value shall be ", quantized_cache ? "int8" : "of the type of query",
+                           " when kv_cache_bit_width is ", kv_cache_bit_width_, ".");
+  }
+
+  const void* past_key_data = past_key == nullptr ? nullptr : past_key->DataRaw();
+  const void* past_value_data = past_value == nullptr ? nullptr : past_value->DataRaw();
+  void* present_key_data = present_key->MutableDataRaw();
+  void* present_value_data = present_value->MutableDataRaw();
+
+  // When the allocation planner reuses past_key/past_value for present_key/present_value, the cache is updated
+  // in place and only the new tokens are written.
+  parameters.kv_share_buffer = past_key_data != nullptr && past_key_data == present_key_data;
+  if (parameters.kv_share_buffer && past_value_data != present_value_data) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "past_key and past_value shall both share buffer with present outputs, or neither.");
+  }
+
+  // The scales of an int8 cache have a value per token of each kv head, and share buffers like the cache.
+  const float* past_key_scale_data = nullptr;
+  const float* past_value_scale_data = nullptr;
+  float* present_key_scale_data = nullptr;
+  float* present_value_scale_data = nullptr;
+  if (quantized_cache) {
+    const Tensor* past_key_scale = context->Input<Tensor>(9);
+    const Tensor* past_value_scale = context->Input<Tensor>(10);
+    if (past_key != nullptr) {
+      const TensorShape past_scale_shape({batch_size, parameters.kv_num_heads, parameters.seqlen_past_kv_cache});
+      if (past_key_scale == nullptr || past_value_scale == nullptr ||
+          past_key_scale->Shape() != past_scale_shape || past_value_scale->Shape() != past_scale_shape) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "past_key_scale and past_value_scale with shape ", past_scale_shape,
+                               " are required by an int8 past_key and past_value.");
+      }
+      past_key_scale_data = past_key_scale->Data<float>();
+      past_value_scale_data = past_value_scale->Data<float>();
+    }
+
+    const TensorShape present_scale_shape({batch_size, parameters.kv_num_heads, parameters.seqlen_present_kv_cache});
+    Tensor* present_key_scale = context->Output(3, present_scale_shape);
+    Tensor* present_value_scale = context->Output(4, present_scale_shape);
+    if (present_key_scale == nullptr || present_value_scale == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Outputs 'present_key_scale' and 'present_value_scale' are required by an int8 cache.");
+    }
+    present_key_scale_data = present_key_scale->MutableData<float>();
+    present_value_scale_data = present_value_scale->MutableData<float>();
+    if (parameters.kv_share_buffer && (past_key_scale_data != present_key_scale_data ||
+                                       past_value_scale_data != present_value_scale_data)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The scales shall share buffer with their present outputs when the cache does.");
+    }
+  }
+
+  const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+  if (!parameters.is_prompt) {
+    const int past_limit = parameters.kv_share_buffer ? parameters.seqlen_present_kv_cache - sequence_length
+                                                      : parameters.seqlen_past_kv_cache;
+    for (int b = 0; b < batch_size; b++) {
+      if (seqlens_k_data[b] < 0 || seqlens_k_data[b] > past_limit ||
+          seqlens_k_data[b] + sequence_length > parameters.seqlen_present_kv_cache) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "seqlens_k[", b, "] = ", seqlens_k_data[b], " is out of range of the kv cache.");
+      }
+    }
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  const T* cos_cache_data = cos_cache == nullptr ? nullptr : cos_cache->Data<T>();
+  const T* sin_cache_data = sin_cache == nullptr ? nullptr : sin_cache->Data<T>();
+  if (quantized_cache) {
+    return ApplyAttention(query->Data<T>(),
+                          key == nullptr ? nullptr : key->Data<T>(),
+                          value == nullptr ? nullptr : value->Data<T>(),
+                          static_cast<const int8_t*>(past_key_data),
+                          static_cast<const int8_t*>(past_value_data),
+                          past_key_scale_data,
+                          past_value_scale_data,
+                          output->MutableData<T>(),
+                          static_cast<int8_t*>(present_key_data),
+                          static_cast<int8_t*>(present_value_data),
+                          present_key_scale_data,
+                          present_value_scale_data,
+                          seqlens_k_data,
+                          cos_cache_data,
+                          sin_cache_data,
+                          rotary_dim,
+                          parameters,
+                          allocator,
+                          context->GetOperatorThreadPool());
+  }
+
+  return ApplyAttention(query->Data<T>(),
+                        key == nullptr ? nullptr : key->Data<T>(),
+                        value == nullptr ? nullptr : value->Data<T>(),
+                        static_cast<const T*>(past_key_data),
+                        static_cast<const T*>(past_value_data),
+                        nullptr,
+                        nullptr,
+                        output->MutableData<T>(),
+                        static_cast<T*>(present_key_data),
+                        static_cast<T*>(present_value_data),
+                        nullptr,
+                        nullptr,
+                        seqlens_k_data,
+                        cos_cache_data,
+                        sin_cache_data,
+                        rotary_dim,
+                        parameters,
+                        allocator,
+                        context->GetOperatorThreadPool());
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
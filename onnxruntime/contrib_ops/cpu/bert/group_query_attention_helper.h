@@ -11,20 +11,20 @@ namespace onnxruntime {
 namespace contrib {
 namespace group_query_attention_helper {
 
-Status CheckInputs(const Tensor* query,
-                   const Tensor* key,
-                   const Tensor* value,
-                   const Tensor* past_key,
-                   const Tensor* past_value,
-                   const Tensor* cos_cache,
-                   const Tensor* sin_cache,
-                   void* parameters,
-                   int num_heads,
-                   int kv_num_heads,
-                   const Tensor* seqlens_k,
-                   const Tensor* total_seqlen,
-                   bool is_past_bsnh,
-                   float scale) {
+inline Status CheckInputs(const Tensor* query,
+                          const Tensor* key,
+                          const Tensor* value,
+                          const Tensor* past_key,
+                          const Tensor* past_value,
+                          const Tensor* cos_cache,
+                          const Tensor* sin_cache,
+                          void* parameters,
+                          int num_heads,
+                          int kv_num_heads,
+                          const Tensor* seqlens_k,
+                          const Tensor* total_seqlen,
+                          bool is_past_bsnh,
+                          float scale) {
   // Note: Here S* is past_cache_sequence_length, S- is past_sequence_length, S+ is sequence_length
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S-, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S-, H) or nullptr
@@ -259,21 +259,21 @@ Status CheckInputs(const Tensor* query,
   return Status::OK();
 }
 
-Status CheckInputs(const Tensor* query,
-                   const Tensor* key,
-                   const Tensor* value,
-                   const Tensor* past_key,
-                   const Tensor* past_value,
-                   const Tensor* cos_cache,
-                   const Tensor* sin_cache,
-                   void* parameters,
-                   int num_heads,
-                   int kv_num_heads,
-                   const Tensor* seqlens_k,
-                   const Tensor* total_seqlen,
-                   bool is_past_bsnh,
-                   float scale,
-                   int max_threads_per_block) {
+inline Status CheckInputs(const Tensor* query,
+                          const Tensor* key,
+                          const Tensor* value,
+                          const Tensor* past_key,
+                          const Tensor* past_value,
+                          const Tensor* cos_cache,
+                          const Tensor* sin_cache,
+                          void* parameters,
+                          int num_heads,
+                          int kv_num_heads,
+                          const Tensor* seqlens_k,
+                          const Tensor* total_seqlen,
+                          bool is_past_bsnh,
+                          float scale,
+                          int max_threads_per_block) {
   if (max_threads_per_block > 0 && num_heads > max_threads_per_block) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads should be no larger than ", max_threads_per_block);
   }
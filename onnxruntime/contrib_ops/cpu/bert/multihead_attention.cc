@@ -290,7 +290,8 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
                                                                       scale,
                                                                       is_unidirectional_,
                                                                       past_present_share_buffer,
-                                                                      false));
+                                                                      false,
+                                                                      true /* allow_kv_batch_broadcast */));
 
   const int batch_size = parameters.batch_size;
   const int q_sequence_length = parameters.sequence_length;
@@ -335,12 +336,14 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
       context, allocator, batch_size, num_heads_, q_sequence_length, qk_head_size, query, bias, q_bias_offset, Q));
 
   if (kv_BNSH) {
-    // No bias add needed for K/V, key already of shape BxNxLxH, value already of shape BxNxLxH_v
+    // No bias add needed for K/V, key already of shape BxNxLxH, value already of shape BxNxLxH_v.
+    // A key/value with a smaller batch (e.g. a cross attention cache shared by all beams) is broadcast.
+    const int kv_batch_repeat = batch_size / static_cast<int>(key->Shape()[0]);
     return ApplyAttention(Q.GetMutable<Tensor>()->MutableData<T>(), key->Data<T>(), value->Data<T>(),
                           key_padding_mask, nullptr /* past */, nullptr /* past_k */, nullptr /* past_v */,
                           output, present_k, present_v,
                           batch_size, q_sequence_length, kv_sequence_length,
-                          qk_head_size, v_head_size, v_hidden_size, extra_add_qk, context);
+                          qk_head_size, v_head_size, v_hidden_size, extra_add_qk, context, kv_batch_repeat);
   }
 
   OrtValue K;
@@ -27,7 +27,8 @@ Status CheckInputs(const T* query,
                    float scale,
                    bool is_unidirectional,
                    bool past_present_share_buffer,
-                   bool dmmha_packing) {
+                   bool dmmha_packing,
+                   bool allow_kv_batch_broadcast = false) {
   //     key_padding_mask (K/V)     : (B) or (2*B + 1) or (B, L) or None
   //     relative_position_bias     : (B, 1, S, L)
   //     past_key                   : (B, N, S*, H)
@@ -37,6 +38,8 @@ Status CheckInputs(const T* query,
   //     key              (K)       : (B, L, D) or (B, N, S*, H)
   //     value            (V)       : (B, L, D_v) or (B, N, S*, H)
   //     bias             (Q/K/V)   : (D + D + D_v)
+  //     With allow_kv_batch_broadcast, key and value of shape (B', N, S*, H) with B % B' == 0 are shared by
+  //     B / B' consecutive batch entries of query, like the cross attention cache shared by beams.
   // When packed kv is used:
   //     query            (Q)       : (B, S, D)
   //     key              (K)       : (B, L, N, 2, H)
@@ -142,7 +145,9 @@ Status CheckInputs(const T* query,
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'key' is expected to have 3, 4, or 5 dimensions, got ",
                              key_dims.size());
     }
-    if (query_dims[0] != key_dims[0]) {
+    const bool key_batch_broadcast = allow_kv_batch_broadcast && key_dims.size() == 4 &&
+                                     key_dims[0] > 0 && query_dims[0] % key_dims[0] == 0;
+    if (query_dims[0] != key_dims[0] && !key_batch_broadcast) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'query' and 'key' shall have same dim 0 (batch size)");
     }
@@ -246,7 +251,9 @@ Status CheckInputs(const T* query,
                              value_dims.size());
     }
 
-    if (query_dims[0] != value_dims[0]) {
+    const bool value_batch_broadcast = allow_kv_batch_broadcast && key != nullptr && value_dims.size() == 4 &&
+                                       value_dims[0] == key->Shape()[0];
+    if (query_dims[0] != value_dims[0] && !value_batch_broadcast) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'query' and 'value' shall have same dim 0 (batch_size)");
     }
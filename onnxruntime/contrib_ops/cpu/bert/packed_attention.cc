@@ -0,0 +1,326 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention_common.h"
+#include "attention_helper.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math.h"
+#include "core/util/math_cpuonly.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+// Attention on packed input, i.e. only the real tokens of the padded batch (see RemovePadding).
+// Each sequence attends to its own tokens only, so no compute is spent on padding.
+template <typename T>
+class PackedAttention final : public OpKernel {
+ public:
+  explicit PackedAttention(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  Status CheckInputs(const TensorShape& input_shape,
+                     const TensorShape& weights_shape,
+                     const TensorShape& bias_shape,
+                     const TensorShape& token_offset_shape,
+                     const TensorShape& cu_seq_len_shape,
+                     const Tensor* relative_position_bias,
+                     PackedAttentionParameters& parameters) const;
+
+  int num_heads_;                          // number of attention heads
+  float scale_;                            // scale for softmax. Default is 0.0f, which will be replaced by 1/sqrt(head_size)
+  std::vector<int64_t> qkv_hidden_sizes_;  // Q, K, V hidden sizes parsed from the qkv_hidden_sizes attribute.
+};
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    PackedAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    PackedAttention<float>);
+
+template <typename T>
+PackedAttention<T>::PackedAttention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+
+  scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+
+  if (!info.GetAttrs<int64_t>("qkv_hidden_sizes", qkv_hidden_sizes_).IsOK()) {
+    qkv_hidden_sizes_.clear();
+  }
+}
+
+template <typename T>
+Status PackedAttention<T>::CheckInputs(const TensorShape& input_shape,
+                                       const TensorShape& weights_shape,
+                                       const TensorShape& bias_shape,
+                                       const TensorShape& token_offset_shape,
+                                       const TensorShape& cu_seq_len_shape,
+                                       const Tensor* relative_position_bias,
+                                       PackedAttentionParameters& parameters) const {
+  // Input shapes:
+  //   input:                  : (T, D_i)
+  //   weights      (Q/K/V)    : (D_i, D + D + D_v)
+  //   bias         (Q/K/V)    : (D + D + D_v)
+  //   token_offset            : (B, S)
+  //   cu_seq_len_shape        : (B + 1)
+  //   relative_position_bias  : (B, N, S, S), (1, N, S, S) or NULL
+  const auto& input_dims = input_shape.GetDims();
+  if (input_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'input' is expected to have 2 dimensions in packing mode, got ",
+                           input_dims.size());
+  }
+  int64_t token_count = input_dims[0];
+  int64_t input_hidden_size = input_dims[1];
+
+  const auto& token_offset_dims = token_offset_shape.GetDims();
+  if (token_offset_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'token_offset' is expected to have 2 dimensions in packing mode, got ",
+                           token_offset_dims.size());
+  }
+  int64_t batch_size = token_offset_dims[0];
+  int64_t sequence_length = token_offset_dims[1];
+
+  const auto& bias_dims = bias_shape.GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'bias' is expected to have 1 dimension, got ",
+                           bias_dims.size());
+  }
+
+  const auto& weights_dims = weights_shape.GetDims();
+  if (weights_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'weights' is expected to have 2 dimensions, got ",
+                           weights_dims.size());
+  }
+  if (weights_dims[0] != input_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 0 should have same length as dimension 1 of input 0");
+  }
+  if (bias_dims[0] != weights_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' dimension 0 should have same length as dimension 1 of input 'weights'");
+  }
+
+  const auto& cu_seq_len_dims = cu_seq_len_shape.GetDims();
+  if (cu_seq_len_dims.size() != 1 || cu_seq_len_dims[0] != batch_size + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' should have 1 dimension with size equal to batch_size + 1");
+  }
+
+  int64_t q_hidden_size = bias_dims[0] / static_cast<int64_t>(3);
+  int64_t k_hidden_size = q_hidden_size;
+  int64_t v_hidden_size = k_hidden_size;
+  if (qkv_hidden_sizes_.size() != 0) {
+    if (qkv_hidden_sizes_.size() != 3) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "qkv_hidden_sizes attribute should have 3 elements");
+    }
+
+    q_hidden_size = qkv_hidden_sizes_[0];
+    k_hidden_size = qkv_hidden_sizes_[1];
+    v_hidden_size = qkv_hidden_sizes_[2];
+  }
+
+  for (int64_t hidden_size : {q_hidden_size, k_hidden_size, v_hidden_size}) {
+    if (hidden_size <= 0 || hidden_size % num_heads_ != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "hidden_size should be positive and divisible by num_heads:", hidden_size);
+    }
+  }
+
+  if (q_hidden_size != k_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "qkv_hidden_sizes first element should be same as the second");
+  }
+
+  if (bias_dims[0] != q_hidden_size + k_hidden_size + v_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' dimension 0 should have same length as sum of Q/K/V hidden sizes:",
+                           " q_hidden_size=", q_hidden_size, " k_hidden_size=", k_hidden_size, " v_hidden_size=",
+                           v_hidden_size, "bias_dims[0]=", bias_dims[0]);
+  }
+
+  bool broadcast_res_pos_bias = false;
+  if (relative_position_bias != nullptr) {
+    const auto& relative_position_bias_dims = relative_position_bias->Shape().GetDims();
+    if (relative_position_bias_dims.size() != 4) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'relative_position_bias' is expected to have 4 dimensions, got ",
+                             relative_position_bias_dims.size());
+    }
+    if (relative_position_bias_dims[0] != batch_size && relative_position_bias_dims[0] != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'relative_position_bias' dimension 0 should be same as batch_size or 1, got ",
+                             relative_position_bias_dims[0]);
+    }
+    broadcast_res_pos_bias = relative_position_bias_dims[0] == 1;
+
+    if (relative_position_bias_dims[1] != num_heads_ ||
+        relative_position_bias_dims[2] != sequence_length ||
+        relative_position_bias_dims[3] != sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'relative_position_bias' is expected to have shape (*, num_heads, "
+                             "sequence_length, sequence_length), got ",
+                             relative_position_bias->Shape());
+    }
+  }
+
+  parameters.batch_size = static_cast<int>(batch_size);
+  parameters.sequence_length = static_cast<int>(sequence_length);
+  parameters.input_hidden_size = static_cast<int>(input_hidden_size);
+  parameters.hidden_size = static_cast<int>(q_hidden_size);
+  parameters.v_hidden_size = static_cast<int>(v_hidden_size);
+  parameters.head_size = static_cast<int>(q_hidden_size) / num_heads_;
+  parameters.v_head_size = static_cast<int>(v_hidden_size) / num_heads_;
+  parameters.num_heads = num_heads_;
+  parameters.scale = scale_;
+  parameters.token_count = static_cast<int>(token_count);
+  parameters.has_relative_position_bias = nullptr != relative_position_bias;
+  parameters.broadcast_res_pos_bias = broadcast_res_pos_bias;
+  parameters.use_tf32 = false;
+
+  return Status::OK();
+}
+
+template <typename T>
+Status PackedAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* token_offset = context->Input<Tensor>(3);
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(4);
+  const Tensor* relative_position_bias = context->Input<Tensor>(5);
+
+  PackedAttentionParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
+                                  weights->Shape(),
+                                  bias->Shape(),
+                                  token_offset->Shape(),
+                                  cumulative_sequence_length->Shape(),
+                                  relative_position_bias,
+                                  parameters));
+
+  const int batch_size = parameters.batch_size;
+  const int sequence_length = parameters.sequence_length;
+  const int token_count = parameters.token_count;
+  const int num_heads = parameters.num_heads;
+  const int head_size = parameters.head_size;
+  const int v_head_size = parameters.v_head_size;
+  const int qkv_hidden_size = parameters.hidden_size + parameters.hidden_size + parameters.v_hidden_size;
+
+  TensorShapeVector output_shape{token_count, parameters.v_hidden_size};
+  Tensor* output = context->Output(0, output_shape);
+
+  // The sequences are stored back to back, so the tokens of sequence b are [cu_seq_len[b], cu_seq_len[b + 1]).
+  const int32_t* cu_seq_len = cumulative_sequence_length->Data<int32_t>();
+  if (cu_seq_len[0] != 0 || cu_seq_len[batch_size] != token_count) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' should start with 0 and end with token_count");
+  }
+
+  // Offsets of the attention scores of each sequence in the scratch buffer. Each sequence only needs
+  // num_heads * L * L scores for its actual length L, rather than the padded sequence_length.
+  std::vector<size_t> scores_offset(static_cast<size_t>(batch_size) + 1, 0);
+  for (int b = 0; b < batch_size; b++) {
+    const int length = cu_seq_len[b + 1] - cu_seq_len[b];
+    if (length < 0 || length > sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'cumulative_sequence_length' has an invalid length ", length, " for sequence ", b);
+    }
+    scores_offset[b + 1] = scores_offset[b] + SafeInt<size_t>(num_heads) * length * length;
+  }
+
+  if (token_count == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  // Compute Q, K, V for the real tokens only
+  // qkv(T, D_t) = input(T, D_i) x weights(D_i, D_t) + bias(D_t), where D_t = D + D + D_v
+  auto qkv = IAllocator::MakeUniquePtr<T>(allocator, SafeInt<size_t>(token_count) * qkv_hidden_size);
+  {
+    const T* bias_data = bias->Data<T>();
+    for (int t = 0; t < token_count; t++) {
+      memcpy(qkv.get() + static_cast<size_t>(t) * qkv_hidden_size, bias_data, qkv_hidden_size * sizeof(T));
+    }
+
+    math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans,
+                                token_count, qkv_hidden_size, parameters.input_hidden_size, 1.0f,
+                                input->Data<T>(), parameters.input_hidden_size,
+                                weights->Data<T>(), qkv_hidden_size,
+                                1.0f, qkv.get(), qkv_hidden_size, tp);
+  }
+
+  auto scores = IAllocator::MakeUniquePtr<T>(allocator, std::max<size_t>(scores_offset[batch_size], 1));
+
+  const float scale = parameters.scale == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : parameters.scale;
+  const T* relative_position_bias_data = relative_position_bias != nullptr ? relative_position_bias->Data<T>() : nullptr;
+  const T* qkv_data = qkv.get();
+  T* scores_data = scores.get();
+  T* output_data = output->MutableData<T>();
+  const int v_hidden_size = parameters.v_hidden_size;
+  const int k_offset = parameters.hidden_size;
+  const int v_offset = 2 * parameters.hidden_size;
+
+  const double cost = static_cast<double>(sequence_length) * sequence_length * (head_size + v_head_size);
+  ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int b = static_cast<int>(i / num_heads);
+      const int n = static_cast<int>(i % num_heads);
+      const int length = cu_seq_len[b + 1] - cu_seq_len[b];
+      if (length == 0) {
+        continue;
+      }
+
+      const T* q = qkv_data + static_cast<size_t>(cu_seq_len[b]) * qkv_hidden_size + n * head_size;
+      const T* k = q + k_offset;
+      const T* v = qkv_data + static_cast<size_t>(cu_seq_len[b]) * qkv_hidden_size + v_offset + n * v_head_size;
+      T* probs = scores_data + scores_offset[b] + static_cast<size_t>(n) * length * length;
+
+      // probs(L, L) = scale * q(L, H) x k(L, H)'
+      math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, length, length, head_size, scale,
+                                  q, qkv_hidden_size, k, qkv_hidden_size, 0.0f, probs, length, nullptr);
+
+      if (relative_position_bias_data != nullptr) {
+        const int bias_batch = parameters.broadcast_res_pos_bias ? 0 : b;
+        const T* bias_data = relative_position_bias_data +
+                             (static_cast<size_t>(bias_batch) * num_heads + n) * sequence_length * sequence_length;
+        for (int row = 0; row < length; row++) {
+          const T* bias_row = bias_data + static_cast<size_t>(row) * sequence_length;
+          T* probs_row = probs + static_cast<size_t>(row) * length;
+          for (int col = 0; col < length; col++) {
+            probs_row[col] += bias_row[col];
+          }
+        }
+      }
+
+      ComputeAttentionSoftmaxInplace(probs, length, length, nullptr);
+
+      // output(L, H_v) = probs(L, L) x v(L, H_v), written in place of the tokens of head n
+      T* out = output_data + static_cast<size_t>(cu_seq_len[b]) * v_hidden_size + n * v_head_size;
+      math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, length, v_head_size, length, 1.0f,
+                                  probs, length, v, qkv_hidden_size, 0.0f, out, v_hidden_size, nullptr);
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
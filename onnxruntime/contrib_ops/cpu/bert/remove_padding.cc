@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+// Packs the real tokens of a right-padded batch back to back, so that later packed operators
+// (like PackedAttention) do not spend compute on padding.
+template <typename T>
+class RemovePadding final : public OpKernel {
+ public:
+  explicit RemovePadding(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    RemovePadding,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    RemovePadding<float>);
+
+template <typename T>
+Status RemovePadding<T>::Compute(OpKernelContext* context) const {
+  // shape of inputs:
+  //   input:                   (batch_size, sequence_length, hidden_size)
+  //   sequence_token_count:    (batch_size)
+  // shape of outputs:
+  //   output:                  (total_tokens, hidden_size)
+  //   token_offset:            (batch_size, sequence_length)
+  //   cumulated_seq_len:       (batch_size + 1)
+  //   max_token_count:         (1)
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* sequence_token_count = context->Input<Tensor>(1);
+
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' is expected to have 3 dimensions, got ",
+                           dims.size());
+  }
+  const int64_t batch_size = dims[0];
+  const int64_t sequence_length = dims[1];
+  const int64_t hidden_size = dims[2];
+
+  if (sequence_token_count->Shape().NumDimensions() != 1 || sequence_token_count->Shape()[0] != batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'sequence_token_count' is expected to have shape (batch_size), got ",
+                           sequence_token_count->Shape());
+  }
+
+  Tensor* token_offset = context->Output(1, {batch_size, sequence_length});
+  Tensor* cumulated_seq_len = context->Output(2, {batch_size + 1});
+
+  const int32_t* token_count_data = sequence_token_count->Data<int32_t>();
+  int32_t* token_offset_data = token_offset->MutableData<int32_t>();
+  int32_t* cumulated_seq_len_data = cumulated_seq_len->MutableData<int32_t>();
+
+  // Offsets of the real tokens first, followed by the offsets of the padding.
+  int32_t total_token_count = 0;
+  int32_t max_token_count = 0;
+  int64_t index = 0;
+  cumulated_seq_len_data[0] = 0;
+  for (int64_t b = 0; b < batch_size; b++) {
+    const int32_t count = token_count_data[b];
+    if (count < 0 || count > sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'sequence_token_count' has an invalid value ", count, " for sequence ", b);
+    }
+    max_token_count = std::max(max_token_count, count);
+    total_token_count += count;
+    cumulated_seq_len_data[b + 1] = total_token_count;
+    for (int32_t s = 0; s < count; s++) {
+      token_offset_data[index++] = static_cast<int32_t>(b * sequence_length + s);
+    }
+  }
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t s = token_count_data[b]; s < sequence_length; s++) {
+      token_offset_data[index++] = static_cast<int32_t>(b * sequence_length + s);
+    }
+  }
+
+  Tensor* output = context->Output(0, {static_cast<int64_t>(total_token_count), hidden_size});
+  Tensor* max_token_count_tensor = context->Output(3, {1});
+  max_token_count_tensor->MutableData<int32_t>()[0] = max_token_count;
+
+  // The real tokens of each sequence are contiguous in the input, so each sequence is a single copy.
+  const T* input_data = input->Data<T>();
+  T* output_data = output->MutableData<T>();
+  const double cost = static_cast<double>(sequence_length) * hidden_size;
+  ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), batch_size, cost,
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                               for (std::ptrdiff_t b = begin; b != end; ++b) {
+                                 memcpy(output_data + static_cast<size_t>(cumulated_seq_len_data[b]) * hidden_size,
+                                        input_data + static_cast<size_t>(b) * sequence_length * hidden_size,
+                                        static_cast<size_t>(token_count_data[b]) * hidden_size * sizeof(T));
+                               }
+                             });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
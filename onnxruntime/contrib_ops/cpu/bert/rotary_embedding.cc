@@ -4,6 +4,10 @@
 #include "contrib_ops/cpu/bert/rotary_embedding.h"
 #include "contrib_ops/cpu/bert/rotary_embedding_helper.h"
 
+#include <type_traits>
+#include <vector>
+
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 
 using onnxruntime::concurrency::ThreadPool;
@@ -13,16 +17,20 @@ namespace onnxruntime {
 namespace contrib {
 
 // These ops are internal-only, so register outside of onnx
-ONNX_OPERATOR_TYPED_KERNEL_EX(
-    RotaryEmbedding,
-    kMSDomain,
-    1,
-    float,
-    kCpuExecutionProvider,
-    KernelDefBuilder()
-        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
-        .TypeConstraint("M", DataTypeImpl::GetTensorType<int64_t>()),
-    RotaryEmbedding<float>);
+#define REGISTER_KERNEL_TYPED(T)                                        \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                        \
+      RotaryEmbedding,                                                  \
+      kMSDomain,                                                        \
+      1,                                                                \
+      T,                                                                \
+      kCpuExecutionProvider,                                            \
+      KernelDefBuilder()                                                \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())        \
+          .TypeConstraint("M", DataTypeImpl::GetTensorType<int64_t>()), \
+      RotaryEmbedding<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
 
 template <typename T>
 RotaryEmbedding<T>::RotaryEmbedding(const OpKernelInfo& info) : OpKernel(info) {
@@ -89,8 +97,14 @@ Status RotaryEmbedding<T>::Compute(OpKernelContext* context) const {
   auto* tp = context->GetOperatorThreadPool();
 
   const int loop_len = batch_size * sequence_length * n_heads;
-  const double cost = static_cast<double>(rotary_emb_dim);
+  const double cost = static_cast<double>(head_size);
   ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    // fp16 rows are rotated in fp32: the input row is followed by the sin and cos values of its position.
+    std::vector<float> float_rows;
+    if constexpr (std::is_same_v<T, MLFloat16>) {
+      float_rows.resize(2 * static_cast<size_t>(rotary_emb_dim));
+    }
+
     for (std::ptrdiff_t ptr = begin; ptr != end; ++ptr) {
       const int b = static_cast<int>((ptr / n_heads) / sequence_length);
       const int s = static_cast<int>((ptr / n_heads) % sequence_length);
@@ -109,20 +123,22 @@ Status RotaryEmbedding<T>::Compute(OpKernelContext* context) const {
       const T* cos_data = cos_cache_data + cache_offset;
       const T* sin_data = sin_cache_data + cache_offset;
 
-      int cache_idx = 0;
-      T sign = 0;
-      int j = 0;
-      for (int i = 0; i < rotary_emb_dim; i++) {
-        if (interleaved) {
-          cache_idx = (i / 2) % half_rotary_emb_dim;
-          sign = (i % 2 == 0) ? static_cast<T>(-1) : static_cast<T>(1);
-          j = (i % 2 == 0) ? i + 1 : i - 1;  // i - sign
-        } else {
-          cache_idx = i % half_rotary_emb_dim;
-          sign = (i < half_rotary_emb_dim) ? static_cast<T>(-1) : static_cast<T>(1);
-          j = (i + half_rotary_emb_dim) % rotary_emb_dim;
-        }
-        output_data[i] = input_data[i] * cos_data[cache_idx] + sign * input_data[j] * sin_data[cache_idx];
+      if constexpr (std::is_same_v<T, MLFloat16>) {
+        float* row = float_rows.data();
+        float* sin_row = row + rotary_emb_dim;
+        float* cos_row = sin_row + half_rotary_emb_dim;
+        MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(input_data), row,
+                                     static_cast<size_t>(rotary_emb_dim));
+        MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(sin_data), sin_row,
+                                     static_cast<size_t>(half_rotary_emb_dim));
+        MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(cos_data), cos_row,
+                                     static_cast<size_t>(half_rotary_emb_dim));
+        MlasRotaryEmbedOneRow(row, sin_row, cos_row, static_cast<size_t>(rotary_emb_dim), interleaved, row);
+        MlasConvertFloatToHalfBuffer(row, reinterpret_cast<unsigned short*>(output_data),
+                                     static_cast<size_t>(rotary_emb_dim));
+      } else {
+        MlasRotaryEmbedOneRow(input_data, sin_data, cos_data, static_cast<size_t>(rotary_emb_dim), interleaved,
+                              output_data);
       }
       for (int i = rotary_emb_dim; i < head_size; i++) {
         output_data[i] = input_data[i];
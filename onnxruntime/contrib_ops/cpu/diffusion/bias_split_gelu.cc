@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = (X[..., :D/2] + bias[:D/2]) * Gelu(X[..., D/2:] + bias[D/2:]) for X of shape (N, S, D).
+class BiasSplitGelu final : public OpKernel {
+ public:
+  BiasSplitGelu(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    BiasSplitGelu,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    BiasSplitGelu);
+
+Status BiasSplitGelu::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input is expected to have 3 dimensions, got ", input_dims.size());
+  }
+
+  if (input_dims[2] % 2 != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "hidden size should be even, got ", input_dims[2]);
+  }
+
+  const Tensor* bias = context->Input<Tensor>(1);
+  const auto& bias_dims = bias->Shape().GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "bias is expected to have 1 dimensions, got ", bias_dims.size());
+  }
+  if (bias_dims[0] != input_dims[2]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "last dimension of input and bias are not the same");
+  }
+
+  TensorShapeVector output_shape = input->Shape().AsShapeVector();
+  output_shape[2] = input_dims[2] / 2;
+  Tensor* output = context->Output(0, output_shape);
+
+  const int64_t num_rows = input_dims[0] * input_dims[1];
+  const int64_t half_hidden_size = input_dims[2] / 2;
+  const float* input_data = input->Data<float>();
+  const float* bias_data = bias->Data<float>();
+  float* output_data = output->MutableData<float>();
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto buffer = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_rows) * half_hidden_size);
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows),
+      static_cast<double>(half_hidden_size) * 8,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t row = begin; row != end; ++row) {
+          const float* left = input_data + row * half_hidden_size * 2;
+          const float* right = left + half_hidden_size;
+          const float* right_bias = bias_data + half_hidden_size;
+          float* temp = buffer.get() + row * half_hidden_size;
+          float* y = output_data + row * half_hidden_size;
+
+          // Gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+          for (int64_t i = 0; i < half_hidden_size; i++) {
+            const float value = right[i] + right_bias[i];
+            y[i] = value * static_cast<float>(M_SQRT1_2);
+            temp[i] = value * 0.5f;
+          }
+          MlasComputeErf(y, y, narrow<size_t>(half_hidden_size));
+          for (int64_t i = 0; i < half_hidden_size; i++) {
+            y[i] = (left[i] + bias_data[i]) * temp[i] * (y[i] + 1.0f);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,323 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/diffusion/group_norm.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    GroupNorm, kMSDomain, 1, kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<float>()),
+    GroupNorm);
+
+ONNX_OPERATOR_KERNEL_EX(
+    SkipGroupNorm, kMSDomain, 1, kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<float>()),
+    GroupNorm);
+
+namespace {
+
+// Number of elements of the NHWC input accumulated by one task of the statistics pass.
+constexpr size_t kStatisticsBlockElements = 16384;
+
+// y = y * sigmoid(y)
+void ApplySilu(float* y, size_t count) {
+  constexpr size_t kBlockSize = 256;
+  float sigmoid[kBlockSize];
+  for (size_t i = 0; i < count; i += kBlockSize) {
+    const size_t n = std::min(kBlockSize, count - i);
+    MlasComputeLogistic(y + i, sigmoid, n);
+    for (size_t j = 0; j < n; j++) {
+      y[i + j] *= sigmoid[j];
+    }
+  }
+}
+
+// Fold mean and inverse standard deviation of each group into per channel scale and shift,
+// so that normalization is y = x * scale + shift.
+void ComputeScaleAndShift(const double* sum, const double* sum_square, const float* gamma, const float* beta,
+                          int64_t channels_per_group, int64_t num_groups, double group_size, float epsilon,
+                          float* scale, float* shift) {
+  for (int64_t g = 0; g < num_groups; g++) {
+    const double mean = sum[g] / group_size;
+    const double variance = std::max(sum_square[g] / group_size - mean * mean, 0.0);
+    const float inv_std = static_cast<float>(1.0 / std::sqrt(variance + static_cast<double>(epsilon)));
+    for (int64_t c = g * channels_per_group; c < (g + 1) * channels_per_group; c++) {
+      scale[c] = gamma[c] * inv_std;
+      shift[c] = beta[c] - static_cast<float>(mean) * scale[c];
+    }
+  }
+}
+
+// NHWC: channels of a group are interleaved with other groups, so statistics are accumulated per channel over
+// fixed blocks of rows in one contiguous pass, then reduced to groups. A second pass normalizes each row.
+Status GroupNormNHWC(OpKernelContext* context, const float* input, const float* gamma, const float* beta,
+                     float* output, int64_t batch_size, int64_t image_size, int64_t num_channels,
+                     int64_t num_groups, float epsilon, bool use_swish_activation) {
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  const int64_t rows_per_block = std::max<int64_t>(1, static_cast<int64_t>(kStatisticsBlockElements) / num_channels);
+  const int64_t blocks_per_image = (image_size + rows_per_block - 1) / rows_per_block;
+  const int64_t num_blocks = batch_size * blocks_per_image;
+
+  // Per block sums and sums of squares of each channel.
+  auto partial_sums = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_blocks) * num_channels * 2);
+  float* partial = partial_sums.get();
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks), static_cast<double>(rows_per_block * num_channels) * 2,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t block = begin; block != end; ++block) {
+          const int64_t n = block / blocks_per_image;
+          const int64_t row_begin = (block % blocks_per_image) * rows_per_block;
+          const int64_t row_end = std::min(image_size, row_begin + rows_per_block);
+          float* sum = partial + SafeInt<size_t>(block) * num_channels * 2;
+          float* sum_square = sum + num_channels;
+          std::fill_n(sum, num_channels * 2, 0.0f);
+          for (int64_t row = row_begin; row < row_end; row++) {
+            const float* x = input + (n * image_size + row) * num_channels;
+            for (int64_t c = 0; c < num_channels; c++) {
+              sum[c] += x[c];
+              sum_square[c] += x[c] * x[c];
+            }
+          }
+        }
+      });
+
+  auto scale_shift = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(batch_size) * num_channels * 2);
+  const int64_t channels_per_group = num_channels / num_groups;
+  std::vector<double> group_sum(SafeInt<size_t>(num_groups) * 2);
+  for (int64_t n = 0; n < batch_size; n++) {
+    std::fill(group_sum.begin(), group_sum.end(), 0.0);
+    for (int64_t b = 0; b < blocks_per_image; b++) {
+      const float* sum = partial + SafeInt<size_t>(n * blocks_per_image + b) * num_channels * 2;
+      for (int64_t c = 0; c < num_channels; c++) {
+        group_sum[c / channels_per_group] += sum[c];
+        group_sum[num_groups + c / channels_per_group] += sum[num_channels + c];
+      }
+    }
+
+    float* scale = scale_shift.get() + n * num_channels * 2;
+    ComputeScaleAndShift(group_sum.data(), group_sum.data() + num_groups, gamma, beta, channels_per_group,
+                         num_groups, static_cast<double>(image_size * channels_per_group), epsilon,
+                         scale, scale + num_channels);
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * image_size), static_cast<double>(num_channels) * 3,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t row = begin; row != end; ++row) {
+          const float* scale = scale_shift.get() + (row / image_size) * num_channels * 2;
+          const float* shift = scale + num_channels;
+          const float* x = input + row * num_channels;
+          float* y = output + row * num_channels;
+          for (int64_t c = 0; c < num_channels; c++) {
+            y[c] = x[c] * scale[c] + shift[c];
+          }
+          if (use_swish_activation) {
+            ApplySilu(y, static_cast<size_t>(num_channels));
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+// NCHW: a group is a contiguous span of channels_per_group planes. Each task computes the statistics of one group,
+// and normalizes it while it is still in cache.
+void GroupNormNCHW(concurrency::ThreadPool* tp, const float* input, const float* gamma, const float* beta,
+                   float* output, int64_t batch_size, int64_t image_size, int64_t num_channels,
+                   int64_t num_groups, float epsilon, bool use_swish_activation) {
+  const int64_t channels_per_group = num_channels / num_groups;
+  const int64_t group_size = channels_per_group * image_size;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_groups), static_cast<double>(group_size) * 5,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        std::vector<float> scale_shift(SafeInt<size_t>(channels_per_group) * 2);
+        for (std::ptrdiff_t task = begin; task != end; ++task) {
+          const int64_t g = task % num_groups;
+          const float* x = input + task * group_size;
+          float* y = output + task * group_size;
+
+          double sum = 0.0;
+          double sum_square = 0.0;
+          for (int64_t c = 0; c < channels_per_group; c++) {
+            float plane_sum = 0.0f;
+            float plane_sum_square = 0.0f;
+            const float* plane = x + c * image_size;
+            for (int64_t i = 0; i < image_size; i++) {
+              plane_sum += plane[i];
+              plane_sum_square += plane[i] * plane[i];
+            }
+            sum += plane_sum;
+            sum_square += plane_sum_square;
+          }
+
+          ComputeScaleAndShift(&sum, &sum_square, gamma + g * channels_per_group, beta + g * channels_per_group,
+                               channels_per_group, 1, static_cast<double>(group_size), epsilon,
+                               scale_shift.data(), scale_shift.data() + channels_per_group);
+
+          for (int64_t c = 0; c < channels_per_group; c++) {
+            const float channel_scale = scale_shift[c];
+            const float channel_shift = scale_shift[channels_per_group + c];
+            const float* plane = x + c * image_size;
+            float* out = y + c * image_size;
+            for (int64_t i = 0; i < image_size; i++) {
+              out[i] = plane[i] * channel_scale + channel_shift;
+            }
+          }
+
+          if (use_swish_activation) {
+            ApplySilu(y, static_cast<size_t>(group_size));
+          }
+        }
+      });
+}
+
+}  // namespace
+
+GroupNorm::GroupNorm(const OpKernelInfo& op_info) : OpKernel(op_info) {
+  has_skip_ = false;
+  const std::string& op_name = op_info.GetKernelDef().OpName();
+  if (op_name == "SkipGroupNorm") {
+    has_skip_ = true;
+  }
+
+  epsilon_ = op_info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+  ORT_ENFORCE(epsilon_ >= 0);
+
+  int64_t num_groups;
+  ORT_ENFORCE(op_info.GetAttr("groups", &num_groups).IsOK());
+  ORT_ENFORCE(num_groups > 0);
+  num_groups_ = static_cast<int>(num_groups);
+
+  int64_t activation;
+  ORT_ENFORCE(op_info.GetAttr("activation", &activation).IsOK());
+  ORT_ENFORCE(activation == 0 || activation == 1);  // 0 is None, 1 is Swish
+  use_swish_activation_ = (activation == 1);
+
+  channels_last_ = (op_info.GetAttrOrDefault<int64_t>("channels_last", static_cast<int64_t>(1)) != 0);
+}
+
+Status GroupNorm::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* gamma = context->Input<Tensor>(1);
+  const Tensor* beta = context->Input<Tensor>(2);
+  Tensor* output = context->Output(0, input->Shape());
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input is expected to have 4 dimensions, got ", input_dims.size());
+  }
+
+  const int64_t batch_size = input_dims[0];
+  const int64_t num_channels = channels_last_ ? input_dims[3] : input_dims[1];
+  const int64_t image_size = channels_last_ ? input_dims[1] * input_dims[2] : input_dims[2] * input_dims[3];
+
+  if (num_channels % num_groups_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "number of channels should be divisiable by num_groups");
+  }
+
+  if (gamma->Shape().NumDimensions() != 1 || gamma->Shape()[0] != num_channels) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "gamma is expected to have shape (C), got ", gamma->Shape());
+  }
+
+  if (beta->Shape().NumDimensions() != 1 || beta->Shape()[0] != num_channels) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "beta is expected to have shape (C), got ", beta->Shape());
+  }
+
+  const float* input_data = input->Data<float>();
+
+  // SkipGroupNorm: s = x + skip + bias is computed first into the optional output S or a temporary buffer.
+  IAllocatorUniquePtr<float> sum_buffer;
+  if (has_skip_) {
+    if (!channels_last_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                             "SkipGroupNorm only supports the channels_last layout");
+    }
+
+    const Tensor* skip = context->Input<Tensor>(3);
+    const Tensor* bias = context->Input<Tensor>(4);
+    const auto& skip_dims = skip->Shape().GetDims();
+    const bool broadcast_skip = (skip_dims.size() == 2 && skip_dims[0] == batch_size && skip_dims[1] == num_channels) ||
+                                (skip_dims.size() == 4 && skip_dims[0] == batch_size && skip_dims[1] == 1 &&
+                                 skip_dims[2] == 1 && skip_dims[3] == num_channels);
+    if (!broadcast_skip && skip->Shape() != input->Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "skip shape is expected to be (N, H, W, C) or (N, 1, 1, C) or (N, C), got ",
+                             skip->Shape());
+    }
+    if (bias != nullptr && (bias->Shape().NumDimensions() != 1 || bias->Shape()[0] != num_channels)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "bias is expected to have shape (C), got ", bias->Shape());
+    }
+
+    Tensor* add_out = context->Output(1, input->Shape());
+    float* sum_data = nullptr;
+    if (add_out != nullptr) {
+      sum_data = add_out->MutableData<float>();
+    } else {
+      AllocatorPtr allocator;
+      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+      sum_buffer = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(input->Shape().Size()));
+      sum_data = sum_buffer.get();
+    }
+
+    const float* skip_data = skip->Data<float>();
+    const float* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_size * image_size),
+        static_cast<double>(num_channels) * 3,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t row = begin; row != end; ++row) {
+            const float* x = input_data + row * num_channels;
+            const float* s = skip_data + (broadcast_skip ? row / image_size : row) * num_channels;
+            float* y = sum_data + row * num_channels;
+            for (int64_t c = 0; c < num_channels; c++) {
+              y[c] = x[c] + s[c];
+            }
+            if (bias_data != nullptr) {
+              for (int64_t c = 0; c < num_channels; c++) {
+                y[c] += bias_data[c];
+              }
+            }
+          }
+        });
+
+    input_data = sum_data;
+  }
+
+  if (channels_last_) {
+    return GroupNormNHWC(context, input_data, gamma->Data<float>(), beta->Data<float>(),
+                         output->MutableData<float>(), batch_size, image_size, num_channels, num_groups_,
+                         epsilon_, use_swish_activation_);
+  }
+
+  GroupNormNCHW(context->GetOperatorThreadPool(), input_data, gamma->Data<float>(), beta->Data<float>(),
+                output->MutableData<float>(), batch_size, image_size, num_channels, num_groups_,
+                epsilon_, use_swish_activation_);
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+bool ParseFusedElementwiseOp(const std::string& op_type, FusedElementwiseOp& op) {
+  static const InlinedHashMap<std::string, FusedElementwiseOp> ops = {
+      {"Add", FusedElementwiseOp::Add},
+      {"Sub", FusedElementwiseOp::Sub},
+      {"Mul", FusedElementwiseOp::Mul},
+      {"Div", FusedElementwiseOp::Div},
+      {"Relu", FusedElementwiseOp::Relu},
+      {"Sigmoid", FusedElementwiseOp::Sigmoid},
+      {"Tanh", FusedElementwiseOp::Tanh},
+      {"Erf", FusedElementwiseOp::Erf},
+      {"Exp", FusedElementwiseOp::Exp},
+      {"Neg", FusedElementwiseOp::Neg},
+      {"Abs", FusedElementwiseOp::Abs},
+      {"Sqrt", FusedElementwiseOp::Sqrt},
+      {"Reciprocal", FusedElementwiseOp::Reciprocal},
+  };
+
+  auto it = ops.find(op_type);
+  if (it == ops.end()) {
+    return false;
+  }
+  op = it->second;
+  return true;
+}
+
+bool IsBinaryFusedElementwiseOp(FusedElementwiseOp op) {
+  return op == FusedElementwiseOp::Add || op == FusedElementwiseOp::Sub || op == FusedElementwiseOp::Mul ||
+         op == FusedElementwiseOp::Div;
+}
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operand_indices = info.GetAttrsOrDefault<int64_t>("operand_indices");
+  const auto operand_positions = info.GetAttrsOrDefault<int64_t>("operand_positions");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one operator.");
+  ORT_ENFORCE(operand_indices.size() == ops.size() && operand_positions.size() == ops.size(),
+              "operand_indices and operand_positions must have one value per operator.");
+
+  const int num_operands = info.GetInputCount() - 1;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    Step step{};
+    ORT_ENFORCE(ParseFusedElementwiseOp(ops[i], step.op), "Unsupported FusedElementwise operator: ", ops[i]);
+    if (IsBinaryFusedElementwiseOp(step.op)) {
+      ORT_ENFORCE(operand_indices[i] >= 0 && operand_indices[i] < num_operands,
+                  "Invalid operand index ", operand_indices[i], " of operator ", i);
+      step.operand_index = static_cast<int>(operand_indices[i]);
+      step.operand_is_lhs = operand_positions[i] != 0;
+    } else {
+      step.operand_index = -1;
+      step.operand_is_lhs = false;
+    }
+    steps_.push_back(step);
+  }
+}
+
+namespace {
+
+// Applies op to the count values at x, writing them to y. x and y may be the same.
+void ApplyStep(FusedElementwiseOp op, const float* x, float* y, std::ptrdiff_t count,
+               const float* operand, bool operand_is_scalar, bool operand_is_lhs) {
+  ConstEigenVectorArrayMap<float> xm(x, count);
+  EigenVectorArrayMap<float> ym(y, count);
+
+  if (IsBinaryFusedElementwiseOp(op)) {
+    if (operand_is_scalar) {
+      const float b = *operand;
+      switch (op) {
+        case FusedElementwiseOp::Add:
+          ym = xm + b;
+          break;
+        case FusedElementwiseOp::Sub:
+          ym = operand_is_lhs ? b - xm : xm - b;
+          break;
+        case FusedElementwiseOp::Mul:
+          ym = xm * b;
+          break;
+        default:
+          ym = operand_is_lhs ? b / xm : xm / b;
+          break;
+      }
+    } else {
+      ConstEigenVectorArrayMap<float> bm(operand, count);
+      switch (op) {
+        case FusedElementwiseOp::Add:
+          ym = xm + bm;
+          break;
+        case FusedElementwiseOp::Sub:
+          ym = operand_is_lhs ? bm - xm : xm - bm;
+          break;
+        case FusedElementwiseOp::Mul:
+          ym = xm * bm;
+          break;
+        default:
+          ym = operand_is_lhs ? bm / xm : xm / bm;
+          break;
+      }
+    }
+    return;
+  }
+
+  switch (op) {
+    case FusedElementwiseOp::Relu:
+      ym = xm.max(0.0f);
+      break;
+    case FusedElementwiseOp::Sigmoid:
+      MlasComputeLogistic(x, y, static_cast<size_t>(count));
+      break;
+    case FusedElementwiseOp::Tanh:
+      MlasComputeTanh(x, y, static_cast<size_t>(count));
+      break;
+    case FusedElementwiseOp::Erf:
+      MlasComputeErf(x, y, static_cast<size_t>(count));
+      break;
+    case FusedElementwiseOp::Exp:
+      MlasComputeExp(x, y, static_cast<size_t>(count));
+      break;
+    case FusedElementwiseOp::Neg:
+      ym = -xm;
+      break;
+    case FusedElementwiseOp::Abs:
+      ym = xm.abs();
+      break;
+    case FusedElementwiseOp::Sqrt:
+      ym = xm.sqrt();
+      break;
+    case FusedElementwiseOp::Reciprocal:
+      ym = xm.inverse();
+      break;
+    default:
+      ORT_THROW("Unexpected FusedElementwise operator.");
+  }
+}
+
+}  // namespace
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const int64_t elem_count = input->Shape().Size();
+  Tensor* output = context->Output(0, input->Shape());
+  if (elem_count == 0) {
+    return Status::OK();
+  }
+
+  const int num_operands = context->InputCount() - 1;
+  InlinedVector<const float*> operand_data(num_operands);
+  InlinedVector<bool> operand_is_scalar(num_operands);
+  for (int i = 0; i < num_operands; ++i) {
+    const Tensor* operand = context->Input<Tensor>(i + 1);
+    const int64_t operand_size = operand->Shape().Size();
+    ORT_RETURN_IF_NOT(operand_size == 1 || operand->Shape() == input->Shape(),
+                      "Operand ", i, " with shape ", operand->Shape(), " must have a single element or the shape ",
+                      input->Shape(), " of X.");
+    operand_data[i] = operand->Data<float>();
+    operand_is_scalar[i] = operand_size == 1;
+  }
+
+  const float* input_data = input->Data<float>();
+  float* output_data = output->MutableData<float>();
+
+  // 16 KB of floats per block, so the block stays in the L1 cache for the whole chain.
+  constexpr int64_t length_per_task = 4096;
+  const int64_t task_count = (elem_count + length_per_task - 1) / length_per_task;
+  concurrency::ThreadPool::TryBatchParallelFor(
+      context->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
+      [&](ptrdiff_t task_idx) {
+        const int64_t start = task_idx * length_per_task;
+        const std::ptrdiff_t count = static_cast<std::ptrdiff_t>(std::min(length_per_task, elem_count - start));
+        const float* x = input_data + start;
+        float* y = output_data + start;
+        for (const auto& step : steps_) {
+          const float* operand = nullptr;
+          bool is_scalar = false;
+          if (step.operand_index >= 0) {
+            is_scalar = operand_is_scalar[step.operand_index];
+            operand = operand_data[step.operand_index] + (is_scalar ? 0 : start);
+          }
+          ApplyStep(step.op, x, y, count, operand, is_scalar, step.operand_is_lhs);
+          x = y;
+        }
+      },
+      0);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+enum class FusedElementwiseOp {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Erf,
+  Exp,
+  Neg,
+  Abs,
+  Sqrt,
+  Reciprocal,
+};
+
+// Returns false if op_type is not an operator supported by FusedElementwise.
+bool ParseFusedElementwiseOp(const std::string& op_type, FusedElementwiseOp& op);
+
+bool IsBinaryFusedElementwiseOp(FusedElementwiseOp op);
+
+// Runs a chain of elementwise operators over blocks of X small enough to stay in the L1 cache, so that the
+// intermediate results never go to memory.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Step {
+    FusedElementwiseOp op;
+    int operand_index;
+    bool operand_is_lhs;
+  };
+
+  InlinedVector<Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -26,5 +26,13 @@ namespace contrib {
 REGISTER_CONTRIB_KERNELS(float)
 REGISTER_CONTRIB_KERNELS(double)
 
+// fp16 activations with fp32 mean and inv_std_var, as the U constraint of the op does not include fp16
+ONNX_OPERATOR_TYPED_KERNEL_EX(SimplifiedLayerNormalization, kOnnxDomain, 1, MLFloat16, kCpuExecutionProvider,
+                              KernelDefBuilder()
+                                  .TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>())
+                                  .TypeConstraint("U", DataTypeImpl::GetTensorType<float>())
+                                  .TypeConstraint("V", DataTypeImpl::GetTensorType<MLFloat16>()),
+                              LayerNorm<true>);
+
 }  // namespace contrib
 }  // namespace onnxruntime
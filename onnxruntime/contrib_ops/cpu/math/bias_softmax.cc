@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// This module defines the BiasSoftmax operator for the CPU: softmax(data + bias) with the bias broadcast over the
+// batches of the softmax, e.g. the additive attention mask of the scores. The sum is written to the output row by row
+// and normalized in place while it is in cache, so the result of the Add is never materialized.
+//
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// BiasSoftmax follows the OpSet-11 definition of Softmax, all the dims from axis on are in the same batch, see the
+// CUDA kernel and BiasSoftmaxFusion.
+class BiasSoftmax final : public OpKernel {
+ public:
+  BiasSoftmax(const OpKernelInfo& info) : OpKernel(info) {
+    info.GetAttrOrDefault("axis", &axis_, static_cast<int64_t>(1));
+    int64_t is_inner_broadcast_value;
+    ORT_ENFORCE(info.GetAttr<int64_t>("is_inner_broadcast", &is_inner_broadcast_value).IsOK());
+    is_inner_broadcast_ = is_inner_broadcast_value != 0;
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  bool is_inner_broadcast_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    BiasSoftmax,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    BiasSoftmax);
+
+Status BiasSoftmax::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* B = context->Input<Tensor>(1);
+  const TensorShape& X_shape = X->Shape();
+  Tensor* Y = context->Output(0, X_shape);
+  if (X_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const size_t axis = onnxruntime::narrow<size_t>(HandleNegativeAxis(axis_, X_shape.NumDimensions()));
+  const size_t batch_count = onnxruntime::narrow<size_t>(X_shape.SizeToDimension(axis));
+  const size_t element_count = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(axis));
+  const size_t bias_size = onnxruntime::narrow<size_t>(B->Shape().Size());
+  ORT_RETURN_IF_NOT(bias_size % element_count == 0 && bias_size / element_count > 0 &&
+                        batch_count % (bias_size / element_count) == 0,
+                    "BiasSoftmax: the bias of shape ", B->Shape(), " cannot be broadcast to the input of shape ",
+                    X_shape, " with softmax axis ", axis);
+
+  // Inner broadcast: consecutive batches share a bias batch. Outer broadcast: the bias batches repeat.
+  const size_t bias_batch_count = bias_size / element_count;
+  const size_t bias_broadcast_size = is_inner_broadcast_ ? batch_count / bias_batch_count : bias_batch_count;
+
+  const float* x_data = X->Data<float>();
+  const float* bias_data = B->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  // rows are added and normalized in chunks that stay in the L1 cache between the two passes
+  const size_t rows_per_chunk = std::max<size_t>(1, 4096 / element_count);
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_count),
+      TensorOpCost{static_cast<double>(element_count * sizeof(float) * 2),
+                   static_cast<double>(element_count * sizeof(float)),
+                   static_cast<double>(element_count) * 8},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t begin = static_cast<size_t>(first); begin < static_cast<size_t>(last); begin += rows_per_chunk) {
+          const size_t end = std::min(begin + rows_per_chunk, static_cast<size_t>(last));
+          for (size_t batch = begin; batch < end; ++batch) {
+            const size_t bias_batch = is_inner_broadcast_ ? batch / bias_broadcast_size : batch % bias_broadcast_size;
+            const float* x = x_data + batch * element_count;
+            const float* bias = bias_data + bias_batch * element_count;
+            float* y = y_data + batch * element_count;
+            for (size_t i = 0; i < element_count; ++i) {
+              y[i] = x[i] + bias[i];
+            }
+          }
+
+          float* y = y_data + begin * element_count;
+          MlasComputeSoftmax(y, y, end - begin, element_count, false, nullptr);
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// This module defines the MatMulLoRA operator, a MatMul with a 2-D weight W that adds the
+// low-rank update (X * lora_A) * lora_B to its output. W is pre-packed once, while lora_A and
+// lora_B are regular inputs so that the adapter can change from one run to the next.
+//
+
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class MatMulLoRA final : public OpKernel {
+ public:
+  MatMulLoRA(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  TensorShape w_shape_;
+  IAllocatorUniquePtr<void> packed_w_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulLoRA,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    MatMulLoRA);
+
+Status MatMulLoRA::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                           /*out*/ bool& is_packed,
+                           /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack the weight, the adapter inputs change between runs
+  if (input_idx == 1) {
+    size_t packed_w_size;
+    is_packed = GemmPackBFp32(alloc, tensor, false, packed_w_, packed_w_size, w_shape_);
+
+    if (is_packed && prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_w_));
+      prepacked_weights->buffer_sizes_.push_back(packed_w_size);
+    }
+  }
+  return Status::OK();
+}
+
+Status MatMulLoRA::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                             int input_idx,
+                                             /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_w_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status MatMulLoRA::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* x = ctx->Input<Tensor>(0);
+  const Tensor* w = packed_w_ ? nullptr : ctx->Input<Tensor>(1);
+  const Tensor* lora_a = ctx->Input<Tensor>(2);
+  const Tensor* lora_b = ctx->Input<Tensor>(3);
+  const auto& w_shape = w ? w->Shape() : w_shape_;
+
+  ORT_RETURN_IF_NOT(w_shape.NumDimensions() == 2, "The weight of MatMulLoRA must be a 2D matrix.");
+  ORT_RETURN_IF_NOT(lora_a->Shape().NumDimensions() == 2 && lora_b->Shape().NumDimensions() == 2,
+                    "lora_A and lora_B of MatMulLoRA must be 2D matrices.");
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(x->Shape(), w_shape));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const size_t rank = static_cast<size_t>(lora_a->Shape()[1]);
+  ORT_RETURN_IF_NOT(static_cast<size_t>(lora_a->Shape()[0]) == K &&
+                        static_cast<size_t>(lora_b->Shape()[0]) == rank &&
+                        static_cast<size_t>(lora_b->Shape()[1]) == N,
+                    "MatMulLoRA expects lora_A of shape [", K, ", r] and lora_B of shape [r, ", N,
+                    "], got ", lora_a->Shape(), " and ", lora_b->Shape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* x_data = x->Data<float>();
+  auto* y_data = y->MutableData<float>();
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.BIsPacked = bool(packed_w_);
+  data.A = x_data;
+  data.lda = K;
+  data.B = data.BIsPacked ? static_cast<const float*>(packed_w_.get()) : w->Data<float>();
+  data.ldb = N;
+  data.C = y_data;
+  data.ldc = N;
+  data.alpha = 1.0f;
+  data.beta = 0.0f;
+  MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, data, thread_pool);
+
+  if (rank == 0) {
+    return Status::OK();
+  }
+
+  // Y += (X * lora_A) * lora_B, the [M, r] intermediate is small as r is much smaller than K and N
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  auto xa = IAllocator::MakeUniquePtr<float>(alloc, SafeInt<size_t>(M) * rank);
+
+  MlasGemm(CblasNoTrans, CblasNoTrans, M, rank, K, 1.0f, x_data, K, lora_a->Data<float>(), rank,
+           0.0f, xa.get(), rank, thread_pool);
+  MlasGemm(CblasNoTrans, CblasNoTrans, M, N, rank, 1.0f, xa.get(), rank, lora_b->Data<float>(), N,
+           1.0f, y_data, N, thread_pool);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,295 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MoE,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    MoE<float>);
+
+template <typename T>
+MoE<T>::MoE(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<int64_t>("k", &k_).IsOK());
+
+  std::string activation_type_str;
+  ORT_ENFORCE(op_kernel_info.GetAttr<std::string>("activation_type", &activation_type_str).IsOK());
+  if (activation_type_str == "relu") {
+    activation_type_ = MoEActivationType::Relu;
+  } else if (activation_type_str == "gelu") {
+    activation_type_ = MoEActivationType::Gelu;
+  } else if (activation_type_str == "silu") {
+    activation_type_ = MoEActivationType::Silu;
+  } else if (activation_type_str == "identity") {
+    activation_type_ = MoEActivationType::Identity;
+  } else {
+    ORT_THROW("Unsupported MoE activation type: ", activation_type_str);
+  }
+
+  normalize_routing_weights_ = op_kernel_info.GetAttrOrDefault<int64_t>("normalize_routing_weights", 0) == 1;
+}
+
+namespace {
+
+// Softmax of the router logits of one row then its top k experts, ties go to the lower expert index.
+void TopKGatingSoftmax(const float* logits, int64_t num_experts, int64_t k, bool normalize_routing_weights,
+                       float* probs, int64_t* experts, int* selected, float* scales) {
+  const float max_logit = *std::max_element(logits, logits + num_experts);
+  float sum = 0.f;
+  for (int64_t e = 0; e < num_experts; ++e) {
+    probs[e] = std::exp(logits[e] - max_logit);
+    sum += probs[e];
+  }
+
+  std::iota(experts, experts + num_experts, int64_t{0});
+  std::partial_sort(experts, experts + k, experts + num_experts, [probs](int64_t a, int64_t b) {
+    return probs[a] > probs[b] || (probs[a] == probs[b] && a < b);
+  });
+
+  float selected_sum = 0.f;
+  for (int64_t i = 0; i < k; ++i) {
+    selected[i] = static_cast<int>(experts[i]);
+    scales[i] = probs[experts[i]] / sum;
+    selected_sum += scales[i];
+  }
+  if (normalize_routing_weights) {
+    for (int64_t i = 0; i < k; ++i) {
+      scales[i] /= selected_sum;
+    }
+  }
+}
+
+// Adds the bias to the rows of data and applies the activation. scratch holds one row per row of data.
+void BiasActivation(float* data, const float* bias, float* scratch, int64_t rows, int64_t cols,
+                    MoEActivationType activation_type, ThreadPool* tp) {
+  if (bias == nullptr && activation_type == MoEActivationType::Identity) {
+    return;
+  }
+
+  ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(rows), static_cast<double>(cols * 8),
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t row = begin; row < end; ++row) {
+          float* x = data + row * cols;
+          float* s = scratch + row * cols;
+          const size_t n = static_cast<size_t>(cols);
+          if (bias != nullptr) {
+            for (int64_t j = 0; j < cols; ++j) {
+              x[j] += bias[j];
+            }
+          }
+          switch (activation_type) {
+            case MoEActivationType::Relu:
+              for (int64_t j = 0; j < cols; ++j) {
+                x[j] = std::max(x[j], 0.f);
+              }
+              break;
+            case MoEActivationType::Gelu: {
+              // Tanh approximation, same as the CUDA kernel:
+              // 0.5 * x * (1 + tanh(z)) = x * sigmoid(2 * z) with z = sqrt(2 / pi) * (x + 0.044715 * x^3).
+              constexpr float kAlpha = 2.f * 0.7978845608028654f;
+              for (int64_t j = 0; j < cols; ++j) {
+                s[j] = kAlpha * (x[j] + 0.044715f * x[j] * x[j] * x[j]);
+              }
+              MlasComputeLogistic(s, s, n);
+              for (int64_t j = 0; j < cols; ++j) {
+                x[j] *= s[j];
+              }
+              break;
+            }
+            case MoEActivationType::Silu:
+              MlasComputeLogistic(x, s, n);
+              for (int64_t j = 0; j < cols; ++j) {
+                x[j] *= s[j];
+              }
+              break;
+            case MoEActivationType::Identity:
+              break;
+          }
+        }
+      });
+}
+
+}  // namespace
+
+template <typename T>
+Status MoE<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+  const Tensor* fc1_experts_weights = context->Input<Tensor>(2);
+  const Tensor* fc2_experts_weights = context->Input<Tensor>(3);
+  const Tensor* fc1_experts_bias_optional = context->Input<Tensor>(4);
+  const Tensor* fc2_experts_bias_optional = context->Input<Tensor>(5);
+  const Tensor* fc3_experts_weights_optional = context->Input<Tensor>(6);
+  const Tensor* fc3_experts_bias_optional = context->Input<Tensor>(7);
+
+  MoEParameters moe_params;
+  ORT_RETURN_IF_ERROR(moe_helper::CheckInputs(moe_params, input, router_probs, fc1_experts_weights,
+                                              fc2_experts_weights, fc1_experts_bias_optional,
+                                              fc2_experts_bias_optional, fc3_experts_weights_optional,
+                                              fc3_experts_bias_optional));
+  ORT_RETURN_IF_NOT(moe_params.parallel_type == MoEParallelType::None,
+                    "Expert slicing is not supported by the CPU MoE kernel");
+  ORT_RETURN_IF_NOT(k_ >= 1 && k_ <= moe_params.num_experts, "k must be in [1, num_experts], got ", k_);
+
+  const int64_t num_rows = moe_params.num_rows;
+  const int64_t num_experts = moe_params.num_experts;
+  const int64_t hidden_size = moe_params.hidden_size;
+  const int64_t inter_size = moe_params.inter_size;
+  const int64_t k = k_;
+  const int64_t num_expanded_rows = num_rows * k;
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  ThreadPool* tp = context->GetOperatorThreadPool();
+
+  // Top k gating: the expert and the routing weight of every expanded row (row * k + i).
+  auto expert_for_expanded_row = IAllocator::MakeUniquePtr<int>(allocator, SafeInt<size_t>(num_expanded_rows));
+  auto expert_scales = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_expanded_rows));
+  {
+    const float* logits = router_probs->Data<float>();
+    ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(num_rows), static_cast<double>(num_experts * 4),
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          std::vector<float> probs(static_cast<size_t>(num_experts));
+          std::vector<int64_t> experts(static_cast<size_t>(num_experts));
+          for (std::ptrdiff_t row = begin; row < end; ++row) {
+            TopKGatingSoftmax(logits + row * num_experts, num_experts, k, normalize_routing_weights_, probs.data(),
+                              experts.data(), expert_for_expanded_row.get() + row * k,
+                              expert_scales.get() + row * k);
+          }
+        });
+  }
+
+  // Sort the expanded rows by expert, keeping the row order within an expert.
+  std::vector<int64_t> expert_offsets(static_cast<size_t>(num_experts) + 1, 0);
+  for (int64_t i = 0; i < num_expanded_rows; ++i) {
+    ++expert_offsets[static_cast<size_t>(expert_for_expanded_row.get()[i]) + 1];
+  }
+  std::partial_sum(expert_offsets.begin(), expert_offsets.end(), expert_offsets.begin());
+
+  auto permuted_row_for_expanded_row =
+      IAllocator::MakeUniquePtr<int64_t>(allocator, SafeInt<size_t>(num_expanded_rows));
+  std::vector<int64_t> source_row_for_permuted_row(static_cast<size_t>(num_expanded_rows));
+  {
+    std::vector<int64_t> next_row(expert_offsets.begin(), expert_offsets.end() - 1);
+    for (int64_t i = 0; i < num_expanded_rows; ++i) {
+      const int64_t permuted_row = next_row[static_cast<size_t>(expert_for_expanded_row.get()[i])]++;
+      permuted_row_for_expanded_row.get()[i] = permuted_row;
+      source_row_for_permuted_row[static_cast<size_t>(permuted_row)] = i / k;
+    }
+  }
+
+  int64_t max_rows_per_expert = 0;
+  for (int64_t e = 0; e < num_experts; ++e) {
+    max_rows_per_expert = std::max(max_rows_per_expert, expert_offsets[e + 1] - expert_offsets[e]);
+  }
+
+  const bool has_fc3 = fc3_experts_weights_optional != nullptr;
+  auto permuted_input = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_expanded_rows) * hidden_size);
+  auto fc1_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(max_rows_per_expert) * inter_size);
+  auto fc3_output = has_fc3 ? IAllocator::MakeUniquePtr<float>(allocator,
+                                                               SafeInt<size_t>(max_rows_per_expert) * inter_size)
+                            : IAllocatorUniquePtr<float>{};
+  auto activation_scratch =
+      IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(max_rows_per_expert) * inter_size);
+  auto fc2_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_expanded_rows) * hidden_size);
+
+  const float* input_data = input->Data<float>();
+  ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_expanded_rows), static_cast<double>(hidden_size),
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t row = begin; row < end; ++row) {
+          memcpy(permuted_input.get() + row * hidden_size,
+                 input_data + source_row_for_permuted_row[static_cast<size_t>(row)] * hidden_size,
+                 SafeInt<size_t>(hidden_size) * sizeof(float));
+        }
+      });
+
+  const float* fc1_weights = fc1_experts_weights->Data<float>();
+  const float* fc2_weights = fc2_experts_weights->Data<float>();
+  const float* fc3_weights = has_fc3 ? fc3_experts_weights_optional->Data<float>() : nullptr;
+  const float* fc1_bias = fc1_experts_bias_optional == nullptr ? nullptr : fc1_experts_bias_optional->Data<float>();
+  const float* fc3_bias = fc3_experts_bias_optional == nullptr ? nullptr : fc3_experts_bias_optional->Data<float>();
+
+  // Every expert runs once over its block of rows, the GEMMs are parallelized by the thread pool.
+  for (int64_t e = 0; e < num_experts; ++e) {
+    const int64_t rows = expert_offsets[e + 1] - expert_offsets[e];
+    if (rows == 0) {
+      continue;
+    }
+
+    const float* expert_input = permuted_input.get() + expert_offsets[e] * hidden_size;
+    math::MatMul<float>(rows, inter_size, hidden_size, expert_input, fc1_weights + e * hidden_size * inter_size,
+                        fc1_output.get(), tp);
+    BiasActivation(fc1_output.get(), fc1_bias == nullptr ? nullptr : fc1_bias + e * inter_size,
+                   activation_scratch.get(), rows, inter_size, activation_type_, tp);
+
+    if (has_fc3) {
+      math::MatMul<float>(rows, inter_size, hidden_size, expert_input, fc3_weights + e * hidden_size * inter_size,
+                          fc3_output.get(), tp);
+      BiasActivation(fc3_output.get(), fc3_bias == nullptr ? nullptr : fc3_bias + e * inter_size,
+                     activation_scratch.get(), rows, inter_size, MoEActivationType::Identity, tp);
+      const int64_t count = rows * inter_size;
+      for (int64_t i = 0; i < count; ++i) {
+        fc1_output.get()[i] *= fc3_output.get()[i];
+      }
+    }
+
+    math::MatMul<float>(rows, hidden_size, inter_size, fc1_output.get(), fc2_weights + e * inter_size * hidden_size,
+                        fc2_output.get() + expert_offsets[e] * hidden_size, tp);
+  }
+
+  // Reduce the k expert outputs of every row with their routing weights.
+  const float* fc2_bias = fc2_experts_bias_optional == nullptr ? nullptr : fc2_experts_bias_optional->Data<float>();
+  float* output_data = output->MutableData<float>();
+  ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_rows), static_cast<double>(k * hidden_size * 2),
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t row = begin; row < end; ++row) {
+          float* out = output_data + row * hidden_size;
+          std::fill_n(out, hidden_size, 0.f);
+          for (int64_t i = 0; i < k; ++i) {
+            const int64_t expanded_row = row * k + i;
+            const float scale = expert_scales.get()[expanded_row];
+            const float* expert_output =
+                fc2_output.get() + permuted_row_for_expanded_row.get()[expanded_row] * hidden_size;
+            const float* bias = fc2_bias == nullptr
+                                    ? nullptr
+                                    : fc2_bias + expert_for_expanded_row.get()[expanded_row] * hidden_size;
+            for (int64_t j = 0; j < hidden_size; ++j) {
+              out[j] += scale * (expert_output[j] + (bias == nullptr ? 0.f : bias[j]));
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/moe/moe_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+enum class MoEActivationType {
+  Relu,
+  Gelu,
+  Silu,
+  Identity,
+};
+
+// Mixture of experts on CPU. The rows are sorted by expert after the top-k gating so that every expert runs its
+// two (three for the gated experts) GEMMs once over a contiguous block of its rows.
+template <typename T>
+class MoE final : public OpKernel {
+ public:
+  explicit MoE(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t k_;
+  MoEActivationType activation_type_;
+  bool normalize_routing_weights_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <limits>
+
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/nn/pool_attributes.h"
+#include "core/util/math.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * @brief Channels last max and average pooling for fp32, used by the NhwcTransformer so that the
+ * layout of a channels last convolution carries through the pooling that follows it.
+ *
+ * The windows are gathered with the NHWC indirection im2col and reduced with one vector
+ * operation over the channels per kernel element.
+ */
+class NhwcPoolFloat final : public OpKernel {
+ public:
+  explicit NhwcPoolFloat(const OpKernelInfo& info)
+      : OpKernel(info),
+        pool_attrs_(info, info.GetKernelDef().OpName(), info.node().SinceVersion()),
+        is_max_pool_(info.GetKernelDef().OpName() == "MaxPool") {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  PoolAttributes pool_attrs_;
+  bool is_max_pool_;  // either max pool or average pool
+};
+
+Status NhwcPoolFloat::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const TensorShape& input_shape = X->Shape();
+
+  const size_t input_rank = input_shape.NumDimensions();
+  ORT_RETURN_IF_NOT(input_rank >= 3, "Input dimension cannot be less than 3.");
+
+  const int64_t N = input_shape[0];
+  const int64_t C = input_shape[input_rank - 1];
+
+  ORT_ENFORCE(input_shape.Size() > 0 || N == 0, "Invalid input shape. Only N can be zero. Got:", input_shape);
+
+  const size_t spatial_dims = input_rank - 2;
+
+  // Compute the output size and effective padding for this pooling operation.
+  TensorShapeVector output_dims({N});
+  TensorShapeVector pads = pool_attrs_.pads;
+  TensorShapeVector kernel_shape = pool_attrs_.kernel_shape;
+  TensorShapeVector strides = pool_attrs_.strides;
+  TensorShapeVector dilations = pool_attrs_.dilations;
+  if (pool_attrs_.global_pooling) {
+    const auto& input_dims = input_shape.GetDims();
+    kernel_shape.assign(input_dims.begin() + 1, input_dims.end() - 1);
+    pads.resize(kernel_shape.size() * 2, 0);
+    strides.resize(kernel_shape.size(), 1);
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  ORT_RETURN_IF_NOT(kernel_shape.size() == spatial_dims, "Invalid kernel shape ", TensorShape(kernel_shape),
+                    " for input shape (NHWC) ", input_shape);
+
+  int64_t kernel_size = 1;
+  int64_t input_image_size = 1;
+  int64_t output_image_size = 1;
+  for (size_t dim = 0; dim < spatial_dims; ++dim) {
+    int64_t kernel = kernel_shape[dim];
+    int64_t input_dim = input_shape[dim + 1];
+
+    kernel_size *= kernel;
+    input_image_size *= input_dim;
+
+    int64_t output_dim = 0;
+    pool_attrs_.ComputeSizePadDilations(input_dim,
+                                        strides[dim],
+                                        kernel,
+                                        &pads.at(dim),
+                                        &pads.at(spatial_dims + dim),
+                                        dilations[dim],
+                                        &output_dim);
+    output_dims.push_back(output_dim);
+
+    output_image_size *= output_dim;
+  }
+  output_dims.push_back(C);
+
+  const auto* Xdata = X->Data<float>();
+  auto* Y = context->Output(0, output_dims);
+  auto* Ydata = Y->MutableData<float>();
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // Padded positions of a window are null in the indirection buffer. Max pooling and average pooling
+  // excluding the padding skip them, average pooling including the padding counts them as zeros.
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(const float*)) * kernel_size * output_image_size);
+  BufferUniquePtr col_buffer(col_data, BufferDeleter(std::move(alloc)));
+  const bool count_include_pad = !is_max_pool_ && pool_attrs_.count_include_pad;
+
+  const int64_t output_stride = std::max((int64_t)2, (int64_t)8192 / (kernel_size * C));
+  const int64_t task_count = (output_image_size + output_stride - 1) / output_stride;
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    auto worker = [&](ptrdiff_t batch) {
+      int64_t output_start = (int64_t)batch * (int64_t)output_stride;
+      int64_t output_count = std::min((int64_t)output_stride, output_image_size - output_start);
+      auto indirection_buffer = static_cast<float const**>(col_buffer.get()) + output_start * kernel_size;
+
+      math::Im2col<float, StorageOrder::NHWC>()(
+          Xdata,
+          C,
+          input_shape.GetDims().data() + 1,
+          output_dims.data() + 1,
+          kernel_shape.data(),
+          strides.data(),
+          dilations.data(),
+          pads.data(),
+          static_cast<ptrdiff_t>(spatial_dims),
+          output_start,
+          output_count,
+          indirection_buffer,
+          nullptr);
+
+      for (int64_t i = 0; i < output_count; ++i) {
+        const float* const* window = indirection_buffer + i * kernel_size;
+        EigenVectorArrayMap<float> y(Ydata + (output_start + i) * C, narrow<size_t>(C));
+        if (is_max_pool_) {
+          y.setConstant(std::numeric_limits<float>::lowest());
+          for (int64_t k = 0; k < kernel_size; ++k) {
+            if (window[k] != nullptr) {
+              y = y.max(ConstEigenVectorArrayMap<float>(window[k], narrow<size_t>(C)));
+            }
+          }
+        } else {
+          y.setZero();
+          int64_t count = 0;
+          for (int64_t k = 0; k < kernel_size; ++k) {
+            if (window[k] != nullptr) {
+              y += ConstEigenVectorArrayMap<float>(window[k], narrow<size_t>(C));
+              ++count;
+            }
+          }
+          y /= static_cast<float>(count_include_pad ? kernel_size : std::max(count, int64_t{1}));
+        }
+      }
+    };
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, onnxruntime::narrow<ptrdiff_t>(task_count), worker);
+
+    Xdata += input_image_size * C;
+    Ydata += output_image_size * C;
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MaxPool,
+    kMSInternalNHWCDomain,
+    12,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcPoolFloat);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    AveragePool,
+    kMSInternalNHWCDomain,
+    11,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcPoolFloat);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GlobalAveragePool,
+    kMSInternalNHWCDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcPoolFloat);
+
+}  // namespace contrib
+}  // namespace onnxruntime
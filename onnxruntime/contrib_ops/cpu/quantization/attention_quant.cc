@@ -10,12 +10,58 @@
 #include "core/common/safeint.h"
 #include "core/platform/threadpool.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using onnxruntime::concurrency::ThreadPool;
 
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+
+// Quantizes data symmetrically to int8, or to uint8 with a zero point of 128 when is_signed is false, and
+// returns the scale.
+float QuantizeSymmetric(const float* data, uint8_t* quant_data, size_t count, bool is_signed) {
+  float min;
+  float max;
+  MlasFindMinMaxElement(data, &min, &max, count);
+  const float max_abs = std::max(-min, max);
+  const float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+  if (is_signed) {
+    MlasQuantizeLinear(data, reinterpret_cast<int8_t*>(quant_data), count, scale, static_cast<int8_t>(0));
+  } else {
+    MlasQuantizeLinear(data, quant_data, count, scale, static_cast<uint8_t>(128));
+  }
+  return scale;
+}
+
+// Converts the context GEMM result to fp32 with one scale per row, v_scale / sum(probs) of the row, and writes it
+// to its head in the (B, S, N, H) output.
+class QAttentionContextOutputProcessor : public MLAS_QGEMM_OUTPUT_PROCESSOR {
+ public:
+  QAttentionContextOutputProcessor(float* output, size_t ldo, const float* row_scales)
+      : output_(output), ldo_(ldo), row_scales_(row_scales) {}
+
+  void Process(const int32_t* C, size_t start_m, size_t start_n, size_t count_m, size_t count_n,
+               size_t ldc) const override {
+    for (size_t m = start_m; m < start_m + count_m; m++) {
+      const int32_t* c = C + m * ldc + start_n;
+      float* output = output_ + m * ldo_ + start_n;
+      const float scale = row_scales_[m];
+      for (size_t n = 0; n < count_n; n++) {
+        output[n] = static_cast<float>(c[n]) * scale;
+      }
+    }
+  }
+
+ private:
+  float* output_;
+  size_t ldo_;
+  const float* row_scales_;
+};
+
+}  // namespace
+
 template <typename T>
 class QAttention : public OpKernel, public AttentionCPUBase {
  public:
@@ -32,10 +78,20 @@ class QAttention : public OpKernel, public AttentionCPUBase {
                                    /*out*/ bool& used_shared_buffers) override;
 
  private:
+  Status ComputeInt8Attention(const T* Q, const T* K, const T* V, const Tensor* mask_index, Tensor* output,
+                              int batch_size, int sequence_length, int head_size, int hidden_size,
+                              OpKernelContext* context) const;
+
   IAllocatorUniquePtr<void> packed_weights_;
   size_t packed_weights_size_;
   TensorShape weight_shape_;
   bool weights_is_signed_;
+
+  // Int8 attention: softmax_lookup_table_[i] = 255 x exp(-i x softmax_step_) for the score differences to
+  // the row max, quantized with softmax_step_.
+  bool use_int8_attention_{false};
+  float softmax_step_{0.0f};
+  uint8_t softmax_lookup_table_[256];
 };
 
 // These ops are internal-only, so register outside of onnx
@@ -54,6 +110,17 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
 
 template <typename T>
 QAttention<T>::QAttention(const OpKernelInfo& info) : OpKernel(info), AttentionCPUBase(info, true) {
+  use_int8_attention_ =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsQAttentionInt8Attention, "0") == "1";
+  if (use_int8_attention_) {
+    // 255 x exp(-255 x step) = 0.5, so the table covers every difference that does not round to 0.
+    softmax_step_ = logf(2.0f * 255.0f) / 255.0f;
+    for (int i = 0; i < 256; i++) {
+      softmax_lookup_table_[i] = static_cast<uint8_t>(std::nearbyintf(255.0f * expf(-i * softmax_step_)));
+    }
+    // Differences clamped to the last entry must not contribute.
+    softmax_lookup_table_[255] = 0;
+  }
 }
 
 template <typename T>
@@ -287,6 +354,11 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
     MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
   }
 
+  if (use_int8_attention_ && past_tensor == nullptr) {
+    return ComputeInt8Attention(Q, K, V, mask_index, output, batch_size, sequence_length, head_size, hidden_size,
+                                context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q, K, V, mask_index, past_tensor, nullptr /* past_key */, nullptr /* past_value*/,
                         output, nullptr /* present_key */, nullptr /* present_value */,
@@ -294,5 +366,194 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
                         head_size, head_size, hidden_size, nullptr /* rel_pos_bias */, context);
 }
 
+template <typename T>
+Status QAttention<T>::ComputeInt8Attention(const T* Q, const T* K, const T* V, const Tensor* mask_index,
+                                           Tensor* output, int batch_size, int sequence_length, int head_size,
+                                           int hidden_size, OpKernelContext* context) const {
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  // Without past state, present(2, B, N, S, H) is K followed by V.
+  int past_sequence_length = 0;
+  Tensor* present = GetPresent(context, nullptr, batch_size, head_size, sequence_length, past_sequence_length);
+  if (present != nullptr) {
+    const size_t qkv_size = SafeInt<size_t>(batch_size) * sequence_length * hidden_size;
+    T* present_data = present->MutableData<T>();
+    memcpy(present_data, K, qkv_size * sizeof(T));
+    memcpy(present_data + qkv_size, V, qkv_size * sizeof(T));
+  }
+
+  const int loop_len = batch_size * num_heads_;
+  const size_t chunk_length = static_cast<size_t>(sequence_length) * head_size;        // S x H
+  const size_t probs_length = static_cast<size_t>(sequence_length) * sequence_length;  // S x S
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+  // u8s8 products can saturate without VNNI, K and V are then quantized to uint8 with a zero point of 128.
+  const bool kv_is_signed = !MlasPlatformU8S8Overflow();
+#else
+  const bool kv_is_signed = true;
+#endif
+  const uint8_t kv_zero_point = kv_is_signed ? 0 : 128;
+
+  auto qkv_quant_data = allocator->Alloc(SafeInt<size_t>(loop_len) * chunk_length * 3);
+  BufferUniquePtr qkv_quant_buffer(qkv_quant_data, BufferDeleter(allocator));
+  uint8_t* q_quant = static_cast<uint8_t*>(qkv_quant_data);
+  uint8_t* k_quant = q_quant + loop_len * chunk_length;  // K' with shape BxNxHxS
+  uint8_t* v_quant = k_quant + loop_len * chunk_length;
+
+  std::vector<float> q_scales(loop_len);
+  std::vector<uint8_t> q_zero_points(loop_len);
+  std::vector<float> k_scales(loop_len);
+  std::vector<float> v_scales(loop_len);
+
+  // STEP.1: quantize Q to uint8 and K, V to int8 for every head, K being transposed to H x S.
+  ThreadPool::TryParallelFor(tp, loop_len, static_cast<double>(chunk_length) * 8, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    auto k_tmp_data = allocator->Alloc(chunk_length);
+    BufferUniquePtr k_tmp_buffer(k_tmp_data, BufferDeleter(allocator));
+
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const T* q = Q + chunk_length * i;
+      float min;
+      float max;
+      MlasFindMinMaxElement(q, &min, &max, chunk_length);
+      min = std::min(min, 0.0f);
+      max = std::max(max, 0.0f);
+      q_scales[i] = max == min ? 1.0f : (max - min) / 255.0f;
+      q_zero_points[i] = static_cast<uint8_t>(RoundHalfToEven(std::min(255.0f, -min / q_scales[i])));
+      MlasQuantizeLinear(q, q_quant + chunk_length * i, chunk_length, q_scales[i], q_zero_points[i]);
+
+      k_scales[i] = QuantizeSymmetric(K + chunk_length * i, static_cast<uint8_t*>(k_tmp_data), chunk_length,
+                                      kv_is_signed);
+      MlasTranspose(static_cast<const uint8_t*>(k_tmp_data), k_quant + chunk_length * i,
+                    static_cast<size_t>(sequence_length), static_cast<size_t>(head_size));
+
+      v_scales[i] = QuantizeSymmetric(V + chunk_length * i, v_quant + chunk_length * i, chunk_length, kv_is_signed);
+    }
+  });
+
+  // STEP.2: scores(B, N, S, S) = Q(B, N, S, H) x K'(B, N, H, S) in int32.
+  auto scores_data = allocator->Alloc(SafeInt<size_t>(loop_len) * probs_length * (sizeof(int32_t) + sizeof(uint8_t)));
+  BufferUniquePtr scores_buffer(scores_data, BufferDeleter(allocator));
+  int32_t* scores = static_cast<int32_t*>(scores_data);
+  uint8_t* probs = reinterpret_cast<uint8_t*>(scores + loop_len * probs_length);
+
+  MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+  gemm_shape.M = sequence_length;
+  gemm_shape.N = sequence_length;
+  gemm_shape.K = head_size;
+  gemm_shape.BIsSigned = kv_is_signed;
+
+  std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(loop_len);
+  for (int i = 0; i < loop_len; i++) {
+    auto& gemm_params = gemm_data_vec[i];
+    gemm_params.A = q_quant + chunk_length * i;
+    gemm_params.lda = head_size;
+    gemm_params.ZeroPointA = q_zero_points[i];
+    gemm_params.B = k_quant + chunk_length * i;
+    gemm_params.ldb = sequence_length;
+    gemm_params.ZeroPointB = &kv_zero_point;
+    gemm_params.C = scores + probs_length * i;
+    gemm_params.ldc = sequence_length;
+  }
+
+  MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
+
+  // STEP.3: probs(B, N, S, S) = Softmax(alpha x scores) with 255 standing for the row max. Every score difference
+  // to the row max is requantized to an index of the exp lookup table, the 1 / sum normalization is left to the
+  // context GEMM.
+  const bool causal = is_unidirectional_ && sequence_length > 1;
+  void* mask_data = nullptr;
+  if (mask_index != nullptr || causal) {
+    size_t mask_data_bytes = SafeInt<size_t>(batch_size) * probs_length * sizeof(T);
+    mask_data = allocator->Alloc(mask_data_bytes);
+    memset(mask_data, 0, mask_data_bytes);
+    PrepareMask(mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr,
+                mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{},
+                static_cast<T*>(mask_data), causal, batch_size, sequence_length, 0, mask_filter_value_);
+  }
+  BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
+
+  const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+  std::vector<float> row_scales(SafeInt<size_t>(loop_len) * sequence_length);
+
+  ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(loop_len) * sequence_length, static_cast<double>(sequence_length) * 4, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t row = begin; row != end; ++row) {
+      const std::ptrdiff_t i = row / sequence_length;
+      const int batch_index = static_cast<int>(i / num_heads_);
+      const int32_t* score = scores + sequence_length * row;
+      uint8_t* prob = probs + sequence_length * row;
+
+      // Masked positions hold a non zero mask value. A fully masked row attends to every position as in fp32.
+      const T* mask = nullptr;
+      if (mask_data != nullptr) {
+        mask = static_cast<const T*>(mask_data) +
+               (SafeInt<ptrdiff_t>(batch_index) * sequence_length + row % sequence_length) * sequence_length;
+        if (std::all_of(mask, mask + sequence_length, [](T value) { return value != 0.0f; })) {
+          mask = nullptr;
+        }
+      }
+
+      int32_t score_max = std::numeric_limits<int32_t>::lowest();
+      for (int j = 0; j < sequence_length; j++) {
+        if (mask == nullptr || mask[j] == 0.0f) {
+          score_max = std::max(score_max, score[j]);
+        }
+      }
+
+      const float ratio = alpha * q_scales[i] * k_scales[i] / softmax_step_;
+      int32_t sum = 0;
+      for (int j = 0; j < sequence_length; j++) {
+        if (mask != nullptr && mask[j] != 0.0f) {
+          prob[j] = 0;
+          continue;
+        }
+        const float index = std::min(static_cast<float>(score_max - score[j]) * ratio + 0.5f, 255.0f);
+        prob[j] = softmax_lookup_table_[static_cast<int>(index)];
+        sum += prob[j];
+      }
+      // The row max maps to 255, so sum is never 0.
+      row_scales[row] = v_scales[i] / static_cast<float>(sum);
+    }
+  });
+
+  // STEP.4: output(B, S, N, H) = probs(B, N, S, S) x V(B, N, S, H) x row_scales, written with the transpose to
+  // (B, S, N, H) by the output processors.
+  auto context_data = allocator->Alloc(SafeInt<size_t>(loop_len) * chunk_length * sizeof(int32_t));
+  BufferUniquePtr context_buffer(context_data, BufferDeleter(std::move(allocator)));
+
+  gemm_shape.M = sequence_length;
+  gemm_shape.N = head_size;
+  gemm_shape.K = sequence_length;
+
+  T* output_data = output->MutableData<T>();
+  std::vector<QAttentionContextOutputProcessor> context_procs;
+  context_procs.reserve(loop_len);
+
+  for (int i = 0; i < loop_len; i++) {
+    const int batch_index = i / num_heads_;
+    const int head_index = i % num_heads_;
+    context_procs.emplace_back(
+        output_data + static_cast<ptrdiff_t>(batch_index) * sequence_length * hidden_size + head_index * head_size,
+        hidden_size, row_scales.data() + static_cast<size_t>(i) * sequence_length);
+
+    auto& gemm_params = gemm_data_vec[i];
+    gemm_params.A = probs + probs_length * i;
+    gemm_params.lda = sequence_length;
+    gemm_params.ZeroPointA = 0;
+    gemm_params.B = v_quant + chunk_length * i;
+    gemm_params.ldb = head_size;
+    gemm_params.ZeroPointB = &kv_zero_point;
+    gemm_params.C = static_cast<int32_t*>(context_data) + chunk_length * i;
+    gemm_params.ldc = head_size;
+    gemm_params.OutputProcessor = &(context_procs[i]);
+  }
+
+  MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -45,28 +45,31 @@ class MatMulIntegerToFloatBase : public MatMulIntegerBase {
   enum OutputTensors : int { OUT_Y = 0 };
 
  protected:
+  // a_data is 8-bit, or 16-bit when a_is_16bit is set. a_zp is the raw byte of an 8-bit zero point.
   Status ComputeCommon(OpKernelContext* ctx,
-                       const uint8_t* a_data,
+                       const void* a_data,
                        const TensorShape& a_shape,
                        float a_scale,
-                       uint8_t a_zp,
+                       int32_t a_zp,
                        bool a_is_signed,
                        const Tensor* b_tensor,
                        const Tensor* b_scale,
                        const Tensor* b_zp,
-                       const Tensor* bias_tensor) const;
+                       const Tensor* bias_tensor,
+                       bool a_is_16bit = false) const;
 };
 
 Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
-                                               const uint8_t* a_data,
+                                               const void* a_data,
                                                const TensorShape& a_shape,
                                                float a_scale,
-                                               uint8_t a_zp,
+                                               int32_t a_zp,
                                                bool a_is_signed,
                                                const Tensor* b_tensor,
                                                const Tensor* b_scale_tensor,
                                                const Tensor* b_zp_tensor,
-                                               const Tensor* bias_tensor) const {
+                                               const Tensor* bias_tensor,
+                                               bool a_is_16bit) const {
   MatMulComputeHelper helper;
   ORT_RETURN_IF_ERROR(helper.Compute(a_shape,
                                      b_tensor ? b_tensor->Shape() : b_shape_,
@@ -127,8 +130,6 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
   const size_t num_gemms = helper.OutputOffsets().size();
   std::vector<MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR> gemm_scale_procs;
   gemm_scale_procs.reserve(num_gemms);
-  std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(num_gemms);
-
   for (size_t gemm_idx = 0; gemm_idx < num_gemms; gemm_idx++) {
     gemm_scale_procs.emplace_back(y_data + helper.OutputOffsets()[gemm_idx],
                                   gemm_shape.N,
@@ -136,13 +137,56 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
                                   bias_data,
                                   MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
                                   is_b_scale_per_column ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix);
+  }
+
+  if (a_is_16bit) {
+    // B that is not prepacked is packed for each GEMM
+    const size_t packed_b_size = MlasGemmInt16x8PackBSize(gemm_shape.N, gemm_shape.K);
+    IAllocatorUniquePtr<uint8_t> packed_b_buffer;
+    if (b_tensor != nullptr) {
+      AllocatorPtr allocator;
+      ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+      packed_b_buffer = IAllocator::MakeUniquePtr<uint8_t>(allocator, SafeInt<size_t>(packed_b_size) * num_gemms);
+    }
+
+    ORT_RETURN_IF(b_tensor == nullptr && !b_packed_for_16bit_a_, "B is not packed for a 16-bit A.");
+
+    std::vector<MLAS_GEMM_INT16X8_DATA_PARAMS> gemm_data_vec(num_gemms);
+    for (size_t gemm_idx = 0; gemm_idx < num_gemms; gemm_idx++) {
+      auto& params = gemm_data_vec[gemm_idx];
+      params.OutputProcessor = &(gemm_scale_procs[gemm_idx]);
+      params.A = static_cast<const uint16_t*>(a_data) + helper.LeftOffsets()[gemm_idx];
+      params.lda = gemm_shape.K;
+      params.ZeroPointA = a_zp;
+      if (b_tensor != nullptr) {
+        uint8_t* packed_b = packed_b_buffer.get() + packed_b_size * gemm_idx;
+        MlasGemmInt16x8PackB(gemm_shape.N, gemm_shape.K,
+                             static_cast<const uint8_t*>(b_tensor->DataRaw()) + helper.RightOffsets()[gemm_idx],
+                             gemm_shape.N, gemm_shape.BIsSigned, packed_b);
+        params.PackedB = packed_b;
+      } else {
+        params.PackedB = PackedBAt(helper.RightOffsets()[gemm_idx]);
+      }
+      params.ZeroPointB = b_zp_ptr + helper.RightZeroPointOffsets()[gemm_idx];
+      params.PerColumnZeroPoints = is_b_zp_per_column;
+      params.C = reinterpret_cast<int32_t*>(y_data + helper.OutputOffsets()[gemm_idx]);
+      params.ldc = gemm_shape.N;
+    }
+
+    MlasGemmInt16x8Batch(gemm_shape, gemm_data_vec.data(), num_gemms, ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
+  std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(num_gemms);
+  for (size_t gemm_idx = 0; gemm_idx < num_gemms; gemm_idx++) {
     auto& params = gemm_data_vec[gemm_idx];
     params.OutputProcessor = &(gemm_scale_procs[gemm_idx]);
-    params.A = a_data + helper.LeftOffsets()[gemm_idx];
+    params.A = static_cast<const uint8_t*>(a_data) + helper.LeftOffsets()[gemm_idx];
     params.lda = gemm_shape.K;
-    params.ZeroPointA = a_zp;
+    params.ZeroPointA = static_cast<uint8_t>(a_zp);
     params.BIsPacked = bool(packed_b_);
-    params.B = b_tensor ? static_cast<const uint8_t*>(b_tensor->DataRaw()) + helper.RightOffsets()[gemm_idx] : packed_b_.get();
+    params.B = b_tensor ? static_cast<const uint8_t*>(b_tensor->DataRaw()) + helper.RightOffsets()[gemm_idx]
+                        : PackedBAt(helper.RightOffsets()[gemm_idx]);
     params.ldb = gemm_shape.N;
     params.ZeroPointB = b_zp_ptr + helper.RightZeroPointOffsets()[gemm_idx];
     params.PerColumnZeroPoints = is_b_zp_per_column;
@@ -267,26 +311,34 @@ Status MatMulIntegerToFloat::Compute(OpKernelContext* ctx) const {
   bool is_b_scale_supported = IsBQuantParamSupported(b_scale_tensor->Shape(), nullptr != b ? b->Shape() : b_shape_);
 
   // validate zero point of a
-  uint8_t a_zero_point = 0;
+  const bool a_is_16bit = a->IsDataType<int16_t>() || a->IsDataType<uint16_t>();
+  int32_t a_zero_point = 0;
   const Tensor* a_zero_point_tensor = ctx->Input<Tensor>(IN_A_ZERO_POINT);
   if (a_zero_point_tensor != nullptr) {
     ORT_ENFORCE(IsScalarOr1ElementVector(a_zero_point_tensor),
                 "MatMulIntegerToFloat : input a zero point must be a scalar or 1D tensor of size 1. Per-Channel is not supported yet.");
-    a_zero_point = *(static_cast<const uint8_t*>(a_zero_point_tensor->DataRaw()));
+    if (a_zero_point_tensor->IsDataType<int16_t>()) {
+      a_zero_point = *a_zero_point_tensor->Data<int16_t>();
+    } else if (a_zero_point_tensor->IsDataType<uint16_t>()) {
+      a_zero_point = *a_zero_point_tensor->Data<uint16_t>();
+    } else {
+      a_zero_point = *(static_cast<const uint8_t*>(a_zero_point_tensor->DataRaw()));
+    }
   }
 
   const Tensor* b_zp_tensor = ctx->Input<Tensor>(IN_B_ZERO_POINT);
   ORT_RETURN_IF_ERROR(ComputeCommon(
       ctx,
-      static_cast<const uint8_t*>(a->DataRaw()),
+      a->DataRaw(),
       a->Shape(),
       is_a_scale_scalar ? *a_scale_tensor->Data<float>() : 1.f,
       a_zero_point,
-      a->IsDataType<int8_t>(),
+      a->IsDataType<int8_t>() || a->IsDataType<int16_t>(),
       b,
       is_b_scale_supported ? b_scale_tensor : nullptr,
       b_zp_tensor,
-      ctx->Input<Tensor>(IN_BIAS)));
+      ctx->Input<Tensor>(IN_BIAS),
+      a_is_16bit));
 
   if (!is_a_scale_scalar) {
     ScaleOutput(*a_scale_tensor, *ctx->Output<Tensor>(0));
@@ -333,5 +385,29 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<float>()),
     MatMulIntegerToFloat);
 
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulIntegerToFloat,
+    kMSDomain,
+    1,
+    int16_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int16_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<float>()),
+    MatMulIntegerToFloat);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulIntegerToFloat,
+    kMSDomain,
+    1,
+    uint16_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint16_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<float>()),
+    MatMulIntegerToFloat);
+
 }  // namespace contrib
 }  // namespace onnxruntime
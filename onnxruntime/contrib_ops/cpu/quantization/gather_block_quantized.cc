@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/float16.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Gather of the rows of a table quantized blockwise in the layout of the B input of MatMulNBits. Only the gathered
+// rows are dequantized, so a quantized embedding table never has to be expanded to float.
+template <typename T>
+class GatherBlockQuantized final : public OpKernel {
+ public:
+  GatherBlockQuantized(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("K", &K_));
+    ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("block_size", &block_size_));
+    bits_ = info.GetAttrOrDefault<int64_t>("bits", 4);
+    ORT_ENFORCE(bits_ == 4 || bits_ == 8, "Only 4b and 8b quantization is supported for GatherBlockQuantized op.");
+    ORT_ENFORCE(K_ > 0 && block_size_ >= 16 && ((block_size_ - 1) & block_size_) == 0,
+                "K must be positive and block_size a power of 2 not smaller than 16.");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeTyped(OpKernelContext* context) const;
+
+  int64_t K_;
+  int64_t bits_;
+  int64_t block_size_;
+};
+
+template <typename T>
+Status GatherBlockQuantized<T>::Compute(OpKernelContext* context) const {
+  const Tensor* indices = context->Input<Tensor>(1);
+  if (indices->IsDataType<int32_t>()) {
+    return ComputeTyped<int32_t>(context);
+  }
+  if (indices->IsDataType<int64_t>()) {
+    return ComputeTyped<int64_t>(context);
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "GatherBlockQuantized: indices must be int32 or int64.");
+}
+
+template <typename T>
+template <typename Tind>
+Status GatherBlockQuantized<T>::ComputeTyped(OpKernelContext* context) const {
+  const Tensor* data = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* scales = context->Input<Tensor>(2);
+  const Tensor* zero_points = context->Input<Tensor>(3);
+
+  const size_t K = narrow<size_t>(K_);
+  const size_t bits = narrow<size_t>(bits_);
+  const size_t block_size = narrow<size_t>(block_size_);
+  const size_t blocks_per_row = (K + block_size - 1) / block_size;
+  const size_t row_bytes = blocks_per_row * (block_size * bits / 8);
+  const size_t zero_point_row_bytes = (blocks_per_row * bits + 7) / 8;
+
+  const TensorShape& data_shape = data->Shape();
+  ORT_RETURN_IF_NOT(data_shape.NumDimensions() >= 1, "GatherBlockQuantized: data must have a row dimension.");
+  const int64_t N = data_shape[0];
+  ORT_RETURN_IF_NOT(narrow<size_t>(data_shape.Size()) == SafeInt<size_t>(N) * row_bytes,
+                    "GatherBlockQuantized: data of shape ", data_shape, " does not hold ", N, " rows of ",
+                    row_bytes, " bytes.");
+  ORT_RETURN_IF_NOT(narrow<size_t>(scales->Shape().Size()) == SafeInt<size_t>(N) * blocks_per_row,
+                    "GatherBlockQuantized: scales must have ", N * blocks_per_row, " elements.");
+  ORT_RETURN_IF_NOT(zero_points == nullptr ||
+                        narrow<size_t>(zero_points->Shape().Size()) == SafeInt<size_t>(N) * zero_point_row_bytes,
+                    "GatherBlockQuantized: zero_points must have ", N * zero_point_row_bytes, " elements.");
+
+  TensorShapeVector output_dims = indices->Shape().AsShapeVector();
+  output_dims.push_back(K_);
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+
+  const size_t index_count = narrow<size_t>(indices->Shape().Size());
+  const Tind* indices_data = indices->Data<Tind>();
+  for (size_t i = 0; i < index_count; ++i) {
+    const int64_t index = static_cast<int64_t>(indices_data[i]);
+    ORT_RETURN_IF_NOT(index >= -N && index < N, "GatherBlockQuantized: indices element out of data bounds, idx=",
+                      index, " must be within the inclusive range [", -N, ",", N - 1, "]");
+  }
+
+  const uint8_t* data_data = data->Data<uint8_t>();
+  const T* scales_data = scales->Data<T>();
+  const uint8_t* zero_points_data = zero_points != nullptr ? zero_points->Data<uint8_t>() : nullptr;
+  T* y_data = Y->MutableData<T>();
+
+  const uint32_t value_mask = (1u << bits) - 1;
+  const int32_t default_zero_point = 1 << (bits - 1);
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(index_count),
+      TensorOpCost{static_cast<double>(row_bytes), static_cast<double>(K * sizeof(T)), static_cast<double>(K) * 2},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t i = static_cast<size_t>(first); i < static_cast<size_t>(last); ++i) {
+          int64_t row = static_cast<int64_t>(indices_data[i]);
+          row = row < 0 ? row + N : row;
+          const uint8_t* row_data = data_data + row * row_bytes;
+          const T* row_scales = scales_data + row * blocks_per_row;
+          const uint8_t* row_zero_points = zero_points_data != nullptr ? zero_points_data + row * zero_point_row_bytes
+                                                                       : nullptr;
+          T* y = y_data + i * K;
+
+          for (size_t block = 0; block < blocks_per_row; ++block) {
+            int32_t zero_point = default_zero_point;
+            if (row_zero_points != nullptr) {
+              const size_t bit_offset = block * bits;
+              zero_point = (row_zero_points[bit_offset / 8] >> (bit_offset % 8)) & value_mask;
+            }
+            const float scale = static_cast<float>(row_scales[block]);
+
+            const size_t k_end = std::min(K, (block + 1) * block_size);
+            for (size_t k = block * block_size; k < k_end; ++k) {
+              const size_t bit_offset = k * bits;
+              const int32_t value = (row_data[bit_offset / 8] >> (bit_offset % 8)) & value_mask;
+              y[k] = static_cast<T>(scale * static_cast<float>(value - zero_point));
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+#define REGISTER_GATHER_BLOCK_QUANTIZED_TYPED_KERNEL(data_type)                                 \
+  ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(                                                            \
+      GatherBlockQuantized, 1, data_type,                                                       \
+      KernelDefBuilder()                                                                        \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<data_type>())                       \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())                         \
+          .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),                      \
+                                   DataTypeImpl::GetTensorType<int64_t>()}),                    \
+      GatherBlockQuantized<data_type>);
+
+REGISTER_GATHER_BLOCK_QUANTIZED_TYPED_KERNEL(float);
+REGISTER_GATHER_BLOCK_QUANTIZED_TYPED_KERNEL(MLFloat16);
+
+}  // namespace contrib
+}  // namespace onnxruntime
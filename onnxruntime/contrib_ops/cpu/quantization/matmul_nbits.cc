@@ -79,7 +79,7 @@ class MatMulNBits final : public OpKernel {
     const auto& node = info.node();
     auto input_defs = node.InputDefs();
     // g_idx
-    if (input_defs.size() > 4) {
+    if (input_defs.size() > 4 && input_defs[4]->Exists()) {
       act_order_ = true;
     }
     int32_t type;
@@ -96,8 +96,10 @@ class MatMulNBits final : public OpKernel {
     bool B_constant = info.TryGetConstantInput(1, &tensor_B);
     bool scale_constant = info.TryGetConstantInput(2, &tensor_scale);
     bool zero_point_constant = info.TryGetConstantInput(3, &tensor_zero_point);
-    is_asym_ = info.GetInputCount() >= 4;
-    all_constant_ = B_constant && scale_constant;
+    is_asym_ = input_defs.size() > 3 && input_defs[3]->Exists();
+    // Neural Speed packs fp32 scales with B.
+    all_constant_ = B_constant && scale_constant && GetType(*input_defs[0], type) &&
+                    type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
     all_constant_ = is_asym_ ? all_constant_ && zero_point_constant : all_constant_;
 #endif
   }
@@ -111,7 +113,14 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  bool CanSkipPrePackWithSharedBuffers(int input_idx) const override;
+
  private:
+  // Computes Y with fp32 A, scales and float zero points. fp16 inputs are converted by Compute().
+  Status ComputeFloat(OpKernelContext* ctx, const MatMulComputeHelper& helper, const float* a_data,
+                      const float* scales_data, const void* zero_points_data, bool zero_points_are_float,
+                      float* y_data) const;
+
   const size_t K_;
   const size_t N_;
   const size_t block_size_;
@@ -242,14 +251,25 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+bool MatMulNBits::CanSkipPrePackWithSharedBuffers(int input_idx) const {
+#if defined(ORT_NEURAL_SPEED)
+  // The packed buffer of B is built from several inputs.
+  ORT_UNUSED_PARAMETER(input_idx);
+  return false;
+#else
+  // Compute() only needs packed_b_, which UseSharedPrePackedBuffers() sets.
+  return input_idx == 1;
+#endif
+}
+
 Status MatMulNBits::Compute(OpKernelContext* ctx) const {
-  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   const Tensor* a = ctx->Input<Tensor>(0);
-  const auto* a_data = a->Data<float>();
 
 #if defined(ORT_NEURAL_SPEED)
 
   if (packed_b_) {
+    concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+    const auto* a_data = a->Data<float>();
     TensorShape b_shape({static_cast<int64_t>(N_), static_cast<int64_t>(K_)});
 
     MatMulComputeHelper helper;
@@ -289,13 +309,10 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
 
   const Tensor* scales = ctx->Input<Tensor>(2);
   const Tensor* zero_points = ctx->InputCount() > 3 ? ctx->Input<Tensor>(3) : nullptr;
-  const Tensor* reorder_idx = ctx->InputCount() > 4 ? ctx->Input<Tensor>(4) : nullptr;
-
-  const auto* scales_data = scales->Data<float>();
   const auto* zero_points_data = zero_points == nullptr ? nullptr : zero_points->DataRaw();
+  const bool zero_points_are_float = zero_points != nullptr && !zero_points->IsDataType<uint8_t>();
 
   TensorShape b_shape({static_cast<int64_t>(N_), static_cast<int64_t>(K_)});
-  const auto* reorder_idx_data = reorder_idx == nullptr ? nullptr : reorder_idx->Data<int32_t>();
 
   MatMulComputeHelper helper;
   ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape, false, true));
@@ -307,7 +324,47 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  auto* y_data = y->MutableData<float>();
+  if (a->IsDataType<float>()) {
+    return ComputeFloat(ctx, helper, a->Data<float>(), scales->Data<float>(), zero_points_data,
+                        zero_points_are_float, y->MutableData<float>());
+  }
+
+  // fp16 A, scales and float zero points are converted to fp32, and Y is computed with fp32 accumulation. B stays
+  // quantized, so the conversion only touches the activations and the small scale tensors.
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+  const size_t a_size = SafeInt<size_t>(a->Shape().Size());
+  const size_t scales_size = SafeInt<size_t>(scales->Shape().Size());
+  const size_t zero_points_size = zero_points_are_float ? SafeInt<size_t>(zero_points->Shape().Size()) : 0;
+  const size_t y_size = SafeInt<size_t>(y->Shape().Size());
+  auto buffer = IAllocator::MakeUniquePtr<float>(allocator, a_size + scales_size + zero_points_size + y_size);
+  float* a_float = buffer.get();
+  float* scales_float = a_float + a_size;
+  float* zero_points_float = scales_float + scales_size;
+  float* y_float = zero_points_float + zero_points_size;
+  MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(a->Data<MLFloat16>()), a_float, a_size);
+  MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(scales->Data<MLFloat16>()), scales_float,
+                               scales_size);
+  if (zero_points_are_float) {
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(zero_points->Data<MLFloat16>()),
+                                 zero_points_float, zero_points_size);
+    zero_points_data = zero_points_float;
+  }
+
+  ORT_RETURN_IF_ERROR(ComputeFloat(ctx, helper, a_float, scales_float, zero_points_data, zero_points_are_float,
+                                   y_float));
+  MlasConvertFloatToHalfBuffer(y_float, reinterpret_cast<unsigned short*>(y->MutableData<MLFloat16>()), y_size);
+  return Status::OK();
+}
+
+Status MatMulNBits::ComputeFloat(OpKernelContext* ctx, const MatMulComputeHelper& helper, const float* a_data,
+                                 const float* scales_data, const void* zero_points_data, bool zero_points_are_float,
+                                 float* y_data) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* reorder_idx = ctx->InputCount() > 4 ? ctx->Input<Tensor>(4) : nullptr;
+  const Tensor* quantized_a = ctx->InputCount() > 5 ? ctx->Input<Tensor>(5) : nullptr;
+  const auto* reorder_idx_data = reorder_idx == nullptr ? nullptr : reorder_idx->Data<int32_t>();
 
   const size_t batch_count = helper.OutputOffsets().size();
   const size_t M = static_cast<size_t>(helper.M());
@@ -323,10 +380,21 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
     const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
 
     if (MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
+      // A quantized by QuantizeMatMulNBitsInput, which the MatMulNBits nodes sharing A take instead of quantizing it
+      const std::byte* quantized_a_data = nullptr;
+      const size_t quantized_a_row_size = MlasSQNBitGemmQuantizedASize(1, K, nbits_, block_size_, compute_type);
+      if (quantized_a != nullptr && quantized_a_row_size > 0) {
+        const TensorShape expected_shape({a->Shape().Size() / static_cast<int64_t>(K),
+                                          static_cast<int64_t>(quantized_a_row_size)});
+        ORT_RETURN_IF_NOT(quantized_a->Shape() == expected_shape, "Input quantized_A is expected to have shape ",
+                          expected_shape, ", got ", quantized_a->Shape());
+        quantized_a_data = static_cast<const std::byte*>(quantized_a->DataRaw());
+      }
+
       IAllocatorUniquePtr<std::byte> workspace{};
       if (const size_t workspace_size = MlasSQNBitGemmBatchWorkspaceSize(M, N, K, batch_count,
                                                                          nbits_, block_size_, compute_type);
-          workspace_size > 0) {
+          workspace_size > 0 && quantized_a_data == nullptr) {
         AllocatorPtr allocator;
         ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
         workspace = IAllocator::MakeUniquePtr<std::byte>(allocator, workspace_size);
@@ -345,6 +413,9 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
       for (size_t i = 0; i < batch_count; ++i) {
         data[i].A = a_data + helper.LeftOffsets()[i];
         data[i].lda = lda;
+        if (quantized_a_data != nullptr) {
+          data[i].QuantA = quantized_a_data + helper.LeftOffsets()[i] / K * quantized_a_row_size;
+        }
         data[i].QuantBData = b_data;
         data[i].QuantBScale = scales_data;
         data[i].QuantBZeroPoint = zero_points_data;
@@ -366,7 +437,7 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_);
-  if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
+  if ((reorder_idx_data == nullptr) && !zero_points_are_float) {
     // dequantize b, only 4b quantization is supported for now
     MlasDequantizeBlockwise<float, 4>(
         tmp_b_data_ptr.get(),                           // dequantized output
@@ -381,7 +452,7 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   } else {
     ORT_ENFORCE(column_wise_quant_, "Row-wise quantization is not supported for now");
     // !!!!!!!!!!!!!! naive implementation, need to be optimized !!!!!!!!!!!!!!
-    if ((zero_points && zero_points->IsDataType<float>())) {
+    if (zero_points_are_float) {
       DequantizeBlockwise<float, float>(
           tmp_b_data_ptr.get(),                         // dequantized output
           b_data,                                       // quantized input
@@ -436,11 +507,59 @@ ONNX_OPERATOR_KERNEL_EX(
     1,
     kCpuExecutionProvider,
     KernelDefBuilder()
-        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<MLFloat16>()})
         .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
-        .TypeConstraint("T3", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<float>()})
-        .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
+        .TypeConstraint("T3", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<float>(),
+                               DataTypeImpl::GetTensorType<MLFloat16>()})
+        .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T5", DataTypeImpl::GetTensorType<uint8_t>()),
     MatMulNBits);
 
+// Quantizes input A of the MatMulNBits nodes with the int8 compute type once for all of them.
+class QuantizeMatMulNBitsInput final : public OpKernel {
+ public:
+  QuantizeMatMulNBitsInput(const OpKernelInfo& info)
+      : OpKernel(info),
+        K_{narrow<size_t>(info.GetAttr<int64_t>("K"))},
+        block_size_{narrow<size_t>(info.GetAttr<int64_t>("block_size"))} {
+    ORT_ENFORCE(MlasIsSQNBitGemmAvailable(kNBits, block_size_, CompInt8),
+                "The int8 compute type of MatMulNBits is not available for block_size ", block_size_, ".");
+  }
+
+  Status Compute(OpKernelContext* ctx) const override {
+    const Tensor* a = ctx->Input<Tensor>(0);
+    const TensorShape& a_shape = a->Shape();
+    ORT_RETURN_IF_NOT(a_shape.NumDimensions() > 0 && static_cast<size_t>(a_shape[a_shape.NumDimensions() - 1]) == K_,
+                      "The last dimension of input A is expected to be K ", K_, ", got shape ", a_shape);
+
+    const size_t M = narrow<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+    const size_t row_size = MlasSQNBitGemmQuantizedASize(1, K_, kNBits, block_size_, CompInt8);
+    Tensor* y = ctx->Output(0, {static_cast<int64_t>(M), static_cast<int64_t>(row_size)});
+    if (M == 0) {
+      return Status::OK();
+    }
+
+    MlasSQNBitGemmQuantizeA(M, K_, kNBits, block_size_, CompInt8, a->Data<float>(), K_, y->MutableDataRaw(),
+                            ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
+ private:
+  // MatMulNBits only supports 4b quantization
+  static constexpr size_t kNBits = 4;
+  const size_t K_;
+  const size_t block_size_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    QuantizeMatMulNBitsInput,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    QuantizeMatMulNBitsInput);
+
 }  // namespace contrib
 }  // namespace onnxruntime
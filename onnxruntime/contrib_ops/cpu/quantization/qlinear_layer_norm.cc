@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// LayerNormalization of a quantized tensor, with quantized output. Each row is dequantized with a table of the 256
+// values of the input type, normalized in float and requantized, so the DQ -> LayerNormalization -> Q chain of a
+// QDQ model runs without the float tensors in between.
+template <typename T>
+class QLinearLayerNormalization final : public OpKernel {
+ public:
+  QLinearLayerNormalization(const OpKernelInfo& info) : OpKernel(info) {
+    axis_ = info.GetAttrOrDefault<int64_t>("axis", -1);
+    epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  float epsilon_;
+};
+
+template <typename T>
+Status QLinearLayerNormalization<T>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* x_scale = context->Input<Tensor>(1);
+  const auto* x_zero_point = context->Input<Tensor>(2);
+  const auto* scale = context->Input<Tensor>(3);
+  const auto* y_scale = context->Input<Tensor>(4);
+  const auto* y_zero_point = context->Input<Tensor>(5);
+  const auto* bias = context->Input<Tensor>(6);
+
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(x_scale) && IsScalarOr1ElementVector(y_scale) &&
+                        (x_zero_point == nullptr || IsScalarOr1ElementVector(x_zero_point)) &&
+                        (y_zero_point == nullptr || IsScalarOr1ElementVector(y_zero_point)),
+                    "QLinearLayerNormalization: the scales and zero points must be scalars.");
+
+  const TensorShape& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  if (x_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const size_t axis = onnxruntime::narrow<size_t>(HandleNegativeAxis(axis_, x_shape.NumDimensions()));
+  const size_t row_count = onnxruntime::narrow<size_t>(x_shape.SizeToDimension(axis));
+  const size_t norm_size = onnxruntime::narrow<size_t>(x_shape.SizeFromDimension(axis));
+  ORT_RETURN_IF_NOT(onnxruntime::narrow<size_t>(scale->Shape().Size()) == norm_size &&
+                        (bias == nullptr || onnxruntime::narrow<size_t>(bias->Shape().Size()) == norm_size),
+                    "QLinearLayerNormalization: scale and B must have the ", norm_size,
+                    " elements of the normalized shape ", x_shape.Slice(axis));
+
+  const float x_scale_value = *x_scale->Data<float>();
+  const T x_zero_point_value = x_zero_point != nullptr ? *x_zero_point->Data<T>() : T{};
+  const float y_scale_value = *y_scale->Data<float>();
+  const T y_zero_point_value = y_zero_point != nullptr ? *y_zero_point->Data<T>() : T{};
+
+  // dequantized value of each byte of the input
+  float dequantize_table[256];
+  for (int i = 0; i < 256; ++i) {
+    const T value = static_cast<T>(static_cast<uint8_t>(i));
+    dequantize_table[i] = x_scale_value * (static_cast<int32_t>(value) - static_cast<int32_t>(x_zero_point_value));
+  }
+
+  const auto* x_data = reinterpret_cast<const uint8_t*>(X->Data<T>());
+  const float* scale_data = scale->Data<float>();
+  const float* bias_data = bias != nullptr ? bias->Data<float>() : nullptr;
+  T* y_data = Y->MutableData<T>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(row_count),
+      TensorOpCost{static_cast<double>(norm_size * sizeof(T)),
+                   static_cast<double>(norm_size * sizeof(T)),
+                   static_cast<double>(norm_size) * 8},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> row(norm_size);
+        for (size_t r = static_cast<size_t>(first); r < static_cast<size_t>(last); ++r) {
+          const uint8_t* x = x_data + r * norm_size;
+          float mean = 0.0f;
+          float mean_square = 0.0f;
+          for (size_t h = 0; h < norm_size; ++h) {
+            const float value = dequantize_table[x[h]];
+            row[h] = value;
+            mean += value;
+            mean_square += value * value;
+          }
+          mean = mean / norm_size;
+          const float std_dev = std::sqrt(mean_square / norm_size - mean * mean + epsilon_);
+
+          for (size_t h = 0; h < norm_size; ++h) {
+            row[h] = (row[h] - mean) / std_dev * scale_data[h] + (bias_data != nullptr ? bias_data[h] : 0.0f);
+          }
+          MlasQuantizeLinear(row.data(), y_data + r * norm_size, norm_size, y_scale_value, y_zero_point_value);
+        }
+      });
+
+  return Status::OK();
+}
+
+#define REGISTER_QLINEAR_LAYER_NORM_TYPED_KERNEL(data_type)                  \
+  ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(                                         \
+      QLinearLayerNormalization, 1, data_type,                               \
+      KernelDefBuilder()                                                     \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()),    \
+      QLinearLayerNormalization<data_type>);
+
+REGISTER_QLINEAR_LAYER_NORM_TYPED_KERNEL(int8_t);
+REGISTER_QLINEAR_LAYER_NORM_TYPED_KERNEL(uint8_t);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -1,7 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <type_traits>
+#include <vector>
+
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -33,6 +37,7 @@ namespace contrib {
 
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
 
 template <typename T, bool simplified>
 SkipLayerNorm<T, simplified>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
@@ -81,53 +86,107 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
 
   const auto& skip_size = skip->Shape().Size();
 
-  concurrency::ThreadPool::TryBatchParallelFor(
-      p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
-      [&](ptrdiff_t task_idx) {
-        auto offset = task_idx * hidden_size;
+  if constexpr (std::is_same_v<T, MLFloat16>) {
+    // fp16 rows are converted to fp32 and normalized with fp32 accumulation, so the activations stay in fp16.
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
+    const size_t hidden = static_cast<size_t>(hidden_size);
+    auto params = IAllocator::MakeUniquePtr<float>(alloc, 3 * hidden);
+    float* gamma_float = params.get();
+    float* beta_float = beta_data == nullptr ? nullptr : gamma_float + hidden;
+    float* bias_float = bias_data == nullptr ? nullptr : gamma_float + 2 * hidden;
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(gamma_data), gamma_float, hidden);
+    if (beta_float != nullptr) {
+      MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(beta_data), beta_float, hidden);
+    }
+    if (bias_float != nullptr) {
+      MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(bias_data), bias_float, hidden);
+    }
+
+    const double bytes_stored = static_cast<double>(sizeof(T)) * hidden_size *
+                                (skip_input_bias_add_output_data != nullptr ? 2 : 1);
+    concurrency::ThreadPool::TryParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(task_count),
+        TensorOpCost{static_cast<double>(sizeof(T)) * 2 * hidden_size, bytes_stored, 10.0 * hidden_size},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          // The sum of input, skip and bias is stored over the input row, and the output over the skip row.
+          std::vector<float> rows(2 * hidden);
+          float* input_row = rows.data();
+          float* output_row = input_row + hidden;
+          for (std::ptrdiff_t task_idx = first; task_idx < last; task_idx++) {
+            auto offset = task_idx * hidden_size;
+            MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(input_data + offset), input_row,
+                                         hidden);
+            MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(skip_data + (offset % skip_size)),
+                                         output_row, hidden);
+            MlasLayerNormalization(input_row, output_row, bias_float, gamma_float, beta_float, output_row,
+                                   skip_input_bias_add_output_data != nullptr ? input_row : nullptr, hidden,
+                                   epsilon_, simplified, nullptr, nullptr);
+
+            MlasConvertFloatToHalfBuffer(output_row, reinterpret_cast<unsigned short*>(output_data + offset),
+                                         hidden);
+            if (skip_input_bias_add_output_data != nullptr) {
+              MlasConvertFloatToHalfBuffer(
+                  input_row, reinterpret_cast<unsigned short*>(skip_input_bias_add_output_data + offset), hidden);
+            }
+          }
+        });
+  } else {
+    concurrency::ThreadPool::TryBatchParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
+        [&](ptrdiff_t task_idx) {
+          auto offset = task_idx * hidden_size;
+
+          const T* p_input = input_data + offset;
+          const T* p_skip = skip_data + (offset % skip_size);
+          T* p_output = output_data + offset;
+          T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
+
+          if constexpr (std::is_same_v<T, float>) {
+            MlasLayerNormalization(p_input, p_skip, bias_data, gamma_data, beta_data, p_output,
+                                   p_skip_input_bias_add_output_data, static_cast<size_t>(hidden_size), epsilon_,
+                                   simplified, nullptr, nullptr);
+            return;
+          }
 
-        const T* p_input = input_data + offset;
-        const T* p_skip = skip_data + (offset % skip_size);
-        T* p_output = output_data + offset;
-        T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
+          T mean = 0;
+          T mean_square = 0;
 
-        T mean = 0;
-        T mean_square = 0;
+          for (int64_t h = 0; h < hidden_size; h++) {
+            T value = p_input[h] + p_skip[h];
 
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
+            if (nullptr != bias_data) {
+              value += bias_data[h];
+            }
 
-          if (nullptr != bias_data) {
-            value += bias_data[h];
-          }
+            if (nullptr != p_skip_input_bias_add_output_data) {
+              p_skip_input_bias_add_output_data[h] = value;
+            }
 
-          if (nullptr != p_skip_input_bias_add_output_data) {
-            p_skip_input_bias_add_output_data[h] = value;
+            p_output[h] = value;
+            mean += value;
+            mean_square += value * value;
           }
 
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
-        }
-
-        mean = mean / hidden_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / hidden_size + epsilon_);
-        } else {
-          mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
-        }
-
-        for (int64_t h = 0; h < hidden_size; h++) {
+          mean = mean / hidden_size;
           if (simplified) {
-            p_output[h] = p_output[h] / mean_square * gamma_data[h];
-          } else if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+            mean_square = sqrt(mean_square / hidden_size + epsilon_);
           } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+            mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
+          }
+
+          for (int64_t h = 0; h < hidden_size; h++) {
+            if (simplified) {
+              p_output[h] = p_output[h] / mean_square * gamma_data[h];
+            } else if (nullptr == beta_data) {
+              p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+            } else {
+              p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+            }
           }
-        }
-      },
-      0);
+        },
+        0);
+  }
 
   return Status::OK();
 }
@@ -0,0 +1,262 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/tensor/embedding_bag.h"
+
+#include <type_traits>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", std::vector<MLDataType>{DataTypeImpl::GetTensorType<float>(),
+                                                     DataTypeImpl::GetTensorType<MLFloat16>(),
+                                                     DataTypeImpl::GetTensorType<uint8_t>(),
+                                                     DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T1", std::vector<MLDataType>{DataTypeImpl::GetTensorType<float>(),
+                                                      DataTypeImpl::GetTensorType<MLFloat16>()})
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+EmbeddingBag::EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+  const std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  ORT_ENFORCE(mode == "sum" || mode == "mean", "EmbeddingBag: mode must be 'sum' or 'mean', got ", mode);
+  mean_ = mode == "mean";
+}
+
+namespace {
+// Adds a row of the embedding matrix scaled by sample_weight to sum, in float.
+// float16 rows are converted through buffer, 8-bit rows are dequantized with the scale and zero point of the row.
+template <typename T>
+void AccumulateRow(const T* row, size_t embedding_dim, float sample_weight, float scale, T zero_point,
+                   float* buffer, float* sum) {
+  EigenVectorArrayMap<float> sum_map(sum, embedding_dim);
+  if constexpr (std::is_same_v<T, float>) {
+    ConstEigenVectorArrayMap<float> row_map(row, embedding_dim);
+    if (sample_weight == 1.0f) {
+      sum_map += row_map;
+    } else {
+      sum_map += row_map * sample_weight;
+    }
+  } else if constexpr (std::is_same_v<T, MLFloat16>) {
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(row), buffer, embedding_dim);
+    ConstEigenVectorArrayMap<float> row_map(buffer, embedding_dim);
+    sum_map += row_map * sample_weight;
+  } else {
+    // (q - zero_point) * scale * sample_weight, with the zero point folded into an offset
+    const float row_scale = scale * sample_weight;
+    const float row_offset = -row_scale * static_cast<float>(zero_point);
+    for (size_t d = 0; d < embedding_dim; ++d) {
+      sum[d] += static_cast<float>(row[d]) * row_scale + row_offset;
+    }
+  }
+}
+}  // namespace
+
+template <typename T, typename Tind>
+Status EmbeddingBag::ComputeImpl(OpKernelContext* context, const Tensor& weight, const Tensor& indices,
+                                 const Tensor* offsets, const Tensor* per_sample_weights, const Tensor* scales,
+                                 const Tensor* zero_points, Tensor& output) const {
+  const int64_t num_embeddings = weight.Shape()[0];
+  const size_t embedding_dim = narrow<size_t>(weight.Shape()[1]);
+  const int64_t num_bags = output.Shape()[0];
+  const int64_t num_indices = indices.Shape().Size();
+
+  const Tind* indices_data = indices.Data<Tind>();
+  for (int64_t i = 0; i < num_indices; ++i) {
+    const Tind idx = indices_data[i];
+    if (idx < -num_embeddings || idx >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -num_embeddings, ",", num_embeddings - 1, "]");
+    }
+  }
+
+  // bag i spans [bag_starts[i], bag_starts[i + 1])
+  std::vector<int64_t> bag_starts(narrow<size_t>(num_bags) + 1);
+  if (offsets != nullptr) {
+    const Tind* offsets_data = offsets->Data<Tind>();
+    for (int64_t bag = 0; bag < num_bags; ++bag) {
+      const int64_t offset = static_cast<int64_t>(offsets_data[bag]);
+      if (offset < (bag == 0 ? 0 : bag_starts[bag - 1]) || offset > num_indices) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "EmbeddingBag: offsets must be non-decreasing and within [0, ", num_indices,
+                               "], got ", offset, " at ", bag);
+      }
+      bag_starts[bag] = offset;
+    }
+    bag_starts[num_bags] = num_indices;
+  } else {
+    const int64_t bag_size = indices.Shape()[1];
+    for (int64_t bag = 0; bag <= num_bags; ++bag) {
+      bag_starts[bag] = bag * bag_size;
+    }
+  }
+
+  using T1 = std::conditional_t<std::is_same_v<T, MLFloat16>, MLFloat16, float>;
+  const T* weight_data = weight.Data<T>();
+  const T1* sample_weights = per_sample_weights != nullptr ? per_sample_weights->Data<T1>() : nullptr;
+  const float* scales_data = scales != nullptr ? scales->Data<float>() : nullptr;
+  const T* zero_points_data = zero_points != nullptr ? zero_points->Data<T>() : nullptr;
+  T1* output_data = output.MutableData<T1>();
+
+  auto row_index = [&](int64_t i) {
+    return indices_data[i] < 0 ? static_cast<int64_t>(indices_data[i]) + num_embeddings
+                               : static_cast<int64_t>(indices_data[i]);
+  };
+
+  // Each bag accumulates its rows in float without storing the gathered rows, directly into the output for float
+  // outputs. The rows are randomly indexed, so the next row is prefetched while the current one is added.
+  const double row_bytes = static_cast<double>(embedding_dim * sizeof(T));
+  const double average_bag_size = num_bags > 0 ? static_cast<double>(num_indices) / static_cast<double>(num_bags) : 0;
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(num_bags),
+      TensorOpCost{row_bytes * average_bag_size, static_cast<double>(embedding_dim * sizeof(T1)),
+                   static_cast<double>(embedding_dim) * average_bag_size},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> sum_buffer;
+        std::vector<float> row_buffer;
+        if constexpr (!std::is_same_v<T1, float>) {
+          sum_buffer.resize(embedding_dim);
+        }
+        if constexpr (std::is_same_v<T, MLFloat16>) {
+          row_buffer.resize(embedding_dim);
+        }
+
+        for (std::ptrdiff_t bag = first; bag < last; ++bag) {
+          float* sum;
+          if constexpr (std::is_same_v<T1, float>) {
+            sum = output_data + bag * embedding_dim;
+          } else {
+            sum = sum_buffer.data();
+          }
+          std::fill_n(sum, embedding_dim, 0.0f);
+
+          const int64_t begin = bag_starts[bag];
+          const int64_t end = bag_starts[bag + 1];
+          for (int64_t i = begin; i < end; ++i) {
+            if (i + 1 < end) {
+              GatherPrefetchRow(weight_data + row_index(i + 1) * static_cast<int64_t>(embedding_dim));
+            }
+            const int64_t row = row_index(i);
+            float sample_weight = 1.0f;
+            if (sample_weights != nullptr) {
+              if constexpr (std::is_same_v<T1, float>) {
+                sample_weight = sample_weights[i];
+              } else {
+                sample_weight = sample_weights[i].ToFloat();
+              }
+            }
+            AccumulateRow(weight_data + row * static_cast<int64_t>(embedding_dim), embedding_dim, sample_weight,
+                          scales_data != nullptr ? scales_data[row] : 1.0f,
+                          zero_points_data != nullptr ? zero_points_data[row] : T{}, row_buffer.data(), sum);
+          }
+
+          if (mean_ && end - begin > 1) {
+            EigenVectorArrayMap<float>(sum, embedding_dim) *= 1.0f / static_cast<float>(end - begin);
+          }
+          if constexpr (!std::is_same_v<T1, float>) {
+            MlasConvertFloatToHalfBuffer(sum, reinterpret_cast<unsigned short*>(output_data + bag * embedding_dim),
+                                         embedding_dim);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  const Tensor* weight = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* per_sample_weights = context->Input<Tensor>(2);
+  const Tensor* offsets = context->Input<Tensor>(3);
+  const Tensor* scales = context->Input<Tensor>(4);
+  const Tensor* zero_points = context->Input<Tensor>(5);
+
+  const TensorShape& weight_shape = weight->Shape();
+  const TensorShape& indices_shape = indices->Shape();
+
+  if (weight_shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "EmbeddingBag: weight must be 2D, got shape ", weight_shape);
+  }
+  int64_t num_bags = 0;
+  if (offsets != nullptr) {
+    if (indices_shape.NumDimensions() != 1 || offsets->Shape().NumDimensions() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag: indices and offsets must be 1D, got shapes ", indices_shape, " and ",
+                             offsets->Shape());
+    }
+    num_bags = offsets->Shape()[0];
+  } else {
+    if (indices_shape.NumDimensions() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag: indices must be 2D (num_bags, bag_size), got shape ", indices_shape);
+    }
+    num_bags = indices_shape[0];
+  }
+  if (per_sample_weights != nullptr) {
+    if (mean_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag: per_sample_weights is only supported with 'sum' mode.");
+    }
+    if (per_sample_weights->Shape() != indices_shape) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag: per_sample_weights shape ", per_sample_weights->Shape(),
+                             " must match indices shape ", indices_shape);
+    }
+  }
+
+  const bool is_quantized = weight->IsDataType<uint8_t>() || weight->IsDataType<int8_t>();
+  if (is_quantized) {
+    if (scales == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "EmbeddingBag: scales are required for 8-bit weight.");
+    }
+    const TensorShape rows_shape({weight_shape[0]});
+    if (scales->Shape() != rows_shape || (zero_points != nullptr && zero_points->Shape() != rows_shape)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "EmbeddingBag: scales and zero_points must have shape ", rows_shape);
+    }
+  } else if (scales != nullptr || zero_points != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "EmbeddingBag: scales and zero_points are only supported with 8-bit weight.");
+  }
+
+  Tensor* output = context->Output(0, {num_bags, weight_shape[1]});
+
+  auto dispatch = [&](auto table_type_tag) {
+    using T = decltype(table_type_tag);
+    if (indices->IsDataType<int32_t>()) {
+      return ComputeImpl<T, int32_t>(context, *weight, *indices, offsets, per_sample_weights, scales, zero_points,
+                                     *output);
+    }
+    return ComputeImpl<T, int64_t>(context, *weight, *indices, offsets, per_sample_weights, scales, zero_points,
+                                   *output);
+  };
+
+  if (weight->IsDataType<float>()) {
+    return dispatch(float{});
+  }
+  if (weight->IsDataType<MLFloat16>()) {
+    return dispatch(MLFloat16{});
+  }
+  if (weight->IsDataType<uint8_t>()) {
+    return dispatch(uint8_t{});
+  }
+  return dispatch(int8_t{});
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Fused Gather + ReduceSum/ReduceMean over bags of embedding indices.
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename T, typename Tind>
+  Status ComputeImpl(OpKernelContext* context, const Tensor& weight, const Tensor& indices, const Tensor* offsets,
+                     const Tensor* per_sample_weights, const Tensor* scales, const Tensor* zero_points,
+                     Tensor& output) const;
+
+  bool mean_{false};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -1,11 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/common/narrow.h"
 #include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
 namespace onnxruntime {
@@ -31,6 +34,10 @@ class Tokenizer final : public OpKernel {
                          size_t N, size_t C,
                          gsl::span<const int64_t> input_dims) const;
 
+  // Writes each row of tokens as a row of the output, padded to the longest row and marked if required.
+  Status OutputTokens(OpKernelContext* ctx, gsl::span<const int64_t> input_dims,
+                      const std::vector<std::vector<re2::StringPiece>>& rows) const;
+
   bool mark_{false};
   std::string pad_value_;
   int64_t mincharnum_{0};
@@ -114,29 +121,60 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
   }
 }
 
+namespace {
+
+// Strings per batch below which the strings are not worth handing to the thread pool
+constexpr size_t kMinStringsPerBatch = 16;
+
+// Runs fn(first, last) over the `count` input strings in batches on the thread pool and returns the first failure.
+template <typename Fn>
+Status ParallelForStrings(concurrency::ThreadPool* tp, size_t count, Fn&& fn) {
+  const size_t num_batches = std::min(static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp)) * 2,
+                                      count / kMinStringsPerBatch);
+  if (num_batches <= 1) {
+    return fn(size_t{0}, count);
+  }
+
+  std::vector<Status> statuses(num_batches);
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, static_cast<std::ptrdiff_t>(num_batches),
+                                                [&](std::ptrdiff_t batch) {
+                                                  auto work = concurrency::ThreadPool::PartitionWork(batch, num_batches,
+                                                                                                      count);
+                                                  statuses[batch] = fn(work.start, work.end);
+                                                });
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
 Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
                                gsl::span<const int64_t> input_dims) const {
   // With char tokenzation we get as many tokens as the number of
   // utf8 characters in the string. So for every string we calculate its character(utf8) length
   // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       tokens)) {
-      // Please do not include the input text in the error message as it could
-      // be deemed as a compliance violation by teams using this operator
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars");
+  std::vector<size_t> string_tokens(N * C);
+  ORT_RETURN_IF_ERROR(ParallelForStrings(tp, N * C, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& s = input_data[i];
+      size_t tokens = 0;  // length in utf8 chars
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                         tokens)) {
+        // Please do not include the input text in the error message as it could
+        // be deemed as a compliance violation by teams using this operator
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input string contains invalid utf8 chars");
+      }
+      string_tokens[i] = tokens;
     }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
-  }
+    return Status::OK();
+  }));
+  size_t max_tokens = *std::max_element(string_tokens.cbegin(), string_tokens.cend());
 
   std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
   // Check if we have no output due to apparently empty strings input.
@@ -155,49 +193,48 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
-      size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
-      assert(result);
-      (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
-      token_idx += tlen;
-      ++tokens;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    // Padding strings
-    assert(tokens + (static_cast<size_t>(mark_) * 2) <= max_tokens);
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+  return ParallelForStrings(tp, N * C, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& s = input_data[i];
+      size_t output_index = i * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      size_t tokens = 0;
+      const size_t str_len = s.size();
+      for (size_t token_idx = 0; token_idx < str_len;) {
+        size_t tlen = 0;
+        bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+        assert(result);
+        (void)result;
+        assert(token_idx + tlen <= str_len);
+        (output_data + output_index)->assign(s.data() + token_idx, tlen);
+        ++output_index;
+        token_idx += tlen;
+        ++tokens;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      // Padding strings
+      assert(tokens + (static_cast<size_t>(mark_) * 2) <= max_tokens);
+      const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - tokens;
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
     }
-    ++curr_input;
-  }
-  return Status::OK();
+    return Status::OK();
+  });
 }
 
 Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                                                size_t N, size_t C,
                                                gsl::span<const int64_t> input_dims) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
+  std::vector<std::vector<StringPiece>> rows(N * C);
 
   // We do not constraint the search to match
   // on the beginning or end of the string
@@ -205,132 +242,79 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
 
   // Scan all strings and attempt to find separators in them
   // collect all the output tokens here
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+  ORT_RETURN_IF_ERROR(ParallelForStrings(ctx->GetOperatorThreadPool(), N * C, [&](size_t first, size_t last) {
+    // the tokens of the current separator, reused across the separators and strings of the batch
+    std::vector<StringPiece> tokens;
+    for (size_t i = first; i < last; ++i) {
+      const auto& s = input_data[i];
+      size_t utf8_chars = 0;  // length in utf8 chars
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                         utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input string contains invalid utf8 chars: " + s);
+      }
 
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-          if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + std::string{submatch});
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
+      auto& row = rows[i];
+      row.emplace_back(s);
+
+      for (const auto& sep : separators_) {
+        tokens.clear();
+        for (const auto& text : row) {
+          const auto end_pos = text.length();
+          size_t start_pos = 0;
+          StringPiece submatch;
+
+          bool match = true;
+          do {
+            match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+            if (match) {
+              // Record  pos/len
+              assert(submatch.data() != nullptr);
+              size_t match_pos = submatch.data() - text.data();
+              assert(match_pos >= start_pos);
+              auto token_len = match_pos - start_pos;
+              utf8_chars = 0;
+              bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                    token_len, utf8_chars);
+              if (!valid) {
+                return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                              "Match contains invalid utf8 chars: " + std::string{submatch});
+              }
+              if (utf8_chars >= size_t(mincharnum_)) {
+                tokens.emplace_back(text.data() + start_pos, token_len);
+              }
+              // Update starting position
+              // Guard against empty string match
+              auto match_len = submatch.length();
+              if (match_len > 0) {
+                start_pos = match_pos + match_len;
+              } else {
+                size_t bytes = 0;
+                utf8_bytes(*submatch.data(), bytes);
+                start_pos = match_pos + bytes;
+              }
             } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
+              // record trailing token
+              auto trailing_len = end_pos - start_pos;
+              utf8_chars = 0;
+              utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                       trailing_len, utf8_chars);
+              if (utf8_chars >= size_t(mincharnum_)) {
+                tokens.emplace_back(text.data() + start_pos, trailing_len);
+              }
             }
-          } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
-          }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
-  }
-
-  std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
+          } while (match);
+        }  // row
+        // Replace the row with the results of this tokenezation
+        row.assign(tokens.cbegin(), tokens.cend());
+      }  // separators_
+    }
     return Status::OK();
-  }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->MutableData<std::string>();
+  }));
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
-  return Status::OK();
+  return OutputTokens(ctx, input_dims, rows);
 }
 
 Status Tokenizer::TokenExpression(OpKernelContext* ctx,
@@ -339,68 +323,73 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
   using namespace re2;
   // Represents a token that will be output after
   // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
+  std::vector<std::vector<StringPiece>> tokens(N * C);
 
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
 
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  ORT_RETURN_IF_ERROR(ParallelForStrings(ctx->GetOperatorThreadPool(), N * C, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& s = input_data[i];
 
-    size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+      size_t utf8_chars = 0;
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                         utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input string contains invalid utf8 chars: " + s);
+      }
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + std::string{submatch});
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
+      auto& row = tokens[i];
+
+      StringPiece text(s);
+      const auto end_pos = s.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
+
+      bool match = true;
+      do {
+        match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+        if (match) {
+          // Record  pos/len
+          assert(submatch.data() != nullptr);
+          size_t match_pos = submatch.data() - s.data();
+          assert(match_pos >= start_pos);
+          // Guard against empty match and make
+          // sure we make progress either way
+          auto token_len = submatch.length();
+          utf8_chars = 0;
+          if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + std::string{submatch});
+          }
+          if (utf8_chars >= size_t(mincharnum_)) {
+            row.push_back(submatch);
+            start_pos = match_pos + token_len;
+          } else {
+            size_t bytes = 0;
+            utf8_bytes(*submatch.data(), bytes);
+            start_pos = match_pos + bytes;
+          }
         }
-      }
-    } while (match);
+      } while (match);
+    }
+    return Status::OK();
+  }));
+
+  return OutputTokens(ctx, input_dims, tokens);
+}
+
+Status Tokenizer::OutputTokens(OpKernelContext* ctx, gsl::span<const int64_t> input_dims,
+                               const std::vector<std::vector<re2::StringPiece>>& rows) const {
+  size_t max_tokens = 0;
+  for (const auto& row : rows) {
     max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
   }
 
-  // Check for empty output
   std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
   // Check if we have no output due to either empty input
   // everything is a separator
@@ -421,42 +410,33 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->MutableData<std::string>();
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+  // every row has max_tokens outputs, so the rows are written independently
+  return ParallelForStrings(ctx->GetOperatorThreadPool(), rows.size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& row = rows[i];
+      size_t output_index = i * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      // Output tokens for this row
+      for (const auto& token : row) {
+        (output_data + output_index)->assign(token.data(), token.size());
+        ++output_index;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
+      assert(output_index == (i + 1) * max_tokens);
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
-
-  return Status::OK();
+    return Status::OK();
+  });
 }
 
 Status Tokenizer::Compute(OpKernelContext* ctx) const {
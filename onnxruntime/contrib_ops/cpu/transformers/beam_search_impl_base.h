@@ -6,6 +6,7 @@
 #include <vector>
 #include <utility>
 #include "contrib_ops/cpu/transformers/generate_impl_base.h"
+#include "core/common/generation_tokens_callback.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -234,7 +235,7 @@ Status BeamSearchBase<T>::Initialize() {
   if (!IsCuda()) {
     // Logits processor is used in CPU only. In CUDA, cuda kernels are used instead.
     // Initialize processors after CheckInputs so that parameters_->vocab_mask is ready.
-    logits_processors_.Init(*parameters_);
+    logits_processors_.Init(*parameters_, thread_pool_);
   }
 
   return Status::OK();
@@ -314,6 +315,11 @@ Status BeamSearchBase<T>::GenerateNextToken(
 
     cpu_state.sequences.AppendNextTokenToSequences(beam_indices, beam_next_tokens);
 
+    if (const GenerationTokensCallback* tokens_callback = GenerationTokensCallback::Current()) {
+      tokens_callback->OnTokens(beam_next_tokens.data(), beam_indices.data(), beam_next_tokens.size(),
+                                static_cast<size_t>(cpu_state.sequences.GetSequenceLength()));
+    }
+
 #ifdef DEBUG_GENERATION
     cpu_state.sequences.PrintSequences(&cpu_dumper_);
 #endif
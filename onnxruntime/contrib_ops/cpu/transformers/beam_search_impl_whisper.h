@@ -114,6 +114,10 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
 
   const BeamSearchParameters* parameters = this->parameters_;
 
+  // Only the CPU MultiHeadAttention kernel broadcasts a key/value with fewer batch entries than the query.
+  ORT_RETURN_IF(decoder_subgraph_.share_cross_attention_cache_ && this->IsCuda(),
+                "share_cross_attention_cache is not supported by the CUDA execution provider");
+
   // Allocate output tensors.
   int64_t sequences_dims[] = {parameters->batch_size, parameters->num_return_sequences, parameters->max_length};
   TensorShape sequences_shape(&sequences_dims[0], sizeof(sequences_dims) / sizeof(sequences_dims[0]));
@@ -0,0 +1,307 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/continuous_batching.h"
+#include "contrib_ops/cpu/transformers/sequences.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+ContinuousBatchingGpt::ContinuousBatchingGpt(const ContinuousBatchingOptions& options,
+                                             AllocatorPtr allocator,
+                                             RunDecoderFunc run_decoder)
+    : options_(options), allocator_(std::move(allocator)), run_decoder_(std::move(run_decoder)) {
+  ORT_ENFORCE(options_.max_batch_size > 0 && options_.num_layers > 0 && options_.num_heads > 0 &&
+              options_.head_size > 0 && options_.vocab_size > 0 && options_.prefill_chunk_size >= 0);
+  slots_.resize(options_.max_batch_size);
+  scores_.resize(options_.vocab_size);
+}
+
+void ContinuousBatchingGpt::AddRequest(GenerationRequest request) {
+  ORT_ENFORCE(!request.input_ids.empty(), "Request ", request.request_id, " has no input_ids.");
+  ORT_ENFORCE(request.max_length > static_cast<int>(request.input_ids.size()),
+              "max_length of request ", request.request_id, " shall be larger than its prompt length.");
+  queue_.push_back(std::move(request));
+}
+
+bool ContinuousBatchingGpt::HasPendingWork() const {
+  return !queue_.empty() || ActiveCount() > 0;
+}
+
+int ContinuousBatchingGpt::ActiveCount() const {
+  return static_cast<int>(std::count_if(slots_.begin(), slots_.end(), [](const Slot& slot) { return slot.active; }));
+}
+
+OrtValue ContinuousBatchingGpt::CreateTensor(MLDataType type, const TensorShape& shape) const {
+  OrtValue value;
+  Tensor::InitOrtValue(type, shape, allocator_, value);
+  return value;
+}
+
+bool ContinuousBatchingGpt::ProcessLogits(Slot& slot, gsl::span<const float> logits) {
+  std::copy(logits.begin(), logits.end(), scores_.begin());
+  gsl::span<float> scores = gsl::make_span(scores_.data(), scores_.size());
+
+  SingleSequence sequence(slot.tokens);
+  const int step = static_cast<int>(slot.tokens.size()) - slot.parameters.sequence_length + 1;
+  slot.logits_processors->Process(&sequence, scores, step);
+
+  const int32_t next_token = static_cast<int32_t>(std::max_element(scores_.begin(), scores_.end()) -
+                                                  scores_.begin());
+  slot.tokens.push_back(next_token);
+
+  return next_token == options_.eos_token_id || static_cast<int>(slot.tokens.size()) >= slot.max_length;
+}
+
+void ContinuousBatchingGpt::LookupPrefix(Slot& slot) {
+  slot.prefill_length = 0;
+  slot.past.clear();
+  if (options_.prefix_cache == nullptr) {
+    return;
+  }
+
+  // At least the last prompt token is run to get its logits.
+  const int prefix_length = options_.prefix_cache->LookupPast(slot.tokens, static_cast<int>(slot.tokens.size()) - 1,
+                                                              allocator_, slot.past);
+  if (prefix_length == 0 || slot.past.size() != static_cast<size_t>(options_.num_layers)) {
+    slot.past.clear();
+    return;
+  }
+
+  slot.prefill_length = prefix_length;
+}
+
+Status ContinuousBatchingGpt::Prefill(Slot& slot, int64_t chunk_length) {
+  const int64_t past_length = slot.prefill_length;
+  const int64_t total_length = past_length + chunk_length;
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  std::vector<OrtValue> feeds;
+  feeds.reserve(3 + static_cast<size_t>(options_.num_layers));
+  const TensorShape ids_shape({1, chunk_length});
+  feeds.push_back(CreateTensor(int32_type, ids_shape));
+  feeds.push_back(CreateTensor(int32_type, ids_shape));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({1, total_length})));
+  int32_t* input_ids = feeds[0].GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* position_ids = feeds[1].GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* attention_mask = feeds[2].GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t s = 0; s < chunk_length; s++) {
+    input_ids[s] = slot.tokens[past_length + s];
+    position_ids[s] = static_cast<int32_t>(past_length + s);
+  }
+  std::fill(attention_mask, attention_mask + total_length, 1);
+
+  if (past_length > 0) {
+    for (int layer = 0; layer < options_.num_layers; layer++) {
+      feeds.push_back(slot.past[layer]);
+    }
+  } else {
+    // Empty past state, as in GptSubgraph::CreateInitialFeeds.
+    const TensorShape past_shape({2, 1, options_.num_heads, 0, options_.head_size});
+    for (int layer = 0; layer < options_.num_layers; layer++) {
+      feeds.push_back(CreateTensor(DataTypeImpl::GetType<float>(), past_shape));
+    }
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(run_decoder_(feeds, fetches));
+  ORT_RETURN_IF_NOT(fetches.size() == 1 + static_cast<size_t>(options_.num_layers),
+                    "Decoder shall output logits and one present state per layer.");
+
+  slot.past.assign(fetches.begin() + 1, fetches.end());
+  slot.prefill_length = total_length;
+  if (IsPrefilling(slot)) {
+    return Status::OK();
+  }
+
+  // Decode replaces the past state of a slot rather than writing to it, so the cache can share it.
+  if (options_.prefix_cache != nullptr) {
+    options_.prefix_cache->Insert(slot.tokens, slot.past);
+  }
+
+  const Tensor& logits = fetches[0].Get<Tensor>();
+  const size_t vocab_size = static_cast<size_t>(options_.vocab_size);
+  gsl::span<const float> last_logits = logits.DataAsSpan<float>().subspan(
+      SafeInt<size_t>(chunk_length - 1) * vocab_size, vocab_size);
+  if (ProcessLogits(slot, last_logits)) {
+    slot.active = false;
+  }
+  return Status::OK();
+}
+
+Status ContinuousBatchingGpt::Decode(gsl::span<const int> slot_indices) {
+  const int64_t batch_size = static_cast<int64_t>(slot_indices.size());
+  const int64_t num_heads = options_.num_heads;
+  const int64_t head_size = options_.head_size;
+
+  int64_t max_past_length = 0;
+  for (int index : slot_indices) {
+    max_past_length = std::max(max_past_length, static_cast<int64_t>(slots_[index].tokens.size()) - 1);
+  }
+  const int64_t total_length = max_past_length + 1;
+
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+  std::vector<OrtValue> feeds;
+  feeds.reserve(3 + static_cast<size_t>(options_.num_layers));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({batch_size, 1})));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({batch_size, 1})));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({batch_size, total_length})));
+  int32_t* input_ids = feeds[0].GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* position_ids = feeds[1].GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* attention_mask = feeds[2].GetMutable<Tensor>()->MutableData<int32_t>();
+
+  for (int64_t b = 0; b < batch_size; b++) {
+    const Slot& slot = slots_[slot_indices[b]];
+    const int64_t past_length = static_cast<int64_t>(slot.tokens.size()) - 1;
+    const int64_t padding = max_past_length - past_length;
+    input_ids[b] = slot.tokens.back();
+    position_ids[b] = static_cast<int32_t>(past_length);
+    int32_t* mask = attention_mask + b * total_length;
+    std::fill(mask, mask + padding, 0);
+    std::fill(mask + padding, mask + total_length, 1);
+  }
+
+  // Left pad the past state of every sequence to max_past_length: (2, 1, N, P_b, H) -> (2, B, N, P_max, H)
+  const size_t row_bytes = SafeInt<size_t>(head_size) * sizeof(float);
+  for (int layer = 0; layer < options_.num_layers; layer++) {
+    OrtValue past = CreateTensor(DataTypeImpl::GetType<float>(),
+                                 TensorShape({2, batch_size, num_heads, max_past_length, head_size}));
+    float* past_data = past.GetMutable<Tensor>()->MutableData<float>();
+    for (int64_t kv = 0; kv < 2; kv++) {
+      for (int64_t b = 0; b < batch_size; b++) {
+        const Slot& slot = slots_[slot_indices[b]];
+        const int64_t past_length = static_cast<int64_t>(slot.tokens.size()) - 1;
+        const int64_t padding = max_past_length - past_length;
+        const float* source = slot.past[layer].Get<Tensor>().Data<float>();
+        for (int64_t n = 0; n < num_heads; n++) {
+          float* dest = past_data + ((kv * batch_size + b) * num_heads + n) * max_past_length * head_size;
+          memset(dest, 0, SafeInt<size_t>(padding) * row_bytes);
+          memcpy(dest + padding * head_size,
+                 source + (kv * num_heads + n) * past_length * head_size,
+                 SafeInt<size_t>(past_length) * row_bytes);
+        }
+      }
+    }
+    feeds.push_back(std::move(past));
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(run_decoder_(feeds, fetches));
+  ORT_RETURN_IF_NOT(fetches.size() == 1 + static_cast<size_t>(options_.num_layers),
+                    "Decoder shall output logits and one present state per layer.");
+
+  // Keep the valid tail of the present state of each sequence: (2, B, N, P_max + 1, H) -> (2, 1, N, P_b + 1, H)
+  for (int layer = 0; layer < options_.num_layers; layer++) {
+    const float* present_data = fetches[1 + layer].Get<Tensor>().Data<float>();
+    for (int64_t b = 0; b < batch_size; b++) {
+      Slot& slot = slots_[slot_indices[b]];
+      const int64_t length = static_cast<int64_t>(slot.tokens.size());
+      const int64_t padding = total_length - length;
+      OrtValue present = CreateTensor(DataTypeImpl::GetType<float>(),
+                                      TensorShape({2, 1, num_heads, length, head_size}));
+      float* dest = present.GetMutable<Tensor>()->MutableData<float>();
+      for (int64_t kv = 0; kv < 2; kv++) {
+        for (int64_t n = 0; n < num_heads; n++) {
+          const float* source = present_data +
+                                (((kv * batch_size + b) * num_heads + n) * total_length + padding) * head_size;
+          memcpy(dest + (kv * num_heads + n) * length * head_size, source, SafeInt<size_t>(length) * row_bytes);
+        }
+      }
+      slot.past[layer] = std::move(present);
+    }
+  }
+
+  const Tensor& logits = fetches[0].Get<Tensor>();
+  const size_t vocab_size = static_cast<size_t>(options_.vocab_size);
+  for (int64_t b = 0; b < batch_size; b++) {
+    Slot& slot = slots_[slot_indices[b]];
+    if (ProcessLogits(slot, logits.DataAsSpan<float>().subspan(SafeInt<size_t>(b) * vocab_size, vocab_size))) {
+      slot.active = false;
+    }
+  }
+  return Status::OK();
+}
+
+Status ContinuousBatchingGpt::Step(std::vector<GenerationResult>& finished) {
+  // Sequences that finished their prefill before this iteration get one decode step in it.
+  std::vector<int> decode_slots;
+  for (int i = 0; i < static_cast<int>(slots_.size()); i++) {
+    if (slots_[i].active && !IsPrefilling(slots_[i])) {
+      decode_slots.push_back(i);
+    }
+  }
+
+  for (int i = 0; i < static_cast<int>(slots_.size()) && !queue_.empty(); i++) {
+    Slot& slot = slots_[i];
+    if (slot.active) {
+      continue;
+    }
+
+    GenerationRequest request = std::move(queue_.front());
+    queue_.pop_front();
+
+    slot.active = true;
+    slot.request_id = request.request_id;
+    slot.max_length = request.max_length;
+    slot.tokens = std::move(request.input_ids);
+
+    slot.parameters = GreedySearchParameters{};
+    slot.parameters.model_type = IGenerationParameters::kModelTypeGpt;
+    slot.parameters.batch_size = 1;
+    slot.parameters.num_beams = 1;
+    slot.parameters.sequence_length = static_cast<int>(slot.tokens.size());
+    slot.parameters.max_length = request.max_length;
+    slot.parameters.min_length = request.min_length;
+    slot.parameters.repetition_penalty = request.repetition_penalty;
+    slot.parameters.no_repeat_ngram_size = request.no_repeat_ngram_size;
+    slot.parameters.eos_token_id = options_.eos_token_id;
+    slot.parameters.vocab_size = options_.vocab_size;
+    slot.parameters.temperature = 0.0f;  // greedy decoding does not need temperature scaling
+    slot.logits_processors = std::make_unique<LogitsProcessorList>();
+    slot.logits_processors->Init(slot.parameters);
+
+    LookupPrefix(slot);
+  }
+
+  // Prompts run in slot order until the prefill budget of this iteration is used up.
+  std::vector<int> changed_slots = decode_slots;
+  int64_t prefill_budget = options_.prefill_chunk_size > 0 ? options_.prefill_chunk_size
+                                                           : std::numeric_limits<int64_t>::max();
+  for (int i = 0; i < static_cast<int>(slots_.size()) && prefill_budget > 0; i++) {
+    Slot& slot = slots_[i];
+    if (!slot.active || !IsPrefilling(slot)) {
+      continue;
+    }
+
+    const int64_t chunk_length = std::min(prefill_budget, slot.parameters.sequence_length - slot.prefill_length);
+    ORT_RETURN_IF_ERROR(Prefill(slot, chunk_length));
+    prefill_budget -= chunk_length;
+    changed_slots.push_back(i);
+  }
+
+  if (!decode_slots.empty()) {
+    ORT_RETURN_IF_ERROR(Decode(decode_slots));
+  }
+
+  for (int i : changed_slots) {
+    Slot& slot = slots_[i];
+    if (!slot.active) {
+      finished.push_back(GenerationResult{slot.request_id, std::move(slot.tokens)});
+      slot.tokens.clear();
+      slot.past.clear();
+      slot.logits_processors.reset();
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
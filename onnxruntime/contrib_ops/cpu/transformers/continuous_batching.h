@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "contrib_ops/cpu/transformers/generation_shared.h"
+#include "contrib_ops/cpu/transformers/greedy_search_parameters.h"
+#include "contrib_ops/cpu/transformers/logits_processor.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// A generation request with its own length limits and logits processing settings.
+struct GenerationRequest {
+  int64_t request_id = 0;
+  std::vector<int32_t> input_ids;  // prompt tokens
+  int max_length = 0;              // maximum length of prompt and generated tokens
+  int min_length = 0;
+  float repetition_penalty = 1.0f;
+  int no_repeat_ngram_size = 0;
+};
+
+struct GenerationResult {
+  int64_t request_id = 0;
+  std::vector<int32_t> sequence;  // prompt followed by generated tokens
+};
+
+struct ContinuousBatchingOptions {
+  int max_batch_size = 1;  // maximum number of sequences decoded together
+  int num_layers = 0;
+  int num_heads = 0;
+  int head_size = 0;
+  int vocab_size = 0;
+  int eos_token_id = -1;
+
+  // Optional cache of prompt state, owned by the caller and possibly shared with other schedulers. When set, prefill
+  // only runs the prompt tokens after the longest cached prefix, and stores the state of every prompt it runs.
+  PrefixKVCache* prefix_cache = nullptr;
+
+  // Maximum number of prompt tokens run per Step(), to bound the latency that prefill adds to the decode step of the
+  // other sequences. Longer prompts are run in chunks over several steps. 0 runs every admitted prompt at once.
+  int prefill_chunk_size = 0;
+};
+
+// Runs the GPT decoder subgraph once. Feeds and fetches follow the GptSubgraph layout:
+//   feeds:   input_ids (B, S), position_ids (B, S), attention_mask (B, P + S), past_0 ... past_{L-1}
+//   fetches: logits (B, S, vocab_size), present_0 ... present_{L-1}
+// where past_i has shape (2, B, num_heads, P, head_size) and present_i has shape (2, B, num_heads, P + S, head_size).
+using RunDecoderFunc = std::function<Status(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches)>;
+
+// Iteration-level scheduler for greedy decoding of a GPT subgraph.
+//
+// Unlike GreedySearch, which runs one batch until every sequence finishes, requests join and leave between decode
+// steps. Each Step() call:
+//   1. admits queued requests into free slots,
+//   2. runs the prompts of the admitted sequences (prefill) up to prefill_chunk_size tokens; a sequence gets its first
+//      token once its whole prompt has run,
+//   3. runs one decode step for all other active sequences as one batch,
+//   4. retires sequences that produced eos_token_id or reached their max_length.
+//
+// A prompt run in chunks attends to the state of its earlier chunks as past state, like a decode step with several
+// tokens, so chunking does not change the generated tokens.
+//
+// Sequences in a decode batch have different past lengths. Batched past state is left padded to the longest past,
+// with attention_mask set to 0 on the padding and position_ids counting real tokens only, which is the padding
+// convention of the GPT subgraph inputs.
+//
+// This is a library-only building block: it is not registered as an operator and no session API creates it, since
+// an ONNX operator call cannot admit requests that arrive after the call started. A serving layer that owns the
+// request queue drives it, passing a RunDecoderFunc that appends the implicit inputs of a GptSubgraph session state
+// to the feeds and calls utils::ExecuteSubgraph, as GreedySearchGpt does for its decoder.
+// GreedySearch and Sampling nodes reuse prompt prefixes and run prompts in chunks themselves, with the
+// kOrtSessionOptionsGenerationPrefixCacheBytes and kOrtSessionOptionsGenerationPrefillChunkSize session options.
+class ContinuousBatchingGpt {
+ public:
+  ContinuousBatchingGpt(const ContinuousBatchingOptions& options,
+                        AllocatorPtr allocator,
+                        RunDecoderFunc run_decoder);
+
+  void AddRequest(GenerationRequest request);
+
+  // Returns true while there are queued or active requests.
+  bool HasPendingWork() const;
+
+  int ActiveCount() const;
+
+  // Runs one scheduling iteration. Results of the requests that finished in this iteration are appended to finished.
+  Status Step(std::vector<GenerationResult>& finished);
+
+ private:
+  struct Slot {
+    bool active = false;
+    int64_t request_id = 0;
+    int max_length = 0;
+    std::vector<int32_t> tokens;
+    int64_t prefill_length = 0;  // prompt tokens that have run; less than the prompt length while prefilling
+    std::vector<OrtValue> past;  // per layer, shape (2, 1, num_heads, past length, head_size), where the past
+                                 // length is prefill_length while prefilling and tokens.size() - 1 after
+    GreedySearchParameters parameters;
+    std::unique_ptr<LogitsProcessorList> logits_processors;
+  };
+
+  bool IsPrefilling(const Slot& slot) const {
+    return slot.prefill_length < slot.parameters.sequence_length;
+  }
+
+  // Starts the past state of an admitted slot from the longest prefix of its prompt in the prefix cache.
+  void LookupPrefix(Slot& slot);
+
+  // Runs the next chunk_length prompt tokens of a prefilling slot.
+  Status Prefill(Slot& slot, int64_t chunk_length);
+
+  Status Decode(gsl::span<const int> slot_indices);
+
+  // Applies logits processors of the slot, appends the arg max token and returns whether the slot is finished.
+  bool ProcessLogits(Slot& slot, gsl::span<const float> logits);
+
+  OrtValue CreateTensor(MLDataType type, const TensorShape& shape) const;
+
+  ContinuousBatchingOptions options_;
+  AllocatorPtr allocator_;
+  RunDecoderFunc run_decoder_;
+
+  std::deque<GenerationRequest> queue_;
+  std::vector<Slot> slots_;
+  std::vector<float> scores_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
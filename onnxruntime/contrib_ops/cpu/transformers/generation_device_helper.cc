@@ -4,11 +4,13 @@
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include "core/providers/cpu/math/top_k.h"
 #include "core/providers/cpu/math/softmax_shared.h"
 #include "core/providers/cpu/generator/random.h"
 #include "core/common/safeint.h"
 #include "core/common/gsl.h"
+#include "core/platform/threadpool.h"
 #include "contrib_ops/cpu/transformers/sequences.h"
 #include "contrib_ops/cpu/transformers/beam_search_scorer.h"
 #include "contrib_ops/cpu/transformers/generation_device_helper.h"
@@ -359,16 +361,17 @@ Status ProcessLogits(const OrtValue& logits,                                 //
 
   // Add beam score to next token scores. Corresponding python code is like:
   //    next_token_scores = next_token_scores + beam_scores[:, None].expand_as(next_token_scores)
-  // TODO(tianleiwu): use thread pool to parallel
-  int offset = 0;
-  int batch_beam_index = 0;
-  for (int i = 0; i < batch_size; i++) {
-    for (int j = 0; j < num_beams; j++, batch_beam_index++) {
-      for (int k = 0; k < vocab_size; k++, offset++) {
-        next_token_scores[offset] += beam_state->beam_scores[batch_beam_index];
-      }
-    }
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, batch_beam_size, static_cast<double>(vocab_size),
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const T beam_score = beam_state->beam_scores[i];
+          T* row = next_token_scores.data() + SafeInt<size_t>(i) * vocab_size;
+          for (int k = 0; k < vocab_size; k++) {
+            row[k] += beam_score;
+          }
+        }
+      });
 
 #ifdef DEBUG_GENERATION
   dumper->Print("next_token_scores adding beam_scores", next_token_scores.data(), batch_size, num_beams, vocab_size);
@@ -549,6 +552,52 @@ Status GreedySearchProcessLogits(
   return Status::OK();
 }
 
+Status SpeculativeProcessLogits(gsl::span<float> scores,
+                                transformers::ISequences* sequences,
+                                onnxruntime::concurrency::ThreadPool* thread_pool,
+                                transformers::ILogitsProcessorList* logits_processors,
+                                const transformers::IGenerationParameters* parameters,
+                                bool do_sampling,
+                                int step) {
+  ORT_RETURN_IF(parameters->batch_size != 1, "Speculative decoding supports batch_size of 1 only.");
+  const size_t vocab_size = static_cast<size_t>(parameters->vocab_size);
+  ORT_RETURN_IF(scores.size() != vocab_size, "Expect scores of ", vocab_size, " tokens, got ", scores.size());
+
+  logits_processors->Process(sequences, scores, step);
+
+  if (do_sampling) {
+    // Filter the scores like SamplingCpuHelper::Sample does before it samples from their softmax.
+    std::vector<size_t> sorted_indices(vocab_size);
+    std::iota(sorted_indices.begin(), sorted_indices.end(), 0);
+    if (parameters->custom_sampling) {
+      std::sort(sorted_indices.begin(), sorted_indices.end(),
+                [&scores](size_t i1, size_t i2) { return scores[i1] > scores[i2]; });
+    } else {
+      std::sort(sorted_indices.begin(), sorted_indices.end(),
+                [&scores](size_t i1, size_t i2) { return scores[i1] < scores[i2]; });
+    }
+
+    std::vector<float> sorted_scores(vocab_size);
+    for (size_t i = 0; i < vocab_size; i++) {
+      sorted_scores[i] = scores[sorted_indices[i]];
+    }
+
+    std::vector<float> cumulative_probs(vocab_size);
+    ORT_RETURN_IF_ERROR(SoftmaxCPU<float>(1, vocab_size, sorted_scores.data(), cumulative_probs.data(), false,
+                                          thread_pool));
+
+    gsl::span<float> cumulative_probs_span(cumulative_probs);
+    if (parameters->custom_sampling) {
+      SamplingCpuHelper::cumulate_and_filter_custom(scores, cumulative_probs_span, parameters, sorted_indices);
+    } else {
+      SamplingCpuHelper::cumulate_and_filter(scores, cumulative_probs_span, parameters, sorted_indices);
+    }
+  }
+
+  std::vector<float> processed_scores(scores.begin(), scores.end());
+  return SoftmaxCPU<float>(1, vocab_size, processed_scores.data(), scores.data(), false, thread_pool);
+}
+
 template <typename T>
 Status DeviceCopy(gsl::span<T> target, gsl::span<const T> source, Stream* /*stream*/, int /*copyDirection*/) {
   gsl::copy(source, target);
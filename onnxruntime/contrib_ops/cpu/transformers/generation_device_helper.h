@@ -123,6 +123,17 @@ using GreedySearchProcessLogitsFunc = std::function<Status(
     Stream* ort_stream,                                     // cuda stream (for CUDA only)
     const transformers::IConsoleDumper* dumper)>;           // tensor dumper
 
+// Turns the logits of the next token of one sequence into its probabilities for speculative decoding: logits
+// processors, then top-p filtering when sampling, then softmax (batch size of 1 only).
+using SpeculativeProcessLogitsFunc = std::function<Status(
+    gsl::span<float> scores,                                // logits as input, probabilities as output
+    transformers::ISequences* sequences,                    // tokens before the next token
+    onnxruntime::concurrency::ThreadPool* thread_pool,      // thread pool (for CPU only)
+    transformers::ILogitsProcessorList* logits_processors,  // logits processors
+    const transformers::IGenerationParameters* parameters,  // parameters
+    bool do_sampling,                                       // whether to do sampling
+    int step)>;                                             // iteration counter
+
 template <typename T>
 using DeviceCopyFunc = std::function<Status(
     gsl::span<T> target,
@@ -293,6 +304,14 @@ Status GreedySearchProcessLogits(const OrtValue& logits,
                                  Stream* stream,                                         // cuda stream (for CUDA only)
                                  const transformers::IConsoleDumper* dumper);            // tensor dumper
 
+Status SpeculativeProcessLogits(gsl::span<float> scores,                                // logits as input, probabilities as output
+                                transformers::ISequences* sequences,                    // tokens before the next token
+                                onnxruntime::concurrency::ThreadPool* thread_pool,      // thread pool (for CPU only)
+                                transformers::ILogitsProcessorList* logits_processors,  // logits processors
+                                const transformers::IGenerationParameters* parameters,  // parameters
+                                bool do_sampling,                                       // whether to do sampling
+                                int step);                                              // iteration counter
+
 template <typename T>
 Status DeviceCopy(gsl::span<T> target,
                   gsl::span<const T> source,
@@ -19,6 +19,8 @@ class FeedsFetchesManager;
 namespace contrib {
 namespace transformers {
 
+class PrefixKVCache;
+
 using namespace onnxruntime::controlflow;  // namespace of IControlFlowKernel
 
 class GreedySearch : public IControlFlowKernel {
@@ -124,11 +126,27 @@ class GreedySearch : public IControlFlowKernel {
   FeedsFetchesManager* decoder_feeds_fetches_manager_;
   FeedsFetchesManager* init_run_decoder_feeds_fetches_manager_;
 
+  // Relevant only for GPT2
+  // The draft_gpt_subgraph_ (if the `draft_decoder` attribute is present) proposes num_speculative_tokens_ tokens
+  // that gpt_subgraph_ verifies in one run.
+  std::unique_ptr<GptSubgraph> draft_gpt_subgraph_;
+  FeedsFetchesManager* draft_decoder_feeds_fetches_manager_ = nullptr;
+  int num_speculative_tokens_ = 4;
+
+  // Cache of prompt state shared by the runs of this node, set by the kOrtSessionOptionsGenerationPrefixCacheBytes
+  // session option.
+  std::shared_ptr<PrefixKVCache> prefix_cache_;
+
+  // Set by the kOrtSessionOptionsGenerationPrefillChunkSize session option.
+  int prefill_chunk_size_ = 0;
+
   IConsoleDumper* dumper_;
 
   GreedySearchParameters parameters_;
 
   bool has_init_decoder_ = false;
+
+  bool has_draft_decoder_ = false;
 };
 
 }  // namespace transformers
@@ -6,6 +6,7 @@
 #include <vector>
 #include "contrib_ops/cpu/transformers/generation_shared.h"
 #include "contrib_ops/cpu/transformers/generate_impl_base.h"
+#include "core/common/generation_tokens_callback.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -237,7 +238,7 @@ Status GreedySearchBase<T, ParametersT>::Initialize() {
   if (!this->IsCuda()) {
     // Logits processor is used in CPU only. In CUDA, cuda kernels are used instead.
     // Initialize processors after CheckInputs so that parameters_->vocab_mask is ready.
-    this->logits_processors_.Init(*parameters_);
+    this->logits_processors_.Init(*parameters_, this->thread_pool_);
   }
 
   return Status::OK();
@@ -278,6 +279,12 @@ Status GreedySearchBase<T, ParametersT>::GenerateNextToken(
 
   greedy_state.sequences.AppendNextTokenToSequences(next_tokens);
 
+  // next_tokens is on the host for all devices, as the search checks them for the end of the sequences
+  if (const GenerationTokensCallback* tokens_callback = GenerationTokensCallback::Current()) {
+    tokens_callback->OnTokens(next_tokens.data(), nullptr, next_tokens.size(),
+                              static_cast<size_t>(greedy_state.sequences.GetSequenceLength()));
+  }
+
 #ifdef DEBUG_GENERATION
   greedy_state.sequences.PrintSequences(&cpu_dumper_);
 #endif
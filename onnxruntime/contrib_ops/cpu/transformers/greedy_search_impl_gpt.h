@@ -7,6 +7,9 @@
 
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+#include "contrib_ops/cpu/transformers/sequences.h"
+#include "contrib_ops/cpu/transformers/speculative_decoding.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -79,12 +82,52 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Use speculative decoding with a draft decoder subgraph that proposes num_speculative_tokens tokens per run of
+  // the decoder subgraph. Supported on CPU for float logits and batch size of 1 only.
+  void SetDraftDecoder(const SessionState* draft_decoder_session_state,
+                       GptSubgraph* draft_gpt_subgraph,
+                       const FeedsFetchesManager* draft_feeds_fetches_manager,
+                       int num_speculative_tokens,
+                       const GenerationDeviceHelper::SpeculativeProcessLogitsFunc& speculative_process_logits_func) {
+    draft_decoder_session_state_ = draft_decoder_session_state;
+    draft_gpt_subgraph_ = draft_gpt_subgraph;
+    draft_feeds_fetches_manager_ = draft_feeds_fetches_manager;
+    num_speculative_tokens_ = num_speculative_tokens;
+    speculative_process_logits_func_ = speculative_process_logits_func;
+  }
+
+  // Start the first run of the decoder subgraph from the longest prefix of the prompt in prefix_cache, and store the
+  // state of the prompt in it. Used on CPU for one unpadded float sequence without init_decoder and
+  // past_present_share_buffer; nullptr disables it.
+  void SetPrefixCache(PrefixKVCache* prefix_cache) {
+    prefix_cache_ = prefix_cache;
+  }
+
+  // Run the prompt in the first run of the decoder subgraph at most prefill_chunk_size tokens at a time, under the same
+  // conditions as the prefix cache. Each chunk attends to the earlier chunks as past state; 0 runs the whole prompt.
+  void SetPrefillChunkSize(int prefill_chunk_size) {
+    prefill_chunk_size_ = prefill_chunk_size;
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                  const FeedsFetchesManager& feeds_fetches_manager);
 
  private:
+  // Generates the sequence with the draft decoder proposing tokens and the decoder verifying them.
+  Status ExecuteSpeculative(const FeedsFetchesManager& feeds_fetches_manager);
+
+  // Returns whether the first run of the decoder subgraph goes through Prefill for the initial feeds.
+  bool UsePrefill(const std::vector<OrtValue>& feeds) const;
+
+  // First run of the decoder subgraph, which only runs the prompt tokens after the longest prefix in prefix_cache_,
+  // in chunks of prefill_chunk_size_ tokens. fetches are those of running the whole prompt, except that logits only
+  // cover the tokens of the last chunk.
+  Status Prefill(const FeedsFetchesManager& feeds_fetches_manager,
+                 const std::vector<OrtValue>& feeds,
+                 std::vector<OrtValue>& fetches);
+
   // Prepare the inputs for first inference of subgraph
   Status CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                             OrtValue& expanded_input_ids,
@@ -116,6 +159,15 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
 
   const void* cuda_device_prop_ = nullptr;
   int cuda_device_arch_ = 0;
+
+  const SessionState* draft_decoder_session_state_ = nullptr;
+  GptSubgraph* draft_gpt_subgraph_ = nullptr;
+  const FeedsFetchesManager* draft_feeds_fetches_manager_ = nullptr;
+  int num_speculative_tokens_ = 0;
+  GenerationDeviceHelper::SpeculativeProcessLogitsFunc speculative_process_logits_func_;
+
+  PrefixKVCache* prefix_cache_ = nullptr;
+  int prefill_chunk_size_ = 0;
 };
 
 template <typename T, typename ParametersT>
@@ -187,9 +239,123 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+template <typename T, typename ParametersT>
+bool GreedySearchGpt<T, ParametersT>::UsePrefill(const std::vector<OrtValue>& feeds) const {
+  if ((prefix_cache_ == nullptr && prefill_chunk_size_ <= 0) || this->IsCuda() || !std::is_same<T, float>::value ||
+      this->parameters_->BatchBeamSize() != 1 || init_run_gpt_subgraph_ != nullptr ||
+      gpt_subgraph_.past_present_share_buffer_) {
+    return false;
+  }
+
+  // Position ids of a padded prompt do not start from 0.
+  gsl::span<const int32_t> attention_mask = feeds[2].Get<Tensor>().DataAsSpan<int32_t>();
+  return std::all_of(attention_mask.begin(), attention_mask.end(), [](int32_t mask) { return mask == 1; });
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::Prefill(const FeedsFetchesManager& feeds_fetches_manager,
+                                                const std::vector<OrtValue>& feeds,
+                                                std::vector<OrtValue>& fetches) {
+  const int first_past_input_index = gpt_subgraph_.GetFirstPastInputIndex();
+  const int first_present_output_index = gpt_subgraph_.GetFirstPresentOutputIndex();
+  gsl::span<const int32_t> prompt = feeds[0].Get<Tensor>().DataAsSpan<int32_t>();
+  const int64_t sequence_length = static_cast<int64_t>(prompt.size());
+
+  // At least the last prompt token is run to get its logits.
+  std::vector<OrtValue> past;
+  int64_t past_length = 0;
+  if (prefix_cache_ != nullptr) {
+    past_length = prefix_cache_->LookupPast(prompt, static_cast<int>(sequence_length) - 1, this->cpu_allocator_, past);
+    if (past.size() != static_cast<size_t>(gpt_subgraph_.num_layers)) {
+      past_length = 0;
+    }
+  }
+
+  const int64_t chunk_size = prefill_chunk_size_ > 0 ? static_cast<int64_t>(prefill_chunk_size_) : sequence_length;
+  if (past_length == 0 && chunk_size >= sequence_length) {
+    // The whole prompt runs at once, as in the normal first run.
+#ifdef DEBUG_NODE_INPUTS_OUTPUTS
+    const_cast<SessionState&>(this->decoder_session_state_).IncrementGraphExecutionCounter();
+#endif
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(this->decoder_session_state_,
+                                               feeds_fetches_manager,
+                                               feeds,
+                                               fetches,
+                                               {},
+                                               ExecutionMode::ORT_SEQUENTIAL,
+                                               this->context_.GetTerminateFlag(),
+                                               this->context_.Logger(),
+                                               this->ort_stream_));
+  } else {
+    // Implicit inputs after the past state are fed unchanged to every chunk.
+    std::vector<OrtValue> prefill_feeds = feeds;
+    std::vector<OrtValue> chunk_fetches;
+    auto int32_type = DataTypeImpl::GetType<int32_t>();
+    while (past_length < sequence_length) {
+      const int64_t run_length = std::min(chunk_size, sequence_length - past_length);
+      const bool is_last_chunk = past_length + run_length == sequence_length;
+
+      Tensor::InitOrtValue(int32_type, TensorShape({1, run_length}), this->cpu_allocator_, prefill_feeds[0]);
+      Tensor::InitOrtValue(int32_type, TensorShape({1, run_length}), this->cpu_allocator_, prefill_feeds[1]);
+      int32_t* input_ids = prefill_feeds[0].GetMutable<Tensor>()->MutableData<int32_t>();
+      int32_t* position_ids = prefill_feeds[1].GetMutable<Tensor>()->MutableData<int32_t>();
+      for (int64_t s = 0; s < run_length; s++) {
+        input_ids[s] = prompt[past_length + s];
+        position_ids[s] = static_cast<int32_t>(past_length + s);
+      }
+
+      // The attention mask of the whole prompt is all ones, so the mask of a chunk is all ones as well. The last chunk
+      // keeps the mask of the whole prompt in feeds.
+      if (is_last_chunk) {
+        prefill_feeds[2] = feeds[2];
+      } else {
+        Tensor::InitOrtValue(int32_type, TensorShape({1, past_length + run_length}), this->cpu_allocator_,
+                             prefill_feeds[2]);
+        int32_t* attention_mask = prefill_feeds[2].GetMutable<Tensor>()->MutableData<int32_t>();
+        std::fill_n(attention_mask, SafeInt<size_t>(past_length + run_length), 1);
+      }
+
+      if (!past.empty()) {
+        for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
+          prefill_feeds[first_past_input_index + layer] = past[layer];
+        }
+      }
+
+      std::vector<OrtValue>& run_fetches = is_last_chunk ? fetches : chunk_fetches;
+      run_fetches.clear();
+#ifdef DEBUG_NODE_INPUTS_OUTPUTS
+      const_cast<SessionState&>(this->decoder_session_state_).IncrementGraphExecutionCounter();
+#endif
+      ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(this->decoder_session_state_,
+                                                 feeds_fetches_manager,
+                                                 prefill_feeds,
+                                                 run_fetches,
+                                                 {},
+                                                 ExecutionMode::ORT_SEQUENTIAL,
+                                                 this->context_.GetTerminateFlag(),
+                                                 this->context_.Logger(),
+                                                 this->ort_stream_));
+
+      past.assign(run_fetches.begin() + first_present_output_index, run_fetches.end());
+      past_length += run_length;
+    }
+  }
+
+  if (prefix_cache_ != nullptr) {
+    // The search replaces its past state rather than writing to it, so the cache can share the present state.
+    std::vector<OrtValue> present(fetches.begin() + first_present_output_index, fetches.end());
+    prefix_cache_->Insert(prompt, present);
+  }
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
+  if (draft_gpt_subgraph_ != nullptr) {
+    return ExecuteSpeculative(feeds_fetches_manager);
+  }
+
   auto status = Status::OK();
   const ParametersT* parameters = this->parameters_;
 
@@ -268,6 +434,8 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  const bool use_prefill = UsePrefill(feeds);
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -295,6 +463,8 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                                       this->context_.GetTerminateFlag(),
                                       this->context_.Logger(),
                                       this->ort_stream_);
+    } else if (iteration_counter == 1 && use_prefill) {
+      status = Prefill(feeds_fetches_manager, feeds, fetches);
     } else {
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       const_cast<SessionState&>(this->decoder_session_state_).IncrementGraphExecutionCounter();
@@ -410,6 +580,98 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
   return status;
 }
 
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ExecuteSpeculative(const FeedsFetchesManager& feeds_fetches_manager) {
+  ParametersT* parameters = this->parameters_;
+  ORT_RETURN_IF(this->IsCuda(), "draft_decoder is only supported by the CPU execution provider.");
+  ORT_RETURN_IF(parameters->batch_size != 1,
+                "draft_decoder supports batch_size of 1 only, got batch_size ", parameters->batch_size);
+  ORT_RETURN_IF(init_run_gpt_subgraph_ != nullptr,
+                "draft_decoder cannot be used with init_decoder, since decoder scores several tokens per run.");
+  ORT_RETURN_IF(gpt_subgraph_.past_present_share_buffer_ || draft_gpt_subgraph_->past_present_share_buffer_,
+                "draft_decoder does not support decoder subgraphs with past_present_share_buffer.");
+  ORT_RETURN_IF(gpt_subgraph_.IsOutputFloat16() || draft_gpt_subgraph_->IsOutputFloat16(),
+                "draft_decoder supports decoder subgraphs with float logits only.");
+  ORT_RETURN_IF(draft_gpt_subgraph_->vocab_size != gpt_subgraph_.vocab_size,
+                "draft_decoder shall have the vocabulary size of decoder, got ", draft_gpt_subgraph_->vocab_size,
+                " and ", gpt_subgraph_.vocab_size);
+
+  const OrtValue* attn_mask_value = this->context_.GetInputOrtValue(6);
+  if (attn_mask_value != nullptr) {
+    gsl::span<const int32_t> attention_mask = attn_mask_value->Get<Tensor>().DataAsSpan<int32_t>();
+    ORT_RETURN_IF(std::find(attention_mask.begin(), attention_mask.end(), 0) != attention_mask.end(),
+                  "draft_decoder does not support padding in attention_mask.");
+  }
+
+  // Both decoders run on the feeds built by SpeculativeDecoding followed by the implicit inputs of the node.
+  auto make_run_decoder = [this](const SessionState& session_state, const FeedsFetchesManager& ffm) {
+    return [this, &session_state, &ffm](const std::vector<OrtValue>& decoder_feeds, std::vector<OrtValue>& fetches) {
+      std::vector<OrtValue> feeds;
+      feeds.reserve(decoder_feeds.size() + this->implicit_inputs_.size());
+      feeds.insert(feeds.end(), decoder_feeds.begin(), decoder_feeds.end());
+      for (const auto* entry : this->implicit_inputs_) {
+        feeds.push_back(*entry);
+      }
+      return utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, {}, ExecutionMode::ORT_SEQUENTIAL,
+                                    this->context_.GetTerminateFlag(), this->context_.Logger(), this->ort_stream_);
+    };
+  };
+
+  const bool use_sampling = std::is_same<ParametersT, SamplingParameters>::value;
+  auto process_scores = [this, parameters, use_sampling](gsl::span<const int32_t> context, int step,
+                                                          gsl::span<float> scores) {
+    SingleSequence sequence(context);
+    return speculative_process_logits_func_(scores, &sequence, this->thread_pool_, &this->logits_processors_,
+                                            parameters, use_sampling, step);
+  };
+
+  SpeculativeDecodingOptions options;
+  options.decoder = DecoderConfig{gpt_subgraph_.num_layers, gpt_subgraph_.num_heads, gpt_subgraph_.head_size};
+  options.draft_decoder = DecoderConfig{draft_gpt_subgraph_->num_layers,
+                                        draft_gpt_subgraph_->num_heads,
+                                        draft_gpt_subgraph_->head_size};
+  options.num_speculative_tokens = num_speculative_tokens_;
+  options.vocab_size = parameters->vocab_size;
+  options.eos_token_id = parameters->eos_token_id;
+  options.do_sample = use_sampling;
+  options.seed = parameters->seed;
+
+  SpeculativeDecoding speculative(options,
+                                  this->cpu_allocator_,
+                                  make_run_decoder(this->decoder_session_state_, feeds_fetches_manager),
+                                  make_run_decoder(*draft_decoder_session_state_, *draft_feeds_fetches_manager_),
+                                  process_scores);
+
+  // Accepted tokens are streamed like the tokens of the search loop, with eos_token_id replaced by pad_token_id.
+  SpeculativeTokenFunc on_token;
+  if (const GenerationTokensCallback* tokens_callback = GenerationTokensCallback::Current()) {
+    on_token = [tokens_callback, parameters](int32_t token, int sequence_length) {
+      const int32_t next_token = (token == parameters->eos_token_id) ? parameters->pad_token_id : token;
+      tokens_callback->OnTokens(&next_token, nullptr, 1, static_cast<size_t>(sequence_length));
+    };
+  }
+
+  const OrtValue* input_ids_value = this->context_.GetInputOrtValue(0);
+  const Tensor& input_ids = input_ids_value->Get<Tensor>();
+  std::vector<int32_t> sequence;
+  ORT_RETURN_IF_ERROR(speculative.Generate(input_ids.DataAsSpan<int32_t>(), parameters->max_length, sequence,
+                                           on_token));
+
+  // Like the search loop, the output has eos_token_id replaced by pad_token_id and is padded to max_length.
+  int64_t sequences_dims[] = {parameters->batch_size, parameters->max_length};
+  TensorShape sequences_shape(&sequences_dims[0], sizeof(sequences_dims) / sizeof(sequences_dims[0]));
+  Tensor* output_sequences = this->context_.Output(0, sequences_shape);
+  gsl::span<int32_t> output = output_sequences->MutableDataAsSpan<int32_t>();
+  std::fill(output.begin(), output.end(), parameters->pad_token_id);
+  for (size_t i = 0; i < sequence.size(); i++) {
+    const bool is_generated_eos = static_cast<int>(i) >= parameters->sequence_length &&
+                                  sequence[i] == parameters->eos_token_id;
+    output[i] = is_generated_eos ? parameters->pad_token_id : sequence[i];
+  }
+
+  return Status::OK();
+}
+
 }  // namespace transformers
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -23,10 +23,11 @@ MinLengthLogitsProcessor<T>::MinLengthLogitsProcessor(int min_length, int eos_to
     : min_length_(min_length), eos_token_id_(eos_token_id) {}
 
 template <typename T>
-void MinLengthLogitsProcessor<T>::Process(const ISequences* sequences,
-                                          NextTokenScores<T>& next_token_scores) {
+void MinLengthLogitsProcessor<T>::ProcessRow(const ISequences* sequences,
+                                             int /*batch_beam_index*/,
+                                             gsl::span<T> beam_token_scores) {
   if (sequences->GetSequenceLength() < min_length_) {
-    next_token_scores.SetScore(eos_token_id_, std::numeric_limits<T>::lowest());
+    beam_token_scores[eos_token_id_] = std::numeric_limits<T>::lowest();
   }
 }
 
@@ -35,26 +36,22 @@ RepetitionPenaltyLogitsProcessor<T>::RepetitionPenaltyLogitsProcessor(float pena
 }
 
 template <typename T>
-void RepetitionPenaltyLogitsProcessor<T>::Process(const ISequences* sequences,
-                                                  NextTokenScores<T>& next_token_scores) {
-  const int batch_beam_size = next_token_scores.batch_beam_size;
-  for (int i = 0; i < batch_beam_size; i++) {
-    gsl::span<T> beam_token_scores = next_token_scores.GetScores(i);
-    gsl::span<const int32_t> sequence = sequences->GetSequence(i);
-
-    // Find unique word IDs in sequence.
-    std::unordered_set<int32_t> unique_word_ids;
-    for (const auto& word_id : sequence) {
-      unique_word_ids.insert(word_id);
-    }
-
-    for (const int32_t word_id : unique_word_ids) {
-      T score = beam_token_scores[word_id];
-
-      // If score < 0, then repetition penalty > 1.0 has to multiplied to reduce the previous token probability,
-      // This assumes that scores are either positive (like ctrl) or negative (like GPT-2), but not a mixture.
-      beam_token_scores[word_id] = (score < 0 ? score * penalty_ : score / penalty_);
-    }
+void RepetitionPenaltyLogitsProcessor<T>::ProcessRow(const ISequences* sequences,
+                                                     int batch_beam_index,
+                                                     gsl::span<T> beam_token_scores) {
+  gsl::span<const int32_t> sequence = sequences->GetSequence(batch_beam_index);
+
+  // Find unique word IDs in sequence. Only the scores of these words are updated.
+  InlinedVector<int32_t> unique_word_ids(sequence.begin(), sequence.end());
+  std::sort(unique_word_ids.begin(), unique_word_ids.end());
+  unique_word_ids.erase(std::unique(unique_word_ids.begin(), unique_word_ids.end()), unique_word_ids.end());
+
+  for (const int32_t word_id : unique_word_ids) {
+    T score = beam_token_scores[word_id];
+
+    // If score < 0, then repetition penalty > 1.0 has to multiplied to reduce the previous token probability,
+    // This assumes that scores are either positive (like ctrl) or negative (like GPT-2), but not a mixture.
+    beam_token_scores[word_id] = (score < 0 ? score * penalty_ : score / penalty_);
   }
 }
 
@@ -63,35 +60,41 @@ NoRepeatNGramLogitsProcessor<T>::NoRepeatNGramLogitsProcessor(int ngram_size) :
 }
 
 template <typename T>
-void NoRepeatNGramLogitsProcessor<T>::Process(const ISequences* sequences,
-                                              NextTokenScores<T>& next_token_scores) {
+void NoRepeatNGramLogitsProcessor<T>::ProcessRow(const ISequences* sequences,
+                                                 int batch_beam_index,
+                                                 gsl::span<T> beam_token_scores) {
   if (ngram_size_ == 0 || ngram_size_ > sequences->GetSequenceLength()) {
     return;
   }
 
   const gsl::index prefix_length = static_cast<gsl::index>(ngram_size_) - 1;
-  int batch_beam_size = next_token_scores.batch_beam_size;
-
-  for (int i = 0; i < batch_beam_size; i++) {
-    gsl::span<T> beam_token_scores = next_token_scores.GetScores(i);
-    gsl::span<const int32_t> sequence = sequences->GetSequence(i);
-
-    gsl::span<const int32_t> prefix = sequence.subspan(sequence.size() - prefix_length);
-    ORT_ENFORCE(prefix.size() == narrow<size_t>(prefix_length));
-
-    std::unordered_set<int32_t> blocked_word_ids;
-    for (int j = 0; j <= static_cast<int>(sequence.size()) - ngram_size_; j++) {
-      // Here we use naive algorithm for matching. The complexity is O(batch_beam_size * ngram_size * sequence_length)
-      // TODO(tianleiwu): build N-Gram index (hash table with prefix of length NGram - 1 as key,
-      //                  and list of last word of NGram as value) for fast matching.
-      if (ngram_size_ == 1 || SpanEq(prefix, sequence.subspan(j, prefix_length))) {
-        blocked_word_ids.insert(sequence[static_cast<gsl::index>(j) + prefix_length]);
-      }
+  gsl::span<const int32_t> sequence = sequences->GetSequence(batch_beam_index);
+
+  gsl::span<const int32_t> prefix = sequence.subspan(sequence.size() - prefix_length);
+  ORT_ENFORCE(prefix.size() == narrow<size_t>(prefix_length));
+
+  std::unordered_set<int32_t> blocked_word_ids;
+  for (int j = 0; j <= static_cast<int>(sequence.size()) - ngram_size_; j++) {
+    // Here we use naive algorithm for matching. The complexity is O(batch_beam_size * ngram_size * sequence_length)
+    // TODO(tianleiwu): build N-Gram index (hash table with prefix of length NGram - 1 as key,
+    //                  and list of last word of NGram as value) for fast matching.
+    if (ngram_size_ == 1 || SpanEq(prefix, sequence.subspan(j, prefix_length))) {
+      blocked_word_ids.insert(sequence[static_cast<gsl::index>(j) + prefix_length]);
     }
+  }
 
-    for (const int32_t word_id : blocked_word_ids) {
-      beam_token_scores[word_id] = std::numeric_limits<T>::lowest();
-    }
+  for (const int32_t word_id : blocked_word_ids) {
+    beam_token_scores[word_id] = std::numeric_limits<T>::lowest();
+  }
+}
+
+// Set scores of tokens with mask value 0 to -inf. Written as a select so that the loop is vectorized.
+template <typename T>
+static void ApplyVocabMask(const int32_t* mask, gsl::span<T> beam_token_scores) {
+  T* p = beam_token_scores.data();
+  const size_t vocab_size = beam_token_scores.size();
+  for (size_t j = 0; j < vocab_size; j++) {
+    p[j] = mask[j] == 0 ? std::numeric_limits<T>::lowest() : p[j];
   }
 }
 
@@ -101,52 +104,36 @@ VocabMaskLogitsProcessor<T>::VocabMaskLogitsProcessor(const gsl::span<const int3
 }
 
 template <typename T>
-void VocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
-                                          NextTokenScores<T>& next_token_scores) {
+void VocabMaskLogitsProcessor<T>::ProcessRow(const ISequences* /*sequences*/,
+                                             int /*batch_beam_index*/,
+                                             gsl::span<T> beam_token_scores) {
   assert(!vocab_mask_.empty());
 
-  // Process vocabulary mask and set tokens with mask value 0 to -inf.
-  T* p = next_token_scores.scores.data();
   // next_token_scores shape (batch_size * num_beams, vocab_size)
   // vocab_mask shape (vocab_size).
-  for (int i = 0; i < next_token_scores.batch_beam_size; i++) {
-    for (int j = 0; j < next_token_scores.vocab_size; j++, p++) {
-      if (vocab_mask_[j] == 0) {
-        *p = std::numeric_limits<T>::lowest();
-      }
-    }
-  }
+  ApplyVocabMask(vocab_mask_.data(), beam_token_scores);
 }
 
 template <typename T>
 PrefixVocabMaskLogitsProcessor<T>::PrefixVocabMaskLogitsProcessor(const gsl::span<const int32_t>& prefix_vocab_mask,
-                                                                  int batch_size)
+                                                                  int batch_size,
+                                                                  int num_beams)
     : prefix_vocab_mask_(prefix_vocab_mask),
-      batch_size_(batch_size) {
+      batch_size_(batch_size),
+      num_beams_(num_beams) {
 }
 
 template <typename T>
-void PrefixVocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
-                                                NextTokenScores<T>& next_token_scores) {
+void PrefixVocabMaskLogitsProcessor<T>::ProcessRow(const ISequences* /*sequences*/,
+                                                   int batch_beam_index,
+                                                   gsl::span<T> beam_token_scores) {
   assert(!prefix_vocab_mask_.empty());
-
-  // next_token_scores shape (batch_size * num_beams, vocab_size)
-  int num_beams = next_token_scores.batch_beam_size / batch_size_;
-  assert(num_beams * batch_size_ == next_token_scores.batch_beam_size);
+  assert(batch_beam_index / num_beams_ < batch_size_);
 
   // Process prefix vocabulary mask and set tokens with mask value 0 to -inf.
   // prefix_vocab_mask shape (batch_size, vocab_size).
-  T* p = next_token_scores.scores.data();
-  for (int i = 0; i < batch_size_; i++) {
-    size_t prefix_vocab_mask_offset = SafeInt<size_t>(i) * next_token_scores.vocab_size;
-    for (int j = 0; j < num_beams; j++) {
-      for (int k = 0; k < next_token_scores.vocab_size; k++, p++) {
-        if (prefix_vocab_mask_[prefix_vocab_mask_offset + static_cast<size_t>(k)] == 0) {
-          *p = std::numeric_limits<T>::lowest();
-        }
-      }
-    }
-  }
+  size_t prefix_vocab_mask_offset = SafeInt<size_t>(batch_beam_index / num_beams_) * beam_token_scores.size();
+  ApplyVocabMask(prefix_vocab_mask_.data() + prefix_vocab_mask_offset, beam_token_scores);
 }
 
 template <typename T>
@@ -154,16 +141,17 @@ TemperatureLogitsProcessor<T>::TemperatureLogitsProcessor(float temperature) : t
 }
 
 template <typename T>
-void TemperatureLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
-                                            NextTokenScores<T>& next_token_scores) {
+void TemperatureLogitsProcessor<T>::ProcessRow(const ISequences* /*sequences*/,
+                                               int /*batch_beam_index*/,
+                                               gsl::span<T> beam_token_scores) {
   if (temperature_ == 1.0f) {
     return;
   }
 
-  T* p = next_token_scores.scores.data();
-  for (size_t i = 0; i < next_token_scores.scores.size(); i++) {
-    *p /= temperature_;
-    ++p;
+  T* p = beam_token_scores.data();
+  const size_t vocab_size = beam_token_scores.size();
+  for (size_t j = 0; j < vocab_size; j++) {
+    p[j] /= temperature_;
   }
 }
 
@@ -174,43 +162,71 @@ PresencePenaltyLogitsProcessor<T>::PresencePenaltyLogitsProcessor(const gsl::spa
 }
 
 template <typename T>
-void PresencePenaltyLogitsProcessor<T>::Process(const ISequences*,
-                                                NextTokenScores<T>& next_token_scores) {
+void PresencePenaltyLogitsProcessor<T>::ProcessRow(const ISequences* /*sequences*/,
+                                                   int batch_beam_index,
+                                                   gsl::span<T> beam_token_scores) {
   if (presence_penalty_ == 0.0f) {
     return;
   }
 
   assert(!presence_mask_.empty());
 
-  T* p = next_token_scores.scores.data();
-  for (size_t i = 0; i < next_token_scores.scores.size(); i++) {
-    *p -= presence_mask_[i] * presence_penalty_;
+  // presence_mask shape (batch_size, vocab_size). Sampling has one beam per batch entry.
+  const size_t vocab_size = beam_token_scores.size();
+  const int32_t* mask = presence_mask_.data() + SafeInt<size_t>(batch_beam_index) * vocab_size;
+  T* p = beam_token_scores.data();
+  for (size_t j = 0; j < vocab_size; j++) {
+    p[j] -= mask[j] * presence_penalty_;
   }
 }
 
-void LogitsProcessorList::Init(const BeamSearchParameters& parameters) {
+void LogitsProcessorList::Init(const BeamSearchParameters& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
   LogitsProcessorInitImpl<BeamSearchParameters>(parameters);
+  thread_pool_ = thread_pool;
 }
 
-void LogitsProcessorList::Init(const GreedySearchParameters& parameters) {
+void LogitsProcessorList::Init(const GreedySearchParameters& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
   LogitsProcessorInitImpl<GreedySearchParameters>(parameters);
+  thread_pool_ = thread_pool;
 }
 
-void LogitsProcessorList::Init(const SamplingParameters& parameters) {
+void LogitsProcessorList::Init(const SamplingParameters& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
   LogitsProcessorInitImpl<SamplingParameters>(parameters);
+  thread_pool_ = thread_pool;
 }
 
 void LogitsProcessorList::Process(const ISequences* sequences,
                                   gsl::span<float>& next_token_scores,
                                   int step) {
-  NextTokenScores<float> input_scores = {next_token_scores, batch_beam_size_, vocab_size_};
-  for (size_t i = 0; i < processor_list_.size(); i++) {
+  InlinedVector<ILogitsProcessor<float>*> processors;
+  for (auto* processor : processor_list_) {
     // Prefix vocab mask is applied to first iteration only.
-    if (step > 1 && processor_list_[i] == prefix_vocab_mask_processor_.get()) {
+    if (step > 1 && processor == prefix_vocab_mask_processor_.get()) {
       continue;
     }
-    processor_list_[i]->Process(sequences, input_scores);
+    processors.push_back(processor);
   }
+
+  if (processors.empty()) {
+    return;
+  }
+
+  // All processors are applied to one row while it is in cache instead of one full pass over the scores per
+  // processor. Rows are independent, so they are processed in parallel.
+  const double cost = static_cast<double>(vocab_size_) * static_cast<double>(processors.size());
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool_, batch_beam_size_, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          gsl::span<float> beam_token_scores = next_token_scores.subspan(SafeInt<gsl::index>(i) * vocab_size_,
+                                                                         static_cast<gsl::index>(vocab_size_));
+          for (auto* processor : processors) {
+            processor->ProcessRow(sequences, static_cast<int>(i), beam_token_scores);
+          }
+        }
+      });
 }
 
 }  // namespace transformers
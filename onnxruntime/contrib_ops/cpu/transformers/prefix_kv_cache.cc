@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+namespace {
+// FNV-1a over the token ids
+constexpr uint64_t kHashOffset = 14695981039346656037ULL;
+constexpr uint64_t kHashPrime = 1099511628211ULL;
+
+uint64_t HashToken(uint64_t hash, int32_t token) {
+  auto value = static_cast<uint32_t>(token);
+  for (int i = 0; i < 4; i++) {
+    hash = (hash ^ (value & 0xff)) * kHashPrime;
+    value >>= 8;
+  }
+  return hash;
+}
+}  // namespace
+
+PrefixKVCache::PrefixKVCache(size_t memory_budget_bytes, int block_size)
+    : memory_budget_bytes_(memory_budget_bytes), block_size_(block_size) {
+  ORT_ENFORCE(block_size > 0, "block_size shall be positive.");
+}
+
+template <typename Fn>
+void PrefixKVCache::ForEachIndexedPrefix(gsl::span<const int32_t> tokens, const Fn& fn) const {
+  uint64_t hash = kHashOffset;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    hash = HashToken(hash, tokens[i]);
+    const size_t length = i + 1;
+    if (length % static_cast<size_t>(block_size_) == 0 || length == tokens.size()) {
+      fn(length, hash);
+    }
+  }
+}
+
+int PrefixKVCache::Lookup(gsl::span<const int32_t> tokens, int max_length, std::vector<OrtValue>& present) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  // Prompt prefixes are hashed at every length, since a prefix of the prompt may be the full length of an entry.
+  size_t best_length = 0;
+  EntryList::iterator best_entry = entries_.end();
+  uint64_t hash = kHashOffset;
+  const size_t prefix_limit = std::min(tokens.size(), static_cast<size_t>(std::max(max_length, 0)));
+  for (size_t i = 0; i < prefix_limit; i++) {
+    hash = HashToken(hash, tokens[i]);
+    const size_t length = i + 1;
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry& entry = *it->second;
+      if (entry.tokens.size() >= length && std::equal(tokens.begin(), tokens.begin() + length, entry.tokens.begin())) {
+        best_length = length;
+        best_entry = it->second;
+        break;
+      }
+    }
+  }
+
+  if (best_entry == entries_.end()) {
+    return 0;
+  }
+
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, best_entry);
+  present = best_entry->present;
+  return static_cast<int>(best_length);
+}
+
+int PrefixKVCache::LookupPast(gsl::span<const int32_t> tokens, int max_length, const AllocatorPtr& allocator,
+                              std::vector<OrtValue>& past) {
+  past.clear();
+  std::vector<OrtValue> present;
+  const int prefix_length = Lookup(tokens, max_length, present);
+  if (prefix_length == 0) {
+    return 0;
+  }
+
+  past.reserve(present.size());
+  for (const OrtValue& value : present) {
+    // Shape is (2, 1, num_heads, length, head_size).
+    const Tensor& source = value.Get<Tensor>();
+    const TensorShape& shape = source.Shape();
+    const int64_t length = shape[3];
+    if (length == prefix_length) {
+      past.push_back(value);
+      continue;
+    }
+
+    OrtValue prefix;
+    Tensor::InitOrtValue(source.DataType(), TensorShape({shape[0], shape[1], shape[2], prefix_length, shape[4]}),
+                         allocator, prefix);
+    const size_t token_bytes = SafeInt<size_t>(shape[4]) * source.DataType()->Size();
+    const auto* source_data = static_cast<const char*>(source.DataRaw());
+    auto* dest = static_cast<char*>(prefix.GetMutable<Tensor>()->MutableDataRaw());
+    for (int64_t i = 0; i < shape[0] * shape[1] * shape[2]; i++) {
+      memcpy(dest + i * prefix_length * token_bytes, source_data + i * length * token_bytes,
+             SafeInt<size_t>(prefix_length) * token_bytes);
+    }
+    past.push_back(std::move(prefix));
+  }
+
+  return prefix_length;
+}
+
+void PrefixKVCache::Insert(gsl::span<const int32_t> tokens, const std::vector<OrtValue>& present) {
+  if (tokens.empty()) {
+    return;
+  }
+
+  size_t bytes = tokens.size() * sizeof(int32_t);
+  for (const OrtValue& value : present) {
+    bytes += value.Get<Tensor>().SizeInBytes();
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (bytes > memory_budget_bytes_) {
+    return;
+  }
+
+  // Refresh an existing entry for the same tokens instead of storing them twice.
+  uint64_t full_hash = kHashOffset;
+  for (int32_t token : tokens) {
+    full_hash = HashToken(full_hash, token);
+  }
+  auto range = index_.equal_range(full_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = *it->second;
+    if (entry.tokens.size() == tokens.size() && std::equal(tokens.begin(), tokens.end(), entry.tokens.begin())) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+  }
+
+  while (memory_usage_ + bytes > memory_budget_bytes_ && !entries_.empty()) {
+    Evict(std::prev(entries_.end()));
+  }
+
+  entries_.push_front(Entry{std::vector<int32_t>(tokens.begin(), tokens.end()), present, bytes});
+  memory_usage_ += bytes;
+  auto entry = entries_.begin();
+  ForEachIndexedPrefix(tokens, [this, entry](size_t /*length*/, uint64_t hash) {
+    index_.emplace(hash, entry);
+  });
+}
+
+void PrefixKVCache::Evict(EntryList::iterator entry) {
+  ForEachIndexedPrefix(entry->tokens, [this, entry](size_t /*length*/, uint64_t hash) {
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == entry) {
+        index_.erase(it);
+        break;
+      }
+    }
+  });
+
+  memory_usage_ -= entry->bytes;
+  entries_.erase(entry);
+}
+
+size_t PrefixKVCache::MemoryUsage() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return memory_usage_;
+}
+
+size_t PrefixKVCache::EntryCount() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t PrefixKVCache::HitCount() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return hit_count_;
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Cache of the present key/value state of prompts, to skip recomputing a prompt prefix that an earlier request
+// already ran, e.g. a system prompt sent with every request.
+//
+// An entry holds the present state of every layer of one prompt, with shape (2, 1, num_heads, length, head_size).
+// As attention is causal, the first p tokens of an entry are the state of any prompt starting with the same p tokens.
+// Entries are indexed by the hash of their prefixes at multiples of block_size tokens and of their full length, and a
+// lookup returns the longest indexed prefix shared with the prompt.
+//
+// The state of an entry is shared read-only with the callers, which shall not write to it. Entries are evicted least
+// recently used first when their total size exceeds the memory budget.
+// The cache may be shared by several runs or sessions; all methods are thread-safe.
+class PrefixKVCache {
+ public:
+  PrefixKVCache(size_t memory_budget_bytes, int block_size);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrefixKVCache);
+
+  // Finds the longest cached prefix of tokens with at most max_length tokens. Returns its length, or 0 if there is
+  // none. present is set to the state of the matching entry, which may be longer than the returned length: only its
+  // first tokens along the sequence dimension belong to the prefix.
+  int Lookup(gsl::span<const int32_t> tokens, int max_length, std::vector<OrtValue>& present);
+
+  // Like Lookup, but past is set to the state of the prefix only, one tensor per layer with the prefix length along
+  // the sequence dimension. The state of a longer entry is copied to tensors allocated with allocator.
+  int LookupPast(gsl::span<const int32_t> tokens, int max_length, const AllocatorPtr& allocator,
+                 std::vector<OrtValue>& past);
+
+  // Stores the present state of tokens, one tensor per layer. Does nothing if the state is larger than the budget.
+  void Insert(gsl::span<const int32_t> tokens, const std::vector<OrtValue>& present);
+
+  size_t MemoryUsage() const;
+  size_t EntryCount() const;
+
+  // Number of lookups that found a cached prefix.
+  size_t HitCount() const;
+
+ private:
+  struct Entry {
+    std::vector<int32_t> tokens;
+    std::vector<OrtValue> present;
+    size_t bytes = 0;
+  };
+  using EntryList = std::list<Entry>;
+
+  // Calls fn(prefix_length, prefix_hash) for the indexed prefixes of tokens.
+  template <typename Fn>
+  void ForEachIndexedPrefix(gsl::span<const int32_t> tokens, const Fn& fn) const;
+
+  void Evict(EntryList::iterator entry);
+
+  const size_t memory_budget_bytes_;
+  const int block_size_;
+
+  mutable OrtMutex mutex_;
+  size_t memory_usage_ = 0;
+  size_t hit_count_ = 0;
+  EntryList entries_;  // most recently used first
+  std::unordered_multimap<uint64_t, EntryList::iterator> index_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
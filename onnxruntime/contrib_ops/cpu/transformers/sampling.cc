@@ -9,6 +9,7 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
 #include "contrib_ops/cpu/transformers/sampling.h"
@@ -16,6 +17,8 @@
 #include "contrib_ops/cpu/transformers/sequences.h"
 #include "contrib_ops/cpu/transformers/dump_tensor.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_gpt.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace ONNX_NAMESPACE;
 using namespace onnxruntime::common;
@@ -56,10 +59,37 @@ void Sampling::Init(const OpKernelInfo& info) {
     if (info.GetAttr<ONNX_NAMESPACE::GraphProto>("init_decoder", &proto).IsOK()) {
       has_init_decoder_ = true;
     }
+
+    // Check if the draft_decoder sub-graph attribute is present for speculative decoding.
+    if (info.GetAttr<ONNX_NAMESPACE::GraphProto>("draft_decoder", &proto).IsOK()) {
+      has_draft_decoder_ = true;
+      num_speculative_tokens_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("num_speculative_tokens", 4));
+      ORT_ENFORCE(num_speculative_tokens_ > 0, "num_speculative_tokens shall be positive.");
+
+      // The tokens are taken from the distributions of both decoders, so there are no filtered logits of one step.
+      const auto& output_defs = info.node().OutputDefs();
+      ORT_ENFORCE(output_defs.size() < 2 || !output_defs[1]->Exists(),
+                  "draft_decoder does not support the filtered_logits output.");
+    }
   }
 
   // Make sure the decoder sub-graph attribute is present for all model types.
   ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+
+  const std::string prefix_cache_bytes_str =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsGenerationPrefixCacheBytes, "0");
+  size_t prefix_cache_bytes = 0;
+  ORT_ENFORCE(TryParseStringWithClassicLocale(prefix_cache_bytes_str, prefix_cache_bytes),
+              "Invalid generation prefix cache size: ", prefix_cache_bytes_str);
+  if (prefix_cache_bytes > 0) {
+    // Prompts are indexed every 16 tokens and at their full length.
+    prefix_cache_ = std::make_shared<PrefixKVCache>(prefix_cache_bytes, 16);
+  }
+
+  const std::string prefill_chunk_size_str =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsGenerationPrefillChunkSize, "0");
+  ORT_ENFORCE(TryParseStringWithClassicLocale(prefill_chunk_size_str, prefill_chunk_size_) && prefill_chunk_size_ >= 0,
+              "Invalid generation prefill chunk size: ", prefill_chunk_size_str);
 }
 
 Status Sampling::SetupSubgraphExecutionInfo(const SessionState& session_state,
@@ -91,6 +121,12 @@ Status Sampling::SetupSubgraphExecutionInfo(const SessionState& session_state,
 
       init_run_gpt_subgraph_ = std::move(res.second);
       init_run_decoder_feeds_fetches_manager_ = init_run_gpt_subgraph_->GetFeedsFetchesManager();
+    } else if (attribute_name == "draft_decoder") {
+      ORT_ENFORCE(draft_gpt_subgraph_ == nullptr, "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+      // 'parameters_' is not updated: it describes the 'decoder' subgraph, whose vocabulary the draft decoder shares.
+      draft_gpt_subgraph_ = std::make_unique<GptSubgraph>(node, attribute_name, subgraph_session_state.GetGraphViewer());
+      ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->Setup(session_state, subgraph_session_state));
+      draft_decoder_feeds_fetches_manager_ = draft_gpt_subgraph_->GetFeedsFetchesManager();
     }
   } else if (parameters_.model_type == IGenerationParameters::kModelTypeT5) {  // encoder-decoder like T5
     ORT_THROW("Not Implemented");
@@ -114,6 +150,12 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
                 "past_present_share_buffer mode must be same for init decoder and decoder subgraphes");
   }
 
+  auto* draft_decoder_session_state = ctx_internal->SubgraphSessionState("draft_decoder");
+  if (has_draft_decoder_) {
+    ORT_ENFORCE(draft_decoder_session_state, "Subgraph SessionState was not found for 'draft_decoder' attribute.");
+    ORT_ENFORCE(draft_decoder_feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
+  }
+
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   // make a copy since we will update the parameters based on inputs later
@@ -139,6 +181,13 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
           init_greedy_state_func_ ? init_greedy_state_func_ : GenerationCpuDeviceHelper::InitGreedyState<float>,
           device_copy_func_ ? device_copy_func_ : GenerationCpuDeviceHelper::DeviceCopy<float>,
           update_gpt_feeds_func_ ? update_gpt_feeds_func_ : GenerationCpuDeviceHelper::UpdateGptFeeds<float>};
+      impl.SetPrefixCache(prefix_cache_.get());
+      impl.SetPrefillChunkSize(prefill_chunk_size_);
+      if (has_draft_decoder_) {
+        impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get(),
+                             draft_decoder_feeds_fetches_manager_, num_speculative_tokens_,
+                             GenerationCpuDeviceHelper::SpeculativeProcessLogits);
+      }
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, gpu_device_prop_, gpu_device_arch_));
 #endif
@@ -146,6 +195,7 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
     } else {
+      ORT_RETURN_IF(has_draft_decoder_, "draft_decoder supports decoder subgraphs with float logits only.");
       GreedySearchGpt<MLFloat16, SamplingParameters> impl{
           *ctx_internal,
           has_init_decoder_ ? init_run_decoder_session_state : nullptr,
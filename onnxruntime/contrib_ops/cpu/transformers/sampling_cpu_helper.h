@@ -65,7 +65,6 @@ Status Sample(AllocatorPtr& allocator,
   ORT_UNUSED_PARAMETER(dumper);
 
   gsl::span<T>& sorted_scores = sampling_state->sorted_scores;
-  memcpy(sorted_scores.data(), next_token_scores.data(), next_token_scores.size_bytes());
   std::vector<size_t> sorted_indices(static_cast<size_t>(parameters->batch_size) * static_cast<size_t>(parameters->vocab_size));
 
   std::function<bool(T, T)> predicator;
@@ -75,21 +74,25 @@ Status Sample(AllocatorPtr& allocator,
     predicator = std::less<T>();
   }
 
-  // TODO: This could be optimized with allocated buffer and handwritten sort algorithm
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    auto indices_begin = sorted_indices.begin() + i * parameters->vocab_size;
-    auto indices_end = sorted_indices.begin() + (i + 1) * parameters->vocab_size;
-    gsl::span<T> next_token_score = next_token_scores.subspan(i * parameters->vocab_size, parameters->vocab_size);
-    std::iota(indices_begin, indices_end, 0);
-    std::sort(indices_begin, indices_end,
-              [&next_token_score, &predicator](size_t i1, size_t i2) {
-                return predicator(next_token_score[i1], next_token_score[i2]);
-              });
-
-    std::sort(sorted_scores.begin() + i * parameters->vocab_size,
-              sorted_scores.begin() + (i + 1) * parameters->vocab_size,
-              predicator);
-  }
+  // the scores are gathered through the sorted indices instead of being sorted a second time. the batches are
+  // sorted in parallel as the vocabulary of a language model is large.
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(parameters->batch_size),
+      [&next_token_scores, &sorted_scores, &sorted_indices, &predicator, parameters](std::ptrdiff_t batch) {
+        const size_t offset = static_cast<size_t>(batch) * static_cast<size_t>(parameters->vocab_size);
+        auto indices_begin = sorted_indices.begin() + offset;
+        auto indices_end = indices_begin + parameters->vocab_size;
+        gsl::span<T> next_token_score = next_token_scores.subspan(offset, parameters->vocab_size);
+        std::iota(indices_begin, indices_end, 0);
+        std::sort(indices_begin, indices_end,
+                  [&next_token_score, &predicator](size_t i1, size_t i2) {
+                    return predicator(next_token_score[i1], next_token_score[i2]);
+                  });
+
+        for (size_t j = 0; j < static_cast<size_t>(parameters->vocab_size); j++) {
+          sorted_scores[offset + j] = next_token_score[indices_begin[j]];
+        }
+      });
 
 #ifdef DEBUG_GENERATION
   dumper->Print("sorted_scores", sorted_scores.data(), parameters->batch_size, parameters->vocab_size);
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include "core/common/safeint.h"
 #include "contrib_ops/cpu/transformers/sequences.h"
 
@@ -20,6 +21,13 @@ void Sequences::Init(gsl::span<int32_t> buffer, int batch_beam_size, int sequenc
   batch_beam_size_ = batch_beam_size;
   max_length_ = max_length;
   current_length_ = sequence_length;
+  materialized_length_ = sequence_length;
+
+  const size_t max_pending_size = SafeInt<size_t>(batch_beam_size) * std::max(max_length - sequence_length, 0);
+  pending_beam_indices_.clear();
+  pending_tokens_.clear();
+  pending_beam_indices_.reserve(max_pending_size);
+  pending_tokens_.reserve(max_pending_size);
 }
 
 void Sequences::InitDevice(gsl::span<int32_t> buffer) {
@@ -28,6 +36,10 @@ void Sequences::InitDevice(gsl::span<int32_t> buffer) {
 }
 
 gsl::span<const int32_t> Sequences::GetSequence(int beam_index) const {
+  if (materialized_length_.load(std::memory_order_acquire) != current_length_) {
+    MaterializePendingTokens();
+  }
+
   gsl::span<const int32_t> buffer = sequences[current_sequences_buffer];
   return buffer.subspan(SafeInt<size_t>(beam_index) * max_length_, static_cast<gsl::index>(current_length_));
 }
@@ -49,25 +61,46 @@ void Sequences::PrintSequences(const IConsoleDumper* dumper) const {
 void Sequences::AppendNextTokenToSequences(
     gsl::span<int32_t>& beam_indices,
     gsl::span<int32_t>& beam_next_tokens) {
+  pending_beam_indices_.insert(pending_beam_indices_.end(), beam_indices.begin(), beam_indices.begin() + batch_beam_size_);
+  pending_tokens_.insert(pending_tokens_.end(), beam_next_tokens.begin(), beam_next_tokens.begin() + batch_beam_size_);
+
+  ++current_length_;
+}
+
+void Sequences::MaterializePendingTokens() const {
+  std::lock_guard<OrtMutex> lock(materialize_mutex_);
+  const int materialized_length = materialized_length_.load(std::memory_order_relaxed);
+  if (materialized_length == current_length_) {
+    return;
+  }
+
   gsl::span<const int32_t> input = sequences[current_sequences_buffer];
   gsl::span<int32_t> output = sequences[current_sequences_buffer ^ 1];
+  const int num_pending_steps = current_length_ - materialized_length;
 
   for (int i = 0; i < batch_beam_size_; i++) {
-    int beam_index = beam_indices[i];
-    gsl::span<const int32_t> source = input.subspan(SafeInt<size_t>(beam_index) * max_length_,
-                                                    static_cast<gsl::index>(current_length_));
     gsl::span<int32_t> target = output.subspan(SafeInt<size_t>(i) * max_length_,
                                                static_cast<gsl::index>(current_length_));
-    gsl::copy(source, target);
 
-    // Append next token to each beam.
-    output[SafeInt<size_t>(i) * max_length_ + current_length_] = beam_next_tokens[i];
+    // Walk back the pending steps to write their tokens and find the beam this one started from.
+    int beam_index = i;
+    for (int step = num_pending_steps - 1; step >= 0; step--) {
+      const size_t offset = SafeInt<size_t>(step) * batch_beam_size_ + beam_index;
+      target[static_cast<size_t>(materialized_length) + step] = pending_tokens_[offset];
+      beam_index = pending_beam_indices_[offset];
+    }
+
+    gsl::span<const int32_t> source = input.subspan(SafeInt<size_t>(beam_index) * max_length_,
+                                                    static_cast<gsl::index>(materialized_length));
+    gsl::copy(source, target.subspan(0, static_cast<gsl::index>(materialized_length)));
   }
 
-  ++current_length_;
+  pending_beam_indices_.clear();
+  pending_tokens_.clear();
 
   // Rotate buffer for next round.
   current_sequences_buffer ^= 1;
+  materialized_length_.store(current_length_, std::memory_order_release);
 }
 
 void Sequences::AppendNextTokenToSequences(gsl::span<int32_t>& next_tokens) {
@@ -79,11 +112,30 @@ void Sequences::AppendNextTokenToSequences(gsl::span<int32_t>& next_tokens) {
   }
 
   ++current_length_;
+  materialized_length_.store(current_length_, std::memory_order_release);
 }
 
 void Sequences::AfterDeviceAppendedNextToken() {
   ++current_length_;
   current_sequences_buffer ^= 1;
+  materialized_length_.store(current_length_, std::memory_order_release);
+}
+
+gsl::span<const int32_t> SingleSequence::GetSequence(int beam_index) const {
+  ORT_ENFORCE(beam_index == 0);
+  return tokens_;
+}
+
+gsl::span<const int32_t> SingleSequence::GetCurrentDeviceSequences() const {
+  ORT_THROW("Device sequences are not used by a single sequence.");
+}
+
+gsl::span<int32_t> SingleSequence::GetNextDeviceSequences() {
+  ORT_THROW("Device sequences are not used by a single sequence.");
+}
+
+int SingleSequence::GetSequenceLength() const {
+  return static_cast<int>(tokens_.size());
 }
 
 }  // namespace transformers
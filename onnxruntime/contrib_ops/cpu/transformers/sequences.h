@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <vector>
 #include "core/common/gsl.h"
+#include "core/platform/ort_mutex.h"
 #include "contrib_ops/cpu/transformers/generation_shared.h"
 
 namespace onnxruntime {
@@ -31,6 +34,7 @@ class Sequences : public ISequences {
 #endif
 
   // Select sequences based on beam indices, then append next token to selected sequences.
+  // The sequences are only rebuilt when they are read, so this costs O(batch_beam_size) regardless of the length.
   void AppendNextTokenToSequences(
       gsl::span<int32_t>& beam_indices,
       gsl::span<int32_t>& beam_next_tokens);
@@ -41,20 +45,46 @@ class Sequences : public ISequences {
   void AfterDeviceAppendedNextToken();
 
  private:
+  // Writes the tokens appended since the last call to the active buffer. Safe to call from several threads.
+  void MaterializePendingTokens() const;
+
   // Two buffers of shape (batch_size, num_beams, max_seq_length) to store sequences.
   // At each time, there is only one buffer is active. The other one will be active in next token.
-  // Each AppendNextTokenToSequences call will trigger a rotation of active buffer.
+  // Rebuilding the sequences from the pending tokens triggers a rotation of active buffer.
   gsl::span<int32_t> sequences[2];
   gsl::span<int32_t> device_sequences[2];
 
   // Index (either 0 or 1) of two buffers that is currently is active.
-  int current_sequences_buffer;
+  mutable int current_sequences_buffer;
+
+  // Beam indices and next tokens of the steps appended since the sequences were last rebuilt,
+  // each of shape (pending steps, batch_beam_size). A sequence is rebuilt by following its beam indices back.
+  // The capacity is reserved in Init so appending never allocates.
+  mutable std::vector<int32_t> pending_beam_indices_;
+  mutable std::vector<int32_t> pending_tokens_;
+  // Length of the sequences in the active buffer.
+  mutable std::atomic<int> materialized_length_{0};
+  mutable OrtMutex materialize_mutex_;
 
   int batch_beam_size_;
   int max_length_;
   int current_length_;
 };
 
+// A single sequence held by the caller, for running logits processors outside of the search loops.
+class SingleSequence : public ISequences {
+ public:
+  explicit SingleSequence(gsl::span<const int32_t> tokens) : tokens_(tokens) {}
+
+  gsl::span<const int32_t> GetSequence(int beam_index) const override;
+  gsl::span<const int32_t> GetCurrentDeviceSequences() const override;
+  gsl::span<int32_t> GetNextDeviceSequences() override;
+  int GetSequenceLength() const override;
+
+ private:
+  gsl::span<const int32_t> tokens_;
+};
+
 }  // namespace transformers
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,276 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/speculative_decoding.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+SpeculativeDecoding::SpeculativeDecoding(const SpeculativeDecodingOptions& options,
+                                         AllocatorPtr allocator,
+                                         RunDecoderFunc run_decoder,
+                                         RunDecoderFunc run_draft_decoder,
+                                         SpeculativeProcessScoresFunc process_scores)
+    : options_(options),
+      allocator_(std::move(allocator)),
+      process_scores_(std::move(process_scores)),
+      generator_(gsl::narrow_cast<uint32_t>(options.seed)) {
+  ORT_ENFORCE(options_.num_speculative_tokens >= 0 && options_.vocab_size > 0);
+  ORT_ENFORCE(!options_.do_sample || options_.temperature > 0.0f, "temperature shall be positive for sampling.");
+  main_.config = options_.decoder;
+  main_.run = std::move(run_decoder);
+  draft_.config = options_.draft_decoder;
+  draft_.run = std::move(run_draft_decoder);
+}
+
+OrtValue SpeculativeDecoding::CreateTensor(MLDataType type, const TensorShape& shape) const {
+  OrtValue value;
+  Tensor::InitOrtValue(type, shape, allocator_, value);
+  return value;
+}
+
+Status SpeculativeDecoding::Run(ModelState& model, gsl::span<const int32_t> tokens, std::vector<float>& logits) {
+  const int64_t sequence_length = static_cast<int64_t>(tokens.size());
+  const int64_t past_length = model.past_length;
+  const int64_t total_length = past_length + sequence_length;
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  std::vector<OrtValue> feeds;
+  feeds.reserve(3 + static_cast<size_t>(model.config.num_layers));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({1, sequence_length})));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({1, sequence_length})));
+  feeds.push_back(CreateTensor(int32_type, TensorShape({1, total_length})));
+  int32_t* input_ids = feeds[0].GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* position_ids = feeds[1].GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* attention_mask = feeds[2].GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t s = 0; s < sequence_length; s++) {
+    input_ids[s] = tokens[s];
+    position_ids[s] = static_cast<int32_t>(past_length + s);
+  }
+  std::fill(attention_mask, attention_mask + total_length, 1);
+
+  if (model.past.empty()) {
+    const TensorShape past_shape({2, 1, model.config.num_heads, 0, model.config.head_size});
+    for (int layer = 0; layer < model.config.num_layers; layer++) {
+      feeds.push_back(CreateTensor(DataTypeImpl::GetType<float>(), past_shape));
+    }
+  } else {
+    feeds.insert(feeds.end(), model.past.begin(), model.past.end());
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(model.run(feeds, fetches));
+  ORT_RETURN_IF_NOT(fetches.size() == 1 + static_cast<size_t>(model.config.num_layers),
+                    "Decoder shall output logits and one present state per layer.");
+
+  const Tensor& logits_tensor = fetches[0].Get<Tensor>();
+  ORT_RETURN_IF_NOT(logits_tensor.Shape().Size() == sequence_length * options_.vocab_size,
+                    "Decoder logits shall have shape (1, ", sequence_length, ", ", options_.vocab_size, ")");
+  gsl::span<const float> logits_data = logits_tensor.DataAsSpan<float>();
+  logits.assign(logits_data.begin(), logits_data.end());
+
+  model.past.assign(fetches.begin() + 1, fetches.end());
+  model.past_length = static_cast<int>(total_length);
+  return Status::OK();
+}
+
+void SpeculativeDecoding::Truncate(ModelState& model, int length) {
+  if (length >= model.past_length) {
+    return;
+  }
+
+  const int64_t num_heads = model.config.num_heads;
+  const int64_t head_size = model.config.head_size;
+  for (auto& past : model.past) {
+    OrtValue truncated = CreateTensor(DataTypeImpl::GetType<float>(),
+                                      TensorShape({2, 1, num_heads, length, head_size}));
+    const float* source = past.Get<Tensor>().Data<float>();
+    float* dest = truncated.GetMutable<Tensor>()->MutableData<float>();
+    for (int64_t i = 0; i < 2 * num_heads; i++) {
+      memcpy(dest + i * length * head_size,
+             source + i * model.past_length * head_size,
+             SafeInt<size_t>(length) * head_size * sizeof(float));
+    }
+    past = std::move(truncated);
+  }
+  model.past_length = length;
+}
+
+Status SpeculativeDecoding::ProcessScores(gsl::span<const int32_t> context, gsl::span<float> scores) const {
+  if (process_scores_) {
+    const int step = static_cast<int>(context.size()) - prompt_length_ + 1;
+    return process_scores_(context, step, scores);
+  }
+
+  const float max_score = *std::max_element(scores.begin(), scores.end());
+  float sum = 0.0f;
+  for (auto& score : scores) {
+    score = std::exp((score - max_score) / options_.temperature);
+    sum += score;
+  }
+  for (auto& score : scores) {
+    score /= sum;
+  }
+  return Status::OK();
+}
+
+int32_t SpeculativeDecoding::SelectToken(gsl::span<const float> probabilities) {
+  if (!options_.do_sample) {
+    return static_cast<int32_t>(std::max_element(probabilities.begin(), probabilities.end()) -
+                                probabilities.begin());
+  }
+
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+  const float threshold = distribution(generator_);
+  float cumulative = 0.0f;
+  for (size_t i = 0; i < probabilities.size(); i++) {
+    cumulative += probabilities[i];
+    if (threshold < cumulative) {
+      return static_cast<int32_t>(i);
+    }
+  }
+
+  // Rounding left the cumulative sum below the threshold: take the last token with non-zero probability.
+  for (size_t i = probabilities.size(); i > 0; i--) {
+    if (probabilities[i - 1] > 0.0f) {
+      return static_cast<int32_t>(i - 1);
+    }
+  }
+  return 0;
+}
+
+Status SpeculativeDecoding::Generate(gsl::span<const int32_t> input_ids,
+                                     int max_length,
+                                     std::vector<int32_t>& sequence,
+                                     const SpeculativeTokenFunc& on_token) {
+  ORT_RETURN_IF(input_ids.empty(), "input_ids shall not be empty.");
+  ORT_RETURN_IF(max_length <= static_cast<int>(input_ids.size()),
+                "max_length shall be larger than the length of input_ids.");
+
+  sequence.assign(input_ids.begin(), input_ids.end());
+  prompt_length_ = static_cast<int>(input_ids.size());
+  for (ModelState* model : {&main_, &draft_}) {
+    model->past.clear();
+    model->past_length = 0;
+  }
+  decoder_runs_ = 0;
+  accepted_tokens_ = 0;
+  proposed_tokens_ = 0;
+
+  const size_t vocab_size = static_cast<size_t>(options_.vocab_size);
+  std::vector<int32_t> proposals;
+  std::vector<float> draft_probabilities;
+  std::vector<int32_t> pending;
+  std::vector<int32_t> context;  // sequence followed by the proposals before the position being scored
+  std::vector<float> logits;
+  std::vector<float> residual(vocab_size);
+
+  bool done = false;
+  while (!done && static_cast<int>(sequence.size()) < max_length) {
+    const int previous_length = static_cast<int>(sequence.size());
+    // Leave room for the token taken from the main model after the accepted proposals.
+    const int k = std::min(options_.num_speculative_tokens, max_length - previous_length - 1);
+
+    // Draft: propose k tokens autoregressively.
+    proposals.clear();
+    context.assign(sequence.begin(), sequence.end());
+    draft_probabilities.resize(k * vocab_size);
+    for (int i = 0; i < k; i++) {
+      // Tokens of sequence followed by proposals that are not in the past state of the draft model yet.
+      if (draft_.past_length < previous_length) {
+        pending.assign(sequence.begin() + draft_.past_length, sequence.end());
+        pending.insert(pending.end(), proposals.begin(), proposals.end());
+      } else {
+        pending.assign(proposals.begin() + (draft_.past_length - previous_length), proposals.end());
+      }
+      ORT_RETURN_IF_ERROR(Run(draft_, pending, logits));
+
+      gsl::span<float> q = gsl::make_span(draft_probabilities).subspan(i * vocab_size, vocab_size);
+      std::copy(logits.end() - vocab_size, logits.end(), q.begin());
+      ORT_RETURN_IF_ERROR(ProcessScores(context, q));
+      proposals.push_back(SelectToken(q));
+      context.push_back(proposals.back());
+    }
+
+    // Main: score all proposals in one run.
+    pending.assign(sequence.begin() + main_.past_length, sequence.end());
+    pending.insert(pending.end(), proposals.begin(), proposals.end());
+    ORT_RETURN_IF_ERROR(Run(main_, pending, logits));
+    decoder_runs_++;
+    proposed_tokens_ += k;
+
+    // Row j of the last k + 1 rows holds the main model distribution of the token after proposal j - 1.
+    gsl::span<float> rows = gsl::make_span(logits).subspan(logits.size() - (k + 1) * vocab_size);
+    int accepted = 0;
+    int32_t next_token = -1;
+    context.resize(previous_length);
+    for (; accepted < k; accepted++) {
+      gsl::span<float> p = rows.subspan(accepted * vocab_size, vocab_size);
+      ORT_RETURN_IF_ERROR(ProcessScores(context, p));
+      const int32_t proposal = proposals[accepted];
+      context.push_back(proposal);
+      if (!options_.do_sample) {
+        const int32_t best = SelectToken(p);
+        if (best != proposal) {
+          next_token = best;
+          break;
+        }
+        continue;
+      }
+
+      gsl::span<const float> q = gsl::make_span(draft_probabilities).subspan(accepted * vocab_size, vocab_size);
+      std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+      if (distribution(generator_) * q[proposal] < p[proposal]) {
+        continue;
+      }
+
+      float sum = 0.0f;
+      for (size_t v = 0; v < vocab_size; v++) {
+        residual[v] = std::max(0.0f, p[v] - q[v]);
+        sum += residual[v];
+      }
+      if (sum > 0.0f) {
+        for (auto& value : residual) {
+          value /= sum;
+        }
+        next_token = SelectToken(residual);
+      } else {
+        next_token = SelectToken(p);
+      }
+      break;
+    }
+
+    if (accepted == k) {
+      gsl::span<float> p = rows.subspan(k * vocab_size, vocab_size);
+      ORT_RETURN_IF_ERROR(ProcessScores(context, p));
+      next_token = SelectToken(p);
+    }
+
+    for (int i = 0; i <= accepted && !done; i++) {
+      const int32_t token = (i < accepted) ? proposals[i] : next_token;
+      sequence.push_back(token);
+      accepted_tokens_ += (i < accepted) ? 1 : 0;
+      done = (token == options_.eos_token_id);
+      if (on_token) {
+        on_token(token, static_cast<int>(sequence.size()));
+      }
+    }
+
+    // Only the last token is not in the past state yet. Entries of rejected proposals are dropped.
+    const int valid_length = static_cast<int>(sequence.size()) - 1;
+    Truncate(main_, valid_length);
+    Truncate(draft_, valid_length);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
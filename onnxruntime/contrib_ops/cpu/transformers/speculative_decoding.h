@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <random>
+#include <vector>
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "contrib_ops/cpu/transformers/continuous_batching.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Shape of the past state of one GPT decoder subgraph.
+struct DecoderConfig {
+  int num_layers = 0;
+  int num_heads = 0;
+  int head_size = 0;
+};
+
+struct SpeculativeDecodingOptions {
+  DecoderConfig decoder;        // main (target) model
+  DecoderConfig draft_decoder;  // small draft model
+  int num_speculative_tokens = 4;
+  int vocab_size = 0;
+  int eos_token_id = -1;
+  bool do_sample = false;  // false: greedy; true: sample from softmax(logits / temperature)
+  float temperature = 1.0f;
+  int seed = 0;
+};
+
+// Turns the logits of the next token of context into the probabilities that the token is taken from, in place.
+// step counts the generated tokens up to and including the next token, which is the step of the logits processors.
+using SpeculativeProcessScoresFunc =
+    std::function<Status(gsl::span<const int32_t> context, int step, gsl::span<float> scores)>;
+
+// Called with each token appended to the sequence and the sequence length including it, to stream the tokens.
+using SpeculativeTokenFunc = std::function<void(int32_t token, int sequence_length)>;
+
+// Speculative decoding of one sequence with a main and a draft GPT decoder subgraph.
+//
+// In every iteration the draft decoder proposes k tokens, one decoder run per token. The main decoder then scores
+// the pending tokens and all k proposals in a single run with sequence length k + 1, which gives the main model
+// distributions p_1 ... p_{k+1} at every proposed position. Proposals are accepted from left to right:
+//   - greedy:   d_i is accepted when it is the arg max of p_i; the first mismatch is replaced by arg max p_i.
+//   - sampling: d_i is accepted with probability min(1, p_i(d_i) / q_i(d_i)), q_i being the draft distribution;
+//               a rejected token is resampled from normalize(max(0, p_i - q_i)).
+// When all k proposals are accepted, one more token is taken from p_{k+1}. Both rules produce the same
+// distribution of sequences as decoding with the main model alone (the same tokens in greedy mode).
+//
+// The distributions of both models come from process_scores when it is given, so that logits processors and top-p
+// filtering shape p and q exactly as they shape the distributions of GreedySearch and Sampling. Otherwise they are
+// softmax(logits / temperature).
+//
+// Past state entries of rejected proposals are dropped by truncating the present state along its sequence axis.
+class SpeculativeDecoding {
+ public:
+  SpeculativeDecoding(const SpeculativeDecodingOptions& options,
+                      AllocatorPtr allocator,
+                      RunDecoderFunc run_decoder,
+                      RunDecoderFunc run_draft_decoder,
+                      SpeculativeProcessScoresFunc process_scores = nullptr);
+
+  // Generates tokens after input_ids until eos_token_id or max_length. sequence receives prompt and generated tokens.
+  // on_token, when given, is called for every generated token as soon as it is accepted.
+  Status Generate(gsl::span<const int32_t> input_ids, int max_length, std::vector<int32_t>& sequence,
+                  const SpeculativeTokenFunc& on_token = nullptr);
+
+  // Statistics of the last Generate call: main decoder runs, proposals appended to the sequence and all proposals.
+  int DecoderRuns() const { return decoder_runs_; }
+  int AcceptedTokens() const { return accepted_tokens_; }
+  int ProposedTokens() const { return proposed_tokens_; }
+
+ private:
+  struct ModelState {
+    DecoderConfig config;
+    RunDecoderFunc run;
+    std::vector<OrtValue> past;  // per layer, shape (2, 1, num_heads, past_length, head_size)
+    int past_length = 0;
+  };
+
+  // Feeds tokens after the past state of a model and returns logits of shape (tokens.size(), vocab_size).
+  Status Run(ModelState& model, gsl::span<const int32_t> tokens, std::vector<float>& logits);
+
+  // Drops the past state beyond length.
+  void Truncate(ModelState& model, int length);
+
+  // Converts the logits of the next token of context to probabilities in place.
+  Status ProcessScores(gsl::span<const int32_t> context, gsl::span<float> scores) const;
+
+  int32_t SelectToken(gsl::span<const float> probabilities);
+
+  OrtValue CreateTensor(MLDataType type, const TensorShape& shape) const;
+
+  SpeculativeDecodingOptions options_;
+  AllocatorPtr allocator_;
+  ModelState main_;
+  ModelState draft_;
+  SpeculativeProcessScoresFunc process_scores_;
+  std::default_random_engine generator_;
+  int prompt_length_ = 0;
+
+  int decoder_runs_ = 0;
+  int accepted_tokens_ = 0;
+  int proposed_tokens_ = 0;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
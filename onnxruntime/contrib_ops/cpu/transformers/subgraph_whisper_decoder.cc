@@ -232,6 +232,13 @@ Status WhisperDecoderSubgraph::CreateInitialFeeds(
       // past key/value for cross attention does not need to be initialized with max_seq_len since they are static.
       bool use_max_seq_len = (j - first_past_input_index_) <= 2 * static_cast<size_t>(num_layers);
 
+      // The cross attention cache is the same for all beams of a batch entry and never updated, so it can be fed
+      // once per batch entry. Attention in the decoder broadcasts it over the beams.
+      if (!use_max_seq_len && share_cross_attention_cache_) {
+        decoder_feeds.push_back(encoder_fetches[j]);
+        continue;
+      }
+
       OrtValue expanded_cache;
       if (is_output_float16_) {
         ORT_RETURN_IF_ERROR(expand_buffer_float16_func(stream,
@@ -19,6 +19,11 @@ class WhisperDecoderSubgraph : public T5DecoderSubgraph {
       const std::string& attribute_name,
       const GraphViewer& subgraph_in) : T5DecoderSubgraph(node_in, attribute_name, subgraph_in) {
     first_past_input_index_ = 1;
+
+    const auto& attributes = node_in.GetAttributes();
+    if (attributes.find("share_cross_attention_cache") != attributes.end()) {
+      share_cross_attention_cache_ = (attributes.at("share_cross_attention_cache").i() != 0LL);
+    }
   }
 
   // Create inputs for first inference of decoder subgraph.
@@ -51,6 +56,9 @@ class WhisperDecoderSubgraph : public T5DecoderSubgraph {
       first_past_input_index_ = 2;
     }
   }
+
+  // Cross attention past key/value from the encoder is fed with batch_size instead of batch_size * num_beams.
+  bool share_cross_attention_cache_ = false;
 };
 
 }  // namespace transformers
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "matmul_all_reduce.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+#include "contrib_ops/cuda/bert/transformer_cuda_common.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#if defined(ORT_USE_NCCL)
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      MatMulAllReduce,                                            \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      (*KernelDefBuilder::Create())                               \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      MatMulAllReduce<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+MatMulAllReduce<T>::MatMulAllReduce(const OpKernelInfo& info) : NcclKernel(info) {
+  num_chunks_ = info.GetAttrOrDefault<int64_t>("num_chunks", 4);
+  ORT_ENFORCE(num_chunks_ >= 1, "num_chunks must be positive, got ", num_chunks_);
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&comm_stream_, cudaStreamNonBlocking));
+}
+
+template <typename T>
+MatMulAllReduce<T>::~MatMulAllReduce() {
+  if (comm_stream_ != nullptr) {
+    (void)cudaStreamDestroy(comm_stream_);
+  }
+}
+
+template <typename T>
+Status MatMulAllReduce<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  const Tensor* A = context->Input<Tensor>(0);
+  const Tensor* B = context->Input<Tensor>(1);
+  const auto& a_shape = A->Shape();
+  const auto& b_shape = B->Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() >= 2 && b_shape.NumDimensions() == 2,
+                    "MatMulAllReduce expects A with at least 2 dimensions and a 2D B, got ", a_shape, " and ",
+                    b_shape);
+  const int64_t K = a_shape[a_shape.NumDimensions() - 1];
+  ORT_RETURN_IF_NOT(b_shape[0] == K, "The last dimension of A must be equal to the first dimension of B, got ",
+                    K, " and ", b_shape[0]);
+  const int64_t N = b_shape[1];
+  const int64_t M = a_shape.SizeToDimension(a_shape.NumDimensions() - 1);
+
+  TensorShapeVector y_dims = a_shape.AsShapeVector();
+  y_dims.back() = N;
+  Tensor* Y = context->Output(0, y_dims);
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  const CudaT alpha = ToCudaType<T>::FromFloat(1.0f);
+  const CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+  const CudaT* a_data = reinterpret_cast<const CudaT*>(A->Data<T>());
+  const CudaT* b_data = reinterpret_cast<const CudaT*>(B->Data<T>());
+  CudaT* y_data = reinterpret_cast<CudaT*>(Y->MutableData<T>());
+
+  cudaStream_t compute_stream = Stream(context);
+  const ncclDataType_t dtype = GetNcclDataType(A->DataType());
+  const int64_t num_chunks = std::min(num_chunks_, M);
+  const int64_t chunk_rows = (M + num_chunks - 1) / num_chunks;
+
+  // One event per chunk for the comm stream to wait for its GEMM, and one for the compute stream to wait for the
+  // last all-reduce.
+  std::vector<AutoDestoryCudaEvent> events(static_cast<size_t>(num_chunks) + 1);
+  for (auto& event : events) {
+    CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&event.Get(), cudaEventDisableTiming));
+  }
+
+  for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+    const int64_t row_begin = chunk * chunk_rows;
+    const int64_t rows = std::min(chunk_rows, M - row_begin);
+    if (rows <= 0) {
+      break;
+    }
+
+    // Row major Y = A * B is computed as column major Y^T = B^T * A^T.
+    CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+        GetCublasHandle(context), CUBLAS_OP_N, CUBLAS_OP_N,
+        static_cast<int>(N), static_cast<int>(rows), static_cast<int>(K),
+        &alpha, b_data, static_cast<int>(N), a_data + row_begin * K, static_cast<int>(K),
+        &zero, y_data + row_begin * N, static_cast<int>(N), GetDeviceProp(), UseTF32()));
+
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(events[static_cast<size_t>(chunk)].Get(), compute_stream));
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(comm_stream_, events[static_cast<size_t>(chunk)].Get(), 0));
+    NCCL_RETURN_IF_ERROR(ncclAllReduce(y_data + row_begin * N, y_data + row_begin * N, rows * N, dtype, ncclSum,
+                                       Comm(), comm_stream_));
+  }
+
+  // The consumers of Y run on the compute stream.
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(events.back().Get(), comm_stream_));
+  CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(compute_stream, events.back().Get(), 0));
+  return Status::OK();
+}
+
+#endif
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
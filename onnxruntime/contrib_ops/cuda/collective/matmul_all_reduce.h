@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "nccl_kernels.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#if defined(ORT_USE_NCCL)
+
+// Row parallel MatMul of tensor parallel layers (the output projection of the attention and the down projection
+// of the MLP): every rank multiplies its shard of the K dimension and the partial results are summed with an
+// all-reduce. The rows are split into chunks, the all-reduce of a chunk runs on a communication stream while the
+// GEMM of the next chunk runs on the compute stream.
+template <typename T>
+class MatMulAllReduce final : public NcclKernel {
+ public:
+  explicit MatMulAllReduce(const OpKernelInfo& info);
+  ~MatMulAllReduce();
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  int64_t num_chunks_;
+  cudaStream_t comm_stream_ = nullptr;
+};
+
+#endif
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
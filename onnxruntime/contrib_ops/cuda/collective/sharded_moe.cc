@@ -105,7 +105,8 @@ Status ShardedMoE<T>::ComputeInternal(OpKernelContext* context) const {
                             ? nullptr
                             : reinterpret_cast<const CudaT*>(fc1_experts_bias_optional->template Data<T>()),
                         activation_type_, reinterpret_cast<const CudaT*>(fc2_experts_weights->template Data<T>()),
-                        std::move(fc2_scales_ptr), static_cast<int>(moe_params.num_rows),
+                        std::move(fc2_scales_ptr), nullptr /*fc3_expert_weights*/, nullptr /*fc3_scales*/,
+                        nullptr /*fc3_expert_biases*/, static_cast<int>(moe_params.num_rows),
                         static_cast<int>(moe_params.hidden_size),
                         static_cast<int>(moe_params.inter_size), static_cast<int>(moe_params.num_experts),
                         static_cast<int>(moe_params.local_num_experts), static_cast<int>(local_experts_start_index_),
@@ -441,6 +441,45 @@ void topk_gating_softmax_kernelLauncher(const T* input, const bool* finished, T*
   }
 }
 
+// Renormalizes the top-k routing weights of each row so that they sum up to 1.
+template <typename T>
+__global__ void normalize_routing_weights_kernel(T* expert_scales, int num_rows, int k) {
+  const int row = blockIdx.x * blockDim.x + threadIdx.x;
+  if (row >= num_rows) return;
+
+  T* row_scales = expert_scales + row * k;
+  float sum = 0.f;
+  for (int i = 0; i < k; ++i) {
+    sum += static_cast<float>(row_scales[i]);
+  }
+  for (int i = 0; i < k; ++i) {
+    row_scales[i] = static_cast<T>(static_cast<float>(row_scales[i]) / sum);
+  }
+}
+
+template <typename T>
+void normalize_routing_weights_kernelLauncher(T* expert_scales, int num_rows, int k, cudaStream_t stream) {
+  const int threads = std::min(1024, num_rows);
+  const int blocks = (num_rows + threads - 1) / threads;
+  normalize_routing_weights_kernel<T><<<blocks, threads, 0, stream>>>(expert_scales, num_rows, k);
+}
+
+// Multiplies the activated fc1 output by the fc3 output of the gated experts.
+template <typename T>
+__global__ void elementwise_mul_kernel(T* output, const T* input, int64_t num_elements) {
+  const int64_t index = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (index < num_elements) {
+    output[index] = static_cast<T>(static_cast<float>(output[index]) * static_cast<float>(input[index]));
+  }
+}
+
+template <typename T>
+void elementwise_mul_kernelLauncher(T* output, const T* input, int64_t num_elements, cudaStream_t stream) {
+  static constexpr int threads = 256;
+  const int blocks = static_cast<int>((num_elements + threads - 1) / threads);
+  elementwise_mul_kernel<T><<<blocks, threads, 0, stream>>>(output, input, num_elements);
+}
+
 // ========================== CUB Sorting things ====================================
 CubKeyValueSorter::CubKeyValueSorter() : num_experts_(0), num_bits_(sizeof(int) * 8) {}
 
@@ -521,7 +560,9 @@ __global__ void dispatch_activations_kernel(int64_t* total_rows_before_expert, i
 }
 
 template <typename T, typename WeightType, typename Enable>
-CutlassMoeFCRunner<T, WeightType, Enable>::CutlassMoeFCRunner(int sm_version) {
+CutlassMoeFCRunner<T, WeightType, Enable>::CutlassMoeFCRunner(int sm_version, bool has_fc3,
+                                                              bool normalize_routing_weights)
+    : has_fc3_(has_fc3), normalize_routing_weights_(normalize_routing_weights) {
   total_past_rows_ = 0;
   total_covered_rows_ = 0;
   moe_gemm_runner_.initialize(sm_version);
@@ -548,6 +589,9 @@ size_t CutlassMoeFCRunner<T, WeightType, Enable>::getWorkspaceSize(int num_rows,
   total_ws_bytes += buf_size * sizeof(T);                    // permuted_data
   total_ws_bytes += padded_experts * sizeof(int64_t);        // Hold total_rows_before_expert_
   total_ws_bytes += num_softmax_outs * sizeof(T);
+  if (has_fc3_) {
+    total_ws_bytes += interbuf_size * sizeof(T);  // fc3 output
+  }
   const int bytes_for_fc1_result = interbuf_size * sizeof(T);
   const int sorter_ws_size_bytes = static_cast<int>(pad_to_multiple_of_16(sorter_.getWorkspaceSize(num_rows)));
   sorter_.update_num_experts(num_experts);
@@ -578,7 +622,8 @@ void CutlassMoeFCRunner<T, WeightType, Enable>::configure_ws_ptrs(char* ws_ptr,
 
   total_rows_before_expert_ = (int64_t*)(permuted_data_ + buf_size);
 
-  fc1_result_ = (T*)(total_rows_before_expert_ + padded_experts);
+  fc3_result_ = (T*)(total_rows_before_expert_ + padded_experts);
+  fc1_result_ = has_fc3_ ? fc3_result_ + interbuf_size : fc3_result_;
 
   const bool is_pow_2 = (num_experts != 0) && ((num_experts & (num_experts - 1)) == 0);
   if (!is_pow_2 || num_experts > 256) {
@@ -592,7 +637,8 @@ template <typename T, typename WeightType, typename Enable>
 void CutlassMoeFCRunner<T, WeightType, Enable>::run_moe_fc(
     const T* input_activations, const T* gating_output, const WeightType* fc1_expert_weights, const T* fc1_scales,
     const T* fc1_expert_biases, ActivationType fc1_activation_type, const WeightType* fc2_expert_weights,
-    const T* fc2_scales, int num_rows, const int hidden_size, const int inter_size, int num_experts,
+    const T* fc2_scales, const WeightType* fc3_expert_weights, const T* fc3_scales, const T* fc3_expert_biases,
+    int num_rows, const int hidden_size, const int inter_size, int num_experts,
     int local_num_experts, int local_experts_start_index, int k, char* workspace_ptr, T* fc2_result,
     const bool* finished, int active_rows, T* expert_scales, int* expanded_source_row_to_expanded_dest_row,
     int* expert_for_source_row, cudaStream_t stream) {
@@ -613,9 +659,16 @@ void CutlassMoeFCRunner<T, WeightType, Enable>::run_moe_fc(
     }
   }
 
+  if (has_fc3_ != (fc3_expert_weights != nullptr)) {
+    ORT_THROW("[FT Error][Run MoE FC] The runner and the fc3 weights disagree on the gated experts");
+  }
+
   configure_ws_ptrs(workspace_ptr, num_rows, hidden_size, inter_size, num_experts, k);
   topk_gating_softmax_kernelLauncher<T>(gating_output, finished, expert_scales, softmax_out_, expert_for_source_row,
                                         source_rows_, num_rows, num_experts, k, stream);
+  if (normalize_routing_weights_ && k > 1) {
+    normalize_routing_weights_kernelLauncher(expert_scales, num_rows, k, stream);
+  }
 
   const int sorter_ws_size_bytes = static_cast<int>(pad_to_multiple_of_16(sorter_.getWorkspaceSize(k * num_rows)));
   sorter_.run((void*)fc1_result_, sorter_ws_size_bytes, expert_for_source_row, permuted_experts_, source_rows_,
@@ -641,6 +694,18 @@ void CutlassMoeFCRunner<T, WeightType, Enable>::run_moe_fc(
                                      expanded_active_expert_rows, inter_size, hidden_size,
                                      local_num_experts, fc1_activation_type, stream);
 
+  if (has_fc3_) {
+    moe_gemm_runner_.moe_gemm_bias_act(permuted_data_ + total_past_rows_ * hidden_size,
+                                       fc3_expert_weights, fc3_scales, fc3_expert_biases,
+                                       fc3_result_ + total_past_rows_ * inter_size,
+                                       total_rows_before_expert_ + local_experts_start_index,
+                                       expanded_active_expert_rows, inter_size, hidden_size,
+                                       local_num_experts, ActivationType::Identity, stream);
+    elementwise_mul_kernelLauncher(fc1_result_ + total_past_rows_ * inter_size,
+                                   fc3_result_ + total_past_rows_ * inter_size,
+                                   static_cast<int64_t>(expanded_active_expert_rows) * inter_size, stream);
+  }
+
   moe_gemm_runner_.moe_gemm(fc1_result_ + total_past_rows_ * inter_size,
                             fc2_expert_weights, fc2_scales,
                             fc2_result + total_past_rows_ * hidden_size,
@@ -652,11 +717,12 @@ template <typename T, typename WeightType, typename Enable>
 void CutlassMoeFCRunner<T, WeightType, Enable>::run_moe_fc(
     const T* input_activations, const T* gating_output, const WeightType* fc1_expert_weights, const T* fc1_scales,
     const T* fc1_expert_biases, ActivationType fc1_activation_type, const WeightType* fc2_expert_weights,
-    const T* fc2_scales, int num_rows, const int hidden_size, const int inter_size, int num_experts,
+    const T* fc2_scales, const WeightType* fc3_expert_weights, const T* fc3_scales, const T* fc3_expert_biases,
+    int num_rows, const int hidden_size, const int inter_size, int num_experts,
     int local_num_experts, int local_experts_start_index, int k, char* workspace_ptr, T* fc2_result, T* expert_scales,
     int* expanded_source_row_to_expanded_dest_row, int* expert_for_source_row, cudaStream_t stream) {
   run_moe_fc(input_activations, gating_output, fc1_expert_weights, fc1_scales, fc1_expert_biases, fc1_activation_type,
-             fc2_expert_weights, fc2_scales, num_rows, hidden_size, inter_size, num_experts, local_num_experts,
+             fc2_expert_weights, fc2_scales, fc3_expert_weights, fc3_scales, fc3_expert_biases, num_rows, hidden_size, inter_size, num_experts, local_num_experts,
              local_experts_start_index, k, workspace_ptr, fc2_result, nullptr, num_rows, expert_scales,
              expanded_source_row_to_expanded_dest_row, expert_for_source_row, stream);
 }
@@ -226,6 +226,103 @@ template Status Dequantize4Bits<half, half>(
     int n,
     int block_size,
     cudaStream_t stream);
+
+// Each thread dequantizes 4 consecutive elements of a block, i.e. one 32-bit word of quant_data.
+template <class T, typename ZeroT = uint8_t>
+__global__ void Dequantize8BitsKernel(
+    T* output,
+    const uint8_t* quant_data,
+    const T* scale_data,
+    const ZeroT* zero_points,
+    int block_size,
+    CUDA_LONG thread_count) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, thread_count);
+  const CUDA_LONG element_offset = id * 4;
+  const CUDA_LONG block_id = element_offset / block_size;
+  const uint32_t quant_value = *(reinterpret_cast<const uint32_t*>(quant_data + element_offset));
+  const float scale = static_cast<float>(scale_data[block_id]);
+  float zero_point = 128.f;
+  if (zero_points) {
+    // uint8_t zero points of 8 bits are not packed, so both types have the shape of the scales.
+    zero_point = static_cast<float>(zero_points[block_id]);
+  }
+
+  output += element_offset;
+#pragma unroll
+  for (int i = 0; i < 4; i++) {
+    output[i] = T(scale * (static_cast<float>((quant_value >> (8 * i)) & 0xFF) - zero_point));
+  }
+}
+
+template <class T, typename ZeroT>
+Status Dequantize8Bits(
+    T* output,
+    const uint8_t* quant_data,
+    const T* scales_data,
+    const ZeroT* zero_points,  // shape: [N, block_per_K]
+    int k,
+    int n,
+    int block_size,
+    cudaStream_t stream) {
+  // k is padded and equal to block_per_K * block_size
+  ORT_ENFORCE(k % block_size == 0, "k must be a multiplier of block_size");
+  const CUDA_LONG thread_count = static_cast<CUDA_LONG>(n) * k / 4;
+  if (thread_count == 0) {
+    return Status::OK();
+  }
+
+  const int blocks_per_grid = static_cast<int>(CeilDiv(thread_count, GridDim::maxThreadsPerBlock));
+  Dequantize8BitsKernel<T, ZeroT><<<blocks_per_grid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      output,
+      quant_data,
+      scales_data,
+      zero_points,
+      block_size,
+      thread_count);
+
+  return CUDA_CALL(cudaGetLastError());
+}
+
+template Status Dequantize8Bits<float, uint8_t>(
+    float* output,
+    const uint8_t* quant_data,
+    const float* scales_data,
+    const uint8_t* zero_points,
+    int k,
+    int n,
+    int block_size,
+    cudaStream_t stream);
+
+template Status Dequantize8Bits<half, uint8_t>(
+    half* output,
+    const uint8_t* quant_data,
+    const half* scales_data,
+    const uint8_t* zero_points,
+    int k,
+    int n,
+    int block_size,
+    cudaStream_t stream);
+
+template Status Dequantize8Bits<float, float>(
+    float* output,
+    const uint8_t* quant_data,
+    const float* scales_data,
+    const float* zero_points,
+    int k,
+    int n,
+    int block_size,
+    cudaStream_t stream);
+
+template Status Dequantize8Bits<half, half>(
+    half* output,
+    const uint8_t* quant_data,
+    const half* scales_data,
+    const half* zero_points,
+    int k,
+    int n,
+    int block_size,
+    cudaStream_t stream);
+
 ///////////////////////////////////////////////////////////////////////////////
 // A more general block-wise dequantization implementation that supports
 // different block sizes and block orientations (row-wise/column-wise).
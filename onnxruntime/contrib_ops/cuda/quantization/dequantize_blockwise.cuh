@@ -19,6 +19,18 @@ Status Dequantize4Bits(
     int block_size,
     cudaStream_t stream);
 
+// Dequantizes B of MatMulNBits with 8 bits to a [n, k] matrix. k is padded to a multiple of block_size.
+template <class T, typename ZeroT>
+Status Dequantize8Bits(
+    T* output,
+    const uint8_t* quant_data,
+    const T* scales_data,
+    const ZeroT* zero_points,
+    int k,
+    int n,
+    int block_size,
+    cudaStream_t stream);
+
 /**
  * @brief Dequantize a block-wise quantized matrix, and store the result in a
  *        column major matrix for use in subsequent GEMM. This implementation supports
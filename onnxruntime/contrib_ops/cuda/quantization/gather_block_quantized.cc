@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/safeint.h"
+#include "core/providers/cuda/cuda_kernel.h"
+#include "gather_block_quantized.cuh"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+using namespace onnxruntime::cuda;
+
+template <typename T>
+class GatherBlockQuantized final : public CudaKernel {
+ public:
+  GatherBlockQuantized(const OpKernelInfo& info) : CudaKernel(info) {
+    ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("K", &K_));
+    ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("block_size", &block_size_));
+    bits_ = info.GetAttrOrDefault<int64_t>("bits", 4);
+    ORT_ENFORCE(bits_ == 4 || bits_ == 8, "Only 4b and 8b quantization is supported for GatherBlockQuantized op.");
+    ORT_ENFORCE(K_ > 0 && block_size_ >= 16 && ((block_size_ - 1) & block_size_) == 0,
+                "K must be positive and block_size a power of 2 not smaller than 16.");
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  int64_t K_;
+  int64_t bits_;
+  int64_t block_size_;
+};
+
+template <typename T>
+Status GatherBlockQuantized<T>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* data = ctx->Input<Tensor>(0);
+  const Tensor* indices = ctx->Input<Tensor>(1);
+  const Tensor* scales = ctx->Input<Tensor>(2);
+  const Tensor* zero_points = ctx->Input<Tensor>(3);
+
+  const int64_t blocks_per_row = (K_ + block_size_ - 1) / block_size_;
+  const int64_t row_bytes = blocks_per_row * (block_size_ * bits_ / 8);
+  const int64_t zero_point_row_bytes = (blocks_per_row * bits_ + 7) / 8;
+
+  const TensorShape& data_shape = data->Shape();
+  ORT_RETURN_IF_NOT(data_shape.NumDimensions() >= 1, "GatherBlockQuantized: data must have a row dimension.");
+  const int64_t N = data_shape[0];
+  ORT_RETURN_IF_NOT(data_shape.Size() == SafeInt<int64_t>(N) * row_bytes,
+                    "GatherBlockQuantized: data of shape ", data_shape, " does not hold ", N, " rows of ",
+                    row_bytes, " bytes.");
+  ORT_RETURN_IF_NOT(scales->Shape().Size() == SafeInt<int64_t>(N) * blocks_per_row,
+                    "GatherBlockQuantized: scales must have ", N * blocks_per_row, " elements.");
+  ORT_RETURN_IF_NOT(zero_points == nullptr || zero_points->Shape().Size() == SafeInt<int64_t>(N) * zero_point_row_bytes,
+                    "GatherBlockQuantized: zero_points must have ", N * zero_point_row_bytes, " elements.");
+
+  TensorShapeVector output_dims = indices->Shape().AsShapeVector();
+  output_dims.push_back(K_);
+  Tensor* Y = ctx->Output(0, TensorShape(output_dims));
+  if (Y->Shape().Size() == 0) return Status::OK();
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  return LaunchGatherBlockQuantized<CudaT>(
+      reinterpret_cast<CudaT*>(Y->MutableData<T>()),
+      data->Data<uint8_t>(),
+      reinterpret_cast<const CudaT*>(scales->Data<T>()),
+      zero_points == nullptr ? nullptr : zero_points->Data<uint8_t>(),
+      indices->DataRaw(),
+      indices->DataType()->Size(),
+      indices->Shape().Size(),
+      N,
+      SafeInt<int>(K_),
+      SafeInt<int>(bits_),
+      SafeInt<int>(block_size_),
+      Stream(ctx));
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GatherBlockQuantized,
+    kMSDomain,
+    1,
+    float,
+    kCudaExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    GatherBlockQuantized<float>);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GatherBlockQuantized,
+    kMSDomain,
+    1,
+    MLFloat16,
+    kCudaExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    GatherBlockQuantized<MLFloat16>);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
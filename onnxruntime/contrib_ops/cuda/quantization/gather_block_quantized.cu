@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include <cuda_fp16.h>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cuda_common.h"
+#include "gather_block_quantized.cuh"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Each thread dequantizes 8 consecutive elements of a row, which share a block since block_size is at least 16.
+constexpr int kElementsPerThread = 8;
+
+template <class T>
+__global__ void GatherBlockQuantizedKernel(
+    T* output,
+    const uint8_t* data,
+    const T* scales,
+    const uint8_t* zero_points,
+    const void* indices,
+    size_t index_element_size,
+    int64_t n,
+    int k,
+    int bits,
+    int block_size,
+    int threads_per_row,
+    CUDA_LONG thread_count) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, thread_count);
+  const int64_t i = id / threads_per_row;
+  const int k_start = (id % threads_per_row) * kElementsPerThread;
+  const int k_end = min(k, k_start + kElementsPerThread);
+  T* y = output + i * k;
+
+  int64_t row = index_element_size == sizeof(int32_t)
+                    ? static_cast<int64_t>(reinterpret_cast<const int32_t*>(indices)[i])
+                    : reinterpret_cast<const int64_t*>(indices)[i];
+  row = row < 0 ? row + n : row;
+  if (row < 0 || row >= n) {
+    for (int kk = k_start; kk < k_end; kk++) {
+      y[kk] = T(0.0f);
+    }
+    return;
+  }
+
+  const int blocks_per_row = (k + block_size - 1) / block_size;
+  const int row_bytes = blocks_per_row * (block_size * bits / 8);
+  const int zero_point_row_bytes = (blocks_per_row * bits + 7) / 8;
+  const int block = k_start / block_size;
+  const uint32_t value_mask = (1u << bits) - 1;
+
+  int zero_point = 1 << (bits - 1);
+  if (zero_points != nullptr) {
+    const int bit_offset = block * bits;
+    zero_point = (zero_points[row * zero_point_row_bytes + bit_offset / 8] >> (bit_offset % 8)) & value_mask;
+  }
+  const float scale = static_cast<float>(scales[row * blocks_per_row + block]);
+
+  const uint8_t* row_data = data + row * row_bytes;
+  for (int kk = k_start; kk < k_end; kk++) {
+    const int bit_offset = kk * bits;
+    const int value = (row_data[bit_offset / 8] >> (bit_offset % 8)) & value_mask;
+    y[kk] = T(scale * static_cast<float>(value - zero_point));
+  }
+}
+
+template <class T>
+Status LaunchGatherBlockQuantized(
+    T* output,
+    const uint8_t* data,
+    const T* scales,
+    const uint8_t* zero_points,
+    const void* indices,
+    size_t index_element_size,
+    int64_t index_count,
+    int64_t n,
+    int k,
+    int bits,
+    int block_size,
+    cudaStream_t stream) {
+  const int threads_per_row = (k + kElementsPerThread - 1) / kElementsPerThread;
+  const CUDA_LONG thread_count = static_cast<CUDA_LONG>(index_count * threads_per_row);
+  if (thread_count == 0) {
+    return Status::OK();
+  }
+
+  const int blocks_per_grid = static_cast<int>(CeilDiv(thread_count, GridDim::maxThreadsPerBlock));
+  GatherBlockQuantizedKernel<T><<<blocks_per_grid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      output, data, scales, zero_points, indices, index_element_size, n, k, bits, block_size, threads_per_row,
+      thread_count);
+  return CUDA_CALL(cudaGetLastError());
+}
+
+template Status LaunchGatherBlockQuantized<float>(
+    float* output, const uint8_t* data, const float* scales, const uint8_t* zero_points, const void* indices,
+    size_t index_element_size, int64_t index_count, int64_t n, int k, int bits, int block_size, cudaStream_t stream);
+
+template Status LaunchGatherBlockQuantized<half>(
+    half* output, const uint8_t* data, const half* scales, const uint8_t* zero_points, const void* indices,
+    size_t index_element_size, int64_t index_count, int64_t n, int k, int bits, int block_size, cudaStream_t stream);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
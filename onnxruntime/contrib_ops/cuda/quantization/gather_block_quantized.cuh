@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Gathers the rows of a table quantized blockwise with 4 or 8 bits in the layout of the B input of MatMulNBits, and
+// dequantizes them into output of shape [index_count, k]. Rows of out of range indices are set to 0.
+template <class T>
+Status LaunchGatherBlockQuantized(
+    T* output,
+    const uint8_t* data,
+    const T* scales,
+    const uint8_t* zero_points,
+    const void* indices,
+    size_t index_element_size,
+    int64_t index_count,
+    int64_t n,
+    int k,
+    int bits,
+    int block_size,
+    cudaStream_t stream);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include "core/common/status.h"
 #include "core/framework/float16.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cuda/tunable/cuda_tunable.h"
 #include "matmul_nbits.cuh"
 #include "dequantize_blockwise.cuh"
 
@@ -16,6 +17,67 @@ namespace contrib {
 namespace cuda {
 using namespace onnxruntime::cuda;
 
+namespace {
+
+template <typename T>
+struct MatMulNBitsParams : OpParams {
+  MatMulNBitsParams(CudaTuningContext* tuning_ctx, onnxruntime::Stream* stream) : OpParams(tuning_ctx, stream) {}
+
+  std::string Signature() const override {
+    return MakeString(bits, "b_", m, "_", n, "_", k, "_", block_size, "_", zero_points != nullptr ? "zp" : "nozp");
+  }
+
+  T* output;
+  const T* a_data;
+  const uint8_t* b_data_quant;
+  const T* scales_data;
+  const uint8_t* zero_points;
+  float* split_k_workspace;
+  int m;
+  int n;
+  int k;
+  int bits;
+  int block_size;
+  int shared_mem_per_block;
+  int default_k_splits;
+};
+
+// Runs the 4 or 8 bits gemv kernel with a fixed number of K splits, or the default one if k_splits is 0.
+template <typename T>
+class MatMulNBitsSplitKOp {
+ public:
+  explicit MatMulNBitsSplitKOp(int k_splits) : k_splits_(k_splits) {}
+
+  Status operator()(const MatMulNBitsParams<T>* params) const {
+    const int k_splits = k_splits_ == 0 ? params->default_k_splits : k_splits_;
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(k_splits > GetMatMul4BitsMaxKSplits(params->k),
+                                              "k_splits ", k_splits, " is too large for K=", params->k);
+    const auto try_matmul = params->bits == 8 ? TryMatMul8Bits<T> : TryMatMul4Bits<T>;
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(
+        !try_matmul(params->output, params->a_data, params->b_data_quant, params->scales_data,
+                    params->zero_points, params->m, params->n, params->k, params->block_size,
+                    params->shared_mem_per_block, k_splits, params->split_k_workspace, params->StreamHandle()),
+        "MatMulNBits does not support the input: ", params->Signature());
+    return CUDA_CALL(cudaGetLastError());
+  }
+
+ private:
+  int k_splits_;
+};
+
+template <typename T>
+class MatMulNBitsTunableOp : public TunableOp<MatMulNBitsParams<T>> {
+ public:
+  MatMulNBitsTunableOp() {
+    this->RegisterOp(MatMulNBitsSplitKOp<T>{0});
+    for (int k_splits = 1; k_splits <= kMatMul4BitsMaxKSplits; k_splits *= 2) {
+      this->RegisterOp(MatMulNBitsSplitKOp<T>{k_splits});
+    }
+  }
+};
+
+}  // namespace
+
 template <typename T>
 Status MatMulNBits<T>::ComputeInternal(OpKernelContext* ctx) const {
   const Tensor* a = ctx->Input<Tensor>(0);
@@ -43,29 +105,76 @@ Status MatMulNBits<T>::ComputeInternal(OpKernelContext* ctx) const {
   // Bail out early if the output is going to be empty
   if (Y->Shape().Size() == 0) return Status::OK();
 
-  bool is_4bit_done = (reorder_idx_data == nullptr) &&
-                      (!zero_points || !zero_points->IsDataType<T>()) &&
-                      TryMatMul4Bits(
-                          reinterpret_cast<CudaT*>(Y->MutableData<T>()),
-                          reinterpret_cast<const CudaT*>(a_data),
-                          blob_data,
-                          reinterpret_cast<const CudaT*>(scales_data),
-                          static_cast<const uint8_t*>(zero_points_data),
-                          SafeInt<int>(helper.M()),
+  const auto is_matmul_supported = nbits_ == 8 ? IsMatMul8BitsSupported<CudaT> : IsMatMul4BitsSupported<CudaT>;
+  if ((reorder_idx_data == nullptr) &&
+      (!zero_points || !zero_points->IsDataType<T>()) &&
+      is_matmul_supported(SafeInt<int>(helper.M()),
                           SafeInt<int>(helper.N()),
                           SafeInt<int>(helper.K()),
                           SafeInt<int>(block_size_),
-                          SafeInt<int>(GetDeviceProp().sharedMemPerBlock),
-                          static_cast<cudaStream_t>(ctx->GetComputeStream()->GetHandle()));
+                          zero_points != nullptr,
+                          SafeInt<int>(GetDeviceProp().sharedMemPerBlock))) {
+    MatMulNBitsParams<CudaT> params(GetTuningContext(), ctx->GetComputeStream());
+    params.output = reinterpret_cast<CudaT*>(Y->MutableData<T>());
+    params.a_data = reinterpret_cast<const CudaT*>(a_data);
+    params.b_data_quant = blob_data;
+    params.scales_data = reinterpret_cast<const CudaT*>(scales_data);
+    params.zero_points = static_cast<const uint8_t*>(zero_points_data);
+    params.m = SafeInt<int>(helper.M());
+    params.n = SafeInt<int>(helper.N());
+    params.k = SafeInt<int>(helper.K());
+    params.bits = SafeInt<int>(nbits_);
+    params.block_size = SafeInt<int>(block_size_);
+    params.shared_mem_per_block = SafeInt<int>(GetDeviceProp().sharedMemPerBlock);
+    params.default_k_splits = GetMatMul4BitsDefaultKSplits(params.m, params.n, params.k,
+                                                           GetDeviceProp().multiProcessorCount,
+                                                           GetDeviceProp().maxThreadsPerMultiProcessor);
 
-  if (is_4bit_done) {
-    return Status::OK();
+    const bool is_tunable_op_enabled = GetTuningContext()->IsTunableOpEnabled();
+    const int max_k_splits = is_tunable_op_enabled ? GetMatMul4BitsMaxKSplits(params.k) : params.default_k_splits;
+    IAllocatorUniquePtr<float> split_k_workspace;
+    if (max_k_splits > 1) {
+      split_k_workspace = GetScratchBuffer<float>(static_cast<size_t>(max_k_splits) * params.m * params.n,
+                                                  ctx->GetComputeStream());
+      params.split_k_workspace = split_k_workspace.get();
+    } else {
+      params.split_k_workspace = nullptr;
+    }
+
+    if (is_tunable_op_enabled) {
+      static MatMulNBitsTunableOp<CudaT> op;
+      return op(&params);
+    }
+    return MatMulNBitsSplitKOp<CudaT>{0}(&params);
   }
 
   int64_t K_padded = (K_ + block_size_ - 1) / block_size_ * block_size_;
   IAllocatorUniquePtr<T> b_data_ptr = GetScratchBuffer<T>(N_ * K_padded, ctx->GetComputeStream());
   auto* b_data = b_data_ptr.get();
-  if (column_wise_quant_blk_) {
+  if (nbits_ == 8) {
+    ORT_RETURN_IF(reorder_idx != nullptr, "MatMulNBits with 8 bits does not support g_idx.");
+    if ((zero_points && zero_points->IsDataType<T>())) {
+      ORT_RETURN_IF_ERROR(Dequantize8Bits(
+          reinterpret_cast<CudaT*>(b_data),
+          blob_data,
+          reinterpret_cast<const CudaT*>(scales_data),
+          (const CudaT*)zero_points_data,
+          SafeInt<int>(K_padded),
+          SafeInt<int>(N_),
+          SafeInt<int>(block_size_),
+          static_cast<cudaStream_t>(ctx->GetComputeStream()->GetHandle())));
+    } else {
+      ORT_RETURN_IF_ERROR(Dequantize8Bits(
+          reinterpret_cast<CudaT*>(b_data),
+          blob_data,
+          reinterpret_cast<const CudaT*>(scales_data),
+          (const uint8_t*)zero_points_data,
+          SafeInt<int>(K_padded),
+          SafeInt<int>(N_),
+          SafeInt<int>(block_size_),
+          static_cast<cudaStream_t>(ctx->GetComputeStream()->GetHandle())));
+    }
+  } else if (column_wise_quant_blk_) {
     if (reorder_idx) {
       ORT_ENFORCE(K_padded == reorder_idx->Shape()[0], "K_padded != g_idx->Shape()[0]");
     }
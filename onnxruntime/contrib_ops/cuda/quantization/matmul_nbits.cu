@@ -2,6 +2,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <cub/cub.cuh>
 #include <cublas_v2.h>
 #include <cuda_fp16.h>
@@ -168,17 +169,70 @@ __device__ __forceinline__ void AccumulateEightElements(uint32_t values_quant, f
   sums[7] += v7 * a_vec_1.w;
 }
 
+// Dequantizes 8 uint8 values stored in two uint32_t and accumulates their products with 8 elements of a.
+__device__ __forceinline__ void AccumulateEightElements8b(uint2 values_quant, half scale, uint8_t zp, const half* a, half* sums) {
+  uint4 vec_a = *(reinterpret_cast<const uint4*>(a));
+
+  // Placing a byte b below the exponent bits 0x64 gives the half 1024 + b, so subtracting 1024 + zp is exact.
+  constexpr uint32_t kU8ToF16MagicNum = 0x64646464;
+  half2 elements[4];
+  uint32_t* h = reinterpret_cast<uint32_t*>(elements);
+  h[0] = __byte_perm(values_quant.x, kU8ToF16MagicNum, 0x5150);
+  h[1] = __byte_perm(values_quant.x, kU8ToF16MagicNum, 0x5352);
+  h[2] = __byte_perm(values_quant.y, kU8ToF16MagicNum, 0x5150);
+  h[3] = __byte_perm(values_quant.y, kU8ToF16MagicNum, 0x5352);
+
+  const half2 scale_half2 = __half2half2(scale);
+  const half2 zp_half2 = __half2half2(__ushort2half_rn(static_cast<unsigned short>(1024 + zp)));
+
+  half2* sums_half2 = reinterpret_cast<half2*>(sums);
+  sums_half2[0] = sums_half2[0] + (elements[0] - zp_half2) * scale_half2 * (*(reinterpret_cast<half2*>(&(vec_a.x))));
+  sums_half2[1] = sums_half2[1] + (elements[1] - zp_half2) * scale_half2 * (*(reinterpret_cast<half2*>(&(vec_a.y))));
+  sums_half2[2] = sums_half2[2] + (elements[2] - zp_half2) * scale_half2 * (*(reinterpret_cast<half2*>(&(vec_a.z))));
+  sums_half2[3] = sums_half2[3] + (elements[3] - zp_half2) * scale_half2 * (*(reinterpret_cast<half2*>(&(vec_a.w))));
+}
+
+__device__ __forceinline__ void AccumulateEightElements8b(uint2 values_quant, float scale, uint8_t zp, const float* a, float* sums) {
+  float4 a_vec_0 = *(reinterpret_cast<const float4*>(a));
+  float4 a_vec_1 = *(reinterpret_cast<const float4*>(a + 4));
+
+  float zp_adjust = -scale * zp;
+  float v0 = float(values_quant.x & 0xFF) * scale + zp_adjust;
+  float v1 = float((values_quant.x >> 8) & 0xFF) * scale + zp_adjust;
+  float v2 = float((values_quant.x >> 16) & 0xFF) * scale + zp_adjust;
+  float v3 = float((values_quant.x >> 24) & 0xFF) * scale + zp_adjust;
+  float v4 = float(values_quant.y & 0xFF) * scale + zp_adjust;
+  float v5 = float((values_quant.y >> 8) & 0xFF) * scale + zp_adjust;
+  float v6 = float((values_quant.y >> 16) & 0xFF) * scale + zp_adjust;
+  float v7 = float((values_quant.y >> 24) & 0xFF) * scale + zp_adjust;
+
+  sums[0] += v0 * a_vec_0.x;
+  sums[1] += v1 * a_vec_0.y;
+  sums[2] += v2 * a_vec_0.z;
+  sums[3] += v3 * a_vec_0.w;
+  sums[4] += v4 * a_vec_1.x;
+  sums[5] += v5 * a_vec_1.y;
+  sums[6] += v6 * a_vec_1.z;
+  sums[7] += v7 * a_vec_1.w;
+}
+
 constexpr int kColsPerThreadBlock = 8;
 constexpr int kWarpSize = 32;
+constexpr int kKPerIter = 256;
 
-// kernel for 4bits quantized gemv, i.e., computing A(1,K) x B(K, N)
+// kernel for 4bits quantized gemv, i.e., computing A(M,K) x B(K, N) for small M
 // B(K, N) is quantized blockwise with 4bits and stored as [N, (K + block_size - 1)/block_size, blob]
-// The thread block size is (kWarpSize, kColsPerThreadBlock) and grid size is (N/kColsPerThreadBlock, 1)
-// Each thread block computes [1, K] x [kColsPerThreadBlock, (K + block_size - 1)/block_size, blob],
-//     i.e., computing kColsPerThreadBlock per block and a warp reduce (1, K) x (K)
-template <class T, int block_size, bool has_zero_point>
+// The thread block size is (kWarpSize, kColsPerThreadBlock) and grid size is
+//     (N/kColsPerThreadBlock, (M + kRows - 1)/kRows, k_splits)
+// Each thread block computes [kRows, K/k_splits] x [kColsPerThreadBlock, (K/k_splits + block_size - 1)/block_size, blob],
+//     i.e., computing kColsPerThreadBlock per block and a warp reduce (1, K/k_splits) x (K/k_splits) for each row,
+//     so that every int4 loaded from B is reused by up to kRows rows of A.
+// With k_splits > 1 the partial sums are written to split_k_workspace [k_splits, M, N] and summed up by
+//     ReduceSplitKKernel, which keeps the GPU busy when N/kColsPerThreadBlock thread blocks are too few for a wide K.
+template <class T, int block_size, bool has_zero_point, int kRows>
 __global__ void __launch_bounds__(kWarpSize* kColsPerThreadBlock) MatMulFloatInt4Kernel(
     T* output,
+    float* split_k_workspace,
     const T* a_data,
     const uint8_t* b_data_quant,
     const T* scales_data,
@@ -186,13 +240,17 @@ __global__ void __launch_bounds__(kWarpSize* kColsPerThreadBlock) MatMulFloatInt
     int m,
     int n,
     int k,
-    int blocks_per_K) {
+    int blocks_per_K,
+    int k_per_split) {
   const int n_block_id = blockIdx.x;
-  const int m_id = blockIdx.y;
+  const int m_id = blockIdx.y * kRows;
+  const int rows = min(kRows, m - m_id);
+  const int k_begin = blockIdx.z * k_per_split;
+  const int k_end = min(k, k_begin + k_per_split);
   const int lane_id = threadIdx.x;
   const int warp_id = WarpUniform(threadIdx.y);
   const int n_id = n_block_id * kColsPerThreadBlock + warp_id;
-  constexpr int k_per_iter = 256;
+  constexpr int k_per_iter = kKPerIter;
 
   extern __shared__ char shared_buffer[];
   // load scale to shared buffer
@@ -220,28 +278,40 @@ __global__ void __launch_bounds__(kWarpSize* kColsPerThreadBlock) MatMulFloatInt
 
   b_scale_vec += warp_id * blocks_per_K;
 
-  T sums[8] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
-  int k_id = 0;
-  int t_meta_k = lane_id * 8 / block_size;
-  b_data_quant += n_id * blocks_per_K * (block_size / 2) + lane_id * 4;
-
-#define UnRollReduction(unroll_size)                                                              \
-  do {                                                                                            \
-    constexpr int kUnroll = unroll_size;                                                          \
-    constexpr int kUnrollMask = 0xffffffff & (~(kUnroll * k_per_iter - 1));                       \
-    for (; k_id < (k & kUnrollMask); k_id += kUnroll * k_per_iter) {                              \
-      _Pragma("unroll") for (int i = 0; i < kUnroll; i++) {                                       \
-        uint32_t value = *(reinterpret_cast<const uint32_t*>(b_data_quant + k_per_iter / 2 * i)); \
-        T scale = b_scale_vec[t_meta_k + k_per_iter / block_size * i];                            \
-        uint8_t zp = 8;                                                                           \
-        if constexpr (has_zero_point) {                                                           \
-          zp = b_zp_vec[t_meta_k + k_per_iter / block_size * i];                                  \
-        }                                                                                         \
-        AccumulateEightElements(value, scale, zp, a_data + k_id + i * k_per_iter, sums);          \
-      }                                                                                           \
-      b_data_quant += k_per_iter / 2 * kUnroll;                                                   \
-      t_meta_k += k_per_iter / block_size * kUnroll;                                              \
-    }                                                                                             \
+  T sums[kRows][8];
+#pragma unroll
+  for (int r = 0; r < kRows; r++) {
+#pragma unroll
+    for (int i = 0; i < 8; i++) {
+      sums[r][i] = 0.f;
+    }
+  }
+
+  // k_begin is a multiple of k_per_iter, hence of block_size.
+  int k_id = k_begin;
+  int t_meta_k = (k_begin + lane_id * 8) / block_size;
+  b_data_quant += n_id * blocks_per_K * (block_size / 2) + k_begin / 2 + lane_id * 4;
+
+#define UnRollReduction(unroll_size)                                                                    \
+  do {                                                                                                  \
+    constexpr int kUnroll = unroll_size;                                                                \
+    for (; k_id + kUnroll * k_per_iter <= k_end; k_id += kUnroll * k_per_iter) {                        \
+      _Pragma("unroll") for (int i = 0; i < kUnroll; i++) {                                             \
+        uint32_t value = *(reinterpret_cast<const uint32_t*>(b_data_quant + k_per_iter / 2 * i));       \
+        T scale = b_scale_vec[t_meta_k + k_per_iter / block_size * i];                                  \
+        uint8_t zp = 8;                                                                                 \
+        if constexpr (has_zero_point) {                                                                 \
+          zp = b_zp_vec[t_meta_k + k_per_iter / block_size * i];                                        \
+        }                                                                                               \
+        _Pragma("unroll") for (int r = 0; r < kRows; r++) {                                             \
+          if (r < rows) {                                                                               \
+            AccumulateEightElements(value, scale, zp, a_data + r * k + k_id + i * k_per_iter, sums[r]); \
+          }                                                                                             \
+        }                                                                                               \
+      }                                                                                                 \
+      b_data_quant += k_per_iter / 2 * kUnroll;                                                         \
+      t_meta_k += k_per_iter / block_size * kUnroll;                                                    \
+    }                                                                                                   \
   } while (false)
 
   UnRollReduction(16);
@@ -250,26 +320,227 @@ __global__ void __launch_bounds__(kWarpSize* kColsPerThreadBlock) MatMulFloatInt
 #undef UnRollReduction
 
   // handle reminder
-  if (k_id + lane_id * 8 < k) {
+  if (k_id + lane_id * 8 < k_end) {
     uint32_t value = *(reinterpret_cast<const uint32_t*>(b_data_quant));
     T scale = b_scale_vec[t_meta_k];
     uint8_t zp = 8;
     if constexpr (has_zero_point) {
       zp = b_zp_vec[t_meta_k];
     }
-    AccumulateEightElements(value, scale, zp, a_data + k_id, sums);
+#pragma unroll
+    for (int r = 0; r < kRows; r++) {
+      if (r < rows) {
+        AccumulateEightElements(value, scale, zp, a_data + r * k + k_id, sums[r]);
+      }
+    }
   }
 
-  float sum = (float)(sums[0] + sums[1] + sums[2] + sums[3] + sums[4] + sums[5] + sums[6] + sums[7]);
-  // warp reduction
-  for (int i = 16; i > 0; i = i / 2) {
-    sum += __shfl_down_sync(0xffffffff, sum, i);
+#pragma unroll
+  for (int r = 0; r < kRows; r++) {
+    if (r < rows) {
+      float sum = (float)(sums[r][0] + sums[r][1] + sums[r][2] + sums[r][3] +
+                          sums[r][4] + sums[r][5] + sums[r][6] + sums[r][7]);
+      // warp reduction
+      for (int i = 16; i > 0; i = i / 2) {
+        sum += __shfl_down_sync(0xffffffff, sum, i);
+      }
+
+      if (lane_id == 0) {
+        if (split_k_workspace != nullptr) {
+          split_k_workspace[(blockIdx.z * m + m_id + r) * n + n_id] = sum;
+        } else {
+          output[(m_id + r) * n + n_id] = sum;
+        }
+      }
+    }
   }
+}
+
+// kernel for 8bits quantized gemv, with the same thread block layout, K splitting and row reuse as
+// MatMulFloatInt4Kernel. B(K, N) is stored as [N, (K + block_size - 1)/block_size, block_size] bytes and the zero
+// points are not packed, i.e. they have the shape of the scales. Each lane dequantizes 8 bytes of B per iteration
+// in registers, so the dequantized B is never written to memory.
+template <class T, int block_size, bool has_zero_point, int kRows>
+__global__ void __launch_bounds__(kWarpSize* kColsPerThreadBlock) MatMulFloatInt8Kernel(
+    T* output,
+    float* split_k_workspace,
+    const T* a_data,
+    const uint8_t* b_data_quant,
+    const T* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int blocks_per_K,
+    int k_per_split) {
+  const int n_block_id = blockIdx.x;
+  const int m_id = blockIdx.y * kRows;
+  const int rows = min(kRows, m - m_id);
+  const int k_begin = blockIdx.z * k_per_split;
+  const int k_end = min(k, k_begin + k_per_split);
+  const int lane_id = threadIdx.x;
+  const int warp_id = WarpUniform(threadIdx.y);
+  const int n_id = n_block_id * kColsPerThreadBlock + warp_id;
+  constexpr int k_per_iter = kKPerIter;
 
-  if (lane_id == 0) {
-    output[m_id * n + n_id] = sum;
+  extern __shared__ char shared_buffer[];
+  // load scale to shared buffer
+  T* b_scale_vec = (T*)shared_buffer;
+  int offset = n_block_id * kColsPerThreadBlock * blocks_per_K;
+  for (int i = warp_id * kWarpSize + lane_id; i < kColsPerThreadBlock * blocks_per_K; i += kColsPerThreadBlock * kWarpSize) {
+    b_scale_vec[i] = scales_data[offset + i];
   }
-}  // namespace cuda
+
+  uint8_t* b_zp_vec;
+  (void)b_zp_vec;
+  if constexpr (has_zero_point) {
+    b_zp_vec = reinterpret_cast<uint8_t*>(b_scale_vec + kColsPerThreadBlock * blocks_per_K);
+    for (int i = warp_id * kWarpSize + lane_id; i < kColsPerThreadBlock * blocks_per_K; i += kColsPerThreadBlock * kWarpSize) {
+      b_zp_vec[i] = zero_points[offset + i];
+    }
+    b_zp_vec += warp_id * blocks_per_K;
+  }
+  __syncthreads();
+
+  a_data += m_id * k + (lane_id << 3);
+
+  b_scale_vec += warp_id * blocks_per_K;
+
+  T sums[kRows][8];
+#pragma unroll
+  for (int r = 0; r < kRows; r++) {
+#pragma unroll
+    for (int i = 0; i < 8; i++) {
+      sums[r][i] = 0.f;
+    }
+  }
+
+  // k_begin is a multiple of k_per_iter, hence of block_size.
+  int k_id = k_begin;
+  int t_meta_k = (k_begin + lane_id * 8) / block_size;
+  b_data_quant += n_id * blocks_per_K * block_size + k_begin + lane_id * 8;
+
+#define UnRollReduction(unroll_size)                                                                       \
+  do {                                                                                                     \
+    constexpr int kUnroll = unroll_size;                                                                   \
+    for (; k_id + kUnroll * k_per_iter <= k_end; k_id += kUnroll * k_per_iter) {                           \
+      _Pragma("unroll") for (int i = 0; i < kUnroll; i++) {                                                \
+        uint2 value = *(reinterpret_cast<const uint2*>(b_data_quant + k_per_iter * i));                    \
+        T scale = b_scale_vec[t_meta_k + k_per_iter / block_size * i];                                     \
+        uint8_t zp = 128;                                                                                  \
+        if constexpr (has_zero_point) {                                                                    \
+          zp = b_zp_vec[t_meta_k + k_per_iter / block_size * i];                                           \
+        }                                                                                                  \
+        _Pragma("unroll") for (int r = 0; r < kRows; r++) {                                                \
+          if (r < rows) {                                                                                  \
+            AccumulateEightElements8b(value, scale, zp, a_data + r * k + k_id + i * k_per_iter, sums[r]); \
+          }                                                                                                \
+        }                                                                                                  \
+      }                                                                                                    \
+      b_data_quant += k_per_iter * kUnroll;                                                                \
+      t_meta_k += k_per_iter / block_size * kUnroll;                                                       \
+    }                                                                                                      \
+  } while (false)
+
+  UnRollReduction(16);
+  UnRollReduction(4);
+  UnRollReduction(1);
+#undef UnRollReduction
+
+  // handle reminder
+  if (k_id + lane_id * 8 < k_end) {
+    uint2 value = *(reinterpret_cast<const uint2*>(b_data_quant));
+    T scale = b_scale_vec[t_meta_k];
+    uint8_t zp = 128;
+    if constexpr (has_zero_point) {
+      zp = b_zp_vec[t_meta_k];
+    }
+#pragma unroll
+    for (int r = 0; r < kRows; r++) {
+      if (r < rows) {
+        AccumulateEightElements8b(value, scale, zp, a_data + r * k + k_id, sums[r]);
+      }
+    }
+  }
+
+#pragma unroll
+  for (int r = 0; r < kRows; r++) {
+    if (r < rows) {
+      float sum = (float)(sums[r][0] + sums[r][1] + sums[r][2] + sums[r][3] +
+                          sums[r][4] + sums[r][5] + sums[r][6] + sums[r][7]);
+      // warp reduction
+      for (int i = 16; i > 0; i = i / 2) {
+        sum += __shfl_down_sync(0xffffffff, sum, i);
+      }
+
+      if (lane_id == 0) {
+        if (split_k_workspace != nullptr) {
+          split_k_workspace[(blockIdx.z * m + m_id + r) * n + n_id] = sum;
+        } else {
+          output[(m_id + r) * n + n_id] = sum;
+        }
+      }
+    }
+  }
+}
+
+// Sums up the partial results [k_splits, M, N] of the split-K MatMulFloatInt4Kernel or MatMulFloatInt8Kernel into the output (M, N).
+template <class T>
+__global__ void ReduceSplitKKernel(T* output, const float* split_k_workspace, int k_splits, int mn) {
+  const int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < mn) {
+    float sum = 0.f;
+    for (int s = 0; s < k_splits; s++) {
+      sum += split_k_workspace[s * mn + i];
+    }
+    output[i] = sum;
+  }
+}
+
+static int GetMatMul4BitsRowsPerBlock(int m) {
+  return m == 1 ? 1 : (m <= 4 ? 4 : 16);
+}
+
+static int GetMatMul4BitsKPerSplit(int k, int k_splits) {
+  const int k_per_split = (k + k_splits - 1) / k_splits;
+  return (k_per_split + kKPerIter - 1) / kKPerIter * kKPerIter;
+}
+
+int GetMatMul4BitsMaxKSplits(int k) {
+  return std::max(1, std::min(kMatMul4BitsMaxKSplits, k / kKPerIter));
+}
+
+int GetMatMul4BitsDefaultKSplits(int m, int n, int k, int sm_count, int max_threads_per_sm) {
+  const int rows_per_block = GetMatMul4BitsRowsPerBlock(m);
+  const int thread_blocks = n / kColsPerThreadBlock * ((m + rows_per_block - 1) / rows_per_block);
+  const int resident_thread_blocks = sm_count * (max_threads_per_sm / (kWarpSize * kColsPerThreadBlock));
+  const int max_k_splits = GetMatMul4BitsMaxKSplits(k);
+  int k_splits = 1;
+  while (k_splits * 2 <= max_k_splits && thread_blocks * k_splits < resident_thread_blocks) {
+    k_splits *= 2;
+  }
+  return k_splits;
+}
+
+template <class T>
+bool IsMatMul4BitsSupported(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block) {
+  if (n % kColsPerThreadBlock != 0 || k % 8 != 0 || m > kMatMul4BitsMaxM) {
+    return false;
+  }
+  if (block_size != 16 && block_size != 32 && block_size != 64 && block_size != 128) {
+    return false;
+  }
+  int blocks_per_K = (k + block_size - 1) / block_size;
+  int shared_mem_size = sizeof(T) * blocks_per_K * kColsPerThreadBlock +
+                        (has_zero_point ? (blocks_per_K + 1) / 2 * kColsPerThreadBlock * 2 : 0);
+  return shared_mem_size <= shared_mem_per_block;
+}
 
 template <class T>
 bool TryMatMul4Bits(
@@ -283,26 +554,45 @@ bool TryMatMul4Bits(
     int k,
     int block_size,
     int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
     cudaStream_t stream) {
-  if (n % kColsPerThreadBlock != 0 || k % 8 != 0 || m > 1) {
+  if (!IsMatMul4BitsSupported<T>(m, n, k, block_size, zero_points != nullptr, shared_mem_per_block)) {
     return false;
   }
-  dim3 blocks((n + kColsPerThreadBlock - 1) / kColsPerThreadBlock, m);
+
+  const int k_per_split = GetMatMul4BitsKPerSplit(k, std::min(k_splits, GetMatMul4BitsMaxKSplits(k)));
+  k_splits = (k + k_per_split - 1) / k_per_split;
+  if (k_splits > 1 && split_k_workspace == nullptr) {
+    return false;
+  }
+  float* workspace = k_splits > 1 ? split_k_workspace : nullptr;
+
+  const int rows_per_block = GetMatMul4BitsRowsPerBlock(m);
+  dim3 blocks(n / kColsPerThreadBlock, (m + rows_per_block - 1) / rows_per_block, k_splits);
   dim3 threads(kWarpSize, kColsPerThreadBlock);
   int blocks_per_K = (k + block_size - 1) / block_size;
   int shared_mem_size = sizeof(T) * blocks_per_K * kColsPerThreadBlock +
                         (zero_points != nullptr ? (blocks_per_K + 1) / 2 * kColsPerThreadBlock * 2 : 0);
-  if (shared_mem_size > shared_mem_per_block) {
-    return false;
+
+#define MatMulFloatInt4KernelDispatchRows(block_size, rows)                                          \
+  if (nullptr != zero_points) {                                                                      \
+    MatMulFloatInt4Kernel<T, block_size, true, rows><<<blocks, threads, shared_mem_size, stream>>>(  \
+        output, workspace, a_data, b_data_quant, scales_data, zero_points, m, n, k, blocks_per_K,    \
+        k_per_split);                                                                                \
+  } else {                                                                                           \
+    MatMulFloatInt4Kernel<T, block_size, false, rows><<<blocks, threads, shared_mem_size, stream>>>( \
+        output, workspace, a_data, b_data_quant, scales_data, zero_points, m, n, k, blocks_per_K,    \
+        k_per_split);                                                                                \
   }
 
-#define MatMulFloatInt4KernelDispatch(block_size)                                              \
-  if (nullptr != zero_points) {                                                                \
-    MatMulFloatInt4Kernel<T, block_size, true><<<blocks, threads, shared_mem_size, stream>>>(  \
-        output, a_data, b_data_quant, scales_data, zero_points, m, n, k, blocks_per_K);        \
-  } else {                                                                                     \
-    MatMulFloatInt4Kernel<T, block_size, false><<<blocks, threads, shared_mem_size, stream>>>( \
-        output, a_data, b_data_quant, scales_data, zero_points, m, n, k, blocks_per_K);        \
+#define MatMulFloatInt4KernelDispatch(block_size)      \
+  if (1 == rows_per_block) {                           \
+    MatMulFloatInt4KernelDispatchRows(block_size, 1);  \
+  } else if (4 == rows_per_block) {                    \
+    MatMulFloatInt4KernelDispatchRows(block_size, 4);  \
+  } else {                                             \
+    MatMulFloatInt4KernelDispatchRows(block_size, 16); \
   }
 
   if (16 == block_size) {
@@ -318,10 +608,132 @@ bool TryMatMul4Bits(
   }
 
 #undef MatMulFloatInt4KernelDispatch
+#undef MatMulFloatInt4KernelDispatchRows
+
+  if (k_splits > 1) {
+    constexpr int kReduceThreads = 256;
+    const int mn = m * n;
+    ReduceSplitKKernel<T><<<(mn + kReduceThreads - 1) / kReduceThreads, kReduceThreads, 0, stream>>>(
+        output, split_k_workspace, k_splits, mn);
+  }
+
+  return true;
+}
+
+template <class T>
+bool IsMatMul8BitsSupported(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block) {
+  if (n % kColsPerThreadBlock != 0 || k % 8 != 0 || m > kMatMul4BitsMaxM) {
+    return false;
+  }
+  if (block_size != 16 && block_size != 32 && block_size != 64 && block_size != 128) {
+    return false;
+  }
+  int blocks_per_K = (k + block_size - 1) / block_size;
+  int shared_mem_size = sizeof(T) * blocks_per_K * kColsPerThreadBlock +
+                        (has_zero_point ? blocks_per_K * kColsPerThreadBlock : 0);
+  return shared_mem_size <= shared_mem_per_block;
+}
+
+template <class T>
+bool TryMatMul8Bits(
+    T* output,
+    const T* a_data,
+    const uint8_t* b_data_quant,
+    const T* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
+    cudaStream_t stream) {
+  if (!IsMatMul8BitsSupported<T>(m, n, k, block_size, zero_points != nullptr, shared_mem_per_block)) {
+    return false;
+  }
+
+  const int k_per_split = GetMatMul4BitsKPerSplit(k, std::min(k_splits, GetMatMul4BitsMaxKSplits(k)));
+  k_splits = (k + k_per_split - 1) / k_per_split;
+  if (k_splits > 1 && split_k_workspace == nullptr) {
+    return false;
+  }
+  float* workspace = k_splits > 1 ? split_k_workspace : nullptr;
+
+  const int rows_per_block = GetMatMul4BitsRowsPerBlock(m);
+  dim3 blocks(n / kColsPerThreadBlock, (m + rows_per_block - 1) / rows_per_block, k_splits);
+  dim3 threads(kWarpSize, kColsPerThreadBlock);
+  int blocks_per_K = (k + block_size - 1) / block_size;
+  int shared_mem_size = sizeof(T) * blocks_per_K * kColsPerThreadBlock +
+                        (zero_points != nullptr ? blocks_per_K * kColsPerThreadBlock : 0);
+
+#define MatMulFloatInt8KernelDispatchRows(block_size, rows)                                          \
+  if (nullptr != zero_points) {                                                                      \
+    MatMulFloatInt8Kernel<T, block_size, true, rows><<<blocks, threads, shared_mem_size, stream>>>(  \
+        output, workspace, a_data, b_data_quant, scales_data, zero_points, m, n, k, blocks_per_K,    \
+        k_per_split);                                                                                \
+  } else {                                                                                           \
+    MatMulFloatInt8Kernel<T, block_size, false, rows><<<blocks, threads, shared_mem_size, stream>>>( \
+        output, workspace, a_data, b_data_quant, scales_data, zero_points, m, n, k, blocks_per_K,    \
+        k_per_split);                                                                                \
+  }
+
+#define MatMulFloatInt8KernelDispatch(block_size)      \
+  if (1 == rows_per_block) {                           \
+    MatMulFloatInt8KernelDispatchRows(block_size, 1);  \
+  } else if (4 == rows_per_block) {                    \
+    MatMulFloatInt8KernelDispatchRows(block_size, 4);  \
+  } else {                                             \
+    MatMulFloatInt8KernelDispatchRows(block_size, 16); \
+  }
+
+  if (16 == block_size) {
+    MatMulFloatInt8KernelDispatch(16);
+  } else if (32 == block_size) {
+    MatMulFloatInt8KernelDispatch(32);
+  } else if (64 == block_size) {
+    MatMulFloatInt8KernelDispatch(64);
+  } else if (128 == block_size) {
+    MatMulFloatInt8KernelDispatch(128);
+  } else {
+    ORT_THROW("block size ", block_size, " is not supported");
+  }
+
+#undef MatMulFloatInt8KernelDispatch
+#undef MatMulFloatInt8KernelDispatchRows
+
+  if (k_splits > 1) {
+    constexpr int kReduceThreads = 256;
+    const int mn = m * n;
+    ReduceSplitKKernel<T><<<(mn + kReduceThreads - 1) / kReduceThreads, kReduceThreads, 0, stream>>>(
+        output, split_k_workspace, k_splits, mn);
+  }
 
   return true;
 }
 
+template bool IsMatMul4BitsSupported<float>(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block);
+
+template bool IsMatMul4BitsSupported<half>(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block);
+
 template bool TryMatMul4Bits<float>(
     float* output,
     const float* a_data,
@@ -333,6 +745,8 @@ template bool TryMatMul4Bits<float>(
     int k,
     int block_size,
     int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
     cudaStream_t stream);
 
 template bool TryMatMul4Bits<half>(
@@ -346,6 +760,54 @@ template bool TryMatMul4Bits<half>(
     int k,
     int block_size,
     int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
+    cudaStream_t stream);
+
+template bool IsMatMul8BitsSupported<float>(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block);
+
+template bool IsMatMul8BitsSupported<half>(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block);
+
+template bool TryMatMul8Bits<float>(
+    float* output,
+    const float* a_data,
+    const uint8_t* b_data_quant,
+    const float* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
+    cudaStream_t stream);
+
+template bool TryMatMul8Bits<half>(
+    half* output,
+    const half* a_data,
+    const uint8_t* b_data_quant,
+    const half* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
     cudaStream_t stream);
 
 }  // namespace cuda
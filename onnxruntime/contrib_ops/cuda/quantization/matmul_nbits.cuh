@@ -8,6 +8,32 @@ namespace onnxruntime {
 namespace contrib {
 namespace cuda {
 
+// Largest M handled by the 4 bits gemv kernel, e.g. batched decoding or speculative verification.
+// Larger M falls back to dequantization followed by cuBLAS.
+constexpr int kMatMul4BitsMaxM = 16;
+
+// Largest number of K splits of the 4 bits gemv kernel.
+constexpr int kMatMul4BitsMaxKSplits = 16;
+
+// Largest number of K splits that is useful for K, i.e. every split gets at least one iteration of the kernel.
+int GetMatMul4BitsMaxKSplits(int k);
+
+// Number of K splits used without tuning: K is split until the thread blocks fill all the SMs once, since the
+// kernel only parallelizes over N and M otherwise, which leaves SMs idle for a narrow N and a wide K.
+int GetMatMul4BitsDefaultKSplits(int m, int n, int k, int sm_count, int max_threads_per_sm);
+
+template <class T>
+bool IsMatMul4BitsSupported(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block);
+
+// Computes A(M, K) x B(K, N) where B is quantized blockwise with 4 bits. The K dimension is split into k_splits
+// parts computed by different thread blocks, then reduced into the output. split_k_workspace needs to hold
+// k_splits * M * N floats when k_splits > 1. Returns false if the shapes are not supported.
 template <class T>
 bool TryMatMul4Bits(
     T* output,
@@ -20,6 +46,35 @@ bool TryMatMul4Bits(
     int k,
     int block_size,
     int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
+    cudaStream_t stream);
+
+template <class T>
+bool IsMatMul8BitsSupported(
+    int m,
+    int n,
+    int k,
+    int block_size,
+    bool has_zero_point,
+    int shared_mem_per_block);
+
+// Same as TryMatMul4Bits for B quantized blockwise with 8 bits. The zero points are not packed, i.e. there is one
+// uint8_t per block. It uses the same limits on M and K splits as the 4 bits kernel.
+template <class T>
+bool TryMatMul8Bits(
+    T* output,
+    const T* a_data,
+    const uint8_t* b_data_quant,
+    const T* scales_data,
+    const uint8_t* zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    int shared_mem_per_block,
+    int k_splits,
+    float* split_k_workspace,
     cudaStream_t stream);
 
 }  // namespace cuda
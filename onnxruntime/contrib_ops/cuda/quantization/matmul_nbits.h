@@ -4,7 +4,7 @@
 //
 // This module define MatMulNBits operator, it is basically
 // matmul float with right hand side being a 2-D matrix
-// pre-packed and block-compacted into int4
+// pre-packed and block-compacted into int4 or int8
 //
 #pragma once
 #include "core/common/safeint.h"
@@ -24,6 +24,7 @@ class MatMulNBits final : public CudaKernel {
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("N", &N_));
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("block_size", &block_size_));
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("bits", &nbits_));
+    ORT_ENFORCE(nbits_ == 4 || nbits_ == 8, "Only 4b and 8b quantization is supported for MatMulNBits op on CUDA.");
   }
 
   Status ComputeInternal(OpKernelContext* context) const override;
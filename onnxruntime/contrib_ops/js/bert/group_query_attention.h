@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/js/js_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace js {
+
+using onnxruntime::js::JsKernel;
+
+class GroupQueryAttention : public JsKernel {
+ public:
+  explicit GroupQueryAttention(const OpKernelInfo& info) : JsKernel(info) {
+    int64_t num_heads = 0;
+    int64_t kv_num_heads = 0;
+    ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+    ORT_ENFORCE(info.GetAttr("kv_num_heads", &kv_num_heads).IsOK() && kv_num_heads > 0 && num_heads % kv_num_heads == 0);
+    ORT_ENFORCE(info.GetAttrOrDefault<int64_t>("kv_cache_bit_width", 0) == 0,
+                "Only a KV cache of the same type as the query is supported by the JS EP.");
+    num_heads_ = static_cast<int>(num_heads);
+    kv_num_heads_ = static_cast<int>(kv_num_heads);
+    scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+    local_window_size_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1));
+    do_rotary_ = info.GetAttrOrDefault<int64_t>("do_rotary", 0) == 1;
+    rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
+
+    // The KV cache stays on the GPU: present_key/present_value may share the buffers of past_key/past_value.
+    JSEP_INIT_KERNEL_ATTRIBUTE(GroupQueryAttention, ({
+                                 "numHeads" : $1,
+                                 "kvNumHeads" : $2,
+                                 "scale" : $3,
+                                 "localWindowSize" : $4,
+                                 "doRotary" : !!$5,
+                                 "rotaryInterleaved" : !!$6,
+                               }),
+                               static_cast<int32_t>(num_heads_),
+                               static_cast<int32_t>(kv_num_heads_),
+                               static_cast<double>(scale_),
+                               static_cast<int32_t>(local_window_size_),
+                               static_cast<int32_t>(do_rotary_),
+                               static_cast<int32_t>(rotary_interleaved_));
+  }
+
+ private:
+  int num_heads_;
+  int kv_num_heads_;
+  float scale_;
+  int local_window_size_;
+  bool do_rotary_;
+  bool rotary_interleaved_;
+};
+
+}  // namespace js
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -17,7 +17,17 @@ ONNX_OPERATOR_KERNEL_EX(
     (*KernelDefBuilder::Create())
         .TypeConstraint("T", JsepSupportedFloatTypes())
         .TypeConstraint("U", JsepSupportedFloatTypes()),
-    SkipLayerNorm);
+    SkipLayerNorm<false>);
+
+ONNX_OPERATOR_KERNEL_EX(
+    SkipSimplifiedLayerNormalization,
+    kMSDomain,
+    1,
+    kJsExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", JsepSupportedFloatTypes())
+        .TypeConstraint("U", JsepSupportedFloatTypes()),
+    SkipLayerNorm<true>);
 
 }  // namespace js
 }  // namespace contrib
@@ -11,15 +11,19 @@ namespace js {
 
 using onnxruntime::js::JsKernel;
 
+// SkipSimplifiedLayerNormalization (RMS normalization without beta) when simplified is true.
+template <bool simplified>
 class SkipLayerNorm final : public JsKernel {
  public:
   SkipLayerNorm(const OpKernelInfo& op_kernel_info) : JsKernel(op_kernel_info) {
     ORT_ENFORCE(op_kernel_info.GetAttr("epsilon", &epsilon_).IsOK());
     ORT_ENFORCE(epsilon_ >= 0);
     JSEP_INIT_KERNEL_ATTRIBUTE(SkipLayerNormalization, ({
-                                 "epsilon" : $1
+                                 "epsilon" : $1,
+                                 "simplified" : !!$2
                                }),
-                               epsilon_);
+                               epsilon_,
+                               static_cast<int32_t>(simplified));
   }
 
  private:
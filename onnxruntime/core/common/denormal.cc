@@ -42,4 +42,33 @@ bool SetDenormalAsZero(bool on) {
   return false;
 }
 
+#ifdef DENORMAL_INTRINC
+// flush-to-zero and denormal-as-zero bits of MXCSR
+constexpr unsigned int kDenormalAsZeroMask = _MM_FLUSH_ZERO_MASK | _MM_DENORMALS_ZERO_MASK;
+#endif
+
+DenormalAsZeroScope::DenormalAsZeroScope(bool on) {
+#ifdef DENORMAL_INTRINC
+  if (on && CPUIDInfo::GetCPUIDInfo().HasSSE3()) {
+    const unsigned int mode = _mm_getcsr();
+    if ((mode & kDenormalAsZeroMask) != kDenormalAsZeroMask) {
+      saved_mode_ = mode;
+      restore_ = true;
+      _mm_setcsr(mode | kDenormalAsZeroMask);
+    }
+  }
+#else
+  ORT_UNUSED_PARAMETER(on);
+#endif
+}
+
+DenormalAsZeroScope::~DenormalAsZeroScope() {
+#ifdef DENORMAL_INTRINC
+  if (restore_) {
+    // only the two bits are restored, the kernel may have left exception flags that are not ours to clear
+    _mm_setcsr((_mm_getcsr() & ~kDenormalAsZeroMask) | (saved_mode_ & kDenormalAsZeroMask));
+  }
+#endif
+}
+
 }  // namespace onnxruntime
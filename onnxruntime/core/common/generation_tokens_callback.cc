@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/generation_tokens_callback.h"
+
+namespace onnxruntime {
+
+namespace {
+thread_local const GenerationTokensCallback* current_generation_tokens_callback = nullptr;
+}  // namespace
+
+const GenerationTokensCallback* GenerationTokensCallback::Current() {
+  return current_generation_tokens_callback;
+}
+
+GenerationTokensCallback::Scope::Scope(const GenerationTokensCallback* callback)
+    : previous_(current_generation_tokens_callback) {
+  current_generation_tokens_callback = callback;
+}
+
+GenerationTokensCallback::Scope::~Scope() {
+  current_generation_tokens_callback = previous_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/common/common.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+/**
+ * The callback set with OrtApi::RunOptionsSetGenerationTokensCallback, to which the BeamSearch, GreedySearch and
+ * Sampling ops push the tokens of each step of a Run, so they can be streamed to users before the generation
+ * completes.
+ *
+ * Like RunStats, the callback is current for the threads that work for the run: Run sets it for its thread, and the
+ * thread pools set it for the work they run on behalf of it.
+ */
+struct GenerationTokensCallback {
+  OrtGenerationTokensCallbackFn fn = nullptr;
+  void* user_data = nullptr;
+
+  // tokens holds the next token of each of the num_sequences sequences. beam_indices, for beam search only, holds the
+  // sequence of the previous step that each of them extends.
+  void OnTokens(const int32_t* tokens, const int32_t* beam_indices, size_t num_sequences,
+                size_t sequence_length) const {
+    fn(user_data, tokens, beam_indices, num_sequences, sequence_length);
+  }
+
+  // The callback of the run the calling thread works for, or nullptr.
+  static const GenerationTokensCallback* Current();
+
+  // Makes `callback` current for the calling thread for the lifetime of the scope.
+  class Scope {
+   public:
+    explicit Scope(const GenerationTokensCallback* callback);
+    ~Scope();
+
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Scope);
+
+   private:
+    const GenerationTokensCallback* const previous_;
+  };
+};
+
+}  // namespace onnxruntime
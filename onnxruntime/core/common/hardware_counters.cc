@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/hardware_counters.h"
+
+#include <sstream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+namespace profiling {
+
+namespace {
+
+constexpr uint64_t kCacheLineSize = 64;
+
+// the counts of a thread that exits between two reads are lost, so a difference may be negative
+uint64_t SaturatingSubtract(uint64_t a, uint64_t b) {
+  return a > b ? a - b : 0;
+}
+
+#ifdef __linux__
+// the events of a group in the order of HardwareCounterValues
+constexpr uint64_t kEvents[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+                                PERF_COUNT_HW_CACHE_MISSES};
+constexpr size_t kEventCount = sizeof(kEvents) / sizeof(kEvents[0]);
+
+int OpenCounter(uint64_t event, pid_t tid, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = event;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // user space only, which is allowed with the default perf_event_paranoid of 2
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, group_fd, 0));
+}
+
+std::vector<pid_t> GetThreadIds() {
+  std::vector<pid_t> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return tids;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      tids.push_back(static_cast<pid_t>(strtol(entry->d_name, nullptr, 10)));
+    }
+  }
+  closedir(dir);
+  return tids;
+}
+#endif
+
+}  // namespace
+
+HardwareCounterValues HardwareCounterValues::operator-(const HardwareCounterValues& other) const {
+  HardwareCounterValues result;
+  result.cycles = SaturatingSubtract(cycles, other.cycles);
+  result.instructions = SaturatingSubtract(instructions, other.instructions);
+  result.llc_references = SaturatingSubtract(llc_references, other.llc_references);
+  result.llc_misses = SaturatingSubtract(llc_misses, other.llc_misses);
+  return result;
+}
+
+std::string HardwareCounterValues::ToJson() const {
+  std::ostringstream json;
+  json << "{\"cycles\" : " << cycles
+       << ", \"instructions\" : " << instructions
+       << ", \"ipc\" : " << (cycles == 0 ? 0.0 : static_cast<double>(instructions) / static_cast<double>(cycles))
+       << ", \"llc_references\" : " << llc_references
+       << ", \"llc_misses\" : " << llc_misses
+       << ", \"llc_miss_bytes\" : " << llc_misses * kCacheLineSize << "}";
+  return json.str();
+}
+
+std::unique_ptr<HardwareCounters> HardwareCounters::Create(const logging::Logger* logger) {
+#ifdef __linux__
+  std::unique_ptr<HardwareCounters> counters{new HardwareCounters()};
+  for (const pid_t tid : GetThreadIds()) {
+    int group_fd = -1;
+    for (const uint64_t event : kEvents) {
+      const int fd = OpenCounter(event, tid, group_fd);
+      if (fd < 0) {
+        if (logger) {
+          LOGS(*logger, WARNING) << "Hardware counters are not available, perf_event_open failed with: "
+                                 << strerror(errno);
+        }
+        return nullptr;
+      }
+      counters->fds_.push_back(fd);
+      if (group_fd < 0) {
+        group_fd = fd;
+        counters->group_fds_.push_back(fd);
+      }
+    }
+  }
+  return counters;
+#else
+  if (logger) {
+    LOGS(*logger, WARNING) << "Hardware counters are only supported on Linux.";
+  }
+  return nullptr;
+#endif
+}
+
+HardwareCounters::~HardwareCounters() {
+#ifdef __linux__
+  for (const int fd : fds_) {
+    close(fd);
+  }
+#endif
+}
+
+HardwareCounterValues HardwareCounters::Read() const {
+  HardwareCounterValues values;
+#ifdef __linux__
+  // PERF_FORMAT_GROUP: the number of counters followed by their values
+  uint64_t buffer[1 + kEventCount];
+  for (const int group_fd : group_fds_) {
+    if (read(group_fd, buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != kEventCount) {
+      // the thread has exited
+      continue;
+    }
+    values.cycles += buffer[1];
+    values.instructions += buffer[2];
+    values.llc_references += buffer[3];
+    values.llc_misses += buffer[4];
+  }
+#endif
+  return values;
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
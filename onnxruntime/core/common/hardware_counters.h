@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+// Hardware event counts, or the difference of two reads.
+struct HardwareCounterValues {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  uint64_t llc_references{0};
+  uint64_t llc_misses{0};
+
+  HardwareCounterValues operator-(const HardwareCounterValues& other) const;
+
+  // Returns the counts and the derived instructions per cycle and bytes loaded from memory (the last level cache
+  // misses times the cache line size) as a JSON object.
+  std::string ToJson() const;
+};
+
+/**
+ * Counts hardware events of all the threads of the process with perf_event_open on Linux.
+ * The threads are those that exist when the counters are created, e.g. the threads of the session thread pools.
+ * The counts are process wide, so they are only attributable to a node when the nodes run one at a time.
+ */
+class HardwareCounters {
+ public:
+  // Returns nullptr if the counters are not available, e.g. on other platforms, in virtual machines without a PMU or
+  // when perf_event_paranoid does not allow the process to count its own events.
+  static std::unique_ptr<HardwareCounters> Create(const logging::Logger* logger);
+
+  ~HardwareCounters();
+
+  HardwareCounterValues Read() const;
+
+ private:
+  HardwareCounters() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HardwareCounters);
+
+  // the file descriptor of the group leader of each thread
+  std::vector<int> group_fds_;
+  // the file descriptors of all counters
+  std::vector<int> fds_;
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
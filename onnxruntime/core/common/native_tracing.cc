@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/native_tracing.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#endif
+
+namespace onnxruntime {
+namespace profiling {
+
+std::atomic<bool> NativeTracing::enabled_{false};
+
+#ifdef __linux__
+
+namespace {
+
+// longer names are truncated, the kernel limits a trace_marker write to about a page
+constexpr size_t kMaxMarkerSize = 1024;
+
+int trace_marker_fd = -1;
+pid_t trace_pid = 0;
+
+// One write per event, which the kernel records atomically with the thread that made it.
+void WriteMarker(const char* marker, int size) {
+  if (size <= 0) {
+    return;
+  }
+  ORT_IGNORE_RETURN_VALUE(write(trace_marker_fd, marker, std::min(static_cast<size_t>(size), kMaxMarkerSize - 1)));
+}
+
+}  // namespace
+
+bool NativeTracing::Enable() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    for (const char* path : {"/sys/kernel/tracing/trace_marker", "/sys/kernel/debug/tracing/trace_marker"}) {
+      trace_marker_fd = open(path, O_WRONLY | O_CLOEXEC);
+      if (trace_marker_fd >= 0) {
+        trace_pid = getpid();
+        enabled_.store(true, std::memory_order_release);
+        break;
+      }
+    }
+  });
+  return IsEnabled();
+}
+
+void NativeTracing::Begin(std::string_view name) {
+  char marker[kMaxMarkerSize];
+  WriteMarker(marker, snprintf(marker, sizeof(marker), "B|%d|%.*s", static_cast<int>(trace_pid),
+                               static_cast<int>(std::min(name.size(), kMaxMarkerSize)), name.data()));
+}
+
+void NativeTracing::End() {
+  char marker[32];
+  WriteMarker(marker, snprintf(marker, sizeof(marker), "E|%d", static_cast<int>(trace_pid)));
+}
+
+void NativeTracing::Counter(std::string_view name, int64_t value) {
+  char marker[kMaxMarkerSize];
+  WriteMarker(marker, snprintf(marker, sizeof(marker), "C|%d|%.*s|%" PRId64, static_cast<int>(trace_pid),
+                               static_cast<int>(std::min(name.size(), kMaxMarkerSize - 64)), name.data(), value));
+}
+
+#else
+
+bool NativeTracing::Enable() {
+  return false;
+}
+
+void NativeTracing::Begin(std::string_view) {}
+
+void NativeTracing::End() {}
+
+void NativeTracing::Counter(std::string_view, int64_t) {}
+
+#endif
+
+}  // namespace profiling
+}  // namespace onnxruntime
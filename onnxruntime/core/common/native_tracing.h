@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+/**
+ * Streams spans and counters to the native tracer of the platform while they happen, unlike the session profiler
+ * that keeps its events in memory until profiling ends. This puts the spans of onnxruntime on the same timeline as
+ * the traces of the rest of the process and of the system.
+ *
+ * On Linux the events are written to the ftrace trace_marker in the atrace format, which Perfetto records with the
+ * "ftrace/print" event and shows as slices of the thread that wrote them, and which trace-cmd records as well.
+ * Writing requires access to tracefs, e.g. running as root or being in the tracing group.
+ *
+ * Tracing is off until Enable() is called, which the session option session.native_tracing does, and then stays on
+ * for the process. While it is off, a span costs a relaxed load.
+ */
+class NativeTracing {
+ public:
+  // Returns false if tracing is not available, e.g. on other platforms or without access to tracefs.
+  static bool Enable();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Spans nest per thread: End() ends the innermost span of the calling thread.
+  static void Begin(std::string_view name);
+  static void End();
+
+  static void Counter(std::string_view name, int64_t value);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+// Traces a span for the lifetime of the object, if tracing is enabled when it is created.
+class NativeTraceSpan {
+ public:
+  explicit NativeTraceSpan(std::string_view name) : active_(NativeTracing::IsEnabled()) {
+    if (active_) {
+      NativeTracing::Begin(name);
+    }
+  }
+
+  ~NativeTraceSpan() {
+    if (active_) {
+      NativeTracing::End();
+    }
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NativeTraceSpan);
+
+ private:
+  const bool active_;
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -47,6 +47,9 @@ void Profiler::StartProfiling(const logging::Logger* custom_logger) {
   enabled_ = true;
   profile_with_logger_ = true;
   custom_logger_ = custom_logger;
+  if (hardware_counters_enabled_) {
+    hardware_counters_ = HardwareCounters::Create(session_logger_);
+  }
   profiling_start_time_ = std::chrono::high_resolution_clock::now();
   for (const auto& ep_profiler : ep_profilers_) {
     ep_profiler->StartProfiling(profiling_start_time_);
@@ -60,6 +63,9 @@ void Profiler::StartProfiling(const std::basic_string<T>& file_name) {
   profile_stream_.open(file_name, std::ios::out | std::ios::trunc);
 #endif
   profile_stream_file_ = ToUTF8String(file_name);
+  if (hardware_counters_enabled_) {
+    hardware_counters_ = HardwareCounters::Create(session_logger_);
+  }
   profiling_start_time_ = std::chrono::high_resolution_clock::now();
   for (const auto& ep_profiler : ep_profilers_) {
     ep_profiler->StartProfiling(profiling_start_time_);
@@ -75,12 +81,20 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
                                      const std::string& event_name,
                                      const TimePoint& start_time,
                                      const std::initializer_list<std::pair<std::string, std::string>>& event_args,
+                                     bool sync_gpu) {
+  EndTimeAndRecordEvent(category, event_name, start_time, {event_args.begin(), event_args.end()}, sync_gpu);
+}
+
+void Profiler::EndTimeAndRecordEvent(EventCategory category,
+                                     const std::string& event_name,
+                                     const TimePoint& start_time,
+                                     std::unordered_map<std::string, std::string>&& event_args,
                                      bool /*sync_gpu*/) {
   long long dur = TimeDiffMicroSeconds(start_time);
   long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
 
   EventRecord event(category, logging::GetProcessId(),
-                    logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+                    logging::GetThreadId(), event_name, ts, dur, std::move(event_args));
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
@@ -106,6 +120,7 @@ std::string Profiler::EndProfiling() {
   if (!enabled_) {
     return std::string();
   }
+  hardware_counters_.reset();
   if (profile_with_logger_) {
     profile_with_logger_ = false;
     return std::string();
@@ -129,13 +144,16 @@ std::string Profiler::EndProfiling() {
     profile_stream_ << "\"tid\" :" << rec.tid << ",";
     profile_stream_ << "\"dur\" :" << rec.dur << ",";
     profile_stream_ << "\"ts\" :" << rec.ts << ",";
-    profile_stream_ << R"("ph" : "X",)";
+    // the values of counter events are numbers
+    const bool is_counter = rec.cat == MEMORY_EVENT;
+    profile_stream_ << (is_counter ? R"("ph" : "C",)" : R"("ph" : "X",)");
     profile_stream_ << R"("name" :")" << rec.name << "\",";
     profile_stream_ << "\"args\" : {";
     bool is_first_arg = true;
     for (std::pair<std::string, std::string> event_arg : rec.args) {
       if (!is_first_arg) profile_stream_ << ",";
-      if (!event_arg.second.empty() && (event_arg.second[0] == '{' || event_arg.second[0] == '[')) {
+      if (is_counter ||
+          (!event_arg.second.empty() && (event_arg.second[0] == '{' || event_arg.second[0] == '['))) {
         profile_stream_ << "\"" << event_arg.first << "\" : " << event_arg.second << "";
       } else {
         profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
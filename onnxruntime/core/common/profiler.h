@@ -9,6 +9,7 @@
 #include <iostream>
 #include <tuple>
 
+#include "core/common/hardware_counters.h"
 #include "core/common/profiler_common.h"
 #include "core/common/logging/logging.h"
 #include "core/platform/ort_mutex.h"
@@ -80,6 +81,37 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  void EndTimeAndRecordEvent(EventCategory category,
+                             const std::string& event_name,
+                             const TimePoint& start_time,
+                             std::unordered_map<std::string, std::string>&& event_args,
+                             bool sync_gpu = false);
+
+  /*
+  Whether to count hardware events per node, see HardwareCounters. Takes effect when profiling starts.
+  */
+  void EnableHardwareCounters(bool enable) {
+    hardware_counters_enabled_ = enable;
+  }
+
+  /*
+  Return the hardware counters if they are enabled and available while profiling, nullptr otherwise.
+  */
+  const HardwareCounters* GetHardwareCounters() const {
+    return hardware_counters_.get();
+  }
+
+  /*
+  Whether to trace the memory of the session's allocators per node, see MemoryTrace.
+  */
+  void EnableMemoryTrace(bool enable) {
+    memory_trace_enabled_ = enable;
+  }
+
+  bool IsMemoryTraceEnabled() const {
+    return memory_trace_enabled_;
+  }
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -156,6 +188,10 @@ class Profiler {
 #endif
 
   std::vector<std::unique_ptr<EpProfiler>> ep_profilers_;
+
+  bool hardware_counters_enabled_{false};
+  bool memory_trace_enabled_{false};
+  std::unique_ptr<HardwareCounters> hardware_counters_;
 };
 
 }  // namespace profiling
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/run_stats.h"
+
+#include <sstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace onnxruntime {
+
+namespace {
+thread_local RunStats* current_run_stats = nullptr;
+}  // namespace
+
+void RunStats::Reset() {
+  wall_time_ns = 0;
+  cpu_time_ns = 0;
+  device_time_ns = -1;
+  kernel_time_ns = 0;
+  num_kernels = 0;
+  memcpy_bytes = 0;
+  num_memcpys = 0;
+  allocated_bytes = 0;
+  num_allocations = 0;
+  peak_bytes = 0;
+  live_bytes_ = 0;
+}
+
+void RunStats::AddDeviceTime(int64_t ns) {
+  int64_t current = device_time_ns.load(std::memory_order_relaxed);
+  while (!device_time_ns.compare_exchange_weak(current, (current < 0 ? 0 : current) + ns,
+                                               std::memory_order_relaxed)) {
+  }
+}
+
+void RunStats::AddAllocation(int64_t bytes) {
+  allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  const int64_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void RunStats::AddRelease(int64_t bytes) {
+  live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+std::string RunStats::ToJson() const {
+  std::ostringstream ss;
+  ss << "{\"wall_time_us\": " << wall_time_ns / 1000
+     << ", \"cpu_time_us\": " << cpu_time_ns / 1000;
+  if (device_time_ns >= 0) {
+    ss << ", \"device_time_us\": " << device_time_ns / 1000;
+  }
+  ss << ", \"kernel_time_us\": " << kernel_time_ns / 1000
+     << ", \"num_kernels\": " << num_kernels
+     << ", \"memcpy_bytes\": " << memcpy_bytes
+     << ", \"num_memcpys\": " << num_memcpys
+     << ", \"allocated_bytes\": " << allocated_bytes
+     << ", \"num_allocations\": " << num_allocations
+     << ", \"peak_bytes\": " << peak_bytes << "}";
+  return ss.str();
+}
+
+RunStats* RunStats::Current() {
+  return current_run_stats;
+}
+
+int64_t RunStats::ThreadCpuTimeNs() {
+#ifdef _WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+    return 0;
+  }
+  auto to_ns = [](const FILETIME& time) {
+    return ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+  };
+  return to_ns(kernel_time) + to_ns(user_time);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#else
+  return 0;
+#endif
+}
+
+RunStats::Scope::Scope(RunStats* stats, bool measure_cpu_time)
+    : previous_(current_run_stats),
+      stats_(stats),
+      // work that runs inline on a thread already working for the run is measured by the enclosing scope
+      measure_cpu_time_(stats != nullptr && measure_cpu_time && previous_ != stats) {
+  current_run_stats = stats;
+  if (measure_cpu_time_) {
+    cpu_time_begin_ns_ = ThreadCpuTimeNs();
+  }
+}
+
+RunStats::Scope::~Scope() {
+  if (measure_cpu_time_) {
+    stats_->cpu_time_ns.fetch_add(ThreadCpuTimeNs() - cpu_time_begin_ns_, std::memory_order_relaxed);
+  }
+  current_run_stats = previous_;
+}
+
+}  // namespace onnxruntime
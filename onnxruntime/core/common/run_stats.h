@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+/**
+ * The resources used by one Run, collected when RunOptions::run_stats is set, e.g. to bill or throttle the tenants
+ * of a service. Unlike the profiler, the stats are collected per run, so runs of other
+ * tenants that overlap in the same session are not counted.
+ *
+ * The stats are attributed through the thread that works for the run: Run sets them as current for its thread, and
+ * the thread pools set them for the work they run on behalf of it, so kernels, copies and allocations count towards
+ * the run wherever they execute.
+ */
+struct RunStats {
+  std::atomic<int64_t> wall_time_ns{0};
+  // CPU time of the threads while they worked for the run: the thread that called Run, and the inter-op and
+  // intra-op threads while they ran its work.
+  std::atomic<int64_t> cpu_time_ns{0};
+  // Time the devices took for the work of the run, as reported by the execution providers. -1 if none did.
+  std::atomic<int64_t> device_time_ns{-1};
+  // Sum of the time of the kernels, which exceeds the wall time when kernels run concurrently.
+  std::atomic<int64_t> kernel_time_ns{0};
+  std::atomic<int64_t> num_kernels{0};
+  // Copies between devices through the data transfers of the session, e.g. of the inputs and of Memcpy nodes.
+  std::atomic<int64_t> memcpy_bytes{0};
+  std::atomic<int64_t> num_memcpys{0};
+  // Tensor buffers allocated from the allocators of the session for the run, including the memory pattern blocks.
+  std::atomic<int64_t> allocated_bytes{0};
+  std::atomic<int64_t> num_allocations{0};
+  // Highest total of the buffers of the run alive at the same time.
+  std::atomic<int64_t> peak_bytes{0};
+
+  void Reset();
+
+  void AddDeviceTime(int64_t ns);
+
+  // Records a buffer allocated for the run, and one released.
+  void AddAllocation(int64_t bytes);
+  void AddRelease(int64_t bytes);
+
+  // The stats as a JSON object, with the times in microseconds.
+  std::string ToJson() const;
+
+  // The stats of the run the calling thread works for, or nullptr.
+  static RunStats* Current();
+
+  // CPU time of the calling thread, 0 where it is not available.
+  static int64_t ThreadCpuTimeNs();
+
+  // Makes `stats` current for the calling thread for the lifetime of the scope. With `measure_cpu_time`, the CPU
+  // time of the thread during the scope is added to them, unless they were already current.
+  class Scope {
+   public:
+    Scope(RunStats* stats, bool measure_cpu_time);
+    ~Scope();
+
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Scope);
+
+   private:
+    RunStats* const previous_;
+    RunStats* const stats_;
+    const bool measure_cpu_time_;
+    int64_t cpu_time_begin_ns_{0};
+  };
+
+ private:
+  std::atomic<int64_t> live_bytes_{0};
+};
+
+}  // namespace onnxruntime
@@ -13,13 +13,20 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <numeric>
 #include <optional>
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 #include "core/common/cpuid_info.h"
 #include "core/common/eigen_common_wrapper.h"
+#include "core/common/generation_tokens_callback.h"
+#include "core/common/native_tracing.h"
+#include "core/common/run_stats.h"
+#include "core/common/threadpool_cost_calibration.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
 #if !defined(ORT_MINIMAL_BUILD)
@@ -178,9 +185,55 @@ std::string ThreadPoolProfiler::MainThreadStat::Reset() {
        << "\": " << events_[i] << ((i == MAX_EVENT - 1) ? std::string{} : ", ");
   }
   memset(events_, 0, sizeof(uint64_t) * MAX_EVENT);
+  // Utilization is the share of the work items' time spent in the loop body. Low utilization with few blocks per
+  // work item points at shards that are too coarse, and a busy time per block in the order of microseconds at shards
+  // that are too fine.
+  double busy_us = std::accumulate(loops_.worker_busy_us.begin(), loops_.worker_busy_us.end(), 0.0);
+  ss << ", \"parallel_loops\": {\"count\": " << num_loops_
+     << ", \"iterations\": " << loops_.iterations
+     << ", \"work_items\": " << loops_.work_items
+     << ", \"blocks\": " << loops_.blocks
+     << ", \"steals\": " << loops_.steals
+     << ", \"elapsed_us\": " << loops_.elapsed_us
+     << ", \"busy_us\": " << busy_us
+     << ", \"join_wait_us\": " << loops_.join_wait_us
+     << ", \"imbalance_us\": " << loops_.imbalance_us
+     << ", \"utilization\": " << (loop_capacity_us_ > 0 ? busy_us / loop_capacity_us_ : 0.0)
+     << ", \"worker_busy_us\": [";
+  for (size_t i = 0; i < loops_.worker_busy_us.size(); ++i) {
+    ss << (i == 0 ? "" : ", ") << loops_.worker_busy_us[i];
+  }
+  ss << "]}";
+  num_loops_ = 0;
+  loops_ = {};
+  loop_capacity_us_ = 0;
   return ss.str();
 }
 
+void ThreadPoolProfiler::LogParallelLoop(const ParallelLoopStat& stat) {
+  if (enabled_) {
+    GetMainThreadStat().LogParallelLoop(stat);
+  }
+}
+
+void ThreadPoolProfiler::MainThreadStat::LogParallelLoop(const ParallelLoopStat& stat) {
+  ++num_loops_;
+  loops_.iterations += stat.iterations;
+  loops_.work_items += stat.work_items;
+  loops_.blocks += stat.blocks;
+  loops_.steals += stat.steals;
+  loops_.elapsed_us += stat.elapsed_us;
+  loops_.join_wait_us += stat.join_wait_us;
+  loops_.imbalance_us += stat.imbalance_us;
+  if (loops_.worker_busy_us.size() < stat.worker_busy_us.size()) {
+    loops_.worker_busy_us.resize(stat.worker_busy_us.size(), 0.0);
+  }
+  for (size_t i = 0; i < stat.worker_busy_us.size(); ++i) {
+    loops_.worker_busy_us[i] += stat.worker_busy_us[i];
+  }
+  loop_capacity_us_ += stat.elapsed_us * static_cast<double>(stat.work_items);
+}
+
 const char* ThreadPoolProfiler::GetEventName(ThreadPoolEvent event) {
   switch (event) {
     case DISTRIBUTION:
@@ -369,6 +422,85 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+// Times the blocks of a parallel loop while the thread pool is profiling.  Each work item updates only its own
+// slot, and the caller summarizes the slots once the work items have joined.  The caller runs work item 0.
+namespace {
+class ParallelLoopProfile {
+ public:
+  using Clock = std::chrono::high_resolution_clock;
+
+  ParallelLoopProfile(std::ptrdiff_t total, unsigned num_work_items)
+      : total_(total), start_(Clock::now()), work_items_(num_work_items) {
+  }
+
+  void StartBlock(unsigned idx) {
+    work_items_[idx].block_start = Clock::now();
+  }
+
+  void EndBlock(unsigned idx, bool stolen) {
+    WorkItem& work_item = work_items_[idx];
+    work_item.busy += Clock::now() - work_item.block_start;
+    ++work_item.blocks;
+    work_item.steals += stolen ? 1 : 0;
+  }
+
+  void EndWork(unsigned idx) {
+    work_items_[idx].end = Clock::now();
+    work_items_[idx].ran = true;
+  }
+
+  ParallelLoopStat Summarize() const {
+    const auto end = Clock::now();
+    auto to_us = [](Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
+
+    ParallelLoopStat stat;
+    stat.iterations = static_cast<uint64_t>(total_);
+    stat.elapsed_us = to_us(end - start_);
+    stat.worker_busy_us.reserve(work_items_.size());
+    std::optional<Clock::time_point> first_end, last_end;
+    for (const WorkItem& work_item : work_items_) {
+      stat.worker_busy_us.push_back(to_us(work_item.busy));
+      if (!work_item.ran) {
+        continue;
+      }
+      ++stat.work_items;
+      stat.blocks += work_item.blocks;
+      stat.steals += work_item.steals;
+      first_end = first_end ? std::min(*first_end, work_item.end) : work_item.end;
+      last_end = last_end ? std::max(*last_end, work_item.end) : work_item.end;
+    }
+    if (first_end) {
+      stat.imbalance_us = to_us(*last_end - *first_end);
+    }
+    if (!work_items_.empty() && work_items_[0].ran) {
+      stat.join_wait_us = to_us(end - work_items_[0].end);
+    }
+    return stat;
+  }
+
+ private:
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) /* Padding added to WorkItem for alignment */
+#endif
+  struct ORT_ALIGN_TO_AVOID_FALSE_SHARING WorkItem {
+    Clock::time_point block_start;
+    Clock::time_point end;
+    Clock::duration busy{0};
+    uint64_t blocks = 0;
+    uint64_t steals = 0;
+    bool ran = false;
+  };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+  const std::ptrdiff_t total_;
+  const Clock::time_point start_;
+  std::vector<WorkItem> work_items_;
+};
+}  // namespace
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
@@ -383,10 +515,17 @@ ThreadPool::ThreadPool(Env* env,
   if (degree_of_parallelism >= 2) {
     int threads_to_create = degree_of_parallelism - 1;
 
+    if (thread_options_.capacities.size() != thread_options_.affinities.size()) {
+      thread_options_.capacities.clear();
+    }
+
     if (!thread_options_.affinities.empty()) {
       // Remove first affinity element as designated for the caller thread
       thread_options_.affinities.erase(thread_options_.affinities.begin());
       assert(thread_options_.affinities.size() >= size_t(threads_to_create));
+      if (!thread_options_.capacities.empty()) {
+        thread_options_.capacities.erase(thread_options_.capacities.begin());
+      }
     }
 
     extended_eigen_threadpool_ =
@@ -401,9 +540,37 @@ ThreadPool::ThreadPool(Env* env,
 
 ThreadPool::~ThreadPool() = default;
 
+// Threads on cores with a lower capacity, such as the efficiency cores of hybrid CPUs, claim smaller blocks of
+// iterations, so that they don't delay the end of a loop by taking one of its last blocks.
+std::ptrdiff_t ThreadPool::ScaleBlockSizeToCurrentThread(std::ptrdiff_t block_size) const {
+  const auto& capacities = thread_options_.capacities;
+  const int thread_id = CurrentThreadId();
+  if (thread_id < 0 || static_cast<size_t>(thread_id) >= capacities.size()) {
+    return block_size;
+  }
+  return std::max<std::ptrdiff_t>(1, std::llround(static_cast<double>(block_size) * capacities[thread_id]));
+}
+
 // Base case for parallel loops, running iterations 0..total, divided into blocks
 // of block_size iterations, and calling into a function that takes a start..end
 // range of indices to run.
+namespace {
+thread_local const bool* current_terminate_flag = nullptr;
+
+// The terminate flag of the loop started by the calling thread, or nullptr when the loop cannot be cancelled.
+const bool* GetLoopTerminateFlag() {
+#ifdef ORT_NO_EXCEPTIONS
+  return nullptr;
+#else
+  return current_terminate_flag;
+#endif
+}
+
+bool IsTerminated(const bool* terminate_flag) {
+  return terminate_flag != nullptr && *static_cast<const volatile bool*>(terminate_flag);
+}
+}  // namespace
+
 void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
                                                      const std::ptrdiff_t block_size,
                                                      const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
@@ -420,46 +587,92 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    // DegreeOfParallelism is smaller than the pool when the calling thread set a limit.
+    auto num_threads_inc_main = std::min(NumThreads() + 1, d_of_p);
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
+    std::optional<ParallelLoopProfile> loop_profile;
+    if (underlying_threadpool_ && underlying_threadpool_->IsProfiling()) {
+      loop_profile.emplace(total, static_cast<unsigned>(num_work_items));
+    }
     LoopCounter lc(total, d_of_p, block_size);
+    const bool* terminate_flag = GetLoopTerminateFlag();
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
+      const std::ptrdiff_t my_block_size = ScaleBlockSizeToCurrentThread(block_size);
       unsigned my_home_shard = lc.GetHomeShard(idx);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
-      while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
+      while (!IsTerminated(terminate_flag) &&
+             lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, my_block_size)) {
+        if (loop_profile) {
+          loop_profile->StartBlock(idx);
+        }
         fn(static_cast<std::ptrdiff_t>(my_iter_start),
            static_cast<std::ptrdiff_t>(my_iter_end));
+        if (loop_profile) {
+          loop_profile->EndBlock(idx, my_shard != my_home_shard);
+        }
+      }
+      if (loop_profile) {
+        loop_profile->EndWork(idx);
       }
     };
     // Run the work in the thread pool (and in the current thread).  Synchronization with helping
     // threads is handled within RunInParallel, hence we can deallocate lc and other state captured by
     // run_work.
     RunInParallel(run_work, num_work_items, block_size);
+    if (loop_profile) {
+      underlying_threadpool_->LogParallelLoop(loop_profile->Summarize());
+    }
+    if (IsTerminated(terminate_flag)) {
+      ORT_THROW("Exiting due to terminate flag being set to true.");
+    }
   } else {
     int num_of_blocks = d_of_p * thread_options_.dynamic_block_base_;
     std::ptrdiff_t base_block_size = static_cast<std::ptrdiff_t>(std::max(1LL, std::llroundl(static_cast<long double>(total) / num_of_blocks)));
+    unsigned num_work_items = static_cast<unsigned>(std::min(NumThreads() + 1, num_of_blocks));
+    std::optional<ParallelLoopProfile> loop_profile;
+    if (underlying_threadpool_ && underlying_threadpool_->IsProfiling()) {
+      loop_profile.emplace(total, num_work_items);
+    }
     alignas(CACHE_LINE_BYTES) std::atomic<std::ptrdiff_t> left{total};
     LoopCounter lc(total, d_of_p, base_block_size);
+    const bool* terminate_flag = GetLoopTerminateFlag();
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
-      std::ptrdiff_t b = base_block_size;
+      std::ptrdiff_t b = ScaleBlockSizeToCurrentThread(base_block_size);
       unsigned my_home_shard = lc.GetHomeShard(idx);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
-      while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
+      while (!IsTerminated(terminate_flag) &&
+             lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
+        if (loop_profile) {
+          loop_profile->StartBlock(idx);
+        }
         fn(static_cast<std::ptrdiff_t>(my_iter_start),
            static_cast<std::ptrdiff_t>(my_iter_end));
+        if (loop_profile) {
+          loop_profile->EndBlock(idx, my_shard != my_home_shard);
+        }
         auto todo = left.fetch_sub(static_cast<std::ptrdiff_t>(my_iter_end - my_iter_start), std::memory_order_relaxed);
         if (b > 1) {
-          b = static_cast<std::ptrdiff_t>(std::max(1LL, std::llroundl(static_cast<long double>(todo) / num_of_blocks)));
+          b = ScaleBlockSizeToCurrentThread(
+              static_cast<std::ptrdiff_t>(std::max(1LL, std::llroundl(static_cast<long double>(todo) / num_of_blocks))));
         }
       }
+      if (loop_profile) {
+        loop_profile->EndWork(idx);
+      }
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, num_work_items, base_block_size);
+    if (loop_profile) {
+      underlying_threadpool_->LogParallelLoop(loop_profile->Summarize());
+    }
+    if (IsTerminated(terminate_flag)) {
+      ORT_THROW("Exiting due to terminate flag being set to true.");
+    }
   }
 }
 
@@ -472,6 +685,26 @@ void ThreadPool::SimpleParallelFor(std::ptrdiff_t total, const std::function<voi
 }
 
 void ThreadPool::Schedule(std::function<void()> fn) {
+  if (RunStats* run_stats = RunStats::Current()) {
+    // the task works for the run on the thread that runs it
+    fn = [fn = std::move(fn), run_stats]() {
+      RunStats::Scope scope(run_stats, true);
+      fn();
+    };
+  }
+  if (const GenerationTokensCallback* generation_tokens_callback = GenerationTokensCallback::Current()) {
+    // e.g. a generation operator run by the executor on an inter-op thread
+    fn = [fn = std::move(fn), generation_tokens_callback]() {
+      GenerationTokensCallback::Scope scope(generation_tokens_callback);
+      fn();
+    };
+  }
+  if (profiling::NativeTracing::IsEnabled()) {
+    fn = [fn = std::move(fn)]() {
+      profiling::NativeTraceSpan span("Task");
+      fn();
+    };
+  }
   if (underlying_threadpool_) {
     underlying_threadpool_->Schedule(std::move(fn));
   } else {
@@ -495,6 +728,10 @@ std::string ThreadPool::StopProfiling() {
 
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+thread_local int current_degree_of_parallelism_limit = 0;
+thread_local const std::atomic<int>* current_higher_priority_runs = nullptr;
+thread_local ThreadPoolCostCalibration* current_cost_calibration = nullptr;
+thread_local const std::string* current_cost_call_site = nullptr;
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
@@ -515,7 +752,60 @@ ThreadPool::ParallelSection::~ParallelSection() {
   }
 }
 
+ThreadPool::DegreeOfParallelismLimit::DegreeOfParallelismLimit(int max_degree)
+    : previous_(current_degree_of_parallelism_limit) {
+  current_degree_of_parallelism_limit = max_degree > 0 ? max_degree : 0;
+}
+
+ThreadPool::DegreeOfParallelismLimit::~DegreeOfParallelismLimit() {
+  current_degree_of_parallelism_limit = previous_;
+}
+
+ThreadPool::LowPriorityScope::LowPriorityScope(const std::atomic<int>* higher_priority_runs)
+    : previous_(current_higher_priority_runs) {
+  current_higher_priority_runs = higher_priority_runs;
+}
+
+ThreadPool::LowPriorityScope::~LowPriorityScope() {
+  current_higher_priority_runs = previous_;
+}
+
+ThreadPool::CancellationScope::CancellationScope(const bool* terminate_flag)
+    : previous_(current_terminate_flag) {
+  current_terminate_flag = terminate_flag;
+}
+
+ThreadPool::CancellationScope::~CancellationScope() {
+  current_terminate_flag = previous_;
+}
+
+ThreadPool::CostCalibrationScope::CostCalibrationScope(ThreadPoolCostCalibration* calibration,
+                                                       const std::string& call_site)
+    : previous_calibration_(current_cost_calibration), previous_call_site_(current_cost_call_site) {
+  current_cost_calibration = calibration;
+  current_cost_call_site = &call_site;
+}
+
+ThreadPool::CostCalibrationScope::~CostCalibrationScope() {
+  current_cost_calibration = previous_calibration_;
+  current_cost_call_site = previous_call_site_;
+}
+
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
+  // a span of the loop on the calling thread, and one for each work item on the thread that runs it
+  profiling::NativeTraceSpan loop_span("ParallelFor");
+  if (RunStats* run_stats = RunStats::Current()) {
+    fn = [fn = std::move(fn), run_stats](unsigned idx) {
+      RunStats::Scope scope(run_stats, true);
+      fn(idx);
+    };
+  }
+  if (profiling::NativeTracing::IsEnabled()) {
+    fn = [fn = std::move(fn)](unsigned idx) {
+      profiling::NativeTraceSpan span("ParallelForWorkItem");
+      fn(idx);
+    };
+  }
   if (underlying_threadpool_) {
     if (current_parallel_section.has_value()) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
@@ -614,16 +904,41 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
   ORT_ENFORCE(n >= 0);
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
+
+  // With a calibration, the loop is split with the measured cost of its call site and its blocks are timed.
+  ThreadPoolCostCalibration* calibration = n > 0 ? current_cost_calibration : nullptr;
+  std::atomic<int64_t> busy_ns{0};
+  std::function<void(std::ptrdiff_t, std::ptrdiff_t)> timed_f;
+  if (calibration != nullptr) {
+    const TensorOpCost calibrated = calibration->GetCost(*current_cost_call_site, n, c);
+    cost = Eigen::TensorOpCost{calibrated.bytes_loaded, calibrated.bytes_stored, calibrated.compute_cycles};
+    timed_f = [&f, &busy_ns](std::ptrdiff_t first, std::ptrdiff_t last) {
+      const auto begin = std::chrono::steady_clock::now();
+      f(first, last);
+      busy_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count(),
+                        std::memory_order_relaxed);
+    };
+  }
+  const auto& loop_fn = calibration != nullptr ? timed_f : f;
+
   auto d_of_p = DegreeOfParallelism(this);
   // Compute small problems directly in the caller thread.
   if ((!ShouldParallelizeLoop(n)) ||
       CostModel::numThreads(static_cast<double>(n), cost, d_of_p) == 1) {
-    f(0, n);
-    return;
+    loop_fn(0, n);
+  } else {
+    ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
+    ParallelForFixedBlockSizeScheduling(n, block, loop_fn);
   }
 
-  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
-  ParallelForFixedBlockSizeScheduling(n, block, f);
+  if (calibration != nullptr) {
+    const double estimated_cycles =
+        CostModel::totalCost(1, Eigen::TensorOpCost{c.bytes_loaded, c.bytes_stored, c.compute_cycles});
+    calibration->Record(*current_cost_call_site, n, c, estimated_cycles,
+                        static_cast<double>(busy_ns.load()) / static_cast<double>(n));
+  }
 }
 
 void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
@@ -639,16 +954,30 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // When not using OpenMP, we parallelise over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
+    int degree_of_parallelism = tp->NumThreads() + 1;
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
-    } else {
-      return ((tp->NumThreads() + 1));
+      degree_of_parallelism *= TaskGranularityFactor;
     }
+    if (current_higher_priority_runs != nullptr &&
+        current_higher_priority_runs->load(std::memory_order_relaxed) > 0) {
+      return 1;
+    }
+    if (current_degree_of_parallelism_limit > 0) {
+      degree_of_parallelism = std::min(degree_of_parallelism, current_degree_of_parallelism_limit);
+    }
+    return degree_of_parallelism;
   } else {
     return 1;
   }
 }
 
+int ThreadPool::CurrentNumaNode(const concurrency::ThreadPool* tp) {
+  if (tp && tp->underlying_threadpool_) {
+    return tp->underlying_threadpool_->CurrentThreadNumaNode();
+  }
+  return -1;
+}
+
 void ThreadPool::StartProfiling(concurrency::ThreadPool* tp) {
   if (tp) {
     tp->StartProfiling();
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/threadpool_cost_calibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include "core/common/hash_combine.h"
+
+namespace onnxruntime {
+namespace concurrency {
+
+namespace {
+// Weight of the latest loop in the measured time per unit once an entry has this many loops. Before that, the
+// measured time is the average of the loops.
+constexpr int64_t kAveragedSamples = 8;
+
+int SizeBucket(std::ptrdiff_t total) {
+  int bucket = 0;
+  while (total > 1) {
+    total >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+// How far the measured cost is from the estimate, in either direction.
+double Divergence(double estimated_cycles, double measured_cycles) {
+  constexpr double kMinCycles = 1e-3;
+  return std::abs(std::log(std::max(measured_cycles, kMinCycles) / std::max(estimated_cycles, kMinCycles)));
+}
+}  // namespace
+
+size_t ThreadPoolCostCalibration::KeyHash::operator()(const Key& key) const {
+  size_t seed = std::hash<std::string>{}(key.call_site);
+  HashCombine(key.size_bucket, seed);
+  HashCombine(key.bytes_loaded, seed);
+  HashCombine(key.bytes_stored, seed);
+  HashCombine(key.compute_cycles, seed);
+  return seed;
+}
+
+ThreadPoolCostCalibration::Key ThreadPoolCostCalibration::MakeKey(const std::string& call_site, std::ptrdiff_t total,
+                                                                  const TensorOpCost& estimate) {
+  return Key{call_site, SizeBucket(total), estimate.bytes_loaded, estimate.bytes_stored, estimate.compute_cycles};
+}
+
+TensorOpCost ThreadPoolCostCalibration::GetCost(const std::string& call_site, std::ptrdiff_t total,
+                                                const TensorOpCost& estimate) const {
+  const Key key = MakeKey(call_site, total, estimate);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second.samples < kMinSamples) {
+    return estimate;
+  }
+  return TensorOpCost{0, 0, it->second.nanoseconds_per_unit * kCyclesPerNanosecond};
+}
+
+void ThreadPoolCostCalibration::Record(const std::string& call_site, std::ptrdiff_t total,
+                                       const TensorOpCost& estimate, double estimated_cycles,
+                                       double nanoseconds_per_unit) {
+  Key key = MakeKey(call_site, total, estimate);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Entry& entry = entries_[std::move(key)];
+  entry.estimated_cycles = estimated_cycles;
+  entry.samples++;
+  const double weight = 1.0 / static_cast<double>(std::min(entry.samples, kAveragedSamples));
+  entry.nanoseconds_per_unit += (nanoseconds_per_unit - entry.nanoseconds_per_unit) * weight;
+}
+
+std::string ThreadPoolCostCalibration::ToJson() const {
+  std::vector<std::pair<const Key*, Entry>> entries;
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries.reserve(entries_.size());
+  for (const auto& entry : entries_) {
+    entries.emplace_back(&entry.first, entry.second);
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return Divergence(a.second.estimated_cycles, a.second.nanoseconds_per_unit * kCyclesPerNanosecond) >
+           Divergence(b.second.estimated_cycles, b.second.nanoseconds_per_unit * kCyclesPerNanosecond);
+  });
+
+  std::ostringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const Key& key = *entries[i].first;
+    const Entry& entry = entries[i].second;
+    const double measured_cycles = entry.nanoseconds_per_unit * kCyclesPerNanosecond;
+    ss << (i == 0 ? "" : ", ")
+       << "{\"call_site\": \"" << key.call_site << "\""
+       << ", \"min_size\": " << (int64_t{1} << key.size_bucket)
+       << ", \"loops\": " << entry.samples
+       << ", \"estimated_cycles_per_unit\": " << entry.estimated_cycles
+       << ", \"measured_cycles_per_unit\": " << measured_cycles
+       << ", \"measured_ns_per_unit\": " << entry.nanoseconds_per_unit << "}";
+  }
+  ss << "]";
+  return ss.str();
+}
+
+}  // namespace concurrency
+}  // namespace onnxruntime
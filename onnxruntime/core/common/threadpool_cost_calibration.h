@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace concurrency {
+
+/**
+ * Online calibration of the cost per unit that kernels estimate by hand when they call ThreadPool::TryParallelFor,
+ * enabled for the loops started from a thread with ThreadPool::CostCalibrationScope.
+ *
+ * Loops are keyed by call site, by their size rounded down to a power of 2 and by the estimated cost, so the loops
+ * of a kernel over inputs of similar sizes share an entry. ParallelFor times the blocks of each loop and records the
+ * time per unit. Once an entry has kMinSamples loops, the later loops with its key are split with the measured cost.
+ */
+class ThreadPoolCostCalibration {
+ public:
+  // Loops timed before their measured cost is used.
+  static constexpr int64_t kMinSamples = 3;
+
+  // The cost model of the thread pool counts cycles, to which the measured times are converted at a nominal 3 GHz.
+  static constexpr double kCyclesPerNanosecond = 3.0;
+
+  ThreadPoolCostCalibration() = default;
+
+  // The cost per unit to split a loop with: the measured one, or `estimate` until the key has kMinSamples loops.
+  TensorOpCost GetCost(const std::string& call_site, std::ptrdiff_t total, const TensorOpCost& estimate) const;
+
+  // Records the time per unit of a loop. estimated_cycles is `estimate` in the cycles of the cost model.
+  void Record(const std::string& call_site, std::ptrdiff_t total, const TensorOpCost& estimate,
+              double estimated_cycles, double nanoseconds_per_unit);
+
+  // The entries as a JSON array, those whose estimates diverge most from their measured costs first.
+  std::string ToJson() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolCostCalibration);
+
+ private:
+  struct Key {
+    std::string call_site;
+    int size_bucket;
+    double bytes_loaded;
+    double bytes_stored;
+    double compute_cycles;
+
+    bool operator==(const Key& other) const {
+      return size_bucket == other.size_bucket && bytes_loaded == other.bytes_loaded &&
+             bytes_stored == other.bytes_stored && compute_cycles == other.compute_cycles &&
+             call_site == other.call_site;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    double estimated_cycles = 0.0;
+    double nanoseconds_per_unit = 0.0;
+    int64_t samples = 0;
+  };
+
+  static Key MakeKey(const std::string& call_site, std::ptrdiff_t total, const TensorOpCost& estimate);
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+};
+
+}  // namespace concurrency
+}  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <queue>
 #include "core/common/exceptions.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/safeint.h"
@@ -385,9 +386,12 @@ class PlannerImpl {
             break;
           }
           const auto& may_strided_inputs = output_node_ci.kernel_def->MayStridedInput();
+          const int variadic_offset = output_node_ci.kernel_def->VariadicMayStridedInputOffset();
           for (size_t i = 0; i < it->InputDefs().size(); ++i) {
-            if (it->InputDefs()[i] == p_output_arg && std::find(may_strided_inputs.begin(), may_strided_inputs.end(),
-                                                                static_cast<int>(i)) == may_strided_inputs.end()) {
+            if (it->InputDefs()[i] == p_output_arg &&
+                !(variadic_offset >= 0 && static_cast<int>(i) >= variadic_offset) &&
+                std::find(may_strided_inputs.begin(), may_strided_inputs.end(),
+                          static_cast<int>(i)) == may_strided_inputs.end()) {
               can_strided = false;
               break;
             }
@@ -1449,7 +1453,7 @@ class PlannerImpl {
 #ifdef ENABLE_STRIDED_TENSORS
           if (is_strided_tensor) AllocPlan(current).is_strided_tensor = true;
 #else
-          ORT_ENFORCE(!is_strided_tensor, "Strided tensor is not supported in non-training build for now.");
+          ORT_ENFORCE(!is_strided_tensor, "Strided tensor is not supported in this build.");
 #endif  // ENABLE_STRIDED_TENSORS
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
           InplaceReuse(reused, current);
@@ -1789,7 +1793,10 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
+    // a partition config file takes precedence over the automatic partitioning of the CPU nodes
+    auto partitioner = partition_config_file.empty() && parent_node_ == nullptr && context_->GetMaxCpuStreams() > 1
+                           ? IGraphPartitioner::CreateCriticalPathPartitioner(logger, context_->GetMaxCpuStreams())
+                           : IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
     auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
@@ -2408,6 +2415,215 @@ void DeviceBasedPartitioner::SaveConfig() const {
   }
 }
 
+/*
+CriticalPathPartitioner spreads the CPU nodes of a graph over multiple streams so that independent branches run in
+parallel, and puts the nodes of other devices on one stream per device like DeviceBasedPartitioner.
+
+The cost of a node is estimated from the inferred shapes as the number of output elements, times the size of the
+reduction for the ops that compute a dot product per output element. The nodes are list scheduled: among the nodes
+whose inputs are ready, the one with the longest path of estimated costs to the end of the graph (the critical path)
+is placed first, on the stream where it can start the earliest. Reading an input produced on another stream adds
+kStreamSyncCost to the start time, so small branches stay on the stream of their producer.
+*/
+class CriticalPathPartitioner : public IGraphPartitioner {
+ public:
+  CriticalPathPartitioner(const logging::Logger& logger, size_t max_cpu_streams)
+      : IGraphPartitioner(logger, PathString{}), max_cpu_streams_(max_cpu_streams) {}
+
+  Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                        const ExecutionProviders& execution_providers,
+                        std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                        ExecutionOrder execution_order) override;
+
+  const char* Type() const override { return "CriticalPathPartitioner"; }
+  size_t Streams() const override { return num_streams_; }
+
+  static double EstimateCost(const Node& node);
+
+ private:
+  // estimated cost of waiting for an input produced on another stream, in output elements
+  static constexpr double kStreamSyncCost = 16384.0;
+
+  const size_t max_cpu_streams_;
+  size_t num_streams_ = 0;
+};
+
+double CriticalPathPartitioner::EstimateCost(const Node& node) {
+  auto num_elements = [](const NodeArg* arg, size_t first_dim = 0) {
+    double elements = 1.0;
+    const auto* shape = arg != nullptr && arg->Exists() ? arg->Shape() : nullptr;
+    if (shape != nullptr) {
+      for (int i = static_cast<int>(first_dim); i < shape->dim_size(); ++i) {
+        const auto& dim = shape->dim(i);
+        // symbolic dimensions are unknown until the run, count them as 1
+        if (utils::HasDimValue(dim) && dim.dim_value() > 0) {
+          elements *= static_cast<double>(dim.dim_value());
+        }
+      }
+    }
+    return elements;
+  };
+
+  double cost = 0.0;
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      cost += num_elements(output);
+    }
+  }
+  cost = std::max(cost, 1.0);
+
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+  if ((op_type == "MatMul" || op_type == "Gemm" || op_type == "FusedMatMul" || op_type == "FusedGemm" ||
+       op_type == "MatMulInteger" || op_type == "QLinearMatMul") &&
+      !inputs.empty()) {
+    // K, the last dimension of A
+    const auto* shape = inputs[0]->Shape();
+    if (shape != nullptr && shape->dim_size() > 0 && utils::HasDimValue(shape->dim(shape->dim_size() - 1))) {
+      cost *= static_cast<double>(std::max<int64_t>(shape->dim(shape->dim_size() - 1).dim_value(), 1));
+    }
+  } else if ((op_type == "Conv" || op_type == "FusedConv" || op_type == "ConvInteger" || op_type == "NhwcConv") &&
+             inputs.size() > 1) {
+    // input channels per group times the kernel size, from the weight shape {M, C/group, kH, kW}
+    cost *= num_elements(inputs[1], 1);
+  } else if (op_type == "QLinearConv" && inputs.size() > 3) {
+    cost *= num_elements(inputs[3], 1);
+  }
+
+  return cost;
+}
+
+Status CriticalPathPartitioner::PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                                               const ExecutionProviders& execution_providers,
+                                               std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                                               ExecutionOrder execution_order) {
+  const auto& node_order = graph_viewer.GetNodesInTopologicalOrder(execution_order);
+  const size_t num_node_indices = graph_viewer.MaxNodeIndex();
+
+  InlinedVector<double> costs(num_node_indices, 0.0);
+  InlinedVector<double> priorities(num_node_indices, 0.0);
+  InlinedVector<size_t> positions(num_node_indices, 0);
+  for (size_t i = 0; i < node_order.size(); ++i) {
+    const auto* node = graph_viewer.GetNode(node_order[i]);
+    costs[node_order[i]] = EstimateCost(*node);
+    positions[node_order[i]] = i;
+  }
+
+  // the priority of a node is the cost of the longest path from it to the end of the graph
+  for (auto it = node_order.rbegin(); it != node_order.rend(); ++it) {
+    const auto* node = graph_viewer.GetNode(*it);
+    double longest_downstream_path = 0.0;
+    for (auto edge = node->OutputEdgesBegin(); edge != node->OutputEdgesEnd(); ++edge) {
+      longest_downstream_path = std::max(longest_downstream_path, priorities[edge->GetNode().Index()]);
+    }
+    priorities[*it] = costs[*it] + longest_downstream_path;
+  }
+
+  // streams of the non-CPU devices, and of the CPU
+  InlinedHashMap<OrtDevice::DeviceType, size_t> device_streams;
+  InlinedVector<size_t> cpu_streams;
+  InlinedVector<double> stream_available_time;
+  stream_nodes.clear();
+  auto add_stream = [&]() {
+    stream_nodes.emplace_back();
+    stream_available_time.push_back(0.0);
+    return stream_nodes.size() - 1;
+  };
+
+  InlinedVector<size_t> node_streams(num_node_indices, 0);
+  InlinedVector<double> finish_times(num_node_indices, 0.0);
+  InlinedVector<size_t> pending_inputs(num_node_indices, 0);
+  auto higher_priority = [&](NodeIndex lhs, NodeIndex rhs) {
+    // std::priority_queue puts the largest element on top
+    if (priorities[lhs] != priorities[rhs]) {
+      return priorities[lhs] < priorities[rhs];
+    }
+    return positions[lhs] > positions[rhs];
+  };
+  std::priority_queue<NodeIndex, std::vector<NodeIndex>, decltype(higher_priority)> ready_nodes(higher_priority);
+  for (auto node_index : node_order) {
+    pending_inputs[node_index] = graph_viewer.GetNode(node_index)->GetInputEdgesCount();
+    if (pending_inputs[node_index] == 0) {
+      ready_nodes.push(node_index);
+    }
+  }
+
+  while (!ready_nodes.empty()) {
+    const NodeIndex node_index = ready_nodes.top();
+    ready_nodes.pop();
+    const auto* node = graph_viewer.GetNode(node_index);
+    auto* ep = execution_providers.Get(*node);
+    ORT_RETURN_IF(ep == nullptr, "No execution provider for node ", node->Name());
+    const auto device_type = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault).Type();
+
+    auto start_time_on = [&](size_t stream) {
+      double start_time = stream_available_time[stream];
+      for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+        const auto producer = edge->GetNode().Index();
+        const double sync_cost = node_streams[producer] != stream ? kStreamSyncCost : 0.0;
+        start_time = std::max(start_time, finish_times[producer] + sync_cost);
+      }
+      return start_time;
+    };
+
+    size_t stream = 0;
+    double start_time = 0.0;
+    if (device_type != OrtDevice::CPU) {
+      auto entry = device_streams.find(device_type);
+      if (entry == device_streams.end()) {
+        entry = device_streams.emplace(device_type, add_stream()).first;
+      }
+      stream = entry->second;
+      start_time = start_time_on(stream);
+    } else {
+      bool found = false;
+      for (size_t cpu_stream : cpu_streams) {
+        const double time = start_time_on(cpu_stream);
+        if (!found || time < start_time) {
+          stream = cpu_stream;
+          start_time = time;
+          found = true;
+        }
+      }
+
+      // a new stream only pays off when the node would otherwise wait for a busy stream
+      if (cpu_streams.size() < max_cpu_streams_) {
+        double ready_time = 0.0;
+        for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+          ready_time = std::max(ready_time, finish_times[edge->GetNode().Index()] + kStreamSyncCost);
+        }
+        if (!found || ready_time < start_time) {
+          stream = add_stream();
+          cpu_streams.push_back(stream);
+          start_time = ready_time;
+        }
+      }
+    }
+
+    node_streams[node_index] = stream;
+    finish_times[node_index] = start_time + costs[node_index];
+    stream_available_time[stream] = finish_times[node_index];
+    stream_nodes[stream].push_back(node_index);
+
+    for (auto edge = node->OutputEdgesBegin(); edge != node->OutputEdgesEnd(); ++edge) {
+      const auto consumer = edge->GetNode().Index();
+      if (--pending_inputs[consumer] == 0) {
+        ready_nodes.push(consumer);
+      }
+    }
+  }
+
+  num_streams_ = stream_nodes.size();
+  LOGS(logger_, INFO) << "Partitioned " << node_order.size() << " nodes into " << cpu_streams.size()
+                      << " CPU streams and " << device_streams.size() << " device streams";
+  return Status::OK();
+}
+
+std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateCriticalPathPartitioner(const logging::Logger& logger,
+                                                                                    size_t max_cpu_streams) {
+  return std::make_unique<CriticalPathPartitioner>(logger, max_cpu_streams);
+}
+
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
                                                                              const PathString& config_file) {
   // use device based partitioner by default
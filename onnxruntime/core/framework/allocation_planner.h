@@ -46,15 +46,22 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // Maximum number of streams the CPU nodes of the main graph are partitioned into when no partition config file is
+  // provided. With more than one, independent branches of the graph are placed on different streams.
+  virtual size_t GetMaxCpuStreams() const { return 1; }
+
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           size_t max_cpu_streams = 1)
       : execution_mode_(execution_mode),
         exection_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        max_cpu_streams_(max_cpu_streams) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -67,10 +74,13 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  size_t GetMaxCpuStreams() const override { return max_cpu_streams_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder exection_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  size_t max_cpu_streams_ = 1;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -85,6 +95,7 @@ class IGraphPartitioner {
   // We will add more optimized partitioner later.
   enum GraphPartitioningStrategy {
     DeviceBasedPartition = 0,
+    CriticalPathPartition,
     Unknown,
   };
   virtual ~IGraphPartitioner() = default;
@@ -92,6 +103,9 @@ class IGraphPartitioner {
   // perform partition based on the user input when provided.
   static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(const logging::Logger& logger,
                                                                    const PathString& config_file);
+  // create a CriticalPathPartitioner, which spreads the CPU nodes over up to max_cpu_streams streams.
+  static std::unique_ptr<IGraphPartitioner> CreateCriticalPathPartitioner(const logging::Logger& logger,
+                                                                          size_t max_cpu_streams);
   virtual Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                 const ExecutionProviders& execution_providers,
                                 std::vector<InlinedVector<NodeIndex>>& stream_nodes,
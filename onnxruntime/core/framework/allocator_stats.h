@@ -18,6 +18,7 @@ struct AllocatorStats {
   int64_t total_allocated_bytes;  // The total number of allocated bytes by the allocator.
   int64_t max_bytes_in_use;       // The maximum bytes in use.
   int64_t max_alloc_size;         // The max single allocation seen.
+  int64_t max_free_chunk_size;    // The largest free chunk (Relevant only for arena based allocators)
                                   // The upper limit what the allocator can allocate, if such a limit
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
@@ -33,6 +34,7 @@ struct AllocatorStats {
     this->bytes_in_use = 0;
     this->max_bytes_in_use = 0;
     this->max_alloc_size = 0;
+    this->max_free_chunk_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
   }
@@ -47,7 +49,8 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "MaxFreeChunkSize:         " << this->max_free_chunk_size << "\n";
     return ss.str();
   }
 };
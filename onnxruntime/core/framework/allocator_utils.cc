@@ -32,6 +32,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int max_cached_chunk_size_bytes = info.arena_cfg.max_cached_chunk_size_bytes == -1
+                                          ? BFCArena::DEFAULT_MAX_CACHED_CHUNK_SIZE_BYTES
+                                          : info.arena_cfg.max_cached_chunk_size_bytes;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -68,7 +71,10 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     max_cached_chunk_size_bytes,
+                                     info.arena_cfg.use_huge_pages == 1,
+                                     info.arena_cfg.prefault_memory == 1));
     }
   } else {
     return device_allocator;
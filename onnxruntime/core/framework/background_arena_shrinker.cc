@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/background_arena_shrinker.h"
+
+#include <algorithm>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/bfc_arena.h"
+
+namespace onnxruntime {
+
+BackgroundArenaShrinker& BackgroundArenaShrinker::Instance() {
+  static BackgroundArenaShrinker shrinker;
+  return shrinker;
+}
+
+BackgroundArenaShrinker::~BackgroundArenaShrinker() {
+  std::thread thread;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    ++generation_;
+    thread = std::move(thread_);
+  }
+  cv_.notify_all();
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+std::unique_ptr<BackgroundArenaShrinker::Registration> BackgroundArenaShrinker::Register(
+    const AllocatorPtr& arena, const ArenaShrinkPolicy& policy) {
+  ORT_ENFORCE(arena && arena->Info().alloc_type == OrtAllocatorType::OrtArenaAllocator,
+              "Only arena based allocators can be shrunk in the background.");
+  ORT_ENFORCE(policy.check_interval.count() > 0, "The arena shrink check interval must be positive.");
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto entry = entries_.insert(entries_.end(), Entry{arena, policy,
+                                                     std::chrono::steady_clock::now() + policy.check_interval});
+  if (!thread_.joinable()) {
+    thread_ = std::thread([this, generation = generation_]() { Run(generation); });
+  }
+  cv_.notify_all();
+  return std::unique_ptr<Registration>(new Registration(*this, entry));
+}
+
+void BackgroundArenaShrinker::Unregister(std::list<Entry>::iterator entry) {
+  std::thread thread;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    entries_.erase(entry);
+    if (entries_.empty()) {
+      ++generation_;
+      thread = std::move(thread_);
+    }
+  }
+  if (thread.joinable()) {
+    cv_.notify_all();
+    thread.join();
+  }
+}
+
+size_t BackgroundArenaShrinker::CheckArena(BFCArena& arena, const ArenaShrinkPolicy& policy,
+                                           int64_t& last_num_allocs) {
+  AllocatorStats stats;
+  arena.GetStats(&stats);
+  const bool idle = stats.num_allocs == last_num_allocs;
+  const bool above_high_water_mark = policy.high_water_mark_bytes > 0 &&
+                                     static_cast<size_t>(stats.total_allocated_bytes) > policy.high_water_mark_bytes;
+  last_num_allocs = stats.num_allocs;
+  if (!idle && !above_high_water_mark) {
+    return 0;
+  }
+
+  return arena.ShrinkUnusedRegions(policy.min_unused_time);
+}
+
+void BackgroundArenaShrinker::Run(uint64_t generation) {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (generation_ == generation) {
+    const auto now = std::chrono::steady_clock::now();
+    auto next_check = std::chrono::steady_clock::time_point::max();
+    for (auto& entry : entries_) {
+      if (entry.next_check <= now) {
+        if (auto allocator = entry.arena.lock()) {
+          ORT_TRY {
+            const size_t freed_bytes = CheckArena(*static_cast<BFCArena*>(allocator.get()), entry.policy,
+                                                  entry.last_num_allocs);
+            if (freed_bytes > 0) {
+              LOGS_DEFAULT(VERBOSE) << "Background shrinkage freed " << freed_bytes << " bytes of arena "
+                                    << allocator->Info().ToString();
+            }
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              LOGS_DEFAULT(WARNING) << "Unable to shrink arena " << allocator->Info().ToString()
+                                    << " in the background: " << ex.what();
+            });
+          }
+        }
+        entry.next_check = now + entry.policy.check_interval;
+      }
+      next_check = std::min(next_check, entry.next_check);
+    }
+
+    if (next_check == std::chrono::steady_clock::time_point::max()) {
+      cv_.wait(lock);
+    } else {
+      cv_.wait_for(lock, next_check - std::chrono::steady_clock::now());
+    }
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <thread>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class BFCArena;
+
+// When and what the background shrinker releases from an arena.
+struct ArenaShrinkPolicy {
+  // How often the arena is checked.
+  std::chrono::milliseconds check_interval{1000};
+
+  // Only allocation regions without chunks in use for at least this long are released.
+  std::chrono::milliseconds min_unused_time{10000};
+
+  // The arena is shrunk when it did not allocate anything since the previous check, or when more than this many
+  // bytes are allocated from the device. 0 to only shrink idle arenas.
+  size_t high_water_mark_bytes = 0;
+};
+
+// Releases the unused memory of arenas from a background thread.
+//
+// Shrinking an arena at the end of a Run adds to the latency of that Run. The background shrinker instead returns
+// memory to the device in between requests, which matters on hosts that serve several models. A single thread
+// serves all arenas of the process, and runs while at least one arena is registered.
+class BackgroundArenaShrinker {
+ public:
+  class Registration;
+
+  static BackgroundArenaShrinker& Instance();
+
+  ~BackgroundArenaShrinker();
+
+  // Starts checking `arena`, which has to be a BFCArena, until the returned registration is destroyed.
+  // The shrinker does not keep the arena alive.
+  std::unique_ptr<Registration> Register(const AllocatorPtr& arena, const ArenaShrinkPolicy& policy);
+
+  // Checks an arena once according to the policy. `last_num_allocs` holds the number of allocations the arena had
+  // made at the previous check and is updated. Returns the number of bytes freed.
+  static size_t CheckArena(BFCArena& arena, const ArenaShrinkPolicy& policy, int64_t& last_num_allocs);
+
+ private:
+  struct Entry {
+    std::weak_ptr<IAllocator> arena;
+    ArenaShrinkPolicy policy;
+    std::chrono::steady_clock::time_point next_check;
+    int64_t last_num_allocs = -1;
+  };
+
+  BackgroundArenaShrinker() = default;
+
+  void Unregister(std::list<Entry>::iterator entry);
+
+  void Run(uint64_t generation);
+
+  // entries_ are only modified under mutex_, which the thread holds while it checks the arenas. So an arena is not
+  // used by the thread anymore once its registration is destroyed.
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::list<Entry> entries_;
+  // incremented to stop the running thread, which may still be exiting when the next one is started
+  uint64_t generation_ = 0;
+  std::thread thread_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BackgroundArenaShrinker);
+};
+
+class BackgroundArenaShrinker::Registration {
+ public:
+  ~Registration() { shrinker_.Unregister(entry_); }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Registration);
+
+ private:
+  friend class BackgroundArenaShrinker;
+
+  Registration(BackgroundArenaShrinker& shrinker, std::list<Entry>::iterator entry)
+      : shrinker_(shrinker), entry_(entry) {}
+
+  BackgroundArenaShrinker& shrinker_;
+  std::list<Entry>::iterator entry_;
+};
+
+}  // namespace onnxruntime
@@ -3,16 +3,237 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <atomic>
 #include <type_traits>
+#include "core/common/inlined_containers.h"
+#include "core/common/native_tracing.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 namespace onnxruntime {
+
+// Caches of recently freed small chunks, so that the frequent small allocations of concurrent Run calls do not
+// all contend for lock_.
+//
+// Each thread uses one of kNumShards shards, and every shard holds up to kSlotsPerSizeClass chunks per size class.
+// Chunks are cached by the rounded size of the request they were taken from the bins for, so any request of the
+// same rounded size can reuse them. A cached chunk stays in use as far as the bins are concerned, so it is never
+// handed out or coalesced by the locked path. Cached chunks are returned to the bins:
+// - in batches, when a size class of a shard is full,
+// - all at once, before the arena is extended and in Shrink.
+//
+// Free needs the size class of a pointer without taking lock_, so it is looked up in a radix tree keyed by the
+// chunk address. The tree is only modified under lock_ and its nodes live as long as the arena, which makes the
+// lookups lock free. An entry is only valid while its chunk is in use: it is overwritten whenever the chunk is
+// taken from the bins and cleared when the chunk is deleted.
+class BFCArena::SmallChunkCache {
+ public:
+  static constexpr size_t kNumShards = 16;
+  static constexpr size_t kSlotsPerSizeClass = 4;
+
+  using EvictedChunks = InlinedVector<void*, kSlotsPerSizeClass + 1>;
+
+  explicit SmallChunkCache(size_t max_chunk_size)
+      : num_size_classes_(max_chunk_size / kMinAllocationSize),
+        slots_(std::make_unique<std::atomic<void*>[]>(kNumShards * num_size_classes_ * kSlotsPerSizeClass)),
+        root_(std::make_unique<RootNode>()) {
+  }
+
+  // Requires lock_. A size class of 0 clears the entry of ptr.
+  void SetEntry(const void* ptr, size_t size_class, size_t chunk_size) {
+    const uint64_t key = Key(ptr);
+    if (key >> kKeyBits) {
+      return;
+    }
+
+    const size_t chunk_size_class = chunk_size / kMinAllocationSize;
+    const uint32_t entry = size_class == 0 || size_class > num_size_classes_ || chunk_size_class > 0xffff
+                               ? 0
+                               : static_cast<uint32_t>(size_class << 16 | chunk_size_class);
+    auto& mid_slot = root_->children[key >> (kMidBits + kLeafBits)];
+    MidNode* mid = mid_slot.load(std::memory_order_acquire);
+    if (mid == nullptr) {
+      if (entry == 0) {
+        return;
+      }
+      mid_nodes_.push_back(std::make_unique<MidNode>());
+      mid = mid_nodes_.back().get();
+      mid_slot.store(mid, std::memory_order_release);
+    }
+
+    auto& leaf_slot = mid->children[(key >> kLeafBits) & ((1 << kMidBits) - 1)];
+    Leaf* leaf = leaf_slot.load(std::memory_order_acquire);
+    if (leaf == nullptr) {
+      if (entry == 0) {
+        return;
+      }
+      leaves_.push_back(std::make_unique<Leaf>());
+      leaf = leaves_.back().get();
+      leaf_slot.store(leaf, std::memory_order_release);
+    }
+
+    leaf->entries[key & ((1 << kLeafBits) - 1)].store(entry, std::memory_order_release);
+  }
+
+  // Returns a cached chunk for a request of rounded_bytes, or nullptr.
+  void* Pop(size_t rounded_bytes) {
+    const size_t size_class = rounded_bytes / kMinAllocationSize;
+    if (size_class > num_size_classes_) {
+      return nullptr;
+    }
+
+    std::atomic<void*>* slots = Slots(size_class);
+    for (size_t i = 0; i < kSlotsPerSizeClass; ++i) {
+      if (slots[i].load(std::memory_order_relaxed) != nullptr) {
+        void* ptr = slots[i].exchange(nullptr, std::memory_order_acquire);
+        if (ptr != nullptr) {
+          cached_bytes_.fetch_sub(ChunkSize(GetEntry(ptr)), std::memory_order_relaxed);
+          num_allocs_.fetch_add(1, std::memory_order_relaxed);
+          return ptr;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  // Caches a freed chunk. Returns false if ptr is not a cacheable chunk. If its size class is full, the chunks
+  // cached before are moved to evicted and have to be returned to the bins by the caller.
+  bool Push(void* ptr, EvictedChunks& evicted) {
+    const uint32_t entry = GetEntry(ptr);
+    if (entry == 0) {
+      return false;
+    }
+
+    std::atomic<void*>* slots = Slots(entry >> 16);
+    cached_bytes_.fetch_add(ChunkSize(entry), std::memory_order_relaxed);
+    if (TryStore(slots, ptr)) {
+      return true;
+    }
+
+    // keep the most recently freed chunk, which is the most likely to still be in the cpu cache
+    for (size_t i = 0; i < kSlotsPerSizeClass; ++i) {
+      void* evicted_ptr = slots[i].exchange(nullptr, std::memory_order_acquire);
+      if (evicted_ptr != nullptr) {
+        cached_bytes_.fetch_sub(ChunkSize(GetEntry(evicted_ptr)), std::memory_order_relaxed);
+        evicted.push_back(evicted_ptr);
+      }
+    }
+    if (!TryStore(slots, ptr)) {
+      cached_bytes_.fetch_sub(ChunkSize(entry), std::memory_order_relaxed);
+      evicted.push_back(ptr);
+    }
+    return true;
+  }
+
+  // Removes all cached chunks and calls fn for each of them.
+  template <typename TFunc>
+  void Drain(TFunc&& fn) {
+    const size_t num_slots = kNumShards * num_size_classes_ * kSlotsPerSizeClass;
+    for (size_t i = 0; i < num_slots; ++i) {
+      if (slots_[i].load(std::memory_order_relaxed) != nullptr) {
+        void* ptr = slots_[i].exchange(nullptr, std::memory_order_acquire);
+        if (ptr != nullptr) {
+          cached_bytes_.fetch_sub(ChunkSize(GetEntry(ptr)), std::memory_order_relaxed);
+          fn(ptr);
+        }
+      }
+    }
+  }
+
+  // Bytes of the chunks currently cached.
+  int64_t CachedBytes() const { return cached_bytes_.load(std::memory_order_relaxed); }
+
+  // Number of allocations served from the cache.
+  int64_t NumAllocs() const { return num_allocs_.load(std::memory_order_relaxed); }
+
+ private:
+  // Chunk addresses are at least kMinAllocationSize apart, which leaves 40 bits of key for 48 bit addresses.
+  static constexpr int kKeyBits = 40;
+  static constexpr int kMidBits = 14;
+  static constexpr int kLeafBits = 12;
+  static_assert(kKeyBits == 2 * kMidBits + kLeafBits, "radix tree levels must cover the key");
+
+  struct Leaf {
+    std::array<std::atomic<uint32_t>, 1 << kLeafBits> entries{};
+  };
+
+  struct MidNode {
+    std::array<std::atomic<Leaf*>, 1 << kMidBits> children{};
+  };
+
+  struct RootNode {
+    std::array<std::atomic<MidNode*>, 1 << kMidBits> children{};
+  };
+
+  static uint64_t Key(const void* ptr) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) >> kMinAllocationBits;
+  }
+
+  static size_t ChunkSize(uint32_t entry) {
+    return static_cast<size_t>(entry & 0xffff) * kMinAllocationSize;
+  }
+
+  uint32_t GetEntry(const void* ptr) const {
+    const uint64_t key = Key(ptr);
+    if (key >> kKeyBits) {
+      return 0;
+    }
+    const auto* mid = root_->children[key >> (kMidBits + kLeafBits)].load(std::memory_order_acquire);
+    if (mid == nullptr) {
+      return 0;
+    }
+    const auto* leaf = mid->children[(key >> kLeafBits) & ((1 << kMidBits) - 1)].load(std::memory_order_acquire);
+    if (leaf == nullptr) {
+      return 0;
+    }
+    return leaf->entries[key & ((1 << kLeafBits) - 1)].load(std::memory_order_acquire);
+  }
+
+  static size_t ThreadShard() {
+    // hashes of thread ids are often aligned addresses, so threads are assigned to shards round robin instead
+    static std::atomic<size_t> next_shard{0};
+    static thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return shard;
+  }
+
+  std::atomic<void*>* Slots(size_t size_class) {
+    return &slots_[(ThreadShard() * num_size_classes_ + size_class - 1) * kSlotsPerSizeClass];
+  }
+
+  static bool TryStore(std::atomic<void*>* slots, void* ptr) {
+    for (size_t i = 0; i < kSlotsPerSizeClass; ++i) {
+      void* expected = nullptr;
+      if (slots[i].load(std::memory_order_relaxed) == nullptr &&
+          slots[i].compare_exchange_strong(expected, ptr, std::memory_order_release, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const size_t num_size_classes_;
+  std::unique_ptr<std::atomic<void*>[]> slots_;
+  std::atomic<int64_t> cached_bytes_{0};
+  std::atomic<int64_t> num_allocs_{0};
+
+  std::unique_ptr<RootNode> root_;
+  // owners of the radix tree nodes, only modified under lock_
+  std::vector<std::unique_ptr<MidNode>> mid_nodes_;
+  std::vector<std::unique_ptr<Leaf>> leaves_;
+};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int max_cached_chunk_size_bytes,
+                   bool use_huge_pages,
+                   bool prefault_memory)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,12 +246,17 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      use_huge_pages_(use_huge_pages),
+      prefault_memory_(prefault_memory) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " max_cached_chunk_size_bytes: " << max_cached_chunk_size_bytes
+                     << " use_huge_pages: " << use_huge_pages_
+                     << " prefault_memory: " << prefault_memory_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -43,6 +269,12 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
 
   arena_extend_strategy_ = arena_extend_strategy;
 
+  ORT_ENFORCE(max_cached_chunk_size_bytes >= 0 && max_cached_chunk_size_bytes <= MAX_CACHED_CHUNK_SIZE_BYTES,
+              "max_cached_chunk_size_bytes must be between 0 and ", MAX_CACHED_CHUNK_SIZE_BYTES);
+  if (max_cached_chunk_size_bytes >= static_cast<int>(kMinAllocationSize)) {
+    small_chunk_cache_ = std::make_unique<SmallChunkCache>(static_cast<size_t>(max_cached_chunk_size_bytes));
+  }
+
   // We never want to shrink the initial allocation if the arena extend strategy is kNextPowerOfTwo.
   // This could seem confusingly arbitrary but the rationale is as follows:
   // The user selected initial allocation chunk is only valid for the arena extend strategy kNextPowerOfTwo
@@ -96,6 +328,34 @@ BFCArena::Chunk* BFCArena::ChunkFromHandle(ChunkHandle h) {
   return &(chunks_[h]);
 }
 
+void BFCArena::PrepareRegion(void* ptr, size_t size) const {
+  if (device_allocator_->Info().device.Type() != OrtDevice::CPU ||
+      device_allocator_->Info().device.MemType() != OrtDevice::MemType::DEFAULT) {
+    return;
+  }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (use_huge_pages_) {
+    // Only the part of the region aligned to huge pages can be backed by them.
+    constexpr uintptr_t kHugePageSize = 2 * 1024 * 1024;
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) & ~(kHugePageSize - 1);
+    if (begin < end && madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) != 0) {
+      LOGS_DEFAULT(WARNING) << "Failed to use huge pages for the allocation region at " << ptr;
+    }
+  }
+#endif
+
+  if (prefault_memory_) {
+    // The memory isn't handed out yet, so its content doesn't matter. 4KB is the smallest page size we run on.
+    constexpr size_t kPageSize = 4096;
+    volatile char* bytes = static_cast<char*>(ptr);
+    for (size_t offset = 0; offset < size; offset += kPageSize) {
+      bytes[offset] = 0;
+    }
+  }
+}
+
 Status BFCArena::Extend(size_t rounded_bytes) {
   size_t available_bytes = memory_limit_ - static_cast<size_t>(stats_.total_allocated_bytes);
   // Rounds available_bytes down to the nearest multiple of kMinAllocationSize.
@@ -203,6 +463,8 @@ Status BFCArena::Extend(size_t rounded_bytes) {
                            "Failed to allocate memory for requested buffer of size ", rounded_bytes);
   }
 
+  PrepareRegion(mem_addr, bytes);
+
   LOGS_DEFAULT(INFO) << "Extended allocation by " << bytes << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
@@ -269,6 +531,12 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (small_chunk_cache_ && size != 0) {
+    void* ptr = small_chunk_cache_->Pop(RoundedBytes(size));
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
@@ -325,6 +593,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
+  profiling::NativeTraceSpan span("Alloc");
   std::lock_guard<OrtMutex> lock(lock_);
   // search for a valid chunk
   auto* chunk = FindChunkPtr(bin_num,
@@ -334,6 +603,12 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                              enable_cross_stream_reusing,
                              wait_fn);
 
+  if (chunk == nullptr && small_chunk_cache_ && small_chunk_cache_->CachedBytes() > 0) {
+    // return the cached chunks to the bins before growing the arena
+    FlushSmallChunkCache();
+    chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, enable_cross_stream_reusing, wait_fn);
+  }
+
   if (chunk != nullptr) {
     // if it is on default stream (the new allocate chunk), assign to current stream
     if (chunk->stream == nullptr) {
@@ -341,6 +616,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (stream)
         chunk->stream_timestamp = stream->GetCurrentTimestamp();
     }
+    RegisterWithSmallChunkCache(chunk->ptr, rounded_bytes, chunk->size, stream);
     return chunk->ptr;
   }
 
@@ -348,7 +624,15 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                      << ". bin_num:" << bin_num << " (requested) num_bytes: " << num_bytes << " (actual) rounded_bytes:" << rounded_bytes;
 
   // Try to extend
-  auto status = Extend(rounded_bytes);
+  Status status;
+  {
+    profiling::NativeTraceSpan extend_span("ArenaExtend");
+    status = Extend(rounded_bytes);
+  }
+  if (profiling::NativeTracing::IsEnabled()) {
+    profiling::NativeTracing::Counter(MakeString(device_allocator_->Info().name, " reserved_bytes"),
+                                      stats_.total_allocated_bytes);
+  }
   if (status.IsOK()) {
     chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, false);
     if (chunk != nullptr) {
@@ -356,6 +640,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (chunk->stream == nullptr && stream) {
         chunk->stream = stream;
       }
+      RegisterWithSmallChunkCache(chunk->ptr, rounded_bytes, chunk->size, stream);
       return chunk->ptr;
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -379,6 +664,33 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  if (small_chunk_cache_) {
+    // cached chunks are in use for the bins, but not for the users of the arena
+    stats->bytes_in_use -= small_chunk_cache_->CachedBytes();
+    stats->num_allocs += small_chunk_cache_->NumAllocs();
+  }
+  // the free chunks of a bin are sorted by size, and the bins by the size of their chunks
+  for (BinNum b = kNumBins - 1; b >= 0; --b) {
+    const Bin* bin = BinFromIndex(b);
+    if (!bin->free_chunks.empty()) {
+      stats->max_free_chunk_size = static_cast<int64_t>(ChunkFromHandle(*bin->free_chunks.rbegin())->size);
+      break;
+    }
+  }
+}
+
+void BFCArena::RegisterWithSmallChunkCache(const void* ptr, size_t rounded_bytes, size_t chunk_size,
+                                           Stream* stream) {
+  if (small_chunk_cache_) {
+    // chunks of streams are left to the locked path, which tracks which stream may reuse them
+    small_chunk_cache_->SetEntry(ptr, stream == nullptr ? rounded_bytes / kMinAllocationSize : 0, chunk_size);
+  }
+}
+
+void BFCArena::FlushSmallChunkCache() {
+  if (small_chunk_cache_) {
+    small_chunk_cache_->Drain([this](void* ptr) { DeallocateRawInternal(ptr); });
+  }
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -496,6 +808,18 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (small_chunk_cache_) {
+    SmallChunkCache::EvictedChunks evicted;
+    if (small_chunk_cache_->Push(p, evicted)) {
+      if (!evicted.empty()) {
+        std::lock_guard<OrtMutex> lock(lock_);
+        for (void* evicted_ptr : evicted) {
+          DeallocateRawInternal(evicted_ptr);
+        }
+      }
+      return;
+    }
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -510,6 +834,7 @@ void BFCArena::Free(void* p) {
 
 Status BFCArena::Shrink() {
   std::lock_guard<OrtMutex> lock(lock_);
+  FlushSmallChunkCache();
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
   std::vector<size_t> region_sizes;
@@ -517,60 +842,96 @@ Status BFCArena::Shrink() {
   region_sizes.reserve(num_regions);
 
   for (const auto& region : region_manager_.regions()) {
-    if (consider_first_allocation_region_for_shrinkage_ || region.id() != 0) {
+    if ((consider_first_allocation_region_for_shrinkage_ || region.id() != 0) && !IsRegionInUse(region)) {
       region_ptrs.push_back(region.ptr());
       region_sizes.push_back(region.memory_size());
     }
   }
 
-  size_t i = 0;
-  for (void* region_ptr : region_ptrs) {
-    bool deallocate_region = true;
-    ChunkHandle region_begin_chunk = region_manager_.get_handle(region_ptr);
-    ChunkHandle h = region_begin_chunk;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        // at-least one used chunk found in the allocation region -
-        // so we cannot deallocate it
-        deallocate_region = false;
-        break;
-      }
-      h = c->next;
-    }
+  for (size_t i = 0; i < region_ptrs.size(); ++i) {
+    RemoveUnusedRegion(region_ptrs[i], region_sizes[i]);
+    device_allocator_->Free(region_ptrs[i]);
+  }
 
-    if (deallocate_region) {
-      auto shrink_size = region_sizes[i];
-      stats_.num_arena_shrinkages += 1;
-      stats_.total_allocated_bytes -= shrink_size;
+  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
+  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
+  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+
+  return Status::OK();
+}
 
-      LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
-                            << shrink_size << " bytes. "
-                            << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+size_t BFCArena::ShrinkUnusedRegions(std::chrono::steady_clock::duration min_unused_time) {
+  std::vector<std::pair<void*, size_t>> regions_to_free;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    FlushSmallChunkCache();
 
-      h = region_begin_chunk;
-      ChunkHandle temp = region_begin_chunk;
-      while (h != kInvalidChunkHandle) {
-        const Chunk* c = ChunkFromHandle(h);
-        temp = c->next;
-        RemoveFreeChunkFromBin(h);
-        DeleteChunk(h);
-        h = temp;
+    const auto now = std::chrono::steady_clock::now();
+    std::unordered_map<void*, std::chrono::steady_clock::time_point> unused_regions_since;
+    for (const auto& region : region_manager_.regions()) {
+      if ((!consider_first_allocation_region_for_shrinkage_ && region.id() == 0) || IsRegionInUse(region)) {
+        continue;
       }
 
-      device_allocator_->Free(region_ptr);
-      region_manager_.RemoveAllocationRegion(region_ptr);
-      stats_.num_arena_extensions--;
+      auto it = unused_regions_since_.find(region.ptr());
+      const auto unused_since = it != unused_regions_since_.end() ? it->second : now;
+      if (now - unused_since >= min_unused_time) {
+        regions_to_free.emplace_back(region.ptr(), region.memory_size());
+      } else {
+        unused_regions_since.emplace(region.ptr(), unused_since);
+      }
     }
+    // regions that were used since the last call start over
+    unused_regions_since_ = std::move(unused_regions_since);
 
-    ++i;
+    for (const auto& region : regions_to_free) {
+      RemoveUnusedRegion(region.first, region.second);
+    }
+    if (!regions_to_free.empty()) {
+      curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+    }
   }
 
-  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
-  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
-  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  size_t freed_bytes = 0;
+  for (const auto& region : regions_to_free) {
+    device_allocator_->Free(region.first);
+    freed_bytes += region.second;
+  }
+  return freed_bytes;
+}
 
-  return Status::OK();
+bool BFCArena::IsRegionInUse(const AllocationRegion& region) {
+  ChunkHandle h = region_manager_.get_handle(region.ptr());
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    if (c->in_use()) {
+      return true;
+    }
+    h = c->next;
+  }
+  return false;
+}
+
+void BFCArena::RemoveUnusedRegion(void* region_ptr, size_t region_size) {
+  stats_.num_arena_shrinkages += 1;
+  stats_.total_allocated_bytes -= region_size;
+
+  LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
+                        << region_size << " bytes. "
+                        << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    ChunkHandle next = c->next;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    h = next;
+  }
+
+  region_manager_.RemoveAllocationRegion(region_ptr);
+  unused_regions_since_.erase(region_ptr);
+  stats_.num_arena_extensions--;
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
@@ -618,6 +979,9 @@ void BFCArena::DeleteChunk(ChunkHandle h) {
   // Delete h and cleanup all state
   Chunk* c = ChunkFromHandle(h);
   //  VLOG(4) << "Removing: " << c->ptr;
+  if (small_chunk_cache_) {
+    small_chunk_cache_->SetEntry(c->ptr, 0, 0);
+  }
   region_manager_.erase(c->ptr);
   DeallocateChunk(h);
 }
@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -60,6 +61,8 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_MAX_DEAD_BYTES_PER_CHUNK = 128 * 1024 * 1024;
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
+  static constexpr int DEFAULT_MAX_CACHED_CHUNK_SIZE_BYTES = 0;  // small chunk cache disabled
+  static constexpr int MAX_CACHED_CHUNK_SIZE_BYTES = 64 * 1024;
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
 
   enum ArenaType {
@@ -73,7 +76,10 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int max_cached_chunk_size_bytes = DEFAULT_MAX_CACHED_CHUNK_SIZE_BYTES,
+           bool use_huge_pages = false,
+           bool prefault_memory = false);
 
   ~BFCArena() override;
 
@@ -86,6 +92,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held by the small chunk cache are returned to the bins first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -93,10 +100,20 @@ class BFCArena : public IAllocator {
   // and the allocation request.
   Status Shrink();
 
+  // Frees the allocation regions in which no chunk has been in use for at least `min_unused_time`.
+  // A region counts as unused from the first call that finds it without chunks in use, so calling this
+  // periodically releases regions that stayed unused for `min_unused_time` plus at most one period.
+  // Unlike Shrink, the memory is returned to the device allocator after lock_ is released, which keeps
+  // concurrent allocations from waiting for it. The first allocation region is treated as in Shrink.
+  // Returns the number of bytes freed.
+  size_t ShrinkUnusedRegions(std::chrono::steady_clock::duration min_unused_time);
+
   void* Reserve(size_t size) override;
 
   void GetStats(AllocatorStats* stats) override;
 
+  // For an allocation served by the small chunk cache this is the size requested when the chunk was taken
+  // from the bins.
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
@@ -123,6 +140,13 @@ class BFCArena : public IAllocator {
  private:
   void DeallocateRawInternal(void* ptr);
 
+  // Records whether the chunk that was just taken from the bins can go through the small chunk cache when freed.
+  // Requires lock_.
+  void RegisterWithSmallChunkCache(const void* ptr, size_t rounded_bytes, size_t chunk_size, Stream* stream);
+
+  // Returns all chunks held by the small chunk cache to the bins. Requires lock_.
+  void FlushSmallChunkCache();
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -362,9 +386,20 @@ class BFCArena : public IAllocator {
     std::vector<AllocationRegion> regions_;
   };
 
+  // Whether any chunk of the region is in use. Requires lock_.
+  bool IsRegionInUse(const AllocationRegion& region);
+
+  // Deletes the chunks of an allocation region that has no chunk in use and removes the region, without
+  // freeing its memory. Requires lock_.
+  void RemoveUnusedRegion(void* region_ptr, size_t region_size);
+
   // Returns 'bytes' rounded up to the next highest kMinAllocationSize.
   size_t RoundedBytes(size_t bytes);
 
+  // Advises the OS to back a new CPU region with transparent huge pages, and writes to each of its pages so that
+  // the page faults happen when the arena is extended instead of on the first use of the memory.
+  void PrepareRegion(void* ptr, size_t size) const;
+
   // Try to add a new memory region that can satisfy an allocation of
   // 'rounded_bytes' bytes.
   Status Extend(size_t rounded_bytes);
@@ -509,6 +544,18 @@ class BFCArena : public IAllocator {
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
 
+  // Only applied to the regions of CPU arenas. See PrepareRegion.
+  const bool use_huge_pages_;
+  const bool prefault_memory_;
+
+  // Per-thread caches of freed small chunks that Alloc and Free use without taking lock_.
+  // nullptr if max_cached_chunk_size_bytes is 0. See SmallChunkCache in bfc_arena.cc.
+  class SmallChunkCache;
+  std::unique_ptr<SmallChunkCache> small_chunk_cache_;
+
+  // Allocation regions that ShrinkUnusedRegions found unused, and since when they are known to be unused.
+  std::unordered_map<void*, std::chrono::steady_clock::time_point> unused_regions_since_;
+
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
   // is to be considered for shrinkage or not.
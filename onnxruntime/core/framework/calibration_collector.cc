@@ -0,0 +1,345 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/calibration_collector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "core/framework/float16.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+bool TryParseCalibrationMethod(const std::string& str, CalibrationMethod& method) {
+  if (str == "minmax") {
+    method = CalibrationMethod::kMinMax;
+  } else if (str == "percentile") {
+    method = CalibrationMethod::kPercentile;
+  } else if (str == "entropy") {
+    method = CalibrationMethod::kEntropy;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void CalibrationHistogram::Add(gsl::span<const float> values, float abs_max) {
+  if (bin_counts.empty()) {
+    bin_counts.resize(kNumBins);
+  }
+
+  if (abs_max > range) {
+    if (range == 0.0f) {
+      // only zeros were added so far, which stay in the first bin
+      range = abs_max;
+    } else {
+      while (range < abs_max) {
+        for (size_t bin = 0; bin < kNumBins / 2; ++bin) {
+          bin_counts[bin] = bin_counts[2 * bin] + bin_counts[2 * bin + 1];
+        }
+        std::fill(bin_counts.begin() + kNumBins / 2, bin_counts.end(), uint64_t{0});
+        range *= 2.0f;
+      }
+    }
+  }
+
+  const float bins_per_unit = range > 0.0f ? static_cast<float>(kNumBins) / range : 0.0f;
+  for (float value : values) {
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    const auto bin = static_cast<size_t>(std::abs(value) * bins_per_unit);
+    ++bin_counts[std::min(bin, kNumBins - 1)];
+    ++count;
+  }
+}
+
+float CalibrationHistogram::PercentileThreshold(double percentile) const {
+  if (count == 0) {
+    return 0.0f;
+  }
+
+  const auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(static_cast<double>(count) * percentile / 100.0)),
+                                       1);
+  uint64_t cumulative = 0;
+  for (size_t bin = 0; bin < kNumBins; ++bin) {
+    cumulative += bin_counts[bin];
+    if (cumulative >= rank) {
+      return range * static_cast<float>(bin + 1) / static_cast<float>(kNumBins);
+    }
+  }
+  return range;
+}
+
+float CalibrationHistogram::EntropyThreshold(size_t num_quantized_bins) const {
+  if (count == 0 || range == 0.0f) {
+    return range;
+  }
+
+  // TensorRT's calibration: for each candidate threshold, the distribution P clips the outliers into its last bin and
+  // Q quantizes the bins below the threshold to num_quantized_bins levels. The threshold with the smallest KL(P || Q)
+  // is chosen.
+  constexpr double kEpsilon = 1e-9;
+  std::vector<double> p;
+  std::vector<double> q;
+  double min_divergence = std::numeric_limits<double>::max();
+  size_t best_threshold_bin = kNumBins;
+
+  uint64_t outliers = count;
+  for (size_t bin = 0; bin < num_quantized_bins; ++bin) {
+    outliers -= bin_counts[bin];
+  }
+
+  for (size_t threshold_bin = num_quantized_bins; threshold_bin <= kNumBins; ++threshold_bin) {
+    p.assign(bin_counts.begin(), bin_counts.begin() + threshold_bin);
+    p[threshold_bin - 1] += static_cast<double>(outliers);
+    if (threshold_bin < kNumBins) {
+      outliers -= bin_counts[threshold_bin];
+    }
+
+    q.assign(threshold_bin, 0.0);
+    const size_t bins_per_level = threshold_bin / num_quantized_bins;
+    for (size_t level = 0; level < num_quantized_bins; ++level) {
+      const size_t start = level * bins_per_level;
+      const size_t stop = level == num_quantized_bins - 1 ? threshold_bin : start + bins_per_level;
+      uint64_t level_count = 0;
+      size_t nonzero_bins = 0;
+      for (size_t bin = start; bin < stop; ++bin) {
+        level_count += bin_counts[bin];
+        nonzero_bins += bin_counts[bin] != 0 ? 1 : 0;
+      }
+      // expand the level back to the bins that are not empty
+      for (size_t bin = start; bin < stop && nonzero_bins > 0; ++bin) {
+        if (bin_counts[bin] != 0) {
+          q[bin] = static_cast<double>(level_count) / static_cast<double>(nonzero_bins);
+        }
+      }
+    }
+
+    double p_sum = 0.0;
+    double q_sum = 0.0;
+    for (size_t bin = 0; bin < threshold_bin; ++bin) {
+      p_sum += p[bin];
+      q_sum += q[bin];
+    }
+    if (q_sum == 0.0) {
+      continue;
+    }
+
+    double divergence = 0.0;
+    for (size_t bin = 0; bin < threshold_bin; ++bin) {
+      if (p[bin] > 0.0) {
+        const double p_bin = p[bin] / p_sum;
+        const double q_bin = std::max(q[bin] / q_sum, kEpsilon);
+        divergence += p_bin * std::log(p_bin / q_bin);
+      }
+    }
+
+    if (divergence < min_divergence) {
+      min_divergence = divergence;
+      best_threshold_bin = threshold_bin;
+    }
+  }
+
+  return range * static_cast<float>(best_threshold_bin) / static_cast<float>(kNumBins);
+}
+
+CalibrationCollector::CalibrationCollector(const GraphViewer& graph_viewer,
+                                           const InlinedHashSet<std::string>& tensor_names,
+                                           CalibrationMethod method, double percentile)
+    : method_(method), percentile_(percentile), node_observers_(graph_viewer.MaxNodeIndex()) {
+  for (const auto& node : graph_viewer.Nodes()) {
+    const auto& output_defs = node.OutputDefs();
+    for (size_t i = 0; i < output_defs.size(); ++i) {
+      const NodeArg& output = *output_defs[i];
+      if (!output.Exists() || (!tensor_names.empty() && tensor_names.count(output.Name()) == 0)) {
+        continue;
+      }
+
+      // skip outputs known not to be float tensors, the element type of the others is checked when they are observed
+      const auto* type = output.TypeAsProto();
+      if (type != nullptr && (!type->has_tensor_type() ||
+                              (type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+                               type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16))) {
+        continue;
+      }
+
+      auto observer = std::make_unique<Observer>();
+      observer->statistics.name = output.Name();
+      node_observers_[node.Index()].emplace_back(static_cast<int>(i), observer.get());
+      observers_.push_back(std::move(observer));
+    }
+  }
+}
+
+void CalibrationCollector::Observe(NodeIndex node_index, OpKernelContextInternal& context) {
+  std::vector<float> converted;
+  for (const auto& output_observer : node_observers_[node_index]) {
+    const OrtValue* value = context.GetOutputMLValue(output_observer.first);
+    if (value == nullptr || !value->IsTensor() || !value->IsAllocated()) {
+      continue;
+    }
+
+    const Tensor& tensor = value->Get<Tensor>();
+    if (tensor.Location().device.Type() != OrtDevice::CPU) {
+      continue;
+    }
+
+    gsl::span<const float> values;
+    if (tensor.IsDataType<float>()) {
+      values = tensor.DataAsSpan<float>();
+    } else if (tensor.IsDataType<MLFloat16>()) {
+      const auto half_values = tensor.DataAsSpan<MLFloat16>();
+      converted.resize(half_values.size());
+      std::transform(half_values.begin(), half_values.end(), converted.begin(),
+                     [](MLFloat16 v) { return v.ToFloat(); });
+      values = converted;
+    } else {
+      continue;
+    }
+
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+    for (float v : values) {
+      if (std::isfinite(v)) {
+        min = std::min(min, v);
+        max = std::max(max, v);
+      }
+    }
+    if (min > max) {
+      continue;  // no finite values
+    }
+
+    Observer& observer = *output_observer.second;
+    std::lock_guard<OrtMutex> lock(observer.mutex);
+    auto& statistics = observer.statistics;
+    statistics.min = observer.observed ? std::min(statistics.min, min) : min;
+    statistics.max = observer.observed ? std::max(statistics.max, max) : max;
+    observer.observed = true;
+    if (method_ != CalibrationMethod::kMinMax) {
+      statistics.histogram.Add(values, std::max(-min, max));
+    }
+  }
+}
+
+void CalibrationCollector::GetStatistics(std::vector<CalibrationStatistics>& statistics) const {
+  for (const auto& observer : observers_) {
+    std::lock_guard<OrtMutex> lock(observer->mutex);
+    if (observer->observed) {
+      statistics.push_back(observer->statistics);
+    }
+  }
+}
+
+std::pair<float, float> ComputeCalibrationRange(const CalibrationStatistics& statistics, CalibrationMethod method,
+                                                double percentile) {
+  constexpr size_t kNumQuantizedBins = 128;
+
+  float threshold;
+  switch (method) {
+    case CalibrationMethod::kPercentile:
+      threshold = statistics.histogram.PercentileThreshold(percentile);
+      break;
+    case CalibrationMethod::kEntropy:
+      threshold = statistics.histogram.EntropyThreshold(kNumQuantizedBins);
+      break;
+    default:
+      return {statistics.min, statistics.max};
+  }
+
+  return {std::max(statistics.min, -threshold), std::min(statistics.max, threshold)};
+}
+
+namespace {
+
+void WriteJsonString(std::ostringstream& ss, const std::string& value) {
+  ss << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        ss << "\\\"";
+        break;
+      case '\\':
+        ss << "\\\\";
+        break;
+      case '\n':
+        ss << "\\n";
+        break;
+      case '\t':
+        ss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static const char* hex = "0123456789abcdef";
+          ss << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        } else {
+          ss << c;
+        }
+    }
+  }
+  ss << '"';
+}
+
+const char* CalibrationMethodName(CalibrationMethod method) {
+  switch (method) {
+    case CalibrationMethod::kPercentile:
+      return "percentile";
+    case CalibrationMethod::kEntropy:
+      return "entropy";
+    default:
+      return "minmax";
+  }
+}
+
+}  // namespace
+
+std::string CalibrationTableToJson(const std::vector<CalibrationStatistics>& statistics, CalibrationMethod method,
+                                   double percentile) {
+  std::vector<const CalibrationStatistics*> sorted;
+  sorted.reserve(statistics.size());
+  for (const auto& tensor : statistics) {
+    sorted.push_back(&tensor);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const CalibrationStatistics* a, const CalibrationStatistics* b) {
+    return a->name < b->name;
+  });
+
+  std::ostringstream ss;
+  ss.precision(std::numeric_limits<float>::max_digits10);
+  ss << "{\"method\":\"" << CalibrationMethodName(method) << '"';
+  if (method == CalibrationMethod::kPercentile) {
+    ss << ",\"percentile\":" << percentile;
+  }
+  ss << ",\"tensors\":[";
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    const auto& tensor = *sorted[i];
+    const auto range = ComputeCalibrationRange(tensor, method, percentile);
+
+    // uint8 quantization parameters of the range extended to include zero, like the Python quantization tools
+    const float rmin = std::min(range.first, 0.0f);
+    const float rmax = std::max(range.second, 0.0f);
+    float scale = 1.0f;
+    int zero_point = 0;
+    if (rmax > rmin) {
+      scale = (rmax - rmin) / 255.0f;
+      zero_point = std::clamp(static_cast<int>(std::nearbyint(-rmin / scale)), 0, 255);
+    }
+
+    ss << (i == 0 ? "" : ",") << "{\"name\":";
+    WriteJsonString(ss, tensor.name);
+    ss << ",\"min\":" << tensor.min
+       << ",\"max\":" << tensor.max
+       << ",\"range_min\":" << range.first
+       << ",\"range_max\":" << range.second
+       << ",\"scale\":" << scale
+       << ",\"zero_point\":" << zero_point << '}';
+  }
+  ss << "]}";
+  return ss.str();
+}
+
+}  // namespace onnxruntime
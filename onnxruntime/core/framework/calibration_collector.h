@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class OpKernelContextInternal;
+
+enum class CalibrationMethod {
+  kMinMax,
+  kPercentile,
+  kEntropy,
+};
+
+// Parses "minmax", "percentile" or "entropy".
+bool TryParseCalibrationMethod(const std::string& str, CalibrationMethod& method);
+
+// Streaming histogram of the absolute values of a tensor over [0, range].
+// When a value beyond the range is added, the range is doubled by merging pairs of adjacent bins, so the histogram
+// is updated incrementally without keeping any of the observed values.
+struct CalibrationHistogram {
+  static constexpr size_t kNumBins = 2048;
+
+  std::vector<uint64_t> bin_counts;
+  float range = 0.0f;
+  uint64_t count = 0;
+
+  void Add(gsl::span<const float> values, float abs_max);
+
+  // Smallest threshold below which the given percentile (0 - 100) of the absolute values lie.
+  float PercentileThreshold(double percentile) const;
+
+  // Threshold that minimizes the KL divergence between the distribution of the absolute values and its
+  // quantization to num_quantized_bins levels.
+  float EntropyThreshold(size_t num_quantized_bins) const;
+};
+
+// Statistics collected for one tensor.
+struct CalibrationStatistics {
+  std::string name;
+  float min = 0.0f;
+  float max = 0.0f;
+  CalibrationHistogram histogram;
+};
+
+// Collects calibration statistics of node outputs during normal Run calls, for the static quantization of a model.
+//
+// The outputs are observed right after their producer ran, so they do not have to be fetched or kept alive.
+// Only float and float16 tensors that are located on CPU are observed.
+// Updates of each tensor are serialized with a mutex, so concurrent Run calls are supported.
+class CalibrationCollector {
+ public:
+  // Observes the outputs in tensor_names, or all outputs if tensor_names is empty.
+  // Histograms are only collected for methods other than kMinMax.
+  CalibrationCollector(const GraphViewer& graph_viewer, const InlinedHashSet<std::string>& tensor_names,
+                       CalibrationMethod method, double percentile);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CalibrationCollector);
+
+  CalibrationMethod Method() const noexcept { return method_; }
+  double Percentile() const noexcept { return percentile_; }
+
+  bool IsObserved(NodeIndex node_index) const noexcept {
+    return node_index < node_observers_.size() && !node_observers_[node_index].empty();
+  }
+
+  // Adds the outputs of a node that just ran to the statistics.
+  void Observe(NodeIndex node_index, OpKernelContextInternal& context);
+
+  // Appends the statistics of all tensors that were observed at least once.
+  void GetStatistics(std::vector<CalibrationStatistics>& statistics) const;
+
+ private:
+  struct Observer {
+    mutable OrtMutex mutex;
+    CalibrationStatistics statistics;
+    bool observed = false;
+  };
+
+  const CalibrationMethod method_;
+  const double percentile_;
+  std::vector<std::unique_ptr<Observer>> observers_;
+  // per node, the output index and observer of each observed output
+  std::vector<InlinedVector<std::pair<int, Observer*>>> node_observers_;
+};
+
+// Range of a tensor for the calibration method, before it is extended to include zero for quantization.
+std::pair<float, float> ComputeCalibrationRange(const CalibrationStatistics& statistics, CalibrationMethod method,
+                                                double percentile);
+
+// Serializes the observed ranges and the resulting uint8 scales and zero points to JSON.
+std::string CalibrationTableToJson(const std::vector<CalibrationStatistics>& statistics, CalibrationMethod method,
+                                   double percentile);
+
+}  // namespace onnxruntime
@@ -3,9 +3,53 @@
 // Licensed under the MIT License.
 #include "core/framework/copy.h"
 
+#if defined(_M_AMD64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#include <emmintrin.h>
+#define ORT_HAS_SSE2_STREAMING_STORES
+#endif
+
 namespace onnxruntime {
 
+void NonTemporalCopy(void* dst, const void* src, size_t count) {
+#if defined(ORT_HAS_SSE2_STREAMING_STORES)
+  auto* d = static_cast<uint8_t*>(dst);
+  const auto* s = static_cast<const uint8_t*>(src);
+
+  // streaming stores need 16 byte aligned destinations, copy the unaligned head normally
+  const size_t head = std::min(count, (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15);
+  memcpy(d, s, head);
+  d += head;
+  s += head;
+  count -= head;
+
+  for (; count >= 64; count -= 64, d += 64, s += 64) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+    const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+    const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d), v0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), v1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), v2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), v3);
+  }
+
+  memcpy(d, s, count);
+
+  // make the streaming stores visible to other threads before the copy is considered done
+  _mm_sfence();
+#else
+  memcpy(dst, src, count);
+#endif
+}
+
 TensorShapeVector StridesForTensor(const Tensor& tensor) {
+#ifdef ENABLE_STRIDED_TENSORS
+  if (!tensor.IsContiguous()) {
+    const auto strides = tensor.Strides();
+    return TensorShapeVector(strides.begin(), strides.end());
+  }
+#endif
+
   const auto& shape = tensor.Shape();
   TensorShapeVector strides(shape.NumDimensions());
   int64_t running_size = 1;
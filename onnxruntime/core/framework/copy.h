@@ -15,8 +15,18 @@ namespace onnxruntime {
 void CoalesceDimensions(
     std::initializer_list<std::reference_wrapper<TensorShapeVector>>&& tensors_strides, TensorShapeVector& shape);
 
+// The strides of the tensor in elements, which are the ones of a strided tensor view if it is not contiguous.
 TensorShapeVector StridesForTensor(const Tensor& tensor);
 
+// memcpy with streaming stores that bypass the cache. Falls back to memcpy on platforms without them.
+void NonTemporalCopy(void* dst, const void* src, size_t count);
+
+// Copies moving at least this many bytes in total with contiguous spans of at least
+// kNonTemporalCopyMinSpanBytes write their output with NonTemporalCopy, as the output would not
+// stay in the cache anyway and reading it in first only costs memory bandwidth.
+constexpr size_t kNonTemporalCopyThresholdBytes = 4 * 1024 * 1024;
+constexpr size_t kNonTemporalCopyMinSpanBytes = 1024;
+
 namespace strided_copy_detail {
 
 template <typename T>
@@ -29,11 +39,15 @@ void Copy1DNonContiguous(T* dst, int64_t dst_stride, const T* src, int64_t src_s
 }
 
 template <typename T>
-void Copy1DContiguous(T* dst, const T* src, std::ptrdiff_t count) {
+void Copy1DContiguous(T* dst, const T* src, std::ptrdiff_t count, bool non_temporal = false) {
   if constexpr (std::is_same_v<std::string, T>) {
     Copy1DNonContiguous(dst, 1, src, 1, count);
   } else {
-    memcpy(dst, src, count * sizeof(T));
+    if (non_temporal) {
+      NonTemporalCopy(dst, src, count * sizeof(T));
+    } else {
+      memcpy(dst, src, count * sizeof(T));
+    }
   }
 }
 
@@ -154,10 +168,15 @@ void StridedCopy(concurrency::ThreadPool* thread_pool,
     // the size of contiguous spans that we can copy before having to advance the non-contiguous stride
     std::ptrdiff_t contiguous_span_size = static_cast<std::ptrdiff_t>(dims == 2 ? copy_shape[1] : copy_shape[0]);
 
+    const bool non_temporal =
+        static_cast<size_t>(total_num_elements_to_copy) * sizeof(T) >= kNonTemporalCopyThresholdBytes &&
+        static_cast<size_t>(contiguous_span_size) * sizeof(T) >= kNonTemporalCopyMinSpanBytes;
+
     concurrency::ThreadPool::TryParallelFor(
         thread_pool, static_cast<std::ptrdiff_t>(total_num_elements_to_copy),
         {static_cast<float>(sizeof(T)), static_cast<float>(sizeof(T)), 1.0F},
-        [src_stride, dst_stride, dst, src, contiguous_span_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+        [src_stride, dst_stride, dst, src, contiguous_span_size, non_temporal](std::ptrdiff_t first,
+                                                                               std::ptrdiff_t last) {
           // get the current inner and outer index
           std::ptrdiff_t inner = first % contiguous_span_size;
           std::ptrdiff_t outer = first / contiguous_span_size;
@@ -170,7 +189,7 @@ void StridedCopy(concurrency::ThreadPool* thread_pool,
             auto elements_to_copy = contiguous_span_size - inner;
             // never copy more than what is in our partition
             elements_to_copy = std::min<std::ptrdiff_t>(elements_to_copy, last - first);
-            strided_copy_detail::Copy1DContiguous<T>(dst + dst_idx, src + src_idx, elements_to_copy);
+            strided_copy_detail::Copy1DContiguous<T>(dst + dst_idx, src + src_idx, elements_to_copy, non_temporal);
             inner = 0;
             outer++;
             first += elements_to_copy;
@@ -182,7 +201,7 @@ void StridedCopy(concurrency::ThreadPool* thread_pool,
 
           // Step 2: copy contiguous span by contiguous span until we reach the penultimate span
           while (first < last - contiguous_span_size) {
-            strided_copy_detail::Copy1DContiguous<T>(dst + dst_idx, src + src_idx, contiguous_span_size);
+            strided_copy_detail::Copy1DContiguous<T>(dst + dst_idx, src + src_idx, contiguous_span_size, non_temporal);
             dst_idx += dst_stride;
             src_idx += src_stride;
             first += contiguous_span_size;
@@ -191,7 +210,7 @@ void StridedCopy(concurrency::ThreadPool* thread_pool,
           // element in our partition
           ORT_ENFORCE(last >= first);
           auto last_span_size = last - first;
-          strided_copy_detail::Copy1DContiguous<T>(dst + dst_idx, src + src_idx, last_span_size);
+          strided_copy_detail::Copy1DContiguous<T>(dst + dst_idx, src + src_idx, last_span_size, non_temporal);
         });
   } else {
     // enforce that the lambda doesn't change anything
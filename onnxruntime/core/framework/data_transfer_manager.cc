@@ -2,12 +2,23 @@
 // Licensed under the MIT License.
 
 #include "core/framework/data_transfer_manager.h"
+#include "core/common/native_tracing.h"
+#include "core/common/run_stats.h"
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 
 namespace onnxruntime {
 using namespace common;
 
+namespace {
+void RecordCopy(const Tensor& src) {
+  if (RunStats* run_stats = RunStats::Current()) {
+    run_stats->memcpy_bytes.fetch_add(static_cast<int64_t>(src.SizeInBytes()), std::memory_order_relaxed);
+    run_stats->num_memcpys.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+}  // namespace
+
 Status DataTransferManager::RegisterDataTransfer(std::unique_ptr<IDataTransfer> data_transfer) {
   if (nullptr == data_transfer) {
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "data_transfer registered is nullptr.");
@@ -37,6 +48,8 @@ Status DataTransferManager::CopyTensor(const Tensor& src, Tensor& dst) const {
       continue;
     }
 
+    profiling::NativeTraceSpan span("Memcpy");
+    RecordCopy(src);
     return data_transfer->CopyTensor(src, dst);
   }
 
@@ -58,6 +71,8 @@ Status DataTransferManager::CopyTensorAsync(const Tensor& src, Tensor& dst, Stre
       continue;
     }
 
+    profiling::NativeTraceSpan span("Memcpy");
+    RecordCopy(src);
     return data_transfer->CopyTensorAsync(src, dst, stream);
   }
 
@@ -126,6 +141,10 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
 
   // all copies are between the same devices so we can do them all at once
   if (all_same) {
+    profiling::NativeTraceSpan span("Memcpy");
+    for (const auto& pair : src_dst_pairs) {
+      RecordCopy(pair.src.get());
+    }
     return first_dt->CopyTensors(src_dst_pairs);
   }
 
@@ -134,6 +153,7 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
   // batch as much as possible.
 
   // copy the first one as we already did the IDataTransfer lookup
+  RecordCopy(first_pair.src.get());
   ORT_RETURN_IF_ERROR(first_pair.src_stream ? first_dt->CopyTensorAsync(first_pair.src.get(), first_pair.dst.get(), *(first_pair.src_stream))
                                             : first_dt->CopyTensor(first_pair.src.get(), first_pair.dst.get()));
 
@@ -187,6 +207,7 @@ common::Status DataTransferManager::CopySparseTensors(const std::vector<IDataTra
   // batch as much as possible.
 
   // copy the first one as we already did the IDataTransfer lookup
+  RecordCopy(first_pair.src.get());
   ORT_RETURN_IF_ERROR(first_pair.src.get().Copy(*first_dt, first_pair.dst));
 
   for (auto cur_pair = src_dst_pairs.cbegin() + 1, end_pair = src_dst_pairs.cend(); cur_pair != end_pair; ++cur_pair) {
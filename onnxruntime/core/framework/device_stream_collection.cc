@@ -33,13 +33,17 @@ class DeviceStreamCollectionImpl {
   void ReleaseSingleStreamBuffers(Stream* stream) {
     if (!stream) return;
     for (auto it : allocators_) {
-      if (it.second->Info().device == stream->GetDevice() &&
-          it.second->Info().alloc_type == OrtArenaAllocator) {
+      if (it.second->Info().device != stream->GetDevice()) {
+        continue;
+      }
+      if (it.second->Info().alloc_type == OrtArenaAllocator) {
         auto* arena_alloc = static_cast<BFCArena*>(it.second.get());
         auto* stream_aware_alloc = StreamAwareArena::FromBFCArena(*arena_alloc);
         if (stream_aware_alloc) {
           stream_aware_alloc->ReleaseStreamBuffers(stream);
         }
+      } else if (it.second->IsStreamOrdered()) {
+        it.second->ReleaseStreamOrderedBuffers(stream);
       }
     }
   }
@@ -128,13 +132,14 @@ Stream* DeviceStreamCollection::GetRootStream() const {
   return impl_->GetRootStream();
 }
 
-DeviceStreamCollectionHolder::DeviceStreamCollectionHolder(const SessionState* session_state)
+DeviceStreamCollectionHolder::DeviceStreamCollectionHolder(const SessionState* session_state, bool reuse_streams)
     : session_state_(session_state),
-      p_(session_state->AcquireDeviceStreamCollection()) {
+      reuse_streams_(reuse_streams),
+      p_(session_state->AcquireDeviceStreamCollection(reuse_streams)) {
 }
 
 DeviceStreamCollectionHolder::~DeviceStreamCollectionHolder() {
-  if (p_) {
+  if (p_ && reuse_streams_) {
     session_state_->RecycleDeviceStreamCollection(std::move(p_));
   }
 }
@@ -47,13 +47,16 @@ class DeviceStreamCollection {
 };
 
 struct DeviceStreamCollectionHolder {
-  DeviceStreamCollectionHolder(const SessionState* session_state);
+  // If reuse_streams is not set, the streams are created for this holder only, e.g. when the EP binds them to the
+  // thread running the session.
+  DeviceStreamCollectionHolder(const SessionState* session_state, bool reuse_streams = true);
   DeviceStreamCollectionHolder() = delete;
   DeviceStreamCollectionHolder(const DeviceStreamCollectionHolder&) = delete;
 
   ~DeviceStreamCollectionHolder();
 
   const SessionState* session_state_;
+  bool reuse_streams_;
   std::unique_ptr<DeviceStreamCollection> p_;
 };
 
@@ -3,8 +3,10 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
 #include <sstream>
 
+#include "core/common/run_stats.h"
 #include "core/framework/mem_pattern_planner.h"
 #include "core/framework/execution_plan_base.h"
 #include "core/framework/sequential_execution_plan.h"
@@ -148,6 +150,12 @@ OrtValue* IExecutionFrame::GetMutableNodeInputOrOutputMLValue(int index) {
   return const_cast<OrtValue*>(GetNodeInputOrOutputMLValue(index));
 }
 
+void IExecutionFrame::ForEachMLValue(const std::function<void(int, const OrtValue&)>& fn) const {
+  for (size_t ort_value_idx = 0; ort_value_idx < all_values_size_; ++ort_value_idx) {
+    fn(static_cast<int>(ort_value_idx), all_values_[ort_value_idx]);
+  }
+}
+
 // TO DO: make it thread-safe
 // This method is not thread-safe!
 // Return S_OK and nullptr if index map to a value that is an unused optional input/output
@@ -357,7 +365,8 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
       device_streams_(device_streams),
 #endif
       session_state_(session_state),
-      mem_patterns_(nullptr) {
+      mem_patterns_(nullptr),
+      run_stats_(RunStats::Current()) {
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -406,7 +415,16 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      // a pattern planned ahead of execution for the fixed input shapes of the model comes first
+      mem_patterns_ = session_state.GetStaticMemoryPatternGroup(feeds, feed_mlvalue_idxs);
+      if (!mem_patterns_) {
+        if (session_state.UseMemoryPatternShapeBuckets()) {
+          bucketed_mem_patterns_ = session_state.GetBucketedMemoryPatternGroup(feeds, min_block_sizes_);
+          mem_patterns_ = bucketed_mem_patterns_.get();
+        } else {
+          mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+        }
+      }
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
@@ -470,6 +488,9 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
             if (buffer != nullptr) {
               buffers_[location] = BufferUniquePtr(buffer, BufferDeleter(alloc));
+              if (run_stats_ != nullptr) {
+                run_stats_->AddAllocation(static_cast<int64_t>(mem_patterns_->patterns[i].PeakSize()));
+              }
             }
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
             // Record activation memory pattern
@@ -557,8 +578,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // a shape bucket pattern is planned for the largest tensors of the bucket, so smaller ones fit too.
+          if (block->size_ == size || (bucketed_mem_patterns_ && block->size_ > size)) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
@@ -573,6 +595,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
                                                    << ", block in memory pattern size is: " << block->size_
                                                    << " but the actual size is: " << size
                                                    << ", fall back to default allocation behavior";
+            if (bucketed_mem_patterns_) {
+              std::lock_guard<std::mutex> lock(mem_pattern_misfits_mutex_);
+              mem_pattern_misfits_.emplace_back(ort_value_index, size);
+            }
           }
         }
         // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
@@ -595,6 +621,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
           current_stream->GetDevice().Type(), current_stream->GetDevice().Type());
       void* p_data = stream_aware_alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
       Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
+    } else if (alloc->IsStreamOrdered()) {
+      size_t buffer_size = Tensor::CalculateTensorStorageSize(element_type, shape);
+      void* p_data = alloc->AllocOnStreamOrdered(buffer_size, current_stream);
+      Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
     } else {
       Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
     }
@@ -605,6 +635,12 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
   }
 
+  if (run_stats_ != nullptr) {
+    run_stats_->AddAllocation(static_cast<int64_t>(size));
+    std::lock_guard<std::mutex> lock(run_stats_mutex_);
+    run_stats_buffer_sizes_[ort_value_index] = size;
+  }
+
   // trace the memory allocation.
   // don't trace the memory allocation on string tensors, as it need
   // placement new, we don't support it in memory pattern optimization.
@@ -886,6 +922,14 @@ void ExecutionFrame::VerifyOutputSizes(int output_index, const Node& node, const
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
   TraceFree(ort_value_idx);
+  if (run_stats_ != nullptr) {
+    std::lock_guard<std::mutex> lock(run_stats_mutex_);
+    auto it = run_stats_buffer_sizes_.find(ort_value_idx);
+    if (it != run_stats_buffer_sizes_.end()) {
+      run_stats_->AddRelease(static_cast<int64_t>(it->second));
+      run_stats_buffer_sizes_.erase(it);
+    }
+  }
   return Status::OK();
 }
 
@@ -901,6 +945,13 @@ void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
         allocation_plan.alloc_kind == AllocKind::kAllocatedExternally) {
       return;
     }
+    // planning a shape bucket again: plan blocks for the largest tensors seen in the bucket
+    if (min_block_sizes_) {
+      auto it = min_block_sizes_->find(ort_value_idx);
+      if (it != min_block_sizes_->end()) {
+        size = std::max(size, it->second);
+      }
+    }
     auto status = planner_->TraceAllocation(ort_value_idx, size);
     if (!status.IsOK()) {
       LOGS(session_state_.Logger(), WARNING) << "TraceAllocation for ort_value_idx=" << ort_value_idx
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "core/common/common.h"
@@ -23,6 +26,7 @@ class DataTransferManager;
 class SessionState;
 class OrtValueNameIdxMap;
 struct MemoryPatternGroup;
+struct RunStats;
 class NodeIndexInfo;
 class Stream;
 #ifdef ORT_ENABLE_STREAM
@@ -54,6 +58,9 @@ class IExecutionFrame {
   const OrtValue* GetNodeInputOrOutputMLValue(int index) const;
   OrtValue* GetMutableNodeInputOrOutputMLValue(int index);
 
+  // Call fn with the index of each OrtValue held by the frame, allocated or not.
+  void ForEachMLValue(const std::function<void(int ort_value_idx, const OrtValue& ort_value)>& fn) const;
+
 #ifdef ENABLE_ATEN
   // Override the index-th output with ort_value
   Status SetOutputMLValue(int index, const OrtValue& ort_value);
@@ -166,6 +173,16 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // Whether the execution uses a cached shape bucket memory pattern.
+  bool UsesBucketedMemoryPattern() const {
+    return bucketed_mem_patterns_ != nullptr;
+  }
+
+  // OrtValue indices and sizes of the tensors that didn't fit their block in the shape bucket memory pattern.
+  gsl::span<const std::pair<int, size_t>> GetBucketedMemoryPatternMisfits() const {
+    return mem_pattern_misfits_;
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is sucessful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
@@ -233,6 +250,13 @@ class ExecutionFrame final : public IExecutionFrame {
   // kernel's input/output tensors.
   const MemoryPatternGroup* mem_patterns_;
 
+  // Owns mem_patterns_ if the session caches memory patterns per shape bucket.
+  std::shared_ptr<const MemoryPatternGroup> bucketed_mem_patterns_;
+  // Minimum block sizes by OrtValue index used by planner_ when a shape bucket is planned again.
+  std::shared_ptr<const InlinedHashMap<int, size_t>> min_block_sizes_;
+  std::mutex mem_pattern_misfits_mutex_;
+  InlinedVector<std::pair<int, size_t>> mem_pattern_misfits_;
+
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::optional<OrtValuePatternPlanner> planner_;
@@ -240,6 +264,12 @@ class ExecutionFrame final : public IExecutionFrame {
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
 
+  // Stats of the run the frame executes, if it collects them, with the sizes of the buffers the frame allocated
+  // by OrtValue index so that their release can be recorded.
+  RunStats* run_stats_{nullptr};
+  std::mutex run_stats_mutex_;
+  InlinedHashMap<int, size_t> run_stats_buffer_sizes_;
+
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
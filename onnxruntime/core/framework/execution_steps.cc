@@ -53,14 +53,12 @@ Status LaunchKernelStep::Execute(StreamExecutionContext& ctx,
                                  SessionScope& session_scope,
                                  const bool& terminate_flag,
                                  bool& continue_flag) {
-#ifdef ENABLE_TRAINING
-  // legacy code required by ORTTrainer. Should be removed when ORTTrainer is removed
+  // skip the nodes the fetches of the run don't depend on
   auto* node_to_execute = ctx.GetNodeToExecute();
   if (node_to_execute && node_to_execute->count(node_index_) == 0) {
     continue_flag = true;
     return Status::OK();
   }
-#endif
   onnxruntime::Status status = ExecuteKernel(ctx, node_index_, stream_idx, terminate_flag, session_scope);
   continue_flag = status.IsOK();
   return status;
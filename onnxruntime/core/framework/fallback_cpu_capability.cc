@@ -65,6 +65,8 @@ std::unordered_set<NodeIndex> GetCpuPreferredNodes(const onnxruntime::GraphViewe
   InlinedHashMap<NodeIndex, const KernelCreateInfo*> node_to_kernel;
   node_to_kernel.reserve(tentative_nodes.size());
 
+  InlinedVector<NodeIndex> host_input_producers;
+
   for (auto& node_id : tentative_nodes) {
     provider_nodes.insert(node_id);
     const Node* node = graph.GetNode(node_id);
@@ -88,6 +90,28 @@ std::unordered_set<NodeIndex> GetCpuPreferredNodes(const onnxruntime::GraphViewe
           }
           return Status::OK();
         }));
+
+    // the producers of the inputs that the target EP kernel reads on CPU, e.g. the shape of a Reshape, are also
+    // candidates. if they can run on CPU too, their output is produced where it is consumed instead of being copied
+    // back from the device, which requires a synchronization of the device stream.
+    for (size_t i = 0; i < node->InputDefs().size(); ++i) {
+      if (!node->InputDefs()[i]->Exists() || !kernel_info->kernel_def->IsInputOnCpu(i)) {
+        continue;
+      }
+
+      const Node* producer = graph.GetProducerNode(node->InputDefs()[i]->Name());
+      if (producer != nullptr) {
+        host_input_producers.push_back(producer->Index());
+      }
+    }
+  }
+
+  for (auto node_id : host_input_producers) {
+    // nodes that are not assigned to the target EP already run on CPU
+    if (provider_nodes.find(node_id) != provider_nodes.end()) {
+      candidates.push(node_id);
+      LOGS_DEFAULT(INFO) << "Candidate for fallback CPU execution: " << graph.GetNode(node_id)->Name();
+    }
   }
 
   const auto& graph_inputs = graph.GetInputs();
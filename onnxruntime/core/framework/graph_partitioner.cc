@@ -12,6 +12,7 @@
 #include "core/framework/kernel_lookup.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/partition_cost_model.h"
 #include "core/graph/function.h"
 #include "core/graph/function_utils.h"
 #include "core/graph/graph_viewer.h"
@@ -982,6 +983,19 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
     ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode,
                                                  providers_, kernel_registry_mgr_));
 
+    if (config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMergeSmallDeviceIslands, "0") == "1" &&
+        config_options.GetConfigOrDefault(kOrtSessionOptionsDisableCPUEPFallback, "0") != "1" &&
+        providers_.Get(kCpuExecutionProvider) != nullptr) {
+      ORT_RETURN_IF_ERROR(partition_cost_model::MergeDeviceIslandsToCpu(graph, providers_, kernel_registry_mgr_,
+                                                                       logger));
+    }
+
+    const std::string assignment_file =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPartitionAssignmentFile, "");
+    if (!assignment_file.empty()) {
+      ORT_RETURN_IF_ERROR(partition_cost_model::WriteAssignment(graph, assignment_file));
+    }
+
     bool ep_context_enabled = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextEnable, "0") == "1";
     std::string ep_context_path = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
     if (ep_context_enabled) {
@@ -185,6 +185,12 @@ KernelDefBuilder& KernelDefBuilder::MayStridedInput(int input_index) {
   return *this;
 }
 
+KernelDefBuilder& KernelDefBuilder::VariadicMayStridedInput(int input_offset) {
+  ORT_ENFORCE(input_offset >= 0);
+  kernel_def_->variadic_may_strided_input_offset_ = input_offset;
+  return *this;
+}
+
 KernelDefBuilder& KernelDefBuilder::MayStridedOutput(int input_index, int output_index) {
   kernel_def_->may_strided_output_map_.emplace_back(input_index, output_index);
   return *this;
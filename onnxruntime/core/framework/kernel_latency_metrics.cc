@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_latency_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+size_t LatencyHistogram::BucketIndex(uint64_t duration_ns) {
+  uint64_t duration_us = duration_ns / 1000;
+  size_t bucket = 0;
+  while (duration_us > 0 && bucket < kNumBuckets - 1) {
+    duration_us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBoundUs(size_t bucket) {
+  return bucket < kNumBuckets - 1 ? uint64_t{1} << bucket : 0;
+}
+
+uint64_t LatencyHistogram::PercentileUpperBoundUs(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  const auto rank = static_cast<uint64_t>(std::ceil(static_cast<double>(count) * percentile / 100.0));
+  uint64_t cumulative = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets - 1; ++bucket) {
+    cumulative += bucket_counts[bucket];
+    if (cumulative >= std::max<uint64_t>(rank, 1)) {
+      return BucketUpperBoundUs(bucket);
+    }
+  }
+  // the percentile is in the unbounded bucket, the maximum is the best bound available
+  return (max_ns + 999) / 1000;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    bucket_counts[bucket] += other.bucket_counts[bucket];
+  }
+  count += other.count;
+  total_ns += other.total_ns;
+  max_ns = std::max(max_ns, other.max_ns);
+}
+
+KernelLatencyMetrics::KernelLatencyMetrics(const GraphViewer& graph_viewer, uint32_t sampling_interval)
+    : sampling_interval_(std::max<uint32_t>(sampling_interval, 1)),
+      num_nodes_(graph_viewer.MaxNodeIndex()),
+      nodes_(std::make_unique<NodeLatency[]>(num_nodes_)),
+      node_infos_(num_nodes_) {
+  for (const auto& node : graph_viewer.Nodes()) {
+    auto& info = node_infos_[node.Index()];
+    info.node_name = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
+    info.op_type = node.OpType();
+    info.domain = node.Domain();
+    info.provider = node.GetExecutionProviderType();
+  }
+}
+
+void KernelLatencyMetrics::Record(NodeIndex node_index, uint64_t duration_ns) noexcept {
+  if (node_index >= num_nodes_) {
+    return;
+  }
+
+  auto& node = nodes_[node_index];
+  node.bucket_counts[LatencyHistogram::BucketIndex(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+  node.count.fetch_add(1, std::memory_order_relaxed);
+  node.total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+  uint64_t max_ns = node.max_ns.load(std::memory_order_relaxed);
+  while (duration_ns > max_ns &&
+         !node.max_ns.compare_exchange_weak(max_ns, duration_ns, std::memory_order_relaxed)) {
+  }
+}
+
+void KernelLatencyMetrics::GetKernelLatencies(std::vector<KernelLatency>& kernel_latencies) const {
+  for (size_t node_index = 0; node_index < num_nodes_; ++node_index) {
+    const auto& node = nodes_[node_index];
+    const uint64_t count = node.count.load(std::memory_order_relaxed);
+    if (count == 0) {
+      continue;
+    }
+
+    const auto& info = node_infos_[node_index];
+    KernelLatency latency{info.node_name, info.op_type, info.domain, info.provider, {}};
+    // the histogram is read without stopping writers, so count is recomputed from the buckets to stay consistent
+    for (size_t bucket = 0; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+      latency.histogram.bucket_counts[bucket] = node.bucket_counts[bucket].load(std::memory_order_relaxed);
+      latency.histogram.count += latency.histogram.bucket_counts[bucket];
+    }
+    latency.histogram.total_ns = node.total_ns.load(std::memory_order_relaxed);
+    latency.histogram.max_ns = node.max_ns.load(std::memory_order_relaxed);
+    kernel_latencies.push_back(std::move(latency));
+  }
+}
+
+void KernelLatencyMetrics::Reset() noexcept {
+  for (size_t node_index = 0; node_index < num_nodes_; ++node_index) {
+    auto& node = nodes_[node_index];
+    for (auto& bucket_count : node.bucket_counts) {
+      bucket_count.store(0, std::memory_order_relaxed);
+    }
+    node.count.store(0, std::memory_order_relaxed);
+    node.total_ns.store(0, std::memory_order_relaxed);
+    node.max_ns.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::vector<KernelLatency> AggregateKernelLatenciesByOpType(const std::vector<KernelLatency>& kernel_latencies) {
+  std::map<std::tuple<std::string, std::string>, KernelLatency> by_op_type;
+  for (const auto& kernel : kernel_latencies) {
+    auto& entry = by_op_type[std::make_tuple(kernel.domain, kernel.op_type)];
+    if (entry.histogram.count == 0) {
+      entry.op_type = kernel.op_type;
+      entry.domain = kernel.domain;
+    }
+    if (entry.provider.empty()) {
+      entry.provider = kernel.provider;
+    } else if (entry.provider != kernel.provider) {
+      entry.provider = "mixed";
+    }
+    entry.histogram.Merge(kernel.histogram);
+  }
+
+  std::vector<KernelLatency> result;
+  result.reserve(by_op_type.size());
+  for (auto& entry : by_op_type) {
+    result.push_back(std::move(entry.second));
+  }
+  return result;
+}
+
+namespace {
+
+void WriteJsonString(std::ostringstream& ss, const std::string& value) {
+  ss << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        ss << "\\\"";
+        break;
+      case '\\':
+        ss << "\\\\";
+        break;
+      case '\n':
+        ss << "\\n";
+        break;
+      case '\t':
+        ss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static const char* hex = "0123456789abcdef";
+          ss << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        } else {
+          ss << c;
+        }
+    }
+  }
+  ss << '"';
+}
+
+void WriteKernelLatencies(std::ostringstream& ss, const std::vector<KernelLatency>& kernel_latencies,
+                          bool write_node_name) {
+  ss << '[';
+  for (size_t i = 0; i < kernel_latencies.size(); ++i) {
+    const auto& kernel = kernel_latencies[i];
+    const auto& histogram = kernel.histogram;
+    ss << (i == 0 ? "" : ",") << '{';
+    if (write_node_name) {
+      ss << "\"name\":";
+      WriteJsonString(ss, kernel.node_name);
+      ss << ',';
+    }
+    ss << "\"op_type\":";
+    WriteJsonString(ss, kernel.op_type);
+    ss << ",\"domain\":";
+    WriteJsonString(ss, kernel.domain);
+    ss << ",\"provider\":";
+    WriteJsonString(ss, kernel.provider);
+    ss << ",\"count\":" << histogram.count
+       << ",\"total_us\":" << histogram.total_ns / 1000
+       << ",\"max_us\":" << histogram.max_ns / 1000
+       << ",\"p50_us\":" << histogram.PercentileUpperBoundUs(50)
+       << ",\"p99_us\":" << histogram.PercentileUpperBoundUs(99)
+       << ",\"buckets\":[";
+    for (size_t bucket = 0; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+      ss << (bucket == 0 ? "" : ",") << histogram.bucket_counts[bucket];
+    }
+    ss << "]}";
+  }
+  ss << ']';
+}
+
+}  // namespace
+
+std::string KernelLatenciesToJson(const std::vector<KernelLatency>& kernel_latencies, uint32_t sampling_interval) {
+  std::ostringstream ss;
+  ss << "{\"sampling_interval\":" << sampling_interval << ",\"bucket_upper_bounds_us\":[";
+  for (size_t bucket = 0; bucket < LatencyHistogram::kNumBuckets - 1; ++bucket) {
+    ss << (bucket == 0 ? "" : ",") << LatencyHistogram::BucketUpperBoundUs(bucket);
+  }
+  ss << "],\"op_types\":";
+  WriteKernelLatencies(ss, AggregateKernelLatenciesByOpType(kernel_latencies), false);
+  ss << ",\"kernels\":";
+  WriteKernelLatencies(ss, kernel_latencies, true);
+  ss << '}';
+  return ss.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+// Histogram of kernel latencies with power of two buckets:
+// bucket 0 counts latencies below 1us, bucket i latencies in [2^(i-1), 2^i) us, the last bucket all larger ones.
+struct LatencyHistogram {
+  static constexpr size_t kNumBuckets = 32;
+
+  std::array<uint64_t, kNumBuckets> bucket_counts{};
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+
+  static size_t BucketIndex(uint64_t duration_ns);
+
+  // Exclusive upper bound of a bucket in microseconds, 0 for the unbounded last bucket.
+  static uint64_t BucketUpperBoundUs(size_t bucket);
+
+  // Upper bound of the bucket that holds the given percentile (0 - 100) of the recorded latencies.
+  uint64_t PercentileUpperBoundUs(double percentile) const;
+
+  void Merge(const LatencyHistogram& other);
+};
+
+// Latencies recorded for one kernel of a graph.
+struct KernelLatency {
+  std::string node_name;
+  std::string op_type;
+  std::string domain;
+  std::string provider;
+  LatencyHistogram histogram;
+};
+
+// Always-on kernel latency metrics of a session state.
+//
+// Every sampling_interval-th execution of each kernel is timed and added to the histogram of its node.
+// Kernels that are not sampled only pay for one relaxed atomic increment, so the metrics can stay enabled in
+// production. All updates are lock free, which allows concurrent Run calls.
+// For kernels that run asynchronously on a device, the latency is the time to launch the kernel.
+class KernelLatencyMetrics {
+ public:
+  KernelLatencyMetrics(const GraphViewer& graph_viewer, uint32_t sampling_interval);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelLatencyMetrics);
+
+  uint32_t SamplingInterval() const noexcept { return sampling_interval_; }
+
+  // Whether this execution of the node is timed.
+  bool ShouldSample(NodeIndex node_index) noexcept {
+    return node_index < num_nodes_ &&
+           nodes_[node_index].executions.fetch_add(1, std::memory_order_relaxed) % sampling_interval_ == 0;
+  }
+
+  void Record(NodeIndex node_index, uint64_t duration_ns) noexcept;
+
+  // Appends the latencies of all kernels that were sampled at least once.
+  void GetKernelLatencies(std::vector<KernelLatency>& kernel_latencies) const;
+
+  void Reset() noexcept;
+
+ private:
+  struct NodeLatency {
+    std::atomic<uint64_t> executions{0};
+    std::array<std::atomic<uint64_t>, LatencyHistogram::kNumBuckets> bucket_counts{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+  };
+
+  struct NodeInfo {
+    std::string node_name;
+    std::string op_type;
+    std::string domain;
+    std::string provider;
+  };
+
+  const uint32_t sampling_interval_;
+  const size_t num_nodes_;
+  std::unique_ptr<NodeLatency[]> nodes_;
+  std::vector<NodeInfo> node_infos_;
+};
+
+// Sums the histograms of kernels with the same domain and op type.
+std::vector<KernelLatency> AggregateKernelLatenciesByOpType(const std::vector<KernelLatency>& kernel_latencies);
+
+// Serializes per op type and per kernel latencies to JSON.
+std::string KernelLatenciesToJson(const std::vector<KernelLatency>& kernel_latencies, uint32_t sampling_interval);
+
+}  // namespace onnxruntime
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_result_cache.h"
+
+#include <cstring>
+
+#include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+template <typename T>
+void AppendBytes(std::string& key, const T& value) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool IsMemoizableTensor(const OrtValue& value) {
+  if (!value.IsTensor() || !value.IsAllocated()) {
+    return false;
+  }
+  const Tensor& tensor = value.Get<Tensor>();
+  return tensor.Location().device.Type() == OrtDevice::CPU && !tensor.IsDataTypeString();
+}
+}  // namespace
+
+KernelResultCache::KernelResultCache(const GraphViewer& graph_viewer,
+                                     const InlinedHashSet<std::string>& output_names,
+                                     size_t capacity_bytes, AllocatorPtr allocator)
+    : capacity_bytes_(capacity_bytes), allocator_(std::move(allocator)), memoized_nodes_(graph_viewer.MaxNodeIndex()) {
+  for (const auto& node : graph_viewer.Nodes()) {
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (output->Exists() && output_names.count(output->Name()) != 0) {
+        memoized_nodes_[node.Index()] = true;
+        break;
+      }
+    }
+  }
+}
+
+bool KernelResultCache::MakeKey(const OpKernel& kernel, const OpKernelContextInternal& context,
+                                std::string& key) const {
+  key.clear();
+  AppendBytes(key, kernel.Node().Index());
+
+  const int input_count = context.InputCount();
+  for (int i = 0; i < input_count; ++i) {
+    const Tensor* constant_input = nullptr;
+    if (kernel.Info().TryGetConstantInput(i, &constant_input)) {
+      key.push_back('c');
+      continue;
+    }
+
+    const OrtValue* input = context.GetInputMLValue(i);
+    if (input == nullptr) {
+      key.push_back('n');
+      continue;
+    }
+    if (!IsMemoizableTensor(*input)) {
+      return false;
+    }
+
+    const Tensor& tensor = input->Get<Tensor>();
+    const auto dims = tensor.Shape().GetDims();
+    key.push_back('t');
+    AppendBytes(key, tensor.DataType());
+    AppendBytes(key, dims.size());
+    key.append(reinterpret_cast<const char*>(dims.data()), dims.size_bytes());
+    key.append(static_cast<const char*>(tensor.DataRaw()), tensor.SizeInBytes());
+  }
+
+  return true;
+}
+
+bool KernelResultCache::TryReuse(const std::string& key, OpKernelContextInternal& context) {
+  std::vector<OrtValue> outputs;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    // the values share the buffers, which stay alive after an eviction until the copies below are done
+    outputs = it->second->outputs;
+  }
+
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (!outputs[i].IsAllocated()) {
+      continue;
+    }
+    const Tensor& cached = outputs[i].Get<Tensor>();
+    Tensor* output = context.Output(static_cast<int>(i), cached.Shape());
+    ORT_ENFORCE(output != nullptr, "Failed to allocate the memoized output ", i);
+    memcpy(output->MutableDataRaw(), cached.DataRaw(), cached.SizeInBytes());
+  }
+
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void KernelResultCache::Insert(std::string&& key, const OpKernelContextInternal& context) {
+  size_t bytes = key.size();
+  const int output_count = context.OutputCount();
+  for (int i = 0; i < output_count; ++i) {
+    const OrtValue* output = context.GetOutputMLValue(i);
+    if (output != nullptr) {
+      if (!IsMemoizableTensor(*output)) {
+        return;
+      }
+      bytes += output->Get<Tensor>().SizeInBytes();
+    }
+  }
+  if (bytes > capacity_bytes_) {
+    return;
+  }
+
+  std::vector<OrtValue> outputs(output_count);
+  for (int i = 0; i < output_count; ++i) {
+    const OrtValue* output = context.GetOutputMLValue(i);
+    if (output != nullptr) {
+      const Tensor& tensor = output->Get<Tensor>();
+      Tensor::InitOrtValue(tensor.DataType(), tensor.Shape(), allocator_, outputs[i]);
+      memcpy(outputs[i].GetMutable<Tensor>()->MutableDataRaw(), tensor.DataRaw(), tensor.SizeInBytes());
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (index_.count(key) != 0) {
+    return;  // inserted by a concurrent run
+  }
+
+  while (memory_usage_ + bytes > capacity_bytes_ && !entries_.empty()) {
+    auto last = std::prev(entries_.end());
+    memory_usage_ -= last->bytes;
+    index_.erase(*last->key);
+    entries_.erase(last);
+  }
+
+  entries_.push_front(Entry{nullptr, std::move(outputs), bytes});
+  auto inserted = index_.emplace(std::move(key), entries_.begin()).first;
+  entries_.front().key = &inserted->first;
+  memory_usage_ += bytes;
+}
+
+size_t KernelResultCache::MemoryUsage() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return memory_usage_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class OpKernel;
+class OpKernelContextInternal;
+
+// Memoizes the outputs of selected nodes across Run calls, keyed by the contents of their inputs, so that a node
+// fed the same inputs as in an earlier run copies its earlier outputs instead of running its kernel.
+//
+// The nodes are selected by naming one of their outputs, and shall be deterministic. Constant initializer inputs are
+// not part of the key. A node is only memoized when its other inputs and its outputs are non-string tensors on CPU.
+// Entries are evicted least recently used first when their total size, inputs included, exceeds the capacity.
+// Lookups and insertions are serialized with a mutex, so concurrent Run calls are supported.
+class KernelResultCache {
+ public:
+  KernelResultCache(const GraphViewer& graph_viewer, const InlinedHashSet<std::string>& output_names,
+                    size_t capacity_bytes, AllocatorPtr allocator);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelResultCache);
+
+  bool IsMemoized(NodeIndex node_index) const noexcept {
+    return node_index < memoized_nodes_.size() && memoized_nodes_[node_index];
+  }
+
+  // Builds the key of the inputs of a memoized node that is about to run.
+  // Returns false if the inputs of this run cannot be memoized.
+  bool MakeKey(const OpKernel& kernel, const OpKernelContextInternal& context, std::string& key) const;
+
+  // Copies the outputs stored for key to the outputs of the node. Returns false if there are none.
+  bool TryReuse(const std::string& key, OpKernelContextInternal& context);
+
+  // Stores copies of the outputs of the node that just ran for key.
+  void Insert(std::string&& key, const OpKernelContextInternal& context);
+
+  uint64_t Hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+  uint64_t Misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+  size_t MemoryUsage() const;
+
+ private:
+  struct Entry {
+    const std::string* key = nullptr;  // owned by the index
+    std::vector<OrtValue> outputs;     // empty OrtValue for missing optional outputs
+    size_t bytes = 0;
+  };
+  using EntryList = std::list<Entry>;
+
+  const size_t capacity_bytes_;
+  const AllocatorPtr allocator_;
+  std::vector<bool> memoized_nodes_;
+
+  mutable OrtMutex mutex_;
+  size_t memory_usage_ = 0;
+  EntryList entries_;  // most recently used first
+  std::unordered_map<std::string, EntryList::iterator> index_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace onnxruntime
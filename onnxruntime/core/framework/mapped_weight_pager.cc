@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mapped_weight_pager.h"
+
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+void MappedWeightPager::SetMemoryBudget(size_t budget) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  budget_ = budget;
+  EvictToBudget(lru_.empty() ? nullptr : lru_.front().owner);
+}
+
+size_t MappedWeightPager::MemoryBudget() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return budget_;
+}
+
+void MappedWeightPager::Register(const Env& env, const void* owner, gsl::span<char> mapped_weights) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ORT_ENFORCE(entries_.find(owner) == entries_.end(), "Mapped weights are already registered for this owner.");
+
+  lru_.push_front(Entry{&env, owner, mapped_weights, true});
+  entries_.emplace(owner, lru_.begin());
+  resident_bytes_ += mapped_weights.size();
+  EvictToBudget(owner);
+}
+
+void MappedWeightPager::Unregister(const void* owner) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(owner);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  if (it->second->resident) {
+    resident_bytes_ -= it->second->mapped_weights.size();
+  }
+  lru_.erase(it->second);
+  entries_.erase(it);
+}
+
+void MappedWeightPager::Activate(const void* owner) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(owner);
+  if (it == entries_.end()) {
+    return;
+  }
+
+  auto entry = it->second;
+  lru_.splice(lru_.begin(), lru_, entry);
+  if (!entry->resident) {
+    auto status = entry->env->PrefetchMappedMemoryPages(entry->mapped_weights);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to prefetch mapped weights: " << status.ErrorMessage();
+    }
+    entry->resident = true;
+    resident_bytes_ += entry->mapped_weights.size();
+  }
+
+  EvictToBudget(owner);
+}
+
+size_t MappedWeightPager::ResidentBytes() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return resident_bytes_;
+}
+
+bool MappedWeightPager::IsResident(const void* owner) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(owner);
+  return it != entries_.end() && it->second->resident;
+}
+
+void MappedWeightPager::EvictToBudget(const void* keep) {
+  if (budget_ == 0) {
+    return;
+  }
+
+  for (auto it = lru_.rbegin(); it != lru_.rend() && resident_bytes_ > budget_; ++it) {
+    if (!it->resident || it->owner == keep) {
+      continue;
+    }
+
+    auto status = it->env->DiscardMappedMemoryPages(it->mapped_weights);
+    if (!status.IsOK()) {
+      // the pages stay in memory, so keep counting them
+      LOGS_DEFAULT(WARNING) << "Failed to page out mapped weights: " << status.ErrorMessage();
+      continue;
+    }
+
+    it->resident = false;
+    resident_bytes_ -= it->mapped_weights.size();
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class Env;
+
+/**
+ * Keeps the memory-mapped initializer data of the sessions of one environment under a memory budget.
+ *
+ * Each registered session contributes the mapping of its model file, see ModelOptions::lazy_initializer_data.
+ * The sessions stay fully initialized; only the physical pages of the weights are released, least recently used
+ * session first, once the resident weights of all the sessions exceed the budget. The pages of a paged out session
+ * are read back from the file, which is usually still in the OS page cache, when the session runs again.
+ *
+ * The mapped memory must be read-only for the pages to be released safely: a released page is restored from the
+ * file. Pages released while a session is running are transparently faulted back in.
+ */
+class MappedWeightPager {
+ public:
+  MappedWeightPager() = default;
+
+  // Sets the budget in bytes for the resident mapped weights of all the sessions. 0 means no limit.
+  void SetMemoryBudget(size_t budget);
+  size_t MemoryBudget() const;
+
+  // Registers the mapped weights of `owner`, which start as resident and most recently used.
+  void Register(const Env& env, const void* owner, gsl::span<char> mapped_weights);
+
+  // Removes `owner`. Its pages are not released.
+  void Unregister(const void* owner);
+
+  // Marks `owner` as most recently used before it runs. If its weights were paged out they are prefetched.
+  // The weights of the least recently used other sessions are paged out until the budget is met.
+  // Does nothing if `owner` is not registered.
+  void Activate(const void* owner);
+
+  // Returns the number of bytes of the registered weights that are currently counted as resident.
+  size_t ResidentBytes() const;
+
+  // Returns true if `owner` is registered and its weights are counted as resident.
+  bool IsResident(const void* owner) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MappedWeightPager);
+
+  struct Entry {
+    const Env* env;
+    const void* owner;
+    gsl::span<char> mapped_weights;
+    bool resident;
+  };
+
+  // Pages out the least recently used resident entries, except `keep`, until the budget is met.
+  void EvictToBudget(const void* keep);
+
+  mutable OrtMutex mutex_;
+  size_t budget_ = 0;
+  size_t resident_bytes_ = 0;
+  // most recently used first
+  std::list<Entry> lru_;
+  std::unordered_map<const void*, std::list<Entry>::iterator> entries_;
+};
+
+}  // namespace onnxruntime
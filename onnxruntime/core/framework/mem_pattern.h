@@ -20,6 +20,8 @@ struct MemoryBlock {
 
 class MemoryPattern {
   friend class MemPatternPlanner;
+  friend class StaticMemPatternPlanner;
+  friend class MemoryPatternDiskCache;
 
  public:
   MemoryPattern() = default;
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_disk_cache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "core/framework/murmurhash3.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'R', 'T', 'M', 'P', 'C', '0', '1'};
+
+PathString GetFilePath(const PathString& directory, const std::string& plan_signature) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  MurmurHash3::x86_128(plan_signature.data(), static_cast<int>(plan_signature.size()), hash[0], &hash);
+
+  std::ostringstream file_name;
+  file_name << std::hex << std::setfill('0');
+  for (uint32_t value : hash) {
+    file_name << std::setw(8) << value;
+  }
+  file_name << ".mempattern";
+  return (std::filesystem::path(directory) / file_name.str()).native();
+}
+
+template <typename T>
+void Write(std::ofstream& file, T value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool Read(std::ifstream& file, T& value) {
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+}  // namespace
+
+MemoryPatternDiskCache::MemoryPatternDiskCache(const Env& env, PathString directory,
+                                               const std::string& plan_signature)
+    : env_(env), directory_(std::move(directory)), file_path_(GetFilePath(directory_, plan_signature)) {
+}
+
+Status MemoryPatternDiskCache::Load(NodeHashMap<int64_t, MemoryPatternGroup>& mem_patterns) const {
+  std::error_code error;
+  if (!std::filesystem::exists(file_path_, error)) {
+    return Status::OK();
+  }
+
+  std::ifstream file(std::filesystem::path(file_path_), std::ios::binary);
+  char magic[sizeof(kMagic)];
+  uint64_t num_groups = 0;
+  if (!file.read(magic, sizeof(magic)) || memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !Read(file, num_groups)) {
+    return Status::OK();
+  }
+
+  // patterns are only added once the whole file has been read successfully
+  NodeHashMap<int64_t, MemoryPatternGroup> loaded;
+  for (uint64_t i = 0; i < num_groups; ++i) {
+    int64_t key = 0;
+    uint64_t num_locations = 0;
+    if (!Read(file, key) || !Read(file, num_locations)) {
+      return Status::OK();
+    }
+
+    MemoryPatternGroup group;
+    for (uint64_t j = 0; j < num_locations; ++j) {
+      int32_t device_type = 0, memory_type = 0, device_id = 0;
+      uint64_t peak_size = 0, num_blocks = 0;
+      if (!Read(file, device_type) || !Read(file, memory_type) || !Read(file, device_id) ||
+          !Read(file, peak_size) || !Read(file, num_blocks)) {
+        return Status::OK();
+      }
+
+      MemoryPattern pattern;
+      pattern.peak_size_ = static_cast<size_t>(peak_size);
+      for (uint64_t k = 0; k < num_blocks; ++k) {
+        int64_t ort_value_idx = 0;
+        uint64_t offset = 0, size = 0;
+        if (!Read(file, ort_value_idx) || !Read(file, offset) || !Read(file, size) ||
+            offset + size < offset || offset + size > peak_size) {
+          return Status::OK();
+        }
+        pattern.patterns_[static_cast<int>(ort_value_idx)] = MemoryBlock(static_cast<size_t>(offset),
+                                                                          static_cast<size_t>(size));
+      }
+
+      group.locations.emplace_back(static_cast<OrtDevice::DeviceType>(device_type),
+                                   static_cast<OrtDevice::MemoryType>(memory_type),
+                                   static_cast<OrtDevice::DeviceId>(device_id));
+      group.patterns.push_back(std::move(pattern));
+    }
+
+    loaded.emplace(key, std::move(group));
+  }
+
+  for (auto& entry : loaded) {
+    // patterns traced in this session take precedence
+    mem_patterns.emplace(entry.first, std::move(entry.second));
+  }
+  return Status::OK();
+}
+
+Status MemoryPatternDiskCache::Save(const NodeHashMap<int64_t, MemoryPatternGroup>& mem_patterns) const {
+  if (!env_.FolderExists(directory_)) {
+    ORT_RETURN_IF_ERROR(env_.CreateFolder(directory_));
+  }
+
+  PathString temp_file_path = file_path_ + ORT_TSTR(".tmp") + ToPathString(std::to_string(env_.GetSelfPid()));
+  {
+    std::ofstream file(std::filesystem::path(temp_file_path), std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file.good(), "Failed to create memory pattern cache file: ", PathToUTF8String(temp_file_path));
+
+    file.write(kMagic, sizeof(kMagic));
+    Write<uint64_t>(file, mem_patterns.size());
+    for (const auto& entry : mem_patterns) {
+      const MemoryPatternGroup& group = entry.second;
+      Write<int64_t>(file, entry.first);
+      Write<uint64_t>(file, group.locations.size());
+      for (size_t i = 0; i < group.locations.size(); ++i) {
+        const OrtDevice& location = group.locations[i];
+        Write<int32_t>(file, location.Type());
+        Write<int32_t>(file, location.MemType());
+        Write<int32_t>(file, location.Id());
+
+        const MemoryPattern& pattern = group.patterns[i];
+        Write<uint64_t>(file, pattern.PeakSize());
+        Write<uint64_t>(file, pattern.GetPatternsMap().size());
+        for (const auto& block : pattern.GetPatternsMap()) {
+          Write<int64_t>(file, block.first);
+          Write<uint64_t>(file, block.second.offset_);
+          Write<uint64_t>(file, block.second.size_);
+        }
+      }
+    }
+
+    file.close();
+    ORT_RETURN_IF_NOT(file.good(), "Failed to write memory pattern cache file: ", PathToUTF8String(temp_file_path));
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_file_path, file_path_, error);
+  if (error) {
+    std::filesystem::remove(temp_file_path, error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename memory pattern cache file to ",
+                           PathToUTF8String(file_path_));
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
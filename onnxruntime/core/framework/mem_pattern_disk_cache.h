@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/path_string.h"
+#include "core/framework/mem_pattern.h"
+
+namespace onnxruntime {
+
+class Env;
+
+// On-disk cache of the memory patterns traced by the executions of a session, so that a later session of the same
+// model starts with the patterns of the input shapes seen before instead of tracing them again in its first runs.
+//
+// The patterns of a session are stored in one file in the cache directory, named after a key that covers the
+// execution plan they were traced for (see the plan_signature argument of ComputeKey). A pattern is only valid
+// for the plan it was traced with, so any change in the model, the optimizations or the EPs selects another file.
+//
+// File layout (host byte order):
+//   char     magic[8]
+//   uint64_t number of pattern groups
+//   per pattern group:
+//     int64_t  key of the input shapes
+//     uint64_t number of locations
+//     per location:
+//       int32_t  device type, memory type, device id
+//       uint64_t peak size
+//       uint64_t number of blocks
+//       per block: int64_t OrtValue index, uint64_t offset, uint64_t size
+class MemoryPatternDiskCache final {
+ public:
+  MemoryPatternDiskCache(const Env& env, PathString directory, const std::string& plan_signature);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternDiskCache);
+
+  // Adds the cached patterns to mem_patterns. A missing or invalid file is not an error.
+  Status Load(NodeHashMap<int64_t, MemoryPatternGroup>& mem_patterns) const;
+
+  // Writes all the patterns in mem_patterns. The file is written under a temporary name and then renamed, so that
+  // concurrent processes never read a partially written file.
+  Status Save(const NodeHashMap<int64_t, MemoryPatternGroup>& mem_patterns) const;
+
+ private:
+  const Env& env_;
+  const PathString directory_;
+  const PathString file_path_;
+};
+
+}  // namespace onnxruntime
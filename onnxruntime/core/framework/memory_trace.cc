@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_trace.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+#include "core/common/profiler.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+namespace {
+
+double Fragmentation(const AllocatorStats& stats) {
+  const int64_t free_bytes = stats.total_allocated_bytes - stats.bytes_in_use;
+  if (free_bytes <= 0) {
+    return 0.0;
+  }
+  return 1.0 - static_cast<double>(std::min(stats.max_free_chunk_size, free_bytes)) / static_cast<double>(free_bytes);
+}
+
+}  // namespace
+
+MemoryTrace::MemoryTrace(const SessionState& session_state, const IExecutionFrame& frame)
+    : session_state_(session_state),
+      frame_(frame),
+      can_snapshot_(session_state.GetExecutionPlan()->execution_plan.size() <= 1) {
+  for (const auto& [device, allocator] : session_state.GetAllocators()) {
+    ORT_UNUSED_PARAMETER(device);
+    AllocatorStats stats;
+    allocator->GetStats(&stats);
+    if (stats.bytes_limit == 0 && stats.total_allocated_bytes == 0 && stats.num_allocs == 0) {
+      // the allocator does not report stats
+      continue;
+    }
+    const OrtMemoryInfo& info = allocator->Info();
+    allocators_.push_back({MakeString(info.name, "_", info.id), allocator, AllocatorStats{}});
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Sample();
+}
+
+std::vector<AllocatorStats> MemoryTrace::Sample() {
+  auto& profiler = session_state_.Profiler();
+  std::vector<AllocatorStats> samples(allocators_.size());
+  for (size_t i = 0; i < allocators_.size(); ++i) {
+    TracedAllocator& traced = allocators_[i];
+    AllocatorStats& stats = samples[i];
+    traced.allocator->GetStats(&stats);
+    if (stats.bytes_in_use == traced.last.bytes_in_use &&
+        stats.total_allocated_bytes == traced.last.total_allocated_bytes &&
+        stats.max_free_chunk_size == traced.last.max_free_chunk_size) {
+      continue;
+    }
+
+    const auto now = profiler.Start();
+    profiler.EndTimeAndRecordEvent(profiling::MEMORY_EVENT, "memory_" + traced.name, now,
+                                   {{"bytes_in_use", std::to_string(stats.bytes_in_use)},
+                                    {"reserved_bytes", std::to_string(stats.total_allocated_bytes)}});
+    if (stats.max_free_chunk_size > 0) {
+      profiler.EndTimeAndRecordEvent(profiling::MEMORY_EVENT, "fragmentation_" + traced.name, now,
+                                     {{"fragmentation", std::to_string(Fragmentation(stats))}});
+    }
+    traced.last = stats;
+  }
+  return samples;
+}
+
+std::vector<AllocatorStats> MemoryTrace::BeginKernel() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return Sample();
+}
+
+std::string MemoryTrace::EndKernel(const std::vector<AllocatorStats>& begin, const std::string& node_name) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  const std::vector<AllocatorStats> end = Sample();
+
+  std::ostringstream ss;
+  int64_t bytes_in_use = 0;
+  for (size_t i = 0; i < allocators_.size(); ++i) {
+    bytes_in_use += end[i].bytes_in_use;
+    const int64_t num_allocs = end[i].num_allocs - begin[i].num_allocs;
+    const int64_t bytes_in_use_delta = end[i].bytes_in_use - begin[i].bytes_in_use;
+    const int64_t arena_extensions = end[i].num_arena_extensions - begin[i].num_arena_extensions;
+    if (num_allocs == 0 && bytes_in_use_delta == 0 && arena_extensions == 0) {
+      continue;
+    }
+
+    ss << (ss.tellp() == 0 ? "{" : ", ")
+       << "\"" << allocators_[i].name << "\": {"
+       << "\"num_allocs\": " << num_allocs
+       << ", \"bytes_in_use_delta\": " << bytes_in_use_delta
+       << ", \"arena_extensions\": " << arena_extensions
+       << ", \"reserved_bytes_delta\": " << end[i].total_allocated_bytes - begin[i].total_allocated_bytes;
+    if (end[i].max_bytes_in_use > begin[i].max_bytes_in_use) {
+      // the kernel raised the high-water mark of the allocator, possibly with temporary buffers
+      ss << ", \"max_bytes_in_use\": " << end[i].max_bytes_in_use;
+    }
+    ss << "}";
+  }
+  if (ss.tellp() != 0) {
+    ss << "}";
+  }
+
+  if (bytes_in_use > peak_bytes_in_use_) {
+    peak_bytes_in_use_ = bytes_in_use;
+    peak_node_name_ = node_name;
+    peak_tensors_.clear();
+    if (can_snapshot_) {
+      const auto& initializers = session_state_.GetInitializedTensors();
+      const auto& name_idx_map = session_state_.GetOrtValueNameIdxMap();
+      std::unordered_set<const void*> buffers;
+      frame_.ForEachMLValue([&](int ort_value_idx, const OrtValue& ort_value) {
+        if (!ort_value.IsAllocated() || !ort_value.IsTensor() || initializers.count(ort_value_idx) != 0) {
+          return;
+        }
+        const Tensor& tensor = ort_value.Get<Tensor>();
+        // values that alias the buffer of another value, e.g. the outputs of Reshape, are counted once
+        if (tensor.SizeInBytes() == 0 || !buffers.insert(tensor.DataRaw()).second) {
+          return;
+        }
+        std::string name;
+        ORT_IGNORE_RETURN_VALUE(name_idx_map.GetName(ort_value_idx, name));
+        peak_tensors_.push_back({std::move(name), tensor.SizeInBytes(), tensor.Location().name});
+      });
+    }
+  }
+
+  return ss.str();
+}
+
+void MemoryTrace::End() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Sample();
+  if (peak_bytes_in_use_ == 0) {
+    return;
+  }
+
+  std::sort(peak_tensors_.begin(), peak_tensors_.end(), [](const LiveTensor& a, const LiveTensor& b) {
+    return a.size_in_bytes > b.size_in_bytes;
+  });
+  std::ostringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < peak_tensors_.size(); ++i) {
+    ss << (i == 0 ? "" : ", ")
+       << "{\"name\": \"" << peak_tensors_[i].name << "\", "
+       << "\"size\": " << peak_tensors_[i].size_in_bytes << ", "
+       << "\"location\": \"" << peak_tensors_[i].location << "\"}";
+  }
+  ss << "]";
+
+  auto& profiler = session_state_.Profiler();
+  profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "memory_peak", profiler.Start(),
+                                 {{"node_name", peak_node_name_},
+                                  {"bytes_in_use", std::to_string(peak_bytes_in_use_)},
+                                  {"live_tensors", ss.str()}});
+}
+
+}  // namespace onnxruntime
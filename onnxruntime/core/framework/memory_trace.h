@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/allocator_stats.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class IExecutionFrame;
+class SessionState;
+
+// Traces the memory of the allocators of a session state during one execution while profiling.
+//
+// The allocators are sampled around each kernel. The bytes in use and reserved by each arena, and its
+// fragmentation, are recorded as profiler counter events whenever they change, which shows a timeline of the memory
+// in chrome tracing. The kernel events get the allocations made by the kernel and the growth of the arenas.
+// The live tensors at the highest total of bytes in use are recorded as an event when the execution ends, to show
+// which tensors to target in order to reduce the peak.
+//
+// Fragmentation is 1 - largest free chunk / free bytes of an arena, i.e. the share of its free memory that cannot
+// serve an allocation of the size of its free memory. It is only recorded for arenas that report their largest free
+// chunk. Only allocators that report stats are traced.
+class MemoryTrace {
+ public:
+  MemoryTrace(const SessionState& session_state, const IExecutionFrame& frame);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryTrace);
+
+  // Samples the allocators before a kernel runs. Returns the stats to pass to EndKernel.
+  std::vector<AllocatorStats> BeginKernel();
+
+  // Samples the allocators after a kernel ran. Returns the allocations made by the kernel as JSON for its event,
+  // or an empty string if it did not allocate. With several streams, the allocations of kernels running at the same
+  // time are included.
+  std::string EndKernel(const std::vector<AllocatorStats>& begin, const std::string& node_name);
+
+  // Records the live tensors at the peak.
+  void End();
+
+ private:
+  struct TracedAllocator {
+    std::string name;
+    AllocatorPtr allocator;
+    AllocatorStats last;  // stats of the last sample
+  };
+
+  struct LiveTensor {
+    std::string name;
+    size_t size_in_bytes;
+    std::string location;
+  };
+
+  // Reads the stats of the allocators, records counter events for those that changed, and returns them.
+  std::vector<AllocatorStats> Sample();
+
+  const SessionState& session_state_;
+  const IExecutionFrame& frame_;
+  // The live tensors are only read when the frame is not updated by other streams at the same time.
+  bool can_snapshot_;
+  OrtMutex mutex_;
+  std::vector<TracedAllocator> allocators_;
+
+  int64_t peak_bytes_in_use_ = 0;
+  std::string peak_node_name_;
+  std::vector<LiveTensor> peak_tensors_;
+};
+
+}  // namespace onnxruntime
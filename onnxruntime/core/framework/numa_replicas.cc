@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/numa_replicas.h"
+
+#include <cstring>
+#include <memory>
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+struct ReplicaCopy {
+  const void* data;
+  size_t size;
+  AllocatorPtr allocator;
+  IAllocatorUniquePtr<void> replica;
+};
+
+unsigned CopyReplica(int /*id*/, Eigen::ThreadPoolInterface* param) {
+  // the parameter is not a thread pool, see ReplicateOnNumaNodes
+  auto* copy = reinterpret_cast<ReplicaCopy*>(param);
+  copy->replica = IAllocator::MakeUniquePtr<void>(copy->allocator, copy->size);
+  memcpy(copy->replica.get(), copy->data, copy->size);
+  return 0;
+}
+}  // namespace
+
+std::vector<IAllocatorUniquePtr<void>> ReplicateOnNumaNodes(const void* data, size_t size) {
+  std::vector<IAllocatorUniquePtr<void>> replicas;
+  Env& env = Env::Default();
+  const std::vector<LogicalProcessors> numa_nodes = env.GetNumaNodes();
+  if (numa_nodes.size() <= 1 || size == 0) {
+    return replicas;
+  }
+
+  // not an arena, whose chunks may already be backed by memory of another node
+  auto allocator = std::make_shared<CPUAllocator>();
+  for (const LogicalProcessors& node_processors : numa_nodes) {
+    ReplicaCopy copy{data, size, allocator, nullptr};
+    ThreadOptions thread_options;
+    thread_options.affinities.push_back(node_processors);
+    {
+      // the destructor joins the thread
+      std::unique_ptr<EnvThread> thread{env.CreateThread(ORT_TSTR("numa_replica"), 0, CopyReplica,
+                                                         reinterpret_cast<Eigen::ThreadPoolInterface*>(&copy),
+                                                         thread_options)};
+    }
+    replicas.push_back(std::move(copy.replica));
+  }
+  return replicas;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+// Copies a read-only buffer, e.g. pre-packed weights, to the memory of each NUMA node of Env::GetNumaNodes(), so
+// that the pool threads running on a node read it locally instead of across the interconnect.
+// Each copy is allocated and written by a thread running on its node, which places its pages on the node as memory
+// is allocated on first touch.
+// Returns one buffer per node, or no buffers unless there are several NUMA nodes.
+std::vector<IAllocatorUniquePtr<void>> ReplicateOnNumaNodes(const void* data, size_t size);
+
+}  // namespace onnxruntime
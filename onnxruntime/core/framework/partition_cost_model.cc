@@ -0,0 +1,335 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/framework/partition_cost_model.h"
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+
+#include "core/framework/data_types.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+namespace partition_cost_model {
+
+namespace {
+
+// Rough costs, in microseconds, of running a node and of copying a tensor between devices. They only need to be
+// good enough to rank a few small nodes against the Memcpy nodes their placement requires; an island with a
+// large matrix multiplication or convolution is always cheaper on the device.
+constexpr double kCpuUsPerElementOp = 1e-3;
+constexpr double kDeviceSpeedup = 20.0;
+constexpr double kDeviceLaunchUs = 5.0;
+constexpr double kCopyLatencyUs = 10.0;
+constexpr double kCopyBytesPerUs = 1e4;
+
+std::optional<int64_t> NumElements(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return std::nullopt;
+  }
+
+  int64_t num_elements = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return std::nullopt;
+    }
+    num_elements *= dim.dim_value();
+  }
+  return num_elements;
+}
+
+std::optional<int64_t> SizeInBytes(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !utils::HasTensorType(*type) || !utils::HasElemType(type->tensor_type())) {
+    return std::nullopt;
+  }
+
+  const auto num_elements = NumElements(arg);
+  if (!num_elements.has_value()) {
+    return std::nullopt;
+  }
+
+  const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType();
+  return *num_elements * static_cast<int64_t>(element_type->Size());
+}
+
+std::optional<int64_t> DimValue(const NodeArg* arg, int axis) {
+  const auto* shape = arg != nullptr ? arg->Shape() : nullptr;
+  if (shape == nullptr || shape->dim_size() == 0) {
+    return std::nullopt;
+  }
+
+  if (axis < 0) {
+    axis += shape->dim_size();
+  }
+  if (axis < 0 || axis >= shape->dim_size() || !utils::HasDimValue(shape->dim(axis))) {
+    return std::nullopt;
+  }
+  return shape->dim(axis).dim_value();
+}
+
+// Estimated number of element operations of the node. Matrix multiplications and convolutions perform a
+// multiply-add per element of the reduced dimension for each output element, everything else is assumed to be
+// linear in the larger of its inputs and outputs.
+std::optional<double> EstimateElementOps(const Node& node) {
+  int64_t max_elements = 0;
+  for (const auto* defs : {&node.InputDefs(), &node.OutputDefs()}) {
+    for (const auto* arg : *defs) {
+      if (!arg->Exists()) {
+        continue;
+      }
+      const auto num_elements = NumElements(*arg);
+      if (!num_elements.has_value()) {
+        return std::nullopt;
+      }
+      max_elements = std::max(max_elements, *num_elements);
+    }
+  }
+
+  const auto& op_type = node.OpType();
+  const auto& input_defs = node.InputDefs();
+  std::optional<int64_t> reduced_dim = 1;
+  if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul") {
+    reduced_dim = DimValue(input_defs[0], -1);
+  } else if (op_type == "Gemm") {
+    const auto& attributes = node.GetAttributes();
+    const auto trans_a = attributes.find("transA");
+    reduced_dim = DimValue(input_defs[0], trans_a != attributes.end() && trans_a->second.i() != 0 ? 0 : 1);
+  } else if (op_type == "Conv" || op_type == "ConvTranspose" || op_type == "FusedConv" ||
+             op_type == "NhwcFusedConv") {
+    const auto weight_elements = input_defs.size() > 1 ? NumElements(*input_defs[1]) : std::nullopt;
+    const auto num_filters = DimValue(input_defs.size() > 1 ? input_defs[1] : nullptr, 0);
+    reduced_dim = weight_elements.has_value() && num_filters.value_or(0) > 0
+                      ? std::optional<int64_t>{*weight_elements / *num_filters}
+                      : std::nullopt;
+  }
+
+  if (!reduced_dim.has_value()) {
+    return std::nullopt;
+  }
+  return static_cast<double>(max_elements) * static_cast<double>(std::max<int64_t>(*reduced_dim, 1));
+}
+
+double CopyCostUs(int64_t num_bytes) {
+  return kCopyLatencyUs + static_cast<double>(num_bytes) / kCopyBytesPerUs;
+}
+
+OrtDevice GetNodeDevice(const Node& node, const ExecutionProviders& execution_providers) {
+  const auto* ep = execution_providers.Get(node);
+  return ep != nullptr ? ep->GetOrtDeviceByMemType(OrtMemTypeDefault) : OrtDevice();
+}
+
+// A tensor that crosses the boundary of an island, and the device on the other side of the boundary.
+struct BoundaryTensor {
+  const NodeArg* arg;
+  OrtDevice device;
+  int64_t num_bytes;
+};
+
+std::optional<DeviceIsland> EvaluateIsland(const Graph& graph, const ExecutionProviders& execution_providers,
+                                           const ProviderType& provider_type, const OrtDevice& island_device,
+                                           InlinedVector<NodeIndex> island_nodes) {
+  InlinedHashSet<NodeIndex> in_island(island_nodes.begin(), island_nodes.end());
+  InlinedVector<BoundaryTensor> boundary;
+
+  auto add_boundary = [&](const NodeArg& arg, const OrtDevice& device) -> bool {
+    const bool seen = std::any_of(boundary.begin(), boundary.end(), [&](const BoundaryTensor& tensor) {
+      return tensor.arg == &arg && tensor.device == device;
+    });
+    if (seen) {
+      return true;
+    }
+
+    const auto num_bytes = SizeInBytes(arg);
+    if (!num_bytes.has_value()) {
+      return false;
+    }
+    boundary.push_back({&arg, device, *num_bytes});
+    return true;
+  };
+
+  double device_compute_us = 0.0;
+  double cpu_compute_us = 0.0;
+  for (NodeIndex node_index : island_nodes) {
+    const Node& node = *graph.GetNode(node_index);
+    const auto element_ops = EstimateElementOps(node);
+    if (!element_ops.has_value()) {
+      return std::nullopt;
+    }
+    cpu_compute_us += *element_ops * kCpuUsPerElementOp;
+    device_compute_us += kDeviceLaunchUs + *element_ops * kCpuUsPerElementOp / kDeviceSpeedup;
+
+    // Initializers are copied to the device once when the session is created, so they are free on either side.
+    for (const auto* input : node.InputDefs()) {
+      if (!input->Exists() || graph.IsInitializedTensor(input->Name())) {
+        continue;
+      }
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if (producer != nullptr && in_island.count(producer->Index()) != 0) {
+        continue;
+      }
+      // graph inputs and outer scope values are fed from the host
+      const OrtDevice device = producer != nullptr ? GetNodeDevice(*producer, execution_providers) : OrtDevice();
+      if (!add_boundary(*input, device)) {
+        return std::nullopt;
+      }
+    }
+
+    for (const auto* output : node.OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+      for (const Node* consumer : graph.GetConsumerNodes(output->Name())) {
+        if (in_island.count(consumer->Index()) == 0 &&
+            !add_boundary(*output, GetNodeDevice(*consumer, execution_providers))) {
+          return std::nullopt;
+        }
+      }
+      // graph outputs are fetched to the host
+      if (graph.IsOutput(output) && !add_boundary(*output, OrtDevice())) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  auto copy_cost_us = [&](const OrtDevice& placement) {
+    double cost_us = 0.0;
+    for (const auto& tensor : boundary) {
+      if (!(tensor.device == placement)) {
+        cost_us += CopyCostUs(tensor.num_bytes);
+      }
+    }
+    return cost_us;
+  };
+
+  return DeviceIsland{provider_type,
+                      std::move(island_nodes),
+                      device_compute_us + copy_cost_us(island_device),
+                      cpu_compute_us + copy_cost_us(OrtDevice())};
+}
+
+Status MergeDeviceIslandsToCpuImpl(Graph& graph, const std::string& graph_path,
+                                   const ExecutionProviders& execution_providers,
+                                   const KernelRegistryManager& kernel_registry_mgr,
+                                   const logging::Logger& logger) {
+  for (auto& node : graph.Nodes()) {
+    for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+      ORT_RETURN_IF_ERROR(MergeDeviceIslandsToCpuImpl(*entry.second, graph_path + "/" + node.Name() + ":" + entry.first,
+                                                      execution_providers, kernel_registry_mgr, logger));
+    }
+  }
+
+  for (const auto& island : FindDeviceIslands(graph, execution_providers)) {
+    if (island.cpu_cost_us >= island.device_cost_us) {
+      continue;
+    }
+
+    // The kernel lookup goes by the assigned execution provider, so move the nodes before looking up their CPU
+    // kernels and restore the assignment if one of them has none.
+    const bool has_cpu_kernels = std::all_of(island.nodes.begin(), island.nodes.end(), [&](NodeIndex node_index) {
+      Node& node = *graph.GetNode(node_index);
+      node.SetExecutionProviderType(kCpuExecutionProvider);
+      return KernelRegistryManager::HasImplementationOf(kernel_registry_mgr, node, kCpuExecutionProvider);
+    });
+
+    if (!has_cpu_kernels) {
+      for (NodeIndex node_index : island.nodes) {
+        graph.GetNode(node_index)->SetExecutionProviderType(island.provider_type);
+      }
+      continue;
+    }
+
+    LOGS(logger, INFO) << "Moved " << island.nodes.size() << " node(s) of " << graph_path << " starting at '"
+                       << graph.GetNode(island.nodes.front())->Name() << "' from " << island.provider_type
+                       << " to " << kCpuExecutionProvider << ". Estimated cost " << island.cpu_cost_us
+                       << "us on CPU vs " << island.device_cost_us << "us on the device including copies.";
+  }
+
+  return Status::OK();
+}
+
+Status WriteAssignmentImpl(const Graph& graph, const std::string& graph_path, std::ofstream& out) {
+  for (const auto& node : graph.Nodes()) {
+    out << graph_path << '\t' << node.Name() << '\t' << node.Domain() << ':' << node.OpType() << '\t'
+        << node.GetExecutionProviderType() << '\n';
+    for (const auto& entry : node.GetAttributeNameToSubgraphMap()) {
+      ORT_RETURN_IF_ERROR(WriteAssignmentImpl(*entry.second, graph_path + "/" + node.Name() + ":" + entry.first, out));
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+std::vector<DeviceIsland> FindDeviceIslands(const Graph& graph, const ExecutionProviders& execution_providers) {
+  std::vector<DeviceIsland> islands;
+  InlinedHashSet<NodeIndex> visited;
+
+  for (const auto& seed : graph.Nodes()) {
+    const auto& provider_type = seed.GetExecutionProviderType();
+    if (provider_type.empty() || provider_type == kCpuExecutionProvider || visited.count(seed.Index()) != 0) {
+      continue;
+    }
+
+    const OrtDevice island_device = GetNodeDevice(seed, execution_providers);
+    if (island_device.Type() == OrtDevice::CPU) {
+      // e.g. XNNPACK, there are no copies to save
+      continue;
+    }
+
+    // Collect the nodes connected to the seed through nodes assigned to the same execution provider.
+    InlinedVector<NodeIndex> island_nodes{seed.Index()};
+    visited.insert(seed.Index());
+    for (size_t i = 0; i < island_nodes.size(); ++i) {
+      const Node& node = *graph.GetNode(island_nodes[i]);
+      auto visit = [&](const Node& neighbour) {
+        if (neighbour.GetExecutionProviderType() == provider_type && visited.insert(neighbour.Index()).second) {
+          island_nodes.push_back(neighbour.Index());
+        }
+      };
+      std::for_each(node.InputNodesBegin(), node.InputNodesEnd(), visit);
+      std::for_each(node.OutputNodesBegin(), node.OutputNodesEnd(), visit);
+    }
+
+    // control flow nodes are left where they are, their cost depends on the subgraphs
+    const bool has_subgraph = std::any_of(island_nodes.begin(), island_nodes.end(), [&](NodeIndex node_index) {
+      return graph.GetNode(node_index)->ContainsSubgraph();
+    });
+    if (has_subgraph) {
+      continue;
+    }
+
+    auto island = EvaluateIsland(graph, execution_providers, provider_type, island_device, std::move(island_nodes));
+    if (island.has_value()) {
+      islands.push_back(std::move(*island));
+    }
+  }
+
+  return islands;
+}
+
+Status MergeDeviceIslandsToCpu(Graph& graph, const ExecutionProviders& execution_providers,
+                               const KernelRegistryManager& kernel_registry_mgr,
+                               const logging::Logger& logger) {
+  return MergeDeviceIslandsToCpuImpl(graph, graph.Name(), execution_providers, kernel_registry_mgr, logger);
+}
+
+Status WriteAssignment(const Graph& graph, const std::string& file_path) {
+  std::ofstream out(file_path, std::ios::out | std::ios::trunc);
+  ORT_RETURN_IF_NOT(out.good(), "Failed to open ", file_path, " to write the partitioning assignment.");
+  ORT_RETURN_IF_ERROR(WriteAssignmentImpl(graph, graph.Name(), out));
+  out.flush();
+  ORT_RETURN_IF_NOT(out.good(), "Failed to write the partitioning assignment to ", file_path);
+  return Status::OK();
+}
+
+}  // namespace partition_cost_model
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
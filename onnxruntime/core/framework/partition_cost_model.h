@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+class ExecutionProviders;
+class KernelRegistryManager;
+
+namespace partition_cost_model {
+
+/**
+ * A connected group of nodes that the greedy partitioning assigned to an execution provider whose memory lives
+ * on a device, together with the estimated cost of running it there or on the CPU execution provider.
+ * The costs are in microseconds and include the copies from and to the neighbouring nodes that the placement
+ * requires.
+ */
+struct DeviceIsland {
+  ProviderType provider_type;
+  InlinedVector<NodeIndex> nodes;
+  double device_cost_us;
+  double cpu_cost_us;
+};
+
+/**
+ * Finds the islands of device nodes in `graph` (not including its subgraphs) and estimates their cost on the
+ * device and on the CPU. Islands with a node whose shapes are not fully known are skipped.
+ */
+std::vector<DeviceIsland> FindDeviceIslands(const Graph& graph, const ExecutionProviders& execution_providers);
+
+/**
+ * Moves the device islands of `graph` and its subgraphs that are estimated to be cheaper on the CPU, taking the
+ * copies into account, back to the CPU execution provider. An island is only moved if the CPU execution provider
+ * has a kernel for each of its nodes.
+ */
+Status MergeDeviceIslandsToCpu(Graph& graph, const ExecutionProviders& execution_providers,
+                               const KernelRegistryManager& kernel_registry_mgr,
+                               const logging::Logger& logger);
+
+/**
+ * Writes the execution provider assignment of each node in `graph` and its subgraphs to `file_path`, one
+ * `<graph>\t<node name>\t<domain>:<op type>\t<execution provider>` line per node.
+ */
+Status WriteAssignment(const Graph& graph, const std::string& file_path);
+
+}  // namespace partition_cost_model
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_disk_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', '0', '1'};
+
+// MurmurHash3 takes an int length, so large weights are hashed in chunks.
+constexpr size_t kHashChunkSize = size_t{1} << 30;
+
+void HashBytes(const void* data, size_t length, uint32_t (&hash)[4]) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  do {
+    const size_t chunk = std::min(length, kHashChunkSize);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk), hash[0], &hash);
+    bytes += chunk;
+    length -= chunk;
+  } while (length > 0);
+}
+
+// CPU features that select pre-packed layouts in MLAS and the CPU kernels.
+std::string GetCpuFeatures() {
+  const auto& cpu_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream ss;
+  ss << cpu_info.HasSSE3() << cpu_info.HasSSE4_1() << cpu_info.HasAVX() << cpu_info.HasAVX2()
+     << cpu_info.HasAVX512f() << cpu_info.HasAVX512Skylake() << cpu_info.HasAVX512_BF16() << cpu_info.HasAMX_BF16()
+     << cpu_info.HasF16C() << cpu_info.HasArmNeonDot() << cpu_info.HasArmNeon_I8MM() << cpu_info.HasArmSVE_I8MM()
+     << cpu_info.HasArmNeon_BF16();
+  return ss.str();
+}
+
+size_t AlignOffset(size_t offset) {
+  const size_t alignment = PrepackedWeightsDiskCache::kBufferAlignment;
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+PrepackedWeightsDiskCache::PrepackedWeightsDiskCache(const Env& env, PathString directory)
+    : env_(env), directory_(std::move(directory)) {
+}
+
+std::string PrepackedWeightsDiskCache::ComputeKey(const std::string& kernel_signature, int input_idx,
+                                                  const Tensor& weight) {
+  std::ostringstream header;
+  header << kernel_signature << '|' << input_idx << '|' << weight.GetElementType() << '|'
+         << weight.Shape().ToString() << '|' << GetCpuFeatures();
+  const std::string header_str = header.str();
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  HashBytes(header_str.data(), header_str.size(), hash);
+  HashBytes(weight.DataRaw(), weight.SizeInBytes(), hash);
+
+  std::ostringstream key;
+  key << std::hex << std::setfill('0');
+  for (uint32_t value : hash) {
+    key << std::setw(8) << value;
+  }
+  return key.str();
+}
+
+PathString PrepackedWeightsDiskCache::GetFilePath(const std::string& key) const {
+  return (std::filesystem::path(directory_) / (key + ".bin")).native();
+}
+
+Status PrepackedWeightsDiskCache::Load(const std::string& key, PrePackedWeights& prepacked_weights,
+                                       bool& found) const {
+  found = false;
+  const PathString file_path = GetFilePath(key);
+  std::error_code error;
+  if (!std::filesystem::exists(file_path, error)) {
+    return Status::OK();
+  }
+
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env_.GetFileLength(file_path.c_str(), file_length));
+  if (file_length < sizeof(kMagic) + sizeof(uint64_t)) {
+    return Status::OK();
+  }
+
+  auto mapped_memory = std::make_shared<Env::MappedMemoryPtr>();
+  ORT_RETURN_IF_ERROR(env_.MapFileIntoMemory(file_path.c_str(), 0, file_length, *mapped_memory));
+  const char* data = mapped_memory->get();
+
+  uint64_t num_buffers = 0;
+  memcpy(&num_buffers, data + sizeof(kMagic), sizeof(num_buffers));
+  if (memcmp(data, kMagic, sizeof(kMagic)) != 0 || num_buffers == 0 || num_buffers > file_length ||
+      sizeof(kMagic) + sizeof(uint64_t) * (1 + 2 * num_buffers) > file_length) {
+    return Status::OK();
+  }
+
+  std::vector<uint64_t> sizes(num_buffers);
+  std::vector<uint64_t> offsets(num_buffers);
+  memcpy(sizes.data(), data + sizeof(kMagic) + sizeof(uint64_t), sizeof(uint64_t) * num_buffers);
+  memcpy(offsets.data(), data + sizeof(kMagic) + sizeof(uint64_t) * (1 + num_buffers),
+         sizeof(uint64_t) * num_buffers);
+
+  PrePackedWeights loaded;
+  for (size_t i = 0; i < num_buffers; ++i) {
+    if (offsets[i] == kNullBufferOffset) {
+      loaded.buffers_.emplace_back(nullptr, [](void*) {});
+    } else {
+      if (offsets[i] > file_length || sizes[i] > file_length - offsets[i]) {
+        return Status::OK();
+      }
+      // The buffers share the mapping, which is released when the last of them is destroyed.
+      loaded.buffers_.emplace_back(const_cast<char*>(data) + offsets[i], [mapped_memory](void*) {});
+    }
+    loaded.buffer_sizes_.push_back(static_cast<size_t>(sizes[i]));
+  }
+
+  prepacked_weights = std::move(loaded);
+  found = true;
+  return Status::OK();
+}
+
+Status PrepackedWeightsDiskCache::Save(const std::string& key, const PrePackedWeights& prepacked_weights) const {
+  ORT_RETURN_IF_NOT(prepacked_weights.buffers_.size() == prepacked_weights.buffer_sizes_.size(),
+                    "Number of pre-packed buffers and buffer sizes differ.");
+
+  if (!env_.FolderExists(directory_)) {
+    ORT_RETURN_IF_ERROR(env_.CreateFolder(directory_));
+  }
+
+  const uint64_t num_buffers = prepacked_weights.buffers_.size();
+  std::vector<uint64_t> sizes(prepacked_weights.buffer_sizes_.begin(), prepacked_weights.buffer_sizes_.end());
+  std::vector<uint64_t> offsets(num_buffers);
+  size_t offset = sizeof(kMagic) + sizeof(uint64_t) * (1 + 2 * num_buffers);
+  for (size_t i = 0; i < num_buffers; ++i) {
+    if (prepacked_weights.buffers_[i] == nullptr) {
+      offsets[i] = kNullBufferOffset;
+      continue;
+    }
+    offset = AlignOffset(offset);
+    offsets[i] = offset;
+    offset += SafeInt<size_t>(sizes[i]);
+  }
+
+  const PathString file_path = GetFilePath(key);
+  PathString temp_file_path = file_path + ORT_TSTR(".tmp") + ToPathString(std::to_string(env_.GetSelfPid()));
+  {
+    std::ofstream file(std::filesystem::path(temp_file_path), std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file.good(), "Failed to create pre-packed weights cache file: ",
+                      PathToUTF8String(temp_file_path));
+
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&num_buffers), sizeof(num_buffers));
+    file.write(reinterpret_cast<const char*>(sizes.data()), sizeof(uint64_t) * num_buffers);
+    file.write(reinterpret_cast<const char*>(offsets.data()), sizeof(uint64_t) * num_buffers);
+
+    const std::vector<char> padding(kBufferAlignment, 0);
+    size_t position = sizeof(kMagic) + sizeof(uint64_t) * (1 + 2 * num_buffers);
+    for (size_t i = 0; i < num_buffers; ++i) {
+      if (offsets[i] == kNullBufferOffset) {
+        continue;
+      }
+      file.write(padding.data(), static_cast<std::streamsize>(offsets[i] - position));
+      file.write(static_cast<const char*>(prepacked_weights.buffers_[i].get()),
+                 static_cast<std::streamsize>(sizes[i]));
+      position = static_cast<size_t>(offsets[i] + sizes[i]);
+    }
+
+    file.close();
+    ORT_RETURN_IF_NOT(file.good(), "Failed to write pre-packed weights cache file: ", PathToUTF8String(temp_file_path));
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_file_path, file_path, error);
+  if (error) {
+    std::filesystem::remove(temp_file_path, error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename pre-packed weights cache file to ",
+                           PathToUTF8String(file_path));
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
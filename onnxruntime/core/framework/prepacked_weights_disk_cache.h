@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+class Env;
+
+// On-disk cache of pre-packed weights, so that a process can map pre-packed buffers written by an earlier
+// process instead of calling PrePack() again.
+//
+// Every entry is one file in the cache directory, named after a key that covers everything the pre-packed
+// contents depend on: the kernel (see the kernel_signature argument of ComputeKey), the input index, the
+// type, shape and bytes of the weight, and the CPU features the pre-packing code dispatches on.
+//
+// File layout (host byte order):
+//   char     magic[8]
+//   uint64_t number of buffers (n)
+//   uint64_t buffer sizes in bytes [n]
+//   uint64_t buffer offsets from the start of the file [n], kNullBufferOffset for a null placeholder buffer
+//   buffer data, each buffer starting at a multiple of kBufferAlignment
+// Loaded buffers point into a read-only mapping of the file, which is released with the last buffer.
+class PrepackedWeightsDiskCache final {
+ public:
+  static constexpr size_t kBufferAlignment = 4096;
+  static constexpr uint64_t kNullBufferOffset = ~uint64_t{0};
+
+  PrepackedWeightsDiskCache(const Env& env, PathString directory);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsDiskCache);
+
+  static std::string ComputeKey(const std::string& kernel_signature, int input_idx, const Tensor& weight);
+
+  // Maps the cached pre-packed buffers of key into prepacked_weights. found is false if there is no valid entry.
+  Status Load(const std::string& key, PrePackedWeights& prepacked_weights, bool& found) const;
+
+  // Writes the pre-packed buffers of key. The file is written under a temporary name and then renamed, so that
+  // concurrent processes never map a partially written entry.
+  Status Save(const std::string& key, const PrePackedWeights& prepacked_weights) const;
+
+ private:
+  PathString GetFilePath(const std::string& key) const;
+
+  const Env& env_;
+  const PathString directory_;
+};
+
+}  // namespace onnxruntime
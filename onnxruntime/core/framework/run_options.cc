@@ -2,6 +2,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 #include "core/framework/run_options.h"
+#include "core/common/run_stats.h"
+#include "core/common/string_helper.h"
 #include "core/session/onnxruntime_c_api.h"
 #include "core/session/ort_apis.h"
 #include "core/framework/error_code_helper.h"
@@ -60,3 +62,30 @@ ORT_API_STATUS_IMPL(OrtApis::AddRunConfigEntry, _Inout_ OrtRunOptions* options,
                     _In_z_ const char* config_key, _In_z_ const char* config_value) {
   return onnxruntime::ToOrtStatus(options->config_options.AddConfigEntry(config_key, config_value));
 }
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsEnableRunStats, _Inout_ OrtRunOptions* options) {
+  API_IMPL_BEGIN
+  if (!options->run_stats) {
+    options->run_stats = std::make_shared<onnxruntime::RunStats>();
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsGetRunStats, _In_ const OrtRunOptions* options,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  if (!options->run_stats) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Run stats are not enabled for these run options.");
+  }
+  *out = onnxruntime::StrDup(options->run_stats->ToJson(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetGenerationTokensCallback, _Inout_ OrtRunOptions* options,
+                    _In_opt_ OrtGenerationTokensCallbackFn callback, _In_opt_ void* user_data) {
+  options->generation_tokens_callback = callback;
+  options->generation_tokens_callback_user_data = user_data;
+  return nullptr;
+}
@@ -4,13 +4,19 @@
 #include "core/framework/sequential_executor.h"
 
 #include <chrono>
+#include <cstring>
+#include <optional>
 #include <thread>
 #include <vector>
 #include <sstream>
 #include "core/common/common.h"
+#include "core/common/denormal.h"
 #include "core/common/logging/logging.h"
+#include "core/common/native_tracing.h"
+#include "core/common/run_stats.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/memory_trace.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -90,6 +96,41 @@ static void CalculateTotalOutputSizes(OpKernelContextInternal* op_kernel_context
   output_type_shape = ss.str();
 }
 
+// Counts the denormal values of the float, double and float16 outputs on CPU, from their bits so that the count does
+// not depend on the denormal-as-zero mode of the thread.
+static size_t CountDenormalOutputs(const OpKernelContextInternal* op_kernel_context) {
+  size_t count = 0;
+  const int output_count = op_kernel_context->OutputCount();
+  for (auto i = 0; i < output_count; i++) {
+    const OrtValue* p_output = op_kernel_context->GetOutputMLValue(i);
+    if (p_output == nullptr || !p_output->IsTensor()) {
+      continue;
+    }
+    const auto& tensor = p_output->Get<Tensor>();
+    if (tensor.Location().device.Type() != OrtDevice::CPU) {
+      continue;
+    }
+    if (tensor.IsDataType<float>()) {
+      for (float value : tensor.DataAsSpan<float>()) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        count += (bits & 0x7f800000u) == 0 && (bits & 0x007fffffu) != 0;
+      }
+    } else if (tensor.IsDataType<double>()) {
+      for (double value : tensor.DataAsSpan<double>()) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        count += (bits & 0x7ff0000000000000ull) == 0 && (bits & 0x000fffffffffffffull) != 0;
+      }
+    } else if (tensor.IsDataType<MLFloat16>()) {
+      for (MLFloat16 value : tensor.DataAsSpan<MLFloat16>()) {
+        count += (value.val & 0x7c00u) == 0 && (value.val & 0x03ffu) != 0;
+      }
+    }
+  }
+  return count;
+}
+
 static void CalculateTotalInputSizes(const OpKernelContextInternal* op_kernel_context,
                                      const onnxruntime::OpKernel* p_op_kernel,
                                      size_t& input_activation_sizes, size_t& input_parameter_sizes,
@@ -178,8 +219,22 @@ class SessionScope {
   {
     if (session_state_.Profiler().IsEnabled()) {
       session_start_ = session_state.Profiler().Start();
+      if (session_state_.Profiler().IsMemoryTraceEnabled()) {
+        memory_trace_.emplace(session_state_, frame);
+      }
     }
 
+    // the instrumentation that KernelScope adds around each kernel is decided once for the run, so kernels of
+    // uninstrumented runs go straight to Compute
+#if defined(CONCURRENCY_VISUALIZER) || defined(ENABLE_NVTX_PROFILE) || defined(DEBUG_NODE_INPUTS_OUTPUTS) || \
+    defined(ONNXRUNTIME_ENABLE_INSTRUMENT)
+    kernel_scope_needed_ = true;
+#else
+    kernel_scope_needed_ = session_state_.Profiler().IsEnabled() || profiling::NativeTracing::IsEnabled() ||
+                           session_state_.GetKernelLatencyMetrics() != nullptr ||
+                           session_state_.GetCalibrationCollector() != nullptr;
+#endif
+
     auto& logger = session_state_.Logger();
     VLOGS(logger, 0) << "Begin execution";
     const SequentialExecutionPlan& seq_exec_plan = *session_state_.GetExecutionPlan();
@@ -224,6 +279,10 @@ class SessionScope {
     }
 #endif
 
+    if (memory_trace_) {
+      memory_trace_->End();
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", session_start_);
     }
@@ -241,6 +300,12 @@ class SessionScope {
 #endif
   }
 
+  // Returns true if the kernels have to run in a KernelScope.
+  // RunStats are current per thread, and the kernels of a run can execute on the inter-op threads.
+  bool KernelScopeNeeded() const {
+    return kernel_scope_needed_ || RunStats::Current() != nullptr;
+  }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   void SetFlushMemoryInfoFlag(bool flush_memory_info) {
     flush_memory_info_ = flush_memory_info;
@@ -250,6 +315,8 @@ class SessionScope {
  private:
   const SessionState& session_state_;
   TimePoint session_start_;
+  std::optional<MemoryTrace> memory_trace_;
+  bool kernel_scope_needed_;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   const ExecutionFrame& frame_;
   // Whether memory profiler need create events and flush to file.
@@ -334,6 +401,11 @@ class KernelScope {
     node_compute_range_.Begin();
 #endif
 
+    if (profiling::NativeTracing::IsEnabled()) {
+      native_traced_ = true;
+      profiling::NativeTracing::Begin(MakeString(kernel_.Node().OpType(), " ", kernel_.Node().Name()));
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& node = kernel.Node();
       node_name_ = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
@@ -349,36 +421,96 @@ class KernelScope {
       CalculateTotalInputSizes(&kernel_context, &kernel_,
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
+      if (session_scope_.memory_trace_) {
+        memory_stats_begin_ = session_scope_.memory_trace_->BeginKernel();
+      }
+      if (const auto* hardware_counters = profiler.GetHardwareCounters()) {
+        hardware_counters_begin_ = hardware_counters->Read();
+      }
+    }
+
+    latency_metrics_ = session_state_.GetKernelLatencyMetrics();
+    if (latency_metrics_ != nullptr && latency_metrics_->ShouldSample(kernel_.Node().Index())) {
+      latency_sampled_ = true;
+      latency_begin_time_ = std::chrono::steady_clock::now();
+    }
+
+    run_stats_ = RunStats::Current();
+    if (run_stats_ != nullptr) {
+      run_stats_begin_time_ = std::chrono::steady_clock::now();
     }
   }
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
 
   ~KernelScope() {
+    if (run_stats_ != nullptr) {
+      run_stats_->kernel_time_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               std::chrono::steady_clock::now() - run_stats_begin_time_)
+                                               .count(),
+                                           std::memory_order_relaxed);
+      run_stats_->num_kernels.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (latency_sampled_) {
+      const auto duration = std::chrono::steady_clock::now() - latency_begin_time_;
+      latency_metrics_->Record(kernel_.Node().Index(), static_cast<uint64_t>(
+                                   std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+    }
+
+    // observe the outputs after the kernel was timed, so the calibration does not count as kernel latency
+    auto* calibration_collector = session_state_.GetCalibrationCollector();
+    if (calibration_collector != nullptr && calibration_collector->IsObserved(kernel_.Node().Index())) {
+      calibration_collector->Observe(kernel_.Node().Index(), kernel_context_);
+    }
+
 #ifdef ENABLE_NVTX_PROFILE
     node_compute_range_.End();
 #endif
 
+    if (native_traced_) {
+      profiling::NativeTracing::End();
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
+      // read the counters before anything else so that they only count the kernel
+      const auto* hardware_counters = profiler.GetHardwareCounters();
+      profiling::HardwareCounterValues hardware_counter_values;
+      if (hardware_counters != nullptr) {
+        hardware_counter_values = hardware_counters->Read() - hardware_counters_begin_;
+      }
       std::string output_type_shape_;
       CalculateTotalOutputSizes(&kernel_context_, total_output_sizes_, node_name_, output_type_shape_);
+      // Log additional operation args / info.
+      std::unordered_map<std::string, std::string> event_args{
+          {"op_name", kernel_.KernelDef().OpName()},
+          {"provider", kernel_.KernelDef().Provider()},
+          {"node_index", std::to_string(kernel_.Node().Index())},
+          {"activation_size", std::to_string(input_activation_sizes_)},
+          {"parameter_size", std::to_string(input_parameter_sizes_)},
+          {"output_size", std::to_string(total_output_sizes_)},
+          {"input_type_shape", input_type_shape_},
+          {"output_type_shape", output_type_shape_},
+          {"thread_scheduling_stats",
+           concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
+      };
+      if (hardware_counters != nullptr) {
+        event_args.emplace("hardware_counters", hardware_counter_values.ToJson());
+      }
+      if (session_state_.ProfileDenormals()) {
+        event_args.emplace("denormal_output_count", std::to_string(CountDenormalOutputs(&kernel_context_)));
+      }
+      if (session_scope_.memory_trace_) {
+        auto memory = session_scope_.memory_trace_->EndKernel(memory_stats_begin_, node_name_);
+        if (!memory.empty()) {
+          event_args.emplace("memory", std::move(memory));
+        }
+      }
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_kernel_time",
                                      kernel_begin_time_,
-                                     // Log additional operation args / info.
-                                     {
-                                         {"op_name", kernel_.KernelDef().OpName()},
-                                         {"provider", kernel_.KernelDef().Provider()},
-                                         {"node_index", std::to_string(kernel_.Node().Index())},
-                                         {"activation_size", std::to_string(input_activation_sizes_)},
-                                         {"parameter_size", std::to_string(input_parameter_sizes_)},
-                                         {"output_size", std::to_string(total_output_sizes_)},
-                                         {"input_type_shape", input_type_shape_},
-                                         {"output_type_shape", output_type_shape_},
-                                         {"thread_scheduling_stats",
-                                          concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
-                                     });
+                                     std::move(event_args));
       auto sync_time_begin = profiler.Start();
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_fence_after",
@@ -407,6 +539,8 @@ class KernelScope {
 
  private:
   TimePoint kernel_begin_time_;
+  profiling::HardwareCounterValues hardware_counters_begin_;
+  std::vector<AllocatorStats> memory_stats_begin_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
   std::string node_name_;
@@ -418,6 +552,13 @@ class KernelScope {
   size_t total_output_sizes_{};
   std::string input_type_shape_;
 
+  KernelLatencyMetrics* latency_metrics_{};
+  bool latency_sampled_{};
+  bool native_traced_{};
+  std::chrono::steady_clock::time_point latency_begin_time_;
+  RunStats* run_stats_{};
+  std::chrono::steady_clock::time_point run_stats_begin_time_;
+
 #ifdef CONCURRENCY_VISUALIZER
   diagnostic::span span_;
 #endif
@@ -431,12 +572,34 @@ class KernelScope {
 #endif
 };
 
+// Runs the kernel, or copies its memoized outputs if it already ran with the same inputs.
+static Status ComputeKernel(const OpKernel& kernel, OpKernelContextInternal& kernel_ctx,
+                            const SessionState& session_state) {
+  KernelResultCache* result_cache = session_state.GetKernelResultCache();
+  std::string key;
+  const bool memoized = result_cache != nullptr && result_cache->IsMemoized(kernel.Node().Index()) &&
+                        result_cache->MakeKey(kernel, kernel_ctx, key);
+  if (memoized && result_cache->TryReuse(key, kernel_ctx)) {
+    return Status::OK();
+  }
+
+  // the parallel loops of the kernel are calibrated per op type
+  concurrency::ThreadPool::CostCalibrationScope cost_calibration_scope(session_state.GetThreadPoolCostCalibration(),
+                                                                       kernel.Node().OpType());
+  auto status = kernel.Compute(&kernel_ctx);
+  if (memoized && status.IsOK()) {
+    result_cache->Insert(std::move(key), kernel_ctx);
+  }
+  return status;
+}
+
 onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                   NodeIndex idx,
                                   size_t stream_idx,
                                   const bool& terminate_flag,
                                   SessionScope& session_scope) {
   auto* p_kernel = ctx.GetSessionState().GetKernel(idx);
+#ifdef ENABLE_TRAINING
   if (p_kernel->KernelDef().OpName() == "YieldOp") {
     // Do not execute YieldOp (it is an no-op anyways).
     // Decrement the reference count of tensors that are not needed beyond this point.
@@ -446,6 +609,7 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
     ctx.RecycleNodeInputs(idx);
     return Status::OK();
   }
+#endif
   // TODO: set terminate flag from run_option
   OpKernelContextInternal kernel_ctx(ctx.GetSessionState(),
                                      ctx.GetExecutionFrame(),
@@ -458,7 +622,14 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
   if (p_kernel->IsAsync()) {
     ORT_THROW("Async Kernel Support is not implemented yet.");
   } else {
-    KernelScope kernel_scope(session_scope, kernel_ctx, *p_kernel);
+    std::optional<KernelScope> kernel_scope;
+    if (session_scope.KernelScopeNeeded()) {
+      kernel_scope.emplace(session_scope, kernel_ctx, *p_kernel);
+    }
+
+    // set on the thread running the kernel, which may not be a thread the session created
+    DenormalAsZeroScope denormal_as_zero_scope(ctx.GetSessionState().DenormalAsZero());
+
     ORT_TRY {
 #ifdef ENABLE_TRAINING
       // AllocateInputsContiguously - is only required for NCCL kernels
@@ -485,12 +656,12 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
         }
       }
       if (!reuse_cached_value) {
-        status = p_kernel->Compute(&kernel_ctx);
+        status = ComputeKernel(*p_kernel, kernel_ctx, ctx.GetSessionState());
       } else {
         status = kernel_ctx.SetOutputMLValue(0, cache.get()->at(cached_arg_name));
       }
 #else
-      status = p_kernel->Compute(&kernel_ctx);
+      status = ComputeKernel(*p_kernel, kernel_ctx, ctx.GetSessionState());
 #endif
     }
     ORT_CATCH(const std::exception& ex) {
@@ -563,14 +734,10 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              logger,
                              single_thread_mode);
 #endif
-#ifdef ENABLE_TRAINING
   if (only_execute_path_to_fetches) {
     auto* node_to_execute = session_state.GetToBeExecutedRange(fetch_mlvalue_idxs);
     ctx.SetNodeToExecute(node_to_execute);
   }
-#else
-  ORT_UNUSED_PARAMETER(only_execute_path_to_fetches);
-#endif
 
   SessionScope session_scope(session_state, ctx.GetExecutionFrame());
 
@@ -606,6 +773,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
     }
+  } else if (ctx.GetExecutionFrame().UsesBucketedMemoryPattern()) {
+    session_state.RecordBucketedMemoryPatternUse(feeds, ctx.GetExecutionFrame().GetBucketedMemoryPatternMisfits());
   }
 
   return Status::OK();
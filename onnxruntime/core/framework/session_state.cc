@@ -3,10 +3,13 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -14,6 +17,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/static_mem_pattern_planner.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -394,9 +399,84 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+// Identifies what the pre-packed contents of a node's weights can depend on, other than the weights themselves.
+static std::string GenerateKernelSignatureForPrepackedWeights(const Node& node) {
+  std::ostringstream ss;
+  ss << node.Domain() << ':' << node.OpType() << ':' << node.SinceVersion() << ':' << node.GetExecutionProviderType();
+
+  const auto& attributes = node.GetAttributes();
+  std::vector<std::string> attribute_names;
+  attribute_names.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    attribute_names.push_back(attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end());
+  for (const auto& name : attribute_names) {
+    ss << '|' << name << '=' << attributes.at(name).SerializeAsString();
+  }
+
+  return ss.str();
+}
+
+Status SessionState::PrepackWithDiskCache(OpKernel& kernel, const Node& node, int input_idx, const Tensor& weight,
+                                          bool& is_packed) {
+  is_packed = false;
+  const std::string key = PrepackedWeightsDiskCache::ComputeKey(GenerateKernelSignatureForPrepackedWeights(node),
+                                                                input_idx, weight);
+
+  PrePackedWeights prepacked_weights;
+  bool found = false;
+  ORT_RETURN_IF_ERROR(prepacked_weights_disk_cache_->Load(key, prepacked_weights, found));
+
+  if (found) {
+    LOGS(logger_, INFO) << "Using pre-packed weight from the disk cache for input " << input_idx
+                        << " of the node: " << node.Name() << " which is of op type: " << node.OpType();
+  } else {
+    AllocatorPtr session_cpu_alloc = GetAllocator(kernel.Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+    ORT_RETURN_IF_ERROR(kernel.PrePack(weight, input_idx, session_cpu_alloc, is_packed, &prepacked_weights));
+    if (!is_packed) {
+      return Status::OK();
+    }
+
+    ORT_ENFORCE(prepacked_weights.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+                " doesn't have an implementation that can cache computed pre-packed weights");
+
+    // A failure to write the cache only costs pre-packing again in the next session.
+    auto status = prepacked_weights_disk_cache_->Save(key, prepacked_weights);
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to write pre-packed weight of the node: " << node.Name()
+                             << " to the disk cache. " << status.ErrorMessage();
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(kernel, input_idx, prepacked_weights, node.Name()));
+  disk_cached_prepacked_weights_.push_back(std::move(prepacked_weights));
+  is_packed = true;
+  return Status::OK();
+}
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  // PrePack() of a CPU kernel without any caching of the pre-packed weights, collected to run on the intra-op pool
+  struct DeferredPrePack {
+    OpKernel* kernel;
+    int input_idx;
+    const Tensor* weight;
+    AllocatorPtr alloc;
+    SessionState* st;
+    int ort_value_idx;
+    const std::string* input_name;
+    Status status;
+    bool is_packed;
+  };
+  std::vector<DeferredPrePack> deferred_prepacks;
+
+  const bool parallel_prepacking =
+      concurrency::ThreadPool::DegreeOfParallelism(thread_pool_) > 1 &&
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableParallelPrepacking, "0") == "1";
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     &deferred_prepacks, parallel_prepacking](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -476,6 +556,18 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                     }
                   }
 
+                } else if (prepacked_weights_disk_cache_ != nullptr &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           kernel->CanSkipPrePackWithSharedBuffers(input_idx)) {  // on-disk cache turned ON
+                  ORT_RETURN_IF_ERROR(PrepackWithDiskCache(*kernel, node, input_idx, const_initialized_tensor,
+                                                           is_packed));
+                } else if (parallel_prepacking && !should_cache_prepacked_weights_for_shared_initializers &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  // the use count of the weight is not decremented until the deferred PrePack() has run,
+                  // so the tensor stays alive until then
+                  deferred_prepacks.push_back({kernel, input_idx, &const_initialized_tensor,
+                                               GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault)),
+                                               st, ort_value_idx, &input_name, Status::OK(), false});
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -518,17 +610,81 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
     // and writes pre-packed weights to the container
     std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
     return prepacked_constant_weights(true);
-  } else {
-    return prepacked_constant_weights(false);
   }
+
+  ORT_RETURN_IF_ERROR(prepacked_constant_weights(false));
+
+  if (deferred_prepacks.empty()) {
+    return Status::OK();
+  }
+
+  // A kernel may rely on the state left by the PrePack() of its previous inputs, so the weights of one kernel are
+  // pre-packed in order by a single task. The deferred PrePack() calls are in node order, so they are contiguous.
+  std::vector<size_t> kernel_begin;
+  for (size_t i = 0; i < deferred_prepacks.size(); ++i) {
+    if (i == 0 || deferred_prepacks[i].kernel != deferred_prepacks[i - 1].kernel) {
+      kernel_begin.push_back(i);
+    }
+  }
+  kernel_begin.push_back(deferred_prepacks.size());
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(kernel_begin.size() - 1), [&](std::ptrdiff_t k) {
+        for (size_t i = kernel_begin[k]; i < kernel_begin[k + 1]; ++i) {
+          auto& prepack = deferred_prepacks[i];
+          ORT_TRY {
+            prepack.status = prepack.kernel->PrePack(*prepack.weight, prepack.input_idx, prepack.alloc,
+                                                     prepack.is_packed, nullptr);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              prepack.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+            });
+          }
+          if (!prepack.status.IsOK()) {
+            break;
+          }
+        }
+      });
+
+  for (auto& prepack : deferred_prepacks) {
+    ORT_RETURN_IF_ERROR(prepack.status);
+    if (prepack.is_packed) {
+      ++number_of_prepacks_counter_;
+
+      const std::string& input_name = *prepack.input_name;
+      if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
+        // release the constant initialized tensor
+        prepack.st->initialized_tensors_.erase(prepack.ort_value_idx);
+        prepack.st->constant_initialized_tensors_.erase(prepack.ort_value_idx);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+static int64_t RoundUpToShapeBucket(int64_t dim, gsl::span<const int64_t> shape_buckets) {
+  auto it = std::lower_bound(shape_buckets.begin(), shape_buckets.end(), dim);
+  return it != shape_buckets.end() ? *it : dim;
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
+// Key of the input shapes, with every dimension rounded up to its shape bucket if shape_buckets is not empty.
+// The position of the dimensions is part of the key so that permuted shapes don't share a pattern.
+static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs,
+                                          gsl::span<const int64_t> shape_buckets = {}) {
+  uint64_t key = 0;
+  auto combine = [&key](int64_t value) {
+    key ^= static_cast<uint64_t>(value) + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+  };
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    combine(static_cast<int64_t>(dims.size()));
+    for (auto dim : dims) {
+      combine(shape_buckets.empty() ? dim : RoundUpToShapeBucket(dim, shape_buckets));
+    }
   }
-  return key;
+  return static_cast<int64_t>(key);
 }
 
 #ifdef ENABLE_TRAINING
@@ -765,6 +921,117 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
+Status SessionState::GenerateStaticMemoryPatternGroup(MemoryPatternGroup& output,
+                                                      InlinedHashMap<int, TensorShape>& input_shapes) const {
+  const auto* exe_plan = GetExecutionPlan();
+  ORT_ENFORCE(exe_plan);
+  // with several streams the order of the steps and therefore the lifetimes are not known ahead of execution
+  ORT_RETURN_IF_NOT(exe_plan->execution_plan.size() == 1, "Static memory planning requires a single stream.");
+
+  auto is_fixed_shape = [](const NodeArg& arg) {
+    const auto* shape = arg.Shape();
+    return shape != nullptr &&
+           std::all_of(shape->dim().begin(), shape->dim().end(), [](const auto& dim) {
+             return utils::HasDimValue(dim) && dim.dim_value() >= 0;
+           });
+  };
+
+  for (const auto* input : graph_viewer_->GetInputs()) {
+    ORT_RETURN_IF_NOT(is_fixed_shape(*input), "Graph input ", input->Name(), " does not have a fixed shape.");
+    int ort_value_idx;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(input->Name(), ort_value_idx));
+    input_shapes.insert_or_assign(ort_value_idx, utils::GetTensorShapeFromTensorShapeProto(*input->Shape()));
+  }
+
+  const auto& steps = exe_plan->execution_plan[0]->steps_;
+  const size_t num_steps = steps.size();
+
+  // a tensor is live from the step of its producer until its release, or until the end of the execution if it
+  // has no release action or one that is only resolved at runtime.
+  InlinedHashMap<size_t, size_t> release_steps;
+  for (size_t step = 0; step < num_steps; ++step) {
+    for (size_t action_idx : exe_plan->node_release_list[steps[step]->GetNodeIndex()]) {
+      const auto& action = exe_plan->release_actions[action_idx];
+      if (action.ref_count == 1) {
+        release_steps[action.value_index] = step;
+      }
+    }
+  }
+
+  std::vector<std::pair<OrtDevice, StaticMemPatternPlanner>> planners;
+  size_t num_planned = 0;
+  for (size_t step = 0; step < num_steps; ++step) {
+    const auto* node = graph_viewer_->GetNode(steps[step]->GetNodeIndex());
+    ORT_RETURN_IF(node == nullptr, "Can't find the node of execution step ", step);
+    for (const auto* output_def : node->OutputDefs()) {
+      if (!output_def->Exists()) {
+        continue;
+      }
+
+      int ort_value_idx;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(output_def->Name(), ort_value_idx));
+      const auto& alloc_plan = exe_plan->allocation_plan[ort_value_idx];
+      // tensors without a fixed shape are allocated at runtime
+      if (alloc_plan.alloc_kind != AllocKind::kAllocate || !alloc_plan.value_type->IsTensorType() ||
+          alloc_plan.location.MemType() != OrtDevice::MemType::DEFAULT || !is_fixed_shape(*output_def)) {
+        continue;
+      }
+
+      const auto* ml_data_type = static_cast<const TensorTypeBase*>(alloc_plan.value_type)->GetElementType();
+      if (utils::IsDataTypeString(ml_data_type)) {
+        continue;
+      }
+
+      const auto shape = utils::GetTensorShapeFromTensorShapeProto(*output_def->Shape());
+      size_t size = 0;
+      if (!IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(static_cast<size_t>(shape.Size()),
+                                                                         ml_data_type->Size(), &size)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Size overflow for ", output_def->Name());
+      }
+
+      auto release_step = release_steps.find(ort_value_idx);
+      const size_t last_step = release_step != release_steps.end() ? release_step->second : num_steps;
+
+      auto planner = std::find_if(planners.begin(), planners.end(),
+                                  [&](const auto& entry) { return entry.first == alloc_plan.location; });
+      if (planner == planners.end()) {
+        planners.emplace_back(alloc_plan.location, StaticMemPatternPlanner{});
+        planner = std::prev(planners.end());
+      }
+      planner->second.AddTensor(ort_value_idx, size, step, std::max(step, last_step));
+      ++num_planned;
+    }
+  }
+
+  ORT_RETURN_IF(num_planned == 0, "No tensors with a fixed shape to plan.");
+
+  for (const auto& planner : planners) {
+    output.locations.push_back(planner.first);
+    output.patterns.push_back(planner.second.GenerateMemPattern());
+    LOGS(logger_, INFO) << "Static memory plan for " << planner.first.ToString() << ": "
+                        << output.patterns.back().GetPatternsMap().size() << " tensors, peak size "
+                        << output.patterns.back().PeakSize() << " bytes";
+  }
+
+  return Status::OK();
+}
+
+const MemoryPatternGroup* SessionState::GetStaticMemoryPatternGroup(gsl::span<const OrtValue> tensor_inputs,
+                                                                    gsl::span<const int> feed_mlvalue_idxs) const {
+  if (!static_mem_patterns_ || feed_mlvalue_idxs.size() != static_mem_pattern_input_shapes_.size()) {
+    return nullptr;
+  }
+
+  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+    auto it = static_mem_pattern_input_shapes_.find(feed_mlvalue_idxs[i]);
+    if (it == static_mem_pattern_input_shapes_.end() || it->second != tensor_inputs[i].Get<Tensor>().Shape()) {
+      return nullptr;
+    }
+  }
+
+  return static_mem_patterns_.get();
+}
+
 // MemoryPatternGroup pointer is cached. It only inserted upon creation
 // and is not updated if already present.
 const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
@@ -799,6 +1066,30 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
   return &it->second;
 }
 
+// Everything the memory patterns traced for an execution plan depend on besides the input shapes: the OrtValue
+// indices, how and where the values are allocated, and the order of the execution steps.
+static std::string GetExecutionPlanSignature(const SequentialExecutionPlan& plan,
+                                             const OrtValueNameIdxMap& ort_value_name_idx_map) {
+  std::ostringstream ss;
+  for (const auto& stream : plan.execution_plan) {
+    ss << stream->device_.ToString() << '{';
+    for (const auto& step : stream->steps_) {
+      ss << step->ToString() << ';';
+    }
+    ss << '}';
+  }
+
+  for (int i = 0, end = static_cast<int>(plan.allocation_plan.size()); i < end; ++i) {
+    std::string name;
+    ORT_IGNORE_RETURN_VALUE(ort_value_name_idx_map.GetName(i, name));
+    const auto& value_plan = plan.allocation_plan[i];
+    ss << name << '|' << static_cast<int>(value_plan.alloc_kind) << '|' << value_plan.location.ToString() << '|'
+       << value_plan.reused_buffer << ';';
+  }
+
+  return ss.str();
+}
+
 void SessionState::ResolveMemoryPatternFlag() {
   if (enable_mem_pattern_) {
     for (auto* input : graph_viewer_->GetInputs()) {
@@ -843,18 +1134,121 @@ void SessionState::ResolveMemoryPatternFlag() {
       }
     }
   }
+
+  if (enable_mem_pattern_ && !graph_viewer_->IsSubgraph() &&
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigStaticMemoryPlanning, "0") == "1") {
+    MemoryPatternGroup mem_patterns;
+    InlinedHashMap<int, TensorShape> input_shapes;
+    auto status = GenerateStaticMemoryPatternGroup(mem_patterns, input_shapes);
+    if (status.IsOK()) {
+      static_mem_patterns_ = std::make_unique<const MemoryPatternGroup>(std::move(mem_patterns));
+      static_mem_pattern_input_shapes_ = std::move(input_shapes);
+    } else {
+      // not an error, the memory patterns are traced at runtime as usual
+      LOGS(logger_, INFO) << "Memory is not planned statically: " << status.ErrorMessage();
+    }
+  }
+
+  const std::string mem_patterns_cache_dir =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternsCacheDir, "");
+  if (enable_mem_pattern_ && !graph_viewer_->IsSubgraph() && !UseMemoryPatternShapeBuckets() &&
+      !mem_patterns_cache_dir.empty()) {
+    mem_pattern_disk_cache_ = std::make_unique<MemoryPatternDiskCache>(
+        Env::Default(), ToPathString(mem_patterns_cache_dir),
+        GetExecutionPlanSignature(*GetExecutionPlan(), ort_value_name_idx_map_));
+
+    std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+    auto status = mem_pattern_disk_cache_->Load(mem_patterns_);
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to read the memory patterns from the disk cache. " << status.ErrorMessage();
+    } else {
+      LOGS(logger_, INFO) << mem_patterns_.size() << " memory patterns loaded from the disk cache.";
+    }
+  }
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
+  if (UseMemoryPatternShapeBuckets()) {
+    int64_t key = CalculateMemoryPatternsKey(tensor_inputs, mem_pattern_shape_buckets_);
+    auto patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+    // the execution that planned the pattern didn't use one
+    mem_pattern_misses_.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+    // replace the pattern of the bucket, frames using the previous one keep a reference to it
+    bucketed_mem_patterns_[key].patterns = std::move(patterns);
+    return Status::OK();
+  }
+
   int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  const bool inserted = mem_patterns_.emplace(key, std::move(mem_patterns)).second;
+  if (inserted && mem_pattern_disk_cache_ != nullptr) {
+    // A failure to write the cache only costs tracing the patterns again in the next session.
+    auto status = mem_pattern_disk_cache_->Save(mem_patterns_);
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to write the memory patterns to the disk cache. " << status.ErrorMessage();
+    }
+  }
   return Status::OK();
 }
 
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetBucketedMemoryPatternGroup(
+    gsl::span<const OrtValue> tensor_inputs,
+    std::shared_ptr<const InlinedHashMap<int, size_t>>& min_block_sizes) const {
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, mem_pattern_shape_buckets_);
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto it = bucketed_mem_patterns_.find(key);
+  if (it == bucketed_mem_patterns_.end()) {
+    min_block_sizes = nullptr;
+    return nullptr;
+  }
+
+  min_block_sizes = it->second.patterns ? nullptr : it->second.min_block_sizes;
+  return it->second.patterns;
+}
+
+void SessionState::RecordBucketedMemoryPatternUse(gsl::span<const OrtValue> tensor_inputs,
+                                                  gsl::span<const std::pair<int, size_t>> misfits) const {
+  if (misfits.empty()) {
+    mem_pattern_hits_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  mem_pattern_misses_.fetch_add(1, std::memory_order_relaxed);
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, mem_pattern_shape_buckets_);
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto it = bucketed_mem_patterns_.find(key);
+  if (it == bucketed_mem_patterns_.end()) {
+    return;
+  }
+
+  // the blocks of the current pattern are kept, so the pattern only grows until the largest tensors of the bucket fit
+  auto& entry = it->second;
+  auto min_block_sizes = entry.min_block_sizes ? std::make_shared<InlinedHashMap<int, size_t>>(*entry.min_block_sizes)
+                                               : std::make_shared<InlinedHashMap<int, size_t>>();
+  auto update_min_block_size = [&min_block_sizes](int ort_value_idx, size_t size) {
+    auto& min_size = (*min_block_sizes)[ort_value_idx];
+    min_size = std::max(min_size, size);
+  };
+  if (entry.patterns) {
+    for (const auto& pattern : entry.patterns->patterns) {
+      for (const auto& block : pattern.GetPatternsMap()) {
+        update_min_block_size(block.first, block.second.size_);
+      }
+    }
+  }
+  for (const auto& misfit : misfits) {
+    update_min_block_size(misfit.first, misfit.second);
+  }
+
+  entry.min_block_sizes = std::move(min_block_sizes);
+  entry.patterns = nullptr;
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -984,34 +1378,71 @@ const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   return *node_index_info_;
 }
 
-#ifdef ENABLE_TRAINING
+void SessionState::GetKernelLatencies(std::vector<KernelLatency>& kernel_latencies) const {
+  if (kernel_latency_metrics_) {
+    kernel_latency_metrics_->GetKernelLatencies(kernel_latencies);
+  }
+
+  for (const auto& entry : subgraph_session_states_) {
+    for (const auto& name_to_subgraph_session_state : entry.second) {
+      name_to_subgraph_session_state.second->GetKernelLatencies(kernel_latencies);
+    }
+  }
+}
+
+void SessionState::GetCalibrationStatistics(std::vector<CalibrationStatistics>& statistics) const {
+  if (calibration_collector_) {
+    calibration_collector_->GetStatistics(statistics);
+  }
+
+  for (const auto& entry : subgraph_session_states_) {
+    for (const auto& name_to_subgraph_session_state : entry.second) {
+      name_to_subgraph_session_state.second->GetCalibrationStatistics(statistics);
+    }
+  }
+}
+
 void SessionState::UpdateToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) {
   InlinedVector<int> sorted_idxs;
   sorted_idxs.reserve(fetch_mlvalue_idxs.size());
   sorted_idxs.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
   std::sort(sorted_idxs.begin(), sorted_idxs.end());
-  if (to_be_executed_nodes_.find(sorted_idxs) != to_be_executed_nodes_.end())
-    return;
-
-  // Get the nodes generating the fetches.
-  InlinedVector<const Node*> nodes;
-  nodes.reserve(fetch_mlvalue_idxs.size());
-  InlinedHashSet<NodeIndex> reachable_nodes;
-  reachable_nodes.reserve(graph_.NumberOfNodes());
+  {
+    std::lock_guard<OrtMutex> lock(to_be_executed_nodes_mutex_);
+    if (to_be_executed_nodes_.find(sorted_idxs) != to_be_executed_nodes_.end())
+      return;
+  }
 
+  InlinedHashSet<std::string> fetch_names;
+  fetch_names.reserve(fetch_mlvalue_idxs.size());
   for (auto idx : fetch_mlvalue_idxs) {
     std::string node_arg_name;
     const auto status = this->GetOrtValueNameIdxMap().GetName(idx, node_arg_name);
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-    auto ending_node = graph_.GetProducerNode(node_arg_name);
-    nodes.push_back(ending_node);
+    fetch_names.insert(std::move(node_arg_name));
+  }
+
+  // Get the nodes generating the fetches. Fetches that are graph inputs or initializers have no producer.
+  // The producers are looked up from the node outputs so this also works in minimal builds.
+  InlinedVector<const Node*> nodes;
+  nodes.reserve(fetch_mlvalue_idxs.size());
+  for (const auto& node : graph_.Nodes()) {
+    for (const auto* output_def : node.OutputDefs()) {
+      if (output_def->Exists() && fetch_names.count(output_def->Name()) > 0) {
+        nodes.push_back(&node);
+        break;
+      }
+    }
   }
 
   // Reversely traverse to get reachable nodes.
+  auto reachable_nodes = std::make_unique<InlinedHashSet<NodeIndex>>();
+  reachable_nodes->reserve(graph_.NumberOfNodes());
   graph_.ReverseDFSFrom(
-      nodes, {}, [&reachable_nodes](const Node* n) { reachable_nodes.insert(n->Index()); });
+      nodes, {}, [&reachable_nodes](const Node* n) { reachable_nodes->insert(n->Index()); });
 
   // global start, end doesn't matters
+  std::lock_guard<OrtMutex> lock(to_be_executed_nodes_mutex_);
   to_be_executed_nodes_.emplace(std::move(sorted_idxs), std::move(reachable_nodes));
 }
 
@@ -1021,10 +1452,10 @@ const InlinedHashSet<NodeIndex>* SessionState::GetToBeExecutedRange(
   sorted_idxs.reserve(fetch_mlvalue_idxs.size());
   sorted_idxs.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
   std::sort(sorted_idxs.begin(), sorted_idxs.end());
+  std::lock_guard<OrtMutex> lock(to_be_executed_nodes_mutex_);
   auto it = to_be_executed_nodes_.find(sorted_idxs);
-  return (it != to_be_executed_nodes_.end()) ? &it->second : nullptr;
+  return (it != to_be_executed_nodes_.end()) ? it->second.get() : nullptr;
 }
-#endif
 
 Status SessionState::CreateSubgraphSessionState() {
   for (auto& node : graph_.Nodes()) {
@@ -1376,9 +1807,25 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  // in parallel mode, the CPU nodes of the main graph are spread over as many streams as the inter-op pool runs at once
+  size_t max_cpu_streams = 1;
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL && parent_node == nullptr) {
+    const std::string max_cpu_streams_str =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelExecutionCpuStreams, "");
+    if (max_cpu_streams_str.empty()) {
+      max_cpu_streams = static_cast<size_t>(
+          std::max(concurrency::ThreadPool::DegreeOfParallelism(inter_op_thread_pool_), 1));
+    } else {
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_cpu_streams_str, max_cpu_streams) && max_cpu_streams > 0,
+                        "Invalid value for ", kOrtSessionOptionsConfigParallelExecutionCpuStreams, ": ",
+                        max_cpu_streams_str);
+    }
+  }
+
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   max_cpu_streams);
 
 #ifdef _WIN32
 
@@ -1503,6 +1950,13 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
   if (!disable_prepacking) {
+    const std::string prepacked_weights_cache_dir =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsCacheDir, "");
+    if (!prepacked_weights_cache_dir.empty()) {
+      prepacked_weights_disk_cache_ = std::make_unique<PrepackedWeightsDiskCache>(
+          Env::Default(), ToPathString(prepacked_weights_cache_dir));
+    }
+
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
                                                           session_options.initializers_to_share_map));
   }
@@ -1510,6 +1964,83 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
 
+  const std::string mem_pattern_shape_buckets =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternShapeBuckets, "");
+  for (const auto bucket_str : utils::SplitString(mem_pattern_shape_buckets, ",")) {
+    int64_t bucket = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(bucket_str, bucket) && bucket > 0,
+                      "Invalid memory pattern shape bucket: ", bucket_str);
+    mem_pattern_shape_buckets_.push_back(bucket);
+  }
+  std::sort(mem_pattern_shape_buckets_.begin(), mem_pattern_shape_buckets_.end());
+  mem_pattern_shape_buckets_.erase(std::unique(mem_pattern_shape_buckets_.begin(), mem_pattern_shape_buckets_.end()),
+                                   mem_pattern_shape_buckets_.end());
+
+  const std::string kernel_latency_sampling_interval =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigKernelLatencySamplingInterval, "0");
+  uint32_t sampling_interval = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(kernel_latency_sampling_interval, sampling_interval),
+                    "Invalid kernel latency sampling interval: ", kernel_latency_sampling_interval);
+  if (sampling_interval > 0) {
+    kernel_latency_metrics_ = std::make_unique<KernelLatencyMetrics>(*graph_viewer_, sampling_interval);
+  }
+
+  const std::string calibration_tensors =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsCalibrationTensors, "");
+  if (!calibration_tensors.empty()) {
+    InlinedHashSet<std::string> tensor_names;
+    if (calibration_tensors != "*") {
+      for (const auto name : utils::SplitString(calibration_tensors, ",")) {
+        tensor_names.emplace(name);
+      }
+    }
+
+    const std::string calibration_method_str =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsCalibrationMethod, "minmax");
+    CalibrationMethod calibration_method;
+    ORT_RETURN_IF_NOT(TryParseCalibrationMethod(calibration_method_str, calibration_method),
+                      "Invalid calibration method: ", calibration_method_str);
+
+    const std::string calibration_percentile_str =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsCalibrationPercentile, "99.999");
+    double calibration_percentile = 0.0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(calibration_percentile_str, calibration_percentile) &&
+                          calibration_percentile > 0.0 && calibration_percentile <= 100.0,
+                      "Invalid calibration percentile: ", calibration_percentile_str);
+
+    calibration_collector_ = std::make_unique<CalibrationCollector>(*graph_viewer_, tensor_names, calibration_method,
+                                                                    calibration_percentile);
+  }
+
+  const std::string memoized_outputs =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoizedOutputs, "");
+  if (!memoized_outputs.empty()) {
+    InlinedHashSet<std::string> output_names;
+    for (const auto name : utils::SplitString(memoized_outputs, ",")) {
+      output_names.emplace(name);
+    }
+
+    const std::string memoization_cache_size_str =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoizationCacheSize, "67108864");
+    size_t memoization_cache_size = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(memoization_cache_size_str, memoization_cache_size),
+                      "Invalid memoization cache size: ", memoization_cache_size_str);
+
+    kernel_result_cache_ = std::make_unique<KernelResultCache>(*graph_viewer_, output_names, memoization_cache_size,
+                                                               GetAllocator(OrtDevice()));
+  }
+
+  // the subgraphs get the calibration of their parent graph before they are finalized
+  if (thread_pool_cost_calibration_ == nullptr &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsIntraOpCostCalibration, "0") == "1") {
+    thread_pool_cost_calibration_ = std::make_shared<concurrency::ThreadPoolCostCalibration>();
+  }
+
+  denormal_as_zero_ =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSetDenormalAsZero, "0") == "1";
+  profile_denormals_ =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileDenormals, "0") == "1";
+
   // Need to recurse into subgraph session state instances to finalize them and add the execution info
 
   // Currently all subgraphs need to be executed using the sequential EP due to potential deadlock with the current
@@ -1535,6 +2066,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
       // We need to create graph info for the subgraphs because information accumulated there
       // is used in OuterScopeNodeArgLocationAccumulator()
       subgraph_session_state.CreateGraphInfo();
+      subgraph_session_state.thread_pool_cost_calibration_ = thread_pool_cost_calibration_;
 
       InlinedHashMap<OrtValueName, OrtDevice> subgraph_outer_scope_node_arg_to_location_map;
       ORT_RETURN_IF_ERROR(OuterScopeNodeArgLocationAccumulator(*p_seq_exec_plan_, GetOrtValueNameIdxMap(),
@@ -1583,10 +2115,10 @@ static void BindToDeviceStream(const SequentialExecutionPlan& execution_plan,
   }
 }
 
-std::unique_ptr<DeviceStreamCollection> SessionState::AcquireDeviceStreamCollection() const {
+std::unique_ptr<DeviceStreamCollection> SessionState::AcquireDeviceStreamCollection(bool reuse) const {
   if (has_device_stream_enabled_ep_) {
     std::lock_guard<onnxruntime::OrtMutex> lock(device_stream_pool_mutex_);
-    if (!device_stream_pool_.empty()) {
+    if (reuse && !device_stream_pool_.empty()) {
       auto device_stream = std::move(device_stream_pool_.back());
       device_stream_pool_.pop_back();
       return device_stream;
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -16,7 +17,9 @@
 #include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/common/threadpool_cost_calibration.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/calibration_collector.h"
 #include "core/framework/callback.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_providers.h"
@@ -24,9 +27,13 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_disk_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
+#include "core/framework/kernel_latency_metrics.h"
+#include "core/framework/kernel_result_cache.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_disk_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -203,6 +210,52 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const noexcept { return profiler_; }
 
+  /**
+  Get the kernel latency metrics of this graph, nullptr unless kOrtSessionOptionsConfigKernelLatencySamplingInterval
+  is set.
+  */
+  KernelLatencyMetrics* GetKernelLatencyMetrics() const noexcept { return kernel_latency_metrics_.get(); }
+
+  /**
+  Appends the sampled kernel latencies of this graph and of all its subgraphs.
+  */
+  void GetKernelLatencies(std::vector<KernelLatency>& kernel_latencies) const;
+
+  /**
+  Get the calibration collector of this graph, nullptr unless kOrtSessionOptionsCalibrationTensors is set.
+  */
+  CalibrationCollector* GetCalibrationCollector() const noexcept { return calibration_collector_.get(); }
+
+  /**
+  Appends the calibration statistics of this graph and of all its subgraphs.
+  */
+  void GetCalibrationStatistics(std::vector<CalibrationStatistics>& statistics) const;
+
+  /**
+  Get the memoized kernel results of this graph, nullptr unless kOrtSessionOptionsMemoizedOutputs is set.
+  */
+  KernelResultCache* GetKernelResultCache() const noexcept { return kernel_result_cache_.get(); }
+
+  /**
+  Get the calibration of the cost of the parallel loops of the kernels, shared with the subgraphs. nullptr unless
+  kOrtSessionOptionsIntraOpCostCalibration is set.
+  */
+  concurrency::ThreadPoolCostCalibration* GetThreadPoolCostCalibration() const noexcept {
+    return thread_pool_cost_calibration_.get();
+  }
+
+  /**
+  Whether flush-to-zero and denormal-as-zero are set around the execution of each kernel, from
+  kOrtSessionOptionsConfigSetDenormalAsZero.
+  */
+  bool DenormalAsZero() const noexcept { return denormal_as_zero_; }
+
+  /**
+  Whether the profiled kernels record the number of denormal values in their outputs, from
+  kOrtSessionOptionsConfigProfileDenormals.
+  */
+  bool ProfileDenormals() const noexcept { return profile_denormals_; }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   MemoryProfiler* GetMemoryProfiler() const noexcept { return memory_profiler_; }
 
@@ -225,6 +278,14 @@ class SessionState {
       gsl::span<const int> feed_mlvalue_idxs,
       const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
 
+  /**
+  Get the memory pattern planned during initialization if the model has fixed shapes
+  (kOrtSessionOptionsConfigStaticMemoryPlanning) and the inputs have these shapes, nullptr otherwise.
+  All inputs must represent Tensors
+  */
+  const MemoryPatternGroup* GetStaticMemoryPatternGroup(gsl::span<const OrtValue> tensor_inputs,
+                                                        gsl::span<const int> feed_mlvalue_idxs) const;
+
   /**
   Set generated memory pattern with a given input shapes.
   Const as it's an internal cache update only.
@@ -233,6 +294,44 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Whether memory patterns are cached per shape bucket (kOrtSessionOptionsConfigMemoryPatternShapeBuckets)
+  instead of per exact input shapes.
+  */
+  bool UseMemoryPatternShapeBuckets() const noexcept { return !mem_pattern_shape_buckets_.empty(); }
+
+  /**
+  Get the memory pattern of the shape bucket of the given inputs. The returned pattern stays valid while it is
+  referenced, even if the bucket is planned again.
+  Returns nullptr if the bucket has to be planned, either because it has no pattern yet or because a tensor of a
+  previous execution didn't fit its block. min_block_sizes then receives the sizes by OrtValue index that the new
+  pattern shall at least provide, nullptr if there are none.
+  All inputs must represent Tensors
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetBucketedMemoryPatternGroup(
+      gsl::span<const OrtValue> tensor_inputs,
+      std::shared_ptr<const InlinedHashMap<int, size_t>>& min_block_sizes) const;
+
+  /**
+  Record the use of the shape bucket memory pattern by an execution with the given inputs.
+  misfits holds the OrtValue indices and sizes of the tensors that didn't fit their block. If there are any,
+  the bucket is planned again with blocks for at least these sizes and the block sizes of the current pattern.
+  */
+  void RecordBucketedMemoryPatternUse(gsl::span<const OrtValue> tensor_inputs,
+                                      gsl::span<const std::pair<int, size_t>> misfits) const;
+
+  struct MemoryPatternCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+  };
+
+  /**
+  Get the number of executions that did and did not find their tensors in a cached shape bucket memory pattern.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const noexcept {
+    return {mem_pattern_hits_.load(std::memory_order_relaxed), mem_pattern_misses_.load(std::memory_order_relaxed)};
+  }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -249,6 +348,8 @@ class SessionState {
   /**
   Update enable_mem_pattern_ flag according to the presence of graph inputs' shape
   If any one of the graph input is shapeless, enable_mem_pattern_ will be set to false
+  Plans the static memory pattern if kOrtSessionOptionsConfigStaticMemoryPlanning is set and the model has fixed
+  shapes.
   */
   void ResolveMemoryPatternFlag();
 
@@ -297,10 +398,11 @@ class SessionState {
   InlinedVector<BufferUniquePtr>& GetMutableWeightsBuffers() noexcept { return weights_buffers_; }
 
   const NodeIndexInfo& GetNodeIndexInfo() const;
-#ifdef ENABLE_TRAINING
+  // Computes and caches the nodes needed to produce the fetches, for the runs with
+  // RunOptions::only_execute_path_to_fetches set. The nodes are cached per set of fetches. Thread-safe.
   void UpdateToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs);
+  // Returns the cached nodes needed to produce the fetches, or nullptr if they were not computed.
   const InlinedHashSet<NodeIndex>* GetToBeExecutedRange(gsl::span<int const> fetch_mlvalue_idxs) const;
-#endif
 
   Status FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                               const KernelRegistryManager& kernel_registry_manager,
@@ -332,7 +434,8 @@ class SessionState {
   }
 
 #ifdef ORT_ENABLE_STREAM
-  std::unique_ptr<DeviceStreamCollection> AcquireDeviceStreamCollection() const;
+  // Get the device streams for a run, from the pool of the recycled ones if reuse is set.
+  std::unique_ptr<DeviceStreamCollection> AcquireDeviceStreamCollection(bool reuse = true) const;
 
   void RecycleDeviceStreamCollection(std::unique_ptr<DeviceStreamCollection> device_stream_collection) const;
 
@@ -374,6 +477,11 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // Pre-packs a constant initializer through the on-disk pre-packed weights cache: cached buffers are mapped
+  // without calling PrePack(), otherwise the buffers produced by PrePack() are written to the cache.
+  Status PrepackWithDiskCache(OpKernel& kernel, const Node& node, int input_idx, const Tensor& weight,
+                              bool& is_packed);
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -393,6 +501,11 @@ class SessionState {
                                   const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map = {},
                                   bool graph_info_already_created = false);
 
+  // Plans the memory pattern of the main graph from the fixed shapes of its tensors and their lifetimes in the
+  // execution plan. input_shapes receives the shapes of the graph inputs by OrtValue index.
+  Status GenerateStaticMemoryPatternGroup(MemoryPatternGroup& output,
+                                          InlinedHashMap<int, TensorShape>& input_shapes) const;
+
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
       gsl::span<const OrtValue> inputs,
@@ -496,6 +609,28 @@ class SessionState {
   NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
 #endif
 
+  // On-disk cache of mem_patterns_, nullptr unless kOrtSessionOptionsConfigMemoryPatternsCacheDir is set.
+  std::unique_ptr<MemoryPatternDiskCache> mem_pattern_disk_cache_;
+
+  // memory pattern planned during initialization for the fixed input shapes, nullptr if there is none.
+  std::unique_ptr<const MemoryPatternGroup> static_mem_patterns_;
+  InlinedHashMap<int, TensorShape> static_mem_pattern_input_shapes_;
+
+  // Sorted upper bounds of the shape buckets, empty unless kOrtSessionOptionsConfigMemoryPatternShapeBuckets is set.
+  InlinedVector<int64_t> mem_pattern_shape_buckets_;
+
+  struct BucketedMemoryPattern {
+    // nullptr while the bucket has to be planned again
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    std::shared_ptr<const InlinedHashMap<int, size_t>> min_block_sizes;
+  };
+
+  // cache for memory patterns per shape bucket, guarded by mem_patterns_lock_.
+  // a pattern planned again replaces the previous one, which is shared with the frames still using it.
+  mutable InlinedHashMap<int64_t, BucketedMemoryPattern> bucketed_mem_patterns_;
+  mutable std::atomic<uint64_t> mem_pattern_hits_{0};
+  mutable std::atomic<uint64_t> mem_pattern_misses_{0};
+
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
 
@@ -517,13 +652,34 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
-#ifdef ENABLE_TRAINING
-// Needed for ORTTrainer. Should be removed along with ORTTrainer code
+  // On-disk cache of pre-packed weights, nullptr unless kOrtSessionOptionsConfigPrepackedWeightsCacheDir is set.
+  std::unique_ptr<PrepackedWeightsDiskCache> prepacked_weights_disk_cache_;
+
+  // Pre-packed buffers used by kernels of this session through the on-disk cache.
+  std::vector<PrePackedWeights> disk_cached_prepacked_weights_;
+
+  // Sampled kernel latencies, nullptr unless kOrtSessionOptionsConfigKernelLatencySamplingInterval is set.
+  std::unique_ptr<KernelLatencyMetrics> kernel_latency_metrics_;
+
+  // Statistics of the tensors to calibrate, nullptr unless kOrtSessionOptionsCalibrationTensors is set.
+  std::unique_ptr<CalibrationCollector> calibration_collector_;
+
+  // Memoized kernel results, nullptr unless kOrtSessionOptionsMemoizedOutputs is set.
+  std::unique_ptr<KernelResultCache> kernel_result_cache_;
+
+  // Calibrated cost of the parallel loops, nullptr unless kOrtSessionOptionsIntraOpCostCalibration is set.
+  std::shared_ptr<concurrency::ThreadPoolCostCalibration> thread_pool_cost_calibration_;
+
+  bool denormal_as_zero_ = false;
+  bool profile_denormals_ = false;
+
+  // The nodes needed to produce each set of fetches, keyed by the sorted fetch indices. The sets are allocated
+  // separately so the pointers returned by GetToBeExecutedRange stay valid while other sets are added.
+  mutable OrtMutex to_be_executed_nodes_mutex_;
 #ifndef DISABLE_ABSEIL
-  InlinedHashMap<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
+  InlinedHashMap<InlinedVector<int>, std::unique_ptr<InlinedHashSet<NodeIndex>>> to_be_executed_nodes_;
 #else
-  std::map<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
-#endif
+  std::map<InlinedVector<int>, std::unique_ptr<InlinedHashSet<NodeIndex>>> to_be_executed_nodes_;
 #endif
 
   SessionState* parent_ = nullptr;
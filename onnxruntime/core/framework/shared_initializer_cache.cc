@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/data_types.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+
+uint64_t HashTensor(const Tensor& tensor) {
+  uint32_t hash[4] = {static_cast<uint32_t>(tensor.GetElementType()), 0, 0, 0};
+  const auto dims = tensor.Shape().GetDims();
+  MurmurHash3::x86_128(dims.data(), gsl::narrow_cast<int32_t>(dims.size_bytes()), hash[0], &hash);
+
+  // MurmurHash3 takes an int length, hash larger tensors in chunks
+  constexpr size_t kChunkSize = size_t{1} << 30;
+  const auto* data = static_cast<const uint8_t*>(tensor.DataRaw());
+  for (size_t offset = 0, size = tensor.SizeInBytes(); offset < size; offset += kChunkSize) {
+    const size_t chunk_size = std::min(kChunkSize, size - offset);
+    MurmurHash3::x86_128(data + offset, static_cast<int32_t>(chunk_size), hash[0], &hash);
+  }
+
+  return (static_cast<uint64_t>(hash[1]) << 32) | hash[0];
+}
+
+bool HaveSameContent(const Tensor& a, const Tensor& b) {
+  return a.DataType() == b.DataType() && a.Shape() == b.Shape() &&
+         std::memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0;
+}
+
+// The OrtValue keeps the tensor alive through its deleter, while the cache only holds a weak reference.
+OrtValue ToOrtValue(std::shared_ptr<Tensor> tensor) {
+  OrtValue value;
+  Tensor* p_tensor = tensor.get();
+  value.Init(p_tensor, DataTypeImpl::GetType<Tensor>(), [tensor = std::move(tensor)](void*) {});
+  return value;
+}
+
+}  // namespace
+
+SharedInitializerCache::SharedInitializerCache() : allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+Status SharedInitializerCache::GetOrCreate(const Env& env, const PathString& model_path,
+                                           const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                           OrtValue& value, bool& reused) {
+  ORT_RETURN_IF(tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING,
+                "String initializers cannot be shared by content: ", tensor_proto.name());
+
+  // The tensor is deserialized before looking it up, the copy is dropped again if the cache has the same content.
+  const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  auto tensor = std::make_shared<Tensor>(element_type, utils::GetTensorShapeFromTensorProto(tensor_proto),
+                                         allocator_);
+  ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, model_path.c_str(), tensor_proto, *tensor));
+  const uint64_t hash = HashTensor(*tensor);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto range = tensors_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    auto cached_tensor = it->second.lock();
+    if (cached_tensor == nullptr) {
+      it = tensors_.erase(it);
+      continue;
+    }
+    if (HaveSameContent(*cached_tensor, *tensor)) {
+      value = ToOrtValue(std::move(cached_tensor));
+      reused = true;
+      return Status::OK();
+    }
+    ++it;
+  }
+
+  tensors_.emplace(hash, tensor);
+  value = ToOrtValue(std::move(tensor));
+  reused = false;
+  return Status::OK();
+}
+
+size_t SharedInitializerCache::NumLiveTensors() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return static_cast<size_t>(std::count_if(tensors_.begin(), tensors_.end(), [](const auto& entry) {
+    return !entry.second.expired();
+  }));
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace ONNX_NAMESPACE {
+class TensorProto;
+}
+
+namespace onnxruntime {
+
+class Env;
+class Tensor;
+
+/**
+ * Deduplicates the initializers of the sessions created in one environment by their content, so that the sessions
+ * of models sharing weights, e.g. fine-tuned variants of one base model, keep a single copy of each of them in the
+ * CPU memory.
+ *
+ * The cache only holds weak references. A tensor is freed once the last session using it releases it, and a later
+ * session with the same weights creates it again.
+ */
+class SharedInitializerCache {
+ public:
+  SharedInitializerCache();
+
+  /**
+   * Returns in `value` a CPU tensor with the content of `tensor_proto`. If a tensor with the same type, shape and
+   * data is alive in the cache it is returned, otherwise the tensor is deserialized and added to the cache.
+   * String tensors are not supported.
+   * @param reused Set to true if an existing tensor was returned.
+   */
+  Status GetOrCreate(const Env& env, const PathString& model_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                     OrtValue& value, bool& reused);
+
+  // Returns the number of tensors in the cache that are still in use by a session.
+  size_t NumLiveTensors() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerCache);
+
+  mutable OrtMutex mutex_;
+  AllocatorPtr allocator_;
+  // tensors keyed by the hash of their data, see GetOrCreate()
+  std::unordered_multimap<uint64_t, std::weak_ptr<Tensor>> tensors_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_mem_pattern_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+
+void StaticMemPatternPlanner::AddTensor(int ort_value_idx, size_t size, size_t first_step, size_t last_step) {
+  ORT_ENFORCE(first_step <= last_step, "Invalid lifetime for OrtValue ", ort_value_idx, ": ", first_step, " - ",
+              last_step);
+  tensors_.push_back({ort_value_idx, size, first_step, last_step});
+}
+
+MemoryPattern StaticMemPatternPlanner::GenerateMemPattern() const {
+  // largest first, ties in execution order to keep the plan deterministic
+  std::vector<size_t> order(tensors_.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+    if (tensors_[lhs].size != tensors_[rhs].size) {
+      return tensors_[lhs].size > tensors_[rhs].size;
+    }
+    return tensors_[lhs].first_step < tensors_[rhs].first_step;
+  });
+
+  std::vector<MemoryBlock> blocks(tensors_.size());
+  std::vector<size_t> placed;
+  placed.reserve(tensors_.size());
+  std::vector<MemoryBlock> live_blocks;
+  SafeInt<size_t> peak_size{0};
+
+  for (size_t index : order) {
+    const auto& tensor = tensors_[index];
+    if (tensor.size == 0) {
+      blocks[index] = MemoryBlock(0, 0);
+      continue;
+    }
+
+    live_blocks.clear();
+    for (size_t other : placed) {
+      if (tensors_[other].first_step <= tensor.last_step && tensor.first_step <= tensors_[other].last_step) {
+        live_blocks.push_back(blocks[other]);
+      }
+    }
+    std::sort(live_blocks.begin(), live_blocks.end());
+
+    size_t current = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    size_t best_offset = 0;
+    bool best_offset_found = false;
+    for (const auto& block : live_blocks) {
+      if (block.offset_ >= current) {
+        auto gap = block.offset_ - current;
+        if (gap >= tensor.size && (gap - tensor.size) < waste_bytes) {
+          waste_bytes = gap - tensor.size;
+          best_offset = current;
+          best_offset_found = true;
+        }
+      }
+      current = std::max(current, block.offset_ + block.size_);
+    }
+
+    if (!best_offset_found) {
+      best_offset = current;
+    }
+
+    blocks[index] = MemoryBlock(best_offset, tensor.size);
+    peak_size = std::max(peak_size, SafeInt<size_t>(best_offset) + tensor.size);
+    placed.push_back(index);
+  }
+
+  MemoryPattern pattern;
+  pattern.peak_size_ = peak_size;
+  pattern.patterns_.reserve(tensors_.size());
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    pattern.patterns_.insert_or_assign(tensors_[i].ort_value_idx, blocks[i]);
+  }
+
+  return pattern;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/framework/mem_pattern.h"
+
+namespace onnxruntime {
+
+// StaticMemPatternPlanner assigns offsets in a single buffer to tensors whose sizes and lifetimes are known before
+// the execution, e.g. for graphs with fixed shapes.
+//
+// Tensors are placed from the largest to the smallest (greedy by size). Each one goes into the smallest gap that
+// fits between the tensors placed before it that are live at the same time, or above all of them. Unlike tracing
+// the allocations of an execution, which can only place a tensor where memory is free when it is allocated, this
+// sees all lifetimes at once and usually gives a lower peak.
+// Not thread-safe.
+class StaticMemPatternPlanner {
+ public:
+  // Adds a tensor of `size` bytes that is live from execution step `first_step` to `last_step`, both inclusive.
+  void AddTensor(int ort_value_idx, size_t size, size_t first_step, size_t last_step);
+
+  MemoryPattern GenerateMemPattern() const;
+
+ private:
+  struct TensorLifetime {
+    int ort_value_idx;
+    size_t size;
+    size_t first_step;
+    size_t last_step;
+  };
+
+  std::vector<TensorLifetime> tensors_;
+};
+
+}  // namespace onnxruntime
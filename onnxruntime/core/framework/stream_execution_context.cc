@@ -205,6 +205,9 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
     end = std::min(end, range->stream_pc_range[stream_idx].second);
 #endif
 
+  // long kernels stop their parallel loops when the run is terminated
+  concurrency::ThreadPool::CancellationScope cancellation_scope(&terminate_flag);
+
   while (since < end) {
     if (!ctx.TaskStatus().IsOK()) {
       ctx.CompleteTask();
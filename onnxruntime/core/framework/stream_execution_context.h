@@ -137,6 +137,9 @@ class StreamExecutionContext {
     program_range_ = range;
   }
 
+#endif
+
+  // The nodes to execute, nullptr to execute all of them. Set for RunOptions::only_execute_path_to_fetches.
   const InlinedHashSet<NodeIndex>* GetNodeToExecute() {
     return node_to_execute_;
   }
@@ -145,8 +148,6 @@ class StreamExecutionContext {
     node_to_execute_ = node_to_execute;
   }
 
-#endif
-
  private:
   const SessionState* session_state_;
 
@@ -164,11 +165,9 @@ class StreamExecutionContext {
   const ProgramRegion* program_range_{nullptr};
 
   OrtValueCachePtr cache_{nullptr};
+#endif
 
-  // TODO: this is mainly for ort trainer
-  // Should we deprecate it?
   const InlinedHashSet<NodeIndex>* node_to_execute_{nullptr};
-#endif
   const bool single_thread_mode_;
 
 #ifdef ORT_ENABLE_STREAM
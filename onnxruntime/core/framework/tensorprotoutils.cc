@@ -181,6 +181,12 @@ Status ReadExternalDataForTensor(const ONNX_NAMESPACE::TensorProto& tensor_proto
       tensor_byte_size));
 
   unpacked_tensor.resize(tensor_byte_size);
+  if (external_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag) {
+    // the value in offset is the memory address of the data
+    std::memcpy(unpacked_tensor.data(), reinterpret_cast<const void*>(file_offset), tensor_byte_size);
+    return Status::OK();
+  }
+
   ORT_RETURN_IF_ERROR(onnxruntime::Env::Default().ReadFileIntoBuffer(
       external_file_path.c_str(),
       file_offset,
@@ -235,6 +241,20 @@ Status TensorProtoToOrtValueImpl(const Env& env, const ORTCHAR_T* model_path,
 
 namespace utils {
 
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& ten_proto) {
+  if (!HasExternalData(ten_proto)) {
+    return false;
+  }
+
+  for (const auto& entry : ten_proto.external_data()) {
+    if (entry.key() == "location") {
+      return ToPathString(entry.value()) == kTensorProtoMemoryAddressTag;
+    }
+  }
+
+  return false;
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 static Status UnpackTensorWithExternalDataImpl(const ONNX_NAMESPACE::TensorProto& tensor,
                                                const ORTCHAR_T* tensor_proto_dir,
@@ -824,6 +844,16 @@ Status GetExtDataFromTensorProto(const Env& env, const ORTCHAR_T* model_path,
     ext_data_buf = reinterpret_cast<void*>(file_offset);
     ext_data_len = raw_data_safe_len;
     ext_data_deleter = OrtCallback{nullptr, nullptr};
+
+    // The buffer may be a view into a serialized model, in which case the data is not necessarily aligned for the
+    // element type. Copy it to an allocation that is suitably aligned before it backs a tensor.
+    const size_t element_size = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType()->Size();
+    if (element_size > 1 && reinterpret_cast<uintptr_t>(ext_data_buf) % element_size != 0) {
+      auto buffer = std::make_unique<char[]>(raw_data_safe_len);
+      std::memcpy(buffer.get(), ext_data_buf, raw_data_safe_len);
+      ext_data_deleter = OrtCallback{DeleteCharArray, buffer.get()};
+      ext_data_buf = buffer.release();
+    }
   } else {
 #if defined(__wasm__)
     ORT_RETURN_IF(file_offset < 0 || file_offset + raw_data_safe_len >= 4294967296,
@@ -320,6 +320,10 @@ inline bool HasExternalData(const ONNX_NAMESPACE::TensorProto& ten_proto) {
          ten_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL;
 }
 
+// Returns true if the external data of the tensor is an existing memory buffer (see kTensorProtoMemoryAddressTag)
+// rather than a file.
+bool HasExternalDataInMemory(const ONNX_NAMESPACE::TensorProto& ten_proto);
+
 inline bool HasDataType(const ONNX_NAMESPACE::TensorProto& ten_proto) {
   return ten_proto.data_type() != ONNX_NAMESPACE::TensorProto::UNDEFINED;
 }
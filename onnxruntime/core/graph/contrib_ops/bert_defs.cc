@@ -285,6 +285,16 @@ void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext&
       ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, static_cast<size_t>(past_key_index) + 1, 2);
       // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
     }
+
+    // An int8 cache is int8 with float scales, whether or not there is a past.
+    if (getAttribute(ctx, "kv_cache_bit_width", 0) == 8) {
+      updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT8);
+      updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::INT8);
+      if (ctx.getNumOutputs() > 4) {
+        updateOutputElemType(ctx, 3, ONNX_NAMESPACE::TensorProto::FLOAT);
+        updateOutputElemType(ctx, 4, ONNX_NAMESPACE::TensorProto::FLOAT);
+      }
+    }
   }
 }
 
@@ -1008,6 +1018,11 @@ constexpr const char* GroupQueryAttention_ver1_doc = R"DOC(
 Group Query Self/Cross Attention.
 
 Supports different number of heads for q and kv. Only supports causal or local attention.
+
+When kv_cache_bit_width is 8, the KV cache is kept in int8 with a float scale per token of each kv head: a cached
+row of head_size values is scale * int8 values, with the scale symmetric over the row. The new tokens are quantized
+as they are appended to the cache, and past_key_scale/past_value_scale and present_key_scale/present_value_scale carry
+the scales like past_key/past_value and present_key/present_value carry the cache, sharing buffers with them as well.
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(
@@ -1032,6 +1047,11 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
               "Rotate using interleaved pattern. Default value is 0 (False).",
               AttributeProto::INT,
               OPTIONAL_VALUE)
+        .Attr("kv_cache_bit_width",
+              "Bits of the values of the KV cache: 0 for a cache of type T, or 8 for an int8 cache with scales. "
+              "Default value is 0.",
+              AttributeProto::INT,
+              static_cast<int64_t>(0))
         .Input(0,
                "query",
                "Query with shape (batch_size, sequence_length, hidden_size), or packed QKV with shape"
@@ -1051,13 +1071,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1077,6 +1097,18 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "past_key_scale",
+               "Scales of an int8 past_key with shape (batch_size, kv_num_heads, past_key sequence length). "
+               "Required when kv_cache_bit_width is 8 and past_key is given.",
+               "T_SCALE",
+               OpSchema::Optional)
+        .Input(10,
+               "past_value_scale",
+               "Scales of an int8 past_value with shape (batch_size, kv_num_heads, past_value sequence length). "
+               "Required when kv_cache_bit_width is 8 and past_value is given.",
+               "T_SCALE",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1086,14 +1118,29 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
-        .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)"}, "Constrain input and output to float tensors.")
+                "T_CACHE")
+        .Output(3,
+                "present_key_scale",
+                "Scales of an int8 present_key with shape (batch_size, kv_num_heads, present_key sequence length). "
+                "Required when kv_cache_bit_width is 8.",
+                "T_SCALE",
+                OpSchema::Optional)
+        .Output(4,
+                "present_value_scale",
+                "Scales of an int8 present_value with shape (batch_size, kv_num_heads, present_value sequence length). "
+                "Required when kv_cache_bit_width is 8.",
+                "T_SCALE",
+                OpSchema::Optional)
+        .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)"},
+                        "Constrain the KV cache to the type of T, or int8 when kv_cache_bit_width is 8.")
+        .TypeConstraint("T_SCALE", {"tensor(float)"}, "Constrain the scales of the KV cache to float tensors.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
@@ -1227,17 +1274,17 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .SetDoc(EmbedLayerNormalization_ver1_doc)
         .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, kDefaultEmbedLayerNormEpsilon)
         .Attr("mask_index_type", "The mask index tensor type for shape inference (0: None, 1: 1D mask_index)", AttributeProto::INT, OPTIONAL_VALUE)
-        .Input(0, "input_ids", "2D words IDs with shape (batch_size, sequence_length)", "T1")
-        .Input(1, "segment_ids", "2D segment IDs with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
+        .Input(0, "input_ids", "2D words IDs with shape (batch_size, sequence_length), or 1D packed words IDs with shape (token_count)", "T1")
+        .Input(1, "segment_ids", "2D segment IDs with shape (batch_size, sequence_length), or 1D with shape (token_count) for packed input", "T1", OpSchema::Optional)
         .Input(2, "word_embedding", "2D with shape (,hidden_size)", "T")
         .Input(3, "position_embedding", "2D with shape (, hidden_size)", "T")
         .Input(4, "segment_embedding", "2D with shape (, hidden_size)", "T", OpSchema::Optional)
         .Input(5, "gamma", "1D gamma tensor for layer normalization with shape (hidden_size)", "T")
         .Input(6, "beta", "1D beta tensor for layer normalization  with shape (hidden_size)", "T")
         .Input(7, "mask", "2D attention mask with shape (batch_size, sequence_length)", "T1", OpSchema::Optional)
-        .Input(8, "position_ids", "2D position ids with shape (batch_size, sequence_length) or (1, sequence_length)", "T1", OpSchema::Optional)
-        .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
-        .Output(1, "mask_index", "1D mask_index tensor with shape (batch_size)", "T1", OpSchema::Optional)
+        .Input(8, "position_ids", "2D position ids with shape (batch_size, sequence_length) or (1, sequence_length). Required with shape (token_count) for packed input", "T1", OpSchema::Optional)
+        .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size), or 2D with shape (token_count, hidden_size) for packed input", "T")
+        .Output(1, "mask_index", "1D mask_index tensor with shape (batch_size). Not supported for packed input", "T1", OpSchema::Optional)
         .Output(2, "embedding_sum", "sum of word_embedding and position_embedding without layer normalization", "T", OpSchema::Optional)
         .TypeConstraint("T1", {"tensor(int32)"}, "Constrain input and output integer tensors types")
         .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output float tensors types.")
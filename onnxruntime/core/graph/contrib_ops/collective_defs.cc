@@ -63,6 +63,34 @@ void RegisterCollectiveOps() {
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulAllReduce)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("Row parallel MatMul of tensor parallel models: the MatMul of the local shards of A and B summed over "
+              "all the ranks. The all-reduce of a chunk of rows overlaps with the MatMul of the next chunk.")
+      .Attr("num_chunks",
+            "Number of chunks the rows of A are split into to overlap the all-reduce with the MatMul.",
+            AttributeProto::INT,
+            static_cast<int64_t>(4))
+      .Input(0, "A", "Local shard of the input with shape (..., K / world_size)", "T")
+      .Input(1, "B", "Local shard of the weight with shape (K / world_size, N)", "T")
+      .Output(0, "Y", "Reduced output with shape (..., N)", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain to float and float16 tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (hasInputShape(ctx, 0) && hasInputShape(ctx, 1)) {
+          auto shape = ctx.getInputType(0)->tensor_type().shape();
+          const auto& b_shape = ctx.getInputType(1)->tensor_type().shape();
+          if (shape.dim_size() >= 2 && b_shape.dim_size() == 2) {
+            *shape.mutable_dim(shape.dim_size() - 1) = b_shape.dim(1);
+            updateOutputShape(ctx, 0, shape);
+          }
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(AllToAll)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -628,6 +628,53 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Applies a chain of elementwise operators to X in a single pass over memory.
+Operator i of the chain is ops[i] and takes the result of operator i - 1 (X for the first operator) as its input.
+Binary operators take a second input from operands, selected by operand_indices[i], where index 0 is the first tensor
+of operands. It must either have a single element or the shape of X. operand_positions[i] is 1 if the operand is
+the left input of the operator and 0 if it is the right one. For unary operators both values are ignored.
+Supported operators are Add, Sub, Mul, Div, Relu, Sigmoid, Tanh, Erf, Exp, Neg, Abs, Sqrt and Reciprocal.
+Y has the shape of X.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The elementwise operators, applied in order.", AttributeProto::STRINGS)
+        .Attr("operand_indices", "Index into operands of the second input of each binary operator.",
+              AttributeProto::INTS)
+        .Attr("operand_positions", "1 if the operand of a binary operator is its left input, 0 otherwise.",
+              AttributeProto::INTS)
+        .Input(0, "X", "The input of the first operator.", "T")
+        .Input(1, "operands", "The second inputs of the binary operators.", "T", OpSchema::Variadic,
+               /*is_homogeneous*/ true, /*min_arity*/ 0)
+        .Output(0, "Y", "The output of the last operator.", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
+
+constexpr const char* MatMulLoRA_ver1_doc = R"DOC(
+Computes Y = X * W + (X * lora_A) * lora_B, the MatMul of X with the weight W and a low-rank update of it.
+W has the shape [K, N], lora_A the shape [K, r] and lora_B the shape [r, N], with the scale of the update
+folded into lora_B. X has the shape [..., K]. With a rank r of 0 the update is skipped and Y = X * W.
+Keeping the update out of W lets the adapter be swapped by feeding other lora_A and lora_B without changing W.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    MatMulLoRA, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(MatMulLoRA_ver1_doc)
+        .Input(0, "X", "The input of shape [..., K].", "T")
+        .Input(1, "W", "The 2D weight of shape [K, N].", "T")
+        .Input(2, "lora_A", "The 2D down projection of the update, of shape [K, r].", "T")
+        .Input(3, "lora_B", "The 2D up projection of the update, of shape [r, N].", "T")
+        .Output(0, "Y", "The output of shape [..., N].", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) { FusedMatMulShapeInference(ctx); }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
@@ -758,6 +805,102 @@ ONNX_MS_OPERATOR_SET_SCHEMA(TorchEmbedding, 1,
                                   updateOutputShape(ctx, 0, outputs_shape);
                                 }));
 
+constexpr const char* EmbeddingBag_ver1_doc = R"DOC(
+      Based on Torch operator EmbeddingBag, looks up the embedding vectors of each bag of indices and
+      reduces them without materializing the gathered vectors. It computes the same result as a Gather
+      of 'weight' by 'indices' followed by a ReduceSum (or ReduceMean) over the bag axis.
+      Each row of a 2D 'indices' is a bag. With 'offsets', 'indices' is 1D and bag i is
+      indices[offsets[i]:offsets[i + 1]], the last bag ending at the end of 'indices', like the
+      SparseLengthsSum operators of Caffe2. Empty bags produce zeros.
+      When 'per_sample_weights' is given, each embedding vector is scaled by its weight before the reduction.
+      8-bit embedding matrices are dequantized per row as (weight - zero_points[row]) * scales[row].
+      )DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(EmbeddingBag, 1,
+                            OpSchema()
+                                .SetDoc(EmbeddingBag_ver1_doc)
+                                .Attr("mode",
+                                      "Reduction applied to each bag: 'sum' (default) or 'mean'.",
+                                      AttributeProto::STRING,
+                                      std::string("sum"))
+                                .Input(0,
+                                       "weight",
+                                       "The embedding matrix of shape (num_embeddings, embedding_dim).",
+                                       "T")
+                                .Input(1,
+                                       "indices",
+                                       "The indices of shape (num_bags, bag_size), or (num_indices) with 'offsets'. "
+                                       "Negative indices count from the end.",
+                                       "Tind")
+                                .Input(2,
+                                       "per_sample_weights",
+                                       "Optional weights of the shape of 'indices'. Only supported with 'sum' mode.",
+                                       "T1",
+                                       OpSchema::Optional)
+                                .Input(3,
+                                       "offsets",
+                                       "Optional start of each bag in the 1D 'indices', of shape (num_bags).",
+                                       "Tind",
+                                       OpSchema::Optional)
+                                .Input(4,
+                                       "scales",
+                                       "Scale of each row of an 8-bit 'weight', of shape (num_embeddings).",
+                                       "tensor(float)",
+                                       OpSchema::Optional)
+                                .Input(5,
+                                       "zero_points",
+                                       "Optional zero point of each row of an 8-bit 'weight', of shape (num_embeddings). "
+                                       "Zero by default.",
+                                       "T",
+                                       OpSchema::Optional)
+                                .Output(0,
+                                        "Y",
+                                        "The reduced embeddings of shape (num_bags, embedding_dim).",
+                                        "T1")
+                                .TypeConstraint("T", {"tensor(float)", "tensor(float16)", "tensor(uint8)", "tensor(int8)"},
+                                                "Constrain the embedding matrix to float, float16 and 8-bit tensors.")
+                                .TypeConstraint("T1", {"tensor(float)", "tensor(float16)"},
+                                                "Constrain the output to the type of a float 'weight', "
+                                                "or float for an 8-bit 'weight'.")
+                                .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"},
+                                                "Constrain indices to integer types.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  const auto weight_type = ctx.getInputType(0)->tensor_type().elem_type();
+                                  if (weight_type == ONNX_NAMESPACE::TensorProto::UINT8 ||
+                                      weight_type == ONNX_NAMESPACE::TensorProto::INT8) {
+                                    updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::FLOAT);
+                                  } else {
+                                    propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  }
+
+                                  if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+                                    return;
+                                  }
+
+                                  auto& weight_shape = getInputShape(ctx, 0);
+                                  auto& indices_shape = getInputShape(ctx, 1);
+                                  if (weight_shape.dim_size() != 2) {
+                                    fail_shape_inference("weight must be 2D");
+                                  }
+
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  if (hasInputShape(ctx, 3)) {
+                                    if (indices_shape.dim_size() != 1) {
+                                      fail_shape_inference("indices must be 1D with offsets");
+                                    }
+                                    *output_shape.add_dim() = getInputShape(ctx, 3).dim(0);
+                                  } else if (ctx.getNumInputs() > 3 && ctx.getInputType(3) != nullptr) {
+                                    return;  // offsets of unknown shape
+                                  } else {
+                                    if (indices_shape.dim_size() != 2) {
+                                      fail_shape_inference("indices must be 2D");
+                                    }
+                                    *output_shape.add_dim() = indices_shape.dim(0);
+                                  }
+                                  *output_shape.add_dim() = weight_shape.dim(1);
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
 constexpr const char* Trilu_ver1_doc = R"DOC(
       Returns the upper or lower triangular part of a 2-D matrix, or batches of 2-D matrices. If the attribute "upper" is set to true,
       the upper triangular matrix is retained. Lower triangular matrix is retained otherwise. Default value for upper is true.
@@ -1211,6 +1354,10 @@ ONNX_MS_OPERATOR_SET_SCHEMA(WhisperBeamSearch, 1,
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
                                       AttributeProto::INT, static_cast<int64_t>(-1))
                                 .Attr("decoder_output_cross_qk", "If nozero, decoder subgraph contains output Q*K from cross attentions. Default 0.", AttributeProto::INT, OPTIONAL_VALUE)
+                                .Attr("share_cross_attention_cache",
+                                      "If nonzero, the cross attention past key/value from the encoder are fed to the decoder once per batch entry "
+                                      "instead of once per beam. The decoder attention must broadcast them over the beams. Default 0.",
+                                      AttributeProto::INT, OPTIONAL_VALUE)
                                 .Input(0, "input_ids", "The sequence used as a prompt for the generation in the encoder subgraph. Shape is (batch_size, sequence_length)", "F")
                                 .Input(1, "max_length", "The maximum length of the sequence to be generated. Shape is (1)", "I")
                                 .Input(2, "min_length", "The minimum length below which the score of eos_token_id is set to -Inf. Shape is (1)", "I", OpSchema::Optional)
@@ -1322,6 +1469,16 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
                                       AttributeProto::INT, static_cast<int64_t>(-1))
+                                .Attr("draft_decoder",
+                                      "Optional smaller decoder subgraph with the inputs, outputs and vocabulary of `decoder`. "
+                                      "When present, speculative decoding is used: `draft_decoder` proposes `num_speculative_tokens` tokens "
+                                      "and `decoder` verifies them in one run, without changing the output distribution of `decoder`. "
+                                      "This is relevant only for the GPT2 model on CPU, with batch_size of 1, float logits, "
+                                      "no `init_decoder` and no padding in `attention_mask`.",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens",
+                                      "Number of tokens proposed by `draft_decoder` per run of `decoder`.",
+                                      AttributeProto::INT, static_cast<int64_t>(4))
                                 .Input(0, "input_ids", "The sequence used as a prompt for the generation. Shape is (batch_size, sequence_length)", "I")
                                 .Input(1, "max_length", "The maximum length of the sequence to be generated. Shape is (1)", "I")
                                 .Input(2, "min_length", "The minimum length below which the score of eos_token_id is set to -Inf. Shape is (1)", "I", OpSchema::Optional)
@@ -1363,6 +1520,16 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Sampling, 1,
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
                                       AttributeProto::INT, static_cast<int64_t>(-1))
+                                .Attr("draft_decoder",
+                                      "Optional smaller decoder subgraph with the inputs, outputs and vocabulary of `decoder`. "
+                                      "When present, speculative decoding is used: `draft_decoder` proposes `num_speculative_tokens` tokens "
+                                      "and `decoder` verifies them in one run, without changing the output distribution of `decoder`. "
+                                      "This is relevant only for the GPT2 model on CPU, with batch_size of 1, float logits, "
+                                      "no `init_decoder`, no padding in `attention_mask` and no `filtered_logits` output.",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens",
+                                      "Number of tokens proposed by `draft_decoder` per run of `decoder`.",
+                                      AttributeProto::INT, static_cast<int64_t>(4))
                                 .Input(0, "input_ids", "The sequence used as a prompt for the generation. Shape is (batch_size, sequence_length)", "I")
                                 .Input(1, "max_length", "The maximum length of the sequence to be generated. Shape is (1)", "I")
                                 .Input(2, "min_length", "The minimum length below which the score of eos_token_id is set to -Inf. Shape is (1)", "I", OpSchema::Optional)
@@ -1391,12 +1558,15 @@ ONNX_MS_OPERATOR_SET_SCHEMA(MoE, 1,
                                 .SetDoc(MoE_ver1_doc)
                                 .Attr("activation_type", "Activation function to use. Choose from relu, gelu, silu and identity. Default is relu", AttributeProto::STRING, std::string("relu"))
                                 .Attr("k", "Number of top experts to select from expert pool", AttributeProto::INT, static_cast<int64_t>(1))
+                                .Attr("normalize_routing_weights", "Whether to normalize the routing weights of the top k experts to sum up to 1. Default is 0", AttributeProto::INT, static_cast<int64_t>(0))
                                 .Input(0, "input", "2D input tensor with shape (num_rows, hidden_size) or 3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
                                 .Input(1, "router_probs", "2D input tensor with shape (num_rows, num_experts)", "T")
                                 .Input(2, "fc1_experts_weights", "3D input tensor with shape (num_experts, hidden_size, inter_size)", "T")
                                 .Input(3, "fc2_experts_weights", "3D input tensor with shape (num_experts, inter_size, hidden_size)", "T")
                                 .Input(4, "fc1_experts_bias", "2D optional input tensor with shape (num_experts, inter_size)", "T", OpSchema::Optional)
                                 .Input(5, "fc2_experts_bias", "2D optional input tensor with shape (num_experts, hidden_size)", "T", OpSchema::Optional)
+                                .Input(6, "fc3_experts_weights", "3D optional input tensor with shape (num_experts, hidden_size, inter_size). The activation of fc1 is multiplied by the fc3 output when set (gated experts, e.g. Mixtral)", "T", OpSchema::Optional)
+                                .Input(7, "fc3_experts_bias", "2D optional input tensor with shape (num_experts, inter_size)", "T", OpSchema::Optional)
                                 .Output(0, "output", "2D input tensor with shape (num_rows, hidden_size) or 3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
                                 .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float or float16 tensors.")
                                 .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
@@ -3360,6 +3530,9 @@ Input scales is stored in same type as original type of B(float32, float16) with
 Input zero_points is stored as uint8_t or same as type(A). It has the same packing method as input B.
   - [CeilDiv((N * n_blocks_per_col + 1) *bits, 8)]
   If zero_points has same type as A, it's not packed and has the same shape as Scales.
+
+Input quantized_A is the optional output of QuantizeMatMulNBitsInput for input A, with the same K and block_size.
+When accuracy_level 4 (int8) is used, it replaces the quantization of A, so MatMulNBits nodes sharing A quantize it once.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulNBits)
@@ -3382,11 +3555,13 @@ Input zero_points is stored as uint8_t or same as type(A). It has the same packi
       .Input(2, "scales", "quantization scale", "T1")
       .Input(3, "zero_points", "quantization zero points", "T3", OpSchema::Optional)
       .Input(4, "g_idx", "group_idx", "T4", OpSchema::Optional)
+      .Input(5, "quantized_A", "input A quantized by QuantizeMatMulNBitsInput", "T5", OpSchema::Optional)
       .Output(0, "Y", "tensor. The output tensor has the same rank as the input. ", "T1")
       .TypeConstraint("T1", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float/half_float tensors.")
       .TypeConstraint("T2", {"tensor(uint8)", "tensor(int32)"}, "Constrain quantized weight types to uint8/int32.")
       .TypeConstraint("T3", {"tensor(uint8)", "tensor(int32)", "tensor(float16)", "tensor(float)"}, "Constrain quantized zero point types to uint8/int32/float16/float.")
       .TypeConstraint("T4", {"tensor(int32)"}, "the index tensor.")
+      .TypeConstraint("T5", {"tensor(uint8)"}, "Constrain the quantized input A to uint8.")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
         // Type inference
         propagateElemTypeFromInputToOutput(ctx, 0, 0);
@@ -3396,6 +3571,56 @@ Input zero_points is stored as uint8_t or same as type(A). It has the same packi
         MatmulWithQuantWeightShapeInference(ctx, in_features, out_features, true);
       });
 
+  static const char* QuantizeMatMulNBitsInput_ver1_doc = R"DOC(
+Quantizes input A of MatMulNBits nodes with accuracy_level 4 (int8) once, so that the nodes sharing A take it as input
+quantized_A instead of each quantizing A again. A is quantized per token, in blocks of block_size along K with a
+symmetric float scale per block.
+
+Output Y is an opaque buffer in the layout of the int8 kernel of MatMulNBits, of shape
+[product of the dimensions of A but the last, n_blocks_per_col * (4 + block_size)] where
+n_blocks_per_col = (K + block_size - 1) / block_size: each block is its float scale followed by its block_size
+int8 values.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(QuantizeMatMulNBitsInput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(QuantizeMatMulNBitsInput_ver1_doc)
+      .Attr("K", "size of each input feature", AttributeProto::INT)
+      .Attr("block_size", "block_size of the MatMulNBits nodes consuming the output.", AttributeProto::INT)
+      .Input(0, "A", "The input tensor, not quantized", "T1")
+      .Output(0, "Y", "The quantized input tensor.", "T2")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain the input to float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain the output to uint8 tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::UINT8);
+
+        const int64_t k = getAttribute(ctx, "K", -1);
+        const int64_t block_size = getAttribute(ctx, "block_size", -1);
+        if (k <= 0 || block_size <= 0) {
+          fail_shape_inference("K and block_size shall be positive.");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        auto* rows = output_shape.add_dim();
+        if (hasInputShape(ctx, 0)) {
+          const auto& a_shape = getInputShape(ctx, 0);
+          int64_t row_count = 1;
+          for (int i = 0; i + 1 < a_shape.dim_size(); ++i) {
+            if (!a_shape.dim(i).has_dim_value()) {
+              row_count = -1;
+              break;
+            }
+            row_count *= a_shape.dim(i).dim_value();
+          }
+          if (row_count >= 0) {
+            rows->set_dim_value(row_count);
+          }
+        }
+        output_shape.add_dim()->set_dim_value((k + block_size - 1) / block_size * (4 + block_size));
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
   static const char* MatMulBnb4_ver1_doc = R"DOC(
 MatMulBnb4 is a MatMul with weight quantized with 4 bits using either FP4 or NF4 data type (https://arxiv.org/pdf/2305.14314.pdf). It does Matrix Multiplication like MatMul (https://github.com/onnx/onnx/blob/main/docs/Operators.md#matmul) with differences:
   1. Input B is a 2D constant Matrix. Its input feature count and output feature count are specified by attribute 'K' and 'N'.
@@ -3460,6 +3685,54 @@ MatMulBnb4 is a MatMul with weight quantized with 4 bits using either FP4 or NF4
         MatmulWithQuantWeightShapeInference(ctx, in_features, out_features, transB);
       });
 
+  static const char* GatherBlockQuantized_ver1_doc = R"DOC(
+GatherBlockQuantized is a Gather of the rows of a table quantized blockwise with N bits, e.g. the embedding table of a
+language model. Only the gathered rows are dequantized.
+
+Inputs data, scales and zero_points have the layout of inputs B, scales and zero_points of MatMulNBits, with the rows
+of the table as the N columns of MatMulNBits:
+  - data is stored as uint8_t with shape [N][n_blocks_per_row][blob_size], or [N][n_blocks_per_row * blob_size], in
+    which n_blocks_per_row = (K + block_size - 1) / block_size and blob_size = CeilDiv(block_size * bits, 8).
+  - scales has shape [N * n_blocks_per_row].
+  - zero_points is packed like data, with shape [N * CeilDiv(n_blocks_per_row * bits, 8)]. The default zero point is
+    2^(bits - 1).
+So a model with tied weights can feed the same initializers to the GatherBlockQuantized of the embedding and to the
+MatMulNBits of the language model head, which computes the logits with the transposed embedding table.
+
+Output Y has shape indices.shape + [K]. Negative indices count from the end of the table.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GatherBlockQuantized)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(GatherBlockQuantized_ver1_doc)
+      .Attr("K", "size of each row of the table", AttributeProto::INT)
+      .Attr("bits", "number of bits used for quantization (default 4)", AttributeProto::INT, static_cast<int64_t>(4))
+      .Attr("block_size", "number of elements of a row sharing a scale and zero point. It needs to be a power of 2 and not smaller than 16.", AttributeProto::INT)
+      .Input(0, "data", "quantized table", "T2")
+      .Input(1, "indices", "rows of the table to gather", "Tind")
+      .Input(2, "scales", "quantization scale", "T1")
+      .Input(3, "zero_points", "quantization zero points", "T2", OpSchema::Optional)
+      .Output(0, "Y", "dequantized rows", "T1")
+      .TypeConstraint("T1", {"tensor(float)", "tensor(float16)"}, "Constrain scales and output types to float/half_float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain the quantized table and zero point types to uint8.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 2, 0);
+
+        const int64_t k = getAttribute(ctx, "K", -1);
+        if (k <= 0) {
+          fail_shape_inference("K shall be positive.");
+        }
+        if (!hasInputShape(ctx, 1)) {
+          return;
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape = getInputShape(ctx, 1);
+        output_shape.add_dim()->set_dim_value(k);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
 #ifdef ENABLE_ATEN
   ONNX_CONTRIB_OPERATOR_SCHEMA(ATen)
       .SetDomain(kPytorchAtenDomain)
@@ -23,18 +23,19 @@ void EmbedLayerNormalizationShapeInference(::ONNX_NAMESPACE::InferenceContext& c
   auto& input_ids_dims = input_ids_shape.dim();
 
   // Note that both batch size and sequence length could be symbolic.
-  // So we only check dimension size here.
-  if (input_ids_dims.size() != 2) {
-    fail_shape_inference("input_ids shall be 2 dimensions");
+  // So we only check dimension size here. Packed input_ids of shape (token_count) has 1 dimension.
+  if (input_ids_dims.size() != 2 && input_ids_dims.size() != 1) {
+    fail_shape_inference("input_ids shall be 1 or 2 dimensions");
   }
+  const bool is_packed = input_ids_dims.size() == 1;
 
   bool has_segment = hasInputShape(ctx, 1);
   if (has_segment) {
     // Ensure that segment_ids has the same shape.
     auto& segment_ids_shape = getInputShape(ctx, 1);
     auto& segment_ids_dims = segment_ids_shape.dim();
-    if (segment_ids_dims.size() != 2) {
-      fail_shape_inference("segment_ids input shall be 2 dimensions");
+    if (segment_ids_dims.size() != input_ids_dims.size()) {
+      fail_shape_inference("segment_ids input shall have same dimensions as input_ids");
     }
   }
 
@@ -91,18 +92,18 @@ void EmbedLayerNormalizationShapeInference(::ONNX_NAMESPACE::InferenceContext& c
         "and same hidden size as word_embedding.");
   }
 
-  // input shape is (batch_size, sequence_length), output shape is (batch_size, sequence_length, hidden_size)
+  // input shape is (batch_size, sequence_length), output shape is (batch_size, sequence_length, hidden_size).
+  // For packed input of shape (token_count), output shape is (token_count, hidden_size).
   ONNX_NAMESPACE::TensorShapeProto output_shape;
-  *output_shape.add_dim() = input_ids_dims[0];
-  *output_shape.add_dim() = input_ids_dims[1];
-
-  output_shape.add_dim();
-  output_shape.mutable_dim(2)->set_dim_value(hidden_size);
+  for (const auto& dim : input_ids_dims) {
+    *output_shape.add_dim() = dim;
+  }
+  output_shape.add_dim()->set_dim_value(hidden_size);
 
   updateOutputShape(ctx, 0, output_shape);
 
-  // mask_index shape is (batch_size)
-  if (mask_index_type > 0) {
+  // mask_index shape is (batch_size). It is not produced for packed input.
+  if (mask_index_type > 0 && !is_packed) {
     ONNX_NAMESPACE::TensorShapeProto mask_index_shape;
     *mask_index_shape.add_dim() = input_ids_dims[0];
     updateOutputShape(ctx, 1, mask_index_shape);
@@ -3437,6 +3437,8 @@ ONNX_NAMESPACE::GraphProto Graph::ToGraphProtoWithExternalInitializers(const std
   std::ofstream external_stream(external_file_path.ToPathString(), std::ofstream::out | std::ofstream::binary);
   ORT_ENFORCE(external_stream.is_open());
   int64_t external_offset = 0;
+  // 64KB is the allocation granularity of file mappings on Windows and a multiple of the page size elsewhere.
+  constexpr int64_t kExternalDataAlignment = 65536;
 
   // Add the initializers to the result graph.
   const auto& model_path = ModelPath();
@@ -3464,10 +3466,18 @@ ONNX_NAMESPACE::GraphProto Graph::ToGraphProtoWithExternalInitializers(const std
         continue;
       }
 
-      for (size_t index = 0; index != tensor_bytes_size; ++index) {
-        external_stream << raw_data[index];
+      // Large initializers start on an aligned offset, so that they can be mapped without copies and their pages
+      // are not shared with other initializers.
+      if (tensor_bytes_size >= static_cast<size_t>(kExternalDataAlignment) && external_offset % kExternalDataAlignment != 0) {
+        const int64_t padding = kExternalDataAlignment - external_offset % kExternalDataAlignment;
+        const std::vector<char> zeros(static_cast<size_t>(padding), 0);
+        external_stream.write(zeros.data(), padding);
+        external_offset += padding;
       }
 
+      external_stream.write(reinterpret_cast<const char*>(raw_data.data()),
+                            static_cast<std::streamsize>(tensor_bytes_size));
+
       output_proto->set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL);
       ONNX_NAMESPACE::StringStringEntryProto* location = output_proto->add_external_data();
       location->set_key("location");
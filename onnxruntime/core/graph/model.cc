@@ -5,6 +5,7 @@
 #include "core/common/logging/logging.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
+#include "core/framework/tensor_external_data_info.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/model.h"
 #include "core/graph/model_load_utils.h"
@@ -21,6 +22,7 @@
 #include "core/util/protobuf_parsing_utils.h"
 
 #include "core/common/gsl.h"
+#include "core/common/narrow.h"
 
 #include "core/platform/env.h"
 
@@ -375,6 +377,20 @@ ModelProto Model::ToProto() const {
   ModelProto result(model_proto_);
   const auto& graph = *graph_;
   *(result.mutable_graph()) = graph.ToGraphProto();
+
+  // Initializers loaded with lazy data refer to the mapped model file, which the serialized model can't.
+  if (mapped_model_data_) {
+    for (auto& initializer : *result.mutable_graph()->mutable_initializer()) {
+      if (utils::HasExternalDataInMemory(initializer)) {
+        std::vector<uint8_t> raw_data;
+        ORT_THROW_IF_ERROR(utils::UnpackInitializerData(initializer, raw_data));
+        initializer.clear_external_data();
+        initializer.set_data_location(TensorProto_DataLocation_DEFAULT);
+        initializer.set_raw_data(raw_data.data(), raw_data.size());
+      }
+    }
+  }
+
   return result;
 }
 
@@ -635,9 +651,188 @@ GSL_SUPPRESS(r.35)
 Status Model::Load(const PathString& file_path, std::shared_ptr<Model>& p_model,
                    const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                    const logging::Logger& logger, const ModelOptions& options) {
+  if (options.lazy_initializer_data) {
+    return LoadWithMappedInitializers(file_path, p_model, local_registries, logger, options);
+  }
+
   return LoadModel(file_path, p_model, local_registries, logger, options);
 }
 
+namespace {
+
+// Field numbers from onnx.proto
+constexpr uint32_t kModelProtoGraphField = 7;
+constexpr uint32_t kGraphProtoInitializerField = 5;
+constexpr uint32_t kTensorProtoRawDataField = 9;
+
+// Initializers with less raw data than this are copied. This matches the default threshold of the onnx python
+// package for external data, and keeps the small tensors that ONNX shape inference needs to read (e.g. shapes
+// and axes) as regular raw data.
+constexpr size_t kMinMappedInitializerBytes = 1024;
+
+// Split a serialized message into the payloads of the length-delimited field `field_number` and the serialized
+// bytes of all other fields. The latter can be parsed as a message of the same type.
+Status SplitSerializedField(gsl::span<const uint8_t> message, uint32_t field_number,
+                            InlinedVector<gsl::span<const uint8_t>>& field_payloads, std::string& other_fields) {
+  ORT_RETURN_IF(message.size() > static_cast<size_t>(INT_MAX), "Protobuf message is too large: ", message.size());
+
+  google::protobuf::io::CodedInputStream input(message.data(), static_cast<int>(message.size()));
+  for (;;) {
+    const int field_start = input.CurrentPosition();
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      break;
+    }
+
+    const uint32_t wire_type = tag & 0x7;
+    uint32_t length = 0;
+    uint64_t varint = 0;
+    bool ok = false;
+    switch (wire_type) {
+      case 0:  // varint
+        ok = input.ReadVarint64(&varint);
+        break;
+      case 1:  // fixed64
+        ok = input.Skip(8);
+        break;
+      case 2:  // length-delimited
+        ok = input.ReadVarint32(&length) && length <= static_cast<uint32_t>(INT_MAX);
+        if (ok && (tag >> 3) == field_number) {
+          const int payload_start = input.CurrentPosition();
+          ok = input.Skip(static_cast<int>(length));
+          if (ok) {
+            field_payloads.push_back(message.subspan(static_cast<size_t>(payload_start), length));
+          }
+          ORT_RETURN_IF_NOT(ok, "Protobuf parsing failed.");
+          continue;
+        }
+        ok = ok && input.Skip(static_cast<int>(length));
+        break;
+      case 5:  // fixed32
+        ok = input.Skip(4);
+        break;
+      default:  // groups are not used in onnx.proto
+        break;
+    }
+    ORT_RETURN_IF_NOT(ok, "Protobuf parsing failed.");
+
+    other_fields.append(reinterpret_cast<const char*>(message.data()) + field_start,
+                        static_cast<size_t>(input.CurrentPosition() - field_start));
+  }
+
+  ORT_RETURN_IF_NOT(static_cast<size_t>(input.CurrentPosition()) == message.size(), "Protobuf parsing failed.");
+  return Status::OK();
+}
+
+// Parse a serialized TensorProto. Large raw data is not copied. The tensor refers to it as external data in memory.
+Status ParseMappedTensorProto(gsl::span<const uint8_t> serialized, TensorProto& tensor_proto) {
+  InlinedVector<gsl::span<const uint8_t>> raw_data;
+  std::string other_fields;
+  ORT_RETURN_IF_ERROR(SplitSerializedField(serialized, kTensorProtoRawDataField, raw_data, other_fields));
+
+  // the last occurrence of a singular field wins
+  if (!raw_data.empty() && raw_data.back().size() >= kMinMappedInitializerBytes) {
+    ORT_RETURN_IF_NOT(tensor_proto.ParseFromString(other_fields), "Protobuf parsing failed.");
+    if (utils::HasDataType(tensor_proto) && !utils::HasString(tensor_proto) &&
+        !utils::HasExternalData(tensor_proto) && tensor_proto.external_data_size() == 0) {
+      static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
+      const void* data_offset = raw_data.back().data();
+      // we reinterpret_cast this back to void* in tensorprotoutils.cc:GetExtDataFromTensorProto.
+      auto offset = narrow<ExternalDataInfo::OFFSET_TYPE>(reinterpret_cast<intptr_t>(data_offset));
+
+      tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+      StringStringEntryProto* entry = tensor_proto.mutable_external_data()->Add();
+      entry->set_key("location");
+      entry->set_value(ToUTF8String(utils::kTensorProtoMemoryAddressTag));
+      entry = tensor_proto.mutable_external_data()->Add();
+      entry->set_key("offset");
+      entry->set_value(std::to_string(offset));
+      entry = tensor_proto.mutable_external_data()->Add();
+      entry->set_key("length");
+      entry->set_value(std::to_string(raw_data.back().size()));
+      return Status::OK();
+    }
+
+    tensor_proto.Clear();
+  }
+
+  ORT_RETURN_IF_NOT(tensor_proto.ParseFromArray(serialized.data(), static_cast<int>(serialized.size())),
+                    "Protobuf parsing failed.");
+  return Status::OK();
+}
+
+// Parse a serialized ModelProto. The graph structure is parsed eagerly. The raw data of large main graph
+// initializers stays in `model_data`, which must outlive the model.
+Status ParseModelProtoWithMappedInitializers(gsl::span<const uint8_t> model_data, ModelProto& model_proto) {
+  InlinedVector<gsl::span<const uint8_t>> graph_data;
+  std::string model_fields;
+  ORT_RETURN_IF_ERROR(SplitSerializedField(model_data, kModelProtoGraphField, graph_data, model_fields));
+
+  // Multiple occurrences of the graph field would need to be merged. Leave that to protobuf.
+  if (graph_data.size() != 1) {
+    ORT_RETURN_IF_NOT(model_proto.ParseFromArray(model_data.data(), static_cast<int>(model_data.size())),
+                      "Protobuf parsing failed.");
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_NOT(model_proto.ParseFromString(model_fields), "Protobuf parsing failed.");
+  model_fields.clear();
+  model_fields.shrink_to_fit();
+
+  InlinedVector<gsl::span<const uint8_t>> initializer_data;
+  std::string graph_fields;
+  ORT_RETURN_IF_ERROR(SplitSerializedField(graph_data[0], kGraphProtoInitializerField, initializer_data,
+                                           graph_fields));
+
+  GraphProto& graph_proto = *model_proto.mutable_graph();
+  ORT_RETURN_IF_NOT(graph_proto.ParseFromString(graph_fields), "Protobuf parsing failed.");
+
+  auto& initializers = *graph_proto.mutable_initializer();
+  initializers.Reserve(narrow<int>(initializer_data.size()));
+  for (const auto& serialized : initializer_data) {
+    ORT_RETURN_IF_ERROR(ParseMappedTensorProto(serialized, *initializers.Add()));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+Status Model::LoadWithMappedInitializers(const PathString& file_path, std::shared_ptr<Model>& p_model,
+                                         const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                                         const logging::Logger& logger, const ModelOptions& options) {
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(file_path.c_str(), file_length));
+  ORT_RETURN_IF(file_length == 0, "Load model ", ToUTF8String(file_path), " failed. File is empty.");
+
+  Env::MappedMemoryPtr mapped_model_data;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, file_length, mapped_model_data));
+
+  ModelProto model_proto;
+  ORT_RETURN_IF_ERROR(ParseModelProtoWithMappedInitializers(
+      gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_model_data.get()), file_length), model_proto));
+
+  auto status = Status::OK();
+  ORT_TRY {
+    p_model = std::make_shared<Model>(std::move(model_proto), file_path, local_registries, logger, options);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = Status(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to load model with error: " + std::string(ex.what()));
+    });
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  p_model->mapped_model_data_ = std::move(mapped_model_data);
+  p_model->mapped_model_data_length_ = file_length;
+
+  Graph::ResolveOptions resolve_options;
+  resolve_options.no_proto_sync_required = true;
+  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(resolve_options));
+
+  return Status::OK();
+}
+
 Status Model::Save(Model& model, const std::string& file_path) {
   return SaveModel(model, file_path);
 }
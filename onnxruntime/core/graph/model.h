@@ -13,6 +13,7 @@
 #include "core/common/path.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/ort_format_load_options.h"
+#include "core/platform/env.h"
 #include "core/session/onnxruntime_c_api.h"
 #if !defined(ORT_MINIMAL_BUILD)
 #include "core/graph/function_template.h"
@@ -35,6 +36,10 @@ struct ModelOptions {
   // warnings will be logged but processing will continue and no error will
   // be returned.
   bool strict_shape_type_inference;
+  // If true, loading a model from a file maps the file into memory and the raw data of the initializers refers
+  // to the mapping instead of being copied. The data is materialized when the initializers are converted to
+  // OrtValues, or read by graph transformers.
+  bool lazy_initializer_data = false;
 
   ModelOptions(bool allow_released_opsets_only, bool strict_shape_type_inference)
       : allow_released_opsets_only(allow_released_opsets_only),
@@ -181,6 +186,12 @@ class Model {
   const Graph& MainGraph() const noexcept;
 
 #if !defined(ORT_MINIMAL_BUILD)
+  // Gets the mapping of the model file that lazily materialized initializers refer to.
+  // Empty unless the model was loaded with ModelOptions::lazy_initializer_data.
+  gsl::span<char> MappedModelData() const noexcept {
+    return gsl::span<char>(mapped_model_data_.get(), mapped_model_data_ ? mapped_model_data_length_ : 0);
+  }
+
   // Get model's serialization proto data.
   ONNX_NAMESPACE::ModelProto ToProto() const;
 
@@ -311,6 +322,14 @@ class Model {
   Model();
 
  private:
+#if !defined(ORT_MINIMAL_BUILD)
+  static common::Status LoadWithMappedInitializers(const PathString& file_path,
+                                                   /*out*/ std::shared_ptr<Model>& p_model,
+                                                   const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                                                   const logging::Logger& logger,
+                                                   const ModelOptions& options);
+#endif
+
   // Model data.
 #if !defined(ORT_MINIMAL_BUILD)
   ONNX_NAMESPACE::ModelProto model_proto_;
@@ -343,6 +362,13 @@ class Model {
   // Path to model file. May be empty.
   const Path model_path_;
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Mapping of the model file that initializers with lazily materialized data refer to.
+  // Declared before graph_ so that it outlives the graph.
+  Env::MappedMemoryPtr mapped_model_data_;
+  size_t mapped_model_data_length_ = 0;
+#endif
+
   // Main graph of the model.
   std::unique_ptr<Graph> graph_;
 };
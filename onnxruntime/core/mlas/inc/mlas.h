@@ -94,6 +94,25 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+#if defined(MLAS_TARGET_AMD64) && defined(MLAS_F16VEC_AVX512FP16_KERNELS)
+// The x64 fp16 kernels are selected at runtime, but halfgemm_kernel_avx512fp16.cpp,
+// activate_fp16.cpp, pooling_fp16.cpp and dwconv.cpp must be compiled with
+// AVX512F, AVX512BW, AVX512VL and AVX512_FP16 enabled. The build defines
+// MLAS_F16VEC_AVX512FP16_KERNELS when it compiles those sources that way.
+#define MLAS_F16VEC_INTRINSICS_SUPPORTED
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
+#if defined(MLAS_TARGET_AMD64) && defined(MLAS_SBGEMM_AVX512BF16_KERNELS)
+// The x64 bf16 kernels are selected at runtime, but sbgemm_kernel_avx512bf16.cpp
+// must be compiled with AVX512_BF16, AVX512BW and AVX512VL enabled. The build
+// defines MLAS_SBGEMM_AVX512BF16_KERNELS when it compiles that source.
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -199,6 +218,55 @@ MlasActivation(
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Interface for single precision gemm post processors.
+ *
+ * SGEMM is computed tile by tile. When the final value of a tile of the
+ * result matrix is produced, and while the tile is still cache resident,
+ * the method Process() is called to process this tile. Parameters of this
+ * method describe the location and shape of the tile.
+ */
+class MLAS_SGEMM_POSTPROCESSOR
+{
+   public:
+    virtual void Process(float*, /**< the address of the tile to process */
+                         size_t, /**< the start row index of the tile in the matrix */
+                         size_t, /**< the start col index of the tile in the matrix */
+                         size_t, /**< the row count of the tile */
+                         size_t, /**< the col count of the tile */
+                         size_t  /**< the leading dimension of matrix */
+    ) const = 0;
+
+    virtual ~MLAS_SGEMM_POSTPROCESSOR() {}
+};
+
+/**
+ * @brief Single precision gemm epilogue: C = Activation(C + Bias + Sum).
+ *
+ * The optional bias is a vector of N elements that is broadcast to each row.
+ * The optional sum tensor, e.g. a residual connection, must have the same
+ * layout as the GEMM output tensor.
+ */
+class MLAS_SGEMM_ACTIVATION_PROCESSOR : public MLAS_SGEMM_POSTPROCESSOR
+{
+   public:
+    MLAS_SGEMM_ACTIVATION_PROCESSOR(
+        const MLAS_ACTIVATION& Activation,
+        const float* Bias = nullptr,
+        const float* SumBuf = nullptr)
+        : Activation_(Activation), Bias_(Bias), SumBuf_(SumBuf)
+    {
+    }
+
+    void Process(float* C, size_t StartM, size_t StartN, size_t CountM, size_t CountN, size_t ldc)
+        const override;
+
+   private:
+    const MLAS_ACTIVATION& Activation_;
+    const float* Bias_;
+    const float* SumBuf_;
+};
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -212,6 +280,11 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_SGEMM_POSTPROCESSOR* OutputProcessor = nullptr; /**< Optional epilogue applied to each output tile */
+    const float* const* BReplicas = nullptr; /**< Optional copies of B per NUMA node, indexed by node, read instead
+                                                  of B by the pool threads running on the node. nullptr entries
+                                                  fall back to B */
+    size_t BReplicaCount = 0; /**< Supplies the number of entries of BReplicas */
 };
 
 /**
@@ -628,6 +701,72 @@ MlasGemm(
     MlasGemmBatch(Shape, &DataParams, 1, ThreadPool);
 }
 
+/**
+ * @brief Supply matrices data information to the GEMM of 16-bit A and 8-bit B.
+ *        Shape.AIsSigned indicates whether A is int16_t or uint16_t, Shape.BIsSigned whether B is int8_t or
+ *        uint8_t. B must be packed by MlasGemmInt16x8PackB.
+ */
+struct MLAS_GEMM_INT16X8_DATA_PARAMS {
+    const void* A = nullptr;
+    size_t lda = 0;
+    int32_t ZeroPointA = 0;
+    const void* PackedB = nullptr;
+    const uint8_t* ZeroPointB = nullptr;
+    bool PerColumnZeroPoints = false;
+    int32_t* C = nullptr;
+    size_t ldc = 0;
+    const MLAS_QGEMM_OUTPUT_PROCESSOR* OutputProcessor = nullptr;
+};
+
+/**
+ * @brief Returns the size of the buffer of a B of N x K packed by MlasGemmInt16x8PackB.
+ */
+size_t
+MLASCALL
+MlasGemmInt16x8PackBSize(
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief Packs an 8-bit B of K x N for MlasGemmInt16x8Batch. Pairs of rows are interleaved and widened to 16
+ *        bits, so each multiply-add of pairs of A and B (pmaddwd, smlal) computes two steps of K.
+ *
+ * @param [IN]  N, K      Shape of B
+ * @param [IN]  B         Address of B, row major
+ * @param [IN]  ldb       Leading dimension of B
+ * @param [IN]  BIsSigned Whether B is int8_t or uint8_t
+ * @param [OUT] PackedB   Buffer of MlasGemmInt16x8PackBSize bytes
+ */
+void
+MLASCALL
+MlasGemmInt16x8PackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    bool BIsSigned,
+    void* PackedB
+    );
+
+/**
+ * @brief Batched GEMM of 16-bit activations A and 8-bit weights B, with 32-bit accumulation.
+ *        Shape.IsAccumulateMode is not supported.
+ *
+ * @param [IN]  Shape        A single shape descriptor for all the multiplications
+ * @param [IN]  DataParams   Array of data descriptors for the matrices.
+ * @param [IN]  BatchN       Size of the parameters array, also number of multiplications to perform
+ * @param [IN]  ThreadPool   optional thread pool for parallel processing
+ */
+void
+MLASCALL
+MlasGemmInt16x8Batch(
+    const MLAS_GEMM_QUANT_SHAPE_PARAMS& Shape,
+    const MLAS_GEMM_INT16X8_DATA_PARAMS* DataParams,
+    const size_t BatchN,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Symmetric QGEMM has limited buffer overrun.
 // Currently only supported in ARM64
@@ -754,6 +893,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -786,6 +926,9 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileBlock;
+        } Winograd;
     } u;
 };
 
@@ -819,6 +962,40 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Switches a convolution prepared by MlasConvPrepare to the Winograd F(4x4, 3x3)
+// algorithm when the convolution is a 2D 3x3 kernel with unit strides and
+// dilations that is large enough to benefit from it. Winograd trades a small
+// amount of accuracy for fewer multiplications, so the caller opts in. Returns
+// false and leaves the parameters unchanged if the algorithm is not selected.
+//
+
+bool
+MLASCALL
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Direct convolution of channels last (NHWC or NDHWC) tensors using the shapes
+// computed by MlasConvPrepare. The filter is stored as kernel spatial positions
+// x input channels per group x output channels, that is HWIO with the output
+// channels of all groups in the last dimension. No working buffer is needed.
+//
+
+void
+MLASCALL
+MlasConvNhwc(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -1016,6 +1193,68 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Reduction routines.
+//
+
+enum MLAS_REDUCE_KIND {
+    MlasReduceSum,
+    MlasReduceMean,
+    MlasReduceMaximum,
+    MlasReduceMinimum,
+    MlasReduceSumSquare,
+    MlasReduceL2,
+    MlasReduceLogSumExp,
+};
+
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Layer normalization routines.
+//
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* InputSkipBiasSum,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
+//
+// Rotary position embedding routines.
+//
+
+void
+MLASCALL
+MlasRotaryEmbedOneRow(
+    const float* Input,
+    const float* SinData,
+    const float* CosData,
+    size_t RotaryDim,
+    bool Interleaved,
+    float* Output
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -1037,6 +1276,34 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+//
+// Brain floating-point routines.
+//
+
+void
+MLASCALL
+MlasConvertBFloat16ToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasConvertFloatToBFloat16Buffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
 //
 // Transpose routines.
 //
@@ -1086,6 +1353,77 @@ MlasTranspose(
     size_t N
     );
 
+//
+// Permutes the axes of an N-dimensional tensor: output axis i is the input
+// axis Permutation[i].
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Gather routines for 32-bit elements.
+//
+// Output[i] = Input[Indices[i] * IndexStride + i * ElementStride] for i in
+// [0, N). Negative indices are relative to AxisSize. The routines return
+// false if an index is outside [-AxisSize, AxisSize), in which case the
+// contents of Output are undefined.
+//
+
+bool
+MLASCALL
+MlasGather(
+    const uint32_t* Input,
+    const int32_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
+bool
+MLASCALL
+MlasGather(
+    const uint32_t* Input,
+    const int64_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1614,7 +1952,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -45,6 +45,8 @@ typedef enum {
 struct MLAS_SQNBIT_GEMM_DATA_PARAMS {
     const float* A = nullptr;               ///< address of A (float32 matrix)
     size_t lda = 0;                         ///< leading dimension of A
+    const void* QuantA = nullptr;           ///< optional address of A quantized by MlasSQNBitGemmQuantizeA(),
+                                            ///< used instead of A by compute types that quantize A
     const void* QuantBData = nullptr;       ///< address of quantized B (quantized n-bit int values)
     const float* QuantBScale = nullptr;     ///< address of scale values of quantized B, one per block
     const void* QuantBZeroPoint = nullptr;  ///< optional address of zero point values of quantized B, one per block
@@ -134,6 +136,54 @@ MlasSQNBitGemmBatchWorkspaceSize(
     MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
 );
 
+/**
+ * @brief Gets the size in bytes of M rows of A quantized by MlasSQNBitGemmQuantizeA().
+ * If zero, the compute type does not quantize A and MlasSQNBitGemmQuantizeA() must not be called.
+ *
+ * @param[in]   M               row size of matrix A
+ * @param[in]   K               column size of matrix A
+ * @param[in]   BlkBitWidth     quantized value bit width (e.g., 4 means 4 bit ints)
+ * @param[in]   BlkLen          number of quantized values per block
+ * @param[in]   ComputeType     GEMM compute type (e.g., multiplying float or int8 values)
+ */
+size_t MLASCALL
+MlasSQNBitGemmQuantizedASize(
+    size_t M,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+);
+
+/**
+ * @brief Quantizes A the way MlasSQNBitGemmBatch() does for the compute type, so that GEMMs sharing the same A can
+ *        pass it as MLAS_SQNBIT_GEMM_DATA_PARAMS::QuantA instead of each quantizing it again.
+ *        The rows of the quantized A are contiguous, the quantized A of row m starts at
+ *        m * MlasSQNBitGemmQuantizedASize(1, K, ...).
+ *
+ * @param[in]   M               row size of matrix A
+ * @param[in]   K               column size of matrix A
+ * @param[in]   BlkBitWidth     quantized value bit width (e.g., 4 means 4 bit ints)
+ * @param[in]   BlkLen          number of quantized values per block
+ * @param[in]   ComputeType     GEMM compute type (e.g., multiplying float or int8 values)
+ * @param[in]   A               address of A (float32 matrix)
+ * @param[in]   lda             leading dimension of A
+ * @param[out]  QuantA          quantized A, a buffer of MlasSQNBitGemmQuantizedASize() bytes aligned for a float
+ * @param[in]   ThreadPool      optional thread pool to use
+ */
+void MLASCALL
+MlasSQNBitGemmQuantizeA(
+    size_t M,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const float* A,
+    size_t lda,
+    void* QuantA,
+    MLAS_THREADPOOL* ThreadPool = nullptr
+);
+
 /**
  * @brief Gets the size in bytes of the packed quantized B data.
  * If non-zero, the quantized B data must first be packed by calling MlasSQNBitGemmPackQuantBData() with a buffer of
@@ -519,3 +519,203 @@ Return Value:
         }
     }
 }
+
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasSgemmEpilogueKernel(
+    const MLAS_ACTIVATION* Activation,
+    float* Buffer,
+    const float* Bias,
+    const float* Sum,
+    size_t M,
+    size_t N,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine steps over a tile of the output matrix, adds the optional
+    bias vector and sum tensor and invokes the templated activation function.
+
+Arguments:
+
+    Activation - Supplies the parameters for the activation.
+
+    Buffer - Supplies the output tile.
+
+    Bias - Supplies the optional bias vector of N elements, which is added to
+        each row of the output tile.
+
+    Sum - Supplies the optional sum tile, which has the same layout as the
+        output tile.
+
+    M - Supplies the number of rows in the output tile.
+
+    N - Supplies the number of columns of the output tile.
+
+    ldc - Supplies the number of elements per row of the output matrix and of
+        the sum matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_ACTIVATION_FUNCTION<ActivationKind> ActivationFunction(Activation);
+
+    while (M-- > 0) {
+
+        float* buffer = Buffer;
+        const float* bias = Bias;
+        const float* sum = Sum;
+        size_t n = N;
+
+        while (n >= 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(buffer);
+
+            if (bias != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(bias));
+                bias += 4;
+            }
+
+            if (sum != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(sum));
+                sum += 4;
+            }
+
+            MlasStoreFloat32x4(buffer, ActivationFunction.Activate(Vector));
+            buffer += 4;
+            n -= 4;
+        }
+
+        while (n > 0) {
+
+            float Scalar = *buffer;
+
+            if (bias != nullptr) {
+                Scalar += *bias++;
+            }
+
+            if (sum != nullptr) {
+                Scalar += *sum++;
+            }
+
+            *buffer++ = ActivationFunction.Activate(Scalar);
+            n -= 1;
+        }
+
+        Buffer += ldc;
+
+        if (Sum != nullptr) {
+            Sum += ldc;
+        }
+    }
+}
+
+void
+MLAS_SGEMM_ACTIVATION_PROCESSOR::Process(
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    ) const
+/*++
+
+Routine Description:
+
+    This routine applies the bias addition, the sum addition and the activation
+    function to a tile of the SGEMM output matrix.
+
+Arguments:
+
+    C - Supplies the address of the output tile.
+
+    StartM - Supplies the starting row of the tile relative to the matrix.
+
+    StartN - Supplies the starting column of the tile relative to the matrix.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the leading dimension of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Bias = (Bias_ != nullptr) ? Bias_ + StartN : nullptr;
+    const float* Sum = (SumBuf_ != nullptr) ? SumBuf_ + StartM * ldc + StartN : nullptr;
+
+    switch (Activation_.ActivationKind) {
+
+        case MlasIdentityActivation:
+        {
+            if (Bias != nullptr || Sum != nullptr) {
+                MlasSgemmEpilogueKernel<MlasIdentityActivation>(&Activation_, C, Bias, Sum, CountM, CountN, ldc);
+            }
+            break;
+        }
+
+        case MlasReluActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasReluActivation>(&Activation_, C, Bias, Sum, CountM, CountN, ldc);
+            break;
+        }
+
+        case MlasLeakyReluActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasLeakyReluActivation>(&Activation_, C, Bias, Sum, CountM, CountN, ldc);
+            break;
+        }
+
+        case MlasTanhActivation:
+        case MlasLogisticActivation:
+        {
+            if (Bias != nullptr || Sum != nullptr) {
+                MlasSgemmEpilogueKernel<MlasIdentityActivation>(&Activation_, C, Bias, Sum, CountM, CountN, ldc);
+            }
+
+            //
+            // The tile is still cache resident, so apply the vectorized
+            // transcendental routines one row at a time.
+            //
+
+            for (size_t m = 0; m < CountM; m++) {
+                float* Row = C + m * ldc;
+                if (Activation_.ActivationKind == MlasTanhActivation) {
+                    MlasComputeTanh(Row, Row, CountN);
+                } else {
+                    MlasComputeLogistic(Row, Row, CountN);
+                }
+            }
+
+            break;
+        }
+
+        case MlasClipActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasClipActivation>(&Activation_, C, Bias, Sum, CountM, CountN, ldc);
+            break;
+        }
+
+        case MlasHardSigmoidActivation:
+        {
+            MlasSgemmEpilogueKernel<MlasHardSigmoidActivation>(&Activation_, C, Bias, Sum, CountM, CountN, ldc);
+            break;
+        }
+
+        case MlasActivationKindCount:
+        {
+            MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
+            break;
+        }
+    }
+}
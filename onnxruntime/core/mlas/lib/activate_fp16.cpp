@@ -92,63 +92,58 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasLeakyReluActivation>
 
 template <>
 struct MLAS_HALF_ACTIVATION_FUNCTION<MlasTanhActivation> {
-#if defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM64EC)
     //
     // Ported from XNNPACK (f16-tanh-aarch64-neonfp16arith-expm1minus-rr1-p3h2-div.c)
     //
 
     //
-    // Constants for float16x8_t
+    // Constants for 8 lane vectors
     //
 
     // The smallest z for which tanhh(-z) is saturated at -1.0h.
-    const float16x8_t vsat_cutoff_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x4482)));  // 0x1.208p+2h
+    const MLAS_FLOAT16X8 vsat_cutoff_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x4482));  // 0x1.208p+2h
     // Large number such that ulp(magic bias) == 0.5 and magic bias === 7.5 mod 2**8.
-    const float16x8_t vmagic_bias_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x620F)));  // 0x1.83Cp+9h
-    const float16x8_t vminus_log2e_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0xBDC5)));  // -0x1.714p+0h
-    const float16x8_t vln2_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x398C)));  // 0x1.630p-1h
+    const MLAS_FLOAT16X8 vmagic_bias_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x620F));  // 0x1.83Cp+9h
+    const MLAS_FLOAT16X8 vminus_log2e_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0xBDC5));  // -0x1.714p+0h
+    const MLAS_FLOAT16X8 vln2_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x398C));  // 0x1.630p-1h
     // Coefficients of polynomial approximation
     //   exp(-2t) - 1 ~ t * (-2 + t * (c2 + t * c3))
     // on [-log(2)/4, log(2)/4]
-    const float16x8_t vc3_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0xBD5B)));  // -0x1.56Cp+0h
-    const float16x8_t vc2_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x4008)));  // 0x1.020p+1h
-    const float16x8_t vtwo_16x8 = vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x4000)));  // 2.0h
-    const float16x8_t vminus_one_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0xBC00)));  // -1.0h
-    // Mask for the sign bit.
-    const uint16x8_t vsign_mask_16x8 = vmovq_n_u16(UINT16_C(0x8000));
+    const MLAS_FLOAT16X8 vc3_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0xBD5B));  // -0x1.56Cp+0h
+    const MLAS_FLOAT16X8 vc2_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x4008));  // 0x1.020p+1h
+    const MLAS_FLOAT16X8 vtwo_16x8 = MlasBroadcastFloat16x8(UINT16_C(0x4000));  // 2.0h
+    const MLAS_FLOAT16X8 vminus_one_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0xBC00));  // -1.0h
 
     //
-    // Constants for float16x4_t
+    // Constants for 4 lane vectors
     //
 
     // The smallest z for which tanhh(-z) is saturated at -1.0h.
-    const float16x4_t vsat_cutoff_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x4482)));  // 0x1.208p+2h
+    const MLAS_FLOAT16X4 vsat_cutoff_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x4482));  // 0x1.208p+2h
     // Large number such that ulp(magic bias) == 0.5 and magic bias === 7.5 mod 2**8.
-    const float16x4_t vmagic_bias_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x620F)));  // 0x1.83Cp+9h
-    const float16x4_t vminus_log2e_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0xBDC5)));  // -0x1.714p+0h
-    const float16x4_t vln2_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x398C)));  // 0x1.630p-1h
+    const MLAS_FLOAT16X4 vmagic_bias_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x620F));  // 0x1.83Cp+9h
+    const MLAS_FLOAT16X4 vminus_log2e_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0xBDC5));  // -0x1.714p+0h
+    const MLAS_FLOAT16X4 vln2_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x398C));  // 0x1.630p-1h
     // Coefficients of polynomial approximation
     //   exp(-2t) - 1 ~ t * (-2 + t * (c2 + t * c3))
     // on [-log(2)/4, log(2)/4]
-    const float16x4_t vc3_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0xBD5B)));  // -0x1.56Cp+0h
-    const float16x4_t vc2_16x4 = vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x4008)));  // 0x1.020p+1h
-    const float16x4_t vtwo_16x4 = vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x4000)));  // 2.0h
-    const float16x4_t vminus_one_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0xBC00)));  // -1.0h
-    // Mask for the sign bit.
-    const uint16x4_t vsign_mask_16x4 = vmov_n_u16(UINT16_C(0x8000));
+    const MLAS_FLOAT16X4 vc3_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0xBD5B));  // -0x1.56Cp+0h
+    const MLAS_FLOAT16X4 vc2_16x4 = MlasBroadcastFloat16x4(UINT16_C(0x4008));  // 0x1.020p+1h
+    const MLAS_FLOAT16X4 vtwo_16x4 = MlasBroadcastFloat16x4(UINT16_C(0x4000));  // 2.0h
+    const MLAS_FLOAT16X4 vminus_one_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0xBC00));  // -1.0h
 
     MLAS_HALF_ACTIVATION_FUNCTION(const MLAS_ACTIVATION& Activation)
     {
@@ -165,13 +160,13 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasTanhActivation> {
         //
         // First we compute y := expm1(-2z) / (2 + expm1(-2z)) where z = abs(x),
         // then set its sign according to the sign of x: f(x) := sign(x) * abs(y).
-        float16x8_t vz = vabsq_f16(vx);
+        MLAS_FLOAT16X8 vz = MlasAbsFloat16x8(vx);
 
         // The function saturates at -1 for large positive inputs: tanhh(-z) == -1.0h for z >=
         // sat_cutoff ~= 9.010913. To guarantee this behavior, we clip input z at sat_cutoff, and
         // leverage the fact that for our implementation tanhf(sat_cutoff) == -1.0h. NaN inputs are
         // passed unchanged.
-        vz = vminq_f16(vz, vsat_cutoff_16x8);
+        vz = MlasMinimumFloat16x8(vsat_cutoff_16x8, vz);
 
         // Compute reduced argument n := round(-z / log(2), 1).
         // We do it by adding a large number (magic bias), which cause rounding of the result to 1
@@ -182,41 +177,41 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasTanhActivation> {
         // tanhh(x). Additionally, we fuse addition of the floating-point exponent bias (15) into
         // the magic bias. Note that addition-subtraction of the large number doesn't cause overflow
         // for inputs in this range.
-        float16x8_t vn = vfmaq_f16(vmagic_bias_16x8, vz, vminus_log2e_16x8);
+        MLAS_FLOAT16X8 vn = MlasMultiplyAddFloat16x8(vz, vminus_log2e_16x8, vmagic_bias_16x8);
 
         // Create a floating-point number s (scale) such that s == 2**(2n) for inputs which don't
         // cause underflow, i.e. 0 <= z <= 4.5078125, and -7 <= n <= 0 accordingly.
-        const float16x8_t vs = vreinterpretq_f16_s16(vshlq_n_s16(vreinterpretq_s16_f16(vn), 10));
+        const MLAS_FLOAT16X8 vs = MlasShiftLeftFloat16x8<10>(vn);
 
         // Subtract the large number back to get final n := round(-z / log(2), 1) as a
         // floating-point number.
-        vn = vsubq_f16(vn, vmagic_bias_16x8);
+        vn = MlasSubtractFloat16x8(vn, vmagic_bias_16x8);
 
         // Compute reduced argument t := z + n * log(2). Note that -t = -z - n * log(2).
-        const float16x8_t vt = vfmaq_f16(vz, vn, vln2_16x8);
+        const MLAS_FLOAT16X8 vt = MlasMultiplyAddFloat16x8(vn, vln2_16x8, vz);
 
         // Compute degree-3 polynomial approximation for exp(-2t) - 1 on [-log(2)/4, log(2)/4].
         //   P(t) = t * (-2 + t * (c2 + t * c3))
         //        = t * (-p)
-        float16x8_t vp = vfmaq_f16(vc2_16x8, vc3_16x8, vt);
-        vp = vfmsq_f16(vtwo_16x8, vp, vt);
+        MLAS_FLOAT16X8 vp = MlasMultiplyAddFloat16x8(vc3_16x8, vt, vc2_16x8);
+        vp = MlasNegateMultiplyAddFloat16x8(vp, vt, vtwo_16x8);
 
         // Reconstruct the exp(-2z) - 1 value:
         //   exp(-2z) - 1 = s * (t * (-2 + t * (c2 + t * c3)) + 1) - 1
         //                = s * t * (-p) + (s - 1)
         //                = (s - 1) - (t * s) * p
-        const float16x8_t vts = vmulq_f16(vt, vs);
-        const float16x8_t vsmo = vaddq_f16(vs, vminus_one_16x8);
-        const float16x8_t vemo = vfmsq_f16(vsmo, vp, vts);
+        const MLAS_FLOAT16X8 vts = MlasMultiplyFloat16x8(vt, vs);
+        const MLAS_FLOAT16X8 vsmo = MlasAddFloat16x8(vs, vminus_one_16x8);
+        const MLAS_FLOAT16X8 vemo = MlasNegateMultiplyAddFloat16x8(vp, vts, vsmo);
 
         // Denominator of the tanh fraction: exp(-2z) + 1 = expm1(-2z) + 2
-        const float16x8_t vepo = vaddq_f16(vemo, vtwo_16x8);
+        const MLAS_FLOAT16X8 vepo = MlasAddFloat16x8(vemo, vtwo_16x8);
 
         // Reconstruct y = expm1(-2z) / (expm1(-2z) + 2)
-        float16x8_t vy = vdivq_f16(vemo, vepo);
+        MLAS_FLOAT16X8 vy = MlasDivFloat16x8(vemo, vepo);
 
         // Reconstruct tanh(x) = copysign(y, x)
-        vy = vbslq_f16(vsign_mask_16x8, vx, vy);
+        vy = MlasCopySignFloat16x8(vy, vx);
 
         return vy;
     }
@@ -231,13 +226,13 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasTanhActivation> {
         //
         // First we compute y := expm1(-2z) / (2 + expm1(-2z)) where z = abs(x),
         // then set its sign according to the sign of x: f(x) := sign(x) * abs(y).
-        float16x4_t vz = vabs_f16(vx);
+        MLAS_FLOAT16X4 vz = MlasAbsFloat16x4(vx);
 
         // The function saturates at -1 for large positive inputs: tanhh(-z) == -1.0h for z >=
         // sat_cutoff ~= 9.010913. To guarantee this behavior, we clip input z at sat_cutoff, and
         // leverage the fact that for our implementation tanhf(sat_cutoff) == -1.0h. NaN inputs are
         // passed unchanged.
-        vz = vmin_f16(vz, vsat_cutoff_16x4);
+        vz = MlasMinimumFloat16x4(vsat_cutoff_16x4, vz);
 
         // Compute reduced argument n := round(-z / log(2), 1).
         // We do it by adding a large number (magic bias), which cause rounding of the result to 1
@@ -248,122 +243,104 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasTanhActivation> {
         // tanhh(x). Additionally, we fuse addition of the floating-point exponent bias (15) into
         // the magic bias. Note that addition-subtraction of the large number doesn't cause overflow
         // for inputs in this range.
-        float16x4_t vn = vfma_f16(vmagic_bias_16x4, vz, vminus_log2e_16x4);
+        MLAS_FLOAT16X4 vn = MlasMultiplyAddFloat16x4(vz, vminus_log2e_16x4, vmagic_bias_16x4);
 
         // Create a floating-point number s (scale) such that s == 2**(2n) for inputs which don't
         // cause underflow, i.e. 0 <= z <= 4.5078125, and -7 <= n <= 0 accordingly.
-        const float16x4_t vs = vreinterpret_f16_s16(vshl_n_s16(vreinterpret_s16_f16(vn), 10));
+        const MLAS_FLOAT16X4 vs = MlasShiftLeftFloat16x4<10>(vn);
 
         // Subtract the large number back to get final n := round(-z / log(2), 1) as a
         // floating-point number.
-        vn = vsub_f16(vn, vmagic_bias_16x4);
+        vn = MlasSubtractFloat16x4(vn, vmagic_bias_16x4);
 
         // Compute reduced argument t := z + n * log(2). Note that -t = -z - n * log(2).
-        const float16x4_t vt = vfma_f16(vz, vn, vln2_16x4);
+        const MLAS_FLOAT16X4 vt = MlasMultiplyAddFloat16x4(vn, vln2_16x4, vz);
 
         // Compute degree-3 polynomial approximation for exp(-2t) - 1 on [-log(2)/4, log(2)/4].
         //   P(t) = t * (-2 + t * (c2 + t * c3))
         //        = t * (-p)
-        float16x4_t vp = vfma_f16(vc2_16x4, vc3_16x4, vt);
-        vp = vfms_f16(vtwo_16x4, vp, vt);
+        MLAS_FLOAT16X4 vp = MlasMultiplyAddFloat16x4(vc3_16x4, vt, vc2_16x4);
+        vp = MlasNegateMultiplyAddFloat16x4(vp, vt, vtwo_16x4);
 
         // Reconstruct the exp(-2z) - 1 value:
         //   exp(-2z) - 1 = s * (t * (-2 + t * (c2 + t * c3)) + 1) - 1
         //                = s * t * (-p) + (s - 1)
         //                = (s - 1) - (t * s) * p
-        const float16x4_t vts = vmul_f16(vt, vs);
-        const float16x4_t vsmo = vadd_f16(vs, vminus_one_16x4);
-        const float16x4_t vemo = vfms_f16(vsmo, vp, vts);
+        const MLAS_FLOAT16X4 vts = MlasMultiplyFloat16x4(vt, vs);
+        const MLAS_FLOAT16X4 vsmo = MlasAddFloat16x4(vs, vminus_one_16x4);
+        const MLAS_FLOAT16X4 vemo = MlasNegateMultiplyAddFloat16x4(vp, vts, vsmo);
 
         // Denominator of the tanh fraction: exp(-2z) + 1 = expm1(-2z) + 2
-        const float16x4_t vepo = vadd_f16(vemo, vtwo_16x4);
+        const MLAS_FLOAT16X4 vepo = MlasAddFloat16x4(vemo, vtwo_16x4);
 
         // Reconstruct y = expm1(-2z) / (expm1(-2z) + 2)
-        float16x4_t vy = vdiv_f16(vemo, vepo);
+        MLAS_FLOAT16X4 vy = MlasDivFloat16x4(vemo, vepo);
 
         // Reconstruct tanh(x) = copysign(y, x)
-        vy = vbsl_f16(vsign_mask_16x4, vx, vy);
+        vy = MlasCopySignFloat16x4(vy, vx);
 
         return vy;
     }
-#else
-    MLAS_HALF_ACTIVATION_FUNCTION(const MLAS_ACTIVATION& Activation)
-    {
-        MLAS_UNREFERENCED_PARAMETER(Activation);
-        MLAS_THROW_EX(std::runtime_error, "unsupported target architecture");
-    }
-
-    MLAS_FLOAT16X8 Activate(MLAS_FLOAT16X8 vx)
-    {
-        MLAS_UNREFERENCED_PARAMETER(Activation);
-        MLAS_THROW_EX(std::runtime_error, "unsupported target architecture");
-    }
-
-    MLAS_FLOAT16X4 Activate(MLAS_FLOAT16X4 vx)
-    {
-        MLAS_UNREFERENCED_PARAMETER(Activation);
-        MLAS_THROW_EX(std::runtime_error, "unsupported target architecture");
-    }
-#endif
 };
 
 template <>
 struct MLAS_HALF_ACTIVATION_FUNCTION<MlasLogisticActivation> {
-#if defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM64EC)
     //
     // Ported from XNNPACK (f16-sigmoid-aarch64-neonfp16arith-rr2-p3-div.c).
     //
 
     //
-    // Constants for float16x8_t
+    // Constants for 8 lane vectors
     //
 
     // Large number such that ulp(magic bias) == 1 and magic bias === 15 mod 2**9.
-    const float16x8_t vmagic_bias_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x660F)));  // 0x1.83Cp+10h
-    const float16x8_t vminus_log2e_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0xBDC5)));  // -0x1.714p+0h
-    const float16x8_t vln2_hi_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x398C)));  // 0x1.630p-1h
-    const float16x8_t vln2_lo_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x8AF4)));  // -0x1.BD0p-13h
+    const MLAS_FLOAT16X8 vmagic_bias_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x660F));  // 0x1.83Cp+10h
+    const MLAS_FLOAT16X8 vminus_log2e_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0xBDC5));  // -0x1.714p+0h
+    const MLAS_FLOAT16X8 vln2_hi_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x398C));  // 0x1.630p-1h
+    const MLAS_FLOAT16X8 vln2_lo_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x8AF4));  // -0x1.BD0p-13h
     // Coefficient of polynomial approximation
     //   exp(-t) ~ 1 + t * (c1 + t * c2)
     // on [-log(2)/2, log(2)/2]
-    const float16x8_t vc3_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0xB156)));  // -0x1.558p-3h
-    const float16x8_t vc2_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x3808)));  // 0x1.020p-1h
-    const float16x8_t vone_16x8 = vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0x3C00)));  // 1.0h
+    const MLAS_FLOAT16X8 vc3_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0xB156));  // -0x1.558p-3h
+    const MLAS_FLOAT16X8 vc2_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x3808));  // 0x1.020p-1h
+    const MLAS_FLOAT16X8 vone_16x8 = MlasBroadcastFloat16x8(UINT16_C(0x3C00));  // 1.0h
+    const MLAS_FLOAT16X8 vzero_16x8 = MlasZeroFloat16x8();
     // The largest z for which sigmoidh(-z) is normalized.
     // This number is also the largest z for which exph(-z) is normalized.
-    const float16x8_t vdenorm_cutoff_16x8 =
-        vreinterpretq_f16_u16(vmovq_n_u16(UINT16_C(0xC8DA)));  // -0x1.368p+3h
+    const MLAS_FLOAT16X8 vdenorm_cutoff_16x8 =
+        MlasBroadcastFloat16x8(UINT16_C(0x48DA));  // 0x1.368p+3h
 
     //
-    // Constants for float16x4_t
+    // Constants for 4 lane vectors
     //
 
     // Large number such that ulp(magic bias) == 1 and magic bias === 15 mod 2**9.
-    const float16x4_t vmagic_bias_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x660F)));  // 0x1.83Cp+10h
-    const float16x4_t vminus_log2e_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0xBDC5)));  // -0x1.714p+0h
-    const float16x4_t vln2_hi_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x398C)));  // 0x1.630p-1h
-    const float16x4_t vln2_lo_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x8AF4)));  // -0x1.BD0p-13h
+    const MLAS_FLOAT16X4 vmagic_bias_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x660F));  // 0x1.83Cp+10h
+    const MLAS_FLOAT16X4 vminus_log2e_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0xBDC5));  // -0x1.714p+0h
+    const MLAS_FLOAT16X4 vln2_hi_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x398C));  // 0x1.630p-1h
+    const MLAS_FLOAT16X4 vln2_lo_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x8AF4));  // -0x1.BD0p-13h
     // Coefficient of polynomial approximation
     //   exp(-t) ~ 1 + t * (c1 + t * c2)
     // on [-log(2)/2, log(2)/2]
-    const float16x4_t vc3_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0xB156)));  // -0x1.558p-3h
-    const float16x4_t vc2_16x4 = vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x3808)));  // 0x1.020p-1h
-    const float16x4_t vone_16x4 = vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0x3C00)));  // 1.0h
+    const MLAS_FLOAT16X4 vc3_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0xB156));  // -0x1.558p-3h
+    const MLAS_FLOAT16X4 vc2_16x4 = MlasBroadcastFloat16x4(UINT16_C(0x3808));  // 0x1.020p-1h
+    const MLAS_FLOAT16X4 vone_16x4 = MlasBroadcastFloat16x4(UINT16_C(0x3C00));  // 1.0h
+    const MLAS_FLOAT16X4 vzero_16x4 = MlasZeroFloat16x4();
     // The largest z for which sigmoidh(-z) is normalized.
     // This number is also the largest z for which exph(-z) is normalized.
-    const float16x4_t vdenorm_cutoff_16x4 =
-        vreinterpret_f16_u16(vmov_n_u16(UINT16_C(0xC8DA)));  // -0x1.368p+3h
+    const MLAS_FLOAT16X4 vdenorm_cutoff_16x4 =
+        MlasBroadcastFloat16x4(UINT16_C(0x48DA));  // 0x1.368p+3h
 
     MLAS_HALF_ACTIVATION_FUNCTION(const MLAS_ACTIVATION& Activation)
     {
@@ -380,7 +357,7 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasLogisticActivation> {
         //
         // First we compute f[-z] := exp(-z) / (1 + exp(-z)) where z = abs(x),
         // then replace result with 1 - f[-z] if x >= 0.
-        const float16x8_t vz = vabsq_f16(vx);
+        const MLAS_FLOAT16X8 vz = MlasAbsFloat16x8(vx);
 
         // Compute reduced argument n := round(-z / ln2).
         // We do it by adding a large number (magic bias) to the product z * (-1/ln2), which
@@ -391,48 +368,47 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasLogisticActivation> {
         // inputs outside of [-9.703125, 8.3125] (i.e. z outside [0, 9.703125]) underflow or
         // saturate sigmoidh(x). We fixup the result for such inputs at the very end of the
         // algorithm.
-        float16x8_t vn = vfmaq_f16(vmagic_bias_16x8, vz, vminus_log2e_16x8);
+        MLAS_FLOAT16X8 vn = MlasMultiplyAddFloat16x8(vz, vminus_log2e_16x8, vmagic_bias_16x8);
 
         // Create a floating-point number s (scale) such that s == 2**n for inputs which don't cause
         // underflow, i.e. -9.703125 <= -z <= 0.0, and -14 <= n <= 0 accordingly.
-        const float16x8_t vs = vreinterpretq_f16_s16(vshlq_n_s16(vreinterpretq_s16_f16(vn), 10));
+        const MLAS_FLOAT16X8 vs = MlasShiftLeftFloat16x8<10>(vn);
 
         // Subtract the large number back to get the final n := round(-z / ln2) as a
         // floating-point number.
-        vn = vsubq_f16(vn, vmagic_bias_16x8);
+        vn = MlasSubtractFloat16x8(vn, vmagic_bias_16x8);
 
         // Compute reduced argument t := z - n * log(2). Note that -t = -z - n * log(2).
         // Use Cody-Waite range reduction method (note two constants to represent -ln(2)) to
         // improve accuracy.
-        float16x8_t vt = vfmaq_f16(vz, vn, vln2_hi_16x8);
-        vt = vfmaq_f16(vt, vn, vln2_lo_16x8);
+        MLAS_FLOAT16X8 vt = MlasMultiplyAddFloat16x8(vn, vln2_hi_16x8, vz);
+        vt = MlasMultiplyAddFloat16x8(vn, vln2_lo_16x8, vt);
 
         // Compute degree-3 polynomial approximation for exp(-t) on [-log(2)/2, log(2)/2]:
         //   P(t) = 1 + t * (-1 + t * (c2 + t * c3)) = -(1 - t * p)
-        float16x8_t vp = vfmaq_f16(vc2_16x8, vc3_16x8, vt);
-        vp = vfmsq_f16(vone_16x8, vp, vt);
+        MLAS_FLOAT16X8 vp = MlasMultiplyAddFloat16x8(vc3_16x8, vt, vc2_16x8);
+        vp = MlasNegateMultiplyAddFloat16x8(vp, vt, vone_16x8);
 
         // Reconstruct the exp(-z) value:
         //   e = s * (1 + t * (-1 + t * (c2 + t * c3))
         //     = s * (1 - t * (-p))
         //     = s - (t * s) * (-p)
-        vt = vmulq_f16(vt, vs);
-        float16x8_t ve = vfmsq_f16(vs, vp, vt);
+        vt = MlasMultiplyFloat16x8(vt, vs);
+        MLAS_FLOAT16X8 ve = MlasNegateMultiplyAddFloat16x8(vp, vt, vs);
 
         // Denominator of the sigmoid fraction: 1.0 + exp(-z)
-        float16x8_t vd = vaddq_f16(ve, vone_16x8);
+        MLAS_FLOAT16X8 vd = MlasAddFloat16x8(ve, vone_16x8);
 
         // Reconstruct sigmoid(-z) = exp(-z) / (1.0 + exp(-z))
-        float16x8_t vf = vdivq_f16(ve, vd);
+        MLAS_FLOAT16X8 vf = MlasDivFloat16x8(ve, vd);
 
         // For inputs below denormal cutoff, replace output with +0.0f.
         // Note that for NaN inputs, comparison result is false, and outputs are left unchanged.
-        vf = vreinterpretq_f16_u16(
-            vbicq_u16(vreinterpretq_u16_f16(vf), vcagtq_f16(vx, vdenorm_cutoff_16x8)));
+        vf = MlasBitwiseSelectFloat16x8(MlasCmpLessThanFloat16x8(vdenorm_cutoff_16x8, vz), vzero_16x8, vf);
 
         // Reconstruct sigmoid(x) = x < 0 ? sigmoid(-z) : 1.0 - sigmoid(-z)
-        const uint16x8_t vm = vcltq_f16(vx, vreinterpretq_f16_u16(vmovq_n_u16(0)));
-        vf = vbslq_f16(vm, vf, vsubq_f16(vone_16x8, vf));
+        const MLAS_UINT16X8 vm = MlasCmpLessThanFloat16x8(vx, vzero_16x8);
+        vf = MlasBitwiseSelectFloat16x8(vm, vf, MlasSubtractFloat16x8(vone_16x8, vf));
 
         return vf;
     }
@@ -447,7 +423,7 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasLogisticActivation> {
         //
         // First we compute f[-z] := exp(-z) / (1 + exp(-z)) where z = abs(x),
         // then replace result with 1 - f[-z] if x >= 0.
-        const float16x4_t vz = vabs_f16(vx);
+        const MLAS_FLOAT16X4 vz = MlasAbsFloat16x4(vx);
 
         // Compute reduced argument n := round(-z / ln2).
         // We do it by adding a large number (magic bias) to the product z * (-1/ln2), which
@@ -458,70 +434,50 @@ struct MLAS_HALF_ACTIVATION_FUNCTION<MlasLogisticActivation> {
         // inputs outside of [-9.703125, 8.3125] (i.e. z outside [0, 9.703125]) underflow or
         // saturate sigmoidh(x). We fixup the result for such inputs at the very end of the
         // algorithm.
-        float16x4_t vn = vfma_f16(vmagic_bias_16x4, vz, vminus_log2e_16x4);
+        MLAS_FLOAT16X4 vn = MlasMultiplyAddFloat16x4(vz, vminus_log2e_16x4, vmagic_bias_16x4);
 
         // Create a floating-point number s (scale) such that s == 2**n for inputs which don't cause
         // underflow, i.e. -9.703125 <= -z <= 0.0, and -14 <= n <= 0 accordingly.
-        const float16x4_t vs = vreinterpret_f16_s16(vshl_n_s16(vreinterpret_s16_f16(vn), 10));
+        const MLAS_FLOAT16X4 vs = MlasShiftLeftFloat16x4<10>(vn);
 
         // Subtract the large number back to get the final n := round(-z / ln2) as a
         // floating-point number.
-        vn = vsub_f16(vn, vmagic_bias_16x4);
+        vn = MlasSubtractFloat16x4(vn, vmagic_bias_16x4);
 
         // Compute reduced argument t := z - n * log(2). Note that -t = -z - n * log(2).
         // Use Cody-Waite range reduction method (note two constants to represent -ln2) to
         // improve accuracy.
-        float16x4_t vt = vfma_f16(vz, vn, vln2_hi_16x4);
-        vt = vfma_f16(vt, vn, vln2_lo_16x4);
+        MLAS_FLOAT16X4 vt = MlasMultiplyAddFloat16x4(vn, vln2_hi_16x4, vz);
+        vt = MlasMultiplyAddFloat16x4(vn, vln2_lo_16x4, vt);
 
         // Compute degree-3 polynomial approximation for exp(-t) on [-log(2)/2, log(2)/2]:
         //   P(t) = 1 + t * (-1 + t * (c2 + t * c3)) = -(1 - t * p)
-        float16x4_t vp = vfma_f16(vc2_16x4, vc3_16x4, vt);
-        vp = vfms_f16(vone_16x4, vp, vt);
+        MLAS_FLOAT16X4 vp = MlasMultiplyAddFloat16x4(vc3_16x4, vt, vc2_16x4);
+        vp = MlasNegateMultiplyAddFloat16x4(vp, vt, vone_16x4);
 
         // Reconstruct the exp(-z) value:
         //   e = s * (1 + t * (-1 + t * (c2 + t * c3))
         //     = s * (1 - t * (-p))
         //     = s - (t * s) * (-p)
-        vt = vmul_f16(vt, vs);
-        float16x4_t ve = vfms_f16(vs, vp, vt);
+        vt = MlasMultiplyFloat16x4(vt, vs);
+        MLAS_FLOAT16X4 ve = MlasNegateMultiplyAddFloat16x4(vp, vt, vs);
 
         // Denominator of the sigmoid fraction: 1.0 + exp(-z)
-        float16x4_t vd = vadd_f16(ve, vone_16x4);
+        MLAS_FLOAT16X4 vd = MlasAddFloat16x4(ve, vone_16x4);
 
         // Reconstruct sigmoid(-z) = exp(-z) / (1.0 + exp(-z))
-        float16x4_t vf = vdiv_f16(ve, vd);
+        MLAS_FLOAT16X4 vf = MlasDivFloat16x4(ve, vd);
 
         // For inputs below denormal cutoff, replace output with +0.0f.
         // Note that for NaN inputs, comparison result is false, and outputs are left unchanged.
-        vf = vreinterpret_f16_u16(
-            vbic_u16(vreinterpret_u16_f16(vf), vcagt_f16(vx, vdenorm_cutoff_16x4)));
+        vf = MlasBitwiseSelectFloat16x4(MlasCmpLessThanFloat16x4(vdenorm_cutoff_16x4, vz), vzero_16x4, vf);
 
         // Reconstruct sigmoid(x) = x < 0 ? sigmoid(-z) : 1.0 - sigmoid(-z)
-        const uint16x4_t vm = vclt_f16(vx, vreinterpret_f16_u16(vmov_n_u16(0)));
-        vf = vbsl_f16(vm, vf, vsub_f16(vone_16x4, vf));
+        const MLAS_UINT16X4 vm = MlasCmpLessThanFloat16x4(vx, vzero_16x4);
+        vf = MlasBitwiseSelectFloat16x4(vm, vf, MlasSubtractFloat16x4(vone_16x4, vf));
 
         return vf;
     }
-#else
-    MLAS_HALF_ACTIVATION_FUNCTION(const MLAS_ACTIVATION& Activation)
-    {
-        MLAS_UNREFERENCED_PARAMETER(Activation);
-        MLAS_THROW_EX(std::runtime_error, "unsupported target architecture");
-    }
-
-    MLAS_FLOAT16X8 Activate(MLAS_FLOAT16X8 vx)
-    {
-        MLAS_UNREFERENCED_PARAMETER(Activation);
-        MLAS_THROW_EX(std::runtime_error, "unsupported target architecture");
-    }
-
-    MLAS_FLOAT16X4 Activate(MLAS_FLOAT16X4 vx)
-    {
-        MLAS_UNREFERENCED_PARAMETER(Activation);
-        MLAS_THROW_EX(std::runtime_error, "unsupported target architecture");
-    }
-#endif
 };
 
 template <>
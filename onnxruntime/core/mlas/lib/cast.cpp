@@ -0,0 +1,121 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cast.cpp
+
+Abstract:
+
+    This module implements routines to convert buffers between single
+    precision and the half precision and brain floating point formats.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CAST_F16_TO_F32_KERNEL* Kernel = GetMlasPlatform().CastF16ToF32Kernel;
+
+    if (Kernel != nullptr) {
+        Kernel(Source, Destination, Count);
+        return;
+    }
+#elif defined(MLAS_NEON64_INTRINSICS)
+    while (Count >= 4) {
+        float16x4_t h = vreinterpret_f16_u16(vld1_u16(Source));
+        vst1q_f32(Destination, vcvt_f32_f16(h));
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+#endif
+
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MLAS_Half2Float(Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CAST_F32_TO_F16_KERNEL* Kernel = GetMlasPlatform().CastF32ToF16Kernel;
+
+    if (Kernel != nullptr) {
+        Kernel(Source, Destination, Count);
+        return;
+    }
+#elif defined(MLAS_NEON64_INTRINSICS)
+    while (Count >= 4) {
+        float16x4_t h = vcvt_f16_f32(vld1q_f32(Source));
+        vst1_u16(Destination, vreinterpret_u16_f16(h));
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+#endif
+
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MLAS_Float2Half(Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertBFloat16ToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    //
+    // A brain float is the upper half of a single precision float. The loop
+    // is plain integer code so that the compiler vectorizes it.
+    //
+
+    uint32_t* Output = reinterpret_cast<uint32_t*>(Destination);
+
+    for (size_t n = 0; n < Count; n++) {
+        Output[n] = uint32_t(Source[n]) << 16;
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToBFloat16Buffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+{
+    //
+    // Round to nearest even. NaNs become a quiet NaN with the sign of the
+    // input, which matches the conversion done by Eigen::bfloat16.
+    //
+
+    const uint32_t* Input = reinterpret_cast<const uint32_t*>(Source);
+
+    for (size_t n = 0; n < Count; n++) {
+        const uint32_t Value = Input[n];
+        const uint32_t Rounded = Value + 0x7FFF + ((Value >> 16) & 1);
+        const bool IsNaN = (Value & 0x7FFFFFFF) > 0x7F800000;
+        Destination[n] = IsNaN ? uint16_t(((Value >> 16) & 0x8000) | 0x7FC0) : uint16_t(Rounded >> 16);
+    }
+}
@@ -0,0 +1,92 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cast_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the half precision conversion kernels for
+    processors with AVX2 and F16C.
+
+--*/
+
+#include "mlasi.h"
+
+#if defined(MLAS_CAST_AVX2_KERNELS)
+
+void
+MLASCALL
+MlasCastF16ToF32KernelAvx2(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 16) {
+        __m128i h0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source));
+        __m128i h1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + 8));
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(h0));
+        _mm256_storeu_ps(Destination + 8, _mm256_cvtph_ps(h1));
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    while (Count >= 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source));
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(h));
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+        unsigned short buf[8] = {};
+        std::memcpy(buf, Source, Count * sizeof(unsigned short));
+        float res[8];
+        _mm256_storeu_ps(res, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf))));
+        std::memcpy(Destination, res, Count * sizeof(float));
+    }
+}
+
+void
+MLASCALL
+MlasCastF32ToF16KernelAvx2(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 16) {
+        __m128i h0 = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m128i h1 = _mm256_cvtps_ph(_mm256_loadu_ps(Source + 8), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination), h0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + 8), h1);
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    while (Count >= 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination), h);
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+        float buf[8] = {};
+        std::memcpy(buf, Source, Count * sizeof(float));
+        unsigned short res[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(res), _mm256_cvtps_ph(_mm256_loadu_ps(buf), _MM_FROUND_TO_NEAREST_INT));
+        std::memcpy(Destination, res, Count * sizeof(unsigned short));
+    }
+}
+
+#endif  // defined(MLAS_CAST_AVX2_KERNELS)
@@ -996,3 +996,1048 @@ Return Value:
 
     MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, ThreadCountN, ThreadPool);
 }
+
+//
+// Define the parameters to execute segments of a reduction on worker threads.
+//
+
+struct MLAS_REDUCE_WORK_BLOCK {
+    ptrdiff_t ThreadCount;
+    MLAS_REDUCE_KIND ReduceKind;
+    const float* Input;
+    float* Output;
+    size_t OuterCount;
+    size_t ReduceCount;
+    size_t InnerCount;
+};
+
+//
+// Number of columns reduced together when the reduced axis is not the
+// innermost axis.
+//
+
+constexpr size_t MLAS_REDUCE_COLUMN_BLOCK = 16;
+
+//
+// Define the accumulation operators of the reductions.
+//
+
+struct MLAS_REDUCE_SUM_OPERATOR
+{
+    static float Initial() { return 0.0f; }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasAddFloat32x4(Accumulator, Vector);
+    }
+
+    static float Accumulate(float Accumulator, float Value) { return Accumulator + Value; }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasAddFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceAddFloat32x4(Vector); }
+};
+
+struct MLAS_REDUCE_SUM_SQUARE_OPERATOR : MLAS_REDUCE_SUM_OPERATOR
+{
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMultiplyAddFloat32x4(Vector, Vector, Accumulator);
+    }
+
+    static float Accumulate(float Accumulator, float Value) { return Accumulator + Value * Value; }
+};
+
+struct MLAS_REDUCE_MAXIMUM_OPERATOR
+{
+    static float Initial() { return -std::numeric_limits<float>::infinity(); }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMaximumFloat32x4(Accumulator, Vector);
+    }
+
+    static float Accumulate(float Accumulator, float Value) { return std::max(Accumulator, Value); }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMaximumFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceMaximumFloat32x4(Vector); }
+};
+
+struct MLAS_REDUCE_MINIMUM_OPERATOR
+{
+    static float Initial() { return std::numeric_limits<float>::infinity(); }
+
+    static MLAS_FLOAT32X4 Accumulate(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMinimumFloat32x4(Accumulator, Vector);
+    }
+
+    static float Accumulate(float Accumulator, float Value) { return std::min(Accumulator, Value); }
+
+    static MLAS_FLOAT32X4 Combine(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
+    {
+        return MlasMinimumFloat32x4(Vector1, Vector2);
+    }
+
+    static float Reduce(MLAS_FLOAT32X4 Vector) { return MlasReduceMinimumFloat32x4(Vector); }
+};
+
+template<typename ReduceOperator>
+float
+MlasReduceRowF32(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates the elements of a contiguous row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the accumulated value.
+
+--*/
+{
+    float Accumulator = ReduceOperator::Initial();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 AccumulatorVector0 = MlasBroadcastFloat32x4(Accumulator);
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 AccumulatorVector1 = AccumulatorVector0;
+            MLAS_FLOAT32X4 AccumulatorVector2 = AccumulatorVector0;
+            MLAS_FLOAT32X4 AccumulatorVector3 = AccumulatorVector0;
+
+            while (N >= 16) {
+
+                AccumulatorVector0 = ReduceOperator::Accumulate(AccumulatorVector0, MlasLoadFloat32x4(Input));
+                AccumulatorVector1 = ReduceOperator::Accumulate(AccumulatorVector1, MlasLoadFloat32x4(Input + 4));
+                AccumulatorVector2 = ReduceOperator::Accumulate(AccumulatorVector2, MlasLoadFloat32x4(Input + 8));
+                AccumulatorVector3 = ReduceOperator::Accumulate(AccumulatorVector3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                N -= 16;
+            }
+
+            AccumulatorVector0 = ReduceOperator::Combine(AccumulatorVector0, AccumulatorVector1);
+            AccumulatorVector2 = ReduceOperator::Combine(AccumulatorVector2, AccumulatorVector3);
+            AccumulatorVector0 = ReduceOperator::Combine(AccumulatorVector0, AccumulatorVector2);
+        }
+
+        while (N >= 4) {
+
+            AccumulatorVector0 = ReduceOperator::Accumulate(AccumulatorVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Accumulator = ReduceOperator::Reduce(AccumulatorVector0);
+    }
+
+    while (N > 0) {
+
+        Accumulator = ReduceOperator::Accumulate(Accumulator, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Accumulator;
+}
+
+template<typename ReduceOperator, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasReduceColumnsF32(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates 4*VectorCount columns over ReduceCount rows that
+    are InputStride elements apart.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    ReduceCount - Supplies the number of rows to accumulate.
+
+    InputStride - Supplies the number of elements between rows.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulators[VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        Accumulators[v] = MlasBroadcastFloat32x4(ReduceOperator::Initial());
+    }
+
+    for (size_t r = 0; r < ReduceCount; r++) {
+
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[v] = ReduceOperator::Accumulate(Accumulators[v], MlasLoadFloat32x4(Input + v * 4));
+        }
+
+        Input += InputStride;
+    }
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        MlasStoreFloat32x4(Output + v * 4, Accumulators[v]);
+    }
+}
+
+template<typename ReduceOperator>
+void
+MlasReduceColumnBlockF32(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InputStride,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates up to MLAS_REDUCE_COLUMN_BLOCK columns over
+    ReduceCount rows that are InputStride elements apart.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    ReduceCount - Supplies the number of rows to accumulate.
+
+    InputStride - Supplies the number of elements between rows.
+
+    CountN - Supplies the number of columns to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (CountN == MLAS_REDUCE_COLUMN_BLOCK) {
+        MlasReduceColumnsF32<ReduceOperator, MLAS_REDUCE_COLUMN_BLOCK / 4>(Input, Output, ReduceCount, InputStride);
+        return;
+    }
+
+    while (CountN >= 4) {
+
+        MlasReduceColumnsF32<ReduceOperator, 1>(Input, Output, ReduceCount, InputStride);
+
+        Input += 4;
+        Output += 4;
+        CountN -= 4;
+    }
+
+    while (CountN > 0) {
+
+        float Accumulator = ReduceOperator::Initial();
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            Accumulator = ReduceOperator::Accumulate(Accumulator, Input[r * InputStride]);
+        }
+
+        *Output = Accumulator;
+
+        Input += 1;
+        Output += 1;
+        CountN -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceLogSumExpFinalize(
+    float Maximum,
+    float Accumulation
+    )
+{
+    //
+    // An infinite maximum is the result whatever the other elements are.
+    //
+
+    return std::isinf(Maximum) ? Maximum : std::log(Accumulation) + Maximum;
+}
+
+template<size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasReduceLogSumExpColumnsF32(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the log of the sum of the exponentials of
+    4*VectorCount columns over ReduceCount rows that are InputStride elements
+    apart.
+
+Arguments:
+
+    See MlasReduceColumnsF32.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 NegativeMaximumVectors[VectorCount];
+    MLAS_FLOAT32X4 Accumulators[VectorCount];
+
+    MlasReduceColumnsF32<MLAS_REDUCE_MAXIMUM_OPERATOR, VectorCount>(Input, Output, ReduceCount, InputStride);
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        NegativeMaximumVectors[v] = MlasSubtractFloat32x4(MlasZeroFloat32x4(), MlasLoadFloat32x4(Output + v * 4));
+        Accumulators[v] = MlasZeroFloat32x4();
+    }
+
+    const float* s = Input;
+
+    for (size_t r = 0; r < ReduceCount; r++) {
+
+        for (size_t v = 0; v < VectorCount; v++) {
+            MLAS_FLOAT32X4 Vector = MlasComputeSumExpVector(MlasLoadFloat32x4(s + v * 4), NegativeMaximumVectors[v]);
+            Accumulators[v] = MlasAddFloat32x4(Accumulators[v], Vector);
+        }
+
+        s += InputStride;
+    }
+
+    float Accumulation[VectorCount * 4];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        MlasStoreFloat32x4(Accumulation + v * 4, Accumulators[v]);
+    }
+
+    for (size_t n = 0; n < VectorCount * 4; n++) {
+        Output[n] = MlasReduceLogSumExpFinalize(Output[n], Accumulation[n]);
+    }
+}
+
+void
+MlasReduceLogSumExpColumnBlockF32(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InputStride,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the log of the sum of the exponentials of up to
+    MLAS_REDUCE_COLUMN_BLOCK columns.
+
+Arguments:
+
+    See MlasReduceColumnBlockF32.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (CountN == MLAS_REDUCE_COLUMN_BLOCK) {
+        MlasReduceLogSumExpColumnsF32<MLAS_REDUCE_COLUMN_BLOCK / 4>(Input, Output, ReduceCount, InputStride);
+        return;
+    }
+
+    while (CountN >= 4) {
+
+        MlasReduceLogSumExpColumnsF32<1>(Input, Output, ReduceCount, InputStride);
+
+        Input += 4;
+        Output += 4;
+        CountN -= 4;
+    }
+
+    while (CountN > 0) {
+
+        float Maximum = MLAS_REDUCE_MAXIMUM_OPERATOR::Initial();
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            Maximum = std::max(Maximum, Input[r * InputStride]);
+        }
+
+        float Accumulation = 0.0f;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            Accumulation += std::exp(Input[r * InputStride] - Maximum);
+        }
+
+        *Output = MlasReduceLogSumExpFinalize(Maximum, Accumulation);
+
+        Input += 1;
+        Output += 1;
+        CountN -= 1;
+    }
+}
+
+template<MLAS_REDUCE_KIND ReduceKind>
+float
+MlasReduceRowKindF32(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a contiguous row.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the reduced value.
+
+--*/
+{
+    if constexpr (ReduceKind == MlasReduceSum) {
+        return MlasReduceRowF32<MLAS_REDUCE_SUM_OPERATOR>(Input, N);
+    } else if constexpr (ReduceKind == MlasReduceMean) {
+        return MlasReduceRowF32<MLAS_REDUCE_SUM_OPERATOR>(Input, N) / float(N);
+    } else if constexpr (ReduceKind == MlasReduceMaximum) {
+        return MlasReduceRowF32<MLAS_REDUCE_MAXIMUM_OPERATOR>(Input, N);
+    } else if constexpr (ReduceKind == MlasReduceMinimum) {
+        return MlasReduceRowF32<MLAS_REDUCE_MINIMUM_OPERATOR>(Input, N);
+    } else if constexpr (ReduceKind == MlasReduceSumSquare) {
+        return MlasReduceRowF32<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(Input, N);
+    } else if constexpr (ReduceKind == MlasReduceL2) {
+        return std::sqrt(MlasReduceRowF32<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(Input, N));
+    } else {
+        static_assert(ReduceKind == MlasReduceLogSumExp);
+
+        const float Maximum = MlasReduceRowF32<MLAS_REDUCE_MAXIMUM_OPERATOR>(Input, N);
+        const float NegativeMaximum = std::isinf(Maximum) ? 0.0f : -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+        float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, N, &NegativeMaximum);
+#else
+        float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, N, &NegativeMaximum);
+#endif
+
+        return MlasReduceLogSumExpFinalize(Maximum, Accumulation);
+    }
+}
+
+template<MLAS_REDUCE_KIND ReduceKind>
+void
+MlasReduceColumnBlockKindF32(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InputStride,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces up to MLAS_REDUCE_COLUMN_BLOCK columns over
+    ReduceCount rows that are InputStride elements apart.
+
+Arguments:
+
+    See MlasReduceColumnBlockF32.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if constexpr (ReduceKind == MlasReduceSum) {
+        MlasReduceColumnBlockF32<MLAS_REDUCE_SUM_OPERATOR>(Input, Output, ReduceCount, InputStride, CountN);
+    } else if constexpr (ReduceKind == MlasReduceMean) {
+        MlasReduceColumnBlockF32<MLAS_REDUCE_SUM_OPERATOR>(Input, Output, ReduceCount, InputStride, CountN);
+        for (size_t n = 0; n < CountN; n++) {
+            Output[n] /= float(ReduceCount);
+        }
+    } else if constexpr (ReduceKind == MlasReduceMaximum) {
+        MlasReduceColumnBlockF32<MLAS_REDUCE_MAXIMUM_OPERATOR>(Input, Output, ReduceCount, InputStride, CountN);
+    } else if constexpr (ReduceKind == MlasReduceMinimum) {
+        MlasReduceColumnBlockF32<MLAS_REDUCE_MINIMUM_OPERATOR>(Input, Output, ReduceCount, InputStride, CountN);
+    } else if constexpr (ReduceKind == MlasReduceSumSquare) {
+        MlasReduceColumnBlockF32<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(Input, Output, ReduceCount, InputStride, CountN);
+    } else if constexpr (ReduceKind == MlasReduceL2) {
+        MlasReduceColumnBlockF32<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(Input, Output, ReduceCount, InputStride, CountN);
+        for (size_t n = 0; n < CountN; n++) {
+            Output[n] = std::sqrt(Output[n]);
+        }
+    } else {
+        static_assert(ReduceKind == MlasReduceLogSumExp);
+        MlasReduceLogSumExpColumnBlockF32(Input, Output, ReduceCount, InputStride, CountN);
+    }
+}
+
+template<MLAS_REDUCE_KIND ReduceKind>
+void
+MlasReduceThreadedKind(
+    const MLAS_REDUCE_WORK_BLOCK* WorkBlock,
+    ptrdiff_t Index
+    )
+{
+    const size_t ReduceCount = WorkBlock->ReduceCount;
+    const size_t InnerCount = WorkBlock->InnerCount;
+
+    if (InnerCount == 1) {
+
+        //
+        // Partition the operation along the rows.
+        //
+
+        size_t o;
+        size_t CountO;
+
+        MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->OuterCount, &o, &CountO);
+
+        const float* Input = WorkBlock->Input + o * ReduceCount;
+        float* Output = WorkBlock->Output + o;
+
+        while (CountO > 0) {
+
+            *Output = MlasReduceRowKindF32<ReduceKind>(Input, ReduceCount);
+
+            Input += ReduceCount;
+            Output += 1;
+            CountO--;
+        }
+
+    } else {
+
+        //
+        // Partition the operation along the blocks of columns.
+        //
+
+        const size_t BlockCountN = (InnerCount + MLAS_REDUCE_COLUMN_BLOCK - 1) / MLAS_REDUCE_COLUMN_BLOCK;
+
+        size_t b;
+        size_t CountB;
+
+        MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->OuterCount * BlockCountN, &b, &CountB);
+
+        while (CountB > 0) {
+
+            const size_t o = b / BlockCountN;
+            const size_t n = (b % BlockCountN) * MLAS_REDUCE_COLUMN_BLOCK;
+            const size_t CountN = std::min(InnerCount - n, MLAS_REDUCE_COLUMN_BLOCK);
+
+            MlasReduceColumnBlockKindF32<ReduceKind>(WorkBlock->Input + o * ReduceCount * InnerCount + n,
+                                                     WorkBlock->Output + o * InnerCount + n,
+                                                     ReduceCount, InnerCount, CountN);
+
+            b++;
+            CountB--;
+        }
+    }
+}
+
+void
+MlasReduceThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    reduction.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_REDUCE_WORK_BLOCK*)Context;
+
+    switch (WorkBlock->ReduceKind) {
+        case MlasReduceSum:
+            MlasReduceThreadedKind<MlasReduceSum>(WorkBlock, Index);
+            break;
+        case MlasReduceMean:
+            MlasReduceThreadedKind<MlasReduceMean>(WorkBlock, Index);
+            break;
+        case MlasReduceMaximum:
+            MlasReduceThreadedKind<MlasReduceMaximum>(WorkBlock, Index);
+            break;
+        case MlasReduceMinimum:
+            MlasReduceThreadedKind<MlasReduceMinimum>(WorkBlock, Index);
+            break;
+        case MlasReduceSumSquare:
+            MlasReduceThreadedKind<MlasReduceSumSquare>(WorkBlock, Index);
+            break;
+        case MlasReduceL2:
+            MlasReduceThreadedKind<MlasReduceL2>(WorkBlock, Index);
+            break;
+        case MlasReduceLogSumExp:
+            MlasReduceThreadedKind<MlasReduceLogSumExp>(WorkBlock, Index);
+            break;
+    }
+}
+
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCE_KIND ReduceKind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the middle axis of a tensor of shape
+    [OuterCount, ReduceCount, InnerCount] to produce a tensor of shape
+    [OuterCount, InnerCount].
+
+    If InnerCount is one, each row is reduced with vector accumulators.
+    Otherwise, blocks of adjacent columns are accumulated across the reduced
+    rows, so no index tables are needed for strided reductions.
+
+Arguments:
+
+    ReduceKind - Supplies the kind of reduction.
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    OuterCount - Supplies the number of elements of the outer axis.
+
+    ReduceCount - Supplies the number of elements of the reduced axis. This
+        must be at least one.
+
+    InnerCount - Supplies the number of elements of the inner axis.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_REDUCE_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the reduction parameters to the work block.
+    //
+
+    WorkBlock.ReduceKind = ReduceKind;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.OuterCount = OuterCount;
+    WorkBlock.ReduceCount = ReduceCount;
+    WorkBlock.InnerCount = InnerCount;
+
+    //
+    // Compute the number of target threads given the size of the reduction.
+    // Limit the number of threads to the number of work items and try to keep
+    // each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    const size_t WorkCount = (InnerCount == 1)
+        ? OuterCount
+        : OuterCount * ((InnerCount + MLAS_REDUCE_COLUMN_BLOCK - 1) / MLAS_REDUCE_COLUMN_BLOCK);
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > WorkCount) {
+        ThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((OuterCount * ReduceCount * InnerCount) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    if (ThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasReduceThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Gamma,
+    const float* Beta,
+    float* Output,
+    float* InputSkipBiasSum,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a row of elements, optionally after adding a skip
+    and a bias row to it:
+
+        X = Input + Skip + Bias
+        Output = (X - Mean(X)) / sqrt(Variance(X) + Epsilon) * Gamma + Beta
+
+    If Simplified is true, the row is normalized by its root mean square
+    instead (RMSNorm), and Beta is ignored:
+
+        Output = X / sqrt(Mean(X * X) + Epsilon) * Gamma
+
+    The mean and the variance are computed in two passes over the row, which
+    is more accurate than accumulating the sum of squares.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the skip row added to the input.
+
+    Bias - Optionally supplies the bias row added to the input.
+
+    Gamma - Supplies the scale row.
+
+    Beta - Optionally supplies the shift row.
+
+    Output - Supplies the output row. This may be the same buffer as Input.
+
+    InputSkipBiasSum - Optionally supplies the buffer to store X to, when
+        Skip or Bias are supplied.
+
+    N - Supplies the number of elements of the row. This must be at least one.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Simplified - Supplies true to compute the root mean square normalization.
+
+    Mean - Optionally supplies the address to store the mean of X to. It is
+        not stored if Simplified is true.
+
+    InvStdDev - Optionally supplies the address to store the inverse of the
+        standard deviation (or root mean square) of X to.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* X = Input;
+
+    //
+    // Add the skip and bias rows to the input. The sum is normalized in place
+    // in the output buffer.
+    //
+
+    if (Skip != nullptr || Bias != nullptr) {
+
+        size_t n = 0;
+
+        for (; n + 4 <= N; n += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + n);
+
+            if (Skip != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Skip + n));
+            }
+
+            if (Bias != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + n));
+            }
+
+            MlasStoreFloat32x4(Output + n, Vector);
+
+            if (InputSkipBiasSum != nullptr) {
+                MlasStoreFloat32x4(InputSkipBiasSum + n, Vector);
+            }
+        }
+
+        for (; n < N; n++) {
+
+            float Value = Input[n];
+
+            if (Skip != nullptr) {
+                Value += Skip[n];
+            }
+
+            if (Bias != nullptr) {
+                Value += Bias[n];
+            }
+
+            Output[n] = Value;
+
+            if (InputSkipBiasSum != nullptr) {
+                InputSkipBiasSum[n] = Value;
+            }
+        }
+
+        X = Output;
+    }
+
+    float MeanValue = 0.0f;
+    float Variance;
+
+    if (Simplified) {
+
+        Variance = MlasReduceRowF32<MLAS_REDUCE_SUM_SQUARE_OPERATOR>(X, N) / float(N);
+
+    } else {
+
+        MeanValue = MlasReduceRowF32<MLAS_REDUCE_SUM_OPERATOR>(X, N) / float(N);
+
+        MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(MeanValue);
+        MLAS_FLOAT32X4 AccumulatorVector0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 AccumulatorVector1 = MlasZeroFloat32x4();
+        size_t n = 0;
+
+        for (; n + 8 <= N; n += 8) {
+
+            MLAS_FLOAT32X4 Difference0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(X + n), MeanVector);
+            MLAS_FLOAT32X4 Difference1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(X + n + 4), MeanVector);
+
+            AccumulatorVector0 = MlasMultiplyAddFloat32x4(Difference0, Difference0, AccumulatorVector0);
+            AccumulatorVector1 = MlasMultiplyAddFloat32x4(Difference1, Difference1, AccumulatorVector1);
+        }
+
+        for (; n + 4 <= N; n += 4) {
+
+            MLAS_FLOAT32X4 Difference = MlasSubtractFloat32x4(MlasLoadFloat32x4(X + n), MeanVector);
+
+            AccumulatorVector0 = MlasMultiplyAddFloat32x4(Difference, Difference, AccumulatorVector0);
+        }
+
+        float Accumulator = MlasReduceAddFloat32x4(MlasAddFloat32x4(AccumulatorVector0, AccumulatorVector1));
+
+        for (; n < N; n++) {
+
+            const float Difference = X[n] - MeanValue;
+
+            Accumulator += Difference * Difference;
+        }
+
+        Variance = Accumulator / float(N);
+    }
+
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    //
+    // Normalize the row: Output = (X * InvStdDev - Mean * InvStdDev) * Gamma + Beta.
+    //
+
+    const float ShiftValue = -MeanValue * InvStdDevValue;
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(InvStdDevValue);
+    MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(ShiftValue);
+    const float* ShiftRow = Simplified ? nullptr : Beta;
+    size_t n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(X + n), ScaleVector, ShiftVector);
+
+        if (ShiftRow != nullptr) {
+            Vector = MlasMultiplyAddFloat32x4(Vector, MlasLoadFloat32x4(Gamma + n), MlasLoadFloat32x4(ShiftRow + n));
+        } else {
+            Vector = MlasMultiplyFloat32x4(Vector, MlasLoadFloat32x4(Gamma + n));
+        }
+
+        MlasStoreFloat32x4(Output + n, Vector);
+    }
+
+    for (; n < N; n++) {
+
+        float Value = (X[n] * InvStdDevValue + ShiftValue) * Gamma[n];
+
+        if (ShiftRow != nullptr) {
+            Value += ShiftRow[n];
+        }
+
+        Output[n] = Value;
+    }
+
+    if (Mean != nullptr && !Simplified) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+}
+
+void
+MLASCALL
+MlasRotaryEmbedOneRow(
+    const float* Input,
+    const float* SinData,
+    const float* CosData,
+    size_t RotaryDim,
+    bool Interleaved,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine rotates the first RotaryDim elements of a head vector by the
+    sin/cos cache entries of its position (rotary position embedding).
+
+    In the interleaved form, the pairs of adjacent elements (x[2i], x[2i+1])
+    are rotated by the angle i. Otherwise, the pairs (x[i], x[i+RotaryDim/2])
+    formed by the two halves of the row are rotated by the angle i.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    SinData - Supplies the RotaryDim/2 sine values of the position.
+
+    CosData - Supplies the RotaryDim/2 cosine values of the position.
+
+    RotaryDim - Supplies the number of elements to rotate. This must be even.
+
+    Interleaved - Supplies true to rotate adjacent elements, false to rotate
+        the two halves of the row.
+
+    Output - Supplies the output row. This may be the same buffer as Input.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t HalfRotaryDim = RotaryDim / 2;
+    size_t i = 0;
+
+    if (Interleaved) {
+
+        for (; i + 4 <= HalfRotaryDim; i += 4) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input + 2 * i);
+            MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 2 * i + 4);
+
+            //
+            // Split the pairs into their even and odd elements.
+            //
+
+            MLAS_FLOAT32X4 Low = MlasInterleaveLowFloat32x4(Vector0, Vector1);
+            MLAS_FLOAT32X4 High = MlasInterleaveHighFloat32x4(Vector0, Vector1);
+            MLAS_FLOAT32X4 Even = MlasInterleaveLowFloat32x4(Low, High);
+            MLAS_FLOAT32X4 Odd = MlasInterleaveHighFloat32x4(Low, High);
+
+            MLAS_FLOAT32X4 SinVector = MlasLoadFloat32x4(SinData + i);
+            MLAS_FLOAT32X4 CosVector = MlasLoadFloat32x4(CosData + i);
+
+            MLAS_FLOAT32X4 Real = MlasSubtractFloat32x4(MlasMultiplyFloat32x4(Even, CosVector),
+                                                        MlasMultiplyFloat32x4(Odd, SinVector));
+            MLAS_FLOAT32X4 Imaginary = MlasMultiplyAddFloat32x4(Odd, CosVector,
+                                                                MlasMultiplyFloat32x4(Even, SinVector));
+
+            MlasStoreFloat32x4(Output + 2 * i, MlasInterleaveLowFloat32x4(Real, Imaginary));
+            MlasStoreFloat32x4(Output + 2 * i + 4, MlasInterleaveHighFloat32x4(Real, Imaginary));
+        }
+
+        for (; i < HalfRotaryDim; i++) {
+
+            const float Even = Input[2 * i];
+            const float Odd = Input[2 * i + 1];
+
+            Output[2 * i] = Even * CosData[i] - Odd * SinData[i];
+            Output[2 * i + 1] = Odd * CosData[i] + Even * SinData[i];
+        }
+
+    } else {
+
+        for (; i + 4 <= HalfRotaryDim; i += 4) {
+
+            MLAS_FLOAT32X4 First = MlasLoadFloat32x4(Input + i);
+            MLAS_FLOAT32X4 Second = MlasLoadFloat32x4(Input + HalfRotaryDim + i);
+
+            MLAS_FLOAT32X4 SinVector = MlasLoadFloat32x4(SinData + i);
+            MLAS_FLOAT32X4 CosVector = MlasLoadFloat32x4(CosData + i);
+
+            MlasStoreFloat32x4(Output + i, MlasSubtractFloat32x4(MlasMultiplyFloat32x4(First, CosVector),
+                                                                 MlasMultiplyFloat32x4(Second, SinVector)));
+            MlasStoreFloat32x4(Output + HalfRotaryDim + i,
+                               MlasMultiplyAddFloat32x4(Second, CosVector, MlasMultiplyFloat32x4(First, SinVector)));
+        }
+
+        for (; i < HalfRotaryDim; i++) {
+
+            const float First = Input[i];
+            const float Second = Input[HalfRotaryDim + i];
+
+            Output[i] = First * CosData[i] - Second * SinData[i];
+            Output[HalfRotaryDim + i] = Second * CosData[i] + First * SinData[i];
+        }
+    }
+}
@@ -0,0 +1,393 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convnhwc.cpp
+
+Abstract:
+
+    This module implements the single precision direct convolution operation
+    for channels last tensors.
+
+    Each output row (all output columns and channels of an output image row)
+    is accumulated in place by one matrix multiply per kernel position: the
+    input pixels read by the kernel position form a matrix with a row stride
+    of the convolution stride, so no im2col expansion is needed. With a single
+    group and unit dilations, the kernel positions along the width are read
+    from adjacent input pixels and are merged in a single multiply.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters of a channels last convolution with the 2D shapes
+// promoted to 3D.
+//
+
+struct MLAS_CONV_NHWC_PARAMETERS {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    size_t InputShape[3];
+    size_t OutputShape[3];
+    size_t KernelShape[3];
+    size_t DilationShape[3];
+    size_t StrideShape[3];
+    size_t Padding[3];
+};
+
+MLAS_FORCEINLINE
+void
+MlasConvNhwcOutputRange(
+    size_t KernelIndex,
+    size_t Dilation,
+    size_t Stride,
+    size_t Padding,
+    size_t InputSize,
+    size_t OutputSize,
+    size_t* OutputStart,
+    size_t* OutputEnd
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the range of output positions for which a kernel
+    position reads an input position inside the input, that is
+    0 <= Output * Stride + KernelIndex * Dilation - Padding < InputSize.
+
+Arguments:
+
+    KernelIndex - Supplies the kernel position.
+
+    Dilation - Supplies the dilation.
+
+    Stride - Supplies the stride.
+
+    Padding - Supplies the padding before the input.
+
+    InputSize - Supplies the input size.
+
+    OutputSize - Supplies the output size.
+
+    OutputStart - Receives the first output position of the range.
+
+    OutputEnd - Receives the end of the range, OutputStart if it is empty.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t Offset = KernelIndex * Dilation;
+
+    size_t Start = 0;
+    if (Padding > Offset) {
+        Start = MlasDivRoundup(Padding - Offset, Stride);
+    }
+
+    size_t End = 0;
+    if (InputSize + Padding > Offset) {
+        End = MlasDivRoundup(InputSize + Padding - Offset, Stride);
+    }
+
+    End = std::min(End, OutputSize);
+    Start = std::min(Start, End);
+
+    *OutputStart = Start;
+    *OutputEnd = End;
+}
+
+void
+MlasConvNhwcRow(
+    const MLAS_CONV_NHWC_PARAMETERS* WorkBlock,
+    size_t Row
+    )
+/*++
+
+Routine Description:
+
+    This routine computes an output row of a channels last convolution.
+
+Arguments:
+
+    WorkBlock - Supplies the convolution parameters.
+
+    Row - Supplies the index of the output row, counting the rows of all
+        images and output depths.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TotalInputChannels = GroupCount * InputChannels;
+    const size_t TotalFilterCount = GroupCount * FilterCount;
+
+    const size_t InputDepth = WorkBlock->InputShape[0];
+    const size_t InputHeight = WorkBlock->InputShape[1];
+    const size_t InputWidth = WorkBlock->InputShape[2];
+    const size_t OutputDepth = WorkBlock->OutputShape[0];
+    const size_t OutputHeight = WorkBlock->OutputShape[1];
+    const size_t OutputWidth = WorkBlock->OutputShape[2];
+    const size_t KernelHeight = WorkBlock->KernelShape[1];
+    const size_t KernelWidth = WorkBlock->KernelShape[2];
+    const size_t StrideWidth = WorkBlock->StrideShape[2];
+    const size_t DilationWidth = WorkBlock->DilationShape[2];
+    const size_t PaddingLeft = WorkBlock->Padding[2];
+
+    const size_t ImageIndex = Row / (OutputDepth * OutputHeight);
+    const size_t od = (Row / OutputHeight) % OutputDepth;
+    const size_t oh = Row % OutputHeight;
+
+    const size_t OutputRowSize = OutputWidth * TotalFilterCount;
+    float* output = WorkBlock->Output + Row * OutputRowSize;
+
+    //
+    // Initialize the output row with the bias, accumulating to the existing
+    // output values if requested.
+    //
+
+    const float Beta = Parameters->Beta;
+    const float* Bias = WorkBlock->Bias;
+
+    for (size_t ow = 0; ow < OutputWidth; ow++) {
+        float* out = output + ow * TotalFilterCount;
+        for (size_t f = 0; f < TotalFilterCount; f++) {
+            float value = (Bias != nullptr) ? Bias[f] : 0.0f;
+            if (Beta != 0.0f) {
+                value += Beta * out[f];
+            }
+            out[f] = value;
+        }
+    }
+
+    //
+    // Compute the ranges of output columns that read inside the input for the
+    // kernel positions along the width.
+    //
+
+    size_t OutputStart[64];
+    size_t OutputEnd[64];
+
+    const bool MergeWidth = (GroupCount == 1) && (DilationWidth == 1) && (KernelWidth <= 64);
+
+    if (MergeWidth) {
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
+            MlasConvNhwcOutputRange(kw, DilationWidth, StrideWidth, PaddingLeft, InputWidth,
+                OutputWidth, &OutputStart[kw], &OutputEnd[kw]);
+        }
+    }
+
+    const float* Filter = WorkBlock->Filter;
+    const size_t FilterPositionSize = InputChannels * TotalFilterCount;
+    const bool Depthwise = (InputChannels == 1) && (FilterCount == 1);
+
+    for (size_t kd = 0; kd < WorkBlock->KernelShape[0]; kd++) {
+
+        const ptrdiff_t id = ptrdiff_t(od * WorkBlock->StrideShape[0] + kd * WorkBlock->DilationShape[0]) -
+            ptrdiff_t(WorkBlock->Padding[0]);
+
+        if (id < 0 || size_t(id) >= InputDepth) {
+            continue;
+        }
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const ptrdiff_t ih = ptrdiff_t(oh * WorkBlock->StrideShape[1] + kh * WorkBlock->DilationShape[1]) -
+                ptrdiff_t(WorkBlock->Padding[1]);
+
+            if (ih < 0 || size_t(ih) >= InputHeight) {
+                continue;
+            }
+
+            const float* input = WorkBlock->Input +
+                ((ImageIndex * InputDepth + size_t(id)) * InputHeight + size_t(ih)) * InputWidth * TotalInputChannels;
+            const float* filter = Filter + (kd * KernelHeight + kh) * KernelWidth * FilterPositionSize;
+
+            //
+            // Accumulates the kernel positions [kw, kw + KernelCount) for the
+            // output columns [ow0, ow1). The kernel positions are adjacent in
+            // the input when KernelCount is larger than one.
+            //
+
+            auto Accumulate = [&](size_t kw, size_t KernelCount, size_t ow0, size_t ow1) {
+                if (ow0 >= ow1) {
+                    return;
+                }
+
+                const size_t iw0 = ow0 * StrideWidth + kw * DilationWidth - PaddingLeft;
+                const float* a = input + iw0 * TotalInputChannels;
+                const float* b = filter + kw * FilterPositionSize;
+                float* c = output + ow0 * TotalFilterCount;
+
+                if (Depthwise) {
+                    for (size_t ow = ow0; ow < ow1; ow++) {
+                        for (size_t f = 0; f < TotalFilterCount; f++) {
+                            c[f] += a[f] * b[f];
+                        }
+                        a += StrideWidth * TotalInputChannels;
+                        c += TotalFilterCount;
+                    }
+                    return;
+                }
+
+                for (size_t group = 0; group < GroupCount; group++) {
+                    MlasSgemmOperation(CblasNoTrans, CblasNoTrans, ow1 - ow0, FilterCount,
+                        KernelCount * InputChannels, 1.0f, a + group * InputChannels,
+                        StrideWidth * TotalInputChannels, b + group * FilterCount, TotalFilterCount, 1.0f,
+                        c + group * FilterCount, TotalFilterCount, nullptr, 0, 0);
+                }
+            };
+
+            if (MergeWidth && !Depthwise) {
+
+                //
+                // The output columns where every kernel position reads inside
+                // the input are computed with a single multiply, the columns
+                // at the edges one kernel position at a time.
+                //
+
+                const size_t FullStart = OutputStart[0];
+                const size_t FullEnd = std::max(OutputEnd[KernelWidth - 1], FullStart);
+
+                Accumulate(0, KernelWidth, FullStart, FullEnd);
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+                    Accumulate(kw, 1, OutputStart[kw], std::min(FullStart, OutputEnd[kw]));
+                    Accumulate(kw, 1, std::max(FullEnd, OutputStart[kw]), OutputEnd[kw]);
+                }
+
+            } else {
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+                    size_t ow0;
+                    size_t ow1;
+                    MlasConvNhwcOutputRange(kw, DilationWidth, StrideWidth, PaddingLeft, InputWidth,
+                        OutputWidth, &ow0, &ow1);
+                    Accumulate(kw, 1, ow0, ow1);
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation, the bias has already been added.
+    //
+
+    MlasActivation(Parameters->Activation, output, nullptr, OutputWidth, TotalFilterCount, TotalFilterCount);
+}
+
+void
+MLASCALL
+MlasConvNhwc(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation for channels last
+    tensors.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters computed by MlasConvPrepare. The algorithm and working
+        buffer size selected by MlasConvPrepare are ignored.
+
+    Input - Supplies the input tensor in N x (D x) H x W x C order, where C
+        is GroupCount * InputChannels.
+
+    Filter - Supplies the filter tensor in (kD x) kH x kW x InputChannels x M
+        order, where M is GroupCount * FilterCount.
+
+    Bias - Optionally supplies the bias vector of M elements.
+
+    Output - Supplies the output tensor in N x (D x) H x W x M order.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_NHWC_PARAMETERS WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+
+    //
+    // Promote the 2D shapes to 3D with a depth of one.
+    //
+
+    const size_t Dimensions = Parameters->Dimensions;
+    const size_t Offset = 3 - Dimensions;
+
+    for (size_t dim = 0; dim < 3; dim++) {
+        const bool Promoted = dim < Offset;
+        WorkBlock.InputShape[dim] = Promoted ? 1 : Parameters->InputShape[dim - Offset];
+        WorkBlock.OutputShape[dim] = Promoted ? 1 : Parameters->OutputShape[dim - Offset];
+        WorkBlock.KernelShape[dim] = Promoted ? 1 : Parameters->KernelShape[dim - Offset];
+        WorkBlock.DilationShape[dim] = Promoted ? 1 : Parameters->DilationShape[dim - Offset];
+        WorkBlock.StrideShape[dim] = Promoted ? 1 : Parameters->StrideShape[dim - Offset];
+        WorkBlock.Padding[dim] = Promoted ? 0 : Parameters->Padding[dim - Offset];
+    }
+
+    const size_t RowCount = Parameters->BatchCount * WorkBlock.OutputShape[0] * WorkBlock.OutputShape[1];
+
+    //
+    // Distribute the output rows over the threads, small convolutions run on
+    // a single thread.
+    //
+
+    const double Complexity = double(RowCount) * double(WorkBlock.OutputShape[2]) *
+        double(Parameters->GroupCount * Parameters->FilterCount) * double(Parameters->K);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= RowCount) {
+        TargetThreadCount = ptrdiff_t(RowCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t RowIndex;
+        size_t RowRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, RowCount, &RowIndex, &RowRemaining);
+
+        for (size_t Row = RowIndex; Row < RowIndex + RowRemaining; Row++) {
+            MlasConvNhwcRow(&WorkBlock, Row);
+        }
+    });
+}
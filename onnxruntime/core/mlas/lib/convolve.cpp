@@ -592,7 +592,7 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, nullptr, 0, 0);
 
             beta = 1.0f;
         }
@@ -712,7 +712,7 @@ Return Value:
 
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount, OutputSize,
                            K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, Beta, output,
-                           OutputSize);
+                           OutputSize, nullptr, 0, 0);
 
         //
         // Apply the activation with optional bias.
@@ -874,6 +874,15 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // The Winograd algorithm schedules the batches and groups itself.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -1002,6 +1011,15 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Dispatched above.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -375,6 +375,13 @@ MlasConvSymPackWSize(
             // TODO!! is there a way to know whether this is called by tests?
             return 0;
         }
+#elif defined(MLAS_TARGET_AMD64) && !defined(ORT_MINIMAL_BUILD) && !defined(__APPLE__)
+        if (KernelSize <= 1 && !InputIsSigned &&
+            GetMlasPlatform().GemmU8S8Dispatch == &MlasGemmU8S8DispatchAmx) {
+            // Pointwise convolutions are plain GEMMs, which run faster with
+            // the AMX tiles than with the indirect conv kernel.
+            return 0;
+        }
 #endif
 
         size_t OutputChannelPackCount = ConvSymDispatch->FilterOutputChannelPackCount;
@@ -0,0 +1,638 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convwinograd.cpp
+
+Abstract:
+
+    This module implements the single precision convolution operation for 3x3
+    kernels with unit strides and dilations using the Winograd F(4x4, 3x3)
+    minimal filtering algorithm.
+
+    The output image is split into 4x4 tiles, each computed from a 6x6 input
+    tile. The filters and the input tiles are transformed so that the
+    convolution becomes, for each of the 36 positions of a transformed tile, a
+    matrix multiply of the transformed filters (FilterCount x InputChannels)
+    with the transformed input tiles (InputChannels x tiles). The products are
+    then transformed back to 4x4 output tiles. This needs 36 multiplies per
+    output tile and channel pair instead of 144.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the tile sizes of the F(4x4, 3x3) algorithm.
+//
+
+constexpr size_t MLAS_WINOGRAD_OUTPUT_TILE = 4;
+constexpr size_t MLAS_WINOGRAD_INPUT_TILE = 6;
+constexpr size_t MLAS_WINOGRAD_POSITIONS = MLAS_WINOGRAD_INPUT_TILE * MLAS_WINOGRAD_INPUT_TILE;
+
+//
+// Define the thresholds to select the Winograd algorithm. The transforms are
+// not amortized by the matrix multiplies for small channel counts, and small
+// images waste most of the work on partial tiles.
+//
+
+constexpr size_t MLAS_WINOGRAD_MINIMUM_CHANNELS = 16;
+constexpr size_t MLAS_WINOGRAD_MINIMUM_OUTPUT = 8;
+
+//
+// Define the number of working buffer elements used by a thread for the
+// transformed input tiles and the products of a block of tiles. The number of
+// tiles in a block is derived from this budget so that both stay in the cache.
+//
+
+constexpr size_t MLAS_WINOGRAD_THREAD_BUFFER_SIZE = 128 * 1024;
+constexpr size_t MLAS_WINOGRAD_MINIMUM_TILE_BLOCK = 8;
+constexpr size_t MLAS_WINOGRAD_MAXIMUM_TILE_BLOCK = 96;
+
+//
+// Define the parameters to execute blocks of tiles on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* TransformedFilter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    size_t InputBatchStride;
+    size_t OutputBatchStride;
+    size_t TileBlockCount;
+};
+
+MLAS_FORCEINLINE
+void
+MlasWinogradFilterTransform1D(
+    const float* g,
+    size_t Stride,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a column of 3 filter elements by the matrix G.
+
+Arguments:
+
+    g - Supplies the filter elements.
+
+    Stride - Supplies the distance between the filter elements.
+
+    Output - Receives the 6 transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float g0 = g[0];
+    const float g1 = g[Stride];
+    const float g2 = g[2 * Stride];
+
+    Output[0] = g0 * (1.0f / 4.0f);
+    Output[1] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+    Output[2] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+    Output[3] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    Output[4] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+    Output[5] = g2;
+}
+
+MLAS_FORCEINLINE
+void
+MlasWinogradInputTransform1D(
+    const float* d,
+    size_t Stride,
+    float* Output,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a column of 6 input elements by the matrix B^T.
+
+Arguments:
+
+    d - Supplies the input elements.
+
+    Stride - Supplies the distance between the input elements.
+
+    Output - Receives the 6 transformed elements.
+
+    OutputStride - Supplies the distance between the transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float d0 = d[0];
+    const float d1 = d[Stride];
+    const float d2 = d[2 * Stride];
+    const float d3 = d[3 * Stride];
+    const float d4 = d[4 * Stride];
+    const float d5 = d[5 * Stride];
+
+    Output[0] = 4.0f * d0 - 5.0f * d2 + d4;
+    Output[OutputStride] = -4.0f * (d1 + d2) + d3 + d4;
+    Output[2 * OutputStride] = 4.0f * (d1 - d2) - d3 + d4;
+    Output[3 * OutputStride] = 2.0f * (d3 - d1) - d2 + d4;
+    Output[4 * OutputStride] = 2.0f * (d1 - d3) - d2 + d4;
+    Output[5 * OutputStride] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasWinogradOutputTransform1D(
+    const float* m,
+    size_t Stride,
+    float* Output,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a column of 6 products by the matrix A^T.
+
+Arguments:
+
+    m - Supplies the products.
+
+    Stride - Supplies the distance between the products.
+
+    Output - Receives the 4 output elements.
+
+    OutputStride - Supplies the distance between the output elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float m0 = m[0];
+    const float m1 = m[Stride];
+    const float m2 = m[2 * Stride];
+    const float m3 = m[3 * Stride];
+    const float m4 = m[4 * Stride];
+    const float m5 = m[5 * Stride];
+
+    const float s12 = m1 + m2;
+    const float d12 = m1 - m2;
+    const float s34 = m3 + m4;
+    const float d34 = m3 - m4;
+
+    Output[0] = m0 + s12 + s34;
+    Output[OutputStride] = d12 + 2.0f * d34;
+    Output[2 * OutputStride] = s12 + 4.0f * s34;
+    Output[3 * OutputStride] = d12 + 8.0f * d34 + m5;
+}
+
+void
+MlasConvWinogradTransformFilter(
+    const float* Filter,
+    float* TransformedFilter,
+    size_t FilterCount,
+    size_t InputChannels,
+    size_t FilterIndex
+    )
+/*++
+
+Routine Description:
+
+    This routine computes G g G^T for each input channel of a filter and
+    scatters the result to the 36 matrices of transformed filters.
+
+Arguments:
+
+    Filter - Supplies the filters of the group.
+
+    TransformedFilter - Receives the transformed filters, stored as 36
+        matrices of FilterCount rows and InputChannels columns.
+
+    FilterCount - Supplies the number of filters of the group.
+
+    InputChannels - Supplies the number of input channels of the group.
+
+    FilterIndex - Supplies the index of the filter to transform.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PositionStride = FilterCount * InputChannels;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* g = Filter + (FilterIndex * InputChannels + c) * 9;
+
+        float t[MLAS_WINOGRAD_INPUT_TILE][3];
+        float column[MLAS_WINOGRAD_INPUT_TILE];
+
+        for (size_t j = 0; j < 3; j++) {
+            MlasWinogradFilterTransform1D(g + j, 3, column);
+            for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+                t[i][j] = column[i];
+            }
+        }
+
+        float* u = TransformedFilter + FilterIndex * InputChannels + c;
+
+        for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+            MlasWinogradFilterTransform1D(t[i], 1, column);
+            for (size_t k = 0; k < MLAS_WINOGRAD_INPUT_TILE; k++) {
+                u[(i * MLAS_WINOGRAD_INPUT_TILE + k) * PositionStride] = column[k];
+            }
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute the blocks of tiles
+    of a group of a Winograd convolution assigned to the thread.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const ptrdiff_t PaddingTop = ptrdiff_t(Parameters->Padding[0]);
+    const ptrdiff_t PaddingLeft = ptrdiff_t(Parameters->Padding[1]);
+    const float Beta = Parameters->Beta;
+
+    const size_t TileBlock = Parameters->u.Winograd.TileBlock;
+    const size_t TilesW = MlasDivRoundup(OutputWidth, MLAS_WINOGRAD_OUTPUT_TILE);
+    const size_t TileCountTotal = MlasDivRoundup(OutputHeight, MLAS_WINOGRAD_OUTPUT_TILE) * TilesW;
+
+    //
+    // Each thread owns a buffer for the transformed input tiles and the
+    // products of a block of tiles.
+    //
+
+    float* TransformedInput = WorkBlock->WorkingBuffer +
+        size_t(Index) * MLAS_WINOGRAD_POSITIONS * (InputChannels + FilterCount) * TileBlock;
+    float* Products = TransformedInput + MLAS_WINOGRAD_POSITIONS * InputChannels * TileBlock;
+
+    const size_t InputPositionStride = InputChannels * TileBlock;
+    const size_t ProductPositionStride = FilterCount * TileBlock;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, Parameters->ThreadCount, Parameters->BatchCount * WorkBlock->TileBlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    for (size_t work = WorkIndex; work < WorkIndex + WorkRemaining; work++) {
+
+        const size_t batch = work / WorkBlock->TileBlockCount;
+        const size_t TileStart = (work % WorkBlock->TileBlockCount) * TileBlock;
+        const size_t TileCount = std::min(TileBlock, TileCountTotal - TileStart);
+
+        const float* input = WorkBlock->Input + batch * WorkBlock->InputBatchStride;
+        float* output = WorkBlock->Output + batch * WorkBlock->OutputBatchStride;
+
+        //
+        // Transform the input tiles: B^T d B.
+        //
+
+        for (size_t tb = 0; tb < TileCount; tb++) {
+
+            const size_t tile = TileStart + tb;
+            const ptrdiff_t ih0 = ptrdiff_t((tile / TilesW) * MLAS_WINOGRAD_OUTPUT_TILE) - PaddingTop;
+            const ptrdiff_t iw0 = ptrdiff_t((tile % TilesW) * MLAS_WINOGRAD_OUTPUT_TILE) - PaddingLeft;
+
+            const bool Interior = ih0 >= 0 && iw0 >= 0 &&
+                size_t(ih0) + MLAS_WINOGRAD_INPUT_TILE <= InputHeight &&
+                size_t(iw0) + MLAS_WINOGRAD_INPUT_TILE <= InputWidth;
+
+            float d[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+            float t[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                const float* channel = input + c * InputSize;
+                const float* source;
+                size_t SourceStride;
+
+                if (Interior) {
+                    source = channel + size_t(ih0) * InputWidth + size_t(iw0);
+                    SourceStride = InputWidth;
+                } else {
+                    for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+                        const ptrdiff_t ih = ih0 + ptrdiff_t(i);
+                        for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                            const ptrdiff_t iw = iw0 + ptrdiff_t(j);
+                            d[i][j] = (ih >= 0 && size_t(ih) < InputHeight && iw >= 0 && size_t(iw) < InputWidth)
+                                ? channel[size_t(ih) * InputWidth + size_t(iw)] : 0.0f;
+                        }
+                    }
+                    source = &d[0][0];
+                    SourceStride = MLAS_WINOGRAD_INPUT_TILE;
+                }
+
+                for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                    MlasWinogradInputTransform1D(source + j, SourceStride, &t[0][j], MLAS_WINOGRAD_INPUT_TILE);
+                }
+
+                float* v = TransformedInput + c * TileBlock + tb;
+
+                for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+                    MlasWinogradInputTransform1D(t[i], 1, v + i * MLAS_WINOGRAD_INPUT_TILE * InputPositionStride,
+                        InputPositionStride);
+                }
+            }
+        }
+
+        //
+        // Multiply the transformed filters with the transformed input tiles
+        // for each of the 36 positions.
+        //
+
+        for (size_t p = 0; p < MLAS_WINOGRAD_POSITIONS; p++) {
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount, InputChannels, 1.0f,
+                WorkBlock->TransformedFilter + p * FilterCount * InputChannels, InputChannels,
+                TransformedInput + p * InputPositionStride, TileBlock, 0.0f,
+                Products + p * ProductPositionStride, TileBlock, nullptr, 0, 0);
+        }
+
+        //
+        // Transform the products to the output tiles: A^T m A.
+        //
+
+        for (size_t tb = 0; tb < TileCount; tb++) {
+
+            const size_t tile = TileStart + tb;
+            const size_t oh0 = (tile / TilesW) * MLAS_WINOGRAD_OUTPUT_TILE;
+            const size_t ow0 = (tile % TilesW) * MLAS_WINOGRAD_OUTPUT_TILE;
+            const size_t rows = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputHeight - oh0);
+            const size_t columns = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputWidth - ow0);
+
+            float t[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+            float y[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_OUTPUT_TILE];
+
+            for (size_t f = 0; f < FilterCount; f++) {
+
+                const float* m = Products + f * TileBlock + tb;
+
+                for (size_t k = 0; k < MLAS_WINOGRAD_INPUT_TILE; k++) {
+                    MlasWinogradOutputTransform1D(m + k * ProductPositionStride,
+                        MLAS_WINOGRAD_INPUT_TILE * ProductPositionStride, &t[0][k], MLAS_WINOGRAD_INPUT_TILE);
+                }
+
+                for (size_t i = 0; i < MLAS_WINOGRAD_OUTPUT_TILE; i++) {
+                    MlasWinogradOutputTransform1D(t[i], 1, y[i], 1);
+                }
+
+                const float bias = (WorkBlock->Bias != nullptr) ? WorkBlock->Bias[f] : 0.0f;
+                float* out = output + f * OutputSize + oh0 * OutputWidth + ow0;
+
+                for (size_t i = 0; i < rows; i++) {
+                    for (size_t j = 0; j < columns; j++) {
+                        float value = y[i][j] + bias;
+                        if (Beta != 0.0f) {
+                            value += Beta * out[j];
+                        }
+                        out[j] = value;
+                    }
+                    out += OutputWidth;
+                }
+            }
+        }
+
+        //
+        // Apply the activation to each run of tiles in the same tile row. The
+        // bias has already been added.
+        //
+
+        if (Parameters->Activation->ActivationKind != MlasIdentityActivation) {
+
+            for (size_t tb = 0; tb < TileCount;) {
+
+                const size_t tile = TileStart + tb;
+                const size_t oh0 = (tile / TilesW) * MLAS_WINOGRAD_OUTPUT_TILE;
+                const size_t tw = tile % TilesW;
+                const size_t run = std::min(TilesW - tw, TileCount - tb);
+                const size_t ow0 = tw * MLAS_WINOGRAD_OUTPUT_TILE;
+                const size_t columns = std::min(run * MLAS_WINOGRAD_OUTPUT_TILE, OutputWidth - ow0);
+                const size_t rows = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputHeight - oh0);
+
+                for (size_t i = 0; i < rows; i++) {
+                    MlasActivation(Parameters->Activation, output + (oh0 + i) * OutputWidth + ow0, nullptr,
+                        FilterCount, columns, OutputSize);
+                }
+
+                tb += run;
+            }
+        }
+    }
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation using the Winograd
+    F(4x4, 3x3) algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvWinogradPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    const size_t InputGroupSize = InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * Parameters->OutputSize;
+    const size_t FilterGroupSize = FilterCount * InputChannels * 9;
+
+    const size_t TileCount = MlasDivRoundup(Parameters->OutputShape[0], MLAS_WINOGRAD_OUTPUT_TILE) *
+        MlasDivRoundup(Parameters->OutputShape[1], MLAS_WINOGRAD_OUTPUT_TILE);
+
+    //
+    // The transformed filters of the current group are followed by the buffers
+    // of the threads.
+    //
+
+    float* TransformedFilter = WorkingBuffer;
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.TransformedFilter = TransformedFilter;
+    WorkBlock.WorkingBuffer = TransformedFilter + MLAS_WINOGRAD_POSITIONS * FilterCount * InputChannels;
+    WorkBlock.InputBatchStride = GroupCount * InputGroupSize;
+    WorkBlock.OutputBatchStride = GroupCount * OutputGroupSize;
+    WorkBlock.TileBlockCount = MlasDivRoundup(TileCount, Parameters->u.Winograd.TileBlock);
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        const float* filter = Filter + group * FilterGroupSize;
+
+        MlasTrySimpleParallel(ThreadPool, ptrdiff_t(FilterCount), [&](ptrdiff_t f) {
+            MlasConvWinogradTransformFilter(filter, TransformedFilter, FilterCount, InputChannels, size_t(f));
+        });
+
+        WorkBlock.Input = Input + group * InputGroupSize;
+        WorkBlock.Bias = (Bias != nullptr) ? Bias + group * FilterCount : nullptr;
+        WorkBlock.Output = Output + group * OutputGroupSize;
+
+        MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+    }
+}
+
+bool
+MLASCALL
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the Winograd algorithm for a convolution prepared by
+    MlasConvPrepare if the convolution supports it and is expected to run
+    faster with it.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters computed by MlasConvPrepare. Updated if the Winograd
+        algorithm is selected.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer if the Winograd algorithm is selected.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the Winograd algorithm is selected, else false and the
+    parameters are unchanged.
+
+--*/
+{
+    if (Parameters->Dimensions != 2 ||
+        Parameters->KernelShape[0] != 3 || Parameters->KernelShape[1] != 3 ||
+        Parameters->StrideShape[0] != 1 || Parameters->StrideShape[1] != 1 ||
+        Parameters->DilationShape[0] != 1 || Parameters->DilationShape[1] != 1) {
+        return false;
+    }
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    if (InputChannels < MLAS_WINOGRAD_MINIMUM_CHANNELS || FilterCount < MLAS_WINOGRAD_MINIMUM_CHANNELS ||
+        Parameters->OutputShape[0] < MLAS_WINOGRAD_MINIMUM_OUTPUT ||
+        Parameters->OutputShape[1] < MLAS_WINOGRAD_MINIMUM_OUTPUT) {
+        return false;
+    }
+
+    //
+    // Size the blocks of tiles to the per thread buffer budget, then shrink
+    // them while there are fewer blocks than threads.
+    //
+
+    const size_t TileCount = MlasDivRoundup(Parameters->OutputShape[0], MLAS_WINOGRAD_OUTPUT_TILE) *
+        MlasDivRoundup(Parameters->OutputShape[1], MLAS_WINOGRAD_OUTPUT_TILE);
+    const size_t ThreadBufferPerTile = MLAS_WINOGRAD_POSITIONS * (InputChannels + FilterCount);
+
+    size_t TileBlock = MLAS_WINOGRAD_THREAD_BUFFER_SIZE / ThreadBufferPerTile;
+    TileBlock = std::max(TileBlock, MLAS_WINOGRAD_MINIMUM_TILE_BLOCK);
+    TileBlock = std::min(TileBlock, MLAS_WINOGRAD_MAXIMUM_TILE_BLOCK);
+    TileBlock = std::min(TileBlock, TileCount);
+
+    const size_t MaximumThreadCount = size_t(MlasGetMaximumThreadCount(ThreadPool));
+
+    while (TileBlock > MLAS_WINOGRAD_MINIMUM_TILE_BLOCK &&
+           Parameters->BatchCount * MlasDivRoundup(TileCount, TileBlock) < MaximumThreadCount) {
+        TileBlock = std::max(TileBlock / 2, MLAS_WINOGRAD_MINIMUM_TILE_BLOCK);
+    }
+
+    const size_t WorkCount = Parameters->BatchCount * MlasDivRoundup(TileCount, TileBlock);
+    const size_t ThreadCount = std::min(MaximumThreadCount, WorkCount);
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = ptrdiff_t(ThreadCount);
+    Parameters->u.Winograd.TileBlock = TileBlock;
+
+    *WorkingBufferSize = MLAS_WINOGRAD_POSITIONS * FilterCount * InputChannels +
+        ThreadCount * ThreadBufferPerTile * TileBlock;
+
+    return true;
+}
@@ -21,7 +21,7 @@ Abstract:
 
 #ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
 
-// TODO!! Add intel fp16 implementations
+#if defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM64EC)
 
 typedef float16x8_t MLAS_FLOAT16X8;
 typedef float16x4_t MLAS_FLOAT16X4;
@@ -176,19 +176,66 @@ MlasMultiplyAddFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2, MLAS_FL
     return vfma_f16(Vector3, Vector1, Vector2);
 }
 
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasNegateMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, MLAS_FLOAT16X8 Vector3)
+{
+    return vfmsq_f16(Vector3, Vector1, Vector2);
+}
 
 MLAS_FORCEINLINE
-void
-MlasMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, _mlas_fp16_ Scalar2, MLAS_FLOAT16X8 Vector3)
+MLAS_FLOAT16X4
+MlasNegateMultiplyAddFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2, MLAS_FLOAT16X4 Vector3)
 {
-    MlasMultiplyAddFloat16x8(Vector1, MlasBroadcastFloat16x8(Scalar2), Vector3);
+    return vfms_f16(Vector3, Vector1, Vector2);
 }
 
 MLAS_FORCEINLINE
-void
-MlasMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, _mlas_fp16_ Scalar3)
+MLAS_FLOAT16X8
+MlasAbsFloat16x8(MLAS_FLOAT16X8 Vector)
 {
-    MlasMultiplyAddFloat16x8(Vector1, Vector2, MlasBroadcastFloat16x8(Scalar3));
+    return vabsq_f16(Vector);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasAbsFloat16x4(MLAS_FLOAT16X4 Vector)
+{
+    return vabs_f16(Vector);
+}
+
+/**
+ * @brief Shift the bits of each element left, e.g. to move an integer
+ *        into the exponent field.
+ */
+template <unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasShiftLeftFloat16x8(MLAS_FLOAT16X8 Vector)
+{
+    return vreinterpretq_f16_s16(vshlq_n_s16(vreinterpretq_s16_f16(Vector), ShiftCount));
+}
+
+template <unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasShiftLeftFloat16x4(MLAS_FLOAT16X4 Vector)
+{
+    return vreinterpret_f16_s16(vshl_n_s16(vreinterpret_s16_f16(Vector), ShiftCount));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasCopySignFloat16x8(MLAS_FLOAT16X8 Magnitude, MLAS_FLOAT16X8 Sign)
+{
+    return vbslq_f16(vdupq_n_u16(0x8000), Sign, Magnitude);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasCopySignFloat16x4(MLAS_FLOAT16X4 Magnitude, MLAS_FLOAT16X4 Sign)
+{
+    return vbsl_f16(vdup_n_u16(0x8000), Sign, Magnitude);
 }
 
 MLAS_FORCEINLINE
@@ -233,14 +280,6 @@ MlasXorFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
     return vreinterpretq_f16_s32(veorq_s32(vreinterpretq_s32_f16(Vector1), vreinterpretq_s32_f16(Vector2)));
 }
 
-MLAS_FORCEINLINE
-MLAS_FLOAT16X8
-MlasBlendFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, MLAS_FLOAT16X8 Selection)
-{
-    return MlasOrFloat16x8(MlasAndFloat16x8(Vector2, Selection),
-                           MlasAndNotFloat16x8(Selection, Vector1));
-}
-
 MLAS_FORCEINLINE
 MLAS_FLOAT16X8
 MlasMaximumFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
@@ -269,15 +308,6 @@ MlasMinimumFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
     return vmin_f16(Vector1, Vector2);
 }
 
-MLAS_FORCEINLINE
-MLAS_FLOAT16X8
-MlasClampFloat16x8(MLAS_FLOAT16X8 Value, _mlas_fp16_ LowerRange, _mlas_fp16_ UpperRange)
-{
-    Value = MlasMaximumFloat16x8(MlasBroadcastFloat16x8(LowerRange), Value);
-    Value = MlasMinimumFloat16x8(MlasBroadcastFloat16x8(UpperRange), Value);
-    return Value;
-}
-
 MLAS_FORCEINLINE
 _mlas_fp16_
 MlasReduceAddFloat16x8(MLAS_FLOAT16X8 Vector)
@@ -301,6 +331,20 @@ MlasCmpLessEqualFloat16x4(MLAS_FLOAT16X4 left, MLAS_FLOAT16X4 right)
     return vcle_f16(left, right);
 }
 
+MLAS_FORCEINLINE
+MLAS_UINT16X8
+MlasCmpLessThanFloat16x8(MLAS_FLOAT16X8 left, MLAS_FLOAT16X8 right)
+{
+    return vcltq_f16(left, right);
+}
+
+MLAS_FORCEINLINE
+MLAS_UINT16X4
+MlasCmpLessThanFloat16x4(MLAS_FLOAT16X4 left, MLAS_FLOAT16X4 right)
+{
+    return vclt_f16(left, right);
+}
+
 MLAS_FORCEINLINE
 MLAS_FLOAT16X8
 MlasBitwiseSelectFloat16x8(MLAS_UINT16X8 select, MLAS_FLOAT16X8 ones, MLAS_FLOAT16X8 zeros)
@@ -315,4 +359,400 @@ MlasBitwiseSelectFloat16x4(MLAS_UINT16X4 select, MLAS_FLOAT16X4 ones, MLAS_FLOAT
     return vbsl_f16(select, ones, zeros);
 }
 
+#elif defined(MLAS_TARGET_AMD64)
+
+//
+// AVX512-FP16 implementations. The source files including this header are
+// compiled with AVX512-FP16/AVX512VL/AVX512BW enabled and must only be called
+// when MlasFp16AccelerationSupported() reports the processor supports them.
+//
+// The 4 element vectors use the low half of a 128-bit register, wrapped in
+// a structure so that the two vector types stay distinct for overloading.
+//
+
+typedef __m128h MLAS_FLOAT16X8;
+typedef __m128i MLAS_UINT16X8;
+typedef __m128i MLAS_UINT16X4;
+
+struct MLAS_FLOAT16X4 {
+    __m128h Value;
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasReinterpretAsFloat16x8(MLAS_INT32X4 Vector) { return _mm_castsi128_ph(Vector); }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasBroadcastFloat16x8(_mlas_fp16_ Value) { return _mm_castsi128_ph(_mm_set1_epi16(short(Value))); }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasBroadcastFloat16x4(_mlas_fp16_ Value) { return {MlasBroadcastFloat16x8(Value)}; }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasBroadcastFloat16x8(const _mlas_fp16_* Value) { return MlasBroadcastFloat16x8(*Value); }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasBroadcastFloat16x4(const _mlas_fp16_* Value) { return MlasBroadcastFloat16x4(*Value); }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasZeroFloat16x8(void) { return _mm_setzero_ph(); }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasZeroFloat16x4(void) { return {_mm_setzero_ph()}; }
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasLoadFloat16x8(const _mlas_fp16_* Buffer)
+{
+    return _mm_castsi128_ph(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Buffer)));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasLoadFloat16x4(const _mlas_fp16_* Buffer)
+{
+    return {_mm_castsi128_ph(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Buffer)))};
+}
+
+MLAS_FORCEINLINE
+void
+MlasStoreFloat16x8(_mlas_fp16_* Buffer, MLAS_FLOAT16X8 Vector)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Buffer), _mm_castph_si128(Vector));
+}
+
+MLAS_FORCEINLINE
+void
+MlasStoreFloat16x4(_mlas_fp16_* Buffer, MLAS_FLOAT16X4 Vector)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(Buffer), _mm_castph_si128(Vector.Value));
+}
+
+MLAS_FORCEINLINE
+void
+MlasStorePartialFloat16x4(_mlas_fp16_* Buffer, MLAS_FLOAT16X4 Vector, size_t len)
+{
+    _mm_mask_storeu_epi16(Buffer, __mmask8((1u << len) - 1), _mm_castph_si128(Vector.Value));
+}
+
+template <unsigned Lane>
+MLAS_FORCEINLINE void
+MlasStoreLaneFloat16x8(_mlas_fp16_* Buffer, MLAS_FLOAT16X8 Vector)
+{
+    *Buffer = _mlas_fp16_(_mm_extract_epi16(_mm_castph_si128(Vector), Lane));
+}
+
+MLAS_FORCEINLINE MLAS_FLOAT16X4
+MlasToLowHalfFloat16x4(MLAS_FLOAT16X8 V)
+{
+    return {V};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasAddFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_add_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasAddFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
+{
+    return {_mm_add_ph(Vector1.Value, Vector2.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasSubtractFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_sub_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasSubtractFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
+{
+    return {_mm_sub_ph(Vector1.Value, Vector2.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasMultiplyFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_mul_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasMultiplyFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
+{
+    return {_mm_mul_ph(Vector1.Value, Vector2.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasDivFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_div_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasDivFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
+{
+    return {_mm_div_ph(Vector1.Value, Vector2.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, MLAS_FLOAT16X8 Vector3)
+{
+    return _mm_fmadd_ph(Vector1, Vector2, Vector3);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasMultiplyAddFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2, MLAS_FLOAT16X4 Vector3)
+{
+    return {_mm_fmadd_ph(Vector1.Value, Vector2.Value, Vector3.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasNegateMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, MLAS_FLOAT16X8 Vector3)
+{
+    return _mm_fnmadd_ph(Vector1, Vector2, Vector3);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasNegateMultiplyAddFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2, MLAS_FLOAT16X4 Vector3)
+{
+    return {_mm_fnmadd_ph(Vector1.Value, Vector2.Value, Vector3.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasAbsFloat16x8(MLAS_FLOAT16X8 Vector)
+{
+    return _mm_abs_ph(Vector);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasAbsFloat16x4(MLAS_FLOAT16X4 Vector)
+{
+    return {_mm_abs_ph(Vector.Value)};
+}
+
+/**
+ * @brief Shift the bits of each element left, e.g. to move an integer
+ *        into the exponent field.
+ */
+template <unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasShiftLeftFloat16x8(MLAS_FLOAT16X8 Vector)
+{
+    return _mm_castsi128_ph(_mm_slli_epi16(_mm_castph_si128(Vector), ShiftCount));
+}
+
+template <unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasShiftLeftFloat16x4(MLAS_FLOAT16X4 Vector)
+{
+    return {MlasShiftLeftFloat16x8<ShiftCount>(Vector.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasDivideFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_div_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasGreaterThanFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_castsi128_ph(_mm_movm_epi16(_mm_cmp_ph_mask(Vector1, Vector2, _CMP_GT_OQ)));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasAndFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_castsi128_ph(_mm_and_si128(_mm_castph_si128(Vector1), _mm_castph_si128(Vector2)));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasOrFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_castsi128_ph(_mm_or_si128(_mm_castph_si128(Vector1), _mm_castph_si128(Vector2)));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasAndNotFloat16x8(MLAS_FLOAT16X8 VectorNot, MLAS_FLOAT16X8 Vector)
+{
+    return _mm_castsi128_ph(_mm_andnot_si128(_mm_castph_si128(VectorNot), _mm_castph_si128(Vector)));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasXorFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_castsi128_ph(_mm_xor_si128(_mm_castph_si128(Vector1), _mm_castph_si128(Vector2)));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasCopySignFloat16x8(MLAS_FLOAT16X8 Magnitude, MLAS_FLOAT16X8 Sign)
+{
+    // Take the sign bit from Sign and the other bits from Magnitude.
+    return _mm_castsi128_ph(_mm_ternarylogic_epi32(_mm_set1_epi16(short(0x8000)),
+                                                   _mm_castph_si128(Sign),
+                                                   _mm_castph_si128(Magnitude), 0xCA));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasCopySignFloat16x4(MLAS_FLOAT16X4 Magnitude, MLAS_FLOAT16X4 Sign)
+{
+    return {MlasCopySignFloat16x8(Magnitude.Value, Sign.Value)};
+}
+
+//
+// N.B. The maximum and minimum instructions return the second operand when
+// either operand is a NaN, so callers pass the value that should propagate
+// NaNs as the second argument.
+//
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasMaximumFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_max_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasMaximumFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
+{
+    return {_mm_max_ph(Vector1.Value, Vector2.Value)};
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasMinimumFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2)
+{
+    return _mm_min_ph(Vector1, Vector2);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasMinimumFloat16x4(MLAS_FLOAT16X4 Vector1, MLAS_FLOAT16X4 Vector2)
+{
+    return {_mm_min_ph(Vector1.Value, Vector2.Value)};
+}
+
+MLAS_FORCEINLINE
+_mlas_fp16_
+MlasReduceAddFloat16x8(MLAS_FLOAT16X8 Vector)
+{
+    Vector = _mm_add_ph(Vector, _mm_castsi128_ph(_mm_srli_si128(_mm_castph_si128(Vector), 8)));
+    Vector = _mm_add_ph(Vector, _mm_castsi128_ph(_mm_srli_si128(_mm_castph_si128(Vector), 4)));
+    Vector = _mm_add_ph(Vector, _mm_castsi128_ph(_mm_srli_si128(_mm_castph_si128(Vector), 2)));
+    return _mlas_fp16_(_mm_extract_epi16(_mm_castph_si128(Vector), 0));
+}
+
+MLAS_FORCEINLINE
+MLAS_UINT16X8
+MlasCmpLessEqualFloat16x8(MLAS_FLOAT16X8 left, MLAS_FLOAT16X8 right)
+{
+    return _mm_movm_epi16(_mm_cmp_ph_mask(left, right, _CMP_LE_OQ));
+}
+
+MLAS_FORCEINLINE
+MLAS_UINT16X4
+MlasCmpLessEqualFloat16x4(MLAS_FLOAT16X4 left, MLAS_FLOAT16X4 right)
+{
+    return MlasCmpLessEqualFloat16x8(left.Value, right.Value);
+}
+
+MLAS_FORCEINLINE
+MLAS_UINT16X8
+MlasCmpLessThanFloat16x8(MLAS_FLOAT16X8 left, MLAS_FLOAT16X8 right)
+{
+    return _mm_movm_epi16(_mm_cmp_ph_mask(left, right, _CMP_LT_OQ));
+}
+
+MLAS_FORCEINLINE
+MLAS_UINT16X4
+MlasCmpLessThanFloat16x4(MLAS_FLOAT16X4 left, MLAS_FLOAT16X4 right)
+{
+    return MlasCmpLessThanFloat16x8(left.Value, right.Value);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasBitwiseSelectFloat16x8(MLAS_UINT16X8 select, MLAS_FLOAT16X8 ones, MLAS_FLOAT16X8 zeros)
+{
+    return _mm_castsi128_ph(
+        _mm_ternarylogic_epi32(select, _mm_castph_si128(ones), _mm_castph_si128(zeros), 0xCA));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+MlasBitwiseSelectFloat16x4(MLAS_UINT16X4 select, MLAS_FLOAT16X4 ones, MLAS_FLOAT16X4 zeros)
+{
+    return {MlasBitwiseSelectFloat16x8(select, ones.Value, zeros.Value)};
+}
+
+#endif  // target architecture
+
+//
+// Helpers composed from the target specific primitives above.
+//
+
+MLAS_FORCEINLINE
+void
+MlasMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, _mlas_fp16_ Scalar2, MLAS_FLOAT16X8 Vector3)
+{
+    MlasMultiplyAddFloat16x8(Vector1, MlasBroadcastFloat16x8(Scalar2), Vector3);
+}
+
+MLAS_FORCEINLINE
+void
+MlasMultiplyAddFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, _mlas_fp16_ Scalar3)
+{
+    MlasMultiplyAddFloat16x8(Vector1, Vector2, MlasBroadcastFloat16x8(Scalar3));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasBlendFloat16x8(MLAS_FLOAT16X8 Vector1, MLAS_FLOAT16X8 Vector2, MLAS_FLOAT16X8 Selection)
+{
+    return MlasOrFloat16x8(MlasAndFloat16x8(Vector2, Selection),
+                           MlasAndNotFloat16x8(Selection, Vector1));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+MlasClampFloat16x8(MLAS_FLOAT16X8 Value, _mlas_fp16_ LowerRange, _mlas_fp16_ UpperRange)
+{
+    Value = MlasMaximumFloat16x8(MlasBroadcastFloat16x8(LowerRange), Value);
+    Value = MlasMinimumFloat16x8(MlasBroadcastFloat16x8(UpperRange), Value);
+    return Value;
+}
+
 #endif  // fp16 vector intrinsic supported
@@ -0,0 +1,182 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gather.cpp
+
+Abstract:
+
+    This module implements routines to gather 32-bit elements by index.
+
+--*/
+
+#include "mlasi.h"
+
+template<typename IndexType>
+bool
+MLASCALL
+MlasGatherKernel(
+    const uint32_t* Input,
+    const IndexType* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the portable form of the gather kernel.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Indices - Supplies the indices along the gathered axis.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to gather.
+
+    AxisSize - Supplies the size of the gathered axis, used to resolve and
+        validate the indices.
+
+    IndexStride - Supplies the distance in elements between consecutive
+        positions of the gathered axis.
+
+    ElementStride - Supplies the distance in elements added to the input
+        offset for each output element.
+
+Return Value:
+
+    Returns false if an index is out of range, else true.
+
+--*/
+{
+    for (size_t i = 0; i < N; i++) {
+
+        int64_t Index = int64_t(Indices[i]);
+
+        if (Index < 0) {
+            Index += AxisSize;
+        }
+
+        if (uint64_t(Index) >= uint64_t(AxisSize)) {
+            return false;
+        }
+
+        Output[i] = Input[size_t(Index) * IndexStride + i * ElementStride];
+    }
+
+    return true;
+}
+
+template
+bool
+MLASCALL
+MlasGatherKernel<int32_t>(
+    const uint32_t* Input,
+    const int32_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
+template
+bool
+MLASCALL
+MlasGatherKernel<int64_t>(
+    const uint32_t* Input,
+    const int64_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
+bool
+MLASCALL
+MlasGather(
+    const uint32_t* Input,
+    const int32_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    )
+/*++
+
+Routine Description:
+
+    This routine gathers 32-bit elements using 32-bit indices:
+
+        Output[i] = Input[Indices[i] * IndexStride + i * ElementStride]
+
+    Negative indices are relative to AxisSize.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Indices - Supplies the indices along the gathered axis.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to gather.
+
+    AxisSize - Supplies the size of the gathered axis.
+
+    IndexStride - Supplies the distance in elements between consecutive
+        positions of the gathered axis.
+
+    ElementStride - Supplies the distance in elements added to the input
+        offset for each output element.
+
+Return Value:
+
+    Returns false if an index is outside [-AxisSize, AxisSize), else true.
+
+--*/
+{
+    return GetMlasPlatform().GatherS32Kernel(Input, Indices, Output, N, AxisSize, IndexStride, ElementStride);
+}
+
+bool
+MLASCALL
+MlasGather(
+    const uint32_t* Input,
+    const int64_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    )
+/*++
+
+Routine Description:
+
+    This routine gathers 32-bit elements using 64-bit indices.
+
+Arguments:
+
+    See the 32-bit index form above.
+
+Return Value:
+
+    Returns false if an index is outside [-AxisSize, AxisSize), else true.
+
+--*/
+{
+    return GetMlasPlatform().GatherS64Kernel(Input, Indices, Output, N, AxisSize, IndexStride, ElementStride);
+}
@@ -0,0 +1,349 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM kernel for processors
+    with AVX2, FMA3 and F16C.
+
+    The processors have no half precision arithmetic, so the kernel converts
+    the inputs to single precision with F16C and uses single precision FMA,
+    rounding the accumulators to half precision after each step like the
+    other half precision kernels.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#if defined(MLAS_HALFGEMM_AVX2_KERNELS)
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Number of columns computed by one iteration of the kernel.
+//
+constexpr size_t MLAS_HALF_GEMM_AVX2_STRIDE_N = 16;
+
+//
+// Number of elements of a row of matrix A converted by one iteration.
+//
+constexpr size_t MLAS_HALF_GEMM_AVX2_STRIDE_K = 8;
+
+MLAS_FORCEINLINE
+void
+CvtFloat2HalfAvx2(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= 8) {
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), half);
+        src += 8;
+        dest += 8;
+        len -= 8;
+    }
+
+    if (len > 0) {
+        float buf[8] = {};
+        std::memcpy(buf, src, len * sizeof(float));
+        _mlas_fp16_ res[8];
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(buf), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(res), half);
+        std::memcpy(dest, res, len * sizeof(_mlas_fp16_));
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2DAvx2(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        CvtFloat2HalfAvx2(dest, src, CntRow * CntCol);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2HalfAvx2(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2DAvx2(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2DAvx2(D, B, ldb, CountK, CountN);
+}
+
+/**
+ * @brief Load up to 16 fp16 values as two vectors of fp32. Partial loads
+ *        stay within the buffer and fill the remaining lanes with zeros.
+ */
+template<bool Partial>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmLoadAvx2(
+    const _mlas_fp16_* Buffer,
+    size_t Count,
+    __m256& Low,
+    __m256& High
+    )
+{
+    _mlas_fp16_ buf[MLAS_HALF_GEMM_AVX2_STRIDE_N];
+    if (Partial) {
+        std::memset(buf, 0, sizeof(buf));
+        std::memcpy(buf, Buffer, Count * sizeof(_mlas_fp16_));
+        Buffer = buf;
+    }
+
+    Low = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Buffer)));
+    High = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Buffer + 8)));
+}
+
+template<bool Partial>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmStoreAvx2(
+    _mlas_fp16_* Buffer,
+    size_t Count,
+    __m256 Low,
+    __m256 High
+    )
+{
+    const __m128i LowHalf = _mm256_cvtps_ph(Low, _MM_FROUND_TO_NEAREST_INT);
+    const __m128i HighHalf = _mm256_cvtps_ph(High, _MM_FROUND_TO_NEAREST_INT);
+
+    if (Partial) {
+        _mlas_fp16_ buf[MLAS_HALF_GEMM_AVX2_STRIDE_N];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buf), LowHalf);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + 8), HighHalf);
+        std::memcpy(Buffer, buf, Count * sizeof(_mlas_fp16_));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Buffer), LowHalf);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Buffer + 8), HighHalf);
+    }
+}
+
+/**
+ * @brief Round the single precision accumulator to half precision after each
+ *        step, so the results match the other half precision kernels, which
+ *        accumulate in half precision.
+ */
+MLAS_FORCEINLINE
+__m256
+MlasHalfGemmRoundAvx2(__m256 Vector)
+{
+    return _mm256_cvtph_ps(_mm256_cvtps_ph(Vector, _MM_FROUND_TO_NEAREST_INT));
+}
+
+/**
+ * @brief Compute RowCount rows by up to 16 columns of the output.
+ */
+template<size_t RowCount, bool Partial>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmBlockAvx2(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    __m256 Accumulators[RowCount][2];
+
+    __m256 BiasLow = _mm256_setzero_ps();
+    __m256 BiasHigh = _mm256_setzero_ps();
+    if (Bias != nullptr) {
+        MlasHalfGemmLoadAvx2<Partial>(Bias, CountN, BiasLow, BiasHigh);
+    }
+
+    for (size_t Row = 0; Row < RowCount; Row++) {
+        Accumulators[Row][0] = BiasLow;
+        Accumulators[Row][1] = BiasHigh;
+        if (!ZeroMode) {
+            __m256 Low, High;
+            MlasHalfGemmLoadAvx2<Partial>(C + Row * ldc, CountN, Low, High);
+            Accumulators[Row][0] = _mm256_add_ps(Accumulators[Row][0], Low);
+            Accumulators[Row][1] = _mm256_add_ps(Accumulators[Row][1], High);
+        }
+    }
+
+    //
+    // Convert a block of each row of A to fp32 so that the inner loop can
+    // broadcast the elements from memory.
+    //
+
+    MLAS_DECLSPEC_ALIGN(float ABlock[RowCount][MLAS_HALF_GEMM_AVX2_STRIDE_K], 32);
+
+    for (size_t k = 0; k < CountK; k += MLAS_HALF_GEMM_AVX2_STRIDE_K) {
+        const size_t CountBlockK = std::min(CountK - k, MLAS_HALF_GEMM_AVX2_STRIDE_K);
+
+        for (size_t Row = 0; Row < RowCount; Row++) {
+            const _mlas_fp16_* a = A + Row * lda + k;
+            __m128i AHalf;
+            if (CountBlockK == MLAS_HALF_GEMM_AVX2_STRIDE_K) {
+                AHalf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+            } else {
+                _mlas_fp16_ buf[MLAS_HALF_GEMM_AVX2_STRIDE_K] = {};
+                std::memcpy(buf, a, CountBlockK * sizeof(_mlas_fp16_));
+                AHalf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+            }
+            _mm256_store_ps(ABlock[Row], _mm256_cvtph_ps(AHalf));
+        }
+
+        const _mlas_fp16_* b = B + k * ldb;
+
+        for (size_t kk = 0; kk < CountBlockK; kk++) {
+            __m256 BLow, BHigh;
+            MlasHalfGemmLoadAvx2<Partial>(b, CountN, BLow, BHigh);
+
+            for (size_t Row = 0; Row < RowCount; Row++) {
+                const __m256 ABroadcast = _mm256_broadcast_ss(&ABlock[Row][kk]);
+                Accumulators[Row][0] = MlasHalfGemmRoundAvx2(
+                    _mm256_fmadd_ps(ABroadcast, BLow, Accumulators[Row][0]));
+                Accumulators[Row][1] = MlasHalfGemmRoundAvx2(
+                    _mm256_fmadd_ps(ABroadcast, BHigh, Accumulators[Row][1]));
+            }
+
+            b += ldb;
+        }
+    }
+
+    for (size_t Row = 0; Row < RowCount; Row++) {
+        MlasHalfGemmStoreAvx2<Partial>(C + Row * ldc, CountN, Accumulators[Row][0], Accumulators[Row][1]);
+    }
+}
+
+template<size_t RowCount>
+void
+MlasHalfGemmRowsAvx2(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    while (CountN >= MLAS_HALF_GEMM_AVX2_STRIDE_N) {
+        MlasHalfGemmBlockAvx2<RowCount, false>(
+            MLAS_HALF_GEMM_AVX2_STRIDE_N, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+        C += MLAS_HALF_GEMM_AVX2_STRIDE_N;
+        B += MLAS_HALF_GEMM_AVX2_STRIDE_N;
+        if (Bias != nullptr) {
+            Bias += MLAS_HALF_GEMM_AVX2_STRIDE_N;
+        }
+        CountN -= MLAS_HALF_GEMM_AVX2_STRIDE_N;
+    }
+
+    if (CountN > 0) {
+        MlasHalfGemmBlockAvx2<RowCount, true>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmRowsAvx2<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmRowsAvx2<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmRowsAvx2<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmRowsAvx2<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmRowsAvx2<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmRowsAvx2<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0
+};
+
+#endif  // defined(MLAS_HALFGEMM_AVX2_KERNELS)
@@ -0,0 +1,278 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM kernel for processors
+    with AVX512-FP16.
+
+    Like the NEON kernel, the products are accumulated in half precision.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Number of fp16 elements of a vector.
+//
+constexpr size_t MLAS_HALF_GEMM_AVX512FP16_VECTOR = 32;
+
+MLAS_FORCEINLINE
+void
+CvtFloat2HalfAvx512Fp16(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= 16) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),
+                            _mm512_cvtps_ph(_mm512_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT));
+        src += 16;
+        dest += 16;
+        len -= 16;
+    }
+
+    if (len > 0) {
+        const __mmask16 mask = __mmask16((1u << len) - 1);
+        _mm256_mask_storeu_epi16(dest, mask,
+                                 _mm512_cvtps_ph(_mm512_maskz_loadu_ps(mask, src), _MM_FROUND_TO_NEAREST_INT));
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2DAvx512Fp16(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        CvtFloat2HalfAvx512Fp16(dest, src, CntRow * CntCol);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2HalfAvx512Fp16(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2DAvx512Fp16(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2DAvx512Fp16(D, B, ldb, CountK, CountN);
+}
+
+MLAS_FORCEINLINE
+__m512h
+MlasHalfGemmLoadAvx512Fp16(const _mlas_fp16_* Buffer, __mmask32 Mask)
+{
+    return _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Mask, Buffer));
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmStoreAvx512Fp16(_mlas_fp16_* Buffer, __mmask32 Mask, __m512h Vector)
+{
+    _mm512_mask_storeu_epi16(Buffer, Mask, _mm512_castph_si512(Vector));
+}
+
+/**
+ * @brief Compute RowCount rows by up to VectorCount vectors of columns of
+ *        the output. Mask selects the columns of the last vector.
+ */
+template<size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmBlockAvx512Fp16(
+    __mmask32 Mask,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    __mmask32 Masks[VectorCount];
+    for (size_t v = 0; v < VectorCount; v++) {
+        Masks[v] = (v + 1 == VectorCount) ? Mask : __mmask32(0xFFFFFFFF);
+    }
+
+    __m512h Accumulators[RowCount][VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        const __m512h BiasVector = (Bias == nullptr)
+            ? _mm512_setzero_ph()
+            : MlasHalfGemmLoadAvx512Fp16(Bias + v * MLAS_HALF_GEMM_AVX512FP16_VECTOR, Masks[v]);
+        for (size_t Row = 0; Row < RowCount; Row++) {
+            Accumulators[Row][v] = BiasVector;
+            if (!ZeroMode) {
+                const __m512h CVector = MlasHalfGemmLoadAvx512Fp16(
+                    C + Row * ldc + v * MLAS_HALF_GEMM_AVX512FP16_VECTOR, Masks[v]);
+                Accumulators[Row][v] = _mm512_add_ph(Accumulators[Row][v], CVector);
+            }
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+        __m512h BVectors[VectorCount];
+        for (size_t v = 0; v < VectorCount; v++) {
+            BVectors[v] = MlasHalfGemmLoadAvx512Fp16(B + v * MLAS_HALF_GEMM_AVX512FP16_VECTOR, Masks[v]);
+        }
+
+        for (size_t Row = 0; Row < RowCount; Row++) {
+            const __m512h ABroadcast = _mm512_castsi512_ph(_mm512_set1_epi16(short(A[Row * lda + k])));
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[Row][v] = _mm512_fmadd_ph(ABroadcast, BVectors[v], Accumulators[Row][v]);
+            }
+        }
+
+        B += ldb;
+    }
+
+    for (size_t Row = 0; Row < RowCount; Row++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            MlasHalfGemmStoreAvx512Fp16(C + Row * ldc + v * MLAS_HALF_GEMM_AVX512FP16_VECTOR, Masks[v],
+                                        Accumulators[Row][v]);
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasHalfGemmRowsAvx512Fp16(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    constexpr size_t StrideN = 2 * MLAS_HALF_GEMM_AVX512FP16_VECTOR;
+
+    while (CountN >= StrideN) {
+        MlasHalfGemmBlockAvx512Fp16<RowCount, 2>(
+            __mmask32(0xFFFFFFFF), CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+        C += StrideN;
+        B += StrideN;
+        if (Bias != nullptr) {
+            Bias += StrideN;
+        }
+        CountN -= StrideN;
+    }
+
+    if (CountN > MLAS_HALF_GEMM_AVX512FP16_VECTOR) {
+        const __mmask32 Mask = __mmask32(0xFFFFFFFF >> (StrideN - CountN));
+        MlasHalfGemmBlockAvx512Fp16<RowCount, 2>(Mask, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+    } else if (CountN > 0) {
+        const __mmask32 Mask = __mmask32(0xFFFFFFFF >> (MLAS_HALF_GEMM_AVX512FP16_VECTOR - CountN));
+        MlasHalfGemmBlockAvx512Fp16<RowCount, 1>(Mask, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmRowsAvx512Fp16<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmRowsAvx512Fp16<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmRowsAvx512Fp16<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmRowsAvx512Fp16<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmRowsAvx512Fp16<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmRowsAvx512Fp16<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0
+};
+
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
@@ -0,0 +1,233 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gather_avx2.cpp
+
+Abstract:
+
+    This module implements the kernels to gather 32-bit elements by index.
+
+    This implementation uses AVX2 instructions.
+
+--*/
+
+#include "mlasi.h"
+
+#if defined(MLAS_GATHER_AVX2_KERNELS)
+
+template<typename IndexType>
+MLAS_FORCEINLINE
+__m256i
+MlasGatherLoadIndicesAvx2(
+    const IndexType* Indices,
+    int64_t AxisSize,
+    __m256i& Invalid
+    );
+
+template<>
+MLAS_FORCEINLINE
+__m256i
+MlasGatherLoadIndicesAvx2<int32_t>(
+    const int32_t* Indices,
+    int64_t AxisSize,
+    __m256i& Invalid
+    )
+/*++
+
+Routine Description:
+
+    This routine loads eight 32-bit indices, resolves the negative indices and
+    accumulates the lanes that are out of range into Invalid.
+
+--*/
+{
+    const __m256i ZeroVector = _mm256_setzero_si256();
+    const __m256i AxisSizeVector = _mm256_set1_epi32(int32_t(AxisSize));
+
+    __m256i IndexVector = _mm256_loadu_si256((const __m256i*)Indices);
+
+    IndexVector = _mm256_add_epi32(IndexVector,
+        _mm256_and_si256(_mm256_cmpgt_epi32(ZeroVector, IndexVector), AxisSizeVector));
+
+    Invalid = _mm256_or_si256(Invalid, _mm256_cmpgt_epi32(ZeroVector, IndexVector));
+    Invalid = _mm256_or_si256(Invalid,
+        _mm256_cmpgt_epi32(IndexVector, _mm256_sub_epi32(AxisSizeVector, _mm256_set1_epi32(1))));
+
+    return IndexVector;
+}
+
+template<>
+MLAS_FORCEINLINE
+__m256i
+MlasGatherLoadIndicesAvx2<int64_t>(
+    const int64_t* Indices,
+    int64_t AxisSize,
+    __m256i& Invalid
+    )
+/*++
+
+Routine Description:
+
+    This routine loads eight 64-bit indices, resolves the negative indices,
+    accumulates the lanes that are out of range into Invalid and narrows the
+    indices to 32 bits.
+
+--*/
+{
+    const __m256i ZeroVector = _mm256_setzero_si256();
+    const __m256i AxisSizeVector = _mm256_set1_epi64x(AxisSize);
+    const __m256i AxisLimitVector = _mm256_set1_epi64x(AxisSize - 1);
+    const __m256i PackLowDwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+    __m256i IndexVector0 = _mm256_loadu_si256((const __m256i*)Indices);
+    __m256i IndexVector1 = _mm256_loadu_si256((const __m256i*)(Indices + 4));
+
+    IndexVector0 = _mm256_add_epi64(IndexVector0,
+        _mm256_and_si256(_mm256_cmpgt_epi64(ZeroVector, IndexVector0), AxisSizeVector));
+    IndexVector1 = _mm256_add_epi64(IndexVector1,
+        _mm256_and_si256(_mm256_cmpgt_epi64(ZeroVector, IndexVector1), AxisSizeVector));
+
+    Invalid = _mm256_or_si256(Invalid, _mm256_cmpgt_epi64(ZeroVector, IndexVector0));
+    Invalid = _mm256_or_si256(Invalid, _mm256_cmpgt_epi64(ZeroVector, IndexVector1));
+    Invalid = _mm256_or_si256(Invalid, _mm256_cmpgt_epi64(IndexVector0, AxisLimitVector));
+    Invalid = _mm256_or_si256(Invalid, _mm256_cmpgt_epi64(IndexVector1, AxisLimitVector));
+
+    IndexVector0 = _mm256_permutevar8x32_epi32(IndexVector0, PackLowDwords);
+    IndexVector1 = _mm256_permutevar8x32_epi32(IndexVector1, PackLowDwords);
+
+    return _mm256_permute2x128_si256(IndexVector0, IndexVector1, 0x20);
+}
+
+template<typename IndexType>
+bool
+MLASCALL
+MlasGatherKernelAvx2(
+    const uint32_t* Input,
+    const IndexType* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the gather kernel with the AVX2 gather
+    instruction. The element offsets are computed in 32-bit lanes, so inputs
+    that span more than 2^31 elements use the portable kernel.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Indices - Supplies the indices along the gathered axis.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to gather.
+
+    AxisSize - Supplies the size of the gathered axis, used to resolve and
+        validate the indices.
+
+    IndexStride - Supplies the distance in elements between consecutive
+        positions of the gathered axis.
+
+    ElementStride - Supplies the distance in elements added to the input
+        offset for each output element.
+
+Return Value:
+
+    Returns false if an index is out of range, else true.
+
+--*/
+{
+    constexpr uint64_t MaximumOffset = uint64_t(std::numeric_limits<int32_t>::max());
+
+    if (N < 8 || AxisSize <= 0 || uint64_t(AxisSize) > MaximumOffset ||
+        IndexStride > MaximumOffset || ElementStride > MaximumOffset / N ||
+        (uint64_t(AxisSize) - 1) * IndexStride > MaximumOffset - (N - 1) * ElementStride) {
+        return MlasGatherKernel<IndexType>(Input, Indices, Output, N, AxisSize, IndexStride, ElementStride);
+    }
+
+    const __m256i IndexStrideVector = _mm256_set1_epi32(int32_t(IndexStride));
+    const __m256i ElementStepVector = _mm256_set1_epi32(int32_t(ElementStride * 8));
+    __m256i ElementOffsetVector = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(int32_t(ElementStride)));
+
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8) {
+
+        __m256i Invalid = _mm256_setzero_si256();
+        __m256i IndexVector = MlasGatherLoadIndicesAvx2<IndexType>(Indices + i, AxisSize, Invalid);
+
+        if (!_mm256_testz_si256(Invalid, Invalid)) {
+            return false;
+        }
+
+        __m256i OffsetVector = ElementOffsetVector;
+
+        if (IndexStride == 1) {
+            OffsetVector = _mm256_add_epi32(OffsetVector, IndexVector);
+        } else {
+            OffsetVector = _mm256_add_epi32(OffsetVector, _mm256_mullo_epi32(IndexVector, IndexStrideVector));
+        }
+
+        __m256i OutputVector = _mm256_i32gather_epi32((const int*)Input, OffsetVector, 4);
+        _mm256_storeu_si256((__m256i*)(Output + i), OutputVector);
+
+        ElementOffsetVector = _mm256_add_epi32(ElementOffsetVector, ElementStepVector);
+    }
+
+    for (; i < N; i++) {
+
+        int64_t Index = int64_t(Indices[i]);
+
+        if (Index < 0) {
+            Index += AxisSize;
+        }
+
+        if (uint64_t(Index) >= uint64_t(AxisSize)) {
+            return false;
+        }
+
+        Output[i] = Input[size_t(Index) * IndexStride + i * ElementStride];
+    }
+
+    return true;
+}
+
+template
+bool
+MLASCALL
+MlasGatherKernelAvx2<int32_t>(
+    const uint32_t* Input,
+    const int32_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
+template
+bool
+MLASCALL
+MlasGatherKernelAvx2<int64_t>(
+    const uint32_t* Input,
+    const int64_t* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
+#endif  // defined(MLAS_GATHER_AVX2_KERNELS)
@@ -0,0 +1,192 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qdwconv_avx512vnni.cpp
+
+Abstract:
+
+    This module implements the quantized integer depthwise convolution kernels.
+
+    This implementation uses AVX512VNNI instructions.
+
+    A depthwise convolution has no reduction along the channel dimension, so
+    the 16-bit pairs consumed by VPDPWSSD are formed from two adjacent kernel
+    positions of the same channel. Each iteration accumulates two taps of 16
+    channels with a single instruction and the remaining channels are handled
+    with masked loads and stores.
+
+--*/
+
+#include "mlasi.h"
+
+#if defined(MLAS_QDWCONV_AVX512VNNI_KERNELS)
+
+//
+// Loads 16 channels of a tap, extends them to 32 bits and subtracts the zero
+// point. The result fits in the low 16 bits of each element.
+//
+
+template<typename ElementType>
+MLAS_FORCEINLINE
+__m512i
+MlasConvDepthwiseLoadTapAvx512Vnni(
+    const ElementType* Buffer,
+    __mmask16 ChannelMask,
+    __m512i ZeroPointVector
+    )
+{
+    __m128i Vector = _mm_maskz_loadu_epi8(ChannelMask, Buffer);
+    __m512i ExtendedVector;
+
+    if (std::is_signed<ElementType>::value) {
+        ExtendedVector = _mm512_cvtepi8_epi32(Vector);
+    } else {
+        ExtendedVector = _mm512_cvtepu8_epi32(Vector);
+    }
+
+    return _mm512_sub_epi32(ExtendedVector, ZeroPointVector);
+}
+
+//
+// Interleaves two taps into the 16-bit pairs of each 32-bit element.
+//
+
+MLAS_FORCEINLINE
+__m512i
+MlasConvDepthwiseInterleaveTapsAvx512Vnni(
+    __m512i Tap0,
+    __m512i Tap1
+    )
+{
+    return _mm512_mask_mov_epi16(Tap0, 0xAAAAAAAA, _mm512_slli_epi32(Tap1, 16));
+}
+
+template<typename InputType, typename FilterType>
+void
+MLASCALL
+MlasConvDepthwiseKernelAvx512Vnni(
+    const InputType* const* Input,
+    InputType InputZeroPoint,
+    const FilterType* Filter,
+    FilterType FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+{
+    const __m512i InputZeroPointVector = _mm512_set1_epi32(InputZeroPoint);
+    const __m512i FilterZeroPointVector = _mm512_set1_epi32(FilterZeroPoint);
+    const __m512i ZeroVector = _mm512_setzero_si512();
+
+    while (OutputCount > 0) {
+
+        for (size_t ChannelOffset = 0; ChannelOffset < Channels; ChannelOffset += 16) {
+
+            const size_t c = std::min(Channels - ChannelOffset, size_t{16});
+            const __mmask16 ChannelMask = __mmask16((uint32_t{1} << c) - 1);
+
+            __m512i Accumulator = _mm512_setzero_si512();
+            size_t ChannelKernelOffset = ChannelOffset;
+            size_t k = 0;
+
+            for (; k + 1 < KernelSize; k += 2) {
+
+                __m512i InputVector = MlasConvDepthwiseInterleaveTapsAvx512Vnni(
+                    MlasConvDepthwiseLoadTapAvx512Vnni(&Input[k][ChannelOffset], ChannelMask, InputZeroPointVector),
+                    MlasConvDepthwiseLoadTapAvx512Vnni(&Input[k + 1][ChannelOffset], ChannelMask, InputZeroPointVector));
+                __m512i FilterVector = MlasConvDepthwiseInterleaveTapsAvx512Vnni(
+                    MlasConvDepthwiseLoadTapAvx512Vnni(&Filter[ChannelKernelOffset], ChannelMask, FilterZeroPointVector),
+                    MlasConvDepthwiseLoadTapAvx512Vnni(&Filter[ChannelKernelOffset + Channels], ChannelMask, FilterZeroPointVector));
+
+                Accumulator = _mm512_dpwssd_epi32(Accumulator, InputVector, FilterVector);
+                ChannelKernelOffset += 2 * Channels;
+            }
+
+            //
+            // Pair an odd last tap with zeros.
+            //
+
+            if (k < KernelSize) {
+
+                __m512i InputVector = MlasConvDepthwiseInterleaveTapsAvx512Vnni(
+                    MlasConvDepthwiseLoadTapAvx512Vnni(&Input[k][ChannelOffset], ChannelMask, InputZeroPointVector),
+                    ZeroVector);
+                __m512i FilterVector = MlasConvDepthwiseInterleaveTapsAvx512Vnni(
+                    MlasConvDepthwiseLoadTapAvx512Vnni(&Filter[ChannelKernelOffset], ChannelMask, FilterZeroPointVector),
+                    ZeroVector);
+
+                Accumulator = _mm512_dpwssd_epi32(Accumulator, InputVector, FilterVector);
+            }
+
+            _mm512_mask_storeu_epi32(Output, ChannelMask, Accumulator);
+            Output += c;
+        }
+
+        Input += KernelSize;
+        OutputCount -= 1;
+    }
+}
+
+template
+void
+MLASCALL
+MlasConvDepthwiseKernelAvx512Vnni<uint8_t, int8_t>(
+    const uint8_t* const* Input,
+    uint8_t InputZeroPoint,
+    const int8_t* Filter,
+    int8_t FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
+template
+void
+MLASCALL
+MlasConvDepthwiseKernelAvx512Vnni<uint8_t, uint8_t>(
+    const uint8_t* const* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
+template
+void
+MLASCALL
+MlasConvDepthwiseKernelAvx512Vnni<int8_t, int8_t>(
+    const int8_t* const* Input,
+    int8_t InputZeroPoint,
+    const int8_t* Filter,
+    int8_t FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
+template
+void
+MLASCALL
+MlasConvDepthwiseKernelAvx512Vnni<int8_t, uint8_t>(
+    const int8_t* const* Input,
+    int8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
+#endif  // defined(MLAS_QDWCONV_AVX512VNNI_KERNELS)
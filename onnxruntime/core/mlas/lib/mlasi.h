@@ -568,6 +568,22 @@ void
     size_t N
     );
 
+typedef
+void
+(MLASCALL MLAS_CAST_F16_TO_F32_KERNEL)(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef
+void
+(MLASCALL MLAS_CAST_F32_TO_F16_KERNEL)(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
 typedef
 float
 (MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
@@ -697,6 +713,22 @@ struct MLAS_QUANT_KERNEL
         );
 };
 
+template<typename IndexType>
+struct MLAS_GATHER_KERNEL
+{
+    typedef
+    bool
+    (MLASCALL Kernel)(
+        const uint32_t* Input,
+        const IndexType* Indices,
+        uint32_t* Output,
+        size_t N,
+        int64_t AxisSize,
+        size_t IndexStride,
+        size_t ElementStride
+        );
+};
+
 extern "C" {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -877,7 +909,7 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -899,7 +931,10 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESSOR* PostProcessor,
+    size_t StartM,
+    size_t StartN
     );
 
 //
@@ -970,6 +1005,52 @@ struct MLAS_SQNBIT_GEMM_DISPATCH;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon;
 
+//
+// sqnbitgemm_kernel_avx2.cpp must be compiled with AVX2 and FMA3 enabled, and
+// sqnbitgemm_kernel_avx512.cpp with AVX512F, AVX512BW, AVX512DQ, AVX512VL and
+// AVX512VNNI enabled. The build defines MLAS_SQNBITGEMM_AVX2_KERNELS and
+// MLAS_SQNBITGEMM_AVX512_KERNELS when it compiles those sources.
+//
+
+#if defined(MLAS_SQNBITGEMM_AVX2_KERNELS)
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2;
+#endif
+
+#if defined(MLAS_SQNBITGEMM_AVX512_KERNELS)
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
+
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
+#endif
+
+//
+// Bfloat16 precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx;
+
+//
+// Half precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+//
+// halfgemm_kernel_avx2.cpp must be compiled with AVX2, FMA3 and F16C enabled.
+// The build defines MLAS_HALFGEMM_AVX2_KERNELS when it compiles that source.
+//
+
+#if defined(MLAS_HALFGEMM_AVX2_KERNELS)
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+#endif
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16;
+#endif
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1002,6 +1083,81 @@ MlasConvDepthwiseKernelAvx2(
     size_t KernelSize
     );
 
+//
+// intrinsics/avx512/qdwconv_avx512vnni.cpp must be compiled with AVX512F,
+// AVX512BW, AVX512VL and AVX512VNNI enabled. The build defines
+// MLAS_QDWCONV_AVX512VNNI_KERNELS when it compiles that source.
+//
+
+#if defined(MLAS_QDWCONV_AVX512VNNI_KERNELS)
+template<typename InputType, typename FilterType>
+void
+MLASCALL
+MlasConvDepthwiseKernelAvx512Vnni(
+    const InputType* const* Input,
+    InputType InputZeroPoint,
+    const FilterType* Filter,
+    FilterType FilterZeroPoint,
+    int32_t* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+#endif
+
+//
+// Gather kernels for 32-bit elements.
+//
+
+template<typename IndexType>
+bool
+MLASCALL
+MlasGatherKernel(
+    const uint32_t* Input,
+    const IndexType* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+
+//
+// intrinsics/avx2/gather_avx2.cpp must be compiled with AVX2 enabled. The
+// build defines MLAS_GATHER_AVX2_KERNELS when it compiles that source;
+// otherwise MlasGather uses the portable MlasGatherKernel.
+//
+
+#if defined(MLAS_GATHER_AVX2_KERNELS)
+template<typename IndexType>
+bool
+MLASCALL
+MlasGatherKernelAvx2(
+    const uint32_t* Input,
+    const IndexType* Indices,
+    uint32_t* Output,
+    size_t N,
+    int64_t AxisSize,
+    size_t IndexStride,
+    size_t ElementStride
+    );
+#endif
+
+//
+// Half precision conversion kernels.
+//
+
+//
+// cast_kernel_avx2.cpp must be compiled with AVX2 and F16C enabled. The build
+// defines MLAS_CAST_AVX2_KERNELS when it compiles that source; otherwise the
+// conversions use the portable loop.
+//
+
+#if defined(MLAS_TARGET_AMD64) && defined(MLAS_CAST_AVX2_KERNELS)
+MLAS_CAST_F16_TO_F32_KERNEL MlasCastF16ToF32KernelAvx2;
+MLAS_CAST_F32_TO_F16_KERNEL MlasCastF32ToF16KernelAvx2;
+#endif
+
 //
 // Define the kernel flags for conv sym
 //
@@ -1069,6 +1225,9 @@ struct MLAS_PLATFORM {
     MLAS_QUANT_KERNEL<int8_t, int8_t>::DepthwiseKernel* ConvDepthwiseS8S8Kernel;
     MLAS_QUANT_KERNEL<int8_t, uint8_t>::DepthwiseKernel* ConvDepthwiseS8U8Kernel;
 
+    MLAS_GATHER_KERNEL<int32_t>::Kernel* GatherS32Kernel;
+    MLAS_GATHER_KERNEL<int64_t>::Kernel* GatherS64Kernel;
+
 #if defined(MLAS_TARGET_POWER)
     MLAS_GEMM_DOUBLE_KERNEL* GemmDoubleKernel;
     const MLAS_GEMM_QUANT_DISPATCH* GemmU8X8Dispatch;
@@ -1118,6 +1277,13 @@ struct MLAS_PLATFORM {
     const MLAS_Q8Q4GEMM_DISPATCH* Q8Q4GemmDispatch{nullptr};
 
     const MLAS_SQNBIT_GEMM_DISPATCH* SQNBitGemmDispatch{nullptr};
+
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+    MLAS_CAST_F16_TO_F32_KERNEL* CastF16ToF32Kernel{nullptr};
+    MLAS_CAST_F32_TO_F16_KERNEL* CastF32ToF16Kernel{nullptr};
+#endif
 };
 
 inline
@@ -1197,6 +1363,20 @@ MlasGetMaximumThreadCount(
 #endif
 }
 
+inline
+int
+MlasGetCurrentNumaNode(
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+#if defined(BUILD_MLAS_NO_ONNXRUNTIME)
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+    return -1;
+#else
+    return onnxruntime::concurrency::ThreadPool::CurrentNumaNode(ThreadPool);
+#endif
+}
+
 inline
 void
 MlasPartitionWork(
@@ -1268,6 +1448,21 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd F(4x4, 3x3) convolution selected by MlasConvWinogradPrepare.
+//
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
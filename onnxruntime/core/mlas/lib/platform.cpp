@@ -237,6 +237,8 @@ Return Value:
     this->ConvDepthwiseU8U8Kernel = MlasConvDepthwiseKernel<uint8_t, uint8_t>;
     this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernel<int8_t, int8_t>;
     this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernel<int8_t, uint8_t>;
+    this->GatherS32Kernel = MlasGatherKernel<int32_t>;
+    this->GatherS64Kernel = MlasGatherKernel<int64_t>;
 
 #if defined(MLAS_TARGET_AMD64_IX86)
 
@@ -372,7 +374,28 @@ Return Value:
                 this->ConvDepthwiseU8U8Kernel = MlasConvDepthwiseKernelAvx2<uint8_t, uint8_t>;
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
+#if defined(MLAS_GATHER_AVX2_KERNELS)
+                this->GatherS32Kernel = MlasGatherKernelAvx2<int32_t>;
+                this->GatherS64Kernel = MlasGatherKernelAvx2<int64_t>;
+#endif
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+#if defined(MLAS_SQNBITGEMM_AVX2_KERNELS)
+                this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
+#endif
+
+                //
+                // Check if the processor supports F16C features.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+#if defined(MLAS_HALFGEMM_AVX2_KERNELS)
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+#endif
+#if defined(MLAS_CAST_AVX2_KERNELS)
+                    this->CastF16ToF32Kernel = MlasCastF16ToF32KernelAvx2;
+                    this->CastF32ToF16Kernel = MlasCastF32ToF16KernelAvx2;
+#endif
+                }
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -438,6 +461,9 @@ Return Value:
                         this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Core;
                         this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx512Core;
                         this->FpQ4GemmDispatch = &MlasFpQ4GemmDispatchAvx512;
+#if defined(MLAS_SQNBITGEMM_AVX512_KERNELS)
+                        this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512;
+#endif
 
                         //
                         // Check if the processor supports AVX512VNNI.
@@ -449,8 +475,44 @@ Return Value:
                             this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
                             this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Vnni;
                             this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx512Vnni;
+#if defined(MLAS_QDWCONV_AVX512VNNI_KERNELS)
+                            this->ConvDepthwiseU8S8Kernel = MlasConvDepthwiseKernelAvx512Vnni<uint8_t, int8_t>;
+                            this->ConvDepthwiseU8U8Kernel = MlasConvDepthwiseKernelAvx512Vnni<uint8_t, uint8_t>;
+                            this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx512Vnni<int8_t, int8_t>;
+                            this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx512Vnni<int8_t, uint8_t>;
+#endif
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
+#if defined(MLAS_SQNBITGEMM_AVX512_KERNELS)
+                            this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
+#endif
+                        }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_BF16.
+                        //
+
+                        unsigned Cpuid7_1[4];
+#if defined(_WIN32)
+                        __cpuidex((int*)Cpuid7_1, 7, 1);
+#else
+                        __cpuid_count(7, 1, Cpuid7_1[0], Cpuid7_1[1], Cpuid7_1[2], Cpuid7_1[3]);
+#endif
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
                         }
+#endif
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_FP16.
+                        //
+
+                        if ((Cpuid7[3] & 0x800000) != 0) {
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
+#endif
                     }
                 }
 
@@ -465,6 +527,17 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+                        //
+                        // Check if the processor supports AMX-BF16. The kernel
+                        // converts matrix A with AVX512_BF16 instructions.
+                        //
+
+                        if ((Cpuid7[3] & 0b1 << 22) != 0 && this->SBGemmDispatch != nullptr) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAmx;
+                        }
+#endif
                     }
                 }
 #endif // __APPLE__
@@ -128,6 +128,53 @@ MlasGemmQuantFixupZeroPointB(
     }
 }
 
+MLAS_FORCEINLINE
+const uint8_t*
+MlasGemmQuantPerColumnZeroPointB(
+    const MLAS_GEMM_QUANT_DATA_PARAMS* Data,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the per-column zero point offsets of matrix B for
+    the range of columns processed by a thread.
+
+    Per-column zero points that are all zero, as produced for symmetrically
+    quantized weights, are dropped so that the kernel skips the per-column
+    zero point correction and the row sums of matrix A are scaled by a zero
+    per-matrix zero point instead. This also allows the GEMV path to be used.
+
+Arguments:
+
+    Data - Supplies the matrix data parameters.
+
+    RangeStartN - Supplies the starting column of the range.
+
+    RangeCountN - Supplies the number of columns of the range.
+
+Return Value:
+
+    Returns the per-column zero point offsets for the range, or nullptr if
+    per-matrix quantization applies to the range.
+
+--*/
+{
+    if (!Data->PerColumnZeroPoints) {
+        return nullptr;
+    }
+
+    const uint8_t* PackedZeroPointB = Data->ZeroPointB + RangeStartN;
+
+    if (std::all_of(PackedZeroPointB, PackedZeroPointB + RangeCountN, [](uint8_t zp) { return zp == 0; })) {
+        return nullptr;
+    }
+
+    return PackedZeroPointB;
+}
+
 template<typename KernelType>
 void
 MlasGemmQuantCopyPackA(
@@ -316,12 +363,13 @@ Return Value:
     const uint8_t* A = Data->A + RangeStartM * lda;
     const uint8_t* B = (const uint8_t*)Data->B + RangeStartN;
     int32_t* C = Data->C + RangeStartM * ldc + RangeStartN;
-    const uint8_t* PackedZeroPointB = Data->PerColumnZeroPoints ?
-        Data->ZeroPointB + RangeStartN : nullptr;
+    const uint8_t* PackedZeroPointB =
+        MlasGemmQuantPerColumnZeroPointB(Data, RangeStartN, RangeCountN);
     bool IsAccumulateMode = Shape->IsAccumulateMode;
 
     int32_t ZeroPointA = typename KernelType::OffsetAType(Data->ZeroPointA);
-    int32_t ZeroPointB = typename KernelType::OffsetBType(*Data->ZeroPointB);
+    int32_t ZeroPointB = (Data->PerColumnZeroPoints && PackedZeroPointB == nullptr) ?
+        0 : typename KernelType::OffsetBType(*Data->ZeroPointB);
 
     //
     // Try to use a GEMV kernel if supported by this kernel type.
@@ -560,12 +608,13 @@ Return Value:
     const uint8_t* A = Data->A + RangeStartM * lda;
     const uint8_t* PackedB = (const uint8_t*)Data->B;
     int32_t* C = Data->C + RangeStartM * ldc + RangeStartN;
-    const uint8_t* PackedZeroPointB = Data->PerColumnZeroPoints ?
-        Data->ZeroPointB + RangeStartN : nullptr;
+    const uint8_t* PackedZeroPointB =
+        MlasGemmQuantPerColumnZeroPointB(Data, RangeStartN, RangeCountN);
     bool IsAccumulateMode = Shape->IsAccumulateMode;
 
     int32_t ZeroPointA = typename KernelType::OffsetAType(Data->ZeroPointA);
-    int32_t ZeroPointB = typename KernelType::OffsetBType(*Data->ZeroPointB);
+    int32_t ZeroPointB = (Data->PerColumnZeroPoints && PackedZeroPointB == nullptr) ?
+        0 : typename KernelType::OffsetBType(*Data->ZeroPointB);
 
     //
     // Fixup the sign bit of the per-matrix zero point offset of matrix A if the
@@ -0,0 +1,304 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_int16x8.cpp
+
+Abstract:
+
+    This module implements the GEMM of 16-bit activations and 8-bit weights
+    with 32-bit accumulation.
+
+    B is packed by panels of 8 columns. Each pair of rows of a panel is
+    interleaved and widened to 16 bits, so the multiply-add of a pair of
+    values of A with a pair of rows of B (pmaddwd, smull + addp) yields the
+    sums of two steps of K. uint16_t A is offset by 32768 to fit int16_t,
+    the zero points of A and B are applied to the accumulators with the
+    sums of the rows of A and of the columns of B.
+
+--*/
+
+#include "mlasi.h"
+
+namespace {
+
+constexpr size_t PanelWidth = 8;
+
+// Panels of B computed by a work item, so small M still spreads over threads.
+constexpr size_t PanelsPerWorkItem = 8;
+
+// Rows of A computed by a work item.
+constexpr size_t RowsPerWorkItem = 4;
+
+struct MLAS_GEMM_INT16X8_PACKED_LAYOUT {
+    size_t PanelCount;
+    size_t KPairs;
+    size_t ColumnSumOffset;
+    size_t Size;
+
+    MLAS_GEMM_INT16X8_PACKED_LAYOUT(size_t N, size_t K)
+    {
+        PanelCount = (N + PanelWidth - 1) / PanelWidth;
+        KPairs = (K + 1) / 2;
+        ColumnSumOffset = PanelCount * KPairs * PanelWidth * 2 * sizeof(int16_t);
+        Size = ColumnSumOffset + PanelCount * PanelWidth * sizeof(int32_t);
+    }
+};
+
+MLAS_FORCEINLINE
+int32_t
+LoadAPair(
+    const uint16_t* A,
+    size_t k,
+    size_t K,
+    bool AIsSigned
+    )
+{
+    // Returns A[k] and A[k + 1] as int16_t in the low and high halves, the pair past K is 0.
+    const uint16_t Offset = AIsSigned ? 0 : 0x8000;
+    const uint32_t Low = uint16_t(A[k] ^ Offset);
+    const uint32_t High = (k + 1 < K) ? uint16_t(A[k + 1] ^ Offset) : 0;
+    return int32_t(Low | (High << 16));
+}
+
+//
+// Computes the accumulators of a row of A with a panel of B.
+//
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+MLAS_FORCEINLINE
+void
+MlasGemmInt16x8KernelRow(
+    const uint16_t* A,
+    size_t K,
+    bool AIsSigned,
+    const int16_t* PackedPanel,
+    size_t KPairs,
+    int32_t Accumulators[PanelWidth]
+    )
+{
+    __m128i Acc0 = _mm_setzero_si128();
+    __m128i Acc1 = _mm_setzero_si128();
+
+    for (size_t kp = 0; kp < KPairs; kp++) {
+        const __m128i APair = _mm_set1_epi32(LoadAPair(A, kp * 2, K, AIsSigned));
+        const __m128i B0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(PackedPanel));
+        const __m128i B1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(PackedPanel + 8));
+        Acc0 = _mm_add_epi32(Acc0, _mm_madd_epi16(B0, APair));
+        Acc1 = _mm_add_epi32(Acc1, _mm_madd_epi16(B1, APair));
+        PackedPanel += PanelWidth * 2;
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Accumulators), Acc0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Accumulators + 4), Acc1);
+}
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+MLAS_FORCEINLINE
+void
+MlasGemmInt16x8KernelRow(
+    const uint16_t* A,
+    size_t K,
+    bool AIsSigned,
+    const int16_t* PackedPanel,
+    size_t KPairs,
+    int32_t Accumulators[PanelWidth]
+    )
+{
+    int32x4_t Acc0 = vdupq_n_s32(0);
+    int32x4_t Acc1 = vdupq_n_s32(0);
+
+    for (size_t kp = 0; kp < KPairs; kp++) {
+        const int16x4_t APair = vreinterpret_s16_s32(vdup_n_s32(LoadAPair(A, kp * 2, K, AIsSigned)));
+        const int16x8_t B0 = vld1q_s16(PackedPanel);
+        const int16x8_t B1 = vld1q_s16(PackedPanel + 8);
+        // products of the pairs of columns 0-1, 2-3, 4-5 and 6-7, added pairwise to the sums of each column
+        const int32x4_t P0 = vmull_s16(vget_low_s16(B0), APair);
+        const int32x4_t P1 = vmull_s16(vget_high_s16(B0), APair);
+        const int32x4_t P2 = vmull_s16(vget_low_s16(B1), APair);
+        const int32x4_t P3 = vmull_s16(vget_high_s16(B1), APair);
+        Acc0 = vaddq_s32(Acc0, vpaddq_s32(P0, P1));
+        Acc1 = vaddq_s32(Acc1, vpaddq_s32(P2, P3));
+        PackedPanel += PanelWidth * 2;
+    }
+
+    vst1q_s32(Accumulators, Acc0);
+    vst1q_s32(Accumulators + 4, Acc1);
+}
+
+#else
+
+MLAS_FORCEINLINE
+void
+MlasGemmInt16x8KernelRow(
+    const uint16_t* A,
+    size_t K,
+    bool AIsSigned,
+    const int16_t* PackedPanel,
+    size_t KPairs,
+    int32_t Accumulators[PanelWidth]
+    )
+{
+    for (size_t n = 0; n < PanelWidth; n++) {
+        Accumulators[n] = 0;
+    }
+
+    for (size_t kp = 0; kp < KPairs; kp++) {
+        const int32_t APair = LoadAPair(A, kp * 2, K, AIsSigned);
+        const int32_t A0 = int16_t(APair & 0xFFFF);
+        const int32_t A1 = int16_t(uint32_t(APair) >> 16);
+        for (size_t n = 0; n < PanelWidth; n++) {
+            Accumulators[n] += A0 * PackedPanel[n * 2] + A1 * PackedPanel[n * 2 + 1];
+        }
+        PackedPanel += PanelWidth * 2;
+    }
+}
+
+#endif
+
+void
+MlasGemmInt16x8Operation(
+    const MLAS_GEMM_QUANT_SHAPE_PARAMS& Shape,
+    const MLAS_GEMM_INT16X8_DATA_PARAMS* Data,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartPanel,
+    size_t RangeCountPanel
+    )
+{
+    const size_t N = Shape.N;
+    const size_t K = Shape.K;
+    const MLAS_GEMM_INT16X8_PACKED_LAYOUT Layout(N, K);
+
+    const int16_t* PackedB = static_cast<const int16_t*>(Data->PackedB);
+    const int32_t* ColumnSums = reinterpret_cast<const int32_t*>(
+        static_cast<const uint8_t*>(Data->PackedB) + Layout.ColumnSumOffset);
+
+    // zero point of A in the int16_t domain of the kernel
+    const int64_t ZeroPointA = int64_t(Data->ZeroPointA) - (Shape.AIsSigned ? 0 : 0x8000);
+
+    int32_t Accumulators[PanelWidth];
+
+    for (size_t m = RangeStartM; m < RangeStartM + RangeCountM; m++) {
+        const uint16_t* a = static_cast<const uint16_t*>(Data->A) + m * Data->lda;
+
+        int64_t RowSum = 0;
+        for (size_t k = 0; k < K; k++) {
+            RowSum += Shape.AIsSigned ? int16_t(a[k]) : int32_t(a[k]) - 0x8000;
+        }
+
+        for (size_t panel = RangeStartPanel; panel < RangeStartPanel + RangeCountPanel; panel++) {
+            MlasGemmInt16x8KernelRow(a, K, Shape.AIsSigned, PackedB + panel * Layout.KPairs * PanelWidth * 2,
+                                     Layout.KPairs, Accumulators);
+
+            const size_t n0 = panel * PanelWidth;
+            const size_t CountN = std::min(PanelWidth, N - n0);
+            int32_t* c = Data->C + m * Data->ldc + n0;
+
+            for (size_t n = 0; n < CountN; n++) {
+                const uint8_t ZeroPointBValue = Data->PerColumnZeroPoints ? Data->ZeroPointB[n0 + n]
+                                                                          : (Data->ZeroPointB ? Data->ZeroPointB[0] : 0);
+                const int64_t ZeroPointB = Shape.BIsSigned ? int64_t(int8_t(ZeroPointBValue)) : int64_t(ZeroPointBValue);
+                const int64_t Value = int64_t(Accumulators[n]) - ZeroPointB * RowSum -
+                                      ZeroPointA * ColumnSums[n0 + n] + int64_t(K) * ZeroPointA * ZeroPointB;
+                c[n] = int32_t(Value);
+            }
+        }
+
+        if (Data->OutputProcessor != nullptr) {
+            const size_t n0 = RangeStartPanel * PanelWidth;
+            Data->OutputProcessor->Process(Data->C, m, n0, 1,
+                                           std::min(RangeCountPanel * PanelWidth, N - n0), Data->ldc);
+        }
+    }
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasGemmInt16x8PackBSize(
+    size_t N,
+    size_t K
+    )
+{
+    return MLAS_GEMM_INT16X8_PACKED_LAYOUT(N, K).Size;
+}
+
+void
+MLASCALL
+MlasGemmInt16x8PackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    bool BIsSigned,
+    void* PackedB
+    )
+{
+    const MLAS_GEMM_INT16X8_PACKED_LAYOUT Layout(N, K);
+
+    int16_t* Packed = static_cast<int16_t*>(PackedB);
+    int32_t* ColumnSums = reinterpret_cast<int32_t*>(static_cast<uint8_t*>(PackedB) + Layout.ColumnSumOffset);
+
+    auto BValue = [&](size_t k, size_t n) -> int16_t {
+        if (k >= K || n >= N) {
+            return 0;
+        }
+        return BIsSigned ? int16_t(int8_t(B[k * ldb + n])) : int16_t(B[k * ldb + n]);
+    };
+
+    for (size_t panel = 0; panel < Layout.PanelCount; panel++) {
+        const size_t n0 = panel * PanelWidth;
+        for (size_t kp = 0; kp < Layout.KPairs; kp++) {
+            for (size_t n = 0; n < PanelWidth; n++) {
+                *Packed++ = BValue(kp * 2, n0 + n);
+                *Packed++ = BValue(kp * 2 + 1, n0 + n);
+            }
+        }
+
+        for (size_t n = 0; n < PanelWidth; n++) {
+            int32_t Sum = 0;
+            for (size_t k = 0; k < K; k++) {
+                Sum += BValue(k, n0 + n);
+            }
+            ColumnSums[n0 + n] = Sum;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasGemmInt16x8Batch(
+    const MLAS_GEMM_QUANT_SHAPE_PARAMS& Shape,
+    const MLAS_GEMM_INT16X8_DATA_PARAMS* DataParams,
+    const size_t BatchN,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (Shape.IsAccumulateMode) {
+        MLAS_THROW_EX(std::invalid_argument, "MlasGemmInt16x8Batch does not support the accumulate mode.");
+    }
+
+    const size_t PanelCount = (Shape.N + PanelWidth - 1) / PanelWidth;
+    const size_t PanelBlocks = (PanelCount + PanelsPerWorkItem - 1) / PanelsPerWorkItem;
+    const size_t RowBlocks = (Shape.M + RowsPerWorkItem - 1) / RowsPerWorkItem;
+    const size_t WorkItemsPerGemm = PanelBlocks * RowBlocks;
+
+    MlasTrySimpleParallel(ThreadPool, ptrdiff_t(WorkItemsPerGemm * BatchN), [&](ptrdiff_t tid) {
+        const size_t gemm = size_t(tid) / WorkItemsPerGemm;
+        const size_t item = size_t(tid) % WorkItemsPerGemm;
+        const size_t StartM = (item / PanelBlocks) * RowsPerWorkItem;
+        const size_t StartPanel = (item % PanelBlocks) * PanelsPerWorkItem;
+
+        MlasGemmInt16x8Operation(Shape, &DataParams[gemm],
+                                 StartM, std::min(RowsPerWorkItem, Shape.M - StartM),
+                                 StartPanel, std::min(PanelsPerWorkItem, PanelCount - StartPanel));
+    });
+}
@@ -0,0 +1,512 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernels for AVX512_BF16
+    and AMX-BF16.
+
+    Both kernels share the layout of the packed B buffer: the columns are
+    split into panels of 16 columns and each pair of rows of a panel is
+    interleaved into 64 bytes, which is the operand layout of VDPBF16PS and
+    of the B tile of TDPBF16PS. Matrix A is converted to bfloat16 a block of
+    rows at a time.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+#include "amx_common.h"
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+struct MLAS_SBGEMM_KERNEL_AMX {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 32;  // two tiles of 16 rows
+    static constexpr size_t PackedK = 32;     // one tile of 16 row pairs
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+//
+// Number of columns of a panel of the packed B buffer.
+//
+constexpr size_t MLAS_SBGEMM_PANEL_N = 16;
+
+//
+// Number of elements of a row of matrix A converted by one iteration.
+//
+constexpr size_t MLAS_SBGEMM_CONVERT_K = 32;
+
+bool MLASCALL
+MlasBf16AccelerationSupported()
+{
+    return GetMlasPlatform().SBGemmDispatch != nullptr;
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmColumnMask(size_t Count)
+{
+    return (Count >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Count) - 1);
+}
+
+/*
+    This routine converts a row of matrix A to bf16. The row is zero padded
+    to a multiple of 32 elements.
+*/
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertRowA(bfloat16_t* D, const float* A, size_t CountK)
+{
+    for (size_t k = 0; k < CountK; k += MLAS_SBGEMM_CONVERT_K) {
+        const size_t CountRemaining = CountK - k;
+        const __m512 Low = _mm512_maskz_loadu_ps(MlasSBGemmColumnMask(CountRemaining), A + k);
+        const __m512 High = _mm512_maskz_loadu_ps(
+            MlasSBGemmColumnMask(CountRemaining > 16 ? CountRemaining - 16 : 0), A + k + 16
+        );
+        _mm512_storeu_si512(D + k, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+    }
+}
+
+/*
+    This routine converts fp32 to bf16 and copies elements from the source
+    matrix to the destination packed buffer.
+
+    Each panel of 16 columns holds the rows of the block in pairs, with
+    the two bf16 values of a column next to each other. The rows are padded
+    to the PackedK alignment of the kernel and the columns to 16.
+*/
+template <typename KernelType>
+void
+MlasSBGemmConvertCopyPackB(bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    const size_t AlignedK = (CountK + KernelType::PackedK - 1) & ~(KernelType::PackedK - 1);
+
+    //
+    // Interleave the two rows converted by VCVTNE2PS2BF16, which returns the
+    // first row in the low half of the vector.
+    //
+    const __m512i Interleave = _mm512_set_epi16(
+        31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8,
+        23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0
+    );
+
+    for (size_t n = 0; n < CountN; n += MLAS_SBGEMM_PANEL_N) {
+        const __mmask16 ColumnMask = MlasSBGemmColumnMask(CountN - n);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < AlignedK; k += 2) {
+            __m512 Row0 = _mm512_setzero_ps();
+            __m512 Row1 = _mm512_setzero_ps();
+
+            if (k < CountK) {
+                Row0 = _mm512_maskz_loadu_ps(ColumnMask, b);
+                b += ldb;
+            }
+            if (k + 1 < CountK) {
+                Row1 = _mm512_maskz_loadu_ps(ColumnMask, b);
+                b += ldb;
+            }
+
+            const __m512i Rows = (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0);
+            _mm512_storeu_si512(D, _mm512_permutexvar_epi16(Interleave, Rows));
+            D += 2 * MLAS_SBGEMM_PANEL_N;
+        }
+    }
+}
+
+template <typename KernelType>
+void
+MlasSBGemmConvertPackB(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    const size_t AlignedN = (CountN + KernelType::PackedN - 1) & ~(KernelType::PackedN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+    size_t K_block_size;
+    constexpr MLAS_SBGEMM_STRIDES Strides = KernelType::Strides;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackB<KernelType>(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB = PackedB + AlignedN * K_block_size;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmStoreOutput(float* C, __m512 Accumulator, const float* Bias, __mmask16 ColumnMask, bool ZeroMode)
+{
+    if (!ZeroMode) {
+        Accumulator = _mm512_add_ps(Accumulator, _mm512_maskz_loadu_ps(ColumnMask, C));
+    } else if (Bias != nullptr) {
+        Accumulator = _mm512_add_ps(Accumulator, _mm512_maskz_loadu_ps(ColumnMask, Bias));
+    }
+    _mm512_mask_storeu_ps(C, ColumnMask, Accumulator);
+}
+
+/*
+    This routine computes RowCount rows of one or two panels of matrix C
+    with VDPBF16PS. Each K pair of a row of A is broadcast and multiplied
+    with a 64 byte row of the panel.
+*/
+template <size_t RowCount, size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelAvx512Bf16Block(
+    const bfloat16_t* A,
+    size_t lda,
+    const bfloat16_t* B,
+    size_t PanelSize,
+    size_t PairCount,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    __m512 Accumulators[RowCount][PanelCount];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t p = 0; p < PanelCount; p++) {
+            Accumulators[r][p] = _mm512_setzero_ps();
+        }
+    }
+
+    for (size_t k = 0; k < PairCount; k++) {
+        __m512bh Panels[PanelCount];
+        for (size_t p = 0; p < PanelCount; p++) {
+            Panels[p] = (__m512bh)_mm512_loadu_si512(B + p * PanelSize + k * 2 * MLAS_SBGEMM_PANEL_N);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m512bh Pair =
+                (__m512bh)_mm512_set1_epi32(*reinterpret_cast<const int32_t*>(A + r * lda + k * 2));
+            for (size_t p = 0; p < PanelCount; p++) {
+                Accumulators[r][p] = _mm512_dpbf16_ps(Accumulators[r][p], Pair, Panels[p]);
+            }
+        }
+    }
+
+    for (size_t p = 0; p < PanelCount; p++) {
+        const size_t n = p * MLAS_SBGEMM_PANEL_N;
+        const __mmask16 ColumnMask = MlasSBGemmColumnMask(CountN - n);
+        const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+        for (size_t r = 0; r < RowCount; r++) {
+            MlasSBGemmStoreOutput(C + r * ldc + n, Accumulators[r][p], bias, ColumnMask, ZeroMode);
+        }
+    }
+}
+
+template <size_t RowCount>
+void
+MlasSBGemmKernelAvx512Bf16Rows(
+    const bfloat16_t* A,
+    size_t lda,
+    const bfloat16_t* B,
+    size_t CountN,
+    size_t CountK,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    const size_t PairCount = (CountK + 1) / 2;
+    const size_t PanelSize = PairCount * 2 * MLAS_SBGEMM_PANEL_N;
+
+    for (size_t n = 0; n < CountN; n += 2 * MLAS_SBGEMM_PANEL_N) {
+        const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+        if (CountN - n > MLAS_SBGEMM_PANEL_N) {
+            MlasSBGemmKernelAvx512Bf16Block<RowCount, 2>(
+                A, lda, B, PanelSize, PairCount, C + n, ldc, CountN - n, bias, ZeroMode
+            );
+        } else {
+            MlasSBGemmKernelAvx512Bf16Block<RowCount, 1>(
+                A, lda, B, PanelSize, PairCount, C + n, ldc, CountN - n, bias, ZeroMode
+            );
+        }
+        B += 2 * PanelSize;
+    }
+}
+
+void
+MlasSBGemmKernelAvx512Bf16(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+    constexpr size_t StrideK = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K;
+
+    MLAS_DECLSPEC_ALIGN(bfloat16_t PanelA[KernelMaxM * StrideK], 64);
+    const size_t ldPanelA = (CountK + MLAS_SBGEMM_CONVERT_K - 1) & ~(MLAS_SBGEMM_CONVERT_K - 1);
+
+    while (CountM > 0) {
+        size_t RowCount = KernelMaxM;
+        while (RowCount > CountM) {
+            RowCount /= 2;
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            MlasSBGemmConvertRowA(PanelA + r * ldPanelA, A + r * lda, CountK);
+        }
+
+        switch (RowCount) {
+            case 8:
+                MlasSBGemmKernelAvx512Bf16Rows<8>(PanelA, ldPanelA, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+            case 4:
+                MlasSBGemmKernelAvx512Bf16Rows<4>(PanelA, ldPanelA, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+            case 2:
+                MlasSBGemmKernelAvx512Bf16Rows<2>(PanelA, ldPanelA, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+            default:
+                MlasSBGemmKernelAvx512Bf16Rows<1>(PanelA, ldPanelA, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+        }
+
+        A += lda * RowCount;
+        C += ldc * RowCount;
+        CountM -= RowCount;
+    }
+}
+
+/*
+    This routine loads the tile configuration used by the AMX kernel: eight
+    tiles of 16 rows of 64 bytes, which is also the configuration of the
+    AMX QGEMM kernel.
+*/
+void
+MlasSBGemmAmxTileConfig()
+{
+    struct tileconfig_t tc;
+    tc.palette_id = 1;
+    for (int t = 0; t < 8; t++) {
+        tc.rows[t] = 16;
+        tc.colb[t] = 64;
+    }
+
+    struct tileconfig_t current_tc;
+    tile_storeconfig(&current_tc);
+
+    if (std::memcmp(&current_tc, &tc, sizeof(tc)) != 0) {
+        tile_loadconfig(&tc);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmAmxStoreTile(
+    float* C, size_t ldc, const float* Tile, size_t RowCount, size_t CountN, const float* Bias, bool ZeroMode
+)
+{
+    const __mmask16 ColumnMask = MlasSBGemmColumnMask(CountN);
+    for (size_t r = 0; r < RowCount; r++) {
+        MlasSBGemmStoreOutput(C + r * ldc, _mm512_load_ps(Tile + r * 16), Bias, ColumnMask, ZeroMode);
+    }
+}
+
+/*
+    This routine computes matrix C 32 rows by 32 columns at a time with
+    TDPBF16PS, using tiles 0-3 to accumulate, tiles 4-5 for matrix A and
+    tiles 6-7 for the panels of matrix B.
+*/
+void
+MlasSBGemmKernelAmx(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AMX::KernelMaxM;
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AMX::PackedK;
+    constexpr size_t StrideK = MLAS_SBGEMM_KERNEL_AMX::Strides.K;
+
+    MLAS_DECLSPEC_ALIGN(bfloat16_t PanelA[KernelMaxM * StrideK], 64);
+    MLAS_DECLSPEC_ALIGN(float Tiles[4][16 * 16], 64);
+
+    MlasSBGemmAmxTileConfig();
+
+    const size_t AlignedK = (CountK + PackedK - 1) & ~(PackedK - 1);
+    const size_t PanelSize = AlignedK * MLAS_SBGEMM_PANEL_N;
+    const size_t StrideA = AlignedK * sizeof(bfloat16_t);
+
+    while (CountM > 0) {
+        const size_t RowCount = std::min(CountM, KernelMaxM);
+        const bool TwoRowTiles = RowCount > 16;
+
+        //
+        // Rows of the tiles past the end of matrix A are zero filled, their
+        // results are not stored.
+        //
+        for (size_t r = 0; r < RowCount; r++) {
+            MlasSBGemmConvertRowA(PanelA + r * AlignedK, A + r * lda, CountK);
+        }
+        const size_t PaddedRowCount = TwoRowTiles ? KernelMaxM : 16;
+        std::fill_n(PanelA + RowCount * AlignedK, (PaddedRowCount - RowCount) * AlignedK, bfloat16_t(0));
+
+        const bfloat16_t* b = B;
+
+        for (size_t n = 0; n < CountN; n += 2 * MLAS_SBGEMM_PANEL_N) {
+            const bool TwoPanels = CountN - n > MLAS_SBGEMM_PANEL_N;
+
+            tile_zero(0);
+            tile_zero(1);
+            tile_zero(2);
+            tile_zero(3);
+
+            for (size_t k = 0; k < AlignedK; k += PackedK) {
+                tile_loadd(4, PanelA + k, StrideA);
+                tile_loadd(6, b + k * MLAS_SBGEMM_PANEL_N, 64);
+                tile_dpbf16ps(0, 4, 6);
+                if (TwoRowTiles) {
+                    tile_loadd(5, PanelA + 16 * AlignedK + k, StrideA);
+                    tile_dpbf16ps(2, 5, 6);
+                }
+                if (TwoPanels) {
+                    tile_loadd(7, b + PanelSize + k * MLAS_SBGEMM_PANEL_N, 64);
+                    tile_dpbf16ps(1, 4, 7);
+                    if (TwoRowTiles) {
+                        tile_dpbf16ps(3, 5, 7);
+                    }
+                }
+            }
+
+            tile_stored(0, Tiles[0], 64);
+            tile_stored(1, Tiles[1], 64);
+            tile_stored(2, Tiles[2], 64);
+            tile_stored(3, Tiles[3], 64);
+
+            for (size_t t = 0; t < 4; t++) {
+                const size_t TileRow = (t / 2) * 16;
+                const size_t TileColumn = n + (t % 2) * MLAS_SBGEMM_PANEL_N;
+                if (TileRow >= RowCount || TileColumn >= CountN) {
+                    continue;
+                }
+                MlasSBGemmAmxStoreTile(
+                    C + TileRow * ldc + TileColumn, ldc, Tiles[t], std::min(RowCount - TileRow, size_t(16)),
+                    CountN - TileColumn, (Bias == nullptr) ? nullptr : Bias + TileColumn, ZeroMode
+                );
+            }
+
+            b += 2 * PanelSize;
+        }
+
+        A += lda * RowCount;
+        C += ldc * RowCount;
+        CountM -= RowCount;
+    }
+}
+
+/*
+    The non packed operation may expand the K stride, while matrix B is
+    packed in slices of Strides.K rows, so the kernels step through the
+    slices along the K dimension.
+*/
+template <typename KernelType, typename KernelRoutine>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelSlices(
+    KernelRoutine Kernel,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    constexpr MLAS_SBGEMM_STRIDES Strides = KernelType::Strides;
+    const size_t AlignedN = (CountN + KernelType::PackedN - 1) & ~(KernelType::PackedN - 1);
+
+    size_t K_block_size;
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        Kernel(CountM, CountN, K_block_size, A + k, lda, B, C, ldc, Bias, ZeroMode);
+
+        B += AlignedN * K_block_size;
+        Bias = nullptr;
+        ZeroMode = false;
+    }
+}
+
+template <>
+void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    MlasSBGemmKernelSlices<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+        MlasSBGemmKernelAvx512Bf16, CountM, CountN, CountK, A, lda, B, C, ldc, Bias, ZeroMode
+    );
+}
+
+template <>
+void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    MlasSBGemmKernelSlices<MLAS_SBGEMM_KERNEL_AMX>(
+        MlasSBGemmKernelAmx, CountM, CountN, CountK, A, lda, B, C, ldc, Bias, ZeroMode
+    );
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0  // kernel does not read beyond buffer end
+};
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AMX>,
+    MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>,
+    MLAS_SBGEMM_KERNEL_AMX::PackedK,
+    MLAS_SBGEMM_KERNEL_AMX::PackedN,
+    MLAS_SBGEMM_KERNEL_AMX::KernelMaxM,
+    0  // kernel does not read beyond buffer end
+};
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
@@ -1015,7 +1015,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_POSTPROCESSOR* PostProcessor,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1051,6 +1054,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    PostProcessor - Supplies the optional post processor to apply to each block
+        of rows after the kernel has produced it. This is only supplied for the
+        last slice along the K dimension.
+
+    StartM - Supplies the row of matrix C relative to the whole output matrix.
+
+    StartN - Supplies the column of matrix C relative to the whole output matrix.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,8 +1082,13 @@ Return Value:
         }
 #endif
 
+        if (PostProcessor != nullptr) {
+            PostProcessor->Process(C, StartM, StartN, RowsHandled, CountN, ldc);
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
+        StartM += RowsHandled;
         CountM -= RowsHandled;
     }
 
@@ -1093,7 +1109,10 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESSOR* PostProcessor,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -1131,6 +1150,13 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcessor - Supplies the optional post processor to apply to the final
+        values of matrix C.
+
+    StartM - Supplies the row of matrix C relative to the whole output matrix.
+
+    StartN - Supplies the column of matrix C relative to the whole output matrix.
+
 Return Value:
 
     None.
@@ -1147,6 +1173,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (PostProcessor != nullptr) {
+            PostProcessor->Process(C, StartM, StartN, M, N, ldc);
+        }
         return;
     }
 
@@ -1170,6 +1199,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (PostProcessor != nullptr) {
+                PostProcessor->Process(C, StartM, StartN, M, N, ldc);
+            }
             return;
         }
 
@@ -1177,6 +1209,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (PostProcessor != nullptr) {
+                PostProcessor->Process(C, StartM, StartN, M, N, ldc);
+            }
             return;
         }
 
@@ -1205,6 +1240,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (PostProcessor != nullptr) {
+                PostProcessor->Process(C, StartM, StartN, M, N, ldc);
+            }
             return;
         }
 
@@ -1267,6 +1305,14 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            //
+            // Post process the rows of matrix C once the last slice along the
+            // K dimension has been accumulated into them.
+            //
+
+            const MLAS_SGEMM_POSTPROCESSOR* SlicePostProcessor =
+                (k + CountK == K) ? PostProcessor : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1285,7 +1331,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SlicePostProcessor, StartM, StartN + n);
 
             } else {
 
@@ -1309,7 +1356,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SlicePostProcessor, StartM + M - RowsRemaining - RowsTransposed, StartN + n);
                 }
             }
 
@@ -1332,7 +1380,9 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESSOR* PostProcessor,
+    size_t StartM
     )
 /*++
 
@@ -1372,6 +1422,11 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcessor - Supplies the optional post processor to apply to the final
+        values of matrix C.
+
+    StartM - Supplies the row of matrix C relative to the whole output matrix.
+
 Return Value:
 
     None.
@@ -1411,6 +1466,9 @@ Return Value:
 
             CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
+            const MLAS_SGEMM_POSTPROCESSOR* SlicePostProcessor =
+                (k + CountK == K) ? PostProcessor : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1420,7 +1478,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SlicePostProcessor, StartM, SliceStartN);
 
             } else {
 
@@ -1444,7 +1503,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SlicePostProcessor, StartM + M - RowsRemaining - RowsTransposed, SliceStartN);
                 }
             }
 
@@ -1540,7 +1600,8 @@ Return Value:
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            DataParams->OutputProcessor, RangeStartM);
 
     } else {
 
@@ -1549,7 +1610,8 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc,
+            DataParams->OutputProcessor, RangeStartM, RangeStartN);
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -1631,8 +1693,26 @@ MlasGemmBatch(
     {
         ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
         ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
+        const MLAS_SGEMM_DATA_PARAMS* DataParams = &(Data[GemmIdx]);
+
+        //
+        // Read the copy of B on the NUMA node of the thread, if any.
+        //
+
+        MLAS_SGEMM_DATA_PARAMS LocalDataParams;
+
+        if (DataParams->BReplicaCount != 0) {
+            const int NumaNode = MlasGetCurrentNumaNode(ThreadPool);
+            if (NumaNode >= 0 && size_t(NumaNode) < DataParams->BReplicaCount &&
+                DataParams->BReplicas[NumaNode] != nullptr) {
+                LocalDataParams = *DataParams;
+                LocalDataParams.B = DataParams->BReplicas[NumaNode];
+                DataParams = &LocalDataParams;
+            }
+        }
+
         MlasSgemmThreaded(ThreadCountM, ThreadCountN,
-            TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
+            TransA, TransB, M, N, K, DataParams, ThreadIdx);
     });
 }
 #if defined(_MSC_VER) && !defined(__clang__)
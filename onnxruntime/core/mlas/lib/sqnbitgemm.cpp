@@ -169,6 +169,28 @@ MlasSQNBitGemmBatchWorkspaceSize(
     return WorkspaceSize + Alignment - 1;
 }
 
+size_t MLASCALL
+MlasSQNBitGemmQuantizedASize(
+    size_t M,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    const auto Variant = GetSQNBitGemmVariant(BlkBitWidth, BlkLen, ComputeType);
+
+    switch (Variant) {
+        case SQNBitGemmVariant_BitWidth4_CompInt8: {
+            // the quantized A is the per GEMM workspace of MlasSQNBitGemmBatch()
+            return SQNBitGemmPerGemmWorkspaceSize(Variant, M, 0, K, BlkLen);
+        }
+        default: {
+            return 0;
+        }
+    }
+}
+
 size_t MLASCALL
 MlasSQNBitGemmPackQuantBDataSize(
     size_t N,
@@ -403,7 +425,9 @@ SQ4BitGemm_CompInt8(
     const size_t ldb = k_blks * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
     const size_t k_blks_zp_bytes = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(k_blks);
 
-    const std::byte* QuantA = static_cast<const std::byte*>(PerGemmWorkspace) + RangeStartM * lda;
+    const std::byte* QuantA =
+        static_cast<const std::byte*>(DataParams->QuantA != nullptr ? DataParams->QuantA : PerGemmWorkspace) +
+        RangeStartM * lda;
 
     const std::byte* QuantBData = static_cast<const std::byte*>(DataParams->QuantBData) + RangeStartN * ldb;
     const float* QuantBScale = DataParams->QuantBScale + RangeStartN * k_blks;
@@ -512,6 +536,11 @@ InitializeWorkspace_CompInt8(
     MlasTrySimpleParallel(ThreadPool, BatchN, [&](ptrdiff_t gemm_idx) {
         const auto& data = DataParams[gemm_idx];
 
+        // A was quantized by MlasSQNBitGemmQuantizeA()
+        if (data.QuantA != nullptr) {
+            return;
+        }
+
         const float* ARowPtr = data.A;
         std::byte* QuantARowPtr = static_cast<std::byte*>(Workspace) + gemm_idx * PerGemmWorkspaceStride;
 
@@ -652,3 +681,30 @@ MlasSQNBitGemmBatch(
         ComputeOperation(BlkLen, K, Data, PerGemmWorkspace, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
     });
 }
+
+void MLASCALL
+MlasSQNBitGemmQuantizeA(
+    const size_t M,
+    const size_t K,
+    const size_t BlkBitWidth,
+    const size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const float* A,
+    const size_t lda,
+    void* QuantA,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    const auto Variant = GetSQNBitGemmVariant(BlkBitWidth, BlkLen, ComputeType);
+    assert(Variant == SQNBitGemmVariant_BitWidth4_CompInt8);
+    MLAS_UNREFERENCED_PARAMETER(Variant);
+
+    const auto QuantizeARow = GetMlasPlatform().SQNBitGemmDispatch->QuantizeARow_CompInt8;
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t QuantAStride = BlockCountK * Q8BlkSize(BlkLen);
+
+    MlasTrySimpleParallel(ThreadPool, M, [&](ptrdiff_t m) {
+        QuantizeARow(BlkLen, A + m * lda, K, static_cast<std::byte*>(QuantA) + m * QuantAStride);
+    });
+}
@@ -0,0 +1,667 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for x64 AVX2.
+
+--*/
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "sqnbitgemm.h"
+
+#if defined(MLAS_SQNBITGEMM_AVX2_KERNELS)
+
+#include "sqnbitgemm_kernel_avx_common.h"
+
+//
+// General helpers.
+//
+
+namespace
+{
+
+MLAS_FORCEINLINE __m128
+FoldAccumulators(const __m256& acc0, const __m256& acc1, const __m256& acc2, const __m256& acc3)
+{
+    // | a0_01 a0_23 a1_01 a1_23 | a0_45 a0_67 a1_45 a1_67 |
+    const __m256 acc01 = _mm256_hadd_ps(acc0, acc1);
+    // | a2_01 a2_23 a3_01 a3_23 | a2_45 a2_67 a3_45 a3_67 |
+    const __m256 acc23 = _mm256_hadd_ps(acc2, acc3);
+    // | a0_0123 a1_0123 a2_0123 a3_0123 | a0_4567 a1_4567 a2_4567 a3_4567 |
+    const __m256 acc0123 = _mm256_hadd_ps(acc01, acc23);
+
+    return _mm_add_ps(_mm256_castps256_ps128(acc0123), _mm256_extractf128_ps(acc0123, 1));
+}
+
+MLAS_FORCEINLINE float
+ReduceAdd(const __m256& v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+MLAS_FORCEINLINE float
+ReduceMax(const __m256& v)
+{
+    __m128 s = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_max_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+/**
+ * @brief Loads up to 8 floats. Elements at and beyond `count` are set to zero.
+ */
+MLAS_FORCEINLINE __m256
+LoadFloat8(const float* src, size_t count)
+{
+    if (count >= 8) {
+        return _mm256_loadu_ps(src);
+    }
+
+    const __m256i mask = _mm256_cmpgt_epi32(
+        _mm256_set1_epi32(static_cast<int>(count)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+    );
+    return _mm256_maskload_ps(src, mask);
+}
+
+template <size_t Capacity>
+MLAS_FORCEINLINE void
+LoadFloatData(const float* src, size_t count, __m256 (&dst)[Capacity / 8])
+{
+    static_assert(Capacity % 8 == 0, "Capacity must be divisible by 8.");
+
+    assert(count <= Capacity);
+
+    size_t vi = 0;  // vector index
+
+    while (count > 0) {
+        dst[vi] = LoadFloat8(src, count);
+
+        const size_t loaded = std::min(count, size_t{8});
+        vi += 1;
+        src += loaded;
+        count -= loaded;
+    }
+}
+
+/**
+ * @brief Unpacks a sub-block of packed 4-bit values (see SQ4BitGemmPackQuantBData()) into 8-bit values.
+ *        For SubBlkLen == 16, the low 16 bytes of the result are set. For SubBlkLen == 32, all 32 bytes are set.
+ */
+template <size_t SubBlkLen>
+MLAS_FORCEINLINE __m256i
+UnpackSubBlk4BitToU8(const std::byte* PackedSubBlk)
+{
+    static_assert(SubBlkLen == 16 || SubBlkLen == 32, "SubBlkLen must be 16 or 32");
+
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+
+    if constexpr (SubBlkLen == 16) {
+        const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(PackedSubBlk));
+        const __m128i lo = _mm_and_si128(packed, LowMask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), LowMask);
+        return _mm256_castsi128_si256(_mm_unpacklo_epi64(lo, hi));
+    } else {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(PackedSubBlk));
+        const __m128i lo = _mm_and_si128(packed, LowMask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), LowMask);
+        return _mm256_set_m128i(hi, lo);
+    }
+}
+
+}  // namespace
+
+//
+// CompFp32 kernel implementation.
+//
+
+namespace
+{
+
+template <size_t NCols, size_t SubBlkLen, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+ComputeDotProducts_BlkBitWidth4_CompFp32(
+    size_t BlkLen,
+    const float* ARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    static_assert(NCols == 1 || NCols == 4, "NCols must be 1 or 4");
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    __m256 acc[NCols];
+    UnrolledLoop<NCols>([&](size_t i) { acc[i] = _mm256_setzero_ps(); });
+
+    const std::byte* QuantBData = QuantBDataColPtr;
+    const float* QuantBScale = QuantBScaleColPtr;
+    [[maybe_unused]] size_t QuantBZeroPointIdx = 0;  // track half byte increments with this index instead of a pointer
+                                                     // only used if HasZeroPoint == true
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        __m256i zp_v[NCols];
+        UnrolledLoop<NCols>([&](size_t i) {
+            if constexpr (HasZeroPoint) {
+                zp_v[i] = _mm256_set1_epi32(
+                    Q4BitBlkZeroPoint(QuantBZeroPointColPtr + i * StrideQuantBZeroPoint, QuantBZeroPointIdx)
+                );
+            } else {
+                zp_v[i] = _mm256_set1_epi32(8);
+            }
+        });
+
+        // the block scale is applied once per block to the accumulated block dot product
+        __m256 blk_acc[NCols];
+        UnrolledLoop<NCols>([&](size_t i) { blk_acc[i] = _mm256_setzero_ps(); });
+
+        for (size_t k_idx_in_blk = 0; k_idx_in_blk < k_blk_len; k_idx_in_blk += SubBlkLen) {
+            // load `SubBlkLen` elements from A, padded with 0's if there aren't enough
+            const size_t k_subblk_len = std::min(k_blk_len - k_idx_in_blk, SubBlkLen);
+            __m256 av[SubBlkLen / 8]{};
+            LoadFloatData<SubBlkLen>(ARowPtr + k + k_idx_in_blk, k_subblk_len, av);
+
+            // load and convert `SubBlkLen` values of each B column
+            const size_t b_data_block_offset = k_idx_in_blk * BlkBitWidth / 8;
+
+            __m256 bv[NCols][SubBlkLen / 8];
+            UnrolledLoop<NCols>([&](size_t i) {
+                const __m256i bv_u8 =
+                    UnpackSubBlk4BitToU8<SubBlkLen>(QuantBData + i * StrideQuantBData + b_data_block_offset);
+
+                UnrolledLoop<SubBlkLen / 8>([&](size_t j) {
+                    // values [8 * j, 8 * j + 8) are in 128-bit lane j / 2, byte offset 8 * (j % 2)
+                    const __m128i bv_u8_lane = (j / 2 == 0)
+                                                   ? _mm256_castsi256_si128(bv_u8)
+                                                   : _mm256_extracti128_si256(bv_u8, 1);
+                    const __m128i bv_u8_8 = (j % 2 == 0) ? bv_u8_lane : _mm_srli_si128(bv_u8_lane, 8);
+
+                    // subtract zero point and convert to float
+                    const __m256i bv_s32 = _mm256_sub_epi32(_mm256_cvtepu8_epi32(bv_u8_8), zp_v[i]);
+                    bv[i][j] = _mm256_cvtepi32_ps(bv_s32);
+                });
+            });
+
+            // c[m,n] += a[m,k] * b[k,n]
+            UnrolledLoop<SubBlkLen / 8>([&](size_t j) {
+                UnrolledLoop<NCols>([&](size_t i) { blk_acc[i] = _mm256_fmadd_ps(av[j], bv[i][j], blk_acc[i]); });
+            });
+        }
+
+        // multiply by scale
+        UnrolledLoop<NCols>([&](size_t i) {
+            acc[i] = _mm256_fmadd_ps(blk_acc[i], _mm256_set1_ps(QuantBScale[i * StrideQuantBScale]), acc[i]);
+        });
+
+        // increment pointers to next block
+        QuantBData += MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+        QuantBScale += 1;
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointIdx += 1;
+        }
+    }
+
+    if constexpr (NCols == 4) {
+        __m128 sum = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+
+        if (BiasPtr != nullptr) {
+            sum = _mm_add_ps(sum, _mm_loadu_ps(BiasPtr));
+        }
+
+        _mm_storeu_ps(SumPtr, sum);
+    } else {
+        for (size_t i = 0; i < NCols; ++i) {
+            SumPtr[i] = ReduceAdd(acc[i]);
+            if (BiasPtr != nullptr) {
+                SumPtr[i] += BiasPtr[i];
+            }
+        }
+    }
+}
+
+template <size_t SubBlkLen, bool HasZeroPoint>
+void
+SQ4BitGemmM1Kernel_CompFp32_Impl(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+    constexpr size_t NCols = 4;
+
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockStrideQuantB;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    auto ComputeCols = [&](auto NColsTag, const std::byte* QuantBDataColPtr, const float* QuantBScaleColPtr,
+                           const std::byte* QuantBZeroPointColPtr, float* SumPtr, const float* BiasPtr) {
+        ComputeDotProducts_BlkBitWidth4_CompFp32<decltype(NColsTag)::value, SubBlkLen, HasZeroPoint>(
+            BlkLen,
+            A, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            BiasPtr
+        );
+    };
+
+    SQ4BitGemmM1KernelForEachColumn<NCols, HasZeroPoint>(
+        BlkLen, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, BlockStrideQuantB, Bias,
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, NCols>{}, Args...); },
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, 1>{}, Args...); }
+    );
+}
+
+template <bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQ4BitGemmM1Kernel_CompFp32_DispatchOnBlkLen(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (SQ4BitGemmPackedSubBlkLen(BlkLen) == 16) {
+        SQ4BitGemmM1Kernel_CompFp32_Impl<16, HasZeroPoint>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompFp32_Impl<32, HasZeroPoint>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+void
+SQ4BitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmM1Kernel_CompFp32_DispatchOnBlkLen<true>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompFp32_DispatchOnBlkLen<false>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+}  // namespace
+
+//
+// CompInt8 kernel implementation.
+//
+
+namespace
+{
+
+void
+QuantizeARow_CompInt8(
+    size_t BlkLen,
+    const float* A,
+    size_t CountK,
+    std::byte* QuantA
+)
+{
+    const __m256 SignMask = _mm256_set1_ps(-0.0f);
+    const __m256 Half = _mm256_set1_ps(0.5f);
+
+    const float* ADataBlkPtr = A;
+    std::byte* QuantABlkPtr = QuantA;
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        //
+        // Scan block values first to determine scale.
+        //
+
+        __m256 amax_v = _mm256_setzero_ps();
+
+        for (size_t kk = 0; kk < k_blk_len; kk += 8) {
+            const __m256 av = LoadFloat8(ADataBlkPtr + kk, k_blk_len - kk);
+            amax_v = _mm256_max_ps(amax_v, _mm256_andnot_ps(SignMask, av));
+        }
+
+        const float amax = ReduceMax(amax_v);  // max of absolute values of A block
+
+        constexpr float range_max = (1 << 7) - 1;
+        const float scale = amax / range_max;
+        const float scale_reciprocal = scale != 0.0f ? 1.0f / scale : 0.0f;
+
+        Q8BlkScale(QuantABlkPtr) = scale;
+
+        //
+        // Compute quantized block values.
+        //
+
+        int8_t* QuantAData = Q8BlkData(QuantABlkPtr);
+
+        const __m256 scale_reciprocal_v = _mm256_set1_ps(scale_reciprocal);
+
+        size_t kk = 0;
+        for (; kk < k_blk_len; kk += 8) {
+            __m256 av = LoadFloat8(ADataBlkPtr + kk, k_blk_len - kk);
+            av = _mm256_mul_ps(av, scale_reciprocal_v);
+
+            // round half away from zero
+            av = _mm256_add_ps(av, _mm256_or_ps(_mm256_and_ps(av, SignMask), Half));
+            const __m256i av_s32 = _mm256_cvttps_epi32(av);
+
+            const __m128i av_s16 =
+                _mm_packs_epi32(_mm256_castsi256_si128(av_s32), _mm256_extracti128_si256(av_s32, 1));
+            const __m128i av_s8 = _mm_packs_epi16(av_s16, av_s16);
+
+            // elements beyond `k_blk_len` were loaded as zero, and BlkLen is a multiple of 8
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(QuantAData + kk), av_s8);
+        }
+
+        //
+        // Zero out any remaining block elements.
+        //
+
+        std::fill(QuantAData + kk, QuantAData + BlkLen, int8_t{0});
+
+        ADataBlkPtr += BlkLen;
+        QuantABlkPtr += Q8BlkSize(BlkLen);
+    }
+}
+
+/**
+ * @brief Computes the int32 dot products of adjacent groups of four signed 8-bit values of `a` and `b`.
+ *        The values of `a` must be in [-127, 127].
+ */
+MLAS_FORCEINLINE __m256i
+DotQuadS8S8(const __m256i a, const __m256i b)
+{
+    // _mm256_maddubs_epi16 multiplies unsigned by signed values, so move the sign of `a` over to `b`
+    const __m256i a_abs = _mm256_sign_epi8(a, a);
+    const __m256i b_signed = _mm256_sign_epi8(b, a);
+    const __m256i dot_s16 = _mm256_maddubs_epi16(a_abs, b_signed);
+    return _mm256_madd_epi16(dot_s16, _mm256_set1_epi16(1));
+}
+
+template <size_t NCols, size_t SubBlkLen, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+ComputeDotProducts_BlkBitWidth4_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    static_assert(NCols == 1 || NCols == 4, "NCols must be 1 or 4");
+    static_assert(SubBlkLen == 16 || SubBlkLen == 32, "SubBlkLen must be 16 or 32");
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    const std::byte* QuantA = QuantARowPtr;
+
+    const std::byte* QuantBData = QuantBDataColPtr;
+    const float* QuantBScale = QuantBScaleColPtr;
+    [[maybe_unused]] size_t QuantBZeroPointIdx = 0;  // track half byte increments with this index instead of a pointer
+                                                     // only used if HasZeroPoint == true
+
+    __m256 acc[NCols];
+    UnrolledLoop<NCols>([&](size_t i) { acc[i] = _mm256_setzero_ps(); });
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        const float a_scale = Q8BlkScale(QuantA);
+        const int8_t* a_data = Q8BlkData(QuantA);
+
+        __m256i zp_v[NCols];
+        UnrolledLoop<NCols>([&](size_t i) {
+            if constexpr (HasZeroPoint) {
+                zp_v[i] = _mm256_set1_epi8(static_cast<char>(
+                    Q4BitBlkZeroPoint(QuantBZeroPointColPtr + i * StrideQuantBZeroPoint, QuantBZeroPointIdx)
+                ));
+            } else {
+                zp_v[i] = _mm256_set1_epi8(8);
+            }
+        });
+
+        // the int32 dot product of the whole block fits easily: |a| <= 127, |b - zp| <= 15, BlkLen <= 256
+        __m256i dot[NCols];
+        UnrolledLoop<NCols>([&](size_t i) { dot[i] = _mm256_setzero_si256(); });
+
+        for (size_t k_idx_in_blk = 0; k_idx_in_blk < k_blk_len; k_idx_in_blk += SubBlkLen) {
+            // load A row vector
+            // quantized A blocks are padded with zeros, so a full sub-block can always be loaded
+            __m256i av;
+            if constexpr (SubBlkLen == 16) {
+                av = _mm256_castsi128_si256(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_data + k_idx_in_blk))
+                );
+            } else {
+                av = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_data + k_idx_in_blk));
+            }
+
+            // load B column vectors, subtract zero point, and compute dot products
+            const size_t b_data_block_offset = k_idx_in_blk * BlkBitWidth / 8;
+
+            UnrolledLoop<NCols>([&](size_t i) {
+                __m256i bv = UnpackSubBlk4BitToU8<SubBlkLen>(
+                    QuantBData + i * StrideQuantBData + b_data_block_offset
+                );
+                bv = _mm256_sub_epi8(bv, zp_v[i]);
+
+                if constexpr (SubBlkLen == 16) {
+                    // only the low 128 bits hold sub-block values
+                    const __m128i a_lo = _mm256_castsi256_si128(av);
+                    const __m128i b_lo = _mm256_castsi256_si128(bv);
+                    const __m128i dot_s16 = _mm_maddubs_epi16(_mm_sign_epi8(a_lo, a_lo), _mm_sign_epi8(b_lo, a_lo));
+                    const __m128i dot_s32 = _mm_madd_epi16(dot_s16, _mm_set1_epi16(1));
+                    dot[i] = _mm256_add_epi32(dot[i], _mm256_inserti128_si256(_mm256_setzero_si256(), dot_s32, 0));
+                } else {
+                    dot[i] = _mm256_add_epi32(dot[i], DotQuadS8S8(av, bv));
+                }
+            });
+        }
+
+        // convert dot product result to float, multiply by scale, and update accumulator
+        UnrolledLoop<NCols>([&](size_t i) {
+            const __m256 scale_v = _mm256_set1_ps(a_scale * QuantBScale[i * StrideQuantBScale]);
+            acc[i] = _mm256_fmadd_ps(_mm256_cvtepi32_ps(dot[i]), scale_v, acc[i]);
+        });
+
+        // increment pointers to next block
+        QuantA += Q8BlkSize(BlkLen);
+        QuantBData += MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+        QuantBScale += 1;
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointIdx += 1;
+        }
+    }
+
+    if constexpr (NCols == 4) {
+        __m128 sum = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+
+        if (BiasPtr != nullptr) {
+            sum = _mm_add_ps(sum, _mm_loadu_ps(BiasPtr));
+        }
+
+        _mm_storeu_ps(SumPtr, sum);
+    } else {
+        for (size_t i = 0; i < NCols; ++i) {
+            SumPtr[i] = ReduceAdd(acc[i]);
+            if (BiasPtr != nullptr) {
+                SumPtr[i] += BiasPtr[i];
+            }
+        }
+    }
+}
+
+template <size_t SubBlkLen, bool HasZeroPoint>
+void
+SQ4BitGemmM1Kernel_CompInt8_Impl(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+    constexpr size_t NCols = 4;
+
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockStrideQuantB;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    auto ComputeCols = [&](auto NColsTag, const std::byte* QuantBDataColPtr, const float* QuantBScaleColPtr,
+                           const std::byte* QuantBZeroPointColPtr, float* SumPtr, const float* BiasPtr) {
+        ComputeDotProducts_BlkBitWidth4_CompInt8<decltype(NColsTag)::value, SubBlkLen, HasZeroPoint>(
+            BlkLen,
+            QuantA, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            BiasPtr
+        );
+    };
+
+    SQ4BitGemmM1KernelForEachColumn<NCols, HasZeroPoint>(
+        BlkLen, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, BlockStrideQuantB, Bias,
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, NCols>{}, Args...); },
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, 1>{}, Args...); }
+    );
+}
+
+template <bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQ4BitGemmM1Kernel_CompInt8_DispatchOnBlkLen(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (SQ4BitGemmPackedSubBlkLen(BlkLen) == 16) {
+        SQ4BitGemmM1Kernel_CompInt8_Impl<16, HasZeroPoint>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompInt8_Impl<32, HasZeroPoint>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+void
+SQ4BitGemmM1Kernel_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmM1Kernel_CompInt8_DispatchOnBlkLen<true>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompInt8_DispatchOnBlkLen<false>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+}  // namespace
+
+//
+// Kernel dispatch structure definition.
+//
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2 = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d;
+
+    d.SQ4BitGemmPackQuantBDataSize = SQ4BitGemmPackQuantBDataSize;
+    d.SQ4BitGemmPackQuantBData = SQ4BitGemmPackQuantBData;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32;
+    d.Q4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32;
+
+    d.SQ4BitGemmM1Kernel_CompInt8 = SQ4BitGemmM1Kernel_CompInt8;
+    d.QuantizeARow_CompInt8 = QuantizeARow_CompInt8;
+
+    return d;
+}();
+
+#endif  // defined(MLAS_SQNBITGEMM_AVX2_KERNELS)
@@ -0,0 +1,799 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_avx512.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for x64 AVX512 (AVX512F/BW/DQ/VL) and
+    AVX512VNNI.
+
+--*/
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "sqnbitgemm.h"
+
+#if defined(MLAS_SQNBITGEMM_AVX512_KERNELS)
+
+#include "sqnbitgemm_kernel_avx_common.h"
+
+//
+// General helpers.
+//
+
+namespace
+{
+
+/**
+ * @brief Horizontally sum 4 vectors and store the results in the returned vector.
+ */
+MLAS_FORCEINLINE __m128
+FoldAccumulators(const __m512& acc0, const __m512& acc1, const __m512& acc2, const __m512& acc3)
+{
+    __m512 acc_lo01 = _mm512_unpacklo_ps(acc0, acc1);
+    __m512 acc_hi01 = _mm512_unpackhi_ps(acc0, acc1);
+    __m512 acc_lo23 = _mm512_unpacklo_ps(acc2, acc3);
+    __m512 acc_hi23 = _mm512_unpackhi_ps(acc2, acc3);
+
+    __m512 acc_lo0123 = _mm512_castpd_ps(
+        _mm512_unpacklo_pd(_mm512_castps_pd(acc_lo01), _mm512_castps_pd(acc_lo23))
+    );
+    __m512 acc_hi0123 = _mm512_castpd_ps(
+        _mm512_unpackhi_pd(_mm512_castps_pd(acc_lo01), _mm512_castps_pd(acc_lo23))
+    );
+    acc_lo0123 = _mm512_add_ps(acc_lo0123, acc_hi0123);
+    acc_hi0123 = _mm512_castpd_ps(
+        _mm512_unpacklo_pd(_mm512_castps_pd(acc_hi01), _mm512_castps_pd(acc_hi23))
+    );
+    acc_lo0123 = _mm512_add_ps(acc_lo0123, acc_hi0123);
+    acc_hi0123 = _mm512_castpd_ps(
+        _mm512_unpackhi_pd(_mm512_castps_pd(acc_hi01), _mm512_castps_pd(acc_hi23))
+    );
+    acc_lo0123 = _mm512_add_ps(acc_lo0123, acc_hi0123);
+
+    __m256 acc_y =
+        _mm256_add_ps(_mm512_extractf32x8_ps(acc_lo0123, 0), _mm512_extractf32x8_ps(acc_lo0123, 1));
+    return _mm_add_ps(_mm256_extractf32x4_ps(acc_y, 0), _mm256_extractf32x4_ps(acc_y, 1));
+}
+
+/**
+ * @brief Loads up to 16 floats. Elements at and beyond `count` are set to zero.
+ */
+MLAS_FORCEINLINE __m512
+LoadFloat16(const float* src, size_t count)
+{
+    if (count >= 16) {
+        return _mm512_loadu_ps(src);
+    }
+
+    const __mmask16 mask = static_cast<__mmask16>((1u << count) - 1);
+    return _mm512_maskz_loadu_ps(mask, src);
+}
+
+template <size_t Capacity>
+MLAS_FORCEINLINE void
+LoadFloatData(const float* src, size_t count, __m512 (&dst)[Capacity / 16])
+{
+    static_assert(Capacity % 16 == 0, "Capacity must be divisible by 16.");
+
+    assert(count <= Capacity);
+
+    size_t vi = 0;  // vector index
+
+    while (count > 0) {
+        dst[vi] = LoadFloat16(src, count);
+
+        const size_t loaded = std::min(count, size_t{16});
+        vi += 1;
+        src += loaded;
+        count -= loaded;
+    }
+}
+
+/**
+ * @brief Unpacks `SubBlkLen` packed 4-bit values (see SQ4BitGemmPackQuantBData()) into 8-bit values, ordered the
+ *        same as the corresponding values of A.
+ *        For SubBlkLen == 64, two consecutive packed 32 value sub-blocks are unpacked.
+ */
+template <size_t SubBlkLen>
+MLAS_FORCEINLINE auto
+UnpackSubBlk4BitToU8(const std::byte* PackedSubBlk)
+{
+    static_assert(SubBlkLen == 16 || SubBlkLen == 32 || SubBlkLen == 64, "SubBlkLen must be 16, 32, or 64");
+
+    if constexpr (SubBlkLen == 16) {
+        const __m128i LowMask = _mm_set1_epi8(0x0F);
+        const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(PackedSubBlk));
+        const __m128i lo = _mm_and_si128(packed, LowMask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), LowMask);
+        return _mm_unpacklo_epi64(lo, hi);
+    } else if constexpr (SubBlkLen == 32) {
+        const __m128i LowMask = _mm_set1_epi8(0x0F);
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(PackedSubBlk));
+        const __m128i lo = _mm_and_si128(packed, LowMask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), LowMask);
+        return _mm256_set_m128i(hi, lo);
+    } else {
+        const __m256i LowMask = _mm256_set1_epi8(0x0F);
+        const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(PackedSubBlk));
+        // | sub-block 0 values [0, 16) | sub-block 1 values [0, 16) |
+        const __m256i lo = _mm256_and_si256(packed, LowMask);
+        // | sub-block 0 values [16, 32) | sub-block 1 values [16, 32) |
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(packed, 4), LowMask);
+        const __m256i v0 = _mm256_permute2x128_si256(lo, hi, 0x20);
+        const __m256i v1 = _mm256_permute2x128_si256(lo, hi, 0x31);
+        return _mm512_inserti64x4(_mm512_castsi256_si512(v0), v1, 1);
+    }
+}
+
+}  // namespace
+
+//
+// CompFp32 kernel implementation.
+//
+
+namespace
+{
+
+template <size_t NCols, size_t SubBlkLen, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+ComputeDotProducts_BlkBitWidth4_CompFp32(
+    size_t BlkLen,
+    const float* ARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    static_assert(NCols == 1 || NCols == 4, "NCols must be 1 or 4");
+    static_assert(SubBlkLen == 16 || SubBlkLen == 32, "SubBlkLen must be 16 or 32");
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    __m512 acc[NCols];
+    UnrolledLoop<NCols>([&](size_t i) { acc[i] = _mm512_setzero_ps(); });
+
+    const std::byte* QuantBData = QuantBDataColPtr;
+    const float* QuantBScale = QuantBScaleColPtr;
+    [[maybe_unused]] size_t QuantBZeroPointIdx = 0;  // track half byte increments with this index instead of a pointer
+                                                     // only used if HasZeroPoint == true
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        __m512i zp_v[NCols];
+        UnrolledLoop<NCols>([&](size_t i) {
+            if constexpr (HasZeroPoint) {
+                zp_v[i] = _mm512_set1_epi32(
+                    Q4BitBlkZeroPoint(QuantBZeroPointColPtr + i * StrideQuantBZeroPoint, QuantBZeroPointIdx)
+                );
+            } else {
+                zp_v[i] = _mm512_set1_epi32(8);
+            }
+        });
+
+        // the block scale is applied once per block to the accumulated block dot product
+        __m512 blk_acc[NCols];
+        UnrolledLoop<NCols>([&](size_t i) { blk_acc[i] = _mm512_setzero_ps(); });
+
+        for (size_t k_idx_in_blk = 0; k_idx_in_blk < k_blk_len; k_idx_in_blk += SubBlkLen) {
+            // load `SubBlkLen` elements from A, padded with 0's if there aren't enough
+            const size_t k_subblk_len = std::min(k_blk_len - k_idx_in_blk, SubBlkLen);
+            __m512 av[SubBlkLen / 16]{};
+            LoadFloatData<SubBlkLen>(ARowPtr + k + k_idx_in_blk, k_subblk_len, av);
+
+            // load and convert `SubBlkLen` values of each B column
+            const size_t b_data_block_offset = k_idx_in_blk * BlkBitWidth / 8;
+
+            __m512 bv[NCols][SubBlkLen / 16];
+            UnrolledLoop<NCols>([&](size_t i) {
+                const auto bv_u8 =
+                    UnpackSubBlk4BitToU8<SubBlkLen>(QuantBData + i * StrideQuantBData + b_data_block_offset);
+
+                __m128i bv_u8_16[SubBlkLen / 16];
+                if constexpr (SubBlkLen == 16) {
+                    bv_u8_16[0] = bv_u8;
+                } else {
+                    bv_u8_16[0] = _mm256_castsi256_si128(bv_u8);
+                    bv_u8_16[1] = _mm256_extracti128_si256(bv_u8, 1);
+                }
+
+                // subtract zero point and convert to float
+                UnrolledLoop<SubBlkLen / 16>([&](size_t j) {
+                    const __m512i bv_s32 = _mm512_sub_epi32(_mm512_cvtepu8_epi32(bv_u8_16[j]), zp_v[i]);
+                    bv[i][j] = _mm512_cvtepi32_ps(bv_s32);
+                });
+            });
+
+            // c[m,n] += a[m,k] * b[k,n]
+            UnrolledLoop<SubBlkLen / 16>([&](size_t j) {
+                UnrolledLoop<NCols>([&](size_t i) { blk_acc[i] = _mm512_fmadd_ps(av[j], bv[i][j], blk_acc[i]); });
+            });
+        }
+
+        // multiply by scale
+        UnrolledLoop<NCols>([&](size_t i) {
+            acc[i] = _mm512_fmadd_ps(blk_acc[i], _mm512_set1_ps(QuantBScale[i * StrideQuantBScale]), acc[i]);
+        });
+
+        // increment pointers to next block
+        QuantBData += MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+        QuantBScale += 1;
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointIdx += 1;
+        }
+    }
+
+    if constexpr (NCols == 4) {
+        __m128 sum = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+
+        if (BiasPtr != nullptr) {
+            sum = _mm_add_ps(sum, _mm_loadu_ps(BiasPtr));
+        }
+
+        _mm_storeu_ps(SumPtr, sum);
+    } else {
+        for (size_t i = 0; i < NCols; ++i) {
+            SumPtr[i] = _mm512_reduce_add_ps(acc[i]);
+            if (BiasPtr != nullptr) {
+                SumPtr[i] += BiasPtr[i];
+            }
+        }
+    }
+}
+
+template <size_t SubBlkLen, bool HasZeroPoint>
+void
+SQ4BitGemmM1Kernel_CompFp32_Impl(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+    constexpr size_t NCols = 4;
+
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockStrideQuantB;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    auto ComputeCols = [&](auto NColsTag, const std::byte* QuantBDataColPtr, const float* QuantBScaleColPtr,
+                           const std::byte* QuantBZeroPointColPtr, float* SumPtr, const float* BiasPtr) {
+        ComputeDotProducts_BlkBitWidth4_CompFp32<decltype(NColsTag)::value, SubBlkLen, HasZeroPoint>(
+            BlkLen,
+            A, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            BiasPtr
+        );
+    };
+
+    SQ4BitGemmM1KernelForEachColumn<NCols, HasZeroPoint>(
+        BlkLen, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, BlockStrideQuantB, Bias,
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, NCols>{}, Args...); },
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, 1>{}, Args...); }
+    );
+}
+
+template <bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQ4BitGemmM1Kernel_CompFp32_DispatchOnBlkLen(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (SQ4BitGemmPackedSubBlkLen(BlkLen) == 16) {
+        SQ4BitGemmM1Kernel_CompFp32_Impl<16, HasZeroPoint>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompFp32_Impl<32, HasZeroPoint>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+void
+SQ4BitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmM1Kernel_CompFp32_DispatchOnBlkLen<true>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompFp32_DispatchOnBlkLen<false>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+}  // namespace
+
+//
+// CompInt8 kernel implementation.
+//
+
+namespace
+{
+
+void
+QuantizeARow_CompInt8(
+    size_t BlkLen,
+    const float* A,
+    size_t CountK,
+    std::byte* QuantA
+)
+{
+    const __m512 SignMask = _mm512_set1_ps(-0.0f);
+    const __m512 Half = _mm512_set1_ps(0.5f);
+
+    const float* ADataBlkPtr = A;
+    std::byte* QuantABlkPtr = QuantA;
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        //
+        // Scan block values first to determine scale.
+        //
+
+        __m512 amax_v = _mm512_setzero_ps();
+
+        for (size_t kk = 0; kk < k_blk_len; kk += 16) {
+            const __m512 av = LoadFloat16(ADataBlkPtr + kk, k_blk_len - kk);
+            amax_v = _mm512_max_ps(amax_v, _mm512_abs_ps(av));
+        }
+
+        const float amax = _mm512_reduce_max_ps(amax_v);  // max of absolute values of A block
+
+        constexpr float range_max = (1 << 7) - 1;
+        const float scale = amax / range_max;
+        const float scale_reciprocal = scale != 0.0f ? 1.0f / scale : 0.0f;
+
+        Q8BlkScale(QuantABlkPtr) = scale;
+
+        //
+        // Compute quantized block values.
+        //
+
+        int8_t* QuantAData = Q8BlkData(QuantABlkPtr);
+
+        const __m512 scale_reciprocal_v = _mm512_set1_ps(scale_reciprocal);
+
+        size_t kk = 0;
+        for (; kk < k_blk_len; kk += 16) {
+            __m512 av = LoadFloat16(ADataBlkPtr + kk, k_blk_len - kk);
+            av = _mm512_mul_ps(av, scale_reciprocal_v);
+
+            // round half away from zero
+            av = _mm512_add_ps(av, _mm512_or_ps(_mm512_and_ps(av, SignMask), Half));
+            const __m512i av_s32 = _mm512_cvttps_epi32(av);
+
+            // elements beyond `k_blk_len` were loaded as zero, and BlkLen is a multiple of 16
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(QuantAData + kk), _mm512_cvtsepi32_epi8(av_s32));
+        }
+
+        //
+        // Zero out any remaining block elements.
+        //
+
+        std::fill(QuantAData + kk, QuantAData + BlkLen, int8_t{0});
+
+        ADataBlkPtr += BlkLen;
+        QuantABlkPtr += Q8BlkSize(BlkLen);
+    }
+}
+
+//
+// Accumulates the int32 dot products of adjacent groups of four signed 8-bit values of `a` and `b` into `acc`.
+// The values of `a` must be in [-127, 127].
+//
+// The unsigned by signed multiply instructions are used, so the sign of `a` is moved over to `b` first.
+//
+
+template <bool Vnni>
+MLAS_FORCEINLINE __m128i
+DotQuadS8S8Accumulate(const __m128i acc, const __m128i a, const __m128i b)
+{
+    const __m128i a_abs = _mm_sign_epi8(a, a);
+    const __m128i b_signed = _mm_sign_epi8(b, a);
+    if constexpr (Vnni) {
+        return _mm_dpbusd_epi32(acc, a_abs, b_signed);
+    } else {
+        return _mm_add_epi32(acc, _mm_madd_epi16(_mm_maddubs_epi16(a_abs, b_signed), _mm_set1_epi16(1)));
+    }
+}
+
+template <bool Vnni>
+MLAS_FORCEINLINE __m256i
+DotQuadS8S8Accumulate(const __m256i acc, const __m256i a, const __m256i b)
+{
+    const __m256i a_abs = _mm256_sign_epi8(a, a);
+    const __m256i b_signed = _mm256_sign_epi8(b, a);
+    if constexpr (Vnni) {
+        return _mm256_dpbusd_epi32(acc, a_abs, b_signed);
+    } else {
+        return _mm256_add_epi32(
+            acc, _mm256_madd_epi16(_mm256_maddubs_epi16(a_abs, b_signed), _mm256_set1_epi16(1))
+        );
+    }
+}
+
+template <bool Vnni>
+MLAS_FORCEINLINE __m512i
+DotQuadS8S8Accumulate(const __m512i acc, const __m512i a, const __m512i b)
+{
+    const __m512i a_abs = _mm512_abs_epi8(a);
+    const __m512i b_signed = _mm512_mask_sub_epi8(b, _mm512_movepi8_mask(a), _mm512_setzero_si512(), b);
+    if constexpr (Vnni) {
+        return _mm512_dpbusd_epi32(acc, a_abs, b_signed);
+    } else {
+        return _mm512_add_epi32(
+            acc, _mm512_madd_epi16(_mm512_maddubs_epi16(a_abs, b_signed), _mm512_set1_epi16(1))
+        );
+    }
+}
+
+//
+// Overloads on the vector type, used by the width-generic CompInt8 kernel below.
+//
+
+MLAS_FORCEINLINE __m128i
+LoadS8(const int8_t* p, __m128i)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+MLAS_FORCEINLINE __m256i
+LoadS8(const int8_t* p, __m256i)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+MLAS_FORCEINLINE __m512i
+LoadS8(const int8_t* p, __m512i)
+{
+    return _mm512_loadu_si512(p);
+}
+
+MLAS_FORCEINLINE __m128i
+Set1S8(int8_t v, __m128i)
+{
+    return _mm_set1_epi8(v);
+}
+
+MLAS_FORCEINLINE __m256i
+Set1S8(int8_t v, __m256i)
+{
+    return _mm256_set1_epi8(v);
+}
+
+MLAS_FORCEINLINE __m512i
+Set1S8(int8_t v, __m512i)
+{
+    return _mm512_set1_epi8(v);
+}
+
+MLAS_FORCEINLINE __m128i
+SubS8(__m128i a, __m128i b)
+{
+    return _mm_sub_epi8(a, b);
+}
+
+MLAS_FORCEINLINE __m256i
+SubS8(__m256i a, __m256i b)
+{
+    return _mm256_sub_epi8(a, b);
+}
+
+MLAS_FORCEINLINE __m512i
+SubS8(__m512i a, __m512i b)
+{
+    return _mm512_sub_epi8(a, b);
+}
+
+// Converts int32 values to float, zero extending to 512 bits.
+
+MLAS_FORCEINLINE __m512
+ToFloat512(__m128i v)
+{
+    return _mm512_zextps128_ps512(_mm_cvtepi32_ps(v));
+}
+
+MLAS_FORCEINLINE __m512
+ToFloat512(__m256i v)
+{
+    return _mm512_zextps256_ps512(_mm256_cvtepi32_ps(v));
+}
+
+MLAS_FORCEINLINE __m512
+ToFloat512(__m512i v)
+{
+    return _mm512_cvtepi32_ps(v);
+}
+
+template <size_t NCols, size_t SubBlkLen, bool HasZeroPoint, bool Vnni>
+MLAS_FORCEINLINE void
+ComputeDotProducts_BlkBitWidth4_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    static_assert(NCols == 1 || NCols == 4, "NCols must be 1 or 4");
+    static_assert(SubBlkLen == 16 || SubBlkLen == 32 || SubBlkLen == 64, "SubBlkLen must be 16, 32, or 64");
+
+    // the vector type holding `SubBlkLen` 8-bit values
+    using VecS8 = decltype(UnpackSubBlk4BitToU8<SubBlkLen>(nullptr));
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    const std::byte* QuantA = QuantARowPtr;
+
+    const std::byte* QuantBData = QuantBDataColPtr;
+    const float* QuantBScale = QuantBScaleColPtr;
+    [[maybe_unused]] size_t QuantBZeroPointIdx = 0;  // track half byte increments with this index instead of a pointer
+                                                     // only used if HasZeroPoint == true
+
+    __m512 acc[NCols];
+    UnrolledLoop<NCols>([&](size_t i) { acc[i] = _mm512_setzero_ps(); });
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        const float a_scale = Q8BlkScale(QuantA);
+        const int8_t* a_data = Q8BlkData(QuantA);
+
+        VecS8 zp_v[NCols];
+        UnrolledLoop<NCols>([&](size_t i) {
+            if constexpr (HasZeroPoint) {
+                zp_v[i] = Set1S8(
+                    static_cast<int8_t>(
+                        Q4BitBlkZeroPoint(QuantBZeroPointColPtr + i * StrideQuantBZeroPoint, QuantBZeroPointIdx)
+                    ),
+                    VecS8{}
+                );
+            } else {
+                zp_v[i] = Set1S8(8, VecS8{});
+            }
+        });
+
+        // the int32 dot product of the whole block fits easily: |a| <= 127, |b - zp| <= 15, BlkLen <= 256
+        VecS8 dot[NCols];
+        UnrolledLoop<NCols>([&](size_t i) { dot[i] = VecS8{}; });
+
+        for (size_t k_idx_in_blk = 0; k_idx_in_blk < k_blk_len; k_idx_in_blk += SubBlkLen) {
+            // load A row vector
+            // quantized A blocks are padded with zeros, so a full sub-block can always be loaded
+            const VecS8 av = LoadS8(a_data + k_idx_in_blk, VecS8{});
+
+            // load B column vectors, subtract zero point, and compute dot products
+            const size_t b_data_block_offset = k_idx_in_blk * BlkBitWidth / 8;
+
+            UnrolledLoop<NCols>([&](size_t i) {
+                VecS8 bv = UnpackSubBlk4BitToU8<SubBlkLen>(QuantBData + i * StrideQuantBData + b_data_block_offset);
+                bv = SubS8(bv, zp_v[i]);
+                dot[i] = DotQuadS8S8Accumulate<Vnni>(dot[i], av, bv);
+            });
+        }
+
+        // convert dot product result to float, multiply by scale, and update accumulator
+        UnrolledLoop<NCols>([&](size_t i) {
+            const __m512 scale_v = _mm512_set1_ps(a_scale * QuantBScale[i * StrideQuantBScale]);
+            acc[i] = _mm512_fmadd_ps(ToFloat512(dot[i]), scale_v, acc[i]);
+        });
+
+        // increment pointers to next block
+        QuantA += Q8BlkSize(BlkLen);
+        QuantBData += MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+        QuantBScale += 1;
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointIdx += 1;
+        }
+    }
+
+    if constexpr (NCols == 4) {
+        __m128 sum = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+
+        if (BiasPtr != nullptr) {
+            sum = _mm_add_ps(sum, _mm_loadu_ps(BiasPtr));
+        }
+
+        _mm_storeu_ps(SumPtr, sum);
+    } else {
+        for (size_t i = 0; i < NCols; ++i) {
+            SumPtr[i] = _mm512_reduce_add_ps(acc[i]);
+            if (BiasPtr != nullptr) {
+                SumPtr[i] += BiasPtr[i];
+            }
+        }
+    }
+}
+
+template <size_t SubBlkLen, bool HasZeroPoint, bool Vnni>
+void
+SQ4BitGemmM1Kernel_CompInt8_Impl(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+    constexpr size_t NCols = 4;
+
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockStrideQuantB;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    auto ComputeCols = [&](auto NColsTag, const std::byte* QuantBDataColPtr, const float* QuantBScaleColPtr,
+                           const std::byte* QuantBZeroPointColPtr, float* SumPtr, const float* BiasPtr) {
+        ComputeDotProducts_BlkBitWidth4_CompInt8<decltype(NColsTag)::value, SubBlkLen, HasZeroPoint, Vnni>(
+            BlkLen,
+            QuantA, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            BiasPtr
+        );
+    };
+
+    SQ4BitGemmM1KernelForEachColumn<NCols, HasZeroPoint>(
+        BlkLen, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, BlockStrideQuantB, Bias,
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, NCols>{}, Args...); },
+        [&](auto... Args) { ComputeCols(std::integral_constant<size_t, 1>{}, Args...); }
+    );
+}
+
+template <bool HasZeroPoint, bool Vnni>
+MLAS_FORCEINLINE void
+SQ4BitGemmM1Kernel_CompInt8_DispatchOnBlkLen(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    // For BlkLen >= 64, two adjacent packed 32 value sub-blocks fill a 512-bit vector.
+    if (BlkLen == 16) {
+        SQ4BitGemmM1Kernel_CompInt8_Impl<16, HasZeroPoint, Vnni>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else if (BlkLen == 32) {
+        SQ4BitGemmM1Kernel_CompInt8_Impl<32, HasZeroPoint, Vnni>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompInt8_Impl<64, HasZeroPoint, Vnni>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+template <bool Vnni>
+void
+SQ4BitGemmM1Kernel_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmM1Kernel_CompInt8_DispatchOnBlkLen<true, Vnni>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQ4BitGemmM1Kernel_CompInt8_DispatchOnBlkLen<false, Vnni>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+}  // namespace
+
+//
+// Kernel dispatch structure definitions.
+//
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512 = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d;
+
+    d.SQ4BitGemmPackQuantBDataSize = SQ4BitGemmPackQuantBDataSize;
+    d.SQ4BitGemmPackQuantBData = SQ4BitGemmPackQuantBData;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32;
+    d.Q4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32;
+
+    d.SQ4BitGemmM1Kernel_CompInt8 = SQ4BitGemmM1Kernel_CompInt8</* Vnni */ false>;
+    d.QuantizeARow_CompInt8 = QuantizeARow_CompInt8;
+
+    return d;
+}();
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d;
+
+    d.SQ4BitGemmPackQuantBDataSize = SQ4BitGemmPackQuantBDataSize;
+    d.SQ4BitGemmPackQuantBData = SQ4BitGemmPackQuantBData;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32;
+    d.Q4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32;
+
+    d.SQ4BitGemmM1Kernel_CompInt8 = SQ4BitGemmM1Kernel_CompInt8</* Vnni */ true>;
+    d.QuantizeARow_CompInt8 = QuantizeARow_CompInt8;
+
+    return d;
+}();
+
+#endif  // defined(MLAS_SQNBITGEMM_AVX512_KERNELS)
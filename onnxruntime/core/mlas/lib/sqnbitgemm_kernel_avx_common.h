@@ -0,0 +1,327 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_avx_common.h
+
+Abstract:
+
+    This module includes the quantized B data packing and dequantization
+    functions shared by the x64 AVX2 and AVX512 implementations of the
+    float/quantized n-bit integer matrix multiplication kernels.
+
+    Each source file including this header is compiled with its own set of
+    target ISA flags, so everything here has internal linkage.
+
+--*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "sqnbitgemm.h"
+
+namespace
+{
+
+//
+// General helpers.
+//
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+//
+// Quantized B data packing function implementation.
+//
+
+/**
+ * @brief Gets the number of 4-bit values in a packed sub-block of a block of quantized B data.
+ *        On x64, the same packed layout is used for both the CompFp32 and CompInt8 kernels.
+ */
+constexpr MLAS_FORCEINLINE size_t
+SQ4BitGemmPackedSubBlkLen(size_t BlkLen)
+{
+    return (BlkLen == 16) ? 16 : 32;
+}
+
+size_t
+SQ4BitGemmPackQuantBDataSize(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);  // same size regardless of ComputeType
+
+    constexpr size_t BlkBitWidth = 4;
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t PackedQuantBDataSize = N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    return PackedQuantBDataSize;
+}
+
+void
+SQ4BitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);  // same layout regardless of ComputeType
+
+    constexpr size_t BlkBitWidth = 4;
+
+    assert(BlkLen >= 16 && BlkLen % 16 == 0);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t Iterations = N * BlockCountK;  // one iteration per block
+
+    const size_t SubBlkLen = SQ4BitGemmPackedSubBlkLen(BlkLen);
+
+    const size_t SubBlkDataSize = SubBlkLen / 2;
+    const size_t SubBlkBytePairCount = SubBlkLen / 4;
+
+    //
+    // Pack `SubBlkLen` 4-bit values at a time so that the low nibbles of the packed bytes hold the first half of
+    // the sub-block and the high nibbles hold the second half. A single mask and a single shift then unpack the
+    // sub-block into two runs of consecutive values.
+    //
+    // For SubBlkLen == 16, pack 16 4-bit values (8 bytes) at a time like this:
+    //
+    // src: | v0 v1 | v2 v3 | v4 v5 | v6 v7 | v8 v9 | vA vB | vC vD | vE vF |
+    //   =>
+    // dst: | v0 v8 | v1 v9 | v2 vA | v3 vB | v4 vC | v5 vD | v6 vE | v7 vF |
+    //
+    // For SubBlkLen == 32, pack 32 4-bit values (16 bytes) at a time like this:
+    //
+    // src: | v0  v1  | v2  v3  | ... | v28 v29 | v30 v31 |
+    //   =>
+    // dst: | v0  v16 | v1  v17 | ... | v14 v30 | v15 v31 |
+    //
+
+    MlasTrySimpleParallel(
+        ThreadPool, Iterations,
+        [&](ptrdiff_t tid) {
+            const size_t n = tid / BlockCountK;
+            const size_t k_blk = tid % BlockCountK;
+
+            const size_t data_offset = n * BlockCountK * BlkDataSize + k_blk * BlkDataSize;
+            const std::byte* QuantBData = QuantBDataBegin + data_offset;
+            std::byte* PackedQuantBData = PackedQuantBDataBegin + data_offset;
+
+            for (size_t kk = 0; kk < BlkLen; kk += SubBlkLen) {
+                for (size_t byte_pair_idx = 0; byte_pair_idx < SubBlkBytePairCount; ++byte_pair_idx) {
+                    const std::byte src0 = QuantBData[byte_pair_idx];
+                    const std::byte src1 = QuantBData[byte_pair_idx + SubBlkDataSize / 2];
+
+                    std::byte& dst0 = PackedQuantBData[2 * byte_pair_idx];
+                    std::byte& dst1 = PackedQuantBData[2 * byte_pair_idx + 1];
+
+                    dst0 = (src0 & std::byte{0x0F}) | ((src1 & std::byte{0x0F}) << 4);
+                    dst1 = (src0 >> 4) | ((src1 >> 4) << 4);
+                }
+
+                QuantBData += SubBlkDataSize;
+                PackedQuantBData += SubBlkDataSize;
+            }
+        }
+    );
+}
+
+//
+// M=1 kernel helpers.
+//
+
+/**
+ * @brief Steps through the columns of quantized B for an M=1 kernel, `NCols` columns at a time and then one column
+ *        at a time for any remaining columns.
+ *
+ *        `ComputeNCols` and `Compute1Col` are invoked as
+ *          f(QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, BiasPtr)
+ *        and compute `NCols` or one output value(s) respectively.
+ */
+template <size_t NCols, bool HasZeroPoint, typename ComputeNColsFn, typename Compute1ColFn>
+MLAS_FORCEINLINE void
+SQ4BitGemmM1KernelForEachColumn(
+    size_t BlkLen,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t BlockStrideQuantB,
+    const float* Bias,
+    ComputeNColsFn&& ComputeNCols,
+    Compute1ColFn&& Compute1Col
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    const size_t BlockCountK = BlockStrideQuantB;
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    const float* BiasPtr = Bias;
+
+    const std::byte* QuantBDataColPtr = QuantBData;
+    const float* QuantBScaleColPtr = QuantBScale;
+    const std::byte* QuantBZeroPointColPtr = QuantBZeroPoint;
+
+    float* SumPtr = C;
+
+    int64_t nblk = static_cast<int64_t>(CountN) - NCols;
+
+    while (nblk >= 0) {
+        ComputeNCols(QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, BiasPtr);
+
+        // move to next `NCols` columns
+
+        QuantBDataColPtr += NCols * StrideQuantBData;
+        QuantBScaleColPtr += NCols * StrideQuantBScale;
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointColPtr += NCols * StrideQuantBZeroPoint;
+        }
+
+        BiasPtr += BiasPtr != nullptr ? NCols : 0;
+        SumPtr += NCols;
+
+        nblk -= NCols;
+    }
+
+    // left over columns less than `NCols`?
+    nblk += NCols;
+    for (int64_t n = 0; n < nblk; ++n) {
+        Compute1Col(QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, BiasPtr);
+
+        // move to next column
+
+        QuantBDataColPtr += StrideQuantBData;
+        QuantBScaleColPtr += StrideQuantBScale;
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointColPtr += StrideQuantBZeroPoint;
+        }
+
+        BiasPtr += BiasPtr != nullptr ? 1 : 0;
+        SumPtr += 1;
+    }
+}
+
+/**
+ * @brief Gets the 4-bit zero point of block `BlkIdx` from a column of packed zero points.
+ */
+MLAS_FORCEINLINE int
+Q4BitBlkZeroPoint(const std::byte* QuantBZeroPointColPtr, size_t BlkIdx)
+{
+    const std::byte zp_packed = QuantBZeroPointColPtr[BlkIdx / 2];
+    return ((BlkIdx & 1) == 1)
+               ? std::to_integer<int>(zp_packed >> 4)
+               : std::to_integer<int>(zp_packed & std::byte{0x0F});
+}
+
+//
+// CompFp32 dequantization implementation.
+//
+
+void
+Q4BitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    // The Sgemm kernels consume B packed into panels of 16 columns (see MlasSgemmCopyPackB).
+    constexpr size_t PanelN = 16;
+
+    const size_t SubBlkLen = SQ4BitGemmPackedSubBlkLen(BlkLen);
+
+    float* Dst = FpData;
+
+    const std::byte* QuantBDataCol = QuantBData;
+    const float* QuantBScaleCol = QuantBScale;
+    const std::byte* QuantBZeroPointCol = QuantBZeroPoint;
+
+    for (size_t n = 0; n < CountN; n += PanelN) {
+        const size_t nnlen = std::min(CountN - n, PanelN);
+
+        for (size_t nn = 0; nn < nnlen; ++nn) {
+            for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, k_blk_idx += 1) {
+                const size_t kklen = std::min(CountK - k, BlkLen);
+
+                const std::byte* b_data =
+                    QuantBDataCol + k_blk_idx * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+                const float b_s = QuantBScaleCol[k_blk_idx];
+                const int b_z =
+                    (QuantBZeroPointCol != nullptr)
+                        ? ((k_blk_idx & 1) == 1)
+                              ? std::to_integer<int>(QuantBZeroPointCol[k_blk_idx / 2] >> 4)
+                              : std::to_integer<int>(QuantBZeroPointCol[k_blk_idx / 2] & std::byte{0x0F})
+                        : 8;
+
+                for (size_t kk = 0; kk < kklen; ++kk) {
+                    const size_t packed_idx = kk % SubBlkLen;
+
+                    const bool is_low_half = packed_idx < (SubBlkLen / 2);
+                    const size_t packed_byte_idx = packed_idx % (SubBlkLen / 2);
+                    const size_t packed_range_offset = (kk / SubBlkLen) * (SubBlkLen / 2);
+
+                    const std::byte b_packed = b_data[packed_range_offset + packed_byte_idx];
+                    const std::byte b_byte = is_low_half ? (b_packed & std::byte{0x0F}) : (b_packed >> 4);
+                    const float b_value = (std::to_integer<int>(b_byte) - b_z) * b_s;
+
+                    Dst[(k + kk) * PanelN + nn] = b_value;
+                }
+            }
+
+            QuantBDataCol += BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+            QuantBScaleCol += BlockStrideQuantB;
+            if (QuantBZeroPointCol != nullptr) {
+                QuantBZeroPointCol += MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+            }
+        }
+
+        // zero out any remaining columns
+
+        if (nnlen < PanelN) {
+            for (size_t k = 0; k < CountK; ++k) {
+                std::fill_n(Dst + (k * PanelN) + nnlen, PanelN - nnlen, 0.0f);
+            }
+        }
+
+        Dst += CountK * PanelN;
+    }
+}
+
+}  // namespace
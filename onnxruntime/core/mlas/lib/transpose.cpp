@@ -16,6 +16,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <vector>
+
 #if defined(MLAS_SSE2_INTRINSICS)
 
 MLAS_FORCEINLINE
@@ -74,6 +76,52 @@ MlasTranspose4x4Block(
     _mm_storeh_pi((__m64*)&Output[OutputStride * 3], _mm_castsi128_ps(c1));
 }
 
+MLAS_FORCEINLINE
+void
+MlasTranspose8x8Block(
+    const uint16_t* Input,
+    size_t InputStride,
+    uint16_t* Output,
+    size_t OutputStride
+    )
+{
+    __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 0]);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 1]);
+    __m128i a2 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 2]);
+    __m128i a3 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 3]);
+    __m128i a4 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 4]);
+    __m128i a5 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 5]);
+    __m128i a6 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 6]);
+    __m128i a7 = _mm_loadu_si128((const __m128i*)&Input[InputStride * 7]);
+
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+    __m128i b4 = _mm_unpacklo_epi16(a4, a5);
+    __m128i b5 = _mm_unpackhi_epi16(a4, a5);
+    __m128i b6 = _mm_unpacklo_epi16(a6, a7);
+    __m128i b7 = _mm_unpackhi_epi16(a6, a7);
+
+    __m128i c0 = _mm_unpacklo_epi32(b0, b2);
+    __m128i c1 = _mm_unpackhi_epi32(b0, b2);
+    __m128i c2 = _mm_unpacklo_epi32(b1, b3);
+    __m128i c3 = _mm_unpackhi_epi32(b1, b3);
+    __m128i c4 = _mm_unpacklo_epi32(b4, b6);
+    __m128i c5 = _mm_unpackhi_epi32(b4, b6);
+    __m128i c6 = _mm_unpacklo_epi32(b5, b7);
+    __m128i c7 = _mm_unpackhi_epi32(b5, b7);
+
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 0], _mm_unpacklo_epi64(c0, c4));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 1], _mm_unpackhi_epi64(c0, c4));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 2], _mm_unpacklo_epi64(c1, c5));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 3], _mm_unpackhi_epi64(c1, c5));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 4], _mm_unpacklo_epi64(c2, c6));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 5], _mm_unpackhi_epi64(c2, c6));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 6], _mm_unpacklo_epi64(c3, c7));
+    _mm_storeu_si128((__m128i*)&Output[OutputStride * 7], _mm_unpackhi_epi64(c3, c7));
+}
+
 MLAS_FORCEINLINE
 void
 MlasTranspose8x8Block(
@@ -486,6 +534,111 @@ MlasTranspose8x8Block(
     __lsx_vst(__lsx_vinsgr2vr_d(__lsx_vld((__m128i *)&Output[OutputStride * 7], 0), __lsx_vpickve2gr_d(d3, 1), 0), (__m128i *)&Output[OutputStride * 7], 0);
 }
 
+#elif defined(MLAS_WASM_SIMD_INTRINSICS)
+
+MLAS_FORCEINLINE
+void
+MlasTranspose4x4Block(
+    const uint32_t* Input,
+    size_t InputStride,
+    uint32_t* Output,
+    size_t OutputStride
+    )
+{
+    v128_t a0 = wasm_v128_load(&Input[InputStride * 0]);
+    v128_t a1 = wasm_v128_load(&Input[InputStride * 1]);
+    v128_t a2 = wasm_v128_load(&Input[InputStride * 2]);
+    v128_t a3 = wasm_v128_load(&Input[InputStride * 3]);
+
+    v128_t b0 = wasm_i32x4_shuffle(a0, a1, 0, 4, 1, 5);
+    v128_t b1 = wasm_i32x4_shuffle(a0, a1, 2, 6, 3, 7);
+    v128_t b2 = wasm_i32x4_shuffle(a2, a3, 0, 4, 1, 5);
+    v128_t b3 = wasm_i32x4_shuffle(a2, a3, 2, 6, 3, 7);
+
+    v128_t c0 = wasm_i64x2_shuffle(b0, b2, 0, 2);
+    v128_t c1 = wasm_i64x2_shuffle(b0, b2, 1, 3);
+    v128_t c2 = wasm_i64x2_shuffle(b1, b3, 0, 2);
+    v128_t c3 = wasm_i64x2_shuffle(b1, b3, 1, 3);
+
+    wasm_v128_store(&Output[OutputStride * 0], c0);
+    wasm_v128_store(&Output[OutputStride * 1], c1);
+    wasm_v128_store(&Output[OutputStride * 2], c2);
+    wasm_v128_store(&Output[OutputStride * 3], c3);
+}
+
+MLAS_FORCEINLINE
+void
+MlasTranspose4x4Block(
+    const uint16_t* Input,
+    size_t InputStride,
+    uint16_t* Output,
+    size_t OutputStride
+    )
+{
+    v128_t a0 = wasm_v128_load64_zero(&Input[InputStride * 0]);
+    v128_t a1 = wasm_v128_load64_zero(&Input[InputStride * 1]);
+    v128_t a2 = wasm_v128_load64_zero(&Input[InputStride * 2]);
+    v128_t a3 = wasm_v128_load64_zero(&Input[InputStride * 3]);
+
+    v128_t b0 = wasm_i16x8_shuffle(a0, a1, 0, 8, 1, 9, 2, 10, 3, 11);
+    v128_t b1 = wasm_i16x8_shuffle(a2, a3, 0, 8, 1, 9, 2, 10, 3, 11);
+
+    v128_t c0 = wasm_i32x4_shuffle(b0, b1, 0, 4, 1, 5);
+    v128_t c1 = wasm_i32x4_shuffle(b0, b1, 2, 6, 3, 7);
+
+    wasm_v128_store64_lane(&Output[OutputStride * 0], c0, 0);
+    wasm_v128_store64_lane(&Output[OutputStride * 1], c0, 1);
+    wasm_v128_store64_lane(&Output[OutputStride * 2], c1, 0);
+    wasm_v128_store64_lane(&Output[OutputStride * 3], c1, 1);
+}
+
+MLAS_FORCEINLINE
+void
+MlasTranspose8x8Block(
+    const uint8_t* Input,
+    size_t InputStride,
+    uint8_t* Output,
+    size_t OutputStride
+    )
+{
+    v128_t a0 = wasm_v128_load64_zero(&Input[InputStride * 0]);
+    v128_t a1 = wasm_v128_load64_zero(&Input[InputStride * 1]);
+    v128_t b0 = wasm_i8x16_shuffle(a0, a1, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+
+    v128_t a2 = wasm_v128_load64_zero(&Input[InputStride * 2]);
+    v128_t a3 = wasm_v128_load64_zero(&Input[InputStride * 3]);
+    v128_t b1 = wasm_i8x16_shuffle(a2, a3, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+
+    v128_t a4 = wasm_v128_load64_zero(&Input[InputStride * 4]);
+    v128_t a5 = wasm_v128_load64_zero(&Input[InputStride * 5]);
+    v128_t b2 = wasm_i8x16_shuffle(a4, a5, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+
+    v128_t a6 = wasm_v128_load64_zero(&Input[InputStride * 6]);
+    v128_t a7 = wasm_v128_load64_zero(&Input[InputStride * 7]);
+    v128_t b3 = wasm_i8x16_shuffle(a6, a7, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+
+    v128_t c0 = wasm_i16x8_shuffle(b0, b1, 0, 8, 1, 9, 2, 10, 3, 11);
+    v128_t c1 = wasm_i16x8_shuffle(b0, b1, 4, 12, 5, 13, 6, 14, 7, 15);
+    v128_t c2 = wasm_i16x8_shuffle(b2, b3, 0, 8, 1, 9, 2, 10, 3, 11);
+    v128_t c3 = wasm_i16x8_shuffle(b2, b3, 4, 12, 5, 13, 6, 14, 7, 15);
+
+    v128_t d0 = wasm_i32x4_shuffle(c0, c2, 0, 4, 1, 5);
+    wasm_v128_store64_lane(&Output[OutputStride * 0], d0, 0);
+    wasm_v128_store64_lane(&Output[OutputStride * 1], d0, 1);
+
+    v128_t d1 = wasm_i32x4_shuffle(c0, c2, 2, 6, 3, 7);
+    wasm_v128_store64_lane(&Output[OutputStride * 2], d1, 0);
+    wasm_v128_store64_lane(&Output[OutputStride * 3], d1, 1);
+
+    v128_t d2 = wasm_i32x4_shuffle(c1, c3, 0, 4, 1, 5);
+    wasm_v128_store64_lane(&Output[OutputStride * 4], d2, 0);
+    wasm_v128_store64_lane(&Output[OutputStride * 5], d2, 1);
+
+    v128_t d3 = wasm_i32x4_shuffle(c1, c3, 2, 6, 3, 7);
+    wasm_v128_store64_lane(&Output[OutputStride * 6], d3, 0);
+    wasm_v128_store64_lane(&Output[OutputStride * 7], d3, 1);
+}
+
 #endif
 
 template<typename ElementType>
@@ -588,7 +741,7 @@ Return Value:
         size_t m = M;
 
 #if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS) || defined(MLAS_TARGET_POWER) || \
-    defined(MLAS_LSX_INTRINSICS)
+    defined(MLAS_LSX_INTRINSICS) || defined(MLAS_WASM_SIMD_INTRINSICS)
 
         while (m >= 4) {
 
@@ -713,7 +866,8 @@ Return Value:
         uint16_t* d = Output;
         size_t m = M;
 
-#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)  || defined(MLAS_LSX_INTRINSICS)
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)  || defined(MLAS_LSX_INTRINSICS) || \
+    defined(MLAS_WASM_SIMD_INTRINSICS)
 
         while (m >= 4) {
 
@@ -850,7 +1004,8 @@ Return Value:
         uint8_t* d = Output;
         size_t m = M;
 
-#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)  || defined(MLAS_LSX_INTRINSICS)
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)  || defined(MLAS_LSX_INTRINSICS) || \
+    defined(MLAS_WASM_SIMD_INTRINSICS)
 
         while (m >= 8) {
 
@@ -926,3 +1081,528 @@ MlasTranspose(
         M,
         N);
 }
+
+//
+// Block kernels used by the strided transpose for each element type. The
+// block is BlockSize rows by BlockSize columns.
+//
+
+template<typename ElementType>
+struct MLAS_TRANSPOSE_BLOCK_KERNEL
+{
+    static constexpr size_t BlockSize = 1;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const ElementType* Input,
+        size_t InputStride,
+        ElementType* Output,
+        size_t OutputStride
+        )
+    {
+        MLAS_UNREFERENCED_PARAMETER(InputStride);
+        MLAS_UNREFERENCED_PARAMETER(OutputStride);
+
+        Output[0] = Input[0];
+    }
+};
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS) || defined(MLAS_TARGET_POWER) || \
+    defined(MLAS_LSX_INTRINSICS) || defined(MLAS_WASM_SIMD_INTRINSICS)
+
+template<>
+struct MLAS_TRANSPOSE_BLOCK_KERNEL<uint32_t>
+{
+    static constexpr size_t BlockSize = 4;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint32_t* Input,
+        size_t InputStride,
+        uint32_t* Output,
+        size_t OutputStride
+        )
+    {
+        MlasTranspose4x4Block(Input, InputStride, Output, OutputStride);
+    }
+};
+
+#endif
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS) || defined(MLAS_LSX_INTRINSICS) || \
+    defined(MLAS_WASM_SIMD_INTRINSICS)
+
+template<>
+struct MLAS_TRANSPOSE_BLOCK_KERNEL<uint16_t>
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    static constexpr size_t BlockSize = 8;
+#else
+    static constexpr size_t BlockSize = 4;
+#endif
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint16_t* Input,
+        size_t InputStride,
+        uint16_t* Output,
+        size_t OutputStride
+        )
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        MlasTranspose8x8Block(Input, InputStride, Output, OutputStride);
+#else
+        MlasTranspose4x4Block(Input, InputStride, Output, OutputStride);
+#endif
+    }
+};
+
+#endif
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS) || defined(MLAS_TARGET_POWER) || \
+    defined(MLAS_LSX_INTRINSICS) || defined(MLAS_WASM_SIMD_INTRINSICS)
+
+template<>
+struct MLAS_TRANSPOSE_BLOCK_KERNEL<uint8_t>
+{
+#if defined(MLAS_TARGET_POWER)
+    static constexpr size_t BlockSize = 16;
+#else
+    static constexpr size_t BlockSize = 8;
+#endif
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Transpose(
+        const uint8_t* Input,
+        size_t InputStride,
+        uint8_t* Output,
+        size_t OutputStride
+        )
+    {
+#if defined(MLAS_TARGET_POWER)
+        MlasTranspose16x16Block(Input, InputStride, Output, OutputStride);
+#else
+        MlasTranspose8x8Block(Input, InputStride, Output, OutputStride);
+#endif
+    }
+};
+
+#endif
+
+//
+// Number of rows and columns below which the strided transpose stops
+// subdividing the matrix and runs the block kernels directly.
+//
+
+constexpr size_t MLAS_TRANSPOSE_STRIDED_TILE = 32;
+
+//
+// Minimum number of elements assigned to each thread by the N-dimensional
+// transpose.
+//
+
+constexpr size_t MLAS_TRANSPOSE_ND_ELEMENTS_PER_THREAD = 16384;
+
+template<typename ElementType>
+void
+MlasTransposeStridedTile(
+    const ElementType* Input,
+    size_t InputStride,
+    ElementType* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of M rows by N columns, whose rows are
+    InputStride elements apart, to a matrix of N rows by M columns, whose rows
+    are OutputStride elements apart.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    InputStride - Supplies the number of elements between input rows.
+
+    Output - Supplies the output matrix.
+
+    OutputStride - Supplies the number of elements between output rows.
+
+    M - Supplies the number of rows of the input matrix.
+
+    N - Supplies the number of columns of the input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using BlockKernel = MLAS_TRANSPOSE_BLOCK_KERNEL<ElementType>;
+    constexpr size_t BlockSize = BlockKernel::BlockSize;
+
+    size_t n = 0;
+
+    for (; n + BlockSize <= N; n += BlockSize) {
+
+        size_t m = 0;
+
+        for (; m + BlockSize <= M; m += BlockSize) {
+            BlockKernel::Transpose(&Input[m * InputStride + n], InputStride,
+                                   &Output[n * OutputStride + m], OutputStride);
+        }
+
+        for (; m < M; m++) {
+            for (size_t i = 0; i < BlockSize; i++) {
+                Output[(n + i) * OutputStride + m] = Input[m * InputStride + n + i];
+            }
+        }
+    }
+
+    for (; n < N; n++) {
+        for (size_t m = 0; m < M; m++) {
+            Output[n * OutputStride + m] = Input[m * InputStride + n];
+        }
+    }
+}
+
+template<typename ElementType>
+void
+MlasTransposeStrided(
+    const ElementType* Input,
+    size_t InputStride,
+    ElementType* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a strided matrix like MlasTransposeStridedTile,
+    but first recursively halves the longer dimension until the pieces fit in
+    a tile. The resulting access pattern stays cache friendly regardless of
+    the cache sizes and of the input and output strides.
+
+Arguments:
+
+    See MlasTransposeStridedTile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = MLAS_TRANSPOSE_BLOCK_KERNEL<ElementType>::BlockSize;
+
+    while (M > MLAS_TRANSPOSE_STRIDED_TILE || N > MLAS_TRANSPOSE_STRIDED_TILE) {
+
+        if (M >= N) {
+
+            const size_t M0 = (M / 2) / BlockSize * BlockSize;
+
+            MlasTransposeStrided(Input, InputStride, Output, OutputStride, M0, N);
+
+            Input += M0 * InputStride;
+            Output += M0;
+            M -= M0;
+
+        } else {
+
+            const size_t N0 = (N / 2) / BlockSize * BlockSize;
+
+            MlasTransposeStrided(Input, InputStride, Output, OutputStride, M, N0);
+
+            Input += N0;
+            Output += N0 * OutputStride;
+            N -= N0;
+        }
+    }
+
+    MlasTransposeStridedTile(Input, InputStride, Output, OutputStride, M, N);
+}
+
+template<typename ElementType>
+void
+MlasTransposeNd(
+    const ElementType* Input,
+    ElementType* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine permutes the axes of an N-dimensional tensor.
+
+    Axes of unit extent are dropped and runs of output axes that are also
+    adjacent in the input are merged. If the innermost axis is unchanged, the
+    transpose reduces to copying contiguous rows. Otherwise each plane formed
+    by the innermost input axis and the innermost output axis is transposed
+    with MlasTransposeStrided. The work is split over the remaining outer
+    axes and, if needed, over the longer dimension of the plane.
+
+Arguments:
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Permutation - Supplies the input axis for each output axis.
+
+    Rank - Supplies the number of axes.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t TotalElements = 1;
+
+    for (size_t axis = 0; axis < Rank; axis++) {
+        TotalElements *= InputShape[axis];
+    }
+
+    if (TotalElements == 0) {
+        return;
+    }
+
+    //
+    // Merge the output axes, skipping those of unit extent, into groups of
+    // input axes that are adjacent and in order.
+    //
+
+    std::vector<size_t> GroupFirstAxis;
+    std::vector<size_t> GroupExtent;
+    size_t PreviousAxis = 0;
+
+    for (size_t i = 0; i < Rank; i++) {
+
+        const size_t axis = Permutation[i];
+
+        if (InputShape[axis] == 1) {
+            continue;
+        }
+
+        bool Adjacent = !GroupFirstAxis.empty() && axis > PreviousAxis;
+
+        for (size_t a = PreviousAxis + 1; Adjacent && a < axis; a++) {
+            Adjacent = (InputShape[a] == 1);
+        }
+
+        if (Adjacent) {
+            GroupExtent.back() *= InputShape[axis];
+        } else {
+            GroupFirstAxis.push_back(axis);
+            GroupExtent.push_back(InputShape[axis]);
+        }
+
+        PreviousAxis = axis;
+    }
+
+    const size_t GroupCount = GroupFirstAxis.size();
+
+    if (GroupCount <= 1) {
+        std::copy_n(Input, TotalElements, Output);
+        return;
+    }
+
+    //
+    // Compute the position of each group in the merged input tensor and then
+    // the input and output strides of each output axis.
+    //
+
+    std::vector<size_t> GroupInputAxis(GroupCount, 0);
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        for (size_t h = 0; h < GroupCount; h++) {
+            if (GroupFirstAxis[h] < GroupFirstAxis[g]) {
+                GroupInputAxis[g]++;
+            }
+        }
+    }
+
+    std::vector<size_t> MergedInputStride(GroupCount);
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        MergedInputStride[GroupInputAxis[g]] = GroupExtent[g];
+    }
+
+    size_t Stride = 1;
+
+    for (size_t a = GroupCount; a > 0; a--) {
+        const size_t Extent = MergedInputStride[a - 1];
+        MergedInputStride[a - 1] = Stride;
+        Stride *= Extent;
+    }
+
+    std::vector<size_t> InputStride(GroupCount);
+    std::vector<size_t> OutputStride(GroupCount);
+
+    Stride = 1;
+
+    for (size_t g = GroupCount; g > 0; g--) {
+        InputStride[g - 1] = MergedInputStride[GroupInputAxis[g - 1]];
+        OutputStride[g - 1] = Stride;
+        Stride *= GroupExtent[g - 1];
+    }
+
+    //
+    // Select the inner matrix: the rows follow the innermost output axis and
+    // the columns follow the innermost input axis. If these are the same axis,
+    // the inner matrix is a single contiguous row.
+    //
+
+    const size_t InnerOutputAxis = GroupCount - 1;
+    size_t InnerInputAxis = InnerOutputAxis;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        if (GroupInputAxis[g] == GroupCount - 1) {
+            InnerInputAxis = g;
+        }
+    }
+
+    const bool RowCopy = (InnerInputAxis == InnerOutputAxis);
+    const size_t M = RowCopy ? 1 : GroupExtent[InnerOutputAxis];
+    const size_t N = GroupExtent[InnerInputAxis];
+    const size_t MatrixInputStride = InputStride[InnerOutputAxis];
+    const size_t MatrixOutputStride = OutputStride[InnerInputAxis];
+
+    std::vector<size_t> OuterExtent;
+    std::vector<size_t> OuterInputStride;
+    std::vector<size_t> OuterOutputStride;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        if (g != InnerOutputAxis && g != InnerInputAxis) {
+            OuterExtent.push_back(GroupExtent[g]);
+            OuterInputStride.push_back(InputStride[g]);
+            OuterOutputStride.push_back(OutputStride[g]);
+        }
+    }
+
+    const size_t OuterCount = TotalElements / (M * N);
+
+    //
+    // Split the longer dimension of the inner matrix into chunks of whole
+    // tiles so that small outer extents still provide parallelism.
+    //
+
+    const bool SplitRows = (M > N);
+    const size_t SplitExtent = SplitRows ? M : N;
+    const size_t ChunkCount = (SplitExtent + MLAS_TRANSPOSE_STRIDED_TILE - 1) / MLAS_TRANSPOSE_STRIDED_TILE;
+    const size_t TotalWork = OuterCount * ChunkCount;
+
+    ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+    const size_t MaximumThreadCount =
+        std::max<size_t>(1, std::min(TotalWork, TotalElements / MLAS_TRANSPOSE_ND_ELEMENTS_PER_THREAD));
+
+    if (size_t(TargetThreadCount) > MaximumThreadCount) {
+        TargetThreadCount = ptrdiff_t(MaximumThreadCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, TotalWork, &WorkIndex, &WorkRemaining);
+
+        while (WorkRemaining > 0) {
+
+            size_t OuterIndex = WorkIndex / ChunkCount;
+            const size_t ChunkIndex = WorkIndex % ChunkCount;
+            const size_t ChunksThisIteration = std::min(WorkRemaining, ChunkCount - ChunkIndex);
+
+            const ElementType* s = Input;
+            ElementType* d = Output;
+
+            for (size_t i = OuterExtent.size(); i > 0; i--) {
+                const size_t Index = OuterIndex % OuterExtent[i - 1];
+                OuterIndex /= OuterExtent[i - 1];
+                s += Index * OuterInputStride[i - 1];
+                d += Index * OuterOutputStride[i - 1];
+            }
+
+            const size_t SplitStart = ChunkIndex * MLAS_TRANSPOSE_STRIDED_TILE;
+            const size_t SplitCount =
+                std::min(SplitExtent, SplitStart + ChunksThisIteration * MLAS_TRANSPOSE_STRIDED_TILE) - SplitStart;
+
+            if (RowCopy) {
+                std::copy_n(s + SplitStart, SplitCount, d + SplitStart);
+            } else if (SplitRows) {
+                MlasTransposeStrided(s + SplitStart * MatrixInputStride, MatrixInputStride,
+                                     d + SplitStart, MatrixOutputStride, SplitCount, N);
+            } else {
+                MlasTransposeStrided(s + SplitStart, MatrixInputStride,
+                                     d + SplitStart * MatrixOutputStride, MatrixOutputStride, M, SplitCount);
+            }
+
+            WorkIndex += ChunksThisIteration;
+            WorkRemaining -= ChunksThisIteration;
+        }
+    });
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasTransposeNd(Input, Output, InputShape, Permutation, Rank, ThreadPool);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasTransposeNd(Input, Output, InputShape, Permutation, Rank, ThreadPool);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    size_t Rank,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasTransposeNd(Input, Output, InputShape, Permutation, Rank, ThreadPool);
+}
@@ -44,7 +44,8 @@ bool TryBiasSoftmaxSubgraphMatch(Graph& graph, Node& start, Node*& add, Node*& s
 
   // check node is add and has single output
   if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
-      !graph_utils::IsSupportedProvider(node, {kCudaExecutionProvider, kRocmExecutionProvider}) ||
+      !graph_utils::IsSupportedProvider(node, {kCudaExecutionProvider, kRocmExecutionProvider,
+                                               kCpuExecutionProvider}) ||
       !optimizer_utils::CheckOutputEdges(graph, node, 1)) {
     return false;
   }
@@ -60,11 +61,13 @@ bool TryBiasSoftmaxSubgraphMatch(Graph& graph, Node& start, Node*& add, Node*& s
   }
 
   // BiasSoftmax supports only float/float16/double - see ./onnxruntime/core/graph/contrib_ops/contrib_defs.cc
-  auto type_allowed = [](NodeArg* input) {
+  // The CPU kernel supports only float.
+  const bool is_cpu = node.GetExecutionProviderType() == kCpuExecutionProvider;
+  auto type_allowed = [is_cpu](NodeArg* input) {
     auto data_type = input->TypeAsProto()->tensor_type().elem_type();
-    if (data_type != ONNX_NAMESPACE::TensorProto_DataType_DOUBLE &&
-        data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 &&
-        data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    if (data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+        (is_cpu || (data_type != ONNX_NAMESPACE::TensorProto_DataType_DOUBLE &&
+                    data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16))) {
       return false;
     }
     return true;
@@ -237,9 +240,9 @@ Status BiasSoftmaxFusion::ApplyImpl(Graph& graph, bool& modified, int graph_leve
   GraphViewer graph_viewer(graph);
   const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
 
-  // only support GPU execution provider
   auto& cep = GetCompatibleExecutionProviders();
-  if (cep.size() > 0 && cep.find(kCudaExecutionProvider) == cep.end() && cep.find(kRocmExecutionProvider) == cep.end())
+  if (cep.size() > 0 && cep.find(kCudaExecutionProvider) == cep.end() && cep.find(kRocmExecutionProvider) == cep.end() &&
+      cep.find(kCpuExecutionProvider) == cep.end())
     return Status::OK();
 
   for (auto node_index : node_topology_list) {
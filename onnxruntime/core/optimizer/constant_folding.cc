@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <limits>
 
 #include "core/optimizer/constant_folding.h"
@@ -93,6 +94,113 @@ static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
   return is_concrete_shape;  // convert to constant if this is true
 }
 
+// Like Shape, a Size node only needs the shape of its input. Folding it lets conditions such as the ones that check
+// for an empty input be constant folded, and the If nodes that use them be inlined.
+static bool ConstantFoldSizeNode(Graph& graph, Node& node) {
+  const auto* shape = node.InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  int64_t size = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+    size *= dim.dim_value();
+  }
+
+  ONNX_NAMESPACE::TensorProto size_constant;
+  auto* constant_arg_out = node.MutableOutputDefs()[0];
+  size_constant.set_name(constant_arg_out->Name());
+  size_constant.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  size_constant.set_raw_data(&size, sizeof(int64_t));
+  constant_arg_out->SetShape(ONNX_NAMESPACE::TensorShapeProto());
+  graph.AddInitializedTensor(size_constant);
+
+  return true;
+}
+
+// A Gather along axis 0 of the output of a Shape node can be constant folded if the gathered dimensions are known,
+// even if the input of the Shape node has symbolic dimensions. This folds the common
+// Shape -> Gather -> Unsqueeze -> Concat chains that build the target shape of a Reshape from a few fixed dimensions,
+// e.g. the dimensions made concrete by a free dimension override.
+static bool ConstantFoldShapeGatherNode(Graph& graph, Node& node) {
+  const Node* shape_node = graph.GetProducerNode(node.InputDefs()[0]->Name());
+  if (shape_node == nullptr || shape_node->OpType() != "Shape" ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13})) {
+    return false;
+  }
+
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr != nullptr && utils::HasInt(*axis_attr) && axis_attr->i() != 0) {
+    return false;
+  }
+
+  const auto* shape = shape_node->InputDefs()[0]->Shape();
+  constexpr bool check_outer_scope_true = true;
+  const ONNX_NAMESPACE::TensorProto* indices_proto =
+      graph.GetConstantInitializer(node.InputDefs()[1]->Name(), check_outer_scope_true);
+  if (shape == nullptr || indices_proto == nullptr || indices_proto->dims_size() > 1) {
+    return false;
+  }
+
+  // the dimensions selected by the 'start' and 'end' attributes of an opset-15 Shape node
+  const int64_t rank = shape->dim_size();
+  int64_t start = 0;
+  int64_t end = rank;
+  for (const auto& attr : shape_node->GetAttributes()) {
+    if (attr.first == "start") {
+      start = attr.second.i();
+    } else if (attr.first == "end") {
+      end = attr.second.i();
+    }
+  }
+  start = std::clamp(start < 0 ? start + rank : start, int64_t{0}, rank);
+  end = std::clamp(end < 0 ? end + rank : end, int64_t{0}, rank);
+  const int64_t num_dims = std::max(end - start, int64_t{0});
+
+  Initializer indices{*indices_proto, graph.ModelPath()};
+  std::vector<int64_t> indices_values;
+  if (indices.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+    auto span = indices.DataAsSpan<int64_t>();
+    indices_values.assign(span.begin(), span.end());
+  } else if (indices.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+    auto span = indices.DataAsSpan<int32_t>();
+    indices_values.assign(span.begin(), span.end());
+  } else {
+    return false;
+  }
+
+  std::vector<int64_t> dim_values;
+  for (int64_t index : indices_values) {
+    index = index < 0 ? index + num_dims : index;
+    if (index < 0 || index >= num_dims) {
+      return false;
+    }
+    const auto& dim = shape->dim(static_cast<int>(start + index));
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+    dim_values.push_back(dim.dim_value());
+  }
+
+  ONNX_NAMESPACE::TensorProto gather_constant;
+  auto* constant_arg_out = node.MutableOutputDefs()[0];
+  gather_constant.set_name(constant_arg_out->Name());
+  gather_constant.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  ONNX_NAMESPACE::TensorShapeProto result_shape;
+  if (indices_proto->dims_size() == 1) {
+    gather_constant.add_dims(static_cast<int64_t>(dim_values.size()));
+    result_shape.add_dim()->set_dim_value(static_cast<int64_t>(dim_values.size()));
+  }
+  gather_constant.set_raw_data(dim_values.data(), dim_values.size() * sizeof(int64_t));
+  constant_arg_out->SetShape(result_shape);
+  graph.AddInitializedTensor(gather_constant);
+
+  return true;
+}
+
 // This function inlines the appropriate subgraph. It does not literally fold it.
 static Status ConstantFoldIfNode(Graph& graph, Node& if_node, const logging::Logger& logger, bool& folded) {
   folded = false;
@@ -175,6 +283,12 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       }
     } else if (node->OpType().compare("Shape") == 0) {
       converted_to_constant = ConstantFoldShapeNode(graph, *node);
+    } else if (node->OpType().compare("Size") == 0) {
+      converted_to_constant = ConstantFoldSizeNode(graph, *node);
+    } else if (node->OpType().compare("Gather") == 0 &&
+               graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) &&
+               ConstantFoldShapeGatherNode(graph, *node)) {
+      converted_to_constant = true;
     } else {
       InitializedTensorSet constant_inputs;
 
@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsBinaryOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14});
+}
+
+bool IsUnaryOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13});
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool HaveSameShape(const TensorShapeProto& a, const TensorShapeProto& b) {
+  if (a.dim_size() != b.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < a.dim_size(); ++i) {
+    const auto& da = a.dim(i);
+    const auto& db = b.dim(i);
+    const bool same = (utils::HasDimValue(da) && utils::HasDimValue(db) && da.dim_value() == db.dim_value()) ||
+                      (utils::HasDimParam(da) && utils::HasDimParam(db) && da.dim_param() == db.dim_param());
+    if (!same) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The second input of a binary operator must not broadcast the chain value of shape chain_shape.
+bool IsValidOperand(const NodeArg& operand, const TensorShapeProto& chain_shape) {
+  const auto* shape = operand.Shape();
+  if (shape == nullptr || !IsFloatTensor(operand)) {
+    return false;
+  }
+
+  bool is_single_element = shape->dim_size() <= chain_shape.dim_size();
+  for (const auto& dim : shape->dim()) {
+    is_single_element = is_single_element && utils::HasDimValue(dim) && dim.dim_value() == 1;
+  }
+  return is_single_element || HaveSameShape(*shape, chain_shape);
+}
+
+struct ChainStep {
+  Node* node;
+  NodeArg* operand;  // nullptr for unary operators
+  bool operand_is_lhs;
+};
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  auto is_fusible = [&](const Node& node) {
+    return (IsBinaryOp(node) || IsUnaryOp(node)) &&
+           graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) &&
+           IsFloatTensor(*node.OutputDefs()[0]);
+  };
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) continue;  // node was removed as part of an earlier fusion
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!is_fusible(node)) {
+      continue;
+    }
+
+    // the input of the chain, which determines the shape of all the intermediate results
+    NodeArg* chain_input = nullptr;
+    InlinedVector<ChainStep> chain;
+    if (IsBinaryOp(node)) {
+      NodeArg* a = node.MutableInputDefs()[0];
+      NodeArg* b = node.MutableInputDefs()[1];
+      if (a->Shape() != nullptr && IsValidOperand(*b, *a->Shape())) {
+        chain_input = a;
+        chain.push_back({&node, b, false});
+      } else if (b->Shape() != nullptr && IsValidOperand(*a, *b->Shape())) {
+        chain_input = b;
+        chain.push_back({&node, a, true});
+      } else {
+        continue;
+      }
+    } else {
+      chain_input = node.MutableInputDefs()[0];
+      if (chain_input->Shape() == nullptr || !IsFloatTensor(*chain_input)) {
+        continue;
+      }
+      chain.push_back({&node, nullptr, false});
+    }
+
+    const TensorShapeProto& chain_shape = *chain_input->Shape();
+    while (true) {
+      const Node& last = *chain.back().node;
+      if (!optimizer_utils::CheckOutputEdges(graph, last, 1)) {
+        break;
+      }
+
+      Node& next = *graph.GetNode(last.OutputNodesBegin()->Index());
+      if (!is_fusible(next) || next.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        break;
+      }
+
+      const NodeArg* value = last.OutputDefs()[0];
+      if (IsBinaryOp(next)) {
+        const int value_index = optimizer_utils::IndexOfNodeInput(next, *value);
+        NodeArg* operand = next.MutableInputDefs()[1 - value_index];
+        if (operand == value || !IsValidOperand(*operand, chain_shape)) {
+          break;
+        }
+        chain.push_back({&next, operand, value_index == 1});
+      } else {
+        chain.push_back({&next, nullptr, false});
+      }
+    }
+
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    InlinedVector<NodeArg*> fused_inputs{chain_input};
+    InlinedVector<std::string> ops;
+    InlinedVector<int64_t> operand_indices;
+    InlinedVector<int64_t> operand_positions;
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_fuse;
+    for (const auto& step : chain) {
+      int64_t operand_index = -1;
+      if (step.operand != nullptr) {
+        // the chain input is also added to the operands if it is the operand of a later operator,
+        // e.g. x * Sigmoid(x), as FusedElementwise only takes the second inputs from operands
+        auto it = std::find(fused_inputs.begin() + 1, fused_inputs.end(), step.operand);
+        if (it == fused_inputs.end()) {
+          it = fused_inputs.insert(fused_inputs.end(), step.operand);
+        }
+        // index 0 of the operands is input 1 of the fused node
+        operand_index = static_cast<int64_t>(it - fused_inputs.begin()) - 1;
+      }
+      ops.push_back(step.node->OpType());
+      operand_indices.push_back(operand_index);
+      operand_positions.push_back(step.operand_is_lhs ? 1 : 0);
+      nodes_to_fuse.emplace_back(*step.node);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"), "FusedElementwise",
+                                     "fused elementwise operators", fused_inputs,
+                                     std::array{chain.back().node->MutableOutputDefs()[0]}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operand_indices", operand_indices);
+    fused_node.AddAttribute("operand_positions", operand_positions);
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // The input edges of the first node are moved by FinalizeNodeFusion, the ones of the operands of the later
+    // nodes are added here.
+    for (size_t i = 1; i < chain.size(); ++i) {
+      const Node& chain_node = *chain[i].node;
+      for (auto edge = chain_node.InputEdgesBegin(); edge != chain_node.InputEdgesEnd(); ++edge) {
+        const NodeArg* arg = chain_node.InputDefs()[edge->GetDstArgIndex()];
+        if (&edge->GetNode() == chain[i - 1].node) {
+          continue;
+        }
+        for (int j = 0; j < static_cast<int>(fused_inputs.size()); ++j) {
+          if (fused_inputs[j] == arg) {
+            graph.AddEdge(edge->GetNode().Index(), fused_node.Index(), edge->GetSrcArgIndex(), j);
+          }
+        }
+      }
+    }
+
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuses chains of float elementwise operators, such as Add, Mul, Erf or Sigmoid, into a FusedElementwise node
+ * that applies the whole chain in a single pass over memory.
+ *
+ * Every operator of a chain consumes the result of the previous one, which has no other consumer. The second input of
+ * a binary operator must either have a single element or the shape of the chain input, so that no operator
+ * broadcasts the intermediate results.
+ */
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
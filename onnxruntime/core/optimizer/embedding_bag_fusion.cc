@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/node_attr_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Returns the reduced axes of ReduceSum/ReduceMean, which moved from an attribute to an optional input in opset 13
+// and 18 respectively. Returns false if they are not known.
+bool GetReduceAxes(const Graph& graph, const Node& reduce_node, InlinedVector<int64_t>& axes) {
+  if (graph_utils::GetRepeatedNodeAttributeValues(reduce_node, "axes", axes)) {
+    return true;
+  }
+  const auto& input_defs = reduce_node.InputDefs();
+  return input_defs.size() > 1 && input_defs[1]->Exists() &&
+         optimizer_utils::AppendTensorFromInitializer(graph, *input_defs[1], axes);
+}
+
+bool HasRank(const NodeArg& node_arg, int rank) {
+  const auto* shape = node_arg.Shape();
+  return shape != nullptr && shape->dim_size() == rank;
+}
+
+}  // namespace
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) continue;  // we removed the node as part of an earlier fusion
+
+    Node& reduce_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(reduce_node, modified, graph_level, logger));
+
+    const bool is_sum = graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceSum", {1, 11, 13});
+    if ((!is_sum && !graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceMean", {1, 11, 13, 18})) ||
+        !graph_utils::IsSupportedProvider(reduce_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto* keepdims = graph_utils::GetNodeAttribute(reduce_node, "keepdims");
+    InlinedVector<int64_t> axes;
+    if (keepdims == nullptr || keepdims->i() != 0 || !GetReduceAxes(graph, reduce_node, axes) ||
+        axes.size() != 1 || (axes[0] != 1 && axes[0] != -2)) {
+      continue;
+    }
+
+    const Node* gather_node = graph.GetProducerNode(reduce_node.InputDefs()[0]->Name());
+    if (gather_node == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*gather_node, "Gather", {1, 11, 13}) ||
+        gather_node->GetExecutionProviderType() != reduce_node.GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph, *gather_node, 1)) {
+      continue;
+    }
+
+    const auto* gather_axis = graph_utils::GetNodeAttribute(*gather_node, "axis");
+    NodeArg* weight = graph.GetNodeArg(gather_node->InputDefs()[0]->Name());
+    NodeArg* indices = graph.GetNodeArg(gather_node->InputDefs()[1]->Name());
+    const auto* weight_type = weight->TypeAsProto();
+    if ((gather_axis != nullptr && gather_axis->i() != 0) || !HasRank(*weight, 2) || !HasRank(*indices, 2) ||
+        weight_type == nullptr ||
+        (weight_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT &&
+         weight_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT16)) {
+      continue;
+    }
+
+    NodeAttributes attributes;
+    utils::SetNodeAttribute(utils::MakeAttribute("mode", std::string(is_sum ? "sum" : "mean")), attributes);
+    Node& embedding_bag_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                             "EmbeddingBag",
+                                             "fused embedding bag of " + reduce_node.Name(),
+                                             {weight, indices},
+                                             {reduce_node.MutableOutputDefs()[0]},
+                                             &attributes,
+                                             kMSDomain);
+    embedding_bag_node.SetExecutionProviderType(reduce_node.GetExecutionProviderType());
+
+    Node& gather = *graph.GetNode(gather_node->Index());
+    graph_utils::FinalizeNodeFusion(graph, {gather, reduce_node}, embedding_bag_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
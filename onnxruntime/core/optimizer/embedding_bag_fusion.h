@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuses the embedding bag of recommendation model exports,
+ *   ReduceSum(Gather(weight, indices), axes=[1], keepdims=0) or the same with ReduceMean,
+ * into an EmbeddingBag node with the matching mode, so the gathered (num_bags, bag_size, embedding_dim) tensor is
+ * never materialized.
+ *
+ * weight must be a 2D float or float16 tensor gathered on axis 0 and indices must be 2D (num_bags, bag_size).
+ */
+class EmbeddingBagFusion : public GraphTransformer {
+ public:
+  EmbeddingBagFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("EmbeddingBagFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
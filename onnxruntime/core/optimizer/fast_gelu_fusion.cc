@@ -15,10 +15,13 @@ namespace onnxruntime {
 // FastGelu supports limited data types.
 static constexpr std::array gpu_supported_data_types{"tensor(float16)", "tensor(float)", "tensor(bfloat16)"};
 static constexpr std::array cpu_supported_data_types{"tensor(float)"};
+static constexpr std::array js_supported_data_types{"tensor(float16)", "tensor(float)"};
 
 static bool IsSupportedDataType(const Node& node) {
   if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
     return optimizer_utils::IsSupportedDataType(node, cpu_supported_data_types);
+  } else if (node.GetExecutionProviderType() == kJsExecutionProvider) {
+    return optimizer_utils::IsSupportedDataType(node, js_supported_data_types);
   } else {
     return optimizer_utils::IsSupportedDataType(node, gpu_supported_data_types);
   }
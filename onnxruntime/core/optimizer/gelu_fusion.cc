@@ -14,11 +14,14 @@ namespace onnxruntime {
 
 // Gelu supports limited data types.
 static std::vector<std::string> supported_data_types{"tensor(float16)", "tensor(float)", "tensor(double)"};
+// The JS EP only implements Gelu for float.
+static std::vector<std::string> js_supported_data_types{"tensor(float)"};
 
 static bool IsSupportedDataType(const Node& node) {
+  const auto& data_types = node.GetExecutionProviderType() == kJsExecutionProvider ? js_supported_data_types
+                                                                                   : supported_data_types;
   for (const auto& input_arg : node.InputDefs()) {
-    if (std::find(supported_data_types.begin(), supported_data_types.end(),
-                  *(input_arg->Type())) == supported_data_types.end()) {
+    if (std::find(data_types.begin(), data_types.end(), *(input_arg->Type())) == data_types.end()) {
       return false;
     }
   }
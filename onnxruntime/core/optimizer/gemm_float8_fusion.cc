@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gemm_float8_fusion.h"
+
+#include <algorithm>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static bool GetElementType(const NodeArg& node_arg, int32_t& data_type) {
+  if (!node_arg.Exists() || node_arg.TypeAsProto() == nullptr) {
+    return false;
+  }
+  return utils::TryGetElementDataType(*node_arg.TypeAsProto(), data_type);
+}
+
+static bool IsFloat8Type(int32_t data_type) {
+  return data_type == TensorProto_DataType_FLOAT8E4M3FN || data_type == TensorProto_DataType_FLOAT8E5M2;
+}
+
+// Checks the DequantizeLinear node only scales a float 8 tensor by a per-tensor float scale
+// (GemmFloat8 has no zero point and no per-axis scale).
+static bool IsPerTensorFloat8Dequantize(const Graph& graph, const Node& dq_node, int32_t& fp8_type) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(dq_node, "DequantizeLinear", {19})) {
+    return false;
+  }
+
+  const auto& input_defs = dq_node.InputDefs();
+  int32_t scale_type;
+  if (!GetElementType(*input_defs[0], fp8_type) || !IsFloat8Type(fp8_type) ||
+      !GetElementType(*input_defs[1], scale_type) || scale_type != TensorProto_DataType_FLOAT ||
+      !optimizer_utils::IsScalar(*input_defs[1])) {
+    return false;
+  }
+
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    const TensorProto* zero_point = graph_utils::GetConstantInitializer(graph, input_defs[2]->Name());
+    if (zero_point == nullptr) {
+      return false;
+    }
+    std::vector<uint8_t> zero_point_data;
+    if (!utils::UnpackInitializerData(*zero_point, graph.ModelPath(), zero_point_data).IsOK() ||
+        std::any_of(zero_point_data.begin(), zero_point_data.end(), [](uint8_t v) { return v != 0; })) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Creates the initializer B^T from the (K, N) float 8 initializer B. cuBLASLt only supports
+// float 8 GEMMs in the TN layout, i.e. GemmFloat8 requires transA=0 and transB=1.
+static NodeArg* AddTransposedInitializer(Graph& graph, const TensorProto& b) {
+  std::vector<uint8_t> data;
+  if (!utils::UnpackInitializerData(b, graph.ModelPath(), data).IsOK()) {
+    return nullptr;
+  }
+
+  const int64_t K = b.dims(0);
+  const int64_t N = b.dims(1);
+  if (static_cast<int64_t>(data.size()) != K * N) {
+    return nullptr;
+  }
+
+  std::vector<uint8_t> transposed(data.size());
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      transposed[n * K + k] = data[k * N + n];
+    }
+  }
+
+  TensorProto b_t;
+  b_t.set_name(graph.GenerateNodeArgName(b.name() + "_transposed"));
+  b_t.set_data_type(b.data_type());
+  b_t.add_dims(N);
+  b_t.add_dims(K);
+  b_t.set_raw_data(transposed.data(), transposed.size());
+  return &graph_utils::AddInitializer(graph, b_t);
+}
+
+/**
+GemmFloat8Fusion will fuse subgraph like below into GemmFloat8:
+
+ A (fp8)  A_Scale   B (fp8, const)  B_Scale
+     \      /              \          /
+  DequantizeLinear      DequantizeLinear
+          \                   /                    ---->   (A, B^T, "", A_Scale, B_Scale)
+           \                 /                                           |
+                 MatMul                                       GemmFloat8 (transB=1)
+                   |                                                     |
+                (output)                                              (output)
+
+The fused node only runs on GPUs with float 8 tensor cores (compute capability 8.9 and above).
+ */
+Status GemmFloat8Fusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedVector<std::reference_wrapper<Node>> nodes_to_remove;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& matmul_node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(matmul_node, modified, graph_level, logger));
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul_node, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(matmul_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* p_dq_a = graph_utils::GetInputNode(matmul_node, 0);
+    const Node* p_dq_b = graph_utils::GetInputNode(matmul_node, 1);
+    if (p_dq_a == nullptr || p_dq_b == nullptr || p_dq_a == p_dq_b) {
+      continue;
+    }
+
+    int32_t a_type;
+    int32_t b_type;
+    if (!IsPerTensorFloat8Dequantize(graph, *p_dq_a, a_type) ||
+        !IsPerTensorFloat8Dequantize(graph, *p_dq_b, b_type) ||
+        // cuBLASLt has no E5M2 x E5M2 float 8 GEMM.
+        (a_type == TensorProto_DataType_FLOAT8E5M2 && b_type == TensorProto_DataType_FLOAT8E5M2)) {
+      continue;
+    }
+
+    const auto* a_shape = p_dq_a->InputDefs()[0]->Shape();
+    if (a_shape == nullptr || a_shape->dim_size() != 2) {
+      continue;
+    }
+
+    const TensorProto* b_initializer = graph_utils::GetConstantInitializer(graph, p_dq_b->InputDefs()[0]->Name());
+    if (b_initializer == nullptr || b_initializer->dims_size() != 2) {
+      continue;
+    }
+
+    Node& dq_a = *graph.GetNode(p_dq_a->Index());
+    Node& dq_b = *graph.GetNode(p_dq_b->Index());
+
+    // Check Nodes' Edges count and Nodes' outputs are not in Graph output
+    if (!optimizer_utils::CheckOutputEdges(graph, dq_a, 1) ||
+        !optimizer_utils::CheckOutputEdges(graph, dq_b, 1)) {
+      continue;
+    }
+
+    NodeArg* b_transposed = AddTransposedInitializer(graph, *b_initializer);
+    if (b_transposed == nullptr) {
+      continue;
+    }
+
+    NodeArg optional_node_arg("", nullptr);
+    InlinedVector<NodeArg*> input_defs{
+        dq_a.MutableInputDefs()[0],
+        b_transposed,
+        &optional_node_arg,
+        dq_a.MutableInputDefs()[1],
+        dq_b.MutableInputDefs()[1]};
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(matmul_node.Name() + "_GemmFloat8"),
+                                     "GemmFloat8",
+                                     "fused DequantizeLinear and MatMul",
+                                     input_defs,
+                                     matmul_node.MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+    fused_node.AddAttribute("transA", static_cast<int64_t>(0));
+    fused_node.AddAttribute("transB", static_cast<int64_t>(1));
+    fused_node.AddAttribute("dtype", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(matmul_node.GetExecutionProviderType());
+
+    nodes_to_remove.push_back(dq_a);
+    nodes_to_remove.push_back(dq_b);
+    nodes_to_remove.push_back(matmul_node);
+  }
+
+  modified = modified || !nodes_to_remove.empty();
+
+  for (const auto& node : nodes_to_remove) {
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.get().Index());
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
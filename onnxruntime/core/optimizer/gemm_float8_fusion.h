@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmFloat8Fusion
+Fuse a MatMul whose inputs are both dequantized from float 8 tensors into GemmFloat8, so that the product
+runs on the float 8 tensor cores instead of being computed in float after the dequantization.
+*/
+class GemmFloat8Fusion : public GraphTransformer {
+ public:
+  GemmFloat8Fusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GemmFloat8Fusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+
+#include <optional>
+
 #include "core/optimizer/rule_based_graph_transformer.h"
 
 using namespace onnxruntime;
@@ -26,14 +29,31 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  // Number of modifications made by the transformers of this level so far, and its value after the last run of
+  // each transformer that left the graph unchanged. Such a transformer would find nothing to do again until another
+  // transformer modifies the graph, so it is skipped until then.
+  size_t graph_version = 0;
+  InlinedVector<std::optional<size_t>> unchanged_at_version(transformers->second.size());
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
+    for (size_t i = 0; i < transformers->second.size(); ++i) {
+      const auto& transformer = transformers->second[i];
       if (step > 0 && transformer->ShouldOnlyApplyOnce())
         continue;
 
+      if (unchanged_at_version[i] == graph_version) {
+        continue;
+      }
+
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
+      if (modified) {
+        ++graph_version;
+        unchanged_at_version[i].reset();
+      } else {
+        unchanged_at_version[i] = graph_version;
+      }
       graph_changed = graph_changed || modified;
     }
     if (!graph_changed) {
@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <variant>
 
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/nhwc_transformer.h"
 #include "core/optimizer/qdq_transformer/qdq_final_cleanup.h"
@@ -32,7 +34,9 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/free_dim_override_transformer.h"
@@ -40,14 +44,18 @@
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/gemm_float8_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
+#include "core/optimizer/group_norm_fusion.h"
 #include "core/optimizer/identical_children_consolidation.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/matmul_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
+#include "core/optimizer/matmul_nbits_input_quantization.h"
+#include "core/optimizer/matmul_nbits_weight_quantization.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
@@ -68,7 +76,9 @@
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rocm_blas_alt_impl.h"
+#include "core/optimizer/rotary_embedding_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/optimizer/scan_elimination.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
 #include "core/optimizer/transpose_optimizer.h"
@@ -211,6 +221,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
         transformers.emplace_back(std::make_unique<DoubleQDQPairsRemover>());
       }
 
+      // Replace the Scan nodes that do not carry state between iterations by their bodies first, so the body nodes
+      // are optimized with the rest of the graph.
+      transformers.emplace_back(std::make_unique<ScanElimination>());
+
       // Put ConstantSharing before CommonSubexpressionElimination by intention as it can create more opportunities for
       // CSE. For example, if A and B nodes both do Add operation with a same value but different initializers, by
       // default, CSE will not merge them, because the different initializers are represented by different NodeArg.
@@ -262,6 +276,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                             QDQIsInt8Allowed() ? "1" : "0") == "1";
       const bool enable_gelu_approximation =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGeluApproximation, "0") == "1";
+      const bool enable_gemm_float8_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGemmFloat8Fusion, "0") == "1";
+      const bool enable_elementwise_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableElementwiseFusion, "0") == "1";
 
       const InlinedHashSet<std::string_view> cuda_rocm_eps = {onnxruntime::kCudaExecutionProvider,
                                                               onnxruntime::kRocmExecutionProvider};
@@ -278,8 +296,21 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                                                onnxruntime::kAclExecutionProvider,
                                                                                onnxruntime::kArmNNExecutionProvider,
                                                                                onnxruntime::kJsExecutionProvider};
+      // EPs that run the fused Gelu, FastGelu and SkipLayerNormalization ops. For the JS EP, every fused subgraph
+      // saves the compilation and dispatch of one shader per node.
+      const InlinedHashSet<std::string_view> cpu_cuda_rocm_js_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                     onnxruntime::kCudaExecutionProvider,
+                                                                     onnxruntime::kRocmExecutionProvider,
+                                                                     onnxruntime::kJsExecutionProvider};
+      const InlinedHashSet<std::string_view> cpu_cuda_dml_rocm_js_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                         onnxruntime::kCudaExecutionProvider,
+                                                                         onnxruntime::kRocmExecutionProvider,
+                                                                         onnxruntime::kDmlExecutionProvider,
+                                                                         onnxruntime::kJsExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_dml_eps = {onnxruntime::kCpuExecutionProvider,
                                                             onnxruntime::kDmlExecutionProvider};
+      const InlinedHashSet<std::string_view> cpu_cuda_eps = {onnxruntime::kCpuExecutionProvider,
+                                                             onnxruntime::kCudaExecutionProvider};
 #ifdef MLAS_TARGET_AMD64_IX86
       const bool avx2_precision_mode =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsAvx2PrecisionMode, "0") == "1" && MlasPlatformU8S8Overflow();
@@ -299,12 +330,43 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<MatMulIntegerToFloatFusion>(cpu_dml_eps));
       transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulFusion>(cpu_ep));
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMatMulNBitsWeightQuantization, "0") == "1") {
+        const std::string block_size_str = session_options.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsMatMulNBitsWeightQuantizationBlockSize, "32");
+        const std::string accuracy_level_str = session_options.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsMatMulNBitsWeightQuantizationAccuracyLevel, "0");
+        int64_t block_size = 0;
+        int64_t accuracy_level = 0;
+        ORT_ENFORCE(TryParseStringWithClassicLocale(block_size_str, block_size) &&
+                        (block_size == 16 || block_size == 32 || block_size == 64 || block_size == 128 ||
+                         block_size == 256),
+                    "Invalid value for ", kOrtSessionOptionsMatMulNBitsWeightQuantizationBlockSize, ": ",
+                    block_size_str);
+        ORT_ENFORCE(TryParseStringWithClassicLocale(accuracy_level_str, accuracy_level) &&
+                        accuracy_level >= 0 && accuracy_level <= 4,
+                    "Invalid value for ", kOrtSessionOptionsMatMulNBitsWeightQuantizationAccuracyLevel, ": ",
+                    accuracy_level_str);
+
+        InlinedHashSet<std::string> excluded_nodes;
+        const std::string excluded_nodes_str = session_options.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsMatMulNBitsWeightQuantizationExcludedNodes, "");
+        for (const auto name : utils::SplitString(excluded_nodes_str, ",")) {
+          excluded_nodes.emplace(name);
+        }
+
+        transformers.emplace_back(std::make_unique<MatMulNBitsWeightQuantization>(
+            block_size, accuracy_level, std::move(excluded_nodes), cpu_cuda_eps));
+      }
+      transformers.emplace_back(std::make_unique<MatMulNBitsInputQuantization>(cpu_ep));
 
       transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_cuda_rocm_acl_armnn_js_eps));
 
-      transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_js_eps));
       transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<GroupNormFusion>(cpu_ep));
+      transformers.emplace_back(std::make_unique<RotaryEmbeddingFusion>(cpu_cuda_eps));
+      transformers.emplace_back(std::make_unique<EmbeddingBagFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<AttentionFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<EmbedLayerNormFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<GatherSliceToSplitFusion>(cpu_cuda_rocm_eps));
@@ -313,9 +375,9 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<MatmulTransposeFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<BiasGeluFusion>(cpu_cuda_dml_rocm_eps));
 
-      transformers.emplace_back(std::make_unique<SkipLayerNormFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<SkipLayerNormFusion>(cpu_cuda_dml_rocm_js_eps));
 
-      transformers.emplace_back(std::make_unique<FastGeluFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<FastGeluFusion>(cpu_cuda_rocm_js_eps));
       transformers.emplace_back(std::make_unique<QuickGeluFusion>(cpu_cuda_dml_rocm_eps));
 
       // GeluApproximation has side effects which may change results. It needs to be manually enabled,
@@ -325,6 +387,12 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
         transformers.emplace_back(std::make_unique<GeluApproximation>(cpu_cuda_rocm_eps));
       }
 
+      // GemmFloat8 only runs on GPUs with float 8 tensor cores, so the fusion needs to be manually enabled.
+      if (enable_gemm_float8_fusion) {
+        transformers.emplace_back(std::make_unique<GemmFloat8Fusion>(
+            InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
+      }
+
 #ifdef ENABLE_TRITON
       if (training::framework::triton::TritonOpExecutor::Instance().IsInitialized()) {
         transformers.emplace_back(
@@ -344,6 +412,12 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<MatMulScaleFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<MatMulActivationFusion>(dml_ep));
 
+      // ElementwiseFusion runs after the fusions of specific elementwise patterns (Gelu, LayerNorm, ...) so that it
+      // only picks up the chains left over by them.
+      if (enable_elementwise_fusion) {
+        transformers.emplace_back(std::make_unique<ElementwiseFusion>(cpu_ep));
+      }
+
 #ifdef MLAS_TARGET_AMD64_IX86
       if (avx2_precision_mode) {
         transformers.emplace_back(std::make_unique<Avx2WeightS8ToU8Transformer>(cpu_ep));
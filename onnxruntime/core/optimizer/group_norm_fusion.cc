@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_norm_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Get a constant float initializer with expected_size elements, whose dims are (C, 1, 1) or (1, C, 1, 1) when
+// per_channel is true.
+const TensorProto* GetFloatConstant(const Graph& graph, const NodeArg& arg, int64_t expected_size, bool per_channel) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return nullptr;
+  }
+
+  int64_t size = 1;
+  for (auto dim : tensor_proto->dims()) {
+    size *= dim;
+  }
+  if (size != expected_size) {
+    return nullptr;
+  }
+
+  if (per_channel) {
+    const auto& dims = tensor_proto->dims();
+    const int rank = dims.size();
+    if (rank < 3 || rank > 4 || (rank == 4 && dims[0] != 1) || dims[rank - 1] != 1 || dims[rank - 2] != 1) {
+      return nullptr;
+    }
+  }
+
+  return tensor_proto;
+}
+
+bool IsFilledWith(const Graph& graph, const TensorProto& tensor_proto, float value) {
+  Initializer initializer{tensor_proto, graph.ModelPath()};
+  const float* data = initializer.data<float>();
+  for (size_t i = 0; i < initializer.size(); i++) {
+    if (data[i] != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+NodeArg& AddChannelInitializer(Graph& graph, const TensorProto& source, const std::string& name, int64_t channels) {
+  Initializer initializer{source, graph.ModelPath()};
+  TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(name));
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(channels);
+  tensor_proto.set_raw_data(initializer.data<float>(), gsl::narrow<size_t>(channels) * sizeof(float));
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+// The second Reshape restores the shape of X, either with Shape(X) or with a constant shape.
+bool RestoresInputShape(const Graph& graph, const Node& reshape, const NodeArg& input) {
+  const Node* shape_node = graph_utils::GetInputNode(reshape, 1);
+  if (shape_node != nullptr) {
+    return graph_utils::IsSupportedOptypeVersionAndDomain(*shape_node, "Shape", {1, 13, 15, 19, 21}) &&
+           shape_node->GetAttributes().empty() &&
+           shape_node->InputDefs()[0]->Name() == input.Name();
+  }
+
+  InlinedVector<int64_t> shape;
+  if (!optimizer_utils::AppendTensorFromInitializer(graph, *reshape.InputDefs()[1], shape) || shape.size() != 4) {
+    return false;
+  }
+
+  const auto* input_shape = input.Shape();
+  for (int i = 0; i < 4; i++) {
+    const auto& dim = input_shape->dim(i);
+    const bool copy_dim = (i == 0 && shape[0] == 0);
+    if (!copy_dim && !(dim.has_dim_value() && dim.dim_value() == shape[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status GroupNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (!p_node) continue;
+
+    Node& norm_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(norm_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(norm_node, "InstanceNormalization", {6, 22}) ||
+        !graph_utils::IsSupportedProvider(norm_node, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::CheckOutputEdges(graph, norm_node, 1)) {
+      continue;
+    }
+
+    // Reshape(X, (N, G, -1))
+    const Node* p_reshape_in = graph_utils::GetInputNode(norm_node, 0);
+    if (p_reshape_in == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*p_reshape_in, "Reshape", {5, 13, 14, 19, 21}) ||
+        p_reshape_in->GetExecutionProviderType() != norm_node.GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph, *p_reshape_in, 1) ||
+        optimizer_utils::IsAttributeWithExpectedValue(*p_reshape_in, "allowzero", static_cast<int64_t>(1))) {
+      continue;
+    }
+    Node& reshape_in = *graph.GetNode(p_reshape_in->Index());
+
+    NodeArg* input = reshape_in.MutableInputDefs()[0];
+    const auto* input_shape = input->Shape();
+    if (input->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_FLOAT ||
+        input_shape == nullptr || input_shape->dim_size() != 4 || !input_shape->dim(1).has_dim_value()) {
+      continue;
+    }
+    const int64_t num_channels = input_shape->dim(1).dim_value();
+
+    InlinedVector<int64_t> group_shape;
+    if (!optimizer_utils::AppendTensorFromInitializer(graph, *reshape_in.InputDefs()[1], group_shape) ||
+        group_shape.size() != 3 || group_shape[2] != -1 || group_shape[1] <= 0 ||
+        num_channels % group_shape[1] != 0 ||
+        !(group_shape[0] == 0 ||
+          (input_shape->dim(0).has_dim_value() && input_shape->dim(0).dim_value() == group_shape[0]))) {
+      continue;
+    }
+    const int64_t num_groups = group_shape[1];
+
+    // InstanceNormalization without affine transform: scale is all ones and bias is all zeros.
+    const TensorProto* norm_scale = GetFloatConstant(graph, *norm_node.InputDefs()[1], num_groups, false);
+    const TensorProto* norm_bias = GetFloatConstant(graph, *norm_node.InputDefs()[2], num_groups, false);
+    if (norm_scale == nullptr || norm_bias == nullptr ||
+        !IsFilledWith(graph, *norm_scale, 1.0f) || !IsFilledWith(graph, *norm_bias, 0.0f)) {
+      continue;
+    }
+
+    // Reshape back to (N, C, H, W)
+    Node& reshape_out = *graph.GetNode(norm_node.OutputNodesBegin()->Index());
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(reshape_out, "Reshape", {5, 13, 14, 19, 21}) ||
+        reshape_out.GetExecutionProviderType() != norm_node.GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph, reshape_out, 1) ||
+        !RestoresInputShape(graph, reshape_out, *input)) {
+      continue;
+    }
+    const Node* shape_node = graph_utils::GetInputNode(reshape_out, 1);
+
+    // Mul(gamma) with gamma of shape (C, 1, 1)
+    Node& mul_node = *graph.GetNode(reshape_out.OutputNodesBegin()->Index());
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(mul_node, "Mul", {7, 13, 14}) ||
+        mul_node.GetExecutionProviderType() != norm_node.GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph, mul_node, 1)) {
+      continue;
+    }
+    const int gamma_index = mul_node.InputDefs()[0] == reshape_out.OutputDefs()[0] ? 1 : 0;
+    const TensorProto* gamma = GetFloatConstant(graph, *mul_node.InputDefs()[gamma_index], num_channels, true);
+    if (gamma == nullptr) {
+      continue;
+    }
+
+    // Add(beta) with beta of shape (C, 1, 1)
+    Node& add_node = *graph.GetNode(mul_node.OutputNodesBegin()->Index());
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_node, "Add", {7, 13, 14}) ||
+        add_node.GetExecutionProviderType() != norm_node.GetExecutionProviderType()) {
+      continue;
+    }
+    const int beta_index = add_node.InputDefs()[0] == mul_node.OutputDefs()[0] ? 1 : 0;
+    const TensorProto* beta = GetFloatConstant(graph, *add_node.InputDefs()[beta_index], num_channels, true);
+    if (beta == nullptr) {
+      continue;
+    }
+
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_fuse{reshape_in, norm_node, reshape_out, mul_node, add_node};
+
+    // Optional SiLU: Mul(y, Sigmoid(y))
+    int64_t activation = 0;
+    if (optimizer_utils::CheckOutputEdges(graph, add_node, 2)) {
+      const NodeArg* add_output = add_node.OutputDefs()[0];
+      Node* sigmoid_node = nullptr;
+      Node* silu_mul_node = nullptr;
+      for (auto it = add_node.OutputNodesBegin(); it != add_node.OutputNodesEnd(); ++it) {
+        Node* consumer = graph.GetNode(it->Index());
+        if (graph_utils::IsSupportedOptypeVersionAndDomain(*consumer, "Sigmoid", {6, 13})) {
+          sigmoid_node = consumer;
+        } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*consumer, "Mul", {7, 13, 14})) {
+          silu_mul_node = consumer;
+        }
+      }
+
+      if (sigmoid_node != nullptr && silu_mul_node != nullptr &&
+          sigmoid_node->GetExecutionProviderType() == norm_node.GetExecutionProviderType() &&
+          silu_mul_node->GetExecutionProviderType() == norm_node.GetExecutionProviderType() &&
+          optimizer_utils::CheckOutputEdges(graph, *sigmoid_node, 1) &&
+          sigmoid_node->OutputNodesBegin()->Index() == silu_mul_node->Index() &&
+          (silu_mul_node->InputDefs()[0] == add_output || silu_mul_node->InputDefs()[1] == add_output)) {
+        activation = 1;
+        nodes_to_fuse.push_back(*sigmoid_node);
+        nodes_to_fuse.push_back(*silu_mul_node);
+      }
+    }
+
+    float epsilon = 1e-5f;
+    const auto& norm_attributes = norm_node.GetAttributes();
+    auto epsilon_attr = norm_attributes.find("epsilon");
+    if (epsilon_attr != norm_attributes.end()) {
+      epsilon = epsilon_attr->second.f();
+    }
+
+    NodeArg& gamma_arg = AddChannelInitializer(graph, *gamma, "GroupNorm_gamma", num_channels);
+    NodeArg& beta_arg = AddChannelInitializer(graph, *beta, "GroupNorm_beta", num_channels);
+
+    Node& group_norm_node = graph.AddNode(graph.GenerateNodeName("GroupNorm"),
+                                          "GroupNorm",
+                                          "fused GroupNorm subgraphs",
+                                          {input, &gamma_arg, &beta_arg},
+                                          {nodes_to_fuse.back().get().MutableOutputDefs()[0]},
+                                          {}, kMSDomain);
+    group_norm_node.AddAttribute("epsilon", epsilon);
+    group_norm_node.AddAttribute("groups", num_groups);
+    group_norm_node.AddAttribute("activation", activation);
+    group_norm_node.AddAttribute("channels_last", static_cast<int64_t>(0));
+    group_norm_node.SetExecutionProviderType(norm_node.GetExecutionProviderType());
+
+    const NodeIndex shape_node_index = shape_node != nullptr ? shape_node->Index() : 0;
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, group_norm_node);
+
+    // Shape(X) only fed the removed Reshape.
+    if (shape_node != nullptr) {
+      Node* unused_shape_node = graph.GetNode(shape_node_index);
+      if (unused_shape_node != nullptr && unused_shape_node->GetOutputEdgesCount() == 0 &&
+          !graph.NodeProducesGraphOutput(*unused_shape_node)) {
+        graph_utils::RemoveNode(graph, *unused_shape_node);
+      }
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupNormFusion
+
+Rewrite the decomposed group normalization of exported diffusion models (NCHW input)
+    Reshape(N, G, -1) -> InstanceNormalization(scale=1, bias=0) -> Reshape(N, C, H, W) -> Mul(gamma) -> Add(beta)
+optionally followed by SiLU (x * Sigmoid(x)), to GroupNorm with channels_last=0.
+*/
+class GroupNormFusion : public GraphTransformer {
+ public:
+  GroupNormFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupNormFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_nbits_input_quantization.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas_qnbit.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// The accuracy_level of MatMulNBits that allows the int8 compute type.
+constexpr int64_t kInt8AccuracyLevel = 4;
+
+// Input indices of MatMulNBits.
+constexpr int kZeroPointsInputIndex = 3;
+constexpr int kQuantizedAInputIndex = 5;
+
+// Returns true if `node` is a MatMulNBits that runs with the int8 compute type and takes A as it is, so it can use A
+// quantized by QuantizeMatMulNBitsInput. Sets the K and block_size of the node.
+bool IsMatMulNBitsWithInt8Compute(const Node& node, int64_t& k, int64_t& block_size) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulNBits", {1}, kMSDomain)) {
+    return false;
+  }
+
+  // g_idx reorders the blocks of K and a quantized_A is already set
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() > 4 || input_defs[0]->TypeAsProto() == nullptr ||
+      input_defs[0]->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  // zero points of the type of A are not supported by the MLAS kernels
+  if (input_defs.size() > kZeroPointsInputIndex && input_defs[kZeroPointsInputIndex]->Exists() &&
+      (input_defs[kZeroPointsInputIndex]->TypeAsProto() == nullptr ||
+       input_defs[kZeroPointsInputIndex]->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_UINT8)) {
+    return false;
+  }
+
+  const auto& attributes = node.GetAttributes();
+  const auto bits = attributes.find("bits");
+  const auto k_attr = attributes.find("K");
+  const auto block_size_attr = attributes.find("block_size");
+  const auto accuracy_level = attributes.find("accuracy_level");
+  if (bits == attributes.end() || bits->second.i() != 4 ||
+      k_attr == attributes.end() || block_size_attr == attributes.end() ||
+      accuracy_level == attributes.end() || accuracy_level->second.i() < kInt8AccuracyLevel) {
+    return false;
+  }
+
+  k = k_attr->second.i();
+  block_size = block_size_attr->second.i();
+  return k > 0 && block_size > 0 && MlasIsSQNBitGemmAvailable(4, static_cast<size_t>(block_size), CompInt8);
+}
+
+}  // namespace
+
+Status MatMulNBitsInputQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                               const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // The MatMulNBits nodes of each input A by K and block_size, ordered by name so the nodes are added deterministically.
+  std::map<std::tuple<std::string, int64_t, int64_t>, InlinedVector<NodeIndex>> consumers;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    int64_t k = 0;
+    int64_t block_size = 0;
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !IsMatMulNBitsWithInt8Compute(node, k, block_size)) {
+      continue;
+    }
+
+    consumers[{node.InputDefs()[0]->Name(), k, block_size}].push_back(node_index);
+  }
+
+  for (auto& [key, nodes] : consumers) {
+    // a single consumer quantizes A as fast itself
+    if (nodes.size() < 2) {
+      continue;
+    }
+
+    const auto& [input_name, k, block_size] = key;
+    NodeArg& input = *graph.GetNodeArg(input_name);
+
+    TypeProto quantized_type;
+    quantized_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+    NodeArg& quantized_input = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(input.Name() + "_quantized"),
+                                                        &quantized_type);
+
+    Node& first_consumer = *graph.GetNode(nodes.front());
+    Node& quantize_node = graph.AddNode(graph.GenerateNodeName("QuantizeMatMulNBitsInput"),
+                                        "QuantizeMatMulNBitsInput",
+                                        "quantizes the input A shared by MatMulNBits nodes",
+                                        {&input},
+                                        {&quantized_input},
+                                        nullptr,
+                                        kMSDomain);
+    quantize_node.AddAttribute("K", k);
+    quantize_node.AddAttribute("block_size", block_size);
+    quantize_node.SetExecutionProviderType(first_consumer.GetExecutionProviderType());
+
+    if (const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(first_consumer, 0); input_edge != nullptr) {
+      graph.AddEdge(input_edge->GetNode().Index(), quantize_node.Index(), input_edge->GetSrcArgIndex(), 0);
+    }
+
+    NodeArg& empty_input = graph.GetOrCreateNodeArg("", nullptr);
+    for (NodeIndex node_index : nodes) {
+      Node& node = *graph.GetNode(node_index);
+      for (int i = static_cast<int>(node.InputDefs().size()); i < kQuantizedAInputIndex; ++i) {
+        graph_utils::AddNodeInput(node, i, empty_input);
+      }
+      graph_utils::AddNodeInput(node, kQuantizedAInputIndex, quantized_input);
+      graph.AddEdge(quantize_node.Index(), node_index, 0, kQuantizedAInputIndex);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
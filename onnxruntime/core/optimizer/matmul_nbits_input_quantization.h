@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulNBitsInputQuantization
+Quantize the input A shared by several MatMulNBits nodes with the int8 compute type once, e.g. the input of the Q/K/V
+or gate/up projections of a decoder layer. A QuantizeMatMulNBitsInput node is added for A and its output is passed to
+each of the MatMulNBits nodes as input quantized_A, which they use instead of quantizing A themselves.
+*/
+class MatMulNBitsInputQuantization : public GraphTransformer {
+ public:
+  MatMulNBitsInputQuantization(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulNBitsInputQuantization", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
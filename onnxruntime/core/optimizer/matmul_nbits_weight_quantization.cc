@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_nbits_weight_quantization.h"
+
+#include <type_traits>
+#include <vector>
+
+#include "core/framework/float16.h"
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas_q4.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+constexpr int kQBits = 4;
+
+// Returns the element type of B if `node` is a MatMul whose B is a constant 2D float or float16 initializer that
+// MatMulNBits supports on the EP of the node, or TensorProto_DataType_UNDEFINED otherwise.
+int32_t GetQuantizableWeightType(const Graph& graph, const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+
+  const NodeArg& b = *node.InputDefs()[1];
+  const TensorProto* b_tensor = graph_utils::GetConstantInitializer(graph, b.Name());
+  if (b_tensor == nullptr || b_tensor->dims_size() != 2 || b_tensor->dims(0) <= 0 || b_tensor->dims(1) <= 0) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+
+  // the CPU kernel of MatMulNBits only runs with float A
+  const int32_t type = b_tensor->data_type();
+  const bool is_cpu = node.GetExecutionProviderType() == kCpuExecutionProvider;
+  if (type != TensorProto_DataType_FLOAT && (is_cpu || type != TensorProto_DataType_FLOAT16)) {
+    return TensorProto_DataType_UNDEFINED;
+  }
+
+  return type;
+}
+
+template <typename T>
+void QuantizeWeight(const Initializer& b, int64_t K, int64_t N, int64_t block_size,
+                    std::vector<uint8_t>& data, std::vector<T>& scales, std::vector<uint8_t>& zero_points) {
+  using MlasT = std::conditional_t<std::is_same_v<T, MLFloat16>, MLAS_FP16, float>;
+
+  size_t data_size = 0;
+  size_t scale_count = 0;
+  size_t zero_point_size = 0;
+  MlasBlockwiseQuantizedBufferSizes(kQBits, static_cast<int>(block_size), /* columnwise */ true,
+                                    static_cast<int>(K), static_cast<int>(N),
+                                    data_size, scale_count, &zero_point_size);
+  data.resize(data_size);
+  scales.resize(scale_count);
+  zero_points.resize(zero_point_size);
+
+  MlasQuantizeBlockwise<MlasT, kQBits>(data.data(),
+                                       reinterpret_cast<MlasT*>(scales.data()),
+                                       zero_points.data(),
+                                       reinterpret_cast<const MlasT*>(b.data<T>()),
+                                       static_cast<int>(block_size),
+                                       /* columnwise */ true,
+                                       static_cast<int>(K),
+                                       static_cast<int>(N),
+                                       static_cast<int>(N),
+                                       nullptr);
+}
+
+template <typename T>
+NodeArg& AddInitializer(Graph& graph, const std::string& name, int32_t data_type,
+                        std::initializer_list<int64_t> dims, const std::vector<T>& values) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(name));
+  tensor.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    tensor.add_dims(dim);
+  }
+  tensor.set_raw_data(values.data(), values.size() * sizeof(T));
+  return graph_utils::AddInitializer(graph, tensor);
+}
+
+}  // namespace
+
+Status MatMulNBitsWeightQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                                const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        excluded_nodes_.count(node.Name()) > 0) {
+      continue;
+    }
+
+    const int32_t type = GetQuantizableWeightType(graph, node);
+    if (type == TensorProto_DataType_UNDEFINED) {
+      continue;
+    }
+
+    const NodeArg& b_arg = *node.InputDefs()[1];
+    const TensorProto* b_tensor = graph_utils::GetConstantInitializer(graph, b_arg.Name());
+    const int64_t K = b_tensor->dims(0);
+    const int64_t N = b_tensor->dims(1);
+    const int64_t blocks_per_col = (K + block_size_ - 1) / block_size_;
+    Initializer b(*b_tensor, graph.ModelPath());
+
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> zero_points;
+    NodeArg* scales_arg = nullptr;
+    if (type == TensorProto_DataType_FLOAT) {
+      std::vector<float> scales;
+      QuantizeWeight(b, K, N, block_size_, data, scales, zero_points);
+      scales_arg = &AddInitializer(graph, b_arg.Name() + "_scales", type, {N * blocks_per_col}, scales);
+    } else {
+      std::vector<MLFloat16> scales;
+      QuantizeWeight(b, K, N, block_size_, data, scales, zero_points);
+      scales_arg = &AddInitializer(graph, b_arg.Name() + "_scales", type, {N * blocks_per_col}, scales);
+    }
+    NodeArg& data_arg = AddInitializer(graph, b_arg.Name() + "_q4", TensorProto_DataType_UINT8,
+                                       {N, blocks_per_col, block_size_ * kQBits / 8}, data);
+    NodeArg& zero_points_arg = AddInitializer(graph, b_arg.Name() + "_zero_points", TensorProto_DataType_UINT8,
+                                              {static_cast<int64_t>(zero_points.size())}, zero_points);
+
+    Node& matmul_nbits = graph.AddNode(graph.GenerateNodeName(node.Name() + "_Q4"),
+                                       "MatMulNBits",
+                                       "MatMul with the weight quantized at session creation",
+                                       {node.MutableInputDefs()[0], &data_arg, scales_arg, &zero_points_arg},
+                                       {},
+                                       nullptr,
+                                       kMSDomain);
+    matmul_nbits.AddAttribute("K", K);
+    matmul_nbits.AddAttribute("N", N);
+    matmul_nbits.AddAttribute("bits", static_cast<int64_t>(kQBits));
+    matmul_nbits.AddAttribute("block_size", block_size_);
+    matmul_nbits.AddAttribute("accuracy_level", accuracy_level_);
+    matmul_nbits.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // the initializer of B is removed by Graph::Resolve once no node uses it
+    graph_utils::FinalizeNodeFusion(graph, {node}, matmul_nbits);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulNBitsWeightQuantization
+Quantize the constant 2D float or float16 weight B of MatMul nodes blockwise to 4 bits when the session is created,
+and replace the MatMul nodes with MatMulNBits, so a full precision model can run with weight only quantization
+without an offline conversion. B is quantized asymmetrically along K in blocks of block_size, as the Python
+MatMul4BitsQuantizer does. Nodes named in excluded_nodes, e.g. a sensitive LM head, keep their weight.
+*/
+class MatMulNBitsWeightQuantization : public GraphTransformer {
+ public:
+  MatMulNBitsWeightQuantization(int64_t block_size,
+                                int64_t accuracy_level,
+                                InlinedHashSet<std::string> excluded_nodes,
+                                const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulNBitsWeightQuantization", compatible_execution_providers),
+        block_size_(block_size),
+        accuracy_level_(accuracy_level),
+        excluded_nodes_(std::move(excluded_nodes)) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+ private:
+  const int64_t block_size_;
+  const int64_t accuracy_level_;
+  const InlinedHashSet<std::string> excluded_nodes_;
+};
+
+}  // namespace onnxruntime
@@ -114,6 +114,49 @@ NhwcTransformer::NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<Ker
     }
   }
 
+  // fp32 conv -> fp32 nhwc conv, only where MLAS has no NCHWc kernels. Otherwise the NchwcTransformer
+  // already rewrites the fp32 convolutions it supports to the faster blocked layout.
+  if (MlasNchwcGetBlockSize() <= 1) {
+    OpKernelRegistryId nhwc_conv_fp32{
+        "NhwcFusedConv", kMSDomain, 1, {{"T", {DataTypeImpl::GetTensorType<float>()}}}};
+
+    const KernelCreateInfo* kernel_create_info{};
+    const auto status = cpu_kernel_registry->TryFindKernel(
+        kCpuExecutionProvider, nhwc_conv_fp32.op_type_, nhwc_conv_fp32.domain_,
+        nhwc_conv_fp32.version_, nhwc_conv_fp32.type_constraints_, &kernel_create_info);
+    if (status.IsOK() && kernel_create_info != nullptr) {
+      kernel_create_info = nullptr;
+      conv_table_.emplace(
+          OpIdInfo("Conv", kOnnxDomain, api::DataType::FLOAT),
+          OpTransformInfo{nhwc_conv_fp32.op_type_, nhwc_conv_fp32.domain_, nhwc_conv_fp32.version_, false});
+      conv_table_.emplace(
+          OpIdInfo("FusedConv", kMSDomain, api::DataType::FLOAT),
+          OpTransformInfo{nhwc_conv_fp32.op_type_, nhwc_conv_fp32.domain_, nhwc_conv_fp32.version_, false});
+    }
+  }
+
+  // fp32 pooling -> fp32 nhwc pooling, under the same condition as the fp32 conv above so that the channels last
+  // layout carries through the pooling between the convolutions instead of being transposed back and forth.
+  if (MlasNchwcGetBlockSize() <= 1) {
+    const OpKernelRegistryId nhwc_pools_fp32[] = {
+        {"MaxPool", kMSInternalNHWCDomain, 12, {{"T", {DataTypeImpl::GetTensorType<float>()}}}},
+        {"AveragePool", kMSInternalNHWCDomain, 11, {{"T", {DataTypeImpl::GetTensorType<float>()}}}},
+        {"GlobalAveragePool", kMSInternalNHWCDomain, 1, {{"T", {DataTypeImpl::GetTensorType<float>()}}}},
+    };
+
+    for (const auto& nhwc_pool_fp32 : nhwc_pools_fp32) {
+      const KernelCreateInfo* kernel_create_info{};
+      const auto status = cpu_kernel_registry->TryFindKernel(
+          kCpuExecutionProvider, nhwc_pool_fp32.op_type_, nhwc_pool_fp32.domain_,
+          nhwc_pool_fp32.version_, nhwc_pool_fp32.type_constraints_, &kernel_create_info);
+      if (status.IsOK() && kernel_create_info != nullptr) {
+        conv_table_.emplace(
+            OpIdInfo(nhwc_pool_fp32.op_type_, kOnnxDomain, api::DataType::FLOAT),
+            OpTransformInfo{nhwc_pool_fp32.op_type_, nhwc_pool_fp32.domain_, nhwc_pool_fp32.version_, false});
+      }
+    }
+  }
+
   {
     // fp16 MaxPool -> fp16 nhwc MaxPool
     OpKernelRegistryId nhwc_maxpool_fp16{
@@ -194,6 +237,11 @@ Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       continue;
     }
 
+    // The channels last MaxPool kernels do not produce the optional indices output.
+    if (node->OpType() == "MaxPool" && node->Outputs().size() > 1 && !node->Outputs()[1].empty()) {
+      continue;
+    }
+
     // Skip if already transformed
     if (transform->has_channels_last_attrib_ &&
         node->GetAttributeIntDefault("channels_last", 0) == 1) {
@@ -206,6 +254,11 @@ Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       continue;
     }
 
+    // The fp32 channels last convolution handles 1D to 3D kernels.
+    if (shape->dim_size() > 5 && api_graph->GetValueInfo(node->Inputs()[0])->DType() == api::DataType::FLOAT) {
+      continue;
+    }
+
     // Convert to channels last
     if (transform->has_channels_last_attrib_) {
       node->SetAttributeInt("channels_last", 1);
@@ -72,6 +72,26 @@ std::vector<NodeAndMoveInfo> ConvMoves() {
 
   return moves;
 }
+std::vector<NodeAndMoveInfo> LayerNormMoves(bool has_bias) {
+  NTO::NodeLocation dq_x{NTO::NodeType::kInput, 0};
+  NTO::NodeLocation target{NTO::NodeType::kTarget, 0};
+  NTO::NodeLocation q{NTO::NodeType::kOutput, 0};
+
+  std::vector<NodeAndMoveInfo> moves{
+      MoveAll(dq_x, ArgType::kInput),                              // append all inputs from x
+      MoveAndAppend(target, ArgType::kInput, 1, ArgType::kInput),  // append the float scale
+      MoveAndAppend(q, ArgType::kInput, 1, ArgType::kInput),       // append scale (input 1) from q
+      MoveAndAppend(q, ArgType::kInput, 2, ArgType::kInput)};      // append zp (input 2) from q
+
+  if (has_bias) {
+    moves.push_back(MoveAndAppend(target, ArgType::kInput, 2, ArgType::kInput));  // append the float bias
+  }
+
+  moves.push_back(MoveAll(q, ArgType::kOutput));  // and use the outputs from q
+
+  return moves;
+}
+
 std::vector<NodeAndMoveInfo> WhereMoves() {
   NTO::NodeLocation dq_x{NTO::NodeType::kInput, 0};
   NTO::NodeLocation dq_y{NTO::NodeType::kInput, 1};
@@ -242,6 +262,15 @@ VariadicReplaceWithQLinear::VariadicReplaceWithQLinear(std::string domain)
     : ReplaceWithQLinear(std::move(domain), VariadicMoves()) {
 }
 
+LayerNormReplaceWithQLinear::LayerNormReplaceWithQLinear()
+    : ReplaceWithQLinear(kMSDomain, LayerNormMoves(true)) {
+}
+
+std::vector<NodeAndMoveInfo> LayerNormReplaceWithQLinear::ValueMoves(const RuntimeState& state) const {
+  const auto& input_defs = state.selected_nodes.Target().InputDefs();
+  return LayerNormMoves(input_defs.size() > 2 && input_defs[2]->Exists());
+}
+
 ConvReplaceWithQLinear::ConvReplaceWithQLinear()
     : ReplaceWithQLinear(kOnnxDomain, ConvMoves()) {
 }
@@ -268,9 +297,19 @@ Status MatMulReplaceWithQLinear::Run(Graph& graph, const NodesToOptimize& select
   bool matmul_integer_to_float = selected_nodes.num_outputs == 0;
   if (matmul_integer_to_float) {
     return matmul_int_to_float_replacer_.Run(graph, selected_nodes);
-  } else {
-    return qlinear_matmul_replacer_.Run(graph, selected_nodes);
   }
+
+  // there is no QLinearMatMul for a 16-bit A, use MatMulIntegerToFloat and keep the Q of the output
+  const auto* a_type = selected_nodes.Input(0)->InputDefs()[0]->TypeAsProto();
+  if (a_type != nullptr && (a_type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_INT16 ||
+                            a_type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_UINT16)) {
+    const std::array<int, 2> dq_indices{0, 1};
+    const auto dq_nodes = selected_nodes.Inputs(dq_indices);
+    NodesToOptimize dq_and_target(dq_nodes, selected_nodes.Target(), {});
+    return matmul_int_to_float_replacer_.Run(graph, dq_and_target);
+  }
+
+  return qlinear_matmul_replacer_.Run(graph, selected_nodes);
 }
 
 static std::vector<NodeAndMoveInfo> GetGemmMoveInfo(bool does_q_node_exist) {
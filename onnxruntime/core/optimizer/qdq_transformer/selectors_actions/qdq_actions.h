@@ -56,6 +56,14 @@ struct VariadicReplaceWithQLinear : ReplaceWithQLinear {
   VariadicReplaceWithQLinear(std::string domain);
 };
 
+// QLinearLayerNormalization takes the optional bias last, so the moves depend on whether the target has one
+struct LayerNormReplaceWithQLinear : ReplaceWithQLinear {
+  LayerNormReplaceWithQLinear();
+
+ private:
+  std::vector<NodeAndMoveInfo> ValueMoves(const RuntimeState& state) const override;
+};
+
 struct ConvReplaceWithQLinear : ReplaceWithQLinear {
   ConvReplaceWithQLinear();
 };
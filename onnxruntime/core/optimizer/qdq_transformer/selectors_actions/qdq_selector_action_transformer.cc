@@ -112,7 +112,27 @@ void UnaryOpQDQRules(SelectorActionRegistry& qdq_selector_action_registry) {
                                                           {"LeakyRelu", {}},
                                                           {"GlobalAveragePool", {}},
                                                           {"Sigmoid", {}},
-                                                          {"Softmax", {}}},
+                                                          {"Softmax", {}},
+                                                          {"Gelu", {}},
+                                                          {SelectorActionRegistry::OpVersionsMapKey("Gelu", kMSDomain), {}}},
+                                                         std::move(selector),
+                                                         std::move(action));
+#else
+  qdq_selector_action_registry.RegisterAction(action_name, std::move(action));
+#endif
+}
+
+void LayerNormQDQRules(SelectorActionRegistry& qdq_selector_action_registry) {
+  // 3 nodes. DQ for X, LayerNormalization with float scale and bias, Q
+  // Replace with QLinearLayerNormalization. Delete all original nodes.
+  const std::string action_name{"LayerNorm"};
+  std::unique_ptr<Action> action = std::make_unique<QDQ::LayerNormReplaceWithQLinear>();
+
+#if !defined(ORT_MINIMAL_BUILD)
+  std::vector<const char*> providers = {kCpuExecutionProvider};
+  std::unique_ptr<NodeSelector> selector = std::make_unique<QDQ::LayerNormSelector>(providers);
+  qdq_selector_action_registry.RegisterSelectorAndAction(action_name,
+                                                         {{"LayerNormalization", {}}},
                                                          std::move(selector),
                                                          std::move(action));
 #else
@@ -215,6 +235,7 @@ void MatMulQDQRules(SelectorActionRegistry& qdq_selector_action_registry, bool i
   std::unique_ptr<Action> action = std::make_unique<QDQ::MatMulReplaceWithQLinear>();
 
 #if !defined(ORT_MINIMAL_BUILD)
+  // 16-bit A with 8-bit B is replaced with MatMulIntegerToFloat, keeping the Q of the output if any.
   // TODO: Enable 16-bit types in selector when QLinearMatMul and MatMulInteger support 16-bit.
   std::vector<const char*> providers = {kCpuExecutionProvider};
   std::unique_ptr<NodeSelector> selector = std::make_unique<QDQ::MatMulSelector>(providers, is_int8_allowed);
@@ -278,6 +299,7 @@ SelectorActionRegistry CreateSelectorActionRegistry(bool is_int8_allowed) {
   DropQDQNodesRules(qdq_selector_action_registry);
   DropDQNodesRules(qdq_selector_action_registry);
   UnaryOpQDQRules(qdq_selector_action_registry);
+  LayerNormQDQRules(qdq_selector_action_registry);
   BinaryOpQDQRules(qdq_selector_action_registry);
   VariadicOpQDQRules(qdq_selector_action_registry);
   ConvQDQRules(qdq_selector_action_registry, is_int8_allowed);
@@ -196,6 +196,29 @@ bool UnaryNodeGroupSelector::Check(const GraphViewer& graph_viewer, const Node&
   return true;
 }
 
+bool LayerNormNodeGroupSelector::Check(const GraphViewer& graph_viewer, const Node& node,
+                                       const std::vector<const Node*>& dq_nodes,
+                                       const std::vector<const Node*>& q_nodes) const {
+  // only X is quantized, scale and bias stay float
+  if (!CheckQDQNodes(graph_viewer, node, dq_nodes, q_nodes, 1) ||
+      node.InputDefs()[0] != dq_nodes[0]->OutputDefs()[0]) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  for (size_t i = 1; i < input_defs.size(); ++i) {
+    if (input_defs[i]->Exists() &&
+        input_defs[i]->TypeAsProto()->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+      return false;
+    }
+  }
+
+  int32_t dt_input = dq_nodes[0]->InputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
+  int32_t dt_output = q_nodes[0]->OutputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
+
+  return dt_input == dt_output && !Is16BitIntType(dt_input);
+}
+
 bool BinaryNodeGroupSelector::Check(const GraphViewer& graph_viewer,
                                     const Node& node,
                                     const std::vector<const Node*>& dq_nodes,
@@ -348,6 +371,16 @@ bool MatMulNodeGroupSelector::Check(const GraphViewer& graph_viewer,
   int32_t dt_input = dq_nodes[0]->InputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
   int32_t dt_weight = dq_nodes[1]->InputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
 
+  // 16-bit A with 8-bit B is replaced with MatMulIntegerToFloat and a Q of the output is kept. The zero point of A
+  // must be explicit as the default zero point added by the action is 8-bit.
+  if (allow_16bit_a_to_float_ && Is16BitIntType(dt_input)) {
+    const auto& a_dq_inputs = dq_nodes[0]->InputDefs();
+    return matmulintegertofloat_allowed_ &&
+           (dt_weight == ONNX_NAMESPACE::TensorProto_DataType_INT8 ||
+            dt_weight == ONNX_NAMESPACE::TensorProto_DataType_UINT8) &&
+           a_dq_inputs.size() == 3 && a_dq_inputs[InputIndex::ZERO_POINT_ID]->Exists();
+  }
+
   if (dt_input == ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT8) {
     if (!int8_allowed_ || dt_weight != dt_input) {
       return false;
@@ -102,6 +102,14 @@ class BinaryNodeGroupSelector : public NodeGroupSelector {
   bool allow_16bit_;
 };
 
+// DQ node for X -> LayerNormalization with float scale and bias -> Q
+class LayerNormNodeGroupSelector : public NodeGroupSelector {
+ private:
+  bool Check(const GraphViewer& graph_viewer, const Node& node,
+             const std::vector<const Node*>& dq_nodes,
+             const std::vector<const Node*>& q_nodes) const override;
+};
+
 // Variadic DQ nodes -> node -> Q
 class VariadicNodeGroupSelector : public NodeGroupSelector {
  public:
@@ -178,10 +186,12 @@ class MatMulNodeGroupSelector : public NodeGroupSelector {
  public:
   MatMulNodeGroupSelector(bool int8_allowed = true,
                           bool matmulintegertofloat_allowed = false,
-                          bool allow_16bit = true)
+                          bool allow_16bit = true,
+                          bool allow_16bit_a_to_float = false)
       : int8_allowed_(int8_allowed),
         matmulintegertofloat_allowed_(matmulintegertofloat_allowed),
-        allow_16bit_(allow_16bit) {
+        allow_16bit_(allow_16bit),
+        allow_16bit_a_to_float_(allow_16bit_a_to_float) {
   }
 
  private:
@@ -191,6 +201,8 @@ class MatMulNodeGroupSelector : public NodeGroupSelector {
   bool int8_allowed_;
   bool matmulintegertofloat_allowed_;
   bool allow_16bit_;
+  // select a 16-bit A with an 8-bit B for MatMulIntegerToFloat, with or without a Q of the output
+  bool allow_16bit_a_to_float_;
 };
 
 // Input: DQ nodes for A, B and optional C
@@ -295,6 +307,12 @@ class UnarySelector : public BaseSelector {
       : BaseSelector(std::make_unique<UnaryNodeGroupSelector>(allow_16bit), compatible_providers) {}
 };
 
+class LayerNormSelector : public BaseSelector {
+ public:
+  explicit LayerNormSelector(gsl::span<const char*> compatible_providers = {})
+      : BaseSelector(std::make_unique<LayerNormNodeGroupSelector>(), compatible_providers) {}
+};
+
 class BinarySelector : public BaseSelector {
  public:
   explicit BinarySelector(gsl::span<const char*> compatible_providers = {}, bool allow_16bit = false)
@@ -339,7 +357,7 @@ class MatMulSelector : public BaseSelector {
  public:
   MatMulSelector(gsl::span<const char*> compatible_providers, bool int8_allowed, bool allow_16bit = false)
       : BaseSelector(std::make_unique<MatMulNodeGroupSelector>(int8_allowed, /*matmulintegertofloat_allowed*/ true,
-                                                               allow_16bit),
+                                                               allow_16bit, /*allow_16bit_a_to_float*/ true),
                      compatible_providers) {}
 };
 
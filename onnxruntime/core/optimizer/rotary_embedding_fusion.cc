@@ -0,0 +1,380 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/rotary_embedding_fusion.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// The cos or sin half of the rotary embedding: Unsqueeze(Gather(cache, position_ids), axes=[1]), where the cache may
+// be sliced as cache[:sequence_length] before the Gather.
+struct CacheMatch {
+  InlinedVector<NodeIndex, 3> nodes;  // Unsqueeze, Gather and the optional Slice
+  const TensorProto* cache;
+  const NodeArg* position_ids;
+};
+
+struct RotaryMatch {
+  const Node* cos_mul;
+  const Node* sin_mul;
+  const Node* concat;
+  const Node* neg;
+  const Node* slice_lo;
+  const Node* slice_hi;
+  const NodeArg* x;
+  CacheMatch cos;
+  CacheMatch sin;
+};
+
+// Returns the producer of the given input of node if it is of op_type, runs on the same EP and has node as its only
+// consumer.
+const Node* GetExclusiveProducer(const Graph& graph, const Node& node, size_t input_index, std::string_view op_type,
+                                 std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion> versions) {
+  if (input_index >= node.InputDefs().size()) {
+    return nullptr;
+  }
+
+  const Node* producer = graph.GetProducerNode(node.InputDefs()[input_index]->Name());
+  if (producer == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*producer, op_type, versions) ||
+      producer->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+      !optimizer_utils::CheckOutputEdges(graph, *producer, 1)) {
+    return nullptr;
+  }
+  return producer;
+}
+
+bool HaveSameDim(const TensorShapeProto_Dimension& a, const TensorShapeProto_Dimension& b) {
+  return (utils::HasDimValue(a) && utils::HasDimValue(b) && a.dim_value() == b.dim_value()) ||
+         (utils::HasDimParam(a) && utils::HasDimParam(b) && a.dim_param() == b.dim_param());
+}
+
+// Whether slice takes [start, end) of the last axis of a 4D input whose last dimension is head_size.
+bool IsLastAxisSlice(const Graph& graph, const Node& slice, int64_t start, int64_t end, int64_t head_size) {
+  const auto& inputs = slice.InputDefs();
+  InlinedVector<int64_t> starts;
+  InlinedVector<int64_t> ends;
+  InlinedVector<int64_t> axes;
+  if (inputs.size() < 4 ||
+      !optimizer_utils::AppendTensorFromInitializer(graph, *inputs[1], starts) ||
+      !optimizer_utils::AppendTensorFromInitializer(graph, *inputs[2], ends) ||
+      !optimizer_utils::AppendTensorFromInitializer(graph, *inputs[3], axes) ||
+      starts.size() != 1 || ends.size() != 1 || axes.size() != 1 ||
+      (axes[0] != -1 && axes[0] != 3)) {
+    return false;
+  }
+
+  if (inputs.size() > 4 && inputs[4]->Exists()) {
+    InlinedVector<int64_t> steps;
+    if (!optimizer_utils::AppendTensorFromInitializer(graph, *inputs[4], steps) || steps.size() != 1 ||
+        steps[0] != 1) {
+      return false;
+    }
+  }
+
+  const int64_t slice_start = starts[0] < 0 ? starts[0] + head_size : starts[0];
+  const int64_t slice_end = ends[0] < 0 ? ends[0] + head_size : std::min(ends[0], head_size);
+  return slice_start == start && slice_end == end;
+}
+
+bool MatchCache(const Graph& graph, const NodeArg& cos_or_sin, const Node& mul, int64_t head_size,
+                int32_t elem_type, CacheMatch& match) {
+  const Node* unsqueeze = graph.GetProducerNode(cos_or_sin.Name());
+  if (unsqueeze == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*unsqueeze, "Unsqueeze", {1, 11, 13}) ||
+      unsqueeze->GetExecutionProviderType() != mul.GetExecutionProviderType() ||
+      graph.NodeProducesGraphOutput(*unsqueeze)) {
+    return false;
+  }
+
+  InlinedVector<int64_t> axes;
+  if (unsqueeze->SinceVersion() < 13) {
+    const auto* axes_attr = graph_utils::GetNodeAttribute(*unsqueeze, "axes");
+    if (axes_attr != nullptr) {
+      axes.assign(axes_attr->ints().begin(), axes_attr->ints().end());
+    }
+  } else if (unsqueeze->InputDefs().size() < 2 ||
+             !optimizer_utils::AppendTensorFromInitializer(graph, *unsqueeze->InputDefs()[1], axes)) {
+    return false;
+  }
+  if (axes.size() != 1 || axes[0] != 1) {
+    return false;
+  }
+
+  const Node* gather = graph.GetProducerNode(unsqueeze->InputDefs()[0]->Name());
+  if (gather == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*gather, "Gather", {1, 11, 13}) ||
+      gather->GetExecutionProviderType() != mul.GetExecutionProviderType() ||
+      graph.NodeProducesGraphOutput(*gather)) {
+    return false;
+  }
+
+  const auto* axis_attr = graph_utils::GetNodeAttribute(*gather, "axis");
+  if (axis_attr != nullptr && utils::HasInt(*axis_attr) && axis_attr->i() != 0) {
+    return false;
+  }
+
+  const NodeArg* position_ids = gather->InputDefs()[1];
+  const auto* position_ids_shape = position_ids->Shape();
+  if (position_ids->TypeAsProto() == nullptr ||
+      position_ids->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_INT64 ||
+      position_ids_shape == nullptr || position_ids_shape->dim_size() != 2) {
+    return false;
+  }
+
+  // The cache may be cut to the current sequence length first, which selects the same rows for valid positions.
+  const Node* slice = nullptr;
+  const TensorProto* cache = graph_utils::GetConstantInitializer(graph, gather->InputDefs()[0]->Name());
+  if (cache == nullptr) {
+    slice = graph.GetProducerNode(gather->InputDefs()[0]->Name());
+    if (slice == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*slice, "Slice", {10, 11, 13}) ||
+        graph.NodeProducesGraphOutput(*slice)) {
+      return false;
+    }
+
+    const auto& slice_inputs = slice->InputDefs();
+    InlinedVector<int64_t> starts;
+    InlinedVector<int64_t> slice_axes;
+    InlinedVector<int64_t> steps;
+    if (!optimizer_utils::AppendTensorFromInitializer(graph, *slice_inputs[1], starts) || starts.size() != 1 ||
+        starts[0] != 0 ||
+        (slice_inputs.size() > 3 && slice_inputs[3]->Exists() &&
+         (!optimizer_utils::AppendTensorFromInitializer(graph, *slice_inputs[3], slice_axes) ||
+          slice_axes.size() != 1 || slice_axes[0] != 0)) ||
+        (slice_inputs.size() > 4 && slice_inputs[4]->Exists() &&
+         (!optimizer_utils::AppendTensorFromInitializer(graph, *slice_inputs[4], steps) ||
+          steps.size() != 1 || steps[0] != 1))) {
+      return false;
+    }
+
+    cache = graph_utils::GetConstantInitializer(graph, slice_inputs[0]->Name());
+  }
+
+  if (cache == nullptr || cache->data_type() != elem_type || cache->dims_size() != 2 ||
+      cache->dims(1) != head_size) {
+    return false;
+  }
+
+  match.nodes = {unsqueeze->Index(), gather->Index()};
+  if (slice != nullptr) {
+    match.nodes.push_back(slice->Index());
+  }
+  match.cache = cache;
+  match.position_ids = position_ids;
+  return true;
+}
+
+bool MatchRotary(const Graph& graph, const Node& cos_mul, const Node& sin_mul, RotaryMatch& match) {
+  // rotate_half(x) * sin
+  const Node* concat = nullptr;
+  size_t sin_index = 0;
+  for (size_t i = 0; i < 2 && concat == nullptr; ++i) {
+    concat = GetExclusiveProducer(graph, sin_mul, i, "Concat", {4, 11, 13});
+    sin_index = 1 - i;
+  }
+  if (concat == nullptr || concat->InputDefs().size() != 2) {
+    return false;
+  }
+
+  const auto* axis_attr = graph_utils::GetNodeAttribute(*concat, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr) || (axis_attr->i() != -1 && axis_attr->i() != 3)) {
+    return false;
+  }
+
+  const Node* neg = GetExclusiveProducer(graph, *concat, 0, "Neg", {6, 13});
+  const Node* slice_hi = neg != nullptr ? GetExclusiveProducer(graph, *neg, 0, "Slice", {10, 11, 13}) : nullptr;
+  const Node* slice_lo = GetExclusiveProducer(graph, *concat, 1, "Slice", {10, 11, 13});
+  if (slice_hi == nullptr || slice_lo == nullptr || slice_hi->InputDefs()[0] != slice_lo->InputDefs()[0]) {
+    return false;
+  }
+
+  // x * cos
+  const NodeArg* x = slice_lo->InputDefs()[0];
+  size_t cos_index = 0;
+  if (cos_mul.InputDefs()[0] == x) {
+    cos_index = 1;
+  } else if (cos_mul.InputDefs()[1] != x) {
+    return false;
+  }
+
+  const auto* x_shape = x->Shape();
+  if (x->TypeAsProto() == nullptr || x_shape == nullptr || x_shape->dim_size() != 4 ||
+      !utils::HasDimValue(x_shape->dim(3)) || x_shape->dim(3).dim_value() <= 0 ||
+      x_shape->dim(3).dim_value() % 2 != 0) {
+    return false;
+  }
+
+  // The CPU kernel is only implemented for float.
+  const int32_t elem_type = x->TypeAsProto()->tensor_type().elem_type();
+  if (elem_type != TensorProto_DataType_FLOAT &&
+      !(elem_type == TensorProto_DataType_FLOAT16 && cos_mul.GetExecutionProviderType() == kCudaExecutionProvider)) {
+    return false;
+  }
+
+  const int64_t head_size = x_shape->dim(3).dim_value();
+  if (!IsLastAxisSlice(graph, *slice_lo, 0, head_size / 2, head_size) ||
+      !IsLastAxisSlice(graph, *slice_hi, head_size / 2, head_size, head_size)) {
+    return false;
+  }
+
+  if (!MatchCache(graph, *cos_mul.InputDefs()[cos_index], cos_mul, head_size, elem_type, match.cos) ||
+      !MatchCache(graph, *sin_mul.InputDefs()[sin_index], sin_mul, head_size, elem_type, match.sin) ||
+      match.cos.position_ids != match.sin.position_ids) {
+    return false;
+  }
+
+  // position_ids must be (batch_size, sequence_length) for the (batch_size, num_heads, sequence_length, head_size) x.
+  const auto* position_ids_shape = match.cos.position_ids->Shape();
+  if (!HaveSameDim(position_ids_shape->dim(0), x_shape->dim(0)) ||
+      !HaveSameDim(position_ids_shape->dim(1), x_shape->dim(2))) {
+    return false;
+  }
+
+  match.cos_mul = &cos_mul;
+  match.sin_mul = &sin_mul;
+  match.concat = concat;
+  match.neg = neg;
+  match.slice_lo = slice_lo;
+  match.slice_hi = slice_hi;
+  match.x = x;
+  return true;
+}
+
+// Returns an initializer with the first half of each row of the cache, or nullptr if the halves of a row differ.
+// The Hugging Face caches are cat(freqs, freqs), which the RotaryEmbedding kernels store once.
+NodeArg* GetHalfCache(Graph& graph, const TensorProto& cache, InlinedHashMap<std::string, NodeArg*>& half_caches) {
+  auto it = half_caches.find(cache.name());
+  if (it != half_caches.end()) {
+    return it->second;
+  }
+
+  Initializer cache_values{cache, graph.ModelPath()};
+  const auto bytes = cache_values.DataAsByteSpan();
+  const size_t rows = narrow<size_t>(cache.dims(0));
+  if (rows == 0) {
+    return nullptr;
+  }
+
+  const size_t row_bytes = bytes.size() / rows;
+  const size_t half_bytes = row_bytes / 2;
+  std::string half_data;
+  half_data.reserve(rows * half_bytes);
+  for (size_t row = 0; row < rows; ++row) {
+    const uint8_t* row_data = bytes.data() + row * row_bytes;
+    if (std::memcmp(row_data, row_data + half_bytes, half_bytes) != 0) {
+      return nullptr;
+    }
+    half_data.append(reinterpret_cast<const char*>(row_data), half_bytes);
+  }
+
+  TensorProto half_cache;
+  half_cache.set_name(graph.GenerateNodeArgName(cache.name() + "_half"));
+  half_cache.set_data_type(cache.data_type());
+  half_cache.add_dims(cache.dims(0));
+  half_cache.add_dims(cache.dims(1) / 2);
+  half_cache.set_raw_data(std::move(half_data));
+
+  NodeArg* half_cache_arg = &graph_utils::AddInitializer(graph, half_cache);
+  half_caches.emplace(cache.name(), half_cache_arg);
+  return half_cache_arg;
+}
+
+void AddInputEdge(Graph& graph, const NodeArg& input, Node& node, int input_index) {
+  const Node* producer = graph.GetProducerNode(input.Name());
+  if (producer != nullptr) {
+    graph.AddEdge(producer->Index(), node.Index(), optimizer_utils::IndexOfNodeOutput(*producer, input), input_index);
+  }
+}
+
+// The cos and sin are usually shared by the rotations of query and key, so their nodes are only removed once the
+// last rotation consuming them has been fused.
+void RemoveCacheNodesIfUnused(Graph& graph, const CacheMatch& match) {
+  for (NodeIndex index : match.nodes) {
+    Node* node = graph.GetNode(index);
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 || graph.NodeProducesGraphOutput(*node)) {
+      return;
+    }
+    graph.RemoveNode(index);
+  }
+}
+
+}  // namespace
+
+Status RotaryEmbeddingFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashMap<std::string, NodeArg*> half_caches;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) continue;  // we removed the node as part of an earlier fusion
+
+    Node& add_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(add_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_node, "Add", {7, 13, 14}) ||
+        !graph_utils::IsSupportedProvider(add_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* mul_0 = GetExclusiveProducer(graph, add_node, 0, "Mul", {7, 13, 14});
+    const Node* mul_1 = GetExclusiveProducer(graph, add_node, 1, "Mul", {7, 13, 14});
+    RotaryMatch match{};
+    if (mul_0 == nullptr || mul_1 == nullptr ||
+        (!MatchRotary(graph, *mul_0, *mul_1, match) && !MatchRotary(graph, *mul_1, *mul_0, match))) {
+      continue;
+    }
+
+    NodeArg* cos_cache = GetHalfCache(graph, *match.cos.cache, half_caches);
+    NodeArg* sin_cache = GetHalfCache(graph, *match.sin.cache, half_caches);
+    if (cos_cache == nullptr || sin_cache == nullptr) {
+      continue;
+    }
+
+    NodeArg* x = graph.GetNodeArg(match.x->Name());
+    NodeArg* position_ids = graph.GetNodeArg(match.cos.position_ids->Name());
+    Node& rotary_node = graph.AddNode(graph.GenerateNodeName("RotaryEmbedding"),
+                                      "RotaryEmbedding",
+                                      "fused rotary embedding of " + add_node.Name(),
+                                      {x, position_ids, cos_cache, sin_cache},
+                                      {add_node.MutableOutputDefs()[0]},
+                                      nullptr,
+                                      kMSDomain);
+    rotary_node.SetExecutionProviderType(add_node.GetExecutionProviderType());
+
+    AddInputEdge(graph, *x, rotary_node, 0);
+    AddInputEdge(graph, *position_ids, rotary_node, 1);
+
+    const auto output_edges = graph_utils::GraphEdge::GetNodeOutputEdges(add_node);
+    for (const auto& edge : output_edges) {
+      graph.AddEdge(rotary_node.Index(), edge.dst_node, 0, edge.dst_arg_index);
+    }
+    graph_utils::GraphEdge::RemoveGraphEdges(graph, output_edges);
+
+    // Each node only feeds the one removed before it.
+    const NodeIndex nodes_to_remove[] = {add_node.Index(), match.cos_mul->Index(), match.sin_mul->Index(),
+                                         match.concat->Index(), match.neg->Index(), match.slice_lo->Index(),
+                                         match.slice_hi->Index()};
+    for (NodeIndex index : nodes_to_remove) {
+      graph.RemoveNode(index);
+    }
+
+    RemoveCacheNodesIfUnused(graph, match.cos);
+    RemoveCacheNodesIfUnused(graph, match.sin);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
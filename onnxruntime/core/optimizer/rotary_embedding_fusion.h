@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuses the rotary positional embedding of the Llama/Mistral decoder exports,
+ *   x * Unsqueeze(Gather(cos_cache, position_ids)) + rotate_half(x) * Unsqueeze(Gather(sin_cache, position_ids))
+ * where rotate_half(x) is Concat(Neg(x[..., H/2:]), x[..., :H/2]), into a RotaryEmbedding node.
+ *
+ * x must have the shape (batch_size, num_heads, sequence_length, head_size) and the caches must be constant
+ * initializers of shape (max_sequence_length, head_size) whose two halves are equal, as produced by the
+ * Hugging Face implementations. The fused node uses the first half of each cache.
+ */
+class RotaryEmbeddingFusion : public GraphTransformer {
+ public:
+  RotaryEmbeddingFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("RotaryEmbeddingFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
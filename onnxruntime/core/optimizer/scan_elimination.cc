@@ -0,0 +1,291 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/scan_elimination.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+// ops that compute each element of the output from the elements of the inputs at the same (broadcast) position
+const InlinedHashSet<std::string_view>& ElementwiseOps() {
+  static const InlinedHashSet<std::string_view> ops = {
+      "Abs", "Add", "And", "Cast", "Ceil", "Clip", "Cos", "Div", "Elu", "Equal", "Erf", "Exp", "Floor", "Greater",
+      "GreaterOrEqual", "HardSigmoid", "Identity", "LeakyRelu", "Less", "LessOrEqual", "Log", "Max", "Mean", "Min",
+      "Mul", "Neg", "Not", "Or", "Pow", "PRelu", "Reciprocal", "Relu", "Round", "Selu", "Sigmoid", "Sign", "Sin",
+      "Softplus", "Softsign", "Sqrt", "Sub", "Sum", "Tanh", "Where", "Xor"};
+  return ops;
+}
+
+bool AllZeros(const Node& node, const std::string& attr_name) {
+  InlinedVector<int64_t> values;
+  if (graph_utils::GetNodeAttribute(node, attr_name) == nullptr) {
+    return true;
+  }
+
+  return graph_utils::GetRepeatedNodeAttributeValues(node, attr_name, values) &&
+         std::all_of(values.cbegin(), values.cend(), [](int64_t value) { return value == 0; });
+}
+
+int GetRank(const NodeArg& node_arg) {
+  const auto* shape = node_arg.Shape();
+  return shape != nullptr ? shape->dim_size() : -1;
+}
+
+// Returns true if running the body node once on the values of all the iterations stacked along a new leading axis
+// produces the outputs of all the iterations stacked the same way.
+// is_per_iteration tells which inputs differ between iterations. The others are broadcast to all the iterations.
+bool CanBatchNode(const Node& node, const InlinedVector<bool>& is_per_iteration) {
+  const auto& input_defs = node.InputDefs();
+  if (node.OpType() == "MatMul") {
+    const int rank_a = GetRank(*input_defs[0]);
+    const int rank_b = GetRank(*input_defs[1]);
+    if (rank_a < 1 || rank_b < 1) {
+      return false;
+    }
+
+    // the new leading axis has to end up in the batch dimensions of MatMul, or in the row dimension of a vector A
+    if (is_per_iteration[0] && is_per_iteration[1]) {
+      return rank_a == rank_b && rank_a >= 2;
+    }
+
+    if (is_per_iteration[0]) {
+      return rank_a == 1 ? rank_b <= 2 : rank_b <= rank_a;
+    }
+
+    return rank_b >= 2 && (rank_a == 1 || rank_a <= rank_b);
+  }
+
+  // the per-iteration values need the full output rank so they all get the new leading axis at the same position,
+  // and the broadcast values must not reach it
+  const int output_rank = GetRank(*node.OutputDefs()[0]);
+  if (output_rank < 0) {
+    return false;
+  }
+
+  for (size_t i = 0; i < input_defs.size(); ++i) {
+    if (!input_defs[i]->Exists()) {
+      continue;
+    }
+
+    const int rank = GetRank(*input_defs[i]);
+    if (rank < 0) {
+      return false;
+    }
+
+    if (is_per_iteration[i]) {
+      // the min and max of Clip must stay scalars
+      if (rank != output_rank || (node.OpType() == "Clip" && i > 0)) {
+        return false;
+      }
+    } else if (rank > output_rank) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Checks that the Scan node can be replaced by its body. On success, body_nodes contains the body nodes in
+// topological order.
+bool CanEliminateScan(const Node& scan_node, const Graph& body, InlinedVector<NodeIndex>& body_nodes) {
+  const int64_t num_scan_inputs = scan_node.GetAttributes().at("num_scan_inputs").i();
+  if (num_scan_inputs != static_cast<int64_t>(scan_node.InputDefs().size()) ||
+      !AllZeros(scan_node, "scan_input_axes") || !AllZeros(scan_node, "scan_input_directions") ||
+      !AllZeros(scan_node, "scan_output_axes") || !AllZeros(scan_node, "scan_output_directions")) {
+    return false;
+  }
+
+  InlinedHashSet<std::string_view> per_iteration_values;
+  for (const auto* input : body.GetInputs()) {
+    per_iteration_values.insert(input->Name());
+  }
+
+  GraphViewer body_viewer(body);
+  for (const auto node_index : body_viewer.GetNodesInTopologicalOrder()) {
+    const Node& node = *body.GetNode(node_index);
+    if (node.Domain() != kOnnxDomain) {
+      return false;
+    }
+
+    if (node.OpType() == "Constant") {
+      body_nodes.push_back(node_index);
+      continue;
+    }
+
+    if (node.OpType() != "MatMul" && ElementwiseOps().count(node.OpType()) == 0) {
+      return false;
+    }
+
+    InlinedVector<bool> is_per_iteration;
+    for (const auto* input : node.InputDefs()) {
+      is_per_iteration.push_back(input->Exists() && per_iteration_values.count(input->Name()) > 0);
+    }
+
+    if (!CanBatchNode(node, is_per_iteration)) {
+      return false;
+    }
+
+    if (std::any_of(is_per_iteration.cbegin(), is_per_iteration.cend(), [](bool value) { return value; })) {
+      for (const auto* output : node.OutputDefs()) {
+        per_iteration_values.insert(output->Name());
+      }
+    }
+
+    body_nodes.push_back(node_index);
+  }
+
+  // every output must be stacked from a distinct per-iteration value computed by the body
+  InlinedHashSet<std::string_view> outputs;
+  for (const auto* output : body.GetOutputs()) {
+    if (body.GetProducerNode(output->Name()) == nullptr || per_iteration_values.count(output->Name()) == 0 ||
+        !outputs.insert(output->Name()).second) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void EliminateScan(Graph& graph, Node& scan_node, const Graph& body, const InlinedVector<NodeIndex>& body_nodes) {
+  // the body values map to the values of graph: the inputs to the scanned tensors, the outputs to the stacked ones,
+  // the outer scope values to the implicit inputs of the Scan node and the rest to new values
+  InlinedHashMap<std::string, NodeArg*> name_to_node_arg;
+  for (size_t i = 0; i < body.GetInputs().size(); ++i) {
+    name_to_node_arg.emplace(body.GetInputs()[i]->Name(), scan_node.MutableInputDefs()[i]);
+  }
+
+  for (size_t i = 0; i < body.GetOutputs().size(); ++i) {
+    name_to_node_arg.emplace(body.GetOutputs()[i]->Name(), scan_node.MutableOutputDefs()[i]);
+  }
+
+  for (auto* implicit_input : scan_node.MutableImplicitInputDefs()) {
+    name_to_node_arg.emplace(implicit_input->Name(), implicit_input);
+  }
+
+  const std::string prefix = scan_node.Name() + "_";
+  auto get_new_node_arg = [&](const NodeArg& body_arg) -> NodeArg* {
+    auto it = name_to_node_arg.find(body_arg.Name());
+    if (it != name_to_node_arg.end()) {
+      return it->second;
+    }
+
+    // the shape of the body value is the shape of a single iteration, let shape inferencing set the stacked one
+    TypeProto type = *body_arg.TypeAsProto();
+    type.mutable_tensor_type()->clear_shape();
+    NodeArg* node_arg = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(prefix + body_arg.Name()), &type);
+    name_to_node_arg.emplace(body_arg.Name(), node_arg);
+    return node_arg;
+  };
+
+  for (const auto& [name, tensor_proto] : body.GetAllInitializedTensors()) {
+    TensorProto initializer = *tensor_proto;
+    initializer.set_name(graph.GenerateNodeArgName(prefix + name));
+    graph.AddInitializedTensor(initializer);
+    const NodeArg* body_arg = body.GetNodeArg(name);
+    name_to_node_arg.emplace(name, &graph.GetOrCreateNodeArg(initializer.name(), body_arg->TypeAsProto()));
+  }
+
+  // producer of each value written by the new nodes, for the edges between them and to the Scan consumers
+  InlinedHashMap<const NodeArg*, std::pair<NodeIndex, int>> producers;
+  InlinedVector<NodeIndex> new_nodes;
+  for (const auto body_node_index : body_nodes) {
+    const Node& body_node = *body.GetNode(body_node_index);
+    InlinedVector<NodeArg*> input_defs;
+    for (const auto* input : body_node.InputDefs()) {
+      input_defs.push_back(input->Exists() ? get_new_node_arg(*input) : &graph.GetOrCreateNodeArg("", nullptr));
+    }
+
+    InlinedVector<NodeArg*> output_defs;
+    for (const auto* output : body_node.OutputDefs()) {
+      output_defs.push_back(output->Exists() ? get_new_node_arg(*output) : &graph.GetOrCreateNodeArg("", nullptr));
+    }
+
+    Node& new_node = graph.AddNode(graph.GenerateNodeName(prefix + body_node.Name()), body_node.OpType(),
+                                   body_node.Description(), input_defs, output_defs, &body_node.GetAttributes(),
+                                   body_node.Domain());
+    new_nodes.push_back(new_node.Index());
+
+    for (int i = 0; i < static_cast<int>(input_defs.size()); ++i) {
+      auto it = producers.find(input_defs[i]);
+      if (it != producers.end()) {
+        graph.AddEdge(it->second.first, new_node.Index(), it->second.second, i);
+      }
+    }
+
+    for (int i = 0; i < static_cast<int>(output_defs.size()); ++i) {
+      if (output_defs[i]->Exists()) {
+        producers[output_defs[i]] = {new_node.Index(), i};
+      }
+    }
+  }
+
+  // the body is owned by the Scan node so it can only be removed once the body nodes are copied
+  const auto input_edges = graph_utils::GraphEdge::GetNodeInputEdges(scan_node);
+  const auto output_edges = graph_utils::GraphEdge::GetNodeOutputEdges(scan_node);
+  graph_utils::RemoveNodeOutputEdges(graph, scan_node);
+  graph.RemoveNode(scan_node.Index());
+
+  // the scanned tensors and the outer scope values keep their producers
+  for (const auto& edge : input_edges) {
+    for (const auto new_node_index : new_nodes) {
+      const auto& input_defs = graph.GetNode(new_node_index)->InputDefs();
+      for (int i = 0; i < static_cast<int>(input_defs.size()); ++i) {
+        if (input_defs[i]->Name() == edge.arg_name) {
+          graph.AddEdge(edge.src_node, new_node_index, edge.src_arg_index, i);
+        }
+      }
+    }
+  }
+
+  for (const auto& edge : output_edges) {
+    const auto& producer = producers.at(graph.GetNodeArg(edge.arg_name));
+    graph.AddEdge(producer.first, edge.dst_node, producer.second, edge.dst_arg_index);
+  }
+}
+
+}  // namespace
+
+Status ScanElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr) {
+      continue;  // node was removed
+    }
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    // opset 8 Scan has a batch dimension and handles sequence lengths, later versions only scan
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Scan", {9, 11, 16, 19}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Graph* body = node.GetGraphAttribute("body");
+    InlinedVector<NodeIndex> body_nodes;
+    if (body == nullptr || !CanEliminateScan(node, *body, body_nodes)) {
+      continue;
+    }
+
+    LOGS(logger, VERBOSE) << "Replacing Scan node '" << node.Name() << "' with the " << body_nodes.size()
+                          << " nodes of its body";
+    EliminateScan(graph, node, *body, body_nodes);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ScanElimination
+
+Replace a Scan node whose iterations are independent of each other with the nodes of its body, run once on the whole
+scan inputs instead of once per slice.
+
+This applies when the Scan has no state variables, scans all its inputs and outputs along axis 0 in the forward
+direction, and its body only contains elementwise ops and MatMul. These ops compute the same values for each slice
+when given the inputs with the leading scan dimension, as long as the values that are shared by all the iterations
+broadcast against the slices without reaching the scan dimension.
+*/
+class ScanElimination : public GraphTransformer {
+ public:
+  ScanElimination(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ScanElimination", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
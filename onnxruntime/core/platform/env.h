@@ -84,6 +84,11 @@ struct ThreadOptions {
   // The process that owns the thread may consider setting its affinity.
   std::vector<LogicalProcessors> affinities;
 
+  // Relative compute capacity of the cores in `affinities`, in the same order: 1.0 for the fastest cores and less for
+  // slower ones, such as the efficiency cores of a hybrid CPU. The thread pool gives threads on slower cores smaller
+  // shares of a parallel loop. If the vector is empty, all the threads are assumed to be equally fast.
+  std::vector<double> capacities;
+
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
 
@@ -91,6 +96,10 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // If set, spinning threads of the pool block once they have spun for about twice the average time between the
+  // parallel sections of the pool, instead of after a fixed number of spins.
+  bool adaptive_spinning = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -141,6 +150,19 @@ class Env {
 
   virtual std::vector<LogicalProcessors> GetDefaultThreadAffinities() const = 0;
 
+  /// <summary>
+  /// The API returns the relative compute capacity of the cores returned by GetDefaultThreadAffinities(),
+  /// in the same order. The fastest cores have a capacity of 1.0.
+  /// </summary>
+  /// <returns>Capacity per core, or an empty vector if the cores are not known to differ</returns>
+  virtual std::vector<double> GetCoreCapacities() const { return {}; }
+
+  /// <summary>
+  /// The API returns the logical processors of each NUMA node that has processors.
+  /// </summary>
+  /// <returns>Logical processors per NUMA node, or an empty vector if the topology is unknown</returns>
+  virtual std::vector<LogicalProcessors> GetNumaNodes() const = 0;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -186,6 +208,26 @@ class Env {
   virtual common::Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                            MappedMemoryPtr& mapped_memory) const = 0;
 
+  /**
+   * Releases the physical pages backing a range of memory returned by MapFileIntoMemory().
+   * The range stays valid; the pages are read back from the file when next accessed, so the memory
+   * must not have been modified.
+   * The default implementation returns NOT_IMPLEMENTED.
+   */
+  virtual common::Status DiscardMappedMemoryPages(gsl::span<char> mapped_memory) const {
+    ORT_UNUSED_PARAMETER(mapped_memory);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "DiscardMappedMemoryPages is not implemented on this platform.");
+  }
+
+  /**
+   * Hints that a range of memory returned by MapFileIntoMemory() will be accessed soon, so its pages can be
+   * read from the file ahead of the access. The default implementation does nothing.
+   */
+  virtual common::Status PrefetchMappedMemoryPages(gsl::span<char> mapped_memory) const {
+    ORT_UNUSED_PARAMETER(mapped_memory);
+    return common::Status::OK();
+  }
+
 #ifdef _WIN32
   /// \brief Returns true if the directory exists.
   virtual bool FolderExists(const std::wstring& path) const = 0;
@@ -16,7 +16,9 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <fstream>
 #include <optional>
 #include <string>
@@ -304,6 +306,49 @@ std::vector<LogicalProcessors> WindowsEnv::GetDefaultThreadAffinities() const {
   return cores_.empty() ? std::vector<LogicalProcessors>(DefaultNumCores(), LogicalProcessors{}) : cores_;
 }
 
+std::vector<double> WindowsEnv::GetCoreCapacities() const {
+  if (cores_.empty() || core_efficiency_classes_.size() != cores_.size()) {
+    return {};
+  }
+
+  // Higher efficiency classes are faster cores, all cores have class 0 on CPUs with a single core type.
+  const BYTE max_class = *std::max_element(core_efficiency_classes_.begin(), core_efficiency_classes_.end());
+  if (max_class == 0) {
+    return {};
+  }
+
+  std::vector<double> capacities;
+  capacities.reserve(core_efficiency_classes_.size());
+  for (BYTE efficiency_class : core_efficiency_classes_) {
+    capacities.push_back(static_cast<double>(efficiency_class + 1) / (max_class + 1));
+  }
+  return capacities;
+}
+
+std::vector<LogicalProcessors> WindowsEnv::GetNumaNodes() const {
+  std::map<USHORT, LogicalProcessors> node_processors;
+  for (const auto& core : cores_) {
+    for (int global_processor_id : core) {
+      const auto processor_info = GetProcessorAffinityMask(global_processor_id);
+      PROCESSOR_NUMBER processor_number = {};
+      processor_number.Group = static_cast<WORD>(processor_info.group_id);
+      processor_number.Number = static_cast<BYTE>(processor_info.local_processor_id);
+      USHORT node_number = 0;
+      if (!GetNumaProcessorNodeEx(&processor_number, &node_number) || node_number == 0xFFFF) {
+        return {};
+      }
+      node_processors[node_number].push_back(global_processor_id);
+    }
+  }
+
+  std::vector<LogicalProcessors> ret;
+  ret.reserve(node_processors.size());
+  for (auto& entry : node_processors) {
+    ret.push_back(std::move(entry.second));
+  }
+  return ret;
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
@@ -921,6 +966,7 @@ void WindowsEnv::InitializeCpuInfo() {
         }
       }
       cores_.push_back(std::move(core_global_proc_ids));
+      core_efficiency_classes_.push_back(processor_info->Processor.EfficiencyClass);
       core_id++;
     }
     iter += size;
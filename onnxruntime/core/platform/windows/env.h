@@ -55,6 +55,8 @@ class WindowsEnv : public Env {
   static int DefaultNumCores();
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
+  std::vector<double> GetCoreCapacities() const override;
+  std::vector<LogicalProcessors> GetNumaNodes() const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
   Status GetFileLength(_In_z_ const ORTCHAR_T* file_path, size_t& length) const override;
@@ -113,6 +115,11 @@ class WindowsEnv : public Env {
    * }
    */
   std::vector<LogicalProcessors> cores_;
+  /*
+   * "core_efficiency_classes_" holds the efficiency class of each core in "cores_",
+   * higher classes are faster cores. All cores are in class 0 on CPUs with a single core type.
+   */
+  std::vector<BYTE> core_efficiency_classes_;
   /*
    * "global_processor_info_map_" is a map of:
    * global_processor_id <--> (group_id, local_processor_id)
@@ -2,8 +2,15 @@
 // Licensed under the MIT License.
 
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/providers/common.h"
@@ -388,6 +395,50 @@ void CreateEmptyFile(const std::string& filename) {
 
 #endif  // defined(COREML_ENABLE_MLPROGRAM)
 
+// Returns a key for the compiled model cache from the serialized CoreML model and the ML Program weights file.
+// The flags are part of the key as they may change how the same model is compiled and loaded.
+Status GetModelCacheKey(const CoreML::Specification::Model& coreml_model, const std::string& weights_file_path,
+                        uint32_t coreml_flags, std::string& key) {
+  std::string serialized_model;
+  {
+    // map fields are serialized in a deterministic order so the same model always has the same key
+    google::protobuf::io::StringOutputStream string_stream(&serialized_model);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    ORT_RETURN_IF_NOT(coreml_model.SerializeToCodedStream(&coded_stream), "Serializing the CoreML model failed.");
+  }
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  auto hash_bytes = [&hash](const void* data, size_t size) {
+    MurmurHash3::x86_128(data, narrow<int32_t>(size), hash[0], &hash);
+  };
+
+  hash_bytes(serialized_model.data(), serialized_model.size());
+  hash_bytes(&coreml_flags, sizeof(coreml_flags));
+
+  if (!weights_file_path.empty()) {
+    std::ifstream weights(weights_file_path, std::ifstream::in | std::ifstream::binary);
+    ORT_RETURN_IF_NOT(weights.is_open(), "Failed to open weights file ", weights_file_path);
+
+    std::vector<char> buffer(1 << 20);
+    while (weights) {
+      weights.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      if (const auto num_read = weights.gcount(); num_read > 0) {
+        hash_bytes(buffer.data(), static_cast<size_t>(num_read));
+      }
+    }
+  }
+
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (uint32_t part : hash) {
+    ss << std::setw(8) << part;
+  }
+
+  key = ss.str();
+  return Status::OK();
+}
+
 std::string GetModelOutputPath(bool create_ml_program) {
   // path is used to create the ML Package directory for ML Program, and for the model directly otherwise.
   auto path = util::GetTemporaryFilePath();
@@ -400,7 +451,7 @@ std::string GetModelOutputPath(bool create_ml_program) {
 }  // namespace
 
 ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                           int32_t coreml_version, uint32_t coreml_flags,
+                           int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                            std::vector<std::string>&& onnx_input_names,
                            std::vector<std::string>&& onnx_output_names)
     : graph_viewer_(graph_viewer),
@@ -409,6 +460,7 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
       coreml_flags_(coreml_flags),
       create_ml_program_((coreml_flags_ & COREML_FLAG_CREATE_MLPROGRAM) != 0),
       model_output_path_(GetModelOutputPath(create_ml_program_)),
+      model_cache_dir_(model_cache_dir),
       onnx_input_names_(std::move(onnx_input_names)),
       onnx_output_names_(std::move(onnx_output_names)),
       coreml_model_(std::make_unique<CoreML::Specification::Model>()) {
@@ -436,7 +488,8 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
     std::string weights_id = mlpackage_->addItem(tmp_dir, "weights", "com.microsoft.OnnxRuntime",
                                                  "CoreML Model Weights");
     auto weights_info = mlpackage_->findItem(weights_id);
-    weights_file_writer_ = std::make_unique<StorageWriter>(weights_info->path() + "/weight.bin");
+    weights_file_path_ = weights_info->path() + "/weight.bin";
+    weights_file_writer_ = std::make_unique<StorageWriter>(weights_file_path_);
 #else
     // should never happen due to handling in coreml_execution_provider.cc
     // throw here so all other code in this class can assume create_ml_program_ is only ever true in a build
@@ -936,6 +989,13 @@ Status ModelBuilder::SaveModel() {
   weights_file_writer_.reset();
 #endif
 
+  if (!model_cache_dir_.empty()) {
+    // the weights file is flushed above, so the key covers the complete model
+    std::string key;
+    ORT_RETURN_IF_ERROR(GetModelCacheKey(*coreml_model_, weights_file_path_, coreml_flags_, key));
+    compiled_model_cache_path_ = model_cache_dir_ + "/" + key + ".mlmodelc";
+  }
+
   return Status::OK();
 }
 
@@ -973,7 +1033,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
                                     get_sanitized_io_info(std::move(input_output_info_)),
                                     std::move(scalar_outputs_),
                                     std::move(int64_outputs_),
-                                    logger_, coreml_flags_);
+                                    logger_, coreml_flags_, compiled_model_cache_path_);
   } else
 #endif
   {
@@ -983,7 +1043,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
                                     std::move(input_output_info_),
                                     std::move(scalar_outputs_),
                                     std::move(int64_outputs_),
-                                    logger_, coreml_flags_);
+                                    logger_, coreml_flags_, compiled_model_cache_path_);
   }
 
   return model->LoadModel();  // load using CoreML API, including compilation
@@ -991,11 +1051,11 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
 
 // static
 Status ModelBuilder::Build(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                           int32_t coreml_version, uint32_t coreml_flags,
+                           int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                            std::vector<std::string>&& onnx_input_names,
                            std::vector<std::string>&& onnx_output_names,
                            std::unique_ptr<Model>& model) {
-  ModelBuilder builder(graph_viewer, logger, coreml_version, coreml_flags,
+  ModelBuilder builder(graph_viewer, logger, coreml_version, coreml_flags, model_cache_dir,
                        std::move(onnx_input_names), std::move(onnx_output_names));
 
   ORT_RETURN_IF_ERROR(builder.CreateModel());
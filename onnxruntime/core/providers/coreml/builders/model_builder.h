@@ -29,14 +29,16 @@ class IOpBuilder;
 class ModelBuilder {
  private:
   ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
-               int32_t coreml_version, uint32_t coreml_flags,
+               int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                std::vector<std::string>&& onnx_input_names,
                std::vector<std::string>&& onnx_output_names);
 
  public:
-  // Create the CoreML model, serialize to disk, load and compile using the CoreML API and return in `model`
+  // Create the CoreML model, serialize to disk, load and compile using the CoreML API and return in `model`.
+  // If model_cache_dir is not empty, the compiled model is stored in it, keyed by a hash of the serialized model, and
+  // the compilation is skipped when a matching compiled model is already there.
   static Status Build(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                      int32_t coreml_version, uint32_t coreml_flags,
+                      int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                       std::vector<std::string>&& onnx_input_names,
                       std::vector<std::string>&& onnx_output_names,
                       std::unique_ptr<Model>& model);
@@ -196,6 +198,9 @@ class ModelBuilder {
   const uint32_t coreml_flags_;
   const bool create_ml_program_;         // ML Program (CoreML5, iOS 15+, macOS 12+) or NeuralNetwork (old)
   const std::string model_output_path_;  // create_ml_program_ ? dir for mlpackage : filename for mlmodel
+  const std::string model_cache_dir_;    // directory of the compiled model cache. empty if caching is disabled
+  std::string compiled_model_cache_path_;  // path of the compiled model in the cache. set in SaveModel
+  std::string weights_file_path_;          // path of the ML Program weights file
 
   std::vector<std::string> onnx_input_names_;
   std::vector<std::string> onnx_output_names_;
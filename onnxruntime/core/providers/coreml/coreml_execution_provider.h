@@ -14,7 +14,8 @@ class Model;
 
 class CoreMLExecutionProvider : public IExecutionProvider {
  public:
-  CoreMLExecutionProvider(uint32_t coreml_flags);
+  // If model_cache_dir is not empty, compiled CoreML models are cached in it and reused by later sessions.
+  CoreMLExecutionProvider(uint32_t coreml_flags, std::string model_cache_dir = {});
   virtual ~CoreMLExecutionProvider();
 
   std::vector<std::unique_ptr<ComputeCapability>>
@@ -31,6 +32,7 @@ class CoreMLExecutionProvider : public IExecutionProvider {
   // COREMLFlags in include/onnxruntime/core/providers/coreml/coreml_provider_factory.h
   uint32_t coreml_flags_;
   const int32_t coreml_version_;
+  const std::string model_cache_dir_;
   ModelMetadefIdGenerator metadef_id_generator_;
 
   // map of fused_node_name to compiled_coreml_model
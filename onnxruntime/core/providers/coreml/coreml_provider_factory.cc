@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/coreml/coreml_provider_factory.h"
+#include "core/common/parse_string.h"
 #include "core/session/abi_session_options_impl.h"
 #include "coreml_execution_provider.h"
 #include "coreml_provider_factory_creator.h"
@@ -10,20 +11,38 @@ using namespace onnxruntime;
 
 namespace onnxruntime {
 struct CoreMLProviderFactory : IExecutionProviderFactory {
-  CoreMLProviderFactory(uint32_t coreml_flags)
-      : coreml_flags_(coreml_flags) {}
+  CoreMLProviderFactory(uint32_t coreml_flags, std::string model_cache_dir)
+      : coreml_flags_(coreml_flags), model_cache_dir_(std::move(model_cache_dir)) {}
   ~CoreMLProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
   uint32_t coreml_flags_;
+  std::string model_cache_dir_;
 };
 
 std::unique_ptr<IExecutionProvider> CoreMLProviderFactory::CreateProvider() {
-  return std::make_unique<CoreMLExecutionProvider>(coreml_flags_);
+  return std::make_unique<CoreMLExecutionProvider>(coreml_flags_, model_cache_dir_);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CoreMLProviderFactoryCreator::Create(uint32_t coreml_flags) {
-  return std::make_shared<onnxruntime::CoreMLProviderFactory>(coreml_flags);
+  return std::make_shared<onnxruntime::CoreMLProviderFactory>(coreml_flags, std::string{});
+}
+
+std::shared_ptr<IExecutionProviderFactory> CoreMLProviderFactoryCreator::Create(
+    const ProviderOptions& provider_options) {
+  uint32_t coreml_flags = 0;
+  std::string model_cache_dir;
+
+  if (auto it = provider_options.find("coreml_flags"); it != provider_options.end()) {
+    ORT_ENFORCE(TryParseStringWithClassicLocale(it->second, coreml_flags),
+                "Invalid coreml_flags value: ", it->second);
+  }
+
+  if (auto it = provider_options.find("model_cache_dir"); it != provider_options.end()) {
+    model_cache_dir = it->second;
+  }
+
+  return std::make_shared<onnxruntime::CoreMLProviderFactory>(coreml_flags, std::move(model_cache_dir));
 }
 }  // namespace onnxruntime
 
@@ -40,11 +40,14 @@ class Model {
         std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
         std::unordered_set<std::string>&& scalar_outputs,
         std::unordered_set<std::string>&& int64_outputs,
-        const logging::Logger& logger, uint32_t coreml_flags);
+        const logging::Logger& logger, uint32_t coreml_flags,
+        const std::string& compiled_model_cache_path);
 
   ~Model();
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Model);
 
+  // Compiles and loads the model. If compiled_model_cache_path is not empty, the compiled model is loaded from that
+  // path if it exists, and is otherwise moved there after compiling so later sessions can skip the compilation.
   Status LoadModel();
 
   Status Predict(const std::unordered_map<std::string, OnnxTensorData>& inputs,
@@ -240,19 +240,23 @@ NS_ASSUME_NONNULL_BEGIN
 // Execution for a CoreML model, it performs
 // 1. Compile the model by given path for execution
 // 2. Predict using given OnnxTensorFeatureProvider input and copy the output data back ORT
-// 3. The compiled model will be removed in dealloc or removed using cleanup function
+// 3. The compiled model will be removed in dealloc or removed using cleanup function, unless it was moved to the
+//    compiled model cache
 @interface CoreMLExecution : NSObject {
   NSString* coreml_model_path_;
   NSString* compiled_model_path_;
+  NSString* _Nullable compiled_model_cache_path_;
   const logging::Logger* logger_;
   uint32_t coreml_flags_;
 }
 
 - (instancetype)initWithPath:(const std::string&)path
                       logger:(const logging::Logger&)logger
-                coreml_flags:(uint32_t)coreml_flags;
+                coreml_flags:(uint32_t)coreml_flags
+    compiledModelCachePath:(const std::string&)compiled_model_cache_path;
 - (void)cleanup;
 - (void)dealloc;
+- (nullable NSURL*)compileModel:(NSURL*)modelUrl error:(NSError**)error API_AVAILABLE_COREML3;
 - (Status)loadModel API_AVAILABLE_COREML3;
 - (Status)predict:(const std::unordered_map<std::string, OnnxTensorData>&)inputs
                   outputs:(const std::unordered_map<std::string, OnnxTensorInfo>&)outputs
@@ -268,9 +272,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)initWithPath:(const std::string&)path
                       logger:(const logging::Logger&)logger
-                coreml_flags:(uint32_t)coreml_flags {
+                coreml_flags:(uint32_t)coreml_flags
+    compiledModelCachePath:(const std::string&)compiled_model_cache_path {
   if (self = [super init]) {
     coreml_model_path_ = [NSString stringWithUTF8String:path.c_str()];
+    compiled_model_cache_path_ = compiled_model_cache_path.empty()
+                                     ? nil
+                                     : [NSString stringWithUTF8String:compiled_model_cache_path.c_str()];
     logger_ = &logger;
     coreml_flags_ = coreml_flags;
   }
@@ -311,30 +319,95 @@ NS_ASSUME_NONNULL_BEGIN
   [self cleanup];
 }
 
+// Compiles the model, and moves the compiled model to the cache if caching is enabled.
+// Returns the URL of the compiled model, or nil on failure.
+- (nullable NSURL*)compileModel:(NSURL*)modelUrl error:(NSError**)error {
+  // TODO: Update this to version with callback handler as the API used here is deprecated.
+  // https://developer.apple.com/documentation/coreml/mlmodel/3929553-compilemodelaturl
+  // As we call loadModel during EP Compile there shouldn't be an issue letting the actual compile run in the
+  // background. We will have to check for completion in `predict` and block until it is done.
+  NSURL* compileUrl = [MLModel compileModelAtURL:modelUrl error:error];
+  if (*error != nil) {
+    return nil;
+  }
+
+  compiled_model_path_ = [compileUrl path];
+
+  if (compiled_model_cache_path_ == nil) {
+    return compileUrl;
+  }
+
+  // The compiled model is moved to a unique path in the cache directory first and then renamed, so another session
+  // never sees a partially written entry. A failure to cache is not an error as the compiled model can still be used.
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+  NSURL* cacheUrl = [NSURL fileURLWithPath:compiled_model_cache_path_];
+  NSURL* stagingUrl = [NSURL fileURLWithPath:[compiled_model_cache_path_
+                                                 stringByAppendingFormat:@".%@.tmp",
+                                                                         [[NSUUID UUID] UUIDString]]];
+  NSError* cache_error = nil;
+  if ([file_manager createDirectoryAtURL:[cacheUrl URLByDeletingLastPathComponent]
+             withIntermediateDirectories:YES
+                              attributes:nil
+                                   error:&cache_error] &&
+      [file_manager moveItemAtURL:compileUrl toURL:stagingUrl error:&cache_error]) {
+    if ([file_manager moveItemAtURL:stagingUrl toURL:cacheUrl error:&cache_error]) {
+      compiled_model_path_ = nil;
+      return cacheUrl;
+    }
+
+    if ([file_manager fileExistsAtPath:compiled_model_cache_path_]) {
+      // another session cached the same model in the meantime
+      [file_manager removeItemAtURL:stagingUrl error:nil];
+      compiled_model_path_ = nil;
+      return cacheUrl;
+    }
+
+    // cleanup removes the staged copy
+    compiled_model_path_ = [stagingUrl path];
+    compileUrl = stagingUrl;
+  }
+
+  LOGS(*logger_, WARNING) << "Failed to add the compiled model to the cache: " << [compiled_model_cache_path_ UTF8String]
+                          << ", error message: " << [[cache_error localizedDescription] UTF8String];
+  return compileUrl;
+}
+
 - (Status)loadModel {
   NSURL* modelUrl = [NSURL URLWithString:coreml_model_path_];
   if (modelUrl == nil) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create model URL from path");
   }
 
-  // TODO: Update this to version with callback handler as the API used here is deprecated.
-  // https://developer.apple.com/documentation/coreml/mlmodel/3929553-compilemodelaturl
-  // As we call loadModel during EP Compile there shouldn't be an issue letting the actual compile run in the
-  // background. We will have to check for completion in `predict` and block until it is done.
+  MLModelConfiguration* config = [MLModelConfiguration alloc];
+  config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
+                            ? MLComputeUnitsCPUOnly
+                            : MLComputeUnitsAll;
+
   NSError* error = nil;
-  NSURL* compileUrl = [MLModel compileModelAtURL:modelUrl error:&error];
 
+  if (compiled_model_cache_path_ != nil &&
+      [[NSFileManager defaultManager] fileExistsAtPath:compiled_model_cache_path_]) {
+    NSURL* cacheUrl = [NSURL fileURLWithPath:compiled_model_cache_path_];
+    _model = [MLModel modelWithContentsOfURL:cacheUrl configuration:config error:&error];
+    if (error == nil && _model != nil) {
+      LOGS(*logger_, INFO) << "Loaded compiled CoreML model from cache: " << [compiled_model_cache_path_ UTF8String];
+      return Status::OK();
+    }
+
+    // the entry is unusable, e.g. it was compiled by an incompatible OS version. replace it.
+    LOGS(*logger_, WARNING) << "Failed to load compiled model from cache: " << [compiled_model_cache_path_ UTF8String]
+                            << ". Recompiling the model.";
+    [[NSFileManager defaultManager] removeItemAtURL:cacheUrl error:nil];
+    _model = nil;
+    error = nil;
+  }
+
+  NSURL* compileUrl = [self compileModel:modelUrl error:&error];
   if (error != nil) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error compiling model: ",
                            [[error localizedDescription] UTF8String]);
   }
 
-  compiled_model_path_ = [compileUrl path];
-
-  MLModelConfiguration* config = [MLModelConfiguration alloc];
-  config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
-                            ? MLComputeUnitsCPUOnly
-                            : MLComputeUnitsAll;
   _model = [MLModel modelWithContentsOfURL:compileUrl configuration:config error:&error];
 
   if (error != nil || _model == nil) {
@@ -441,7 +514,8 @@ namespace coreml {
 // This class will bridge Model (c++) with CoreMLExecution (objective c++)
 class Execution {
  public:
-  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags);
+  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags,
+            const std::string& compiled_model_cache_path);
   ~Execution(){};
 
   Status LoadModel();
@@ -454,11 +528,13 @@ class Execution {
   CoreMLExecution* execution_;
 };
 
-Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags) {
+Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags,
+                     const std::string& compiled_model_cache_path) {
   @autoreleasepool {
     execution_ = [[CoreMLExecution alloc] initWithPath:path
                                                 logger:logger
-                                          coreml_flags:coreml_flags];
+                                          coreml_flags:coreml_flags
+                                compiledModelCachePath:compiled_model_cache_path];
   }
 }
 
@@ -502,8 +578,9 @@ Model::Model(const std::string& path,
              std::unordered_set<std::string>&& scalar_outputs,
              std::unordered_set<std::string>&& int64_outputs,
              const logging::Logger& logger,
-             uint32_t coreml_flags)
-    : execution_(std::make_unique<Execution>(path, logger, coreml_flags)),
+             uint32_t coreml_flags,
+             const std::string& compiled_model_cache_path)
+    : execution_(std::make_unique<Execution>(path, logger, coreml_flags, compiled_model_cache_path)),
       model_input_names_(std::move(model_input_names)),
       model_output_names_(std::move(model_output_names)),
       input_output_info_(std::move(input_output_info)),
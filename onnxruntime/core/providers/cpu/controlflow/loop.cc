@@ -12,6 +12,8 @@
 #include "core/providers/cpu/controlflow/loop.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
+#include <algorithm>
+
 #include "core/framework/allocator.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -198,11 +200,34 @@ class LoopImpl {
   Status Execute(const FeedsFetchesManager& cached_ffm);
 
  private:
+  // Buffer the values of a Loop scan output are written to as the iterations run, so the per-iteration values
+  // don't have to be kept and concatenated at the end. It is allocated by the first iteration, and grows by doubling
+  // as the number of iterations is not known up front.
+  struct ScanOutput {
+    OrtValue buffer;
+    MLDataType element_type = nullptr;
+    AllocatorPtr allocator;
+    TensorShape per_iteration_shape;
+    size_t bytes_per_iteration = 0;
+    int64_t capacity = 0;  // number of iterations the buffer can hold
+    // whether the subgraph can allocate its output directly in the buffer
+    bool write_in_place = false;
+  };
+
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
-  void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  void UpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+
+  // make sure the buffer of the scan output can hold the value of the given iteration
+  Status ReserveScanOutput(ScanOutput& scan_output, int64_t iteration);
+
+  // OrtValue for the slice of the scan output buffer of the given iteration
+  OrtValue GetScanOutputSlice(const ScanOutput& scan_output, int64_t iteration) const;
 
-  // create the single Loop output from a collection of per-iteration outputs
-  Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
+  // copy the value of the scan output from the given iteration to the buffer, unless the subgraph wrote it there
+  Status SaveScanOutput(ScanOutput& scan_output, const OrtValue& value, int64_t iteration);
+
+  // create the single Loop output from the buffer of the scan output
+  Status CreateLoopOutput(const ScanOutput& scan_output, int output_index, int64_t num_iterations);
 
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
@@ -216,13 +241,21 @@ class LoopImpl {
   OrtValue iter_num_mlvalue_;
   OrtValue condition_mlvalue_;
 
-  // collection of OrtValue outputs from each loop iteration for the loop outputs.
-  // the order from the subgraph matches the order from the loop output
-  std::vector<std::vector<OrtValue>> loop_output_tensors_;
+  // buffers for the loop outputs. the order from the subgraph matches the order from the loop output
+  std::vector<ScanOutput> scan_outputs_;
 
   const Loop::ConcatOutput& concat_output_func_;
 };
 
+static TensorShape PrependDim(int64_t dim, const TensorShape& shape) {
+  TensorShapeVector dims;
+  dims.reserve(shape.NumDimensions() + 1);
+  dims.push_back(dim);
+  const auto shape_dims = shape.GetDims();
+  dims.insert(dims.end(), shape_dims.begin(), shape_dims.end());
+  return TensorShape(dims);
+}
+
 static Status ConcatenateCpuOutput(void* /*stream*/,
                                    std::vector<OrtValue>& per_iteration_output,
                                    void* output, size_t output_size_in_bytes) {
@@ -420,7 +453,16 @@ Status LoopImpl::Initialize() {
   iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(cpu_allocator, 0, iter_num_rank != 0);
   condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank != 0);
 
-  loop_output_tensors_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+  scan_outputs_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+
+  // a subgraph output that is also used for another output is not written in place, as the other output would refer
+  // to the buffer, which may be reallocated when it grows
+  const auto& subgraph_output_names = info_.subgraph_output_names;
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& name = subgraph_output_names[static_cast<size_t>(i) + 1];  // skip cond
+    scan_outputs_[static_cast<size_t>(i) - info_.num_loop_carried_vars].write_in_place =
+        std::count(subgraph_output_names.begin(), subgraph_output_names.end(), name) == 1;
+  }
 
   return status;
 }
@@ -443,8 +485,7 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
-void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
-                                         std::vector<OrtValue>& next_inputs) {
+void LoopImpl::UpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
@@ -452,30 +493,90 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   for (ptrdiff_t i = 1; i < info_.num_subgraph_inputs; ++i) {
     next_inputs[i] = last_outputs[i - 1];
   }
+}
+
+Status LoopImpl::ReserveScanOutput(ScanOutput& scan_output, int64_t iteration) {
+  if (iteration < scan_output.capacity) {
+    return Status::OK();
+  }
 
-  // save loop outputs as we have to concatenate at the end
-  for (ptrdiff_t j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+  constexpr int64_t kMinCapacity = 16;
+  const int64_t capacity = std::min(std::max({scan_output.capacity * 2, kMinCapacity, iteration + 1}),
+                                    max_trip_count_);
+
+  OrtValue buffer;
+  Tensor::InitOrtValue(scan_output.element_type, PrependDim(capacity, scan_output.per_iteration_shape),
+                       scan_output.allocator, buffer);
+
+  // move the values of the previous iterations to the new buffer
+  if (iteration > 0 && scan_output.bytes_per_iteration > 0) {
+    std::vector<OrtValue> previous_iterations{scan_output.buffer};
+    Stream* ort_stream = context_.GetComputeStream();
+    ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, previous_iterations,
+                                            buffer.GetMutable<Tensor>()->MutableDataRaw(),
+                                            scan_output.buffer.Get<Tensor>().SizeInBytes()));
   }
+
+  scan_output.buffer = std::move(buffer);
+  scan_output.capacity = capacity;
+  return Status::OK();
 }
 
-Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
-  const auto& first_output = per_iteration_output.front().Get<Tensor>();
-  const auto& per_iteration_dims = first_output.Shape().GetDims();
+OrtValue LoopImpl::GetScanOutputSlice(const ScanOutput& scan_output, int64_t iteration) const {
+  auto& buffer = const_cast<Tensor&>(scan_output.buffer.Get<Tensor>());
+  OrtValue slice;
+  Tensor::InitOrtValue(scan_output.element_type, scan_output.per_iteration_shape,
+                       static_cast<gsl::byte*>(buffer.MutableDataRaw()) +
+                           static_cast<size_t>(iteration) * scan_output.bytes_per_iteration,
+                       buffer.Location(), slice);
+  return slice;
+}
 
-  std::vector<int64_t> dims;
-  dims.reserve(1 + per_iteration_output.size());
+Status LoopImpl::SaveScanOutput(ScanOutput& scan_output, const OrtValue& value, int64_t iteration) {
+  ORT_RETURN_IF_NOT(value.IsTensor(), "All scan outputs MUST be tensors");
+  const auto& tensor = value.Get<Tensor>();
+
+  if (iteration == 0) {
+    // the first iteration decides the type, shape and device of the scan output
+    scan_output.element_type = tensor.DataType();
+    scan_output.allocator = session_state_.GetAllocator(tensor.Location().device);
+    ORT_RETURN_IF_NOT(scan_output.allocator, "Failed to get allocator for loop output on ", tensor.Location().device);
+    scan_output.per_iteration_shape = tensor.Shape();
+    scan_output.bytes_per_iteration = tensor.SizeInBytes();
+  } else if (tensor.Shape() != scan_output.per_iteration_shape) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                           " Expected:", scan_output.per_iteration_shape, " Got:", tensor.Shape());
+  }
 
-  // first dimension is number of iterations
-  dims.push_back(gsl::narrow_cast<int64_t>(per_iteration_output.size()));
-  std::copy(per_iteration_dims.begin(), per_iteration_dims.end(), std::back_inserter(dims));
+  ORT_RETURN_IF_ERROR(ReserveScanOutput(scan_output, iteration));
 
-  TensorShape output_shape{dims};
+  OrtValue slice = GetScanOutputSlice(scan_output, iteration);
+  if (tensor.DataRaw() != slice.Get<Tensor>().DataRaw() && scan_output.bytes_per_iteration > 0) {
+    std::vector<OrtValue> iteration_output{value};
+    Stream* ort_stream = context_.GetComputeStream();
+    ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, iteration_output,
+                                            slice.GetMutable<Tensor>()->MutableDataRaw(),
+                                            scan_output.bytes_per_iteration));
+  }
+
+  return Status::OK();
+}
+
+Status LoopImpl::CreateLoopOutput(const ScanOutput& scan_output, int output_index, int64_t num_iterations) {
+  // first dimension is number of iterations
+  const TensorShape output_shape = PrependDim(num_iterations, scan_output.per_iteration_shape);
   Tensor* output = context_.Output(output_index, output_shape);
 
-  Stream* ort_stream = context_.GetComputeStream();
-  ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, per_iteration_output, output->MutableDataRaw(), output->SizeInBytes()));
+  if (output->SizeInBytes() > 0) {
+    auto& buffer = const_cast<Tensor&>(scan_output.buffer.Get<Tensor>());
+    OrtValue iterations;
+    Tensor::InitOrtValue(scan_output.element_type, output_shape, buffer.MutableDataRaw(), buffer.Location(),
+                         iterations);
+    std::vector<OrtValue> all_iterations{iterations};
+    Stream* ort_stream = context_.GetComputeStream();
+    ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, all_iterations,
+                                            output->MutableDataRaw(), output->SizeInBytes()));
+  }
 
   return Status::OK();
 }
@@ -485,18 +586,47 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
+    // stop between iterations, also when the body has no nodes at which the executor would check the flag
+    ORT_RETURN_IF(context_.GetTerminateFlag(), "Exiting due to terminate flag being set to true.");
+
     if (iter_num_value != 0) {
-      SaveOutputsAndUpdateFeeds(fetches, feeds);
+      UpdateFeeds(fetches, feeds);
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    if (iter_num_value == 1) {
+      // the first iteration allocated the scan output buffers. from now on, the subgraph writes the scan outputs
+      // directly to the slice of the current iteration if they have the expected shape and device.
+      for (size_t j = 0; j < scan_outputs_.size(); ++j) {
+        auto& scan_output = scan_outputs_[j];
+        if (!scan_output.write_in_place) {
+          continue;
+        }
+
+        fetch_allocators[j + info_.num_loop_carried_vars + 1] =  // skip cond
+            [this, &scan_output, &iter_num_value](const TensorShape& shape, const OrtDevice& location,
+                                                  OrtValue& ort_value, bool& allocated) {
+              if (shape != scan_output.per_iteration_shape ||
+                  location != scan_output.allocator->Info().device) {
+                return Status::OK();
+              }
+
+              ORT_RETURN_IF_ERROR(ReserveScanOutput(scan_output, iter_num_value));
+              ort_value = GetScanOutputSlice(scan_output, iter_num_value);
+              allocated = true;
+              return Status::OK();
+            };
+      }
+    }
+
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
                                     context_.GetComputeStream(),
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
@@ -506,6 +636,11 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
     condition_mlvalue_ = fetches[0];
 
+    for (size_t j = 0; j < scan_outputs_.size(); ++j) {
+      ORT_RETURN_IF_ERROR(SaveScanOutput(scan_outputs_[j], fetches[j + info_.num_loop_carried_vars + 1],  // skip cond
+                                         iter_num_value));
+    }
+
     ++iter_num_value;
   }
 
@@ -582,11 +717,8 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     }
 
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
-      // add last output
-      auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
-      per_iteration_outputs.push_back(fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
-
-      ORT_RETURN_IF_ERROR(ConcatenateLoopOutput(per_iteration_outputs, i));
+      const auto& scan_output = scan_outputs_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
+      ORT_RETURN_IF_ERROR(CreateLoopOutput(scan_output, i, iter_num_value));
     }
   } else {
     // no iterations.
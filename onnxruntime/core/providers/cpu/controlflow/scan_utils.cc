@@ -210,6 +210,8 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
 
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
+    ORT_RETURN_IF(context.GetTerminateFlag(), "Exiting due to terminate flag being set to true.");
+
     for (int input = 0; input < num_variadic_inputs; ++input) {
       if (input < num_loop_state_variables) {
         // add loop state variable input
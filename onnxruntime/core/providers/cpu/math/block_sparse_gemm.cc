@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/block_sparse_gemm.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace onnxruntime {
+
+namespace {
+
+// Columns of a block, and rows of A multiplied with each block
+constexpr size_t kBlockColumns = 4;
+constexpr size_t kBlockRows = 4;
+
+// The packed buffer is the header followed by the arrays, each 16 byte aligned:
+//   uint64_t panel_start[panel_count + 1]   first block of each panel of 4 columns
+//   float values[block_count * 4]           the blocks, by panel and by row of K within a panel
+//   uint32_t block_k[block_count]           the row of K of each block
+struct BlockSparseHeader {
+  uint64_t K;
+  uint64_t N;
+  uint64_t panel_count;
+  uint64_t block_count;
+};
+
+struct BlockSparseLayout {
+  size_t panel_start_offset;
+  size_t values_offset;
+  size_t block_k_offset;
+  size_t size;
+
+  BlockSparseLayout(size_t panel_count, size_t block_count) {
+    auto align = [](size_t offset) { return (offset + 15) & ~size_t{15}; };
+    panel_start_offset = align(sizeof(BlockSparseHeader));
+    values_offset = align(panel_start_offset + (panel_count + 1) * sizeof(uint64_t));
+    block_k_offset = align(values_offset + block_count * kBlockColumns * sizeof(float));
+    size = align(block_k_offset + block_count * sizeof(uint32_t));
+  }
+};
+
+}  // namespace
+
+bool GemmPackBBlockSparse(AllocatorPtr& alloc,
+                          const Tensor& tensor_b,
+                          bool trans_b,
+                          IAllocatorUniquePtr<void>& packed_b,
+                          size_t& packed_b_size,
+                          TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(tensor_b.Shape()[1]) : static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = trans_b ? static_cast<size_t>(tensor_b.Shape()[0]) : static_cast<size_t>(tensor_b.Shape()[1]);
+  if (K == 0 || N == 0 || K > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  const float* b_data = tensor_b.Data<float>();
+  auto b_at = [b_data, trans_b, K, N](size_t k, size_t n) { return trans_b ? b_data[n * K + k] : b_data[k * N + n]; };
+
+  const size_t panel_count = (N + kBlockColumns - 1) / kBlockColumns;
+  auto is_zero_block = [&](size_t k, size_t panel) {
+    const size_t n_end = std::min(N, (panel + 1) * kBlockColumns);
+    for (size_t n = panel * kBlockColumns; n < n_end; n++) {
+      if (b_at(k, n) != 0.0f) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  size_t block_count = 0;
+  for (size_t panel = 0; panel < panel_count; panel++) {
+    for (size_t k = 0; k < K; k++) {
+      block_count += is_zero_block(k, panel) ? 0 : 1;
+    }
+  }
+  if (static_cast<float>(block_count) > kBlockSparseGemmMaxDensity * static_cast<float>(panel_count * K)) {
+    return false;
+  }
+
+  const BlockSparseLayout layout(panel_count, block_count);
+  packed_b_size = layout.size;
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  auto* packed_b_data = static_cast<uint8_t*>(packed_b.get());
+
+  // Initialize memory to 0 as the padding would otherwise generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  auto* header = reinterpret_cast<BlockSparseHeader*>(packed_b_data);
+  header->K = K;
+  header->N = N;
+  header->panel_count = panel_count;
+  header->block_count = block_count;
+  auto* panel_start = reinterpret_cast<uint64_t*>(packed_b_data + layout.panel_start_offset);
+  auto* values = reinterpret_cast<float*>(packed_b_data + layout.values_offset);
+  auto* block_k = reinterpret_cast<uint32_t*>(packed_b_data + layout.block_k_offset);
+
+  size_t block = 0;
+  for (size_t panel = 0; panel < panel_count; panel++) {
+    panel_start[panel] = block;
+    const size_t n_end = std::min(N, (panel + 1) * kBlockColumns);
+    for (size_t k = 0; k < K; k++) {
+      if (is_zero_block(k, panel)) {
+        continue;
+      }
+      // the columns of the last panel past N stay 0
+      for (size_t n = panel * kBlockColumns; n < n_end; n++) {
+        values[block * kBlockColumns + n - panel * kBlockColumns] = b_at(k, n);
+      }
+      block_k[block] = static_cast<uint32_t>(k);
+      block++;
+    }
+  }
+  panel_start[panel_count] = block;
+
+  b_shape = tensor_b.Shape();
+  return true;
+}
+
+void GemmBlockSparse(size_t M, size_t N, size_t K,
+                     float alpha,
+                     const float* A, size_t lda,
+                     const void* packed_b,
+                     float beta,
+                     float* C, size_t ldc,
+                     concurrency::ThreadPool* thread_pool) {
+  const auto* packed_b_data = static_cast<const uint8_t*>(packed_b);
+  const auto* header = reinterpret_cast<const BlockSparseHeader*>(packed_b_data);
+  ORT_ENFORCE(header->K == K && header->N == N, "The block sparse B does not match the GEMM shape.");
+
+  const size_t panel_count = static_cast<size_t>(header->panel_count);
+  const size_t block_count = static_cast<size_t>(header->block_count);
+  const BlockSparseLayout layout(panel_count, block_count);
+  const auto* panel_start = reinterpret_cast<const uint64_t*>(packed_b_data + layout.panel_start_offset);
+  const auto* values = reinterpret_cast<const float*>(packed_b_data + layout.values_offset);
+  const auto* block_k = reinterpret_cast<const uint32_t*>(packed_b_data + layout.block_k_offset);
+
+  // Each task computes a tile of kBlockRows rows by a panel of kBlockColumns columns. The tile is accumulated in
+  // registers over the blocks of the panel, so only the non-zero blocks of B are loaded and multiplied.
+  const size_t row_blocks = (M + kBlockRows - 1) / kBlockRows;
+  const double blocks_per_panel = static_cast<double>(block_count) / static_cast<double>(panel_count);
+  const TensorOpCost cost{blocks_per_panel * (kBlockColumns + kBlockRows + 1) * sizeof(float),
+                          static_cast<double>(kBlockRows * kBlockColumns * sizeof(float)),
+                          blocks_per_panel * kBlockRows * kBlockColumns * 2};
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(row_blocks * panel_count), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t tile = static_cast<size_t>(first); tile < static_cast<size_t>(last); tile++) {
+          const size_t m0 = (tile / panel_count) * kBlockRows;
+          const size_t panel = tile % panel_count;
+          const size_t rows = std::min(kBlockRows, M - m0);
+          const size_t columns = std::min(kBlockColumns, N - panel * kBlockColumns);
+
+          const size_t block_begin = static_cast<size_t>(panel_start[panel]);
+          const size_t block_end = static_cast<size_t>(panel_start[panel + 1]);
+          const float* a = A + m0 * lda;
+
+          float acc[kBlockRows][kBlockColumns] = {};
+          if (rows == kBlockRows) {
+            for (size_t block = block_begin; block < block_end; block++) {
+              const float* v = values + block * kBlockColumns;
+              const size_t k = block_k[block];
+              for (size_t r = 0; r < kBlockRows; r++) {
+                const float a_rk = a[r * lda + k];
+                for (size_t c = 0; c < kBlockColumns; c++) {
+                  acc[r][c] += a_rk * v[c];
+                }
+              }
+            }
+          } else {
+            for (size_t block = block_begin; block < block_end; block++) {
+              const float* v = values + block * kBlockColumns;
+              const size_t k = block_k[block];
+              for (size_t r = 0; r < rows; r++) {
+                const float a_rk = a[r * lda + k];
+                for (size_t c = 0; c < kBlockColumns; c++) {
+                  acc[r][c] += a_rk * v[c];
+                }
+              }
+            }
+          }
+
+          for (size_t r = 0; r < rows; r++) {
+            float* c_row = C + (m0 + r) * ldc + panel * kBlockColumns;
+            for (size_t c = 0; c < columns; c++) {
+              c_row[c] = beta == 0.0f ? alpha * acc[r][c] : alpha * acc[r][c] + beta * c_row[c];
+            }
+          }
+        }
+      });
+}
+
+}  // namespace onnxruntime
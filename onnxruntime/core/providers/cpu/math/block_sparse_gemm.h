@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+// Largest fraction of non-zero 1x4 blocks of B for which the block sparse GEMM is selected over the dense one.
+constexpr float kBlockSparseGemmMaxDensity = 0.3f;
+
+/**
+ * Packs a constant 2D B of a GEMM that is mostly zeros, e.g. the weight of a pruned model, as 1x4 blocks.
+ * The columns of B are split into panels of 4 and each panel keeps the rows of K with a non-zero value in it.
+ * Returns false when B is not 2D or more than kBlockSparseGemmMaxDensity of its blocks are non-zero, the dense
+ * packing should be used then.
+ */
+bool GemmPackBBlockSparse(AllocatorPtr& alloc,
+                          const Tensor& tensor_b,
+                          bool trans_b,
+                          IAllocatorUniquePtr<void>& packed_b,
+                          size_t& packed_b_size,
+                          TensorShape& b_shape);
+
+/**
+ * Computes C = alpha * A * B + beta * C for the B packed by GemmPackBBlockSparse and a row major A of M x K.
+ * C is not read when beta is 0.
+ */
+void GemmBlockSparse(size_t M, size_t N, size_t K,
+                     float alpha,
+                     const float* A, size_t lda,
+                     const void* packed_b,
+                     float beta,
+                     float* C, size_t ldc,
+                     concurrency::ThreadPool* thread_pool);
+
+}  // namespace onnxruntime
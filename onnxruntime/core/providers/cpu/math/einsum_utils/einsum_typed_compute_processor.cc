@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "einsum_typed_compute_processor.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 #include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 
@@ -92,6 +97,141 @@ static bool IsTransposeReshapeForEinsum(const gsl::span<const size_t>& perm,
   return true;
 }
 
+// Inputs up to which the contraction order is searched exhaustively, the order is built greedily for more.
+constexpr size_t kMaxInputsForOptimalContractionOrder = 12;
+
+// Chooses the order in which the inputs are contracted. The inputs are contracted one at a time into the result of
+// the previous ones, and the cost of a step is the number of multiply-adds of its MatMul: the product of the dims of
+// the subscripts of the result and of the next input. The result of a set of inputs has the same subscripts whatever
+// the order they were contracted in, those that appear in the set and in the output or in another input, so the
+// order of least total cost is found by dynamic programming over the sets of inputs, like the left-deep paths of
+// opt_einsum. Returns the inputs in their given order unless another order is cheaper.
+// `present[i][s]` tells whether subscript `s` has a non-trivial dim in input i, `in_output[s]` whether it is an output.
+static InlinedVector<size_t> GetContractionOrder(const std::vector<InlinedVector<bool>>& present,
+                                                 const InlinedVector<bool>& in_output,
+                                                 const InlinedVector<double>& subscript_dims) {
+  const size_t num_inputs = present.size();
+  const size_t num_subscripts = subscript_dims.size();
+
+  InlinedVector<size_t> order(num_inputs);
+  std::iota(order.begin(), order.end(), size_t{0});
+  if (num_inputs < 3) {
+    return order;
+  }
+
+  // the subscripts of the result of contracting the inputs in `set`
+  auto result_subscripts = [&](const InlinedVector<bool>& in_set, InlinedVector<bool>& subscripts) {
+    subscripts.assign(num_subscripts, false);
+    for (size_t s = 0; s < num_subscripts; ++s) {
+      bool inside = false;
+      bool outside = in_output[s];
+      for (size_t i = 0; i < num_inputs; ++i) {
+        (in_set[i] ? inside : outside) |= present[i][s];
+      }
+      subscripts[s] = inside && outside;
+    }
+  };
+
+  auto step_cost = [&](const InlinedVector<bool>& subscripts, size_t input) {
+    double cost = 1;
+    for (size_t s = 0; s < num_subscripts; ++s) {
+      if (subscripts[s] || present[input][s]) {
+        cost *= subscript_dims[s];
+      }
+    }
+    return cost;
+  };
+
+  auto order_cost = [&](gsl::span<const size_t> candidate) {
+    InlinedVector<bool> in_set(num_inputs, false);
+    InlinedVector<bool> subscripts;
+    in_set[candidate[0]] = true;
+    double cost = 0;
+    for (size_t p = 1; p < num_inputs; ++p) {
+      result_subscripts(in_set, subscripts);
+      cost += step_cost(subscripts, candidate[p]);
+      in_set[candidate[p]] = true;
+    }
+    return cost;
+  };
+
+  InlinedVector<size_t> best_order;
+  if (num_inputs <= kMaxInputsForOptimalContractionOrder) {
+    // cost and last input of the cheapest order of each set of inputs
+    const size_t num_sets = size_t{1} << num_inputs;
+    std::vector<double> set_cost(num_sets, std::numeric_limits<double>::infinity());
+    std::vector<size_t> set_last(num_sets, 0);
+    InlinedVector<bool> in_set(num_inputs);
+    InlinedVector<bool> subscripts;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      set_cost[size_t{1} << i] = 0;
+      set_last[size_t{1} << i] = i;
+    }
+    for (size_t set = 1; set < num_sets; ++set) {
+      if (set_cost[set] == std::numeric_limits<double>::infinity()) {
+        continue;
+      }
+      for (size_t i = 0; i < num_inputs; ++i) {
+        in_set[i] = (set >> i) & 1;
+      }
+      result_subscripts(in_set, subscripts);
+      for (size_t i = 0; i < num_inputs; ++i) {
+        const size_t next_set = set | (size_t{1} << i);
+        if (next_set == set) {
+          continue;
+        }
+        const double cost = set_cost[set] + step_cost(subscripts, i);
+        if (cost < set_cost[next_set]) {
+          set_cost[next_set] = cost;
+          set_last[next_set] = i;
+        }
+      }
+    }
+
+    best_order.resize(num_inputs);
+    for (size_t set = num_sets - 1, p = num_inputs; p-- > 0;) {
+      best_order[p] = set_last[set];
+      set &= ~(size_t{1} << set_last[set]);
+    }
+  } else {
+    // start from the cheapest pair, then add the input whose step is the cheapest
+    InlinedVector<bool> in_set(num_inputs, false);
+    InlinedVector<bool> subscripts;
+    double best_cost = std::numeric_limits<double>::infinity();
+    size_t first = 0;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      in_set[i] = true;
+      result_subscripts(in_set, subscripts);
+      in_set[i] = false;
+      for (size_t j = 0; j < num_inputs; ++j) {
+        if (j != i && step_cost(subscripts, j) < best_cost) {
+          best_cost = step_cost(subscripts, j);
+          first = i;
+        }
+      }
+    }
+
+    best_order.push_back(first);
+    in_set[first] = true;
+    while (best_order.size() < num_inputs) {
+      result_subscripts(in_set, subscripts);
+      size_t next = num_inputs;
+      for (size_t i = 0; i < num_inputs; ++i) {
+        if (!in_set[i] && (next == num_inputs || step_cost(subscripts, i) < step_cost(subscripts, next))) {
+          next = i;
+        }
+      }
+      best_order.push_back(next);
+      in_set[next] = true;
+    }
+  }
+
+  if (order_cost(best_order) < order_cost(order)) {
+    order = std::move(best_order);
+  }
+  return order;
+}
+
 template <typename T>
 std::unique_ptr<Tensor> EinsumTypedComputeProcessor<T>::PairwiseOperandProcess(const Tensor& left,
                                                                                const TensorShape& left_shape_override,
@@ -353,22 +493,49 @@ Status EinsumTypedComputeProcessor<T>::Run() {
 
   const auto& homogenized_input_dims = einsum_compute_preprocessor_.GetHomogenizedInputDims();
 
-  auto num_subscript_labels = einsum_compute_preprocessor_.GetNumSubscriptIndices();
-
-  auto num_inputs = context_->InputCount();
+  auto num_subscript_labels = onnxruntime::narrow<size_t>(einsum_compute_preprocessor_.GetNumSubscriptIndices());
+
+  auto num_inputs = onnxruntime::narrow<size_t>(context_->InputCount());
+
+  // Choose the order in which the inputs are contracted. A subscript is present in an input if its dim is
+  // non-trivial there, or if the input is the last one it appears in, so that subscripts with a dim of 1 in all
+  // inputs are still reduced.
+  std::vector<InlinedVector<bool>> present(num_inputs, InlinedVector<bool>(num_subscript_labels, false));
+  InlinedVector<bool> in_output(num_subscript_labels, false);
+  InlinedVector<double> subscript_dims(num_subscript_labels, 1.0);
+  for (size_t s = 0; s < num_subscript_labels; ++s) {
+    in_output[s] = mapped_indices_to_last_input_index[s] == -1;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      const int64_t dim = homogenized_input_dims[i][s];
+      present[i][s] = dim > 1 || mapped_indices_to_last_input_index[s] == static_cast<int64_t>(i);
+      subscript_dims[s] = std::max(subscript_dims[s], static_cast<double>(dim));
+    }
+  }
+  const InlinedVector<size_t> order = GetContractionOrder(present, in_output, subscript_dims);
+
+  // The position in `order` of the last input each subscript that is not an output appears in, it is reduced there
+  InlinedVector<int64_t> last_position(num_subscript_labels, -1);
+  for (size_t p = 0; p < num_inputs; ++p) {
+    for (size_t s = 0; s < num_subscript_labels; ++s) {
+      if (!in_output[s] && present[order[p]][s]) {
+        last_position[s] = static_cast<int64_t>(p);
+      }
+    }
+  }
 
   // Pre-process the first input so as to reduce any dims that only it has
   std::unique_ptr<const Tensor> result;
+  const size_t first = order[0];
 
   {
     TensorShapeVector reduced_dims;
-    TensorShapeVector preserved_dims;                                           // dims which were not reduced
-    TensorShapeVector preserved_shape;                                          // shape pertaining to only the dims that were preserved (not reduced)
-    reduced_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));    // num_subscript_labels is the upper bound. No harm in over-reserving.
-    preserved_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving.
+    TensorShapeVector preserved_dims;                 // dims which were not reduced
+    TensorShapeVector preserved_shape;                // shape pertaining to only the dims that were preserved (not reduced)
+    reduced_dims.reserve(num_subscript_labels);       // num_subscript_labels is the upper bound. No harm in over-reserving.
+    preserved_dims.reserve(num_subscript_labels);     // num_subscript_labels is the upper bound. No harm in over-reserving.
 
-    for (size_t i = 0; i < onnxruntime::narrow<size_t>(num_subscript_labels); ++i) {
-      if (mapped_indices_to_last_input_index[i] == 0) {
+    for (size_t i = 0; i < num_subscript_labels; ++i) {
+      if (last_position[i] == 0) {
         reduced_dims.push_back(i);
       } else {
         preserved_dims.push_back(i);
@@ -377,14 +544,14 @@ Status EinsumTypedComputeProcessor<T>::Run() {
 
     // Reduce the dims that are last seen in the first input alone
     if (reduced_dims.size() != 0) {
-      result = EinsumOp::ReduceSum<T>(preprocessed_inputs[0] ? *preprocessed_inputs[0] : *raw_inputs[0],
-                                      homogenized_input_dims[0].GetDims(), reduced_dims, allocator_, tp_,
+      result = EinsumOp::ReduceSum<T>(preprocessed_inputs[first] ? *preprocessed_inputs[first] : *raw_inputs[first],
+                                      homogenized_input_dims[first].GetDims(), reduced_dims, allocator_, tp_,
                                       einsum_ep_assets_, device_reduce_sum_func_);
     } else {
       // Check if there is a pre-processed version of this input
       // If so assign it to result
-      if (preprocessed_inputs[0]) {
-        result = std::move(preprocessed_inputs[0]);
+      if (preprocessed_inputs[first]) {
+        result = std::move(preprocessed_inputs[first]);
       }
     }
 
@@ -402,21 +569,22 @@ Status EinsumTypedComputeProcessor<T>::Run() {
   {
     bool is_final_pair = false;
     // Keep processing each input pair-wise
-    for (int input = 1; input < num_inputs; ++input) {
+    for (size_t p = 1; p < num_inputs; ++p) {
+      const size_t input = order[p];
       TensorShapeVector reduced_dims;
-      reduced_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
-      for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[onnxruntime::narrow<size_t>(dim)] == input) {
+      reduced_dims.reserve(num_subscript_labels);  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
+      for (size_t dim = 0; dim < num_subscript_labels; ++dim) {
+        if (last_position[dim] == static_cast<int64_t>(p)) {
           // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
           reduced_dims.push_back(dim);
         }
       }
-      if (input == num_inputs - 1) {
+      if (p == num_inputs - 1) {
         is_final_pair = true;
       }
       // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
+      result = PairwiseOperandProcess(result ? *result : *raw_inputs[first],
+                                      result ? result->Shape() : homogenized_input_dims[first],
                                       preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
                                       homogenized_input_dims[input],
                                       reduced_dims, is_final_pair);
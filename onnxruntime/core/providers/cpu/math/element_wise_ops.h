@@ -947,7 +947,7 @@ struct ProcessBroadcastSpanFuncs {
 // Parallelize processing of data where all the output is covered by a single span
 template <typename TBroadcastHelper>
 static void ParallelizeSingleSpan(TBroadcastHelper& helper, const ProcessBroadcastSpanFuncs& functors) {
-  TensorOpCost cost{static_cast<float>(std::max(helper.Input0ElementSize(), helper.Input1ElementSize())),
+  TensorOpCost cost{static_cast<float>(helper.Input0ElementSize() + helper.Input1ElementSize()),
                     static_cast<float>(helper.OutputElementSize()),
                     helper.UnitCost()};
 
@@ -994,6 +994,14 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
 void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFuncs& funcs, double unit_cost,
                          void* user_data = nullptr);
 
+// Broadcast the two inputs of input_broadcaster into output with parallelization.
+//
+// A single span is split across the threads, otherwise each thread processes a range of whole spans.
+// The cost of an element covers the bytes read from both inputs and written to the output.
+// unit_cost must be a valid cost value.
+void ParallelBroadcastLooper(const InputBroadcaster& input_broadcaster, Tensor& output, concurrency::ThreadPool* tp,
+                             const ProcessBroadcastSpanFuncs& funcs, double unit_cost, void* user_data = nullptr);
+
 // Helper to provide the looping logic with optimization for parallelizing within a single span if the
 // TBroadcastHelper instance was setup to enable that.
 template <typename TBroadcastHelper>
@@ -5,6 +5,7 @@
 #include "core/providers/cpu/math/gemm.h"
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/providers/cpu/math/block_sparse_gemm.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -106,136 +107,63 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    IAllocatorUniquePtr<void>& packed_b,
                    size_t& packed_b_size,
                    TensorShape& b_shape) {
-  // Only handle the common case of a 2D weight matrix. Additional matrices
-  // could be handled by stacking the packed buffers.
+  // Only handle the common case of a 2D weight matrix. See GemmPackBFp32Batched for
+  // a batch of matrices.
   if (tensor_b.Shape().NumDimensions() != 2) {
     return false;
   }
+
+  size_t packed_b_matrix_size;
+  return GemmPackBFp32Batched(alloc, tensor_b, trans_b, packed_b, packed_b_size, packed_b_matrix_size, b_shape);
+}
+
+bool GemmPackBFp32Batched(AllocatorPtr& alloc,
+                          const Tensor& tensor_b,
+                          bool trans_b,
+                          IAllocatorUniquePtr<void>& packed_b,
+                          size_t& packed_b_size,
+                          size_t& packed_b_matrix_size,
+                          TensorShape& b_shape) {
+  const size_t rank = tensor_b.Shape().NumDimensions();
+  if (rank < 2 || tensor_b.Shape().Size() == 0) {
+    return false;
+  }
   b_shape = tensor_b.Shape();
 
-  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
-  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[rank - 1]) : static_cast<size_t>(b_shape[rank - 2]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[rank - 2]) : static_cast<size_t>(b_shape[rank - 1]);
+  const size_t batch_count = static_cast<size_t>(b_shape.SizeToDimension(rank - 2));
 
-  packed_b_size = MlasGemmPackBSize(N, K);
-  if (packed_b_size == 0) {
+  packed_b_matrix_size = MlasGemmPackBSize(N, K);
+  if (packed_b_matrix_size == 0) {
     return false;
   }
 
+  // keep each packed matrix aligned
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  packed_b_matrix_size = (packed_b_matrix_size + alignment - 1) / alignment * alignment;
+  packed_b_size = SafeInt<size_t>(packed_b_matrix_size) * batch_count;
+
   packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
-  auto* packed_b_data = packed_b.get();
+  auto* packed_b_data = static_cast<uint8_t*>(packed_b.get());
 
   // Initialize memory to 0 as there could be some padding associated with pre-packed
   // buffer memory and we don not want it uninitialized and generate different hashes
   // if and when we try to cache this pre-packed buffer for sharing between sessions.
   memset(packed_b_data, 0, packed_b_size);
 
-  MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
-                N,
-                K,
-                tensor_b.Data<float>(),
-                trans_b ? K : N,
-                packed_b_data);
-  return true;
-}
-
-template <typename T>
-void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
-                          ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
-                          T alpha,
-                          const T* a_data, const T* b_data,
-                          T beta,
-                          const T* c_data, const TensorShape* c_shape,
-                          T* y_data,
-                          concurrency::ThreadPool* thread_pool) {
-  // if input is empty tensor, return directly as nothing need to be calculated.
-  if (M == 0 || N == 0)
-    return;
-
-  // Broadcast the bias as needed if bias is given
-  GemmBroadcastBias(M, N, beta, c_data, c_shape, y_data);
-
-  math::Gemm<T>(trans_a, trans_b,
-                M, N, K,
-                alpha,
-                a_data,
-                b_data,
-                // ideally we need to set the output buffer contents to 0 if bias is missing,
-                // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
-                c_data != nullptr ? beta : 0,
-                y_data,
-                thread_pool);
-}
-
-template <>
-void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
-                                  ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
-                                  MLFloat16 alpha,
-                                  const MLFloat16* a_data, const MLFloat16* b_data,
-                                  MLFloat16 beta,
-                                  const MLFloat16* c_data, const TensorShape* c_shape,
-                                  MLFloat16* y_data,
-                                  concurrency::ThreadPool* thread_pool) {
-  // if input is empty tensor, return directly as nothing need to be calculated.
-  if (M == 0 || N == 0)
-    return;
-
-#if defined(__GNUC__) && defined(HAS_CLASS_MEMACCESS)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wclass-memaccess"
-#endif
-  // MLFloat16's constructor is explicit, so here we need to use memset
-  if (c_data == nullptr)
-    memset(&beta, 0, sizeof(MLFloat16));
-#if defined(__GNUC__) && defined(HAS_CLASS_MEMACCESS)
-#pragma GCC diagnostic pop
-#endif
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
-  bool support_mlas = false;
-  if (c_shape == nullptr) {
-    support_mlas = true;
-  } else if (c_shape->NumDimensions() == 1 && (*c_shape)[0] == N) {
-    support_mlas = true;
-  } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
-    support_mlas = true;
-  }
-  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
-    MLAS_HALF_GEMM_DATA_PARAMS data;
-    data.A = a_data;
-    data.lda = K;
-    data.B = b_data;
-    data.ldb = N;
-    data.C = y_data;
-    data.ldc = N;
-    if (c_shape != nullptr) {
-      data.Bias = c_data;
-    }
-    MlasHalfGemmBatch(M, N, K, 1, &data, thread_pool);
-    return;
+  const float* b_data = tensor_b.Data<float>();
+  for (size_t i = 0; i < batch_count; i++) {
+    MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                  N,
+                  K,
+                  b_data + i * K * N,
+                  trans_b ? K : N,
+                  packed_b_data + i * packed_b_matrix_size);
   }
-#endif
-  // Fallback to Eigen
-  // Broadcast the bias as needed if bias is given
-  GemmBroadcastBias(M, N, beta, c_data, c_shape, y_data);
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wstrict-aliasing"
-#endif
-  math::Gemm<Eigen::half>(trans_a, trans_b, M, N, K, *reinterpret_cast<Eigen::half*>(&alpha),
-                          reinterpret_cast<const Eigen::half*>(a_data), reinterpret_cast<const Eigen::half*>(b_data), *reinterpret_cast<Eigen::half*>(&beta), reinterpret_cast<Eigen::half*>(y_data), thread_pool);
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
-#endif
+  return true;
 }
 
-template void Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
-                                       ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
-                                       float alpha,
-                                       const float* a_data, const float* b_data,
-                                       float beta,
-                                       const float* c_data, const TensorShape* c_shape,
-                                       float* y_data,
-                                       concurrency::ThreadPool* thread_pool);
-
 template <typename T>
 Status Gemm<T>::PrePack(const Tensor& /* tensor */, int /* input_idx */, AllocatorPtr /*alloc_for_caching*/,
                         /*out*/ bool& is_packed,
@@ -253,7 +181,12 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    // the block sparse kernel takes A as is
+    packed_b_is_sparse_ = trans_A_ == CblasNoTrans &&
+                          GemmPackBBlockSparse(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size,
+                                               b_shape_);
+    is_packed = packed_b_is_sparse_ ||
+                GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -408,7 +341,66 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
+  if (packed_b_is_sparse_) {
+    GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+    GemmBlockSparse(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha_,
+                    A->Data<float>(), static_cast<size_t>(K), packed_b_.get(),
+                    (c_data != nullptr && beta_ != 0.0f) ? beta_ : 0.0f, y_data, static_cast<size_t>(N), thread_pool);
+    if (mlas_activation_.has_value()) {
+      MlasActivation(&*mlas_activation_, y_data, nullptr, static_cast<size_t>(M), static_cast<size_t>(N),
+                     static_cast<size_t>(N));
+    }
+    ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
+    return Status::OK();
+  }
+
+  // A per column bias or a C of the full output shape, e.g. a residual connection folded in
+  // by MatMulAddFusion, is added by the SGEMM epilogue together with the fused activation
+  // while each output tile is cache resident. This saves the passes over Y that broadcast
+  // C and apply the activation.
+  const float* epilogue_bias = nullptr;
+  const float* epilogue_sum = nullptr;
+  if (c_data != nullptr && beta_ == 1.0f) {
+    if (c_shape->Size() == N && (c_shape->NumDimensions() == 1 ||
+                                 (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1))) {
+      epilogue_bias = c_data;
+    } else if (c_shape->NumDimensions() == 2 && (*c_shape)[0] == M && (*c_shape)[1] == N) {
+      epilogue_sum = c_data;
+    }
+  }
+
+  if (mlas_activation_.has_value() || epilogue_bias != nullptr || epilogue_sum != nullptr) {
+    MLAS_ACTIVATION activation;
+    activation.ActivationKind = MlasIdentityActivation;
+    if (mlas_activation_.has_value()) {
+      activation = *mlas_activation_;
+    }
+    MLAS_SGEMM_ACTIVATION_PROCESSOR output_processor(activation, epilogue_bias, epilogue_sum);
+
+    const bool c_in_epilogue = epilogue_bias != nullptr || epilogue_sum != nullptr;
+    if (!c_in_epilogue) {
+      GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+    }
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+    if (B) {
+      data.B = B->Data<float>();
+      data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+    } else {
+      data.B = static_cast<const float*>(packed_b_.get());
+      data.BIsPacked = true;
+    }
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.alpha = alpha_;
+    data.beta = (c_data != nullptr && !c_in_epilogue) ? beta_ : 0.0f;
+    data.OutputProcessor = &output_processor;
+
+    MlasGemm(trans_A_, trans_B_, static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+             data, thread_pool);
+  } else if (B) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
   } else {
@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <optional>
+
 #include "gemm_base.h"
 
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -40,10 +43,16 @@ class Gemm : protected GemmBase, public OpKernel {
  protected:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // B is mostly zeros and packed by GemmPackBBlockSparse
+  bool packed_b_is_sparse_{false};
 
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
+  // For fused gemm + activation when the activation is applied by the MLAS SGEMM epilogue
+  // instead of by activation_.
+  std::optional<MLAS_ACTIVATION> mlas_activation_;
+
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
 };
 
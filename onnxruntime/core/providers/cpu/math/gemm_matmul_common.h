@@ -14,4 +14,14 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Packs each of the matrices in the last two dimensions of a B with two or more dimensions, one after the other.
+// The packed matrices are packed_b_matrix_size bytes apart.
+bool GemmPackBFp32Batched(AllocatorPtr& alloc,
+                          const Tensor& tensor_b,
+                          bool trans_b,
+                          IAllocatorUniquePtr<void>& packed_b,
+                          size_t& packed_b_size,
+                          size_t& packed_b_matrix_size,
+                          TensorShape& b_shape);
+
 };  // namespace onnxruntime
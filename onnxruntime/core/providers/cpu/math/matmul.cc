@@ -2,8 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+#include "core/framework/numa_replicas.h"
+#include "core/providers/cpu/math/block_sparse_gemm.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tunable/gemm.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -124,7 +127,7 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -171,28 +174,48 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
-    size_t dim1 = 0;
-    size_t dim2 = 0;
-    TensorShape b_shape = tensor.Shape();
-
-    if (b_shape.NumDimensions() == 2) {
-      dim1 = static_cast<size_t>(b_shape[0]);
-      dim2 = static_cast<size_t>(b_shape[1]);
-    }
 
-    if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
-      is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
-    } else
+    // the block sparse kernel takes A as is
+    packed_b_is_sparse_ = trans_a_attr_ == 0 && !trans_batch_a_ && !trans_batch_b_ &&
+                          GemmPackBBlockSparse(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+    if (packed_b_is_sparse_) {
+      is_packed = true;
+    } else {
+      // a batch of matrices is packed matrix by matrix, unless the batch dimensions are transposed
+      const bool can_pack_fp32 = tensor.Shape().NumDimensions() == 2 || !trans_batch_b_;
+#if defined(MLAS_SBGEMM_SUPPORTED)
+      size_t dim1 = 0;
+      size_t dim2 = 0;
+      TensorShape b_shape = tensor.Shape();
+
+      if (b_shape.NumDimensions() == 2) {
+        dim1 = static_cast<size_t>(b_shape[0]);
+        dim2 = static_cast<size_t>(b_shape[1]);
+      }
+
+      if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
+        is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      } else
 #endif
-    {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      {
+        is_packed = can_pack_fp32 && GemmPackBFp32Batched(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size,
+                                                          packed_b_matrix_size_, b_shape_);
+        if (is_packed && replicate_on_numa_nodes_) {
+          packed_b_replicas_ = ReplicateOnNumaNodes(packed_b_.get(), packed_b_size);
+        }
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
       prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+      // the copies follow the packed B
+      for (auto& replica : packed_b_replicas_) {
+        prepacked_weights->buffers_.push_back(std::move(replica));
+        prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+      }
+      packed_b_replicas_.clear();
     }
   }
   return Status::OK();
@@ -206,6 +229,10 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   if (input_idx == 1) {
     used_shared_buffers = true;
     packed_b_ = std::move(prepacked_buffers[0]);
+    packed_b_replicas_.clear();
+    for (size_t i = 1; i < prepacked_buffers.size(); ++i) {
+      packed_b_replicas_.push_back(std::move(prepacked_buffers[i]));
+    }
   }
 
   return Status::OK();
@@ -240,8 +267,19 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
-  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
+
+  if (packed_b_is_sparse_) {
+    for (size_t i = 0; i < max_len; i++) {
+      GemmBlockSparse(M, N, K, alpha_attr_, a_data + helper.LeftOffsets()[i], lda, packed_b_.get(), 0.0f,
+                      y_data + helper.OutputOffsets()[i], N, thread_pool);
+    }
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // a batch of matrices is never packed into bf16
+  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold) &&
+      (!packed_b_ || b_shape.NumDimensions() == 2)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
       data[i].BIsfp32 = !(bool(packed_b_));
@@ -260,16 +298,37 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
 #endif
   {
     std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
+    // the B of each matrix in each copy of the packed B
+    const size_t num_replicas = packed_b_ ? packed_b_replicas_.size() : 0;
+    std::vector<const float*> b_replicas(max_len * num_replicas);
     for (size_t i = 0; i < max_len; i++) {
       data[i].BIsPacked = bool(packed_b_);
       data[i].A = a_data + helper.LeftOffsets()[i];
       data[i].lda = lda;
-      data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
+      // the packed matrices of a batched B follow each other
+      data[i].B = data[i].BIsPacked
+                      ? reinterpret_cast<const float*>(static_cast<const uint8_t*>(packed_b_.get()) +
+                                                       helper.RightOffsets()[i] / (K * N) * packed_b_matrix_size_)
+                      : b_data + helper.RightOffsets()[i];
       data[i].ldb = ldb;
       data[i].C = y_data + helper.OutputOffsets()[i];
       data[i].ldc = N;
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
+      if (num_replicas > 0) {
+        const size_t matrix_offset = helper.RightOffsets()[i] / (K * N) * packed_b_matrix_size_;
+        for (size_t node = 0; node < num_replicas; node++) {
+          b_replicas[i * num_replicas + node] =
+              reinterpret_cast<const float*>(static_cast<const uint8_t*>(packed_b_replicas_[node].get()) +
+                                             matrix_offset);
+        }
+        data[i].BReplicas = b_replicas.data() + i * num_replicas;
+        data[i].BReplicaCount = num_replicas;
+      }
+    }
+    if (auto* tuning_ctx = cpu::tunable::GetEnabledTuningContext(*this); tuning_ctx != nullptr) {
+      return cpu::tunable::Sgemm(tuning_ctx, trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
+                                 M, N, K, data.data(), max_len, thread_pool);
     }
     MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
                   M, N, K, data.data(), max_len, thread_pool);
@@ -30,10 +30,12 @@ class MatMul<float> final : public OpKernel {
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
     use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
 #endif
+    replicate_on_numa_nodes_ =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsNumaReplicatePrepackedWeights, "0") == "1";
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -48,6 +50,13 @@ class MatMul<float> final : public OpKernel {
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // bytes between the packed matrices of a B with more than two dimensions
+  size_t packed_b_matrix_size_{0};
+  // B is mostly zeros and packed by GemmPackBBlockSparse
+  bool packed_b_is_sparse_{false};
+  // copies of the fp32 packed_b_ on each NUMA node, see kOrtSessionOptionsNumaReplicatePrepackedWeights
+  bool replicate_on_numa_nodes_{false};
+  std::vector<IAllocatorUniquePtr<void>> packed_b_replicas_;
 
   // For FusedMatMul contrib ops
   float alpha_attr_;
@@ -56,10 +65,10 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
   bool use_fastmath_mode_;
-  // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
+  // sbgemm kernels process blocks of at least 8x16 elements with weights pre-packed into bf16 panels,
   // so a minimum of 32 elements is defined to outweigh the additional prepacking overhead
   const size_t kFastMathModeKernelsizeThreshold = 32;
 #endif
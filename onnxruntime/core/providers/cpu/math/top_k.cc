@@ -140,6 +140,97 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// Selects the top k of the contiguous values at indices [begin, end) into a heap of their indices, which
+// HeapifyIthPosition maintains. Requires end - begin >= k.
+//
+// Once the heap holds values near the k-th best almost no value replaces its top, so the values are first compared
+// with the top a block at a time in a loop without branches, which the compiler vectorizes, and only the blocks
+// with a candidate are inserted one value at a time.
+template <class Comparator>
+static void HeapSelectContiguous(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                                 int64_t begin, int64_t end, const unsigned k, int64_t* heap) {
+  constexpr int64_t kBlockSize = 32;
+
+  int64_t cur_idx = begin;
+  for (unsigned l = 0; l < k; ++l, ++cur_idx) {
+    heap[k - l - 1] = cur_idx;
+    HeapifyIthPosition(heap, k - l - 1, k, comparer);
+  }
+
+  // as in FindTopKElements, a value equal to the top doesn't replace it as its index is higher
+  auto top = input_data[heap[0]];
+  auto insert = [&](int64_t idx) {
+    if (comparer.CompareValueOnly(input_data[idx], top)) {
+      heap[0] = idx;
+      HeapifyIthPosition(heap, 0, k, comparer);
+      top = input_data[heap[0]];
+    }
+  };
+
+  for (; cur_idx + kBlockSize <= end; cur_idx += kBlockSize) {
+    const auto* block = input_data + cur_idx;
+    int candidates = 0;
+    for (int64_t l = 0; l < kBlockSize; ++l) {
+      candidates += comparer.CompareValueOnly(block[l], top) ? 1 : 0;
+    }
+
+    if (candidates != 0) {
+      for (int64_t l = 0; l < kBlockSize; ++l) {
+        insert(cur_idx + l);
+      }
+    }
+  }
+
+  for (; cur_idx < end; ++cur_idx) {
+    insert(cur_idx);
+  }
+}
+
+// Finds the top k of rows that are few and long by splitting each row into shards across the threads. Each shard
+// selects its own top k with HeapSelectContiguous, then the top k of each row are selected from those of its shards.
+// The rows must be contiguous, i.e. TopK must be along the last axis.
+template <class Comparator>
+static void FindTopKElementsSharded(const typename Comparator::DataType* input_data, int64_t rows, int64_t cols,
+                                    int64_t shards_per_row, const unsigned k, bool sorted,
+                                    EigenMatrixMapRowMajor<typename Comparator::DataType>& values_map,
+                                    EigenMatrixMapRowMajor<int64_t>& indices_map,
+                                    concurrency::ThreadPool* threadpool) {
+  // the heap of each shard, and then the candidates of each row
+  std::vector<int64_t> candidates(SafeInt<size_t>(rows) * shards_per_row * k);
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, onnxruntime::narrow<std::ptrdiff_t>(rows * shards_per_row),
+      [input_data, cols, shards_per_row, k, &candidates](std::ptrdiff_t shard) {
+        const int64_t row = shard / shards_per_row;
+        auto work = concurrency::ThreadPool::PartitionWork(shard % shards_per_row,
+                                                           onnxruntime::narrow<std::ptrdiff_t>(shards_per_row),
+                                                           onnxruntime::narrow<std::ptrdiff_t>(cols));
+        Comparator comparer(input_data);
+        HeapSelectContiguous(comparer, input_data, row * cols + work.start, row * cols + work.end, k,
+                             candidates.data() + shard * k);
+      });
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, onnxruntime::narrow<std::ptrdiff_t>(rows),
+      [input_data, cols, shards_per_row, k, sorted, &candidates, &values_map, &indices_map](std::ptrdiff_t row) {
+        Comparator comparer(input_data);
+        auto row_candidates = candidates.begin() + row * shards_per_row * k;
+        auto row_candidates_end = row_candidates + shards_per_row * k;
+
+        std::nth_element(row_candidates, row_candidates + (k - 1), row_candidates_end, comparer);
+        if (sorted) {
+          std::sort(row_candidates, row_candidates + k, comparer);
+        }
+
+        const int64_t row_offset = row * cols;
+        for (unsigned l = 0; l < k; ++l) {
+          int64_t idx = row_candidates[l];
+          values_map(row, l) = input_data[idx];
+          indices_map(row, l) = idx - row_offset;
+        }
+      });
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -173,6 +264,17 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   int64_t threads_needed = static_cast<int64_t>(std::floor(input_shape.Size() * k / (128 * 1024)));
   num_threads = std::max(std::min(threads_needed, num_threads), static_cast<int64_t>(1));
 
+  // with fewer rows than threads, e.g. the logits of a large vocabulary for a small batch, split long rows into
+  // shards so all the threads are used. each shard must be long enough that selecting its top k is cheap relative
+  // to scanning it.
+  constexpr int64_t kMinShardSize = 16 * 1024;
+  if (block_slice == 1 && rows < tp_threads && num_blocks >= 2 * kMinShardSize && k <= kMinShardSize / 64) {
+    const int64_t shards_per_row = std::min((tp_threads + rows - 1) / rows, num_blocks / kMinShardSize);
+    FindTopKElementsSharded<Comparator>(input_data, rows, cols, shards_per_row, k, sorted, values_map, indices_map,
+                                        threadpool);
+    return;
+  }
+
   // from testing various batch sizes relative to k, the following appears to work well as a selector.
   // tested with following combinations
   //   batch_size = [ 8, 16, 32, 64, 128, 256, 512, 1024, 2048 ]
@@ -233,27 +335,31 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
               int64_t l = 0;
               auto cur_idx = row_offset + j;
 
-              // add first k items starting from the bottom up
-              for (; l < k; ++l) {
-                indices[k - l - 1] = cur_idx;
-                HeapifyIthPosition(indices, k - SafeInt<size_t>(l) - 1, k, comparer);
-
-                cur_idx += block_slice;
-              }
+              if (block_slice == 1) {
+                HeapSelectContiguous(comparer, input_data, row_offset, row_offset + num_blocks, k, indices);
+              } else {
+                // add first k items starting from the bottom up
+                for (; l < k; ++l) {
+                  indices[k - l - 1] = cur_idx;
+                  HeapifyIthPosition(indices, k - SafeInt<size_t>(l) - 1, k, comparer);
 
-              // insert remainder if the next value would replace the top of the heap (current worst top k value)
-              // save top so we only have one load in the CompareValueOnly call
-              auto top = input_data[indices[0]];
-              for (; l < num_blocks; ++l) {
-                // we can compare value only. if the current value is equal to the top of the heap it won't
-                // replace it as the index will be higher.
-                if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
-                  indices[0] = cur_idx;
-                  HeapifyIthPosition(indices, 0, k, comparer);
-                  top = input_data[indices[0]];
+                  cur_idx += block_slice;
                 }
 
-                cur_idx += block_slice;
+                // insert remainder if the next value would replace the top of the heap (current worst top k value)
+                // save top so we only have one load in the CompareValueOnly call
+                auto top = input_data[indices[0]];
+                for (; l < num_blocks; ++l) {
+                  // we can compare value only. if the current value is equal to the top of the heap it won't
+                  // replace it as the index will be higher.
+                  if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
+                    indices[0] = cur_idx;
+                    HeapifyIthPosition(indices, 0, k, comparer);
+                    top = input_data[indices[0]];
+                  }
+
+                  cur_idx += block_slice;
+                }
               }
 
               if (sorted) {
@@ -524,5 +524,23 @@ void batched_update_scores_inplace(gsl::span<T> scores, int64_t num_batches_in,
     }
   }
 }
+
+// Writes map(input[i]) to output[i] for all the elements. The elements are split across the threads of threadpool,
+// map has to be safe to call concurrently.
+template <typename TIn, typename TOut, typename TMap>
+void MapElements(concurrency::ThreadPool* threadpool, gsl::span<const TIn> input, gsl::span<TOut> output,
+                 const TMap& map) {
+  // a string key is hashed and compared, a string value is copied
+  constexpr double cost = std::is_same_v<TIn, std::string> || std::is_same_v<TOut, std::string> ? 64.0 : 8.0;
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, static_cast<std::ptrdiff_t>(input.size()),
+      TensorOpCost{static_cast<double>(sizeof(TIn)), static_cast<double>(sizeof(TOut)), cost},
+      [&input, &output, &map](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          output[i] = map(input[i]);
+        }
+      });
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -247,7 +247,8 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
                               threadpool);
 
-    for (int64_t n = 0; n < num_batches; n++) {
+    auto score_batch = [this, &kernels_span, &classifier_scores, &votes_span, num_slots_per_iteration,
+                        num_classifiers](ptrdiff_t n) {
       // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
       // per class.
       // coefficients: [num_classes - 1, vector_count_]
@@ -304,7 +305,10 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
           ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
         }
       }
-    }
+    };
+
+    // the batches write to separate scores and votes
+    concurrency::ThreadPool::TryBatchParallelFor(threadpool, num_batches, score_batch, -1);
   }
 
   auto finalize_batch = [this, &final_scores, final_scores_per_batch,
@@ -39,28 +39,28 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
+      // exp(-gamma * |a - b|^2) with |a - b|^2 = |a|^2 + |b|^2 - 2 * a.b, so the dot products of all the batches with
+      // all the support vectors are computed by a single GEMM
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        2.f * gamma_, a.data(), b.data(), 0.f,
+                                        nullptr, nullptr,
+                                        out.data(),
+                                        threadpool);
 
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
+      const Eigen::Array<T, Eigen::Dynamic, 1> a_norms =
+          ConstEigenMatrixMapRowMajor<T>(a.data(), m, k).rowwise().squaredNorm().array() * gamma_;
+      const Eigen::Array<T, 1, Eigen::Dynamic> b_norms =
+          ConstEigenMatrixMapRowMajor<T>(b.data(), n, k).rowwise().squaredNorm().transpose().array() * gamma_;
 
-        cur_batch += k;  // move to start of next batch
+      auto map_out = EigenMatrixMapRowMajor<T>(out.data(), m, n);
+      map_out.array() = (map_out.array().colwise() - a_norms).rowwise() - b_norms;
+      if (gamma_ > 0.f) {
+        // the rounding errors of the expansion can make the distance of close vectors slightly negative
+        map_out.array() = map_out.array().min(T(0));
       }
+
+      MlasComputeExp(out.data(), out.data(), out.size());
     } else {
       float alpha = 1.f;
       float beta = 1.f;
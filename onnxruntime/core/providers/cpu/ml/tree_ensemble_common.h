@@ -7,6 +7,7 @@
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 #include "tree_ensemble_helper.h"
+#include "tree_ensemble_quickscorer.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -32,6 +33,8 @@ class TreeEnsembleCommonAttributes {
   int parallel_tree_;    // starts parallelizing the computing by trees if n_tree >= parallel_tree_
   int parallel_tree_N_;  // batch size if parallelizing by trees
   int parallel_N_;       // starts parallelizing the computing by rows if n_rows <= parallel_N_
+  int quickscorer_tree_;  // evaluates batches of rows with the bitvector engine if n_tree >= quickscorer_tree_
+  int quickscorer_N_;     // and n_rows >= quickscorer_N_
 };
 
 // TI: input type
@@ -47,6 +50,7 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   // `ThresholdType` is used as well for output type (double as well for lightgbm) and not `OutputType`.
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
+  TreeEnsembleQuickScorer<ThresholdType> quickscorer_;
 
  public:
   TreeEnsembleCommon() {}
@@ -86,6 +90,10 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
+  template <typename AGG>
+  void ComputeAggQuickScorer(concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+                             int64_t* label_data, int64_t N, int64_t stride, const AGG& agg) const;
+
  private:
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
@@ -161,6 +169,8 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
   parallel_tree_ = parallel_tree;
   parallel_tree_N_ = parallel_tree_N;
   parallel_N_ = parallel_N;
+  quickscorer_tree_ = 64;
+  quickscorer_N_ = 8;
 
   ORT_ENFORCE(n_targets_or_classes > 0);
   ORT_ENFORCE(nodes_falsenodeids.size() == nodes_featureids.size());
@@ -338,6 +348,13 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  // Builds the bitvector layout if the trees allow it, ComputeAgg decides whether to use it.
+  auto first_branch = std::find_if(nodes_.cbegin(), nodes_.cend(),
+                                   [](const TreeNodeElement<ThresholdType>& node) { return node.is_not_leaf(); });
+  if (same_mode_ && !has_missing_tracks_ && first_branch != nodes_.cend()) {
+    quickscorer_.Init(nodes_, roots_, max_feature_id_ + 1, first_branch->mode());
+  }
+
   return Status::OK();
 }
 
@@ -455,6 +472,11 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
   auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
+  if (quickscorer_.enabled() && n_trees_ >= quickscorer_tree_ && N >= quickscorer_N_) {
+    ComputeAggQuickScorer(ttp, x_data, z_data, label_data, N, stride, agg);
+    return;
+  }
+
   if (n_targets_or_classes_ == 1) {
     if (N == 1) {
       ScoreValue<ThresholdType> score = {0, 0};
@@ -669,6 +691,60 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggQuickScorer(
+    concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data, int64_t* label_data,
+    int64_t N, int64_t stride, const AGG& agg) const {
+  // Rows are evaluated by batches of kRows, every batch goes through all the trees
+  // before the next one starts. Batches are distributed among threads.
+  static constexpr int64_t kRows = static_cast<int64_t>(TreeEnsembleQuickScorer<ThresholdType>::kRows);
+  const int64_t n_batches = (N + kRows - 1) / kRows;
+  auto num_threads = std::min<int32_t>(concurrency::ThreadPool::DegreeOfParallelism(ttp),
+                                       SafeInt<int32_t>(n_batches));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      ttp,
+      num_threads,
+      [this, &agg, num_threads, n_batches, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+        std::vector<uint64_t> bitvectors(quickscorer_.BitvectorSize());
+        auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads),
+                                                           onnxruntime::narrow<ptrdiff_t>(n_batches));
+        if (n_targets_or_classes_ == 1) {
+          ScoreValue<ThresholdType> scores[kRows];
+          for (auto b = work.start; b < work.end; ++b) {
+            const int64_t begin = b * kRows;
+            const size_t n_rows = onnxruntime::narrow<size_t>(std::min(kRows, N - begin));
+            std::fill(scores, scores + n_rows, ScoreValue<ThresholdType>({0, 0}));
+            quickscorer_.Compute(x_data + begin * stride, stride, n_rows, bitvectors.data(),
+                                 [&agg, &scores](size_t r, const TreeNodeElement<ThresholdType>& leaf) {
+                                   agg.ProcessTreeNodePrediction1(scores[r], leaf);
+                                 });
+            for (size_t r = 0; r < n_rows; ++r) {
+              agg.FinalizeScores1(z_data + begin + r, scores[r],
+                                  label_data == nullptr ? nullptr : (label_data + begin + r));
+            }
+          }
+        } else {
+          std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(onnxruntime::narrow<size_t>(kRows));
+          for (auto b = work.start; b < work.end; ++b) {
+            const int64_t begin = b * kRows;
+            const size_t n_rows = onnxruntime::narrow<size_t>(std::min(kRows, N - begin));
+            for (size_t r = 0; r < n_rows; ++r) {
+              scores[r].assign(onnxruntime::narrow<size_t>(n_targets_or_classes_), ScoreValue<ThresholdType>({0, 0}));
+            }
+            quickscorer_.Compute(x_data + begin * stride, stride, n_rows, bitvectors.data(),
+                                 [this, &agg, &scores](size_t r, const TreeNodeElement<ThresholdType>& leaf) {
+                                   agg.ProcessTreeNodePrediction(scores[r], leaf, weights_);
+                                 });
+            for (size_t r = 0; r < n_rows; ++r) {
+              agg.FinalizeScores(scores[r], z_data + (begin + r) * n_targets_or_classes_, -1,
+                                 label_data == nullptr ? nullptr : (label_data + begin + r));
+            }
+          }
+        }
+      });
+}
+
 #define TREE_FIND_VALUE(CMP)                                                                           \
   if (has_missing_tracks_) {                                                                           \
     while (root->is_not_leaf()) {                                                                      \
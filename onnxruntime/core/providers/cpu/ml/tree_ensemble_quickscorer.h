@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "tree_ensemble_aggregator.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Alternative evaluation engine for large ensembles of small trees, based on QuickScorer
+// (Lucchese et al., SIGIR 2015) and its vectorized variant processing several rows at once.
+//
+// Every tree gets a 64-bit bitvector with one bit per leaf, leaves being numbered so that the
+// leaves of the true subtree of a node come before the leaves of its false subtree. Each
+// condition node is turned into a mask clearing the leaves of its true subtree. Evaluating a row
+// is then done feature by feature instead of tree by tree: the nodes of a feature are sorted by
+// threshold, every node whose condition is false for the row applies its mask to the bitvector
+// of its tree, and the scan stops at the first threshold for which the condition holds. Once all
+// features are processed, the exit leaf of a tree is the lowest bit still set.
+//
+// The nodes are stored as a structure of arrays (threshold, tree, mask) so that the scan is
+// branch free and sequential, kRows rows are compared against every threshold in one loop the
+// compiler vectorizes, and trees are grouped in blocks sized to stay in L2 while the rows of a
+// batch go through them.
+//
+// The engine only handles ensembles where every tree has at most 64 leaves, all conditions are
+// BRANCH_LEQ or all are BRANCH_LT, no node tracks missing values to the true branch and no node
+// is shared between two parents. Init returns false otherwise and TreeEnsembleCommon keeps
+// walking the trees node by node.
+template <typename ThresholdType>
+class TreeEnsembleQuickScorer {
+ public:
+  // Number of rows evaluated together.
+  static constexpr size_t kRows = 16;
+  // Maximum number of leaves in a tree, one bit per leaf.
+  static constexpr size_t kMaxLeaves = 64;
+  // Approximate amount of memory touched by a block of trees (nodes, leaves and bitvectors).
+  static constexpr size_t kBlockBytes = 192 * 1024;
+
+  // all_nodes is the vector roots point into.
+  bool Init(const std::vector<TreeNodeElement<ThresholdType>>& all_nodes,
+            const std::vector<TreeNodeElement<ThresholdType>*>& roots, int64_t n_features, NODE_MODE mode);
+
+  bool enabled() const { return enabled_; }
+
+  // Number of uint64_t the caller must provide to Compute.
+  size_t BitvectorSize() const { return max_block_trees_ * kRows; }
+
+  // Evaluates every tree on n_rows <= kRows rows and calls fn(row, leaf) for each row and each tree.
+  // For a given row, the trees are visited in the same order as roots.
+  template <typename InputType, typename Fn>
+  void Compute(const InputType* x_data, int64_t stride, size_t n_rows, uint64_t* bitvectors, Fn&& fn) const {
+    if (less_) {
+      ComputeImpl<true>(x_data, stride, n_rows, bitvectors, fn);
+    } else {
+      ComputeImpl<false>(x_data, stride, n_rows, bitvectors, fn);
+    }
+  }
+
+ private:
+  struct Block {
+    size_t first_tree;
+    size_t n_trees;
+    size_t feature_offsets;  // position of the block offsets in feature_offsets_
+  };
+
+  struct Node {
+    int64_t feature_id;
+    ThresholdType threshold;
+    uint32_t tree;
+    uint64_t mask;
+  };
+
+  bool AddTree(const TreeNodeElement<ThresholdType>* root, NODE_MODE mode, std::vector<Node>& nodes,
+               std::vector<uint8_t>& visited, const TreeNodeElement<ThresholdType>* first_node);
+
+  template <bool kLess, typename InputType, typename Fn>
+  void ComputeImpl(const InputType* x_data, int64_t stride, size_t n_rows, uint64_t* bitvectors, Fn& fn) const;
+
+  static inline size_t LowestBit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return static_cast<size_t>(index);
+#else
+    return static_cast<size_t>(__builtin_ctzll(v));
+#endif
+  }
+
+  bool enabled_ = false;
+  bool less_ = false;
+  size_t n_features_ = 0;
+  size_t max_block_trees_ = 0;
+
+  std::vector<Block> blocks_;
+  // n_features_ + 1 offsets per block into thresholds_, trees_ and masks_.
+  std::vector<size_t> feature_offsets_;
+  std::vector<ThresholdType> thresholds_;
+  std::vector<uint32_t> trees_;  // tree index relative to the block
+  std::vector<uint64_t> masks_;
+  // Leaves of every tree in the bitvector order, tree j starts at leaf_offsets_[j].
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves_;
+  std::vector<size_t> leaf_offsets_;
+};
+
+template <typename ThresholdType>
+bool TreeEnsembleQuickScorer<ThresholdType>::AddTree(const TreeNodeElement<ThresholdType>* root, NODE_MODE mode,
+                                                     std::vector<Node>& nodes, std::vector<uint8_t>& visited,
+                                                     const TreeNodeElement<ThresholdType>* first_node) {
+  // Depth first, true branch first, so that the leaves of the true subtree of every node
+  // are the contiguous range [first_leaf, n_leaves) once the subtree is processed.
+  const size_t tree_first_leaf = leaves_.size();
+  struct Frame {
+    const TreeNodeElement<ThresholdType>* node;
+    size_t first_leaf;
+    bool true_done;
+  };
+  InlinedVector<Frame> stack;
+  stack.push_back({root, 0, false});
+  while (!stack.empty()) {
+    const Frame frame = stack.back();
+    const TreeNodeElement<ThresholdType>* node = frame.node;
+    const size_t n_leaves = leaves_.size() - tree_first_leaf;
+    if (frame.true_done) {
+      // The true subtree is done, its leaves are [frame.first_leaf, n_leaves).
+      const size_t count = n_leaves - frame.first_leaf;
+      const uint64_t range = (count == 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1)) << frame.first_leaf;
+      nodes.push_back({static_cast<int64_t>(node->feature_id), node->value_or_unique_weight, 0, ~range});
+      stack.back() = {node + 1, 0, false};
+      continue;
+    }
+
+    const size_t position = static_cast<size_t>(node - first_node);
+    if (visited[position]) {
+      // The node has two parents, the leaves can't be numbered.
+      return false;
+    }
+    visited[position] = 1;
+    if (node->is_not_leaf()) {
+      if (node->mode() != mode || node->is_missing_track_true()) {
+        return false;
+      }
+      stack.back() = {node, n_leaves, true};
+      stack.push_back({node->truenode_or_weight.ptr, 0, false});
+    } else {
+      if (n_leaves >= kMaxLeaves) {
+        return false;
+      }
+      leaves_.push_back(node);
+      stack.pop_back();
+    }
+  }
+  return true;
+}
+
+template <typename ThresholdType>
+bool TreeEnsembleQuickScorer<ThresholdType>::Init(const std::vector<TreeNodeElement<ThresholdType>>& all_nodes,
+                                                  const std::vector<TreeNodeElement<ThresholdType>*>& roots,
+                                                  int64_t n_features, NODE_MODE mode) {
+  enabled_ = false;
+  blocks_.clear();
+  feature_offsets_.clear();
+  thresholds_.clear();
+  trees_.clear();
+  masks_.clear();
+  leaves_.clear();
+  leaf_offsets_.clear();
+  max_block_trees_ = 0;
+
+  if (roots.empty() || (mode != NODE_MODE::BRANCH_LEQ && mode != NODE_MODE::BRANCH_LT)) {
+    return false;
+  }
+  less_ = mode == NODE_MODE::BRANCH_LT;
+  n_features_ = static_cast<size_t>(n_features);
+
+  std::vector<uint8_t> visited(all_nodes.size(), 0);
+  std::vector<Node> nodes;
+  std::vector<Node> block_nodes;
+  leaf_offsets_.reserve(roots.size());
+
+  // A tree which does not fit in the current block starts the next one.
+  bool pending = false;
+  size_t pending_bytes = 0;
+  size_t tree = 0;
+  while (tree < roots.size()) {
+    Block block{tree, 0, feature_offsets_.size()};
+    size_t block_bytes = 0;
+    block_nodes.clear();
+    while (tree < roots.size()) {
+      size_t tree_bytes = pending_bytes;
+      if (!pending) {
+        nodes.clear();
+        const size_t first_leaf = leaves_.size();
+        if (!AddTree(roots[tree], mode, nodes, visited, all_nodes.data())) {
+          return false;
+        }
+        leaf_offsets_.push_back(first_leaf);
+        tree_bytes = nodes.size() * (sizeof(ThresholdType) + sizeof(uint32_t) + sizeof(uint64_t)) +
+                     (leaves_.size() - first_leaf) * sizeof(void*) + kRows * sizeof(uint64_t);
+      }
+      if (block.n_trees > 0 && block_bytes + tree_bytes > kBlockBytes) {
+        pending = true;
+        pending_bytes = tree_bytes;
+        break;
+      }
+      pending = false;
+      for (auto& node : nodes) {
+        node.tree = static_cast<uint32_t>(block.n_trees);
+      }
+      block_nodes.insert(block_nodes.end(), nodes.begin(), nodes.end());
+      block_bytes += tree_bytes;
+      ++block.n_trees;
+      ++tree;
+    }
+
+    std::stable_sort(block_nodes.begin(), block_nodes.end(), [](const Node& a, const Node& b) {
+      return a.feature_id < b.feature_id || (a.feature_id == b.feature_id && a.threshold < b.threshold);
+    });
+    size_t position = 0;
+    for (size_t f = 0; f <= n_features_; ++f) {
+      feature_offsets_.push_back(thresholds_.size() + position);
+      while (position < block_nodes.size() && block_nodes[position].feature_id == static_cast<int64_t>(f)) {
+        ++position;
+      }
+    }
+    if (position != block_nodes.size()) {
+      // A feature id is negative or beyond n_features.
+      return false;
+    }
+    for (const auto& node : block_nodes) {
+      thresholds_.push_back(node.threshold);
+      trees_.push_back(node.tree);
+      masks_.push_back(node.mask);
+    }
+    max_block_trees_ = std::max(max_block_trees_, block.n_trees);
+    blocks_.push_back(block);
+  }
+
+  enabled_ = true;
+  return true;
+}
+
+template <typename ThresholdType>
+template <bool kLess, typename InputType, typename Fn>
+void TreeEnsembleQuickScorer<ThresholdType>::ComputeImpl(const InputType* x_data, int64_t stride, size_t n_rows,
+                                                         uint64_t* bitvectors, Fn& fn) const {
+  InputType x[kRows];
+  for (const Block& block : blocks_) {
+    std::fill(bitvectors, bitvectors + block.n_trees * kRows, ~uint64_t(0));
+    const size_t* offsets = feature_offsets_.data() + block.feature_offsets;
+
+    for (size_t f = 0; f < n_features_; ++f) {
+      const size_t begin = offsets[f];
+      const size_t end = offsets[f + 1];
+      if (begin == end) {
+        continue;
+      }
+      // Missing rows repeat the first one, their bitvectors are not read.
+      for (size_t r = 0; r < kRows; ++r) {
+        x[r] = x_data[(r < n_rows ? r : 0) * stride + f];
+      }
+      for (size_t k = begin; k < end; ++k) {
+        const ThresholdType threshold = thresholds_[k];
+        const uint64_t mask = masks_[k];
+        uint64_t* v = bitvectors + trees_[k] * kRows;
+        uint64_t any_false = 0;
+        for (size_t r = 0; r < kRows; ++r) {
+          // The node is false (the row goes to the false branch) when the condition does not hold,
+          // NaN included, and then the leaves of its true subtree are unreachable.
+          const uint64_t is_false = uint64_t(0) - static_cast<uint64_t>(kLess ? !(x[r] < threshold)
+                                                                              : !(x[r] <= threshold));
+          v[r] &= mask | ~is_false;
+          any_false |= is_false;
+        }
+        if (any_false == 0) {
+          // Thresholds are sorted, the condition holds for every row on the remaining nodes.
+          break;
+        }
+      }
+    }
+
+    const auto* const* leaves = leaves_.data();
+    for (size_t r = 0; r < n_rows; ++r) {
+      for (size_t j = 0; j < block.n_trees; ++j) {
+        fn(r, *leaves[leaf_offsets_[block.first_tree + j] + LowestBit(bitvectors[j * kRows + r])]);
+      }
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 /**
 https://github.com/onnx/onnx/blob/main/onnx/defs/traditionalml/defs.cc
@@ -35,6 +36,27 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
                                             DataTypeImpl::GetType<std::vector<std::map<std::int64_t, float>>>()}),
     ZipMapOp);
 
+namespace {
+// Returns the map with the keys of the rows and sets value_indices to the index of the input value of each key, in
+// key order. The last value of a duplicated key wins.
+template <typename TKey>
+std::map<TKey, float> MakeMapTemplate(const std::vector<TKey>& classlabels, std::vector<size_t>& value_indices) {
+  std::map<TKey, size_t> key_to_index;
+  for (size_t j = 0; j < classlabels.size(); ++j) {
+    key_to_index[classlabels[j]] = j;
+  }
+
+  std::map<TKey, float> map_template;
+  value_indices.reserve(key_to_index.size());
+  for (const auto& [key, index] : key_to_index) {
+    map_template.emplace_hint(map_template.end(), key, 0.f);
+    value_indices.push_back(index);
+  }
+
+  return map_template;
+}
+}  // namespace
+
 ZipMapOp::ZipMapOp(const OpKernelInfo& info)
     : OpKernel(info),
       classlabels_int64s_(info.GetAttrsOrDefault<int64_t>("classlabels_int64s")),
@@ -42,10 +64,16 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+  if (using_strings_) {
+    string_map_template_ = MakeMapTemplate(classlabels_strings_, value_indices_);
+  } else {
+    int64_map_template_ = MakeMapTemplate(classlabels_int64s_, value_indices_);
+  }
 }
 
-common::Status ZipMapOp::Compute(OpKernelContext* context) const {
-  const auto* tensor_pointer = context->Input<Tensor>(0);
+template <typename TKey>
+common::Status ZipMapOp::ComputeImpl(OpKernelContext& context, const std::map<TKey, float>& map_template) const {
+  const auto* tensor_pointer = context.Input<Tensor>(0);
   if (tensor_pointer == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
   const Tensor& X = *tensor_pointer;
   auto x_dims = X.Shape().GetDims();
@@ -65,51 +93,39 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
                   "Zipmap only supports 1D or 2D input tensors");
   }
 
+  const size_t num_classlabels = using_strings_ ? classlabels_strings_.size() : classlabels_int64s_.size();
+  if (features_per_batch != static_cast<int64_t>(num_classlabels)) {
+    return Status(ONNXRUNTIME,
+                  INVALID_ARGUMENT,
+                  "Input features_per_batch[" + std::to_string(features_per_batch) +
+                      "] != number of classlabels[" + std::to_string(num_classlabels) + "]");
+  }
+
+  auto* y_data = context.Output<std::vector<std::map<TKey, float>>>(0);
+  if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
+
   const auto* x_data = X.Data<float>();
+  y_data->resize(onnxruntime::narrow<size_t>(batch_size));
 
-  if (using_strings_) {
-    if (features_per_batch != static_cast<int64_t>(classlabels_strings_.size())) {
-      return Status(ONNXRUNTIME,
-                    INVALID_ARGUMENT,
-                    "Input features_per_batch[" + std::to_string(features_per_batch) +
-                        "] != number of classlabels[" + std::to_string(classlabels_strings_.size()) + "]");
-    }
-    auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
-    if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
+  // copying the template allocates the nodes of the map but does not compare any keys
+  concurrency::ThreadPool::TryBatchParallelFor(
+      context.GetOperatorThreadPool(), onnxruntime::narrow<std::ptrdiff_t>(batch_size),
+      [&](std::ptrdiff_t n) {
+        const float* row = x_data + n * features_per_batch;
+        auto& row_map = (*y_data)[onnxruntime::narrow<size_t>(n)];
+        row_map = map_template;
+        auto value_index = value_indices_.cbegin();
+        for (auto& entry : row_map) {
+          entry.second = row[*value_index++];
+        }
+      },
+      0);
 
-    // auto* y_data = Y->MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[onnxruntime::narrow<size_t>(j)]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[onnxruntime::narrow<size_t>(n)] = std::move(map1);
-    }
-  } else {
-    if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
-      return Status(ONNXRUNTIME,
-                    INVALID_ARGUMENT,
-                    "Input features_per_batch[" + std::to_string(features_per_batch) +
-                        "] != number of classlabels[" + std::to_string(classlabels_int64s_.size()) + "]");
-    }
-    auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
-    if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    // auto* y_data = Y->MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
-  }
   return common::Status::OK();
 }
+
+common::Status ZipMapOp::Compute(OpKernelContext* context) const {
+  return using_strings_ ? ComputeImpl(*context, string_map_template_) : ComputeImpl(*context, int64_map_template_);
+}
 }  // namespace ml
 }  // namespace onnxruntime
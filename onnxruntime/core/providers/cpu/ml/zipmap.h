@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <map>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 namespace onnxruntime {
@@ -13,9 +15,18 @@ class ZipMapOp final : public OpKernel {
   common::Status Compute(OpKernelContext* context) const override;
 
  private:
+  template <typename TKey>
+  common::Status ComputeImpl(OpKernelContext& context, const std::map<TKey, float>& map_template) const;
+
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+
+  // The maps of all the rows have the same keys. Each row copies this map, which has the keys and no values, and
+  // sets the values in key order from the input at value_indices_, so the keys are not compared for each row.
+  std::map<std::string, float> string_map_template_;
+  std::map<int64_t, float> int64_map_template_;
+  std::vector<size_t> value_indices_;
 };
 
 }  // namespace ml
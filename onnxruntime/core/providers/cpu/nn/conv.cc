@@ -19,11 +19,29 @@
 
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/providers/cpu/tunable/conv.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 using ConvPadVector = ConvAttributes::ConvPadVector;
 
+namespace {
+
+// Reorders the filter from (M x C/group x kernel_size) to (kernel_size x C/group x M), the layout
+// used by MlasConvNhwc.
+void ReorderFilterChannelsLast(const float* input, float* output, size_t output_channels,
+                               size_t input_channels, size_t kernel_size) {
+  for (size_t k = 0; k < kernel_size; k++) {
+    for (size_t ic = 0; ic < input_channels; ic++) {
+      for (size_t oc = 0; oc < output_channels; oc++) {
+        *output++ = input[(oc * input_channels + ic) * kernel_size + k];
+      }
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T>
 Status Conv<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -153,7 +171,162 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                           /*out*/ bool& is_packed,
+                           /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // Only the filter of a channels last convolution is reordered.
+  if (!channels_last_ || input_idx != 1) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() < 3) {
+    return Status::OK();
+  }
+
+  const size_t output_channels = narrow<size_t>(shape[0]);
+  const size_t group_input_channels = narrow<size_t>(shape[1]);
+  const size_t kernel_size = narrow<size_t>(shape.SizeFromDimension(2));
+
+  const size_t reordered_W_size = SafeInt<size_t>(sizeof(float)) * output_channels * group_input_channels * kernel_size;
+  auto* reordered_W = static_cast<float*>(alloc->Alloc(reordered_W_size));
+  reordered_W_buffer_ = BufferUniquePtr(reordered_W, BufferDeleter(alloc));
+
+  ReorderFilterChannelsLast(tensor.Data<float>(), reordered_W, output_channels, group_input_channels, kernel_size);
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(reordered_W_buffer_));
+    prepacked_weights->buffer_sizes_.push_back(reordered_W_size);
+  }
+
+  W_shape_ = shape;
+  is_packed = true;
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  used_shared_buffers = true;
+  reordered_W_buffer_ = std::move(prepacked_buffers[0]);
+  return Status::OK();
+}
+
+Status Conv<float>::ComputeChannelsLast(OpKernelContext* context) const {
+  size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = reordered_W_buffer_ ? nullptr : context->Input<Tensor>(1);
+  const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
+  const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
+  const TensorShape& W_shape = W != nullptr ? W->Shape() : W_shape_;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape, true));
+
+  const size_t rank = X->Shape().NumDimensions();
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[rank - 1];
+  const int64_t M = W_shape[0];
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
+
+  const size_t kernel_rank = kernel_shape.size();
+  if (kernel_rank < 1 || kernel_rank > 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "Channels last convolution only supports 1D, 2D and 3D kernels, got rank ", kernel_rank);
+  }
+
+  ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_rank * 2, 0);
+  }
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_rank, 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_rank, 1);
+  }
+
+  TensorShapeVector Y_dims({N});
+  TensorShape input_shape = X->Shape().Slice(1, rank - 1);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
+  Y_dims.push_back(M);
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(1, rank - 1);
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  float* Ydata = Y->MutableData<float>();
+  // Check for the optional Conv/Sum fusion.
+  float Beta = 0.0f;
+  if (Sum != nullptr) {
+    ORT_RETURN_IF_NOT(Y->Shape() == Sum->Shape(), "output and sum shape must match");
+    // If the output was not allocated inplace with the sum tensor, then copy here.
+    if (Ydata != Sum->Data<float>()) {
+      gsl::copy(Sum->DataAsSpan<float>(), Y->MutableDataAsSpan<float>());
+    }
+    Beta = 1.0f;
+  }
+
+  // Reorder the filter here when it is not a constant initializer.
+  const float* filter_data = static_cast<const float*>(reordered_W_buffer_.get());
+  BufferUniquePtr reordered_W;
+  if (filter_data == nullptr) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    auto* reordered = static_cast<float*>(alloc->Alloc(SafeInt<size_t>(sizeof(float)) * W_shape.Size()));
+    reordered_W = BufferUniquePtr(reordered, BufferDeleter(std::move(alloc)));
+    ReorderFilterChannelsLast(W->Data<float>(), reordered, narrow<size_t>(M), narrow<size_t>(W_shape[1]),
+                              narrow<size_t>(W_shape.SizeFromDimension(2)));
+    filter_data = reordered;
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  MLAS_CONV_PARAMETERS Parameters;
+  size_t WorkingBufferSize;
+  MlasConvPrepare(&Parameters,
+                  kernel_rank,
+                  narrow<size_t>(N),
+                  narrow<size_t>(conv_attrs_.group),
+                  narrow<size_t>(C / conv_attrs_.group),
+                  input_shape.GetDims().data(),
+                  kernel_shape.data(),
+                  dilations.data(),
+                  pads.data(),
+                  strides.data(),
+                  output_shape.GetDims().data(),
+                  narrow<size_t>(M / conv_attrs_.group),
+                  &activation_,
+                  &WorkingBufferSize,
+                  Beta,
+                  thread_pool);
+
+  MlasConvNhwc(&Parameters,
+               X->Data<float>(),
+               filter_data,
+               B != nullptr ? B->Data<float>() : nullptr,
+               Ydata,
+               thread_pool);
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
+  if (channels_last_) {
+    return ComputeChannelsLast(context);
+  }
+
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
   const Tensor* W = context->Input<Tensor>(1);
@@ -214,6 +387,32 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
   if (kernel_rank >= 1 && kernel_rank <= 3) {
+    if (auto* tuning_ctx = cpu::tunable::GetEnabledTuningContext(*this); tuning_ctx != nullptr) {
+      cpu::tunable::ConvParams params;
+      params.tuning_ctx = tuning_ctx;
+      params.dimensions = kernel_rank;
+      params.batch_count = narrow<size_t>(N);
+      params.group_count = narrow<size_t>(conv_attrs_.group);
+      params.input_channels = narrow<size_t>(C / conv_attrs_.group);
+      params.input_shape = input_shape.GetDims().data();
+      params.kernel_shape = kernel_shape.data();
+      params.dilation_shape = dilations.data();
+      params.padding = pads.data();
+      params.stride_shape = strides.data();
+      params.output_shape = output_shape.GetDims().data();
+      params.filter_count = narrow<size_t>(M / conv_attrs_.group);
+      params.activation = &activation_;
+      params.beta = Beta;
+      params.use_winograd = use_winograd_;
+      params.x = Xdata.data();
+      params.w = W->Data<float>();
+      params.b = Bdata;
+      params.y = Ydata.data();
+      params.allocator = alloc;
+      params.thread_pool = thread_pool;
+      return cpu::tunable::Conv(&params);
+    }
+
     MLAS_CONV_PARAMETERS Parameters;
     size_t WorkingBufferSize;
     MlasConvPrepare(&Parameters,
@@ -233,6 +432,12 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     Beta,
                     thread_pool);
 
+    // Winograd is only considered when enabled in the session options, MLAS keeps the algorithm
+    // selected above when the shape would not benefit from it.
+    if (use_winograd_) {
+      MlasConvWinogradPrepare(&Parameters, &WorkingBufferSize, thread_pool);
+    }
+
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -21,19 +22,38 @@ class Conv : public OpKernel {
   ConvAttributes conv_attrs_;
 };
 
+// Also implements ms.NhwcFusedConv through FusedConvFloat, in which case the input and output
+// tensors are channels last and the filter is reordered to (kH x kW x C/group) x M.
 template <>
 class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    channels_last_ = (info.GetKernelDef().OpName() == "NhwcFusedConv");
+    use_winograd_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasConvWinograd, "0") == "1";
   }
 
   Status Compute(OpKernelContext* context) const override;
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  Status ComputeChannelsLast(OpKernelContext* context) const;
+
+  bool channels_last_{false};
+  bool use_winograd_{false};
+  TensorShape W_shape_;
+  BufferUniquePtr reordered_W_buffer_;
 };
 
 }  // namespace onnxruntime
@@ -271,23 +271,41 @@ Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dyna
           thread_pool);
 
       if (p.X->Shape().NumDimensions() == 4) {
-        math::Col2im<float, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            p.num_output_channels / conv_transpose_attrs_.group,
-            p.Y->Shape()[2],
-            p.Y->Shape()[3],
-            p.kernel_shape[0],
-            p.kernel_shape[1],
-            p.dilations[0],
-            p.dilations[1],
-            p.pads[0],
-            p.pads[1],
-            p.pads[2],
-            p.pads[3],
-            p.strides[0],
-            p.strides[1],
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
+        // The output channels only accumulate their own rows of the col buffer, so they are scattered in parallel
+        // and the bias is added to each channel while it is still in cache.
+        const int64_t group_output_channels = p.num_output_channels / conv_transpose_attrs_.group;
+        const int64_t col_channel_size = kernel_size * input_image_size;
+        const float* group_bias_data = p.B != nullptr ? p.B->Data<float>() + group_id * group_output_channels
+                                                      : nullptr;
+        float* group_Ydata = Ydata + group_id * Y_offset;
+        concurrency::ThreadPool::TryParallelFor(
+            thread_pool, onnxruntime::narrow<ptrdiff_t>(group_output_channels),
+            static_cast<double>(col_channel_size + output_size),
+            [&](ptrdiff_t begin, ptrdiff_t end) {
+              math::Col2im<float, CPUMathUtil, StorageOrder::NCHW>(
+                  col_buffer_data + begin * col_channel_size,
+                  end - begin,
+                  p.Y->Shape()[2],
+                  p.Y->Shape()[3],
+                  p.kernel_shape[0],
+                  p.kernel_shape[1],
+                  p.dilations[0],
+                  p.dilations[1],
+                  p.pads[0],
+                  p.pads[1],
+                  p.pads[2],
+                  p.pads[3],
+                  p.strides[0],
+                  p.strides[1],
+                  group_Ydata + begin * output_size,
+                  &CPUMathUtil::Instance());
+              if (group_bias_data != nullptr) {
+                for (ptrdiff_t c = begin; c < end; ++c) {
+                  EigenVectorArrayMap<float>(group_Ydata + c * output_size, onnxruntime::narrow<size_t>(output_size)) +=
+                      group_bias_data[c];
+                }
+              }
+            });
       } else {
         math::Col2imNd<float, CPUMathUtil, StorageOrder::NCHW>(
             col_buffer_data,
@@ -305,7 +323,7 @@ Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dyna
       }
     }
 
-    if (p.B != nullptr) {
+    if (p.B != nullptr && p.X->Shape().NumDimensions() != 4) {
       auto Ymatrix = EigenMatrixMap<float>(Ydata, onnxruntime::narrow<size_t>(output_size), onnxruntime::narrow<size_t>(p.num_output_channels));
       auto Bvec = ConstEigenVectorMap<float>(p.B->Data<float>(), onnxruntime::narrow<size_t>(p.num_output_channels));
       Ymatrix.rowwise() += Bvec.transpose();
@@ -3,8 +3,11 @@
 
 #include "layer_norm_impl.h"
 
+#include <type_traits>
+
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -55,9 +58,6 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
     }
   }
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
-
   int output_index = 1;
 
   U* mean_data = nullptr;
@@ -74,47 +74,110 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
     inv_std_dev_data = inv_std_dev->MutableData<U>();
   }
 
-  concurrency::ThreadPool::TryBatchParallelFor(
-      p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
-      [&](ptrdiff_t task_idx) {
-        const T* p_input = X_data + task_idx * norm_size;
-        T* p_output = Y_data + task_idx * norm_size;
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, MLFloat16>) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
+
+    // fp16 tensors are converted to fp32 once, and every row is normalized in place in fp32.
+    const float* input_data = nullptr;
+    const float* scale_float_data = nullptr;
+    const float* bias_float_data = nullptr;
+    float* output_data = nullptr;
+    IAllocatorUniquePtr<float> buffer;
+    if constexpr (std::is_same_v<T, float>) {
+      input_data = X_data;
+      scale_float_data = scale_data;
+      bias_float_data = bias_data;
+      output_data = Y_data;
+    } else {
+      const size_t x_size = SafeInt<size_t>(x_shape.Size());
+      const size_t bias_float_size = bias_data != nullptr ? static_cast<size_t>(norm_size) : 0;
+      buffer = IAllocator::MakeUniquePtr<float>(alloc, x_size + static_cast<size_t>(norm_size) + bias_float_size);
+      float* x_float_data = buffer.get();
+      float* scale_buffer = x_float_data + x_size;
+      MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(X_data), x_float_data, x_size);
+      MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(scale_data), scale_buffer,
+                                   static_cast<size_t>(norm_size));
+      if (bias_data != nullptr) {
+        MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(bias_data), scale_buffer + norm_size,
+                                     static_cast<size_t>(norm_size));
+        bias_float_data = scale_buffer + norm_size;
+      }
+
+      input_data = x_float_data;
+      scale_float_data = scale_buffer;
+      output_data = x_float_data;
+    }
 
-        T mean = 0;
-        T mean_square = 0;
+    concurrency::ThreadPool::TryBatchParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
+        [&](ptrdiff_t task_idx) {
+          float mean = 0.0f;
+          float inv_std_dev = 0.0f;
+          float* p_output = output_data + task_idx * norm_size;
+          MlasLayerNormalization(input_data + task_idx * norm_size, nullptr, nullptr, scale_float_data,
+                                 bias_float_data, p_output, nullptr, static_cast<size_t>(norm_size), epsilon,
+                                 simplified, &mean, &inv_std_dev);
+
+          if constexpr (std::is_same_v<T, MLFloat16>) {
+            T* p_y = Y_data + task_idx * norm_size;
+            for (int64_t h = 0; h < norm_size; h++) {
+              p_y[h] = MLFloat16(p_output[h]);
+            }
+          }
 
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
+          if (mean_data != nullptr) {
+            mean_data[task_idx] = static_cast<U>(mean);
+          }
 
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
-        } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-        }
+          if (inv_std_dev_data != nullptr) {
+            inv_std_dev_data[task_idx] = static_cast<U>(inv_std_dev);
+          }
+        },
+        0);
+  } else {
+    concurrency::ThreadPool::TryBatchParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
+        [&](ptrdiff_t task_idx) {
+          const T* p_input = X_data + task_idx * norm_size;
+          T* p_output = Y_data + task_idx * norm_size;
+
+          T mean = 0;
+          T mean_square = 0;
+
+          for (int64_t h = 0; h < norm_size; h++) {
+            mean += p_input[h];
+            mean_square += p_input[h] * p_input[h];
+          }
 
-        for (int64_t h = 0; h < norm_size; h++) {
+          mean = mean / norm_size;
           if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            mean_square = sqrt(mean_square / norm_size + epsilon);
           } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+          }
+
+          for (int64_t h = 0; h < norm_size; h++) {
+            if (simplified) {
+              p_output[h] = p_input[h] / mean_square * scale_data[h];
+            } else if (nullptr == bias) {
+              p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            } else {
+              p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            }
           }
-        }
 
-        if (mean_data != nullptr) {
-          // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-          mean_data[task_idx] = gsl::narrow_cast<U>(mean);
-        }
+          if (mean_data != nullptr) {
+            // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
+            mean_data[task_idx] = gsl::narrow_cast<U>(mean);
+          }
 
-        if (inv_std_dev_data != nullptr) {
-          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
-        }
-      },
-      0);
+          if (inv_std_dev_data != nullptr) {
+            inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
+          }
+        },
+        0);
+  }
 
   return Status::OK();
 }
@@ -122,10 +185,10 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
 template <typename T>
 struct SrcDispatcher {
   Status operator()(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, bool simplified, bool contrib_op) const {
-    // the contrib op kernel was always registered with the same type for all constraints.
-    // our implementation of the onnx op only supports 'float' as the U constraint.
+    // the contrib op kernel was always registered with the same type for all constraints, except for fp16 which
+    // uses 'float' for U. our implementation of the onnx op only supports 'float' as the U constraint.
 #if !defined(DISABLE_CONTRIB_OPS)
-    if (contrib_op) {
+    if (contrib_op && !std::is_same_v<T, MLFloat16>) {
       return ComputeImpl<T, T>(p_ctx, orig_axis, epsilon, simplified);
     } else
 #else
@@ -141,7 +204,7 @@ struct SrcDispatcher {
 Status LayerNormImpl::Compute(OpKernelContext* p_ctx) const {
   const auto elem_type = p_ctx->Input<Tensor>(0)->GetElementType();
 
-  using SupportedTypeList = boost::mp11::mp_list<float, double>;
+  using SupportedTypeList = boost::mp11::mp_list<float, double, MLFloat16>;
 
   utils::MLTypeCallDispatcherFromTypeList<SupportedTypeList> t_disp(elem_type);
   return t_disp.InvokeRet<Status, SrcDispatcher>(p_ctx, axis_, epsilon_, simplified_, contrib_op_);
@@ -13,10 +13,13 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
-#include <queue>
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <vector>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +121,108 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+struct BoxInfoPtr {
+  float score_{};
+  int64_t index_{};
+
+  BoxInfoPtr() = default;
+  explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+  inline bool operator<(const BoxInfoPtr& rhs) const {
+    return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  }
+};
+
+// The corners and areas of boxes as a struct of arrays, so that the IOU of a box with many boxes is computed in a
+// loop the compiler vectorizes.
+struct BoxCorners {
+  // boxes are compared a block at a time, and the selected boxes are padded to a whole block with empty boxes
+  static constexpr size_t kBlockSize = 16;
+
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  void Resize(size_t size) {
+    x_min.resize(size);
+    y_min.resize(size);
+    x_max.resize(size);
+    y_max.resize(size);
+    area.resize(size);
+  }
+
+  // Sets the corners of box `i` from `box`, computed as nms_helpers::SuppressByIOU does.
+  void Set(size_t i, const float* box, int64_t center_point_box) {
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], x_min[i], x_max[i]);
+      MaxMin(box[0], box[2], y_min[i], y_max[i]);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min[i] = box[0] - width_half;
+      x_max[i] = box[0] + width_half;
+      y_min[i] = box[1] - height_half;
+      y_max[i] = box[1] + height_half;
+    }
+    area[i] = (x_max[i] - x_min[i]) * (y_max[i] - y_min[i]);
+  }
+
+  void Copy(size_t i, const BoxCorners& other, size_t other_i) {
+    x_min[i] = other.x_min[other_i];
+    y_min[i] = other.y_min[other_i];
+    x_max[i] = other.x_max[other_i];
+    y_max[i] = other.y_max[other_i];
+    area[i] = other.area[other_i];
+  }
+};
+
+// Returns whether the IOU of box `i` of `boxes` with any of the `num_selected` boxes of `selected` exceeds
+// iou_threshold, with the same result as nms_helpers::SuppressByIOU. `selected` must be padded to whole blocks with
+// boxes of area 0, which never suppress.
+bool SuppressBySelected(const BoxCorners& boxes, size_t i, const BoxCorners& selected, size_t num_selected,
+                        float iou_threshold) {
+  const float x_min = boxes.x_min[i];
+  const float y_min = boxes.y_min[i];
+  const float x_max = boxes.x_max[i];
+  const float y_max = boxes.y_max[i];
+  const float area = boxes.area[i];
+  if (area <= .0f) {
+    return false;
+  }
+
+  for (size_t block = 0; block < num_selected; block += BoxCorners::kBlockSize) {
+    // all the conditions are evaluated without branches so the loop is vectorized
+    int suppressed = 0;
+    for (size_t j = block; j < block + BoxCorners::kBlockSize; ++j) {
+      const float other_x_min = selected.x_min[j];
+      const float other_y_min = selected.y_min[j];
+      const float other_x_max = selected.x_max[j];
+      const float other_y_max = selected.y_max[j];
+      const float other_area = selected.area[j];
+
+      const float width = std::min(x_max, other_x_max) - std::max(x_min, other_x_min);
+      const float height = std::min(y_max, other_y_max) - std::max(y_min, other_y_min);
+      const float intersection_area = width * height;
+      const float union_area = area + other_area - intersection_area;
+      suppressed += (width > .0f) & (height > .0f) & (intersection_area > .0f) & (other_area > .0f) &
+                    (union_area > .0f) & (intersection_area / union_area > iou_threshold);
+    }
+
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -135,33 +240,39 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
+  const auto center_point_box = GetCenterPointBox();
+  const size_t num_boxes = static_cast<size_t>(pc.num_boxes_);
+  const size_t max_selected = std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), num_boxes);
 
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
-
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  // the corners of the boxes of each batch are computed once for all the classes
+  std::vector<BoxCorners> batch_corners(narrow<size_t>(pc.num_batches_));
+  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
+    BoxCorners& corners = batch_corners[narrow<size_t>(batch_index)];
+    const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
+    corners.Resize(num_boxes);
+    for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+      corners.Set(box_index, batch_boxes + box_index * 4, center_point_box);
     }
-  };
+  }
 
-  const auto center_point_box = GetCenterPointBox();
+  // the boxes selected for each class of each batch, which are independent so they are processed in parallel
+  const std::ptrdiff_t num_batch_classes = narrow<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<int64_t>> selected_indices_per_class(narrow<size_t>(num_batch_classes));
 
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
+  auto select_boxes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<BoxInfoPtr> candidate_boxes;
+    candidate_boxes.reserve(num_boxes);
+    BoxCorners selected_corners;
+    selected_corners.Resize(max_selected + BoxCorners::kBlockSize);
 
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
+    for (std::ptrdiff_t batch_class = first; batch_class < last; ++batch_class) {
+      const int64_t batch_index = batch_class / pc.num_classes_;
+      const BoxCorners& corners = batch_corners[narrow<size_t>(batch_index)];
+      std::vector<int64_t>& selected_indices = selected_indices_per_class[narrow<size_t>(batch_class)];
 
       // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
+      candidate_boxes.clear();
+      const auto* class_scores = scores_data + batch_class * pc.num_boxes_;
       if (pc.score_threshold_ != nullptr) {
         for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
           if (*class_scores > score_threshold) {
@@ -173,37 +284,51 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
           candidate_boxes.emplace_back(*class_scores, box_index);
         }
       }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
+      std::make_heap(candidate_boxes.begin(), candidate_boxes.end());
 
-      selected_boxes_inside_class.clear();
       // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
+      auto candidates_end = candidate_boxes.end();
+      while (candidates_end != candidate_boxes.begin() && selected_indices.size() < max_selected) {
+        std::pop_heap(candidate_boxes.begin(), candidates_end);
+        --candidates_end;
+        const BoxInfoPtr& next_top_score = *candidates_end;
+        const size_t box_index = static_cast<size_t>(next_top_score.index_);
 
-        bool selected = true;
         // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+        const size_t num_selected = selected_indices.size();
+        if (!SuppressBySelected(corners, box_index, selected_corners, num_selected, iou_threshold)) {
+          selected_corners.Copy(num_selected, corners, box_index);
+          if (num_selected % BoxCorners::kBlockSize == 0) {
+            // the boxes after the last selected one in its block are compared as well, so they must be empty
+            std::fill_n(selected_corners.area.begin() + num_selected + 1, BoxCorners::kBlockSize - 1, .0f);
           }
+          selected_indices.push_back(next_top_score.index_);
         }
+      }
+    }
+  };
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-        sorted_boxes.pop();
-      }  // while
-    }    // for class_index
-  }      // for batch_index
+  const double cost_per_class = static_cast<double>(num_boxes) * 4;
+  concurrency::ThreadPool::TryParallelFor(ctx->GetOperatorThreadPool(), num_batch_classes,
+                                          TensorOpCost{static_cast<double>(num_boxes * sizeof(float)), 0,
+                                                       cost_per_class * std::log2(std::max<double>(num_boxes, 2))},
+                                          select_boxes);
+
+  size_t num_selected = 0;
+  for (const auto& selected_indices : selected_indices_per_class) {
+    num_selected += selected_indices.size();
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+  for (std::ptrdiff_t batch_class = 0; batch_class < num_batch_classes; ++batch_class) {
+    for (int64_t box_index : selected_indices_per_class[narrow<size_t>(batch_class)]) {
+      *output_data++ = SelectedIndex(batch_class / pc.num_classes_, batch_class % pc.num_classes_, box_index);
+    }
+  }
 
   return Status::OK();
 }
@@ -163,11 +163,21 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
   int64_t pooled_height = output_shape[2];
   int64_t pooled_width = output_shape[3];
 
+  // Split the channels of each roi into blocks so that a few rois with many channels still keep all the threads
+  // busy. The indices and weights of a roi are shared by all its channels, so each block computes them once.
+  const int64_t target_num_blocks = static_cast<int64_t>(ThreadPool::DegreeOfParallelism(ttp)) * 4;
+  const int64_t min_blocks_per_roi = (target_num_blocks + n_rois - 1) / std::max<int64_t>(n_rois, 1);
+  const int64_t blocks_per_roi = std::clamp<int64_t>(min_blocks_per_roi, 1, std::max<int64_t>(channels, 1));
+  const int64_t channels_per_block = (channels + blocks_per_roi - 1) / blocks_per_roi;
+
   // 100 is a random chosed value, need be tuned
-  double cost = static_cast<double>(channels * pooled_width * pooled_height * 100);
+  double cost = static_cast<double>(channels_per_block * pooled_width * pooled_height * 100);
 
-  ThreadPool::TryParallelFor(ttp, static_cast<ptrdiff_t>(n_rois), cost, [&](ptrdiff_t n, ptrdiff_t end) {
-    for (; n != end; ++n) {
+  ThreadPool::TryParallelFor(ttp, static_cast<ptrdiff_t>(n_rois * blocks_per_roi), cost, [&](ptrdiff_t block, ptrdiff_t end) {
+    for (; block != end; ++block) {
+      const int64_t n = block / blocks_per_roi;
+      const int64_t c_begin = (block % blocks_per_roi) * channels_per_block;
+      const int64_t c_end = std::min(c_begin + channels_per_block, channels);
       int64_t index_n = n * channels * pooled_width * pooled_height;
 
       const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
@@ -206,7 +216,7 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
                                     roi_start_h, roi_start_w, bin_size_h, bin_size_w, roi_bin_grid_h,
                                     roi_bin_grid_w, pre_calc);
 
-      for (int64_t c = 0; c < channels; c++) {
+      for (int64_t c = c_begin; c < c_end; c++) {
         int64_t index_n_c = index_n + c * pooled_width * pooled_height;
         const T* offset_bottom_data =
             bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
@@ -253,7 +263,7 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
           }  // for pw
         }    // for ph
       }      // for c
-    }        // for n
+    }        // for block
   });
 }
 }  // namespace
@@ -117,7 +117,7 @@ Status MatMulInteger::Compute(OpKernelContext* ctx) const {
     gemm_params.ldc = gemm_shape.N;
     gemm_params.BIsPacked = bool(packed_b_);
     gemm_params.A = a_data + helper.LeftOffsets()[batch];
-    gemm_params.B = b_data + helper.RightOffsets()[batch];
+    gemm_params.B = b ? b_data + helper.RightOffsets()[batch] : PackedBAt(helper.RightOffsets()[batch]);
     gemm_params.C = y_data + helper.OutputOffsets()[batch];
   }
   MlasGemmBatch(gemm_shape, gemm_data_vec.data(), batch_size, ctx->GetOperatorThreadPool());
@@ -20,20 +20,23 @@ class MatMulIntegerBase : public OpKernel {
 
     // only pack Matrix B
     if (input_idx == GetBIdx()) {
-      // Only handle the common case of a 2D weight matrix. Additional matrices
-      // could be handled by stacking the packed buffers.
+      // A batch of weight matrices is packed matrix by matrix, the packed matrices follow each other.
       b_shape_ = tensor.Shape();
-      if (b_shape_.NumDimensions() != 2) {
+      const size_t rank = b_shape_.NumDimensions();
+      if (rank < 2 || (rank > 2 && IsBTransposed()) || b_shape_.Size() == 0) {
         return Status::OK();
       }
 
       auto a_elem_type = Node().InputDefs()[GetAIdx()]->TypeAsProto()->tensor_type().elem_type();
       bool a_is_signed = ONNX_NAMESPACE::TensorProto_DataType_INT8 == a_elem_type;
+      b_packed_for_16bit_a_ = ONNX_NAMESPACE::TensorProto_DataType_INT16 == a_elem_type ||
+                              ONNX_NAMESPACE::TensorProto_DataType_UINT16 == a_elem_type;
 
       b_is_signed_ = tensor.IsDataType<int8_t>();
 
-      size_t K = static_cast<size_t>(b_shape_[0]);
-      size_t N = static_cast<size_t>(b_shape_[1]);
+      size_t K = static_cast<size_t>(b_shape_[rank - 2]);
+      size_t N = static_cast<size_t>(b_shape_[rank - 1]);
+      const size_t batch_count = static_cast<size_t>(b_shape_.SizeToDimension(rank - 2));
 
       const auto* b_data = static_cast<const uint8_t*>(tensor.DataRaw());
 
@@ -42,17 +45,31 @@ class MatMulIntegerBase : public OpKernel {
         std::swap(K, N);
         b_data = quantization::TransPoseInputData(b_data, b_trans_buffer, alloc, N, K);
       }
-      const size_t packed_b_size = MlasGemmPackBSize(N, K, a_is_signed, b_is_signed_);
-      if (packed_b_size == 0) {
+      packed_b_matrix_size_ = b_packed_for_16bit_a_ ? MlasGemmInt16x8PackBSize(N, K)
+                                                     : MlasGemmPackBSize(N, K, a_is_signed, b_is_signed_);
+      if (packed_b_matrix_size_ == 0) {
         return Status::OK();
       }
 
+      // keep each packed matrix aligned
+      const size_t alignment = MlasGetPreferredBufferAlignment();
+      packed_b_matrix_size_ = (packed_b_matrix_size_ + alignment - 1) / alignment * alignment;
+      const size_t packed_b_size = SafeInt<size_t>(packed_b_matrix_size_) * batch_count;
+      b_matrix_size_ = K * N;
+
       packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
       // Initialize memory to 0 as there could be some padding associated with pre-packed
       // buffer memory and we don not want it uninitialized and generate different hashes
       // if and when we try to cache this pre-packed buffer for sharing between sessions.
       memset(packed_b_.get(), 0, packed_b_size);
-      MlasGemmPackB(N, K, b_data, N, a_is_signed, b_is_signed_, packed_b_.get());
+      for (size_t i = 0; i < batch_count; i++) {
+        auto* packed_matrix = static_cast<uint8_t*>(packed_b_.get()) + i * packed_b_matrix_size_;
+        if (b_packed_for_16bit_a_) {
+          MlasGemmInt16x8PackB(N, K, b_data + i * b_matrix_size_, N, b_is_signed_, packed_matrix);
+        } else {
+          MlasGemmPackB(N, K, b_data + i * b_matrix_size_, N, a_is_signed, b_is_signed_, packed_matrix);
+        }
+      }
 
       bool share_prepacked_weights = (prepacked_weights != nullptr);
       if (share_prepacked_weights) {
@@ -79,6 +96,11 @@ class MatMulIntegerBase : public OpKernel {
   }
 
  protected:
+  // Returns the packed matrix of B read by a GEMM at right_offset, see MatMulComputeHelper::RightOffsets().
+  const uint8_t* PackedBAt(size_t right_offset) const {
+    return static_cast<const uint8_t*>(packed_b_.get()) + right_offset / b_matrix_size_ * packed_b_matrix_size_;
+  }
+
   /**
    * @return input index of Matrix B, the weight tensor
    */
@@ -125,8 +147,13 @@ class MatMulIntegerBase : public OpKernel {
   }
 
   bool b_is_signed_{true};
+  // B is packed by MlasGemmInt16x8PackB for a 16-bit A, by MlasGemmPackB otherwise
+  bool b_packed_for_16bit_a_{false};
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // elements of each matrix of B and bytes between its packed matrices
+  size_t b_matrix_size_{0};
+  size_t packed_b_matrix_size_{0};
 };
 
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "core/framework/float8.h"
 #include "core/framework/float16.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/util/qmath.h"
@@ -77,6 +78,23 @@ static void PrepareForQDQ(const TensorShape& input_shape,
   }
 }
 
+// Calls fn(channel, begin, end) in parallel over the flattened tensor of block_count * broadcast_dim blocks of
+// block_size values, where [begin, end) is a range of a single block of the given channel.
+// Splitting the flattened tensor rather than each block keeps all threads busy whatever the block size.
+template <typename Fn>
+static void ParallelForChannelRanges(concurrency::ThreadPool* tp, int64_t block_count, int64_t broadcast_dim,
+                                     int64_t block_size, const TensorOpCost& unit_cost, const Fn& fn) {
+  const std::ptrdiff_t total_size = SafeInt<std::ptrdiff_t>(block_count) * broadcast_dim * block_size;
+  concurrency::ThreadPool::TryParallelFor(tp, total_size, unit_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    while (first < last) {
+      const std::ptrdiff_t block = first / block_size;
+      const std::ptrdiff_t end = std::min(last, (block + 1) * block_size);
+      fn(static_cast<size_t>(block % broadcast_dim), first, end);
+      first = end;
+    }
+  });
+}
+
 #define REGISTER_DEQUANTIZELINEAR(T)                                         \
   ONNX_CPU_OPERATOR_TYPED_KERNEL(                                            \
       DequantizeLinear,                                                      \
@@ -175,34 +193,25 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 
 template <typename T, typename OutT>
 struct DequantizeLinearApply {
-  void op(int64_t N, int64_t broadcast_dim, int64_t block_size, const T* input, const OutT* scale, OutT* output, const T* zero_point) {
-    for (size_t n = 0; n < static_cast<size_t>(N); n++) {
-      for (size_t bd = 0; bd < static_cast<size_t>(broadcast_dim); bd++) {
-        auto zp = zero_point ? static_cast<int32_t>(zero_point[bd]) : 0;
-        auto sc = static_cast<float>(scale[bd]);
-        for (size_t bs = 0; bs < static_cast<size_t>(block_size); bs++) {
-          *output++ = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(*input++) - zp) * sc);
-        }
-      }
+  // Dequantizes count values sharing the same scale and zero point.
+  void op(const T* input, OutT* output, size_t count, float scale, T zero_point) {
+    const auto zp = static_cast<int32_t>(zero_point);
+    for (size_t i = 0; i < count; i++) {
+      output[i] = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(input[i]) - zp) * scale);
     }
   }
 };
 
 #if !defined(DISABLE_FLOAT8_TYPES)
 
-#define DEQUANTIZE_LINEAR_APPLY_FLOAT8(T)                                                                                      \
-  template <typename OutT>                                                                                                     \
-  struct DequantizeLinearApply<T, OutT> {                                                                                      \
-    void op(int64_t N, int64_t broadcast_dim, int64_t block_size, const T* input, const OutT* scale, OutT* output, const T*) { \
-      for (size_t n = 0; n < static_cast<size_t>(N); n++) {                                                                    \
-        for (size_t bd = 0; bd < static_cast<size_t>(broadcast_dim); bd++) {                                                   \
-          auto sc = scale[bd];                                                                                                 \
-          for (size_t bs = 0; bs < static_cast<size_t>(block_size); bs++, input++) {                                           \
-            *output++ = static_cast<OutT>(input->ToFloat() * sc);                                                              \
-          }                                                                                                                    \
-        }                                                                                                                      \
-      }                                                                                                                        \
-    }                                                                                                                          \
+#define DEQUANTIZE_LINEAR_APPLY_FLOAT8(T)                                      \
+  template <typename OutT>                                                     \
+  struct DequantizeLinearApply<T, OutT> {                                      \
+    void op(const T* input, OutT* output, size_t count, float scale, T) {      \
+      for (size_t i = 0; i < count; i++) {                                     \
+        output[i] = static_cast<OutT>(input[i].ToFloat() * scale);             \
+      }                                                                        \
+    }                                                                          \
   };
 
 DEQUANTIZE_LINEAR_APPLY_FLOAT8(Float8E4M3FN)
@@ -244,15 +253,26 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
 
   const auto to = x_scale.GetElementType();
   const T* input = x.Data<T>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
 
   if (to == ONNX_NAMESPACE::TensorProto::FLOAT) {
     const float* scale = x_scale.Data<float>();
     float* output = y.MutableData<float>();
-    DequantizeLinearApply<T, float>().op(N, broadcast_dim, block_size, input, scale, output, zero_point);
+    ParallelForChannelRanges(
+        tp, N, broadcast_dim, block_size, TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(float)), 2.0},
+        [&](size_t bd, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          DequantizeLinearApply<T, float>().op(input + begin, output + begin, static_cast<size_t>(end - begin),
+                                               scale[bd], zero_point ? zero_point[bd] : T{});
+        });
   } else if (to == ONNX_NAMESPACE::TensorProto::FLOAT16) {
     const MLFloat16* scale = x_scale.Data<MLFloat16>();
     MLFloat16* output = y.MutableData<MLFloat16>();
-    DequantizeLinearApply<T, MLFloat16>().op(N, broadcast_dim, block_size, input, scale, output, zero_point);
+    ParallelForChannelRanges(
+        tp, N, broadcast_dim, block_size, TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(MLFloat16)), 2.0},
+        [&](size_t bd, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          DequantizeLinearApply<T, MLFloat16>().op(input + begin, output + begin, static_cast<size_t>(end - begin),
+                                                   scale[bd].ToFloat(), zero_point ? zero_point[bd] : T{});
+        });
   } else if (to == ONNX_NAMESPACE::TensorProto::BFLOAT16) {
     ORT_THROW("DequantizeLinear into BFLOAT16 is not implemented yet.");
   } else {
@@ -373,13 +393,18 @@ void ParQuantizeLinear(const InputType* Input,
 
 template <typename T, typename InT>
 void ComputeLoop(OpKernelContext* ctx, const InT* input, const InT* scale, const T* zero_point, T* output, int64_t N, int64_t broadcast_dim, int64_t block_size, bool saturate) {
-  for (size_t n = 0; n < static_cast<size_t>(N); n++) {
-    for (size_t bd = 0; bd < static_cast<size_t>(broadcast_dim); bd++) {
-      ParQuantizeLinear(input, output, static_cast<size_t>(block_size), scale[bd], bd, zero_point, saturate, ctx->GetOperatorThreadPool());
-      input += block_size;
-      output += block_size;
-    }
+  if (N * broadcast_dim == 1) {
+    ParQuantizeLinear(input, output, static_cast<size_t>(block_size), scale[0], 0, zero_point, saturate, ctx->GetOperatorThreadPool());
+    return;
   }
+
+  // per-channel: each thread quantizes a range of the channel blocks instead of every block being split on its own
+  ParallelForChannelRanges(
+      ctx->GetOperatorThreadPool(), N, broadcast_dim, block_size, TensorOpCost{static_cast<double>(sizeof(InT)), static_cast<double>(sizeof(T)), 2.0},
+      [&](size_t bd, std::ptrdiff_t begin, std::ptrdiff_t end) {
+        ParQuantizeLinear(input + begin, output + begin, static_cast<size_t>(end - begin), scale[bd], bd, zero_point,
+                          saturate, nullptr);
+      });
 }
 
 // formula is Y = X / Scale + ZeroPoint
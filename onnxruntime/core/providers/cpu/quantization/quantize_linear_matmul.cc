@@ -124,7 +124,7 @@ Status QLinearMatMul::Compute(OpKernelContext* ctx) const {
     gemm_params[i].lda = gemm_shape.K;
     gemm_params[i].ZeroPointA = *(static_cast<const uint8_t*>(a_offset->DataRaw()));
 
-    gemm_params[i].B = b_data + helper.RightOffsets()[i];
+    gemm_params[i].B = b ? b_data + helper.RightOffsets()[i] : PackedBAt(helper.RightOffsets()[i]);
     gemm_params[i].ldb = gemm_shape.N;
     gemm_params[i].BIsPacked = bool(packed_b_);
     gemm_params[i].ZeroPointB = b_zp_data + helper.RightZeroPointOffsets()[i];
@@ -349,6 +349,32 @@ void ReduceAggregatorBase::FastReduceRKR(const Tensor&, const gsl::span<const in
   ValidateMustBeOverloaded();
 }
 
+void MlasFastReduce(MLAS_REDUCE_KIND reduce_kind, FastReduceKind fast_kind, const Tensor& input,
+                    const gsl::span<const int64_t>& fast_shape, Tensor& output, concurrency::ThreadPool* tp) {
+  size_t outer_count, reduce_count, inner_count;
+  switch (fast_kind) {
+    case FastReduceKind::kKR:
+      outer_count = onnxruntime::narrow<size_t>(fast_shape[0]);
+      reduce_count = onnxruntime::narrow<size_t>(fast_shape[1]);
+      inner_count = 1;
+      break;
+    case FastReduceKind::kRK:
+      outer_count = 1;
+      reduce_count = onnxruntime::narrow<size_t>(fast_shape[0]);
+      inner_count = onnxruntime::narrow<size_t>(fast_shape[1]);
+      break;
+    case FastReduceKind::kKRK:
+      outer_count = onnxruntime::narrow<size_t>(fast_shape[0]);
+      reduce_count = onnxruntime::narrow<size_t>(fast_shape[1]);
+      inner_count = onnxruntime::narrow<size_t>(fast_shape[2]);
+      break;
+    default:
+      ORT_THROW("Unexpected fast reduction kind ", static_cast<int>(fast_kind), " for MLAS.");
+  }
+  MlasReduce(reduce_kind, input.Data<float>(), output.MutableData<float>(),
+             outer_count, reduce_count, inner_count, tp);
+}
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  gsl::span<const int64_t> reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results) {
@@ -751,6 +777,7 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
                             TensorShapeVector& output_shape,
                             TensorShapeVector& fast_axes,
                             FastReduceKind which_fast_reduce,
+                            bool fast_reduce_all_sizes,
                             fast_reduce_fct* case_kr,
                             fast_reduce_fct* case_rk,
                             fast_reduce_fct* case_krk,
@@ -779,9 +806,10 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
         }
         case FastReduceKind::kRK: {
           ValidateFastReduceRK(fast_shape, *output);
-          if ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
-              (std::max(fast_shape[0], fast_shape[1]) >
-               concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256)) {
+          if (fast_reduce_all_sizes ||
+              ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
+               (std::max(fast_shape[0], fast_shape[1]) >
+                concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256))) {
             // See benchmarks in PR #7719.
             case_rk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
@@ -791,7 +819,8 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
         }
         case FastReduceKind::kKRK:
           ValidateFastReduceKRK(fast_shape, *output);
-          if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
+          if (fast_reduce_all_sizes ||
+              fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
             // See benchmarks in PR #7719.
             case_krk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
@@ -829,7 +858,7 @@ bool CommonFastReduce(OpKernelContext* ctx,
                       TensorShapeVector& fast_axes) {
   return CommonFastReduceSwitch(ctx, axes_, keepdims_, noop_with_empty_axes,
                                 fast_kind, fast_shape, output_shape, fast_axes,
-                                AGG::WhichFastReduce(), &AGG::FastReduceKR, &AGG::FastReduceRK,
+                                AGG::WhichFastReduce(), AGG::FastReduceAllSizes(), &AGG::FastReduceKR, &AGG::FastReduceRK,
                                 &AGG::FastReduceKRK, &AGG::FastReduceRKR);
 }
 
@@ -1051,8 +1080,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
       }
       case FastReduceKind::kRK:
         ValidateFastReduceRK(fast_shape, *output);
-        if (std::max(fast_shape[0], fast_shape[1]) >
-            concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
+        if (ReduceAggregatorSum<T>::FastReduceAllSizes() ||
+            std::max(fast_shape[0], fast_shape[1]) > concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
           // See benchmarks in PR #7719.
           ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, *output, tp);
           return output;
@@ -1061,7 +1090,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
         }
       case FastReduceKind::kKRK:
         ValidateFastReduceKRK(fast_shape, *output);
-        if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
+        if (ReduceAggregatorSum<T>::FastReduceAllSizes() ||
+            fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
           // See benchmarks in PR #7719.
           ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, *output, tp);
           return output;
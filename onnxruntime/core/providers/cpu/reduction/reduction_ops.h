@@ -12,6 +12,7 @@
 #include "core/util/math.h"
 #endif
 #include "core/framework/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/reduction/reduction_kernel_base.h"
@@ -70,6 +71,11 @@ FastReduceKind OptimizeShapeForFastReduce(gsl::span<const int64_t> input_shape,
                                           TensorShapeVector& fast_axes,
                                           bool keep_dims, bool noop_with_empty_axes = false);
 
+/* Runs a fast reduction of a float tensor with MLAS, fast_kind must be kKR, kRK or kKRK.
+   MLAS processes the strided cases without index tables. */
+void MlasFastReduce(MLAS_REDUCE_KIND reduce_kind, FastReduceKind fast_kind, const Tensor& input,
+                    const gsl::span<const int64_t>& fast_shape, Tensor& output, concurrency::ThreadPool* tp);
+
 class ResultsNoTransposePrepareForReduce {
  public:
   TensorShapeVector input_shape;
@@ -155,6 +161,8 @@ class ReduceAggregatorBase {
  public:
   // Fast reduction: see OptimizeShapeForFastReduce's comment.
   static inline FastReduceKind WhichFastReduce() { return FastReduceKind::kNone; }
+  // Tells if FastReduceRK and FastReduceKRK are faster than the generic implementation whatever the shape is.
+  static inline bool FastReduceAllSizes() { return false; }
   static void FastReduceKR(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceKRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
@@ -229,8 +237,14 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
 
+  static inline bool FastReduceAllSizes() { return std::is_same_v<T, float>; }
+
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceSum, FastReduceKind::kKR, input, fast_shape, output, tp);
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -245,6 +259,10 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceSum, FastReduceKind::kRK, input, fast_shape, output, tp);
+      return;
+    }
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
@@ -263,6 +281,10 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceSum, FastReduceKind::kKRK, input, fast_shape, output, tp);
+      return;
+    }
     int64_t N = fast_shape[2];
     const T* data = input.Data<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
@@ -300,6 +322,30 @@ class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction, only implemented by MLAS for float.
+  static constexpr bool kIsFloat = std::is_same_v<T, float> && std::is_same_v<TVAL, float>;
+
+  static inline FastReduceKind WhichFastReduce() {
+    return kIsFloat ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK : FastReduceKind::kNone;
+  }
+
+  static inline bool FastReduceAllSizes() { return kIsFloat; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceSumSquare, FastReduceKind::kKR, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceSumSquare, FastReduceKind::kRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceSumSquare, FastReduceKind::kKRK, input, fast_shape, output, tp);
+  }
 };
 
 template <typename T>
@@ -319,6 +365,10 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMean, FastReduceKind::kKR, input, fast_shape, output, tp);
+      return;
+    }
     ReduceAggregatorSum<T>::FastReduceKR(input, fast_shape, output, tp);
     // TODO: use MLAS or BLAS
     T* out = output.MutableData<T>();
@@ -330,6 +380,10 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMean, FastReduceKind::kRK, input, fast_shape, output, tp);
+      return;
+    }
     ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, output, tp);
     // TODO: use MLAS or BLAS
     T* out = output.MutableData<T>();
@@ -341,6 +395,10 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMean, FastReduceKind::kKRK, input, fast_shape, output, tp);
+      return;
+    }
     ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, output, tp);
     int64_t strideo = fast_shape[2];
     T* out = output.MutableData<T>();
@@ -389,8 +447,14 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
 
+  static inline bool FastReduceAllSizes() { return std::is_same_v<T, float>; }
+
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMaximum, FastReduceKind::kKR, input, fast_shape, output, tp);
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -415,6 +479,10 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMaximum, FastReduceKind::kRK, input, fast_shape, output, tp);
+      return;
+    }
     int64_t n_rows = fast_shape[0];
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
@@ -441,6 +509,10 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMaximum, FastReduceKind::kKRK, input, fast_shape, output, tp);
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
@@ -599,8 +671,14 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
 
+  static inline bool FastReduceAllSizes() { return std::is_same_v<T, float>; }
+
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMinimum, FastReduceKind::kKR, input, fast_shape, output, tp);
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -625,6 +703,10 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMinimum, FastReduceKind::kRK, input, fast_shape, output, tp);
+      return;
+    }
     int64_t n_rows = fast_shape[0];
     int64_t N = fast_shape[1];
     const T* data = input.Data<T>();
@@ -651,6 +733,10 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (std::is_same_v<T, float>) {
+      MlasFastReduce(MlasReduceMinimum, FastReduceKind::kKRK, input, fast_shape, output, tp);
+      return;
+    }
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1] * fast_shape[2];
@@ -734,6 +820,29 @@ class ReduceAggregatorL2 : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction, only implemented by MLAS for float.
+  static inline FastReduceKind WhichFastReduce() {
+    return std::is_same_v<T, float> ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK
+                                   : FastReduceKind::kNone;
+  }
+
+  static inline bool FastReduceAllSizes() { return std::is_same_v<T, float>; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceL2, FastReduceKind::kKR, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceL2, FastReduceKind::kRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceL2, FastReduceKind::kKRK, input, fast_shape, output, tp);
+  }
 };
 
 template <typename T>
@@ -774,6 +883,29 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Fast reduction, only implemented by MLAS for float.
+  static inline FastReduceKind WhichFastReduce() {
+    return std::is_same_v<T, float> ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK
+                                   : FastReduceKind::kNone;
+  }
+
+  static inline bool FastReduceAllSizes() { return std::is_same_v<T, float>; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceLogSumExp, FastReduceKind::kKR, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceLogSumExp, FastReduceKind::kRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    MlasFastReduce(MlasReduceLogSumExp, FastReduceKind::kKRK, input, fast_shape, output, tp);
+  }
 };
 
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
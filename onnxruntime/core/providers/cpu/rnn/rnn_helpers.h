@@ -286,6 +286,18 @@ inline void ComputeGemm(const int M,
               thread_pool);
 }
 
+// Whether the two directions of a bidirectional RNN should run concurrently, each on a single thread, instead of
+// one after the other on all the threads. The steps of a direction run in order, so when there are too few rows to
+// split the batch and the GEMM of the hidden state of a step is too small for MLAS to split it across more than a few
+// threads, e.g. when streaming with a batch of 1, a direction barely uses more than one thread anyway.
+inline bool RunDirectionsConcurrently(const concurrency::ThreadPool* thread_pool, int batch_size, int hidden_size,
+                                      int num_gates) {
+  // MLAS gives each thread of a GEMM at least 64K multiply-adds
+  constexpr int64_t kMaxStepGemmSize = 4 * 64 * 1024;
+  return concurrency::ThreadPool::DegreeOfParallelism(thread_pool) >= 2 && batch_size <= 2 &&
+         SafeInt<int64_t>(batch_size) * num_gates * hidden_size * hidden_size < kMaxStepGemmSize;
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
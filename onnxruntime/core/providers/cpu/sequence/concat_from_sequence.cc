@@ -17,6 +17,19 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes()),
     ConcatFromSequence);
 
+namespace {
+bool InputsAreContiguous(const Prepare& p) {
+  for (size_t i = 1; i < p.inputs.size(); ++i) {
+    const auto& previous = *p.inputs[i - 1].tensor;
+    if (static_cast<const char*>(previous.DataRaw()) + previous.SizeInBytes() != p.inputs[i].tensor->DataRaw()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+}  // namespace
+
 // core Compute() method for the 'ConcatFromSequence' kernel
 Status ConcatFromSequence::Compute(OpKernelContext* ctx) const {
   const auto* X = ctx->Input<TensorSeq>(0);
@@ -39,6 +52,14 @@ Status ConcatFromSequence::Compute(OpKernelContext* ctx) const {
   if (p.output_num_elements == 0)
     return Status::OK();
 
+  // The output is the inputs back to back if there is a single block before the concat axis. If the inputs are also
+  // back to back in memory, which is the case for the elements produced by SplitToSequence along that axis,
+  // they can be copied with a single memcpy.
+  if (!p.is_string_type && p.output_num_elements == p.output_axis_pitch && InputsAreContiguous(p)) {
+    memcpy(p.output_tensor->MutableDataRaw(), p.inputs[0].tensor->DataRaw(), p.output_tensor->SizeInBytes());
+    return Status::OK();
+  }
+
   // Compute values to be placed in the output tensor
   return ComputeImpl(p, ctx);
 }
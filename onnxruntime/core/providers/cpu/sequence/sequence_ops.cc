@@ -487,9 +487,21 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
   tseq->SetType(input.DataType());
   tseq->Reserve(static_cast<size_t>(num_outputs));
 
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
+
+  // the elements of non-string types are views into a single buffer that holds all of them back to back, so the
+  // split costs one allocation and ConcatFromSequence can copy them back with a single memcpy.
+  // the buffer is released with the last element that refers to it.
+  std::shared_ptr<char> elements_buffer;
+  if (!is_string_type) {
+    elements_buffer = IAllocator::MakeUniquePtr<char>(alloc, input.SizeInBytes());
+  }
+
   // copy dimensions so we can update the selected axis in place
   auto output_dimensions = input_shape.AsShapeVector();
   SafeInt<size_t> input_offset = 0;
+  SafeInt<size_t> output_offset = 0;  // offset of the output tensor in elements_buffer
   const void* input_data = input.DataRaw();
   for (int i = 0; i < num_outputs; ++i) {
     // update size of dimension for axis we're splitting on while considering uneven split
@@ -501,10 +513,31 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
     }
     output_dimensions[onnxruntime::narrow<size_t>(axis)] = split_size;
 
-    AllocatorPtr alloc;
-    ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
-    Tensor output_tensor(input.DataType(), onnxruntime::TensorShape(output_dimensions), alloc);
-    void* output_data = output_tensor.MutableDataRaw();
+    // if keep_dims = 0, the output tensor drops the dimension corresponding to 'axis'
+    TensorShapeVector output_tensor_dims;
+    if (use_keep_dims && keepdims_ == 0) {
+      output_tensor_dims.reserve(output_dimensions.size() - 1);
+      for (int64_t idx = 0, end = static_cast<int64_t>(output_dimensions.size()); idx < end; ++idx) {
+        if (idx != axis) {
+          output_tensor_dims.push_back(output_dimensions[onnxruntime::narrow<size_t>(idx)]);
+        }
+      }
+    } else {
+      output_tensor_dims = output_dimensions;
+    }
+
+    OrtValue output_value;
+    if (is_string_type) {
+      Tensor::InitOrtValue(input.DataType(), onnxruntime::TensorShape(output_tensor_dims), alloc, output_value);
+    } else {
+      auto p_tensor = std::make_unique<Tensor>(input.DataType(), onnxruntime::TensorShape(output_tensor_dims),
+                                               elements_buffer.get() + static_cast<size_t>(output_offset * element_size),
+                                               alloc->Info());
+      output_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                        [elements_buffer](void* p) { delete static_cast<Tensor*>(p); });
+    }
+
+    void* output_data = output_value.GetMutable<Tensor>()->MutableDataRaw();
 
     const auto M = before_dims;
     const auto* A = static_cast<const char*>(input_data) + static_cast<size_t>(input_offset * element_size);
@@ -548,21 +581,10 @@ Status SplitToSequence::ComputeImpl(OpKernelContext& context, const Tensor& inpu
     }
 
     input_offset += SafeInt<size_t>(split_size) * after_dims_excluding_split;  // offset by the N data we used in this iteration
-
-    // if keep_dims = 0, reshape the tensor by dropping the dimension corresponding to 'axis'
-    if (use_keep_dims && keepdims_ == 0) {
-      TensorShapeVector new_dims;
-      new_dims.reserve(output_dimensions.size() - 1);
-      for (int64_t idx = 0, end = static_cast<int64_t>(output_dimensions.size()); idx < end; ++idx) {
-        if (idx != axis) {
-          new_dims.push_back(output_dimensions[onnxruntime::narrow<size_t>(idx)]);
-        }
-      }
-      output_tensor.Reshape(new_dims);
-    }
+    output_offset += SafeInt<size_t>(M) * N;
 
     // finally move the resulting tensor to the output sequence
-    tseq->Add(std::move(output_tensor));
+    tseq->Add(std::move(output_value));
   }
 
   return Status::OK();
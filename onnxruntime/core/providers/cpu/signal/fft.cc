@@ -0,0 +1,476 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/signal/fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace signal {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Largest prime factor transformed by a pass, larger ones use Bluestein's algorithm.
+constexpr size_t kMaxRadix = 13;
+
+// Plans of this many sizes are cached per type, which covers the sizes a model transforms. The cache is cleared when
+// it is full, e.g. when dft_length changes with every run.
+constexpr size_t kMaxCachedPlans = 64;
+
+template <typename Plan>
+std::shared_ptr<const Plan> GetCachedPlan(size_t size) {
+  static OrtMutex mutex;
+  static std::unordered_map<size_t, std::shared_ptr<const Plan>> plans;
+  {
+    std::lock_guard<OrtMutex> lock(mutex);
+    auto it = plans.find(size);
+    if (it != plans.end()) {
+      return it->second;
+    }
+  }
+
+  // created without the lock, as a plan can get the plans it uses
+  auto plan = std::make_shared<const Plan>(size);
+  std::lock_guard<OrtMutex> lock(mutex);
+  if (plans.size() >= kMaxCachedPlans) {
+    plans.clear();
+  }
+  // keeps the plan of a thread that created it at the same time
+  return plans.emplace(size, std::move(plan)).first->second;
+}
+
+template <typename T>
+std::complex<T> UnitRoot(uint64_t numerator, uint64_t denominator) {
+  const double angle = -2 * kPi * static_cast<double>(numerator % denominator) / static_cast<double>(denominator);
+  return std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+}
+
+// The passes work on this instead of std::complex, whose operator* handles infinities and NaNs with a library call
+// and whose arithmetic the compilers do not vectorize, so that the loops over the contiguous elements of a pass are
+// vectorized. It has the layout of std::complex.
+template <typename T>
+struct Complex {
+  T re;
+  T im;
+};
+
+template <typename T>
+inline Complex<T> operator+(const Complex<T>& a, const Complex<T>& b) {
+  return {a.re + b.re, a.im + b.im};
+}
+
+template <typename T>
+inline Complex<T> operator-(const Complex<T>& a, const Complex<T>& b) {
+  return {a.re - b.re, a.im - b.im};
+}
+
+template <typename T>
+inline Complex<T> operator*(const Complex<T>& a, T b) {
+  return {a.re * b, a.im * b};
+}
+
+template <typename T>
+inline Complex<T> Conj(const Complex<T>& a) {
+  return {a.re, -a.im};
+}
+
+template <typename T>
+inline Complex<T>* AsComplex(std::complex<T>* data) {
+  return reinterpret_cast<Complex<T>*>(data);
+}
+
+template <typename T>
+inline const Complex<T>* AsComplex(const std::complex<T>* data) {
+  return reinterpret_cast<const Complex<T>*>(data);
+}
+
+// a * w for the forward transform, a * conj(w) for the inverse one.
+template <bool inverse, typename T>
+inline Complex<T> Rotate(const Complex<T>& a, const Complex<T>& w) {
+  if constexpr (inverse) {
+    return {a.re * w.re + a.im * w.im, a.im * w.re - a.re * w.im};
+  } else {
+    return {a.re * w.re - a.im * w.im, a.re * w.im + a.im * w.re};
+  }
+}
+
+// a * -i for the forward transform, a * i for the inverse one.
+template <bool inverse, typename T>
+inline Complex<T> RotateQuarter(const Complex<T>& a) {
+  if constexpr (inverse) {
+    return {-a.im, a.re};
+  } else {
+    return {a.im, -a.re};
+  }
+}
+
+// The transforms of size radix, y_j = sum_m x_m exp(-+2 pi i j m / radix).
+template <size_t radix, bool inverse, typename T>
+struct Butterfly;
+
+template <bool inverse, typename T>
+struct Butterfly<2, inverse, T> {
+  static void Run(const Complex<T>* x, Complex<T>* y) {
+    y[0] = x[0] + x[1];
+    y[1] = x[0] - x[1];
+  }
+};
+
+template <bool inverse, typename T>
+struct Butterfly<3, inverse, T> {
+  static void Run(const Complex<T>* x, Complex<T>* y) {
+    constexpr T kSin60 = static_cast<T>(0.866025403784438646763723170752936183);
+    const Complex<T> sum = x[1] + x[2];
+    const Complex<T> middle = x[0] - sum * static_cast<T>(0.5);
+    const Complex<T> difference = RotateQuarter<inverse>(x[1] - x[2]) * kSin60;
+    y[0] = x[0] + sum;
+    y[1] = middle + difference;
+    y[2] = middle - difference;
+  }
+};
+
+template <bool inverse, typename T>
+struct Butterfly<4, inverse, T> {
+  static void Run(const Complex<T>* x, Complex<T>* y) {
+    const Complex<T> t0 = x[0] + x[2];
+    const Complex<T> t1 = x[0] - x[2];
+    const Complex<T> t2 = x[1] + x[3];
+    const Complex<T> t3 = RotateQuarter<inverse>(x[1] - x[3]);
+    y[0] = t0 + t2;
+    y[1] = t1 + t3;
+    y[2] = t0 - t2;
+    y[3] = t1 - t3;
+  }
+};
+
+template <bool inverse, typename T>
+struct Butterfly<5, inverse, T> {
+  static void Run(const Complex<T>* x, Complex<T>* y) {
+    constexpr T kCos72 = static_cast<T>(0.309016994374947424102293417182819059);
+    constexpr T kCos144 = static_cast<T>(-0.809016994374947424102293417182819059);
+    constexpr T kSin72 = static_cast<T>(0.951056516295153572116439333379382143);
+    constexpr T kSin144 = static_cast<T>(0.587785252292473129168705954639072769);
+    const Complex<T> t1 = x[1] + x[4];
+    const Complex<T> t2 = x[2] + x[3];
+    const Complex<T> t3 = x[1] - x[4];
+    const Complex<T> t4 = x[2] - x[3];
+    const Complex<T> a1 = x[0] + t1 * kCos72 + t2 * kCos144;
+    const Complex<T> a2 = x[0] + t1 * kCos144 + t2 * kCos72;
+    const Complex<T> b1 = RotateQuarter<inverse>(t3 * kSin72 + t4 * kSin144);
+    const Complex<T> b2 = RotateQuarter<inverse>(t3 * kSin144 - t4 * kSin72);
+    y[0] = x[0] + t1 + t2;
+    y[1] = a1 + b1;
+    y[2] = a2 + b2;
+    y[3] = a2 - b2;
+    y[4] = a1 - b1;
+  }
+};
+
+// A Stockham pass, with the input viewed as [l1][radix][ido] and the output as [radix][l1][ido]. The inner loop runs
+// over contiguous elements.
+template <size_t radix, bool inverse, typename T>
+void RunPass(size_t l1, size_t ido, const Complex<T>* __restrict input, Complex<T>* __restrict output,
+             const Complex<T>* __restrict twiddles) {
+  Complex<T> x[radix];
+  Complex<T> y[radix];
+  if (ido == 1) {
+    // the last pass, without twiddles
+    for (size_t k = 0; k < l1; ++k) {
+      for (size_t m = 0; m < radix; ++m) {
+        x[m] = input[m + radix * k];
+      }
+      Butterfly<radix, inverse, T>::Run(x, y);
+      for (size_t j = 0; j < radix; ++j) {
+        output[k + l1 * j] = y[j];
+      }
+    }
+    return;
+  }
+
+  for (size_t k = 0; k < l1; ++k) {
+    for (size_t i = 0; i < ido; ++i) {
+      for (size_t m = 0; m < radix; ++m) {
+        x[m] = input[i + ido * (m + radix * k)];
+      }
+      Butterfly<radix, inverse, T>::Run(x, y);
+      output[i + ido * k] = y[0];
+      for (size_t j = 1; j < radix; ++j) {
+        output[i + ido * (k + l1 * j)] = Rotate<inverse>(y[j], twiddles[(j - 1) * ido + i]);
+      }
+    }
+  }
+}
+
+// A pass of a prime radix above 5, which computes its butterflies directly with the roots of unity.
+template <bool inverse, typename T>
+void RunGenericPass(size_t radix, size_t l1, size_t ido, const Complex<T>* __restrict input,
+                    Complex<T>* __restrict output, const Complex<T>* __restrict twiddles,
+                    const Complex<T>* __restrict roots) {
+  Complex<T> x[kMaxRadix];
+  for (size_t k = 0; k < l1; ++k) {
+    for (size_t i = 0; i < ido; ++i) {
+      for (size_t m = 0; m < radix; ++m) {
+        x[m] = input[i + ido * (m + radix * k)];
+      }
+      for (size_t j = 0; j < radix; ++j) {
+        Complex<T> sum = x[0];
+        size_t root = 0;
+        for (size_t m = 1; m < radix; ++m) {
+          root += j;
+          if (root >= radix) {
+            root -= radix;
+          }
+          sum = sum + Rotate<inverse>(x[m], roots[root]);
+        }
+        output[i + ido * (k + l1 * j)] = j == 0 ? sum : Rotate<inverse>(sum, twiddles[(j - 1) * ido + i]);
+      }
+    }
+  }
+}
+
+// Smallest size of at least `size` with no prime factor above 5.
+size_t NextFastSize(size_t size) {
+  for (size_t candidate = size;; ++candidate) {
+    size_t remainder = candidate;
+    for (size_t factor : {2, 3, 5}) {
+      while (remainder % factor == 0) {
+        remainder /= factor;
+      }
+    }
+    if (remainder == 1) {
+      return candidate;
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+std::shared_ptr<const FftPlan<T>> FftPlan<T>::Get(size_t size) {
+  return GetCachedPlan<FftPlan<T>>(size);
+}
+
+template <typename T>
+FftPlan<T>::FftPlan(size_t size) : size_(size) {
+  ORT_ENFORCE(size > 0, "The size of a DFT must be positive.");
+
+  InlinedVector<size_t> radices;
+  size_t remainder = size;
+  while (remainder % 4 == 0) {
+    radices.push_back(4);
+    remainder /= 4;
+  }
+  for (size_t radix = 2; radix <= kMaxRadix; ++radix) {
+    while (remainder % radix == 0) {
+      radices.push_back(radix);
+      remainder /= radix;
+    }
+  }
+
+  if (remainder != 1) {
+    // a prime factor above kMaxRadix. the transform is a convolution with a chirp, done with a plan of a fast size:
+    // X_k = w_k sum_n (x_n w_n) conj(w_(k - n)) with w_k = exp(-pi i k^2 / size)
+    const size_t bluestein_size = NextFastSize(2 * size - 1);
+    bluestein_plan_ = FftPlan::Get(bluestein_size);
+    scratch_size_ = bluestein_size + bluestein_plan_->ScratchSize();
+
+    chirp_.resize(size);
+    for (size_t k = 0; k < size; ++k) {
+      // k^2 is taken modulo 2 * size to keep the angle accurate
+      chirp_[k] = UnitRoot<T>(static_cast<uint64_t>(k) * k, 2 * static_cast<uint64_t>(size));
+    }
+
+    bluestein_filter_.assign(bluestein_size, std::complex<T>());
+    bluestein_filter_[0] = std::conj(chirp_[0]);
+    for (size_t k = 1; k < size; ++k) {
+      bluestein_filter_[k] = bluestein_filter_[bluestein_size - k] = std::conj(chirp_[k]);
+    }
+    std::vector<std::complex<T>> scratch(bluestein_plan_->ScratchSize());
+    bluestein_plan_->Transform(bluestein_filter_.data(), scratch.data(), false);
+    const T scale = static_cast<T>(1) / static_cast<T>(bluestein_size);
+    for (auto& value : bluestein_filter_) {
+      value *= scale;
+    }
+    return;
+  }
+
+  size_t l1 = 1;
+  for (size_t radix : radices) {
+    const size_t ido = size / (l1 * radix);
+    Pass pass{radix, l1, ido, twiddles_.size(), 0};
+    for (size_t j = 1; j < radix; ++j) {
+      for (size_t i = 0; i < ido; ++i) {
+        twiddles_.push_back(UnitRoot<T>(static_cast<uint64_t>(j) * l1 * i, size));
+      }
+    }
+    passes_.push_back(pass);
+    l1 *= radix;
+  }
+
+  for (auto& pass : passes_) {
+    if (pass.radix > 5) {
+      pass.root_offset = twiddles_.size();
+      for (size_t q = 0; q < pass.radix; ++q) {
+        twiddles_.push_back(UnitRoot<T>(q, pass.radix));
+      }
+    }
+  }
+
+  scratch_size_ = passes_.empty() ? 0 : size;
+}
+
+template <typename T>
+template <bool inverse>
+void FftPlan<T>::RunPasses(std::complex<T>* data, std::complex<T>* scratch) const {
+  Complex<T>* input = AsComplex(data);
+  Complex<T>* output = AsComplex(scratch);
+  for (const auto& pass : passes_) {
+    const Complex<T>* twiddles = AsComplex(twiddles_.data() + pass.twiddle_offset);
+    switch (pass.radix) {
+      case 2:
+        RunPass<2, inverse>(pass.l1, pass.ido, input, output, twiddles);
+        break;
+      case 3:
+        RunPass<3, inverse>(pass.l1, pass.ido, input, output, twiddles);
+        break;
+      case 4:
+        RunPass<4, inverse>(pass.l1, pass.ido, input, output, twiddles);
+        break;
+      case 5:
+        RunPass<5, inverse>(pass.l1, pass.ido, input, output, twiddles);
+        break;
+      default:
+        RunGenericPass<inverse>(pass.radix, pass.l1, pass.ido, input, output, twiddles,
+                                AsComplex(twiddles_.data() + pass.root_offset));
+        break;
+    }
+    std::swap(input, output);
+  }
+
+  if (input != AsComplex(data)) {
+    std::copy(input, input + size_, AsComplex(data));
+  }
+}
+
+template <typename T>
+void FftPlan<T>::TransformBluestein(std::complex<T>* data, std::complex<T>* scratch) const {
+  const size_t bluestein_size = bluestein_plan_->Size();
+  Complex<T>* values = AsComplex(data);
+  Complex<T>* convolution = AsComplex(scratch);
+  const Complex<T>* chirp = AsComplex(chirp_.data());
+  const Complex<T>* filter = AsComplex(bluestein_filter_.data());
+
+  for (size_t k = 0; k < size_; ++k) {
+    convolution[k] = Rotate<false>(values[k], chirp[k]);
+  }
+  std::fill(convolution + size_, convolution + bluestein_size, Complex<T>{0, 0});
+
+  bluestein_plan_->Transform(scratch, scratch + bluestein_size, false);
+  for (size_t k = 0; k < bluestein_size; ++k) {
+    convolution[k] = Rotate<false>(convolution[k], filter[k]);
+  }
+  bluestein_plan_->Transform(scratch, scratch + bluestein_size, true);
+
+  for (size_t k = 0; k < size_; ++k) {
+    values[k] = Rotate<false>(convolution[k], chirp[k]);
+  }
+}
+
+template <typename T>
+void FftPlan<T>::Transform(std::complex<T>* data, std::complex<T>* scratch, bool inverse) const {
+  if (bluestein_plan_) {
+    // the inverse transform is the conjugate of the forward transform of the conjugate
+    Complex<T>* values = AsComplex(data);
+    if (inverse) {
+      std::transform(values, values + size_, values, Conj<T>);
+    }
+    TransformBluestein(data, scratch);
+    if (inverse) {
+      std::transform(values, values + size_, values, Conj<T>);
+    }
+  } else if (inverse) {
+    RunPasses<true>(data, scratch);
+  } else {
+    RunPasses<false>(data, scratch);
+  }
+}
+
+template <typename T>
+std::shared_ptr<const RealFftPlan<T>> RealFftPlan<T>::Get(size_t size) {
+  return GetCachedPlan<RealFftPlan<T>>(size);
+}
+
+template <typename T>
+RealFftPlan<T>::RealFftPlan(size_t size) : size_(size) {
+  ORT_ENFORCE(size > 0, "The size of a DFT must be positive.");
+  if (size % 2 == 0) {
+    plan_ = FftPlan<T>::Get(size / 2);
+    twiddles_.resize(size / 2 + 1);
+    for (size_t k = 0; k <= size / 2; ++k) {
+      twiddles_[k] = UnitRoot<T>(k, size);
+    }
+  } else {
+    plan_ = FftPlan<T>::Get(size);
+  }
+}
+
+template <typename T>
+size_t RealFftPlan<T>::ScratchSize() const {
+  return size_ % 2 == 0 ? plan_->ScratchSize() : size_ + plan_->ScratchSize();
+}
+
+template <typename T>
+void RealFftPlan<T>::Transform(const T* input, std::complex<T>* output, std::complex<T>* scratch) const {
+  if (size_ % 2 != 0) {
+    std::complex<T>* data = scratch;
+    for (size_t n = 0; n < size_; ++n) {
+      data[n] = std::complex<T>(input[n], 0);
+    }
+    plan_->Transform(data, scratch + size_, false);
+    std::copy(data, data + size_ / 2 + 1, output);
+    return;
+  }
+
+  // the even and odd samples are transformed as the real and imaginary parts of a signal of half the size:
+  // z_m = x_2m + i x_2m+1, and X_k = (Z_k + conj(Z_h-k)) / 2 - i exp(-2 pi i k / size) (Z_k - conj(Z_h-k)) / 2
+  const size_t half = size_ / 2;
+  for (size_t m = 0; m < half; ++m) {
+    output[m] = std::complex<T>(input[2 * m], input[2 * m + 1]);
+  }
+  plan_->Transform(output, scratch, false);
+
+  Complex<T>* values = AsComplex(output);
+  const Complex<T>* twiddles = AsComplex(twiddles_.data());
+  const Complex<T> first = values[0];
+  values[0] = {first.re + first.im, 0};
+  values[half] = {first.re - first.im, 0};
+
+  auto combine = [twiddles](const Complex<T>& z_k, const Complex<T>& z_half_minus_k, size_t k) {
+    const Complex<T> even = (z_k + Conj(z_half_minus_k)) * static_cast<T>(0.5);
+    const Complex<T> odd = RotateQuarter<false>(z_k - Conj(z_half_minus_k)) * static_cast<T>(0.5);
+    return even + Rotate<false>(odd, twiddles[k]);
+  };
+  for (size_t k = 1; k <= half - k; ++k) {
+    const Complex<T> z_k = values[k];
+    const Complex<T> z_half_minus_k = values[half - k];
+    values[k] = combine(z_k, z_half_minus_k, k);
+    values[half - k] = combine(z_half_minus_k, z_k, half - k);
+  }
+}
+
+template class FftPlan<float>;
+template class FftPlan<double>;
+template class RealFftPlan<float>;
+template class RealFftPlan<double>;
+
+}  // namespace signal
+}  // namespace onnxruntime
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace onnxruntime {
+namespace signal {
+
+/**
+ * A plan to compute unscaled discrete Fourier transforms of one size:
+ *   y_k = sum_n x_n exp(-+2 pi i n k / size)
+ * with the minus sign for the forward transform and the plus sign for the inverse one.
+ *
+ * The size is factored into radix 4, 2, 3 and 5 passes, and passes of other primes up to 13, which run as
+ * out-of-place Stockham passes that need no bit reversal. Sizes with a larger prime factor use Bluestein's
+ * algorithm, a convolution done with a plan of a fast size. The twiddle factors are computed once per plan, in
+ * double precision.
+ *
+ * Plans are immutable, so one plan is shared by the kernels and threads transforming its size: Get() returns the
+ * cached plan of a size.
+ */
+template <typename T>
+class FftPlan {
+ public:
+  static std::shared_ptr<const FftPlan> Get(size_t size);
+
+  explicit FftPlan(size_t size);
+
+  size_t Size() const { return size_; }
+
+  // Number of complex elements of the scratch buffer Transform() needs.
+  size_t ScratchSize() const { return scratch_size_; }
+
+  // Transforms the `Size()` elements of `data` in place.
+  void Transform(std::complex<T>* data, std::complex<T>* scratch, bool inverse) const;
+
+ private:
+  struct Pass {
+    size_t radix;
+    size_t l1;   // product of the radices of the previous passes
+    size_t ido;  // size / (l1 * radix)
+    size_t twiddle_offset;
+    size_t root_offset;  // of the passes of radices above 5
+  };
+
+  template <bool inverse>
+  void RunPasses(std::complex<T>* data, std::complex<T>* scratch) const;
+
+  void TransformBluestein(std::complex<T>* data, std::complex<T>* scratch) const;
+
+  size_t size_;
+  size_t scratch_size_{0};
+
+  std::vector<Pass> passes_;
+  // exp(-2 pi i j l1 i / size) of each pass, for j in [1, radix) and i in [0, ido), followed by the roots of unity
+  // exp(-2 pi i q / radix) of the passes of radices above 5
+  std::vector<std::complex<T>> twiddles_;
+
+  // Bluestein's algorithm: the chirp exp(-pi i k^2 / size), and the transform of the filter it is convolved with,
+  // scaled by 1 / bluestein_plan_->Size().
+  std::shared_ptr<const FftPlan> bluestein_plan_;
+  std::vector<std::complex<T>> chirp_;
+  std::vector<std::complex<T>> bluestein_filter_;
+};
+
+/**
+ * A plan to compute the forward transform of real signals of one size, of which it returns the size / 2 + 1
+ * values that are not redundant. An even size is transformed as a complex signal of half the size.
+ */
+template <typename T>
+class RealFftPlan {
+ public:
+  static std::shared_ptr<const RealFftPlan> Get(size_t size);
+
+  explicit RealFftPlan(size_t size);
+
+  size_t Size() const { return size_; }
+
+  // Number of complex elements of the scratch buffer Transform() needs.
+  size_t ScratchSize() const;
+
+  // Transforms the `Size()` elements of `input` into the `Size() / 2 + 1` elements of `output`.
+  void Transform(const T* input, std::complex<T>* output, std::complex<T>* scratch) const;
+
+ private:
+  size_t size_;
+  // plan of size / 2 for even sizes, of size otherwise
+  std::shared_ptr<const FftPlan<T>> plan_;
+  // exp(-2 pi i k / size) for k in [0, size / 2], for even sizes
+  std::vector<std::complex<T>> twiddles_;
+};
+
+}  // namespace signal
+}  // namespace onnxruntime
@@ -15,6 +15,8 @@
 #include "core/framework/data_types.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
@@ -22,10 +24,6 @@
 #include "Eigen/src/Core/arch/Default/BFloat16.h"
 #include "Eigen/src/Core/arch/Default/Half.h"
 
-#if defined(_M_AMD64) && !defined(_M_ARM64EC)
-#include "core/mlas/inc/mlas.h"
-#endif
-
 namespace onnxruntime {
 
 namespace op_kernel_type_control {
@@ -178,19 +176,30 @@ template <>
 struct EigenCastType<BFloat16> {
   using type = Eigen::bfloat16;
 };
+// run fn over the [begin, end) element ranges of a cast, split across the intra-op thread pool
+template <typename SrcType, typename DstType, typename Fn>
+void ParallelCast(const OpKernelContext& context, std::ptrdiff_t shape_size, Fn&& fn) {
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), shape_size,
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 1.0},
+      std::forward<Fn>(fn));
+}
+
 // generic tensor X -> Y
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCaster {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     using SrcEigenCastType = typename EigenCastType<SrcType>::type;
     using DstEigenCastType = typename EigenCastType<DstType>::type;
 
     const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
-    const auto in_vector =
-        ConstEigenVectorMap<SrcEigenCastType>(reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>()), shape_size);
-    auto out_vector =
-        EigenVectorMap<DstEigenCastType>(reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>()), shape_size);
-    out_vector = in_vector.template cast<DstEigenCastType>();
+    const auto* in_data = reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>());
+    auto* out_data = reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>());
+    ParallelCast<SrcType, DstType>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      const auto in_vector = ConstEigenVectorMap<SrcEigenCastType>(in_data + begin, end - begin);
+      auto out_vector = EigenVectorMap<DstEigenCastType>(out_data + begin, end - begin);
+      out_vector = in_vector.template cast<DstEigenCastType>();
+    });
   }
 };
 
@@ -225,13 +234,15 @@ struct TensorCaster<std::string, DstType> {
 // tensor X -> float 8
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCasterNoSat {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
     const auto* in_data = in.Data<SrcType>();
     auto* out_data = out.MutableData<DstType>();
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      out_data[i] = DstType(static_cast<float>(in_data[i]), false);
-    }
+    ParallelCast<SrcType, DstType>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i < end; ++i) {
+        out_data[i] = DstType(static_cast<float>(in_data[i]), false);
+      }
+    });
   }
 };
 
@@ -252,18 +263,57 @@ struct TensorCasterNoSat<std::string, DstType> {
 
 #endif
 
-#if defined(_M_AMD64) && !defined(_M_ARM64EC)
-// specializations to use optimized and Windows x64-specific
-// MlasConvertHalfToFloatBuffer() routine for MLFloat16 -> float conversion
+// specializations to use the MLAS bulk conversion routines for float <-> MLFloat16/BFloat16
 
 // tensor MLFloat16 -> float
 template <>
 struct TensorCaster<MLFloat16, float> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     auto out_data = out.MutableData<float>();
     auto in_data = in.Data<MLFloat16>();
-    const size_t shape_size = narrow<size_t>(shape.Size());
-    MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
+    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+    ParallelCast<MLFloat16, float>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertHalfToFloatBuffer(&in_data[begin].val, out_data + begin, static_cast<size_t>(end - begin));
+    });
+  }
+};
+
+// tensor float -> MLFloat16
+template <>
+struct TensorCaster<float, MLFloat16> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    auto out_data = out.MutableData<MLFloat16>();
+    auto in_data = in.Data<float>();
+    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+    ParallelCast<float, MLFloat16>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertFloatToHalfBuffer(in_data + begin, &out_data[begin].val, static_cast<size_t>(end - begin));
+    });
+  }
+};
+
+// tensor BFloat16 -> float
+template <>
+struct TensorCaster<BFloat16, float> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    auto out_data = out.MutableData<float>();
+    auto in_data = in.Data<BFloat16>();
+    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+    ParallelCast<BFloat16, float>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertBFloat16ToFloatBuffer(&in_data[begin].val, out_data + begin, static_cast<size_t>(end - begin));
+    });
+  }
+};
+
+// tensor float -> BFloat16
+template <>
+struct TensorCaster<float, BFloat16> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    auto out_data = out.MutableData<BFloat16>();
+    auto in_data = in.Data<float>();
+    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+    ParallelCast<float, BFloat16>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertFloatToBFloat16Buffer(in_data + begin, &out_data[begin].val, static_cast<size_t>(end - begin));
+    });
   }
 };
 
@@ -299,7 +349,6 @@ struct TensorCaster<MLFloat16, std::string> {
     CastMLFloat16ThroughFloatTensor<std::string>(context, shape, in, out);
   }
 };
-#endif
 
 class Cast final : public OpKernel {
  public:
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/compress.h"
+#include <algorithm>
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 using namespace ::onnxruntime::common;
 
@@ -38,18 +40,36 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[onnxruntime::narrow<size_t>(axis)] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
-  // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
-    if (condition_data[i]) {
-      ++positive_condition_count;
+  // The condition is split into blocks and the true entries of each block are counted in parallel.
+  // The prefix sum of the counts is the offset in the output of the selected entries of each block.
+  constexpr int64_t kMinBlockSize = 16 * 1024;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  const int64_t num_blocks = std::max<int64_t>(
+      1, std::min<int64_t>(valid_condition_length / kMinBlockSize,
+                           static_cast<int64_t>(concurrency::ThreadPool::DegreeOfParallelism(tp)) * 4));
+  const int64_t block_size = (valid_condition_length + num_blocks - 1) / num_blocks;
+
+  std::vector<int64_t> block_offsets(onnxruntime::narrow<size_t>(num_blocks) + 1, 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t b) {
+    const int64_t begin = std::min(valid_condition_length, b * block_size);
+    const int64_t end = std::min(valid_condition_length, begin + block_size);
+    int64_t count = 0;
+    for (int64_t i = begin; i < end; ++i) {
+      count += condition_data[i] ? 1 : 0;
     }
+    block_offsets[b + 1] = count;
+  });
+
+  for (size_t b = 0; b + 1 < block_offsets.size(); ++b) {
+    block_offsets[b + 1] += block_offsets[b];
   }
 
+  // Figure out output shape
+  const int64_t positive_condition_count = block_offsets.back();
   std::vector<int64_t> output_dims(input_dimensions.begin(), input_dimensions.end());
   if (has_axis_) {
     output_dims[onnxruntime::narrow<size_t>(axis)] = positive_condition_count;
@@ -68,55 +88,71 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   auto element_bytes = input_tensor->DataType()->Size();
   bool is_string_type = input_tensor->IsDataTypeString();
-  int64_t output_index = 0;
 
   if (has_axis_) {
     int64_t axes_left_stride = 1;
     int64_t axes_right_stride = 1;
-    for (int i = 0; i < axis; ++i) {
-      axes_left_stride *= input_dimensions[i];
+    for (int64_t i = 0; i < axis; ++i) {
+      axes_left_stride *= input_dimensions[onnxruntime::narrow<size_t>(i)];
     }
 
     for (auto i = static_cast<size_t>(axis + 1); i < rank; ++i) {
       axes_right_stride *= input_dimensions[i];
     }
     int64_t axes_included_right_stride = axes_right_stride * input_dimensions[onnxruntime::narrow<size_t>(axis)];
-    int64_t axes_included_right_stride_bytes = axes_included_right_stride * element_bytes;
     ORT_ENFORCE(axes_right_stride >= 0 &&
                 static_cast<uint64_t>(axes_right_stride) < std::numeric_limits<size_t>::max());
     size_t axes_right_stride_bytes = 0;
     if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
                                          &axes_right_stride_bytes))
       return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
+
+    std::vector<int64_t> selected;
+    selected.reserve(onnxruntime::narrow<size_t>(positive_condition_count));
+    for (int64_t j = 0; j < valid_condition_length; ++j) {
+      if (condition_data[j]) {
+        selected.push_back(j);
+      }
+    }
+
+    // copy the selected slices, output slice k is selected slice k % positive_condition_count of the outer index
+    // k / positive_condition_count
+    const double slice_bytes = static_cast<double>(axes_right_stride_bytes);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, axes_left_stride * positive_condition_count, TensorOpCost{slice_bytes, slice_bytes, 0.0},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t k = first; k < last; ++k) {
+            const int64_t i = k / positive_condition_count;
+            const int64_t j = selected[onnxruntime::narrow<size_t>(k % positive_condition_count)];
+            const int64_t input_offset = i * axes_included_right_stride + j * axes_right_stride;
+            const int64_t output_offset = k * axes_right_stride;
+            if (is_string_type) {
+              std::copy_n(reinterpret_cast<const std::string*>(input_data) + input_offset,
+                          onnxruntime::narrow<size_t>(axes_right_stride),
+                          reinterpret_cast<std::string*>(output_data) + output_offset);
+            } else {
+              memcpy(output_data + output_offset * element_bytes, input_data + input_offset * element_bytes,
+                     axes_right_stride_bytes);
+            }
+          }
+        });
+  } else {
+    concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t b) {
+      const int64_t begin = std::min(valid_condition_length, b * block_size);
+      const int64_t end = std::min(valid_condition_length, begin + block_size);
+      int64_t output_index = block_offsets[b];
+      for (int64_t i = begin; i < end; ++i) {
+        if (!condition_data[i]) {
           continue;
         }
         if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-                reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
-          }
-          output_index += axes_right_stride;
+          reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
         } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
+          memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
         }
+        ++output_index;
       }
-    }
-  } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
-      }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
-      }
-      ++output_index;
-    }
+    });
   }
 
   return Status::OK();
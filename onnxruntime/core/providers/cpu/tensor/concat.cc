@@ -11,11 +11,18 @@
 
 namespace onnxruntime {
 
+// The inputs are read with strided copies, so they may be strided tensor views.
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_CONCAT_KERNEL_DEF KernelDefBuilder().VariadicMayStridedInput(0)
+#else
+#define CREATE_CONCAT_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Concat,
     4,
     10,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    CREATE_CONCAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Concat);
 
 // Opset 11 starts to support Neg Axis.
@@ -23,14 +30,14 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Concat,
     11,
     12,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    CREATE_CONCAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Concat);
 
 // Opset 13 .
 ONNX_CPU_OPERATOR_KERNEL(
     Concat,
     13,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    CREATE_CONCAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     Concat);
 
 namespace op_kernel_type_control {
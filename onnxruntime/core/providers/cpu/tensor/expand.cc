@@ -7,19 +7,25 @@
 
 namespace onnxruntime {
 
-#define REG_EXPAND_KERNEL(TYPE)                                                    \
-  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                        \
-      Expand,                                                                      \
-      8,                                                                           \
-      12,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
-      Expand<TYPE>);                                                               \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      Expand,                                                                      \
-      13,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder().MayStridedOutput(0, 0)
+#else
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder()
+#endif
+
+#define REG_EXPAND_KERNEL(TYPE)                                                           \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                               \
+      Expand,                                                                             \
+      8,                                                                                  \
+      12,                                                                                 \
+      TYPE,                                                                               \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      Expand<TYPE>);                                                                      \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                         \
+      Expand,                                                                             \
+      13,                                                                                 \
+      TYPE,                                                                               \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       Expand<TYPE>);
 
 REG_EXPAND_KERNEL(float)
@@ -69,6 +75,23 @@ Status Expand<T>::Compute(OpKernelContext* context) const {
 
   TensorShape output_tensor_shape(output_shape);
   auto* output_tensor = context->Output(0, output_tensor_shape);
+
+#ifdef ENABLE_STRIDED_TENSORS
+  // Strided output sharing the input buffer, planned when all the consumers accept strided inputs. The broadcast
+  // dimensions have a stride of 0.
+  if (input_tensor->DataRaw() == output_tensor->DataRaw()) {
+    const auto input_strides = input_tensor->Strides();
+    const size_t offset = output_shape.size() - input_shape.size();
+    TensorShapeVector output_strides(output_shape.size(), 0);
+    for (size_t dim = offset; dim < output_shape.size(); ++dim) {
+      if (input_shape[dim - offset] == output_shape[dim]) {
+        output_strides[dim] = input_strides[dim - offset];
+      }
+    }
+    output_tensor->SetShapeAndStrides(output_tensor_shape, output_strides);
+    return Status::OK();
+  }
+#endif
   auto* output_data = output_tensor->MutableData<T>();
   auto* output_dims = output_shape.data();
   auto output_dims_size = static_cast<int64_t>(output_shape.size());
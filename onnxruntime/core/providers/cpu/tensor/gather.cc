@@ -7,6 +7,7 @@
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel_type_control_utils.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
 
@@ -83,6 +84,10 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+// Rows at least this long are prefetched GatherPrefetchDistance indices ahead.
+constexpr size_t GatherPrefetchRowBytes = 256;
+constexpr int64_t GatherPrefetchDistance = 4;
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
@@ -102,30 +107,67 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-  auto lambda = [&](int64_t index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
+  const size_t block_bytes = narrow<size_t>(block_size);
+  const size_t block_elements = block_bytes / element_bytes;
+  const bool prefetch_rows = block_bytes >= GatherPrefetchRowBytes;
+
+  // The M * N output blocks are split into ranges, and each range walks its batches and indices
+  // incrementally. Blocks of a single 1, 2, 4 or 8 byte element are assigned directly instead of
+  // calling memcpy, and 4 byte elements use the MLAS gather kernel.
+  auto copy_range = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    int64_t batch = first / N;
+    int64_t i = first % N;
+
+    for (std::ptrdiff_t remaining = last - first; remaining > 0;) {
+      const int64_t count = std::min<int64_t>(N - i, remaining);
+      const uint8_t* src_batch = src_base + batch * data_batch_bytes;
+      uint8_t* dst_batch = dst_base + batch * gathered_batch_bytes + i * block_size;
+      const Tin* indices = indices_data + i;
+
+      auto assign_elements = [&](auto* dst, const auto* src) {
+        for (int64_t j = 0; j < count; ++j) {
+          const int64_t idx = indices[j] < 0 ? indices[j] + axis_dim_limit : indices[j];
+          dst[j] = src[idx];
+        }
+      };
+
+      if (is_string_type) {
+        const auto* src = reinterpret_cast<const std::string*>(src_batch);
+        auto* dst = reinterpret_cast<std::string*>(dst_batch);
+        for (int64_t j = 0; j < count; ++j) {
+          const int64_t idx = indices[j] < 0 ? indices[j] + axis_dim_limit : indices[j];
+          std::copy_n(src + idx * static_cast<int64_t>(block_elements), block_elements, dst + j * block_elements);
+        }
+      } else if (block_bytes == sizeof(uint32_t)) {
+        MlasGather(reinterpret_cast<const uint32_t*>(src_batch), indices, reinterpret_cast<uint32_t*>(dst_batch),
+                   narrow<size_t>(count), axis_dim_limit, 1, 0);
+      } else if (block_bytes == sizeof(uint8_t)) {
+        assign_elements(dst_batch, src_batch);
+      } else if (block_bytes == sizeof(uint16_t)) {
+        assign_elements(reinterpret_cast<uint16_t*>(dst_batch), reinterpret_cast<const uint16_t*>(src_batch));
+      } else if (block_bytes == sizeof(uint64_t)) {
+        assign_elements(reinterpret_cast<uint64_t*>(dst_batch), reinterpret_cast<const uint64_t*>(src_batch));
+      } else {
+        for (int64_t j = 0; j < count; ++j) {
+          if (prefetch_rows && j + GatherPrefetchDistance < count) {
+            const Tin next = indices[j + GatherPrefetchDistance];
+            GatherPrefetchRow(src_batch + (next < 0 ? next + axis_dim_limit : next) * block_size);
+          }
+          const int64_t idx = indices[j] < 0 ? indices[j] + axis_dim_limit : indices[j];
+          memcpy(dst_batch + j * block_size, src_batch + idx * block_size, block_bytes);
+        }
+      }
+
+      remaining -= count;
+      i = 0;
+      ++batch;
     }
   };
-  concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
-                                              lambda(index);
-                                            }
-                                          });
+
+  const double block_cost = static_cast<double>(block_bytes);
+  concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N,
+                                          TensorOpCost{block_cost + sizeof(Tin), block_cost, 1.0},
+                                          copy_range);
 
   return Status::OK();
 }
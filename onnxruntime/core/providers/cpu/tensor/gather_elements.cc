@@ -4,6 +4,7 @@
 #include <string>
 #include "gather_elements.h"
 #include "onnxruntime_config.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -112,19 +113,31 @@ static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
   bool innermost_axis = axis == input_rank - 1;
   bool index_error = false;
 
+  // Each row of the indices is gathered as a unit, the rows are split across threads by the cost model.
+  const TensorOpCost row_cost{static_cast<double>(inner_dim_size * (element_size + sizeof(Tin))),
+                              static_cast<double>(inner_dim_size * element_size),
+                              static_cast<double>(inner_dim_size)};
+
   auto MainLoop = [&](auto* output_data, auto* input_data) {
-    auto BatchWork = [&](size_t inner_dim) {
+    auto BatchWork = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
       ORT_TRY {
-        auto output = output_data + inner_dim_size * inner_dim;
-        auto input = input_data + CalculateOffset(inner_dim, input_shape_pitches, onnxruntime::narrow<size_t>(axis), indices_shape);
-        auto indices = indices_data + inner_dim_size * inner_dim;
-
-        if (innermost_axis) {
-          for (size_t i = 0; i < inner_dim_size; i++)
-            output[i] = input[GetIndex(i, indices, axis_size)];
-        } else {
-          for (size_t i = 0; i < inner_dim_size; i++)
-            output[i] = input[GetIndex(i, indices, axis_size) * axis_pitch + i];
+        for (size_t inner_dim = static_cast<size_t>(first); inner_dim < static_cast<size_t>(last); ++inner_dim) {
+          auto output = output_data + inner_dim_size * inner_dim;
+          auto input = input_data + CalculateOffset(inner_dim, input_shape_pitches, onnxruntime::narrow<size_t>(axis), indices_shape);
+          auto indices = indices_data + inner_dim_size * inner_dim;
+
+          if constexpr (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<decltype(input)>>, uint32_t>) {
+            if (!MlasGather(input, indices, output, inner_dim_size, axis_size,
+                            innermost_axis ? 1 : onnxruntime::narrow<size_t>(axis_pitch), innermost_axis ? 0 : 1)) {
+              index_error = true;
+            }
+          } else if (innermost_axis) {
+            for (size_t i = 0; i < inner_dim_size; i++)
+              output[i] = input[GetIndex(i, indices, axis_size)];
+          } else {
+            for (size_t i = 0; i < inner_dim_size; i++)
+              output[i] = input[GetIndex(i, indices, axis_size) * axis_pitch + i];
+          }
         }
       }
       ORT_CATCH(const std::exception&) {
@@ -132,7 +145,7 @@ static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
       }
     };
 
-    concurrency::ThreadPool::TryBatchParallelFor(ttp, num_inner_dim, BatchWork, 0);
+    concurrency::ThreadPool::TryParallelFor(ttp, static_cast<std::ptrdiff_t>(num_inner_dim), row_cost, BatchWork);
   };
 
   // Iterate over the elements based on the element size (or if it's a string). For everything but strings
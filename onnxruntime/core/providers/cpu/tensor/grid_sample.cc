@@ -121,6 +121,20 @@ T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, in
   return pixel;
 }
 
+template <typename T>
+int64_t GridSample<T>::PixelIndexAtGrid(int64_t r, int64_t c, int64_t H, int64_t W, const T border[/* 4 */]) const {
+  if (padding_mode_ == Zeros) {
+    return (c >= 0 && c < W && r >= 0 && r < H) ? r * W + c : -1;
+  } else if (padding_mode_ == Border) {
+    c = std::clamp<int64_t>(c, 0, W - 1);
+    r = std::clamp<int64_t>(r, 0, H - 1);
+  } else {  // (padding_mode_ == Reflection)
+    c = static_cast<int64_t>(GsReflect(static_cast<T>(c), border[0], border[2]));
+    r = static_cast<int64_t>(GsReflect(static_cast<T>(r), border[1], border[3]));
+  }
+  return r * W + c;
+}
+
 template <typename T>
 T GridSample<T>::PixelAtGrid3D(const T* image, int64_t d, int64_t h, int64_t w, int64_t D, int64_t H, int64_t W, T border[/* 6 */]) const {
   T pixel = {};  // default 0
@@ -204,45 +218,24 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     T border[] = {x_min, y_min, x_max, y_max};  // l-t-r-b
 
     concurrency::ThreadPool* tp = H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
-    for (int64_t n = 0; n < N; n++) {
-      const T* grid_data = grid->Data<T>() + n * (H_out * W_out) * 2;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
-
-            for (int64_t oy = 0; oy < H_out; oy++) {
-              for (int64_t ox = 0; ox < W_out; ox++) {
-                const T* gridpoint = grid_data + (oy * W_out + ox) * 2;
-                T* Y_gridpoint = Y_data + oy * W_out + ox;
-                auto nx = gridpoint[0];  // normalized location
-                auto ny = gridpoint[1];
-                auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                auto y = GsDenormalize<T>(ny, H_in, align_corners_);
-
-                if (mode_ == Nearest) {
-                  x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                  y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                  // x, y are integers in all padding modes
-                  *Y_gridpoint = PixelAtGrid(X_data, static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
-                } else if (mode_ == Linear) {
-                  int64_t x1 = static_cast<int64_t>(std::floor(x));
-                  int64_t y1 = static_cast<int64_t>(std::floor(y));
-                  int64_t x2 = x1 + 1;
-                  int64_t y2 = y1 + 1;
-
-                  T p11 = PixelAtGrid(X_data, y1, x1, H_in, W_in, border);
-                  T p12 = PixelAtGrid(X_data, y1, x2, H_in, W_in, border);
-                  T p21 = PixelAtGrid(X_data, y2, x1, H_in, W_in, border);
-                  T p22 = PixelAtGrid(X_data, y2, x2, H_in, W_in, border);
-
-                  T dx2 = static_cast<T>(x2) - x;
-                  T dx1 = x - static_cast<T>(x1);
-                  T dy2 = static_cast<T>(y2) - y;
-                  T dy1 = y - static_cast<T>(y1);
-                  *Y_gridpoint = dy2 * (dx2 * p11 + dx1 * p12) + dy1 * (dx2 * p21 + dx1 * p22);
-                } else if (mode_ == Cubic) {
+    if (mode_ == Cubic) {
+      for (int64_t n = 0; n < N; n++) {
+        const T* grid_data = grid->Data<T>() + n * (H_out * W_out) * 2;
+        concurrency::ThreadPool::TrySimpleParallelFor(
+            tp, onnxruntime::narrow<std::ptrdiff_t>(C),
+            [&](std::ptrdiff_t c) {
+              const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
+              T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
+
+              for (int64_t oy = 0; oy < H_out; oy++) {
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  const T* gridpoint = grid_data + (oy * W_out + ox) * 2;
+                  T* Y_gridpoint = Y_data + oy * W_out + ox;
+                  auto nx = gridpoint[0];  // normalized location
+                  auto ny = gridpoint[1];
+                  auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
+                  auto y = GsDenormalize<T>(ny, H_in, align_corners_);
+
                   int64_t x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
                   int64_t y0 = static_cast<int64_t>(std::floor(y)) - 1;
 
@@ -257,6 +250,90 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
                   *Y_gridpoint = GsBicubicInterpolate(p, dx, dy);
                 }
               }
+            });
+      }
+      return Status::OK();
+    }
+
+    // Nearest and linear sampling only depend on the grid, so the source offsets and the interpolation weights of
+    // the output points are computed once per image and shared by all the channels, which leaves a plain weighted
+    // gather per channel. Zero padded taps have offset -1.
+    const int64_t num_points = H_out * W_out;
+    const int64_t num_taps = mode_ == Linear ? 4 : 1;
+    std::vector<int64_t> tap_offsets(SafeInt<size_t>(num_points) * num_taps);
+    std::vector<T> tap_weights(SafeInt<size_t>(num_points) * num_taps);
+    const TensorOpCost precompute_cost{static_cast<double>(2 * sizeof(T)),
+                                       static_cast<double>(num_taps * (sizeof(int64_t) + sizeof(T))),
+                                       static_cast<double>(20 * num_taps)};
+    const TensorOpCost gather_cost{static_cast<double>(W_out * num_taps * (sizeof(int64_t) + 2 * sizeof(T))),
+                                   static_cast<double>(W_out * sizeof(T)),
+                                   static_cast<double>(W_out * num_taps * 3)};
+
+    for (int64_t n = 0; n < N; n++) {
+      const T* grid_data = grid->Data<T>() + n * num_points * 2;
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(num_points), precompute_cost,
+          [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t i = begin; i < end; i++) {
+              const T* gridpoint = grid_data + i * 2;
+              int64_t* offsets = tap_offsets.data() + i * num_taps;
+              T* weights = tap_weights.data() + i * num_taps;
+              auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+              auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
+
+              if (mode_ == Nearest) {
+                x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
+                y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
+                // x, y are integers in all padding modes
+                offsets[0] = PixelIndexAtGrid(static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
+              } else {  // (mode_ == Linear)
+                int64_t x1 = static_cast<int64_t>(std::floor(x));
+                int64_t y1 = static_cast<int64_t>(std::floor(y));
+                int64_t x2 = x1 + 1;
+                int64_t y2 = y1 + 1;
+
+                T dx2 = static_cast<T>(x2) - x;
+                T dx1 = x - static_cast<T>(x1);
+                T dy2 = static_cast<T>(y2) - y;
+                T dy1 = y - static_cast<T>(y1);
+
+                offsets[0] = PixelIndexAtGrid(y1, x1, H_in, W_in, border);
+                offsets[1] = PixelIndexAtGrid(y1, x2, H_in, W_in, border);
+                offsets[2] = PixelIndexAtGrid(y2, x1, H_in, W_in, border);
+                offsets[3] = PixelIndexAtGrid(y2, x2, H_in, W_in, border);
+                weights[0] = dy2 * dx2;
+                weights[1] = dy2 * dx1;
+                weights[2] = dy1 * dx2;
+                weights[3] = dy1 * dx1;
+              }
+            }
+          });
+
+      // One task per (channel, output row) so that images with few channels still use all the threads.
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(C * H_out), gather_cost,
+          [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t row = begin; row < end; row++) {
+              const int64_t c = row / H_out;
+              const int64_t oy = row % H_out;
+              const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
+              T* Y_data = Y.MutableData<T>() + (n * C + c) * num_points + oy * W_out;
+              const int64_t* offsets = tap_offsets.data() + oy * W_out * num_taps;
+              const T* weights = tap_weights.data() + oy * W_out * num_taps;
+
+              if (num_taps == 4) {
+                for (int64_t ox = 0; ox < W_out; ox++, offsets += 4, weights += 4) {
+                  const T p11 = offsets[0] >= 0 ? X_data[offsets[0]] : T{};
+                  const T p12 = offsets[1] >= 0 ? X_data[offsets[1]] : T{};
+                  const T p21 = offsets[2] >= 0 ? X_data[offsets[2]] : T{};
+                  const T p22 = offsets[3] >= 0 ? X_data[offsets[3]] : T{};
+                  Y_data[ox] = weights[0] * p11 + weights[1] * p12 + weights[2] * p21 + weights[3] * p22;
+                }
+              } else {
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  Y_data[ox] = offsets[ox] >= 0 ? X_data[offsets[ox]] : T{};
+                }
+              }
             }
           });
     }
@@ -69,6 +69,8 @@ class GridSample final : public OpKernel {
   };
 
   T PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const;
+  // Returns the offset of the padded pixel at (r, c) in the image, or -1 if the pixel is zero padding.
+  int64_t PixelIndexAtGrid(int64_t r, int64_t c, int64_t H, int64_t W, const T border[/* 4 */]) const;
   T PixelAtGrid3D(const T* image, int64_t d, int64_t h, int64_t w, int64_t D, int64_t H, int64_t W, T border[/* 6 */]) const;
 
   GridSampleInterpolationMode mode_{Linear};
@@ -3,10 +3,11 @@
 
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
-#include <core/common/safeint.h>
-#include "core/util/math_cpuonly.h"
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -59,27 +60,79 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : onnxruntime::narrow<Eigen::Index>(X_shape.NumDimensions());
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(SafeInt<size_t>(X_shape.Size()) * coordinate_size);
-
   const T* data = X->Data<T>();
 
   if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
+    const int64_t num_non_zero_values = *data != T{} ? 1 : 0;
+    Tensor* const Y = context->Output(0, {1, num_non_zero_values});
+    ORT_ENFORCE(Y, "failed to get first output!");
+    if (num_non_zero_values > 0) {
+      *Y->MutableData<int64_t>() = 0;
+    }
+    return Status::OK();
+  }
+
+  const auto dims = X_shape.GetDims();
+  const size_t coordinate_size = dims.size();
+  const size_t size = onnxruntime::narrow<size_t>(X_shape.Size());
+
+  // The input is split into blocks. The non-zero values of each block are counted in parallel, and then each block
+  // writes its coordinates in parallel at the offset given by the number of non-zero values of the preceding blocks.
+  constexpr size_t kMinBlockSize = 16 * 1024;
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const size_t num_blocks =
+      std::max<size_t>(1, std::min<size_t>(size / kMinBlockSize,
+                                           static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp)) * 4));
+  const size_t block_size = (size + num_blocks - 1) / num_blocks;
+
+  std::vector<size_t> block_offsets(num_blocks + 1, 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, static_cast<std::ptrdiff_t>(num_blocks), [&](std::ptrdiff_t b) {
+    const size_t begin = std::min(size, static_cast<size_t>(b) * block_size);
+    const size_t end = std::min(size, begin + block_size);
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+      count += data[i] != T{} ? 1 : 0;
+    }
+    block_offsets[b + 1] = count;
+  });
+
+  for (size_t b = 0; b < num_blocks; ++b) {
+    block_offsets[b + 1] += block_offsets[b];
+  }
+
+  const size_t num_non_zero_values = block_offsets.back();
+  Tensor* const Y = context->Output(0, {static_cast<int64_t>(coordinate_size),
+                                        static_cast<int64_t>(num_non_zero_values)});
+  ORT_ENFORCE(Y, "failed to get first output!");
+  if (num_non_zero_values == 0) {
+    return Status::OK();
+  }
+
+  // Y has the shape {coordinate_size, num_non_zero_values}
+  int64_t* y_data = Y->MutableData<int64_t>();
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, static_cast<std::ptrdiff_t>(num_blocks), [&](std::ptrdiff_t b) {
+    const size_t begin = std::min(size, static_cast<size_t>(b) * block_size);
+    const size_t end = std::min(size, begin + block_size);
+    size_t output_idx = block_offsets[b];
+    if (output_idx == block_offsets[b + 1]) {
+      return;
+    }
+
+    // coordinate of the first entry of the block
+    TensorShapeVector coordinate(coordinate_size, 0);
+    size_t remainder = begin;
+    for (size_t idx = coordinate_size; idx-- > 0;) {
+      const size_t dim = onnxruntime::narrow<size_t>(dims[idx]);
+      coordinate[idx] = static_cast<int64_t>(remainder % dim);
+      remainder /= dim;
     }
-  } else {
-    std::vector<int64_t> coordinate(coordinate_size, 0);
 
     // as we iterate the entries, increment the coordinate for the current entry
     // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
-      for (Eigen::Index idx = coordinate_size - 1; idx >= 0; --idx) {
+    auto increment_coordinate = [&coordinate, coordinate_size, &dims]() {
+      for (size_t idx = coordinate_size; idx-- > 0;) {
         int64_t& cur_coord = coordinate[idx];
-        if (cur_coord != X_shape[idx] - 1) {
+        if (cur_coord != dims[idx] - 1) {
           ++cur_coord;
           break;
         }
@@ -87,31 +140,17 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
       }
     };
 
-    for (size_t i = 0, end = onnxruntime::narrow<size_t>(X_shape.Size()); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
+    for (size_t i = begin; i < end; ++i) {
+      if (data[i] != T{}) {
+        for (size_t idx = 0; idx < coordinate_size; ++idx) {
+          y_data[idx * num_non_zero_values + output_idx] = coordinate[idx];
+        }
+        ++output_idx;
       }
 
       increment_coordinate();
     }
-  }
-
-  const Eigen::Index num_non_zero_values = onnxruntime::narrow<Eigen::Index>(non_zero_indices_buffer.size()) / coordinate_size;
-
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
-
-  Tensor* const Y = context->Output(0, {coordinate_size, num_non_zero_values});
-  ORT_ENFORCE(Y, "failed to get first output!");
-
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+  });
 
   return Status::OK();
 }
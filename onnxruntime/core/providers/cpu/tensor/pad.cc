@@ -326,6 +326,16 @@ static Status PadInputWithDimValueOfZero(OpKernelContext* ctx,
 template <typename T>
 static void PadAxis(T* output, T* input, ptrdiff_t input_delta, ptrdiff_t input_pitch,
                     size_t block_size, size_t block_count) {
+  if (input_delta == 1) {
+    // each block is a contiguous run of already written output, which never overlaps the block being written
+    for (size_t block_index = 0; block_index < block_count; block_index++) {
+      memcpy(output, input, block_size * sizeof(T));
+      output += block_size;
+      input += static_cast<ptrdiff_t>(block_size) + input_pitch;
+    }
+    return;
+  }
+
   for (size_t block_index = 0; block_index < block_count; block_index++) {
     for (size_t i = 0; i < block_size; i++) {
       *output++ = *input;
@@ -354,11 +364,7 @@ static void PadAxisConstant(T* output, T constant, size_t size) {
     *output = constant;
     *(output + 1) = constant;
   } else {
-    // This would be faster with SSE instructions.
-    // That would mean to have an implementation for each type (uint8, uint32, uint64).
-    T* end = output + size;
-    for (; output != end;)
-      *output++ = constant;
+    std::fill_n(output, size, constant);
   }
 }
 
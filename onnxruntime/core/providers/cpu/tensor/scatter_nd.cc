@@ -350,59 +350,65 @@ struct Func_Max_ND<BFloat16> {
   }
 };
 
+// Applies the updates with TFunc. Without a reduction the indices are expected to be unique, so the updates are
+// split across threads by index. With a reduction several indices may address the same slice, so the threads
+// split the slice columns instead and each applies all the updates of its columns in index order.
+template <typename TData, typename TFunc>
+void ScatterNDApply(const Prepare<TData>& prepare, concurrency::ThreadPool* tp, bool split_by_index) {
+  const TFunc func{};
+  const auto element_to_copy = prepare.element_to_copy;
+  const auto num_updates = static_cast<std::ptrdiff_t>(prepare.element_offsets.size());
+  const double slice_bytes = static_cast<double>(element_to_copy * sizeof(TData));
+
+  if (split_by_index) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, num_updates, TensorOpCost{slice_bytes, slice_bytes, static_cast<double>(element_to_copy)},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            func(prepare.output_base + prepare.element_offsets[static_cast<size_t>(i)],
+                 prepare.input_base + i * element_to_copy,
+                 element_to_copy);
+          }
+        });
+  } else {
+    const double update_count = static_cast<double>(num_updates);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(element_to_copy),
+        TensorOpCost{2 * update_count * sizeof(TData), update_count * sizeof(TData), update_count},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = 0; i < num_updates; ++i) {
+            func(prepare.output_base + prepare.element_offsets[static_cast<size_t>(i)] + first,
+                 prepare.input_base + i * element_to_copy + first,
+                 static_cast<uint64_t>(last - first));
+          }
+        });
+  }
+}
+
 template <typename TData>
 struct ScatterNDDispatchTarget {
   Status operator()(OpKernelContext* context, concurrency::ThreadPool* tp, ScatterND::Reduction reduction) const {
     Prepare<TData> prepare;
     ORT_RETURN_IF_ERROR(PrepareForCompute(context, prepare));
 
-    auto lambda = [&](int64_t i) {
-      switch (reduction) {
-        case ScatterND::Reduction::Add: {
-          auto func = Func_Add_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Mul: {
-          auto func = Func_Mul_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Min: {
-          auto func = Func_Min_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Max: {
-          auto func = Func_Max_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        default:
-        case ScatterND::Reduction::None: {
-          auto func = Func_Copy_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-      }
-    };
-    concurrency::ThreadPool::TryParallelFor(
-        tp, prepare.element_offsets.size(), static_cast<double>(prepare.element_to_copy),
-        [&lambda](ptrdiff_t first, ptrdiff_t last) {
-          for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
-            lambda(i);
-          }
-        });
+    switch (reduction) {
+      case ScatterND::Reduction::Add:
+        ScatterNDApply<TData, Func_Add_ND<TData>>(prepare, tp, false);
+        break;
+      case ScatterND::Reduction::Mul:
+        ScatterNDApply<TData, Func_Mul_ND<TData>>(prepare, tp, false);
+        break;
+      case ScatterND::Reduction::Min:
+        ScatterNDApply<TData, Func_Min_ND<TData>>(prepare, tp, false);
+        break;
+      case ScatterND::Reduction::Max:
+        ScatterNDApply<TData, Func_Max_ND<TData>>(prepare, tp, false);
+        break;
+      default:
+      case ScatterND::Reduction::None:
+        ScatterNDApply<TData, Func_Copy_ND<TData>>(prepare, tp, true);
+        break;
+    }
     return Status::OK();
   }
 };
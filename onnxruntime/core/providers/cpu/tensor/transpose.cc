@@ -247,9 +247,37 @@ static void DoTransposeEltWise(int64_t num_axes, gsl::span<const int64_t> target
   }
 }
 
+// Transposes 1, 2 and 4 byte element types with the blocked MLAS N-D transpose.
+// Returns false if the element size is not handled by MLAS.
+static bool MlasDoTranspose(const gsl::span<const size_t>& permutations, gsl::span<const int64_t> input_dims,
+                            const uint8_t* source, uint8_t* target, size_t element_size,
+                            concurrency::ThreadPool* tp) {
+  InlinedVector<size_t> input_shape(input_dims.size());
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    input_shape[i] = onnxruntime::narrow<size_t>(input_dims[i]);
+  }
+
+  switch (element_size) {
+    case sizeof(uint32_t):
+      MlasTranspose(reinterpret_cast<const uint32_t*>(source), reinterpret_cast<uint32_t*>(target),
+                    input_shape.data(), permutations.data(), input_shape.size(), tp);
+      return true;
+    case sizeof(uint16_t):
+      MlasTranspose(reinterpret_cast<const uint16_t*>(source), reinterpret_cast<uint16_t*>(target),
+                    input_shape.data(), permutations.data(), input_shape.size(), tp);
+      return true;
+    case sizeof(uint8_t):
+      MlasTranspose(source, target, input_shape.data(), permutations.data(), input_shape.size(), tp);
+      return true;
+    default:
+      return false;
+  }
+}
+
 //  `input_shape_override` overrides the shape of `input` for compute purposes.
 static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
-                                 const TensorShape* input_shape_override = nullptr) {
+                                 const TensorShape* input_shape_override = nullptr,
+                                 concurrency::ThreadPool* tp = nullptr) {
   const auto& input_shape = input_shape_override ? *input_shape_override : input.Shape();
   const auto& input_dims = input_shape.GetDims();
   auto rank = input_shape.NumDimensions();
@@ -309,6 +337,8 @@ static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, co
     auto* output_data = reinterpret_cast<uint8_t*>(output.MutableDataRaw());
     if (1 == prefix_blocksize) {
       DoTransposeSingleBlock(suffix_blocksize, input_data, output_data, element_size);
+    } else if (MlasDoTranspose(permutations, input_dims, input_data, output_data, element_size, tp)) {
+      // 1, 2 and 4 byte element types are transposed by MLAS.
     } else if (1 == suffix_blocksize) {
       // this may return a failed status if the data size is not supported in this build
       status = DoTransposeEltWise(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, stride,
@@ -338,7 +368,7 @@ bool IsTransposeReshape(const gsl::span<const size_t>& perm, gsl::span<const int
 
 //`input_shape_override` overrides the shape of `input` for compute purposes.
 Status TransposeBase::DoTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
-                                  const TensorShape* input_shape_override) {
+                                  const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -360,10 +390,10 @@ Status TransposeBase::DoTranspose(const gsl::span<const size_t>& permutations, c
     bool moving_single_axis = IsTransposeMovingSingleAxis(permutations, from, to);
 
     if (moving_single_axis && !input.IsDataTypeString()) {
-      SingleAxisTranspose(permutations, input, output, from, to, input_shape_override);
+      SingleAxisTranspose(permutations, input, output, from, to, input_shape_override, tp);
     } else {
       // fall back to default implementation
-      status = DoUntypedTranspose(permutations, input, output, input_shape_override);
+      status = DoUntypedTranspose(permutations, input, output, input_shape_override, tp);
     }
   }
 
@@ -388,6 +418,19 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor& Y = *ctx->Output(0, output_shape);
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // Strided output sharing the input buffer, planned when all the consumers accept strided inputs.
+  if (Y.DataRaw() == X.DataRaw()) {
+    const auto input_strides = X.Strides();
+    TensorShapeVector output_strides(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      output_strides[i] = input_strides[(*p_perm)[i]];
+    }
+    Y.SetShapeAndStrides(output_shape, output_strides);
+    return Status::OK();
+  }
+#endif
+
   if (output_shape.Size() == 0)
     return Status::OK();
 
@@ -405,23 +448,29 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
     SingleAxisTranspose(*p_perm, X, Y, from, to, nullptr, ctx->GetOperatorThreadPool());
   } else {
     // fall back to default implementation
-    status = DoUntypedTranspose(*p_perm, X, Y);
+    status = DoUntypedTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool());
   }
 
   return status;
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_TRANSPOSE_KERNEL_DEF KernelDefBuilder().MayStridedOutput(0, 0)
+#else
+#define CREATE_TRANSPOSE_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     1,
     12,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    CREATE_TRANSPOSE_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
     Transpose);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     13,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    CREATE_TRANSPOSE_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
     Transpose);
 
 }  // namespace onnxruntime
@@ -2,10 +2,15 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/unique.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <numeric>
 #include <core/common/safeint.h>
 #include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel_type_control_utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/providers/op_kernel_type_control.h"
 
@@ -144,13 +149,128 @@ class Subtensor {
   std::vector<T> items_;
 };
 
+// Returns true if a sorts before b. NaNs sort after all the other values so this is a strict weak ordering.
+template <typename T>
+static bool UniqueLess(const T& a, const T& b) {
+  if constexpr (std::is_floating_point<T>::value) {
+    return a < b || (std::isnan(b) && !std::isnan(a));
+  } else {
+    return a < b;
+  }
+}
+
+// Finds the unique values of the flattened input in order of their first occurrence.
+// first_indices and counts have an entry per unique value, inverse_index has an entry per input value.
+// Large inputs are split into partitions by the hash of the values. Each partition is built by one thread that scans
+// the whole input, so it sees its values in input order, and the partitions are merged by first occurrence.
+template <typename T>
+static void FindFlattenedUnique(gsl::span<const T> data, concurrency::ThreadPool* tp,
+                                std::vector<int64_t>& first_indices,
+                                std::vector<int64_t>& counts,
+                                std::vector<int64_t>& inverse_index) {
+  using OffsetMap = InlinedHashMap<T, int64_t>;
+  // every partition hashes the whole input, so only split inputs that are large enough
+  constexpr size_t kMinPartitionSize = 64 * 1024;
+  constexpr size_t kMaxPartitions = 64;
+
+  const size_t n = data.size();
+  const size_t num_partitions =
+      std::max<size_t>(1, std::min({static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp)),
+                                    n / kMinPartitionSize, kMaxPartitions}));
+
+  // spread the hash to pick a partition, as the hash of an integer may be the integer itself
+  auto partition_of = [num_partitions](size_t hash) {
+    return static_cast<size_t>(((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> 32) % num_partitions);
+  };
+
+  std::vector<std::vector<int64_t>> partition_first_indices(num_partitions);
+  std::vector<std::vector<int64_t>> partition_counts(num_partitions);
+  // the partition of each input value, only needed with more than one partition
+  std::vector<uint8_t> value_partitions(num_partitions > 1 ? n : 0);
+  inverse_index.resize(n);
+
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, static_cast<std::ptrdiff_t>(num_partitions), [&](std::ptrdiff_t p) {
+    auto& part_first_indices = partition_first_indices[p];
+    auto& part_counts = partition_counts[p];
+    OffsetMap offsets;  // unique value to its offset in the partition
+    typename OffsetMap::hasher hasher;
+
+    for (size_t i = 0; i < n; ++i) {
+      if (num_partitions > 1) {
+        if (partition_of(hasher(data[i])) != static_cast<size_t>(p)) {
+          continue;
+        }
+        value_partitions[i] = static_cast<uint8_t>(p);
+      }
+
+      auto entry = offsets.try_emplace(data[i], static_cast<int64_t>(part_first_indices.size()));
+      if (entry.second) {
+        part_first_indices.push_back(static_cast<int64_t>(i));
+        part_counts.push_back(1);
+      } else {
+        ++part_counts[onnxruntime::narrow<size_t>(entry.first->second)];
+      }
+      inverse_index[i] = entry.first->second;
+    }
+  });
+
+  if (num_partitions == 1) {
+    first_indices = std::move(partition_first_indices[0]);
+    counts = std::move(partition_counts[0]);
+    return;
+  }
+
+  // concatenate the partitions and order their entries by first occurrence
+  std::vector<size_t> partition_offsets(num_partitions + 1, 0);
+  for (size_t p = 0; p < num_partitions; ++p) {
+    partition_offsets[p + 1] = partition_offsets[p] + partition_first_indices[p].size();
+  }
+
+  const size_t num_unique = partition_offsets.back();
+  std::vector<int64_t> concat_first_indices;
+  std::vector<int64_t> concat_counts;
+  concat_first_indices.reserve(num_unique);
+  concat_counts.reserve(num_unique);
+  for (size_t p = 0; p < num_partitions; ++p) {
+    concat_first_indices.insert(concat_first_indices.end(),
+                                partition_first_indices[p].begin(), partition_first_indices[p].end());
+    concat_counts.insert(concat_counts.end(), partition_counts[p].begin(), partition_counts[p].end());
+  }
+
+  std::vector<size_t> order(num_unique);
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [&concat_first_indices](size_t a, size_t b) {
+    return concat_first_indices[a] < concat_first_indices[b];
+  });
+
+  std::vector<int64_t> concat_to_unique(num_unique);
+  first_indices.resize(num_unique);
+  counts.resize(num_unique);
+  for (size_t u = 0; u < num_unique; ++u) {
+    concat_to_unique[order[u]] = static_cast<int64_t>(u);
+    first_indices[u] = concat_first_indices[order[u]];
+    counts[u] = concat_counts[order[u]];
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(n),
+      TensorOpCost{static_cast<double>(sizeof(int64_t) + 1), static_cast<double>(sizeof(int64_t)), 2.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const size_t offset = partition_offsets[value_partitions[i]] + onnxruntime::narrow<size_t>(inverse_index[i]);
+          inverse_index[i] = concat_to_unique[offset];
+        }
+      });
+}
+
 template <typename T>
 static void CreateFlattenedOutput(OpKernelContext& context,
-                                  const std::map<const T, int64_t>& offsets,         // map sorted key to unsorted idx
-                                  const std::vector<std::vector<int64_t>>& indices,  // unsorted
-                                  const std::vector<int64_t>& inverse_index,         // unsorted
+                                  gsl::span<const T> data,
+                                  const std::vector<int64_t>& first_indices,  // in order of first occurrence
+                                  const std::vector<int64_t>& unique_counts,  // in order of first occurrence
+                                  const std::vector<int64_t>& inverse_index,  // unique value of each input entry
                                   bool sorted) {
-  int64_t num_unique = static_cast<int64_t>(indices.size());
+  int64_t num_unique = static_cast<int64_t>(first_indices.size());
   Tensor& Y = *context.Output(0, {num_unique});
   Tensor* indices_out = context.Output(1, {num_unique});
   Tensor* inverse_indices = context.Output(2, {static_cast<int64_t>(inverse_index.size())});
@@ -164,41 +284,47 @@ static void CreateFlattenedOutput(OpKernelContext& context,
   gsl::span<int64_t> counts_data = counts != nullptr ? counts->MutableDataAsSpan<int64_t>()
                                                      : gsl::span<int64_t>();
 
-  // iterate using 'offsets' which is sorted, but contains the offset of the unsorted entry
-  auto offsets_iter = offsets.begin();
-  for (int64_t i = 0, end = num_unique; i < end; ++i, ++offsets_iter) {
-    // write sequentially if we want sorted output, use the unsorted_idx if not
-    auto unsorted_idx = offsets_iter->second;
-    auto output_idx = sorted ? i : unsorted_idx;
+  // output order of the unique values. NaNs are never equal so keep them in order of first occurrence.
+  std::vector<size_t> order(first_indices.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  if (sorted) {
+    std::stable_sort(order.begin(), order.end(), [&data, &first_indices](size_t a, size_t b) {
+      return UniqueLess(data[onnxruntime::narrow<size_t>(first_indices[a])],
+                        data[onnxruntime::narrow<size_t>(first_indices[b])]);
+    });
+  }
 
-    Y_data[onnxruntime::narrow<size_t>(output_idx)] = offsets_iter->first;
+  for (size_t i = 0, end = order.size(); i < end; ++i) {
+    const size_t unsorted_idx = order[i];
+    Y_data[i] = data[onnxruntime::narrow<size_t>(first_indices[unsorted_idx])];
 
     if (indices_out) {
-      indices_data[onnxruntime::narrow<size_t>(output_idx)] = indices[onnxruntime::narrow<size_t>(unsorted_idx)].front();
+      indices_data[i] = first_indices[unsorted_idx];
     }
 
     if (counts) {
-      counts_data[onnxruntime::narrow<size_t>(output_idx)] = indices[onnxruntime::narrow<size_t>(unsorted_idx)].size();
+      counts_data[i] = unique_counts[unsorted_idx];
     }
   }
 
   if (inverse_indices) {
     if (sorted) {
       // need to convert unsorted entries in the inverse index to their sorted values
-      std::vector<int64_t> unsorted_to_sorted;
-      unsorted_to_sorted.resize(onnxruntime::narrow<size_t>(num_unique));
-      int64_t sorted_idx = 0;
-      for (const auto& offset : offsets) {
-        unsorted_to_sorted[onnxruntime::narrow<size_t>(offset.second)] = sorted_idx++;
+      std::vector<int64_t> unsorted_to_sorted(order.size());
+      for (size_t i = 0, end = order.size(); i < end; ++i) {
+        unsorted_to_sorted[order[i]] = static_cast<int64_t>(i);
       }
 
-      for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
-        inverse_indices_data[onnxruntime::narrow<size_t>(i)] = unsorted_to_sorted[onnxruntime::narrow<size_t>(inverse_index[i])];
-      }
+      concurrency::ThreadPool::TryParallelFor(
+          context.GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(inverse_index.size()),
+          TensorOpCost{static_cast<double>(sizeof(int64_t)), static_cast<double>(sizeof(int64_t)), 1.0},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t i = first; i < last; ++i) {
+              inverse_indices_data[i] = unsorted_to_sorted[onnxruntime::narrow<size_t>(inverse_index[i])];
+            }
+          });
     } else {
-      for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
-        inverse_indices_data[i] = inverse_index[i];
-      }
+      std::copy(inverse_index.begin(), inverse_index.end(), inverse_indices_data.begin());
     }
   }
 }
@@ -308,30 +434,12 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
   auto data = input.DataAsSpan<T>();
 
   if (flatten_) {
-    std::map<const T, int64_t> offsets;  // offset of entry in indices. provides map between sorted and unsorted values
-    std::vector<std::vector<int64_t>> indices;
+    std::vector<int64_t> first_indices;
+    std::vector<int64_t> counts;
     std::vector<int64_t> inverse_index;
+    FindFlattenedUnique(data, context.GetOperatorThreadPool(), first_indices, counts, inverse_index);
 
-    indices.reserve(data.size() / 2);  // arbitrary value. at worst 1 realloc but could be too large
-    inverse_index.reserve(data.size());
-
-    int64_t num_unique = 0;
-
-    for (int64_t i = 0, end = input.Shape().Size(); i < end; ++i) {
-      auto entry = offsets.find(data[onnxruntime::narrow<size_t>(i)]);
-      if (entry == offsets.end()) {
-        offsets[data[onnxruntime::narrow<size_t>(i)]] = num_unique;
-        inverse_index.push_back({num_unique});
-        indices.push_back({i});
-        ++num_unique;
-      } else {
-        size_t indices_idx = onnxruntime::narrow<size_t>(entry->second);
-        indices[indices_idx].push_back(i);
-        inverse_index.push_back(onnxruntime::narrow<int64_t>(indices_idx));
-      }
-    }
-
-    CreateFlattenedOutput(context, offsets, indices, inverse_index, sort_);
+    CreateFlattenedOutput(context, data, first_indices, counts, inverse_index, sort_);
   } else {
     const auto& input_shape = input.Shape();
     const int64_t input_dims = static_cast<int64_t>(input_shape.NumDimensions());
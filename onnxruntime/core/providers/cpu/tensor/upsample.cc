@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "core/common/inlined_containers.h"
@@ -918,49 +920,61 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
+// The taps of the cubic interpolation of the output coordinates along one axis: for each output coordinate, the
+// input indices of its 4 taps clamped to the input, and their weights, which are renormalized to a sum of 1 without
+// the taps outside of the input when exclude_outside is set.
+struct CubicAxisTaps {
+  std::vector<int64_t> indices;
+  std::vector<float> weights;
+  // the output coordinates whose original coordinate is outside of the input, for use_extrapolation
+  std::vector<uint8_t> outside;
+};
 
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+static CubicAxisTaps SetupCubicAxisTaps(int64_t input_size, int64_t output_size, float scale,
+                                        float roi_start, float roi_end, float cubic_coeff_a,
+                                        bool use_extrapolation, bool exclude_outside,
+                                        const GetOriginalCoordinateFunc& get_original_coordinate) {
+  CubicAxisTaps taps;
+  taps.indices.resize(narrow<size_t>(output_size) * CubicModeGridLength);
+  taps.weights.resize(narrow<size_t>(output_size) * CubicModeGridLength);
+  taps.outside.resize(narrow<size_t>(output_size));
+
+  for (int64_t o = 0; o < output_size; ++o) {
+    float in = scale == 1 ? static_cast<float>(o)
+                          : get_original_coordinate(static_cast<float>(o), scale,
+                                                    static_cast<float>(output_size),
+                                                    static_cast<float>(input_size),
+                                                    roi_start, roi_end);
+    taps.outside[narrow<size_t>(o)] =
+        use_extrapolation && (in < 0 || in > static_cast<float>(input_size - 1));
+
+    auto in_int = static_cast<int64_t>(std::floor(in));
+    auto coeffs = GetCubicCoeffs(in - static_cast<float>(in_int), cubic_coeff_a);
+    float coeff_sum = 1;
+    if (exclude_outside) {
+      // When true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      coeff_sum = 0;
+      for (size_t i = 0; i < CubicModeGridLength; ++i) {
+        int64_t index = in_int - 1 + static_cast<int64_t>(i);
+        coeffs[i] = (index < 0 || index >= input_size) ? 0.0f : coeffs[i];
+        coeff_sum += coeffs[i];
+      }
+    }
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[narrow<size_t>(i)] / coeff_sum * orig_data;
+    for (size_t i = 0; i < CubicModeGridLength; ++i) {
+      const size_t tap = narrow<size_t>(o) * CubicModeGridLength + i;
+      taps.indices[tap] = std::clamp<int64_t>(in_int - 1 + static_cast<int64_t>(i), 0, input_size - 1);
+      taps.weights[tap] = coeffs[i] / coeff_sum;
+    }
   }
-  cache[grid_start_pos] = result;
 
-  return result;
+  return taps;
 }
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
+
+// Bicubic interpolation as two separable passes: the rows of the input that the output uses are interpolated along
+// the width, then the output rows are interpolated from them along the height, in contiguous loops over the width.
+// The taps are computed once per axis rather than per output pixel, and the channels are resized in parallel.
 template <typename T>
 void ResizeBiCubic(int64_t batch_size,
                    int64_t num_channels,
@@ -977,138 +991,94 @@ void ResizeBiCubic(int64_t batch_size,
                    gsl::span<const float> roi,
                    const T* Xdata,
                    T* Ydata,
-                   const GetOriginalCoordinateFunc& get_original_coordinate) {
-  std::vector<float> y_original;
-  y_original.reserve(narrow<size_t>(output_height));
-
-  std::vector<float> x_original;
-  x_original.reserve(narrow<size_t>(output_width));
-
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
+                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                   concurrency::ThreadPool* tp) {
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
 
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[narrow<size_t>(y)] - std::floor(y_original[narrow<size_t>(y)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[narrow<size_t>(x)] - std::floor(x_original[narrow<size_t>(x)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
+  const CubicAxisTaps y_taps = SetupCubicAxisTaps(input_height, output_height, height_scale,
+                                                  roi[roi_y_start], roi[roi_y_end], cubic_coeff_a,
+                                                  use_extrapolation, exclude_outside, get_original_coordinate);
+  const CubicAxisTaps x_taps = SetupCubicAxisTaps(input_width, output_width, width_scale,
+                                                  roi[roi_x_start], roi[roi_x_end], cubic_coeff_a,
+                                                  use_extrapolation, exclude_outside, get_original_coordinate);
+
+  // the input rows used by the output rows that are not extrapolated
+  std::vector<uint8_t> row_used(narrow<size_t>(input_height), 0);
+  for (size_t y = 0; y < y_taps.outside.size(); ++y) {
+    if (!y_taps.outside[y]) {
+      for (size_t i = 0; i < CubicModeGridLength; ++i) {
+        row_used[narrow<size_t>(y_taps.indices[y * CubicModeGridLength + i])] = 1;
+      }
     }
   }
 
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[narrow<size_t>(y)];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
-        }
-
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[narrow<size_t>(i)] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[narrow<size_t>(i)];
-            y_coeff_sum += y_coeff_holder[narrow<size_t>(i)];
+  const size_t out_w = narrow<size_t>(output_width);
+  const double cost_per_channel =
+      static_cast<double>(input_height + output_height) * static_cast<double>(output_width) * CubicModeGridLength * 2;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels),
+      TensorOpCost{static_cast<double>(input_height * input_width * sizeof(T)),
+                   static_cast<double>(output_height * output_width * sizeof(T)), cost_per_channel},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // the input rows interpolated along the width
+        std::vector<float> rows(narrow<size_t>(input_height) * out_w);
+
+        for (std::ptrdiff_t c = first; c < last; ++c) {
+          const T* X = Xdata + c * input_height * input_width;
+          T* Y = Ydata + c * output_height * output_width;
+
+          for (int64_t r = 0; r < input_height; ++r) {
+            if (!row_used[narrow<size_t>(r)]) {
+              continue;
+            }
+            const T* x_row = X + r * input_width;
+            float* row = rows.data() + narrow<size_t>(r) * out_w;
+            const int64_t* indices = x_taps.indices.data();
+            const float* weights = x_taps.weights.data();
+            for (size_t x = 0; x < out_w; ++x, indices += CubicModeGridLength, weights += CubicModeGridLength) {
+              float result = 0;
+              for (size_t i = 0; i < CubicModeGridLength; ++i) {
+                result += weights[i] * static_cast<float>(x_row[indices[i]]);
+              }
+              row[x] = result;
+            }
           }
-        }
 
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[narrow<size_t>(x)];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
-          }
+          for (size_t y = 0; y < y_taps.outside.size(); ++y) {
+            T* y_row = Y + y * out_w;
+            // when use_extrapolation is set and original index is out of the dim range
+            // then use extrapolation_value as the output value.
+            if (y_taps.outside[y]) {
+              std::fill_n(y_row, out_w, static_cast<T>(extrapolation_value));
+              continue;
+            }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[narrow<size_t>(i)] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[narrow<size_t>(i)];
-              x_coeff_sum += x_coeff_holder[narrow<size_t>(i)];
+            const int64_t* indices = y_taps.indices.data() + y * CubicModeGridLength;
+            const float* weights = y_taps.weights.data() + y * CubicModeGridLength;
+            const float* row0 = rows.data() + narrow<size_t>(indices[0]) * out_w;
+            const float* row1 = rows.data() + narrow<size_t>(indices[1]) * out_w;
+            const float* row2 = rows.data() + narrow<size_t>(indices[2]) * out_w;
+            const float* row3 = rows.data() + narrow<size_t>(indices[3]) * out_w;
+            const float w0 = weights[0], w1 = weights[1], w2 = weights[2], w3 = weights[3];
+            for (size_t x = 0; x < out_w; ++x) {
+              y_row[x] = static_cast<T>(row0[x] * w0 + row1[x] * w1 + row2[x] * w2 + row3[x] * w3);
             }
-          }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[narrow<size_t>(i)] / y_coeff_sum;
+            if (use_extrapolation) {
+              for (size_t x = 0; x < out_w; ++x) {
+                if (x_taps.outside[x]) {
+                  y_row[x] = static_cast<T>(extrapolation_value);
+                }
+              }
+            }
           }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
-      }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
-  }
+      });
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -1352,7 +1322,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
         ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                       height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                       extrapolation_value_, exclude_outside_, roi, X->Data<float>(),
-                      Y->MutableData<float>(), get_original_coordinate_);
+                      Y->MutableData<float>(), get_original_coordinate_,
+                      output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
       }
       return Status::OK();
     }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #ifndef SHARED_PROVIDER
 #include "core/framework/op_kernel.h"
@@ -109,26 +110,36 @@ void UpsampleBilinear(const int32_t batch_size,
               XdataBase + (n * num_channels + static_cast<int32_t>(c)) * (input_height * input_width);
           T* const Ydata = YdataBase + (n * num_channels + static_cast<int32_t>(c)) * (output_height * output_width);
           for (int32_t y = 0; y < output_height; ++y) {
-            for (int32_t x = 0; x < output_width; ++x) {
-              const int32_t output_offset = output_width * y + x;
-              // when use_extrapolation is set and original index of x or y is out of the dim range
-              // then use extrapolation_value as the output value.
-              if (use_extrapolation &&
-                  ((p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1)) ||
-                   (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1)))) {
-                Ydata[output_offset] = static_cast<T>(extrapolation_value);
-                continue;
-              }
+            T* const Yrow = Ydata + output_width * y;
+            // when use_extrapolation is set and original index of x or y is out of the dim range
+            // then use extrapolation_value as the output value.
+            if (use_extrapolation && (p.y_original[y] < 0 || p.y_original[y] > static_cast<float>(input_height - 1))) {
+              std::fill_n(Yrow, output_width, static_cast<T>(extrapolation_value));
+              continue;
+            }
 
-              T X11 = Xdata[p.input_width_mul_y1[y] + p.in_x1[x]];
-              T X21 = Xdata[p.input_width_mul_y1[y] + p.in_x2[x]];
-              T X12 = Xdata[p.input_width_mul_y2[y] + p.in_x1[x]];
-              T X22 = Xdata[p.input_width_mul_y2[y] + p.in_x2[x]];
+            // the row terms are loop invariant, so the loop over the width only gathers the 4 inputs of each output
+            const T* const Xrow1 = Xdata + p.input_width_mul_y1[y];
+            const T* const Xrow2 = Xdata + p.input_width_mul_y2[y];
+            const float dy1 = p.dy1[y];
+            const float dy2 = p.dy2[y];
+            for (int32_t x = 0; x < output_width; ++x) {
+              const int32_t in_x1 = p.in_x1[x];
+              const int32_t in_x2 = p.in_x2[x];
+              const float dx1 = p.dx1[x];
+              const float dx2 = p.dx2[x];
+              Yrow[x] = static_cast<T>(dx2 * dy2 * Xrow1[in_x1] +
+                                       dx1 * dy2 * Xrow1[in_x2] +
+                                       dx2 * dy1 * Xrow2[in_x1] +
+                                       dx1 * dy1 * Xrow2[in_x2]);
+            }
 
-              Ydata[output_offset] = static_cast<T>(p.dx2[x] * p.dy2[y] * X11 +
-                                                    p.dx1[x] * p.dy2[y] * X21 +
-                                                    p.dx2[x] * p.dy1[y] * X12 +
-                                                    p.dx1[x] * p.dy1[y] * X22);
+            if (use_extrapolation) {
+              for (int32_t x = 0; x < output_width; ++x) {
+                if (p.x_original[x] < 0 || p.x_original[x] > static_cast<float>(input_width - 1)) {
+                  Yrow[x] = static_cast<T>(extrapolation_value);
+                }
+              }
             }
           }
         });
@@ -4,6 +4,7 @@
 #include "string_normalizer.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 #include "onnxruntime_config.h"
 
 #ifdef _MSC_VER
@@ -17,8 +18,11 @@
 
 #endif  // _MSC_VER
 
+#include <algorithm>
+#include <atomic>
 #include <locale>
 #include <functional>
+#include <memory>
 #include <unordered_set>
 
 #if defined(__GNUC__)
@@ -214,10 +218,41 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS and not Apple
 
 #endif  // _MSC_VER
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
+// Strings that are all ASCII convert to and from wide strings char by char. This skips the converter, which
+// opens an iconv descriptor per call on Linux.
+inline bool IsAscii(const std::string& s) {
+  unsigned char bits = 0;
+  for (char c : s) {
+    bits |= static_cast<unsigned char>(c);
+  }
+  return bits < 0x80;
+}
+
+inline bool IsAscii(const std::wstring& wstr) {
+  return std::all_of(wstr.cbegin(), wstr.cend(), [](wchar_t ch) { return static_cast<uint32_t>(ch) < 0x80; });
+}
+
+std::wstring FromBytes(Utf8Converter& converter, const std::string& s) {
+  if (IsAscii(s)) {
+    return std::wstring(s.cbegin(), s.cend());
+  }
+  return converter.from_bytes(s);
+}
+
+std::string ToBytes(Utf8Converter& converter, const std::wstring& wstr) {
+  if (IsAscii(wstr)) {
+    return std::string(wstr.cbegin(), wstr.cend());
+  }
+  return converter.to_bytes(wstr);
+}
+
+// Cost of normalizing a string, the strings are normalized in parallel
+const TensorOpCost string_cost{static_cast<double>(sizeof(std::string) * 2),
+                               static_cast<double>(sizeof(std::string) * 2), 256.0};
+
+template <class RandomIter>
+Status CopyCaseAction(RandomIter first, RandomIter end, OpKernelContext* ctx,
                       const Locale& loc,
-                      Utf8Converter& converter,
                       size_t N, size_t C,
                       StringNormalizer::CaseAction caseaction) {
   std::vector<int64_t> output_dims;
@@ -240,27 +275,39 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->MutableData<std::string>();
 
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        // Please do not include the input text in the error message as it could
-        // be deemed as a compliance violation by teams using this operator
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars");
-      }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
+  if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
+    std::atomic<bool> invalid_utf8{false};
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(end - first), string_cost,
+        [&](std::ptrdiff_t range_first, std::ptrdiff_t range_last) {
+          // the standard converters are not thread safe, so each range has its own
+          Utf8Converter converter(conv_error, wconv_error);
+          for (std::ptrdiff_t i = range_first; i < range_last; ++i) {
+            std::wstring wstr = FromBytes(converter, first[i]);
+            if (wstr == wconv_error) {
+              invalid_utf8 = true;
+              return;
+            }
+            // In place transform
+            loc.ChangeCase(caseaction, wstr);
+            output_data[i] = ToBytes(converter, wstr);
+          }
+        });
+    if (invalid_utf8) {
+      // Please do not include the input text in the error message as it could
+      // be deemed as a compliance violation by teams using this operator
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                    "Input contains invalid utf8 chars");
+    }
+  } else {
+    assert(caseaction == StringNormalizer::NONE);
+    size_t output_idx = 0;
+    while (first != end) {
       // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+      *(output_data + output_idx) = std::move(*first);
+      ++output_idx;
+      ++first;
     }
-    ++output_idx;
-    ++first;
   }
   return Status::OK();
 }
@@ -306,7 +353,7 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
       auto p = stopwords_.insert(std::move(sw));
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
+      std::wstring wstr = FromBytes(converter, sw);
       ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
       locale.ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(std::move(wstr));
@@ -344,7 +391,6 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
 
   Status status;
   Locale locale(locale_name_);
-  Utf8Converter converter(conv_error, wconv_error);
   auto* const input_data = X->Data<std::string>();
   using StrRef = std::reference_wrapper<const std::string>;
   if (is_case_sensitive_) {
@@ -360,52 +406,70 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
         }
         ++first;
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
+      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale,
                               N, filtered_strings.size(), case_change_action_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, N, C, case_change_action_);
     }
   } else {
     if (!wstopwords_.empty()) {
       // Filter input. When no case action is required
       // we simply store original string references.
       // Otherwise, we store converted strings.
+      // The strings are cased for the comparison in parallel, then filtered in order.
+      std::vector<std::string> cased_strings(case_change_action_ == NONE ? 0 : C);
+      std::unique_ptr<bool[]> is_stopword = std::make_unique<bool[]>(C);
+      std::atomic<bool> invalid_utf8{false};
+      concurrency::ThreadPool::TryParallelFor(
+          ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(C), string_cost,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            Utf8Converter converter(conv_error, wconv_error);
+            for (std::ptrdiff_t i = first; i < last; ++i) {
+              std::wstring wstr = FromBytes(converter, input_data[i]);
+              if (wstr == wconv_error) {
+                invalid_utf8 = true;
+                return;
+              }
+              locale.ChangeCase(compare_caseaction_, wstr);
+              is_stopword[i] = wstopwords_.count(wstr) != 0;
+              if (case_change_action_ != NONE && !is_stopword[i]) {
+                cased_strings[i] = ToBytes(converter, wstr);
+              }
+            }
+          });
+      if (invalid_utf8) {
+        // Please do not include the input text in the error message as it could
+        // be deemed as a compliance violation by teams using this operator
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Input contains invalid utf8 chars");
+      }
+
+      // When no case action is required we simply store original string references.
+      // Otherwise, we store converted strings.
       InlinedVector<StrRef> filtered_orignal_strings;
       InlinedVector<std::string> filtered_cased_strings;
       filtered_orignal_strings.reserve(C);
       filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          // Please do not include the input text in the error message as it could
-          // be deemed as a compliance violation by teams using this operator
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars");
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
+      for (size_t i = 0; i < C; ++i) {
+        if (!is_stopword[i]) {
           if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
+            filtered_orignal_strings.push_back(std::cref(input_data[i]));
           } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            filtered_cased_strings.push_back(std::move(cased_strings[i]));
           }
         }
-        ++first;
       }
       if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
+        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale,
                                 N, filtered_orignal_strings.size(), NONE);
       } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
+        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale,
                                 N, filtered_cased_strings.size(), NONE);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, N, C, case_change_action_);
     }
   }
   return status;
@@ -6,6 +6,7 @@
 #include <limits>
 #include <string>
 #include "core/common/common.h"
+#include "core/platform/threadpool.h"
 namespace onnxruntime {
 
 ONNX_CPU_OPERATOR_KERNEL(StringSplit, 20,
@@ -24,21 +25,19 @@ void ComputeSubstrings(std::string_view str, std::string_view delimiter, int64_t
   }
   if (delimiter.empty()) {
     // Count consecutive whitespace as one delimiter. Preceding and trailing whitespace is meant to be ignored.
-    size_t pos = str.find_first_not_of(" ");
+    // The single character searches scan with memchr.
+    size_t pos = str.find_first_not_of(' ');
     int64_t token_count = 0;
     while (pos != std::string::npos) {
       if (token_count++ == max_splits) {
         // Trim down last substring as required in specification
-        size_t next_pos = str.length() - 1;
-        while (str[next_pos] == ' ') {
-          next_pos--;
-        }
+        size_t next_pos = str.find_last_not_of(' ');
         out.push_back(str.substr(pos, next_pos - pos + 1));
         break;
       } else {
-        auto next_pos = str.find_first_of(" ", pos);
+        auto next_pos = str.find(' ', pos);
         out.push_back(str.substr(pos, next_pos - pos));
-        pos = str.find_first_not_of(" ", next_pos);
+        pos = str.find_first_not_of(' ', next_pos);
       }
     }
   } else {
@@ -67,19 +66,24 @@ Status StringSplit::Compute(OpKernelContext* context) const {
 
   // Set up number of tokens output
   auto num_tokens_data = context->Output(1, input->Shape())->template MutableDataAsSpan<int64_t>();
-  auto num_tokens_iter = num_tokens_data.begin();
 
-  InlinedVector<InlinedVector<std::string_view>> input_slices;
-  input_slices.reserve(input_data.size());
-  size_t last_dim = 0;
+  // The strings are split and copied to the output in parallel, each string only touches its own slices and row.
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const TensorOpCost cost{static_cast<double>(sizeof(std::string) * 4), static_cast<double>(sizeof(std::string) * 4),
+                          64.0};
+  std::vector<InlinedVector<std::string_view>> input_slices(input_data.size());
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(input_data.size()), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t i = static_cast<size_t>(first), end = static_cast<size_t>(last); i < end; ++i) {
+          ComputeSubstrings(input_data[i], delimiter_, maxsplit_, input_slices[i]);
+          num_tokens_data[i] = static_cast<int64_t>(input_slices[i].size());
+        }
+      });
 
-  for (const auto& s : input_data) {
-    auto& substrs = input_slices.emplace_back();
-    ComputeSubstrings(s, delimiter_, maxsplit_, substrs);
-    auto substr_count = substrs.size();
-    last_dim = std::max(last_dim, substr_count);
-    *num_tokens_iter = static_cast<int64_t>(substr_count);
-    ++num_tokens_iter;
+  size_t last_dim = 0;
+  for (const auto& substrs : input_slices) {
+    last_dim = std::max(last_dim, substrs.size());
   }
 
   // Set up splits output
@@ -87,9 +91,14 @@ Status StringSplit::Compute(OpKernelContext* context) const {
   splits_shape.push_back(last_dim);
 
   auto splits_data = context->Output(0, splits_shape)->template MutableDataAsSpan<std::string>();
-  auto slices_iter = input_slices.begin();
-  for (auto output_splits_iter = splits_data.begin(); output_splits_iter != splits_data.end(); output_splits_iter += last_dim, ++slices_iter) {
-    std::copy(slices_iter->begin(), slices_iter->end(), output_splits_iter);
+  if (last_dim > 0) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(input_slices.size()), cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (size_t i = static_cast<size_t>(first), end = static_cast<size_t>(last); i < end; ++i) {
+            std::copy(input_slices[i].begin(), input_slices[i].end(), splits_data.begin() + i * last_dim);
+          }
+        });
   }
 
   return Status::OK();
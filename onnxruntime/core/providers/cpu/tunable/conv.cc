@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/conv.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace internal {
+
+enum class ConvAlgorithm {
+  kConfigured,  // what the kernel runs without tuning
+  kDefault,     // the algorithm picked by MlasConvPrepare
+  kWinograd,
+};
+
+// MlasConvPrepare splits the work by the degree of parallelism, so it runs under the same limit as MlasConv.
+template <ConvAlgorithm Algorithm>
+Status MlasConvOp(const ConvParams* params) {
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+  MlasConvPrepare(&parameters, params->dimensions, params->batch_count, params->group_count, params->input_channels,
+                  params->input_shape, params->kernel_shape, params->dilation_shape, params->padding,
+                  params->stride_shape, params->output_shape, params->filter_count, params->activation,
+                  &working_buffer_size, params->beta, params->thread_pool);
+
+  if constexpr (Algorithm == ConvAlgorithm::kConfigured) {
+    if (params->use_winograd) {
+      MlasConvWinogradPrepare(&parameters, &working_buffer_size, params->thread_pool);
+    }
+  } else if constexpr (Algorithm == ConvAlgorithm::kWinograd) {
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(
+        !MlasConvWinogradPrepare(&parameters, &working_buffer_size, params->thread_pool),
+        "Winograd does not apply to the convolution");
+  }
+
+  IAllocatorUniquePtr<float> working_buffer;
+  if (working_buffer_size > 0) {
+    working_buffer = IAllocator::MakeUniquePtr<float>(params->allocator, working_buffer_size);
+  }
+  MlasConv(&parameters, params->x, params->w, params->b, working_buffer.get(), params->y, params->thread_pool);
+  return Status::OK();
+}
+
+// Kernel 0 is what Conv runs without tuning. The next ones are the algorithm picked by MlasConvPrepare and then
+// Winograd, each on the whole thread pool followed by fewer threads.
+class ConvTunableOp : public TunableOp<ConvParams> {
+ public:
+  ConvTunableOp() {
+    this->RegisterOp(MlasConvOp<ConvAlgorithm::kConfigured>);
+    RegisterAlgorithm(MlasConvOp<ConvAlgorithm::kDefault>);
+    RegisterAlgorithm(MlasConvOp<ConvAlgorithm::kWinograd>);
+    this->SetDefaultId(0);
+  }
+
+  const ConvParams* PreTuning(const ConvParams* params) override {
+    if (params->beta != 0.0f) {
+      // The output holds the Sum input of a fused Conv/Sum and is accumulated into. Tune on a copy, otherwise the
+      // output would be accumulated into by every tuning run before the actual one.
+      ConvParams* proxy = new ConvParams(*params);
+      const size_t output_elements = params->OutputElements();
+      proxy->y = new float[output_elements];
+      std::copy_n(params->y, output_elements, proxy->y);
+      return proxy;
+    }
+
+    return params;
+  }
+
+  void PostTuning(const ConvParams* params) override {
+    if (params->beta != 0.0f) {
+      delete[] params->y;
+      delete params;
+    }
+  }
+
+ private:
+  void RegisterAlgorithm(Status (&op)(const ConvParams*)) {
+    this->RegisterOp(op);
+    for (int max_degree : kDegreeOfParallelismCandidates) {
+      this->RegisterOp(DegreeOfParallelismLimitedOp<ConvParams, Status (*)(const ConvParams*)>(op, max_degree));
+    }
+  }
+};
+
+}  // namespace internal
+
+std::string ConvParams::Signature() const {
+  std::ostringstream oss;
+  const auto append_shape = [&oss](const char* name, const int64_t* shape, size_t rank) {
+    oss << "_" << name;
+    for (size_t i = 0; i < rank; i++) {
+      oss << (i == 0 ? "" : "x") << shape[i];
+    }
+  };
+  oss << "N" << batch_count << "_G" << group_count << "_C" << input_channels << "_M" << filter_count;
+  append_shape("I", input_shape, dimensions);
+  append_shape("K", kernel_shape, dimensions);
+  append_shape("S", stride_shape, dimensions);
+  append_shape("D", dilation_shape, dimensions);
+  append_shape("P", padding, dimensions * 2);
+  // Kernel 0 and the degree of parallelism of the thread pool differ between sessions.
+  oss << (use_winograd ? "_W" : "") << "_T" << concurrency::ThreadPool::DegreeOfParallelism(thread_pool);
+  return oss.str();
+}
+
+size_t ConvParams::OutputElements() const {
+  SafeInt<size_t> elements = SafeInt<size_t>(batch_count) * group_count * filter_count;
+  for (size_t i = 0; i < dimensions; i++) {
+    elements *= static_cast<size_t>(output_shape[i]);
+  }
+  return elements;
+}
+
+Status Conv(const ConvParams* params) {
+  static internal::ConvTunableOp op;
+  return op(params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// A channels first single precision convolution, with the arguments of MlasConvPrepare and MlasConv.
+struct ConvParams : OpParams {
+  std::string Signature() const override;
+
+  // Number of elements of the output.
+  size_t OutputElements() const;
+
+  size_t dimensions;
+  size_t batch_count;
+  size_t group_count;
+  size_t input_channels;  // per group
+  const int64_t* input_shape;
+  const int64_t* kernel_shape;
+  const int64_t* dilation_shape;
+  const int64_t* padding;
+  const int64_t* stride_shape;
+  const int64_t* output_shape;
+  size_t filter_count;  // per group
+  const MLAS_ACTIVATION* activation;
+  float beta;
+  // Whether the kernel was configured to use Winograd when it applies, this is what kernel 0 does.
+  bool use_winograd;
+
+  const float* x;
+  const float* w;
+  const float* b;
+  float* y;
+
+  AllocatorPtr allocator;  // for the working buffer
+  concurrency::ThreadPool* thread_pool;
+};
+
+// Runs the convolution, tuning the algorithm (the one picked by MlasConvPrepare or Winograd) and the degree of
+// parallelism for the shape when tuning is enabled on the tuning context of params.
+Status Conv(const ConvParams* params);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <utility>
+
+#include "core/framework/tunable.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// Kernels run synchronously on the calling thread, there is no native stream.
+using OpParams = OpParams<CpuTuningContext, void*>;
+
+template <typename ParamsT>
+using Op = Op<ParamsT>;
+
+class Timer : public ITimer<void*> {
+ public:
+  using TimerBase = ITimer<void*>;
+
+  explicit Timer(void* stream) : TimerBase{stream} {}
+
+  void Start() override { start_ = std::chrono::steady_clock::now(); }
+  void End() override { end_ = std::chrono::steady_clock::now(); }
+  float Duration() override {
+    return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end_ - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+};
+
+template <typename ParamsT>
+using TunableOp = TunableOp<ParamsT, Timer>;
+
+// Degrees of parallelism tried in addition to the full thread pool. Kernels on small shapes, e.g. GEMMs with a
+// handful of rows at decode time, are often faster on fewer threads than MLAS partitions them to.
+constexpr std::array<int, 6> kDegreeOfParallelismCandidates{1, 2, 4, 8, 16, 32};
+
+// Wraps an implementation so that it runs with the degree of parallelism of the thread pool limited to
+// max_degree. The candidate is unsupported when the limit would not reduce the degree of parallelism, so that
+// the kernel ids registered by a tunable op do not depend on the size of the thread pool.
+template <typename ParamsT, typename ImplT>
+class DegreeOfParallelismLimitedOp {
+ public:
+  DegreeOfParallelismLimitedOp(ImplT impl, int max_degree) : impl_(std::move(impl)), max_degree_(max_degree) {}
+
+  Status operator()(const ParamsT* params) {
+    concurrency::ThreadPool::DegreeOfParallelismLimit limit(max_degree_);
+    return impl_(params);
+  }
+
+  Status IsSupported(const ParamsT* params) {
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(
+        max_degree_ >= concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool),
+        "degree of parallelism ", max_degree_, " is not below the one of the thread pool");
+    concurrency::ThreadPool::DegreeOfParallelismLimit limit(max_degree_);
+    if constexpr (HasIsSupportedMethod<ImplT, const ParamsT*>::value) {
+      return impl_.IsSupported(params);
+    } else {
+      return impl_(params);
+    }
+  }
+
+ private:
+  ImplT impl_;
+  int max_degree_;
+};
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
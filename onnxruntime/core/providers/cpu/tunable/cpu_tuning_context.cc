@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tuning_context.h"
+#define TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context_impl.h"
+#undef TUNING_CONTEXT_IMPL
+#include "core/graph/constants.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+std::string CpuTuningResultsValidator::GetOrtBuildConfig() const {
+  std::ostringstream oss;
+#if defined(_M_AMD64) || defined(__x86_64__)
+  oss << "ARCH=x86_64|";
+#elif defined(_M_IX86) || defined(__i386__)
+  oss << "ARCH=x86|";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+  oss << "ARCH=arm64|";
+#elif defined(_M_ARM) || defined(__arm__)
+  oss << "ARCH=arm|";
+#else
+  oss << "ARCH=other|";
+#endif
+  return oss.str();
+}
+
+// The kernels MLAS dispatches to depend on the instruction sets of the processor, so results tuned on one
+// processor family are not meaningful on another.
+std::string CpuTuningResultsValidator::GetCpuFeatures() const {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream oss;
+  oss << "AVX=" << cpuid_info.HasAVX()
+      << "|AVX2=" << cpuid_info.HasAVX2()
+      << "|AVX512F=" << cpuid_info.HasAVX512f()
+      << "|AVX512_BF16=" << cpuid_info.HasAVX512_BF16()
+      << "|AMX_BF16=" << cpuid_info.HasAMX_BF16()
+      << "|NEON_DOT=" << cpuid_info.HasArmNeonDot()
+      << "|NEON_I8MM=" << cpuid_info.HasArmNeon_I8MM()
+      << "|NEON_BF16=" << cpuid_info.HasArmNeon_BF16()
+      << "|HYBRID=" << cpuid_info.IsHybrid();
+  return oss.str();
+}
+
+Status CpuTuningResultsValidator::ValidateCpuFeatures(const std::string& value) const {
+  auto current = GetCpuFeatures();
+  ORT_RETURN_IF(current != value, "CPU features mismatch: tuning results produced with CPU features ", value,
+                ", onnxruntime currently run with CPU features ", current);
+  return Status::OK();
+}
+
+CpuTuningResultsValidator::CpuTuningResultsValidator() {
+  RegisterValidator(
+      "CPU_FEATURES",
+      [this]() { return GetCpuFeatures(); },
+      [this](const std::string& value) { return ValidateCpuFeatures(value); });
+}
+
+CpuTuningContext::CpuTuningContext(CPUExecutionProvider* ep, TunableOpInfo* info)
+    : ITuningContext(ep), info_(info) {}
+
+void CpuTuningContext::EnableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp for CPU Execution Provider";
+  info_->enable = true;
+}
+
+void CpuTuningContext::DisableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp for CPU Execution Provider";
+  info_->enable = false;
+}
+
+bool CpuTuningContext::IsTunableOpEnabled() const {
+  return info_->enable;
+}
+
+void CpuTuningContext::EnableTuning() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = true;
+}
+
+void CpuTuningContext::DisableTuning() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = false;
+}
+
+bool CpuTuningContext::IsTuningEnabled() const {
+  return info_->tuning_enable;
+}
+
+void CpuTuningContext::SetMaxTuningDurationMs(int max_duration_ms) {
+  info_->max_tuning_duration_ms = max_duration_ms;
+}
+
+int CpuTuningContext::GetMaxTuningDurationMs() const {
+  return info_->max_tuning_duration_ms > 0 ? info_->max_tuning_duration_ms : std::numeric_limits<int>::max();
+}
+
+TuningResultsManager& CpuTuningContext::GetTuningResultsManager() {
+  return manager_;
+}
+
+const TuningResultsManager& CpuTuningContext::GetTuningResultsManager() const {
+  return manager_;
+}
+
+const TuningResultsValidator& CpuTuningContext::GetTuningResultsValidator() const {
+  return validator_;
+}
+
+CpuTuningContext* GetEnabledTuningContext(const OpKernel& kernel) {
+  const auto* ep = kernel.Info().GetExecutionProvider();
+  if (ep == nullptr || ep->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+  auto* tuning_ctx = static_cast<CpuTuningContext*>(ep->GetTuningContext());
+  return tuning_ctx != nullptr && tuning_ctx->IsTunableOpEnabled() ? tuning_ctx : nullptr;
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/gemm.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace internal {
+
+Status MlasSgemmOp(const SgemmParams* params) {
+  MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k, params->data, params->batch,
+                params->thread_pool);
+  return Status::OK();
+}
+
+// Kernel 0 is MlasGemmBatch on the whole thread pool, the next ones run it on fewer threads.
+class SgemmTunableOp : public TunableOp<SgemmParams> {
+ public:
+  SgemmTunableOp() {
+    this->RegisterOp(MlasSgemmOp);
+    for (int max_degree : kDegreeOfParallelismCandidates) {
+      this->RegisterOp(DegreeOfParallelismLimitedOp<SgemmParams, decltype(&MlasSgemmOp)>(MlasSgemmOp, max_degree));
+    }
+    this->SetDefaultId(0);
+  }
+};
+
+}  // namespace internal
+
+std::string SgemmParams::Signature() const {
+  // The best degree of parallelism depends on the size of the thread pool the session runs with.
+  return MakeString(trans_a == CblasTrans ? "T" : "N", trans_b == CblasTrans ? "T" : "N", "_", m, "_", n, "_", k,
+                    "_B", batch, data[0].BIsPacked ? "_P" : "",
+                    "_D", concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+}
+
+Status Sgemm(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+             size_t m, size_t n, size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch,
+             concurrency::ThreadPool* thread_pool) {
+  SgemmParams params;
+  params.tuning_ctx = tuning_ctx;
+  params.trans_a = trans_a;
+  params.trans_b = trans_b;
+  params.m = m;
+  params.n = n;
+  params.k = k;
+  params.data = data;
+  params.batch = batch;
+  params.thread_pool = thread_pool;
+
+  for (size_t i = 0; i < batch; i++) {
+    ORT_RETURN_IF(data[i].beta != 0.0f, "Tunable SGEMM does not accumulate into the output");
+  }
+
+  static internal::SgemmTunableOp op;
+  return op(&params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// A batch of single precision GEMMs sharing their shape, as computed by MlasGemmBatch.
+struct SgemmParams : OpParams {
+  std::string Signature() const override;
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t m;
+  size_t n;
+  size_t k;
+  const MLAS_SGEMM_DATA_PARAMS* data;
+  size_t batch;
+  concurrency::ThreadPool* thread_pool;
+};
+
+// Runs MlasGemmBatch, tuning the degree of parallelism for the shape when tuning is enabled on tuning_ctx.
+// The outputs are overwritten by the tuning runs, so beta must be zero for every GEMM of the batch.
+Status Sgemm(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+             size_t m, size_t n, size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch,
+             concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
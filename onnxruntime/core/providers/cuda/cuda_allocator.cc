@@ -3,6 +3,7 @@
 
 #include "cuda_allocator.h"
 #include "cuda_common.h"
+#include "core/framework/stream_handles.h"
 #include "gpu_data_transfer.h"
 
 namespace onnxruntime {
@@ -86,6 +87,120 @@ void* CUDAExternalAllocator::Reserve(size_t size) {
   return p;
 }
 
+CUDAMemPoolAllocator::CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold)
+    : IAllocator(
+          OrtMemoryInfo(name, OrtAllocatorType::OrtDeviceAllocator,
+                        OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, device_id),
+                        device_id, OrtMemTypeDefault)) {
+  cudaMemPool_t pool;
+  CUDA_CALL_THROW(cudaDeviceGetDefaultMemPool(&pool, device_id));
+  // Without a threshold the pool returns its unused memory to the system each time a stream synchronizes.
+  uint64_t threshold = release_threshold;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+  pool_ = pool;
+}
+
+void* CUDAMemPoolAllocator::AllocOn(size_t size, Stream* stream) {
+  void* p = nullptr;
+  if (size == 0) {
+    return p;
+  }
+
+  cudaStream_t cuda_stream = stream != nullptr ? static_cast<cudaStream_t>(stream->GetHandle()) : nullptr;
+  CUDA_CALL_THROW(cudaMallocFromPoolAsync(&p, size, static_cast<cudaMemPool_t>(pool_), cuda_stream));
+  if (stream == nullptr) {
+    // The buffer may be used on any stream, so it must be allocated before returning.
+    CUDA_CALL_THROW(cudaStreamSynchronize(nullptr));
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  buffer_streams_[p] = stream;
+  return p;
+}
+
+void* CUDAMemPoolAllocator::Alloc(size_t size) {
+  return AllocOn(size, nullptr);
+}
+
+void* CUDAMemPoolAllocator::AllocOnStreamOrdered(size_t size, Stream* stream) {
+  return AllocOn(size, stream);
+}
+
+void CUDAMemPoolAllocator::Free(void* p) {
+  if (!p) return;
+  Stream* stream = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = buffer_streams_.find(p);
+    ORT_ENFORCE(it != buffer_streams_.end(), "The buffer was not allocated by this allocator");
+    stream = it->second;
+    buffer_streams_.erase(it);
+  }
+
+  // Like the buffers of StreamAwareArena, the buffer is only reused on its stream after its last use there.
+  // The frees do not throw since they may fail during shutdown.
+  if (stream != nullptr) {
+    cudaFreeAsync(p, static_cast<cudaStream_t>(stream->GetHandle()));
+  } else {
+    cudaFree(p);
+  }
+}
+
+void CUDAMemPoolAllocator::ReleaseStreamOrderedBuffers(Stream* stream) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (auto& buffer_stream : buffer_streams_) {
+    if (buffer_stream.second == stream) {
+      buffer_stream.second = nullptr;
+    }
+  }
+}
+
+void* CUDAThreadArenaAllocator::AllocOn(const AllocatorPtr& arena, size_t size, bool reserve) {
+  void* p = reserve ? arena->Reserve(size) : arena->Alloc(size);
+  if (p) {
+    std::lock_guard<OrtMutex> lock(lock_);
+    allocations_[p] = arena;
+  }
+  return p;
+}
+
+void* CUDAThreadArenaAllocator::Alloc(size_t size) {
+  AllocatorPtr arena;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = thread_arenas_.find(std::this_thread::get_id());
+    arena = it != thread_arenas_.end() ? it->second : default_arena_;
+  }
+  return AllocOn(arena, size, false);
+}
+
+void* CUDAThreadArenaAllocator::Reserve(size_t size) {
+  // Reserved buffers are shared by the threads, e.g. initializers.
+  return AllocOn(default_arena_, size, true);
+}
+
+void CUDAThreadArenaAllocator::Free(void* p) {
+  if (!p) return;
+  AllocatorPtr arena;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = allocations_.find(p);
+    ORT_ENFORCE(it != allocations_.end(), "The buffer was not allocated by this allocator");
+    arena = std::move(it->second);
+    allocations_.erase(it);
+  }
+  arena->Free(p);
+}
+
+void CUDAThreadArenaAllocator::SetThreadArena(AllocatorPtr arena) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  if (arena) {
+    thread_arenas_[std::this_thread::get_id()] = std::move(arena);
+  } else {
+    thread_arenas_.erase(std::this_thread::get_id());
+  }
+}
+
 void* CUDAPinnedAllocator::Alloc(size_t size) {
   void* p = nullptr;
   if (size > 0) {
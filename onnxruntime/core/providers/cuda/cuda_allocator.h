@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <thread>
+#include <unordered_map>
+
 #include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/platform/ort_mutex.h"
@@ -49,6 +52,61 @@ class CUDAExternalAllocator : public CUDAAllocator {
   InlinedHashSet<void*> reserved_;
 };
 
+// Allocates from the default memory pool of the device with cudaMallocAsync. The allocations and frees are ordered
+// on the stream of the value allocated, so the driver reuses the memory of a stream without any synchronization by
+// ORT, and the pool is shared with the other libraries of the process that allocate from it, e.g. PyTorch with its
+// cudaMallocAsync backend. Memory above release_threshold is returned to the system when the streams synchronize.
+// Buffers allocated without a stream, e.g. initializers, are allocated and freed synchronously.
+class CUDAMemPoolAllocator : public IAllocator {
+ public:
+  CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  bool IsStreamOrdered() const override { return true; }
+  void* AllocOnStreamOrdered(size_t size, Stream* stream) override;
+  void ReleaseStreamOrderedBuffers(Stream* stream) override;
+
+ private:
+  void* AllocOn(size_t size, Stream* stream);
+
+  void* pool_{nullptr};  // cudaMemPool_t
+  mutable OrtMutex lock_;
+  // The stream each live buffer was allocated on. Buffers outliving their stream, e.g. the outputs of a run, are
+  // moved to no stream and freed synchronously.
+  InlinedHashMap<void*, Stream*> buffer_streams_;
+};
+
+// Allocates on the arena set for the calling thread with SetThreadArena(), or on the default arena for the threads
+// without one. Each buffer is freed by the arena it was allocated from, whichever thread frees it.
+// Used when each thread captures its own CUDA graphs, so that the buffers a graph was captured with are never
+// handed to the runs of another thread.
+class CUDAThreadArenaAllocator : public IAllocator {
+ public:
+  CUDAThreadArenaAllocator(OrtDevice::DeviceId device_id, const char* name, AllocatorPtr default_arena)
+      : IAllocator(
+            OrtMemoryInfo(name, OrtAllocatorType::OrtDeviceAllocator,
+                          OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, device_id),
+                          device_id, OrtMemTypeDefault)),
+        default_arena_(std::move(default_arena)) {}
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  void* Reserve(size_t size) override;
+
+  // Set the arena of the calling thread, nullptr to use the default arena again.
+  void SetThreadArena(AllocatorPtr arena);
+
+ private:
+  void* AllocOn(const AllocatorPtr& arena, size_t size, bool reserve);
+
+  mutable OrtMutex lock_;
+  AllocatorPtr default_arena_;
+  std::unordered_map<std::thread::id, AllocatorPtr> thread_arenas_;
+  InlinedHashMap<void*, AllocatorPtr> allocations_;
+};
+
 // TODO: add a default constructor
 class CUDAPinnedAllocator : public IAllocator {
  public:
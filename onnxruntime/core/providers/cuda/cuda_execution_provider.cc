@@ -11,6 +11,7 @@
 #include "core/providers/cuda/cuda_fwd.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "core/providers/cuda/cuda_profiler.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
 
 #ifndef USE_CUDA_MINIMAL
 #ifndef DISABLE_CONTRIB_OPS
@@ -167,10 +168,19 @@ AllocatorPtr CUDAExecutionProvider::CreateCudaAllocator(OrtDevice::DeviceId devi
   }
 }
 
-CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, cudaStream_t stream, size_t /*gpu_mem_limit*/,
-                                                          ArenaExtendStrategy /*arena_extend_strategy*/, CUDAExecutionProviderExternalAllocatorInfo /*external_allocator_info*/,
-                                                          OrtArenaCfg* /*default_memory_arena_cfg*/) {
+CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, cudaStream_t stream, size_t gpu_mem_limit,
+                                                          ArenaExtendStrategy arena_extend_strategy, CUDAExecutionProviderExternalAllocatorInfo external_allocator_info,
+                                                          OrtArenaCfg* default_memory_arena_cfg, size_t max_num_cuda_graphs,
+                                                          bool graph_per_thread) {
   CUDA_CALL_THROW(cudaSetDevice(device_id));
+  if (graph_per_thread) {
+    // The graphs of this thread are captured and replayed on its own stream, with buffers from its own arena.
+    CUDA_CALL_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+    own_stream_ = true;
+    arena_ = CreateCudaAllocator(device_id, gpu_mem_limit, arena_extend_strategy, external_allocator_info,
+                                 default_memory_arena_cfg);
+  }
+  stream_ = stream;
 #ifndef USE_CUDA_MINIMAL
   CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
   CUBLAS_CALL_THROW(cublasLtCreate(&cublas_lt_handle_));
@@ -179,7 +189,11 @@ CUDAExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId de
   CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
   CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, stream));
 #endif
-  cuda_graph_.SetStream(stream);
+  cuda_graphs_.SetStream(stream);
+  cuda_graphs_.SetMaxNumGraphs(max_num_cuda_graphs);
+  if (graph_per_thread) {
+    cuda_graphs_.SetCaptureMode(cudaStreamCaptureModeThreadLocal);
+  }
 }
 
 CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
@@ -188,34 +202,51 @@ CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
   ORT_IGNORE_RETURN_VALUE(CUBLAS_CALL(cublasLtDestroy(cublas_lt_handle_)));
   ORT_IGNORE_RETURN_VALUE(CUDNN_CALL(cudnnDestroy(cudnn_handle_)));
 #endif
+  if (own_stream_) {
+    ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaStreamSynchronize(stream_)));
+    ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaStreamDestroy(stream_)));
+  }
 }
 
-bool CUDAExecutionProvider::PerThreadContext::IsGraphCaptureAllowed() const {
-  return regular_run_count_before_graph_capture_ >= min_num_runs_before_cuda_graph_capture_;
+bool CUDAExecutionProvider::PerThreadContext::IsGraphCaptureAllowed(const std::string& graph_annotation) const {
+  auto it = regular_run_count_before_graph_capture_.find(graph_annotation);
+  return it != regular_run_count_before_graph_capture_.end() &&
+         it->second >= min_num_runs_before_cuda_graph_capture_;
 }
 
-void CUDAExecutionProvider::PerThreadContext::CaptureBegin() {
-  cuda_graph_.Reset();
-  cuda_graph_.CaptureBegin();
+void CUDAExecutionProvider::PerThreadContext::CaptureBegin(const std::string& graph_annotation) {
+  cuda_graphs_.CaptureBegin(graph_annotation);
 }
 
 void CUDAExecutionProvider::PerThreadContext::CaptureEnd() {
-  cuda_graph_.CaptureEnd();
-  is_graph_captured_ = true;
+  cuda_graphs_.CaptureEnd();
+}
+
+bool CUDAExecutionProvider::PerThreadContext::IsGraphCaptured(const std::string& graph_annotation) const {
+  return cuda_graphs_.IsGraphCaptured(graph_annotation);
+}
+
+Status CUDAExecutionProvider::PerThreadContext::ReplayGraph(const std::string& graph_annotation) {
+  ORT_ENFORCE(IsGraphCaptured(graph_annotation));
+  return cuda_graphs_.Replay(graph_annotation);
 }
 
-bool CUDAExecutionProvider::PerThreadContext::IsGraphCaptured() const {
-  return is_graph_captured_;
+Status CUDAExecutionProvider::PerThreadContext::UpdateGraphBuffers(const std::string& graph_annotation,
+                                                                   const std::vector<GraphBuffer>& buffers) {
+  return cuda_graphs_.UpdateBuffers(graph_annotation, buffers);
 }
 
-Status CUDAExecutionProvider::PerThreadContext::ReplayGraph() {
-  ORT_ENFORCE(IsGraphCaptured());
-  return cuda_graph_.Replay();
+void CUDAExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture(
+    const std::string& graph_annotation) {
+  ++regular_run_count_before_graph_capture_[graph_annotation];
 }
 
-void CUDAExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture() {
-  ++regular_run_count_before_graph_capture_;
+namespace {
+// The session sets the annotation of every run when graph capture is enabled, see InferenceSession::Run().
+std::string GetCudaGraphAnnotation(const onnxruntime::RunOptions& run_options) {
+  return GetRunConfigOptions(run_options).GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation).value_or("");
 }
+}  // namespace
 
 void OverrideTunableOpInfoByEnv(CUDAExecutionProviderInfo& info) {
   if (auto env_tunable_op_enable = onnxruntime::ParseTestOnlyEnvironmentVariable<bool>(
@@ -254,6 +285,8 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
 
   // This scenario is not supported.
   ORT_ENFORCE(!(info.has_user_compute_stream && info.external_allocator_info.UseExternalAllocator()));
+  ORT_ENFORCE(!(info.use_cuda_mempool && (info.external_allocator_info.UseExternalAllocator() || info.enable_cuda_graph)),
+              "use_cuda_mempool can't be combined with an external allocator or CUDA graph.");
 
   if (info.has_user_compute_stream) {
     external_stream_ = true;
@@ -273,6 +306,13 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
     }
   }
 
+  if (info_.enable_cuda_graph_per_thread &&
+      (!info_.enable_cuda_graph || external_stream_ || info_.external_allocator_info.UseExternalAllocator())) {
+    LOGS_DEFAULT(WARNING) << "enable_cuda_graph_per_thread requires enable_cuda_graph, and no user compute stream "
+                             "or external allocator. It is ignored.";
+    info_.enable_cuda_graph_per_thread = false;
+  }
+
   size_t free = 0;
   size_t total = 0;
   CUDA_CALL_THROW(cudaMemGetInfo(&free, &total));
@@ -341,7 +381,8 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
     // get or create a context
     if (context_state_.retired_context_pool.empty()) {
       context = std::make_shared<PerThreadContext>(info_.device_id, stream_, info_.gpu_mem_limit,
-                                                   info_.arena_extend_strategy, info_.external_allocator_info, info_.default_memory_arena_cfg);
+                                                   info_.arena_extend_strategy, info_.external_allocator_info, info_.default_memory_arena_cfg,
+                                                   info_.cuda_graph_max_num_graphs, IsGraphCapturePerThread());
     } else {
       context = context_state_.retired_context_pool.back();
       context_state_.retired_context_pool.pop_back();
@@ -386,30 +427,77 @@ Status CUDAExecutionProvider::Sync() const {
   return Status::OK();
 }
 
-Status CUDAExecutionProvider::OnRunStart(const onnxruntime::RunOptions& /*run_options*/) {
+Status CUDAExecutionProvider::OnRunStart(const onnxruntime::RunOptions& run_options) {
   // always set CUDA device when session::Run() in case it runs in a worker thread
   CUDA_RETURN_IF_ERROR(cudaSetDevice(GetDeviceId()));
-  if (IsGraphCaptureEnabled() && GetPerThreadContext().IsGraphCaptureAllowed() && !GetPerThreadContext().IsGraphCaptured()) {
-    LOGS(*GetLogger(), INFO) << "Capturing the cuda graph for this model";
-    GetPerThreadContext().CaptureBegin();
+  // the device time of a run is only known if all its work is on one stream. record the start before a graph
+  // capture begins, as the events of a capturing stream are not recorded until the graph is replayed.
+  if ((use_ep_level_unified_stream_ || IsGraphCapturePerThread()) && CollectsRunStats(run_options)) {
+    cudaEvent_t start_event;
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&start_event));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(start_event, ComputeStream()));
+    std::lock_guard<OrtMutex> lock(run_stats_events_mutex_);
+    run_stats_start_events_[&run_options] = start_event;
+  }
+  if (IsGraphCaptureEnabled()) {
+    if (IsGraphCapturePerThread() && thread_arena_allocator_) {
+      thread_arena_allocator_->SetThreadArena(GetPerThreadContext().Arena());
+    }
+    const std::string graph_annotation = GetCudaGraphAnnotation(run_options);
+    if (GetPerThreadContext().IsGraphCaptureAllowed(graph_annotation) &&
+        !GetPerThreadContext().IsGraphCaptured(graph_annotation)) {
+      LOGS(*GetLogger(), INFO) << "Capturing the cuda graph for this model with annotation: " << graph_annotation;
+      GetPerThreadContext().CaptureBegin(graph_annotation);
+    }
   }
   return Status::OK();
 }
 
-Status CUDAExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& /*run_options*/) {
-  if (IsGraphCaptureEnabled() && !GetPerThreadContext().IsGraphCaptured()) {
-    if (GetPerThreadContext().IsGraphCaptureAllowed()) {
-      GetPerThreadContext().CaptureEnd();
-      // CUDA work issued to a capturing stream doesn’t actually run on the GPU,
-      // so run the captured graph here to actually execute the work.
-      ORT_RETURN_IF_ERROR(GetPerThreadContext().ReplayGraph());
-    } else {
-      GetPerThreadContext().IncrementRegularRunCountBeforeGraphCapture();
+Status CUDAExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& run_options) {
+  if (IsGraphCaptureEnabled()) {
+    const std::string graph_annotation = GetCudaGraphAnnotation(run_options);
+    if (!GetPerThreadContext().IsGraphCaptured(graph_annotation)) {
+      if (GetPerThreadContext().IsGraphCaptureAllowed(graph_annotation)) {
+        GetPerThreadContext().CaptureEnd();
+        // CUDA work issued to a capturing stream doesn’t actually run on the GPU,
+        // so run the captured graph here to actually execute the work.
+        ORT_RETURN_IF_ERROR(GetPerThreadContext().ReplayGraph(graph_annotation));
+      } else {
+        GetPerThreadContext().IncrementRegularRunCountBeforeGraphCapture(graph_annotation);
+      }
+    }
+    if (IsGraphCapturePerThread() && thread_arena_allocator_) {
+      thread_arena_allocator_->SetThreadArena(nullptr);
     }
   }
 
+  cudaEvent_t run_stats_start_event = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(run_stats_events_mutex_);
+    auto it = run_stats_start_events_.find(&run_options);
+    if (it != run_stats_start_events_.end()) {
+      run_stats_start_event = it->second;
+      run_stats_start_events_.erase(it);
+    }
+  }
+  if (run_stats_start_event != nullptr) {
+    // waits for the work of the run even without sync_stream, which is the cost of collecting the device time
+    cudaEvent_t end_event;
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&end_event));
+    auto destroy_events = gsl::finally([run_stats_start_event, end_event]() {
+      ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaEventDestroy(run_stats_start_event)));
+      ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaEventDestroy(end_event)));
+    });
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(end_event, ComputeStream()));
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(end_event));
+    float elapsed_ms = 0;
+    CUDA_RETURN_IF_ERROR(cudaEventElapsedTime(&elapsed_ms, run_stats_start_event, end_event));
+    AddRunStatsDeviceTime(run_options, static_cast<int64_t>(static_cast<double>(elapsed_ms) * 1000000));
+  }
+
   if (sync_stream) {
-    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(static_cast<cudaStream_t>(stream_)));
+    const cudaStream_t stream = IsGraphCapturePerThread() ? GetPerThreadContext().Stream() : stream_;
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
   }
 
   // The reason of !IsGraphCaptureEnabled():
@@ -433,12 +521,17 @@ bool CUDAExecutionProvider::IsGraphCaptureEnabled() const {
   return info_.enable_cuda_graph;
 }
 
-bool CUDAExecutionProvider::IsGraphCaptured() const {
-  return GetPerThreadContext().IsGraphCaptured();
+bool CUDAExecutionProvider::IsGraphCaptured(const std::string& graph_annotation) const {
+  return GetPerThreadContext().IsGraphCaptured(graph_annotation);
+}
+
+Status CUDAExecutionProvider::ReplayGraph(const std::string& graph_annotation) {
+  return GetPerThreadContext().ReplayGraph(graph_annotation);
 }
 
-Status CUDAExecutionProvider::ReplayGraph() {
-  return GetPerThreadContext().ReplayGraph();
+Status CUDAExecutionProvider::UpdateGraphBuffers(const std::string& graph_annotation,
+                                                 const std::vector<GraphBuffer>& buffers) {
+  return GetPerThreadContext().UpdateGraphBuffers(graph_annotation, buffers);
 }
 
 namespace cuda {
@@ -2515,6 +2608,19 @@ void CUDAExecutionProvider::RegisterStreamHandlers(IStreamCommandHandleRegistry&
   // This allocator must be the same to the allocator
   // used in AllocateBufferOnCPUPinned.
   auto allocator = allocators[GetOrtDeviceByMemType(OrtMemTypeCPU)];
+  if (IsGraphCapturePerThread()) {
+    // The runs of a thread use the stream and handles of its PerThreadContext.
+    RegisterCudaStreamHandles(stream_handle_registry,
+                              OrtDevice::GPU,
+                              allocator,
+                              false,
+                              [this]() {
+                                auto& context = GetPerThreadContext();
+                                return CudaStreamHandles{context.Stream(), context.CudnnHandle(), context.CublasHandle()};
+                              },
+                              info_);
+    return;
+  }
   RegisterCudaStreamHandles(stream_handle_registry,
                             OrtDevice::GPU,
                             allocator,
@@ -2545,9 +2651,29 @@ std::vector<AllocatorPtr> CUDAExecutionProvider::CreatePreferredAllocators() {
       // correct to use the GPU device id, unless we wanted to share the pinned memory allocator across devices,
       // at the risk the lifetime isn't managed correctly if one of those devices go away.
       0);
+  if (info_.use_cuda_mempool) {
+    const size_t release_threshold = info_.cuda_mempool_release_threshold;
+    AllocatorCreationInfo mempool_memory_info(
+        [release_threshold](OrtDevice::DeviceId id) {
+          return std::make_unique<CUDAMemPoolAllocator>(id, CUDA, release_threshold);
+        },
+        info_.device_id,
+        // the driver pools the memory, so no arena
+        false);
+    return std::vector<AllocatorPtr>{
+        CreateAllocator(mempool_memory_info),
+        CreateAllocator(pinned_memory_info),
+    };
+  }
+
+  AllocatorPtr cuda_allocator = CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
+                                                    info_.external_allocator_info, info_.default_memory_arena_cfg);
+  if (IsGraphCapturePerThread()) {
+    thread_arena_allocator_ = std::make_shared<CUDAThreadArenaAllocator>(info_.device_id, CUDA, std::move(cuda_allocator));
+    cuda_allocator = thread_arena_allocator_;
+  }
   return std::vector<AllocatorPtr>{
-      CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
-                          info_.external_allocator_info, info_.default_memory_arena_cfg),
+      cuda_allocator,
       CreateAllocator(pinned_memory_info),
   };
 }
@@ -5,11 +5,13 @@
 #pragma once
 
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "core/framework/arena_extend_strategy.h"
 #include "core/framework/execution_provider.h"
 #include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/cuda_execution_provider_info.h"
 #include "core/providers/cuda/cuda_graph.h"
 #include "core/providers/cuda/cuda_pch.h"
@@ -55,7 +57,7 @@ class CUDAExecutionProvider : public IExecutionProvider {
   cudaStream_t ComputeStream() {
     // this will return the CUDA EP level stream which can differ from the actual compute tasks stream
     // the compute task stream is supplied within OpKernelContext during inference
-    return stream_;
+    return IsGraphCapturePerThread() ? GetPerThreadContext().Stream() : stream_;
   }
 
   template <typename T>
@@ -92,8 +94,9 @@ class CUDAExecutionProvider : public IExecutionProvider {
   std::unique_ptr<profiling::EpProfiler> GetProfiler() override;
 
   bool IsGraphCaptureEnabled() const override;
-  bool IsGraphCaptured() const override;
-  Status ReplayGraph() override;
+  bool IsGraphCaptured(const std::string& graph_annotation) const override;
+  Status ReplayGraph(const std::string& graph_annotation) override;
+  Status UpdateGraphBuffers(const std::string& graph_annotation, const std::vector<GraphBuffer>& buffers) override;
   void RegisterStreamHandlers(IStreamCommandHandleRegistry& stream_handle_registry, AllocatorMap& allocators) const override;
   OrtDevice GetOrtDeviceByMemType(OrtMemType mem_type) const override;
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
@@ -107,16 +110,34 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   bool use_ep_level_unified_stream_ = false;
 
+  // Events recorded on the stream at the start of the runs that collect RunStats, by their run options, to report
+  // the time the device worked for each run. Only used when all the work of a run is on one stream.
+  OrtMutex run_stats_events_mutex_;
+  std::unordered_map<const RunOptions*, cudaEvent_t> run_stats_start_events_;
+
+  // Routes the allocations of the runs to the arenas of the PerThreadContexts when the graphs are per thread.
+  std::shared_ptr<CUDAThreadArenaAllocator> thread_arena_allocator_;
+
   // the tuning context might be altered when calling into a TunableOp
   mutable cuda::tunable::CudaTuningContext tuning_context_;
 
   class PerThreadContext final {
    public:
     PerThreadContext(OrtDevice::DeviceId device_id, cudaStream_t stream, size_t cuda_mem_limit, ArenaExtendStrategy arena_extend_strategy,
-                     CUDAExecutionProviderExternalAllocatorInfo external_alloc_info, OrtArenaCfg* arena_cfg);
+                     CUDAExecutionProviderExternalAllocatorInfo external_alloc_info, OrtArenaCfg* arena_cfg,
+                     size_t max_num_cuda_graphs, bool graph_per_thread);
     ~PerThreadContext();
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PerThreadContext);
 
+    cudaStream_t Stream() const {
+      return stream_;
+    }
+
+    // The arena of this thread when the graphs are per thread, nullptr otherwise.
+    const AllocatorPtr& Arena() const {
+      return arena_;
+    }
+
     cublasHandle_t CublasHandle() const {
       return cublas_handle_;
     }
@@ -168,14 +189,20 @@ class CUDAExecutionProvider : public IExecutionProvider {
       }
     }
 
-    bool IsGraphCaptureAllowed() const;
-    void CaptureBegin();
+    bool IsGraphCaptureAllowed(const std::string& graph_annotation) const;
+    void CaptureBegin(const std::string& graph_annotation);
     void CaptureEnd();
-    bool IsGraphCaptured() const;
-    Status ReplayGraph();
-    void IncrementRegularRunCountBeforeGraphCapture();
+    bool IsGraphCaptured(const std::string& graph_annotation) const;
+    Status ReplayGraph(const std::string& graph_annotation);
+    Status UpdateGraphBuffers(const std::string& graph_annotation, const std::vector<GraphBuffer>& buffers);
+    void IncrementRegularRunCountBeforeGraphCapture(const std::string& graph_annotation);
 
    private:
+    // The EP level stream, or the stream owned by this context when the graphs are per thread.
+    cudaStream_t stream_ = nullptr;
+    bool own_stream_ = false;
+    AllocatorPtr arena_;
+
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
     cublasLtHandle_t cublas_lt_handle_ = nullptr;
@@ -189,11 +216,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
     std::unique_ptr<cuda::IConstantBuffer<Float8E5M2>> constant_ones_float8e5m2_;
 #endif
 
-    // Cuda graph with multi threads will be supported in the future, so cuda_graph_
-    // is put under PerThreadContext.
-    CUDAGraph cuda_graph_;
-    bool is_graph_captured_ = false;
-    int regular_run_count_before_graph_capture_ = 0;
+    // The graphs are captured and replayed on stream_. With enable_cuda_graph_per_thread every thread has its own
+    // stream and arena, otherwise the runs of all the threads share the EP level stream and must not be concurrent.
+    CUDAGraphCache cuda_graphs_;
+    // The regular runs of each graph annotation, an evicted graph is captured again without regular runs as the
+    // memory it needs is still in the arena.
+    std::unordered_map<std::string, int> regular_run_count_before_graph_capture_;
 
     // There is chance that the second regular run allocates GPU memory for causes like:
     // (1) memory pattern is enabled. (2) arena allocation for stream.
@@ -242,6 +270,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   PerThreadContext& GetPerThreadContext() const;
   void ReleasePerThreadContext() const;
+
+  bool IsGraphCapturePerThread() const {
+    return info_.enable_cuda_graph && info_.enable_cuda_graph_per_thread;
+  }
 };
 
 }  // namespace onnxruntime
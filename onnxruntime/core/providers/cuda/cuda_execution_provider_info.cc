@@ -26,6 +26,10 @@ constexpr const char* kGpuExternalFree = "gpu_external_free";
 constexpr const char* kGpuExternalEmptyCache = "gpu_external_empty_cache";
 constexpr const char* kCudnnConvUseMaxWorkspace = "cudnn_conv_use_max_workspace";
 constexpr const char* kEnableCudaGraph = "enable_cuda_graph";
+constexpr const char* kCudaGraphMaxNumGraphs = "cuda_graph_max_num_graphs";
+constexpr const char* kEnableCudaGraphPerThread = "enable_cuda_graph_per_thread";
+constexpr const char* kUseCudaMemPool = "use_cuda_mempool";
+constexpr const char* kCudaMemPoolReleaseThreshold = "cuda_mempool_release_threshold";
 constexpr const char* kCudnnConv1dPadToNc1d = "cudnn_conv1d_pad_to_nc1d";
 constexpr const char* kTunableOpEnable = "tunable_op_enable";
 constexpr const char* kTunableOpTuningEnable = "tunable_op_tuning_enable";
@@ -112,6 +116,10 @@ CUDAExecutionProviderInfo CUDAExecutionProviderInfo::FromProviderOptions(const P
           .AddAssignmentToReference(cuda::provider_option_names::kDoCopyInDefaultStream, info.do_copy_in_default_stream)
           .AddAssignmentToReference(cuda::provider_option_names::kCudnnConvUseMaxWorkspace, info.cudnn_conv_use_max_workspace)
           .AddAssignmentToReference(cuda::provider_option_names::kEnableCudaGraph, info.enable_cuda_graph)
+          .AddAssignmentToReference(cuda::provider_option_names::kCudaGraphMaxNumGraphs, info.cuda_graph_max_num_graphs)
+          .AddAssignmentToReference(cuda::provider_option_names::kEnableCudaGraphPerThread, info.enable_cuda_graph_per_thread)
+          .AddAssignmentToReference(cuda::provider_option_names::kUseCudaMemPool, info.use_cuda_mempool)
+          .AddAssignmentToReference(cuda::provider_option_names::kCudaMemPoolReleaseThreshold, info.cuda_mempool_release_threshold)
           .AddAssignmentToReference(cuda::provider_option_names::kCudnnConv1dPadToNc1d, info.cudnn_conv1d_pad_to_nc1d)
           .AddAssignmentToReference(cuda::provider_option_names::kEnableSkipLayerNormStrictMode, info.enable_skip_layer_norm_strict_mode)
           .AddAssignmentToReference(cuda::provider_option_names::kPreferNHWCMode, info.prefer_nhwc)
@@ -162,6 +170,10 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const CUDAExecution
       {cuda::provider_option_names::kDoCopyInDefaultStream, MakeStringWithClassicLocale(info.do_copy_in_default_stream)},
       {cuda::provider_option_names::kCudnnConvUseMaxWorkspace, MakeStringWithClassicLocale(info.cudnn_conv_use_max_workspace)},
       {cuda::provider_option_names::kEnableCudaGraph, MakeStringWithClassicLocale(info.enable_cuda_graph)},
+      {cuda::provider_option_names::kCudaGraphMaxNumGraphs, MakeStringWithClassicLocale(info.cuda_graph_max_num_graphs)},
+      {cuda::provider_option_names::kEnableCudaGraphPerThread, MakeStringWithClassicLocale(info.enable_cuda_graph_per_thread)},
+      {cuda::provider_option_names::kUseCudaMemPool, MakeStringWithClassicLocale(info.use_cuda_mempool)},
+      {cuda::provider_option_names::kCudaMemPoolReleaseThreshold, MakeStringWithClassicLocale(info.cuda_mempool_release_threshold)},
       {cuda::provider_option_names::kCudnnConv1dPadToNc1d, MakeStringWithClassicLocale(info.cudnn_conv1d_pad_to_nc1d)},
       {cuda::provider_option_names::kTunableOpEnable, MakeStringWithClassicLocale(info.tunable_op.enable)},
       {cuda::provider_option_names::kTunableOpTuningEnable, MakeStringWithClassicLocale(info.tunable_op.tuning_enable)},
@@ -65,6 +65,19 @@ struct CUDAExecutionProviderInfo {
   bool cudnn_conv_use_max_workspace{true};
 
   bool enable_cuda_graph{false};
+  // The number of graphs kept when enable_cuda_graph is set, one per graph annotation of the runs.
+  // The least recently replayed graph is destroyed to capture a new one. 0 for no bound.
+  size_t cuda_graph_max_num_graphs{8};
+  // When enable_cuda_graph is set, each thread running the session captures and replays its own graphs, on its own
+  // stream and with its own memory arena, so that concurrent runs don't share the buffers of a graph. The inputs and
+  // outputs of each thread must be bound with their own IOBinding.
+  bool enable_cuda_graph_per_thread{false};
+  // Allocate the device memory from the default CUDA memory pool of the device with cudaMallocAsync instead of the
+  // BFC arena. The allocations are ordered on the streams of the values allocated, and the pool is shared with the
+  // other libraries of the process that allocate from it.
+  bool use_cuda_mempool{false};
+  // The bytes of unused memory the pool keeps when use_cuda_mempool is set, instead of returning them to the system.
+  size_t cuda_mempool_release_threshold{std::numeric_limits<size_t>::max()};
 
   // By default, for Conv1D, will pad [N,C,D] to [N,C,D,1], if turn on, will pad to [N,C,1,D].
   bool cudnn_conv1d_pad_to_nc1d{false};
@@ -104,11 +117,15 @@ struct std::hash<::onnxruntime::CUDAExecutionProviderInfo> {
                   (static_cast<size_t>(info.enable_skip_layer_norm_strict_mode) << 27) ^
                   (static_cast<size_t>(info.prefer_nhwc) << 28) ^
                   (static_cast<size_t>(info.use_ep_level_unified_stream) << 29) ^
-                  (static_cast<size_t>(info.use_tf32) << 30);
+                  (static_cast<size_t>(info.use_tf32) << 30) ^
+                  (static_cast<size_t>(info.enable_cuda_graph_per_thread) << 31);
     onnxruntime::HashCombine(data, value);
 
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
+    onnxruntime::HashCombine(info.cuda_graph_max_num_graphs, value);
+    onnxruntime::HashCombine(info.use_cuda_mempool, value);
+    onnxruntime::HashCombine(info.cuda_mempool_release_threshold, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
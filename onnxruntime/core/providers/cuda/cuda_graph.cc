@@ -3,13 +3,17 @@
 
 #include "core/providers/cuda/cuda_graph.h"
 
+#include <cstring>
+
 #include "core/providers/cuda/cuda_common.h"
+#include <cuda.h>
 #include <cuda_runtime_api.h>
 #include <driver_types.h>
 
 namespace onnxruntime {
 
-CUDAGraph::CUDAGraph(cudaStream_t stream) : stream_(stream) {
+CUDAGraph::CUDAGraph(cudaStream_t stream, cudaStreamCaptureMode capture_mode)
+    : stream_(stream), capture_mode_(capture_mode) {
 }
 
 void CUDAGraph::SetStream(cudaStream_t stream) {
@@ -22,11 +26,10 @@ void CUDAGraph::CaptureBegin() {
               "Create a new instance to capture a new graph.");
 
   CUDA_CALL_THROW(cudaStreamSynchronize(stream_));
-  // For now cuda graph can only work with a single thread. In the future, we
-  // will support multiple threads. For multiple threads with multiple graphs
-  // and streams, `cudaStreamCaptureModeGlobal` needs to be changed to
-  // `cudaStreamCaptureModeThreadLocal`
-  CUDA_CALL_THROW(cudaStreamBeginCapture(stream_, cudaStreamCaptureModeGlobal));
+  // With a single stream shared by the threads `cudaStreamCaptureModeGlobal` catches the unsafe calls of the other
+  // threads during the capture. With a graph and a stream per thread, the other threads keep running and only the
+  // calls of the capturing thread are checked with `cudaStreamCaptureModeThreadLocal`.
+  CUDA_CALL_THROW(cudaStreamBeginCapture(stream_, capture_mode_));
 }
 
 void CUDAGraph::CaptureEnd() {
@@ -38,8 +41,6 @@ void CUDAGraph::CaptureEnd() {
   has_graph_ = true;
   CUDA_CALL_THROW(cudaGraphInstantiate(&graph_exec_, graph_, NULL, NULL, 0));
   has_graph_exec_ = true;
-  CUDA_CALL_THROW(cudaGraphDestroy(graph_));
-  has_graph_ = false;
 }
 
 Status CUDAGraph::Replay() {
@@ -60,10 +61,294 @@ void CUDAGraph::Reset() {
     CUDA_CALL_THROW(cudaGraphExecDestroy(graph_exec_));
     has_graph_exec_ = false;
   }
+  has_buffers_ = false;
+  buffers_.clear();
 }
 
 CUDAGraph::~CUDAGraph() {
   Reset();
 }
 
+namespace {
+
+// A buffer the graph was captured with and the buffer to use instead.
+struct BufferRemap {
+  uintptr_t old_begin;
+  uintptr_t old_end;
+  uintptr_t new_begin;
+};
+
+// Move the pointers stored in the 8 bytes aligned words of [data, data + size) from the old buffers to the new
+// ones. Pointers are 8 bytes aligned in the kernel arguments, including the ones in the structs passed by value.
+bool RemapPointers(void* data, size_t size, const std::vector<BufferRemap>& remaps) {
+  bool changed = false;
+  auto* bytes = static_cast<unsigned char*>(data);
+  for (size_t offset = 0; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + offset, sizeof(word));
+    for (const auto& remap : remaps) {
+      if (word >= remap.old_begin && word < remap.old_end) {
+        word = word - remap.old_begin + remap.new_begin;
+        memcpy(bytes + offset, &word, sizeof(word));
+        changed = true;
+        break;
+      }
+    }
+  }
+  return changed;
+}
+
+bool RemapPointer(void*& p, const std::vector<BufferRemap>& remaps) {
+  return RemapPointers(&p, sizeof(p), remaps);
+}
+
+#if CUDA_VERSION >= 12040
+// The sizes of the kernel arguments are only available from the driver API.
+struct KernelNodeDriverApi {
+  using FuncGetParamInfoFn = CUresult (*)(CUfunction, size_t, size_t*, size_t*);
+  using GraphKernelNodeGetParamsFn = CUresult (*)(CUgraphNode, CUDA_KERNEL_NODE_PARAMS*);
+  using GraphKernelNodeSetParamsFn = CUresult (*)(CUgraphNode, const CUDA_KERNEL_NODE_PARAMS*);
+
+  FuncGetParamInfoFn func_get_param_info = nullptr;
+  GraphKernelNodeGetParamsFn graph_kernel_node_get_params = nullptr;
+  GraphKernelNodeSetParamsFn graph_kernel_node_set_params = nullptr;
+
+  bool IsAvailable() const {
+    return func_get_param_info && graph_kernel_node_get_params && graph_kernel_node_set_params;
+  }
+
+  static const KernelNodeDriverApi& Get() {
+    static const KernelNodeDriverApi api = Load();
+    return api;
+  }
+
+ private:
+  template <typename Fn>
+  static Fn GetEntryPoint(const char* symbol) {
+    void* fn = nullptr;
+    cudaDriverEntryPointQueryResult result;
+    if (cudaGetDriverEntryPoint(symbol, &fn, cudaEnableDefault, &result) != cudaSuccess ||
+        result != cudaDriverEntryPointSuccess) {
+      return nullptr;
+    }
+    return reinterpret_cast<Fn>(fn);
+  }
+
+  static KernelNodeDriverApi Load() {
+    KernelNodeDriverApi api;
+    api.func_get_param_info = GetEntryPoint<FuncGetParamInfoFn>("cuFuncGetParamInfo");
+    api.graph_kernel_node_get_params = GetEntryPoint<GraphKernelNodeGetParamsFn>("cuGraphKernelNodeGetParams");
+    api.graph_kernel_node_set_params = GetEntryPoint<GraphKernelNodeSetParamsFn>("cuGraphKernelNodeSetParams");
+    return api;
+  }
+};
+
+Status RemapKernelNode(cudaGraphNode_t node, const std::vector<BufferRemap>& remaps) {
+  const auto& api = KernelNodeDriverApi::Get();
+  ORT_RETURN_IF_NOT(api.IsAvailable(), "Updating the buffers of a CUDA graph requires a CUDA 12.4 driver");
+
+  CUDA_KERNEL_NODE_PARAMS params;
+  ORT_RETURN_IF_NOT(api.graph_kernel_node_get_params(node, &params) == CUDA_SUCCESS,
+                    "Failed to get the parameters of a CUDA graph kernel node");
+
+  bool changed = false;
+  std::vector<std::vector<unsigned char>> args;
+  std::vector<void*> arg_pointers;
+  std::vector<void*> extra;
+  if (params.kernelParams != nullptr) {
+    ORT_RETURN_IF(params.func == nullptr, "A CUDA graph kernel node has no function to get its arguments from");
+    size_t offset = 0;
+    size_t size = 0;
+    for (size_t i = 0; api.func_get_param_info(params.func, i, &offset, &size) == CUDA_SUCCESS; ++i) {
+      const auto* arg = static_cast<const unsigned char*>(params.kernelParams[i]);
+      args.emplace_back(arg, arg + size);
+      changed |= RemapPointers(args.back().data(), size, remaps);
+    }
+    for (auto& arg : args) {
+      arg_pointers.push_back(arg.data());
+    }
+    params.kernelParams = arg_pointers.data();
+  } else if (params.extra != nullptr) {
+    // The arguments are packed in one buffer:
+    // {CU_LAUNCH_PARAM_BUFFER_POINTER, buffer, CU_LAUNCH_PARAM_BUFFER_SIZE, &size, CU_LAUNCH_PARAM_END}
+    void* buffer = nullptr;
+    size_t* buffer_size = nullptr;
+    for (size_t i = 0; params.extra[i] != CU_LAUNCH_PARAM_END; i += 2) {
+      if (params.extra[i] == CU_LAUNCH_PARAM_BUFFER_POINTER) {
+        buffer = params.extra[i + 1];
+      } else if (params.extra[i] == CU_LAUNCH_PARAM_BUFFER_SIZE) {
+        buffer_size = static_cast<size_t*>(params.extra[i + 1]);
+      }
+    }
+    ORT_RETURN_IF(buffer == nullptr || buffer_size == nullptr,
+                  "A CUDA graph kernel node has an unsupported argument buffer");
+    const auto* arg = static_cast<const unsigned char*>(buffer);
+    args.emplace_back(arg, arg + *buffer_size);
+    changed = RemapPointers(args.back().data(), *buffer_size, remaps);
+    extra = {CU_LAUNCH_PARAM_BUFFER_POINTER, args.back().data(), CU_LAUNCH_PARAM_BUFFER_SIZE, buffer_size,
+             CU_LAUNCH_PARAM_END};
+    params.extra = extra.data();
+  }
+
+  if (changed) {
+    ORT_RETURN_IF_NOT(api.graph_kernel_node_set_params(node, &params) == CUDA_SUCCESS,
+                      "Failed to set the parameters of a CUDA graph kernel node");
+  }
+  return Status::OK();
+}
+#else
+Status RemapKernelNode(cudaGraphNode_t /*node*/, const std::vector<BufferRemap>& /*remaps*/) {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Updating the buffers of a CUDA graph requires CUDA 12.4");
+}
+#endif
+
+Status RemapGraphNode(cudaGraphNode_t node, const std::vector<BufferRemap>& remaps) {
+  cudaGraphNodeType type;
+  CUDA_RETURN_IF_ERROR(cudaGraphNodeGetType(node, &type));
+  switch (type) {
+    case cudaGraphNodeTypeKernel:
+      return RemapKernelNode(node, remaps);
+    case cudaGraphNodeTypeMemcpy: {
+      cudaMemcpy3DParms params;
+      CUDA_RETURN_IF_ERROR(cudaGraphMemcpyNodeGetParams(node, &params));
+      bool changed = RemapPointer(params.srcPtr.ptr, remaps);
+      changed |= RemapPointer(params.dstPtr.ptr, remaps);
+      if (changed) {
+        CUDA_RETURN_IF_ERROR(cudaGraphMemcpyNodeSetParams(node, &params));
+      }
+      return Status::OK();
+    }
+    case cudaGraphNodeTypeMemset: {
+      cudaMemsetParams params;
+      CUDA_RETURN_IF_ERROR(cudaGraphMemsetNodeGetParams(node, &params));
+      if (RemapPointer(params.dst, remaps)) {
+        CUDA_RETURN_IF_ERROR(cudaGraphMemsetNodeSetParams(node, &params));
+      }
+      return Status::OK();
+    }
+    case cudaGraphNodeTypeHost:
+    case cudaGraphNodeTypeEmpty:
+    case cudaGraphNodeTypeWaitEvent:
+    case cudaGraphNodeTypeEventRecord:
+      return Status::OK();
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                             "Can't update the buffers of a CUDA graph node of type ", static_cast<int>(type));
+  }
+}
+
+}  // namespace
+
+Status CUDAGraph::UpdateBuffers(const std::vector<GraphBuffer>& buffers) {
+  ORT_RETURN_IF_NOT(has_graph_ && has_graph_exec_, "No cuda graph was captured");
+  if (!has_buffers_) {
+    buffers_ = buffers;
+    has_buffers_ = true;
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_NOT(buffers.size() == buffers_.size(), "The run has ", buffers.size(),
+                    " inputs and outputs but the cuda graph was captured with ", buffers_.size());
+  std::vector<BufferRemap> remaps;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    // An output that isn't bound to a buffer is left where the graph writes it.
+    if (buffers[i].data == buffers_[i].data || buffers[i].data == nullptr) {
+      continue;
+    }
+    ORT_RETURN_IF(buffers_[i].data == nullptr || buffers[i].size != buffers_[i].size,
+                  "The buffer ", i, " of the run doesn't match the one the cuda graph was captured with");
+    const auto old_begin = reinterpret_cast<uintptr_t>(buffers_[i].data);
+    remaps.push_back({old_begin, old_begin + buffers_[i].size, reinterpret_cast<uintptr_t>(buffers[i].data)});
+  }
+  if (remaps.empty()) {
+    return Status::OK();
+  }
+
+  size_t num_nodes = 0;
+  CUDA_RETURN_IF_ERROR(cudaGraphGetNodes(graph_, nullptr, &num_nodes));
+  std::vector<cudaGraphNode_t> nodes(num_nodes);
+  CUDA_RETURN_IF_ERROR(cudaGraphGetNodes(graph_, nodes.data(), &num_nodes));
+  for (auto node : nodes) {
+    ORT_RETURN_IF_ERROR(RemapGraphNode(node, remaps));
+  }
+
+  // The topology is unchanged, so the instantiated graph is updated in place instead of instantiated again.
+#if CUDART_VERSION >= 12000
+  cudaGraphExecUpdateResultInfo result_info;
+  CUDA_RETURN_IF_ERROR(cudaGraphExecUpdate(graph_exec_, graph_, &result_info));
+  const cudaGraphExecUpdateResult result = result_info.result;
+#else
+  cudaGraphNode_t error_node = nullptr;
+  cudaGraphExecUpdateResult result;
+  CUDA_RETURN_IF_ERROR(cudaGraphExecUpdate(graph_exec_, graph_, &error_node, &result));
+#endif
+  ORT_RETURN_IF_NOT(result == cudaGraphExecUpdateSuccess, "Failed to update the cuda graph, result ",
+                    static_cast<int>(result));
+
+  LOGS_DEFAULT(VERBOSE) << "Updated " << remaps.size() << " buffers of the CUDA graph";
+  buffers_ = buffers;
+  return Status::OK();
+}
+
+CUDAGraphCache::CUDAGraphCache(cudaStream_t stream, size_t max_num_graphs)
+    : max_num_graphs_(max_num_graphs), stream_(stream) {
+}
+
+void CUDAGraphCache::SetStream(cudaStream_t stream) {
+  stream_ = stream;
+}
+
+void CUDAGraphCache::SetMaxNumGraphs(size_t max_num_graphs) {
+  max_num_graphs_ = max_num_graphs;
+}
+
+void CUDAGraphCache::SetCaptureMode(cudaStreamCaptureMode capture_mode) {
+  capture_mode_ = capture_mode;
+}
+
+void CUDAGraphCache::CaptureBegin(const std::string& graph_annotation) {
+  ORT_ENFORCE(!IsGraphCaptured(graph_annotation),
+              "A cuda graph has already been captured for annotation ", graph_annotation);
+  ORT_ENFORCE(capturing_graph_.second == nullptr, "Another cuda graph is being captured");
+
+  // Destroy the evicted graphs before capturing, so that their executables are released before a new one is
+  // instantiated. Replay() synchronizes the stream, so the evicted graphs are not running.
+  while (max_num_graphs_ > 0 && graphs_.size() >= max_num_graphs_) {
+    LOGS_DEFAULT(INFO) << "Destroying the least recently replayed CUDA graph with annotation "
+                       << graphs_.back().first;
+    graph_by_annotation_.erase(graphs_.back().first);
+    graphs_.pop_back();
+  }
+
+  capturing_graph_ = std::make_pair(graph_annotation, std::make_unique<CUDAGraph>(stream_, capture_mode_));
+  capturing_graph_.second->CaptureBegin();
+}
+
+void CUDAGraphCache::CaptureEnd() {
+  ORT_ENFORCE(capturing_graph_.second != nullptr, "No cuda graph is being captured");
+  auto graph = std::move(capturing_graph_);
+  capturing_graph_ = {};
+  graph.second->CaptureEnd();
+
+  graphs_.push_front(std::move(graph));
+  graph_by_annotation_[graphs_.front().first] = graphs_.begin();
+}
+
+bool CUDAGraphCache::IsGraphCaptured(const std::string& graph_annotation) const {
+  return graph_by_annotation_.find(graph_annotation) != graph_by_annotation_.end();
+}
+
+Status CUDAGraphCache::Replay(const std::string& graph_annotation) {
+  auto it = graph_by_annotation_.find(graph_annotation);
+  ORT_RETURN_IF(it == graph_by_annotation_.end(), "No cuda graph was captured for annotation ", graph_annotation);
+  graphs_.splice(graphs_.begin(), graphs_, it->second);
+  return it->second->second->Replay();
+}
+
+Status CUDAGraphCache::UpdateBuffers(const std::string& graph_annotation, const std::vector<GraphBuffer>& buffers) {
+  auto it = graph_by_annotation_.find(graph_annotation);
+  ORT_RETURN_IF(it == graph_by_annotation_.end(), "No cuda graph was captured for annotation ", graph_annotation);
+  return it->second->second->UpdateBuffers(buffers);
+}
+
 }  // namespace onnxruntime
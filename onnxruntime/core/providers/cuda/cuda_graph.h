@@ -3,7 +3,15 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "core/common/common.h"
+#include "core/framework/execution_provider.h"
 #include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cuda_pch.h"
 
@@ -13,7 +21,7 @@ using CaptureId_t = unsigned long long;
 
 struct CUDAGraph {
   CUDAGraph(){};
-  CUDAGraph(cudaStream_t stream);
+  CUDAGraph(cudaStream_t stream, cudaStreamCaptureMode capture_mode = cudaStreamCaptureModeGlobal);
   ~CUDAGraph();
 
   void SetStream(cudaStream_t stream);
@@ -22,7 +30,13 @@ struct CUDAGraph {
   Status Replay();
   void Reset();
 
+  // Record the buffers of the run the graph was captured with on the first call. On the next calls, patch the
+  // kernel, memcpy and memset nodes to use the given buffers instead of the recorded ones and update the
+  // instantiated graph with cudaGraphExecUpdate.
+  Status UpdateBuffers(const std::vector<GraphBuffer>& buffers);
+
  private:
+  // Kept after the instantiation for UpdateBuffers().
   cudaGraph_t graph_ = NULL;
   cudaGraphExec_t graph_exec_ = NULL;
 
@@ -30,6 +44,39 @@ struct CUDAGraph {
   bool has_graph_exec_ = false;
 
   cudaStream_t stream_ = nullptr;  // Does not own the stream
+  cudaStreamCaptureMode capture_mode_ = cudaStreamCaptureModeGlobal;
+
+  bool has_buffers_ = false;
+  std::vector<GraphBuffer> buffers_;
+};
+
+// The graphs captured for the different annotations of the runs, see kOrtRunOptionsConfigCudaGraphAnnotation.
+// When capturing a graph would exceed max_num_graphs, the least recently replayed graph is destroyed first.
+struct CUDAGraphCache {
+  CUDAGraphCache(){};
+  CUDAGraphCache(cudaStream_t stream, size_t max_num_graphs);
+
+  void SetStream(cudaStream_t stream);
+  void SetMaxNumGraphs(size_t max_num_graphs);  // 0 for no bound
+  void SetCaptureMode(cudaStreamCaptureMode capture_mode);
+  void CaptureBegin(const std::string& graph_annotation);
+  void CaptureEnd();
+  bool IsGraphCaptured(const std::string& graph_annotation) const;
+  Status Replay(const std::string& graph_annotation);
+  Status UpdateBuffers(const std::string& graph_annotation, const std::vector<GraphBuffer>& buffers);
+  size_t NumGraphs() const { return graphs_.size(); }
+
+ private:
+  // Most recently replayed first.
+  using GraphList = std::list<std::pair<std::string, std::unique_ptr<CUDAGraph>>>;
+  GraphList graphs_;
+  std::unordered_map<std::string, GraphList::iterator> graph_by_annotation_;
+  // The graph being captured, it is added to graphs_ once the capture ended.
+  std::pair<std::string, std::unique_ptr<CUDAGraph>> capturing_graph_;
+
+  size_t max_num_graphs_ = 0;
+  cudaStream_t stream_ = nullptr;  // Does not own the stream
+  cudaStreamCaptureMode capture_mode_ = cudaStreamCaptureModeGlobal;
 };
 
 }  // namespace onnxruntime
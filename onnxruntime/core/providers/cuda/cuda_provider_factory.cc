@@ -41,6 +41,7 @@ struct CUDAProviderFactory : IExecutionProviderFactory {
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
+  std::unique_ptr<IExecutionProvider> CreateProviderForDevice(int device_id) override;
 
  private:
   CUDAExecutionProviderInfo info_;
@@ -50,6 +51,12 @@ std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
   return std::make_unique<CUDAExecutionProvider>(info_);
 }
 
+std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProviderForDevice(int device_id) {
+  auto info = info_;
+  info.device_id = static_cast<OrtDevice::DeviceId>(device_id);
+  return std::make_unique<CUDAExecutionProvider>(info);
+}
+
 struct ProviderInfo_CUDA_Impl final : ProviderInfo_CUDA {
   OrtStatus* SetCurrentGpuDeviceId(_In_ int device_id) override {
     int num_devices;
@@ -158,6 +165,19 @@ struct ProviderInfo_CUDA_Impl final : ProviderInfo_CUDA {
     return num_devices;
   }
 
+  // Used by onnxruntime_pybind_mlvalue.cc to wrap tensors exported through __cuda_array_interface__
+  int cudaPointerGetDevice(const void* ptr) override {
+    cudaPointerAttributes attributes;
+    CUDA_CALL_THROW(::cudaPointerGetAttributes(&attributes, ptr));
+    ORT_ENFORCE(attributes.type == cudaMemoryTypeDevice || attributes.type == cudaMemoryTypeManaged,
+                "Pointer is not a CUDA device pointer.");
+    return attributes.device;
+  }
+
+  void cudaStreamSynchronize(void* stream) override {
+    CUDA_CALL_THROW(::cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
+  }
+
   void CUDAExecutionProviderInfo__FromProviderOptions(const ProviderOptions& options, CUDAExecutionProviderInfo& info) override {
     info = CUDAExecutionProviderInfo::FromProviderOptions(options);
   }
@@ -40,6 +40,8 @@ struct ProviderInfo_CUDA {
   virtual void cudaMemcpy_HostToDevice(void* dst, const void* src, size_t count) = 0;
   virtual void cudaMemcpy_DeviceToHost(void* dst, const void* src, size_t count) = 0;
   virtual int cudaGetDeviceCount() = 0;
+  virtual int cudaPointerGetDevice(const void* ptr) = 0;
+  virtual void cudaStreamSynchronize(void* stream) = 0;
   virtual void CUDAExecutionProviderInfo__FromProviderOptions(const onnxruntime::ProviderOptions& options, onnxruntime::CUDAExecutionProviderInfo& info) = 0;
 
 #if defined(USE_CUDA) && defined(ORT_USE_NCCL) && defined(USE_NCCL_P2P) && defined(ENABLE_TRAINING)
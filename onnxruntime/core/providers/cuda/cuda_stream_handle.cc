@@ -262,4 +262,21 @@ void RegisterCudaStreamHandles(IStreamCommandHandleRegistry& stream_handle_regis
     });
 }
 
+void RegisterCudaStreamHandles(IStreamCommandHandleRegistry& stream_handle_registry,
+                               const OrtDevice::DeviceType device_type,
+                               AllocatorPtr cpu_allocator,
+                               bool release_cpu_buffer_on_cuda_stream,
+                               std::function<CudaStreamHandles()> get_stream_handles,
+                               const CUDAExecutionProviderInfo& ep_info) {
+  stream_handle_registry.RegisterWaitFn(device_type, device_type, WaitCudaNotificationOnDevice);
+  stream_handle_registry.RegisterWaitFn(device_type, OrtDevice::CPU, WaitCudaNotificationOnHost);
+  stream_handle_registry.RegisterCreateStreamFn(device_type, [cpu_allocator,
+                                                              release_cpu_buffer_on_cuda_stream,
+                                                              get_stream_handles,
+                                                              ep_info](const OrtDevice& device) {
+    const CudaStreamHandles handles = get_stream_handles();
+    return std::make_unique<CudaStream>(handles.stream, device, cpu_allocator, release_cpu_buffer_on_cuda_stream, false, handles.cudnn_handle, handles.cublas_handle, ep_info);
+  });
+}
+
 }  // namespace onnxruntime
@@ -64,5 +64,21 @@ void RegisterCudaStreamHandles(IStreamCommandHandleRegistry& stream_handle_regis
                                cudnnHandle_t external_cudnn_handle,
                                cublasHandle_t external_cublass_handle,
                                const CUDAExecutionProviderInfo& ep_info);
+
+// The stream and the library handles wrapped by a CudaStream.
+struct CudaStreamHandles {
+  cudaStream_t stream;
+  cudnnHandle_t cudnn_handle;
+  cublasHandle_t cublas_handle;
+};
+
+// Like above with use_existing_stream, but the handles are the ones get_stream_handles returns when the CudaStream
+// is created, e.g. the handles of the thread running the session.
+void RegisterCudaStreamHandles(IStreamCommandHandleRegistry& stream_handle_registry,
+                               const OrtDevice::DeviceType device_type,
+                               AllocatorPtr cpu_allocator,
+                               bool release_cpu_buffer_on_cuda_stream,
+                               std::function<CudaStreamHandles()> get_stream_handles,
+                               const CUDAExecutionProviderInfo& ep_info);
 void WaitCudaNotificationOnDevice(Stream& stream, synchronize::Notification& notification);
 }  // namespace onnxruntime
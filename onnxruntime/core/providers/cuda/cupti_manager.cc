@@ -114,6 +114,9 @@ void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuff
               {"block_x", std::to_string(kernel->blockX)},
               {"block_y", std::to_string(kernel->blockY)},
               {"block_z", std::to_string(kernel->blockZ)},
+              // the resources that limit the occupancy of the kernel
+              {"registers_per_thread", std::to_string(kernel->registersPerThread)},
+              {"shared_memory", std::to_string(kernel->staticSharedMemory + kernel->dynamicSharedMemory)},
           };
 
           std::string name{demangle(kernel->name)};
@@ -3,13 +3,108 @@
 
 #include "core/providers/shared_library/provider_api.h"
 
+#include <algorithm>
+
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "cuda_common.h"
 
 namespace onnxruntime {
+namespace {
+bool IsPageableHostMemory(const OrtDevice& device) {
+  return device.Type() == OrtDevice::CPU && device.MemType() == OrtDevice::MemType::DEFAULT;
+}
+}  // namespace
+
 GPUDataTransfer::GPUDataTransfer() {}
 
-GPUDataTransfer::~GPUDataTransfer() {}
+GPUDataTransfer::~GPUDataTransfer() {
+  for (auto& entry : staging_buffers_) {
+    auto& staging = *entry.second;
+    for (int i = 0; i < kNumStagingBuffers; ++i) {
+      if (staging.events[i] != nullptr) {
+        // the last DMA may still be reading from or writing to the buffer
+        ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaEventSynchronize(staging.events[i])));
+        ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaEventDestroy(staging.events[i])));
+      }
+      if (staging.buffers[i] != nullptr) {
+        ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaFreeHost(staging.buffers[i])));
+      }
+    }
+  }
+}
+
+common::Status GPUDataTransfer::GetStagingBuffers(StagingBuffers*& staging) const {
+  int device_id = 0;
+  CUDA_RETURN_IF_ERROR(cudaGetDevice(&device_id));
+
+  auto& entry = staging_buffers_[device_id];
+  if (!entry) {
+    auto new_staging = std::make_unique<StagingBuffers>();
+    for (int i = 0; i < kNumStagingBuffers; ++i) {
+      CUDA_RETURN_IF_ERROR(cudaHostAlloc(&new_staging->buffers[i], kStagingBufferSize, cudaHostAllocPortable));
+      CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&new_staging->events[i], cudaEventDisableTiming));
+    }
+    entry = std::move(new_staging);
+  }
+
+  staging = entry.get();
+  return Status::OK();
+}
+
+common::Status GPUDataTransfer::StagedCopyHostToDevice(void* dst, const void* src, size_t bytes,
+                                                       cudaStream_t stream) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  StagingBuffers* staging = nullptr;
+  ORT_RETURN_IF_ERROR(GetStagingBuffers(staging));
+
+  for (size_t offset = 0, chunk = 0; offset < bytes; offset += kStagingBufferSize, ++chunk) {
+    const size_t chunk_bytes = std::min(kStagingBufferSize, bytes - offset);
+    const size_t i = chunk % kNumStagingBuffers;
+    // wait until the DMA issued from this buffer two chunks ago has drained it
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging->events[i]));
+    memcpy(staging->buffers[i], static_cast<const char*>(src) + offset, chunk_bytes);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(dst) + offset, staging->buffers[i], chunk_bytes,
+                                         cudaMemcpyHostToDevice, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(staging->events[i], stream));
+  }
+
+  // the source has been fully consumed, so the DMA of the last chunks can complete in stream order
+  return Status::OK();
+}
+
+common::Status GPUDataTransfer::StagedCopyDeviceToHost(void* dst, const void* src, size_t bytes,
+                                                       cudaStream_t stream) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  StagingBuffers* staging = nullptr;
+  ORT_RETURN_IF_ERROR(GetStagingBuffers(staging));
+
+  auto issue_chunk = [&](size_t chunk) -> Status {
+    const size_t offset = chunk * kStagingBufferSize;
+    const size_t i = chunk % kNumStagingBuffers;
+    // a host to device copy on another stream may still be reading from the buffer
+    CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(stream, staging->events[i], 0));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(staging->buffers[i], static_cast<const char*>(src) + offset,
+                                         std::min(kStagingBufferSize, bytes - offset), cudaMemcpyDeviceToHost,
+                                         stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(staging->events[i], stream));
+    return Status::OK();
+  };
+
+  const size_t num_chunks = (bytes + kStagingBufferSize - 1) / kStagingBufferSize;
+  ORT_RETURN_IF_ERROR(issue_chunk(0));
+  for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+    // start the DMA of the next chunk before draining the current one on the host
+    if (chunk + 1 < num_chunks) {
+      ORT_RETURN_IF_ERROR(issue_chunk(chunk + 1));
+    }
+    const size_t offset = chunk * kStagingBufferSize;
+    const size_t i = chunk % kNumStagingBuffers;
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging->events[i]));
+    memcpy(static_cast<char*>(dst) + offset, staging->buffers[i], std::min(kStagingBufferSize, bytes - offset));
+  }
+
+  return Status::OK();
+}
 
 bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
   return src_device.Type() == OrtDevice::GPU || src_device.MemType() == OrtDevice::MemType::CUDA_PINNED ||
@@ -34,12 +129,20 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst) const
       }
     } else {
       // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      if (IsPageableHostMemory(src_device) && bytes > kStagingBufferSize) {
+        ORT_RETURN_IF_ERROR(StagedCopyHostToDevice(dst_data, src_data, bytes, nullptr));
+      } else {
+        CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      }
       CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(nullptr));
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     // copying from GPU to CPU memory, this is blocking
-    CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+    if (IsPageableHostMemory(dst_device) && bytes > kStagingBufferSize) {
+      ORT_RETURN_IF_ERROR(StagedCopyDeviceToHost(dst_data, src_data, bytes, nullptr));
+    } else {
+      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+    }
     CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(nullptr));
   } else {
     // copying between cpu memory
@@ -59,8 +162,13 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
 
   if (dst_device.Type() == OrtDevice::GPU) {
     if (src_device.Type() == OrtDevice::CPU) {
-      // copy from pinned memory to GPU, this is non-blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream.GetHandle())));
+      if (IsPageableHostMemory(src_device) && bytes > kStagingBufferSize) {
+        // copy from pageable memory through the pinned staging buffers, this only blocks until the source is consumed
+        ORT_RETURN_IF_ERROR(StagedCopyHostToDevice(dst_data, src_data, bytes, static_cast<cudaStream_t>(stream.GetHandle())));
+      } else {
+        // copy from pinned memory to GPU, this is non-blocking
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream.GetHandle())));
+      }
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
       if (dst_data != src_data) {
@@ -69,8 +177,13 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU) {
-      // copying from GPU to pinned memory, this is non-blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, static_cast<cudaStream_t>(stream.GetHandle())));
+      if (IsPageableHostMemory(dst_device) && bytes > kStagingBufferSize) {
+        // copying from GPU to pageable memory through the pinned staging buffers, this is blocking
+        ORT_RETURN_IF_ERROR(StagedCopyDeviceToHost(dst_data, src_data, bytes, static_cast<cudaStream_t>(stream.GetHandle())));
+      } else {
+        // copying from GPU to pinned memory, this is non-blocking
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, static_cast<cudaStream_t>(stream.GetHandle())));
+      }
     }
   } else {
     if (src_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+
 #include "cuda_pch.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -19,6 +23,26 @@ class GPUDataTransfer : public IDataTransfer {
   using IDataTransfer::CopyTensor;
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const override;
   common::Status CopyTensorAsync(const Tensor& src, Tensor& dst, Stream& stream) const override;
+
+ private:
+  // Copies between pageable host memory and the GPU larger than one staging chunk are split into chunks and
+  // double buffered through pinned host memory, so the host side memcpy of one chunk overlaps the DMA of the other.
+  static constexpr int kNumStagingBuffers = 2;
+  static constexpr size_t kStagingBufferSize = 4 * 1024 * 1024;
+
+  struct StagingBuffers {
+    void* buffers[kNumStagingBuffers]{};
+    // recorded after the last DMA touching the buffer with the same index
+    cudaEvent_t events[kNumStagingBuffers]{};
+  };
+
+  common::Status GetStagingBuffers(StagingBuffers*& staging) const;
+  common::Status StagedCopyHostToDevice(void* dst, const void* src, size_t bytes, cudaStream_t stream) const;
+  common::Status StagedCopyDeviceToHost(void* dst, const void* src, size_t bytes, cudaStream_t stream) const;
+
+  // events are bound to the device they were created on, so keep one set of staging buffers per device
+  mutable std::unordered_map<int, std::unique_ptr<StagingBuffers>> staging_buffers_;
+  mutable OrtMutex staging_mutex_;
 };
 
 }  // namespace onnxruntime
@@ -8,6 +8,9 @@
 
 #ifdef USE_TRITON_KERNEL
 #include <dlfcn.h>
+#include <filesystem>
+#include <iterator>
+#include "nlohmann/json.hpp"
 #include "triton_kernel_infos.h"
 #endif
 
@@ -22,17 +25,6 @@
     }                                                                 \
   } while (0)
 
-#define ORT_TRITON_THROW(expr, msg)                                   \
-  do {                                                                \
-    auto status = expr;                                               \
-    const char* error_str;                                            \
-    if (status != CUDA_SUCCESS) {                                     \
-      auto get_status_err_str = cuGetErrorString(status, &error_str); \
-      ORT_UNUSED_PARAMETER(get_status_err_str);                       \
-      ORT_THROW(msg, error_str);                                      \
-    }                                                                 \
-  } while (0)
-
 namespace onnxruntime {
 namespace cuda {
 namespace {
@@ -70,6 +62,80 @@ Status GetSymbolFromLibrary(const std::string& symbol_name, void** symbol) {
   // It's possible to get a NULL symbol in our case when Schemas are not custom.
   return Status::OK();
 }
+
+// Environment variable with a directory of kernels compiled by Triton ahead of time, loaded in addition to the ones
+// built into the library. Each kernel is a <name>.cubin file with its launch metadata in <name>.json, which has the
+// same fields as the built-in kernel infos: name, func_name, group_name, num_warps, shared and constants.
+constexpr const char* kTritonKernelDirEnvVar = "ORT_TRITON_KERNEL_DIR";
+
+Status RegisterKernel(const void* image, const std::string& func_name, TritonKernelMetaData&& metadata,
+                      const std::string& group_name) {
+  // try to load module and get function
+  CUmodule module;
+  ORT_TRITON_CHECK(cuModuleLoadData(&module, image), "Loading module data failed.");
+
+  CUfunction function;
+  ORT_TRITON_CHECK(cuModuleGetFunction(&function, module, func_name.c_str()), "Getting function from module failed.");
+  metadata.func = function;
+
+  auto idx = ort_triton_kernel_metadata.size();
+  const std::string fname = metadata.name;
+  ort_triton_kernel_metadata.push_back(std::move(metadata));
+  ort_triton_kernel_map[fname] = idx;
+  ort_triton_kernel_group_map[group_name].push_back(idx);
+  LOGS_DEFAULT(VERBOSE) << "Loaded ort triton kernel: " << fname << " idx: " << idx;
+  return Status::OK();
+}
+
+// Loads the cubins in dir, so the kernels compiled ahead of time are used without rebuilding the library or JIT
+// compiling them. Kernels that cannot be loaded are skipped, as well as those with the name of a loaded kernel.
+void LoadKernelsFromDirectory(const std::string& dir) {
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, error)) {
+    const auto& cubin_path = entry.path();
+    if (cubin_path.extension() != ".cubin") {
+      continue;
+    }
+
+    auto json_path = cubin_path;
+    json_path.replace_extension(".json");
+    std::ifstream json_stream(json_path);
+    const auto info = nlohmann::json::parse(json_stream, nullptr, /*allow_exceptions*/ false);
+    if (info.is_discarded() || !info.is_object()) {
+      LOGS_DEFAULT(WARNING) << "Skipped triton kernel " << cubin_path << " without valid metadata in " << json_path;
+      continue;
+    }
+
+    TritonKernelMetaData metadata;
+    metadata.name = info.value("name", cubin_path.stem().string());
+    metadata.num_warps = info.value("num_warps", 4);
+    metadata.shared_mem_size = info.value("shared", 0);
+    if (info.contains("constants") && info["constants"].is_object()) {
+      for (const auto& [key, value] : info["constants"].items()) {
+        metadata.constants[key] = value.get<int>();
+      }
+    }
+
+    if (ort_triton_kernel_map.count(metadata.name) > 0) {
+      LOGS_DEFAULT(WARNING) << "Skipped triton kernel " << cubin_path << " named as the loaded kernel "
+                            << metadata.name;
+      continue;
+    }
+
+    std::ifstream cubin_stream(cubin_path, std::ios::binary);
+    const std::string image{std::istreambuf_iterator<char>(cubin_stream), std::istreambuf_iterator<char>()};
+    const std::string func_name = info.value("func_name", metadata.name);
+    const std::string group_name = info.value("group_name", std::string());
+    auto status = RegisterKernel(image.data(), func_name, std::move(metadata), group_name);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Skipped triton kernel " << cubin_path << ": " << status.ErrorMessage();
+    }
+  }
+
+  if (error) {
+    LOGS_DEFAULT(WARNING) << "Failed to list the triton kernels in " << dir << ": " << error.message();
+  }
+}
 #endif
 
 /*
@@ -89,32 +155,23 @@ void TryToLoadKernel() {
     void* buff;
     ORT_THROW_IF_ERROR(GetSymbolFromLibrary(k_i.name_start, &buff));
 
-    // try to load module and get function
-    CUmodule module;
-    ORT_TRITON_THROW(cuModuleLoadData(&module, buff), "Loading module data failed.");
-
-    CUfunction function;
-    ORT_TRITON_THROW(cuModuleGetFunction(&function, module, k_i.func_name), "Getting function from module failed.");
-
     // setup kernel metadata
     TritonKernelMetaData metadata;
     metadata.num_warps = k_i.num_warps;
     metadata.shared_mem_size = k_i.shared;
-    metadata.func = function;
-    std::string fname = k_i.name;  // name is not same as func_name
-    metadata.name = fname;
-    std::string group_name = k_i.group_name;
+    metadata.name = k_i.name;  // name is not same as func_name
 
     // pass constants
     for (auto& kv : k_i.constants) {
       metadata.constants[kv.first] = kv.second;
     }
 
-    auto idx = ort_triton_kernel_metadata.size();
-    ort_triton_kernel_metadata.push_back(metadata);
-    ort_triton_kernel_map[fname] = idx;
-    ort_triton_kernel_group_map[group_name].push_back(idx);
-    LOGS_DEFAULT(VERBOSE) << "Loaded ort triton kernel: " << fname << " idx: " << idx;
+    ORT_THROW_IF_ERROR(RegisterKernel(buff, k_i.func_name, std::move(metadata), k_i.group_name));
+  }
+
+  const std::string kernel_dir = GetEnvironmentVar(kTritonKernelDirEnvVar);
+  if (!kernel_dir.empty()) {
+    LoadKernelsFromDirectory(kernel_dir);
   }
 #endif
 
@@ -11,6 +11,9 @@
 #include "FusedGraphKernel.h"
 #include "MLOperatorAuthorImpl.h"
 #include "DmlGraphFusionHelper.h"
+#include <atomic>
+#include <future>
+#include <thread>
 
 
 namespace Dml
@@ -28,6 +31,51 @@ namespace Dml
             std::unordered_map<uint32_t, uint32_t> serializedGraphInputIndexToSubgraphInputIndex;
             std::unordered_map<std::string_view, uint32_t> serializedGraphLargeConstantNameToSubgraphInputIndex;
         };
+
+        // Compiles the graphs of the partitions, leaving the compiled operator of a partition null if it is too big.
+        // Compiling a graph is dominated by the shader compilation in DirectML and the driver, which runs on the calling
+        // thread. The DML device is free-threaded, so the partitions are compiled concurrently to cut session creation time.
+        void CompilePartitions(
+            const std::vector<std::shared_ptr<CompiledPartitionInfo>>& compiledPartitionInfos,
+            const ExecutionProviderImpl* providerImpl)
+        {
+            std::vector<CompiledPartitionInfo*> pendingPartitions;
+            for (const auto& compiledPartitionInfo : compiledPartitionInfos)
+            {
+                if (compiledPartitionInfo)
+                {
+                    pendingPartitions.push_back(compiledPartitionInfo.get());
+                }
+            }
+
+            const size_t threadCount = std::min<size_t>(pendingPartitions.size(), std::max(1u, std::thread::hardware_concurrency()));
+            std::atomic<size_t> nextPartition = 0;
+            auto compileNextPartitions = [&]()
+            {
+                for (size_t index = nextPartition++; index < pendingPartitions.size(); index = nextPartition++)
+                {
+                    auto& partition = *pendingPartitions[index];
+                    partition.compiledOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
+                        partition.graphDesc,
+                        partition.indexedSubGraph,
+                        providerImpl,
+                        &partition.serializedGraphInputIndexToSubgraphInputIndex,
+                        &partition.serializedGraphLargeConstantNameToSubgraphInputIndex);
+                }
+            };
+
+            // The calling thread is one of the workers. The futures rethrow the failures of the other workers.
+            std::vector<std::future<void>> workers;
+            for (size_t i = 1; i < threadCount; ++i)
+            {
+                workers.push_back(std::async(std::launch::async, compileNextPartitions));
+            }
+            compileNextPartitions();
+            for (auto& worker : workers)
+            {
+                worker.get();
+            }
+        }
     }
 
     DmlGraphFusionTransformer::DmlGraphFusionTransformer(
@@ -258,38 +306,31 @@ namespace Dml
                         serializedGraphLargeConstantNameToSubgraphInputIndex,
                         smallConstantData);
 
-                    // Compile the operator
-                    auto compiledPartition = DmlGraphFusionHelper::TryCreateCompiledOperator(
-                        graphDesc,
-                        indexedSubGraph,
-                        m_providerImpl,
-                        &serializedGraphInputIndexToSubgraphInputIndex,
-                        &serializedGraphLargeConstantNameToSubgraphInputIndex);
+                    auto compiledPartitionInfo = std::make_shared<CompiledPartitionInfo>();
+                    compiledPartitionInfo->indexedSubGraph = std::move(indexedSubGraph);
+                    compiledPartitionInfo->isInputsUploadedByDmlEP = std::move(isInputsUploadedByDmlEP);
+                    compiledPartitionInfo->graphDesc = std::move(graphDesc);
+                    compiledPartitionInfo->isInitializerTransferable = std::move(isInitializerTransferable);
+                    compiledPartitionInfo->smallConstantData = std::move(smallConstantData);
+                    compiledPartitionInfo->serializedGraphInputIndexToSubgraphInputIndex = std::move(serializedGraphInputIndexToSubgraphInputIndex);
+                    compiledPartitionInfo->serializedGraphLargeConstantNameToSubgraphInputIndex = std::move(serializedGraphLargeConstantNameToSubgraphInputIndex);
+                    compiledPartitionInfos[partitionIndex] = std::move(compiledPartitionInfo);
+                }
+            }
 
-                    if (!compiledPartition)
-                    {
-                        // Fail early if even a single operator is too big to compile. This is highly unlikely.
-                        ORT_THROW_HR_IF(E_INVALIDARG, indexedSubGraph.nodes.size() < 2);
+            CompilePartitions(compiledPartitionInfos, m_providerImpl);
 
-                        // Tell the partitioner to split the current partition in half, in the middle
-                        additionalSplittingNodes.push_back(indexedSubGraph.nodes[indexedSubGraph.nodes.size() / 2]);
+            for (auto& compiledPartitionInfo : compiledPartitionInfos)
+            {
+                if (compiledPartitionInfo && !compiledPartitionInfo->compiledOperator)
+                {
+                    const auto& indexedSubGraph = compiledPartitionInfo->indexedSubGraph;
 
-                        // Exit early since we need to repartition
-                        break;
-                    }
-                    else
-                    {
-                        auto compiledPartitionInfo = std::make_shared<CompiledPartitionInfo>();
-                        compiledPartitionInfo->compiledOperator = std::move(compiledPartition);
-                        compiledPartitionInfo->indexedSubGraph = std::move(indexedSubGraph);
-                        compiledPartitionInfo->isInputsUploadedByDmlEP = std::move(isInputsUploadedByDmlEP);
-                        compiledPartitionInfo->graphDesc = std::move(graphDesc);
-                        compiledPartitionInfo->isInitializerTransferable = std::move(isInitializerTransferable);
-                        compiledPartitionInfo->smallConstantData = std::move(smallConstantData);
-                        compiledPartitionInfo->serializedGraphInputIndexToSubgraphInputIndex = std::move(serializedGraphInputIndexToSubgraphInputIndex);
-                        compiledPartitionInfo->serializedGraphLargeConstantNameToSubgraphInputIndex = std::move(serializedGraphLargeConstantNameToSubgraphInputIndex);
-                        compiledPartitionInfos[partitionIndex] = std::move(compiledPartitionInfo);
-                    }
+                    // Fail early if even a single operator is too big to compile. This is highly unlikely.
+                    ORT_THROW_HR_IF(E_INVALIDARG, indexedSubGraph.nodes.size() < 2);
+
+                    // Tell the partitioner to split the partition in half, in the middle
+                    additionalSplittingNodes.push_back(indexedSubGraph.nodes[indexedSubGraph.nodes.size() / 2]);
                 }
             }
         }
@@ -13,9 +13,22 @@ void DnnlBinary::CreatePrimitive(DnnlSubgraphPrimitive& sp, DnnlNode& node) {
 
   dnnl::algorithm algo = dnnl_util::OrtOperatorToDnnlAlgorithm(node.OpType());
 
-  // GetMemory in OrtFormat. Broadcasting and mix format binary ops can result in computation failure
-  auto binary_src0_mem = sp.GetMemoryInOrtFormat(node.Input(IN_A), eng);
-  auto binary_src1_mem = sp.GetMemoryInOrtFormat(node.Input(IN_B), eng);
+  auto binary_src0_mem = sp.GetMemory(node.Input(IN_A));
+  auto binary_src1_mem = sp.GetMemory(node.Input(IN_B));
+  auto src_0_mem_md = binary_src0_mem.get_desc();
+  auto src_1_mem_md = binary_src1_mem.get_desc();
+  if (src_0_mem_md.get_dims() == src_1_mem_md.get_dims() &&
+      src_0_mem_md.get_data_type() == src_1_mem_md.get_data_type() &&
+      !sp.IsMemoryInExpectedOrtFormat(src_0_mem_md)) {
+    // Without broadcasting both inputs can use the blocked format of the first one, e.g. the output of a Conv on a
+    // residual connection, so that the format is kept for the next nodes instead of reordering to OrtFormat and back.
+    binary_src0_mem = sp.GetMemoryAndReshape(node.Input(IN_A), src_0_mem_md, eng);
+    binary_src1_mem = sp.GetMemoryAndReshape(node.Input(IN_B), src_0_mem_md, eng);
+  } else {
+    // GetMemory in OrtFormat. Broadcasting and mix format binary ops can result in computation failure
+    binary_src0_mem = sp.GetMemoryInOrtFormat(node.Input(IN_A), eng);
+    binary_src1_mem = sp.GetMemoryInOrtFormat(node.Input(IN_B), eng);
+  }
   auto src_0_ori_md = binary_src0_mem.get_desc();
   auto src_1_ori_md = binary_src1_mem.get_desc();
 
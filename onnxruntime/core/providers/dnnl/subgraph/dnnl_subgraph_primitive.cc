@@ -37,6 +37,7 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -276,27 +277,37 @@ void DnnlSubgraphPrimitive::Compile(const std::unordered_map<std::string, OnnxTe
     key += "|";
   }
   // if key different from shape key, update and recompile
-  if (key != shape_key_) {
-    shape_key_ = key;
-  } else {
+  if (key == shape_key_) {
+    return;
+  }
+
+  // keep the state of the previous shapes to switch back to it without compiling again
+  if (!shape_key_.empty()) {
+    ShapeState previous_state;
+    SwapShapeState(previous_state);
+    cached_shapes_.emplace_front(shape_key_, std::move(previous_state));
+  }
+  shape_key_ = key;
+
+  auto cached_shape = std::find_if(cached_shapes_.begin(), cached_shapes_.end(),
+                                   [&key](const auto& entry) { return entry.first == key; });
+  if (cached_shape != cached_shapes_.end()) {
+    LOGS_DEFAULT(INFO) << "Reusing the primitives compiled for the input shapes";
+    SwapShapeState(cached_shape->second);
+    cached_shapes_.erase(cached_shape);
     return;
   }
+  while (cached_shapes_.size() > kMaxCachedShapes) {
+    cached_shapes_.pop_back();
+  }
+
   if (IsDynamic()) {
     LOGS_DEFAULT(INFO) << "Dynamic Compile";
   } else {
     LOGS_DEFAULT(INFO) << "Static Compile";
   }
 
-  inputs_.clear();
-  intermediates_.clear();
-  outputs_.clear();
-  outputs_are_always_copied_.clear();
-  inputs_md_.clear();
-  outputs_md_.clear();
-  net_.clear();
-  net_args_.clear();
-  reshapes_.clear();
-  scalar_outputs_.clear();
+  // the state of the previous shapes was swapped out, so the current state is empty
   // initializer should not be cleared upon recompile
   // initializers_.clear();
 
@@ -321,6 +332,20 @@ void DnnlSubgraphPrimitive::Compile(const std::unordered_map<std::string, OnnxTe
   AddOutputs();
 }
 
+void DnnlSubgraphPrimitive::SwapShapeState(ShapeState& state) {
+  std::swap(intermediates_, state.intermediates);
+  std::swap(inputs_, state.inputs);
+  std::swap(inputs_md_, state.inputs_md);
+  std::swap(input_is_scalar_, state.input_is_scalar);
+  std::swap(outputs_, state.outputs);
+  std::swap(outputs_md_, state.outputs_md);
+  std::swap(outputs_are_always_copied_, state.outputs_are_always_copied);
+  std::swap(net_, state.net);
+  std::swap(net_args_, state.net_args);
+  std::swap(reshapes_, state.reshapes);
+  std::swap(scalar_outputs_, state.scalar_outputs);
+}
+
 dnnl::memory::format_tag DnnlSubgraphPrimitive::GetDnnlFormat(size_t dim_size) {
   dnnl::memory::format_tag source_format = dnnl::memory::format_tag::any;
   switch (dim_size) {
@@ -612,9 +637,16 @@ dnnl::memory DnnlSubgraphPrimitive::GetMemoryInOrtFormat(const DnnlTensor& tenso
   auto from_dims = from_desc.get_dims();
   if (!IsMemoryInExpectedOrtFormat(from_desc)) {
     dnnl::memory::desc to_md = dnnl::memory::desc(from_dims, tensor.Type(), GetDnnlFormat(from_dims.size()));
+    // a tensor in a blocked format read by several nodes in OrtFormat is only reordered once
+    if (HasMemory(tensor.Name(), to_md, eng)) {
+      return GetMemory(tensor, to_md, eng);
+    }
     dnnl::memory to_mem = dnnl::memory(to_md, eng);
     AddPrimitive(dnnl::reorder(from_mem, to_mem), {{DNNL_ARG_FROM, from_mem},
                                                    {DNNL_ARG_TO, to_mem}});
+    if (!Contains(initializers_, tensor.Name())) {
+      SetMemory(tensor.Name(), to_mem);
+    }
     return to_mem;
   } else {
     // If using GPU this will move the memory from the CPU to the GPU.
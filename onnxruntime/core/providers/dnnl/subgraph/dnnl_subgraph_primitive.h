@@ -2,6 +2,8 @@
 // Licensed under the MIT License
 
 #pragma once
+#include <list>
+
 #include "dnnl_subgraph.h"
 #include "dnnl.hpp"
 #include "core/platform/ort_mutex.h"
@@ -96,7 +98,30 @@ class DnnlSubgraphPrimitive {
   }
 
  private:
+  // The memories and primitives compiled for one set of input shapes.
+  struct ShapeState {
+    std::unordered_map<std::string, std::vector<dnnl::memory>> intermediates;
+    std::unordered_map<std::string, dnnl::memory> inputs;
+    std::unordered_map<std::string, dnnl::memory::desc> inputs_md;
+    std::unordered_set<std::string> input_is_scalar;
+    std::unordered_map<std::string, dnnl::memory> outputs;
+    std::unordered_map<std::string, dnnl::memory::desc> outputs_md;
+    std::unordered_set<std::string> outputs_are_always_copied;
+    std::vector<dnnl::primitive> net;
+    std::vector<std::unordered_map<int, dnnl::memory>> net_args;
+    std::vector<std::pair<dnnl::memory, dnnl::memory>> reshapes;
+    std::unordered_set<std::string> scalar_outputs;
+  };
+  // exchange the state of the current input shapes with state
+  void SwapShapeState(ShapeState& state);
+
+  // Number of input shape sets of a dynamic subgraph whose primitives are kept, so that alternating between them
+  // (e.g. between batch sizes) doesn't rebuild the primitives and intermediate memories on every run.
+  static constexpr size_t kMaxCachedShapes = 8;
+
   std::string shape_key_;
+  // the states of the other input shapes compiled before, most recently used first
+  std::list<std::pair<std::string, ShapeState>> cached_shapes_;
 
   std::unordered_map<std::string, std::vector<dnnl::memory>> intermediates_;
 
@@ -757,7 +757,7 @@ JsExecutionProvider::~JsExecutionProvider() {
 }
 
 Status JsExecutionProvider::OnRunStart(const onnxruntime::RunOptions& /*run_options*/) {
-  if (IsGraphCaptureEnabled() && IsGraphCaptureAllowed() && !IsGraphCaptured()) {
+  if (IsGraphCaptureEnabled() && IsGraphCaptureAllowed() && !is_graph_captured_) {
     LOGS(*GetLogger(), INFO) << "Capturing the webgpu graph for this model";
     EM_ASM({ Module.jsepCaptureBegin(); });
   }
@@ -765,7 +765,7 @@ Status JsExecutionProvider::OnRunStart(const onnxruntime::RunOptions& /*run_opti
 }
 
 Status JsExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& /*run_options*/) {
-  if (IsGraphCaptureEnabled() && !IsGraphCaptured()) {
+  if (IsGraphCaptureEnabled() && !is_graph_captured_) {
     if (IsGraphCaptureAllowed()) {
       EM_ASM({ Module.jsepCaptureEnd(); });
       is_graph_captured_ = true;
@@ -781,12 +781,12 @@ bool JsExecutionProvider::IsGraphCaptureEnabled() const {
   return enable_graph_capture_;
 }
 
-bool JsExecutionProvider::IsGraphCaptured() const {
+bool JsExecutionProvider::IsGraphCaptured(const std::string& /*graph_annotation*/) const {
   return is_graph_captured_;
 }
 
-Status JsExecutionProvider::ReplayGraph() {
-  ORT_ENFORCE(IsGraphCaptured());
+Status JsExecutionProvider::ReplayGraph(const std::string& /*graph_annotation*/) {
+  ORT_ENFORCE(is_graph_captured_);
   EM_ASM({ Module.jsepReplay(); });
   return Status::OK();
 }
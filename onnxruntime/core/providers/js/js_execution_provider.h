@@ -63,8 +63,9 @@ class JsExecutionProvider : public IExecutionProvider {
   Status OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& run_options) override;
 
   bool IsGraphCaptureEnabled() const override;
-  bool IsGraphCaptured() const override;
-  Status ReplayGraph() override;
+  // JS EP captures a single webgpu graph, which is shared by all the graph annotations.
+  bool IsGraphCaptured(const std::string& graph_annotation) const override;
+  Status ReplayGraph(const std::string& graph_annotation) override;
 
  private:
   bool IsGraphCaptureAllowed() const;
@@ -3,6 +3,7 @@
 
 #include "model_builder.h"
 
+#include <map>
 #include <unordered_map>
 
 #include "core/common/common.h"
@@ -11,6 +12,7 @@
 #include "core/common/safeint.h"
 #include "core/common/status.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/providers/common.h"
@@ -621,6 +623,17 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
           nnapi_model_->compilation_, static_cast<int32_t>(exe_pref_)),
       "on setPreference");
 
+  // The compilation cache is only available on API 29+
+  if (!compilation_cache_dir_.empty() && nnapi_effective_feature_level_ >= ANEURALNETWORKS_FEATURE_LEVEL_3 &&
+      nnapi_.ANeuralNetworksCompilation_setCaching != nullptr) {
+    uint8_t token[ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN];
+    GetCompilationCacheToken(token);
+    RETURN_STATUS_ON_ERROR_WITH_NOTE(
+        nnapi_.ANeuralNetworksCompilation_setCaching(
+            nnapi_model_->compilation_, compilation_cache_dir_.c_str(), token),
+        "on setCaching");
+  }
+
   RETURN_STATUS_ON_ERROR_WITH_NOTE(
       nnapi_.ANeuralNetworksCompilation_finish(nnapi_model_->compilation_),
       "on compilation finish");
@@ -629,6 +642,63 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
   return Status::OK();
 }
 
+void ModelBuilder::GetCompilationCacheToken(uint8_t* token) const {
+  // NNAPI does not detect token collisions, so everything the compiled model depends on is hashed,
+  // including the version of ORT which decides how the ONNX nodes are converted to NNAPI operations
+  uint32_t hash[4] = {0, 0, 0, 0};
+  const auto hash_str = [&hash](const std::string& str) {
+    MurmurHash3::x86_128(str.data(), gsl::narrow_cast<int32_t>(str.size()), hash[0], &hash);
+  };
+
+  hash_str(ORT_VERSION);
+  hash_str(MakeString(use_nchw_, use_fp16_, static_cast<int32_t>(exe_pref_),
+                      static_cast<int32_t>(target_device_option_)));
+  for (const auto& device : nnapi_target_devices_) {
+    hash_str(MakeString(device.name, ":", device.feature_level));
+  }
+
+  for (const auto* input : graph_viewer_.GetInputs()) {
+    hash_str(input->Name());
+    if (const auto* type = input->TypeAsProto()) {
+      hash_str(type->SerializeAsString());
+    }
+  }
+  for (const auto* output : graph_viewer_.GetOutputs()) {
+    hash_str(output->Name());
+  }
+
+  for (const auto node_index : graph_viewer_.GetNodesInTopologicalOrder()) {
+    const auto* node = graph_viewer_.GetNode(node_index);
+    hash_str(MakeString(node->Domain(), ":", node->OpType(), ":", node->SinceVersion()));
+    for (const auto* input : node->InputDefs()) {
+      hash_str(input->Name());
+    }
+    for (const auto* output : node->OutputDefs()) {
+      hash_str(output->Name());
+    }
+    // the attributes are hashed in name order as NodeAttributes is an unordered map
+    std::map<std::string, const ONNX_NAMESPACE::AttributeProto*> attributes;
+    for (const auto& [name, attribute] : node->GetAttributes()) {
+      attributes.emplace(name, &attribute);
+    }
+    for (const auto& [name, attribute] : attributes) {
+      hash_str(attribute->SerializeAsString());
+    }
+  }
+
+  std::map<std::string, const ONNX_NAMESPACE::TensorProto*> initializers(GetInitializerTensors().begin(),
+                                                                         GetInitializerTensors().end());
+  for (const auto& [name, tensor] : initializers) {
+    hash_str(tensor->SerializeAsString());
+  }
+
+  // the token is 32 bytes, fill it with two 128 bit hashes of the fingerprint
+  static_assert(static_cast<size_t>(ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN) == 2 * sizeof(hash));
+  memcpy(token, hash, sizeof(hash));
+  MurmurHash3::x86_128(hash, gsl::narrow_cast<int32_t>(sizeof(hash)), hash[3], &hash);
+  memcpy(token + sizeof(hash), hash, sizeof(hash));
+}
+
 int32_t ModelBuilder::FindActivation(const NodeUnit& node_unit) {
   const auto& output_def_size = node_unit.Outputs().size();
   if (output_def_size != 1) {
@@ -80,6 +80,10 @@ class ModelBuilder {
   void SetExecutePreference(
       android::nn::wrapper::ExecutePreference pref) { exe_pref_ = pref; }
 
+  // Set the directory where NNAPI caches the compiled model, available since API level 29
+  // The compilation is not cached if the directory is empty
+  void SetCompilationCacheDir(const std::string& cache_dir) { compilation_cache_dir_ = cache_dir; }
+
   // Accessors for members
   Shaper& GetShaper() { return shaper_; }
 
@@ -125,6 +129,7 @@ class ModelBuilder {
   bool use_fp16_{false};
   android::nn::wrapper::ExecutePreference exe_pref_{
       android::nn::wrapper::ExecutePreference::PREFER_FAST_SINGLE_ANSWER};
+  std::string compilation_cache_dir_;
 
   Shaper shaper_;
 
@@ -193,6 +198,10 @@ class ModelBuilder {
   // using the result of PreprocessNodeUnits, this need to run early in the Prepare()
   void PreprocessNodeUnits();
 
+  // Computes the token identifying the compiled model in the NNAPI compilation cache from the nodes and
+  // initializers of the graph, the options of the compilation and the target devices
+  void GetCompilationCacheToken(uint8_t* token) const;
+
   common::Status SetOperandValue(uint32_t index, Model::NNMemory* memory, size_t size, size_t offset);
 
   common::Status AddNewNNAPIOperand(const android::nn::wrapper::OperandType& type, uint32_t& index);
@@ -49,10 +49,14 @@ std::unordered_set<std::string> GetPartitioningStopOps(const optional<std::strin
 }  // namespace
 
 NnapiExecutionProvider::NnapiExecutionProvider(uint32_t nnapi_flags,
-                                               const optional<std::string>& partitioning_stop_ops_list)
+                                               const optional<std::string>& partitioning_stop_ops_list,
+                                               const std::string& compilation_cache_dir,
+                                               size_t min_partition_size)
     : IExecutionProvider{onnxruntime::kNnapiExecutionProvider},
       nnapi_flags_(nnapi_flags),
-      partitioning_stop_ops_(GetPartitioningStopOps(partitioning_stop_ops_list)) {
+      partitioning_stop_ops_(GetPartitioningStopOps(partitioning_stop_ops_list)),
+      compilation_cache_dir_(compilation_cache_dir),
+      min_partition_size_(min_partition_size) {
   nnapi_handle_ = NnApiImplementation();
   ORT_ENFORCE(nnapi_handle_ != nullptr, "Failed to get NnApiImplementation");
 
@@ -206,6 +210,23 @@ NnapiExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_view
     }
   });
 
+  // Each partition adds a round trip of its inputs and outputs to the NNAPI device, which a small partition that was
+  // split off by a single unsupported node does not make up for. If there are multiple partitions, leave the small
+  // ones to the other EPs.
+  if (min_partition_size_ > 0 &&
+      std::count_if(result.begin(), result.end(), [](const auto& capability) { return capability != nullptr; }) > 1) {
+    for (auto& capability : result) {
+      if (capability && capability->sub_graph->nodes.size() < min_partition_size_) {
+        LOGS_DEFAULT(VERBOSE) << "Partition " << capability->sub_graph->GetMetaDef()->name << " with "
+                              << capability->sub_graph->nodes.size() << " nodes is smaller than the minimum size "
+                              << min_partition_size_ << " and will not be run by NNAPI";
+        capability.reset();
+      }
+    }
+  }
+
+  result.erase(std::remove(result.begin(), result.end(), nullptr), result.end());
+
   const auto num_of_partitions = result.size();
   const auto num_of_supported_nodes = std::accumulate(
       result.begin(), result.end(), size_t{0},
@@ -278,6 +299,7 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<FusedNodeAndGra
     nnapi::ModelBuilder builder(graph_viewer, *nnapi_handle_, nnapi_target_devices_, target_device_option_);
     builder.SetUseNCHW(nnapi_flags_ & NNAPI_FLAG_USE_NCHW);
     builder.SetUseFp16(nnapi_flags_ & NNAPI_FLAG_USE_FP16);
+    builder.SetCompilationCacheDir(compilation_cache_dir_);
 
     std::unique_ptr<nnapi::Model> nnapi_model;
     ORT_RETURN_IF_ERROR(builder.Compile(nnapi_model));
@@ -19,7 +19,9 @@ class Model;
 class NnapiExecutionProvider : public IExecutionProvider {
  public:
   explicit NnapiExecutionProvider(uint32_t nnapi_flags,
-                                  const optional<std::string>& partitioning_stop_ops_list = {});
+                                  const optional<std::string>& partitioning_stop_ops_list = {},
+                                  const std::string& compilation_cache_dir = {},
+                                  size_t min_partition_size = 0);
 
   virtual ~NnapiExecutionProvider();
 
@@ -43,6 +45,13 @@ class NnapiExecutionProvider : public IExecutionProvider {
 
   const std::unordered_set<std::string> partitioning_stop_ops_;
 
+  // Directory of the NNAPI compilation cache, the compiled models are not cached if it is empty
+  const std::string compilation_cache_dir_;
+
+  // If the graph is split in multiple NNAPI partitions, the partitions with fewer nodes than this are left to the
+  // other EPs, as the cost of the transfers to the NNAPI device outweighs running them there
+  const size_t min_partition_size_;
+
   std::unordered_map<std::string, std::unique_ptr<onnxruntime::nnapi::Model>> nnapi_models_;
 
   // For Android NNAPI and stub implementation.
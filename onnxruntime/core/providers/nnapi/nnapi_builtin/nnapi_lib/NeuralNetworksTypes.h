@@ -277,6 +277,16 @@ enum {
   ANEURALNETWORKS_MAX_SIZE_OF_IMMEDIATELY_COPIED_VALUES = 128
 };
 
+/**
+ * For {@link ANeuralNetworksCompilation_setCaching}, specify the size
+ * of the cache token required from the application. The size is in bytes.
+ *
+ * Available since API level 29.
+ */
+enum {
+  ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN = 32
+};
+
 /**
  * ANeuralNetworksMemoryDesc is an opaque type that represents a memory
  * descriptor.
@@ -3,19 +3,25 @@
 #include "core/providers/nnapi/nnapi_provider_factory.h"
 
 #include "core/common/optional.h"
+#include "core/common/parse_string.h"
 #include "core/providers/nnapi/nnapi_builtin/nnapi_execution_provider.h"
 #include "core/providers/nnapi/nnapi_provider_factory_creator.h"
 #include "core/session/abi_session_options_impl.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/ort_apis.h"
 
 namespace onnxruntime {
 
 namespace {
 struct NnapiProviderFactory : IExecutionProviderFactory {
   NnapiProviderFactory(uint32_t nnapi_flags,
-                       const optional<std::string>& partitioning_stop_ops_list)
+                       const optional<std::string>& partitioning_stop_ops_list,
+                       const std::string& compilation_cache_dir,
+                       size_t min_partition_size)
       : nnapi_flags_(nnapi_flags),
-        partitioning_stop_ops_list_(partitioning_stop_ops_list) {}
+        partitioning_stop_ops_list_(partitioning_stop_ops_list),
+        compilation_cache_dir_(compilation_cache_dir),
+        min_partition_size_(min_partition_size) {}
 
   ~NnapiProviderFactory() override {}
 
@@ -24,24 +30,43 @@ struct NnapiProviderFactory : IExecutionProviderFactory {
  private:
   const uint32_t nnapi_flags_;
   const optional<std::string> partitioning_stop_ops_list_;
+  const std::string compilation_cache_dir_;
+  const size_t min_partition_size_;
 };
 
 std::unique_ptr<IExecutionProvider> NnapiProviderFactory::CreateProvider() {
-  return std::make_unique<NnapiExecutionProvider>(nnapi_flags_, partitioning_stop_ops_list_);
+  return std::make_unique<NnapiExecutionProvider>(nnapi_flags_, partitioning_stop_ops_list_,
+                                                  compilation_cache_dir_, min_partition_size_);
 }
 }  // namespace
 
 std::shared_ptr<IExecutionProviderFactory> NnapiProviderFactoryCreator::Create(
-    uint32_t nnapi_flags, const optional<std::string>& partitioning_stop_ops_list) {
-  return std::make_shared<NnapiProviderFactory>(nnapi_flags, partitioning_stop_ops_list);
+    uint32_t nnapi_flags, const optional<std::string>& partitioning_stop_ops_list,
+    const std::string& compilation_cache_dir, size_t min_partition_size) {
+  return std::make_shared<NnapiProviderFactory>(nnapi_flags, partitioning_stop_ops_list,
+                                                compilation_cache_dir, min_partition_size);
 }
 
 }  // namespace onnxruntime
 
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSessionOptions* options, uint32_t nnapi_flags) {
-  const auto partitioning_stop_ops_list = options->value.config_options.GetConfigEntry(
+  const auto& config_options = options->value.config_options;
+  const auto partitioning_stop_ops_list = config_options.GetConfigEntry(
       kOrtSessionOptionsConfigNnapiEpPartitioningStopOps);
+  const auto compilation_cache_dir = config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigNnapiEpCompilationCacheDir, "");
+  size_t min_partition_size = 0;
+  const auto min_partition_size_str = config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigNnapiEpMinPartitionSize, "0");
+  if (!onnxruntime::TryParseStringWithClassicLocale(min_partition_size_str, min_partition_size)) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 onnxruntime::MakeString("Invalid value for ",
+                                                         kOrtSessionOptionsConfigNnapiEpMinPartitionSize, ": ",
+                                                         min_partition_size_str)
+                                     .c_str());
+  }
   options->provider_factories.push_back(
-      onnxruntime::NnapiProviderFactoryCreator::Create(nnapi_flags, partitioning_stop_ops_list));
+      onnxruntime::NnapiProviderFactoryCreator::Create(nnapi_flags, partitioning_stop_ops_list,
+                                                       compilation_cache_dir, min_partition_size));
   return nullptr;
 }
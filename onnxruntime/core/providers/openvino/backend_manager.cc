@@ -265,23 +265,27 @@ void BackendManager::Compute(OrtKernelContext* context) {
     auto key = MakeMapKeyString(tensor_shapes, GetGlobalContext().device_type);
 
     std::shared_ptr<IBackend> dynamic_backend;
-    auto search = backend_map_.find(key);
-    if (search == backend_map_.end()) {
-      LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
-                         << "Creating concrete backend for key: " << key;
-      LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
-                         << "Backend created for graph " << subgraph_context_.subgraph_name;
-      auto modelproto_with_concrete_shapes = ReWriteInputShapeInfo(*model_proto_, tensor_shapes);
-      try {
-        dynamic_backend = BackendFactory::MakeBackend(*modelproto_with_concrete_shapes,
-                                                      GetGlobalContext(),
-                                                      subgraph_context_);
-      } catch (std::string const& msg) {
-        throw msg;
+    {
+      // the lock is held while compiling so that concurrent runs with a new shape compile it only once
+      std::lock_guard<std::mutex> lock(backend_map_mutex_);
+      auto search = backend_map_.find(key);
+      if (search == backend_map_.end()) {
+        LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
+                           << "Creating concrete backend for key: " << key;
+        LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
+                           << "Backend created for graph " << subgraph_context_.subgraph_name;
+        auto modelproto_with_concrete_shapes = ReWriteInputShapeInfo(*model_proto_, tensor_shapes);
+        try {
+          dynamic_backend = BackendFactory::MakeBackend(*modelproto_with_concrete_shapes,
+                                                        GetGlobalContext(),
+                                                        subgraph_context_);
+        } catch (std::string const& msg) {
+          throw msg;
+        }
+        backend_map_.insert({key, dynamic_backend});
+      } else {
+        dynamic_backend = search->second;
       }
-      backend_map_.insert({key, dynamic_backend});
-    } else {
-      dynamic_backend = search->second;
     }
 
     dynamic_backend->Infer(context);
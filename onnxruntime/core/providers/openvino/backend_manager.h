@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "ov_interface.h"
@@ -44,7 +45,9 @@ class BackendManager {
 
   std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
   std::shared_ptr<IBackend> concrete_backend_;
+  // backends compiled for the concrete input shapes seen so far, shared by the concurrent Compute calls
   std::map<std::string, std::shared_ptr<IBackend>> backend_map_;
+  std::mutex backend_map_mutex_;
   SubGraphContext subgraph_context_;
   GlobalContext global_context_;
 };
@@ -1,6 +1,7 @@
 // Copyright (C) 2019-2022 Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
@@ -95,7 +96,17 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
     throw(msg);
   }
 
-  inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, 1));
+  // Concurrent Run calls each take an idle infer request from the pool, so create as many requests as the compiled
+  // model can execute in parallel (one per stream) instead of serializing the runs on a single request.
+  size_t num_infer_requests = 1;
+  try {
+    num_infer_requests = exe_network_.Get().get_property(ov::optimal_number_of_infer_requests);
+  } catch (const ov::Exception&) {
+    LOGS_DEFAULT(INFO) << log_tag << "The device doesn't report the optimal number of infer requests";
+  }
+  num_infer_requests = std::max<size_t>({num_infer_requests, static_cast<size_t>(global_context_.num_streams), 1});
+  LOGS_DEFAULT(INFO) << log_tag << "Creating " << num_infer_requests << " infer requests";
+  inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, num_infer_requests));
 }
 
 bool BasicBackend::ValidateSubgraph(std::map<std::string, std::shared_ptr<ov::Node>>& const_outputs_map) {
@@ -234,6 +245,18 @@ void BasicBackend::StartAsyncInference(Ort::KernelContext& context, OVInferReque
         } catch (const char* msg) {
           throw(msg);
         }
+      } else if (global_context_.device_type == "CPU") {
+        // the input is already in host memory, so wrap it instead of copying it into the tensor of the request
+        auto tensor = context.GetInput(subgraph_context_.input_names.at(input_name));
+        auto tensor_shape = tensor.GetTensorTypeAndShapeInfo().GetShape();
+        ov::Shape input_tensor_shape(tensor_shape.begin(), tensor_shape.end());
+        OVTensorPtr tensor_ptr = std::make_shared<ov::Tensor>(input_info_iter->get_element_type(), input_tensor_shape,
+                                                              const_cast<void*>(tensor.GetTensorRawData()));
+        try {
+          infer_request->SetTensor(input_name, tensor_ptr);
+        } catch (const char* msg) {
+          throw(msg);
+        }
       } else {
         OVTensorPtr graph_input_blob;
         try {
@@ -425,8 +448,8 @@ void BasicBackend::CompleteAsyncInference(Ort::KernelContext& context, OVInferRe
 }
 
 void BasicBackend::Infer(OrtKernelContext* ctx) {
-  // Preliminary Thread safety mechanism
-  // currently allows a maximum of 8 Infer request's to parallel execute at the same time
+  // Thread safety: each call takes its own infer request from inferRequestsQueue_, concurrent calls wait for an idle
+  // request once all of them are busy
   Ort::KernelContext context(ctx);
 
   LOGS_DEFAULT(INFO) << log_tag << "Running graph " << subgraph_context_.subgraph_name;
@@ -518,7 +518,8 @@ std::unique_ptr<unsigned char[]> QnnBackendManager::GetContextBinaryBuffer(uint6
 }
 
 Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
-                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                                         bool share_ep_contexts) {
   bool result = nullptr == qnn_sys_interface_.systemContextCreate ||
                 nullptr == qnn_sys_interface_.systemContextGetBinaryInfo ||
                 nullptr == qnn_sys_interface_.systemContextFree;
@@ -553,7 +554,11 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
 
   ORT_RETURN_IF(graph_count < 1 || graphs_info == nullptr, "Failed to get graph info from Qnn cached context.");
   LOGS(*logger_, VERBOSE) << "Graph count from QNN context: " << graph_count << ", EPContext node count: " << qnn_models.size();
-  ORT_RETURN_IF(graph_count != qnn_models.size(), "Graph count from QNN context not equal to EPContext node count.");
+  if (share_ep_contexts) {
+    ORT_RETURN_IF(graph_count < qnn_models.size(), "Graph count from QNN context less than EPContext node count.");
+  } else {
+    ORT_RETURN_IF(graph_count != qnn_models.size(), "Graph count from QNN context not equal to EPContext node count.");
+  }
 
   ORT_RETURN_IF(nullptr == qnn_interface_.contextCreateFromBinary,
                 "Invalid function pointer for contextCreateFromBinary.");
@@ -577,12 +582,22 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
     auto qnn_model_pose = qnn_models.begin();
     ORT_RETURN_IF_ERROR(qnn_model_pose->second->DeserializeGraphInfoFromBinaryInfo(graphs_info[0]));
   } else {
+    const size_t ep_context_node_count = qnn_models.size();
+    size_t matched_graph_count = 0;
     for (uint32_t i = 0; i < graph_count; ++i) {
       std::string graph_name(graphs_info[i].graphInfoV1.graphName);
       auto qnn_model_pos = qnn_models.find(graph_name);
-      ORT_RETURN_IF(qnn_model_pos == qnn_models.end(), graph_name + " does not match any EPContext node names.");
+      if (qnn_model_pos != qnn_models.end()) {
+        ++matched_graph_count;
+      } else {
+        ORT_RETURN_IF(!share_ep_contexts, graph_name + " does not match any EPContext node names.");
+        // the graph is used by another session sharing this context
+        qnn_model_pos = qnn_models.emplace(graph_name, std::make_unique<qnn::QnnModel>(*logger_, this)).first;
+      }
       ORT_RETURN_IF_ERROR(qnn_model_pos->second->DeserializeGraphInfoFromBinaryInfo(graphs_info[i]));
     }
+    ORT_RETURN_IF(matched_graph_count != ep_context_node_count,
+                  "Not all EPContext node names match a graph in the QNN context.");
   }
 
   qnn_sys_interface_.systemContextFree(sys_ctx_handle);
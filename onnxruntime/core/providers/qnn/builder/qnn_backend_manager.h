@@ -83,8 +83,12 @@ class QnnBackendManager {
 
   std::unique_ptr<unsigned char[]> GetContextBinaryBuffer(uint64_t& written_buffer_size);
 
+  // Creates the QNN context from a context binary and deserializes its graphs to qnn_models, keyed by the EPContext
+  // node names. If share_ep_contexts is true, the binary may hold more graphs than there are EPContext nodes, and the
+  // other graphs are added to qnn_models under their graph names.
   Status LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
-                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models);
+                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                        bool share_ep_contexts = false);
 
   Status SetupBackend(const logging::Logger& logger, bool load_from_cached_context);
 
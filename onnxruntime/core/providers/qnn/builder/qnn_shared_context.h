@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/platform/ort_mutex.h"
+#include "core/providers/qnn/builder/qnn_backend_manager.h"
+#include "core/providers/qnn/builder/qnn_model.h"
+
+namespace onnxruntime {
+namespace qnn {
+
+// Process wide pool of the QNN graphs that were loaded from an EP context binary but are not used by the session
+// that loaded it, for the sessions that set ep.share_ep_contexts.
+// A context binary can hold several graphs that share weights, e.g. the prefill and decode graphs of a LLM. The
+// session that loads the binary leaves the other graphs here, together with the backend manager that owns the QNN
+// context, and the sessions of those graphs take them instead of loading the binary again.
+class SharedContext {
+ public:
+  static SharedContext& GetInstance() {
+    static SharedContext instance;
+    return instance;
+  }
+
+  // Adds the graphs of a QNN context owned by backend_manager.
+  void AddQnnModels(const std::shared_ptr<QnnBackendManager>& backend_manager,
+                    std::unordered_map<std::string, std::unique_ptr<QnnModel>>&& qnn_models) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (auto& [graph_name, qnn_model] : qnn_models) {
+      shared_qnn_models_[graph_name] = SharedQnnModel{backend_manager, std::move(qnn_model)};
+    }
+  }
+
+  // If all the graphs in graph_names are in the pool and belong to the same QNN context, moves them to qnn_models and
+  // returns the backend manager that owns the context. Returns nullptr otherwise.
+  std::shared_ptr<QnnBackendManager> TakeQnnModels(
+      const std::vector<std::string>& graph_names,
+      std::unordered_map<std::string, std::unique_ptr<QnnModel>>& qnn_models) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    std::shared_ptr<QnnBackendManager> backend_manager;
+    for (const auto& graph_name : graph_names) {
+      auto it = shared_qnn_models_.find(graph_name);
+      if (it == shared_qnn_models_.end() ||
+          (backend_manager != nullptr && backend_manager != it->second.backend_manager)) {
+        return nullptr;
+      }
+
+      backend_manager = it->second.backend_manager;
+    }
+
+    for (const auto& graph_name : graph_names) {
+      auto it = shared_qnn_models_.find(graph_name);
+      qnn_models[graph_name] = std::move(it->second.qnn_model);
+      shared_qnn_models_.erase(it);
+    }
+
+    return backend_manager;
+  }
+
+ private:
+  SharedContext() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedContext);
+
+  struct SharedQnnModel {
+    // keeps the QNN context of the graph alive after the session that loaded it is released
+    std::shared_ptr<QnnBackendManager> backend_manager;
+    std::unique_ptr<QnnModel> qnn_model;
+  };
+
+  OrtMutex mutex_;
+  std::unordered_map<std::string, SharedQnnModel> shared_qnn_models_;
+};
+
+}  // namespace qnn
+}  // namespace onnxruntime
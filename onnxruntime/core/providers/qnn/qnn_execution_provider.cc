@@ -3,6 +3,7 @@
 
 #include "qnn_execution_provider.h"
 
+#include <algorithm>
 #include <filesystem>
 #include "core/framework/compute_capability.h"
 #include "core/graph/graph_viewer.h"
@@ -19,6 +20,7 @@
 #include "core/providers/qnn/builder/op_builder_factory.h"
 #include "core/providers/qnn/builder/qnn_def.h"
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
+#include "core/providers/qnn/builder/qnn_shared_context.h"
 #include "core/framework/run_options.h"
 
 namespace onnxruntime {
@@ -177,6 +179,10 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
 
     context_cache_path_cfg_ = session_options->config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
     LOGS_DEFAULT(VERBOSE) << "User specified context cache path: " << context_cache_path_cfg_;
+
+    share_ep_contexts_ = session_options->config_options.GetConfigOrDefault(
+                             kOrtSessionOptionShareEpContexts, "0") == "1";
+    LOGS_DEFAULT(VERBOSE) << "Share EP contexts: " << share_ep_contexts_;
   }
 
   static const std::string BACKEND_PATH = "backend_path";
@@ -298,7 +304,7 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     }
   }
 
-  qnn_backend_manager_ = std::make_unique<qnn::QnnBackendManager>(
+  qnn_backend_manager_ = std::make_shared<qnn::QnnBackendManager>(
       std::move(backend_path),
       profiling_level,
       context_priority,
@@ -478,8 +484,11 @@ QNNExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer
   bool is_qnn_ctx_model = qnn::GraphHasEpContextNode(graph_viewer);
 
   // It will load the QnnSystem lib if is_qnn_ctx_model=true, and
-  // delay the Qnn context creation to Compile() using the cached context binary
-  auto rt = qnn_backend_manager_->SetupBackend(logger, is_qnn_ctx_model);
+  // delay the Qnn context creation to Compile() using the cached context binary.
+  // A shared QNN context may outlive this session, so it logs to the default logger instead of the session logger.
+  const auto& backend_logger = share_ep_contexts_ && is_qnn_ctx_model ? logging::LoggingManager::DefaultLogger()
+                                                                      : logger;
+  auto rt = qnn_backend_manager_->SetupBackend(backend_logger, is_qnn_ctx_model);
   if (Status::OK() != rt) {
     LOGS(logger, ERROR) << "QNN SetupBackend failed " << rt.ErrorMessage();
     return result;
@@ -694,17 +703,55 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
     // for this session (created from an EP context model), the graph_meta_id is new
     std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> qnn_models;
 
-    int main_context_pos = -1;
-    ORT_RETURN_IF_ERROR(qnn::GetMainContextNode(fused_nodes_and_graphs, qnn_backend_manager_.get(),
-                                                logger, main_context_pos, qnn_models));
-
-    const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
-    // Create QNN context from the cached binary, deserialize the QNN graph from the binary
-    ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
-                                                     context_cache_path,
-                                                     qnn_backend_manager_.get(),
-                                                     qnn_models,
-                                                     logger));
+    std::vector<std::string> ep_context_node_names;
+    ep_context_node_names.reserve(fused_nodes_and_graphs.size());
+    for (const auto& fused_node_and_graph : fused_nodes_and_graphs) {
+      const onnxruntime::GraphViewer& graph_viewer(fused_node_and_graph.filtered_graph);
+      ep_context_node_names.push_back(graph_viewer.Nodes().begin()->Name());
+    }
+
+    // Use the graphs that another session loaded from a context binary shared with this model if there are any.
+    std::shared_ptr<qnn::QnnBackendManager> shared_backend_manager;
+    if (share_ep_contexts_) {
+      shared_backend_manager = qnn::SharedContext::GetInstance().TakeQnnModels(ep_context_node_names, qnn_models);
+    }
+
+    if (shared_backend_manager != nullptr) {
+      LOGS(logger, VERBOSE) << "Use the QNN context shared by another session.";
+      // the backend set up by GetCapability is not needed
+      qnn_backend_manager_ = std::move(shared_backend_manager);
+    } else {
+      int main_context_pos = -1;
+      ORT_RETURN_IF_ERROR(qnn::GetMainContextNode(fused_nodes_and_graphs, qnn_backend_manager_.get(),
+                                                  logger, main_context_pos, qnn_models));
+
+      const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
+      // Create QNN context from the cached binary, deserialize the QNN graph from the binary
+      ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
+                                                       context_cache_path,
+                                                       qnn_backend_manager_.get(),
+                                                       qnn_models,
+                                                       logger,
+                                                       share_ep_contexts_));
+
+      if (share_ep_contexts_) {
+        // leave the graphs this session does not use to the other sessions
+        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> unused_qnn_models;
+        for (auto it = qnn_models.begin(); it != qnn_models.end();) {
+          if (std::find(ep_context_node_names.begin(), ep_context_node_names.end(), it->first) ==
+              ep_context_node_names.end()) {
+            unused_qnn_models.emplace(it->first, std::move(it->second));
+            it = qnn_models.erase(it);
+          } else {
+            ++it;
+          }
+        }
+
+        if (!unused_qnn_models.empty()) {
+          qnn::SharedContext::GetInstance().AddQnnModels(qnn_backend_manager_, std::move(unused_qnn_models));
+        }
+      }
+    }
 
     for (auto fused_node_and_graph : fused_nodes_and_graphs) {
       const onnxruntime::GraphViewer& graph_viewer(fused_node_and_graph.filtered_graph);
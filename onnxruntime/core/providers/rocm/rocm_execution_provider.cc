@@ -4,6 +4,7 @@
 #include "core/common/inlined_containers.h"
 #include "core/providers/shared_library/provider_api.h"
 #include "core/platform/env_var_utils.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
 #include "core/providers/rocm/rocm_execution_provider.h"
 #include "core/providers/rocm/rocm_common.h"
 #include "core/providers/rocm/rocm_allocator.h"
@@ -162,7 +163,7 @@ AllocatorPtr ROCMExecutionProvider::CreateRocmAllocator(OrtDevice::DeviceId devi
 
 ROCMExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId device_id, hipStream_t stream, size_t /*gpu_mem_limit*/,
                                                           ArenaExtendStrategy /*arena_extend_strategy*/, ROCMExecutionProviderExternalAllocatorInfo /*external_allocator_info*/,
-                                                          OrtArenaCfg* /*default_memory_arena_cfg*/) {
+                                                          OrtArenaCfg* /*default_memory_arena_cfg*/, size_t max_num_hip_graphs) {
   HIP_CALL_THROW(hipSetDevice(device_id));
 
   ROCBLAS_CALL_THROW(rocblas_create_handle(&rocblas_handle_));
@@ -171,7 +172,8 @@ ROCMExecutionProvider::PerThreadContext::PerThreadContext(OrtDevice::DeviceId de
   MIOPEN_CALL_THROW(miopenCreate(&miopen_handle_));
   MIOPEN_CALL_THROW(miopenSetStream(miopen_handle_, stream));
 
-  hip_graph_.SetStream(stream);
+  hip_graphs_.SetStream(stream);
+  hip_graphs_.SetMaxNumGraphs(max_num_hip_graphs);
 }
 
 ROCMExecutionProvider::PerThreadContext::~PerThreadContext() {
@@ -179,33 +181,41 @@ ROCMExecutionProvider::PerThreadContext::~PerThreadContext() {
   ORT_IGNORE_RETURN_VALUE(MIOPEN_CALL(miopenDestroy(miopen_handle_)));
 }
 
-bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptureAllowed() const {
-  return regular_run_count_before_graph_capture_ >= min_num_runs_before_hip_graph_capture_;
+bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptureAllowed(const std::string& graph_annotation) const {
+  auto it = regular_run_count_before_graph_capture_.find(graph_annotation);
+  return it != regular_run_count_before_graph_capture_.end() &&
+         it->second >= min_num_runs_before_hip_graph_capture_;
 }
 
-void ROCMExecutionProvider::PerThreadContext::CaptureBegin() {
-  hip_graph_.Reset();
-  hip_graph_.CaptureBegin();
+void ROCMExecutionProvider::PerThreadContext::CaptureBegin(const std::string& graph_annotation) {
+  hip_graphs_.CaptureBegin(graph_annotation);
 }
 
 void ROCMExecutionProvider::PerThreadContext::CaptureEnd() {
-  hip_graph_.CaptureEnd();
-  is_graph_captured_ = true;
+  hip_graphs_.CaptureEnd();
 }
 
-bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptured() const {
-  return is_graph_captured_;
+bool ROCMExecutionProvider::PerThreadContext::IsGraphCaptured(const std::string& graph_annotation) const {
+  return hip_graphs_.IsGraphCaptured(graph_annotation);
 }
 
-Status ROCMExecutionProvider::PerThreadContext::ReplayGraph() {
-  ORT_ENFORCE(IsGraphCaptured());
-  return hip_graph_.Replay();
+Status ROCMExecutionProvider::PerThreadContext::ReplayGraph(const std::string& graph_annotation) {
+  ORT_ENFORCE(IsGraphCaptured(graph_annotation));
+  return hip_graphs_.Replay(graph_annotation);
 }
 
-void ROCMExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture() {
-  ++regular_run_count_before_graph_capture_;
+void ROCMExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture(
+    const std::string& graph_annotation) {
+  ++regular_run_count_before_graph_capture_[graph_annotation];
 }
 
+namespace {
+// The session sets the annotation of every run when graph capture is enabled, see InferenceSession::Run().
+std::string GetHipGraphAnnotation(const onnxruntime::RunOptions& run_options) {
+  return GetRunConfigOptions(run_options).GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation).value_or("");
+}
+}  // namespace
+
 void OverrideTunableOpInfoByEnv(ROCMExecutionProviderInfo& info) {
   if (auto env_tunable_op_enable = onnxruntime::ParseTestOnlyEnvironmentVariable<bool>(
           "ORT_ROCM_TUNABLE_OP_ENABLE", {"0", "1"}, "Use provider_options \"tunable_op_enable\" instead.");
@@ -312,7 +322,8 @@ ROCMExecutionProvider::PerThreadContext& ROCMExecutionProvider::GetPerThreadCont
     // get or create a context
     if (context_state_.retired_context_pool.empty()) {
       context = std::make_shared<PerThreadContext>(info_.device_id, stream_, info_.gpu_mem_limit,
-                                                   info_.arena_extend_strategy, info_.external_allocator_info, info_.default_memory_arena_cfg);
+                                                   info_.arena_extend_strategy, info_.external_allocator_info, info_.default_memory_arena_cfg,
+                                                   info_.hip_graph_max_num_graphs);
     } else {
       context = context_state_.retired_context_pool.back();
       context_state_.retired_context_pool.pop_back();
@@ -353,25 +364,32 @@ Status ROCMExecutionProvider::Sync() const {
   return Status::OK();
 }
 
-Status ROCMExecutionProvider::OnRunStart(const onnxruntime::RunOptions& /*run_options*/) {
+Status ROCMExecutionProvider::OnRunStart(const onnxruntime::RunOptions& run_options) {
   // always set ROCM device when session::Run() in case it runs in a worker thread
   HIP_RETURN_IF_ERROR(hipSetDevice(GetDeviceId()));
-  if (IsGraphCaptureEnabled() && GetPerThreadContext().IsGraphCaptureAllowed() && !GetPerThreadContext().IsGraphCaptured()) {
-    LOGS_DEFAULT(INFO) << "Capturing the hip graph for this model";
-    GetPerThreadContext().CaptureBegin();
+  if (IsGraphCaptureEnabled()) {
+    const std::string graph_annotation = GetHipGraphAnnotation(run_options);
+    if (GetPerThreadContext().IsGraphCaptureAllowed(graph_annotation) &&
+        !GetPerThreadContext().IsGraphCaptured(graph_annotation)) {
+      LOGS_DEFAULT(INFO) << "Capturing the hip graph for this model with annotation: " << graph_annotation;
+      GetPerThreadContext().CaptureBegin(graph_annotation);
+    }
   }
   return Status::OK();
 }
 
-Status ROCMExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& /*run_options*/) {
-  if (IsGraphCaptureEnabled() && !GetPerThreadContext().IsGraphCaptured()) {
-    if (GetPerThreadContext().IsGraphCaptureAllowed()) {
-      GetPerThreadContext().CaptureEnd();
-      // HIP work issued to a capturing stream doesn’t actually run on the GPU,
-      // so run the captured graph here to actually execute the work.
-      ORT_RETURN_IF_ERROR(GetPerThreadContext().ReplayGraph());
-    } else {
-      GetPerThreadContext().IncrementRegularRunCountBeforeGraphCapture();
+Status ROCMExecutionProvider::OnRunEnd(bool sync_stream, const onnxruntime::RunOptions& run_options) {
+  if (IsGraphCaptureEnabled()) {
+    const std::string graph_annotation = GetHipGraphAnnotation(run_options);
+    if (!GetPerThreadContext().IsGraphCaptured(graph_annotation)) {
+      if (GetPerThreadContext().IsGraphCaptureAllowed(graph_annotation)) {
+        GetPerThreadContext().CaptureEnd();
+        // HIP work issued to a capturing stream doesn’t actually run on the GPU,
+        // so run the captured graph here to actually execute the work.
+        ORT_RETURN_IF_ERROR(GetPerThreadContext().ReplayGraph(graph_annotation));
+      } else {
+        GetPerThreadContext().IncrementRegularRunCountBeforeGraphCapture(graph_annotation);
+      }
     }
   }
 
@@ -400,12 +418,12 @@ bool ROCMExecutionProvider::IsGraphCaptureEnabled() const {
   return info_.enable_hip_graph;
 }
 
-bool ROCMExecutionProvider::IsGraphCaptured() const {
-  return GetPerThreadContext().IsGraphCaptured();
+bool ROCMExecutionProvider::IsGraphCaptured(const std::string& graph_annotation) const {
+  return GetPerThreadContext().IsGraphCaptured(graph_annotation);
 }
 
-Status ROCMExecutionProvider::ReplayGraph() {
-  return GetPerThreadContext().ReplayGraph();
+Status ROCMExecutionProvider::ReplayGraph(const std::string& graph_annotation) {
+  return GetPerThreadContext().ReplayGraph(graph_annotation);
 }
 
 namespace rocm {
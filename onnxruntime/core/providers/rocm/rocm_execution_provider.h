@@ -75,8 +75,8 @@ class ROCMExecutionProvider : public IExecutionProvider {
   std::unique_ptr<profiling::EpProfiler> GetProfiler() override;
 
   bool IsGraphCaptureEnabled() const override;
-  bool IsGraphCaptured() const override;
-  Status ReplayGraph() override;
+  bool IsGraphCaptured(const std::string& graph_annotation) const override;
+  Status ReplayGraph(const std::string& graph_annotation) override;
   void RegisterStreamHandlers(IStreamCommandHandleRegistry& stream_handle_registry, AllocatorMap& allocators) const override;
   OrtDevice GetOrtDeviceByMemType(OrtMemType mem_type) const override;
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
@@ -96,7 +96,8 @@ class ROCMExecutionProvider : public IExecutionProvider {
   class PerThreadContext final {
    public:
     PerThreadContext(OrtDevice::DeviceId device_id, hipStream_t stream, size_t rocm_mem_limit, ArenaExtendStrategy arena_extend_strategy,
-                     ROCMExecutionProviderExternalAllocatorInfo external_alloc_info, OrtArenaCfg* arena_cfg);
+                     ROCMExecutionProviderExternalAllocatorInfo external_alloc_info, OrtArenaCfg* arena_cfg,
+                     size_t max_num_hip_graphs);
     ~PerThreadContext();
 
     rocblas_handle RocblasHandle() const {
@@ -138,12 +139,12 @@ class ROCMExecutionProvider : public IExecutionProvider {
       }
     }
 
-    bool IsGraphCaptureAllowed() const;
-    void CaptureBegin();
+    bool IsGraphCaptureAllowed(const std::string& graph_annotation) const;
+    void CaptureBegin(const std::string& graph_annotation);
     void CaptureEnd();
-    bool IsGraphCaptured() const;
-    Status ReplayGraph();
-    void IncrementRegularRunCountBeforeGraphCapture();
+    bool IsGraphCaptured(const std::string& graph_annotation) const;
+    Status ReplayGraph(const std::string& graph_annotation);
+    void IncrementRegularRunCountBeforeGraphCapture(const std::string& graph_annotation);
 
    private:
     rocblas_handle rocblas_handle_ = nullptr;
@@ -154,11 +155,12 @@ class ROCMExecutionProvider : public IExecutionProvider {
     std::unique_ptr<rocm::IConstantBuffer<half>> constant_ones_half_;
     std::unique_ptr<rocm::IConstantBuffer<BFloat16>> constant_ones_bfloat16_;
 
-    // Hip graph with multi threads will be supported in the future, so hip_graph_
+    // Hip graph with multi threads will be supported in the future, so hip_graphs_
     // is put under PerThreadContext.
-    ROCMGraph hip_graph_;
-    bool is_graph_captured_ = false;
-    int regular_run_count_before_graph_capture_ = 0;
+    ROCMGraphCache hip_graphs_;
+    // The regular runs of each graph annotation, an evicted graph is captured again without regular runs as the
+    // memory it needs is still in the arena.
+    std::unordered_map<std::string, int> regular_run_count_before_graph_capture_;
 
     // There is chance that the second regular run allocates GPU memory for causes like:
     // (1) memory pattern is enabled. (2) arena allocation for stream.
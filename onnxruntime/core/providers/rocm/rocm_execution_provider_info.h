@@ -64,6 +64,9 @@ struct ROCMExecutionProviderInfo {
   bool miopen_conv_use_max_workspace{true};
 
   bool enable_hip_graph{false};
+  // The number of graphs kept when enable_hip_graph is set, one per graph annotation of the runs.
+  // The least recently replayed graph is destroyed to capture a new one. 0 for no bound.
+  size_t hip_graph_max_num_graphs{8};
 
   rocm::TunableOpInfo tunable_op{};
 
@@ -92,6 +95,7 @@ struct std::hash<::onnxruntime::ROCMExecutionProviderInfo> {
 
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
+    onnxruntime::HashCombine(info.hip_graph_max_num_graphs, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
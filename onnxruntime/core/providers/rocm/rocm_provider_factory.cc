@@ -186,6 +186,7 @@ struct ROCM_Provider : Provider {
     info.user_compute_stream = params->user_compute_stream;
     info.default_memory_arena_cfg = params->default_memory_arena_cfg;
     info.enable_hip_graph = params->enable_hip_graph;
+    info.hip_graph_max_num_graphs = params->hip_graph_max_num_graphs;
     info.tunable_op.enable = params->tunable_op_enable;
     info.tunable_op.tuning_enable = params->tunable_op_tuning_enable;
     info.tunable_op.max_tuning_duration_ms = params->tunable_op_max_tuning_duration_ms;
@@ -217,6 +218,7 @@ struct ROCM_Provider : Provider {
     }
     rocm_options.default_memory_arena_cfg = internal_options.default_memory_arena_cfg;
     rocm_options.enable_hip_graph = internal_options.enable_hip_graph;
+    rocm_options.hip_graph_max_num_graphs = internal_options.hip_graph_max_num_graphs;
     rocm_options.tunable_op_enable = internal_options.tunable_op.enable;
     rocm_options.tunable_op_tuning_enable = internal_options.tunable_op.tuning_enable;
     rocm_options.tunable_op_max_tuning_duration_ms = internal_options.tunable_op.max_tuning_duration_ms;
@@ -393,6 +393,20 @@ struct ConfigOptions final {
   PROVIDER_DISALLOW_ALL(ConfigOptions)
 };
 
+// RunOptions is OrtRunOptions, whose members are not visible to the providers.
+inline const ConfigOptions& GetRunConfigOptions(const RunOptions& run_options) {
+  return g_host->RunOptions__GetConfigOptions(&run_options);
+}
+
+// Whether the run collects RunStats, to which the provider can add the time its device worked for the run.
+inline bool CollectsRunStats(const RunOptions& run_options) {
+  return g_host->RunOptions__CollectsRunStats(&run_options);
+}
+
+inline void AddRunStatsDeviceTime(const RunOptions& run_options, int64_t ns) {
+  g_host->RunOptions__AddRunStatsDeviceTime(&run_options, ns);
+}
+
 struct ComputeCapability final {
   static std::unique_ptr<ComputeCapability> Create(std::unique_ptr<IndexedSubGraph> t_sub_graph) { return g_host->ComputeCapability__construct(std::move(t_sub_graph)); }
   static void operator delete(void* p) { g_host->ComputeCapability__operator_delete(reinterpret_cast<ComputeCapability*>(p)); }
@@ -546,6 +546,23 @@ bool ApplyProfileShapesFromProviderOptions(std::vector<nvinfer1::IOptimizationPr
   return true;
 }
 
+// Bounds of the power of 2 bucket containing dim, used to grow the profile ranges of dynamic shape inputs.
+static int64_t NextPowerOfTwo(int64_t dim) {
+  int64_t bucket = 1;
+  while (bucket < dim && bucket < std::numeric_limits<int32_t>::max() / 2) {
+    bucket *= 2;
+  }
+  return std::max(bucket, dim);
+}
+
+static int64_t PreviousPowerOfTwo(int64_t dim) {
+  int64_t bucket = 1;
+  while (bucket * 2 <= dim) {
+    bucket *= 2;
+  }
+  return std::min(bucket, std::max<int64_t>(dim, 0));
+}
+
 /*
  * Apply TensorRT optimization profile shapes from input tensor value.
  *
@@ -560,6 +577,7 @@ Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizatio
                                               const std::unordered_map<std::string, size_t>& input_indexes,
                                               std::unordered_map<std::string, std::vector<int32_t>>& tensor_shape_values,
                                               cudaStream_t stream,
+                                              bool profile_shape_bucketing,
                                               bool* engine_update) {
   for (size_t i = 0; i < trt_profiles.size(); i++) {
     const std::string& input_name = input->getName();
@@ -698,15 +716,15 @@ Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizatio
 
           // Update minimum dimension
           if (tensor_shape < shape_range[0]) {
-            shape_range[0] = tensor_shape;
-            dims_min.d[j] = static_cast<int32_t>(tensor_shape);
+            shape_range[0] = profile_shape_bucketing ? PreviousPowerOfTwo(tensor_shape) : tensor_shape;
+            dims_min.d[j] = static_cast<int32_t>(shape_range[0]);
             *engine_update = true;
           }
           // Update maximum dimension
           if (tensor_shape > shape_range[1]) {
-            shape_range[1] = tensor_shape;
+            shape_range[1] = profile_shape_bucketing ? NextPowerOfTwo(tensor_shape) : tensor_shape;
             shape_range[2] = tensor_shape;
-            dims_max.d[j] = static_cast<int32_t>(tensor_shape);
+            dims_max.d[j] = static_cast<int32_t>(shape_range[1]);
             dims_opt.d[j] = static_cast<int32_t>(tensor_shape);
             *engine_update = true;
           }
@@ -1213,6 +1231,8 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     dump_ep_context_model_ = info.dump_ep_context_model;
     ep_context_file_path_ = info.ep_context_file_path;
     ep_context_embed_mode_ = info.ep_context_embed_mode;
+    profile_shape_bucketing_ = info.profile_shape_bucketing;
+    share_initializers_enable_ = info.share_initializers_enable;
     if (engine_cache_enable_ || int8_enable_ || timing_cache_enable_) {
       cache_path_ = info.engine_cache_path;
       cache_prefix_ = info.engine_cache_prefix;
@@ -1336,6 +1356,16 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
         ep_context_embed_mode_ = std::stoi(ep_context_embed_mode_env);
       }
 
+      const std::string profile_shape_bucketing_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kProfileShapeBucketing);
+      if (!profile_shape_bucketing_env.empty()) {
+        profile_shape_bucketing_ = (std::stoi(profile_shape_bucketing_env) == 0 ? false : true);
+      }
+
+      const std::string share_initializers_enable_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kShareInitializersEnable);
+      if (!share_initializers_enable_env.empty()) {
+        share_initializers_enable_ = (std::stoi(share_initializers_enable_env) == 0 ? false : true);
+      }
+
       if (engine_cache_enable_ || int8_enable_ || timing_cache_enable_) {
         const std::string engine_cache_path = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kEngineCachePath);
         cache_path_ = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kCachePath);
@@ -1594,7 +1624,9 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
                         << ", trt_dump_ep_context_model: " << dump_ep_context_model_
                         << ", trt_ep_context_file_path: " << ep_context_file_path_
                         << ", trt_ep_context_embed_mode: " << ep_context_embed_mode_
-                        << ", trt_cache_prefix: " << cache_prefix_;
+                        << ", trt_cache_prefix: " << cache_prefix_
+                        << ", trt_profile_shape_bucketing: " << profile_shape_bucketing_
+                        << ", trt_share_initializers_enable: " << share_initializers_enable_;
 }
 
 TensorrtExecutionProvider::~TensorrtExecutionProvider() {
@@ -1643,12 +1675,12 @@ void TensorrtExecutionProvider::CaptureEnd() {
   is_graph_captured_ = true;
 }
 
-bool TensorrtExecutionProvider::IsGraphCaptured() const {
+bool TensorrtExecutionProvider::IsGraphCaptured(const std::string& /*graph_annotation*/) const {
   return is_graph_captured_;
 }
 
-Status TensorrtExecutionProvider::ReplayGraph() {
-  ORT_ENFORCE(IsGraphCaptured());
+Status TensorrtExecutionProvider::ReplayGraph(const std::string& graph_annotation) {
+  ORT_ENFORCE(IsGraphCaptured(graph_annotation));
   // Please note that CUDAGraph::Replay() is not thread safe.
   // ORT TRT calls ReplayGraph() in compute_func() where synchromization is enforced due to lock_guard(),
   // therefore calling CUDAGraph::Replay() here is guaranteed to be thread safe.
@@ -1784,14 +1816,32 @@ std::unique_ptr<IndexedSubGraph> TensorrtExecutionProvider::GetSubGraph(SubGraph
   int input_order = 0;
   int output_order = 0;
 
+  // An initializer shared with nodes outside of the subgraph is an input of the fused node when
+  // share_initializers_enable_ is set, so that TensorRT reads it from the session state's device copy.
+  auto is_shared_initializer = [&](const std::string& name) {
+    if (!share_initializers_enable_ || graph.IsSubgraph()) {
+      return false;
+    }
+    for (const auto* consumer : graph.GetGraph().GetConsumerNodes(name)) {
+      if (node_set.find(consumer->Index()) == node_set.end()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  bool has_shared_initializers = false;
+
   std::vector<std::string> initializers;
   for (const auto& index : graph_nodes_index.first) {
     sub_graph->Nodes().push_back(node_index[index]);
     const auto& node = graph.GetNode(node_index[index]);
     for (const auto& input : node->InputDefs()) {
       if (graph.IsConstantInitializer(input->Name(), true)) {
-        initializers.push_back(input->Name());
-        continue;
+        if (!is_shared_initializer(input->Name())) {
+          initializers.push_back(input->Name());
+          continue;
+        }
+        has_shared_initializers = true;
       }
       const auto& it = fused_outputs.find(input);
       if (it != fused_outputs.end()) {
@@ -1886,6 +1936,11 @@ std::unique_ptr<IndexedSubGraph> TensorrtExecutionProvider::GetSubGraph(SubGraph
   auto meta_def = IndexedSubGraph_MetaDef::Create();
   const std::string graph_type = graph.IsSubgraph() ? "subgraph" : "graph";
   meta_def->name() = "TRTKernel_" + graph_type + "_" + graph.Name() + "_" + subgraph_id;
+  if (has_shared_initializers) {
+    // The engine has extra inputs for the shared initializers, keep its cache apart from the one of the
+    // engine which has them built in.
+    meta_def->name() += "_shared_initializers";
+  }
   LOGS_DEFAULT(INFO) << "[TensorRT EP] TensorRT subgraph MetaDef name " + meta_def->name();
 
   // Assign inputs and outputs to subgraph's meta_def
@@ -3142,7 +3197,8 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       // If there is any input tensor in shape_ranges, it means this input tensor has dynamic shape and its profile shape values have not yet resolved.
       // TRT EP will help determine the min/max/opt profile values based on current input tensor value.
       if (shape_ranges.find(input_name) != shape_ranges.end()) {
-        auto status = ApplyProfileShapesFromInputTensorValue(trt_profiles, ctx, input, shape_ranges, input_indexes, tensor_shape_values, stream, &engine_update);
+        auto status = ApplyProfileShapesFromInputTensorValue(trt_profiles, ctx, input, shape_ranges, input_indexes, tensor_shape_values, stream,
+                                                             profile_shape_bucketing_, &engine_update);
         if (status != Status::OK()) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to parse input tensor and generate optimization profiles.");
         }
@@ -3412,7 +3468,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     // Start CUDA graph capture.
     // Note: The reason we don't put graph capture in OnRunStart() like CUDA EP does is because
     // current ORT TRT doesn't get cuda stream until compute time and graph capture requires cuda stream.
-    if (cuda_graph_enable_ && IsGraphCaptureAllowed() && !IsGraphCaptured()) {
+    if (cuda_graph_enable_ && IsGraphCaptureAllowed() && !is_graph_captured_) {
       LOGS_DEFAULT(INFO) << "Capturing the cuda graph for this model";
       cuda_graph_.SetStream(stream);
       CaptureBegin();
@@ -3483,12 +3539,12 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     // Note: One reason we don't put end of graph capture in OnRunEnd() like CUDA EP does is because of cuda stream mentioned in graph capture
     // above, another reason is because OnRunEnd() is not synchronized with OnRunStart() and ExecuteGraph() per inference_session.cc.
     // It's safe to start/end CUDA graph capture in compute_func() here since cuda graph object is maintained by a per thread basis.
-    if (cuda_graph_enable_ && !IsGraphCaptured()) {
+    if (cuda_graph_enable_ && !is_graph_captured_) {
       if (IsGraphCaptureAllowed()) {
         CaptureEnd();
         // CUDA work issued to a capturing stream doesn’t actually run on the GPU,
         // so run the captured graph here to actually execute the work.
-        ORT_RETURN_IF_ERROR(ReplayGraph());
+        ORT_RETURN_IF_ERROR(ReplayGraph(/*graph_annotation*/ ""));
       } else {
         IncrementRegularRunCountBeforeGraphCapture();
       }
@@ -3705,7 +3761,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromPrecompiledEngine(con
     // Start CUDA graph capture.
     // Note: The reason we don't put graph capture in OnRunStart() like CUDA EP does is because
     // current ORT TRT doesn't get cuda stream until compute time and graph capture requires cuda stream.
-    if (cuda_graph_enable_ && IsGraphCaptureAllowed() && !IsGraphCaptured()) {
+    if (cuda_graph_enable_ && IsGraphCaptureAllowed() && !is_graph_captured_) {
       LOGS_DEFAULT(INFO) << "Capturing the cuda graph for this model";
       cuda_graph_.SetStream(stream);
       CaptureBegin();
@@ -3776,12 +3832,12 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromPrecompiledEngine(con
     // Note: One reason we don't put end of graph capture in OnRunEnd() like CUDA EP does is because of cuda stream mentioned in graph capture
     // above, another reason is because OnRunEnd() is not synchronized with OnRunStart() and ExecuteGraph() per inference_session.cc.
     // It's safe to start/end CUDA graph capture in compute_func() here since cuda graph object is maintained by a per thread basis.
-    if (cuda_graph_enable_ && !IsGraphCaptured()) {
+    if (cuda_graph_enable_ && !is_graph_captured_) {
       if (IsGraphCaptureAllowed()) {
         CaptureEnd();
         // CUDA work issued to a capturing stream doesn’t actually run on the GPU,
         // so run the captured graph here to actually execute the work.
-        ORT_RETURN_IF_ERROR(ReplayGraph());
+        ORT_RETURN_IF_ERROR(ReplayGraph(/*graph_annotation*/ ""));
       } else {
         IncrementRegularRunCountBeforeGraphCapture();
       }
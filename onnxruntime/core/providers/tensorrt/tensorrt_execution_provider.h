@@ -51,6 +51,8 @@ static const std::string kDumpEpContextModel = "ORT_DUMP_EP_CONTEXT_MODEL";
 static const std::string kEpContextEmbedMode = "ORT_EP_CONTEXT_EMBED_MODE";
 static const std::string kEpContextComputeCapabilityEnable = "ORT_EP_CONTEXT_COMPUTE_CAPABILITY_ENABLE";
 static const std::string kEngineCachePrefix = "ORT_TENSORRT_CACHE_PREFIX";
+static const std::string kProfileShapeBucketing = "ORT_TENSORRT_PROFILE_SHAPE_BUCKETING_ENABLE";
+static const std::string kShareInitializersEnable = "ORT_TENSORRT_SHARE_INITIALIZERS_ENABLE";
 // Old env variable for backward compatibility
 static const std::string kEngineCachePath = "ORT_TENSORRT_ENGINE_CACHE_PATH";
 }  // namespace tensorrt_env_vars
@@ -250,8 +252,9 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
 
   bool IsGraphCaptureEnabled() const override;
-  bool IsGraphCaptured() const override;
-  Status ReplayGraph() override;
+  // TRT EP captures a single graph, which is shared by all the graph annotations.
+  bool IsGraphCaptured(const std::string& graph_annotation) const override;
+  Status ReplayGraph(const std::string& graph_annotation) override;
 
  private:
   mutable TensorrtExecutionProviderInfo info_;
@@ -294,6 +297,14 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   bool cuda_graph_enable_ = false;
   std::string cache_prefix_;
 
+  // Grow the profile ranges of the dynamic shape inputs to powers of 2, so that the engine is rebuilt
+  // O(log(max_dim)) times instead of whenever a dimension exceeds the range seen so far.
+  bool profile_shape_bucketing_ = false;
+
+  // Initializers which are also consumed outside of a TRT subgraph, e.g. by CUDA EP nodes, become inputs of the
+  // engine instead of being baked into it, so that the GPU holds the single copy owned by the session state.
+  bool share_initializers_enable_ = false;
+
   // The OrtAllocator object will be get during ep compute time
   // and should be kept for the lifetime of TRT EP object.
   OrtAllocator* alloc_ = nullptr;
@@ -50,6 +50,8 @@ constexpr const char* kCudaGraphEnable = "trt_cuda_graph_enable";
 constexpr const char* kEpContextEmbedMode = "trt_ep_context_embed_mode";
 constexpr const char* kEpContextFilePath = "trt_ep_context_file_path";
 constexpr const char* kDumpEpContextModel = "trt_dump_ep_context_model";
+constexpr const char* kProfileShapeBucketing = "trt_profile_shape_bucketing";
+constexpr const char* kShareInitializersEnable = "trt_share_initializers_enable";
 }  // namespace provider_option_names
 }  // namespace tensorrt
 
@@ -105,6 +107,8 @@ TensorrtExecutionProviderInfo TensorrtExecutionProviderInfo::FromProviderOptions
           .AddAssignmentToReference(tensorrt::provider_option_names::kDumpEpContextModel, info.dump_ep_context_model)
           .AddAssignmentToReference(tensorrt::provider_option_names::kEpContextFilePath, info.ep_context_file_path)
           .AddAssignmentToReference(tensorrt::provider_option_names::kEpContextEmbedMode, info.ep_context_embed_mode)
+          .AddAssignmentToReference(tensorrt::provider_option_names::kProfileShapeBucketing, info.profile_shape_bucketing)
+          .AddAssignmentToReference(tensorrt::provider_option_names::kShareInitializersEnable, info.share_initializers_enable)
           .Parse(options));  // add new provider option here.
 
   return info;
@@ -150,6 +154,8 @@ ProviderOptions TensorrtExecutionProviderInfo::ToProviderOptions(const TensorrtE
       {tensorrt::provider_option_names::kDumpEpContextModel, MakeStringWithClassicLocale(info.dump_ep_context_model)},
       {tensorrt::provider_option_names::kEpContextFilePath, MakeStringWithClassicLocale(info.ep_context_file_path)},
       {tensorrt::provider_option_names::kEpContextEmbedMode, MakeStringWithClassicLocale(info.ep_context_embed_mode)},
+      {tensorrt::provider_option_names::kProfileShapeBucketing, MakeStringWithClassicLocale(info.profile_shape_bucketing)},
+      {tensorrt::provider_option_names::kShareInitializersEnable, MakeStringWithClassicLocale(info.share_initializers_enable)},
   };
   return options;
 }
@@ -206,6 +212,8 @@ ProviderOptions TensorrtExecutionProviderInfo::ToProviderOptions(const OrtTensor
       {tensorrt::provider_option_names::kEpContextFilePath, kEpContextFilePath_},
       {tensorrt::provider_option_names::kDumpEpContextModel, MakeStringWithClassicLocale(info.trt_dump_ep_context_model)},
       {tensorrt::provider_option_names::kEpContextEmbedMode, MakeStringWithClassicLocale(info.trt_ep_context_embed_mode)},
+      {tensorrt::provider_option_names::kProfileShapeBucketing, MakeStringWithClassicLocale(info.trt_profile_shape_bucketing)},
+      {tensorrt::provider_option_names::kShareInitializersEnable, MakeStringWithClassicLocale(info.trt_share_initializers_enable)},
   };
   return options;
 }
@@ -301,5 +309,7 @@ void TensorrtExecutionProviderInfo::UpdateProviderOptions(void* provider_options
   trt_provider_options_v2.trt_dump_ep_context_model = internal_options.dump_ep_context_model;
   trt_provider_options_v2.trt_ep_context_embed_mode = internal_options.ep_context_embed_mode;
   trt_provider_options_v2.trt_ep_context_file_path = copy_string_if_needed(internal_options.ep_context_file_path);
+  trt_provider_options_v2.trt_profile_shape_bucketing = internal_options.profile_shape_bucketing;
+  trt_provider_options_v2.trt_share_initializers_enable = internal_options.share_initializers_enable;
 }
 }  // namespace onnxruntime
@@ -52,6 +52,7 @@ struct TensorrtProviderFactory : IExecutionProviderFactory {
   ~TensorrtProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
+  std::unique_ptr<IExecutionProvider> CreateProviderForDevice(int device_id) override;
 
  private:
   TensorrtExecutionProviderInfo info_;
@@ -61,6 +62,12 @@ std::unique_ptr<IExecutionProvider> TensorrtProviderFactory::CreateProvider() {
   return std::make_unique<TensorrtExecutionProvider>(info_);
 }
 
+std::unique_ptr<IExecutionProvider> TensorrtProviderFactory::CreateProviderForDevice(int device_id) {
+  auto info = info_;
+  info.device_id = device_id;
+  return std::make_unique<TensorrtExecutionProvider>(info);
+}
+
 struct Tensorrt_Provider : Provider {
   void* GetInfo() override { return &g_info; }
   std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory(int device_id) override {
@@ -112,6 +119,8 @@ struct Tensorrt_Provider : Provider {
     info.dump_ep_context_model = options.trt_dump_ep_context_model != 0;
     info.ep_context_file_path = options.trt_ep_context_file_path == nullptr ? "" : options.trt_ep_context_file_path;
     info.ep_context_embed_mode = options.trt_ep_context_embed_mode;
+    info.profile_shape_bucketing = options.trt_profile_shape_bucketing != 0;
+    info.share_initializers_enable = options.trt_share_initializers_enable != 0;
     info.engine_cache_prefix = options.trt_engine_cache_prefix == nullptr ? "" : options.trt_engine_cache_prefix;
 
     return std::make_shared<TensorrtProviderFactory>(info);
@@ -88,24 +88,21 @@ Status MatMul::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
   if (b_shape_.NumDimensions() == 1) {
     shape_broadcast.push_back(1);
   }
-  status = xnn_create_fully_connected_nc_f32(
-      shape_broadcast[0],    // size_t input_channels,
-      shape_broadcast[1],    // size_t output_channels,
-      shape_broadcast[0],    // size_t input_stride,
-      shape_broadcast[1],    // size_t output_stride,
-      tensor.Data<float>(),  // const float* kernel,
-      nullptr,               // const float* bias,
-      output_min,
-      output_max,
-      flags,
-#ifdef XNN_CACHE_ENABLE
-      GetCodeCache(),
-      GetWeightsCache(),
-#else
-      nullptr,
-      nullptr,
-#endif
-      &p);
+  status = CreateWithWeightsCache([&](xnn_weights_cache_t weights_cache) {
+    return xnn_create_fully_connected_nc_f32(
+        shape_broadcast[0],    // size_t input_channels,
+        shape_broadcast[1],    // size_t output_channels,
+        shape_broadcast[0],    // size_t input_stride,
+        shape_broadcast[1],    // size_t output_stride,
+        tensor.Data<float>(),  // const float* kernel,
+        nullptr,               // const float* bias,
+        output_min,
+        output_max,
+        flags,
+        GetCodeCache(),
+        weights_cache,
+        &p);
+  });
 
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_create_fully_connected_nc_f32 returned ", status);
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <iterator>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
@@ -13,10 +15,13 @@
 
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/partitioning_utils.h"
 #include "core/providers/shared/node_unit/node_unit.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "xnnpack_init.h"
+#include "xnnpack_subgraph.h"
 
 namespace onnxruntime {
 
@@ -154,8 +159,25 @@ std::unique_ptr<KernelRegistry> RegisterKernels() {
 
 using namespace xnnpack;
 
+namespace {
+// The weights cache shared by the XNNPACK EPs created with the shared_weights_cache option. The EPs and kernels hold
+// it, so it is freed and recreated on demand when all the sessions using it are released.
+struct SharedWeightsCacheRegistry {
+  OrtMutex mutex;
+  std::weak_ptr<xnn_weights_cache> cache;
+  bool finalized{false};
+};
+
+SharedWeightsCacheRegistry& GetSharedWeightsCacheRegistry() {
+  static SharedWeightsCacheRegistry registry;
+  return registry;
+}
+}  // namespace
+
 XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProviderInfo& info)
-    : IExecutionProvider{kXnnpackExecutionProvider} {
+    : IExecutionProvider{kXnnpackExecutionProvider},
+      use_shared_weights_cache_{info.shared_weights_cache},
+      fuse_subgraphs_{info.fuse_subgraphs} {
   int xnn_thread_pool_size = info.xnn_thread_pool_size;
   int ort_thread_pool_size = info.session_options ? info.session_options->intra_op_param.thread_pool_size : 1;
   bool allow_intra_op_spinning = (info.session_options == nullptr) ||
@@ -200,6 +222,46 @@ std::vector<AllocatorPtr> XnnpackExecutionProvider::CreatePreferredAllocators()
   return std::vector<AllocatorPtr>{stored_allocator};
 }
 
+std::shared_ptr<xnn_weights_cache> XnnpackExecutionProvider::GetSharedWeightsCache() const {
+  if (!use_shared_weights_cache_) {
+    return nullptr;
+  }
+
+  // created on first use as XNNPACK has to be initialized with the allocator first
+  auto& registry = GetSharedWeightsCacheRegistry();
+  std::lock_guard<OrtMutex> lock(registry.mutex);
+  auto cache = registry.cache.lock();
+  if (!cache) {
+    xnn_weights_cache_t weights_cache = nullptr;
+    const xnn_status status = xnn_create_weights_cache(&weights_cache);
+    ORT_ENFORCE(status == xnn_status_success, "Failed to create XNNPACK weights cache. Status:", status);
+    cache.reset(weights_cache, xnn_delete_weights_cache);
+    registry.cache = cache;
+    registry.finalized = false;
+  }
+
+  return cache;
+}
+
+Status XnnpackExecutionProvider::OnSessionInitializationEnd() {
+  if (!use_shared_weights_cache_) {
+    return Status::OK();
+  }
+
+  auto& registry = GetSharedWeightsCacheRegistry();
+  std::lock_guard<OrtMutex> lock(registry.mutex);
+  auto cache = registry.cache.lock();
+  if (cache && !registry.finalized) {
+    // The cache must not grow once kernels run, as that may move the packed weights. A soft finalized cache still
+    // accepts weights that are already in it, which is what the other sessions of the same model insert.
+    const xnn_status status = xnn_finalize_weights_cache(cache.get(), xnn_weights_cache_finalization_kind_soft);
+    ORT_RETURN_IF(status != xnn_status_success, "Failed to finalize XNNPACK weights cache. Status:", status);
+    registry.finalized = true;
+  }
+
+  return Status::OK();
+}
+
 // For ops are not lay-out sensitive and does not defined in
 // onnx-domain, it will be created dynamicly
 static bool RequestDynamicSchema(const NodeUnit& node_unit) {
@@ -342,12 +404,100 @@ std::vector<std::unique_ptr<ComputeCapability>> XnnpackExecutionProvider::GetCap
     }
   }
 
-  // FUTURE: finding nodes to compile can be inserted here and added to the ComputeCapability instances returned.
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  // Compile the connected nodes taken in the second call into XNNPACK subgraphs.
   // GraphPartitioner can handle a mix of static and compiled kernels.
+  if (fuse_subgraphs_) {
+    std::unordered_map<NodeIndex, size_t> node_to_capability;
+    std::unordered_set<size_t> layout_transformed_capabilities;
+    for (size_t i = 0; i < capabilities.size(); ++i) {
+      for (NodeIndex index : capabilities[i]->sub_graph->nodes) {
+        node_to_capability[index] = i;
+        if (graph.GetNode(index)->GetExecutionProviderType() == Type()) {
+          layout_transformed_capabilities.insert(i);
+        }
+      }
+    }
+
+    const auto is_node_supported = [&](const Node& node) {
+      const auto it = node_to_capability.find(node.Index());
+      return it != node_to_capability.end() && layout_transformed_capabilities.count(it->second) > 0 &&
+             IsNodeSupportedInSubgraph(node, graph);
+    };
+
+    // a partition replaces the ComputeCapability instances of its nodes, so it must cover them completely.
+    // a single ComputeCapability runs as fast with its static kernel.
+    const auto on_group_closed = [&](const std::vector<const Node*>& group) {
+      std::unordered_set<NodeIndex> group_nodes;
+      std::unordered_set<size_t> group_capabilities;
+      for (const Node* node : group) {
+        group_nodes.insert(node->Index());
+        group_capabilities.insert(node_to_capability[node->Index()]);
+      }
+
+      return group_capabilities.size() > 1 &&
+             std::all_of(group_capabilities.begin(), group_capabilities.end(), [&](size_t i) {
+               const auto& nodes = capabilities[i]->sub_graph->nodes;
+               return std::all_of(nodes.begin(), nodes.end(),
+                                  [&](NodeIndex index) { return group_nodes.count(index) > 0; });
+             });
+    };
+
+    const auto gen_metadef_name = [&]() {
+      HashValue model_hash;
+      int metadef_id = metadef_id_generator_.GenerateId(graph, model_hash);
+      return MakeString("XNNPACK_", model_hash, "_", metadef_id);
+    };
+
+    auto partitions = utils::CreateSupportedPartitions(graph, is_node_supported, on_group_closed, gen_metadef_name,
+                                                       "XNNPACK", Type());
+    for (const auto& partition : partitions) {
+      for (NodeIndex index : partition->sub_graph->nodes) {
+        capabilities[node_to_capability[index]].reset();
+      }
+    }
+
+    capabilities.erase(std::remove(capabilities.begin(), capabilities.end(), nullptr), capabilities.end());
+    std::move(partitions.begin(), partitions.end(), std::back_inserter(capabilities));
+  }
+#endif
 
   return capabilities;
 }
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+common::Status XnnpackExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                                                 std::vector<NodeComputeInfo>& node_compute_funcs) {
+  for (const auto& fused_node_and_graph : fused_nodes_and_graphs) {
+    const Node& fused_node = fused_node_and_graph.fused_node;
+
+    std::unique_ptr<XnnpackSubgraph> subgraph;
+    ORT_RETURN_IF_ERROR(XnnpackSubgraph::Create(fused_node_and_graph.filtered_graph, fused_node,
+                                                xnnpack_thread_pool_, subgraph));
+    subgraphs_.emplace(fused_node.Name(), std::move(subgraph));
+
+    NodeComputeInfo compute_info;
+    compute_info.create_state_func = [this](ComputeContext* context, FunctionState* state) {
+      *state = subgraphs_[context->node_name].get();
+      return 0;
+    };
+
+    compute_info.release_state_func = [](FunctionState state) {
+      // the `state` is a XnnpackSubgraph managed by unique_ptr
+      ORT_UNUSED_PARAMETER(state);
+    };
+
+    compute_info.compute_func = [](FunctionState state, const OrtApi* /* api */, OrtKernelContext* context) {
+      return static_cast<XnnpackSubgraph*>(state)->Compute(context);
+    };
+
+    node_compute_funcs.push_back(compute_info);
+  }
+
+  return Status::OK();
+}
+#endif
+
 std::shared_ptr<KernelRegistry> XnnpackExecutionProvider::GetKernelRegistry() const {
   static std::shared_ptr<KernelRegistry> registry = xnnpack::RegisterKernels();
   return registry;
@@ -4,16 +4,30 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 #include "core/framework/execution_provider.h"
+#include "core/framework/model_metadef_id_generator.h"
 #include "core/graph/constants.h"
 #include "core/providers/providers.h"
 #include "core/framework/session_options.h"
 
 struct pthreadpool;
+struct xnn_weights_cache;
 namespace onnxruntime {
+namespace xnnpack {
+class XnnpackSubgraph;
+}  // namespace xnnpack
+
 // placeholder for future use. no options currently
 struct XnnpackExecutionProviderInfo {
   int xnn_thread_pool_size{0};
+  // share the packed weights of Conv, Gemm and MatMul with the other sessions that enable this option
+  bool shared_weights_cache{false};
+  // compile the connected nodes taken by the EP into XNNPACK subgraphs that run as one node
+  bool fuse_subgraphs{false};
   const SessionOptions* session_options{nullptr};
   XnnpackExecutionProviderInfo() = default;
 
@@ -22,6 +36,12 @@ struct XnnpackExecutionProviderInfo {
     if (auto it = po.find("intra_op_num_threads"); it != po.end()) {
       xnn_thread_pool_size = std::stoi(it->second);
     }
+    if (auto it = po.find("shared_weights_cache"); it != po.end()) {
+      shared_weights_cache = it->second == "1";
+    }
+    if (auto it = po.find("fuse_subgraphs"); it != po.end()) {
+      fuse_subgraphs = it->second == "1";
+    }
   }
 };
 
@@ -36,6 +56,11 @@ class XnnpackExecutionProvider : public IExecutionProvider {
 
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  common::Status Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override;
+#endif
+
   DataLayout GetPreferredLayout() const override { return DataLayout::NHWC; }
 
   FusionStyle GetFusionStyle() const override { return FusionStyle::FilteredGraphViewer; }
@@ -47,10 +72,22 @@ class XnnpackExecutionProvider : public IExecutionProvider {
     return xnnpack_thread_pool_;
   }
 
+  // Weights cache shared by the kernels of all XNNPACK EPs created with the shared_weights_cache option, or nullptr.
+  // Kernels packing identical weights share one copy, which is released when the last kernel using it is freed.
+  std::shared_ptr<xnn_weights_cache> GetSharedWeightsCache() const;
+
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
 
+  // Soft finalizes the shared weights cache when the first session using it is initialized. Kernels created afterwards
+  // reuse the weights that are already cached and pack any others into their own buffers.
+  Status OnSessionInitializationEnd() override;
+
  private:
   pthreadpool* xnnpack_thread_pool_{nullptr};
+  bool use_shared_weights_cache_{false};
+  bool fuse_subgraphs_{false};
+  ModelMetadefIdGenerator metadef_id_generator_;
+  std::unordered_map<std::string, std::unique_ptr<xnnpack::XnnpackSubgraph>> subgraphs_;
 };
 
 }  // namespace onnxruntime
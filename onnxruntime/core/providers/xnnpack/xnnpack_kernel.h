@@ -17,7 +17,11 @@ class XnnpackKernel : public OpKernel {
       : OpKernel{info},
         xnnpack_threadpool_{
             static_cast<const XnnpackExecutionProvider*>(info.GetExecutionProvider())->GetPrivateThreadPool()},
-        caches_{enable_caches} {
+        shared_weights_cache_{
+            enable_caches
+                ? static_cast<const XnnpackExecutionProvider*>(info.GetExecutionProvider())->GetSharedWeightsCache()
+                : nullptr},
+        caches_{enable_caches && !shared_weights_cache_} {
   }
   [[nodiscard]] pthreadpool* GetThreadPool() const {
     return xnnpack_threadpool_;
@@ -26,11 +30,29 @@ class XnnpackKernel : public OpKernel {
   // see comment below about enabling code cache
   // xnn_code_cache_t GetCodeCache() { return caches_.auto_code_cache.get();}
   xnn_code_cache_t GetCodeCache() { return nullptr; }
-  xnn_weights_cache_t GetWeightsCache() { return caches_.auto_weights_cache.get(); }
+  xnn_weights_cache_t GetWeightsCache() {
+    return shared_weights_cache_ ? shared_weights_cache_.get() : caches_.auto_weights_cache.get();
+  }
+
+  // Creates an XNNPACK operator with create_op(weights_cache). If the weights cache is shared and was finalized
+  // without the weights of this kernel, the operator is created with its own packed weights instead.
+  template <typename CreateOp>
+  xnn_status CreateWithWeightsCache(CreateOp&& create_op) {
+    xnn_weights_cache_t weights_cache = GetWeightsCache();
+    xnn_status status = create_op(weights_cache);
+    if (status != xnn_status_success && shared_weights_cache_) {
+      status = create_op(nullptr);
+    }
+
+    return status;
+  }
 
  private:
   pthreadpool* xnnpack_threadpool_;
 
+  // keeps the weights cache shared across sessions alive while the operators of this kernel use it
+  std::shared_ptr<xnn_weights_cache> shared_weights_cache_;
+
   // Helper class to wrap usage of the XNNPACK weights and code caches.
   // NOTE: Currently creating/freeing the code cache is not exposed via the public xnnpack.h header so usage is
   // commented out. If we need to use it, we'll need to add the 'src' directory of XNNPACK to the include path
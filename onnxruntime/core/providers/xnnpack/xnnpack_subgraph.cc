@@ -0,0 +1,515 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/xnnpack_subgraph.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/providers/cpu/nn/pool_attributes.h"
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+namespace {
+bool IsStaticFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type() ||
+      type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  const auto* shape = arg.Shape();
+  return shape != nullptr &&
+         std::all_of(shape->dim().begin(), shape->dim().end(),
+                     [](const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) {
+                       return dim.has_dim_value() && dim.dim_value() > 0;
+                     });
+}
+
+// rank of a constant float initializer, or -1 if the input is not one
+int GetConstantRank(const NodeArg& arg, const GraphViewer& graph) {
+  const auto* tensor = arg.Exists() ? graph.GetConstantInitializer(arg.Name(), true) : nullptr;
+  if (tensor == nullptr || tensor->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return -1;
+  }
+
+  return tensor->dims_size();
+}
+
+int GetRank(const NodeArg& arg) {
+  return arg.Shape() != nullptr ? arg.Shape()->dim_size() : -1;
+}
+
+// Bounds of a Relu or Clip node. Returns false if the bounds of the Clip node are not constant.
+bool GetClampBounds(const Node& node, const GraphViewer& graph, float& output_min, float& output_max) {
+  output_min = -std::numeric_limits<float>::infinity();
+  output_max = std::numeric_limits<float>::infinity();
+
+  if (node.OpType() == "Relu") {
+    output_min = 0.0f;
+    return true;
+  }
+
+  if (node.SinceVersion() < 11) {
+    ProtoHelperNodeContext nc(node);
+    OpNodeProtoHelper info(&nc);
+    output_min = info.GetAttrOrDefault<float>("min", std::numeric_limits<float>::lowest());
+    output_max = info.GetAttrOrDefault<float>("max", std::numeric_limits<float>::max());
+    return true;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  for (size_t i = 1; i < std::min<size_t>(input_defs.size(), 3); ++i) {
+    if (!input_defs[i]->Exists()) {
+      continue;
+    }
+
+    const auto* bound_tensor = graph.GetConstantInitializer(input_defs[i]->Name(), true);
+    if (bound_tensor == nullptr || bound_tensor->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+      return false;
+    }
+
+    Initializer bound(*bound_tensor, graph.ModelPath());
+    if (bound.size() != 1) {
+      return false;
+    }
+
+    (i == 1 ? output_min : output_max) = bound.DataAsSpan<float>()[0];
+  }
+
+  return true;
+}
+
+// Defines the values and nodes of an XNNPACK subgraph for the nodes of a partition
+class SubgraphBuilder {
+ public:
+  SubgraphBuilder(xnn_subgraph_t subgraph, const GraphViewer& graph,
+                  std::vector<std::vector<float>>& static_data)
+      : subgraph_{subgraph}, graph_{graph}, static_data_{static_data} {}
+
+  Status DefineExternalValue(const NodeArg& arg, uint32_t external_id, uint32_t flags) {
+    auto shape = utils::GetTensorShapeFromTensorShapeProto(*arg.Shape());
+    uint32_t id = XNN_INVALID_VALUE_ID;
+    ORT_RETURN_IF_ERROR(DefineTensorValue(shape.GetDims(), nullptr, external_id, flags, id));
+    value_ids_[arg.Name()] = id;
+    return Status::OK();
+  }
+
+  Status DefineNode(const Node& node);
+
+ private:
+  Status DefineTensorValue(gsl::span<const int64_t> shape, const void* data, uint32_t external_id, uint32_t flags,
+                           uint32_t& id) {
+    std::vector<size_t> dims(shape.begin(), shape.end());
+    const xnn_status status = xnn_define_tensor_value(subgraph_, xnn_datatype_fp32, dims.size(), dims.data(), data,
+                                                      external_id, flags, &id);
+    ORT_RETURN_IF(status != xnn_status_success, "xnn_define_tensor_value returned ", status);
+    return Status::OK();
+  }
+
+  Status GetValueId(const NodeArg& arg, uint32_t& id) const {
+    auto it = value_ids_.find(arg.Name());
+    ORT_RETURN_IF(it == value_ids_.end(), "XNNPACK subgraph value was not defined: ", arg.Name());
+    id = it->second;
+    return Status::OK();
+  }
+
+  // output values are defined by their producer, unless they are outputs of the partition
+  Status DefineOutputValue(const NodeArg& arg, uint32_t& id) {
+    if (auto it = value_ids_.find(arg.Name()); it != value_ids_.end()) {
+      id = it->second;
+      return Status::OK();
+    }
+
+    auto shape = utils::GetTensorShapeFromTensorShapeProto(*arg.Shape());
+    ORT_RETURN_IF_ERROR(DefineTensorValue(shape.GetDims(), nullptr, XNN_INVALID_VALUE_ID, 0, id));
+    value_ids_[arg.Name()] = id;
+    return Status::OK();
+  }
+
+  // copies a constant initializer into a static value, with its dims permuted to the XNNPACK layout if `perm` is
+  // given
+  Status DefineStaticValue(const NodeArg& arg, const std::vector<size_t>& perm, uint32_t& id) {
+    const auto* tensor = graph_.GetConstantInitializer(arg.Name(), true);
+    ORT_RETURN_IF(tensor == nullptr, "XNNPACK subgraph input is not a constant initializer: ", arg.Name());
+    Initializer initializer(*tensor, graph_.ModelPath());
+    const auto values = initializer.DataAsSpan<float>();
+    const auto dims = initializer.dims();
+
+    auto& data = static_data_.emplace_back(values.begin(), values.end());
+    TensorShapeVector shape(dims.begin(), dims.end());
+    if (!perm.empty()) {
+      // e.g. Conv weights {M, C/group, kH, kW} -> {M, kH, kW, C/group}
+      TensorShapeVector strides(dims.size(), 1);
+      for (size_t i = dims.size() - 1; i > 0; --i) {
+        strides[i - 1] = strides[i] * dims[i];
+      }
+
+      TensorShapeVector index(dims.size(), 0);
+      for (size_t i = 0; i < perm.size(); ++i) {
+        shape[i] = dims[perm[i]];
+      }
+
+      for (size_t out = 0; out < data.size(); ++out) {
+        size_t in = 0;
+        for (size_t i = 0; i < perm.size(); ++i) {
+          in += narrow<size_t>(index[i] * strides[perm[i]]);
+        }
+        data[out] = values[in];
+
+        for (size_t i = perm.size(); i-- > 0;) {
+          if (++index[i] < shape[i]) {
+            break;
+          }
+          index[i] = 0;
+        }
+      }
+    }
+
+    return DefineTensorValue(shape, data.data(), XNN_INVALID_VALUE_ID, 0, id);
+  }
+
+  Status DefineConv(const Node& node);
+  Status DefinePool(const Node& node);
+  Status DefineFullyConnected(const Node& node);
+
+  xnn_subgraph_t subgraph_;
+  const GraphViewer& graph_;
+  std::vector<std::vector<float>>& static_data_;
+  std::unordered_map<std::string, uint32_t> value_ids_;
+};
+
+Status SubgraphBuilder::DefineConv(const Node& node) {
+  const auto& input_defs = node.InputDefs();
+  const auto& x_shape = *input_defs[0]->Shape();
+  const auto* w_tensor = graph_.GetConstantInitializer(input_defs[1]->Name(), true);
+  const int64_t C = x_shape.dim(3).dim_value();  // input is NHWC
+  const int64_t M = w_tensor->dims(0);
+  const uint32_t kernel_height = narrow<uint32_t>(w_tensor->dims(2));
+  const uint32_t kernel_width = narrow<uint32_t>(w_tensor->dims(3));
+
+  ProtoHelperNodeContext nc(node);
+  OpNodeProtoHelper info(&nc);
+  const auto auto_pad = StringToAutoPadType(info.GetAttrOrDefault<std::string>("auto_pad", "NOTSET"));
+  auto pads = info.GetAttrsOrDefault("pads", TensorShapeVector{0, 0, 0, 0});
+  const auto strides = info.GetAttrsOrDefault("strides", TensorShapeVector{1, 1});
+  const auto dilations = info.GetAttrsOrDefault("dilations", TensorShapeVector{1, 1});
+  const int64_t group = info.GetAttrOrDefault<int64_t>("group", 1);
+
+  uint32_t flags = 0;
+  if (auto_pad == AutoPadType::SAME_UPPER) {
+    flags |= XNN_FLAG_TENSORFLOW_SAME_PADDING;
+  }
+  if (auto_pad != AutoPadType::NOTSET) {
+    pads.assign(4, 0);
+  }
+
+  uint32_t input_id, filter_id, bias_id = XNN_INVALID_VALUE_ID, output_id;
+  ORT_RETURN_IF_ERROR(GetValueId(*input_defs[0], input_id));
+  ORT_RETURN_IF_ERROR(DefineStaticValue(*input_defs[1], {0, 2, 3, 1}, filter_id));
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    ORT_RETURN_IF_ERROR(DefineStaticValue(*input_defs[2], {}, bias_id));
+  }
+  ORT_RETURN_IF_ERROR(DefineOutputValue(*node.OutputDefs()[0], output_id));
+
+  // pads are {top, left, bottom, right}
+  const xnn_status status = xnn_define_convolution_2d(
+      subgraph_,
+      narrow<uint32_t>(pads[0]), narrow<uint32_t>(pads[3]), narrow<uint32_t>(pads[2]), narrow<uint32_t>(pads[1]),
+      kernel_height, kernel_width,
+      narrow<uint32_t>(strides[0]), narrow<uint32_t>(strides[1]),
+      narrow<uint32_t>(dilations[0]), narrow<uint32_t>(dilations[1]),
+      narrow<uint32_t>(group), narrow<size_t>(C / group), narrow<size_t>(M / group),
+      -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+      input_id, filter_id, bias_id, output_id, flags);
+  ORT_RETURN_IF(status != xnn_status_success, "xnn_define_convolution_2d returned ", status);
+  return Status::OK();
+}
+
+Status SubgraphBuilder::DefinePool(const Node& node) {
+  ProtoHelperNodeContext nc(node);
+  OpNodeProtoHelper info(&nc);
+  PoolAttributes pool_attrs(info, node.OpType(), node.SinceVersion());
+
+  uint32_t flags = 0;
+  if (pool_attrs.auto_pad == AutoPadType::SAME_UPPER) {
+    flags |= XNN_FLAG_TENSORFLOW_SAME_PADDING;
+  }
+  if (pool_attrs.auto_pad != AutoPadType::NOTSET) {
+    pool_attrs.pads.assign(4, 0);
+  }
+
+  uint32_t input_id, output_id;
+  ORT_RETURN_IF_ERROR(GetValueId(*node.InputDefs()[0], input_id));
+  ORT_RETURN_IF_ERROR(DefineOutputValue(*node.OutputDefs()[0], output_id));
+
+  const auto& pads = pool_attrs.pads;
+  xnn_status status;
+  if (node.OpType() == "MaxPool") {
+    status = xnn_define_max_pooling_2d(
+        subgraph_,
+        narrow<uint32_t>(pads[0]), narrow<uint32_t>(pads[3]), narrow<uint32_t>(pads[2]), narrow<uint32_t>(pads[1]),
+        narrow<uint32_t>(pool_attrs.kernel_shape[0]), narrow<uint32_t>(pool_attrs.kernel_shape[1]),
+        narrow<uint32_t>(pool_attrs.strides[0]), narrow<uint32_t>(pool_attrs.strides[1]),
+        narrow<uint32_t>(pool_attrs.dilations[0]), narrow<uint32_t>(pool_attrs.dilations[1]),
+        -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+        input_id, output_id, flags);
+  } else {
+    status = xnn_define_average_pooling_2d(
+        subgraph_,
+        narrow<uint32_t>(pads[0]), narrow<uint32_t>(pads[3]), narrow<uint32_t>(pads[2]), narrow<uint32_t>(pads[1]),
+        narrow<uint32_t>(pool_attrs.kernel_shape[0]), narrow<uint32_t>(pool_attrs.kernel_shape[1]),
+        narrow<uint32_t>(pool_attrs.strides[0]), narrow<uint32_t>(pool_attrs.strides[1]),
+        -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+        input_id, output_id, flags);
+  }
+
+  ORT_RETURN_IF(status != xnn_status_success, "Failed to define ", node.OpType(), " in XNNPACK subgraph: ", status);
+  return Status::OK();
+}
+
+Status SubgraphBuilder::DefineFullyConnected(const Node& node) {
+  const auto& input_defs = node.InputDefs();
+
+  // the filter is {output_channels, input_channels}, or {input_channels, output_channels} with
+  // XNN_FLAG_TRANSPOSE_WEIGHTS, which matches a B input that is not transposed
+  uint32_t flags = XNN_FLAG_TRANSPOSE_WEIGHTS;
+  if (node.OpType() == "Gemm") {
+    ProtoHelperNodeContext nc(node);
+    OpNodeProtoHelper info(&nc);
+    if (info.GetAttrOrDefault<int64_t>("transB", 0) != 0) {
+      flags = 0;
+    }
+  }
+
+  uint32_t input_id, filter_id, bias_id = XNN_INVALID_VALUE_ID, output_id;
+  ORT_RETURN_IF_ERROR(GetValueId(*input_defs[0], input_id));
+  ORT_RETURN_IF_ERROR(DefineStaticValue(*input_defs[1], {}, filter_id));
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    ORT_RETURN_IF_ERROR(DefineStaticValue(*input_defs[2], {}, bias_id));
+  }
+  ORT_RETURN_IF_ERROR(DefineOutputValue(*node.OutputDefs()[0], output_id));
+
+  const xnn_status status = xnn_define_fully_connected(
+      subgraph_, -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+      input_id, filter_id, bias_id, output_id, flags);
+  ORT_RETURN_IF(status != xnn_status_success, "xnn_define_fully_connected returned ", status);
+  return Status::OK();
+}
+
+Status SubgraphBuilder::DefineNode(const Node& node) {
+  const auto& op_type = node.OpType();
+  if (op_type == "Conv") {
+    return DefineConv(node);
+  }
+
+  if (op_type == "MaxPool" || op_type == "AveragePool") {
+    return DefinePool(node);
+  }
+
+  if (op_type == "Gemm" || op_type == "MatMul") {
+    return DefineFullyConnected(node);
+  }
+
+  uint32_t input_id, output_id;
+  ORT_RETURN_IF_ERROR(GetValueId(*node.InputDefs()[0], input_id));
+  ORT_RETURN_IF_ERROR(DefineOutputValue(*node.OutputDefs()[0], output_id));
+
+  xnn_status status = xnn_status_unsupported_parameter;
+  if (op_type == "Softmax") {
+    status = xnn_define_softmax(subgraph_, input_id, output_id, 0);
+  } else if (op_type == "Relu" || op_type == "Clip") {
+    // XNNPACK fuses the clamp into the producer if possible
+    float output_min, output_max;
+    ORT_RETURN_IF_NOT(GetClampBounds(node, graph_, output_min, output_max), "Clip bounds are not constant");
+    status = xnn_define_clamp(subgraph_, output_min, output_max, input_id, output_id, 0);
+  }
+
+  ORT_RETURN_IF(status != xnn_status_success, "Failed to define ", op_type, " in XNNPACK subgraph: ", status);
+  return Status::OK();
+}
+}  // namespace
+
+bool IsNodeSupportedInSubgraph(const Node& node, const GraphViewer& graph) {
+  const auto& input_defs = node.InputDefs();
+  const auto& output_defs = node.OutputDefs();
+
+  // values computed at runtime must be float with static shapes, as they are planned when the runtime is created
+  for (const auto* input : input_defs) {
+    if (input->Exists() && !graph.IsConstantInitializer(input->Name(), true) && !IsStaticFloatTensor(*input)) {
+      return false;
+    }
+  }
+
+  if (output_defs.empty() || !IsStaticFloatTensor(*output_defs[0])) {
+    return false;
+  }
+
+  // optional outputs such as the MaxPool indices are not supported
+  for (size_t i = 1; i < output_defs.size(); ++i) {
+    if (output_defs[i]->Exists()) {
+      return false;
+    }
+  }
+
+  const auto& op_type = node.OpType();
+  if (node.Domain() == kMSInternalNHWCDomain) {
+    if (GetRank(*input_defs[0]) != 4) {
+      return false;
+    }
+
+    if (op_type == "Conv") {
+      ProtoHelperNodeContext nc(node);
+      OpNodeProtoHelper info(&nc);
+      const auto auto_pad = info.GetAttrOrDefault<std::string>("auto_pad", "NOTSET");
+      return GetConstantRank(*input_defs[1], graph) == 4 &&
+             (input_defs.size() < 3 || !input_defs[2]->Exists() || GetConstantRank(*input_defs[2], graph) == 1) &&
+             auto_pad != "SAME_LOWER";
+    }
+
+    if (op_type == "MaxPool" || op_type == "AveragePool") {
+      ProtoHelperNodeContext nc(node);
+      OpNodeProtoHelper info(&nc);
+      PoolAttributes pool_attrs(info, op_type, node.SinceVersion());
+      return pool_attrs.kernel_shape.size() == 2 && pool_attrs.ceil_mode == 0 &&
+             pool_attrs.auto_pad != AutoPadType::SAME_LOWER &&
+             (op_type == "MaxPool" || (!pool_attrs.count_include_pad && pool_attrs.default_dilations));
+    }
+
+    return false;
+  }
+
+  if (node.Domain() != kOnnxDomain) {
+    return false;
+  }
+
+  if (op_type == "Relu") {
+    return true;
+  }
+
+  if (op_type == "Clip") {
+    float output_min, output_max;
+    return GetClampBounds(node, graph, output_min, output_max);
+  }
+
+  if (op_type == "Softmax") {
+    // XNNPACK normalizes over the last axis only
+    ProtoHelperNodeContext nc(node);
+    OpNodeProtoHelper info(&nc);
+    const int64_t rank = GetRank(*input_defs[0]);
+    int64_t axis = info.GetAttrOrDefault<int64_t>("axis", node.SinceVersion() < 13 ? 1 : -1);
+    axis = axis < 0 ? axis + rank : axis;
+    return axis == rank - 1;
+  }
+
+  if (op_type == "MatMul") {
+    return GetRank(*input_defs[0]) == 2 && GetConstantRank(*input_defs[1], graph) == 2;
+  }
+
+  if (op_type == "Gemm") {
+    ProtoHelperNodeContext nc(node);
+    OpNodeProtoHelper info(&nc);
+    const bool has_bias = input_defs.size() > 2 && input_defs[2]->Exists();
+    if (info.GetAttrOrDefault<int64_t>("transA", 0) != 0 ||
+        info.GetAttrOrDefault<float>("alpha", 1.0f) != 1.0f ||
+        (has_bias && info.GetAttrOrDefault<float>("beta", 1.0f) != 1.0f) ||
+        GetRank(*input_defs[0]) != 2 || GetConstantRank(*input_defs[1], graph) != 2) {
+      return false;
+    }
+
+    // the bias must be a vector of the output channels
+    return !has_bias || (GetConstantRank(*input_defs[2], graph) == 1 &&
+                         input_defs[2]->Shape()->dim(0).dim_value() == output_defs[0]->Shape()->dim(1).dim_value());
+  }
+
+  return false;
+}
+
+Status XnnpackSubgraph::Create(const GraphViewer& graph_viewer, const Node& fused_node, pthreadpool* threadpool,
+                               std::unique_ptr<XnnpackSubgraph>& subgraph) {
+  std::unique_ptr<XnnpackSubgraph> result(new XnnpackSubgraph());
+
+  // constant initializers are defined as static values by the nodes using them
+  const auto& input_defs = fused_node.InputDefs();
+  const auto& output_defs = fused_node.OutputDefs();
+  uint32_t num_external_values = 0;
+  for (size_t i = 0; i < input_defs.size(); ++i) {
+    if (!graph_viewer.IsConstantInitializer(input_defs[i]->Name(), true)) {
+      auto shape = utils::GetTensorShapeFromTensorShapeProto(*input_defs[i]->Shape());
+      result->inputs_.push_back({i, num_external_values++, shape.AsShapeVector()});
+    }
+  }
+
+  for (size_t i = 0; i < output_defs.size(); ++i) {
+    auto shape = utils::GetTensorShapeFromTensorShapeProto(*output_defs[i]->Shape());
+    result->outputs_.push_back({i, num_external_values++, shape.AsShapeVector()});
+  }
+
+  xnn_subgraph_t xnn_subgraph = nullptr;
+  xnn_status status = xnn_create_subgraph(num_external_values, 0, &xnn_subgraph);
+  ORT_RETURN_IF(status != xnn_status_success, "xnn_create_subgraph returned ", status);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> subgraph_holder(xnn_subgraph, xnn_delete_subgraph);
+
+  SubgraphBuilder builder(xnn_subgraph, graph_viewer, result->static_data_);
+  for (const auto& input : result->inputs_) {
+    ORT_RETURN_IF_ERROR(builder.DefineExternalValue(*input_defs[input.index], input.id,
+                                                    XNN_VALUE_FLAG_EXTERNAL_INPUT));
+  }
+
+  for (const auto& output : result->outputs_) {
+    ORT_RETURN_IF_ERROR(builder.DefineExternalValue(*output_defs[output.index], output.id,
+                                                    XNN_VALUE_FLAG_EXTERNAL_OUTPUT));
+  }
+
+  for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+    ORT_RETURN_IF_ERROR(builder.DefineNode(*graph_viewer.GetNode(index)));
+  }
+
+  xnn_runtime_t runtime = nullptr;
+  status = xnn_create_runtime_v2(xnn_subgraph, threadpool, 0, &runtime);
+  ORT_RETURN_IF(status != xnn_status_success, "xnn_create_runtime_v2 returned ", status);
+  result->runtime_.reset(runtime);
+
+  subgraph = std::move(result);
+  return Status::OK();
+}
+
+Status XnnpackSubgraph::Compute(OrtKernelContext* context) {
+  Ort::KernelContext ctx(context);
+
+  std::vector<xnn_external_value> external_values;
+  external_values.reserve(inputs_.size() + outputs_.size());
+  for (const auto& input : inputs_) {
+    auto tensor = ctx.GetInput(input.index);
+    const auto shape = tensor.GetTensorTypeAndShapeInfo().GetShape();
+    ORT_RETURN_IF_NOT(std::equal(shape.begin(), shape.end(), input.shape.begin(), input.shape.end()),
+                      "The shape of input ", input.index, " differs from the shape the XNNPACK subgraph was "
+                      "compiled for: ", TensorShape(shape), " != ", TensorShape(input.shape));
+    external_values.push_back(xnn_external_value{input.id, const_cast<void*>(tensor.GetTensorRawData())});
+  }
+
+  for (const auto& output : outputs_) {
+    auto tensor = ctx.GetOutput(output.index, output.shape.data(), output.shape.size());
+    external_values.push_back(xnn_external_value{output.id, tensor.GetTensorMutableRawData()});
+  }
+
+  xnn_status status = xnn_setup_runtime(runtime_.get(), external_values.size(), external_values.data());
+  ORT_RETURN_IF(status != xnn_status_success, "xnn_setup_runtime returned ", status);
+
+  status = xnn_invoke_runtime(runtime_.get());
+  ORT_RETURN_IF(status != xnn_status_success, "xnn_invoke_runtime returned ", status);
+
+  return Status::OK();
+}
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
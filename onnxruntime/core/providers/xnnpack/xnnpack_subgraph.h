@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/tensor_shape.h"
+#include "xnnpack.h"
+
+struct OrtKernelContext;
+struct pthreadpool;
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+
+namespace xnnpack {
+
+// Returns true if XnnpackSubgraph can define the node. Only float tensors with static shapes are supported, and
+// layout sensitive operators must have been converted to NHWC.
+bool IsNodeSupportedInSubgraph(const Node& node, const GraphViewer& graph);
+
+// A partition of the graph compiled into a single XNNPACK runtime.
+// XNNPACK plans the memory of the intermediate values and fuses operators such as Conv and Clip, so the whole
+// partition runs as one node without going through the ORT executor for each operator.
+class XnnpackSubgraph {
+ public:
+  // Compiles the nodes of the filtered graph of the fused node. The inputs and outputs of the fused node map to the
+  // external values of the runtime.
+  static Status Create(const GraphViewer& graph_viewer, const Node& fused_node, pthreadpool* threadpool,
+                       std::unique_ptr<XnnpackSubgraph>& subgraph);
+
+  // Runs the partition. Not thread safe, the XNNPACK EP does not support concurrent runs.
+  Status Compute(OrtKernelContext* context);
+
+ private:
+  struct ExternalValue {
+    size_t index;  // index of the fused node input or output
+    uint32_t id;   // id of the XNNPACK external value
+    TensorShapeVector shape;
+  };
+
+  XnnpackSubgraph() : runtime_(nullptr, xnn_delete_runtime) {}
+
+  std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_;
+  std::vector<ExternalValue> inputs_;
+  std::vector<ExternalValue> outputs_;
+  // weights that were transposed to the XNNPACK layout
+  std::vector<std::vector<float>> static_data_;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
@@ -94,9 +94,11 @@ common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue
     output_names_.push_back(name);
     outputs_.push_back(ml_value);
     outputs_device_info_.push_back(device);
+    outputs_bound_to_device_.push_back(!ml_value.IsAllocated());
   } else {
     outputs_[index] = ml_value;
     outputs_device_info_[index] = device;
+    outputs_bound_to_device_[index] = !ml_value.IsAllocated();
   }
   ORT_ENFORCE(mapped_output_names_.size() == output_names_.size(), "Size mismatch", mapped_output_names_.size(), "!=", output_names_.size());
 
@@ -108,6 +110,11 @@ void IOBinding::ClearOutputs() {
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
+  outputs_bound_to_device_.clear();
+}
+
+void IOBinding::SetOutputShapeChangedCallback(OutputShapeChangedCallback callback) {
+  output_shape_changed_callback_ = std::move(callback);
 }
 
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
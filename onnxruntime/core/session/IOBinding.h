@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -66,11 +67,23 @@ class IOBinding {
 
   /**
    * Bind an output name to a device.
+   * The output is allocated by the first Run(). Later runs write into the same buffer as long as the output keeps
+   * its shape, and allocate a new one when it changes.
    *
    * @param device Device to allocate the output on. Default is CPU.
    */
   common::Status BindOutput(const std::string& name, OrtDevice device = {});
 
+  using OutputShapeChangedCallback = std::function<void(const std::string& output_name,
+                                                        const TensorShape& previous_shape,
+                                                        const TensorShape& new_shape)>;
+
+  /**
+   * Set a callback that is invoked after Run() for each output bound to a device that was reallocated because its
+   * shape changed. Pass an empty callback to remove it.
+   */
+  void SetOutputShapeChangedCallback(OutputShapeChangedCallback callback);
+
   /**
    * This simply collects the outputs obtained after calling Run() inside the @param outputs.
    */
@@ -106,12 +119,19 @@ class IOBinding {
   std::unordered_map<std::string, size_t> mapped_output_names_;
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
+  // whether the output was bound to a device rather than to a pre-allocated OrtValue
+  std::vector<bool> outputs_bound_to_device_;
+  OutputShapeChangedCallback output_shape_changed_callback_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
   // device info for all outputs. only used by InferenceSession if the output is not pre-allocated.
   const std::vector<OrtDevice>& GetOutputsDeviceInfo() const;
 
+  bool IsOutputBoundToDevice(size_t index) const { return outputs_bound_to_device_[index]; }
+
+  const OutputShapeChangedCallback& GetOutputShapeChangedCallback() const { return output_shape_changed_callback_; }
+
   // The implementation for the BindOutput() overloads
   common::Status BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device);
 };
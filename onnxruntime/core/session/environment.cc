@@ -137,6 +137,9 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int max_cached_chunk_size_bytes = -1;
+    int use_huge_pages = -1;
+    int prefault_memory = -1;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -154,10 +157,16 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      max_cached_chunk_size_bytes = arena_cfg->max_cached_chunk_size_bytes;
+      use_huge_pages = arena_cfg->use_huge_pages;
+      prefault_memory = arena_cfg->prefault_memory;
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
                             initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+    l_arena_cfg.max_cached_chunk_size_bytes = max_cached_chunk_size_bytes;
+    l_arena_cfg.use_huge_pages = use_huge_pages;
+    l_arena_cfg.prefault_memory = prefault_memory;
     AllocatorCreationInfo alloc_creation_info{
         [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
         0,
@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -12,8 +13,11 @@
 #include <queue>
 
 #include "core/common/denormal.h"
+#include "core/common/generation_tokens_callback.h"
 #include "core/common/logging/logging.h"
+#include "core/common/native_tracing.h"
 #include "core/common/parse_string.h"
+#include "core/common/run_stats.h"
 #include "core/common/path_string.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/ort_format_version.h"
@@ -438,6 +442,9 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.adaptive_spinning =
+            allow_intra_op_spinning &&
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveSpinning, "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -448,9 +455,14 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        std::string numa_node_str;
+        if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadNumaNode, numa_node_str)) {
+          ORT_ENFORCE(TryParseStringWithClassicLocale(numa_node_str, to.numa_node) && to.numa_node >= 0,
+                      "Invalid NUMA node: ", numa_node_str);
+        }
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
-                               to.affinity_str.empty();
+                               to.affinity_str.empty() && to.numa_node < 0;
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for intra op thread pool");
@@ -460,12 +472,18 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
             concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
       }
     }
-    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    const bool run_async_on_inter_op_pool =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigRunAsyncOnInterOpThreadPool,
+                                                           "0") == "1";
+    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL || run_async_on_inter_op_pool) {
       if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
             session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
         OrtThreadPoolParams to = session_options_.inter_op_param;
-        to.auto_set_affinity = to.thread_pool_size == 0 && session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+        // threads that only run RunAsync requests are not pinned to the cores of the intra-op threads
+        to.auto_set_affinity = to.thread_pool_size == 0 &&
+                               session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
+                               !run_async_on_inter_op_pool;
         std::basic_stringstream<ORTCHAR_T> ss;
         if (to.name) {
           ss << to.name << ORT_TSTR("-");
@@ -487,7 +505,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         }
         inter_op_thread_pool_ =
             concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
-        if (inter_op_thread_pool_ == nullptr) {
+        if (inter_op_thread_pool_ == nullptr && session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
           LOGS(*session_logger_, INFO) << "Failed to create the inter-op thread pool for the parallel executor, setting ExecutionMode to SEQUENTIAL";
           session_options_.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
         }
@@ -500,9 +518,29 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
+
+    const std::string thread_quota_str =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsGlobalIntraOpThreadQuota, "0");
+    ORT_ENFORCE(TryParseStringWithClassicLocale(thread_quota_str, global_intra_op_thread_quota_) &&
+                    global_intra_op_thread_quota_ >= 0,
+                "Invalid global intra-op thread quota: ", thread_quota_str);
+    const std::string priority =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsGlobalThreadPoolPriority, "latency");
+    ORT_ENFORCE(priority == "latency" || priority == "batch",
+                "Invalid global thread pool priority: ", priority, ". Expected \"latency\" or \"batch\".");
+    global_thread_pool_batch_priority_ = priority == "batch";
   }
 
   session_profiler_.Initialize(session_logger_);
+  session_profiler_.EnableHardwareCounters(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfileHardwareCounters, "0") == "1");
+  session_profiler_.EnableMemoryTrace(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfileMemory, "0") == "1");
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsNativeTracing, "0") == "1" &&
+      !profiling::NativeTracing::Enable()) {
+    LOGS(*session_logger_, WARNING) << "Native tracing is not available, the trace_marker of tracefs could not be "
+                                       "opened for writing.";
+  }
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -637,6 +675,13 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // stop the background shrinkage first, so that it does not use the arenas while they are being destroyed
+  arena_shrink_registrations_.clear();
+
+  if (registered_with_mapped_weight_pager_) {
+    environment_.GetMappedWeightPager().Unregister(this);
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -656,6 +701,12 @@ InferenceSession::~InferenceSession() {
     }
   }
 
+  if (session_state_ && session_state_->GetEnableMemoryPattern() && session_state_->UseMemoryPatternShapeBuckets()) {
+    const auto stats = session_state_->GetMemoryPatternCacheStats();
+    LOGS(*session_logger_, INFO) << "Shape bucket memory pattern cache hits: " << stats.hits
+                                 << ", misses: " << stats.misses;
+  }
+
   // Unregister the session
 #ifdef _WIN32
   std::lock_guard<OrtMutex> lock(active_sessions_mutex_);
@@ -915,9 +966,11 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    ModelOptions model_options(true, strict_shape_type_inference);
+    model_options.lazy_initializer_data = session_options_.config_options.GetConfigOrDefault(
+                                              kOrtSessionOptionsConfigLazyLoadInitializers, "0") == "1";
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                    *session_logger_,
-                                    ModelOptions(true, strict_shape_type_inference));
+                                    *session_logger_, model_options);
   };
 
   common::Status st = LoadWithLoader(loader, "model_loading_uri");
@@ -1254,7 +1307,10 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
     const std::string probe_config =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerProbeConfig, "0:0");
 
-    MemoryOptimizer mem_transformer{memory_optimizer_config, probe_config};
+    const std::string memory_budget_config =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerBudget, "");
+
+    MemoryOptimizer mem_transformer{memory_optimizer_config, probe_config, memory_budget_config};
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(mem_transformer, *session_logger_, graph));
   }
 #endif
@@ -1285,10 +1341,29 @@ static Status LoadOrtModelBytes(const PathString& model_uri,
   return Status::OK();
 }
 
+static Status MapOrtModelBytes(const PathString& model_uri,
+                               gsl::span<const uint8_t>& bytes,
+                               Env::MappedMemoryPtr& mapped_memory) {
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_uri.c_str(), num_bytes));
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_memory));
+
+  bytes = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_memory.get()), num_bytes);
+
+  return Status::OK();
+}
+
 Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
+        const auto& config_options = GetSessionOptions().config_options;
+        if (config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMapInitializersFromFile, "0") == "1") {
+          ORT_RETURN_IF_ERROR(
+              MapOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_mapped_memory_));
+          return Status::OK();
+        }
+
         ORT_RETURN_IF_ERROR(
             LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
         return Status::OK();
@@ -1398,11 +1473,13 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
   // will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
+  // the same applies when the model file is mapped into memory, as the mapping is kept for the session lifetime.
   const auto& config_options = session_options_.config_options;
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
           ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          (ort_format_model_mapped_memory_ != nullptr ||
+           config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1");
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1558,6 +1635,64 @@ Status ApplyOrtFormatModelRuntimeOptimizations(
   return Status::OK();
 }
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+
+void CollectSubgraphInitializerNames(const Graph& graph, InlinedHashSet<std::string>& names) {
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& entry : node.GetAttributeNameToSubgraphMap()) {
+      for (const auto& initializer : entry.second->GetAllInitializedTensors()) {
+        names.insert(initializer.first);
+      }
+      CollectSubgraphInitializerNames(*entry.second, names);
+    }
+  }
+}
+
+// Gets the initializers of the main graph that are only used by nodes of the CPU EP from the cache of the
+// environment, which shares them by content with the other sessions.
+Status GetInitializersSharedAcrossSessions(const Graph& graph, const PathString& model_location,
+                                           const SessionOptions& session_options, SharedInitializerCache& cache,
+                                           InlinedHashMap<std::string, OrtValue>& shared_initializers,
+                                           const logging::Logger& logger) {
+  // The initializers to share are looked up by name when the subgraphs are finalized as well, so names that a
+  // subgraph uses for its own initializers are not shared.
+  InlinedHashSet<std::string> subgraph_initializer_names;
+  CollectSubgraphInitializerNames(graph, subgraph_initializer_names);
+
+  size_t num_reused = 0;
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    if (session_options.initializers_to_share_map.count(name) != 0 ||
+        subgraph_initializer_names.count(name) != 0 ||
+        utils::HasExternalData(*tensor_proto) ||
+        tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      continue;
+    }
+#if !defined(DISABLE_SPARSE_TENSORS)
+    if (graph.IsSparseInitializer(name)) {
+      continue;
+    }
+#endif
+
+    // an initializer planned on another device is copied there by each session anyway
+    const auto consumers = graph.GetConsumerNodes(name);
+    const bool used_on_cpu_only =
+        !consumers.empty() && std::all_of(consumers.begin(), consumers.end(), [](const Node* node) {
+          return node->GetExecutionProviderType() == kCpuExecutionProvider;
+        });
+    if (!used_on_cpu_only) {
+      continue;
+    }
+
+    OrtValue value;
+    bool reused = false;
+    ORT_RETURN_IF_ERROR(cache.GetOrCreate(Env::Default(), model_location, *tensor_proto, value, reused));
+    num_reused += reused ? 1 : 0;
+    shared_initializers.emplace(name, std::move(value));
+  }
+
+  LOGS(logger, INFO) << "Sharing " << shared_initializers.size() << " initializers across sessions, "
+                     << num_reused << " of them with existing sessions.";
+  return Status::OK();
+}
 }  // namespace
 
 static void ResolveMemoryPatternFlags(SessionState& session_state) {
@@ -1641,6 +1776,15 @@ common::Status InferenceSession::Initialize() {
     session_activity_started_ = true;
 #endif
 
+    // the replicas of a session share its CPU initializers
+    const bool share_initializers_across_sessions =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShareInitializersAcrossSessions,
+                                                           "0") == "1" ||
+        !session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigReplicaDeviceIds, "").empty();
+    if (share_initializers_across_sessions && prepacked_weights_container_ == nullptr) {
+      prepacked_weights_container_ = &environment_.GetSharedPrepackedWeightsContainer();
+    }
+
     // now that we have all the execution providers, create the session state
     session_state_ = std::make_unique<SessionState>(
         model_->MainGraph(),
@@ -1660,6 +1804,28 @@ common::Status InferenceSession::Initialize() {
       session_state_->UpdateAllocatorsWithEnvAllocators(environment_.GetRegisteredSharedAllocators());
     }
 
+    // TunableOp of the CPU EP is configured with the session options, whether the EP was added implicitly or not.
+    // Tuning results in the model metadata enable it as well once they are loaded below.
+    if (auto* cpu_tuning_ctx = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetTuningContext();
+        cpu_tuning_ctx != nullptr) {
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTunableOp();
+      }
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTuning();
+      }
+      if (const auto max_tuning_duration_ms_str =
+              config_options.GetConfigEntry(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs);
+          max_tuning_duration_ms_str.has_value()) {
+        int max_tuning_duration_ms = 0;
+        ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(*max_tuning_duration_ms_str, max_tuning_duration_ms),
+                          "Invalid value for ", kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, ": ",
+                          *max_tuning_duration_ms_str);
+        cpu_tuning_ctx->SetMaxTuningDurationMs(max_tuning_duration_ms);
+      }
+    }
+
     for (auto& ep : execution_providers_) {
       auto tuning_ctx = ep->GetTuningContext();
       if (nullptr != tuning_ctx) {
@@ -1764,6 +1930,14 @@ common::Status InferenceSession::Initialize() {
       }
 #endif
 
+      // the MatMuls of the LoRA target weights are replaced before partitioning so that they are not fused
+      const std::string lora_target_weights =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLoraTargetWeights, "");
+      if (!lora_target_weights.empty()) {
+        lora_adapters_ = std::make_unique<LoraAdapters>();
+        ORT_RETURN_IF_ERROR_SESSIONID_(lora_adapters_->ApplyToGraph(graph, lora_target_weights, *session_logger_));
+      }
+
       // apply any transformations to the main graph and any subgraphs
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, saving_ort_format));
 
@@ -1925,6 +2099,23 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
+    // The shared initializers are treated like the ones added with AddInitializer while the session state is
+    // finalized, which keeps its own references to them.
+    InlinedHashMap<std::string, OrtValue> shared_initializers;
+    auto remove_shared_initializers = gsl::finally([this, &shared_initializers]() {
+      for (const auto& entry : shared_initializers) {
+        session_options_.initializers_to_share_map.erase(entry.first);
+      }
+    });
+    if (share_initializers_across_sessions) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(GetInitializersSharedAcrossSessions(
+          graph, model_location_, session_options_, environment_.GetSharedInitializerCache(), shared_initializers,
+          *session_logger_));
+      for (const auto& entry : shared_initializers) {
+        session_options_.initializers_to_share_map.emplace(entry.first, &entry.second);
+      }
+    }
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
@@ -1981,6 +2172,17 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(StartBackgroundArenaShrinkage());
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateRequestBatcher());
+    ORT_RETURN_IF_ERROR_SESSIONID_(RegisterWithMappedWeightPager());
+
+    const std::string streaming_states =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigStreamingStates, "");
+    if (!streaming_states.empty()) {
+      stream_states_ = std::make_unique<StreamStates>();
+      ORT_RETURN_IF_ERROR_SESSIONID_(stream_states_->Init(streaming_states, model_->MainGraph(), *session_state_));
+    }
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -2343,6 +2545,104 @@ Status InferenceSession::PartialRun(onnxruntime::RunOptions& run_options,
 
 namespace {
 // Concurrent runs counting and thread-pool spin control
+// The default graph annotation of a run, see kOrtRunOptionsConfigCudaGraphAnnotation.
+// A captured graph replays with the shapes it was captured with, so runs with different input shapes
+// can't share a graph. E.g. "1x128,1x128" for two inputs of shape [1, 128].
+std::string GetGraphAnnotationFromFeeds(gsl::span<const OrtValue> feeds) {
+  std::ostringstream annotation;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (i > 0) {
+      annotation << ",";
+    }
+    if (feeds[i].IsTensor()) {
+      const auto dims = feeds[i].Get<Tensor>().Shape().GetDims();
+      for (size_t j = 0; j < dims.size(); ++j) {
+        annotation << (j > 0 ? "x" : "") << dims[j];
+      }
+    }
+  }
+  return annotation.str();
+}
+
+// The buffers of the inputs and outputs of a run, for the EP to update the captured graph with.
+std::vector<GraphBuffer> GetGraphBuffers(gsl::span<const OrtValue> feeds, const std::vector<OrtValue>* p_fetches) {
+  std::vector<GraphBuffer> buffers;
+  auto add_buffer = [&buffers](const OrtValue& value) {
+    if (value.IsAllocated() && value.IsTensor()) {
+      const auto& tensor = value.Get<Tensor>();
+      buffers.push_back({tensor.DataRaw(), tensor.SizeInBytes()});
+    } else {
+      buffers.push_back({nullptr, 0});
+    }
+  };
+  for (const auto& feed : feeds) {
+    add_buffer(feed);
+  }
+  if (p_fetches != nullptr) {
+    for (const auto& fetch : *p_fetches) {
+      add_buffer(fetch);
+    }
+  }
+  return buffers;
+}
+
+// Number of runs in flight above the low and the normal run priority on the global thread pools of the process.
+std::atomic<int> global_thread_pool_runs_above_low_priority{0};
+std::atomic<int> global_thread_pool_runs_above_normal_priority{0};
+
+enum class RunPriority {
+  kLow,
+  kNormal,
+  kHigh,
+};
+
+bool TryParseRunPriority(const std::string& str, RunPriority& priority) {
+  if (str == "low") {
+    priority = RunPriority::kLow;
+  } else if (str == "normal") {
+    priority = RunPriority::kNormal;
+  } else if (str == "high") {
+    priority = RunPriority::kHigh;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Counts a run in the priorities it is above of while it is in flight, and makes its parallel work yield the
+// intra-op threads to the runs of a higher priority.
+class RunPriorityScope {
+ public:
+  RunPriorityScope(RunPriority priority, std::atomic<int>& runs_above_low, std::atomic<int>& runs_above_normal)
+      : runs_above_low_(priority > RunPriority::kLow ? &runs_above_low : nullptr),
+        runs_above_normal_(priority > RunPriority::kNormal ? &runs_above_normal : nullptr),
+        low_priority_scope_(priority == RunPriority::kLow      ? &runs_above_low
+                            : priority == RunPriority::kNormal ? &runs_above_normal
+                                                               : nullptr) {
+    if (runs_above_low_ != nullptr) {
+      runs_above_low_->fetch_add(1, std::memory_order_relaxed);
+    }
+    if (runs_above_normal_ != nullptr) {
+      runs_above_normal_->fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  ~RunPriorityScope() {
+    if (runs_above_low_ != nullptr) {
+      runs_above_low_->fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (runs_above_normal_ != nullptr) {
+      runs_above_normal_->fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::atomic<int>* runs_above_low_;
+  std::atomic<int>* runs_above_normal_;
+  concurrency::ThreadPool::LowPriorityScope low_priority_scope_;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunPriorityScope);
+};
+
 struct ThreadPoolSpinningSwitch {
   concurrency::ThreadPool* intra_tp_{nullptr};
   concurrency::ThreadPool* inter_tp_{nullptr};
@@ -2369,7 +2669,103 @@ struct ThreadPoolSpinningSwitch {
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
-                             const std::vector<OrtDevice>* p_fetches_device_info) {
+                             const std::vector<OrtDevice>* p_fetches_device_info,
+                             const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators) {
+  // The runs of a stream stay on this session, which holds the stream states
+  InferenceSession* replica = this;
+  if (!replicas_.empty() && run_options.config_options.configurations.count(kOrtRunOptionsConfigStreamId) == 0) {
+    replica = &SelectReplica();
+  }
+
+  return replica->RunOnThisReplica(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                   p_fetch_allocators);
+}
+
+InferenceSession& InferenceSession::SelectReplica() {
+  // Start the search at a rotating replica, so the idle replicas take turns
+  const size_t num_replicas = replicas_.size() + 1;
+  const size_t first = next_replica_.fetch_add(1, std::memory_order_relaxed) % num_replicas;
+
+  InferenceSession* selected = nullptr;
+  int selected_num_runs = std::numeric_limits<int>::max();
+  for (size_t i = 0; i < num_replicas; ++i) {
+    InferenceSession& replica = GetReplica((first + i) % num_replicas);
+    const int num_runs = replica.GetCurrentNumRuns();
+    if (num_runs < selected_num_runs) {
+      selected = &replica;
+      selected_num_runs = num_runs;
+    }
+  }
+
+  return *selected;
+}
+
+Status InferenceSession::AddReplica(std::unique_ptr<InferenceSession> replica) {
+  ORT_RETURN_IF_NOT(replica != nullptr, "The replica is null.");
+  ORT_RETURN_IF_NOT(is_inited_ && replica->is_inited_, "The session and its replica must be initialized.");
+  ORT_RETURN_IF_NOT(replica->replicas_.empty(), "A replica can't have replicas of its own.");
+  replicas_.push_back(std::move(replica));
+  return Status::OK();
+}
+
+InferenceSession& InferenceSession::GetReplica(size_t index) {
+  ORT_ENFORCE(index <= replicas_.size(), "Invalid replica index ", index, ". The session has ", replicas_.size(),
+              " replicas.");
+  return index == 0 ? *this : *replicas_[index - 1];
+}
+
+Status InferenceSession::RunOnThisReplica(const RunOptions& run_options,
+                                          gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                          gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                          const std::vector<OrtDevice>* p_fetches_device_info,
+                                          const std::unordered_map<size_t, IExecutor::CustomAllocator>*
+                                              p_fetch_allocators) {
+  // The runs of a stream are fed its states
+  const std::string& stream_id = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigStreamId, "");
+  if (!stream_id.empty()) {
+    return RunStream(run_options, stream_id, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                     p_fetch_allocators);
+  }
+
+  // Each graph annotation gets its own captured graph, annotate the run with the shapes of its inputs if the user
+  // didn't. The annotation is passed to the EPs with the run options.
+  std::string graph_annotation;
+  if (cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled() &&
+      !run_options.config_options.TryGetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation, graph_annotation)) {
+    RunOptions annotated_run_options = run_options;
+    ORT_RETURN_IF_ERROR_SESSIONID_(annotated_run_options.config_options.AddConfigEntry(
+        kOrtRunOptionsConfigCudaGraphAnnotation, GetGraphAnnotationFromFeeds(feeds).c_str()));
+    return RunOnThisReplica(annotated_run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                            p_fetch_allocators);
+  }
+
+  if (!run_options.only_execute_path_to_fetches &&
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigOnlyExecutePathToFetches, "0") == "1") {
+    RunOptions pruned_run_options = run_options;
+    pruned_run_options.only_execute_path_to_fetches = true;
+    return RunOnThisReplica(pruned_run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                            p_fetch_allocators);
+  }
+
+  // The tensors of the selected LoRA adapter are fed to the inputs of its updates
+  InlinedVector<std::string> lora_feed_names;
+  InlinedVector<OrtValue> lora_feeds;
+  const std::string& lora_adapter = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigLoraAdapter, "");
+  if (!lora_adapter.empty()) {
+    ORT_RETURN_IF_NOT(lora_adapters_, "The LoRA adapter ", lora_adapter,
+                      " is selected but the session has no LoRA target weights.");
+    lora_feed_names.assign(feed_names.begin(), feed_names.end());
+    lora_feeds.assign(feeds.begin(), feeds.end());
+    ORT_RETURN_IF_ERROR_SESSIONID_(lora_adapters_->AppendFeeds(lora_adapter, lora_feed_names, lora_feeds));
+    feed_names = lora_feed_names;
+    feeds = lora_feeds;
+  }
+
+  // Bring the weights of the session back in if they were paged out, paging out other sessions of the env instead
+  if (registered_with_mapped_weight_pager_) {
+    environment_.GetMappedWeightPager().Activate(this);
+  }
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2380,6 +2776,32 @@ Status InferenceSession::Run(const RunOptions& run_options,
   ortrun_activity.SetRelatedActivity(session_activity);
   TraceLoggingWriteStart(ortrun_activity, "OrtRun");
 #endif
+  profiling::NativeTraceSpan run_span("Run");
+
+  // the resources used by this run, for the run options that collect them
+  RunStats* run_stats = run_options.run_stats.get();
+  std::optional<RunStats::Scope> run_stats_scope;
+  const auto run_stats_begin_time = std::chrono::steady_clock::now();
+  if (run_stats != nullptr) {
+    run_stats->Reset();
+    run_stats_scope.emplace(run_stats, true);
+  }
+  auto record_run_wall_time = gsl::finally([run_stats, run_stats_begin_time]() {
+    if (run_stats != nullptr) {
+      run_stats->wall_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - run_stats_begin_time)
+                                    .count();
+    }
+  });
+
+  // the tokens the generation operators produce in this run, for the run options that stream them
+  const GenerationTokensCallback generation_tokens_callback{run_options.generation_tokens_callback,
+                                                            run_options.generation_tokens_callback_user_data};
+  std::optional<GenerationTokensCallback::Scope> generation_tokens_callback_scope;
+  if (generation_tokens_callback.fn != nullptr) {
+    generation_tokens_callback_scope.emplace(&generation_tokens_callback);
+  }
+
   Status retval = Status::OK();
   const Env& env = Env::Default();
 
@@ -2387,17 +2809,42 @@ Status InferenceSession::Run(const RunOptions& run_options,
   // session threads spinning as configured. Do nothing for graph replay except the counter.
   const bool control_spinning = use_per_session_threads_ &&
                                 force_spinning_stop_between_runs_ &&
-                                !cached_execution_provider_for_graph_replay_.IsGraphCaptured();
+                                !cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation);
   auto* intra_tp = (control_spinning) ? thread_pool_.get() : nullptr;
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
 
+  // Runs yield the intra-op threads to the runs of a higher priority on the same pool, which is shared across the
+  // process for the sessions using the global thread pools.
+  RunPriority run_priority = global_thread_pool_batch_priority_ ? RunPriority::kLow : RunPriority::kNormal;
+  std::string run_priority_str;
+  if (run_options.config_options.TryGetConfigEntry(kOrtRunOptionsConfigPriority, run_priority_str) &&
+      !TryParseRunPriority(run_priority_str, run_priority)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid run priority: ", run_priority_str,
+                           ". Expected \"low\", \"normal\" or \"high\".");
+  }
+  RunPriorityScope run_priority_scope(
+      run_priority,
+      use_per_session_threads_ ? runs_above_low_priority_ : global_thread_pool_runs_above_low_priority,
+      use_per_session_threads_ ? runs_above_normal_priority_ : global_thread_pool_runs_above_normal_priority);
+
+  // Runs on the global intra-op thread pool are limited to the thread quota of the session.
+  std::optional<concurrency::ThreadPool::DegreeOfParallelismLimit> global_thread_pool_limit;
+  if (!use_per_session_threads_ && global_intra_op_thread_quota_ > 0) {
+    global_thread_pool_limit.emplace(global_intra_op_thread_quota_);
+  }
+
   // Check if this Run() is simply going to be a CUDA Graph replay.
-  if (cached_execution_provider_for_graph_replay_.IsGraphCaptured()) {
+  const bool is_graph_captured = cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation);
+  if (is_graph_captured) {
     LOGS(*session_logger_, INFO) << "Replaying the captured "
                                  << cached_execution_provider_for_graph_replay_.Type()
-                                 << " CUDA Graph for this model with tag: " << run_options.run_tag;
-    ORT_RETURN_IF_ERROR_SESSIONID_(cached_execution_provider_for_graph_replay_.ReplayGraph());
+                                 << " CUDA Graph for this model with tag: " << run_options.run_tag
+                                 << " and graph annotation: " << graph_annotation;
+    // The inputs and outputs may be bound to other buffers than the ones the graph was captured with.
+    ORT_RETURN_IF_ERROR_SESSIONID_(cached_execution_provider_for_graph_replay_.UpdateGraphBuffers(
+        graph_annotation, GetGraphBuffers(feeds, p_fetches)));
+    ORT_RETURN_IF_ERROR_SESSIONID_(cached_execution_provider_for_graph_replay_.ReplayGraph(graph_annotation));
   } else {
     InlinedVector<IExecutionProvider*> exec_providers_to_stop;
     exec_providers_to_stop.reserve(execution_providers_.NumProviders());
@@ -2466,14 +2913,9 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_CHECK_AND_SET_RETVAL(start_func());
       }
 
-#ifdef ENABLE_TRAINING
       if (run_options.only_execute_path_to_fetches) {
-        // TODO: this method is not thread safe, if multiple Run happened in parallel we might hit race condition issue.
-        // currently it only used in training, there is no parallel run execution in training so it is ok.
-        // but it is better we can fix it with a better solution.
         session_state_->UpdateToBeExecutedRange(feeds_fetches_manager.GetFeedsFetchesInfo().fetches_mlvalue_idxs);
       }
-#endif
 
       // execute the graph
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
@@ -2481,7 +2923,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #endif
 
 #ifdef ORT_ENABLE_STREAM
-      DeviceStreamCollectionHolder device_stream_collection_holder(session_state_.get());
+      // The streams of the EP capturing the graphs may be bound to the thread running the session, e.g. with
+      // enable_cuda_graph_per_thread of the CUDA EP, so they aren't shared with the runs of other threads.
+      DeviceStreamCollectionHolder device_stream_collection_holder(
+          session_state_.get(), !cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled());
 #endif
 
       if (retval.IsOK()) {
@@ -2491,7 +2936,9 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #ifdef ORT_ENABLE_STREAM
                                      device_stream_collection_holder,
 #endif
-                                     run_logger);
+                                     run_logger,
+                                     p_fetch_allocators ? *p_fetch_allocators
+                                                        : std::unordered_map<size_t, IExecutor::CustomAllocator>{});
       }
 
       // info all execution providers InferenceSession:Run ended
@@ -2552,6 +2999,13 @@ Status InferenceSession::Run(const RunOptions& run_options,
   TraceLoggingWriteStop(ortrun_activity, "OrtRun");
 #endif
 
+  // Record the buffers the graph was captured with, the replays are updated to the buffers of their run.
+  if (retval.IsOK() && !is_graph_captured &&
+      cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation)) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(cached_execution_provider_for_graph_replay_.UpdateGraphBuffers(
+        graph_annotation, GetGraphBuffers(feeds, p_fetches)));
+  }
+
   // As N+1 inference runs (N for memory allocation and 1 for graph capturing)
   // are needed before replaying the captured graph, here run N inference runs recursively until graph captured,
   // so that users just need one session run to capture the graph.
@@ -2559,7 +3013,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
   // N is defined in min_num_runs_before_hip_graph_capture_ for ROCM EP,
   // and the value could be different for other EP.
   if (retval.IsOK() && cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled() &&
-      !cached_execution_provider_for_graph_replay_.IsGraphCaptured()) {
+      !cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation)) {
     LOGS(*session_logger_, INFO) << "Start another run for necessary memory allocation or graph capture.";
     ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
   }
@@ -2612,7 +3066,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
   }
 
   Status status;
-  status = Run(run_options, feed_name_vec, feed_vec, fetch_name_vec, &fetch_vec, nullptr);
+  // the runs of a stream depend on each other and are not batched
+  if (request_batcher_ && run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigStreamId, "").empty()) {
+    status = request_batcher_->Run(run_options, feed_name_vec, feed_vec, fetch_name_vec, fetch_vec);
+  } else {
+    status = Run(run_options, feed_name_vec, feed_vec, fetch_name_vec, &fetch_vec, nullptr);
+  }
 
   if (!status.IsOK())
     return status;
@@ -2645,7 +3104,13 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           RunAsyncCallbackFn callback,
                                           void* user_data) {
   size_t num_fetches = fetch_names.size();
-  auto* tp = GetIntraOpThreadPoolToUse();
+  // In sequential mode the inter-op pool does not execute any part of a run, so the request can occupy one of its
+  // threads without competing with the kernels for the intra-op threads. In parallel mode the streams of the run
+  // are scheduled on the inter-op pool and waited for, which could starve it.
+  auto* tp = session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL ? GetInterOpThreadPoolToUse() : nullptr;
+  if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
+    tp = GetIntraOpThreadPoolToUse();
+  }
   if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
   }
@@ -2695,6 +3160,24 @@ common::Status InferenceSession::Run(const RunOptions& run_options, const NameML
   return Run(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
 }
 
+common::Status InferenceSession::RunMany(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                         gsl::span<const std::vector<OrtValue>> feeds,
+                                         gsl::span<const std::string> output_names,
+                                         gsl::span<std::vector<OrtValue>> fetches) {
+  ORT_RETURN_IF_NOT(feeds.size() == fetches.size(), "The number of requests (", feeds.size(),
+                    ") does not match the number of fetches (", fetches.size(), ").");
+
+  if (request_batcher_) {
+    return request_batcher_->RunMany(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds[i], output_names, &fetches[i], nullptr));
+  }
+
+  return Status::OK();
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -2761,8 +3244,55 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+  auto& outputs = io_binding.GetOutputs();
+
+  // Outputs bound to a device hold the buffers of the previous run. Passing them as pre-allocated fetches would
+  // require the shapes to stay the same, so they are handed out by custom allocators instead, which only reuse a
+  // buffer when the shape and the device match the ones the graph allocates the output with.
+  std::vector<OrtValue> previous_outputs(outputs.size());
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  for (size_t i = 0, end = outputs.size(); i < end; ++i) {
+    if (!io_binding.IsOutputBoundToDevice(i) || !outputs[i].IsTensor()) {
+      continue;
+    }
+
+    previous_outputs[i] = outputs[i];
+    outputs[i] = OrtValue();
+    fetch_allocators.emplace(i, [&previous = previous_outputs[i]](const TensorShape& shape, const OrtDevice& location,
+                                                                  OrtValue& ort_value, bool& allocated) {
+      const auto& tensor = previous.Get<Tensor>();
+      if (tensor.Shape() == shape && tensor.Location().device == location) {
+        ort_value = previous;
+        allocated = true;
+      }
+      return Status::OK();
+    });
+  }
+
+  // the bound buffers belong to the devices of this session, so the run is not dispatched to a replica
+  auto status = RunOnThisReplica(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
+                                 io_binding.GetOutputNames(), &outputs, &io_binding.GetOutputsDeviceInfo(),
+                                 fetch_allocators.empty() ? nullptr : &fetch_allocators);
+
+  const auto& shape_changed_callback = io_binding.GetOutputShapeChangedCallback();
+  for (const auto& entry : fetch_allocators) {
+    const size_t i = entry.first;
+    if (!outputs[i].IsAllocated()) {
+      // keep the buffer for the next run if this one failed
+      outputs[i] = std::move(previous_outputs[i]);
+      continue;
+    }
+
+    if (shape_changed_callback && outputs[i].IsTensor()) {
+      const auto& previous_shape = previous_outputs[i].Get<Tensor>().Shape();
+      const auto& new_shape = outputs[i].Get<Tensor>().Shape();
+      if (previous_shape != new_shape) {
+        shape_changed_callback(io_binding.GetOutputNames()[i], previous_shape, new_shape);
+      }
+    }
+  }
+
+  return status;
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -2770,6 +3300,74 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunStream(
+    const RunOptions& run_options, const std::string& stream_id,
+    gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+    gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+    const std::vector<OrtDevice>* p_fetches_device_info,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators) {
+  ORT_RETURN_IF_NOT(stream_states_, "The stream ", stream_id, " is selected but the session has no streaming states.");
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+  if (run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigStreamReset, "0") == "1") {
+    stream_states_->Reset(stream_id);
+  }
+
+  InlinedVector<std::string> stream_feed_names(feed_names.begin(), feed_names.end());
+  InlinedVector<OrtValue> stream_feeds(feeds.begin(), feeds.end());
+  InlinedVector<std::string> stream_output_names(output_names.begin(), output_names.end());
+  std::vector<OrtValue> stream_fetches = *p_fetches;
+  std::vector<OrtDevice> stream_fetch_devices = p_fetches_device_info != nullptr
+                                                    ? *p_fetches_device_info
+                                                    : std::vector<OrtDevice>(output_names.size());
+  stream_fetch_devices.resize(output_names.size());
+  stream_states_->AppendFeedsAndFetches(stream_id, stream_feed_names, stream_feeds, stream_output_names,
+                                        stream_fetches, stream_fetch_devices);
+
+  // the run itself is not part of the stream again
+  RunOptions stream_run_options = run_options;
+  stream_run_options.config_options.configurations.erase(kOrtRunOptionsConfigStreamId);
+  ORT_RETURN_IF_ERROR_SESSIONID_(RunOnThisReplica(stream_run_options, stream_feed_names, stream_feeds,
+                                                  stream_output_names, &stream_fetches, &stream_fetch_devices,
+                                                  p_fetch_allocators));
+
+  if (run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigStreamEnd, "0") == "1") {
+    stream_states_->Reset(stream_id);
+  } else {
+    stream_states_->Update(stream_id, stream_output_names, stream_fetches);
+  }
+
+  stream_fetches.resize(output_names.size());
+  *p_fetches = std::move(stream_fetches);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ResetStreamStates(const std::string& stream_id) {
+  if (!stream_states_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no streaming states, set them with ",
+                           kOrtSessionOptionsConfigStreamingStates);
+  }
+  stream_states_->Reset(stream_id);
+  return Status::OK();
+}
+
+common::Status InferenceSession::AddLoraAdapter(const std::string& name, const LoraAdapter& adapter) {
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "LoRA adapters can only be added to an initialized session.");
+  }
+  if (!lora_adapters_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no LoRA target weights, set them with ",
+                           kOrtSessionOptionsConfigLoraTargetWeights);
+  }
+  return lora_adapters_->Add(name, adapter);
+}
+
+common::Status InferenceSession::RemoveLoraAdapter(const std::string& name) {
+  if (!lora_adapters_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The session has no LoRA target weights.");
+  }
+  return lora_adapters_->Remove(name);
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -2794,6 +3392,12 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      const auto* cost_calibration = session_state_ ? session_state_->GetThreadPoolCostCalibration() : nullptr;
+      if (cost_calibration != nullptr) {
+        session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "intra_op_cost_calibration",
+                                                session_profiler_.Start(),
+                                                {{"call_sites", cost_calibration->ToJson()}});
+      }
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -2808,6 +3412,44 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+common::Status InferenceSession::GetKernelLatencyMetrics(std::string& json) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  const KernelLatencyMetrics* metrics = session_state_->GetKernelLatencyMetrics();
+  ORT_RETURN_IF(metrics == nullptr, "Kernel latency sampling is disabled. Set the session config entry ",
+                kOrtSessionOptionsConfigKernelLatencySamplingInterval, " to enable it.");
+
+  std::vector<KernelLatency> kernel_latencies;
+  session_state_->GetKernelLatencies(kernel_latencies);
+  json = KernelLatenciesToJson(kernel_latencies, metrics->SamplingInterval());
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetCalibrationTable(std::string& json) const {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  const CalibrationCollector* collector = session_state_->GetCalibrationCollector();
+  ORT_RETURN_IF(collector == nullptr, "Calibration is disabled. Set the session config entry ",
+                kOrtSessionOptionsCalibrationTensors, " to enable it.");
+
+  std::vector<CalibrationStatistics> statistics;
+  session_state_->GetCalibrationStatistics(statistics);
+  json = CalibrationTableToJson(statistics, collector->Method(), collector->Percentile());
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
@@ -2934,6 +3576,105 @@ void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_t
   }
 }
 
+Status InferenceSession::StartBackgroundArenaShrinkage() {
+  const auto& config_options = session_options_.config_options;
+  int64_t check_interval_ms = 0;
+  const std::string check_interval_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigArenaShrinkCheckIntervalMs, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(check_interval_str, check_interval_ms) && check_interval_ms >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigArenaShrinkCheckIntervalMs, ": ", check_interval_str);
+  if (check_interval_ms == 0) {
+    return Status::OK();
+  }
+
+  int64_t unused_time_ms = 0;
+  const std::string unused_time_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigArenaShrinkUnusedTimeMs, "10000");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(unused_time_str, unused_time_ms) && unused_time_ms >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigArenaShrinkUnusedTimeMs, ": ", unused_time_str);
+
+  size_t high_water_mark_bytes = 0;
+  const std::string high_water_mark_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigArenaShrinkHighWaterMarkBytes, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(high_water_mark_str, high_water_mark_bytes),
+                    "Invalid value for ", kOrtSessionOptionsConfigArenaShrinkHighWaterMarkBytes, ": ",
+                    high_water_mark_str);
+
+  ArenaShrinkPolicy policy;
+  policy.check_interval = std::chrono::milliseconds(check_interval_ms);
+  policy.min_unused_time = std::chrono::milliseconds(unused_time_ms);
+  policy.high_water_mark_bytes = high_water_mark_bytes;
+
+  for (const auto& entry : session_state_->GetAllocators()) {
+    const AllocatorPtr& alloc = entry.second;
+    if (alloc->Info().alloc_type == OrtAllocatorType::OrtArenaAllocator) {
+      arena_shrink_registrations_.push_back(BackgroundArenaShrinker::Instance().Register(alloc, policy));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status InferenceSession::RegisterWithMappedWeightPager() {
+  size_t budget = 0;
+  const std::string budget_str =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(budget_str, budget),
+                    "Invalid value for ", kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes, ": ", budget_str);
+  if (budget == 0) {
+    return Status::OK();
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  const auto mapped_weights = model_->MappedModelData();
+  if (mapped_weights.empty()) {
+    LOGS(*session_logger_, WARNING) << kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes
+                                    << " is set but the model is not memory mapped. Set "
+                                    << kOrtSessionOptionsConfigLazyLoadInitializers
+                                    << " to load its initializers lazily from the file.";
+    return Status::OK();
+  }
+
+  auto& pager = environment_.GetMappedWeightPager();
+  pager.SetMemoryBudget(budget);
+  pager.Register(Env::Default(), this, mapped_weights);
+  registered_with_mapped_weight_pager_ = true;
+#endif
+
+  return Status::OK();
+}
+
+Status InferenceSession::CreateRequestBatcher() {
+  const auto& config_options = session_options_.config_options;
+  size_t max_batch_size = 0;
+  const std::string max_batch_size_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_batch_size_str, max_batch_size) && max_batch_size != 1,
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, ": ",
+                    max_batch_size_str);
+  if (max_batch_size == 0) {
+    return Status::OK();
+  }
+
+  int64_t timeout_us = 0;
+  const std::string timeout_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingTimeoutUs, "1000");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(timeout_str, timeout_us) && timeout_us >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingTimeoutUs, ": ", timeout_str);
+
+  auto allocator = session_state_->GetAllocator(OrtDevice());
+  ORT_RETURN_IF_NOT(allocator, "Dynamic batching requires a CPU allocator.");
+  request_batcher_ = std::make_unique<RequestBatcher>(
+      max_batch_size, std::chrono::microseconds(timeout_us), std::move(allocator),
+      [this](const RunOptions& run_options, gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+        return Run(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+      });
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled with a maximum batch size of " << max_batch_size
+                               << " and a timeout of " << timeout_us << "us";
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
@@ -14,6 +14,7 @@
 #include "core/common/path_string.h"
 #include "core/common/profiler.h"
 #include "core/common/status.h"
+#include "core/framework/background_arena_shrinker.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
@@ -27,7 +28,11 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
+#include "core/session/lora_adapters.h"
+#include "core/session/stream_states.h"
+#include "core/session/request_batcher.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -323,10 +328,28 @@ class InferenceSession {
    */
   [[nodiscard]] common::Status Initialize();
 
+  /**
+   * @param p_fetches_device_info devices to allocate the fetches that are not pre-allocated on.
+   * @param p_fetch_allocators custom allocators for the fetches that are not pre-allocated, by fetch index.
+   */
   [[nodiscard]] common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
                                    gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches,
-                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr);
+                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr,
+                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators =
+                                       nullptr);
+
+  /**
+   * Runs several requests that use the same inputs and outputs with a single call.
+   * With dynamic batching enabled, the compatible requests are merged into batches right away instead of waiting
+   * for concurrent Run calls. Otherwise the requests run one after another.
+   * @param feeds the inputs of each request, in the order of feed_names.
+   * @param fetches the outputs of each request, in the order of output_names.
+   */
+  [[nodiscard]] common::Status RunMany(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const std::vector<OrtValue>> feeds,
+                                       gsl::span<const std::string> output_names,
+                                       gsl::span<std::vector<OrtValue>> fetches);
 
   [[nodiscard]] common::Status Run(const RunOptions& run_options,
                                    gsl::span<const char* const> feed_names,
@@ -374,6 +397,27 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Registers the LoRA adapter `name`, replacing an adapter with the same name. A run applies it when its run options
+   * set kOrtRunOptionsConfigLoraAdapter to `name`.
+   * The session must be initialized and have LoRA target weights, see kOrtSessionOptionsConfigLoraTargetWeights.
+   * This API is thread-safe, runs in progress keep using the adapter they started with.
+   */
+  [[nodiscard]] common::Status AddLoraAdapter(const std::string& name, const LoraAdapter& adapter);
+
+  /**
+   * Removes the LoRA adapter `name` registered with AddLoraAdapter.
+   * This API is thread-safe.
+   */
+  [[nodiscard]] common::Status RemoveLoraAdapter(const std::string& name);
+
+  /**
+   * Releases the states of stream `stream_id`, its next run starts from the initial states.
+   * The session must have streaming states, see kOrtSessionOptionsConfigStreamingStates.
+   * This API is thread-safe, but must not be called while a run of the stream is in progress.
+   */
+  [[nodiscard]] common::Status ResetStreamStates(const std::string& stream_id);
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -432,6 +476,22 @@ class InferenceSession {
    */
   int GetCurrentNumRuns() const;
 
+  /**
+   * Adds a replica of this session, e.g. the same model initialized with the execution providers of another device.
+   * Both must be initialized. Run calls are then dispatched to the least loaded of this session and its replicas,
+   * except for the runs of a stream and the runs with an IOBinding, which stay on the session that owns the stream
+   * states or created the binding.
+   * Not thread-safe with Run.
+   */
+  [[nodiscard]] common::Status AddReplica(std::unique_ptr<InferenceSession> replica);
+
+  // Returns the number of replicas added with AddReplica.
+  size_t NumReplicas() const { return replicas_.size(); }
+
+  // Returns the replica `index`, where 0 is this session and 1 to NumReplicas() are the added replicas.
+  // Use it to create IOBindings for the devices of a replica.
+  InferenceSession& GetReplica(size_t index);
+
   /**
    * Get the names of registered Execution Providers. The returned vector is ordered by Execution Provider
    * priority. The first provider in the vector has the highest priority.
@@ -480,6 +540,22 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+   * Get the sampled kernel latencies of the main graph and all subgraphs as JSON, with histograms per kernel and
+   * per op type. Requires kOrtSessionOptionsConfigKernelLatencySamplingInterval to be set.
+   * @param json receives the latency metrics.
+   * @return OK if success.
+   */
+  common::Status GetKernelLatencyMetrics(std::string& json) const;
+
+  /**
+   * Get the calibration table of the tensors observed in the main graph and all subgraphs as JSON, with their ranges
+   * and uint8 quantization parameters. Requires kOrtSessionOptionsCalibrationTensors to be set.
+   * @param json receives the calibration table.
+   * @return OK if success.
+   */
+  common::Status GetCalibrationTable(std::string& json) const;
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -596,6 +672,10 @@ class InferenceSession {
   // The file path of where the model was loaded. e.g. /tmp/test_squeezenet/model.onnx
   PathString model_location_;
 
+  // Read-only mapping of an ORT format model file when "session.map_initializers_from_file" is set.
+  // Initializers refer to it, so it is declared before session_state_ to outlive the OrtValues.
+  Env::MappedMemoryPtr ort_format_model_mapped_memory_;
+
   // The list of execution providers.
   ExecutionProviders execution_providers_;
 
@@ -685,6 +765,46 @@ class InferenceSession {
    */
   void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink);
 
+  /*
+   * Registers the arenas of the session with the background arena shrinker if
+   * kOrtSessionOptionsConfigArenaShrinkCheckIntervalMs is set.
+   */
+  [[nodiscard]] common::Status StartBackgroundArenaShrinkage();
+
+  /*
+   * Creates the batcher of concurrent Run calls if kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize is set.
+   */
+  [[nodiscard]] common::Status CreateRequestBatcher();
+
+  // Run() without dispatching to a replica.
+  [[nodiscard]] common::Status RunOnThisReplica(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                                gsl::span<const OrtValue> feeds,
+                                                gsl::span<const std::string> output_names,
+                                                std::vector<OrtValue>* p_fetches,
+                                                const std::vector<OrtDevice>* p_fetches_device_info,
+                                                const std::unordered_map<size_t, IExecutor::CustomAllocator>*
+                                                    p_fetch_allocators);
+
+  // Returns the replica with the fewest runs in progress.
+  InferenceSession& SelectReplica();
+
+  /*
+   * Registers the memory mapped weights of the session with the pager of the env if
+   * kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes is set.
+   */
+  [[nodiscard]] common::Status RegisterWithMappedWeightPager();
+
+  /*
+   * Runs a chunk of stream `stream_id`: feeds the states of the stream, fetches the state outputs along with
+   * `output_names` and keeps them for the next run of the stream.
+   */
+  [[nodiscard]] common::Status RunStream(
+      const RunOptions& run_options, const std::string& stream_id,
+      gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+      gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+      const std::vector<OrtDevice>* p_fetches_device_info,
+      const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators);
+
 #ifdef _WIN32
   void LogAllSessions();
 #endif
@@ -748,6 +868,11 @@ class InferenceSession {
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
   onnxruntime::concurrency::ThreadPool* inter_op_thread_pool_from_env_{};
+  // Maximum number of threads of the global intra-op thread pool used by each run, 0 for no limit.
+  int global_intra_op_thread_quota_ = 0;
+  // Whether runs default to the low run priority, yielding the global intra-op thread pool to the runs of
+  // latency-critical sessions.
+  bool global_thread_pool_batch_priority_ = false;
 
   // External threadpools.
   onnxruntime::concurrency::ThreadPool* external_intra_op_thread_pool_{};
@@ -782,6 +907,10 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_ = 0;
 
+  // Number of runs in flight above the low and the normal run priority, when the session uses its own thread pools.
+  std::atomic<int> runs_above_low_priority_ = 0;
+  std::atomic<int> runs_above_normal_priority_ = 0;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
@@ -867,18 +996,24 @@ class InferenceSession {
       return cached_execution_provider_for_graph_replay_ != nullptr && cached_execution_provider_for_graph_replay_->IsGraphCaptureEnabled();
     }
 
-    bool IsGraphCaptured() const {
-      return cached_execution_provider_for_graph_replay_ != nullptr && cached_execution_provider_for_graph_replay_->IsGraphCaptured();
+    bool IsGraphCaptured(const std::string& graph_annotation) const {
+      return cached_execution_provider_for_graph_replay_ != nullptr &&
+             cached_execution_provider_for_graph_replay_->IsGraphCaptured(graph_annotation);
     }
 
-    Status ReplayGraph() {
-      ORT_ENFORCE(IsGraphCaptured());
+    Status ReplayGraph(const std::string& graph_annotation) {
+      ORT_ENFORCE(IsGraphCaptured(graph_annotation));
       if (cached_execution_provider_for_graph_replay_) {
-        return cached_execution_provider_for_graph_replay_->ReplayGraph();
+        return cached_execution_provider_for_graph_replay_->ReplayGraph(graph_annotation);
       }
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached EP instance for graph replay is not set yet before calling ReplayGraph()");
     }
 
+    Status UpdateGraphBuffers(const std::string& graph_annotation, const std::vector<GraphBuffer>& buffers) {
+      ORT_ENFORCE(IsGraphCaptured(graph_annotation));
+      return cached_execution_provider_for_graph_replay_->UpdateGraphBuffers(graph_annotation, buffers);
+    }
+
     const std::string& Type() const {
       return cached_execution_provider_for_graph_replay_->Type();
     }
@@ -887,6 +1022,26 @@ class InferenceSession {
   };
 
   CachedExecutionProviderForGraphReplay cached_execution_provider_for_graph_replay_;
+
+  // Registrations of the session arenas with the background arena shrinker.
+  std::vector<std::unique_ptr<BackgroundArenaShrinker::Registration>> arena_shrink_registrations_;
+
+  // The replicas added with AddReplica, which Run calls are dispatched to along with this session.
+  std::vector<std::unique_ptr<InferenceSession>> replicas_;
+  // Where SelectReplica starts its search.
+  std::atomic<size_t> next_replica_{0};
+
+  // Whether the mapped weights of the session are registered with the pager of the env.
+  bool registered_with_mapped_weight_pager_ = false;
+
+  // Merges concurrent Run calls into batches. Only set when dynamic batching is enabled.
+  std::unique_ptr<RequestBatcher> request_batcher_;
+
+  // The LoRA adapters of the session. Only set when the session has LoRA target weights.
+  std::unique_ptr<LoraAdapters> lora_adapters_;
+
+  // The states carried across the runs of each stream. Only set when the session has streaming states.
+  std::unique_ptr<StreamStates> stream_states_;
 };
 
 struct SessionIOBinding {
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/lora_adapters.h"
+
+#include <algorithm>
+
+#include "core/common/string_utils.h"
+#include "core/framework/tensor.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph.h"
+#include "core/graph/graph_utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+#if !defined(ORT_MINIMAL_BUILD)
+// Adds the overridable initializer `name` holding an update matrix of rank 0, i.e. no update. The rank is symbolic in
+// the graph input so that updates of any rank can be fed.
+NodeArg& AddEmptyUpdateInput(Graph& graph, const std::string& name, int64_t rows, int64_t cols) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+  ONNX_NAMESPACE::TypeProto type_proto;
+  type_proto.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* shape = type_proto.mutable_tensor_type()->mutable_shape();
+  for (int64_t dim : {rows, cols}) {
+    if (dim == 0) {
+      shape->add_dim()->set_dim_param(name + "_rank");
+    } else {
+      shape->add_dim()->set_dim_value(dim);
+    }
+    tensor_proto.add_dims(dim);
+  }
+
+  // create the NodeArg first so that it has the symbolic shape of the graph input
+  NodeArg& node_arg = graph.GetOrCreateNodeArg(name, &type_proto);
+  graph.AddInitializedTensor(tensor_proto);
+  return node_arg;
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+Status ValidateUpdate(const std::string& weight_name, const LoraWeights& weights, int64_t k, int64_t n) {
+  ORT_RETURN_IF_NOT(weights.lora_a.IsTensor() && weights.lora_b.IsTensor(),
+                    "The LoRA update of ", weight_name, " must be tensors.");
+  const Tensor& lora_a = weights.lora_a.Get<Tensor>();
+  const Tensor& lora_b = weights.lora_b.Get<Tensor>();
+  ORT_RETURN_IF_NOT(lora_a.IsDataType<float>() && lora_b.IsDataType<float>(),
+                    "The LoRA update of ", weight_name, " must be float tensors.");
+  ORT_RETURN_IF_NOT(lora_a.Location().device.Type() == OrtDevice::CPU &&
+                        lora_b.Location().device.Type() == OrtDevice::CPU,
+                    "The LoRA update of ", weight_name, " must be on the CPU.");
+
+  const auto& a_shape = lora_a.Shape();
+  const auto& b_shape = lora_b.Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() == 2 && b_shape.NumDimensions() == 2 &&
+                        a_shape[0] == k && b_shape[1] == n && a_shape[1] == b_shape[0],
+                    "The LoRA update of ", weight_name, " must have the shapes [", k, ", r] and [r, ", n,
+                    "], got ", a_shape, " and ", b_shape);
+  return Status::OK();
+}
+
+}  // namespace
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status LoraAdapters::ApplyToGraph(Graph& graph, const std::string& target_weights, const logging::Logger& logger) {
+  ORT_RETURN_IF_NOT(graph.CanOverrideInitializer(),
+                    "LoRA target weights require a model with IR version 4 or later, got ", graph.IrVersion());
+
+  const auto& graph_inputs = graph.GetInputsIncludingInitializers();
+  InlinedVector<const NodeArg*> new_graph_inputs(graph_inputs.begin(), graph_inputs.end());
+
+  for (const auto weight_name_view : utils::SplitString(target_weights, ";")) {
+    const std::string weight_name{weight_name_view};
+    ORT_RETURN_IF(targets_.count(weight_name) != 0, "LoRA target weight ", weight_name, " is listed twice.");
+
+    const auto* tensor_proto = graph.GetConstantInitializer(weight_name, false);
+    ORT_RETURN_IF(tensor_proto == nullptr, "LoRA target weight ", weight_name, " is not a constant initializer.");
+    ORT_RETURN_IF_NOT(tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+                          tensor_proto->dims_size() == 2,
+                      "LoRA target weight ", weight_name, " must be a 2D float tensor.");
+
+    InlinedVector<Node*> matmuls;
+    for (Node* node : graph.GetMutableConsumerNodes(weight_name)) {
+      const auto& input_defs = node->InputDefs();
+      ORT_RETURN_IF_NOT(graph_utils::IsSupportedOptypeVersionAndDomain(*node, "MatMul", {1, 9, 13}) &&
+                            input_defs[0]->Name() != weight_name && input_defs[1]->Name() == weight_name,
+                        "LoRA target weight ", weight_name, " must only be the second input of MatMul nodes, ",
+                        "it is used by ", node->OpType(), " node ", node->Name());
+      matmuls.push_back(node);
+    }
+    ORT_RETURN_IF(matmuls.empty(), "LoRA target weight ", weight_name, " is not used.");
+
+    const int64_t k = tensor_proto->dims(0);
+    const int64_t n = tensor_proto->dims(1);
+    Target target{graph.GenerateNodeArgName(weight_name + "_lora_A"),
+                  graph.GenerateNodeArgName(weight_name + "_lora_B"), k, n};
+    NodeArg& lora_a = AddEmptyUpdateInput(graph, target.lora_a_input, k, 0);
+    NodeArg& lora_b = AddEmptyUpdateInput(graph, target.lora_b_input, 0, n);
+    new_graph_inputs.push_back(&lora_a);
+    new_graph_inputs.push_back(&lora_b);
+
+    for (Node* matmul : matmuls) {
+      const auto& input_defs = matmul->MutableInputDefs();
+      Node& matmul_lora = graph.AddNode(graph.GenerateNodeName(matmul->Name() + "_lora"), "MatMulLoRA",
+                                        "MatMul with a runtime LoRA update",
+                                        {input_defs[0], input_defs[1], &lora_a, &lora_b},
+                                        matmul->MutableOutputDefs(), nullptr, kMSDomain);
+      matmul_lora.SetExecutionProviderType(matmul->GetExecutionProviderType());
+      graph_utils::FinalizeNodeFusion(graph, {*matmul}, matmul_lora);
+    }
+
+    LOGS(logger, INFO) << "Added a LoRA update to " << matmuls.size() << " MatMul nodes using " << weight_name;
+    targets_.emplace(weight_name, std::move(target));
+  }
+
+  graph.SetInputs(new_graph_inputs);
+  return graph.Resolve();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+Status LoraAdapters::Add(const std::string& name, const LoraAdapter& adapter) {
+  ORT_RETURN_IF(name.empty(), "The name of a LoRA adapter cannot be empty.");
+  for (const auto& [weight_name, weights] : adapter) {
+    auto target = targets_.find(weight_name);
+    ORT_RETURN_IF(target == targets_.end(), "LoRA adapter ", name, " updates ", weight_name,
+                  " which is not a LoRA target weight of the session.");
+    ORT_RETURN_IF_ERROR(ValidateUpdate(weight_name, weights, target->second.k, target->second.n));
+  }
+
+  auto adapter_copy = std::make_shared<const LoraAdapter>(adapter);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  adapters_.insert_or_assign(name, std::move(adapter_copy));
+  return Status::OK();
+}
+
+Status LoraAdapters::Remove(const std::string& name) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ORT_RETURN_IF(adapters_.erase(name) == 0, "LoRA adapter ", name, " is not registered.");
+  return Status::OK();
+}
+
+Status LoraAdapters::AppendFeeds(const std::string& name, InlinedVector<std::string>& feed_names,
+                                 InlinedVector<OrtValue>& feeds) const {
+  std::shared_ptr<const LoraAdapter> adapter;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = adapters_.find(name);
+    ORT_RETURN_IF(it == adapters_.end(), "LoRA adapter ", name, " is not registered.");
+    adapter = it->second;
+  }
+
+  for (const auto& [weight_name, weights] : *adapter) {
+    const Target& target = targets_.at(weight_name);
+    ORT_RETURN_IF(std::find(feed_names.begin(), feed_names.end(), target.lora_a_input) != feed_names.end() ||
+                      std::find(feed_names.begin(), feed_names.end(), target.lora_b_input) != feed_names.end(),
+                  "The LoRA update of ", weight_name, " is fed directly and by adapter ", name);
+    feed_names.push_back(target.lora_a_input);
+    feeds.push_back(weights.lora_a);
+    feed_names.push_back(target.lora_b_input);
+    feeds.push_back(weights.lora_b);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
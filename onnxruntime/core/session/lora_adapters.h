@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class Graph;
+
+// The low-rank update of one weight W of shape [K, N]: W + lora_a * lora_b with lora_a of shape [K, r] and lora_b
+// of shape [r, N]. The scale of the update is expected to be folded into lora_b.
+struct LoraWeights {
+  OrtValue lora_a;
+  OrtValue lora_b;
+};
+
+// A LoRA adapter, the updates of the weights it changes keyed by the name of the weight.
+using LoraAdapter = InlinedHashMap<std::string, LoraWeights>;
+
+/**
+ * Lets the adapter of a model with LoRA target weights be switched per run without rebuilding the session.
+ *
+ * The MatMuls consuming a target weight are replaced with MatMulLoRA nodes that keep the weight as it is, so it is
+ * pre-packed once, and take the update as two extra inputs. The updates are overridable initializers with a rank
+ * of 0, so the base model runs when no adapter is selected. The adapters are registered with the session and a run
+ * selects one by name, its tensors are added to the feeds of the run. Switching adapters therefore only changes which
+ * tensors are fed, nothing is copied or re-packed.
+ */
+class LoraAdapters {
+ public:
+  LoraAdapters() = default;
+
+  /**
+   * Replaces the MatMuls consuming the target weights in the main graph with MatMulLoRA nodes.
+   * @param target_weights The names of the target weights, separated by ';'. Each must be a constant 2D float
+   *                       initializer that is only consumed as the second input of MatMul nodes.
+   */
+  Status ApplyToGraph(Graph& graph, const std::string& target_weights, const logging::Logger& logger);
+
+  // Registers or replaces the adapter `name`. The adapter may update any subset of the target weights.
+  Status Add(const std::string& name, const LoraAdapter& adapter);
+
+  Status Remove(const std::string& name);
+
+  /**
+   * Appends the inputs feeding the update tensors of adapter `name` to the feeds of a run.
+   * Target weights that the adapter does not update keep their default of no update.
+   */
+  Status AppendFeeds(const std::string& name, InlinedVector<std::string>& feed_names,
+                     InlinedVector<OrtValue>& feeds) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LoraAdapters);
+
+  struct Target {
+    std::string lora_a_input;
+    std::string lora_b_input;
+    int64_t k;
+    int64_t n;
+  };
+
+  // targets by weight name, set by ApplyToGraph()
+  InlinedHashMap<std::string, Target> targets_;
+
+  mutable OrtMutex mutex_;
+  // the registered adapters. a run holds a reference so that an adapter can be replaced or removed meanwhile.
+  InlinedHashMap<std::string, std::shared_ptr<const LoraAdapter>> adapters_;
+};
+
+}  // namespace onnxruntime
@@ -18,7 +18,9 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
+#include "core/common/parse_string.h"
 #include "core/common/status.h"
+#include "core/common/string_utils.h"
 #include "core/common/safeint.h"
 #include "core/graph/constants.h"
 #include "core/graph/graph.h"
@@ -31,6 +33,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/ort_apis.h"
 #include "core/session/ort_env.h"
 #include "core/framework/data_types.h"
@@ -736,15 +739,24 @@ static ORT_STATUS_PTR CreateSessionAndLoadModel(_In_ const OrtSessionOptions* op
   return nullptr;
 }
 
+// `device_id` selects the device of the providers that support it, for a replica of a session. -1 keeps the device
+// set in the provider options.
 static ORT_STATUS_PTR InitializeSession(_In_ const OrtSessionOptions* options,
                                         _In_ std::unique_ptr<::onnxruntime::InferenceSession>& sess,
-                                        _Inout_opt_ OrtPrepackedWeightsContainer* prepacked_weights_container = nullptr) {
+                                        _Inout_opt_ OrtPrepackedWeightsContainer* prepacked_weights_container = nullptr,
+                                        int device_id = -1) {
   // we need to disable mem pattern if DML is one of the providers since DML doesn't have the concept of
   // byte addressable memory
   std::vector<std::unique_ptr<IExecutionProvider>> provider_list;
   if (options) {
     for (auto& factory : options->provider_factories) {
-      auto provider = factory->CreateProvider();
+      std::unique_ptr<IExecutionProvider> provider;
+      if (device_id >= 0) {
+        provider = factory->CreateProviderForDevice(device_id);
+      }
+      if (!provider) {
+        provider = factory->CreateProvider();
+      }
       provider_list.push_back(std::move(provider));
     }
   }
@@ -766,6 +778,39 @@ static ORT_STATUS_PTR InitializeSession(_In_ const OrtSessionOptions* options,
   return nullptr;
 }
 
+// Adds the replicas listed in kOrtSessionOptionsConfigReplicaDeviceIds to the initialized session.
+static ORT_STATUS_PTR CreateSessionReplicas(_In_ const OrtSessionOptions* options,
+                                            _In_ const OrtEnv* env,
+                                            _In_opt_z_ const ORTCHAR_T* model_path,
+                                            _In_opt_ const void* model_data,
+                                            size_t model_data_length,
+                                            _Inout_opt_ OrtPrepackedWeightsContainer* prepacked_weights_container,
+                                            _In_ std::unique_ptr<::onnxruntime::InferenceSession>& sess) {
+  if (options == nullptr) {
+    return nullptr;
+  }
+
+  const std::string device_ids =
+      options->value.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigReplicaDeviceIds, "");
+  for (const auto device_id_str : utils::SplitString(device_ids, ";")) {
+    int device_id = -1;
+    if (!TryParseStringWithClassicLocale(device_id_str, device_id) || device_id < 0) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                   ("Invalid device id in " + std::string(kOrtSessionOptionsConfigReplicaDeviceIds) +
+                                    ": " + device_ids)
+                                       .c_str());
+    }
+
+    std::unique_ptr<::onnxruntime::InferenceSession> replica;
+    ORT_API_RETURN_IF_ERROR(CreateSessionAndLoadModel(options, env, model_path, model_data, model_data_length,
+                                                      replica));
+    ORT_API_RETURN_IF_ERROR(InitializeSession(options, replica, prepacked_weights_container, device_id));
+    ORT_API_RETURN_IF_STATUS_NOT_OK(sess->AddReplica(std::move(replica)));
+  }
+
+  return nullptr;
+}
+
 }  // namespace
 
 ORT_API_STATUS_IMPL(OrtApis::CreateSession, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* model_path,
@@ -778,6 +823,7 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSession, _In_ const OrtEnv* env, _In_ const O
   ORT_TRY {
     ORT_API_RETURN_IF_ERROR(CreateSessionAndLoadModel(options, env, model_path, nullptr, 0, sess));
     ORT_API_RETURN_IF_ERROR(InitializeSession(options, sess));
+    ORT_API_RETURN_IF_ERROR(CreateSessionReplicas(options, env, model_path, nullptr, 0, nullptr, sess));
 
     *out = reinterpret_cast<OrtSession*>(sess.release());
   }
@@ -801,6 +847,7 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   ORT_TRY {
     ORT_API_RETURN_IF_ERROR(CreateSessionAndLoadModel(options, env, nullptr, model_data, model_data_length, sess));
     ORT_API_RETURN_IF_ERROR(InitializeSession(options, sess));
+    ORT_API_RETURN_IF_ERROR(CreateSessionReplicas(options, env, nullptr, model_data, model_data_length, nullptr, sess));
 
     *out = reinterpret_cast<OrtSession*>(sess.release());
   }
@@ -1033,6 +1080,26 @@ ORT_API(void, OrtApis::ClearBoundOutputs, _Inout_ OrtIoBinding* binding_ptr) {
   binding_ptr->binding_->ClearOutputs();
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SetBoundOutputShapeChangedCallback, _Inout_ OrtIoBinding* binding_ptr,
+                    _In_opt_ OrtBoundOutputShapeChangedCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (callback == nullptr) {
+    binding_ptr->binding_->SetOutputShapeChangedCallback(nullptr);
+    return nullptr;
+  }
+
+  binding_ptr->binding_->SetOutputShapeChangedCallback(
+      [callback, user_data](const std::string& output_name, const TensorShape& previous_shape,
+                            const TensorShape& new_shape) {
+        const auto previous_dims = previous_shape.GetDims();
+        const auto new_dims = new_shape.GetDims();
+        callback(user_data, output_name.c_str(), previous_dims.data(), previous_dims.size(),
+                 new_dims.data(), new_dims.size());
+      });
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SynchronizeBoundInputs, _Inout_ OrtIoBinding* binding_ptr) {
   API_IMPL_BEGIN
   auto st = binding_ptr->binding_->SynchronizeInputs();
@@ -2196,6 +2263,28 @@ ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingStartTimeNs, _In_ const OrtSessi
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetKernelLatencyMetrics, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string json;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetKernelLatencyMetrics(json));
+  *out = StrDup(json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetCalibrationTable, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string json;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetCalibrationTable(json));
+  *out = StrDup(json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 // End support for non-tensor types
 
 ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfg, _In_ size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
@@ -2230,6 +2319,12 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "max_cached_chunk_size_bytes") == 0) {
+      cfg->max_cached_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "use_huge_pages") == 0) {
+      cfg->use_huge_pages = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "prefault_memory") == 0) {
+      cfg->prefault_memory = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2271,6 +2366,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionWithPrepackedWeightsContainer, _In_ co
   ORT_TRY {
     ORT_API_RETURN_IF_ERROR(CreateSessionAndLoadModel(options, env, model_path, nullptr, 0, sess));
     ORT_API_RETURN_IF_ERROR(InitializeSession(options, sess, prepacked_weights_container));
+    ORT_API_RETURN_IF_ERROR(CreateSessionReplicas(options, env, model_path, nullptr, 0, prepacked_weights_container,
+                                                  sess));
 
     *out = reinterpret_cast<OrtSession*>(sess.release());
   }
@@ -2297,6 +2394,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArrayWithPrepackedWeightsContainer
     ORT_API_RETURN_IF_ERROR(CreateSessionAndLoadModel(options, env, nullptr, model_data,
                                                       model_data_length, sess));
     ORT_API_RETURN_IF_ERROR(InitializeSession(options, sess, prepacked_weights_container));
+    ORT_API_RETURN_IF_ERROR(CreateSessionReplicas(options, env, nullptr, model_data, model_data_length,
+                                                  prepacked_weights_container, sess));
 
     *out = reinterpret_cast<OrtSession*>(sess.release());
   }
@@ -2725,6 +2824,12 @@ static constexpr OrtApi ort_api_1_to_18 = {
     &OrtApis::KernelContext_ParallelFor,
     &OrtApis::SessionOptionsAppendExecutionProvider_OpenVINO_V2,
     &OrtApis::SessionOptionsAppendExecutionProvider_VitisAI,
+    &OrtApis::SessionGetKernelLatencyMetrics,
+    &OrtApis::SetBoundOutputShapeChangedCallback,
+    &OrtApis::RunOptionsEnableRunStats,
+    &OrtApis::RunOptionsGetRunStats,
+    &OrtApis::SessionGetCalibrationTable,
+    &OrtApis::RunOptionsSetGenerationTokensCallback,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
@@ -513,4 +513,20 @@ ORT_API_STATUS_IMPL(SessionOptionsAppendExecutionProvider_OpenVINO_V2,
 ORT_API_STATUS_IMPL(SessionOptionsAppendExecutionProvider_VitisAI, _In_ OrtSessionOptions* options,
                     _In_reads_(num_keys) const char* const* provider_options_keys,
                     _In_reads_(num_keys) const char* const* provider_options_values, _In_ size_t num_keys);
+
+ORT_API_STATUS_IMPL(SessionGetKernelLatencyMetrics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(SetBoundOutputShapeChangedCallback, _Inout_ OrtIoBinding* binding_ptr,
+                    _In_opt_ OrtBoundOutputShapeChangedCallbackFn callback, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(RunOptionsEnableRunStats, _Inout_ OrtRunOptions* options);
+ORT_API_STATUS_IMPL(RunOptionsGetRunStats, _In_ const OrtRunOptions* options, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(SessionGetCalibrationTable, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(RunOptionsSetGenerationTokensCallback, _Inout_ OrtRunOptions* options,
+                    _In_opt_ OrtGenerationTokensCallbackFn callback, _In_opt_ void* user_data);
 }  // namespace OrtApis
@@ -19,6 +19,8 @@
 #include "core/framework/provider_options.h"
 #include "core/framework/fallback_cpu_capability.h"
 #include "core/framework/random_generator.h"
+#include "core/framework/run_options.h"
+#include "core/common/run_stats.h"
 #include "core/graph/model.h"
 #include "core/platform/env.h"
 #include "core/providers/common.h"
@@ -676,6 +678,15 @@ struct ProviderHostImpl : ProviderHost {
     return p->GetConfigEntry(config_key);
   }
 
+  // RunOptions (wrapped)
+  const ConfigOptions& RunOptions__GetConfigOptions(const RunOptions* p) override { return p->config_options; }
+  bool RunOptions__CollectsRunStats(const RunOptions* p) override { return p->run_stats != nullptr; }
+  void RunOptions__AddRunStatsDeviceTime(const RunOptions* p, int64_t ns) override {
+    if (p->run_stats) {
+      p->run_stats->AddDeviceTime(ns);
+    }
+  }
+
   // ComputeCapability (wrapped)
   std::unique_ptr<ComputeCapability> ComputeCapability__construct(std::unique_ptr<IndexedSubGraph> t_sub_graph) override { return std::make_unique<ComputeCapability>(std::move(t_sub_graph)); }
   void ComputeCapability__operator_delete(ComputeCapability* p) override { delete p; }
@@ -1628,6 +1639,8 @@ OrtTensorRTProviderOptionsV2 OrtTensorRTProviderOptionsToOrtTensorRTProviderOpti
   trt_options_converted.trt_dump_ep_context_model = 0;
   trt_options_converted.trt_ep_context_file_path = "";
   trt_options_converted.trt_ep_context_embed_mode = 0;
+  trt_options_converted.trt_profile_shape_bucketing = 0;
+  trt_options_converted.trt_share_initializers_enable = 0;
   trt_options_converted.trt_engine_cache_prefix = "";
 
   return trt_options_converted;
@@ -2563,6 +2576,7 @@ ORT_API_STATUS_IMPL(OrtApis::CreateROCMProviderOptions, _Outptr_ OrtROCMProvider
   options->tunable_op_enable = 0;
   options->tunable_op_tuning_enable = 0;
   options->tunable_op_max_tuning_duration_ms = 0;
+  options->hip_graph_max_num_graphs = 8;
 
   *out = options.release();
   return nullptr;
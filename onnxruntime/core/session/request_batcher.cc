@@ -0,0 +1,341 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+Status TerminatedStatus() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+}
+}  // namespace
+
+RequestBatcher::RequestBatcher(size_t max_batch_size, std::chrono::microseconds timeout, AllocatorPtr allocator,
+                               RunFn run_fn)
+    : max_batch_size_(max_batch_size),
+      timeout_(timeout),
+      allocator_(std::move(allocator)),
+      run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(max_batch_size_ > 1, "The maximum batch size must be greater than 1.");
+  ORT_ENFORCE(allocator_ && allocator_->Info().device.Type() == OrtDevice::CPU,
+              "A CPU allocator is required to batch requests.");
+}
+
+int64_t RequestBatcher::GetBatchSize(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                                     gsl::span<const OrtValue> fetches) const {
+  // run config entries may change how a run executes, so they are not dropped by merging the request into another.
+  // run stats and token callbacks report on a single run, so they can't be shared by the requests of a batch.
+  if (feeds.empty() || run_options.terminate || run_options.only_execute_path_to_fetches ||
+      !run_options.config_options.configurations.empty() || run_options.run_stats != nullptr ||
+      run_options.generation_tokens_callback != nullptr) {
+    return -1;
+  }
+
+  if (std::any_of(fetches.begin(), fetches.end(), [](const OrtValue& fetch) { return fetch.IsAllocated(); })) {
+    return -1;
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return -1;
+    }
+
+    const auto& tensor = feed.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || shape.NumDimensions() == 0 || shape[0] <= 0 ||
+        (batch_size != -1 && shape[0] != batch_size)) {
+      return -1;
+    }
+
+    batch_size = shape[0];
+  }
+
+  if (static_cast<size_t>(batch_size) >= max_batch_size_) {
+    return -1;
+  }
+
+  return batch_size;
+}
+
+std::string RequestBatcher::GetBatchKey(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                        gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names) {
+  std::ostringstream key;
+  // the batch runs with the run options of one of its requests, so they have to log the same way
+  key << run_options.run_log_severity_level << ',' << run_options.run_log_verbosity_level << ','
+      << run_options.run_tag.size() << ':' << run_options.run_tag << '|';
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    const auto& tensor = feeds[i].Get<Tensor>();
+    key << feed_names[i] << ':' << tensor.GetElementType();
+    const auto dims = tensor.Shape().GetDims();
+    for (size_t dim = 1; dim < dims.size(); ++dim) {
+      key << ',' << dims[dim];
+    }
+    key << ';';
+  }
+
+  key << '>';
+  for (const auto& output_name : output_names) {
+    key << output_name << ';';
+  }
+
+  return key.str();
+}
+
+void RequestBatcher::CloseBatch(Batch& batch) {
+  batch.closed = true;
+  auto entry = open_batches_.find(batch.key);
+  if (entry != open_batches_.end() && entry->second.get() == &batch) {
+    open_batches_.erase(entry);
+  }
+  cv_.notify_all();
+}
+
+Status RequestBatcher::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                           gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                           std::vector<OrtValue>& fetches) {
+  const int64_t batch_size = GetBatchSize(run_options, feeds, fetches);
+  if (batch_size < 0) {
+    return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  Request request{&run_options, feeds, &fetches, batch_size};
+  std::string key = GetBatchKey(run_options, feed_names, feeds, output_names);
+  std::shared_ptr<Batch> batch;
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    auto entry = open_batches_.find(key);
+    if (entry != open_batches_.end() &&
+        static_cast<size_t>(entry->second->batch_size + batch_size) <= max_batch_size_) {
+      // join the batch, its first request runs it
+      auto& open_batch = *entry->second;
+      open_batch.requests.push_back(&request);
+      open_batch.batch_size += batch_size;
+      if (static_cast<size_t>(open_batch.batch_size) == max_batch_size_) {
+        CloseBatch(open_batch);
+      }
+
+      cv_.wait(lock, [&request]() { return request.done; });
+    } else {
+      if (entry != open_batches_.end()) {
+        // the request does not fit anymore, so the batch won't grow and can run right away
+        CloseBatch(*entry->second);
+      }
+
+      batch = std::make_shared<Batch>();
+      batch->key = std::move(key);
+      batch->requests.push_back(&request);
+      batch->batch_size = batch_size;
+      open_batches_.emplace(batch->key, batch);
+
+      const auto deadline = std::chrono::steady_clock::now() + timeout_;
+      while (!batch->closed) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+          CloseBatch(*batch);
+          break;
+        }
+
+        cv_.wait_for(lock, deadline - now);
+      }
+    }
+  }
+
+  if (batch) {
+    RunBatch(feed_names, output_names, *batch);
+  }
+
+  if (request.terminated) {
+    return TerminatedStatus();
+  }
+
+  if (request.run_alone) {
+    return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  return Status::OK();
+}
+
+Status RequestBatcher::RunMany(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                               gsl::span<const std::vector<OrtValue>> feeds, gsl::span<const std::string> output_names,
+                               gsl::span<std::vector<OrtValue>> fetches) {
+  ORT_RETURN_IF_NOT(feeds.size() == fetches.size(), "The number of requests (", feeds.size(),
+                    ") does not match the number of fetches (", fetches.size(), ").");
+
+  std::vector<Request> requests;
+  requests.reserve(feeds.size());
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (fetches[i].empty()) {
+      fetches[i].resize(output_names.size());
+    }
+    requests.push_back(Request{&run_options, feeds[i], &fetches[i], GetBatchSize(run_options, feeds[i], fetches[i])});
+  }
+
+  // fill the batches in the order of the requests, a batch is complete once the next request does not fit anymore
+  std::vector<Batch> batches;
+  std::unordered_map<std::string, Batch> filling_batches;
+  for (auto& request : requests) {
+    if (request.batch_size < 0) {
+      request.run_alone = true;
+      continue;
+    }
+
+    std::string key = GetBatchKey(run_options, feed_names, request.feeds, output_names);
+    auto& batch = filling_batches[key];
+    if (static_cast<size_t>(batch.batch_size + request.batch_size) > max_batch_size_) {
+      batches.push_back(std::move(batch));
+      batch = Batch{};
+    }
+
+    batch.key = std::move(key);
+    batch.requests.push_back(&request);
+    batch.batch_size += request.batch_size;
+  }
+
+  for (auto& entry : filling_batches) {
+    batches.push_back(std::move(entry.second));
+  }
+
+  for (auto& batch : batches) {
+    batch.closed = true;
+    RunBatch(feed_names, output_names, batch);
+  }
+
+  for (auto& request : requests) {
+    if (request.terminated) {
+      return TerminatedStatus();
+    }
+
+    if (request.run_alone) {
+      ORT_RETURN_IF_ERROR(run_fn_(run_options, feed_names, request.feeds, output_names, *request.fetches));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status RequestBatcher::ConcatFeeds(const Batch& batch, std::vector<OrtValue>& batched_feeds) const {
+  const size_t num_feeds = batch.requests.front()->feeds.size();
+  batched_feeds.resize(num_feeds);
+  for (size_t i = 0; i < num_feeds; ++i) {
+    const auto& first = batch.requests.front()->feeds[i].Get<Tensor>();
+    auto dims = first.Shape().AsShapeVector();
+    dims[0] = batch.batch_size;
+    Tensor::InitOrtValue(first.DataType(), TensorShape(dims), allocator_, batched_feeds[i]);
+    auto& batched = *batched_feeds[i].GetMutable<Tensor>();
+
+    if (batched.IsDataTypeString()) {
+      auto* dst = batched.MutableData<std::string>();
+      for (const Request* request : batch.requests) {
+        const auto src = request->feeds[i].Get<Tensor>().DataAsSpan<std::string>();
+        dst = std::copy(src.begin(), src.end(), dst);
+      }
+    } else {
+      auto* dst = static_cast<uint8_t*>(batched.MutableDataRaw());
+      for (const Request* request : batch.requests) {
+        const auto& src = request->feeds[i].Get<Tensor>();
+        const size_t num_bytes = src.SizeInBytes();
+        memcpy(dst, src.DataRaw(), num_bytes);
+        dst += num_bytes;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+void RequestBatcher::RunBatch(gsl::span<const std::string> feed_names, gsl::span<const std::string> output_names,
+                              Batch& batch) {
+  // the requests terminated while they waited for the batch are left out of it
+  std::vector<Request*> terminated_requests;
+  {
+    auto terminated = std::stable_partition(batch.requests.begin(), batch.requests.end(),
+                                            [](const Request* request) { return !request->run_options->terminate; });
+    for (auto it = terminated; it != batch.requests.end(); ++it) {
+      (*it)->terminated = true;
+      batch.batch_size -= (*it)->batch_size;
+      terminated_requests.push_back(*it);
+    }
+    batch.requests.erase(terminated, batch.requests.end());
+  }
+
+  // a single request runs with its own inputs, without concatenating them
+  bool batched = false;
+  std::vector<OrtValue> batched_fetches(output_names.size());
+  if (batch.requests.size() > 1) {
+    // a copy whose terminate flag stays unset, so that terminating one request does not abort the others
+    RunOptions run_options = *batch.requests.front()->run_options;
+    run_options.terminate = false;
+    Status status;
+    std::vector<OrtValue> batched_feeds;
+    ORT_TRY {
+      status = ConcatFeeds(batch, batched_feeds);
+      if (status.IsOK()) {
+        status = run_fn_(run_options, feed_names, batched_feeds, output_names, batched_fetches);
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    // the model may not accept the concatenated inputs, the requests are then run on their own so that each one
+    // gets its own result or error
+    batched = status.IsOK() &&
+              std::all_of(batched_fetches.begin(), batched_fetches.end(), [&batch](const OrtValue& fetch) {
+                if (!fetch.IsTensor()) {
+                  return false;
+                }
+                const auto& shape = fetch.Get<Tensor>().Shape();
+                return shape.NumDimensions() > 0 && shape[0] == batch.batch_size;
+              });
+  }
+
+  if (batched) {
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    int64_t offset = 0;
+    for (Request* request : batch.requests) {
+      // the terminate flag of the request was set during the batched run, which completed for the other requests
+      if (request->run_options->terminate) {
+        request->terminated = true;
+        offset += request->batch_size;
+        continue;
+      }
+
+      for (size_t i = 0, end = batched_fetches.size(); i < end; ++i) {
+        const auto& tensor = batched_fetches[i].Get<Tensor>();
+        auto dims = tensor.Shape().AsShapeVector();
+        dims[0] = request->batch_size;
+        const size_t row_bytes = tensor.SizeInBytes() / narrow<size_t>(batch.batch_size);
+        auto* data = static_cast<uint8_t*>(const_cast<void*>(tensor.DataRaw())) + SafeInt<size_t>(offset) * row_bytes;
+        auto p_tensor = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+        // the view keeps the batched output alive
+        (*request->fetches)[i].Init(p_tensor.release(), ml_tensor,
+                                    [batched_fetch = batched_fetches[i]](void* p) { delete static_cast<Tensor*>(p); });
+      }
+      offset += request->batch_size;
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (Request* request : batch.requests) {
+    request->run_alone = !batched && !request->terminated;
+    request->done = true;
+  }
+  for (Request* request : terminated_requests) {
+    request->done = true;
+  }
+  cv_.notify_all();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// RequestBatcher coalesces concurrent Run calls into a single execution of the graph.
+//
+// Requests whose inputs have the same names, element types and shapes apart from the first (batch) dimension join
+// the same batch. The first request of a batch waits until the batch holds `max_batch_size` rows or until `timeout`
+// expires, concatenates the inputs along the batch dimension, runs the graph once on its own thread and hands every
+// request a view of its rows of the outputs. The views share the buffers of the batched outputs, so scattering the
+// outputs does not copy them.
+//
+// Only requests with all inputs in CPU memory, a batch dimension smaller than `max_batch_size`, no run config
+// entries, run stats or token callback and no pre-allocated outputs are batched; the others run on their own. Only
+// requests with the same run tag and log levels share a batch. A request whose terminate flag is set before the
+// batched run is left out of it, and one whose flag is set during the run gets no outputs; both fail like a terminated
+// run. When the batched run fails or one of its outputs does not have the batch dimension, every request of the batch
+// is run on its own.
+//
+// The model has to process the rows of the batch independently of each other, as the requests otherwise get
+// different results than when they run on their own.
+class RequestBatcher {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>& fetches)>;
+
+  // `allocator` allocates the batched inputs in CPU memory. `run_fn` executes the graph.
+  RequestBatcher(size_t max_batch_size, std::chrono::microseconds timeout, AllocatorPtr allocator, RunFn run_fn);
+
+  Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+             std::vector<OrtValue>& fetches);
+
+  // Runs requests submitted together, which share the feed and output names. The compatible requests are merged into
+  // batches right away instead of waiting for concurrent Run calls, the others run one after another.
+  Status RunMany(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                 gsl::span<const std::vector<OrtValue>> feeds, gsl::span<const std::string> output_names,
+                 gsl::span<std::vector<OrtValue>> fetches);
+
+ private:
+  struct Request {
+    const RunOptions* run_options;
+    gsl::span<const OrtValue> feeds;
+    std::vector<OrtValue>* fetches;
+    int64_t batch_size;
+    // whether the request has to be run on its own because its batch could not be run or scattered
+    bool run_alone = false;
+    // whether the terminate flag of the request was set before its outputs were set
+    bool terminated = false;
+    bool done = false;
+  };
+
+  struct Batch {
+    std::string key;
+    std::vector<Request*> requests;
+    int64_t batch_size = 0;
+    bool closed = false;
+  };
+
+  // Returns the batch dimension of the request, or -1 if it can't be batched.
+  int64_t GetBatchSize(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                       gsl::span<const OrtValue> fetches) const;
+
+  static std::string GetBatchKey(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                 gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names);
+
+  // Closes the batch. Requires mutex_ to be held.
+  void CloseBatch(Batch& batch);
+
+  // Runs the graph once for the requests of a closed batch that are not terminated, with a copy of the run options of
+  // the first of them, and sets the outputs of the requests, or marks them to be run on their own.
+  void RunBatch(gsl::span<const std::string> feed_names, gsl::span<const std::string> output_names, Batch& batch);
+
+  Status ConcatFeeds(const Batch& batch, std::vector<OrtValue>& batched_feeds) const;
+
+  const size_t max_batch_size_;
+  const std::chrono::microseconds timeout_;
+  const AllocatorPtr allocator_;
+  const RunFn run_fn_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  // the batches that requests can still join, by key
+  std::unordered_map<std::string, std::shared_ptr<Batch>> open_batches_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/stream_states.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/common/string_utils.h"
+#include "core/framework/data_types_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace {
+
+const NodeArg* FindNodeArg(const std::vector<const NodeArg*>& node_args, std::string_view name) {
+  auto it = std::find_if(node_args.begin(), node_args.end(),
+                         [name](const NodeArg* node_arg) { return node_arg->Name() == name; });
+  return it != node_args.end() ? *it : nullptr;
+}
+
+// Creates a tensor of zeros for the state input `node_arg` if it has a static shape and a numeric type.
+void CreateZeros(const NodeArg& node_arg, AllocatorPtr allocator, OrtValue& value) {
+  const ONNX_NAMESPACE::TypeProto* type_proto = node_arg.TypeAsProto();
+  if (type_proto == nullptr || !utils::HasTensorType(*type_proto) || node_arg.Shape() == nullptr) {
+    return;
+  }
+
+  const TensorShape shape = utils::GetTensorShapeFromTensorShapeProto(*node_arg.Shape());
+  const auto dims = shape.GetDims();
+  if (std::any_of(dims.begin(), dims.end(), [](int64_t dim) { return dim < 0; })) {
+    return;
+  }
+
+  const auto* element_type =
+      DataTypeImpl::TensorTypeFromONNXEnum(type_proto->tensor_type().elem_type())->GetElementType();
+  if (utils::IsDataTypeString(element_type)) {
+    return;
+  }
+
+  Tensor::InitOrtValue(element_type, shape, std::move(allocator), value);
+  Tensor& tensor = *value.GetMutable<Tensor>();
+  memset(tensor.MutableDataRaw(), 0, tensor.SizeInBytes());
+}
+
+}  // namespace
+
+Status StreamStates::Init(const std::string& states, const Graph& graph, const SessionState& session_state) {
+  const auto& inputs = graph.GetInputsIncludingInitializers();
+  const auto& required_inputs = graph.GetInputs();
+  const auto& outputs = graph.GetOutputs();
+  AllocatorPtr cpu_allocator = session_state.GetAllocator(OrtDevice());
+
+  for (const auto state_view : utils::SplitString(states, ";")) {
+    const auto names = utils::SplitString(state_view, ":");
+    ORT_RETURN_IF_NOT(names.size() == 2 && !names[0].empty() && !names[1].empty(),
+                      "The streaming state ", state_view, " must be a pair of an input and an output as input:output.");
+
+    const NodeArg* input = FindNodeArg(inputs, names[0]);
+    ORT_RETURN_IF_NOT(input != nullptr, "The streaming state input ", names[0], " is not an input of the model.");
+    ORT_RETURN_IF_NOT(FindNodeArg(outputs, names[1]) != nullptr,
+                      "The streaming state output ", names[1], " is not an output of the model.");
+
+    State& state = states_.emplace_back();
+    state.input_name = std::string{names[0]};
+    state.output_name = std::string{names[1]};
+
+    // an input that no node consumes stays on the CPU
+    InlinedVector<SessionState::NodeInfo> node_info;
+    if (session_state.GetInputNodeInfo(state.input_name, node_info).IsOK() && !node_info.empty() &&
+        node_info[0].device != nullptr) {
+      state.device = *node_info[0].device;
+    }
+
+    // the default of an overridable initializer is the initial state, it is fed by the session when the input is not
+    if (FindNodeArg(required_inputs, names[0]) != nullptr) {
+      CreateZeros(*input, cpu_allocator, state.initial_value);
+    }
+  }
+
+  ORT_RETURN_IF(states_.empty(), "No streaming states are set.");
+  return Status::OK();
+}
+
+void StreamStates::AppendFeedsAndFetches(const std::string& stream_id,
+                                         InlinedVector<std::string>& feed_names, InlinedVector<OrtValue>& feeds,
+                                         InlinedVector<std::string>& output_names, std::vector<OrtValue>& fetches,
+                                         std::vector<OrtDevice>& fetch_devices) const {
+  const bool preallocated_fetches = !fetches.empty();
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto stream = streams_.find(stream_id);
+
+  for (size_t i = 0; i < states_.size(); ++i) {
+    const State& state = states_[i];
+
+    if (std::find(feed_names.begin(), feed_names.end(), state.input_name) == feed_names.end()) {
+      const OrtValue* value = &state.initial_value;
+      if (stream != streams_.end() && stream->second[i].IsAllocated()) {
+        value = &stream->second[i];
+      }
+      // a missing state without an initial value is reported by the validation of the inputs
+      if (value->IsAllocated()) {
+        feed_names.push_back(state.input_name);
+        feeds.push_back(*value);
+      }
+    }
+
+    if (std::find(output_names.begin(), output_names.end(), state.output_name) == output_names.end()) {
+      output_names.push_back(state.output_name);
+      fetch_devices.push_back(state.device);
+      if (preallocated_fetches) {
+        fetches.emplace_back();
+      }
+    }
+  }
+}
+
+void StreamStates::Update(const std::string& stream_id, gsl::span<const std::string> output_names,
+                          gsl::span<const OrtValue> fetches) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& values = streams_[stream_id];
+  values.resize(states_.size());
+
+  for (size_t i = 0; i < states_.size(); ++i) {
+    auto it = std::find(output_names.begin(), output_names.end(), states_[i].output_name);
+    if (it != output_names.end()) {
+      values[i] = fetches[narrow<size_t>(it - output_names.begin())];
+    }
+  }
+}
+
+void StreamStates::Reset(const std::string& stream_id) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  streams_.erase(stream_id);
+}
+
+}  // namespace onnxruntime
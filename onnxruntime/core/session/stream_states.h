@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class Graph;
+class SessionState;
+
+/**
+ * Carries the states of streaming models, e.g. the hidden states of an LSTM, the caches of the convolutions of a
+ * Conformer or the KV cache of a decoder, across the runs processing the chunks of a stream.
+ *
+ * A state is a pair of a graph input and the graph output holding its value for the next chunk. The runs of a stream
+ * select it by id and the session feeds the state inputs with the outputs of the previous run of the stream, so the
+ * application neither feeds nor fetches them. The outputs are fetched to the device of the nodes consuming the state
+ * inputs and fed to the next run as they are, so the states stay on the device and are never copied. States of
+ * inputs with a static shape start as zeros, which all streams share, states of inputs with a default start from it.
+ */
+class StreamStates {
+ public:
+  StreamStates() = default;
+
+  /**
+   * @param states The state inputs and outputs of the main graph as "input:output" pairs, separated by ';'.
+   * @param session_state The finalized session state of the main graph.
+   */
+  Status Init(const std::string& states, const Graph& graph, const SessionState& session_state);
+
+  /**
+   * Appends the states of stream `stream_id` to the feeds of a run, and the state outputs to its outputs, with the
+   * devices to fetch them to. Inputs fed by the caller override the states.
+   * `fetches` is extended when it is preallocated, `fetch_devices` must have an entry per output name.
+   */
+  void AppendFeedsAndFetches(const std::string& stream_id,
+                             InlinedVector<std::string>& feed_names, InlinedVector<OrtValue>& feeds,
+                             InlinedVector<std::string>& output_names, std::vector<OrtValue>& fetches,
+                             std::vector<OrtDevice>& fetch_devices) const;
+
+  // Keeps the state outputs fetched by a run of stream `stream_id` as the states of its next run.
+  void Update(const std::string& stream_id, gsl::span<const std::string> output_names,
+              gsl::span<const OrtValue> fetches);
+
+  // Drops the states of stream `stream_id`, its next run starts from the initial states.
+  void Reset(const std::string& stream_id);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StreamStates);
+
+  struct State {
+    std::string input_name;
+    std::string output_name;
+    // device of the nodes consuming the input, the output is fetched to it
+    OrtDevice device;
+    // zeros for inputs with a static shape and no default, unset otherwise
+    OrtValue initial_value;
+  };
+
+  std::vector<State> states_;
+
+  mutable OrtMutex mutex_;
+  // the states of each stream, indexed like states_. an unset value is replaced with the initial one.
+  InlinedHashMap<std::string, std::vector<OrtValue>> streams_;
+};
+
+}  // namespace onnxruntime
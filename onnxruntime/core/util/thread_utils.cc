@@ -4,6 +4,7 @@
 #include "core/util/thread_utils.h"
 
 #include <algorithm>
+#include <numeric>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -19,9 +20,11 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " thread_pool_size: " << params.thread_pool_size;
   os << " auto_set_affinity: " << params.auto_set_affinity;
   os << " allow_spinning: " << params.allow_spinning;
+  os << " adaptive_spinning: " << params.adaptive_spinning;
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " numa_node: " << params.numa_node;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -89,10 +92,66 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 }
 #endif
 
+// Affinities of the threads of a pool that runs on a NUMA node.
+// The first affinity is for the caller thread and is dropped by the thread pool, as for the default affinities.
+static std::vector<LogicalProcessors> GetNumaNodeAffinities(int numa_node, int& thread_pool_size) {
+  const auto numa_nodes = Env::Default().GetNumaNodes();
+  ORT_ENFORCE(static_cast<size_t>(numa_node) < numa_nodes.size(),
+              "NUMA node ", numa_node, " does not exist, number of NUMA nodes: ", numa_nodes.size());
+  const LogicalProcessors& node_processors = numa_nodes[numa_node];
+
+  if (thread_pool_size > 0) {
+    return std::vector<LogicalProcessors>(static_cast<size_t>(thread_pool_size), node_processors);
+  }
+
+  // one thread per physical core of the node
+  std::vector<LogicalProcessors> node_cores;
+  for (auto& core : Env::Default().GetDefaultThreadAffinities()) {
+    if (!core.empty() &&
+        std::all_of(core.begin(), core.end(), [&node_processors](int processor) {
+          return std::find(node_processors.begin(), node_processors.end(), processor) != node_processors.end();
+        })) {
+      node_cores.push_back(std::move(core));
+    }
+  }
+  if (node_cores.empty()) {
+    // core topology is unknown, use one thread per logical processor
+    node_cores.assign(node_processors.size(), node_processors);
+  }
+  thread_pool_size = static_cast<int>(node_cores.size());
+  return node_cores;
+}
+
+// Sets one thread per core of the default affinities. On CPUs with cores of different types, the performance cores
+// come first, so that the slot of the caller thread, which is dropped by the thread pool, is a performance core, and
+// the capacities of the cores let the thread pool give less work to the threads on efficiency cores.
+static void SetDefaultThreadAffinities(std::vector<LogicalProcessors> default_affinities, ThreadOptions& to) {
+  auto capacities = Env::Default().GetCoreCapacities();
+  if (capacities.size() != default_affinities.size()) {
+    to.affinities = std::move(default_affinities);
+    return;
+  }
+
+  std::vector<size_t> order(default_affinities.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&capacities](size_t lhs, size_t rhs) { return capacities[lhs] > capacities[rhs]; });
+
+  to.affinities.clear();
+  to.capacities.clear();
+  for (size_t core : order) {
+    to.affinities.push_back(std::move(default_affinities[core]));
+    to.capacities.push_back(capacities[core]);
+  }
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
-  if (options.thread_pool_size <= 0) {  // default
+  if (options.numa_node >= 0) {
+    ORT_ENFORCE(options.affinity_str.empty(), "Thread affinities and a NUMA node can't both be set for a thread pool");
+    to.affinities = GetNumaNodeAffinities(options.numa_node, options.thread_pool_size);
+  } else if (options.thread_pool_size <= 0) {  // default
     if (options.auto_set_affinity) {
 #ifdef _WIN32
       // Only set thread affinity on Server with auto affinity.
@@ -104,7 +163,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
           return nullptr;
         }
         options.thread_pool_size = static_cast<int>(default_affinities.size());
-        to.affinities = std::move(default_affinities);
+        SetDefaultThreadAffinities(std::move(default_affinities), to);
       } else {
         options.thread_pool_size = Env::Default().GetNumPhysicalCpuCores();
       }
@@ -114,7 +173,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
         return nullptr;
       }
       options.thread_pool_size = static_cast<int>(default_affinities.size());
-      to.affinities = std::move(default_affinities);
+      SetDefaultThreadAffinities(std::move(default_affinities), to);
 #endif
     } else {
       options.thread_pool_size = Env::Default().GetNumPhysicalCpuCores();
@@ -129,6 +188,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
     ORT_THROW("Setting thread affinity is not implemented in this build.");
 #else
     to.affinities = ReadThreadAffinityConfig(options.affinity_str);
+    to.capacities.clear();
     // Limiting the number of affinities to be of thread_pool_size - 1,
     // for the fact that the main thread is a special "member" of the threadpool,
     // which onnxruntime has no control.
@@ -151,6 +211,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   to.custom_thread_creation_options = options.custom_thread_creation_options;
   to.custom_join_thread_fn = options.custom_join_thread_fn;
   to.dynamic_block_base_ = options.dynamic_block_base_;
+  to.adaptive_spinning = options.allow_spinning && options.adaptive_spinning;
   if (to.custom_create_thread_fn) {
     ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set");
   }
@@ -21,6 +21,10 @@ struct OrtThreadPoolParams {
   // If it is true, the thread pool will spin a while after the queue became empty.
   bool allow_spinning = true;
 
+  // If it is true together with allow_spinning, the time the threads spin before blocking follows the average time
+  // between the parallel sections run by the thread pool.
+  bool adaptive_spinning = false;
+
   // It it is non-negative, thread pool will split a task by a decreasing block size
   // of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
   int dynamic_block_base_ = 0;
@@ -37,6 +41,11 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If it is non-negative, the threads run on the logical processors of this NUMA node (index in
+  // Env::GetNumaNodes()). With thread_pool_size = 0, the pool gets one thread per physical core of the node.
+  // Can't be combined with affinity_str.
+  int numa_node = -1;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
@@ -199,15 +199,21 @@ class Session:
                 f"Required inputs ({missing_input_names}) are missing from input feed ({feed_input_names})."
             )
 
-    def run(self, output_names, input_feed, run_options=None):
+    def run(self, output_names, input_feed, run_options=None, outputs=None):
         """
         Compute the predictions.
 
         :param output_names: name of the outputs
-        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param input_feed: dictionary ``{ input_name: input_value }``. Besides numpy arrays and OrtValues, the values
+            may be objects exporting ``__cuda_array_interface__`` (CUDA builds) or ``__dlpack__`` (builds with DLPack
+            support), whose memory is used without a copy.
         :param run_options: See :class:`onnxruntime.RunOptions`.
+        :param outputs: optional list of pre-allocated numpy arrays, one per output name (or per model output if
+            output_names is empty). Each array must be C-contiguous and have the type and shape of the output,
+            which is written into it and returned. ``None`` entries are allocated by onnxruntime.
         :return: list of results, every result is either a numpy array,
-            a sparse tensor, a list or a dictionary.
+            a sparse tensor, a list or a dictionary. Numpy arrays of outputs located in CPU memory
+            share the buffer produced by onnxruntime instead of copying it.
 
         ::
 
@@ -216,8 +222,10 @@ class Session:
         self._validate_input(list(input_feed.keys()))
         if not output_names:
             output_names = [output.name for output in self._outputs_meta]
+        if outputs is None:
+            outputs = []
         try:
-            return self._sess.run(output_names, input_feed, run_options)
+            return self._sess.run(output_names, input_feed, run_options, outputs)
         except C.EPFail as err:
             if self._enable_fallback:
                 print(f"EP Error: {err!s} using {self._providers}")
@@ -225,7 +233,41 @@ class Session:
                 self.set_providers(self._fallback_providers)
                 # Fallback only once.
                 self.disable_fallback()
-                return self._sess.run(output_names, input_feed, run_options)
+                return self._sess.run(output_names, input_feed, run_options, outputs)
+            raise
+
+    def run_many(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions of several requests with a single call.
+
+        The inputs of all requests are converted first, then the requests run without holding the GIL
+        and their results are converted together, which saves most of the per-request Python overhead
+        of calling :meth:`run` for each of them. When dynamic batching is enabled with the session config
+        entry ``session.dynamic_batching_max_batch_size``, compatible requests are merged into batches.
+
+        :param output_names: name of the outputs
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }`` that all feed the same inputs
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: list with the list of results of every request, see :meth:`run`.
+
+        ::
+
+            sess.run_many([output_name], [{input_name: x1}, {input_name: x2}])
+        """
+        if input_feeds:
+            self._validate_input(list(input_feeds[0].keys()))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        try:
+            return self._sess.run_many(output_names, input_feeds, run_options)
+        except C.EPFail as err:
+            if self._enable_fallback:
+                print(f"EP Error: {err!s} using {self._providers}")
+                print(f"Falling back to {self._fallback_providers} and retrying.")
+                self.set_providers(self._fallback_providers)
+                # Fallback only once.
+                self.disable_fallback()
+                return self._sess.run_many(output_names, input_feeds, run_options)
             raise
 
     def run_async(self, output_names, input_feed, callback, user_data, run_options=None):
@@ -816,6 +858,28 @@ class OrtValue:
         """
         self._ortvalue.update_inplace(np_arr)
 
+    def __dlpack__(self, stream=None):
+        """
+        Returns a DLPack capsule sharing the tensor's memory (part of the DLPack protocol).
+        Only available in builds with DLPack support.
+        """
+        return self._ortvalue.__dlpack__(stream)
+
+    def __dlpack_device__(self):
+        """
+        Returns a tuple of integers, (device type, device index) (part of the DLPack protocol).
+        Only available in builds with DLPack support.
+        """
+        return self._ortvalue.__dlpack_device__()
+
+    @property
+    def __cuda_array_interface__(self):
+        """
+        Describes the CUDA memory of a tensor located on a CUDA device so that libraries such as CuPy,
+        Numba or PyTorch can use it without a copy. Only available in CUDA builds.
+        """
+        return self._ortvalue.__cuda_array_interface__
+
 
 class OrtDevice:
     """
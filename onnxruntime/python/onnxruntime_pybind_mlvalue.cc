@@ -950,6 +950,94 @@ static void CreateGenericIterableMLValue(PyObject* iterator, AllocatorPtr alloc,
   }
 }
 
+#ifdef USE_CUDA
+// Wraps the device memory of an object exporting __cuda_array_interface__ (CuPy, Numba, PyTorch, ...) without a copy.
+// The object is kept alive until the OrtValue is released.
+static void CreateTensorMLValueFromCudaArrayInterface(const std::string& name_input, const py::object& value,
+                                                      OrtValue* p_mlvalue) {
+  py::dict array_interface = value.attr("__cuda_array_interface__").cast<py::dict>();
+
+  py::dtype dtype(array_interface["typestr"].cast<std::string>());
+  MLDataType element_type = NumpyTypeToOnnxRuntimeTensorType(dtype.num());
+
+  TensorShapeVector dims;
+  for (const auto& dim : array_interface["shape"].cast<py::tuple>()) {
+    dims.push_back(dim.cast<int64_t>());
+  }
+
+  if (array_interface.contains("strides") && !array_interface["strides"].is_none()) {
+    // Only C-contiguous layouts can be wrapped, they may still be described with explicit strides.
+    auto strides = array_interface["strides"].cast<py::tuple>();
+    int64_t expected_stride = dtype.itemsize();
+    for (size_t i = dims.size(); i > 0; --i) {
+      if (dims[i - 1] != 1 && strides[i - 1].cast<int64_t>() != expected_stride) {
+        throw std::runtime_error("Input '" + name_input + "' exported through __cuda_array_interface__ must be C-contiguous.");
+      }
+      expected_stride *= dims[i - 1];
+    }
+  }
+
+  if (array_interface.contains("mask") && !array_interface["mask"].is_none()) {
+    throw std::runtime_error("Input '" + name_input + "' exported through __cuda_array_interface__ must not be masked.");
+  }
+
+  auto data = array_interface["data"].cast<py::tuple>();
+  void* data_ptr = reinterpret_cast<void*>(data[0].cast<uintptr_t>());
+
+  // The producer may still be writing the data on the stream it exported (1 is the legacy default stream,
+  // 2 the per-thread default stream), wait for it since the session runs on its own streams.
+  if (array_interface.contains("stream") && !array_interface["stream"].is_none()) {
+    GetProviderInfo_CUDA().cudaStreamSynchronize(reinterpret_cast<void*>(array_interface["stream"].cast<uintptr_t>()));
+  }
+
+  // Empty tensors may have a null pointer.
+  int device_id = 0;
+  if (data_ptr != nullptr) {
+    device_id = GetProviderInfo_CUDA().cudaPointerGetDevice(data_ptr);
+  }
+
+  auto p_tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), data_ptr,
+                                           GetCudaAllocator(static_cast<OrtDevice::DeviceId>(device_id))->Info());
+
+  PyObject* owner = value.ptr();
+  Py_INCREF(owner);
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  p_mlvalue->Init(p_tensor.release(), ml_tensor, [owner](void* p) {
+    delete static_cast<Tensor*>(p);
+    // The OrtValue may be released by a thread that does not hold the GIL.
+    py::gil_scoped_acquire gil;
+    Py_DECREF(owner);
+  });
+}
+#endif
+
+#ifdef ENABLE_DLPACK
+// Consumes the DLPack capsule exported by an object implementing __dlpack__ without a copy.
+static void CreateTensorMLValueFromDlpack(const InputDefList* input_def_list, const std::string& name_input,
+                                          const py::object& value, OrtValue* p_mlvalue) {
+  // DLPack does not distinguish bool from uint8, use the type of the input.
+  onnx::TypeProto type_proto;
+  CheckIfInputIsSequenceType(name_input, input_def_list, type_proto);
+  const bool is_bool_tensor = type_proto.has_tensor_type() &&
+                              type_proto.tensor_type().elem_type() == onnx::TensorProto_DataType_BOOL;
+
+  py::object capsule;
+  auto device = value.attr("__dlpack_device__")().cast<py::tuple>();
+  if (device[0].cast<int>() == static_cast<int>(DLDeviceType::kDLCUDA)) {
+    // Asks the producer to order its pending work before the legacy default stream, then waits for that stream
+    // since the session runs on its own streams.
+    capsule = value.attr("__dlpack__")(py::arg("stream") = 1);
+#ifdef USE_CUDA
+    GetProviderInfo_CUDA().cudaStreamSynchronize(reinterpret_cast<void*>(uintptr_t{1}));
+#endif
+  } else {
+    capsule = value.attr("__dlpack__")();
+  }
+
+  *p_mlvalue = FromDlpack(capsule.ptr(), is_bool_tensor);
+}
+#endif
+
 // Setting `use_numpy_data_memory` to `true` will ensure that the underlying numpy array buffer is directly used
 // as the backing data buffer for the ORT Tensor where applicable (for numeric tensors)
 // The numpy object owns the memory and needs to be alive until the corresponding OrtValue is in scope
@@ -1001,6 +1089,14 @@ void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, const
     // This should just increase the ref counts of the underlying shared_ptrs in the native OrtValue
     // and the ref count will be decreased when the OrtValue used for Run() is destroyed upon exit.
     *p_mlvalue = *value.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+#ifdef USE_CUDA
+  } else if (!accept_only_numpy_array && py::hasattr(value, "__cuda_array_interface__")) {
+    CreateTensorMLValueFromCudaArrayInterface(name_input, value, p_mlvalue);
+#endif
+#ifdef ENABLE_DLPACK
+  } else if (!accept_only_numpy_array && py::hasattr(value, "__dlpack__") && py::hasattr(value, "__dlpack_device__")) {
+    CreateTensorMLValueFromDlpack(input_def_list, name_input, value, p_mlvalue);
+#endif
   } else if (!accept_only_numpy_array) {
     auto iterator = PyObject_GetIter(value.ptr());
     if (iterator == NULL) {
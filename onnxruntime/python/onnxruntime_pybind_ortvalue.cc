@@ -15,7 +15,7 @@
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 #include "core/framework/TensorSeq.h"
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
 #include "core/dlpack/dlpack_converter.h"
 #endif
 
@@ -317,7 +317,7 @@ void addOrtValueMethods(pybind11::module& m) {
 #endif
         return obj;
       })
-#ifdef ENABLE_TRAINING
+#ifdef ENABLE_DLPACK
       .def(
           "to_dlpack", [](OrtValue* ort_value) -> py::object {
             return py::reinterpret_steal<py::object>(ToDlpack(*ort_value));
@@ -346,6 +346,33 @@ void addOrtValueMethods(pybind11::module& m) {
             return py::make_tuple(static_cast<int>(device.device_type), device.device_id);
           },
           "Returns a tuple of integers, (device, device index) (part of __dlpack__ protocol).")
+#endif
+#ifdef USE_CUDA
+      .def_property_readonly(
+          "__cuda_array_interface__", [](const OrtValue* ort_value) -> py::dict {
+            if (!ort_value->IsTensor() || ort_value->Get<Tensor>().Location().device.Type() != OrtDevice::GPU) {
+              throw py::attribute_error("__cuda_array_interface__ is only available for tensors located on a CUDA device");
+            }
+            const Tensor& tensor = ort_value->Get<Tensor>();
+            ORT_ENFORCE(!tensor.IsDataTypeString(), "String tensors are not supported");
+
+            py::list shape;
+            for (auto dim : tensor.Shape().GetDims()) {
+              shape.append(dim);
+            }
+
+            py::dict array_interface;
+            array_interface["version"] = 3;
+            array_interface["shape"] = py::tuple(shape);
+            array_interface["typestr"] = py::dtype(OnnxRuntimeTensorToNumpyType(tensor.DataType())).attr("str");
+            array_interface["data"] = py::make_tuple(reinterpret_cast<uintptr_t>(tensor.DataRaw()), false);
+            array_interface["strides"] = py::none();
+            // Run() synchronizes its streams before returning, the data can be consumed on any stream.
+            array_interface["stream"] = py::none();
+            return array_interface;
+          },
+          "Describes the CUDA memory of the tensor (CUDA Array Interface version 3) so that libraries such as "
+          "CuPy, Numba or PyTorch can use it without a copy. The OrtValue must persist while the data is in use.")
 #endif
       ;
 
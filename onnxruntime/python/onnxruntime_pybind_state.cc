@@ -14,6 +14,7 @@
 #include "core/common/logging/severity.h"
 #include "core/common/narrow.h"
 #include "core/common/optional.h"
+#include "core/common/parse_string.h"
 #include "core/common/path_string.h"
 #include "core/framework/arena_extend_strategy.h"
 #include "core/framework/data_transfer_utils.h"
@@ -134,7 +135,7 @@ void AsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtS
       const auto& fet = *outputs[ith];
       if (fet.IsAllocated()) {
         if (fet.IsTensor()) {
-          rfetch.push_back(AddTensorAsPyObj(fet, nullptr, nullptr));
+          rfetch.push_back(AddTensorAsPyObjNoCopy(fet, nullptr, nullptr));
         } else if (fet.IsSparseTensor()) {
           rfetch.push_back(GetPyObjectFromSparseTensor(pos, fet, nullptr));
         } else {
@@ -304,6 +305,48 @@ py::object AddNonTensor<TensorSeq>(const OrtValue& val,
   return py::cast<py::object>(py_list);
 }
 
+#if !defined(DISABLE_ML_OPS)
+// The maps of a sequence, like the output of ZipMap, usually have the same keys. The Python objects of the keys are
+// created once and shared by the dicts, which also saves hashing them again for each dict.
+template <typename TKey>
+static py::object SequenceOfMapsToPyList(const std::vector<std::map<TKey, float>>& maps) {
+  py::list py_list(maps.size());
+  std::vector<std::pair<TKey, py::object>> keys;  // keys of the previous map, in order
+  for (size_t i = 0; i < maps.size(); ++i) {
+    py::dict py_dict;
+    size_t j = 0;
+    for (const auto& [key, value] : maps[i]) {
+      if (j == keys.size()) {
+        keys.emplace_back(key, py::cast(key));
+      } else if (keys[j].first != key) {
+        keys[j] = {key, py::cast(key)};
+      }
+
+      py_dict[keys[j].second] = py::float_(value);
+      ++j;
+    }
+
+    py_list[i] = std::move(py_dict);
+  }
+
+  return py_list;
+}
+
+template <>
+py::object AddNonTensor<VectorMapStringToFloat>(const OrtValue& val,
+                                                const DataTransferManager* /*data_transfer_manager*/,
+                                                const std::unordered_map<OrtDevice::DeviceType, MemCpyFunc>* /*mem_cpy_to_host_functions*/) {
+  return SequenceOfMapsToPyList(val.Get<VectorMapStringToFloat>());
+}
+
+template <>
+py::object AddNonTensor<VectorMapInt64ToFloat>(const OrtValue& val,
+                                               const DataTransferManager* /*data_transfer_manager*/,
+                                               const std::unordered_map<OrtDevice::DeviceType, MemCpyFunc>* /*mem_cpy_to_host_functions*/) {
+  return SequenceOfMapsToPyList(val.Get<VectorMapInt64ToFloat>());
+}
+#endif  // !defined(DISABLE_ML_OPS)
+
 py::object AddNonTensorAsPyObj(const OrtValue& val,
                                const DataTransferManager* data_transfer_manager,
                                const std::unordered_map<OrtDevice::DeviceType, MemCpyFunc>* mem_cpy_to_host_functions) {
@@ -353,6 +396,55 @@ py::object AddTensorAsPyObj(const OrtValue& val, const DataTransferManager* data
   return obj;
 }
 
+py::object AddTensorAsPyObjNoCopy(const OrtValue& val, const DataTransferManager* data_transfer_manager,
+                                  const std::unordered_map<OrtDevice::DeviceType, MemCpyFunc>* mem_cpy_to_host_functions) {
+  const Tensor& rtensor = val.Get<Tensor>();
+  // A tensor that does not own its buffer may refer to the memory of an input numpy array or of an initializer,
+  // which must not be aliased by the output.
+  if (rtensor.Location().device.Type() != OrtDevice::CPU || rtensor.IsDataTypeString() || !rtensor.OwnsBuffer()) {
+    return AddTensorAsPyObj(val, data_transfer_manager, mem_cpy_to_host_functions);
+  }
+
+  std::vector<npy_intp> npy_dims;
+  const TensorShape& shape = rtensor.Shape();
+  for (size_t n = 0; n < shape.NumDimensions(); ++n) {
+    npy_dims.push_back(shape[n]);
+  }
+
+  // the capsule owns a copy of the OrtValue, which shares the tensor and thereby its buffer
+  py::capsule base(new OrtValue(val), [](void* ort_value) { delete static_cast<OrtValue*>(ort_value); });
+  auto obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+      narrow<int>(shape.NumDimensions()), npy_dims.data(), OnnxRuntimeTensorToNumpyType(rtensor.DataType()),
+      const_cast<void*>(rtensor.DataRaw())));
+  if (!obj) {
+    throw py::error_already_set();
+  }
+
+  // PyArray_SetBaseObject steals the reference to the capsule
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), base.release().ptr()) != 0) {
+    throw py::error_already_set();
+  }
+  return obj;
+}
+
+// Wraps the memory of a pre-allocated numpy array, so that the output is written into it by Run.
+static OrtValue CreateOutputMLValueFromNumpy(const std::string& name, const py::object& obj) {
+  if (!IsNumericNumpyArray(obj)) {
+    throw std::runtime_error("Pre-allocated output '" + name + "' must be a numeric numpy array.");
+  }
+
+  auto* darray = reinterpret_cast<PyArrayObject*>(obj.ptr());
+  if (!PyArray_ISCARRAY(darray)) {
+    throw std::runtime_error("Pre-allocated output '" + name + "' must be a C-contiguous, aligned and writeable "
+                             "numpy array.");
+  }
+
+  OrtValue ml_value;
+  Tensor::InitOrtValue(NumpyTypeToOnnxRuntimeTensorType(PyArray_TYPE(darray)), GetShape(py::cast<py::array>(obj)),
+                       PyArray_DATA(darray), GetAllocator()->Info(), ml_value);
+  return ml_value;
+}
+
 static std::unique_ptr<onnxruntime::IExecutionProvider> LoadExecutionProvider(
     const std::string& ep_shared_lib_path,
     const ProviderOptions& provider_options = {},
@@ -741,6 +833,22 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
             } else {
               ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_ep_context_embed_mode' should be a positive integer number i.e. '1'.\n");
             }
+          } else if (option.first == "trt_profile_shape_bucketing") {
+            if (option.second == "True" || option.second == "true") {
+              params.trt_profile_shape_bucketing = true;
+            } else if (option.second == "False" || option.second == "false") {
+              params.trt_profile_shape_bucketing = false;
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_profile_shape_bucketing' should be 'True' or 'False'. Default value is 'False'.\n");
+            }
+          } else if (option.first == "trt_share_initializers_enable") {
+            if (option.second == "True" || option.second == "true") {
+              params.trt_share_initializers_enable = true;
+            } else if (option.second == "False" || option.second == "false") {
+              params.trt_share_initializers_enable = false;
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_share_initializers_enable' should be 'True' or 'False'. Default value is 'False'.\n");
+            }
           } else {
             ORT_THROW("Invalid TensorRT EP option: ", option.first);
           }
@@ -1017,7 +1125,13 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
 #endif
     const auto partitioning_stop_ops_list = session_options.config_options.GetConfigEntry(
         kOrtSessionOptionsConfigNnapiEpPartitioningStopOps);
-    return onnxruntime::NnapiProviderFactoryCreator::Create(0, partitioning_stop_ops_list)->CreateProvider();
+    const auto compilation_cache_dir = session_options.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigNnapiEpCompilationCacheDir, "");
+    const auto min_partition_size = ParseStringWithClassicLocale<size_t>(
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNnapiEpMinPartitionSize, "0"));
+    return onnxruntime::NnapiProviderFactoryCreator::Create(0, partitioning_stop_ops_list, compilation_cache_dir,
+                                                            min_partition_size)
+        ->CreateProvider();
 #endif
   } else if (type == kRknpuExecutionProvider) {
 #ifdef USE_RKNPU
@@ -1028,7 +1142,10 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
 #if !defined(__APPLE__)
     LOGS_DEFAULT(WARNING) << "CoreML execution provider can only be used to generate ORT format model in this build.";
 #endif
-    return onnxruntime::CoreMLProviderFactoryCreator::Create(0)->CreateProvider();
+    auto cit = provider_options_map.find(type);
+    return onnxruntime::CoreMLProviderFactoryCreator::Create(
+               cit == provider_options_map.end() ? ProviderOptions{} : cit->second)
+        ->CreateProvider();
 #endif
   } else if (type == kXnnpackExecutionProvider) {
 #if defined(USE_XNNPACK)
@@ -1407,6 +1524,12 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "max_cached_chunk_size_bytes") {
+            ort_arena_cfg->max_cached_chunk_size_bytes = kvp.second.cast<int>();
+          } else if (key == "use_huge_pages") {
+            ort_arena_cfg->use_huge_pages = kvp.second.cast<int>();
+          } else if (key == "prefault_memory") {
+            ort_arena_cfg->prefault_memory = kvp.second.cast<int>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1418,7 +1541,10 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("max_cached_chunk_size_bytes", &OrtArenaCfg::max_cached_chunk_size_bytes)
+      .def_readwrite("use_huge_pages", &OrtArenaCfg::use_huge_pages)
+      .def_readwrite("prefault_memory", &OrtArenaCfg::prefault_memory);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
@@ -1834,8 +1960,8 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           R"pbdoc(Load a model saved in ONNX or ORT format.)pbdoc")
       .def("run",
            [](PyInferenceSession* sess, std::vector<std::string> output_names,
-              std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr)
-               -> std::vector<py::object> {
+              std::map<std::string, py::object> pyfeeds, RunOptions* run_options,
+              const std::vector<py::object>& pyoutputs) -> std::vector<py::object> {
              NameMLValMap feeds;
              for (auto feed : pyfeeds) {
                // No need to process 'None's sent in by the user
@@ -1857,6 +1983,21 @@ including arg name, arg type (contains both type and shape).)pbdoc")
              std::vector<OrtValue> fetches;
              common::Status status;
 
+             // Pre-allocated outputs are written in place, None lets Run allocate the output.
+             if (!pyoutputs.empty()) {
+               if (pyoutputs.size() != output_names.size()) {
+                 throw std::runtime_error("The number of pre-allocated outputs (" + std::to_string(pyoutputs.size()) +
+                                          ") does not match the number of output names (" +
+                                          std::to_string(output_names.size()) + ").");
+               }
+               fetches.resize(output_names.size());
+               for (size_t i = 0; i < pyoutputs.size(); ++i) {
+                 if (!pyoutputs[i].is_none()) {
+                   fetches[i] = CreateOutputMLValueFromNumpy(output_names[i], pyoutputs[i]);
+                 }
+               }
+             }
+
              {
                // release GIL to allow multiple python threads to invoke Run() in parallel.
                py::gil_scoped_release release;
@@ -1872,8 +2013,12 @@ including arg name, arg type (contains both type and shape).)pbdoc")
              size_t pos = 0;
              for (auto fet : fetches) {
                if (fet.IsAllocated()) {
-                 if (fet.IsTensor()) {
-                   rfetch.push_back(AddTensorAsPyObj(fet, nullptr, nullptr));
+                 if (fet.IsTensor() && pos < pyoutputs.size() && !pyoutputs[pos].is_none() &&
+                     fet.Get<Tensor>().DataRaw() ==
+                         PyArray_DATA(reinterpret_cast<PyArrayObject*>(pyoutputs[pos].ptr()))) {
+                   rfetch.push_back(pyoutputs[pos]);
+                 } else if (fet.IsTensor()) {
+                   rfetch.push_back(AddTensorAsPyObjNoCopy(fet, nullptr, nullptr));
                  } else if (fet.IsSparseTensor()) {
                    rfetch.push_back(GetPyObjectFromSparseTensor(pos, fet, nullptr));
                  } else {
@@ -1885,7 +2030,81 @@ including arg name, arg type (contains both type and shape).)pbdoc")
                ++pos;
              }
              return rfetch;
-           })
+           },
+           py::arg("output_names"), py::arg("input_feed"), py::arg("run_options") = nullptr,
+           py::arg("outputs") = std::vector<py::object>{})
+      .def("run_many",
+           [](PyInferenceSession* sess, std::vector<std::string> output_names,
+              const std::vector<py::dict>& pyfeeds_list, RunOptions* run_options) -> std::vector<std::vector<py::object>> {
+             auto px = sess->GetSessionHandle()->GetModelInputs();
+             if (!px.first.IsOK() || !px.second) {
+               throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+             }
+
+             // All requests feed the inputs of the first one, 'None's are left out as in run().
+             std::vector<std::string> feed_names;
+             if (!pyfeeds_list.empty()) {
+               for (auto feed : pyfeeds_list.front()) {
+                 if (!feed.second.is_none()) {
+                   feed_names.push_back(feed.first.cast<std::string>());
+                 }
+               }
+             }
+
+             std::vector<std::vector<OrtValue>> feeds(pyfeeds_list.size());
+             for (size_t i = 0; i < pyfeeds_list.size(); ++i) {
+               const py::dict& pyfeeds = pyfeeds_list[i];
+               size_t num_feeds = 0;
+               for (auto feed : pyfeeds) {
+                 num_feeds += feed.second.is_none() ? 0 : 1;
+               }
+               if (num_feeds != feed_names.size()) {
+                 throw std::runtime_error("Input feed " + std::to_string(i) + " does not feed the same inputs as the first one.");
+               }
+
+               feeds[i].resize(feed_names.size());
+               for (size_t j = 0; j < feed_names.size(); ++j) {
+                 const char* name = feed_names[j].c_str();
+                 if (!pyfeeds.contains(name) || pyfeeds[name].is_none()) {
+                   throw std::runtime_error("Input feed " + std::to_string(i) + " does not feed the same inputs as the first one.");
+                 }
+                 CreateGenericMLValue(px.second, GetAllocator(), feed_names[j], pyfeeds[name], &feeds[i][j]);
+                 ThrowIfPyErrOccured();
+               }
+             }
+
+             std::vector<std::vector<OrtValue>> fetches(feeds.size());
+             RunOptions default_run_options;
+             {
+               // release GIL once for all requests to allow multiple python threads to invoke Run() in parallel.
+               py::gil_scoped_release release;
+               OrtPybindThrowIfError(sess->GetSessionHandle()->RunMany(
+                   run_options != nullptr ? *run_options : default_run_options, feed_names, feeds, output_names, fetches));
+             }
+
+             std::vector<std::vector<py::object>> rfetches;
+             rfetches.reserve(fetches.size());
+             for (const auto& request_fetches : fetches) {
+               std::vector<py::object> rfetch;
+               rfetch.reserve(request_fetches.size());
+               size_t pos = 0;
+               for (const auto& fet : request_fetches) {
+                 if (!fet.IsAllocated()) {
+                   rfetch.push_back(py::none());
+                 } else if (fet.IsTensor()) {
+                   rfetch.push_back(AddTensorAsPyObjNoCopy(fet, nullptr, nullptr));
+                 } else if (fet.IsSparseTensor()) {
+                   rfetch.push_back(GetPyObjectFromSparseTensor(pos, fet, nullptr));
+                 } else {
+                   rfetch.push_back(AddNonTensorAsPyObj(fet, nullptr, nullptr));
+                 }
+                 ++pos;
+               }
+               rfetches.push_back(std::move(rfetch));
+             }
+             return rfetches;
+           },
+           py::arg("output_names"), py::arg("input_feeds"), py::arg("run_options") = nullptr)
       .def("run_async",
            [](PyInferenceSession* sess,
               std::vector<std::string> output_names,
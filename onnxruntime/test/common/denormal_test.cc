@@ -35,5 +35,32 @@ TEST(DenormalTest, DenormalAsZeroTest) {
   test_denormal(false);
 }
 
+TEST(DenormalTest, DenormalAsZeroScopeTest) {
+  constexpr float denormal_float = 1e-38f;
+  volatile float input_float = denormal_float;
+
+  // When it returns false, denormal as zero isn't supported, so validation will be skipped
+  if (!SetDenormalAsZero(false)) {
+    return;
+  }
+
+  {
+    DenormalAsZeroScope scope(true);
+    EXPECT_EQ(input_float * 2, 0.0f);
+    {
+      DenormalAsZeroScope inner_scope(true);
+      EXPECT_EQ(input_float * 2, 0.0f);
+    }
+    // the inner scope found the mode set and leaves it set
+    EXPECT_EQ(input_float * 2, 0.0f);
+  }
+  EXPECT_EQ(input_float * 2, denormal_float * 2);
+
+  {
+    DenormalAsZeroScope scope(false);
+    EXPECT_EQ(input_float * 2, denormal_float * 2);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "contrib_ops/cpu/transformers/sequences.h"
 #include "test/common/cuda_op_test_utils.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
@@ -13,6 +14,41 @@ extern std::unique_ptr<Ort::Env> ort_env;
 namespace onnxruntime {
 namespace test {
 
+TEST(BeamSearchTest, SequencesFollowBeamIndices) {
+  constexpr int batch_beam_size = 2;
+  constexpr int sequence_length = 2;
+  constexpr int max_length = 6;
+  std::vector<int32_t> buffer(2 * batch_beam_size * max_length, 0);
+  buffer[0] = 1;
+  buffer[1] = 2;
+  buffer[max_length] = 3;
+  buffer[max_length + 1] = 4;
+
+  contrib::transformers::Sequences sequences;
+  sequences.Init(buffer, batch_beam_size, sequence_length, max_length);
+
+  auto append = [&sequences](std::vector<int32_t> beam_indices, std::vector<int32_t> next_tokens) {
+    gsl::span<int32_t> beam_indices_span(beam_indices);
+    gsl::span<int32_t> next_tokens_span(next_tokens);
+    sequences.AppendNextTokenToSequences(beam_indices_span, next_tokens_span);
+  };
+  auto sequence = [&sequences](int beam_index) {
+    auto span = sequences.GetSequence(beam_index);
+    return std::vector<int32_t>(span.begin(), span.end());
+  };
+
+  // two steps are appended before the sequences are read
+  append({1, 0}, {5, 6});
+  append({1, 1}, {7, 8});
+  EXPECT_EQ(sequences.GetSequenceLength(), 4);
+  EXPECT_EQ(sequence(0), (std::vector<int32_t>{1, 2, 6, 7}));
+  EXPECT_EQ(sequence(1), (std::vector<int32_t>{1, 2, 6, 8}));
+
+  append({0, 1}, {9, 10});
+  EXPECT_EQ(sequence(0), (std::vector<int32_t>{1, 2, 6, 7, 9}));
+  EXPECT_EQ(sequence(1), (std::vector<int32_t>{1, 2, 6, 8, 10}));
+}
+
 TEST(BeamSearchTest, GptBeamSearchFp32) {
   std::vector<int64_t> input_ids_shape{3, 12};
   std::vector<int32_t> input_ids{
@@ -132,7 +132,20 @@ class BiasSoftmaxTester {
   }
 
   void RunComparison() {
-    // BiasSoftmax only implemented for cuda architecture
+    // the CPU kernel supports only float
+    if (!use_float16_) {
+      OpTester tester("BiasSoftmax", 1, onnxruntime::kMSDomain);
+      tester.AddAttribute<int64_t>("axis", axis_);
+      tester.AddAttribute<int64_t>("is_inner_broadcast", is_inner_broadcast_);
+      tester.AddInput<float>("data", in_shape_, in_data_);
+      tester.AddInput<float>("bias", bias_shape_, bias_data_);
+      tester.AddOutput<float>("output", in_shape_, out_data_);
+
+      std::vector<std::unique_ptr<IExecutionProvider>> ep;
+      ep.push_back(DefaultCpuExecutionProvider());
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &ep);
+    }
+
     int min_cuda_architecture = use_float16_ ? 530 : 0;
     if (HasCudaEnvironment(min_cuda_architecture) || kGpuExecutionProvider == kRocmExecutionProvider) {
       OpTester tester("BiasSoftmax", 1, onnxruntime::kMSDomain);
@@ -74,21 +74,20 @@ std::vector<float> GetExpectedResult(const std::vector<float>& input_data,
 }
 }  // namespace bias_split_gelu_test
 
-#if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
-
-static void RunBiasSplitGeluGpuTest(const std::vector<float>& input_data,
-                                    const std::vector<float>& bias_data,
-                                    const std::vector<float>& output_data,
-                                    const std::vector<int64_t>& input_dims,
-                                    const std::vector<int64_t>& bias_dims,
-                                    const std::vector<int64_t>& output_dims,
-                                    bool use_float16 = false) {
+static void RunBiasSplitGeluKernelTest(const std::vector<float>& input_data,
+                                       const std::vector<float>& bias_data,
+                                       const std::vector<float>& output_data,
+                                       const std::vector<int64_t>& input_dims,
+                                       const std::vector<int64_t>& bias_dims,
+                                       const std::vector<int64_t>& output_dims,
+                                       bool use_float16 = false) {
   int min_cuda_architecture = use_float16 ? 530 : 0;
   bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
   bool enable_rocm = (nullptr != DefaultRocmExecutionProvider().get());
   bool enable_dml = (nullptr != DefaultDmlExecutionProvider().get());
 
-  if (!enable_cuda && !enable_rocm && !enable_dml) {
+  // The CPU kernel supports float only.
+  if (use_float16 && !enable_cuda && !enable_rocm && !enable_dml) {
     return;
   }
 
@@ -105,6 +104,9 @@ static void RunBiasSplitGeluGpuTest(const std::vector<float>& input_data,
   }
 
   std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  if (!use_float16) {
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+  }
   if (enable_cuda) {
     execution_providers.push_back(DefaultCudaExecutionProvider());
   }
@@ -128,7 +130,7 @@ static void RunBiasSplitGeluTest(int64_t batch_size, int64_t sequence_length, in
   std::vector<float> bias_data = random.Gaussian<float>(bias_dims, 0.0f, 0.3f);
   std::vector<float> output_data = bias_split_gelu_test::GetExpectedResult(input_data, input_dims, bias_data);
 
-  RunBiasSplitGeluGpuTest(input_data, bias_data, output_data, input_dims, bias_dims, output_dims);
+  RunBiasSplitGeluKernelTest(input_data, bias_data, output_data, input_dims, bias_dims, output_dims);
 }
 
 TEST(BiasSplitGeluTest, BiasSplitGeluTest_HiddenSize_2560) {
@@ -166,7 +168,5 @@ TEST(BiasSplitGeluTest, BiasSplitGeluTest_HiddenSize_12288) {
   RunBiasSplitGeluTest(batch_size, sequence_length, hidden_size);
 }
 
-#endif
-
 }  // namespace test
 }  // namespace onnxruntime
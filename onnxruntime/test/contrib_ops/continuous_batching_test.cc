@@ -0,0 +1,319 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/continuous_batching.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::ContinuousBatchingGpt;
+using contrib::transformers::ContinuousBatchingOptions;
+using contrib::transformers::GenerationRequest;
+using contrib::transformers::GenerationResult;
+using contrib::transformers::PrefixKVCache;
+
+namespace {
+
+constexpr int kNumLayers = 2;
+constexpr int kNumHeads = 2;
+constexpr int kHeadSize = 3;
+constexpr int kVocabSize = 11;
+constexpr int kEosTokenId = 0;
+
+// A fake GPT decoder. The present state stores (token + 1, position) of every token. The next token is a hash of
+// the present state visible through the attention mask, so wrong padding or a wrong past gives another sequence.
+class FakeDecoder {
+ public:
+  explicit FakeDecoder(AllocatorPtr allocator) : allocator_(std::move(allocator)) {}
+
+  Status Run(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+    ORT_RETURN_IF_NOT(feeds.size() == 3 + kNumLayers, "unexpected number of feeds");
+    const Tensor& input_ids = feeds[0].Get<Tensor>();
+    const Tensor& position_ids = feeds[1].Get<Tensor>();
+    const Tensor& attention_mask = feeds[2].Get<Tensor>();
+    const int64_t batch_size = input_ids.Shape()[0];
+    const int64_t sequence_length = input_ids.Shape()[1];
+    const int64_t total_length = attention_mask.Shape()[1];
+    const int64_t past_length = total_length - sequence_length;
+    ORT_RETURN_IF_NOT(position_ids.Shape() == input_ids.Shape(), "position_ids shape mismatch");
+    max_batch_size_seen_ = std::max(max_batch_size_seen_, batch_size);
+    tokens_run_ += batch_size * sequence_length;
+    max_sequence_length_seen_ = std::max(max_sequence_length_seen_, sequence_length);
+
+    fetches.clear();
+    OrtValue logits;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({batch_size, sequence_length, kVocabSize}),
+                         allocator_, logits);
+    fetches.push_back(logits);
+
+    for (int layer = 0; layer < kNumLayers; layer++) {
+      const Tensor& past = feeds[3 + layer].Get<Tensor>();
+      ORT_RETURN_IF_NOT(past.Shape() == TensorShape({2, batch_size, kNumHeads, past_length, kHeadSize}),
+                        "past shape mismatch");
+      OrtValue present;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<float>(),
+                           TensorShape({2, batch_size, kNumHeads, total_length, kHeadSize}), allocator_, present);
+      const float* past_data = past.Data<float>();
+      float* present_data = present.GetMutable<Tensor>()->MutableData<float>();
+      for (int64_t i = 0; i < 2 * batch_size * kNumHeads; i++) {
+        const int64_t b = (i / kNumHeads) % batch_size;
+        float* dest = present_data + i * total_length * kHeadSize;
+        std::copy(past_data + i * past_length * kHeadSize, past_data + (i + 1) * past_length * kHeadSize, dest);
+        for (int64_t s = 0; s < sequence_length; s++) {
+          for (int h = 0; h < kHeadSize; h++) {
+            dest[(past_length + s) * kHeadSize + h] =
+                static_cast<float>(h == 0 ? input_ids.Data<int32_t>()[b * sequence_length + s] + 1
+                                          : position_ids.Data<int32_t>()[b * sequence_length + s] + layer);
+          }
+        }
+      }
+      fetches.push_back(present);
+    }
+
+    // Logits are computed from the present state of the last layer.
+    const float* present_data = fetches.back().Get<Tensor>().Data<float>();
+    float* logits_data = fetches[0].GetMutable<Tensor>()->MutableData<float>();
+    const int32_t* mask = attention_mask.Data<int32_t>();
+    for (int64_t b = 0; b < batch_size; b++) {
+      for (int64_t s = 0; s < sequence_length; s++) {
+        int64_t hash = 0;
+        for (int64_t t = 0; t <= past_length + s; t++) {
+          if (mask[b * total_length + t] == 0) {
+            continue;
+          }
+          const float* row = present_data + (b * kNumHeads * total_length + t) * kHeadSize;
+          hash = hash * 31 + static_cast<int64_t>(row[0]) * 7 + static_cast<int64_t>(row[1]);
+          hash %= 1000003;
+        }
+        float* scores = logits_data + (b * sequence_length + s) * kVocabSize;
+        for (int v = 0; v < kVocabSize; v++) {
+          scores[v] = static_cast<float>((hash + v * 5) % kVocabSize);
+        }
+      }
+    }
+    return Status::OK();
+  }
+
+  int64_t MaxBatchSizeSeen() const { return max_batch_size_seen_; }
+  int64_t TokensRun() const { return tokens_run_; }
+  int64_t MaxSequenceLengthSeen() const { return max_sequence_length_seen_; }
+
+ private:
+  AllocatorPtr allocator_;
+  int64_t max_batch_size_seen_ = 0;
+  int64_t tokens_run_ = 0;
+  int64_t max_sequence_length_seen_ = 0;
+};
+
+ContinuousBatchingOptions GetOptions(int max_batch_size) {
+  ContinuousBatchingOptions options;
+  options.max_batch_size = max_batch_size;
+  options.num_layers = kNumLayers;
+  options.num_heads = kNumHeads;
+  options.head_size = kHeadSize;
+  options.vocab_size = kVocabSize;
+  options.eos_token_id = kEosTokenId;
+  return options;
+}
+
+std::vector<GenerationRequest> GetRequests() {
+  std::vector<GenerationRequest> requests(5);
+  const std::vector<std::vector<int32_t>> prompts = {{3, 5, 7}, {1}, {9, 2, 4, 6, 8}, {10, 10}, {2, 3}};
+  for (size_t i = 0; i < requests.size(); i++) {
+    requests[i].request_id = static_cast<int64_t>(100 + i);
+    requests[i].input_ids = prompts[i];
+    requests[i].max_length = static_cast<int>(prompts[i].size() + 4 + 2 * i);
+  }
+  requests[1].min_length = 6;
+  requests[3].repetition_penalty = 2.0f;
+  return requests;
+}
+
+std::map<int64_t, std::vector<int32_t>> RunAll(int max_batch_size,
+                                               const std::vector<GenerationRequest>& requests,
+                                               FakeDecoder& decoder,
+                                               PrefixKVCache* prefix_cache = nullptr,
+                                               int prefill_chunk_size = 0) {
+  ContinuousBatchingOptions options = GetOptions(max_batch_size);
+  options.prefix_cache = prefix_cache;
+  options.prefill_chunk_size = prefill_chunk_size;
+  ContinuousBatchingGpt runtime(options, std::make_shared<CPUAllocator>(),
+                                [&decoder](const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+                                  return decoder.Run(feeds, fetches);
+                                });
+  for (const auto& request : requests) {
+    runtime.AddRequest(request);
+  }
+
+  std::map<int64_t, std::vector<int32_t>> results;
+  while (runtime.HasPendingWork()) {
+    std::vector<GenerationResult> finished;
+    EXPECT_TRUE(runtime.Step(finished).IsOK());
+    EXPECT_LE(runtime.ActiveCount(), max_batch_size);
+    for (auto& result : finished) {
+      EXPECT_EQ(results.count(result.request_id), 0u);
+      results[result.request_id] = std::move(result.sequence);
+    }
+  }
+  return results;
+}
+
+}  // namespace
+
+TEST(ContinuousBatchingTest, BatchedMatchesSequential) {
+  const std::vector<GenerationRequest> requests = GetRequests();
+
+  std::map<int64_t, std::vector<int32_t>> expected;
+  for (const auto& request : requests) {
+    FakeDecoder decoder(std::make_shared<CPUAllocator>());
+    auto result = RunAll(1, {request}, decoder);
+    ASSERT_EQ(result.size(), 1u);
+    expected[request.request_id] = result[request.request_id];
+  }
+
+  FakeDecoder decoder(std::make_shared<CPUAllocator>());
+  auto results = RunAll(3, requests, decoder);
+  EXPECT_EQ(decoder.MaxBatchSizeSeen(), 3);
+  ASSERT_EQ(results.size(), requests.size());
+  for (const auto& request : requests) {
+    EXPECT_EQ(results[request.request_id], expected[request.request_id]) << "request " << request.request_id;
+  }
+}
+
+TEST(ContinuousBatchingTest, StopConditions) {
+  const std::vector<GenerationRequest> requests = GetRequests();
+  FakeDecoder decoder(std::make_shared<CPUAllocator>());
+  auto results = RunAll(2, requests, decoder);
+  ASSERT_EQ(results.size(), requests.size());
+
+  for (const auto& request : requests) {
+    const std::vector<int32_t>& sequence = results[request.request_id];
+    const size_t prompt_length = request.input_ids.size();
+    ASSERT_GT(sequence.size(), prompt_length);
+    ASSERT_LE(sequence.size(), static_cast<size_t>(request.max_length));
+    EXPECT_TRUE(std::equal(request.input_ids.begin(), request.input_ids.end(), sequence.begin()));
+
+    // Generation stops at the first end of sequence token, otherwise at max_length.
+    for (size_t i = prompt_length; i + 1 < sequence.size(); i++) {
+      EXPECT_NE(sequence[i], kEosTokenId);
+    }
+    if (sequence.back() != kEosTokenId) {
+      EXPECT_EQ(sequence.size(), static_cast<size_t>(request.max_length));
+    }
+    if (request.min_length > 0 && sequence.back() == kEosTokenId) {
+      EXPECT_GT(sequence.size(), static_cast<size_t>(request.min_length));
+    }
+  }
+}
+
+TEST(ContinuousBatchingTest, ChunkedPrefill) {
+  std::vector<GenerationRequest> requests = GetRequests();
+  requests[2].input_ids = {9, 2, 4, 6, 8, 1, 3, 5, 7};
+  requests[2].max_length = 14;
+
+  FakeDecoder expected_decoder(std::make_shared<CPUAllocator>());
+  auto expected = RunAll(3, requests, expected_decoder);
+
+  // Long prompts run over several steps while the other sequences keep decoding.
+  FakeDecoder decoder(std::make_shared<CPUAllocator>());
+  auto results = RunAll(3, requests, decoder, nullptr, 2);
+  EXPECT_EQ(decoder.MaxSequenceLengthSeen(), 2);
+  EXPECT_EQ(decoder.TokensRun(), expected_decoder.TokensRun());
+  ASSERT_EQ(results.size(), requests.size());
+  for (const auto& request : requests) {
+    EXPECT_EQ(results[request.request_id], expected[request.request_id]) << "request " << request.request_id;
+  }
+
+  // Chunks start after the cached prefix.
+  PrefixKVCache prefix_cache(1 << 20, 1);
+  RunAll(1, {requests[2]}, decoder, &prefix_cache, 2);
+  FakeDecoder cached_decoder(std::make_shared<CPUAllocator>());
+  results = RunAll(3, requests, cached_decoder, &prefix_cache, 2);
+  EXPECT_LT(cached_decoder.TokensRun(), expected_decoder.TokensRun());
+  for (const auto& request : requests) {
+    EXPECT_EQ(results[request.request_id], expected[request.request_id]) << "request " << request.request_id;
+  }
+}
+
+TEST(ContinuousBatchingTest, PrefixCacheReusesPromptState) {
+  // Prompts sharing a system prompt of 5 tokens, one prompt equal to it and one longer prompt extending another.
+  const std::vector<int32_t> system_prompt = {4, 6, 8, 1, 3};
+  const std::vector<std::vector<int32_t>> suffixes = {{7, 2}, {9}, {}, {7, 2, 5, 5}, {2, 10, 10}};
+  std::vector<GenerationRequest> requests(suffixes.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    requests[i].request_id = static_cast<int64_t>(200 + i);
+    requests[i].input_ids = system_prompt;
+    requests[i].input_ids.insert(requests[i].input_ids.end(), suffixes[i].begin(), suffixes[i].end());
+    requests[i].max_length = static_cast<int>(requests[i].input_ids.size() + 5);
+  }
+
+  FakeDecoder expected_decoder(std::make_shared<CPUAllocator>());
+  auto expected = RunAll(1, requests, expected_decoder);
+
+  PrefixKVCache prefix_cache(1 << 20, 2);
+  FakeDecoder decoder(std::make_shared<CPUAllocator>());
+  auto results = RunAll(1, requests, decoder, &prefix_cache);
+  ASSERT_EQ(results.size(), requests.size());
+  for (const auto& request : requests) {
+    EXPECT_EQ(results[request.request_id], expected[request.request_id]) << "request " << request.request_id;
+  }
+  EXPECT_LT(decoder.TokensRun(), expected_decoder.TokensRun());
+  EXPECT_EQ(prefix_cache.EntryCount(), requests.size());
+
+  // A second run with the same requests finds every prompt in the cache.
+  const size_t hit_count = prefix_cache.HitCount();
+  FakeDecoder cached_decoder(std::make_shared<CPUAllocator>());
+  results = RunAll(2, requests, cached_decoder, &prefix_cache);
+  for (const auto& request : requests) {
+    EXPECT_EQ(results[request.request_id], expected[request.request_id]) << "request " << request.request_id;
+  }
+  EXPECT_LT(cached_decoder.TokensRun(), decoder.TokensRun());
+  EXPECT_EQ(prefix_cache.HitCount(), hit_count + requests.size());
+  EXPECT_EQ(prefix_cache.EntryCount(), requests.size());
+}
+
+TEST(ContinuousBatchingTest, PrefixCacheEvictsLeastRecentlyUsed) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  auto make_present = [&allocator](int64_t length) {
+    OrtValue value;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({2, 1, kNumHeads, length, kHeadSize}),
+                         allocator, value);
+    return std::vector<OrtValue>{value};
+  };
+  const std::vector<int32_t> first = {1, 2, 3, 4};
+  const std::vector<int32_t> second = {5, 6, 7, 8};
+  const std::vector<int32_t> third = {1, 2, 9, 9};
+  const size_t entry_bytes = 4 * sizeof(int32_t) + 2 * kNumHeads * 4 * kHeadSize * sizeof(float);
+
+  PrefixKVCache prefix_cache(2 * entry_bytes, 2);
+  prefix_cache.Insert(first, make_present(4));
+  prefix_cache.Insert(second, make_present(4));
+  EXPECT_EQ(prefix_cache.MemoryUsage(), 2 * entry_bytes);
+
+  // The lookup finds the first 2 tokens of first, and makes it the most recently used entry.
+  std::vector<OrtValue> present;
+  EXPECT_EQ(prefix_cache.Lookup(third, 4, present), 2);
+  ASSERT_EQ(present.size(), 1u);
+  EXPECT_EQ(present[0].Get<Tensor>().Shape()[3], 4);
+  EXPECT_EQ(prefix_cache.Lookup(first, 3, present), 2);
+  EXPECT_EQ(prefix_cache.Lookup(first, 4, present), 4);
+
+  prefix_cache.Insert(third, make_present(4));
+  EXPECT_EQ(prefix_cache.EntryCount(), 2u);
+  EXPECT_EQ(prefix_cache.Lookup(second, 4, present), 0);
+  EXPECT_EQ(prefix_cache.Lookup(first, 4, present), 4);
+  EXPECT_EQ(prefix_cache.Lookup(third, 4, present), 4);
+
+  // An entry larger than the budget is not stored.
+  prefix_cache.Insert(std::vector<int32_t>(64, 1), make_present(64));
+  EXPECT_EQ(prefix_cache.EntryCount(), 2u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -217,5 +217,40 @@ TEST(EmbedLayerNormTest, EmbedLayerNormBatch_Distill) {
   RunTest(embedlayernorm::EmbedLayerNormBatch_Distill());
 }
 
+// Packed input_ids of shape (token_count) hold two sequences of length 2 and 1 with padding removed.
+TEST(EmbedLayerNormTest, EmbedLayerNormPacked_PositionIds) {
+  embedlayernorm::OpData data = embedlayernorm::EmbedLayerNormBatch1_PositionIds();
+  const int64_t token_count = 3;
+
+  std::vector<int32_t> input_ids_data = {1, 3, 1};
+  std::vector<int32_t> position_ids_data = {0, 1, 0};
+  std::vector<float> output_data = {
+      0.39587587118148804f, 0.03670068085193634f, 0.7449488639831543f, -1.4981462955474854f,
+      0.61326867341995239f, -0.046796366572380066f, 0.81048583984375f, -1.1954958438873291f,
+      0.39587587118148804f, 0.03670068085193634f, 0.7449488639831543f, -1.4981462955474854f};
+
+  OpTester tester("EmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  tester.AddInput<int32_t>("input_ids", {token_count}, input_ids_data);
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("word_embedding",
+                         {static_cast<int64_t>(data.word_embedding_data.size() / data.hidden_size), data.hidden_size},
+                         data.word_embedding_data, /*is_initializer=*/true);
+  tester.AddInput<float>("position_embedding",
+                         {static_cast<int64_t>(data.position_embedding_data.size() / data.hidden_size), data.hidden_size},
+                         data.position_embedding_data, /*is_initializer=*/true);
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<float>("gamma", {data.hidden_size}, data.gamma_data, /*is_initializer=*/true);
+  tester.AddInput<float>("beta", {data.hidden_size}, data.beta_data, /*is_initializer=*/true);
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<int32_t>("position_ids", {token_count}, position_ids_data);
+  tester.AddAttribute("epsilon", data.epsilon);
+  tester.AddAttribute("mask_index_type", static_cast<int64_t>(0));
+  tester.AddOutput<float>("output", {token_count, data.hidden_size}, output_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// weight = [[0, 1], [10, 11], [20, 21], [30, 31]]
+static const std::vector<float> kWeight = {0.0f, 1.0f, 10.0f, 11.0f, 20.0f, 21.0f, 30.0f, 31.0f};
+
+TEST(EmbeddingBagOpTest, Sum) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {3, 2}, {0, 1, 3, 3, -1, 2});
+  test.AddOutput<float>("Y", {3, 2}, {10.0f, 12.0f, 60.0f, 62.0f, 50.0f, 52.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, MeanInt32Indices) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int32_t>("indices", {2, 3}, {0, 1, 2, 3, 3, 0});
+  test.AddOutput<float>("Y", {2, 2}, {10.0f, 11.0f, 20.0f, 21.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, PerSampleWeights) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {2, 2}, {1, 2, 0, 3});
+  test.AddInput<float>("per_sample_weights", {2, 2}, {0.5f, 2.0f, 1.0f, -1.0f});
+  test.AddOutput<float>("Y", {2, 2}, {45.0f, 47.5f, -30.0f, -30.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, MatchesGatherReduceSum) {
+  constexpr int64_t num_embeddings = 97, embedding_dim = 67, num_bags = 33, bag_size = 7;
+  std::vector<float> weight(num_embeddings * embedding_dim);
+  for (size_t i = 0; i < weight.size(); ++i) {
+    weight[i] = static_cast<float>(static_cast<int>(i % 19) - 9) * 0.125f;
+  }
+  std::vector<int64_t> indices(num_bags * bag_size);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = static_cast<int64_t>((i * 31) % num_embeddings);
+  }
+
+  std::vector<float> expected(num_bags * embedding_dim, 0.0f);
+  for (int64_t b = 0; b < num_bags; ++b) {
+    for (int64_t j = 0; j < bag_size; ++j) {
+      const int64_t idx = indices[b * bag_size + j];
+      for (int64_t d = 0; d < embedding_dim; ++d) {
+        expected[b * embedding_dim + d] += weight[idx * embedding_dim + d];
+      }
+    }
+  }
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {num_embeddings, embedding_dim}, weight, true);
+  test.AddInput<int64_t>("indices", {num_bags, bag_size}, indices);
+  test.AddOutput<float>("Y", {num_bags, embedding_dim}, expected);
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, Offsets) {
+  // bags [0, 1], [] and [3, -1, 2]
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {5}, {0, 1, 3, -1, 2});
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int64_t>("offsets", {3}, {0, 2, 2});
+  test.AddOutput<float>("Y", {3, 2}, {10.0f, 12.0f, 0.0f, 0.0f, 80.0f, 83.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, OffsetsPerSampleWeightsInt32) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int32_t>("indices", {3}, {1, 2, 3});
+  test.AddInput<float>("per_sample_weights", {3}, {2.0f, 0.5f, 1.0f});
+  test.AddInput<int32_t>("offsets", {2}, {0, 1});
+  test.AddOutput<float>("Y", {2, 2}, {20.0f, 22.0f, 40.0f, 41.5f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, DecreasingOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {3}, {0, 1, 2});
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int64_t>("offsets", {2}, {2, 1});
+  test.AddOutput<float>("Y", {2, 2}, {0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "offsets must be non-decreasing");
+}
+
+TEST(EmbeddingBagOpTest, Float16) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<MLFloat16>("weight", {4, 2}, ToFloat16(kWeight));
+  test.AddInput<int64_t>("indices", {2, 2}, {0, 1, 3, 2});
+  test.AddOutput<MLFloat16>("Y", {2, 2}, ToFloat16({5.0f, 6.0f, 25.0f, 26.0f}));
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, Uint8WithZeroPoints) {
+  // rows dequantize to [[0, 1], [10, 12], [20, 22], [30, 32]]
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<uint8_t>("weight", {4, 2}, {10, 11, 15, 16, 20, 21, 25, 26}, true);
+  test.AddInput<int64_t>("indices", {2, 2}, {0, 1, 3, 3});
+  test.AddInput<float>("per_sample_weights", {2, 2}, {1.0f, 0.5f, 1.0f, -1.0f});
+  test.AddOptionalInputEdge<int64_t>();
+  test.AddInput<float>("scales", {4}, {1.0f, 2.0f, 2.0f, 2.0f}, true);
+  test.AddInput<uint8_t>("zero_points", {4}, {10, 10, 10, 10}, true);
+  test.AddOutput<float>("Y", {2, 2}, {5.0f, 7.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, Int8) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<int8_t>("weight", {3, 2}, {-4, 2, 6, -8, 1, 1}, true);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 1});
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<int64_t>();
+  test.AddInput<float>("scales", {3}, {0.5f, 0.25f, 1.0f}, true);
+  test.AddOutput<float>("Y", {1, 2}, {-0.5f, -1.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagOpTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {4, 2}, kWeight);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 4});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -236,6 +236,27 @@ TEST(FusedConvTest, Cpu_Conv2D_Bias_Z_Relu) {
   RunConvOp(attrs, {X, W, B, Z}, {X_shape, W_shape, B_shape, Z_shape}, expected_vals, Y_shape, false, true, true);
 }
 
+// Same as Cpu_Conv2D_Bias_Z_Relu with channels last X, Z and Y.
+TEST(FusedConvTest, Cpu_NhwcConv2D_Bias_Z_Relu) {
+  for (bool weight_is_initializer : {false, true}) {
+    OpTester test("NhwcFusedConv", 1, onnxruntime::kMSDomain);
+    test.AddAttribute("group", static_cast<int64_t>(1));
+    test.AddAttribute("kernel_shape", vector<int64_t>{2, 2});
+    test.AddAttribute("pads", vector<int64_t>{0, 0, 0, 0});
+    test.AddAttribute("activation", "Relu");
+
+    test.AddInput<float>("X", {1, 3, 3, 1}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f});
+    test.AddInput<float>("W", {2, 1, 2, 2}, {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f}, weight_is_initializer);
+    test.AddInput<float>("B", {2}, {1.0f, -1.0f});
+    test.AddInput<float>("Z", {1, 2, 2, 2}, {-1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f});
+    test.AddOutput<float>("Y", {1, 2, 2, 2}, {12.0f, 11.0f, 17.0f, 15.0f, 25.0f, 23.0f, 29.0f, 28.0f});
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
 #endif
 
 }  // namespace test
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedElementwiseTest, UnaryAndBinaryOps) {
+  const std::vector<int64_t> dims{2, 3};
+  const std::vector<float> x{-2.0f, -0.5f, 0.0f, 0.5f, 1.0f, 3.0f};
+  const std::vector<float> bias{0.25f, -0.25f, 1.0f, -1.0f, 0.5f, 2.0f};
+
+  // Y = 3 - Tanh(Relu(X + bias) * 0.5)
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    y[i] = 3.0f - std::tanh(std::max(x[i] + bias[i], 0.0f) * 0.5f);
+  }
+
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Add", "Relu", "Mul", "Tanh", "Sub"});
+  test.AddAttribute<std::vector<int64_t>>("operand_indices", {0, 0, 1, 0, 2});
+  test.AddAttribute<std::vector<int64_t>>("operand_positions", {0, 0, 0, 0, 1});
+  test.AddInput<float>("X", dims, x);
+  test.AddInput<float>("bias", dims, bias);
+  test.AddInput<float>("scale", {}, {0.5f});
+  test.AddInput<float>("minuend", {1}, {3.0f});
+  test.AddOutput<float>("Y", dims, y);
+  test.Run();
+}
+
+// Spans several blocks of the kernel, the last of which is partial.
+TEST(FusedElementwiseTest, MultipleBlocks) {
+  constexpr int64_t size = 3 * 4096 + 123;
+  std::vector<float> x(size);
+  std::vector<float> divisor(size);
+  std::vector<float> y(size);
+  for (int64_t i = 0; i < size; ++i) {
+    x[i] = static_cast<float>(i % 97) / 16.0f - 3.0f;
+    divisor[i] = 1.0f + static_cast<float>(i % 13);
+    const float sigmoid = 1.0f / (1.0f + std::exp(-x[i]));
+    y[i] = std::sqrt(std::abs(std::erf(sigmoid / divisor[i])));
+  }
+
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Sigmoid", "Div", "Erf", "Abs", "Sqrt"});
+  test.AddAttribute<std::vector<int64_t>>("operand_indices", {0, 0, 0, 0, 0});
+  test.AddAttribute<std::vector<int64_t>>("operand_positions", {0, 0, 0, 0, 0});
+  test.AddInput<float>("X", {size}, x);
+  test.AddInput<float>("divisor", {size}, divisor);
+  test.AddOutput<float>("Y", {size}, y);
+  test.SetOutputRelErr("Y", 1e-4f);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, InvalidOperandShape) {
+  OpTester test("FusedElementwise", 1, kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Exp", "Add"});
+  test.AddAttribute<std::vector<int64_t>>("operand_indices", {0, 0});
+  test.AddAttribute<std::vector<int64_t>>("operand_positions", {0, 0});
+  test.AddInput<float>("X", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("bias", {2}, {1.0f, 2.0f});
+  test.AddOutput<float>("Y", {2, 2}, {0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
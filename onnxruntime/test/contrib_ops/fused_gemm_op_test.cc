@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A = [[1, 2, 3, 4], [-1, -2, -3, -4]] and B = ones(4, 3), so A * B = [[10, 10, 10], [-10, -10, -10]].
+static void RunFusedGemmTest(const std::string& activation,
+                             const std::vector<int64_t>& c_dims, const std::vector<float>& c_vals,
+                             const std::vector<float>& expected_vals, bool b_is_initializer,
+                             float activation_alpha = 0.0f, bool has_activation_alpha = false) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", activation);
+  if (has_activation_alpha) {
+    test.AddAttribute("activation_alpha", activation_alpha);
+  }
+
+  test.AddInput<float>("A", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f), b_is_initializer);
+  test.AddInput<float>("C", c_dims, c_vals);
+  test.AddOutput<float>("Y", {2, 3}, expected_vals);
+  test.Run();
+}
+
+TEST(FusedGemmOpTest, ReluWithBias) {
+  for (bool b_is_initializer : {false, true}) {
+    RunFusedGemmTest("Relu", {3}, {1.0f, 2.0f, 3.0f},
+                     {11.0f, 12.0f, 13.0f, 0.0f, 0.0f, 0.0f}, b_is_initializer);
+  }
+}
+
+TEST(FusedGemmOpTest, LeakyReluWithSum) {
+  for (bool b_is_initializer : {false, true}) {
+    RunFusedGemmTest("LeakyRelu", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 20.0f},
+                     {11.0f, 12.0f, 13.0f, -0.6f, -0.5f, 10.0f}, b_is_initializer, 0.1f, true);
+  }
+}
+
+TEST(FusedGemmOpTest, SigmoidWithBroadcastColumn) {
+  // A C of shape (M, 1) is broadcast before the GEMM and is not handled by the epilogue.
+  RunFusedGemmTest("Sigmoid", {2, 1}, {-10.0f, 10.0f},
+                   {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f}, false);
+}
+
+TEST(FusedGemmOpTest, SoftsignWithBias) {
+  // Softsign is not implemented by the MLAS epilogue and runs as a separate pass.
+  RunFusedGemmTest("Softsign", {3}, {0.0f, 0.0f, 0.0f},
+                   {10.0f / 11.0f, 10.0f / 11.0f, 10.0f / 11.0f, -10.0f / 11.0f, -10.0f / 11.0f, -10.0f / 11.0f},
+                   false);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
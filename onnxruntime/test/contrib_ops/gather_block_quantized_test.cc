@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef ORT_MINIMAL_BUILD
+
+#include "core/mlas/inc/mlas_q4.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Quantizes a table of N rows of K elements like the weight of MatMulNBits, whose N columns are the rows of the
+// table, and returns the dequantized table in table.
+void QuantizeTable(std::vector<float>& table, std::vector<uint8_t>& data, std::vector<float>& scales,
+                   std::vector<uint8_t>* zero_points, int64_t N, int64_t K, int64_t block_size) {
+  size_t data_size, scale_size, zero_point_size;
+  MlasBlockwiseQuantizedBufferSizes(4, static_cast<int>(block_size), /* columnwise */ true, static_cast<int>(K),
+                                    static_cast<int>(N), data_size, scale_size, &zero_point_size);
+  data.resize(data_size);
+  scales.resize(scale_size);
+  if (zero_points != nullptr) {
+    zero_points->resize(zero_point_size);
+  }
+
+  // MatMulNBits quantizes B of K x N, which is the transposed table
+  std::vector<float> table_t(N * K);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t k = 0; k < K; k++) {
+      table_t[k * N + n] = table[n * K + k];
+    }
+  }
+
+  MlasQuantizeBlockwise<float, 4>(data.data(), scales.data(), zero_points != nullptr ? zero_points->data() : nullptr,
+                                  table_t.data(), static_cast<int>(block_size), true, static_cast<int>(K),
+                                  static_cast<int>(N), static_cast<int>(N), nullptr);
+  MlasDequantizeBlockwise<float, 4>(table.data(), data.data(), scales.data(),
+                                    zero_points != nullptr ? zero_points->data() : nullptr,
+                                    static_cast<int>(block_size), true, static_cast<int>(K), static_cast<int>(N),
+                                    nullptr);
+}
+
+template <typename Tind>
+void RunGatherBlockQuantizedTest(int64_t N, int64_t K, int64_t block_size, bool has_zero_point, bool use_float16,
+                                 const std::vector<int64_t>& indices_shape, const std::vector<Tind>& indices) {
+  RandomValueGenerator random{1234};
+  std::vector<float> table(random.Gaussian<float>(std::vector<int64_t>({N, K}), 0.0f, 0.25f));
+  std::vector<uint8_t> data;
+  std::vector<float> scales;
+  std::vector<uint8_t> zero_points;
+  QuantizeTable(table, data, scales, has_zero_point ? &zero_points : nullptr, N, K, block_size);
+
+  std::vector<float> expected;
+  for (Tind index : indices) {
+    const int64_t row = index < 0 ? index + N : index;
+    expected.insert(expected.end(), table.begin() + row * K, table.begin() + (row + 1) * K);
+  }
+  std::vector<int64_t> output_shape(indices_shape);
+  output_shape.push_back(K);
+
+  const int64_t blocks_per_row = (K + block_size - 1) / block_size;
+
+  OpTester test("GatherBlockQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("bits", 4);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddInput<uint8_t>("data", {N, blocks_per_row, block_size / 2}, data, true);
+  test.AddInput<Tind>("indices", indices_shape, indices);
+  if (use_float16) {
+    test.AddInput<MLFloat16>("scales", {static_cast<int64_t>(scales.size())}, ToFloat16(scales), true);
+  } else {
+    test.AddInput<float>("scales", {static_cast<int64_t>(scales.size())}, scales, true);
+  }
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {static_cast<int64_t>(zero_points.size())}, zero_points, true);
+  } else {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  if (use_float16) {
+    test.AddOutput<MLFloat16>("Y", output_shape, ToFloat16(expected));
+    test.SetOutputAbsErr("Y", 0.01f);
+  } else {
+    test.AddOutput<float>("Y", output_shape, expected);
+    test.SetOutputAbsErr("Y", 1e-5f);
+  }
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+#if defined(USE_CUDA)
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+#endif
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+TEST(GatherBlockQuantized, Float32) {
+  for (auto K : {16, 93, 256}) {
+    for (auto block_size : {16, 32, 128}) {
+      RunGatherBlockQuantizedTest<int64_t>(10, K, block_size, false, false, {2, 3}, {0, 9, 4, 4, -1, -10});
+      RunGatherBlockQuantizedTest<int64_t>(10, K, block_size, true, false, {2, 3}, {0, 9, 4, 4, -1, -10});
+      RunGatherBlockQuantizedTest<int32_t>(7, K, block_size, true, false, {4}, {6, 0, 3, -2});
+    }
+  }
+}
+
+TEST(GatherBlockQuantized, Float16) {
+  RunGatherBlockQuantizedTest<int64_t>(10, 93, 32, false, true, {1, 4}, {1, 2, 3, -3});
+  RunGatherBlockQuantizedTest<int32_t>(10, 256, 64, true, true, {3}, {8, 0, 5});
+}
+
+TEST(GatherBlockQuantized, Bits8) {
+  // two rows of K = 20 in blocks of 16, the second block of each row is padded to 16 bytes
+  constexpr int64_t K = 20;
+  constexpr int64_t block_size = 16;
+  std::vector<uint8_t> data(2 * 2 * block_size);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  const std::vector<float> scales = {0.5f, 2.0f, 0.25f, 1.0f};
+  const std::vector<uint8_t> zero_points = {100, 3, 128, 255};
+
+  std::vector<float> expected;
+  for (int64_t row : {1, 0}) {
+    for (int64_t k = 0; k < K; k++) {
+      const int64_t block = row * 2 + k / block_size;
+      const int value = data[row * 2 * block_size + k];
+      expected.push_back(scales[block] * static_cast<float>(value - zero_points[block]));
+    }
+  }
+
+  OpTester test("GatherBlockQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("bits", 8);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddInput<uint8_t>("data", {2, 2 * block_size}, data, true);
+  test.AddInput<int64_t>("indices", {2}, {1, 0});
+  test.AddInput<float>("scales", {4}, scales, true);
+  test.AddInput<uint8_t>("zero_points", {4}, zero_points, true);
+  test.AddOutput<float>("Y", {2, K}, expected);
+  test.Run();
+}
+
+TEST(GatherBlockQuantized, IndexOutOfRange) {
+  OpTester test("GatherBlockQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", 16);
+  test.AddAttribute<int64_t>("block_size", 16);
+  test.AddInput<uint8_t>("data", {2, 8}, std::vector<uint8_t>(16, 0x88), true);
+  test.AddInput<int64_t>("indices", {1}, {2});
+  test.AddInput<float>("scales", {2}, {1.0f, 1.0f}, true);
+  test.AddOutput<float>("Y", {1, 16}, std::vector<float>(16, 0.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds",
+           {kCudaExecutionProvider, kRocmExecutionProvider});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // ORT_MINIMAL_BUILD
@@ -1,11 +1,15 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include <memory>
 #include <vector>
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
+#include "core/platform/env.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/util/thread_utils.h"
+#include "contrib_ops/cpu/transformers/logits_processor.h"
 #include "test/common/cuda_op_test_utils.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
@@ -171,5 +175,133 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+// The tokens of each step are streamed to the callback of the run options, and match the generated sequences.
+TEST(GreedySearchTest, GptGreedySearchStreamsTokens) {
+  std::vector<int64_t> input_ids_shape{2, 4};
+  std::vector<int32_t> input_ids{
+      0, 0, 0, 52, 0, 0, 195, 731};
+
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length{10};
+  std::vector<int32_t> min_length{1};
+  std::vector<float> repetition_penalty{1.0f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, input_ids.data(), input_ids.size(), input_ids_shape.data(), input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, max_length.data(), max_length.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, min_length.data(), min_length.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, repetition_penalty.data(), repetition_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "repetition_penalty"};
+  const char* const output_names[] = {"sequences"};
+
+  struct Step {
+    std::vector<int32_t> tokens;
+    bool has_beam_indices;
+    size_t sequence_length;
+  };
+  std::vector<Step> steps;
+  auto on_tokens = [](void* user_data, const int32_t* tokens, const int32_t* beam_indices, size_t num_sequences,
+                      size_t sequence_length) {
+    static_cast<std::vector<Step>*>(user_data)->push_back(
+        Step{std::vector<int32_t>(tokens, tokens + num_sequences), beam_indices != nullptr, sequence_length});
+  };
+
+  Ort::Session session(*ort_env, ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"),
+                       Ort::SessionOptions{});
+  Ort::RunOptions run_options;
+  run_options.SetGenerationTokensCallback(on_tokens, &steps);
+  auto ort_outputs = session.Run(run_options, input_names, ort_inputs.data(), ort_inputs.size(), output_names, 1);
+
+  ASSERT_EQ(ort_outputs.size(), 1U);
+  const auto shape = ort_outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+  ASSERT_EQ(shape, (std::vector<int64_t>{input_ids_shape[0], max_length[0]}));
+  const auto* sequences = ort_outputs[0].GetTensorData<int32_t>();
+
+  ASSERT_EQ(steps.size(), static_cast<size_t>(max_length[0] - input_ids_shape[1]));
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const Step& step = steps[i];
+    EXPECT_FALSE(step.has_beam_indices);
+    EXPECT_EQ(step.sequence_length, static_cast<size_t>(input_ids_shape[1]) + i + 1);
+    ASSERT_EQ(step.tokens.size(), static_cast<size_t>(input_ids_shape[0]));
+    for (int64_t batch = 0; batch < input_ids_shape[0]; ++batch) {
+      EXPECT_EQ(step.tokens[batch], sequences[batch * max_length[0] + input_ids_shape[1] + static_cast<int64_t>(i)]);
+    }
+  }
+}
+
+// The logits processors are applied to the rows of a batch in parallel on the intra-op pool, with the same result as
+// applying them to each row in turn.
+TEST(GreedySearchTest, LogitsProcessorsProcessRowsInParallel) {
+  constexpr int batch_size = 4;
+  constexpr int vocab_size = 32000;
+  constexpr int sequence_length = 3;
+  constexpr int max_length = 8;
+  constexpr int eos_token_id = 2;
+
+  // the sequences of the rows hold different tokens, and the first one holds the eos token
+  std::vector<int32_t> sequences_buffer(2 * batch_size * max_length, 0);
+  for (int b = 0; b < batch_size; b++) {
+    for (int j = 0; j < sequence_length; j++) {
+      sequences_buffer[b * max_length + j] = b * 10 + j;
+    }
+  }
+  contrib::transformers::Sequences sequences;
+  sequences.Init(sequences_buffer, batch_size, sequence_length, max_length);
+
+  std::vector<int32_t> vocab_mask(vocab_size, 1);
+  vocab_mask[5] = 0;
+  vocab_mask[vocab_size - 1] = 0;
+  std::vector<int32_t> prefix_vocab_mask(batch_size * vocab_size, 1);
+  for (int b = 0; b < batch_size; b++) {
+    prefix_vocab_mask[b * vocab_size + 100 + b] = 0;
+  }
+
+  contrib::transformers::GreedySearchParameters parameters{};
+  parameters.batch_size = batch_size;
+  parameters.vocab_size = vocab_size;
+  parameters.repetition_penalty = 2.0f;
+  parameters.min_length = 5;
+  parameters.eos_token_id = eos_token_id;
+  parameters.vocab_mask = vocab_mask;
+  parameters.prefix_vocab_mask = prefix_vocab_mask;
+
+  // positive and negative scores, which the repetition penalty treats differently
+  std::vector<float> scores(batch_size * vocab_size);
+  for (size_t i = 0; i < scores.size(); i++) {
+    scores[i] = static_cast<float>((i * 7919) % 1000) / 100.0f - 5.0f;
+  }
+
+  std::vector<float> expected = scores;
+  for (int b = 0; b < batch_size; b++) {
+    float* row = expected.data() + b * vocab_size;
+    for (int j = 0; j < sequence_length; j++) {
+      float& score = row[b * 10 + j];
+      score = score < 0 ? score * parameters.repetition_penalty : score / parameters.repetition_penalty;
+    }
+    for (int j = 0; j < vocab_size; j++) {
+      if (vocab_mask[j] == 0 || prefix_vocab_mask[b * vocab_size + j] == 0) {
+        row[j] = std::numeric_limits<float>::lowest();
+      }
+    }
+    // the sequences are shorter than min_length
+    row[eos_token_id] = std::numeric_limits<float>::lowest();
+  }
+
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  contrib::transformers::LogitsProcessorList processors;
+  processors.Init(parameters, tp.get());
+  gsl::span<float> next_token_scores(scores);
+  processors.Process(&sequences, next_token_scores, 1);
+
+  EXPECT_EQ(scores, expected);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -736,23 +736,19 @@ TEST(GroupNormTest, GroupNorm_128) {
   std::array<int, 3> channels_last_values = {-1, 0, 1};
 
   for (const int channels_last : channels_last_values) {
-    if (enable_cuda || enable_rocm || enable_dml) {
-      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-      if (enable_cuda && channels_last != 0) {
-        execution_providers.push_back(DefaultCudaExecutionProvider());
-      }
-      if (enable_rocm && channels_last != 0) {
-        execution_providers.push_back(DefaultRocmExecutionProvider());
-      }
-      if (enable_dml) {
-        execution_providers.push_back(DefaultDmlExecutionProvider());
-      }
-
-      // Don't run the test if no providers are supported
-      if (execution_providers.empty()) {
-        continue;
-      }
+    std::vector<std::unique_ptr<IExecutionProvider>> fp16_execution_providers;
+    if (enable_cuda && channels_last != 0) {
+      fp16_execution_providers.push_back(DefaultCudaExecutionProvider());
+    }
+    if (enable_rocm && channels_last != 0) {
+      fp16_execution_providers.push_back(DefaultRocmExecutionProvider());
+    }
+    if (enable_dml) {
+      fp16_execution_providers.push_back(DefaultDmlExecutionProvider());
+    }
 
+    // Don't run the test if no providers are supported. The CPU kernel supports float only.
+    if (!fp16_execution_providers.empty()) {
       OpTester test("GroupNorm", 1, onnxruntime::kMSDomain);
       test.AddAttribute<float>("epsilon", 1e-05f);
       test.AddAttribute<int64_t>("groups", 32);
@@ -779,13 +775,14 @@ TEST(GroupNormTest, GroupNorm_128) {
 
       test.AddInput<float>("gamma", {C}, gamma_data);
       test.AddInput<float>("beta", {C}, beta_data);
-      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &fp16_execution_providers);
     }
 
     // Test float32, with activation
-    enable_cuda = HasCudaEnvironment(0);
-    if (enable_cuda || enable_rocm || enable_dml) {
+    {
+      enable_cuda = HasCudaEnvironment(0);
       std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
       if (enable_cuda && channels_last != 0) {
         execution_providers.push_back(DefaultCudaExecutionProvider());
       }
@@ -796,11 +793,6 @@ TEST(GroupNormTest, GroupNorm_128) {
         execution_providers.push_back(DefaultDmlExecutionProvider());
       }
 
-      // Don't run the test if no providers are supported
-      if (execution_providers.empty()) {
-        continue;
-      }
-
       OpTester test("GroupNorm", 1, onnxruntime::kMSDomain);
       test.AddAttribute<float>("epsilon", 1e-05f);
       test.AddAttribute<int64_t>("groups", 32);
@@ -0,0 +1,313 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+struct GQAConfig {
+  int batch_size;
+  int sequence_length;
+  int past_sequence_length;  // valid past tokens of every batch, which is also the past buffer length
+  int num_heads;
+  int kv_num_heads;
+  int head_size;
+  int local_window_size;
+};
+
+// Naive causal grouped query attention with Q as BxSxD, K/V as BxSxD_kv and past K/V as BxN_kvxPxH.
+void ComputeReference(const GQAConfig& config,
+                      const std::vector<float>& query,
+                      const std::vector<float>& key,
+                      const std::vector<float>& value,
+                      const std::vector<float>& past_key,
+                      const std::vector<float>& past_value,
+                      std::vector<float>& output,
+                      std::vector<float>& present_key,
+                      std::vector<float>& present_value) {
+  const int B = config.batch_size;
+  const int S = config.sequence_length;
+  const int P = config.past_sequence_length;
+  const int T = P + S;
+  const int N = config.num_heads;
+  const int N_kv = config.kv_num_heads;
+  const int H = config.head_size;
+  const float scale = 1.0f / std::sqrt(static_cast<float>(H));
+
+  present_key.assign(static_cast<size_t>(B) * N_kv * T * H, 0.0f);
+  present_value.assign(present_key.size(), 0.0f);
+  for (int b = 0; b < B; b++) {
+    for (int n = 0; n < N_kv; n++) {
+      for (int t = 0; t < T; t++) {
+        for (int h = 0; h < H; h++) {
+          size_t dst = ((static_cast<size_t>(b) * N_kv + n) * T + t) * H + h;
+          if (t < P) {
+            size_t src = ((static_cast<size_t>(b) * N_kv + n) * P + t) * H + h;
+            present_key[dst] = past_key[src];
+            present_value[dst] = past_value[src];
+          } else {
+            size_t src = (static_cast<size_t>(b) * S + (t - P)) * N_kv * H + n * H + h;
+            present_key[dst] = key[src];
+            present_value[dst] = value[src];
+          }
+        }
+      }
+    }
+  }
+
+  output.assign(static_cast<size_t>(B) * S * N * H, 0.0f);
+  std::vector<float> scores(T);
+  for (int b = 0; b < B; b++) {
+    for (int n = 0; n < N; n++) {
+      const int kv_n = n / (N / N_kv);
+      const float* k = present_key.data() + (static_cast<size_t>(b) * N_kv + kv_n) * T * H;
+      const float* v = present_value.data() + (static_cast<size_t>(b) * N_kv + kv_n) * T * H;
+      for (int s = 0; s < S; s++) {
+        const float* q = query.data() + (static_cast<size_t>(b) * S + s) * N * H + n * H;
+        const int end = P + s + 1;
+        const int start = (config.local_window_size > 0) ? std::max(0, end - config.local_window_size - 1) : 0;
+        float max_score = -std::numeric_limits<float>::infinity();
+        for (int t = start; t < end; t++) {
+          float dot = 0.0f;
+          for (int h = 0; h < H; h++) {
+            dot += q[h] * k[t * H + h];
+          }
+          scores[t] = dot * scale;
+          max_score = std::max(max_score, scores[t]);
+        }
+        float sum = 0.0f;
+        for (int t = start; t < end; t++) {
+          scores[t] = std::exp(scores[t] - max_score);
+          sum += scores[t];
+        }
+        float* out = output.data() + (static_cast<size_t>(b) * S + s) * N * H + n * H;
+        for (int t = start; t < end; t++) {
+          for (int h = 0; h < H; h++) {
+            out[h] += scores[t] / sum * v[t * H + h];
+          }
+        }
+      }
+    }
+  }
+}
+
+std::vector<float> RandomData(size_t size, float min_value, float max_value) {
+  RandomValueGenerator random{};
+  return random.Uniform<float>(std::vector<int64_t>{static_cast<int64_t>(size)}, min_value, max_value);
+}
+
+void RunGroupQueryAttentionTest(const GQAConfig& config) {
+  const int B = config.batch_size;
+  const int S = config.sequence_length;
+  const int P = config.past_sequence_length;
+  const int T = P + S;
+  const int hidden_size = config.num_heads * config.head_size;
+  const int kv_hidden_size = config.kv_num_heads * config.head_size;
+
+  std::vector<float> query = RandomData(static_cast<size_t>(B) * S * hidden_size, -1.0f, 1.0f);
+  std::vector<float> key = RandomData(static_cast<size_t>(B) * S * kv_hidden_size, -1.0f, 1.0f);
+  std::vector<float> value = RandomData(static_cast<size_t>(B) * S * kv_hidden_size, -1.0f, 1.0f);
+  std::vector<float> past_key = RandomData(static_cast<size_t>(B) * kv_hidden_size * P, -1.0f, 1.0f);
+  std::vector<float> past_value = RandomData(static_cast<size_t>(B) * kv_hidden_size * P, -1.0f, 1.0f);
+
+  std::vector<float> output;
+  std::vector<float> present_key;
+  std::vector<float> present_value;
+  ComputeReference(config, query, key, value, past_key, past_value, output, present_key, present_value);
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(config.num_heads));
+  tester.AddAttribute<int64_t>("kv_num_heads", static_cast<int64_t>(config.kv_num_heads));
+  tester.AddAttribute<int64_t>("local_window_size", static_cast<int64_t>(config.local_window_size));
+
+  std::vector<int64_t> past_dims = {B, config.kv_num_heads, P, config.head_size};
+  std::vector<int64_t> present_dims = {B, config.kv_num_heads, T, config.head_size};
+
+  tester.AddInput<float>("query", {B, S, hidden_size}, query);
+  tester.AddInput<float>("key", {B, S, kv_hidden_size}, key);
+  tester.AddInput<float>("value", {B, S, kv_hidden_size}, value);
+  if (P > 0) {
+    tester.AddInput<float>("past_key", past_dims, past_key);
+    tester.AddInput<float>("past_value", past_dims, past_value);
+  } else {
+    tester.AddOptionalInputEdge<float>();
+    tester.AddOptionalInputEdge<float>();
+  }
+  tester.AddInput<int32_t>("seqlens_k", {B}, std::vector<int32_t>(B, P));
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {T});
+
+  tester.AddOutput<float>("output", {B, S, hidden_size}, output);
+  tester.AddOutput<float>("present_key", present_dims, present_key);
+  tester.AddOutput<float>("present_value", present_dims, present_value);
+  tester.SetOutputAbsErr("output", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Quantizes rows of head_size values to int8 with a symmetric scale per row, like the int8 KV cache.
+void QuantizeRows(const std::vector<float>& input, int head_size,
+                  std::vector<int8_t>& output, std::vector<float>& scales) {
+  const size_t rows = input.size() / head_size;
+  output.resize(input.size());
+  scales.resize(rows);
+  for (size_t r = 0; r < rows; r++) {
+    const float* row = input.data() + r * head_size;
+    float max_abs = 0.0f;
+    for (int h = 0; h < head_size; h++) {
+      max_abs = std::max(max_abs, std::abs(row[h]));
+    }
+    scales[r] = max_abs / 127.0f;
+    const float inverse_scale = max_abs == 0.0f ? 0.0f : 127.0f / max_abs;
+    for (int h = 0; h < head_size; h++) {
+      output[r * head_size + h] = static_cast<int8_t>(std::nearbyint(row[h] * inverse_scale));
+    }
+  }
+}
+
+std::vector<float> DequantizeRows(const std::vector<int8_t>& input, const std::vector<float>& scales,
+                                  int head_size) {
+  std::vector<float> output(input.size());
+  for (size_t i = 0; i < input.size(); i++) {
+    output[i] = scales[i / head_size] * input[i];
+  }
+  return output;
+}
+
+// Runs with an int8 KV cache. The reference attends to the dequantized cache, so the output matches closely.
+void RunGroupQueryAttentionInt8CacheTest(const GQAConfig& config) {
+  const int B = config.batch_size;
+  const int S = config.sequence_length;
+  const int P = config.past_sequence_length;
+  const int T = P + S;
+  const int H = config.head_size;
+  const int hidden_size = config.num_heads * H;
+  const int kv_hidden_size = config.kv_num_heads * H;
+
+  std::vector<float> query = RandomData(static_cast<size_t>(B) * S * hidden_size, -1.0f, 1.0f);
+  std::vector<float> key = RandomData(static_cast<size_t>(B) * S * kv_hidden_size, -1.0f, 1.0f);
+  std::vector<float> value = RandomData(static_cast<size_t>(B) * S * kv_hidden_size, -1.0f, 1.0f);
+
+  std::vector<int8_t> past_key, past_value;
+  std::vector<float> past_key_scale, past_value_scale;
+  QuantizeRows(RandomData(static_cast<size_t>(B) * kv_hidden_size * P, -1.0f, 1.0f), H, past_key, past_key_scale);
+  QuantizeRows(RandomData(static_cast<size_t>(B) * kv_hidden_size * P, -1.0f, 1.0f), H, past_value, past_value_scale);
+
+  // Rows of the new K/V are heads of a token, so they quantize like the rows of the cache.
+  std::vector<int8_t> key_quantized, value_quantized;
+  std::vector<float> key_scale, value_scale;
+  QuantizeRows(key, H, key_quantized, key_scale);
+  QuantizeRows(value, H, value_quantized, value_scale);
+
+  std::vector<float> output;
+  std::vector<float> present_key_dequantized;
+  std::vector<float> present_value_dequantized;
+  ComputeReference(config, query, DequantizeRows(key_quantized, key_scale, H),
+                   DequantizeRows(value_quantized, value_scale, H),
+                   DequantizeRows(past_key, past_key_scale, H), DequantizeRows(past_value, past_value_scale, H),
+                   output, present_key_dequantized, present_value_dequantized);
+
+  // The expected present cache is the past rows followed by the quantized new rows of each kv head.
+  std::vector<int8_t> present_key, present_value;
+  std::vector<float> present_key_scale, present_value_scale;
+  for (int b = 0; b < B; b++) {
+    for (int n = 0; n < config.kv_num_heads; n++) {
+      for (int t = 0; t < T; t++) {
+        const size_t row = t < P ? (static_cast<size_t>(b) * config.kv_num_heads + n) * P + t
+                                 : (static_cast<size_t>(b) * S + (t - P)) * config.kv_num_heads + n;
+        const std::vector<int8_t>& k = t < P ? past_key : key_quantized;
+        const std::vector<int8_t>& v = t < P ? past_value : value_quantized;
+        present_key.insert(present_key.end(), k.begin() + row * H, k.begin() + (row + 1) * H);
+        present_value.insert(present_value.end(), v.begin() + row * H, v.begin() + (row + 1) * H);
+        present_key_scale.push_back(t < P ? past_key_scale[row] : key_scale[row]);
+        present_value_scale.push_back(t < P ? past_value_scale[row] : value_scale[row]);
+      }
+    }
+  }
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(config.num_heads));
+  tester.AddAttribute<int64_t>("kv_num_heads", static_cast<int64_t>(config.kv_num_heads));
+  tester.AddAttribute<int64_t>("local_window_size", static_cast<int64_t>(config.local_window_size));
+  tester.AddAttribute<int64_t>("kv_cache_bit_width", 8);
+
+  std::vector<int64_t> past_dims = {B, config.kv_num_heads, P, H};
+  std::vector<int64_t> present_dims = {B, config.kv_num_heads, T, H};
+
+  tester.AddInput<float>("query", {B, S, hidden_size}, query);
+  tester.AddInput<float>("key", {B, S, kv_hidden_size}, key);
+  tester.AddInput<float>("value", {B, S, kv_hidden_size}, value);
+  if (P > 0) {
+    tester.AddInput<int8_t>("past_key", past_dims, past_key);
+    tester.AddInput<int8_t>("past_value", past_dims, past_value);
+  } else {
+    tester.AddOptionalInputEdge<int8_t>();
+    tester.AddOptionalInputEdge<int8_t>();
+  }
+  tester.AddInput<int32_t>("seqlens_k", {B}, std::vector<int32_t>(B, P));
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {T});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  if (P > 0) {
+    tester.AddInput<float>("past_key_scale", {B, config.kv_num_heads, P}, past_key_scale);
+    tester.AddInput<float>("past_value_scale", {B, config.kv_num_heads, P}, past_value_scale);
+  } else {
+    tester.AddOptionalInputEdge<float>();
+    tester.AddOptionalInputEdge<float>();
+  }
+
+  tester.AddOutput<float>("output", {B, S, hidden_size}, output);
+  tester.AddOutput<int8_t>("present_key", present_dims, present_key);
+  tester.AddOutput<int8_t>("present_value", present_dims, present_value);
+  tester.AddOutput<float>("present_key_scale", {B, config.kv_num_heads, T}, present_key_scale);
+  tester.AddOutput<float>("present_value_scale", {B, config.kv_num_heads, T}, present_value_scale);
+  tester.SetOutputAbsErr("output", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // anonymous namespace
+
+TEST(GroupQueryAttentionTest, Prompt) {
+  RunGroupQueryAttentionTest({2, 5, 0, 4, 2, 16, -1});
+}
+
+TEST(GroupQueryAttentionTest, PromptMultiQuery) {
+  RunGroupQueryAttentionTest({1, 7, 0, 6, 1, 8, -1});
+}
+
+TEST(GroupQueryAttentionTest, TokenGeneration) {
+  RunGroupQueryAttentionTest({3, 1, 9, 8, 2, 16, -1});
+}
+
+TEST(GroupQueryAttentionTest, TokenGenerationLocalWindow) {
+  RunGroupQueryAttentionTest({2, 1, 12, 4, 4, 8, 4});
+}
+
+TEST(GroupQueryAttentionTest, PromptLocalWindow) {
+  RunGroupQueryAttentionTest({1, 9, 0, 4, 2, 8, 3});
+}
+
+TEST(GroupQueryAttentionTest, PromptInt8Cache) {
+  RunGroupQueryAttentionInt8CacheTest({2, 5, 0, 4, 2, 16, -1});
+}
+
+TEST(GroupQueryAttentionTest, TokenGenerationInt8Cache) {
+  RunGroupQueryAttentionInt8CacheTest({3, 1, 9, 8, 2, 16, -1});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
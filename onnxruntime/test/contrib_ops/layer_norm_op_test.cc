@@ -232,6 +232,18 @@ TEST(LayerNormTest, LayerNorm17_double) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kDnnlExecutionProvider});
 }
 
+TEST(LayerNormTest, LayerNorm17_float16) {
+  OpTester test("LayerNormalization", 17);
+  test.AddAttribute<float>("epsilon", 1e-05f);
+
+  std::vector<int64_t> dims{1, 2, 3};
+  test.AddInput<MLFloat16>("x", dims, ToFloat16({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+  test.AddInput<MLFloat16>("gamma", {3}, ToFloat16({1.0f, 1.0f, 1.0f}));
+  test.AddInput<MLFloat16>("bias", {3}, ToFloat16({0.5f, 0.0f, -0.5f}));
+  test.AddOutput<MLFloat16>("output", dims, ToFloat16({-0.7247f, 0.0f, 0.7247f, -0.7247f, 0.0f, 0.7247f}));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kDnnlExecutionProvider});
+}
+
 TEST(LayerNormTest, LayerNorm_InvalidScaleBias) {
   OpTester test("LayerNormalization");
   test.AddAttribute<float>("epsilon", 1e-05f);
@@ -250,6 +262,21 @@ TEST(LayerNormTest, LayerNorm_InvalidScaleBias) {
            {kDnnlExecutionProvider, kDmlExecutionProvider, kTensorrtExecutionProvider});
 }
 
+TEST(LayerNormTest, SimplifiedLayerNorm_Float16InputScaleOutput) {
+  OpTester test("SimplifiedLayerNormalization");
+  test.AddAttribute<float>("epsilon", 1e-05f);
+
+  std::vector<int64_t> dims{2, 3};
+  test.AddInput<MLFloat16>("x", dims, ToFloat16({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+  test.AddInput<MLFloat16>("scale", {3}, ToFloat16({1.0f, 2.0f, 0.5f}));
+  test.AddOutput<MLFloat16>("output", dims, ToFloat16({0.4629f, 1.8516f, 0.6944f, 0.7895f, 1.9739f, 0.5922f}));
+  test.AddOutput<float>("inv_std_var", {2, 1}, {0.462910f, 0.197385f});
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 #if defined(USE_DNNL)
 TEST(LayerNormTest, LayerNorm17_Scale_Bias_bfloat16) {
 #ifdef USE_DNNL
@@ -19,7 +19,9 @@
 #include "core/session/ort_env.h"
 #include "core/util/qmath.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <random>
 
 #include "gtest/gtest.h"
@@ -156,7 +158,11 @@ void RunTest(int64_t M, int64_t N, int64_t K, int64_t block_size, int64_t accura
     test.SetOutputAbsErr("Y", fp16_abs_error);
 
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+#if defined(USE_CUDA)
     execution_providers.push_back(DefaultCudaExecutionProvider());
+#else
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+#endif
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   } else {
     test.AddInput<float>("A", {M, K}, input0_vals, false);
@@ -224,6 +230,23 @@ TEST(MatMulNBits, Float32) {
   }
 }
 
+#if !defined(USE_CUDA)
+// The CPU kernel converts fp16 A and scales to fp32 and converts Y back to fp16.
+TEST(MatMulNBits, Float16Cpu) {
+  for (auto M : {1, 2, 33}) {
+    for (auto N : {1, 32, 288}) {
+      for (auto K : {16, 93, 256}) {
+        for (auto block_size : {16, 32, 128}) {
+          RunTest(M, N, K, block_size, 0, false, true);
+          RunTest(M, N, K, block_size, 0, true, true);
+          RunTest(M, N, K, block_size, 0, true, true, false, false);
+        }
+      }
+    }
+  }
+}
+#endif
+
 #if defined(USE_CUDA)
 TEST(MatMulNBits, Float16) {
   for (auto M : {1, 2, 100}) {
@@ -250,6 +273,116 @@ TEST(MatMulNBits, Float16Large) {
   }
 }
 
+// Small batches with a narrow N and a wide K, which use the split-K gemv kernel.
+TEST(MatMulNBits, Float16SmallBatchWideK) {
+  for (auto M : {1, 3, 4, 9, 16}) {
+    for (auto block_size : {32, 128}) {
+      for (auto symmetric : {false, true}) {
+        RunTest(M, 256, 11008, block_size, 0, symmetric, true, false, true, 0.05f);
+      }
+    }
+  }
+}
+
+// B is quantized with 8 bits, which is only implemented by the CUDA kernel. The zero points are not packed.
+void RunTest8Bits(int64_t M, int64_t N, int64_t K, int64_t block_size, bool has_zeropoint, bool use_float16) {
+  RandomValueGenerator random{1234};
+  std::vector<float> input0_vals(random.Gaussian<float>(std::vector<int64_t>({M, K}), 0.0f, 0.25f));
+  // B is stored transposed, i.e. as N x K
+  std::vector<float> input1_f_vals(random.Gaussian<float>(std::vector<int64_t>({N, K}), 0.0f, 0.25f));
+
+  const int64_t blocks_per_K = (K + block_size - 1) / block_size;
+  std::vector<uint8_t> input1_vals(N * blocks_per_K * block_size, 0);
+  std::vector<float> scales(N * blocks_per_K);
+  std::vector<uint8_t> zp(N * blocks_per_K, 128);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t block = 0; block < blocks_per_K; block++) {
+      const int64_t k_begin = block * block_size;
+      const int64_t k_end = std::min(K, k_begin + block_size);
+      float min = 0.0f;
+      float max = 0.0f;
+      for (int64_t k = k_begin; k < k_end; k++) {
+        min = std::min(min, input1_f_vals[n * K + k]);
+        max = std::max(max, input1_f_vals[n * K + k]);
+      }
+
+      float scale = has_zeropoint ? (max - min) / 255.0f : std::max(-min, max) / 127.0f;
+      scale = scale == 0.0f ? 1.0f : scale;
+      const int zero_point = has_zeropoint ? std::clamp(static_cast<int>(std::nearbyint(-min / scale)), 0, 255) : 128;
+      scales[n * blocks_per_K + block] = scale;
+      zp[n * blocks_per_K + block] = static_cast<uint8_t>(zero_point);
+
+      // the reference uses the dequantized values of B
+      for (int64_t k = k_begin; k < k_end; k++) {
+        const int q = std::clamp(static_cast<int>(std::nearbyint(input1_f_vals[n * K + k] / scale)) + zero_point,
+                                 0, 255);
+        input1_vals[n * blocks_per_K * block_size + k] = static_cast<uint8_t>(q);
+        input1_f_vals[n * K + k] = (q - zero_point) * scale;
+      }
+    }
+  }
+
+  std::vector<float> expected_vals(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += input0_vals[m * K + k] * input1_f_vals[n * K + k];
+      }
+      expected_vals[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", 8);
+  test.AddAttribute<int64_t>("accuracy_level", 0);
+
+  if (use_float16) {
+    test.AddInput<MLFloat16>("A", {M, K}, ToFloat16(input0_vals), false);
+    test.AddInput<uint8_t>("B", {N, blocks_per_K, block_size}, input1_vals, true);
+    test.AddInput<MLFloat16>("scales", {N * blocks_per_K}, ToFloat16(scales), true);
+  } else {
+    test.AddInput<float>("A", {M, K}, input0_vals, false);
+    test.AddInput<uint8_t>("B", {N, blocks_per_K, block_size}, input1_vals, true);
+    test.AddInput<float>("scales", {N * blocks_per_K}, scales, true);
+  }
+  if (has_zeropoint) {
+    test.AddInput<uint8_t>("zero_points", {N * blocks_per_K}, zp, true);
+  } else {
+    test.AddInput<uint8_t>("", {0}, {});
+  }
+
+  if (use_float16) {
+    test.AddOutput<MLFloat16>("Y", {M, N}, ToFloat16(expected_vals));
+    test.SetOutputAbsErr("Y", 0.05f);
+  } else {
+    test.AddOutput<float>("Y", {M, N}, expected_vals);
+    test.SetOutputAbsErr("Y", 0.005f);
+  }
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MatMulNBits, Int8Weights) {
+  for (auto use_float16 : {false, true}) {
+    // small M uses the fused gemv kernel, with K splits for the wide K, large M dequantizes B for cuBLAS
+    for (auto M : {1, 4, 16, 100}) {
+      for (auto K : {64, 93, 1024, 4096}) {
+        for (auto block_size : {16, 32, 64, 128}) {
+          for (auto has_zeropoint : {false, true}) {
+            RunTest8Bits(M, 96, K, block_size, has_zeropoint, use_float16);
+          }
+        }
+      }
+    }
+  }
+}
+
 #endif
 
 void RunSharedPrepackedWeightsTest(int64_t M, int64_t N, int64_t K, int block_size, bool is_asym,
@@ -410,6 +543,37 @@ void RunSharedPrepackedWeightsTest(int64_t M, int64_t N, int64_t K, int block_si
   }
 }
 
+// The MatMulNBits nodes with the int8 compute type that share input A take it quantized once by
+// QuantizeMatMulNBitsInput, which gives the same results as each node quantizing A itself.
+TEST(MatMulNBits, SharedInputQuantization) {
+  constexpr int64_t K = 96;
+  constexpr int64_t block_size = 32;
+  constexpr int64_t k_blocks = K / block_size;
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    NodeArg* input = builder.MakeInput<float>({2, 3, K}, -1.0f, 1.0f);
+    for (int64_t N : {48, 16, 32}) {
+      NodeArg* b = builder.MakeInitializer<uint8_t>({N, k_blocks, block_size / 2}, 0, 255);
+      NodeArg* scales = builder.MakeInitializer<float>({N * k_blocks}, 0.01f, 0.02f);
+      Node& node = builder.AddNode("MatMulNBits", {input, b, scales}, {builder.MakeOutput()}, kMSDomain);
+      node.AddAttribute("K", K);
+      node.AddAttribute("N", N);
+      node.AddAttribute("bits", static_cast<int64_t>(QBits));
+      node.AddAttribute("block_size", block_size);
+      node.AddAttribute("accuracy_level", static_cast<int64_t>(4));
+    }
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    const int expected_count = MlasIsSQNBitGemmAvailable(QBits, block_size, CompInt8) ? 1 : 0;
+    EXPECT_EQ(op_to_count["com.microsoft.QuantizeMatMulNBitsInput"], expected_count);
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 3);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14, 1e-5);
+}
+
 #ifdef ORT_NEURAL_SPEED
 TEST(MatMulNBits, SharedPrepackedWeights) {
   RunSharedPrepackedWeightsTest(2, 4096, 4096, 32, true, 1);
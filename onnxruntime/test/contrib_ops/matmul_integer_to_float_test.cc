@@ -225,6 +225,22 @@ TEST(MatMulIntegerToFloat, HasZeroPoint_HasBias_test_U8S8) {
   RunMatMulIntegerToFloatTest<uint8_t, int8_t, float, true, true>();
 }
 
+TEST(MatMulIntegerToFloat, HasZeroPoint_NoBias_test_S16S8) {
+  RunMatMulIntegerToFloatTest<int16_t, int8_t, float, true, false>();
+}
+
+TEST(MatMulIntegerToFloat, NoZeroPoint_HasBias_test_S16S8) {
+  RunMatMulIntegerToFloatTest<int16_t, int8_t, float, false, true>();
+}
+
+TEST(MatMulIntegerToFloat, HasZeroPoint_HasBias_test_U16U8) {
+  RunMatMulIntegerToFloatTest<uint16_t, uint8_t, float, true, true>();
+}
+
+TEST(MatMulIntegerToFloat, HasZeroPoint_NoBias_test_U16S8) {
+  RunMatMulIntegerToFloatTest<uint16_t, int8_t, float, true, false>();
+}
+
 // DML EP supports Float16 output type and Signed A Matrix and Unsigned B Matric for Float32 output
 #if defined(USE_DML)
 
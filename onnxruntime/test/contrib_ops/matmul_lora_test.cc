@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Y = X * W + (X * A) * B with X [M, K], W [K, N], A [K, r] and B [r, N]
+std::vector<float> ReferenceMatMulLoRA(const std::vector<float>& x, const std::vector<float>& w,
+                                       const std::vector<float>& a, const std::vector<float>& b,
+                                       int64_t m, int64_t k, int64_t n, int64_t r) {
+  std::vector<float> y(m * n, 0.0f);
+  for (int64_t i = 0; i < m; ++i) {
+    std::vector<float> xa(r, 0.0f);
+    for (int64_t j = 0; j < r; ++j) {
+      for (int64_t p = 0; p < k; ++p) {
+        xa[j] += x[i * k + p] * a[p * r + j];
+      }
+    }
+    for (int64_t j = 0; j < n; ++j) {
+      for (int64_t p = 0; p < k; ++p) {
+        y[i * n + j] += x[i * k + p] * w[p * n + j];
+      }
+      for (int64_t p = 0; p < r; ++p) {
+        y[i * n + j] += xa[p] * b[p * n + j];
+      }
+    }
+  }
+  return y;
+}
+
+void RunMatMulLoRATest(int64_t r, bool is_initializer_w) {
+  constexpr int64_t batch = 2, seq = 3, k = 8, n = 5;
+  const std::vector<int64_t> x_dims{batch, seq, k}, w_dims{k, n}, a_dims{k, r}, b_dims{r, n};
+  RandomValueGenerator random{};
+  const auto x = random.Uniform<float>(x_dims, -1.0f, 1.0f);
+  const auto w = random.Uniform<float>(w_dims, -1.0f, 1.0f);
+  const auto a = random.Uniform<float>(a_dims, -1.0f, 1.0f);
+  const auto b = random.Uniform<float>(b_dims, -1.0f, 1.0f);
+
+  OpTester test("MatMulLoRA", 1, kMSDomain);
+  test.AddInput<float>("X", x_dims, x);
+  test.AddInput<float>("W", w_dims, w, is_initializer_w);
+  test.AddInput<float>("lora_A", a_dims, a);
+  test.AddInput<float>("lora_B", b_dims, b);
+  test.AddOutput<float>("Y", {batch, seq, n}, ReferenceMatMulLoRA(x, w, a, b, batch * seq, k, n, r));
+  test.SetOutputAbsErr("Y", 1e-4f);
+  test.Run();
+}
+
+}  // namespace
+
+TEST(MatMulLoRATest, Rank2) {
+  RunMatMulLoRATest(2, false);
+}
+
+TEST(MatMulLoRATest, Rank2PrePackedWeight) {
+  RunMatMulLoRATest(2, true);
+}
+
+// Without an adapter the update has rank 0 and Y = X * W
+TEST(MatMulLoRATest, Rank0) {
+  RunMatMulLoRATest(0, true);
+}
+
+TEST(MatMulLoRATest, InvalidUpdateShape) {
+  OpTester test("MatMulLoRA", 1, kMSDomain);
+  test.AddInput<float>("X", {1, 2}, {1.0f, 2.0f});
+  test.AddInput<float>("W", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("lora_A", {2, 1}, {1.0f, 2.0f});
+  test.AddInput<float>("lora_B", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "MatMulLoRA expects lora_A of shape");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
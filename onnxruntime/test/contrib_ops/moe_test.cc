@@ -1,10 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -22,47 +26,114 @@ static void RunMoETest(
     int hidden_size,
     int inter_size,
     std::string activation_type,
-    bool use_float16 = false) {
-  int min_cuda_architecture = use_float16 ? 530 : 0;
-
-  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
-  if (enable_cuda) {
-    OpTester tester("MoE", 1, onnxruntime::kMSDomain);
-    tester.AddAttribute<int64_t>("k", static_cast<int64_t>(1));
-    tester.AddAttribute<std::string>("activation_type", activation_type);
-
-    std::vector<int64_t> input_dims = {num_rows, hidden_size};
-    std::vector<int64_t> router_probs_dims = {num_rows, num_experts};
-    std::vector<int64_t> fc1_experts_weights_dims = {num_experts, hidden_size, inter_size};
-    std::vector<int64_t> fc2_experts_weights_dims = {num_experts, inter_size, hidden_size};
-    std::vector<int64_t> fc1_experts_bias_dims = {num_experts, inter_size};
-    std::vector<int64_t> fc2_experts_bias_dims = {num_experts, hidden_size};
-    std::vector<int64_t> output_dims = {num_rows, hidden_size};
+    bool use_float16 = false,
+    int k = 1,
+    const std::vector<float>& fc3_experts_weights = {},
+    int normalize_routing_weights = 0) {
+  std::vector<int64_t> input_dims = {num_rows, hidden_size};
+  std::vector<int64_t> router_probs_dims = {num_rows, num_experts};
+  std::vector<int64_t> fc1_experts_weights_dims = {num_experts, hidden_size, inter_size};
+  std::vector<int64_t> fc2_experts_weights_dims = {num_experts, inter_size, hidden_size};
+  std::vector<int64_t> fc1_experts_bias_dims = {num_experts, inter_size};
+  std::vector<int64_t> fc2_experts_bias_dims = {num_experts, hidden_size};
+  std::vector<int64_t> output_dims = {num_rows, hidden_size};
 
+  auto make_tester = [&]() {
+    auto tester = std::make_unique<OpTester>("MoE", 1, onnxruntime::kMSDomain);
+    tester->AddAttribute<int64_t>("k", static_cast<int64_t>(k));
+    tester->AddAttribute<std::string>("activation_type", activation_type);
+    tester->AddAttribute<int64_t>("normalize_routing_weights", static_cast<int64_t>(normalize_routing_weights));
     if (use_float16) {
-      tester.AddInput<MLFloat16>("input", input_dims, ToFloat16(input));
-      tester.AddInput<MLFloat16>("router_probs", router_probs_dims, ToFloat16(router_probs));
-      tester.AddInput<MLFloat16>("fc1_experts_weights", fc1_experts_weights_dims, ToFloat16(fc1_experts_weights));
-      tester.AddInput<MLFloat16>("fc2_experts_weights", fc2_experts_weights_dims, ToFloat16(fc2_experts_weights));
-      tester.AddInput<MLFloat16>("fc1_experts_bias", fc1_experts_bias_dims, ToFloat16(fc1_experts_bias));
-      tester.AddInput<MLFloat16>("fc2_experts_bias", fc2_experts_bias_dims, ToFloat16(fc2_experts_bias));
-      tester.AddOutput<MLFloat16>("output", output_dims, ToFloat16(output_data));
+      tester->AddInput<MLFloat16>("input", input_dims, ToFloat16(input));
+      tester->AddInput<MLFloat16>("router_probs", router_probs_dims, ToFloat16(router_probs));
+      tester->AddInput<MLFloat16>("fc1_experts_weights", fc1_experts_weights_dims, ToFloat16(fc1_experts_weights));
+      tester->AddInput<MLFloat16>("fc2_experts_weights", fc2_experts_weights_dims, ToFloat16(fc2_experts_weights));
+      tester->AddInput<MLFloat16>("fc1_experts_bias", fc1_experts_bias_dims, ToFloat16(fc1_experts_bias));
+      tester->AddInput<MLFloat16>("fc2_experts_bias", fc2_experts_bias_dims, ToFloat16(fc2_experts_bias));
+      if (!fc3_experts_weights.empty()) {
+        tester->AddInput<MLFloat16>("fc3_experts_weights", fc1_experts_weights_dims, ToFloat16(fc3_experts_weights));
+      }
+      tester->AddOutput<MLFloat16>("output", output_dims, ToFloat16(output_data));
     } else {
-      tester.AddInput<float>("input", input_dims, input);
-      tester.AddInput<float>("router_probs", router_probs_dims, router_probs);
-      tester.AddInput<float>("fc1_experts_weights", fc1_experts_weights_dims, fc1_experts_weights);
-      tester.AddInput<float>("fc2_experts_weights", fc2_experts_weights_dims, fc2_experts_weights);
-      tester.AddInput<float>("fc1_experts_bias", fc1_experts_bias_dims, fc1_experts_bias);
-      tester.AddInput<float>("fc2_experts_bias", fc2_experts_bias_dims, fc2_experts_bias);
-      tester.AddOutput<float>("output", output_dims, output_data);
+      tester->AddInput<float>("input", input_dims, input);
+      tester->AddInput<float>("router_probs", router_probs_dims, router_probs);
+      tester->AddInput<float>("fc1_experts_weights", fc1_experts_weights_dims, fc1_experts_weights);
+      tester->AddInput<float>("fc2_experts_weights", fc2_experts_weights_dims, fc2_experts_weights);
+      tester->AddInput<float>("fc1_experts_bias", fc1_experts_bias_dims, fc1_experts_bias);
+      tester->AddInput<float>("fc2_experts_bias", fc2_experts_bias_dims, fc2_experts_bias);
+      if (!fc3_experts_weights.empty()) {
+        tester->AddInput<float>("fc3_experts_weights", fc1_experts_weights_dims, fc3_experts_weights);
+      }
+      tester->AddOutput<float>("output", output_dims, output_data);
     }
+    return tester;
+  };
 
+  int min_cuda_architecture = use_float16 ? 530 : 0;
+  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
+  if (enable_cuda) {
+    auto tester = make_tester();
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
     execution_providers.push_back(DefaultCudaExecutionProvider());
-    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    tester->Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+
+  if (!use_float16) {
+    auto tester = make_tester();
+    tester->SetOutputAbsErr("output", 1e-4f);
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester->Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
 
+// Reference of the gated (Mixtral style) experts with top k routing.
+static std::vector<float> ReferenceGatedMoE(const std::vector<float>& input,
+                                            const std::vector<float>& router_probs,
+                                            const std::vector<float>& fc1_experts_weights,
+                                            const std::vector<float>& fc2_experts_weights,
+                                            const std::vector<float>& fc3_experts_weights,
+                                            int num_rows, int num_experts, int hidden_size, int inter_size, int k) {
+  std::vector<float> output(static_cast<size_t>(num_rows) * hidden_size, 0.f);
+  for (int row = 0; row < num_rows; ++row) {
+    const float* logits = router_probs.data() + row * num_experts;
+    std::vector<std::pair<float, int>> probs;
+    float max_logit = *std::max_element(logits, logits + num_experts);
+    for (int e = 0; e < num_experts; ++e) {
+      probs.push_back({std::exp(logits[e] - max_logit), e});
+    }
+    std::stable_sort(probs.begin(), probs.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    float selected_sum = 0.f;
+    for (int i = 0; i < k; ++i) {
+      selected_sum += probs[i].first;
+    }
+
+    for (int i = 0; i < k; ++i) {
+      const int e = probs[i].second;
+      const float scale = probs[i].first / selected_sum;
+      std::vector<float> inter(inter_size);
+      for (int j = 0; j < inter_size; ++j) {
+        float fc1 = 0.f;
+        float fc3 = 0.f;
+        for (int h = 0; h < hidden_size; ++h) {
+          const float x = input[row * hidden_size + h];
+          fc1 += x * fc1_experts_weights[(e * hidden_size + h) * inter_size + j];
+          fc3 += x * fc3_experts_weights[(e * hidden_size + h) * inter_size + j];
+        }
+        inter[j] = fc1 / (1.f + std::exp(-fc1)) * fc3;
+      }
+      for (int h = 0; h < hidden_size; ++h) {
+        float fc2 = 0.f;
+        for (int j = 0; j < inter_size; ++j) {
+          fc2 += inter[j] * fc2_experts_weights[(e * inter_size + j) * hidden_size + h];
+        }
+        output[row * hidden_size + h] += scale * fc2;
+      }
+    }
+  }
+  return output;
+}
+
 TEST(MoETest, MoETest_Gelu) {
   int num_rows = 4;
   int num_experts = 4;
@@ -419,5 +490,46 @@ TEST(MoETest, MoETest_Relu) {
              "relu");
 }
 
+TEST(MoETest, MoETest_Mixtral) {
+  constexpr int num_rows = 6;
+  constexpr int num_experts = 8;
+  constexpr int hidden_size = 16;
+  constexpr int inter_size = 32;
+  constexpr int k = 2;
+
+  RandomValueGenerator random{1234};
+  std::vector<float> input = random.Gaussian<float>(std::vector<int64_t>{num_rows, hidden_size}, 0.f, 1.f);
+  std::vector<float> router_probs = random.Gaussian<float>(std::vector<int64_t>{num_rows, num_experts}, 0.f, 1.f);
+  std::vector<float> fc1_experts_weights =
+      random.Gaussian<float>(std::vector<int64_t>{num_experts, hidden_size, inter_size}, 0.f, 0.2f);
+  std::vector<float> fc2_experts_weights =
+      random.Gaussian<float>(std::vector<int64_t>{num_experts, inter_size, hidden_size}, 0.f, 0.2f);
+  std::vector<float> fc3_experts_weights =
+      random.Gaussian<float>(std::vector<int64_t>{num_experts, hidden_size, inter_size}, 0.f, 0.2f);
+  std::vector<float> fc1_experts_bias(num_experts * inter_size, 0.f);
+  std::vector<float> fc2_experts_bias(num_experts * hidden_size, 0.f);
+
+  std::vector<float> output = ReferenceGatedMoE(input, router_probs, fc1_experts_weights, fc2_experts_weights,
+                                                fc3_experts_weights, num_rows, num_experts, hidden_size, inter_size,
+                                                k);
+
+  RunMoETest(input,
+             router_probs,
+             fc1_experts_weights,
+             fc2_experts_weights,
+             fc1_experts_bias,
+             fc2_experts_bias,
+             output,
+             num_rows,
+             num_experts,
+             hidden_size,
+             inter_size,
+             "silu",
+             false,
+             k,
+             fc3_experts_weights,
+             1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
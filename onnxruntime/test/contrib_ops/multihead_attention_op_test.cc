@@ -415,6 +415,18 @@ static void RunMultiHeadAttentionTests(AttentionTestData& data, bool disable_cpu
         data.present_value_data, data.key_padding_mask_data, data.mask_type, data.fp32_output_data,
         data.num_heads, data.batch_size, data.sequence_length, data.kv_sequence_length, data.hidden_size,
         data.v_hidden_size, kernel_type, use_float16, data.is_static_kv, disable_cpu, disable_cuda);
+
+    // Run the CPU kernel again with tiled attention forced on for any sequence length.
+    if (!disable_cpu) {
+      ScopedEnvironmentVariables scoped_env_vars{
+          EnvVarMap{{onnxruntime::contrib::attention::kMinSeqLenForCpuFlashAttention, "1"}}};
+      RunMultiHeadAttentionKernel(
+          data.query_data, data.key_data, data.value_data, data.kv_data, data.qkv_data, data.bias_data,
+          data.rel_pos_bias_data, data.past_key_data, data.past_value_data, data.present_key_data,
+          data.present_value_data, data.key_padding_mask_data, data.mask_type, data.fp32_output_data,
+          data.num_heads, data.batch_size, data.sequence_length, data.kv_sequence_length, data.hidden_size,
+          data.v_hidden_size, kernel_type, use_float16, data.is_static_kv, disable_cpu, true);
+    }
   }
 
   if (data.fp16_output_data.size() > 0) {
@@ -578,6 +590,56 @@ TEST(MultiHeadAttentionTest, SelfAttention_WithPastAndPresent_NoMask_NoRelPosBia
   RunMultiHeadAttentionTests(data, /*disable_cpu=*/false, /*disable_cuda=*/true);
 }
 
+TEST(MultiHeadAttentionTest, CrossAttention_KeyValueBatchBroadcast) {
+  // Whisper decoder cross attention with the past key/value of one batch entry shared by its two beams.
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 2;
+  constexpr int kv_sequence_length = 3;
+  constexpr int hidden_size = num_heads * head_size;
+
+  const std::vector<float> query_data = {0.5f, -1.0f, 1.5f, 0.25f,
+                                         -0.75f, 2.0f, 0.0f, -1.25f};
+  const std::vector<float> key_data = {0.1f, 0.2f, -0.3f, 0.4f, 0.5f, -0.6f,
+                                       0.7f, -0.8f, 0.9f, 1.0f, -1.1f, 1.2f};
+  const std::vector<float> value_data = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f,
+                                         -1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f};
+
+  std::vector<float> output_data(batch_size * hidden_size);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const float* q = query_data.data() + b * hidden_size + n * head_size;
+      const float* k = key_data.data() + n * kv_sequence_length * head_size;
+      const float* v = value_data.data() + n * kv_sequence_length * head_size;
+      float scores[kv_sequence_length];
+      float sum = 0.0f;
+      for (int l = 0; l < kv_sequence_length; l++) {
+        scores[l] = std::exp((q[0] * k[l * head_size] + q[1] * k[l * head_size + 1]) * scale);
+        sum += scores[l];
+      }
+      for (int h = 0; h < head_size; h++) {
+        float value = 0.0f;
+        for (int l = 0; l < kv_sequence_length; l++) {
+          value += scores[l] / sum * v[l * head_size + h];
+        }
+        output_data[b * hidden_size + n * head_size + h] = value;
+      }
+    }
+  }
+
+  OpTester tester("MultiHeadAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+  tester.AddInput<float>("query", {batch_size, 1, hidden_size}, query_data);
+  tester.AddInput<float>("key", {1, num_heads, kv_sequence_length, head_size}, key_data);
+  tester.AddInput<float>("value", {1, num_heads, kv_sequence_length, head_size}, value_data);
+  tester.AddOutput<float>("output", {batch_size, 1, hidden_size}, output_data, /*sort*/ false, 0.0f, 1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 // This test is disabled since it is not used in Whisper anymore, and it fails in ROCm.
 TEST(MultiHeadAttentionTest, DISABLED_CrossAttention_WithPastPassedInDirectly_NoMask) {
   // Whisper decoder cross attention with past_kv in place of current KV and no present_kv
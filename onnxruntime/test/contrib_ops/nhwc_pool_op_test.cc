@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// Test module for NHWC fp32 internal pooling operators
+//
+
+#include <algorithm>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+#ifndef DISABLE_CONTRIB_OPS
+
+namespace {
+
+// Reference 2D pooling over an NHWC input with symmetric padding and unit dilations.
+std::vector<float> NhwcPool2D(const std::vector<float>& x, const std::vector<int64_t>& x_shape, bool is_max_pool,
+                              bool count_include_pad, int64_t kernel, int64_t pad, int64_t stride,
+                              std::vector<int64_t>& y_shape) {
+  const int64_t N = x_shape[0], H = x_shape[1], W = x_shape[2], C = x_shape[3];
+  const int64_t out_h = (H + 2 * pad - kernel) / stride + 1;
+  const int64_t out_w = (W + 2 * pad - kernel) / stride + 1;
+  y_shape = {N, out_h, out_w, C};
+
+  std::vector<float> y;
+  y.reserve(static_cast<size_t>(N * out_h * out_w * C));
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t oh = 0; oh < out_h; ++oh) {
+      for (int64_t ow = 0; ow < out_w; ++ow) {
+        for (int64_t c = 0; c < C; ++c) {
+          float acc = is_max_pool ? std::numeric_limits<float>::lowest() : 0.0f;
+          int64_t count = 0;
+          for (int64_t kh = 0; kh < kernel; ++kh) {
+            for (int64_t kw = 0; kw < kernel; ++kw) {
+              const int64_t ih = oh * stride - pad + kh;
+              const int64_t iw = ow * stride - pad + kw;
+              if (ih < 0 || ih >= H || iw < 0 || iw >= W) {
+                continue;
+              }
+              const float value = x[static_cast<size_t>(((n * H + ih) * W + iw) * C + c)];
+              acc = is_max_pool ? std::max(acc, value) : acc + value;
+              ++count;
+            }
+          }
+          if (!is_max_pool) {
+            acc /= static_cast<float>(count_include_pad ? kernel * kernel : count);
+          }
+          y.push_back(acc);
+        }
+      }
+    }
+  }
+  return y;
+}
+
+std::vector<float> MakeInput(const std::vector<int64_t>& shape) {
+  size_t size = 1;
+  for (int64_t dim : shape) {
+    size *= static_cast<size_t>(dim);
+  }
+  std::vector<float> x(size);
+  for (size_t i = 0; i < size; ++i) {
+    x[i] = static_cast<float>((i * 37) % 101) / 16.0f - 3.0f;
+  }
+  return x;
+}
+
+void RunNhwcPool2DTest(bool is_max_pool, bool count_include_pad, const std::vector<int64_t>& x_shape,
+                       int64_t kernel, int64_t pad, int64_t stride) {
+  const std::vector<float> x = MakeInput(x_shape);
+  std::vector<int64_t> y_shape;
+  const std::vector<float> y = NhwcPool2D(x, x_shape, is_max_pool, count_include_pad, kernel, pad, stride, y_shape);
+
+  OpTester test(is_max_pool ? "MaxPool" : "AveragePool", is_max_pool ? 12 : 11, onnxruntime::kMSInternalNHWCDomain);
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{kernel, kernel});
+  test.AddAttribute("pads", std::vector<int64_t>{pad, pad, pad, pad});
+  test.AddAttribute("strides", std::vector<int64_t>{stride, stride});
+  if (!is_max_pool) {
+    test.AddAttribute("count_include_pad", static_cast<int64_t>(count_include_pad));
+  }
+  test.AddInput<float>("X", x_shape, x);
+  test.AddOutput<float>("Y", y_shape, y);
+  test.Run();
+}
+
+}  // namespace
+
+TEST(NhwcFp32PoolOpTest, MaxPool2D) {
+  for (int64_t channels : {1, 3, 16, 37}) {
+    RunNhwcPool2DTest(true, false, {2, 15, 19, channels}, 3, 1, 1);
+  }
+}
+
+TEST(NhwcFp32PoolOpTest, MaxPoolStrides) {
+  RunNhwcPool2DTest(true, false, {1, 23, 19, 32}, 3, 0, 2);
+}
+
+TEST(NhwcFp32PoolOpTest, AvgPoolExcludePad) {
+  for (int64_t channels : {1, 3, 16, 37}) {
+    RunNhwcPool2DTest(false, false, {2, 15, 19, channels}, 3, 1, 1);
+  }
+}
+
+TEST(NhwcFp32PoolOpTest, AvgPoolIncludePad) {
+  RunNhwcPool2DTest(false, true, {1, 13, 11, 24}, 3, 1, 2);
+}
+
+TEST(NhwcFp32PoolOpTest, GlobalAveragePool) {
+  const std::vector<int64_t> x_shape{2, 5, 7, 6};
+  const std::vector<float> x = MakeInput(x_shape);
+  std::vector<float> y(2 * 6, 0.0f);
+  for (size_t n = 0; n < 2; ++n) {
+    for (size_t i = 0; i < 5 * 7; ++i) {
+      for (size_t c = 0; c < 6; ++c) {
+        y[n * 6 + c] += x[(n * 5 * 7 + i) * 6 + c] / 35.0f;
+      }
+    }
+  }
+
+  OpTester test("GlobalAveragePool", 1, onnxruntime::kMSInternalNHWCDomain);
+  test.AddInput<float>("X", x_shape, x);
+  test.AddOutput<float>("Y", {2, 1, 1, 6}, y);
+  test.SetOutputRelErr("Y", 1e-5f);
+  test.Run();
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+}  // namespace test
+}  // namespace onnxruntime
@@ -33,8 +33,9 @@ static void RunPackedAttentionTest(
     const std::vector<float>& relative_position_bias_data) {
   int min_cuda_architecture = use_float16 ? 530 : 0;
   bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
+  bool enable_cpu = !use_float16;
 
-  if (enable_cuda) {
+  if (enable_cuda || enable_cpu) {
     OpTester tester("PackedAttention", 1, onnxruntime::kMSDomain);
     tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
 
@@ -89,7 +90,12 @@ static void RunPackedAttentionTest(
     }
 
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
+    if (enable_cuda) {
+      execution_providers.push_back(DefaultCudaExecutionProvider());
+    }
+    if (enable_cpu) {
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+    }
     tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
@@ -382,6 +388,108 @@ TEST(PackedAttentionTest, PackedBatchWithQKV) {
       qkv_sizes);
 }
 
+// Runs RemovePadding -> PackedAttention -> RestorePadding, the padding-free pipeline of BERT models.
+class PackedAttentionPipelineTester : public OpTester {
+ public:
+  explicit PackedAttentionPipelineTester(int64_t number_of_heads)
+      : OpTester("PackedAttention", 1, onnxruntime::kMSDomain), number_of_heads_(number_of_heads) {
+  }
+
+ protected:
+  void AddNodes(onnxruntime::Graph& graph,
+                std::vector<onnxruntime::NodeArg*>& graph_input_defs,
+                std::vector<onnxruntime::NodeArg*>& graph_output_defs,
+                std::vector<std::function<void(onnxruntime::Node& node)>>& /*add_attribute_funcs*/) override {
+    ASSERT_EQ(graph_input_defs.size(), 4u);
+    ASSERT_EQ(graph_output_defs.size(), 1u);
+
+    NodeArg* input = graph_input_defs[0];
+    NodeArg* sequence_token_count = graph_input_defs[1];
+    NodeArg* weight = graph_input_defs[2];
+    NodeArg* bias = graph_input_defs[3];
+
+    ONNX_NAMESPACE::TypeProto float_type;
+    float_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    ONNX_NAMESPACE::TypeProto int32_type;
+    int32_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+
+    auto& packed_input = graph.GetOrCreateNodeArg("packed_input", &float_type);
+    auto& token_offset = graph.GetOrCreateNodeArg("token_offset", &int32_type);
+    auto& cumulated_seq_len = graph.GetOrCreateNodeArg("cumulated_seq_len", &int32_type);
+    auto& max_token_count = graph.GetOrCreateNodeArg("max_token_count", &int32_type);
+    auto& packed_output = graph.GetOrCreateNodeArg("packed_output", &float_type);
+
+    graph.AddNode("remove_padding", "RemovePadding", "", {input, sequence_token_count},
+                  {&packed_input, &token_offset, &cumulated_seq_len, &max_token_count}, nullptr, kMSDomain);
+    auto& attention = graph.AddNode("packed_attention", "PackedAttention", "",
+                                    {&packed_input, weight, bias, &token_offset, &cumulated_seq_len},
+                                    {&packed_output}, nullptr, kMSDomain);
+    attention.AddAttribute("num_heads", number_of_heads_);
+    graph.AddNode("restore_padding", "RestorePadding", "", {&packed_output, &token_offset},
+                  {graph_output_defs[0]}, nullptr, kMSDomain);
+  }
+
+ private:
+  int64_t number_of_heads_;
+};
+
+TEST(PackedAttentionTest, RemovePaddingPackedAttentionRestorePadding) {
+  int batch_size = 2;
+  int sequence_length = 4;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+
+  // The same two tokens in both sequences, as in PackedBatch, followed by padding with values that must not leak
+  // into the attention of the real tokens.
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,   // b0:s0
+      0.5f, 0.2f, 0.3f, -0.6f,  // b0:s1
+      9.0f, 9.0f, 9.0f, 9.0f,   // b0:s2 (padding)
+      9.0f, 9.0f, 9.0f, 9.0f,   // b0:s3 (padding)
+      0.8f, -0.5f, 0.0f, 1.f,   // b1:s0
+      0.5f, 0.2f, 0.3f, -0.6f,  // b1:s1
+      9.0f, 9.0f, 9.0f, 9.0f,   // b1:s2 (padding)
+      9.0f, 9.0f, 9.0f, 9.0f    // b1:s3 (padding)
+  };
+
+  std::vector<int32_t> sequence_token_count_data = {2, 2};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      0.0f, 0.0f, 0.0f, 0.0f,
+      0.0f, 0.0f, 0.0f, 0.0f,
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      0.0f, 0.0f, 0.0f, 0.0f,
+      0.0f, 0.0f, 0.0f, 0.0f};
+
+  std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> sequence_token_count_dims = {batch_size};
+  std::vector<int64_t> weights_dims = {hidden_size, 3 * hidden_size};
+  std::vector<int64_t> bias_dims = {3 * hidden_size};
+
+  PackedAttentionPipelineTester tester(number_of_heads);
+  tester.AddInput<float>("input", input_dims, input_data);
+  tester.AddInput<int32_t>("sequence_token_count", sequence_token_count_dims, sequence_token_count_data);
+  tester.AddInput<float>("weight", weights_dims, weight_data);
+  tester.AddInput<float>("bias", bias_dims, bias_data);
+  tester.AddOutput<float>("output", input_dims, output_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 static void RunModelWithRandomInput(
     int64_t batch_size,
     int64_t sequence_length,
@@ -13,6 +13,7 @@
 #include "test/providers/provider_test_utils.h"
 #include "core/util/qmath.h"
 #include "core/quantization/quantization.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 namespace test {
@@ -980,6 +981,112 @@ TEST(QAttentionTest, QAttentionPrunedModel) {
                    input_hidden_size);
 }
 
+// Compares the int8 attention path against a reference computed in double precision from the dequantized inputs.
+static void TestQAttentionInt8Attention(int batch_size, int sequence_length, int hidden_size, int number_of_heads,
+                                        const std::vector<int32_t>& mask_index_data, bool is_unidirectional) {
+  const int head_size = hidden_size / number_of_heads;
+  constexpr float input_scale = 0.02f;
+  constexpr uint8_t input_zero_point = 128;
+  constexpr float weight_scale = 0.001f;
+
+  RandomValueGenerator random{};
+  std::vector<int64_t> input_dims{batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> weight_dims{hidden_size, 3 * hidden_size};
+  std::vector<int64_t> bias_dims{3 * hidden_size};
+  std::vector<uint8_t> input_data = random.Uniform<uint8_t>(input_dims, 0, 255);
+  std::vector<int8_t> weight_data = random.Uniform<int8_t>(weight_dims, -127, 127);
+  std::vector<float> bias_data = random.Gaussian<float>(bias_dims, 0.0f, 0.3f);
+
+  // qkv(3, B, N, S, H)
+  std::vector<double> qkv(3 * static_cast<size_t>(batch_size) * sequence_length * hidden_size);
+  for (int b = 0; b < batch_size; b++) {
+    for (int s = 0; s < sequence_length; s++) {
+      for (int o = 0; o < 3 * hidden_size; o++) {
+        double sum = bias_data[o];
+        for (int d = 0; d < hidden_size; d++) {
+          sum += (input_data[(b * sequence_length + s) * hidden_size + d] - input_zero_point) * input_scale *
+                 weight_data[d * 3 * hidden_size + o] * weight_scale;
+        }
+        const int qkv_index = o / hidden_size;
+        const int head_index = (o % hidden_size) / head_size;
+        qkv[((((qkv_index * batch_size) + b) * number_of_heads + head_index) * sequence_length + s) * head_size +
+            o % head_size] = sum;
+      }
+    }
+  }
+
+  const size_t qkv_size = static_cast<size_t>(batch_size) * sequence_length * hidden_size;
+  std::vector<float> output_data(qkv_size);
+  std::vector<double> scores(sequence_length);
+  for (int b = 0; b < batch_size; b++) {
+    const int valid_length = mask_index_data.empty() ? sequence_length : mask_index_data[b];
+    for (int n = 0; n < number_of_heads; n++) {
+      const size_t head_offset = (static_cast<size_t>(b) * number_of_heads + n) * sequence_length * head_size;
+      const double* q = qkv.data() + head_offset;
+      const double* k = q + qkv_size;
+      const double* v = k + qkv_size;
+      for (int s = 0; s < sequence_length; s++) {
+        double score_max = std::numeric_limits<double>::lowest();
+        for (int t = 0; t < sequence_length; t++) {
+          double score = 0.0;
+          for (int h = 0; h < head_size; h++) {
+            score += q[s * head_size + h] * k[t * head_size + h];
+          }
+          scores[t] = score / std::sqrt(static_cast<double>(head_size));
+          if (t >= valid_length || (is_unidirectional && t > s)) {
+            scores[t] -= 10000.0;
+          }
+          score_max = std::max(score_max, scores[t]);
+        }
+        double sum = 0.0;
+        for (auto& score : scores) {
+          score = std::exp(score - score_max);
+          sum += score;
+        }
+        for (int h = 0; h < head_size; h++) {
+          double value = 0.0;
+          for (int t = 0; t < sequence_length; t++) {
+            value += scores[t] / sum * v[t * head_size + h];
+          }
+          output_data[(b * sequence_length + s) * hidden_size + n * head_size + h] = static_cast<float>(value);
+        }
+      }
+    }
+  }
+
+  OpTester tester("QAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  if (is_unidirectional) {
+    tester.AddAttribute<int64_t>("unidirectional", 1);
+  }
+  tester.AddInput<uint8_t>("input", input_dims, input_data);
+  tester.AddInput<int8_t>("weight", weight_dims, weight_data, true);
+  tester.AddInput<float>("bias", bias_dims, bias_data);
+  tester.AddInput<float>("input_scale", {1}, {input_scale});
+  tester.AddInput<float>("weight_scale", {1}, {weight_scale});
+  if (mask_index_data.empty()) {
+    tester.AddOptionalInputEdge<int32_t>();
+  } else {
+    tester.AddInput<int32_t>("mask_index", {batch_size}, mask_index_data);
+  }
+  tester.AddInput<uint8_t>("input_zero_point", {1}, {input_zero_point});
+  tester.AddInput<int8_t>("weight_zero_point", {1}, {0});
+  tester.AddOutput<float>("output", input_dims, output_data, /*sort_output*/ false, 0.03f, 0.03f);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsQAttentionInt8Attention, "1"));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(QAttentionTest, QAttentionInt8Attention) {
+  TestQAttentionInt8Attention(2, 24, 64, 4, {24, 17}, false);
+  TestQAttentionInt8Attention(1, 37, 48, 3, {}, false);
+  TestQAttentionInt8Attention(2, 16, 64, 2, {}, true);
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(QAttentionTest, SharedPrepackedWeights) {
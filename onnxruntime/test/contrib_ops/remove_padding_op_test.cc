@@ -21,7 +21,7 @@ static void RunRemovePadding(
     int hidden_size,
     int total_tokens,
     bool use_float16 = false,
-    const bool disable_cpu = true,
+    const bool disable_cpu = false,
     const bool disable_cuda = false,
     const bool disable_rocm = true) {
   int min_cuda_architecture = use_float16 ? 530 : 0;
@@ -94,7 +94,7 @@ static void RunRemovePaddingTests(
     int hidden_size,
     int total_tokens) {
   bool use_float16 = false;
-  constexpr bool disable_cpu = true;
+  constexpr bool disable_cpu = false;
   constexpr bool disable_cuda = false;
   constexpr bool disable_rocm = true;
   RunRemovePadding(input_data, sequence_token_count_data, output_data, token_offset_data, cumulated_seq_len_data,
@@ -73,7 +73,7 @@ static void RunTest(
   if (enable_dml && !disable_dml) {
     execution_providers.push_back(DefaultDmlExecutionProvider());
   }
-  if (tensor_type == TensorType::kFloat && !disable_cpu) {
+  if (tensor_type != TensorType::kBFloat16 && !disable_cpu) {
     execution_providers.push_back(DefaultCpuExecutionProvider());
   }
   if (execution_providers.size() == 0) {
@@ -186,6 +186,24 @@ static void RunTests(const std::vector<float>& input_data,
             false, /* disable_cuda*/
             disable_dml || false /* disable_dml */);
 
+    // FP16 test for CPU
+    RunTest(input_data,
+            position_ids,
+            cos_cache,
+            sin_cache,
+            output_data,
+            batch_size,
+            sequence_length,
+            head_size,
+            rotary_embedding_dim,
+            num_heads,
+            max_sequence_length,
+            interleaved,
+            TensorType::kFloat16,
+            false, /* disable_cpu */
+            true,  /* disable_cuda*/
+            true /* disable_dml */);
+
     // RunTest(input_data,
     //         position_ids,
     //         cos_cache,
@@ -2,11 +2,22 @@
 // Licensed under the MIT License.
 
 #include <memory>
+#include <utility>
 #include <vector>
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
+#include "core/platform/env.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/util/thread_utils.h"
+#include "contrib_ops/cpu/transformers/logits_processor.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+#include "contrib_ops/cpu/transformers/sampling.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
 
@@ -155,6 +166,153 @@ TEST(SamplingTest, Gpt2Sampling_CPU) {
 
   ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
 }
+
+// A prompt that starts with an earlier prompt of 16 tokens, the block size of the prefix cache, runs only its last tokens
+// from the cached state of the earlier prompt. Sequences are the same with and without the cache, and with prompts run
+// in chunks.
+TEST(SamplingTest, Gpt2Sampling_CPU_Prefill) {
+  const std::vector<int32_t> prefix{41, 554, 74, 622, 206, 222, 75, 223, 221, 198, 224, 572, 52, 328, 219, 328};
+  std::vector<int32_t> prompt = prefix;
+  prompt.insert(prompt.end(), {206, 288, 227, 896});
+  constexpr int32_t max_length = 24;
+
+  auto create_session = [](const std::vector<std::pair<const char*, const char*>>& config_entries,
+                           std::unique_ptr<InferenceSessionWrapper>& session) {
+    SessionOptions so;
+    for (const auto& entry : config_entries) {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(entry.first, entry.second));
+    }
+    session = std::make_unique<InferenceSessionWrapper>(so, GetEnvironment());
+    ASSERT_STATUS_OK(session->Load(ORT_TSTR("testdata/transformers/tiny_gpt2_sampling.onnx")));
+    ASSERT_STATUS_OK(session->Initialize());
+  };
+
+  auto run = [](InferenceSessionWrapper& session, const std::vector<int32_t>& input_ids,
+                std::vector<int32_t>& sequence) {
+    AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+    OrtValue input_ids_value, max_length_value, min_length_value, repetition_penalty_value;
+    CreateMLValue<int32_t>(allocator, {1, static_cast<int64_t>(input_ids.size())}, input_ids, &input_ids_value);
+    CreateMLValue<int32_t>(allocator, {1}, {max_length}, &max_length_value);
+    CreateMLValue<int32_t>(allocator, {1}, {1}, &min_length_value);
+    CreateMLValue<float>(allocator, {1}, {1.0f}, &repetition_penalty_value);
+    NameMLValMap feeds{{"input_ids", input_ids_value},
+                       {"max_length", max_length_value},
+                       {"min_length", min_length_value},
+                       {"repetition_penalty", repetition_penalty_value}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(feeds, {"sequences"}, &fetches));
+    gsl::span<const int32_t> result = fetches[0].Get<Tensor>().DataAsSpan<int32_t>();
+    sequence.assign(result.begin(), result.end());
+  };
+
+  auto get_prefix_cache = [](const InferenceSessionWrapper& session) -> const contrib::transformers::PrefixKVCache* {
+    for (const Node& node : session.GetGraph().Nodes()) {
+      if (node.OpType() == "Sampling") {
+        const OpKernel* kernel = session.GetSessionState().GetKernel(node.Index());
+        return static_cast<const contrib::transformers::Sampling*>(kernel)->GetPrefixCache();
+      }
+    }
+    return nullptr;
+  };
+
+  std::unique_ptr<InferenceSessionWrapper> session;
+  create_session({}, session);
+  std::vector<int32_t> expected_prefix_sequence, expected_sequence;
+  run(*session, prefix, expected_prefix_sequence);
+  run(*session, prompt, expected_sequence);
+  ASSERT_EQ(expected_sequence.size(), static_cast<size_t>(max_length));
+
+  std::unique_ptr<InferenceSessionWrapper> cached_session;
+  create_session({{kOrtSessionOptionsGenerationPrefixCacheBytes, "1048576"}}, cached_session);
+  const contrib::transformers::PrefixKVCache* prefix_cache = get_prefix_cache(*cached_session);
+  ASSERT_NE(prefix_cache, nullptr);
+
+  std::vector<int32_t> sequence;
+  run(*cached_session, prefix, sequence);
+  EXPECT_EQ(sequence, expected_prefix_sequence);
+  EXPECT_EQ(prefix_cache->EntryCount(), 1u);
+  EXPECT_EQ(prefix_cache->HitCount(), 0u);
+
+  run(*cached_session, prompt, sequence);
+  EXPECT_EQ(sequence, expected_sequence);
+  EXPECT_EQ(prefix_cache->EntryCount(), 2u);
+  EXPECT_EQ(prefix_cache->HitCount(), 1u);
+
+  run(*cached_session, prompt, sequence);
+  EXPECT_EQ(sequence, expected_sequence);
+  EXPECT_EQ(prefix_cache->EntryCount(), 2u);
+  EXPECT_EQ(prefix_cache->HitCount(), 2u);
+
+  // The chunks of the longer prompt start after the cached prefix.
+  std::unique_ptr<InferenceSessionWrapper> chunked_cached_session;
+  create_session({{kOrtSessionOptionsGenerationPrefixCacheBytes, "1048576"},
+                  {kOrtSessionOptionsGenerationPrefillChunkSize, "3"}},
+                 chunked_cached_session);
+  prefix_cache = get_prefix_cache(*chunked_cached_session);
+  ASSERT_NE(prefix_cache, nullptr);
+  run(*chunked_cached_session, prefix, sequence);
+  EXPECT_EQ(sequence, expected_prefix_sequence);
+  run(*chunked_cached_session, prompt, sequence);
+  EXPECT_EQ(sequence, expected_sequence);
+  EXPECT_EQ(prefix_cache->HitCount(), 1u);
+
+  std::unique_ptr<InferenceSessionWrapper> chunked_session;
+  create_session({{kOrtSessionOptionsGenerationPrefillChunkSize, "5"}}, chunked_session);
+  EXPECT_EQ(get_prefix_cache(*chunked_session), nullptr);
+  run(*chunked_session, prompt, sequence);
+  EXPECT_EQ(sequence, expected_sequence);
+}
 #endif
+
+// The presence penalty of each row is taken from the row of the presence mask of its batch entry, with the rows of the
+// batch processed in parallel on the intra-op pool.
+TEST(SamplingTest, PresencePenaltyProcessesRowsInParallel) {
+  constexpr int batch_size = 4;
+  constexpr int vocab_size = 32000;
+  constexpr int sequence_length = 3;
+  constexpr int max_length = 8;
+
+  std::vector<int32_t> sequences_buffer(2 * batch_size * max_length, 0);
+  contrib::transformers::Sequences sequences;
+  sequences.Init(sequences_buffer, batch_size, sequence_length, max_length);
+
+  // each row of the mask penalizes different tokens, some of them more than once
+  std::vector<int32_t> presence_mask(batch_size * vocab_size, 0);
+  for (int b = 0; b < batch_size; b++) {
+    for (int j = b; j < vocab_size; j += 7 + b) {
+      presence_mask[b * vocab_size + j] = 1 + (j % 3);
+    }
+  }
+
+  contrib::transformers::SamplingParameters parameters{};
+  parameters.batch_size = batch_size;
+  parameters.vocab_size = vocab_size;
+  parameters.repetition_penalty = 1.0f;
+  parameters.temperature = 0.7f;
+  parameters.presence_penalty = 1.5f;
+  parameters.presence_mask = presence_mask;
+
+  std::vector<float> scores(batch_size * vocab_size);
+  for (size_t i = 0; i < scores.size(); i++) {
+    scores[i] = static_cast<float>((i * 7919) % 1000) / 100.0f - 5.0f;
+  }
+
+  std::vector<float> expected = scores;
+  for (size_t i = 0; i < expected.size(); i++) {
+    expected[i] /= parameters.temperature;
+    expected[i] -= presence_mask[i] * parameters.presence_penalty;
+  }
+
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  contrib::transformers::LogitsProcessorList processors;
+  processors.Init(parameters, tp.get());
+  gsl::span<float> next_token_scores(scores);
+  processors.Process(&sequences, next_token_scores, 1);
+
+  EXPECT_EQ(scores, expected);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -96,9 +96,7 @@ static void RunOneTest(
       execution_providers.push_back(DefaultCpuExecutionProvider());
     }
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
-  } else if (HasCudaEnvironment(530 /*min_cuda_architecture*/) ||
-             dml_ep != nullptr ||
-             rocm_ep != nullptr) {
+  } else {
     OpTester test(op_type.c_str(), 1, onnxruntime::kMSDomain);
     test.AddInput<MLFloat16>("input", input_dims, ToFloat16(input_data));
     test.AddInput<MLFloat16>("skip", skip_dims, ToFloat16(skip_data));
@@ -136,6 +134,9 @@ static void RunOneTest(
       execution_providers.push_back(DefaultDmlExecutionProvider());
     } else if (rocm_ep != nullptr) {
       execution_providers.push_back(DefaultRocmExecutionProvider());
+    } else if (!HasCudaEnvironment(530 /*min_cuda_architecture*/)) {
+      // The CPU kernel normalizes fp16 rows in fp32.
+      execution_providers.push_back(DefaultCpuExecutionProvider());
     } else {
       if (strict) {
         const auto& api = Ort::GetApi();
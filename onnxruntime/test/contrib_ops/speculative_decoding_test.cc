@@ -0,0 +1,415 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_cxx_api.h"
+#include "contrib_ops/cpu/transformers/speculative_decoding.h"
+
+extern std::unique_ptr<Ort::Env> ort_env;
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::DecoderConfig;
+using contrib::transformers::SpeculativeDecoding;
+using contrib::transformers::SpeculativeDecodingOptions;
+using contrib::transformers::SpeculativeProcessScoresFunc;
+
+namespace {
+
+constexpr int kVocabSize = 13;
+constexpr int kEosTokenId = 12;
+
+// Scores of the token after a history, from a hash of the history. Histories whose hash is a multiple of
+// disagree_every get different scores, which makes a draft model that only partially agrees with the main model.
+void ComputeScores(const std::vector<int32_t>& history, int disagree_every, float* scores) {
+  int64_t hash = 0;
+  for (size_t t = 0; t < history.size(); t++) {
+    hash = (hash * 31 + (history[t] + 1) * 7 + static_cast<int64_t>(t)) % 1000003;
+  }
+  const bool disagree = disagree_every > 0 && hash % disagree_every == 0;
+  for (int v = 0; v < kVocabSize; v++) {
+    scores[v] = static_cast<float>((hash + v * (disagree ? 3 : 5)) % kVocabSize);
+  }
+}
+
+// A fake GPT decoder. The present state stores (token, position) of every token of the sequence, so the logits
+// can only be right when the past state passed back holds exactly the accepted tokens.
+class FakeDecoder {
+ public:
+  FakeDecoder(const DecoderConfig& config, int disagree_every)
+      : config_(config), disagree_every_(disagree_every), allocator_(std::make_shared<CPUAllocator>()) {}
+
+  Status Run(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+    runs_++;
+    const Tensor& input_ids = feeds[0].Get<Tensor>();
+    const Tensor& position_ids = feeds[1].Get<Tensor>();
+    const int64_t sequence_length = input_ids.Shape()[1];
+    const int64_t total_length = feeds[2].Get<Tensor>().Shape()[1];
+    const int64_t past_length = total_length - sequence_length;
+
+    fetches.clear();
+    OrtValue logits;
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({1, sequence_length, kVocabSize}),
+                         allocator_, logits);
+    fetches.push_back(logits);
+
+    std::vector<int32_t> history;
+    for (int layer = 0; layer < config_.num_layers; layer++) {
+      const Tensor& past = feeds[3 + layer].Get<Tensor>();
+      ORT_RETURN_IF_NOT(past.Shape() == TensorShape({2, 1, config_.num_heads, past_length, config_.head_size}),
+                        "past shape mismatch");
+      OrtValue present;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<float>(),
+                           TensorShape({2, 1, config_.num_heads, total_length, config_.head_size}),
+                           allocator_, present);
+      const float* past_data = past.Data<float>();
+      float* present_data = present.GetMutable<Tensor>()->MutableData<float>();
+      for (int64_t i = 0; i < 2 * config_.num_heads; i++) {
+        float* dest = present_data + i * total_length * config_.head_size;
+        std::copy(past_data + i * past_length * config_.head_size,
+                  past_data + (i + 1) * past_length * config_.head_size, dest);
+        for (int64_t s = 0; s < sequence_length; s++) {
+          dest[(past_length + s) * config_.head_size] = static_cast<float>(input_ids.Data<int32_t>()[s]);
+          dest[(past_length + s) * config_.head_size + 1] = static_cast<float>(position_ids.Data<int32_t>()[s]);
+        }
+      }
+
+      if (layer == 0) {
+        for (int64_t t = 0; t < total_length; t++) {
+          ORT_RETURN_IF_NOT(present_data[t * config_.head_size + 1] == static_cast<float>(t), "wrong past state");
+          history.push_back(static_cast<int32_t>(present_data[t * config_.head_size]));
+        }
+      }
+      fetches.push_back(present);
+    }
+
+    float* logits_data = fetches[0].GetMutable<Tensor>()->MutableData<float>();
+    for (int64_t s = 0; s < sequence_length; s++) {
+      std::vector<int32_t> prefix(history.begin(), history.begin() + past_length + s + 1);
+      ComputeScores(prefix, disagree_every_, logits_data + s * kVocabSize);
+    }
+    return Status::OK();
+  }
+
+  int Runs() const { return runs_; }
+
+ private:
+  DecoderConfig config_;
+  int disagree_every_;
+  AllocatorPtr allocator_;
+  int runs_ = 0;
+};
+
+// Sets the scores of even tokens to -inf, like a vocabulary mask.
+void BanEvenTokens(gsl::span<float> scores) {
+  for (size_t v = 0; v < scores.size(); v += 2) {
+    scores[v] = -std::numeric_limits<float>::infinity();
+  }
+}
+
+// Greedy decoding with the main model alone.
+std::vector<int32_t> GreedyReference(const std::vector<int32_t>& input_ids, int max_length, int eos_token_id,
+                                     bool ban_even_tokens = false) {
+  std::vector<int32_t> sequence = input_ids;
+  std::vector<float> scores(kVocabSize);
+  while (static_cast<int>(sequence.size()) < max_length) {
+    ComputeScores(sequence, 0, scores.data());
+    if (ban_even_tokens) {
+      BanEvenTokens(scores);
+    }
+    const int32_t token = static_cast<int32_t>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+    sequence.push_back(token);
+    if (token == eos_token_id) {
+      break;
+    }
+  }
+  return sequence;
+}
+
+SpeculativeDecodingOptions GetOptions(int num_speculative_tokens, int eos_token_id) {
+  SpeculativeDecodingOptions options;
+  options.decoder = DecoderConfig{3, 2, 4};
+  options.draft_decoder = DecoderConfig{1, 1, 2};
+  options.num_speculative_tokens = num_speculative_tokens;
+  options.vocab_size = kVocabSize;
+  options.eos_token_id = eos_token_id;
+  return options;
+}
+
+struct RunResult {
+  std::vector<int32_t> sequence;
+  int main_runs;
+  int accepted_tokens;
+  int proposed_tokens;
+};
+
+RunResult RunSpeculative(const SpeculativeDecodingOptions& options, int draft_disagree_every,
+                         const std::vector<int32_t>& input_ids, int max_length,
+                         SpeculativeProcessScoresFunc process_scores = nullptr) {
+  FakeDecoder decoder(options.decoder, 0);
+  FakeDecoder draft_decoder(options.draft_decoder, draft_disagree_every);
+  SpeculativeDecoding speculative(
+      options, std::make_shared<CPUAllocator>(),
+      [&decoder](const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+        return decoder.Run(feeds, fetches);
+      },
+      [&draft_decoder](const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+        return draft_decoder.Run(feeds, fetches);
+      },
+      process_scores);
+
+  // Every generated token is streamed once, in order, with the sequence length including it.
+  std::vector<int32_t> streamed_tokens;
+  bool lengths_match = true;
+  auto on_token = [&](int32_t token, int sequence_length) {
+    streamed_tokens.push_back(token);
+    lengths_match = lengths_match && sequence_length == static_cast<int>(input_ids.size() + streamed_tokens.size());
+  };
+
+  RunResult result;
+  EXPECT_TRUE(speculative.Generate(input_ids, max_length, result.sequence, on_token).IsOK());
+  EXPECT_TRUE(std::equal(streamed_tokens.begin(), streamed_tokens.end(), result.sequence.begin() + input_ids.size(),
+                         result.sequence.end()));
+  EXPECT_TRUE(lengths_match);
+  EXPECT_EQ(speculative.DecoderRuns(), decoder.Runs());
+  result.main_runs = decoder.Runs();
+  result.accepted_tokens = speculative.AcceptedTokens();
+  result.proposed_tokens = speculative.ProposedTokens();
+  return result;
+}
+
+}  // namespace
+
+TEST(SpeculativeDecodingTest, GreedyMatchesMainModel) {
+  const std::vector<std::vector<int32_t>> prompts = {{1, 2, 3}, {7}, {4, 4, 9, 0, 11}};
+  for (int k : {0, 1, 3, 5}) {
+    for (const auto& prompt : prompts) {
+      const int max_length = static_cast<int>(prompt.size()) + 20;
+      RunResult result = RunSpeculative(GetOptions(k, kEosTokenId), 3, prompt, max_length);
+      EXPECT_EQ(result.sequence, GreedyReference(prompt, max_length, kEosTokenId)) << "k=" << k;
+      EXPECT_LE(result.accepted_tokens, result.proposed_tokens);
+
+      // Every main decoder run appends its accepted proposals and one more token, unless an accepted proposal is eos.
+      const int generated = static_cast<int>(result.sequence.size() - prompt.size());
+      EXPECT_GE(result.main_runs, generated - result.accepted_tokens);
+      EXPECT_LE(result.main_runs, generated - result.accepted_tokens + 1);
+    }
+  }
+}
+
+TEST(SpeculativeDecodingTest, GreedyUsesProcessedScores) {
+  const std::vector<int32_t> prompt = {1, 2, 3};
+  const int max_length = static_cast<int>(prompt.size()) + 20;
+  const std::vector<int32_t> expected = GreedyReference(prompt, max_length, -1, true);
+  ASSERT_NE(expected, GreedyReference(prompt, max_length, -1));
+
+  bool steps_match = true;
+  auto process_scores = [&prompt, &steps_match](gsl::span<const int32_t> context, int step, gsl::span<float> scores) {
+    steps_match = steps_match && step == static_cast<int>(context.size() - prompt.size()) + 1;
+    BanEvenTokens(scores);
+    const float max_score = *std::max_element(scores.begin(), scores.end());
+    float sum = 0.0f;
+    for (auto& score : scores) {
+      score = std::exp(score - max_score);
+      sum += score;
+    }
+    for (auto& score : scores) {
+      score /= sum;
+    }
+    return Status::OK();
+  };
+
+  for (int k : {1, 3}) {
+    RunResult result = RunSpeculative(GetOptions(k, -1), 3, prompt, max_length, process_scores);
+    EXPECT_EQ(result.sequence, expected) << "k=" << k;
+  }
+  EXPECT_TRUE(steps_match);
+}
+
+TEST(SpeculativeDecodingTest, IdenticalDraftAcceptsAll) {
+  const std::vector<int32_t> prompt = {5, 6};
+  constexpr int k = 4;
+  const int max_length = static_cast<int>(prompt.size()) + 16;
+  // No eos, so that generation always runs to max_length.
+  const std::vector<int32_t> expected = GreedyReference(prompt, max_length, -1);
+  ASSERT_EQ(expected.size(), static_cast<size_t>(max_length));
+
+  RunResult result = RunSpeculative(GetOptions(k, -1), 0, prompt, max_length);
+  EXPECT_EQ(result.sequence, expected);
+  EXPECT_EQ(result.accepted_tokens, result.proposed_tokens);
+
+  // Every main decoder run produces k + 1 tokens, except the last one that is limited by max_length.
+  const int generated = max_length - static_cast<int>(prompt.size());
+  EXPECT_EQ(result.main_runs, (generated + k) / (k + 1));
+}
+
+TEST(SpeculativeDecodingTest, SamplingWithIdenticalDraftAcceptsAll) {
+  SpeculativeDecodingOptions options = GetOptions(3, -1);
+  options.do_sample = true;
+  options.temperature = 0.7f;
+  options.seed = 17;
+  const std::vector<int32_t> prompt = {3, 1, 4, 1, 5};
+  const int max_length = static_cast<int>(prompt.size()) + 12;
+
+  RunResult result = RunSpeculative(options, 0, prompt, max_length);
+  EXPECT_EQ(result.accepted_tokens, result.proposed_tokens);
+  ASSERT_EQ(result.sequence.size(), static_cast<size_t>(max_length));
+  EXPECT_TRUE(std::equal(prompt.begin(), prompt.end(), result.sequence.begin()));
+  for (size_t i = prompt.size(); i < result.sequence.size(); i++) {
+    EXPECT_GE(result.sequence[i], 0);
+    EXPECT_LT(result.sequence[i], kVocabSize);
+  }
+
+  // The same seed gives the same sequence.
+  EXPECT_EQ(RunSpeculative(options, 0, prompt, max_length).sequence, result.sequence);
+}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+namespace {
+
+// Serializes tiny_gpt2_sampling.onnx with its Sampling node changed to op_type. With draft_decoder, the decoder subgraph
+// is copied to the draft_decoder attribute, so that the decoder accepts every proposal. Sampling keeps only the arg max
+// of every distribution, which makes its sequences those of greedy search whatever the random numbers.
+std::string CreateTinyGpt2Model(const std::string& op_type, bool draft_decoder, bool filtered_logits = false) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_THROW_IF_ERROR(Model::Load(ORT_TSTR("testdata/transformers/tiny_gpt2_sampling.onnx"), model_proto));
+  for (auto& node : *model_proto.mutable_graph()->mutable_node()) {
+    if (node.op_type() != "Sampling") {
+      continue;
+    }
+
+    const std::unordered_set<std::string> sampling_attributes{"temperature", "top_p", "filter_value",
+                                                              "min_tokens_to_keep", "presence_penalty", "custom"};
+    google::protobuf::RepeatedPtrField<ONNX_NAMESPACE::AttributeProto> attributes;
+    for (const auto& attribute : node.attribute()) {
+      if (sampling_attributes.count(attribute.name()) != 0) {
+        continue;
+      }
+      *attributes.Add() = attribute;
+      if (draft_decoder && attribute.name() == "decoder") {
+        ONNX_NAMESPACE::AttributeProto* draft_decoder_attribute = attributes.Add();
+        *draft_decoder_attribute = attribute;
+        draft_decoder_attribute->set_name("draft_decoder");
+      }
+    }
+
+    node.set_op_type(op_type);
+    if (op_type == "GreedySearch") {
+      // Inputs after attention_mask and the filtered_logits output are Sampling only.
+      while (node.input_size() > 7) {
+        node.mutable_input()->RemoveLast();
+      }
+      while (node.output_size() > 1) {
+        node.mutable_output()->RemoveLast();
+      }
+    } else {
+      // A low temperature leaves the arg max as the only token within top_p.
+      auto add_float_attribute = [&attributes](const char* name, float value) {
+        ONNX_NAMESPACE::AttributeProto* attribute = attributes.Add();
+        attribute->set_name(name);
+        attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_FLOAT);
+        attribute->set_f(value);
+      };
+      add_float_attribute("temperature", 1e-6f);
+      add_float_attribute("top_p", 0.5f);
+      ONNX_NAMESPACE::AttributeProto* min_tokens_to_keep = attributes.Add();
+      min_tokens_to_keep->set_name("min_tokens_to_keep");
+      min_tokens_to_keep->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+      min_tokens_to_keep->set_i(1);
+
+      if (filtered_logits) {
+        while (node.output_size() < 2) {
+          node.add_output();
+        }
+        node.set_output(1, "filtered_logits");
+      }
+    }
+    node.mutable_attribute()->Swap(&attributes);
+  }
+
+  std::string model_data;
+  model_proto.SerializeToString(&model_data);
+  return model_data;
+}
+
+// Runs the model on one prompt. Returns the sequence, and the tokens streamed to the callback of the run options.
+std::vector<int32_t> RunTinyGpt2Model(const std::string& model_data, std::vector<int32_t> input_ids,
+                                      int32_t max_length, std::vector<int32_t>& streamed_tokens) {
+  std::vector<int64_t> input_ids_shape{1, static_cast<int64_t>(input_ids.size())};
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length_value{max_length};
+  std::vector<int32_t> min_length_value{1};
+  std::vector<float> repetition_penalty_value{1.0f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, input_ids.data(), input_ids.size(), input_ids_shape.data(), input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, max_length_value.data(), max_length_value.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, min_length_value.data(), min_length_value.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, repetition_penalty_value.data(), repetition_penalty_value.size(),
+                                                parameter_shape.data(), parameter_shape.size()));
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "repetition_penalty"};
+  const char* const output_names[] = {"sequences"};
+
+  streamed_tokens.clear();
+  auto on_tokens = [](void* user_data, const int32_t* tokens, const int32_t* /*beam_indices*/, size_t num_sequences,
+                      size_t /*sequence_length*/) {
+    auto* streamed = static_cast<std::vector<int32_t>*>(user_data);
+    streamed->insert(streamed->end(), tokens, tokens + num_sequences);
+  };
+  Ort::RunOptions run_options;
+  run_options.SetGenerationTokensCallback(on_tokens, &streamed_tokens);
+
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{});
+  auto ort_outputs = session.Run(run_options, input_names, ort_inputs.data(), ort_inputs.size(), output_names, 1);
+  const auto* sequence = ort_outputs[0].GetTensorData<int32_t>();
+  return std::vector<int32_t>(sequence, sequence + max_length);
+}
+
+void TestDraftDecoderMatchesDecoder(const std::string& op_type) {
+  const std::vector<int32_t> prompt{41, 554, 74, 622, 206, 222, 75, 223};
+  constexpr int32_t max_length = 20;
+
+  std::vector<int32_t> expected_streamed_tokens;
+  const std::vector<int32_t> expected = RunTinyGpt2Model(CreateTinyGpt2Model(op_type, false), prompt, max_length,
+                                                         expected_streamed_tokens);
+  ASSERT_FALSE(expected_streamed_tokens.empty());
+
+  std::vector<int32_t> streamed_tokens;
+  EXPECT_EQ(RunTinyGpt2Model(CreateTinyGpt2Model(op_type, true), prompt, max_length, streamed_tokens), expected);
+  EXPECT_EQ(streamed_tokens, expected_streamed_tokens);
+}
+
+}  // namespace
+
+TEST(SpeculativeDecodingTest, GreedySearchWithDraftDecoder) {
+  TestDraftDecoderMatchesDecoder("GreedySearch");
+}
+
+TEST(SpeculativeDecodingTest, SamplingWithDraftDecoder) {
+  TestDraftDecoderMatchesDecoder("Sampling");
+}
+
+TEST(SpeculativeDecodingTest, SamplingWithDraftDecoderRejectsFilteredLogits) {
+  const std::string model_data = CreateTinyGpt2Model("Sampling", true, true);
+  EXPECT_THROW({ Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{}); },
+               Ort::Exception);
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
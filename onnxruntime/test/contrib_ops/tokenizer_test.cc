@@ -814,6 +814,39 @@ TEST(ContribOpTest, TokenizerExpression_RegChar) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, TokenizerWithSeparators_ManyStringsWithMarkersNC) {
+  // Enough strings to be tokenized in batches, rows of different lengths are padded to the longest
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, true, {" "}, 1);
+
+  constexpr int64_t N = 2;
+  constexpr int64_t C = 64;
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  const size_t max_tokens = 4 + 2;
+  for (int64_t i = 0; i < N * C; ++i) {
+    std::vector<std::string> tokens;
+    for (int64_t t = 0; t <= i % 4; ++t) {
+      tokens.push_back("w" + std::to_string(i) + "_" + std::to_string(t));
+    }
+
+    std::string s;
+    for (const auto& token : tokens) {
+      s += (s.empty() ? "" : " ") + token;
+    }
+    input.push_back(s);
+
+    output.push_back(start_mark);
+    output.insert(output.end(), tokens.begin(), tokens.end());
+    output.push_back(end_mark);
+    output.resize(output.size() + max_tokens - tokens.size() - 2, padval);
+  }
+
+  test.AddInput<std::string>("T", {N, C}, input);
+  test.AddOutput<std::string>("Y", {N, C, static_cast<int64_t>(max_tokens)}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 TEST(ContribOpTest, Tokenizer_EmptyInput) {
   // Special case of empty input.
   // For [C] empty input we should output [0]
@@ -356,6 +356,14 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  void CheckStridedTensor(const std::string& name, bool is_strided_tensor) {
+    int id;
+    index(name, id);
+    EXPECT_EQ(plan_->allocation_plan[id].is_strided_tensor, is_strided_tensor) << "Error in strided tensor for " << name;
+  }
+#endif
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // TODO: add the checker for new implementation of release plan
     //// create set and check equality
@@ -598,6 +606,64 @@ TEST_F(PlannerTest, MayStridedTest2) {
   CheckFreed(2, {});
 }
 
+// Concat accepts strided tensors at all its inputs, so the output of Expand is a strided view of its input.
+TEST_F(PlannerTest, MayStridedOutputToVariadicMayStridedInput) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), concat_node("concat");
+
+  std::unique_ptr<::onnxruntime::KernelDef> concat_kernel = KernelDefBuilder()
+                                                                .SetName("Concat")
+                                                                .Provider(kCpuExecutionProvider)
+                                                                .SinceVersion(4, 10)
+                                                                .VariadicMayStridedInput(0)
+                                                                .Build();
+
+  // graph structure:
+  AddMayStridedOutputNode(X1, X2);  // stands in for Expand
+  std::vector<onnxruntime::NodeArg*> concat_inputs{Arg(X1), Arg(X2)}, concat_outputs{Arg(X3)};
+  AddNode(*concat_kernel, concat_node, concat_inputs, concat_outputs)->AddAttribute("axis", int64_t{0});
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  Shape shape2{"K", "N"};
+  SetShape({{X1, &shape1.value}, {X2, &shape1.value}, {X3, &shape2.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kReuse);
+  CheckStridedTensor(X2, true);
+  CheckAllocKind(X3, AllocKind::kAllocateOutput);
+}
+
+// Add needs contiguous inputs, so the output of Expand is allocated.
+TEST_F(PlannerTest, MayStridedOutputToContiguousInput) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), add_node("add");
+
+  std::unique_ptr<::onnxruntime::KernelDef> add_kernel =
+      KernelDefBuilder().SetName("Add").Provider(kCpuExecutionProvider).SinceVersion(7, 10).Build();
+
+  // graph structure:
+  AddMayStridedOutputNode(X1, X2);  // stands in for Expand
+  std::vector<onnxruntime::NodeArg*> add_inputs{Arg(X1), Arg(X2)}, add_outputs{Arg(X3)};
+  AddNode(*add_kernel, add_node, add_inputs, add_outputs);
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckStridedTensor(X2, false);
+  CheckAllocKind(X3, AllocKind::kAllocateOutput);
+}
+
 TEST_F(PlannerTest, MayStridedTest3) {
   // tensor variables:
   std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
@@ -1858,6 +1924,58 @@ TEST_F(PlannerTest, TestMultiStreamConfig) {
               graph_partitioner_cpu_gpu->Streams() == 2);
 }
 
+// Two independent MatMul branches joined by an Add are placed on separate CPU streams in parallel mode
+TEST_F(PlannerTest, CriticalPathPartitionerSplitsIndependentBranches) {
+  TypeProto matrix_type;
+  matrix_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  matrix_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256L);
+  matrix_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256L);
+
+  onnxruntime::Model model("main_graph", false, ModelMetaData(),
+                           PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 14}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& main_graph = model.MainGraph();
+  auto& a = main_graph.GetOrCreateNodeArg("a", &matrix_type);
+  auto& b = main_graph.GetOrCreateNodeArg("b", &matrix_type);
+  auto& c = main_graph.GetOrCreateNodeArg("c", &matrix_type);
+  auto& matmul_0_out = main_graph.GetOrCreateNodeArg("matmul_0_out", nullptr);
+  auto& matmul_1_out = main_graph.GetOrCreateNodeArg("matmul_1_out", nullptr);
+  auto& relu_0_out = main_graph.GetOrCreateNodeArg("relu_0_out", nullptr);
+  auto& relu_1_out = main_graph.GetOrCreateNodeArg("relu_1_out", nullptr);
+  auto& graph_out = main_graph.GetOrCreateNodeArg("graph_out", nullptr);
+  main_graph.AddNode("matmul_0", "MatMul", "", {&a, &b}, {&matmul_0_out});
+  main_graph.AddNode("matmul_1", "MatMul", "", {&a, &c}, {&matmul_1_out});
+  main_graph.AddNode("relu_0", "Relu", "", {&matmul_0_out}, {&relu_0_out});
+  main_graph.AddNode("relu_1", "Relu", "", {&matmul_1_out}, {&relu_1_out});
+  main_graph.AddNode("add_0", "Add", "", {&relu_0_out, &relu_1_out}, {&graph_out});
+  main_graph.SetInputs({&a, &b, &c});
+  main_graph.SetOutputs({&graph_out});
+  ASSERT_STATUS_OK(main_graph.Resolve());
+
+  SessionOptions so;
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigParallelExecutionCpuStreams, "2"));
+  InferenceSession sess{so, GetEnvironment()};
+  ASSERT_STATUS_OK(sess.RegisterExecutionProvider(DefaultCpuExecutionProvider()));
+
+  std::string s1;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&s1));
+  std::stringstream sstr(s1);
+  ASSERT_STATUS_OK(sess.Load(sstr));
+  ASSERT_STATUS_OK(sess.Initialize());
+
+  const auto& session_state = sess.GetSessionState();
+  const auto* exe_plan = session_state.GetExecutionPlan();
+  ASSERT_EQ(exe_plan->execution_plan.size(), 2u);
+
+  const auto& ort_value_name_idx_map = session_state.GetOrtValueNameIdxMap();
+  int matmul_0_out_idx = -1, matmul_1_out_idx = -1;
+  ASSERT_STATUS_OK(ort_value_name_idx_map.GetIdx("matmul_0_out", matmul_0_out_idx));
+  ASSERT_STATUS_OK(ort_value_name_idx_map.GetIdx("matmul_1_out", matmul_1_out_idx));
+  const auto& value_to_stream_map = exe_plan->GetValueToStreamMap();
+  EXPECT_NE(value_to_stream_map.at(matmul_0_out_idx), value_to_stream_map.at(matmul_1_out_idx));
+}
+
 // Save partition config to a file and check its completeness
 TEST_F(PlannerTest, TestMultiStreamSaveConfig) {
   const char* config_file_path = "./testdata/multi_stream_models/conv_add_relu_single_stream.json";
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <chrono>
+#include <thread>
+
+#include "core/framework/background_arena_shrinker.h"
+#include "core/framework/bfc_arena.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+std::shared_ptr<BFCArena> CreateArena() {
+  return std::make_shared<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+                                    ArenaExtendStrategy::kSameAsRequested);
+}
+
+int64_t TotalAllocatedBytes(BFCArena& arena) {
+  AllocatorStats stats;
+  arena.GetStats(&stats);
+  return stats.total_allocated_bytes;
+}
+
+}  // namespace
+
+TEST(BackgroundArenaShrinkerTest, ShrinksIdleArenas) {
+  auto arena = CreateArena();
+  ArenaShrinkPolicy policy;
+  policy.min_unused_time = std::chrono::milliseconds(0);
+
+  void* p = arena->Alloc(1024);
+  void* q = arena->Alloc(4096);
+  arena->Free(p);
+  int64_t last_num_allocs = -1;
+  // the arena allocated since the last check
+  EXPECT_EQ(BackgroundArenaShrinker::CheckArena(*arena, policy, last_num_allocs), 0u);
+  EXPECT_EQ(last_num_allocs, 2);
+
+  // only the unused region is released
+  EXPECT_EQ(BackgroundArenaShrinker::CheckArena(*arena, policy, last_num_allocs), 1024u);
+  EXPECT_EQ(TotalAllocatedBytes(*arena), 4096);
+  arena->Free(q);
+}
+
+TEST(BackgroundArenaShrinkerTest, ShrinksAboveHighWaterMark) {
+  auto arena = CreateArena();
+  ArenaShrinkPolicy policy;
+  policy.min_unused_time = std::chrono::milliseconds(0);
+  policy.high_water_mark_bytes = 8192;
+
+  int64_t last_num_allocs = -1;
+  void* p = arena->Alloc(4096);
+  arena->Free(p);
+  // busy and below the high-water mark
+  EXPECT_EQ(BackgroundArenaShrinker::CheckArena(*arena, policy, last_num_allocs), 0u);
+
+  p = arena->Alloc(4096);
+  void* q = arena->Alloc(8192);
+  arena->Free(p);
+  // busy but above the high-water mark
+  EXPECT_EQ(BackgroundArenaShrinker::CheckArena(*arena, policy, last_num_allocs), 4096u);
+  arena->Free(q);
+}
+
+TEST(BackgroundArenaShrinkerTest, BackgroundThread) {
+  auto arena = CreateArena();
+  ArenaShrinkPolicy policy;
+  policy.check_interval = std::chrono::milliseconds(5);
+  policy.min_unused_time = std::chrono::milliseconds(20);
+
+  arena->Free(arena->Alloc(1024));
+  auto registration = BackgroundArenaShrinker::Instance().Register(arena, policy);
+  // a second arena keeps the thread running when the first one is unregistered
+  auto other_arena = CreateArena();
+  auto other_registration = BackgroundArenaShrinker::Instance().Register(other_arena, policy);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (TotalAllocatedBytes(*arena) != 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(TotalAllocatedBytes(*arena), 0);
+
+  registration.reset();
+  arena.reset();
+  other_arena->Free(other_arena->Alloc(1024));
+  while (TotalAllocatedBytes(*other_arena) != 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(TotalAllocatedBytes(*other_arena), 0);
+
+  // the thread stops with the last registration and starts again with the next one
+  other_registration.reset();
+  other_arena->Free(other_arena->Alloc(1024));
+  registration = BackgroundArenaShrinker::Instance().Register(other_arena, policy);
+  while (TotalAllocatedBytes(*other_arena) != 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(TotalAllocatedBytes(*other_arena), 0);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
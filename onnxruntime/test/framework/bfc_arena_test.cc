@@ -6,7 +6,12 @@
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +312,159 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, SmallChunkCache) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES, 4096);
+
+  void* p = a.Alloc(1000);
+  a.Free(p);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // a request of another rounded size does not get the cached chunk, a request of the same one does
+  void* other = a.Alloc(1200);
+  EXPECT_NE(other, p);
+  void* q = a.Alloc(1020);
+  EXPECT_EQ(q, p);
+  CheckStats(&a, 3, 1024 + 1280, 1024 + 1280, 1280);
+
+  // large allocations are not cached
+  void* large = a.Alloc(1 << 20);
+  a.Free(large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 1024 + 1280);
+
+  // fill the cache of a size class beyond its capacity, the chunks that do not fit go back to the bins
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; i++) {
+    ptrs.push_back(a.Alloc(512));
+  }
+  for (void* ptr : ptrs) {
+    a.Free(ptr);
+  }
+  a.Free(q);
+  a.Free(other);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, 20);
+}
+
+TEST(BFCArenaTest, SmallChunkCacheFlush) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo, 8192,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK, BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES, BFCArena::MAX_CACHED_CHUNK_SIZE_BYTES);
+
+  void* p1 = a.Alloc(4096);
+  void* p2 = a.Alloc(4096);
+  a.Free(p1);
+  a.Free(p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+
+  // the cached chunks are returned to the bins and coalesced instead of extending the arena
+  void* p = a.Alloc(8192);
+  EXPECT_EQ(p, p1);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+  EXPECT_EQ(stats.bytes_in_use, 8192);
+  a.Free(p);
+
+  // cached chunks do not keep their regions alive
+  BFCArena b(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             BFCArena::MAX_CACHED_CHUNK_SIZE_BYTES);
+  b.Free(b.Alloc(1000));
+  EXPECT_EQ(b.Shrink(), Status::OK());
+  b.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.num_arena_extensions, 0);
+}
+
+TEST(BFCArenaTest, SmallChunkCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES, 8192);
+
+  constexpr int kNumThreads = 8;
+  std::atomic<bool> overlap{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&a, &overlap, t]() {
+      std::vector<std::pair<char*, size_t>> live;
+      for (int i = 0; i < 2000; i++) {
+        const size_t size = 64 + static_cast<size_t>((i * 37 + t * 11) % 10000);
+        char* ptr = static_cast<char*>(a.Alloc(size));
+        memset(ptr, t, size);
+        live.emplace_back(ptr, size);
+        if (live.size() > 8 || i % 3 == 0) {
+          // every buffer must still hold what this thread wrote into it
+          auto [front, front_size] = live.front();
+          if (std::any_of(front, front + front_size, [t](char c) { return c != static_cast<char>(t); })) {
+            overlap = true;
+          }
+          a.Free(front);
+          live.erase(live.begin());
+        }
+      }
+      for (auto& [ptr, size] : live) {
+        a.Free(ptr);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(overlap);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, kNumThreads * 2000);
+}
+
+TEST(BFCArenaTest, ShrinkUnusedRegions) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+  void* p1k = a.Alloc(1024);
+  void* p10M = a.Alloc(10 * 1024 * 1024);
+  a.Free(p1k);
+
+  // regions count as unused from the first call that finds them unused
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::hours(1)), 0u);
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::hours(1)), 0u);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::milliseconds(0)), 1024u);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1) << "p10M is still in use";
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024);
+
+  // a region that is found in use again starts over
+  a.Free(p10M);
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::hours(1)), 0u);
+  p10M = a.Alloc(10 * 1024 * 1024);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::milliseconds(10)), 0u);
+  a.Free(p10M);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::milliseconds(10)), 0u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(a.ShrinkUnusedRegions(std::chrono::milliseconds(10)), 10u * 1024 * 1024);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  // the arena still extends after shrinking
+  void* p = a.Alloc(4096);
+  EXPECT_NE(p, nullptr);
+  a.Free(p);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -315,6 +473,30 @@ class BadAllocator : public IAllocator {
   void Free(void* /*p*/) override {}
 };
 
+TEST(BFCArenaTest, HugePagesAndPrefault) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             BFCArena::DEFAULT_MAX_CACHED_CHUNK_SIZE_BYTES, true, true);
+
+  // regions of several huge pages, and smaller than a page
+  const size_t size = 8 * 1024 * 1024 + 1000;
+  auto* p = static_cast<char*>(a.Alloc(size));
+  ASSERT_NE(p, nullptr);
+  memset(p, 1, size);
+  EXPECT_EQ(p[size - 1], 1);
+
+  void* q = a.Alloc(100);
+  ASSERT_NE(q, nullptr);
+
+  a.Free(q);
+  a.Free(p);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+}
+
 TEST(BFCArenaTest, TestBackoffDoesntHang) {
   // test that if there are allocation failures the backoff logic doesn't hang. See comments in BFCArena::Extend
   BFCArena a(std::unique_ptr<IAllocator>(new BadAllocator()), 10 * 1024 * 1024);
@@ -109,6 +109,63 @@ TEST_F(CopyTest, Concat2D) {
   }
 }
 
+TEST_F(CopyTest, ConcatLargeNonTemporal) {
+  // large enough to take the non-temporal store path, with an odd offset so the spans are unaligned
+  constexpr int64_t rows = 1024;
+  constexpr int64_t src_cols = 1031;
+  constexpr int64_t dst_cols = 2 * src_cols + 1;
+  static_assert(rows * src_cols * sizeof(float) >= kNonTemporalCopyThresholdBytes);
+
+  std::vector<float> src(rows * src_cols);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = static_cast<float>(i);
+  }
+  std::vector<float> dst(rows * dst_cols, -1.0f);
+
+  constexpr std::ptrdiff_t offset = src_cols + 1;
+  StridedCopy<float>(tp.get(), dst.data() + offset, {dst_cols, 1}, {rows, src_cols}, src.data(), {src_cols, 1});
+
+  for (int64_t i0 = 0; i0 < rows; i0++) {
+    for (int64_t i1 = 0; i1 < dst_cols; i1++) {
+      const float expected = i1 >= offset ? src[i0 * src_cols + i1 - offset] : -1.0f;
+      ASSERT_EQ(expected, dst[i0 * dst_cols + i1]) << i0 << ", " << i1;
+    }
+  }
+}
+
+TEST_F(CopyTest, BroadcastTile2D) {
+  // test performing a tile using a strided copy with 0 strides on the repeat axes
+  std::vector<int32_t> src{1, 2, 3, 4, 5, 6};  // [2, 3]
+  std::vector<int32_t> dst(4 * 9);                // [2 * 2, 3 * 3]
+
+  // copy shape [2, 2, 3, 3] = [repeats0, dim0, repeats1, dim1]
+  StridedCopy<int32_t>(tp.get(), dst.data(), {18, 9, 3, 1}, {2, 2, 3, 3}, src.data(), {0, 3, 0, 1});
+
+  for (int i0 = 0; i0 < 4; i0++) {
+    for (int i1 = 0; i1 < 9; i1++) {
+      EXPECT_EQ(src[(i0 % 2) * 3 + i1 % 3], dst[i0 * 9 + i1]);
+    }
+  }
+}
+
+TEST_F(CopyTest, NonTemporalCopy) {
+  std::vector<uint8_t> src(4096 + 77);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = static_cast<uint8_t>(i * 7);
+  }
+
+  for (size_t dst_offset : {0, 1, 5, 16}) {
+    for (size_t count : {0, 3, 63, 64, 100, 4096}) {
+      std::vector<uint8_t> dst(src.size() + 32, 0);
+      NonTemporalCopy(dst.data() + dst_offset, src.data() + 3, count);
+      for (size_t i = 0; i < dst.size(); i++) {
+        const bool copied = i >= dst_offset && i < dst_offset + count;
+        ASSERT_EQ(copied ? src[i - dst_offset + 3] : 0, dst[i]) << dst_offset << ", " << count << ", " << i;
+      }
+    }
+  }
+}
+
 TEST_F(CopyTest, CoalesceTensorsTest) {
   {
     TensorShapeVector strides_a{3, 1};
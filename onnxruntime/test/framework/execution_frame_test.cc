@@ -8,6 +8,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -366,6 +367,270 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+TEST_F(ExecutionFrameTest, MemPatternShapeBucketsTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      input_def3("X3", &tensor_float),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternShapeBuckets,
+                                                              "8,64"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  ASSERT_TRUE(state.UseMemoryPatternShapeBuckets());
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+
+  int x1_idx = -1, x2_idx = -1, x3_idx = -1;
+  int t1_idx = -1, t2_idx = -1, t3_idx = -1;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X3", x3_idx).IsOK());
+
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T3", t3_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+  const OrtDevice& device = cpu_allocator->Info().device;
+
+  // Executes the allocations of T1 and T2 for an X1 with the given number of rows, like the sequential executor.
+  // Returns the pattern planned by the execution, if it had no pattern to use.
+  auto execute = [&](int64_t rows, bool& planned, MemoryPatternGroup& planned_pattern) {
+    OrtValue v1, v2, v3;
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{rows, 2},
+                         std::vector<float>(static_cast<size_t>(rows) * 2, 1.0f), &v1);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+    std::vector<OrtValue> feeds{v1, v2, v3};
+
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(AsSpan({x1_idx, x2_idx, x3_idx}), feeds, AsSpan({t3_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+
+    OrtValue t1, t2;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1, t1_idx, DataTypeImpl::GetType<float>(), device,
+                                                              TensorShape({rows, 2})));
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t2, t2_idx, DataTypeImpl::GetType<float>(), device,
+                                                              TensorShape({rows, 3})));
+
+    planned = frame.HasMemoryPatternPlanner();
+    if (planned) {
+      ASSERT_FALSE(frame.UsesBucketedMemoryPattern());
+      ASSERT_STATUS_OK(frame.GeneratePatterns(planned_pattern));
+      MemoryPatternGroup pattern_copy;
+      ASSERT_STATUS_OK(frame.GeneratePatterns(pattern_copy));
+      ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(feeds, std::move(pattern_copy)));
+    } else {
+      ASSERT_TRUE(frame.UsesBucketedMemoryPattern());
+      state.RecordBucketedMemoryPatternUse(feeds, frame.GetBucketedMemoryPatternMisfits());
+    }
+  };
+
+  bool planned = false;
+  MemoryPatternGroup pattern;
+
+  // the first execution of the (8, 64] bucket plans its pattern
+  execute(20, planned, pattern);
+  ASSERT_TRUE(planned);
+
+  // smaller tensors of the same bucket fit the planned blocks
+  execute(10, planned, pattern);
+  ASSERT_FALSE(planned);
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().hits, 1u);
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().misses, 1u);
+
+  // larger tensors don't, which schedules the bucket to be planned again
+  execute(40, planned, pattern);
+  ASSERT_FALSE(planned);
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().misses, 2u);
+
+  // the new plan holds the largest tensors seen, even if the planning execution has smaller ones
+  execute(9, planned, pattern);
+  ASSERT_TRUE(planned);
+  const auto* p = pattern.GetPatterns(device);
+  ASSERT_NE(p, nullptr);
+  EXPECT_GE(p->GetBlock(t1_idx)->size_, 40u * 2 * sizeof(float));
+  EXPECT_GE(p->GetBlock(t2_idx)->size_, 40u * 3 * sizeof(float));
+
+  execute(40, planned, pattern);
+  ASSERT_FALSE(planned);
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().hits, 2u);
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().misses, 3u);
+
+  // dimensions above the largest bucket are not rounded, and a smaller bucket has its own pattern
+  execute(100, planned, pattern);
+  EXPECT_TRUE(planned);
+  execute(4, planned, pattern);
+  EXPECT_TRUE(planned);
+}
+
+TEST_F(ExecutionFrameTest, MemPatternStaticPlanTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  auto fixed_shape_float = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+  TypeProto x1_type = fixed_shape_float({3, 2}), x2_type = fixed_shape_float({2, 2}),
+            x3_type = fixed_shape_float({2, 3});
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &x1_type),
+      input_def2("X2", &x2_type),
+      input_def3("X3", &x3_type),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  // shape inference gives T1 and T2 fixed shapes
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanning, "1"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  state.ResolveMemoryPatternFlag();
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+
+  int x1_idx = -1, x2_idx = -1, x3_idx = -1;
+  int t1_idx = -1, t2_idx = -1, t3_idx = -1;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X3", x3_idx).IsOK());
+
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T3", t3_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+  const OrtDevice& device = cpu_allocator->Info().device;
+
+  auto create_feeds = [&](int64_t rows) {
+    OrtValue v1, v2, v3;
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{rows, 2},
+                         std::vector<float>(static_cast<size_t>(rows) * 2, 1.0f), &v1);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+    return std::vector<OrtValue>{v1, v2, v3};
+  };
+
+  // the pattern is planned during initialization, T1 and T2 are live at the same time while node2 runs
+  auto feeds = create_feeds(3);
+  const auto* static_pattern = state.GetStaticMemoryPatternGroup(feeds, AsSpan({x1_idx, x2_idx, x3_idx}));
+  ASSERT_NE(static_pattern, nullptr);
+  const auto* p = static_pattern->GetPatterns(device);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(p->PeakSize(), 2u * kAllocAlignment);
+  EXPECT_EQ(p->GetBlock(t1_idx)->offset_, 0u);
+  EXPECT_EQ(p->GetBlock(t2_idx)->offset_, kAllocAlignment);
+  EXPECT_EQ(p->GetBlock(t3_idx), nullptr) << "graph outputs are not planned";
+
+  {
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(AsSpan({x1_idx, x2_idx, x3_idx}), feeds, AsSpan({t3_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+    EXPECT_FALSE(frame.HasMemoryPatternPlanner());
+
+    OrtValue t1, t2;
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1, t1_idx, DataTypeImpl::GetType<float>(), device,
+                                                              TensorShape({3, 2})));
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t2, t2_idx, DataTypeImpl::GetType<float>(), device,
+                                                              TensorShape({3, 3})));
+    // both tensors are placed in the pattern buffer
+    EXPECT_EQ(static_cast<const char*>(t2.Get<Tensor>().DataRaw()) -
+                  static_cast<const char*>(t1.Get<Tensor>().DataRaw()),
+              static_cast<ptrdiff_t>(kAllocAlignment));
+  }
+
+  // other input shapes trace their patterns at runtime
+  feeds = create_feeds(1);
+  EXPECT_EQ(state.GetStaticMemoryPatternGroup(feeds, AsSpan({x1_idx, x2_idx, x3_idx})), nullptr);
+  std::vector<OrtValue> outputs;
+  ExecutionFrame frame(AsSpan({x1_idx, x2_idx, x3_idx}), feeds, AsSpan({t3_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                       {},
+#endif
+                       state);
+  EXPECT_TRUE(frame.HasMemoryPatternPlanner());
+}
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
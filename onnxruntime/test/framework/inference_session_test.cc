@@ -8,6 +8,8 @@
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <random>
 #include <thread>
 #include <fstream>
 
@@ -16,9 +18,12 @@
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/profiler.h"
+#include "core/common/run_stats.h"
+#include "core/framework/calibration_collector.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/kernel_latency_metrics.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
@@ -419,6 +424,57 @@ TEST(InferenceSessionTests, OnlyExecutePathToFetches) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, OnlyExecutePathToFetches_SkipsNodesOfOtherOutputs) {
+  const PathString model_file_name = ORT_TSTR("only_execute_path_to_fetches_test.onnx");
+  {
+    onnxruntime::Model model("two_heads", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                             {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+    auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+    auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+    graph.AddNode("abs", "Abs", "", {&x}, {&a});
+    graph.AddNode("neg", "Neg", "", {&x}, {&b});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+  }
+
+  InferenceSessionWrapper session{SessionOptions{}, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_file_name));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2}, {-1.0f, 2.0f}, &x);
+  NameMLValMap feeds{{"X", x}};
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigOnlyExecutePathToFetches, "1"));
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(run_options, feeds, std::vector<std::string>{"A"}, &fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  auto a = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_THAT(std::vector<float>(a.begin(), a.end()), ::testing::ElementsAre(1.0f, 2.0f));
+
+  // only the node producing A is executed for this set of fetches
+  const auto& session_state = session.GetSessionState();
+  int a_idx = -1;
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("A", a_idx));
+  const auto* nodes_to_execute = session_state.GetToBeExecutedRange(AsSpan({a_idx}));
+  ASSERT_NE(nodes_to_execute, nullptr);
+  ASSERT_EQ(nodes_to_execute->size(), 1u);
+  EXPECT_EQ(session_state.GetGraphViewer().GetNode(*nodes_to_execute->begin())->OpType(), "Abs");
+
+  // fetching both outputs executes both nodes
+  fetches.clear();
+  ASSERT_STATUS_OK(session.Run(run_options, feeds, std::vector<std::string>{"A", "B"}, &fetches));
+  ASSERT_EQ(fetches.size(), 2u);
+  auto b = fetches[1].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_THAT(std::vector<float>(b.begin(), b.end()), ::testing::ElementsAre(1.0f, -2.0f));
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -741,6 +797,125 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions2) {
 #endif
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithHardwareCounters) {
+  if (profiling::HardwareCounters::Create(nullptr) == nullptr) {
+    GTEST_SKIP() << "Hardware counters are not available";
+  }
+
+  SessionOptions so;
+  so.session_logid = "CheckRunProfiler";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_profile_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfileHardwareCounters, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  size_t kernel_events = 0;
+  size_t kernel_events_with_counters = 0;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") != string::npos) {
+      ++kernel_events;
+      if (line.find(R"("hardware_counters" : {"cycles" : )") != string::npos &&
+          line.find(R"("instructions" : )") != string::npos) {
+        ++kernel_events_with_counters;
+      }
+    }
+  }
+
+  ASSERT_GT(kernel_events, 0u);
+  ASSERT_EQ(kernel_events_with_counters, kernel_events);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithMemoryTrace) {
+  SessionOptions so;
+  so.session_logid = "CheckRunProfiler";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_profile_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfileMemory, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  bool has_memory_counter = false;
+  bool has_memory_peak = false;
+  while (std::getline(profile, line)) {
+    has_memory_counter |= line.find(R"("ph" : "C","name" :"memory_)") != string::npos;
+    has_memory_peak |= line.find(R"("name" :"memory_peak")") != string::npos &&
+                       line.find(R"("live_tensors" : [)") != string::npos;
+  }
+
+  ASSERT_TRUE(has_memory_counter);
+  ASSERT_TRUE(has_memory_peak);
+}
+
+// Native tracing needs access to tracefs, runs must succeed whether or not it is available.
+TEST(InferenceSessionTests, RunWithNativeTracing) {
+  SessionOptions so;
+  so.session_logid = "RunWithNativeTracing";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsNativeTracing, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, RunWithRunStats) {
+  SessionOptions so;
+  so.session_logid = "RunWithRunStats";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  run_options.run_stats = std::make_shared<RunStats>();
+  RunModel(session_object, run_options);
+
+  const RunStats& run_stats = *run_options.run_stats;
+  EXPECT_GT(run_stats.wall_time_ns, 0);
+  EXPECT_GT(run_stats.num_kernels, 0);
+  EXPECT_LE(run_stats.kernel_time_ns, run_stats.wall_time_ns);
+  EXPECT_GT(run_stats.num_allocations, 0);
+  EXPECT_GE(run_stats.allocated_bytes, run_stats.peak_bytes);
+  EXPECT_GT(run_stats.peak_bytes, 0);
+  EXPECT_EQ(run_stats.device_time_ns, -1);
+
+  const std::string json = run_stats.ToJson();
+  EXPECT_NE(json.find("\"cpu_time_us\""), std::string::npos);
+  EXPECT_EQ(json.find("\"device_time_us\""), std::string::npos);
+
+  // the stats are reset by the next run
+  RunModel(session_object, run_options);
+  EXPECT_GT(run_stats.num_kernels, 0);
+  EXPECT_GE(run_stats.allocated_bytes, run_stats.peak_bytes);
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
@@ -806,6 +981,181 @@ TEST(InferenceSessionTests, CheckRunProfilerStartTime) {
   ASSERT_TRUE(before_start_time <= profiling_start_time && profiling_start_time <= after_start_time);
 }
 
+TEST(InferenceSessionTests, KernelLatencyMetrics) {
+  SessionOptions so;
+  so.session_logid = "KernelLatencyMetrics";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigKernelLatencySamplingInterval, "2"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  for (int i = 0; i < 5; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetKernelLatencyMetrics(json));
+  // the first, third and fifth execution of the only kernel are sampled
+  EXPECT_NE(json.find("\"sampling_interval\":2"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"op_types\":[{\"op_type\":\"Mul\""), std::string::npos) << json;
+  EXPECT_NE(json.find("\"kernels\":[{\"name\":\"mul_1\",\"op_type\":\"Mul\""), std::string::npos) << json;
+  EXPECT_NE(json.find("\"count\":3,"), std::string::npos) << json;
+
+  // disabled by default
+  InferenceSession session_object_2(SessionOptions{}, GetEnvironment());
+  ASSERT_STATUS_OK(session_object_2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object_2.Initialize());
+  EXPECT_FALSE(session_object_2.GetKernelLatencyMetrics(json).IsOK());
+}
+
+TEST(InferenceSessionTests, KernelLatencyHistogram) {
+  EXPECT_EQ(LatencyHistogram::BucketIndex(999), 0u);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(1000), 1u);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(3999), 2u);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(4000), 3u);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(uint64_t{1} << 62), LatencyHistogram::kNumBuckets - 1);
+
+  LatencyHistogram histogram;
+  for (uint64_t duration_ns : {500, 1500, 1500, 20000}) {
+    const size_t bucket = LatencyHistogram::BucketIndex(duration_ns);
+    ASSERT_LT(duration_ns / 1000, LatencyHistogram::BucketUpperBoundUs(bucket));
+    ++histogram.bucket_counts[bucket];
+    ++histogram.count;
+    histogram.total_ns += duration_ns;
+    histogram.max_ns = std::max(histogram.max_ns, duration_ns);
+  }
+  EXPECT_EQ(histogram.PercentileUpperBoundUs(25), 1u);
+  EXPECT_EQ(histogram.PercentileUpperBoundUs(50), 2u);
+  EXPECT_EQ(histogram.PercentileUpperBoundUs(99), 32u);
+
+  std::vector<KernelLatency> kernels{{"a", "Mul", "", kCpuExecutionProvider, histogram},
+                                     {"b", "Mul", "", kCpuExecutionProvider, histogram},
+                                     {"c", "Add", "", kCpuExecutionProvider, LatencyHistogram{}}};
+  auto op_types = AggregateKernelLatenciesByOpType(kernels);
+  ASSERT_EQ(op_types.size(), 2u);
+  EXPECT_EQ(op_types[0].op_type, "Add");
+  EXPECT_EQ(op_types[1].op_type, "Mul");
+  EXPECT_EQ(op_types[1].histogram.count, 8u);
+  EXPECT_EQ(op_types[1].histogram.total_ns, 2 * histogram.total_ns);
+  EXPECT_EQ(op_types[1].histogram.max_ns, 20000u);
+}
+
+TEST(InferenceSessionTests, MemoizedOutputs) {
+  SessionOptions so;
+  so.session_logid = "MemoizedOutputs";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMemoizedOutputs, "Y"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // the outputs of the runs after the first one are copied from the cache, and checked by RunModel
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  const KernelResultCache* cache = session_object.GetSessionState().GetKernelResultCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->Misses(), 1u);
+  EXPECT_EQ(cache->Hits(), 2u);
+  EXPECT_GT(cache->MemoryUsage(), 0u);
+
+  // nothing fits in the capacity
+  SessionOptions so_2;
+  ASSERT_STATUS_OK(so_2.config_options.AddConfigEntry(kOrtSessionOptionsMemoizedOutputs, "Y"));
+  ASSERT_STATUS_OK(so_2.config_options.AddConfigEntry(kOrtSessionOptionsMemoizationCacheSize, "8"));
+  InferenceSession session_object_2(so_2, GetEnvironment());
+  ASSERT_STATUS_OK(session_object_2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object_2.Initialize());
+  for (int i = 0; i < 2; ++i) {
+    RunModel(session_object_2, run_options);
+  }
+
+  cache = session_object_2.GetSessionState().GetKernelResultCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->Misses(), 2u);
+  EXPECT_EQ(cache->Hits(), 0u);
+  EXPECT_EQ(cache->MemoryUsage(), 0u);
+}
+
+TEST(InferenceSessionTests, CalibrationTable) {
+  SessionOptions so;
+  so.session_logid = "CalibrationTable";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCalibrationTensors, "*"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetCalibrationTable(json));
+  // Y = X * X with X in [1, 6], quantized to uint8 over [0, 36]
+  EXPECT_NE(json.find("\"method\":\"minmax\""), std::string::npos) << json;
+  EXPECT_NE(json.find("{\"name\":\"Y\",\"min\":1,\"max\":36,\"range_min\":1,\"range_max\":36,"),
+            std::string::npos)
+      << json;
+  EXPECT_NE(json.find("\"zero_point\":0}"), std::string::npos) << json;
+
+  // disabled by default
+  InferenceSession session_object_2(SessionOptions{}, GetEnvironment());
+  ASSERT_STATUS_OK(session_object_2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object_2.Initialize());
+  EXPECT_FALSE(session_object_2.GetCalibrationTable(json).IsOK());
+
+  SessionOptions so_3;
+  ASSERT_STATUS_OK(so_3.config_options.AddConfigEntry(kOrtSessionOptionsCalibrationTensors, "Y"));
+  ASSERT_STATUS_OK(so_3.config_options.AddConfigEntry(kOrtSessionOptionsCalibrationMethod, "histogram"));
+  InferenceSession session_object_3(so_3, GetEnvironment());
+  ASSERT_STATUS_OK(session_object_3.Load(MODEL_URI));
+  EXPECT_FALSE(session_object_3.Initialize().IsOK());
+}
+
+TEST(InferenceSessionTests, CalibrationHistogram) {
+  CalibrationHistogram histogram;
+  const std::vector<float> values_1{0.5f, -1.0f, 0.0f};
+  histogram.Add(values_1, 1.0f);
+  EXPECT_EQ(histogram.range, 1.0f);
+  // doubles the range twice, merging the bins of the values added before
+  const std::vector<float> values_2{3.0f, std::numeric_limits<float>::quiet_NaN()};
+  histogram.Add(values_2, 3.0f);
+  EXPECT_EQ(histogram.range, 4.0f);
+  EXPECT_EQ(histogram.count, 4u);
+  EXPECT_EQ(histogram.bin_counts[0], 1u);
+  EXPECT_EQ(histogram.bin_counts[256], 1u);
+  EXPECT_EQ(histogram.bin_counts[511], 1u);
+  EXPECT_EQ(histogram.bin_counts[1536], 1u);
+
+  EXPECT_FLOAT_EQ(histogram.PercentileThreshold(75), 1.0f);
+  EXPECT_FLOAT_EQ(histogram.PercentileThreshold(100), 4.0f * 1537 / 2048);
+
+  // the entropy threshold clips a rare outlier far from the other values
+  CalibrationHistogram gaussian;
+  std::default_random_engine generator(1234);
+  std::normal_distribution<float> distribution(0.0f, 1.0f);
+  std::vector<float> values(20000);
+  for (auto& value : values) {
+    value = distribution(generator);
+  }
+  values[0] = 64.0f;
+  gaussian.Add(values, 64.0f);
+  const float threshold = gaussian.EntropyThreshold(128);
+  EXPECT_GT(threshold, 2.0f);
+  EXPECT_LT(threshold, 16.0f);
+
+  CalibrationStatistics statistics{"t", -1.5f, 64.0f, gaussian};
+  const auto range = ComputeCalibrationRange(statistics, CalibrationMethod::kEntropy, 0.0);
+  EXPECT_EQ(range.first, -1.5f);
+  EXPECT_EQ(range.second, threshold);
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -1073,6 +1423,61 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingReusesOutputBoundToDevice) {
+  SessionOptions so;
+  InferenceSession session_object(so, GetEnvironment());
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+
+  std::vector<std::string> changed_outputs;
+  std::vector<TensorShape> previous_shapes;
+  std::vector<TensorShape> new_shapes;
+  io_binding->SetOutputShapeChangedCallback(
+      [&](const std::string& output_name, const TensorShape& previous_shape, const TensorShape& new_shape) {
+        changed_outputs.push_back(output_name);
+        previous_shapes.push_back(previous_shape);
+        new_shapes.push_back(new_shape);
+      });
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue a, b;
+  CreateMLValue<float>(allocator, {2, 2}, {1.f, 2.f, 3.f, 4.f}, &a);
+  CreateMLValue<float>(allocator, {2, 2}, {1.f, 0.f, 0.f, 1.f}, &b);
+  ASSERT_STATUS_OK(io_binding->BindInput("A", a));
+  ASSERT_STATUS_OK(io_binding->BindInput("B", b));
+  ASSERT_STATUS_OK(io_binding->BindOutput("Y", OrtDevice()));
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(session_object.Run(run_options, *io_binding));
+  VerifyOutputs(io_binding->GetOutputs(), {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  const void* output_buffer = io_binding->GetOutputs()[0].Get<Tensor>().DataRaw();
+
+  // same shape, the output is written into the same buffer
+  CreateMLValue<float>(allocator, {2, 2}, {2.f, 0.f, 0.f, 2.f}, &b);
+  ASSERT_STATUS_OK(io_binding->BindInput("B", b));
+  ASSERT_STATUS_OK(session_object.Run(run_options, *io_binding));
+  VerifyOutputs(io_binding->GetOutputs(), {2, 2}, {2.f, 4.f, 6.f, 8.f});
+  EXPECT_EQ(io_binding->GetOutputs()[0].Get<Tensor>().DataRaw(), output_buffer);
+  EXPECT_TRUE(changed_outputs.empty());
+
+  // a new shape is allocated and reported instead of failing the run
+  CreateMLValue<float>(allocator, {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &a);
+  ASSERT_STATUS_OK(io_binding->BindInput("A", a));
+  ASSERT_STATUS_OK(session_object.Run(run_options, *io_binding));
+  VerifyOutputs(io_binding->GetOutputs(), {3, 2}, {2.f, 4.f, 6.f, 8.f, 10.f, 12.f});
+  ASSERT_EQ(changed_outputs, std::vector<std::string>{"Y"});
+  EXPECT_EQ(previous_shapes[0], TensorShape({2, 2}));
+  EXPECT_EQ(new_shapes[0], TensorShape({3, 2}));
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -2644,6 +3049,86 @@ TEST(InferenceSessionTests, InvalidSessionEnvCombination) {
   }
 }
 
+// Test 5: sessions sharing the global tp with thread quotas and priority classes
+TEST(InferenceSessionTests, GlobalThreadPoolQuotaAndPriority) {
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  OrtThreadingOptions tp_options;
+  tp_options.intra_op_thread_pool_params.thread_pool_size = 4;
+  ASSERT_STATUS_OK(Environment::Create(std::move(logging_manager), env, &tp_options,
+                                       true /*create_global_thread_pools*/));
+
+  SessionOptions latency_so;
+  latency_so.use_per_session_threads = false;
+  latency_so.session_logid = "GlobalThreadPoolQuotaAndPriority.latency";
+  ASSERT_STATUS_OK(latency_so.config_options.AddConfigEntry(kOrtSessionOptionsGlobalIntraOpThreadQuota, "2"));
+  InferenceSessionTestGlobalThreadPools latency_session{latency_so, *env};
+  ASSERT_STATUS_OK(latency_session.Load(MODEL_URI));
+  ASSERT_STATUS_OK(latency_session.Initialize());
+
+  SessionOptions batch_so;
+  batch_so.use_per_session_threads = false;
+  batch_so.session_logid = "GlobalThreadPoolQuotaAndPriority.batch";
+  ASSERT_STATUS_OK(batch_so.config_options.AddConfigEntry(kOrtSessionOptionsGlobalThreadPoolPriority, "batch"));
+  InferenceSessionTestGlobalThreadPools batch_session{batch_so, *env};
+  ASSERT_STATUS_OK(batch_session.Load(MODEL_URI));
+  ASSERT_STATUS_OK(batch_session.Initialize());
+
+  RunOptions run_options;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i]() { RunModel(i % 2 == 0 ? latency_session : batch_session, run_options); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  SessionOptions invalid_so;
+  invalid_so.use_per_session_threads = false;
+  ASSERT_STATUS_OK(invalid_so.config_options.AddConfigEntry(kOrtSessionOptionsGlobalThreadPoolPriority, "urgent"));
+  ORT_TRY {
+    InferenceSessionTestGlobalThreadPools session_object{invalid_so, *env};
+    FAIL() << "The invalid priority should have been rejected.";
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&e]() {
+      EXPECT_THAT(e.what(), testing::HasSubstr("Invalid global thread pool priority"));
+    });
+  }
+}
+
+TEST(InferenceSessionTests, RunPriority) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunPriority";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // concurrent runs of all priorities complete, the low priority ones on fewer threads
+  std::vector<std::thread> threads;
+  for (const char* priority : {"low", "normal", "high", "low"}) {
+    threads.emplace_back([&session_object, priority]() {
+      RunOptions run_options;
+      ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigPriority, priority));
+      RunModel(session_object, run_options);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigPriority, "urgent"));
+  NameMLValMap feeds;
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(session_object.Run(run_options, feeds, output_names, &fetches),
+                                      "Invalid run priority");
+}
+
 // Tests for sharing allocators between sessions
 class InferenceSessionTestSharingAllocator : public InferenceSessionWrapper {
  public:
@@ -2836,6 +3321,306 @@ TEST(InferenceSessionTests, InitializerSharing_EnsureSessionsUseUserAddedInitial
   }
 }
 
+TEST(InferenceSessionTests, InitializerSharing_EnsureSessionsShareIdenticalInitializersThroughEnv) {
+  if constexpr (!SessionOptions::DEFAULT_USE_PER_SESSION_THREADS) {
+    GTEST_SKIP() << "Skipping the test";
+  }
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  ASSERT_STATUS_OK(Environment::Create(std::move(logging_manager), env));
+
+  const char* init_name = "W";
+  auto get_init_buffer = [init_name](const InferenceSessionWrapper& sess) -> const float* {
+    int idx;
+    if (!sess.GetSessionState().GetOrtValueNameIdxMap().GetIdx(init_name, idx).IsOK()) {
+      return nullptr;
+    }
+    return sess.GetSessionState().GetInitializedTensors().at(idx).Get<Tensor>().Data<float>();
+  };
+
+  SessionOptions so1;
+  ASSERT_STATUS_OK(so1.config_options.AddConfigEntry(kOrtSessionOptionsConfigShareInitializersAcrossSessions, "1"));
+  InferenceSessionTestSharingInitializer sess1(so1, *env);
+  ASSERT_STATUS_OK(sess1.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess1.Initialize());
+
+  SessionOptions so2;
+  ASSERT_STATUS_OK(so2.config_options.AddConfigEntry(kOrtSessionOptionsConfigShareInitializersAcrossSessions, "1"));
+  InferenceSessionTestSharingInitializer sess2(so2, *env);
+  ASSERT_STATUS_OK(sess2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess2.Initialize());
+
+  SessionOptions so3;
+  InferenceSessionTestSharingInitializer sess3(so3, *env);
+  ASSERT_STATUS_OK(sess3.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess3.Initialize());
+
+  const float* so1_init_buffer = get_init_buffer(sess1);
+  ASSERT_NE(so1_init_buffer, nullptr);
+  EXPECT_EQ(so1_init_buffer, get_init_buffer(sess2));
+  EXPECT_GE(env->GetSharedInitializerCache().NumLiveTensors(), 1u);
+
+  // a session without the option keeps its own copy
+  const float* so3_init_buffer = get_init_buffer(sess3);
+  if (so3_init_buffer != nullptr) {
+    EXPECT_NE(so3_init_buffer, so1_init_buffer);
+  }
+
+  // the shared initializers are not left behind in the options of the sessions
+  EXPECT_TRUE(sess1.GetSessionOptions().initializers_to_share_map.empty());
+
+  RunModel(sess1, RunOptions{});
+  RunModel(sess2, RunOptions{});
+}
+
+#if !defined(ORT_MINIMAL_BUILD) && !defined(_WIN32)
+TEST(InferenceSessionTests, MappedWeightPaging_PagesOutLeastRecentlyRunSession) {
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  ASSERT_STATUS_OK(Environment::Create(std::move(logging_manager), env));
+  auto& pager = env->GetMappedWeightPager();
+
+  // a budget smaller than one model, so that only the most recently run session stays resident
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigLazyLoadInitializers, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnvWeightPagingBudgetBytes, "1"));
+
+  InferenceSessionWrapper sess1(so, *env);
+  ASSERT_STATUS_OK(sess1.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess1.Initialize());
+  const InferenceSession* owner1 = &sess1;
+  EXPECT_TRUE(pager.IsResident(owner1));
+
+  InferenceSessionWrapper sess2(so, *env);
+  ASSERT_STATUS_OK(sess2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess2.Initialize());
+  const InferenceSession* owner2 = &sess2;
+  EXPECT_FALSE(pager.IsResident(owner1));
+  EXPECT_TRUE(pager.IsResident(owner2));
+
+  // the paged out weights are read back from the file
+  RunModel(sess1, RunOptions{});
+  EXPECT_TRUE(pager.IsResident(owner1));
+  EXPECT_FALSE(pager.IsResident(owner2));
+
+  RunModel(sess2, RunOptions{});
+  EXPECT_FALSE(pager.IsResident(owner1));
+  EXPECT_TRUE(pager.IsResident(owner2));
+}
+#endif
+
+TEST(InferenceSessionTests, Replicas_ShareInitializersAndServeRuns) {
+  if constexpr (!SessionOptions::DEFAULT_USE_PER_SESSION_THREADS) {
+    GTEST_SKIP() << "Skipping the test";
+  }
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  ASSERT_STATUS_OK(Environment::Create(std::move(logging_manager), env));
+
+  // the CPU EP has no device to select, so the replica only differs from the session by its state
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigReplicaDeviceIds, "0"));
+  auto create_session = [&]() {
+    auto session = std::make_unique<InferenceSessionWrapper>(so, *env);
+    EXPECT_STATUS_OK(session->Load(MODEL_URI));
+    EXPECT_STATUS_OK(session->Initialize());
+    return session;
+  };
+
+  auto sess = create_session();
+  auto replica = create_session();
+  const InferenceSession* replica_ptr = replica.get();
+  EXPECT_GE(env->GetSharedInitializerCache().NumLiveTensors(), 1u);
+
+  ASSERT_STATUS_OK(sess->AddReplica(std::move(replica)));
+  ASSERT_EQ(sess->NumReplicas(), 1u);
+  EXPECT_EQ(&sess->GetReplica(0), sess.get());
+  EXPECT_EQ(&sess->GetReplica(1), replica_ptr);
+
+  // a replica can't have replicas of its own
+  auto nested = create_session();
+  ASSERT_STATUS_OK(nested->AddReplica(create_session()));
+  EXPECT_FALSE(sess->AddReplica(std::move(nested)).IsOK());
+
+  // the runs are served by either of the replicas
+  for (int i = 0; i < 4; ++i) {
+    RunModel(*sess, RunOptions{});
+  }
+}
+
+TEST(InferenceSessionTests, LoraAdapters_SwitchAdapterPerRun) {
+  const PathString model_file_name = ORT_TSTR("lora_adapters_test.onnx");
+  {
+    onnxruntime::Model model("lora_graph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                             {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_name("W");
+    weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    weight.add_dims(2);
+    weight.add_dims(2);
+    for (float value : {1.0f, 0.0f, 0.0f, 1.0f}) {
+      weight.add_float_data(value);
+    }
+    graph.AddInitializedTensor(weight);
+
+    auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+    auto& w = graph.GetOrCreateNodeArg("W", nullptr);
+    auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+    graph.AddNode("matmul", "MatMul", "", {&x, &w}, {&y});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+  }
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigLoraTargetWeights, "W"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_file_name));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  auto make_tensor = [&allocator](const std::vector<int64_t>& dims, const std::vector<float>& values) {
+    OrtValue value;
+    CreateMLValue<float>(allocator, dims, values, &value);
+    return value;
+  };
+
+  // Y = X * W + (X * A) * B, W is the identity
+  LoraAdapter rank1;
+  rank1.emplace("W", LoraWeights{make_tensor({2, 1}, {1.0f, 1.0f}), make_tensor({1, 2}, {0.5f, -1.0f})});
+  ASSERT_STATUS_OK(session.AddLoraAdapter("rank1", rank1));
+  LoraAdapter rank2;
+  rank2.emplace("W", LoraWeights{make_tensor({2, 2}, {1.0f, 0.0f, 0.0f, 1.0f}),
+                                 make_tensor({2, 2}, {1.0f, 1.0f, 0.0f, 0.0f})});
+  ASSERT_STATUS_OK(session.AddLoraAdapter("rank2", rank2));
+
+  // updates of weights that are not targeted or with the wrong shape are rejected
+  LoraAdapter invalid;
+  invalid.emplace("W", LoraWeights{make_tensor({3, 1}, {1.0f, 1.0f, 1.0f}), make_tensor({1, 2}, {1.0f, 1.0f})});
+  EXPECT_FALSE(session.AddLoraAdapter("invalid", invalid).IsOK());
+  invalid.clear();
+  invalid.emplace("V", rank1.at("W"));
+  EXPECT_FALSE(session.AddLoraAdapter("invalid", invalid).IsOK());
+
+  NameMLValMap feeds{{"X", make_tensor({1, 2}, {1.0f, 2.0f})}};
+  const std::vector<std::string> output_names{"Y"};
+  auto run = [&](const std::string& adapter, std::vector<float>& y) {
+    RunOptions run_options;
+    if (!adapter.empty()) {
+      ORT_RETURN_IF_ERROR(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigLoraAdapter,
+                                                                    adapter.c_str()));
+    }
+    std::vector<OrtValue> fetches;
+    ORT_RETURN_IF_ERROR(session.Run(run_options, feeds, output_names, &fetches));
+    auto output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    y.assign(output.begin(), output.end());
+    return Status::OK();
+  };
+
+  std::vector<float> y;
+  ASSERT_STATUS_OK(run("", y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+  ASSERT_STATUS_OK(run("rank1", y));
+  EXPECT_THAT(y, ::testing::ElementsAre(2.5f, -1.0f));
+  ASSERT_STATUS_OK(run("rank2", y));
+  EXPECT_THAT(y, ::testing::ElementsAre(2.0f, 3.0f));
+  ASSERT_STATUS_OK(run("", y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+
+  ASSERT_STATUS_OK(session.RemoveLoraAdapter("rank1"));
+  EXPECT_FALSE(run("rank1", y).IsOK());
+}
+
+TEST(InferenceSessionTests, StreamStates_CarriedAcrossRuns) {
+  const PathString model_file_name = ORT_TSTR("stream_states_test.onnx");
+  {
+    onnxruntime::Model model("stream_graph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                             {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    // the state accumulates the chunks: Y = S_out = X + S_in
+    auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+    auto& s_in = graph.GetOrCreateNodeArg("S_in", &float_tensor);
+    auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+    auto& s_out = graph.GetOrCreateNodeArg("S_out", &float_tensor);
+    graph.AddNode("add", "Add", "", {&x, &s_in}, {&y});
+    graph.AddNode("identity", "Identity", "", {&y}, {&s_out});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+  }
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStreamingStates, "S_in:S_out"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_file_name));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue x;
+  CreateMLValue<float>(allocator, {1, 2}, {1.0f, 2.0f}, &x);
+  NameMLValMap feeds{{"X", x}};
+  const std::vector<std::string> output_names{"Y"};
+  auto run = [&](const std::string& stream_id, const char* flag, std::vector<float>& y) {
+    RunOptions run_options;
+    if (!stream_id.empty()) {
+      ORT_RETURN_IF_ERROR(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigStreamId,
+                                                                    stream_id.c_str()));
+    }
+    if (flag != nullptr) {
+      ORT_RETURN_IF_ERROR(run_options.config_options.AddConfigEntry(flag, "1"));
+    }
+    std::vector<OrtValue> fetches;
+    ORT_RETURN_IF_ERROR(session.Run(run_options, feeds, output_names, &fetches));
+    ORT_RETURN_IF_NOT(fetches.size() == 1, "The state output must not be returned.");
+    auto output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    y.assign(output.begin(), output.end());
+    return Status::OK();
+  };
+
+  std::vector<float> y;
+  ASSERT_STATUS_OK(run("a", nullptr, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+  ASSERT_STATUS_OK(run("a", nullptr, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(2.0f, 4.0f));
+
+  // streams are independent
+  ASSERT_STATUS_OK(run("b", nullptr, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+  ASSERT_STATUS_OK(run("a", nullptr, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(3.0f, 6.0f));
+
+  ASSERT_STATUS_OK(run("a", kOrtRunOptionsConfigStreamReset, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+  ASSERT_STATUS_OK(run("b", kOrtRunOptionsConfigStreamEnd, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(2.0f, 4.0f));
+  ASSERT_STATUS_OK(run("b", nullptr, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+  ASSERT_STATUS_OK(session.ResetStreamStates("a"));
+  ASSERT_STATUS_OK(run("a", nullptr, y));
+  EXPECT_THAT(y, ::testing::ElementsAre(1.0f, 2.0f));
+
+  // runs outside of a stream must feed the state
+  EXPECT_FALSE(run("", nullptr, y).IsOK());
+}
+
 void RunModelWithDenormalAsZero(InferenceSession& session_object,
                                 const RunOptions& run_options,
                                 bool set_denormal_as_zero) {
@@ -3002,5 +3787,75 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
   VerifyThreadPoolWithDenormalAsZero(session2.GetInterOpThreadPoolToUse(), false);
 }
 
+// the kernels run with denormal as zero on threads the session did not create
+TEST(InferenceSessionTests, DenormalAsZeroOnCallingThread) {
+  // test if denormal-as-zero mode is supported
+  if (!SetDenormalAsZero(false)) {
+    return;
+  }
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigSetDenormalAsZero, "1"));
+
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load("testdata/matmul_1.onnx"));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "calling_thread_denormal_as_zero";
+  std::thread([&]() {
+    SetDenormalAsZero(false);
+    RunModelWithDenormalAsZero(session, run_options, true);
+
+    // the mode of the calling thread is restored after each kernel
+    constexpr float denormal_float = 1e-38f;
+    volatile float input_float = denormal_float;
+    EXPECT_EQ(input_float * 2, denormal_float * 2);
+  }).join();
+
+  // Set back to default.
+  SetDenormalAsZero(false);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithDenormalCount) {
+  // a denormal output has to be computed without denormal as zero
+  SetDenormalAsZero(false);
+
+  SessionOptions so;
+  so.session_logid = "CheckRunProfiler";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_profile_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfileDenormals, "1"));
+
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load("testdata/matmul_1.onnx"));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  // X * [1, 2] of a denormal X is denormal
+  std::vector<float> values_mul(6, 1e-39f);
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2}, values_mul, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+  std::string profile_file = session.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  size_t kernel_events = 0;
+  bool has_denormal_count = false;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") != string::npos) {
+      ++kernel_events;
+      has_denormal_count = has_denormal_count ||
+                           line.find(R"("denormal_output_count" : "3")") != string::npos;
+    }
+  }
+
+  ASSERT_GT(kernel_events, 0u);
+  ASSERT_TRUE(has_denormal_count);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,8 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/framework/mem_pattern_disk_cache.h"
 #include "core/framework/mem_pattern_planner.h"
+#include "core/framework/static_mem_pattern_planner.h"
+#include "core/platform/env.h"
 #include "gtest/gtest.h"
+#include "asserts.h"
+#include "test/util/include/temp_dir.h"
 
 namespace onnxruntime {
 namespace test {
@@ -35,5 +40,85 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024u + 256u + 512u);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024u);
 }
+
+TEST(MemPatternPlannerTest, StaticPlanGreedyBySize) {
+  StaticMemPatternPlanner planner;
+  // a small tensor that lives long would keep the buffer of the first tensor from being reused if the tensors were
+  // placed in the order in which they are allocated.
+  planner.AddTensor(0, 100, 0, 0);
+  planner.AddTensor(1, 10, 0, 3);
+  planner.AddTensor(2, 200, 1, 2);
+  planner.AddTensor(3, 50, 2, 3);
+  planner.AddTensor(4, 0, 1, 1);
+
+  auto pattern = planner.GenerateMemPattern();
+
+  EXPECT_EQ(pattern.PeakSize(), 260u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 200u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 250u);
+  EXPECT_EQ(pattern.GetBlock(4)->size_, 0u);
+}
+
+TEST(MemPatternPlannerTest, StaticPlanBestFit) {
+  StaticMemPatternPlanner planner;
+  planner.AddTensor(0, 400, 0, 4);
+  planner.AddTensor(1, 300, 0, 1);
+  planner.AddTensor(2, 200, 0, 4);
+  planner.AddTensor(3, 100, 0, 1);
+  planner.AddTensor(4, 90, 0, 4);
+  // after step 1 there are gaps of 300 and 100 bytes, the 80 byte tensor takes the smaller one
+  planner.AddTensor(5, 80, 2, 3);
+
+  auto pattern = planner.GenerateMemPattern();
+
+  EXPECT_EQ(pattern.PeakSize(), 1090u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 400u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 700u);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 900u);
+  EXPECT_EQ(pattern.GetBlock(4)->offset_, 1000u);
+  EXPECT_EQ(pattern.GetBlock(5)->offset_, 900u);
+}
+
+TEST(MemPatternPlannerTest, DiskCacheRoundTrip) {
+  TemporaryDirectory cache_dir(ORT_TSTR("mem_pattern_disk_cache_test"));
+
+  constexpr bool using_counters = false;
+  MemPatternPlanner planner{using_counters};
+  planner.TraceAllocation(0, 1024);
+  planner.TraceAllocation(1, 256);
+  planner.TraceFree(0);
+  planner.TraceAllocation(2, 512);
+
+  NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns;
+  MemoryPatternGroup group;
+  group.locations.push_back(OrtDevice());
+  group.patterns.push_back(planner.GenerateMemPattern());
+  mem_patterns.emplace(42, std::move(group));
+
+  MemoryPatternDiskCache cache(Env::Default(), cache_dir.Path(), "plan");
+  ASSERT_STATUS_OK(cache.Save(mem_patterns));
+
+  NodeHashMap<int64_t, MemoryPatternGroup> loaded;
+  ASSERT_STATUS_OK(cache.Load(loaded));
+  ASSERT_EQ(loaded.size(), 1u);
+  const MemoryPattern* pattern = loaded[42].GetPatterns(OrtDevice());
+  ASSERT_NE(pattern, nullptr);
+  const MemoryPattern& expected = *mem_patterns[42].GetPatterns(OrtDevice());
+  EXPECT_EQ(pattern->PeakSize(), expected.PeakSize());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(pattern->GetBlock(i)->offset_, expected.GetBlock(i)->offset_);
+    EXPECT_EQ(pattern->GetBlock(i)->size_, expected.GetBlock(i)->size_);
+  }
+
+  // the patterns of another execution plan are not used
+  MemoryPatternDiskCache other_plan_cache(Env::Default(), cache_dir.Path(), "other plan");
+  NodeHashMap<int64_t, MemoryPatternGroup> not_loaded;
+  ASSERT_STATUS_OK(other_plan_cache.Load(not_loaded));
+  EXPECT_TRUE(not_loaded.empty());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
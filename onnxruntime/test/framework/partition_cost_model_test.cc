@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <fstream>
+#include <sstream>
+
+#include "core/common/path_string.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/framework/partition_cost_model.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+#include "asserts.h"
+#include "test/test_environment.h"
+#include "test/util/include/temp_dir.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr const char* kFakeDeviceExecutionProvider = "FakeDeviceExecutionProvider";
+
+// Execution provider without kernels whose memory lives on a GPU, the nodes are assigned to it by hand.
+class FakeDeviceExecutionProvider : public IExecutionProvider {
+ public:
+  FakeDeviceExecutionProvider()
+      : IExecutionProvider{kFakeDeviceExecutionProvider, OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0)} {}
+};
+
+TypeProto FloatTensorType(std::initializer_list<int64_t> dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (int64_t dim : dims) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+class PartitionCostModelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = std::make_unique<Model>("test", false, DefaultLoggingManager().DefaultLogger());
+    ASSERT_STATUS_OK(execution_providers_.Add(kFakeDeviceExecutionProvider,
+                                              std::make_unique<FakeDeviceExecutionProvider>()));
+    ASSERT_STATUS_OK(execution_providers_.Add(kCpuExecutionProvider,
+                                              std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo())));
+    ASSERT_STATUS_OK(kernel_registry_manager_.RegisterKernels(execution_providers_));
+  }
+
+  Graph& GetGraph() { return model_->MainGraph(); }
+
+  std::unique_ptr<Model> model_;
+  ExecutionProviders execution_providers_;
+  KernelRegistryManager kernel_registry_manager_;
+};
+
+}  // namespace
+
+// A single Neg on the device between two CPU nodes costs two copies and is moved back to the CPU EP.
+TEST_F(PartitionCostModelTest, MergeSmallIsland) {
+  Graph& graph = GetGraph();
+  const TypeProto type = FloatTensorType({1, 64});
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& a = graph.GetOrCreateNodeArg("A", &type);
+  auto& b = graph.GetOrCreateNodeArg("B", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+
+  auto& relu = graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  auto& neg = graph.AddNode("neg", "Neg", "", {&a}, {&b});
+  auto& abs = graph.AddNode("abs", "Abs", "", {&b}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  relu.SetExecutionProviderType(kCpuExecutionProvider);
+  neg.SetExecutionProviderType(kFakeDeviceExecutionProvider);
+  abs.SetExecutionProviderType(kCpuExecutionProvider);
+
+  const auto islands = partition_cost_model::FindDeviceIslands(graph, execution_providers_);
+  ASSERT_EQ(islands.size(), 1u);
+  EXPECT_EQ(islands[0].provider_type, kFakeDeviceExecutionProvider);
+  ASSERT_EQ(islands[0].nodes.size(), 1u);
+  EXPECT_EQ(islands[0].nodes[0], neg.Index());
+  EXPECT_LT(islands[0].cpu_cost_us, islands[0].device_cost_us);
+
+  ASSERT_STATUS_OK(partition_cost_model::MergeDeviceIslandsToCpu(graph, execution_providers_,
+                                                                 kernel_registry_manager_,
+                                                                 DefaultLoggingManager().DefaultLogger()));
+  EXPECT_EQ(neg.GetExecutionProviderType(), kCpuExecutionProvider);
+}
+
+// A large MatMul saves more on the device than the copies around it cost.
+TEST_F(PartitionCostModelTest, KeepExpensiveIsland) {
+  Graph& graph = GetGraph();
+  const TypeProto type = FloatTensorType({256, 256});
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& w = graph.GetOrCreateNodeArg("W", &type);
+  auto& a = graph.GetOrCreateNodeArg("A", &type);
+  auto& b = graph.GetOrCreateNodeArg("B", &type);
+  auto& c = graph.GetOrCreateNodeArg("C", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+
+  auto& relu = graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  auto& matmul = graph.AddNode("matmul", "MatMul", "", {&a, &w}, {&b});
+  auto& neg = graph.AddNode("neg", "Neg", "", {&b}, {&c});
+  auto& abs = graph.AddNode("abs", "Abs", "", {&c}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  relu.SetExecutionProviderType(kCpuExecutionProvider);
+  matmul.SetExecutionProviderType(kFakeDeviceExecutionProvider);
+  neg.SetExecutionProviderType(kFakeDeviceExecutionProvider);
+  abs.SetExecutionProviderType(kCpuExecutionProvider);
+
+  const auto islands = partition_cost_model::FindDeviceIslands(graph, execution_providers_);
+  ASSERT_EQ(islands.size(), 1u);
+  EXPECT_EQ(islands[0].nodes.size(), 2u);
+  EXPECT_GT(islands[0].cpu_cost_us, islands[0].device_cost_us);
+
+  ASSERT_STATUS_OK(partition_cost_model::MergeDeviceIslandsToCpu(graph, execution_providers_,
+                                                                 kernel_registry_manager_,
+                                                                 DefaultLoggingManager().DefaultLogger()));
+  EXPECT_EQ(matmul.GetExecutionProviderType(), kFakeDeviceExecutionProvider);
+  EXPECT_EQ(neg.GetExecutionProviderType(), kFakeDeviceExecutionProvider);
+}
+
+// An island is not moved if the CPU EP has no kernel for one of its nodes, here Neg for float16.
+TEST_F(PartitionCostModelTest, KeepIslandWithoutCpuKernel) {
+  Graph& graph = GetGraph();
+  TypeProto type = FloatTensorType({1, 64});
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& a = graph.GetOrCreateNodeArg("A", &type);
+  auto& b = graph.GetOrCreateNodeArg("B", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+
+  auto& neg = graph.AddNode("neg", "Neg", "", {&x}, {&a});
+  auto& relu = graph.AddNode("relu", "Relu", "", {&a}, {&b});
+  auto& abs = graph.AddNode("abs", "Abs", "", {&b}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  neg.SetExecutionProviderType(kFakeDeviceExecutionProvider);
+  relu.SetExecutionProviderType(kFakeDeviceExecutionProvider);
+  abs.SetExecutionProviderType(kCpuExecutionProvider);
+
+  const auto islands = partition_cost_model::FindDeviceIslands(graph, execution_providers_);
+  ASSERT_EQ(islands.size(), 1u);
+  EXPECT_LT(islands[0].cpu_cost_us, islands[0].device_cost_us);
+
+  ASSERT_STATUS_OK(partition_cost_model::MergeDeviceIslandsToCpu(graph, execution_providers_,
+                                                                 kernel_registry_manager_,
+                                                                 DefaultLoggingManager().DefaultLogger()));
+  EXPECT_EQ(neg.GetExecutionProviderType(), kFakeDeviceExecutionProvider);
+  EXPECT_EQ(relu.GetExecutionProviderType(), kFakeDeviceExecutionProvider);
+}
+
+TEST_F(PartitionCostModelTest, WriteAssignment) {
+  Graph& graph = GetGraph();
+  const TypeProto type = FloatTensorType({1, 64});
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& a = graph.GetOrCreateNodeArg("A", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+
+  auto& relu = graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  auto& neg = graph.AddNode("neg", "Neg", "", {&a}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  relu.SetExecutionProviderType(kCpuExecutionProvider);
+  neg.SetExecutionProviderType(kFakeDeviceExecutionProvider);
+
+  TemporaryDirectory temp_dir(ORT_TSTR("partition_cost_model_test"));
+  const std::string file_path = ToUTF8String(temp_dir.Path() + ORT_TSTR("/assignment.txt"));
+  ASSERT_STATUS_OK(partition_cost_model::WriteAssignment(graph, file_path));
+
+  std::ifstream in(file_path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  const std::string& graph_name = graph.Name();
+  EXPECT_EQ(contents.str(),
+            graph_name + "\trelu\t:Relu\t" + kCpuExecutionProvider + "\n" +
+                graph_name + "\tneg\t:Neg\t" + kFakeDeviceExecutionProvider + "\n");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "core/session/request_batcher.h"
+#include "core/framework/tensor.h"
+#include "test_utils.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Records the batch sizes the graph was run with. The output "Y" is the input doubled, or a scalar if
+// `reduce_batches` is set and more than one row is run.
+struct FakeGraph {
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  bool reduce_batches = false;
+  // called with the batch size of each run
+  std::function<void(int64_t)> on_run;
+  std::mutex mutex;
+  std::vector<int64_t> batch_sizes;
+
+  RequestBatcher::RunFn RunFunction() {
+    return [this](const RunOptions& run_options, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+                  gsl::span<const std::string>, std::vector<OrtValue>& fetches) {
+      const auto& input = feeds[0].Get<Tensor>();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch_sizes.push_back(input.Shape()[0]);
+      }
+
+      if (on_run) {
+        on_run(input.Shape()[0]);
+      }
+
+      if (run_options.terminate) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      }
+
+      if (reduce_batches && input.Shape()[0] > 1) {
+        CreateMLValue<float>(allocator, {}, {0.f}, &fetches[0]);
+        return Status::OK();
+      }
+
+      std::vector<float> output;
+      for (float value : input.DataAsSpan<float>()) {
+        output.push_back(value * 2);
+      }
+      CreateMLValue<float>(allocator, input.Shape().AsShapeVector(), output, &fetches[0]);
+      return Status::OK();
+    };
+  }
+};
+
+Status RunRequest(RequestBatcher& batcher, const AllocatorPtr& allocator, std::vector<int64_t> dims,
+                  std::vector<float> values, OrtValue& output, const RunOptions& run_options = RunOptions{}) {
+  std::vector<std::string> feed_names{"X"};
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, dims, values, &feeds[0]);
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches(1);
+  ORT_RETURN_IF_ERROR(batcher.Run(run_options, feed_names, feeds, output_names, fetches));
+  output = fetches[0];
+  return Status::OK();
+}
+
+}  // namespace
+
+TEST(RequestBatcherTest, BatchesConcurrentRequests) {
+  FakeGraph graph;
+  // the batch only runs once it is full
+  RequestBatcher batcher(3, std::chrono::seconds(60), graph.allocator, graph.RunFunction());
+
+  OrtValue output1, output2;
+  std::thread thread1([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 2}, {1.f, 2.f}, output1));
+  });
+  std::thread thread2([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {2, 2}, {3.f, 4.f, 5.f, 6.f}, output2));
+  });
+  thread1.join();
+  thread2.join();
+
+  ASSERT_EQ(graph.batch_sizes, std::vector<int64_t>{3});
+  EXPECT_EQ(output1.Get<Tensor>().Shape(), TensorShape({1, 2}));
+  EXPECT_EQ(output2.Get<Tensor>().Shape(), TensorShape({2, 2}));
+  const auto values1 = output1.Get<Tensor>().DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(values1.begin(), values1.end()), (std::vector<float>{2.f, 4.f}));
+  const auto values2 = output2.Get<Tensor>().DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(values2.begin(), values2.end()), (std::vector<float>{6.f, 8.f, 10.f, 12.f}));
+}
+
+TEST(RequestBatcherTest, RunsAloneAfterTimeout) {
+  FakeGraph graph;
+  RequestBatcher batcher(4, std::chrono::milliseconds(1), graph.allocator, graph.RunFunction());
+
+  OrtValue output;
+  ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 2}, {1.f, 2.f}, output));
+  // too large to be batched
+  ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {4, 1}, {1.f, 2.f, 3.f, 4.f}, output));
+
+  EXPECT_EQ(graph.batch_sizes, (std::vector<int64_t>{1, 4}));
+  const auto values = output.Get<Tensor>().DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(values.begin(), values.end()), (std::vector<float>{2.f, 4.f, 6.f, 8.f}));
+}
+
+TEST(RequestBatcherTest, RunsAloneWithoutBatchDimensionInOutputs) {
+  FakeGraph graph;
+  graph.reduce_batches = true;
+  RequestBatcher batcher(2, std::chrono::seconds(60), graph.allocator, graph.RunFunction());
+
+  OrtValue output1, output2;
+  std::thread thread1([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 1}, {1.f}, output1));
+  });
+  std::thread thread2([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 1}, {2.f}, output2));
+  });
+  thread1.join();
+  thread2.join();
+
+  // the batch of 2 rows, then each request on its own
+  EXPECT_EQ(graph.batch_sizes, (std::vector<int64_t>{2, 1, 1}));
+  EXPECT_EQ(output1.Get<Tensor>().Data<float>()[0], 2.f);
+  EXPECT_EQ(output2.Get<Tensor>().Data<float>()[0], 4.f);
+}
+
+TEST(RequestBatcherTest, BatchesOnlyRequestsWithSameRunOptions) {
+  FakeGraph graph;
+  RequestBatcher batcher(2, std::chrono::milliseconds(10), graph.allocator, graph.RunFunction());
+
+  RunOptions run_options1;
+  run_options1.run_tag = "1";
+  RunOptions run_options2;
+  run_options2.run_tag = "2";
+  OrtValue output1, output2;
+  std::thread thread1([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 1}, {1.f}, output1, run_options1));
+  });
+  std::thread thread2([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 1}, {2.f}, output2, run_options2));
+  });
+  thread1.join();
+  thread2.join();
+
+  // each request ran on its own after the timeout
+  EXPECT_EQ(graph.batch_sizes, (std::vector<int64_t>{1, 1}));
+  EXPECT_EQ(output1.Get<Tensor>().Data<float>()[0], 2.f);
+  EXPECT_EQ(output2.Get<Tensor>().Data<float>()[0], 4.f);
+}
+
+TEST(RequestBatcherTest, TerminatesRequestDuringBatchedRun) {
+  FakeGraph graph;
+  RequestBatcher batcher(3, std::chrono::seconds(60), graph.allocator, graph.RunFunction());
+
+  RunOptions terminated_run_options;
+  graph.on_run = [&terminated_run_options](int64_t batch_size) {
+    if (batch_size == 3) {
+      terminated_run_options.terminate = true;
+    }
+  };
+
+  OrtValue output1, output2, output3;
+  Status status2;
+  std::thread thread1([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 1}, {1.f}, output1));
+  });
+  std::thread thread2([&]() {
+    status2 = RunRequest(batcher, graph.allocator, {1, 1}, {2.f}, output2, terminated_run_options);
+  });
+  std::thread thread3([&]() {
+    ASSERT_STATUS_OK(RunRequest(batcher, graph.allocator, {1, 1}, {3.f}, output3));
+  });
+  thread1.join();
+  thread2.join();
+  thread3.join();
+
+  // the batched run completed for the other requests, the terminated one got no outputs
+  EXPECT_EQ(graph.batch_sizes, std::vector<int64_t>{3});
+  EXPECT_FALSE(status2.IsOK());
+  EXPECT_FALSE(output2.IsAllocated());
+  EXPECT_EQ(output1.Get<Tensor>().Data<float>()[0], 2.f);
+  EXPECT_EQ(output3.Get<Tensor>().Data<float>()[0], 6.f);
+}
+
+TEST(RequestBatcherTest, RunManyBatchesWithoutWaiting) {
+  FakeGraph graph;
+  // a timeout that would fail the test if the batches waited for it
+  RequestBatcher batcher(3, std::chrono::seconds(60), graph.allocator, graph.RunFunction());
+
+  std::vector<std::string> feed_names{"X"};
+  std::vector<std::string> output_names{"Y"};
+  std::vector<std::vector<OrtValue>> feeds(4, std::vector<OrtValue>(1));
+  CreateMLValue<float>(graph.allocator, {1, 1}, {1.f}, &feeds[0][0]);
+  CreateMLValue<float>(graph.allocator, {2, 1}, {2.f, 3.f}, &feeds[1][0]);
+  // too large to be batched
+  CreateMLValue<float>(graph.allocator, {3, 1}, {4.f, 5.f, 6.f}, &feeds[2][0]);
+  CreateMLValue<float>(graph.allocator, {1, 1}, {7.f}, &feeds[3][0]);
+  std::vector<std::vector<OrtValue>> fetches(feeds.size());
+  ASSERT_STATUS_OK(batcher.RunMany(RunOptions{}, feed_names, feeds, output_names, fetches));
+
+  // the first two requests fill a batch, the others run on their own
+  EXPECT_EQ(graph.batch_sizes, (std::vector<int64_t>{3, 3, 1}));
+  const std::vector<std::vector<float>> expected{{2.f}, {4.f, 6.f}, {8.f, 10.f, 12.f}, {14.f}};
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    ASSERT_EQ(fetches[i].size(), 1u);
+    const auto values = fetches[i][0].Get<Tensor>().DataAsSpan<float>();
+    EXPECT_EQ(std::vector<float>(values.begin(), values.end()), expected[i]);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
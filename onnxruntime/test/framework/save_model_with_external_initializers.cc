@@ -3,6 +3,7 @@
 
 #include "core/common/path_string.h"
 #include "core/framework/data_types.h"
+#include "core/framework/tensor_external_data_info.h"
 #include "core/graph/model.h"
 #include "core/framework/tensorprotoutils.h"
 #include "test/test_environment.h"
@@ -68,6 +69,13 @@ void LoadSaveAndCompareModel(const std::string& input_onnx,
     } else {
       // 'Large' tensors should be added to the external binary file.
       EXPECT_EQ(from_external_tensor_proto->data_location(), ONNX_NAMESPACE::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL);
+
+      // Tensors of 64KB or more start on a 64KB boundary so they can be mapped directly.
+      std::unique_ptr<ExternalDataInfo> external_data_info;
+      ASSERT_STATUS_OK(ExternalDataInfo::Create(from_external_tensor_proto->external_data(), external_data_info));
+      if (from_external_tensor_proto_size >= 65536) {
+        EXPECT_EQ(external_data_info->GetOffset() % 65536, 0);
+      }
     }
 
     ASSERT_EQ(tensor_proto_size, from_external_tensor_proto_size);
@@ -21,6 +21,7 @@
 #include "gtest/gtest.h"
 #include "test/test_environment.h"
 #include "test/util/include/default_providers.h"
+#include "test/util/include/temp_dir.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 
 using namespace ONNX_NAMESPACE;
@@ -368,6 +369,10 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  bool CanSkipPrePackWithSharedBuffers(int /*input_idx*/) const override {
+    return true;
+  }
+
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
                  /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override {
     ORT_UNUSED_PARAMETER(tensor);
@@ -526,13 +531,16 @@ static void PlaceAllNodesToCPUEP(Graph& graph) {
 struct PrepackingTestParam {
   bool test_subgraph;
   bool test_prepacking;
+  bool test_parallel_prepacking;
 };
 
 class SessionStatePrepackingTest : public testing::TestWithParam<PrepackingTestParam> {};
 TEST_P(SessionStatePrepackingTest, PrePackingTest) {
   PrepackingTestParam test_param = GetParam();
 
+  // Two threads even on single core machines, so that parallel pre-packing is not skipped for lack of a pool.
   OrtThreadPoolParams to;
+  to.thread_pool_size = 2;
   auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
   ONNX_OPERATOR_SCHEMA(PrePackingTest)
       .SetDoc("Faking Node for PrePacking")
@@ -567,6 +575,8 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
   sess_options.enable_mem_reuse = true;
   sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] =
       test_param.test_prepacking ? "0" : "1";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigEnableParallelPrepacking] =
+      test_param.test_parallel_prepacking ? "1" : "0";
 
   SessionState session_state(model.MainGraph(),
                              execution_providers,
@@ -983,12 +993,62 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + pre-packed weights disk cache =
+// first session pre-packs and writes the cache, second session maps the cached weight without pre-packing
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, DiskCache) {
+  TemporaryDirectory cache_dir(ORT_TSTR("prepacked_weights_disk_cache_test"));
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  // Enable pre-packing
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  // Enable the disk cache
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigPrepackedWeightsCacheDir] =
+      PathToUTF8String(cache_dir.Path());
+
+  for (int session = 0; session < 2; session++) {
+    Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+    CreateSimpleGraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    SessionState session_state(model.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options);
+
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+
+    const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(0));
+
+    // Only the first session calls PrePack(), both use the buffer through UseSharedPrePackedBuffers()
+    ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    ASSERT_EQ(kernel->prepack_calls_count, session == 0 ? 1 : 0);
+    ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+
+    const float* weight_packed = reinterpret_cast<const float*>(kernel->weight_packed_.get());
+    ASSERT_EQ(weight_packed[0], 1.2345f);
+    ASSERT_EQ(weight_packed[1], 1.2345f * 2.f);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
-                         testing::Values(PrepackingTestParam{false, false},
-                                         PrepackingTestParam{false, true},
-                                         PrepackingTestParam{true, false},
-                                         PrepackingTestParam{true, true}));
+                         testing::Values(PrepackingTestParam{false, false, false},
+                                         PrepackingTestParam{false, true, false},
+                                         PrepackingTestParam{false, true, true},
+                                         PrepackingTestParam{true, false, false},
+                                         PrepackingTestParam{true, true, false},
+                                         PrepackingTestParam{true, true, true}));
 #endif
 
 }  // namespace test
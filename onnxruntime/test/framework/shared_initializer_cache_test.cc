@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_cache.h"
+
+#include "core/framework/tensor.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+#include "gtest/gtest.h"
+#include "asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+ONNX_NAMESPACE::TensorProto MakeFloatTensorProto(const std::string& name, const std::vector<int64_t>& dims,
+                                                 const std::vector<float>& values) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (int64_t dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  for (float value : values) {
+    tensor_proto.add_float_data(value);
+  }
+  return tensor_proto;
+}
+
+}  // namespace
+
+TEST(SharedInitializerCacheTest, SharesByContent) {
+  SharedInitializerCache cache;
+  const auto w1 = MakeFloatTensorProto("W1", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  // same content under another name, as in another model
+  const auto w2 = MakeFloatTensorProto("W2", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  // same data with another shape
+  const auto w3 = MakeFloatTensorProto("W3", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  // same shape with other data
+  const auto w4 = MakeFloatTensorProto("W4", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 7.f});
+
+  OrtValue v1, v2, v3, v4;
+  bool reused = true;
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w1, v1, reused));
+  EXPECT_FALSE(reused);
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w2, v2, reused));
+  EXPECT_TRUE(reused);
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w3, v3, reused));
+  EXPECT_FALSE(reused);
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w4, v4, reused));
+  EXPECT_FALSE(reused);
+
+  EXPECT_EQ(v1.Get<Tensor>().Data<float>(), v2.Get<Tensor>().Data<float>());
+  EXPECT_NE(v1.Get<Tensor>().Data<float>(), v3.Get<Tensor>().Data<float>());
+  EXPECT_NE(v1.Get<Tensor>().Data<float>(), v4.Get<Tensor>().Data<float>());
+  EXPECT_EQ(v3.Get<Tensor>().Shape(), TensorShape({3, 2}));
+  EXPECT_EQ(v4.Get<Tensor>().Data<float>()[5], 7.f);
+  EXPECT_EQ(cache.NumLiveTensors(), 3u);
+}
+
+TEST(SharedInitializerCacheTest, FreedWithLastUser) {
+  SharedInitializerCache cache;
+  const auto w = MakeFloatTensorProto("W", {4}, {1.f, 2.f, 3.f, 4.f});
+
+  OrtValue v1, v2;
+  bool reused = false;
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w, v1, reused));
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w, v2, reused));
+  EXPECT_TRUE(reused);
+  EXPECT_EQ(cache.NumLiveTensors(), 1u);
+
+  v1 = OrtValue();
+  EXPECT_EQ(cache.NumLiveTensors(), 1u);
+  v2 = OrtValue();
+  EXPECT_EQ(cache.NumLiveTensors(), 0u);
+
+  // the next user creates it again
+  OrtValue v3;
+  ASSERT_STATUS_OK(cache.GetOrCreate(Env::Default(), PathString(), w, v3, reused));
+  EXPECT_FALSE(reused);
+  EXPECT_EQ(v3.Get<Tensor>().Data<float>()[3], 4.f);
+  EXPECT_EQ(cache.NumLiveTensors(), 1u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
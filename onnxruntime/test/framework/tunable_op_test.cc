@@ -7,9 +7,10 @@
 
 #include "core/common/common.h"
 #include "core/framework/tunable.h"
-#define TUNING_CONTEXT_IMPL
-#include "core/framework/tuning_context_impl.h"
-#undef TUNING_CONTEXT_IMPL
+#include "core/platform/env.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/providers/cpu/tunable/gemm.h"
 
 using namespace std::chrono_literals;
 
@@ -734,6 +735,63 @@ TEST(TuningContext, GetAndLoadTuningResults) {
 #endif
 }
 
+TEST(TuningContext, CpuExecutionProviderTuningResults) {
+#ifdef ORT_NO_RTTI
+  GTEST_SKIP() << "TunableOp needs RTTI to work correctly";
+#else
+  constexpr size_t M = 2, N = 48, K = 96;
+  std::vector<float> a(M * K), b(K * N), c(M * N), expected(M * N);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(static_cast<int>(i % 13) - 6) / 8.0f;
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = static_cast<float>(static_cast<int>(i % 7) - 3) / 4.0f;
+  }
+  for (size_t m = 0; m < M; m++) {
+    for (size_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (size_t k = 0; k < K; k++) {
+        sum += a[m * K + k] * b[k * N + n];
+      }
+      expected[m * N + n] = sum;
+    }
+  }
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = a.data();
+  data.lda = K;
+  data.B = b.data();
+  data.ldb = N;
+  data.C = c.data();
+  data.ldc = N;
+
+  auto tp = std::make_unique<concurrency::ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, true);
+  CPUExecutionProvider ep{CPUExecutionProviderInfo{}};
+  auto* ctx = static_cast<cpu::tunable::CpuTuningContext*>(ep.GetTuningContext());
+  ASSERT_NE(ctx, nullptr);
+  ASSERT_FALSE(ctx->IsTunableOpEnabled());
+  ctx->EnableTunableOpAndTuning();
+  ctx->SetMaxTuningDurationMs(1);
+
+  // Tuning runs every candidate on the actual output, the result must still be the one of a single GEMM.
+  ASSERT_STATUS_OK(cpu::tunable::Sgemm(ctx, CblasNoTrans, CblasNoTrans, M, N, K, &data, 1, tp.get()));
+  for (size_t i = 0; i < c.size(); i++) {
+    ASSERT_NEAR(c[i], expected[i], 1e-4f) << "@" << i;
+  }
+
+  auto trs = ctx->GetTuningResults();
+  ASSERT_EQ(trs.ep, kCpuExecutionProvider);
+  ASSERT_THAT(trs.validators, ::testing::Contains(::testing::Key("CPU_FEATURES")));
+  ASSERT_EQ(trs.results.size(), 1u);
+  ASSERT_EQ(trs.results.begin()->second.size(), 1u);
+
+  // The results are valid for another CPU EP in the same process.
+  CPUExecutionProvider other_ep{CPUExecutionProviderInfo{}};
+  ASSERT_STATUS_OK(other_ep.GetTuningContext()->LoadTuningResults(trs));
+  ASSERT_EQ(other_ep.GetTuningContext()->GetTuningResults().results, trs.results);
+#endif
+}
+
 }  // namespace tuning_context
 
 }  // namespace test
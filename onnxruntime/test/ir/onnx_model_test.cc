@@ -2,14 +2,19 @@
 // Licensed under the MIT License.
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <fstream>
 #include <memory>
+#include <numeric>
 #include "core/platform/env.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/platform/path_lib.h"
 #include "core/session/onnxruntime_c_api.h"
 #include "test/providers/provider_test_utils.h"  //For ASSERT_STATUS_OK
 #include "test/test_environment.h"
+#include "test/util/include/temp_dir.h"
 #include "gtest/gtest.h"
 #include "onnx/defs/function.h"
 #include "onnx/defs/parser.h"
@@ -423,5 +428,71 @@ agraph (float[N] x, float[N] y) => (float[N] zp)
   RunFunctionTests(std::move(model_proto));
 }
 
+// Loading with lazy initializer data keeps the raw data of large initializers in the mapped model file.
+TEST_F(ONNXModelsTest, LoadWithLazyInitializerData) {
+  const char* code = R"ONNX(
+<
+  ir_version: 8,
+  opset_import: [ "" : 13]
+>
+agraph (float[512] x) => (float[512] y)
+{
+    t = Add(x, large)
+    y = Mul(t, small)
+}
+)ONNX";
+
+  ModelProto model_proto;
+  ONNX_NAMESPACE::OnnxParser parser(code);
+  ASSERT_TRUE(parser.Parse(model_proto).IsOK());
+
+  std::vector<float> large_data(512);
+  std::iota(large_data.begin(), large_data.end(), 0.0f);
+  auto* large = model_proto.mutable_graph()->add_initializer();
+  large->set_name("large");
+  large->set_data_type(TensorProto_DataType_FLOAT);
+  large->add_dims(512);
+  large->set_raw_data(large_data.data(), large_data.size() * sizeof(float));
+
+  const float small_data = 2.0f;
+  auto* small = model_proto.mutable_graph()->add_initializer();
+  small->set_name("small");
+  small->set_data_type(TensorProto_DataType_FLOAT);
+  small->add_dims(1);
+  small->set_raw_data(&small_data, sizeof(float));
+
+  TemporaryDirectory tmp_dir(ORT_TSTR("lazy_initializer_data_test"));
+  const PathString model_path = ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("model.onnx"));
+  {
+    std::ofstream model_stream(model_path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_stream));
+  }
+
+  ModelOptions options;
+  options.lazy_initializer_data = true;
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_path, model, nullptr, *logger_, options));
+
+  const TensorProto* tensor = nullptr;
+  ASSERT_TRUE(model->MainGraph().GetInitializedTensor("large", tensor));
+  EXPECT_TRUE(utils::HasExternalDataInMemory(*tensor));
+  std::vector<uint8_t> unpacked;
+  ASSERT_STATUS_OK(utils::UnpackInitializerData(*tensor, unpacked));
+  ASSERT_EQ(unpacked.size(), large_data.size() * sizeof(float));
+  EXPECT_EQ(0, memcmp(unpacked.data(), large_data.data(), unpacked.size()));
+
+  ASSERT_TRUE(model->MainGraph().GetInitializedTensor("small", tensor));
+  EXPECT_FALSE(utils::HasExternalData(*tensor));
+  EXPECT_TRUE(utils::HasRawData(*tensor));
+
+  // the serialized model must not refer to the mapped file
+  ModelProto saved_proto = model->ToProto();
+  ASSERT_EQ(saved_proto.graph().initializer_size(), 2);
+  for (const auto& initializer : saved_proto.graph().initializer()) {
+    EXPECT_FALSE(utils::HasExternalData(initializer));
+    EXPECT_EQ(initializer.raw_data(), model_proto.graph().initializer(initializer.name() == "large" ? 0 : 1).raw_data());
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
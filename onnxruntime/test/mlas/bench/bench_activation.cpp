@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+using MlasUnaryFunction = void(MLASCALL*)(const float* Input, float* Output, size_t N);
+
+void ELEMENTWISE(benchmark::State& state, MlasUnaryFunction function) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -5.0f, 5.0f);
+  std::vector<float> output(N);
+
+  function(input.data(), output.data(), N);
+  for (auto _ : state) {
+    function(input.data(), output.data(), N);
+  }
+
+  SetRooflineCounters(state, 0, 2.0 * N * sizeof(float));
+}
+
+BENCHMARK_CAPTURE(ELEMENTWISE, Erf, MlasComputeErf)->ArgName("N")->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_CAPTURE(ELEMENTWISE, Exp, MlasComputeExp)->ArgName("N")->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_CAPTURE(ELEMENTWISE, Logistic, MlasComputeLogistic)->ArgName("N")->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_CAPTURE(ELEMENTWISE, Tanh, MlasComputeTanh)->ArgName("N")->Range(1 << 10, 1 << 22)->UseRealTime();
+
+// The activations fused into the GEMM and convolution kernels, applied in place with a bias per row.
+void ACTIVATION(benchmark::State& state, MLAS_ACTIVATION_KIND kind) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  constexpr size_t M = 64;
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = kind;
+  if (kind == MlasLeakyReluActivation) {
+    activation.Parameters.LeakyRelu.alpha = 0.01f;
+  } else if (kind == MlasClipActivation) {
+    activation.Parameters.Clip.minimum = 0.0f;
+    activation.Parameters.Clip.maximum = 6.0f;
+  } else if (kind == MlasHardSigmoidActivation) {
+    activation.Parameters.HardSigmoid.alpha = 0.2f;
+    activation.Parameters.HardSigmoid.beta = 0.5f;
+  }
+
+  auto buffer = RandomVectorUniform(M * N, -5.0f, 5.0f);
+  auto bias = RandomVectorUniform(M, -1.0f, 1.0f);
+
+  MlasActivation(&activation, buffer.data(), bias.data(), M, N, N);
+  for (auto _ : state) {
+    MlasActivation(&activation, buffer.data(), bias.data(), M, N, N);
+  }
+
+  SetRooflineCounters(state, 0, 2.0 * M * N * sizeof(float));
+}
+
+static void ActivationSizes(benchmark::internal::Benchmark* b) {
+  b->ArgName("N");
+  b->Range(1 << 6, 1 << 16);
+}
+
+BENCHMARK_CAPTURE(ACTIVATION, Relu, MlasReluActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, LeakyRelu, MlasLeakyReluActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Tanh, MlasTanhActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Logistic, MlasLogisticActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Clip, MlasClipActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, HardSigmoid, MlasHardSigmoidActivation)->Apply(ActivationSizes)->UseRealTime();
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/framework/float16.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> halfgemm_arg_names = {"M", "N", "K"};
+
+static std::vector<onnxruntime::MLFloat16> RandomHalfVector(size_t N) {
+  const auto values = RandomVectorUniform(N, -1.0f, 1.0f);
+  std::vector<onnxruntime::MLFloat16> result;
+  result.reserve(N);
+  for (float value : values) {
+    result.emplace_back(value);
+  }
+  return result;
+}
+
+void HGEMM(benchmark::State& state, bool pack_b) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  if (!MlasFp16AccelerationSupported()) {
+    state.SkipWithError("Half precision GEMM is not supported on this platform");
+    return;
+  }
+
+  const auto A = RandomHalfVector(M * K);
+  const auto B = RandomHalfVector(K * N);
+  std::vector<onnxruntime::MLFloat16> C(M * N);
+  std::vector<uint8_t> B_packed;
+
+  MLAS_HALF_GEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.lda = K;
+  params.C = reinterpret_cast<MLAS_FP16*>(C.data());
+  params.ldc = N;
+  if (pack_b) {
+    B_packed.resize(MlasHalfGemmPackBSize(N, K, false));
+    MlasHalfGemmPackB(N, K, reinterpret_cast<const MLAS_FP16*>(B.data()), N, B_packed.data());
+    params.B = B_packed.data();
+    params.ldb = 0;
+  } else {
+    params.B = B.data();
+    params.ldb = N;
+  }
+
+  MlasHalfGemmBatch(M, N, K, 1, &params, nullptr);
+  for (auto _ : state) {
+    MlasHalfGemmBatch(M, N, K, 1, &params, nullptr);
+  }
+
+  SetRooflineCounters(state, 2.0 * M * N * K, static_cast<double>(M * K + K * N + M * N) * sizeof(uint16_t));
+}
+
+static void HalfGemmSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_arg_names);
+  b->ArgsProduct({{1, 63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(HGEMM, NoPackB, false)->Apply(HalfGemmSizes)->UseRealTime();
+BENCHMARK_CAPTURE(HGEMM, PackB, true)->Apply(HalfGemmSizes)->UseRealTime();
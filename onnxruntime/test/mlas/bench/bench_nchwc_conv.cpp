@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> nchwc_conv_arg_names = {"N", "C", "H", "W", "F", "K", "S"};
+
+// Convolution of an input that is already in the NCHWc layout, with a square kernel of size K, a stride of S and the
+// padding that keeps the output size at the input size divided by the stride. C and F must be multiples of the
+// NCHWc block size.
+void NCHWC_CONV(benchmark::State& state) {
+  for (int i = 0; i < 7; i++) {
+    if (state.range(i) <= 0) throw std::invalid_argument(nchwc_conv_arg_names[i] + " must greater than 0!");
+  }
+  const int64_t batch_size = state.range(0);
+  const int64_t input_channels = state.range(1);
+  const int64_t height = state.range(2);
+  const int64_t width = state.range(3);
+  const int64_t filter_count = state.range(4);
+  const int64_t kernel = state.range(5);
+  const int64_t stride = state.range(6);
+  const int64_t padding = (kernel - 1) / 2;
+
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("The NCHWc layout is not supported on this platform");
+    return;
+  }
+  if (input_channels % block_size != 0 || filter_count % block_size != 0) {
+    state.SkipWithError("C and F must be multiples of the NCHWc block size");
+    return;
+  }
+
+  const int64_t input_shape[] = {batch_size, input_channels, height, width};
+  const int64_t filter_shape[] = {filter_count, input_channels, kernel, kernel};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t dilations[] = {1, 1};
+  const int64_t paddings[] = {padding, padding, padding, padding};
+  const int64_t strides[] = {stride, stride};
+  const int64_t output_shape[] = {batch_size, filter_count, (height + 2 * padding - kernel) / stride + 1,
+                                  (width + 2 * padding - kernel) / stride + 1};
+  if (output_shape[2] <= 0 || output_shape[3] <= 0) throw std::invalid_argument("Kernel larger than the input!");
+
+  const size_t input_size = static_cast<size_t>(batch_size * input_channels * height * width);
+  const size_t filter_size = static_cast<size_t>(filter_count * input_channels * kernel * kernel);
+  const size_t output_size = static_cast<size_t>(batch_size * filter_count * output_shape[2] * output_shape[3]);
+
+  auto input = RandomVectorUniform(input_size, -1.0f, 1.0f);
+  auto filter = RandomVectorUniform(filter_size, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(static_cast<size_t>(filter_count), -1.0f, 1.0f);
+  std::vector<float> nchwc_input(input_size);
+  std::vector<float> nchwc_filter(filter_size);
+  std::vector<float> nchwc_output(output_size);
+
+  const size_t image_size = static_cast<size_t>(input_channels * height * width);
+  for (int64_t n = 0; n < batch_size; n++) {
+    MlasReorderInputNchw(input.data() + n * image_size, nchwc_input.data() + n * image_size,
+                         static_cast<size_t>(input_channels), static_cast<size_t>(height * width));
+  }
+  MlasReorderFilterOIHWBiBo(filter_shape, filter.data(), nchwc_filter.data());
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  MlasNchwcConv(input_shape, kernel_shape, dilations, paddings, strides, output_shape, 1, nchwc_input.data(),
+                nchwc_filter.data(), bias.data(), nchwc_output.data(), &activation, true, nullptr);
+  for (auto _ : state) {
+    MlasNchwcConv(input_shape, kernel_shape, dilations, paddings, strides, output_shape, 1, nchwc_input.data(),
+                  nchwc_filter.data(), bias.data(), nchwc_output.data(), &activation, true, nullptr);
+  }
+
+  SetRooflineCounters(state, 2.0 * output_size * input_channels * kernel * kernel,
+                      static_cast<double>(input_size + filter_size + output_size) * sizeof(float));
+}
+
+static void NchwcConvSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(nchwc_conv_arg_names);
+  // ResNet-50 like layers, pointwise and 3x3
+  b->Args({1, 64, 56, 56, 256, 1, 1});
+  b->Args({1, 64, 56, 56, 64, 3, 1});
+  b->Args({1, 128, 28, 28, 128, 3, 1});
+  b->Args({1, 256, 14, 14, 1024, 1, 1});
+  b->Args({1, 256, 28, 28, 256, 3, 2});
+  b->Args({1, 512, 7, 7, 512, 3, 1});
+}
+
+BENCHMARK(NCHWC_CONV)->Apply(NchwcConvSizes)->UseRealTime();
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> pool_arg_names = {"N", "C", "H", "W", "K", "S"};
+
+// Pools with a square kernel of size K, a stride of S and the padding that keeps the output size at the input size
+// divided by the stride, as in the pooling layers of CNNs.
+void POOL2D(benchmark::State& state, MLAS_POOLING_KIND kind) {
+  for (int i = 0; i < 6; i++) {
+    if (state.range(i) <= 0) throw std::invalid_argument(pool_arg_names[i] + " must greater than 0!");
+  }
+  const int64_t batch_size = state.range(0);
+  const int64_t channels = state.range(1);
+  const int64_t height = state.range(2);
+  const int64_t width = state.range(3);
+  const int64_t kernel = state.range(4);
+  const int64_t stride = state.range(5);
+  const int64_t padding = (kernel - 1) / 2;
+
+  const int64_t input_shape[] = {batch_size, channels, height, width};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t paddings[] = {padding, padding, padding, padding};
+  const int64_t strides[] = {stride, stride};
+  const int64_t output_shape[] = {batch_size, channels, (height + 2 * padding - kernel) / stride + 1,
+                                  (width + 2 * padding - kernel) / stride + 1};
+  if (output_shape[2] <= 0 || output_shape[3] <= 0) throw std::invalid_argument("Kernel larger than the input!");
+
+  const size_t input_size = static_cast<size_t>(batch_size * channels * height * width);
+  const size_t output_size = static_cast<size_t>(batch_size * channels * output_shape[2] * output_shape[3]);
+  auto input = RandomVectorUniform(input_size, -1.0f, 1.0f);
+  std::vector<float> output(output_size);
+
+  MlasPool(kind, 2, input_shape, kernel_shape, paddings, strides, output_shape, input.data(), output.data(), nullptr);
+  for (auto _ : state) {
+    MlasPool(kind, 2, input_shape, kernel_shape, paddings, strides, output_shape, input.data(), output.data(),
+             nullptr);
+  }
+
+  SetRooflineCounters(state, static_cast<double>(output_size) * kernel * kernel,
+                      static_cast<double>(input_size + output_size) * sizeof(float));
+}
+
+static void PoolSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(pool_arg_names);
+  b->Args({1, 64, 112, 112, 3, 2});
+  b->Args({1, 256, 56, 56, 3, 1});
+  b->Args({1, 512, 28, 28, 2, 2});
+  b->Args({1, 1024, 14, 14, 3, 2});
+}
+
+BENCHMARK_CAPTURE(POOL2D, Max, MlasMaximumPooling)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, AverageExcludePad, MlasAveragePoolingExcludePad)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, AverageIncludePad, MlasAveragePoolingIncludePad)->Apply(PoolSizes)->UseRealTime();
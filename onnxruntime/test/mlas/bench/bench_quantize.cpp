@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+template <typename T>
+void QUANTIZELINEAR(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -10.0f, 10.0f);
+  std::vector<T> output(N);
+  constexpr float scale = 0.1f;
+  constexpr T zero_point = 3;
+
+  MlasQuantizeLinear(input.data(), output.data(), N, scale, zero_point);
+  for (auto _ : state) {
+    MlasQuantizeLinear(input.data(), output.data(), N, scale, zero_point);
+  }
+
+  SetRooflineCounters(state, 0, static_cast<double>(N) * (sizeof(float) + sizeof(T)));
+}
+
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, uint8_t)->ArgName("N")->Range(1 << 10, 1 << 24)->UseRealTime();
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, int8_t)->ArgName("N")->Range(1 << 10, 1 << 24)->UseRealTime();
+
+static const std::vector<std::string> requantize_arg_names = {"M", "N", "PerColumn"};
+
+// Requantizes the int32 output of an integer GEMM, with a bias as the quantized MatMul and Conv kernels do.
+template <typename T>
+void REQUANTIZE(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const bool per_column = state.range(2) != 0;
+
+  auto input = RandomVectorUniform<int32_t>(M * N, -100000, 100000);
+  auto bias = RandomVectorUniform<int32_t>(N, -1000, 1000);
+  auto scale = RandomVectorUniform(per_column ? N : 1, 0.0001f, 0.001f);
+  std::vector<T> output(M * N);
+  constexpr T zero_point = 3;
+
+  MlasRequantizeOutput(input.data(), N, output.data(), N, bias.data(), scale.data(), per_column, zero_point,
+                       0, 0, M, N);
+  for (auto _ : state) {
+    MlasRequantizeOutput(input.data(), N, output.data(), N, bias.data(), scale.data(), per_column, zero_point,
+                         0, 0, M, N);
+  }
+
+  SetRooflineCounters(state, 0, static_cast<double>(M * N) * (sizeof(int32_t) + sizeof(T)));
+}
+
+static void RequantizeSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(requantize_arg_names);
+  b->ArgsProduct({{1, 128, 1024}, {768, 3072}, {0, 1}});
+}
+
+BENCHMARK_TEMPLATE(REQUANTIZE, uint8_t)->Apply(RequantizeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(REQUANTIZE, int8_t)->Apply(RequantizeSizes)->UseRealTime();
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+static const std::vector<std::string> sbgemm_arg_names = {"M", "N", "K"};
+
+// A and B are single precision and converted to bfloat16 by the kernel, B ahead of time when it is packed.
+void SBGEMM(benchmark::State& state, bool pack_b) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  const size_t packed_b_size = MlasSBGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    state.SkipWithError("Bfloat16 GEMM is not supported on this platform");
+    return;
+  }
+
+  const auto A = RandomVectorUniform(M * K, -1.0f, 1.0f);
+  const auto B = RandomVectorUniform(K * N, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+  std::vector<uint8_t> B_packed;
+
+  MLAS_SBGEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.lda = K;
+  params.AIsfp32 = true;
+  params.C = C.data();
+  params.ldc = N;
+  if (pack_b) {
+    B_packed.resize(packed_b_size);
+    MlasSBGemmConvertPackB(N, K, B.data(), N, B_packed.data());
+    params.B = B_packed.data();
+    params.ldb = 0;
+    params.BIsfp32 = false;
+  } else {
+    params.B = B.data();
+    params.ldb = N;
+    params.BIsfp32 = true;
+  }
+
+  MlasSBGemmBatch(M, N, K, 1, &params, nullptr);
+  for (auto _ : state) {
+    MlasSBGemmBatch(M, N, K, 1, &params, nullptr);
+  }
+
+  SetRooflineCounters(state, 2.0 * M * N * K, static_cast<double>(M * K + K * N + M * N) * sizeof(float));
+}
+
+static void SBGemmSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_arg_names);
+  b->ArgsProduct({{1, 63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(SBGEMM, NoPackB, false)->Apply(SBGemmSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, PackB, true)->Apply(SBGemmSizes)->UseRealTime();
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
@@ -99,6 +99,9 @@ void SGEMM(benchmark::State& state, bool pack_b, bool trans_a, bool trans_b, flo
           tp.get());
     }
   }
+
+  SetRooflineCounters(state, 2.0 * M * N * K, static_cast<double>(M * K + K * N + M * N) * sizeof(float),
+                      static_cast<size_t>(tpo.thread_pool_size));
 }
 
 static void GemmSizeWithOne(benchmark::internal::Benchmark* b) {
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> softmax_arg_names = {"N", "D"};
+
+void SOFTMAX(benchmark::State& state, bool log_softmax) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("D must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+
+  auto input = RandomVectorUniform(N * D, -10.0f, 10.0f);
+  std::vector<float> output(N * D);
+
+  MlasComputeSoftmax(input.data(), output.data(), N, D, log_softmax, nullptr);
+  for (auto _ : state) {
+    MlasComputeSoftmax(input.data(), output.data(), N, D, log_softmax, nullptr);
+  }
+
+  SetRooflineCounters(state, 0, 2.0 * N * D * sizeof(float));
+}
+
+static void SoftmaxSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(softmax_arg_names);
+  b->ArgsProduct({{1, 64, 1024}, {16, 128, 1024, 4096}});
+}
+
+BENCHMARK_CAPTURE(SOFTMAX, Softmax, false)->Apply(SoftmaxSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SOFTMAX, LogSoftmax, true)->Apply(SoftmaxSizes)->UseRealTime();
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> transpose_arg_names = {"M", "N"};
+
+template <typename T>
+void TRANSPOSE(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  auto input = RandomVectorUniform<T>(M * N);
+  std::vector<T> output(M * N);
+
+  MlasTranspose(input.data(), output.data(), M, N);
+  for (auto _ : state) {
+    MlasTranspose(input.data(), output.data(), M, N);
+  }
+
+  SetRooflineCounters(state, 0, 2.0 * M * N * sizeof(T));
+}
+
+static void TransposeSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(transpose_arg_names);
+  b->ArgsProduct({{64, 256, 1024, 4096}, {64, 256, 1024, 4096}});
+}
+
+BENCHMARK_TEMPLATE(TRANSPOSE, float)->Apply(TransposeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSPOSE, uint8_t)->Apply(TransposeSizes)->UseRealTime();
+
+// The transpose of the heads and the sequence of an attention input: [1, S, H, D] -> [1, H, S, D]
+void TRANSPOSE_HEADS(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("S must greater than 0!");
+  const size_t shape[] = {1, static_cast<size_t>(state.range(0)), 12, 64};
+  const size_t permutation[] = {0, 2, 1, 3};
+  const size_t size = shape[0] * shape[1] * shape[2] * shape[3];
+
+  auto input = RandomVectorUniform<uint32_t>(size);
+  std::vector<uint32_t> output(size);
+
+  MlasTranspose(input.data(), output.data(), shape, permutation, 4, nullptr);
+  for (auto _ : state) {
+    MlasTranspose(input.data(), output.data(), shape, permutation, 4, nullptr);
+  }
+
+  SetRooflineCounters(state, 0, 2.0 * size * sizeof(uint32_t));
+}
+
+BENCHMARK(TRANSPOSE_HEADS)->ArgName("S")->Arg(128)->Arg(512)->Arg(2048)->UseRealTime();
@@ -2,6 +2,15 @@
 // Licensed under the MIT License.
 
 #include "bench_util.h"
+#include "mlas.h"
+#include "core/util/thread_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
 
@@ -49,3 +58,90 @@ void ArgsProductWithFilter(benchmark::internal::Benchmark* bench,
     } while (indices[arg++] == 0 && arg < arglists.size());
   }
 }
+
+namespace {
+
+struct MachinePeak {
+  double flops_per_second;
+  double bytes_per_second;
+};
+
+// Returns the shortest time of a few runs of `fn` after a warm up run.
+template <typename Fn>
+double BestSeconds(Fn&& fn) {
+  fn();
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 5; run++) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+MachinePeak MeasureMachinePeak(size_t threads) {
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp;
+  if (threads > 1) {
+    OrtThreadPoolParams tpo;
+    tpo.thread_pool_size = static_cast<int>(threads);
+    tpo.auto_set_affinity = true;
+    tp = onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                    tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP);
+  }
+
+  constexpr size_t gemm_size = 1024;
+  const auto A = RandomVectorUniform(gemm_size * gemm_size, -1.0f, 1.0f);
+  const auto B = RandomVectorUniform(gemm_size * gemm_size, -1.0f, 1.0f);
+  std::vector<float> C(gemm_size * gemm_size);
+  std::vector<float> B_packed((MlasGemmPackBSize(gemm_size, gemm_size) + sizeof(float) - 1) / sizeof(float));
+  MlasGemmPackB(CblasNoTrans, gemm_size, gemm_size, B.data(), gemm_size, B_packed.data());
+  const double gemm_seconds = BestSeconds([&]() {
+    MlasGemm(CblasNoTrans, gemm_size, gemm_size, gemm_size, 1.0f, A.data(), gemm_size, B_packed.data(), 0.0f,
+             C.data(), gemm_size, tp.get());
+  });
+
+  constexpr size_t copy_size = size_t{32} << 20;
+  const std::vector<float> source(copy_size, 1.0f);
+  std::vector<float> destination(copy_size);
+  const std::ptrdiff_t block_count = static_cast<std::ptrdiff_t>(threads * 4);
+  const double copy_seconds = BestSeconds([&]() {
+    onnxruntime::concurrency::ThreadPool::TrySimpleParallelFor(tp.get(), block_count, [&](std::ptrdiff_t block) {
+      const size_t begin = copy_size * block / block_count;
+      const size_t end = copy_size * (block + 1) / block_count;
+      std::copy(source.begin() + begin, source.begin() + end, destination.begin() + begin);
+    });
+  });
+
+  MachinePeak peak;
+  peak.flops_per_second = 2.0 * gemm_size * gemm_size * gemm_size / gemm_seconds;
+  peak.bytes_per_second = 2.0 * copy_size * sizeof(float) / copy_seconds;
+  std::cerr << "Machine peak with " << threads << " thread(s): " << peak.flops_per_second / 1e9 << " GFLOPS, "
+            << peak.bytes_per_second / 1e9 << " GBps" << std::endl;
+  return peak;
+}
+
+const MachinePeak& GetMachinePeak(size_t threads) {
+  static std::map<size_t, MachinePeak> peaks;
+  auto it = peaks.find(threads);
+  if (it == peaks.end()) {
+    it = peaks.emplace(threads, MeasureMachinePeak(threads)).first;
+  }
+  return it->second;
+}
+
+}  // namespace
+
+void SetRooflineCounters(benchmark::State& state, double flops, double bytes, size_t threads) {
+  const MachinePeak& peak = GetMachinePeak(std::max<size_t>(threads, 1));
+  if (flops > 0) {
+    state.counters["GFLOPS"] = benchmark::Counter(flops / 1e9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["PeakFLOPS%"] =
+        benchmark::Counter(flops * 100.0 / peak.flops_per_second, benchmark::Counter::kIsIterationInvariantRate);
+  }
+  if (bytes > 0) {
+    state.counters["GBps"] = benchmark::Counter(bytes / 1e9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["PeakBW%"] =
+        benchmark::Counter(bytes * 100.0 / peak.bytes_per_second, benchmark::Counter::kIsIterationInvariantRate);
+  }
+}
@@ -35,3 +35,11 @@ std::vector<ElementType> RandomVectorUniform(
 std::vector<float> RandomVectorUniform(std::vector<int64_t> shape, float min_value, float max_value);
 
 std::vector<int64_t> BenchArgsVector(benchmark::State& state, size_t& start, size_t count);
+
+// Adds the roofline counters of a kernel that performs `flops` operations and moves `bytes` bytes per iteration.
+// `bytes` is the compulsory traffic, i.e. every input read and every output written once.
+// GFLOPS and GBps are the achieved rates, PeakFLOPS% and PeakBW% their percentage of the peak that the machine reaches
+// with `threads` threads: an SGEMM of 1024x1024x1024 and a copy of buffers larger than the last level cache, measured
+// once per thread count. Reduced precision and integer kernels are compared to the single precision peak, so they may
+// exceed 100%. Counters of a zero amount are omitted.
+void SetRooflineCounters(benchmark::State& state, double flops, double bytes, size_t threads = 1);
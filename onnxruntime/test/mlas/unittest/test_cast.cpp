@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+#include "mlas_float16.h"
+
+#include <cstring>
+
+class MlasCastTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferFloat;
+  MatrixGuardBuffer<float> BufferFloatOutput;
+  MatrixGuardBuffer<unsigned short> BufferShort;
+
+  static uint16_t ReferenceFloatToBFloat16(float Value) {
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    if (std::isnan(Value)) {
+      return uint16_t(((Bits >> 16) & 0x8000) | 0x7FC0);
+    }
+    Bits += 0x7FFF + ((Bits >> 16) & 1);
+    return uint16_t(Bits >> 16);
+  }
+
+  void Test(size_t N) {
+    float* Input = BufferFloat.GetBuffer(N);
+    float* Output = BufferFloatOutput.GetBuffer(N);
+    unsigned short* Converted = BufferShort.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-70000.0f, 70000.0f);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = distribution(generator);
+    }
+    if (N > 3) {
+      Input[0] = std::numeric_limits<float>::infinity();
+      Input[1] = 1e-6f;
+      Input[2] = -0.0f;
+    }
+
+    MlasConvertFloatToHalfBuffer(Input, Converted, N);
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Converted[n], MLAS_Float2Half(Input[n])) << "FloatToHalf N:" << N << " @" << n;
+    }
+
+    MlasConvertHalfToFloatBuffer(Converted, Output, N);
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Output[n], MLAS_Half2Float(Converted[n])) << "HalfToFloat N:" << N << " @" << n;
+    }
+
+    MlasConvertFloatToBFloat16Buffer(Input, Converted, N);
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Converted[n], ReferenceFloatToBFloat16(Input[n])) << "FloatToBFloat16 N:" << N << " @" << n;
+    }
+
+    MlasConvertBFloat16ToFloatBuffer(Converted, Output, N);
+    for (size_t n = 0; n < N; n++) {
+      uint32_t Bits = uint32_t(Converted[n]) << 16;
+      float Expected;
+      std::memcpy(&Expected, &Bits, sizeof(Expected));
+      ASSERT_EQ(Output[n], Expected) << "BFloat16ToFloat N:" << N << " @" << n;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Cast");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n : {1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 100, 1027}) {
+      Test(n);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasCastTest>::RegisterShortExecute() : 0;
+});
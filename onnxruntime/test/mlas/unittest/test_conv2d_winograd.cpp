@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Verify the Winograd F(4x4, 3x3) convolution against a direct convolution
+// computed in double precision. Winograd rounds differently than the
+// im2col path, so the results are compared with a tolerance relative to the
+// magnitude of the products.
+//
+
+class MlasConv2DWinogradTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferWorking;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void Fill(float* Buffer, size_t Elements, size_t Seed) {
+    for (size_t i = 0; i < Elements; i++) {
+      Buffer[i] = float(int((i * 7919 + Seed * 104729) % 257) - 128) / 128.0f;
+    }
+  }
+
+  void Test(size_t BatchCount, size_t GroupCount, size_t InputChannels, size_t InputHeight, size_t InputWidth,
+            size_t FilterCount, size_t PaddingTop, size_t PaddingLeft, size_t PaddingBottom, size_t PaddingRight,
+            bool HasBias, float Beta, MLAS_ACTIVATION_KIND ActivationKind) {
+    const size_t OutputHeight = InputHeight + PaddingTop + PaddingBottom - 2;
+    const size_t OutputWidth = InputWidth + PaddingLeft + PaddingRight - 2;
+    const size_t InputSize = InputHeight * InputWidth;
+    const size_t OutputSize = OutputHeight * OutputWidth;
+
+    const size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
+    const size_t FilterElements = GroupCount * FilterCount * InputChannels * 9;
+    const size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+
+    float* Input = BufferInput.GetBuffer(InputElements);
+    float* Filter = BufferFilter.GetBuffer(FilterElements);
+    float* Bias = HasBias ? BufferBias.GetBuffer(GroupCount * FilterCount) : nullptr;
+    float* Output = BufferOutput.GetBuffer(OutputElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+    Fill(Input, InputElements, 1);
+    Fill(Filter, FilterElements, 2);
+    if (Bias != nullptr) {
+      Fill(Bias, GroupCount * FilterCount, 3);
+    }
+    Fill(Output, OutputElements, 4);
+    std::copy_n(Output, OutputElements, OutputReference);
+
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {3, 3};
+    int64_t DilationShape[] = {1, 1};
+    int64_t Padding[] = {int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight)};
+    int64_t StrideShape[] = {1, 1};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = ActivationKind;
+    Activation.Parameters.Clip.minimum = -1.0f;
+    Activation.Parameters.Clip.maximum = 1.0f;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels, InputShape, KernelShape,
+                    DilationShape, Padding, StrideShape, OutputShape, FilterCount, &Activation,
+                    &WorkingBufferSize, Beta, threadpool_);
+
+    ASSERT_TRUE(MlasConvWinogradPrepare(&Parameters, &WorkingBufferSize, threadpool_));
+    ASSERT_EQ(Parameters.Algorithm, MlasConvAlgorithmWinograd);
+
+    MlasConv(&Parameters, Input, Filter, Bias, BufferWorking.GetBuffer(WorkingBufferSize), Output, threadpool_);
+
+    for (size_t b = 0; b < BatchCount; b++) {
+      for (size_t g = 0; g < GroupCount; g++) {
+        const float* input = Input + (b * GroupCount + g) * InputChannels * InputSize;
+        for (size_t f = 0; f < FilterCount; f++) {
+          const size_t FilterIndex = g * FilterCount + f;
+          const float* filter = Filter + FilterIndex * InputChannels * 9;
+          const float* prior = OutputReference + (b * GroupCount + g) * FilterCount * OutputSize + f * OutputSize;
+          const float* output = Output + (prior - OutputReference);
+
+          for (size_t oh = 0; oh < OutputHeight; oh++) {
+            for (size_t ow = 0; ow < OutputWidth; ow++) {
+              double Sum = 0.0;
+              double Magnitude = 1.0;
+              for (size_t c = 0; c < InputChannels; c++) {
+                for (size_t kh = 0; kh < 3; kh++) {
+                  const size_t ih = oh + kh - PaddingTop;
+                  for (size_t kw = 0; kw < 3; kw++) {
+                    const size_t iw = ow + kw - PaddingLeft;
+                    if (ih < InputHeight && iw < InputWidth) {
+                      const double Product = double(input[c * InputSize + ih * InputWidth + iw]) *
+                                             double(filter[c * 9 + kh * 3 + kw]);
+                      Sum += Product;
+                      Magnitude += std::fabs(Product);
+                    }
+                  }
+                }
+              }
+              float Value = float(Sum + (Bias != nullptr ? Bias[FilterIndex] : 0.0f) +
+                                  Beta * prior[oh * OutputWidth + ow]);
+              if (ActivationKind == MlasReluActivation) {
+                Value = std::max(Value, 0.0f);
+              } else if (ActivationKind == MlasClipActivation) {
+                Value = std::min(std::max(Value, -1.0f), 1.0f);
+              }
+
+              ASSERT_NEAR(output[oh * OutputWidth + ow], Value, 1e-5 * Magnitude)
+                  << "@[" << b << "," << FilterIndex << "," << oh << "," << ow << "], Batch=" << BatchCount
+                  << ", Group=" << GroupCount << ", C=" << InputChannels << ", H=" << InputHeight
+                  << ", W=" << InputWidth << ", M=" << FilterCount << ", Padding=" << PaddingTop << ","
+                  << PaddingLeft << "," << PaddingBottom << "," << PaddingRight << ", Beta=" << Beta;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void TestNotSelected(size_t InputChannels, size_t FilterCount, size_t InputSize, size_t Kernel, size_t Stride,
+                       size_t Dilation) {
+    const size_t OutputSize = (InputSize - Dilation * (Kernel - 1) - 1) / Stride + 1;
+
+    int64_t InputShape[] = {int64_t(InputSize), int64_t(InputSize)};
+    int64_t KernelShape[] = {int64_t(Kernel), int64_t(Kernel)};
+    int64_t DilationShape[] = {int64_t(Dilation), int64_t(Dilation)};
+    int64_t Padding[] = {0, 0, 0, 0};
+    int64_t StrideShape[] = {int64_t(Stride), int64_t(Stride)};
+    int64_t OutputShape[] = {int64_t(OutputSize), int64_t(OutputSize)};
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, 1, 1, InputChannels, InputShape, KernelShape, DilationShape, Padding,
+                    StrideShape, OutputShape, FilterCount, &Activation, &WorkingBufferSize, 0.0f, threadpool_);
+
+    const MLAS_CONV_ALGORITHM Algorithm = Parameters.Algorithm;
+    const size_t PreparedWorkingBufferSize = WorkingBufferSize;
+
+    ASSERT_FALSE(MlasConvWinogradPrepare(&Parameters, &WorkingBufferSize, threadpool_));
+    ASSERT_EQ(Parameters.Algorithm, Algorithm);
+    ASSERT_EQ(WorkingBufferSize, PreparedWorkingBufferSize);
+  }
+
+ public:
+  MlasConv2DWinogradTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Conv2dWinograd");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    Test(1, 1, 16, 10, 10, 16, 0, 0, 0, 0, false, 0.0f, MlasIdentityActivation);
+    Test(1, 1, 16, 10, 10, 16, 1, 1, 1, 1, true, 0.0f, MlasIdentityActivation);
+    Test(2, 1, 32, 17, 13, 24, 1, 1, 1, 1, true, 0.0f, MlasReluActivation);
+    Test(1, 2, 16, 9, 23, 17, 2, 0, 1, 2, true, 1.0f, MlasClipActivation);
+    Test(3, 1, 19, 28, 28, 33, 1, 1, 1, 1, false, 1.0f, MlasReluActivation);
+    Test(1, 1, 64, 56, 56, 64, 1, 1, 1, 1, true, 0.0f, MlasIdentityActivation);
+
+    TestNotSelected(16, 16, 16, 3, 2, 1);
+    TestNotSelected(16, 16, 16, 3, 1, 2);
+    TestNotSelected(16, 16, 16, 5, 1, 1);
+    TestNotSelected(8, 16, 16, 3, 1, 1);
+    TestNotSelected(16, 16, 6, 3, 1, 1);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasConv2DWinogradTest>::RegisterShortExecute() : 0;
+});
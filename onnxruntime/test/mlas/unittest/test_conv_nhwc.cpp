@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Verify the channels last direct convolution against a reference computed in
+// double precision on the same layout.
+//
+
+class MlasConvNhwcTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void Fill(float* Buffer, size_t Elements, size_t Seed) {
+    for (size_t i = 0; i < Elements; i++) {
+      Buffer[i] = float(int((i * 7919 + Seed * 104729) % 257) - 128) / 128.0f;
+    }
+  }
+
+  //
+  // The shapes are given as depth, height and width, a depth of zero selects
+  // a 2D convolution and a height of zero in addition a 1D convolution.
+  //
+
+  void Test(size_t BatchCount, size_t GroupCount, size_t InputChannels, size_t FilterCount,
+            const size_t (&InputShape)[3], const size_t (&KernelShape)[3], const size_t (&Stride)[3],
+            const size_t (&Dilation)[3], const size_t (&PaddingBegin)[3], const size_t (&PaddingEnd)[3],
+            bool HasBias, float Beta, MLAS_ACTIVATION_KIND ActivationKind) {
+    const size_t Dimensions = InputShape[0] != 0 ? 3 : (InputShape[1] != 0 ? 2 : 1);
+    const size_t First = 3 - Dimensions;
+
+    size_t Input3D[3] = {1, 1, 1};
+    size_t Kernel3D[3] = {1, 1, 1};
+    size_t Output3D[3] = {1, 1, 1};
+    int64_t InputShape64[3];
+    int64_t KernelShape64[3];
+    int64_t StrideShape64[3];
+    int64_t DilationShape64[3];
+    int64_t Padding64[6];
+    int64_t OutputShape64[3];
+
+    for (size_t dim = First; dim < 3; dim++) {
+      const size_t d = dim - First;
+      Input3D[dim] = InputShape[dim];
+      Kernel3D[dim] = KernelShape[dim];
+      Output3D[dim] = (InputShape[dim] + PaddingBegin[dim] + PaddingEnd[dim] - Dilation[dim] * (KernelShape[dim] - 1) - 1) /
+                          Stride[dim] + 1;
+      InputShape64[d] = int64_t(InputShape[dim]);
+      KernelShape64[d] = int64_t(KernelShape[dim]);
+      StrideShape64[d] = int64_t(Stride[dim]);
+      DilationShape64[d] = int64_t(Dilation[dim]);
+      Padding64[d] = int64_t(PaddingBegin[dim]);
+      Padding64[d + Dimensions] = int64_t(PaddingEnd[dim]);
+      OutputShape64[d] = int64_t(Output3D[dim]);
+    }
+
+    const size_t TotalInputChannels = GroupCount * InputChannels;
+    const size_t TotalFilterCount = GroupCount * FilterCount;
+    const size_t KernelSize = Kernel3D[0] * Kernel3D[1] * Kernel3D[2];
+    const size_t InputElements = BatchCount * Input3D[0] * Input3D[1] * Input3D[2] * TotalInputChannels;
+    const size_t FilterElements = KernelSize * InputChannels * TotalFilterCount;
+    const size_t OutputElements = BatchCount * Output3D[0] * Output3D[1] * Output3D[2] * TotalFilterCount;
+
+    float* Input = BufferInput.GetBuffer(InputElements);
+    float* Filter = BufferFilter.GetBuffer(FilterElements);
+    float* Bias = HasBias ? BufferBias.GetBuffer(TotalFilterCount) : nullptr;
+    float* Output = BufferOutput.GetBuffer(OutputElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+    Fill(Input, InputElements, 1);
+    Fill(Filter, FilterElements, 2);
+    if (Bias != nullptr) {
+      Fill(Bias, TotalFilterCount, 3);
+    }
+    Fill(Output, OutputElements, 4);
+    std::copy_n(Output, OutputElements, OutputReference);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = ActivationKind;
+    Activation.Parameters.LeakyRelu.alpha = 0.25f;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, Dimensions, BatchCount, GroupCount, InputChannels, InputShape64, KernelShape64,
+                    DilationShape64, Padding64, StrideShape64, OutputShape64, FilterCount, &Activation,
+                    &WorkingBufferSize, Beta, threadpool_);
+
+    MlasConvNhwc(&Parameters, Input, Filter, Bias, Output, threadpool_);
+
+    size_t index = 0;
+    for (size_t b = 0; b < BatchCount; b++) {
+      for (size_t od = 0; od < Output3D[0]; od++) {
+        for (size_t oh = 0; oh < Output3D[1]; oh++) {
+          for (size_t ow = 0; ow < Output3D[2]; ow++) {
+            for (size_t m = 0; m < TotalFilterCount; m++, index++) {
+              const size_t g = m / FilterCount;
+              double Sum = 0.0;
+              double Magnitude = 1.0;
+              for (size_t kd = 0; kd < Kernel3D[0]; kd++) {
+                const size_t id = od * Stride[0] + kd * Dilation[0] - PaddingBegin[0];
+                for (size_t kh = 0; kh < Kernel3D[1]; kh++) {
+                  const size_t ih = oh * Stride[1] + kh * Dilation[1] - PaddingBegin[1];
+                  for (size_t kw = 0; kw < Kernel3D[2]; kw++) {
+                    const size_t iw = ow * Stride[2] + kw * Dilation[2] - PaddingBegin[2];
+                    if (id >= Input3D[0] || ih >= Input3D[1] || iw >= Input3D[2]) {
+                      continue;
+                    }
+                    const float* input =
+                        Input + (((b * Input3D[0] + id) * Input3D[1] + ih) * Input3D[2] + iw) * TotalInputChannels +
+                        g * InputChannels;
+                    const float* filter =
+                        Filter + ((kd * Kernel3D[1] + kh) * Kernel3D[2] + kw) * InputChannels * TotalFilterCount + m;
+                    for (size_t c = 0; c < InputChannels; c++) {
+                      const double Product = double(input[c]) * double(filter[c * TotalFilterCount]);
+                      Sum += Product;
+                      Magnitude += std::fabs(Product);
+                    }
+                  }
+                }
+              }
+              float Value = float(Sum + (Bias != nullptr ? Bias[m] : 0.0f) + Beta * OutputReference[index]);
+              if (ActivationKind == MlasReluActivation) {
+                Value = std::max(Value, 0.0f);
+              } else if (ActivationKind == MlasLeakyReluActivation) {
+                Value = Value >= 0.0f ? Value : Value * 0.25f;
+              }
+
+              ASSERT_NEAR(Output[index], Value, 1e-6 * Magnitude)
+                  << "@[" << b << "," << od << "," << oh << "," << ow << "," << m << "], Dimensions=" << Dimensions
+                  << ", Batch=" << BatchCount << ", Group=" << GroupCount << ", C=" << InputChannels
+                  << ", M=" << FilterCount << ", Beta=" << Beta;
+            }
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  MlasConvNhwcTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("ConvNhwc");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    // 1D.
+    Test(2, 1, 5, 7, {0, 0, 19}, {0, 0, 3}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}, true, 0.0f,
+         MlasIdentityActivation);
+    Test(1, 2, 4, 3, {0, 0, 23}, {0, 0, 5}, {0, 0, 2}, {0, 0, 2}, {0, 0, 3}, {0, 0, 0}, false, 1.0f,
+         MlasReluActivation);
+
+    // 2D.
+    Test(1, 1, 3, 16, {0, 11, 13}, {0, 3, 3}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, true, 0.0f,
+         MlasReluActivation);
+    Test(2, 1, 16, 24, {0, 14, 14}, {0, 3, 3}, {0, 2, 2}, {0, 1, 1}, {0, 1, 0}, {0, 1, 0}, true, 0.0f,
+         MlasLeakyReluActivation);
+    Test(1, 1, 8, 8, {0, 9, 9}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, {0, 0, 0}, {0, 0, 0}, false, 0.0f,
+         MlasIdentityActivation);
+    Test(1, 1, 32, 16, {0, 8, 10}, {0, 5, 5}, {0, 1, 1}, {0, 1, 1}, {0, 2, 2}, {0, 2, 2}, true, 1.0f,
+         MlasIdentityActivation);
+    Test(1, 1, 4, 6, {0, 12, 12}, {0, 3, 3}, {0, 1, 1}, {0, 2, 3}, {0, 2, 3}, {0, 2, 3}, false, 0.0f,
+         MlasIdentityActivation);
+    Test(1, 4, 6, 5, {0, 10, 7}, {0, 3, 3}, {0, 1, 2}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, true, 0.0f,
+         MlasReluActivation);
+    Test(1, 3, 2, 4, {0, 3, 3}, {0, 5, 5}, {0, 1, 1}, {0, 1, 1}, {0, 2, 2}, {0, 2, 2}, true, 0.0f,
+         MlasIdentityActivation);
+
+    // Depthwise.
+    Test(2, 32, 1, 1, {0, 15, 15}, {0, 3, 3}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, true, 0.0f,
+         MlasReluActivation);
+    Test(1, 19, 1, 1, {0, 16, 16}, {0, 3, 3}, {0, 2, 2}, {0, 1, 1}, {0, 1, 1}, {0, 0, 0}, false, 1.0f,
+         MlasIdentityActivation);
+    Test(1, 8, 1, 2, {0, 9, 9}, {0, 3, 3}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, {0, 1, 1}, true, 0.0f,
+         MlasIdentityActivation);
+
+    // 3D.
+    Test(1, 1, 4, 8, {5, 6, 7}, {3, 3, 3}, {1, 1, 1}, {1, 1, 1}, {1, 1, 1}, {1, 1, 1}, true, 0.0f,
+         MlasReluActivation);
+    Test(2, 2, 3, 2, {6, 5, 9}, {2, 3, 3}, {2, 1, 2}, {1, 2, 1}, {0, 2, 1}, {1, 1, 1}, false, 1.0f,
+         MlasIdentityActivation);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasConvNhwcTest>::RegisterShortExecute() : 0;
+});
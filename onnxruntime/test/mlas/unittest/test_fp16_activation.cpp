@@ -149,6 +149,9 @@ class MlasFp16ActivationTest : public MlasTestBase {
 };
 
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  if (!MlasFp16AccelerationSupported()) {
+    return size_t(0);
+  }
   return is_short_execute ? MlasDirectShortExecuteTests<MlasFp16ActivationTest>::RegisterShortExecute() : 0;
 });
 
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <typename IndexType>
+class MlasGatherTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint32_t> BufferInput;
+  MatrixGuardBuffer<IndexType> BufferIndices;
+  MatrixGuardBuffer<uint32_t> BufferOutput;
+
+  void Test(size_t N, size_t AxisSize, size_t IndexStride, size_t ElementStride) {
+    const size_t InputSize = (AxisSize - 1) * IndexStride + (N - 1) * ElementStride + 1;
+    uint32_t* Input = BufferInput.GetBuffer(InputSize);
+    IndexType* Indices = BufferIndices.GetBuffer(N);
+    uint32_t* Output = BufferOutput.GetBuffer(N);
+
+    for (size_t i = 0; i < InputSize; i++) {
+      Input[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+
+    // Mix positive and negative indices.
+    for (size_t i = 0; i < N; i++) {
+      const int64_t Index = static_cast<int64_t>((i * 7919) % AxisSize);
+      Indices[i] = static_cast<IndexType>((i % 3) == 0 ? Index - static_cast<int64_t>(AxisSize) : Index);
+    }
+
+    ASSERT_TRUE(MlasGather(Input, Indices, Output, N, static_cast<int64_t>(AxisSize), IndexStride, ElementStride));
+
+    for (size_t i = 0; i < N; i++) {
+      const size_t Index = static_cast<size_t>((i * 7919) % AxisSize);
+      ASSERT_EQ(Output[i], Input[Index * IndexStride + i * ElementStride])
+          << "@" << i << ", N=" << N << ", AxisSize=" << AxisSize
+          << ", IndexStride=" << IndexStride << ", ElementStride=" << ElementStride;
+    }
+
+    // An index out of range on either side is reported wherever it is.
+    for (size_t Position : {size_t(0), N / 2, N - 1}) {
+      const IndexType Saved = Indices[Position];
+      Indices[Position] = static_cast<IndexType>(AxisSize);
+      ASSERT_FALSE(MlasGather(Input, Indices, Output, N, static_cast<int64_t>(AxisSize), IndexStride, ElementStride));
+      Indices[Position] = static_cast<IndexType>(-static_cast<int64_t>(AxisSize) - 1);
+      ASSERT_FALSE(MlasGather(Input, Indices, Output, N, static_cast<int64_t>(AxisSize), IndexStride, ElementStride));
+      Indices[Position] = Saved;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("Gather_Index") + std::to_string(sizeof(IndexType) * 8));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t N : {1, 3, 8, 15, 16, 33, 100, 1000}) {
+      for (size_t AxisSize : {1, 5, 64, 1021}) {
+        Test(N, AxisSize, 1, 0);
+        Test(N, AxisSize, 17, 1);
+        Test(N, AxisSize, 3, 5);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasGatherTest<int32_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasGatherTest<int64_t>>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferGamma;
+  MatrixGuardBuffer<float> BufferBeta;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferSum;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferSumReference;
+
+  void Test(size_t N, bool WithSkip, bool WithBeta, bool Simplified) {
+    float* Input = BufferInput.GetBuffer(N);
+    float* Skip = WithSkip ? BufferSkip.GetBuffer(N) : nullptr;
+    float* Bias = WithSkip ? BufferBias.GetBuffer(N) : nullptr;
+    float* Gamma = BufferGamma.GetBuffer(N);
+    float* Beta = WithBeta ? BufferBeta.GetBuffer(N) : nullptr;
+    float* Output = BufferOutput.GetBuffer(N);
+    float* Sum = WithSkip ? BufferSum.GetBuffer(N) : nullptr;
+    float* OutputReference = BufferOutputReference.GetBuffer(N);
+    float* SumReference = BufferSumReference.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-5.0f, 5.0f);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = distribution(generator);
+      Gamma[n] = distribution(generator);
+      if (WithSkip) {
+        Skip[n] = distribution(generator);
+        Bias[n] = distribution(generator);
+      }
+      if (WithBeta) {
+        Beta[n] = distribution(generator);
+      }
+    }
+
+    constexpr float Epsilon = 1e-5f;
+    float Mean = 0.0f;
+    float InvStdDev = 0.0f;
+
+    MlasLayerNormalization(Input, Skip, Bias, Gamma, Beta, Output, Sum, N, Epsilon, Simplified, &Mean, &InvStdDev);
+
+    // Reference computed in double precision.
+    double ReferenceMean = 0.0;
+    for (size_t n = 0; n < N; n++) {
+      SumReference[n] = Input[n] + (WithSkip ? Skip[n] + Bias[n] : 0.0f);
+      ReferenceMean += SumReference[n];
+    }
+    ReferenceMean /= double(N);
+
+    double Variance = 0.0;
+    for (size_t n = 0; n < N; n++) {
+      double Value = Simplified ? double(SumReference[n]) : double(SumReference[n]) - ReferenceMean;
+      Variance += Value * Value;
+    }
+    const double ReferenceInvStdDev = 1.0 / std::sqrt(Variance / double(N) + Epsilon);
+
+    for (size_t n = 0; n < N; n++) {
+      double Value = Simplified ? double(SumReference[n]) : double(SumReference[n]) - ReferenceMean;
+      Value = Value * ReferenceInvStdDev * Gamma[n];
+      if (WithBeta && !Simplified) {
+        Value += Beta[n];
+      }
+      OutputReference[n] = float(Value);
+    }
+
+    constexpr float AbsoluteTolerance = 1e-4f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t n = 0; n < N; n++) {
+      float diff = std::fabs(Output[n] - OutputReference[n]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[n]) * RelativeTolerance)
+          << "Simplified:" << (int)Simplified << " N:" << N << " @" << n
+          << ", got: " << Output[n] << ", expecting: " << OutputReference[n];
+      if (WithSkip) {
+        ASSERT_EQ(Sum[n], SumReference[n]) << "N:" << N << " @" << n;
+      }
+    }
+
+    ASSERT_NEAR(InvStdDev, float(ReferenceInvStdDev), std::fabs(float(ReferenceInvStdDev)) * RelativeTolerance);
+    if (!Simplified) {
+      ASSERT_NEAR(Mean, float(ReferenceMean), AbsoluteTolerance);
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LayerNorm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n : {1, 3, 4, 7, 8, 15, 16, 33, 127, 768, 1027}) {
+      for (bool Simplified : {false, true}) {
+        Test(n, false, false, Simplified);
+        Test(n, false, true, Simplified);
+        Test(n, true, true, Simplified);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasLayerNormTest>::RegisterShortExecute() : 0;
+});
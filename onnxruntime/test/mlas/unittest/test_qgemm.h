@@ -182,10 +182,10 @@ class MlasQgemmTest<AType, BType, int32_t, Packed, Threaded> : public MlasQgemmT
     Test(M, N, K, BatchSize, A, K, offa, B, N, offb, C, CReference, N);
   }
 
-  void Test(size_t M, size_t N, size_t K, size_t BatchSize, uint8_t offa) {
+  void Test(size_t M, size_t N, size_t K, size_t BatchSize, uint8_t offa, bool ZeroPointBIsZero = false) {
     const uint8_t* A = BufferA.GetBuffer(K * M * BatchSize);
     const uint8_t* B = BufferB.GetBuffer(N * K * BatchSize);
-    const uint8_t* ZeroPointB = BufferZeroPointB.GetBuffer(N);
+    const uint8_t* ZeroPointB = BufferZeroPointB.GetBuffer(N, ZeroPointBIsZero);
     int32_t* C = BufferC.GetBuffer(N * M * BatchSize);
     int32_t* CReference = BufferCReference.GetBuffer(N * M * BatchSize);
 
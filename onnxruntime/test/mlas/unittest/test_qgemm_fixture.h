@@ -15,25 +15,29 @@ class QgemmShortExecuteTest;
 template <typename AType, typename BType, bool Packed, bool Threaded>
 class QgemmShortExecuteTest<AType, BType, int32_t, Packed, Threaded> : public MlasTestFixture<MlasQgemmTest<AType, BType, int32_t, Packed, Threaded>> {
  public:
-  explicit QgemmShortExecuteTest(bool use_offb, size_t M, size_t N, size_t K, size_t Batch, uint8_t offa, uint8_t offb)
-      : use_offb_(use_offb), M_(M), N_(N), K_(K), Batch_(Batch), offa_(offa), offb_(offb) {
+  explicit QgemmShortExecuteTest(bool use_offb, size_t M, size_t N, size_t K, size_t Batch, uint8_t offa, uint8_t offb,
+                                 bool zero_offb_per_column)
+      : use_offb_(use_offb), zero_offb_per_column_(zero_offb_per_column), M_(M), N_(N), K_(K), Batch_(Batch), offa_(offa), offb_(offb) {
   }
 
   void TestBody() override {
     if (use_offb_) {
       MlasTestFixture<MlasQgemmTest<AType, BType, int32_t, Packed, Threaded>>::mlas_tester->Test(M_, N_, K_, Batch_, offa_, offb_);
     } else {
-      MlasTestFixture<MlasQgemmTest<AType, BType, int32_t, Packed, Threaded>>::mlas_tester->Test(M_, N_, K_, Batch_, offa_);
+      MlasTestFixture<MlasQgemmTest<AType, BType, int32_t, Packed, Threaded>>::mlas_tester->Test(M_, N_, K_, Batch_, offa_, zero_offb_per_column_);
     }
   }
 
-  static size_t RegisterSingleTest(bool use_offb, size_t M, size_t N, size_t K, size_t Batch, uint8_t offa, uint8_t offb) {
+  static size_t RegisterSingleTest(bool use_offb, size_t M, size_t N, size_t K, size_t Batch, uint8_t offa, uint8_t offb,
+                                   bool zero_offb_per_column = false) {
     std::stringstream ss;
     ss << "Batch" << Batch << "/M" << M << "xN" << N << "xK" << K << "/"
        << "offa" << (unsigned)offa << "/"
        << "offb";
     if (use_offb) {
       ss << (unsigned)offb;
+    } else if (zero_offb_per_column) {
+      ss << "0s";
     } else {
       ss << "--";
     }
@@ -49,7 +53,7 @@ class QgemmShortExecuteTest<AType, BType, int32_t, Packed, Threaded> : public Ml
         // Important to use the fixture type as the return type here.
         [=]() -> MlasTestFixture<MlasQgemmTest<AType, BType, int32_t, Packed, Threaded>>* {
           return new QgemmShortExecuteTest<AType, BType, int32_t, Packed, Threaded>(
-              use_offb, M, N, K, Batch, offa, offb);
+              use_offb, M, N, K, Batch, offa, offb, zero_offb_per_column);
         });
 
     return 1;
@@ -94,6 +98,12 @@ class QgemmShortExecuteTest<AType, BType, int32_t, Packed, Threaded> : public Ml
         test_registered += RegisterSingleTest(1, 32, b, 5, 0, 0);
       }
     }
+    // per-column zero points of matrix B that are all zero, as with symmetric weights
+    for (size_t b = 1; b < 96; b += 15) {
+      test_registered += RegisterSingleTest(false, 1, b, b, 1, 0, 0, true);
+      test_registered += RegisterSingleTest(false, b, b, b, 1, 17, 0, true);
+    }
+    test_registered += RegisterSingleTest(false, 43, 500, 401, 1, 183, 0, true);
     test_registered += RegisterSingleTest(43, 500, 401, 1, 183, 223);
     test_registered += RegisterSingleTest(1023, 1023, 1023, 1, 5, 8);
     test_registered += RegisterSingleTest(1023, 1023, 1023, 1, 7);
@@ -117,6 +127,7 @@ class QgemmShortExecuteTest<AType, BType, int32_t, Packed, Threaded> : public Ml
 
  private:
   bool use_offb_;
+  bool zero_offb_per_column_;
   size_t M_, N_, K_, Batch_;
   uint8_t offa_, offb_;
 };
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <vector>
+
+template <typename AType, typename BType>
+class MlasGemmInt16x8Test : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<AType> BufferA;
+  MatrixGuardBuffer<BType> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferPackedB;
+  MatrixGuardBuffer<int32_t> BufferC;
+  MatrixGuardBuffer<int32_t> BufferCReference;
+
+  void Test(size_t M, size_t N, size_t K, int32_t ZeroPointA, bool PerColumnZeroPoints) {
+    AType* A = BufferA.GetBuffer(M * K);
+    BType* B = BufferB.GetBuffer(K * N);
+    int32_t* C = BufferC.GetBuffer(M * N);
+    int32_t* CReference = BufferCReference.GetBuffer(M * N);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K + ZeroPointA));
+    std::uniform_int_distribution<int32_t> a_distribution(std::numeric_limits<AType>::lowest(),
+                                                          std::numeric_limits<AType>::max());
+    std::uniform_int_distribution<int32_t> b_distribution(std::numeric_limits<BType>::lowest(),
+                                                          std::numeric_limits<BType>::max());
+
+    for (size_t i = 0; i < M * K; i++) {
+      A[i] = static_cast<AType>(a_distribution(generator));
+    }
+    for (size_t i = 0; i < K * N; i++) {
+      B[i] = static_cast<BType>(b_distribution(generator));
+    }
+    std::vector<BType> ZeroPointB(PerColumnZeroPoints ? N : 1);
+    for (auto& zp : ZeroPointB) {
+      zp = static_cast<BType>(b_distribution(generator));
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        const int32_t zb = ZeroPointB[PerColumnZeroPoints ? n : 0];
+        int64_t sum = 0;
+        for (size_t k = 0; k < K; k++) {
+          sum += (int64_t(A[m * K + k]) - ZeroPointA) * (int64_t(B[k * N + n]) - zb);
+        }
+        CReference[m * N + n] = static_cast<int32_t>(sum);
+      }
+    }
+
+    uint8_t* PackedB = BufferPackedB.GetBuffer(MlasGemmInt16x8PackBSize(N, K));
+    MlasGemmInt16x8PackB(N, K, reinterpret_cast<const uint8_t*>(B), N, std::is_signed<BType>::value, PackedB);
+
+    MLAS_GEMM_QUANT_SHAPE_PARAMS Shape;
+    Shape.M = M;
+    Shape.N = N;
+    Shape.K = K;
+    Shape.AIsSigned = std::is_signed<AType>::value;
+    Shape.BIsSigned = std::is_signed<BType>::value;
+
+    MLAS_GEMM_INT16X8_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = K;
+    Data.ZeroPointA = ZeroPointA;
+    Data.PackedB = PackedB;
+    Data.ZeroPointB = reinterpret_cast<const uint8_t*>(ZeroPointB.data());
+    Data.PerColumnZeroPoints = PerColumnZeroPoints;
+    Data.C = C;
+    Data.ldc = N;
+
+    MlasGemmInt16x8Batch(Shape, &Data, 1, GetMlasThreadPool());
+
+    for (size_t i = 0; i < M * N; i++) {
+      ASSERT_EQ(C[i], CReference[i]) << " @[" << i / N << "," << i % N << "], M=" << M << ", N=" << N
+                                     << ", K=" << K << ", ZeroPointA=" << ZeroPointA;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("GemmInt16x8_") +
+                                        (std::is_signed<AType>::value ? "S16" : "U16") +
+                                        (std::is_signed<BType>::value ? "S8" : "U8"));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    const int32_t ZeroPointA = std::is_signed<AType>::value ? -1234 : 32768 + 567;
+    for (size_t M : {1, 3, 4, 7}) {
+      for (size_t N : {1, 8, 15, 70}) {
+        for (size_t K : {1, 2, 17, 64}) {
+          Test(M, N, K, 0, false);
+          Test(M, N, K, ZeroPointA, false);
+          Test(M, N, K, ZeroPointA, true);
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  if (is_short_execute) {
+    return MlasDirectShortExecuteTests<MlasGemmInt16x8Test<int16_t, int8_t>>::RegisterShortExecute() +
+           MlasDirectShortExecuteTests<MlasGemmInt16x8Test<int16_t, uint8_t>>::RegisterShortExecute() +
+           MlasDirectShortExecuteTests<MlasGemmInt16x8Test<uint16_t, int8_t>>::RegisterShortExecute() +
+           MlasDirectShortExecuteTests<MlasGemmInt16x8Test<uint16_t, uint8_t>>::RegisterShortExecute();
+  }
+  return (size_t)0;
+});
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void ReferenceReduce(MLAS_REDUCE_KIND ReduceKind, const float* Input, float* Output,
+                              size_t OuterCount, size_t ReduceCount, size_t InnerCount) {
+    for (size_t o = 0; o < OuterCount; o++) {
+      for (size_t n = 0; n < InnerCount; n++) {
+        const float* s = Input + o * ReduceCount * InnerCount + n;
+        double Accumulator = 0.0;
+        double Maximum = -std::numeric_limits<double>::infinity();
+        double Minimum = std::numeric_limits<double>::infinity();
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+          const double Value = s[r * InnerCount];
+          Maximum = std::max(Maximum, Value);
+          Minimum = std::min(Minimum, Value);
+          Accumulator += (ReduceKind == MlasReduceSumSquare || ReduceKind == MlasReduceL2) ? Value * Value : Value;
+        }
+
+        double Result = 0.0;
+        switch (ReduceKind) {
+          case MlasReduceSum:
+          case MlasReduceSumSquare:
+            Result = Accumulator;
+            break;
+          case MlasReduceMean:
+            Result = Accumulator / double(ReduceCount);
+            break;
+          case MlasReduceMaximum:
+            Result = Maximum;
+            break;
+          case MlasReduceMinimum:
+            Result = Minimum;
+            break;
+          case MlasReduceL2:
+            Result = std::sqrt(Accumulator);
+            break;
+          case MlasReduceLogSumExp: {
+            double SumExp = 0.0;
+            for (size_t r = 0; r < ReduceCount; r++) {
+              SumExp += std::exp(double(s[r * InnerCount]) - Maximum);
+            }
+            Result = std::log(SumExp) + Maximum;
+            break;
+          }
+        }
+
+        Output[o * InnerCount + n] = float(Result);
+      }
+    }
+  }
+
+  void Test(MLAS_REDUCE_KIND ReduceKind, size_t OuterCount, size_t ReduceCount, size_t InnerCount) {
+    const size_t InputCount = OuterCount * ReduceCount * InnerCount;
+    const size_t OutputCount = OuterCount * InnerCount;
+
+    float* Input = BufferInput.GetBuffer(InputCount);
+    float* Output = BufferOutput.GetBuffer(OutputCount);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputCount);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputCount));
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+    for (size_t i = 0; i < InputCount; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    MlasReduce(ReduceKind, Input, Output, OuterCount, ReduceCount, InnerCount, threadpool_);
+    ReferenceReduce(ReduceKind, Input, OutputReference, OuterCount, ReduceCount, InnerCount);
+
+    for (size_t i = 0; i < OutputCount; i++) {
+      ASSERT_NEAR(Output[i], OutputReference[i], 1e-5f * std::max(1.0f, std::fabs(OutputReference[i])) * ReduceCount)
+          << "@" << i << " ReduceKind=" << ReduceKind << " [" << OuterCount << "," << ReduceCount << ","
+          << InnerCount << "]";
+    }
+  }
+
+  void TestInfinity(MLAS_REDUCE_KIND ReduceKind, size_t InnerCount, float Value, float Expected) {
+    constexpr size_t ReduceCount = 7;
+    float* Input = BufferInput.GetBuffer(ReduceCount * InnerCount);
+    float* Output = BufferOutput.GetBuffer(InnerCount);
+
+    for (size_t i = 0; i < ReduceCount * InnerCount; i++) {
+      Input[i] = Value;
+    }
+
+    MlasReduce(ReduceKind, Input, Output, 1, ReduceCount, InnerCount, threadpool_);
+
+    for (size_t i = 0; i < InnerCount; i++) {
+      ASSERT_EQ(Output[i], Expected) << "@" << i << " ReduceKind=" << ReduceKind << " InnerCount=" << InnerCount;
+    }
+  }
+
+ public:
+  MlasReduceTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Reduce");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const MLAS_REDUCE_KIND ReduceKinds[] = {
+        MlasReduceSum, MlasReduceMean, MlasReduceMaximum, MlasReduceMinimum,
+        MlasReduceSumSquare, MlasReduceL2, MlasReduceLogSumExp};
+
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 3, 1}, {5, 17, 1}, {3, 64, 1}, {2, 1000, 1}, {1, 1, 9},
+        {1, 3, 4}, {4, 5, 16}, {3, 7, 19}, {2, 33, 37}, {1, 129, 100}, {7, 600, 3}, {1, 2, 40000}};
+
+    for (const auto ReduceKind : ReduceKinds) {
+      for (const auto& Shape : Shapes) {
+        Test(ReduceKind, Shape[0], Shape[1], Shape[2]);
+      }
+    }
+
+    constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+    for (size_t InnerCount : {size_t(1), size_t(3), size_t(4), size_t(16)}) {
+      TestInfinity(MlasReduceMaximum, InnerCount, -Infinity, -Infinity);
+      TestInfinity(MlasReduceMinimum, InnerCount, Infinity, Infinity);
+      TestInfinity(MlasReduceLogSumExp, InnerCount, -Infinity, -Infinity);
+      TestInfinity(MlasReduceLogSumExp, InnerCount, Infinity, Infinity);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasReduceTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasRoPETest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSin;
+  MatrixGuardBuffer<float> BufferCos;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+
+  void Test(size_t RotaryDim, bool Interleaved) {
+    const size_t HalfRotaryDim = RotaryDim / 2;
+    float* Input = BufferInput.GetBuffer(RotaryDim);
+    float* SinData = BufferSin.GetBuffer(HalfRotaryDim);
+    float* CosData = BufferCos.GetBuffer(HalfRotaryDim);
+    float* Output = BufferOutput.GetBuffer(RotaryDim);
+    float* OutputReference = BufferOutputReference.GetBuffer(RotaryDim);
+
+    std::default_random_engine generator(static_cast<unsigned>(RotaryDim));
+    std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+
+    for (size_t i = 0; i < RotaryDim; i++) {
+      Input[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < HalfRotaryDim; i++) {
+      const float Angle = distribution(generator);
+      SinData[i] = std::sin(Angle);
+      CosData[i] = std::cos(Angle);
+    }
+
+    MlasRotaryEmbedOneRow(Input, SinData, CosData, RotaryDim, Interleaved, Output);
+
+    // Reference in the formulation of the RotaryEmbedding contrib op.
+    for (size_t i = 0; i < RotaryDim; i++) {
+      size_t cache_idx;
+      float sign;
+      size_t j;
+      if (Interleaved) {
+        cache_idx = i / 2;
+        sign = (i % 2 == 0) ? -1.0f : 1.0f;
+        j = (i % 2 == 0) ? i + 1 : i - 1;
+      } else {
+        cache_idx = i % HalfRotaryDim;
+        sign = (i < HalfRotaryDim) ? -1.0f : 1.0f;
+        j = (i + HalfRotaryDim) % RotaryDim;
+      }
+      OutputReference[i] = Input[i] * CosData[cache_idx] + sign * Input[j] * SinData[cache_idx];
+    }
+
+    for (size_t i = 0; i < RotaryDim; i++) {
+      ASSERT_NEAR(Output[i], OutputReference[i], 1e-5f)
+          << "Interleaved:" << (int)Interleaved << " RotaryDim:" << RotaryDim << " @" << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("RoPE");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t RotaryDim : {2, 6, 8, 14, 16, 32, 64, 80, 128}) {
+      Test(RotaryDim, false);
+      Test(RotaryDim, true);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasRoPETest>::RegisterShortExecute() : 0;
+});
@@ -15,10 +15,10 @@ Abstract:
 
 --*/
 
-#if defined(__aarch64__) && defined(__linux__)
-
 #include "test_sbgemm.h"
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
 //
 // Short Execute() test helper to register each test seperately by all parameters.
 //
@@ -138,4 +138,4 @@ static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_exe
   }
   return SBGemmRegistLongExecute() > 0;
 });
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
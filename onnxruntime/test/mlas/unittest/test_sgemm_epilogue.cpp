@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Verify the SGEMM epilogue (MLAS_SGEMM_ACTIVATION_PROCESSOR) against a plain
+// SGEMM followed by a reference bias addition, sum addition and activation.
+//
+
+class MlasSgemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferSum;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MLAS_THREADPOOL* threadpool_;
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float Value) {
+    switch (Activation.ActivationKind) {
+      case MlasReluActivation:
+        return std::max(Value, 0.0f);
+      case MlasLeakyReluActivation:
+        return Value >= 0.0f ? Value : Value * Activation.Parameters.LeakyRelu.alpha;
+      case MlasTanhActivation:
+        return std::tanh(Value);
+      case MlasLogisticActivation:
+        return 1.0f / (1.0f + std::exp(-Value));
+      case MlasClipActivation:
+        return std::min(std::max(Value, Activation.Parameters.Clip.minimum), Activation.Parameters.Clip.maximum);
+      case MlasHardSigmoidActivation:
+        return std::min(std::max(Value * Activation.Parameters.HardSigmoid.alpha + Activation.Parameters.HardSigmoid.beta, 0.0f), 1.0f);
+      default:
+        return Value;
+    }
+  }
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+            const MLAS_ACTIVATION& Activation, bool HasBias, bool HasSum, bool PackB) {
+    if (PackB && MlasGemmPackBSize(N, K) == 0) {
+      return;
+    }
+
+    const float* A = BufferA.GetBuffer(M * K);
+    const float* B = BufferB.GetBuffer(K * N);
+    const float* Bias = HasBias ? BufferBias.GetBuffer(N) : nullptr;
+    const float* Sum = HasSum ? BufferSum.GetBuffer(M * N) : nullptr;
+    float* C = BufferC.GetBuffer(M * N, true);
+    float* CReference = BufferCReference.GetBuffer(M * N, true);
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    MlasGemm(TransA, TransB, M, N, K, 1.0f, A, lda, B, ldb, 0.0f, CReference, N, threadpool_);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float Value = CReference[m * N + n];
+        if (Bias != nullptr) {
+          Value += Bias[n];
+        }
+        if (Sum != nullptr) {
+          Value += Sum[m * N + n];
+        }
+        CReference[m * N + n] = ReferenceActivation(Activation, Value);
+      }
+    }
+
+    MLAS_SGEMM_ACTIVATION_PROCESSOR OutputProcessor(Activation, Bias, Sum);
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = N;
+    Data.OutputProcessor = &OutputProcessor;
+
+    if (PackB) {
+      void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = ldb;
+    }
+
+    MlasGemm(TransA, TransB, M, N, K, Data, threadpool_);
+
+    for (size_t f = 0; f < M * N; f++) {
+      ASSERT_NEAR(C[f], CReference[f], 1e-5f * std::max(1.0f, std::fabs(CReference[f])))
+          << "@[" << f / N << "x" << f % N << "], M=" << M << ", N=" << N << ", K=" << K
+          << ", TransA=" << (TransA == CblasTrans) << ", TransB=" << (TransB == CblasTrans)
+          << ", Activation=" << Activation.ActivationKind << ", HasBias=" << HasBias
+          << ", HasSum=" << HasSum << ", PackB=" << PackB;
+    }
+  }
+
+ public:
+  MlasSgemmEpilogueTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SgemmEpilogue");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    MLAS_ACTIVATION Activations[MlasActivationKindCount];
+    for (int kind = 0; kind < MlasActivationKindCount; kind++) {
+      Activations[kind].ActivationKind = static_cast<MLAS_ACTIVATION_KIND>(kind);
+    }
+    Activations[MlasLeakyReluActivation].Parameters.LeakyRelu.alpha = 0.2f;
+    Activations[MlasClipActivation].Parameters.Clip.minimum = -0.5f;
+    Activations[MlasClipActivation].Parameters.Clip.maximum = 0.5f;
+    Activations[MlasHardSigmoidActivation].Parameters.HardSigmoid.alpha = 0.2f;
+    Activations[MlasHardSigmoidActivation].Parameters.HardSigmoid.beta = 0.5f;
+
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 37, 19}, {7, 1, 33}, {5, 17, 3}, {16, 64, 64}, {33, 300, 129}, {67, 23, 400}};
+
+    for (const auto& Shape : Shapes) {
+      for (const auto& Activation : Activations) {
+        for (int flags = 0; flags < 4; flags++) {
+          const bool HasBias = (flags & 1) != 0;
+          const bool HasSum = (flags & 2) != 0;
+          Test(CblasNoTrans, CblasNoTrans, Shape[0], Shape[1], Shape[2], Activation, HasBias, HasSum, false);
+          Test(CblasTrans, CblasTrans, Shape[0], Shape[1], Shape[2], Activation, HasBias, HasSum, false);
+          Test(CblasNoTrans, CblasNoTrans, Shape[0], Shape[1], Shape[2], Activation, HasBias, HasSum, true);
+          Test(CblasTrans, CblasTrans, Shape[0], Shape[1], Shape[2], Activation, HasBias, HasSum, true);
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSgemmEpilogueTest>::RegisterShortExecute() : 0;
+});
@@ -45,12 +45,110 @@ class MlasTransposeTest : public MlasTestBase {
   }
 };
 
+template <typename ElementType>
+class MlasTransposeNdTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<ElementType> BufferInput;
+  MatrixGuardBuffer<ElementType> BufferOutput;
+  MatrixGuardBuffer<ElementType> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void
+  Test(const std::vector<size_t>& Shape, const std::vector<size_t>& Permutation) {
+    const size_t Rank = Shape.size();
+    size_t Count = 1;
+    for (size_t d : Shape) {
+      Count *= d;
+    }
+
+    ElementType* Input = BufferInput.GetBuffer(Count);
+    ElementType* Output = BufferOutput.GetBuffer(Count);
+    ElementType* OutputReference = BufferOutputReference.GetBuffer(Count);
+
+    for (size_t i = 0; i < Count; i++) {
+      Input[i] = static_cast<ElementType>(i * 7 + 3);
+    }
+
+    MlasTranspose(Input, Output, Shape.data(), Permutation.data(), Rank, threadpool_);
+    ReferenceTranspose(Input, OutputReference, Shape, Permutation);
+
+    std::ostringstream ss;
+    for (size_t i = 0; i < Rank; i++) {
+      ss << (i == 0 ? "" : ",") << Shape[i] << "/" << Permutation[i];
+    }
+    ASSERT_EQ(memcmp(Output, OutputReference, Count * sizeof(ElementType)), 0) << " [" << ss.str() << "]";
+  }
+
+  void ReferenceTranspose(const ElementType* Input, ElementType* Output,
+                          const std::vector<size_t>& Shape, const std::vector<size_t>& Permutation) {
+    const size_t Rank = Shape.size();
+    std::vector<size_t> InputStride(Rank, 1);
+    for (size_t i = Rank; i > 1; i--) {
+      InputStride[i - 2] = InputStride[i - 1] * Shape[i - 1];
+    }
+
+    std::vector<size_t> Index(Rank, 0);
+    size_t Count = 1;
+    for (size_t d : Shape) {
+      Count *= d;
+    }
+
+    for (size_t o = 0; o < Count; o++) {
+      size_t Offset = 0;
+      for (size_t i = 0; i < Rank; i++) {
+        Offset += Index[i] * InputStride[Permutation[i]];
+      }
+      Output[o] = Input[Offset];
+
+      for (size_t i = Rank; i > 0; i--) {
+        if (++Index[i - 1] < Shape[Permutation[i - 1]]) {
+          break;
+        }
+        Index[i - 1] = 0;
+      }
+    }
+  }
+
+ public:
+  MlasTransposeNdTest() : threadpool_(GetMlasThreadPool()) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("TransposeNd_Size") + std::to_string(int(sizeof(ElementType)));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    Test({7}, {0});
+    Test({1, 1}, {1, 0});
+    Test({13, 29}, {1, 0});
+    Test({257, 131}, {1, 0});
+    Test({3, 1, 5}, {2, 1, 0});
+    Test({2, 3, 4}, {0, 2, 1});
+    Test({2, 3, 4}, {1, 2, 0});
+    Test({2, 3, 4}, {2, 0, 1});
+    Test({2, 3, 4}, {1, 0, 2});
+    Test({4, 65, 37}, {2, 1, 0});
+    Test({2, 3, 17, 19}, {0, 2, 3, 1});
+    Test({2, 17, 19, 3}, {0, 3, 1, 2});
+    Test({3, 5, 7, 9}, {3, 1, 0, 2});
+    Test({3, 5, 7, 9}, {1, 0, 3, 2});
+    Test({8, 1, 16, 1, 24}, {4, 1, 0, 3, 2});
+    Test({2, 3, 2, 3, 2, 3}, {5, 3, 1, 4, 2, 0});
+    Test({1, 512, 1, 200}, {3, 0, 2, 1});
+    Test({64, 48, 40}, {1, 2, 0});
+    Test({3, 96, 2, 100}, {2, 3, 0, 1});
+  }
+};
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
   if (is_short_execute) {
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint32_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint16_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint32_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint16_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint8_t>>::RegisterShortExecute();
   }
   return count;
 });
@@ -74,11 +74,17 @@ BENCHMARK(BM_ResolveGraph);
     }                                                        \
   } while (0);
 
+bool RegisterModelOpBenchmarks();
+
 int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return -1;
   ORT_ABORT_ON_ERROR(g_ort->CreateEnv(ORT_LOGGING_LEVEL_ERROR, "test", &env));
+  if (!RegisterModelOpBenchmarks()) {
+    g_ort->ReleaseEnv(env);
+    return -1;
+  }
   ::benchmark::RunSpecifiedBenchmarks();
   g_ort->ReleaseEnv(env);
   return 0;
@@ -0,0 +1,418 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks each node of a model on its own, with the shapes, attributes and input values it has when the model runs.
+// This pinpoints which kernels regress between two builds without writing a benchmark per op.
+//
+// The model is first saved with the graph optimizations of ORT_MODEL_OP_BENCHMARK_OPT_LEVEL applied, so that fused
+// nodes are benchmarked as they run, and then run once with every intermediate value as an output. Every node of the
+// saved model becomes a single node model whose constant inputs are the initializers of the original model and whose
+// other inputs are the values captured from that run. The benchmarks are named
+// BM_ModelOp/<node index>_<op type>_<node name>/<execution provider>/threads:<intra-op threads>.
+//
+// The benchmarks are only registered when ORT_MODEL_OP_BENCHMARK_MODEL is set. Other environment variables:
+//   ORT_MODEL_OP_BENCHMARK_EPS        comma separated execution providers, cpu (default), cuda or dnnl. The model is
+//                                     optimized and its values are captured with the first one.
+//   ORT_MODEL_OP_BENCHMARK_THREADS    comma separated intra-op thread counts, default 1 and the number of cores.
+//   ORT_MODEL_OP_BENCHMARK_OPT_LEVEL  graph optimization level applied to the model: 0 (none), 1 (basic),
+//                                     2 (extended, default) or 99 (all).
+//   ORT_MODEL_OP_BENCHMARK_DIMS       values of the symbolic dimensions of the model inputs, e.g. "batch=1,seq=128".
+//                                     Unlisted symbolic dimensions are 1.
+// The model inputs are random in [-1, 1) if they are floating point and zero otherwise, so that index inputs are valid.
+
+#include <benchmark/benchmark.h>
+#include <core/common/parse_string.h>
+#include <core/common/path_string.h>
+#include <core/common/string_utils.h>
+#include <core/graph/model.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/platform/env.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "providers.h"
+
+extern const OrtApi* g_ort;
+
+using namespace onnxruntime;
+
+namespace {
+
+struct ModelOpContext {
+  Ort::Env env{ORT_LOGGING_LEVEL_ERROR, "model_ops"};
+  // the optimized model
+  ONNX_NAMESPACE::ModelProto model_proto;
+  std::unordered_map<std::string, const ONNX_NAMESPACE::TensorProto*> initializers;
+  // the model inputs and the outputs of every node from one run of the model
+  std::unordered_map<std::string, Ort::Value> values;
+};
+
+std::vector<std::string> GetListFromEnvironment(const std::string& name, const std::string& default_value) {
+  std::string value = Env::Default().GetEnvironmentVar(name);
+  if (value.empty()) {
+    value = default_value;
+  }
+
+  std::vector<std::string> result;
+  for (const auto item : utils::SplitString(value, ",")) {
+    result.emplace_back(item);
+  }
+  return result;
+}
+
+void AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& provider) {
+  if (provider == "cpu") {
+    return;
+  }
+#ifdef USE_CUDA
+  if (provider == "cuda") {
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_CUDA(session_options, 0));
+    return;
+  }
+#endif
+#ifdef USE_DNNL
+  if (provider == "dnnl") {
+    Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Dnnl(session_options, 1));
+    return;
+  }
+#endif
+  ORT_CXX_API_THROW("Execution provider " + provider + " is not supported by this build", ORT_INVALID_ARGUMENT);
+}
+
+size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      ORT_CXX_API_THROW("Model inputs of element type " + std::to_string(type) + " are not supported",
+                        ORT_NOT_IMPLEMENTED);
+  }
+}
+
+// Creates a value for the model input `input_index`, the symbolic dimensions take their value from `dims`.
+Ort::Value CreateModelInput(const Ort::Session& session, size_t input_index,
+                            const std::unordered_map<std::string, int64_t>& dims, std::mt19937& generator) {
+  const auto type_info = session.GetInputTypeInfo(input_index);
+  if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+    ORT_CXX_API_THROW("Model inputs that are not tensors are not supported", ORT_NOT_IMPLEMENTED);
+  }
+
+  const auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+  const auto element_type = tensor_info.GetElementType();
+  std::vector<int64_t> shape = tensor_info.GetShape();
+  std::vector<const char*> symbolic_dims(shape.size(), nullptr);
+  tensor_info.GetSymbolicDimensions(symbolic_dims.data(), symbolic_dims.size());
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] < 0) {
+      auto dim = symbolic_dims[i] != nullptr ? dims.find(symbolic_dims[i]) : dims.end();
+      shape[i] = dim != dims.end() ? dim->second : 1;
+    }
+  }
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), element_type);
+  const size_t element_count = value.GetTensorTypeAndShapeInfo().GetElementCount();
+  void* data = value.GetTensorMutableRawData();
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+    std::generate_n(static_cast<float*>(data), element_count,
+                    [&]() { return static_cast<float>(distribution(generator)); });
+  } else if (element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE) {
+    std::generate_n(static_cast<double*>(data), element_count, [&]() { return distribution(generator); });
+  } else {
+    memset(data, 0, element_count * ElementSize(element_type));
+  }
+  return value;
+}
+
+// Saves the model with the graph optimizations of `optimization_level` applied and loads it into `model_proto`.
+void LoadOptimizedModel(const Ort::Env& env, const PathString& model_path, GraphOptimizationLevel optimization_level,
+                        const std::string& provider, ONNX_NAMESPACE::ModelProto& model_proto) {
+  // saving the model also moves all initializers into it, so it does not depend on external data files
+  const std::filesystem::path optimized_model_path =
+      std::filesystem::temp_directory_path() / "ort_model_op_benchmark.onnx";
+  Ort::SessionOptions session_options;
+  session_options.SetGraphOptimizationLevel(optimization_level);
+  session_options.SetOptimizedModelFilePath(optimized_model_path.c_str());
+  AppendExecutionProvider(session_options, provider);
+  Ort::Session session(env, model_path.c_str(), session_options);
+
+  const auto status = Model::Load(optimized_model_path.native(), model_proto);
+  std::filesystem::remove(optimized_model_path);
+  if (!status.IsOK()) {
+    ORT_CXX_API_THROW(status.ErrorMessage(), ORT_FAIL);
+  }
+}
+
+// Runs the model once with every node output as a model output and keeps the model inputs and all outputs.
+void CaptureValues(ModelOpContext& context, const std::string& provider) {
+  ONNX_NAMESPACE::ModelProto capture_proto = context.model_proto;
+  auto* graph = capture_proto.mutable_graph();
+  std::unordered_set<std::string> output_names;
+  for (const auto& output : graph->output()) {
+    output_names.insert(output.name());
+  }
+  for (const auto& node : graph->node()) {
+    for (const auto& output_name : node.output()) {
+      if (!output_name.empty() && output_names.insert(output_name).second) {
+        graph->add_output()->set_name(output_name);
+      }
+    }
+  }
+  const std::string model_data = capture_proto.SerializeAsString();
+  capture_proto.Clear();
+
+  Ort::SessionOptions session_options;
+  session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+  AppendExecutionProvider(session_options, provider);
+  Ort::Session session(context.env, model_data.data(), model_data.size(), session_options);
+
+  std::unordered_map<std::string, int64_t> dims;
+  for (const auto& dim : GetListFromEnvironment("ORT_MODEL_OP_BENCHMARK_DIMS", "")) {
+    const auto name_and_value = utils::SplitString(dim, "=");
+    int64_t value = 0;
+    if (name_and_value.size() != 2 || !TryParseStringWithClassicLocale(name_and_value[1], value) || value < 0) {
+      ORT_CXX_API_THROW("Invalid dimension in ORT_MODEL_OP_BENCHMARK_DIMS: " + dim, ORT_INVALID_ARGUMENT);
+    }
+    dims[std::string{name_and_value[0]}] = value;
+  }
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::mt19937 generator(42);
+  std::vector<Ort::AllocatedStringPtr> input_name_ptrs;
+  std::vector<const char*> input_names;
+  std::vector<Ort::Value> inputs;
+  for (size_t i = 0; i < session.GetInputCount(); ++i) {
+    input_name_ptrs.push_back(session.GetInputNameAllocated(i, allocator));
+    input_names.push_back(input_name_ptrs.back().get());
+    inputs.push_back(CreateModelInput(session, i, dims, generator));
+  }
+
+  std::vector<Ort::AllocatedStringPtr> output_name_ptrs;
+  std::vector<const char*> output_names_to_fetch;
+  for (size_t i = 0; i < session.GetOutputCount(); ++i) {
+    output_name_ptrs.push_back(session.GetOutputNameAllocated(i, allocator));
+    output_names_to_fetch.push_back(output_name_ptrs.back().get());
+  }
+
+  auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names.data(), inputs.data(), inputs.size(),
+                             output_names_to_fetch.data(), output_names_to_fetch.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    context.values.emplace(input_names[i], std::move(inputs[i]));
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    context.values.emplace(output_names_to_fetch[i], std::move(outputs[i]));
+  }
+}
+
+std::string ShapeToString(const std::vector<int64_t>& shape) {
+  std::ostringstream stream;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    stream << (i == 0 ? "" : "x") << shape[i];
+  }
+  return shape.empty() ? "scalar" : stream.str();
+}
+
+// A model with only the node `node_index`, and its feeds.
+struct SingleNodeModel {
+  std::string model_data;
+  std::vector<const char*> input_names;
+  std::vector<const OrtValue*> inputs;
+  std::vector<const char*> output_names;
+  std::string label;
+};
+
+SingleNodeModel CreateSingleNodeModel(const ModelOpContext& context, int node_index) {
+  const auto& node = context.model_proto.graph().node(node_index);
+  for (const auto& attribute : node.attribute()) {
+    if (attribute.type() == ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH ||
+        attribute.type() == ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPHS) {
+      ORT_CXX_API_THROW("Nodes with subgraphs are not supported", ORT_NOT_IMPLEMENTED);
+    }
+  }
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  model_proto.set_ir_version(context.model_proto.ir_version());
+  *model_proto.mutable_opset_import() = context.model_proto.opset_import();
+  *model_proto.mutable_functions() = context.model_proto.functions();
+  auto* graph = model_proto.mutable_graph();
+  graph->set_name(node.op_type());
+  *graph->add_node() = node;
+
+  SingleNodeModel single_node_model;
+  std::unordered_set<std::string> added_inputs;
+  std::ostringstream label;
+  label << node.op_type();
+  for (const auto& input_name : node.input()) {
+    if (input_name.empty() || !added_inputs.insert(input_name).second) {
+      continue;
+    }
+
+    auto initializer = context.initializers.find(input_name);
+    if (initializer != context.initializers.end()) {
+      *graph->add_initializer() = *initializer->second;
+      std::vector<int64_t> shape(initializer->second->dims().begin(), initializer->second->dims().end());
+      label << " " << ShapeToString(shape);
+      continue;
+    }
+
+    auto value = context.values.find(input_name);
+    if (value == context.values.end() || !value->second.IsTensor()) {
+      ORT_CXX_API_THROW("Input " + input_name + " is not a captured tensor", ORT_NOT_IMPLEMENTED);
+    }
+    const auto tensor_info = value->second.GetTensorTypeAndShapeInfo();
+    const auto shape = tensor_info.GetShape();
+    auto* graph_input = graph->add_input();
+    graph_input->set_name(input_name);
+    auto* tensor_type = graph_input->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(tensor_info.GetElementType());
+    for (const int64_t dim : shape) {
+      tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    single_node_model.input_names.push_back(value->first.c_str());
+    single_node_model.inputs.push_back(value->second);
+    label << " " << ShapeToString(shape);
+  }
+
+  for (const auto& output_name : node.output()) {
+    if (!output_name.empty()) {
+      graph->add_output()->set_name(output_name);
+      single_node_model.output_names.push_back(output_name.c_str());
+    }
+  }
+
+  single_node_model.model_data = model_proto.SerializeAsString();
+  single_node_model.label = label.str();
+  return single_node_model;
+}
+
+void BM_ModelOp(benchmark::State& state, const std::shared_ptr<const ModelOpContext>& context, int node_index,
+                const std::string& provider) {
+  try {
+    const auto model = CreateSingleNodeModel(*context, node_index);
+    state.SetLabel(model.label);
+
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(static_cast<int>(state.range(0)));
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+    // a node the provider does not support must not be measured on the CPU instead
+    if (provider != "cpu") {
+      session_options.AddConfigEntry(kOrtSessionOptionsDisableCPUEPFallback, "1");
+    }
+    AppendExecutionProvider(session_options, provider);
+    Ort::Session session(context->env, model.model_data.data(), model.model_data.size(), session_options);
+
+    std::vector<OrtValue*> outputs(model.output_names.size(), nullptr);
+    auto run = [&]() {
+      Ort::ThrowOnError(g_ort->Run(session, nullptr, model.input_names.data(), model.inputs.data(),
+                                   model.inputs.size(), model.output_names.data(), outputs.size(), outputs.data()));
+      for (auto*& output : outputs) {
+        g_ort->ReleaseValue(output);
+        output = nullptr;
+      }
+    };
+
+    // the first run allocates the buffers of the session
+    run();
+    for (auto _ : state) {
+      run();
+    }
+  } catch (const std::exception& ex) {
+    state.SkipWithError(ex.what());
+  }
+}
+
+}  // namespace
+
+// Registers the benchmarks of the nodes of the model ORT_MODEL_OP_BENCHMARK_MODEL, if set.
+// Returns false if the model could not be prepared.
+bool RegisterModelOpBenchmarks() {
+  const std::string model_path = Env::Default().GetEnvironmentVar("ORT_MODEL_OP_BENCHMARK_MODEL");
+  if (model_path.empty()) {
+    return true;
+  }
+
+  try {
+    const auto providers = GetListFromEnvironment("ORT_MODEL_OP_BENCHMARK_EPS", "cpu");
+    std::vector<int64_t> thread_counts;
+    for (const auto& thread_count_str :
+         GetListFromEnvironment("ORT_MODEL_OP_BENCHMARK_THREADS",
+                                "1," + std::to_string(std::max(std::thread::hardware_concurrency(), 1u)))) {
+      int64_t thread_count = 0;
+      if (!TryParseStringWithClassicLocale(thread_count_str, thread_count) || thread_count < 1) {
+        ORT_CXX_API_THROW("Invalid thread count in ORT_MODEL_OP_BENCHMARK_THREADS: " + thread_count_str,
+                          ORT_INVALID_ARGUMENT);
+      }
+      if (std::find(thread_counts.begin(), thread_counts.end(), thread_count) == thread_counts.end()) {
+        thread_counts.push_back(thread_count);
+      }
+    }
+
+    int optimization_level = 2;
+    const std::string optimization_level_str = Env::Default().GetEnvironmentVar("ORT_MODEL_OP_BENCHMARK_OPT_LEVEL");
+    if (!optimization_level_str.empty() &&
+        (!TryParseStringWithClassicLocale(optimization_level_str, optimization_level) ||
+         (optimization_level != ORT_DISABLE_ALL && optimization_level != ORT_ENABLE_BASIC &&
+          optimization_level != ORT_ENABLE_EXTENDED && optimization_level != ORT_ENABLE_ALL))) {
+      ORT_CXX_API_THROW("Invalid ORT_MODEL_OP_BENCHMARK_OPT_LEVEL: " + optimization_level_str, ORT_INVALID_ARGUMENT);
+    }
+
+    auto context = std::make_shared<ModelOpContext>();
+    LoadOptimizedModel(context->env, ToPathString(model_path), static_cast<GraphOptimizationLevel>(optimization_level),
+                       providers.front(), context->model_proto);
+    for (const auto& initializer : context->model_proto.graph().initializer()) {
+      context->initializers.emplace(initializer.name(), &initializer);
+    }
+    CaptureValues(*context, providers.front());
+
+    std::shared_ptr<const ModelOpContext> const_context = std::move(context);
+    const auto& nodes = const_context->model_proto.graph().node();
+    for (int node_index = 0; node_index < nodes.size(); ++node_index) {
+      const auto& node = nodes[node_index];
+      for (const auto& provider : providers) {
+        const std::string name = "BM_ModelOp/" + std::to_string(node_index) + "_" + node.op_type() + "_" +
+                                 node.name() + "/" + provider;
+        auto* benchmark = benchmark::RegisterBenchmark(
+            name.c_str(), [const_context, node_index, provider](benchmark::State& state) {
+              BM_ModelOp(state, const_context, node_index, provider);
+            });
+        benchmark->ArgName("threads")->UseRealTime();
+        for (const int64_t thread_count : thread_counts) {
+          benchmark->Arg(thread_count);
+        }
+      }
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << "Failed to prepare the benchmarks of " << model_path << ": " << ex.what() << std::endl;
+    return false;
+  }
+  return true;
+}
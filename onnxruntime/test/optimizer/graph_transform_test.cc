@@ -17,6 +17,7 @@
 #include "core/common/span_utils.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ort_value.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -39,18 +40,22 @@
 #include "core/optimizer/div_mul_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gather_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/gemm_float8_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_config.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
+#include "core/optimizer/group_norm_fusion.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/isinf_reducesum_fusion.h"
@@ -64,7 +69,9 @@
 #include "core/optimizer/quick_gelu_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
+#include "core/optimizer/rotary_embedding_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/optimizer/scan_elimination.h"
 #include "core/optimizer/slice_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
@@ -786,6 +793,95 @@ TEST_F(GraphTransformationTests, ConstantFoldingWithScalarShapeToInitializer) {
   ASSERT_TRUE(op_to_count["Add"] == 1);
 }
 
+// Gathering the fixed dimensions of a Shape with a symbolic dimension is constant folded, the symbolic one is not.
+TEST_F(GraphTransformationTests, ConstantFoldingShapeGatherOfFixedDims) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", 16, 8});
+    auto* shape_out = builder.MakeIntermediate();
+    auto* batch_dim = builder.MakeIntermediate();
+    auto* fixed_dims = builder.MakeIntermediate();
+    auto* batch_dim_1d = builder.MakeIntermediate();
+    auto* fixed_dims_product = builder.MakeIntermediate();
+    auto* target_shape = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Shape", {input_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(0)}, {batch_dim});
+    builder.AddNode("Gather", {shape_out, builder.MakeInitializer<int64_t>({2}, {1, -1})}, {fixed_dims});
+    builder.AddNode("Unsqueeze", {batch_dim, builder.MakeInitializer<int64_t>({1}, {0})}, {batch_dim_1d});
+    builder.AddNode("ReduceProd", {fixed_dims}, {fixed_dims_product}).AddAttribute("keepdims", int64_t{1});
+    builder.AddNode("Concat", {batch_dim_1d, fixed_dims_product}, {target_shape}).AddAttribute("axis", int64_t{0});
+    builder.AddNode("Reshape", {input_arg, target_shape}, {output_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 2);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Shape"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Gather"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["ReduceProd"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Concat"] == 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Concat") {
+        const ONNX_NAMESPACE::TensorProto* folded =
+            graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+        TEST_RETURN_IF_NOT(folded != nullptr);
+        Initializer folded_value{*folded, graph.ModelPath()};
+        TEST_RETURN_IF_NOT(folded_value.size() == 1 && folded_value.data<int64_t>()[0] == 16 * 8);
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  const ConfigOptions empty_config_options;
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_,
+                                        std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/,
+                                                                          empty_config_options),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ConstantFoldingSizeOfFixedShape) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* fixed_input = builder.MakeInput<float>({4, 16, 8}, -1.f, 1.f);
+    auto* symbolic_input = builder.MakeSymbolicInput<float>({"batch", 16});
+    auto* fixed_size = builder.MakeIntermediate();
+    auto* symbolic_size = builder.MakeIntermediate();
+    auto* fixed_output = builder.MakeOutput();
+    auto* symbolic_output = builder.MakeOutput();
+
+    builder.AddNode("Size", {fixed_input}, {fixed_size});
+    builder.AddNode("Size", {symbolic_input}, {symbolic_size});
+    builder.AddNode("Equal", {fixed_size, builder.MakeScalarInitializer<int64_t>(0)}, {fixed_output});
+    builder.AddNode("Equal", {symbolic_size, builder.MakeScalarInitializer<int64_t>(0)}, {symbolic_output});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Size"] == 2);
+    return Status::OK();
+  };
+
+  // the Size of the input with a fixed shape and the Equal that uses it are folded
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Size"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Equal"] == 1);
+    return Status::OK();
+  };
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  const ConfigOptions empty_config_options;
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_,
+                                        std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/,
+                                                                          empty_config_options),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingForOpsWithMissingOptionalInputs) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/constant_folding_for_ops_having_missing_optional_inputs.onnx";
   std::shared_ptr<Model> model;
@@ -1045,9 +1141,8 @@ TEST_F(GraphTransformationTests, ConstantFoldingIfConstantInlining) {
   // Constant nodes and initializers are promoted to the outer graph.
   // The initializer or a constant node is the output of the subgraph being inlined.
   // Nested subgraphs names are renamed as appropriate.
-  // In all If node is constant folded twice. The last If node is not constant
-  // folded because the input is indirectly dependent on the size of the input.
-  // XXX: Can we constant fold Size() if the graph input shape is fixed?
+  // In all If node is constant folded three times. The last If node is constant
+  // folded because Size() of an input with a fixed shape is constant folded.
 
   const char* code = R"(
   <
@@ -1132,39 +1227,16 @@ TEST_F(GraphTransformationTests, ConstantFoldingIfConstantInlining) {
   // ASSERT_FALSE(printed_model.empty());
   // std::cout << printed_model << std::endl;
 
-  // This is the resulting model proto.
-  // The remaining If node is not constant foldable because Size() does not constant fold
-  // although the shape is fixed.
-  /*
-    <
-       ir_version: 8,
-       opset_import: ["" : 16, "local" : 1,
-         "com.microsoft.nchwc" : 1,
-          "ai.onnx.ml" : 4,
-          "com.ms.internal.nhwc" : 20,
-          "ai.onnx.training" : 1,
-          "ai.onnx.preview.training" : 1,
-          "com.microsoft" : 1,
-          "com.microsoft.experimental" : 1,
-          "org.pytorch.aten" : 1]
-    >
-    agraph (float[128] x, float[128] x1) => (float[128] y) {
-       _if_elseGraph_10__inlfunc_aten_gather_tmp_9 = Size (x1)
-       _if_elseGraph_10__inlfunc_aten_gather_cond_11 =
-                                  Equal (_if_elseGraph_10__inlfunc_aten_gather_tmp_9, ortshared_7_0_1_0_token_10)
-       y = If (_if_elseGraph_10__inlfunc_aten_gather_cond_11) <then_branch: graph = thenGraph_15 () => (float[128] _inlfunc_aten_gather_result_12) {
-          _inlfunc_aten_gather_result_12 = Cast <to: int = 1> (x1)
-       }, else_branch: graph = elseGraph_15 () => (float[128] _inlfunc_aten_gather_result_14) {
-          _inlfunc_aten_gather_index_13 = Cast <to: int = 7> (x1)
-          _inlfunc_aten_gather_result_14 = GatherElements <axis: int = 1> (x, _inlfunc_aten_gather_index_13)
-       }>
-    }
-  */
+  // The resulting graph is the else branch of the last If node, as Size(x1) is 128:
+  //   index_13 = Cast <to: int = 7> (x1)
+  //   y = GatherElements <axis: int = 1> (x, index_13)
 
   auto& graph = session_object.GetModel().MainGraph();
   auto op_to_count = CountOpsInGraph(graph);
   ASSERT_EQ(op_to_count["local.aten_gather"], 0);
-  ASSERT_EQ(op_to_count["If"], 1);
+  ASSERT_EQ(op_to_count["If"], 0);
+  ASSERT_EQ(op_to_count["Size"], 0);
+  ASSERT_EQ(op_to_count["GatherElements"], 1);
 }
 
 TEST_F(GraphTransformationTests, ConstantFoldingIfConstantInliningRebuildEdges) {
@@ -1370,6 +1442,100 @@ TEST_F(GraphTransformationTests, SubgraphWithConstantInputs) {
   ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
 }
 
+static void TestScanElimination(const char* code, const logging::Logger& logger, bool expect_eliminated) {
+  ONNX_NAMESPACE::OnnxParser parser(code);
+  ONNX_NAMESPACE::ModelProto model_proto;
+  auto parse_status = parser.Parse(model_proto);
+  ASSERT_TRUE(parse_status.IsOK()) << parse_status.ErrorMessage();
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(Model::Load(std::move(model_proto), p_model, nullptr, logger));
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<ScanElimination>(), TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, logger));
+
+  auto op_to_count = CountOpsInGraph(graph, /* recurse_into_subgraphs */ false);
+  if (!expect_eliminated) {
+    ASSERT_EQ(op_to_count["Scan"], 1);
+    return;
+  }
+
+  ASSERT_EQ(op_to_count["Scan"], 0);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+
+  // the output of the body nodes is stacked along the scan axis
+  const auto* y_shape = graph.GetNodeArg("y")->Shape();
+  ASSERT_NE(y_shape, nullptr);
+  ASSERT_EQ(y_shape->dim_size(), 2);
+  EXPECT_EQ(y_shape->dim(0).dim_value(), 4);
+  EXPECT_EQ(y_shape->dim(1).dim_value(), 2);
+}
+
+TEST_F(GraphTransformationTests, ScanElimination) {
+  // the iterations only read the scanned slice and values from the outer scope
+  const char* code = R"(
+  <
+  ir_version: 8,
+  opset_import: [ "" : 16 ]
+  >
+  agraph (float[4, 3] x, float[3, 2] w) => (float[4, 2] y)
+  {
+      y = Scan <num_scan_inputs: int = 1, body: graph = scan_body (float[3] xi) => (float[2] yi) {
+        bias = Constant <value: tensor = float[2] bias {0.5, -0.5}> ()
+        m = MatMul (xi, w)
+        a = Add (m, bias)
+        yi = Relu (a)
+      }> (x)
+  }
+  )";
+
+  TestScanElimination(code, *logger_, true);
+}
+
+TEST_F(GraphTransformationTests, ScanEliminationNotAppliedWithState) {
+  // the state variable carries the sum of the previous iterations
+  const char* code = R"(
+  <
+  ir_version: 8,
+  opset_import: [ "" : 16 ]
+  >
+  agraph (float[2] s, float[4, 3] x, float[3, 2] w) => (float[2] s_final, float[4, 2] y)
+  {
+      s_final, y = Scan <num_scan_inputs: int = 1, body: graph = scan_body (float[2] s_in, float[3] xi) =>
+                         (float[2] s_out, float[2] yi) {
+        m = MatMul (xi, w)
+        s_out = Add (s_in, m)
+        yi = Relu (s_out)
+      }> (s, x)
+  }
+  )";
+
+  TestScanElimination(code, *logger_, false);
+}
+
+TEST_F(GraphTransformationTests, ScanEliminationNotAppliedWithReverseDirection) {
+  const char* code = R"(
+  <
+  ir_version: 8,
+  opset_import: [ "" : 16 ]
+  >
+  agraph (float[4, 3] x, float[3, 2] w) => (float[4, 2] y)
+  {
+      y = Scan <num_scan_inputs: int = 1, scan_output_directions: ints = [1],
+                body: graph = scan_body (float[3] xi) => (float[2] yi) {
+        m = MatMul (xi, w)
+        yi = Relu (m)
+      }> (x)
+  }
+  )";
+
+  TestScanElimination(code, *logger_, false);
+}
+
 TEST_F(GraphTransformationTests, FuseConvBNNoBias) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/fuse-conv-bn-no-bias.onnx";
 
@@ -4422,6 +4588,30 @@ TEST_F(GraphTransformationTests, GeluFusionTest) {
   ASSERT_TRUE(op_to_count["com.microsoft.Gelu"] == 1);
 }
 
+TEST_F(GraphTransformationTests, GeluFusionTestJsEp) {
+  constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/gelu.onnx";
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, p_model, nullptr, *logger_));
+  Graph& graph = p_model->MainGraph();
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kJsExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  const InlinedHashSet<std::string_view> js_ep = {kJsExecutionProvider};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<GeluFusion>(js_ep), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Erf"] == 0);
+  ASSERT_TRUE(op_to_count["com.microsoft.Gelu"] == 1);
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Gelu") {
+      EXPECT_EQ(node.GetExecutionProviderType(), kJsExecutionProvider);
+    }
+  }
+}
+
 TEST_F(GraphTransformationTests, GeluFusionTestSwitchOrderFormat2) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/gelu_format2_0.onnx";
   std::shared_ptr<Model> p_model;
@@ -5169,6 +5359,393 @@ TEST_F(GraphTransformationTests, QuickGelu) {
   }
 }
 
+TEST_F(GraphTransformationTests, ElementwiseFusion) {
+  // Mul(2, Sigmoid(Add(x, b))) becomes a single FusedElementwise node.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 3, 4}});
+      auto* bias_arg = builder.MakeInitializer<float>({2, 3, 4}, -1.f, 1.f);
+      auto* scale_arg = builder.MakeInitializer<float>({}, {2.f});
+      auto* add_out = builder.MakeIntermediate();
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+      builder.AddNode("Mul", {scale_arg, sigmoid_out}, {mul_out});
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+      for (auto& node : graph.Nodes()) {
+        if (node.OpType() == "FusedElementwise") {
+          const auto& attrs = node.GetAttributes();
+          TEST_RETURN_IF_NOT(attrs.at("ops").strings_size() == 3);
+          TEST_RETURN_IF_NOT(attrs.at("ops").strings(0) == "Add");
+          TEST_RETURN_IF_NOT(attrs.at("ops").strings(1) == "Sigmoid");
+          TEST_RETURN_IF_NOT(attrs.at("ops").strings(2) == "Mul");
+          // The scale is the left input of the Mul.
+          TEST_RETURN_IF_NOT(attrs.at("operand_positions").ints(2) == 1);
+          TEST_RETURN_IF_NOT(node.InputDefs().size() == 3);
+        }
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<ElementwiseFusion>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  }
+
+  // The output of the Sigmoid is also consumed by another node, so only Add and Sigmoid are fused.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 3, 4}});
+      auto* bias_arg = builder.MakeInitializer<float>({}, {0.5f});
+      auto* add_out = builder.MakeIntermediate();
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeOutput();
+      auto* identity_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+      builder.AddNode("Mul", {sigmoid_out, input_arg}, {mul_out});
+      builder.AddNode("Identity", {sigmoid_out}, {identity_out});
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<ElementwiseFusion>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  }
+
+  // The operand of the Mul broadcasts the intermediate result, so the Mul is not fused.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{3, 4}});
+      auto* other_arg = builder.MakeInput<float>({{2, 3, 4}});
+      auto* tanh_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeOutput();
+
+      builder.AddNode("Tanh", {input_arg}, {tanh_out});
+      builder.AddNode("Mul", {tanh_out, other_arg}, {mul_out});
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["Tanh"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 0);
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<ElementwiseFusion>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  }
+}
+
+// x * cos + rotate_half(x) * sin of the Hugging Face Llama export, with caches of shape (max_sequence_length,
+// head_size) whose halves are equal.
+TEST_F(GraphTransformationTests, RotaryEmbeddingFusion) {
+  constexpr int64_t max_sequence_length = 16;
+  constexpr int64_t head_size = 8;
+  std::vector<float> cos_cache(max_sequence_length * head_size);
+  std::vector<float> sin_cache(max_sequence_length * head_size);
+  for (int64_t position = 0; position < max_sequence_length; ++position) {
+    for (int64_t i = 0; i < head_size / 2; ++i) {
+      const float angle = static_cast<float>(position) * std::pow(10000.0f, -2.0f * i / head_size);
+      cos_cache[position * head_size + i] = cos_cache[position * head_size + i + head_size / 2] = std::cos(angle);
+      sin_cache[position * head_size + i] = sin_cache[position * head_size + i + head_size / 2] = std::sin(angle);
+    }
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4, 3, head_size}, -1.0f, 1.0f);
+    auto* position_ids_arg = builder.MakeInput<int64_t>({2, 3}, int64_t{0}, max_sequence_length);
+    auto* cos_cache_arg = builder.MakeInitializer<float>({max_sequence_length, head_size}, cos_cache);
+    auto* sin_cache_arg = builder.MakeInitializer<float>({max_sequence_length, head_size}, sin_cache);
+    auto* axis_arg = builder.MakeInitializer<int64_t>({1}, {-1});
+    auto* cos_gather_out = builder.MakeIntermediate();
+    auto* sin_gather_out = builder.MakeIntermediate();
+    auto* cos_out = builder.MakeIntermediate();
+    auto* sin_out = builder.MakeIntermediate();
+    auto* x1_out = builder.MakeIntermediate();
+    auto* x2_out = builder.MakeIntermediate();
+    auto* neg_out = builder.MakeIntermediate();
+    auto* rotated_out = builder.MakeIntermediate();
+    auto* x_cos_out = builder.MakeIntermediate();
+    auto* rotated_sin_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Gather", {cos_cache_arg, position_ids_arg}, {cos_gather_out});
+    builder.AddNode("Gather", {sin_cache_arg, position_ids_arg}, {sin_gather_out});
+    builder.AddNode("Unsqueeze", {cos_gather_out, builder.MakeInitializer<int64_t>({1}, {1})}, {cos_out});
+    builder.AddNode("Unsqueeze", {sin_gather_out, builder.MakeInitializer<int64_t>({1}, {1})}, {sin_out});
+    builder.AddNode("Slice", {input_arg, builder.MakeInitializer<int64_t>({1}, {0}),
+                              builder.MakeInitializer<int64_t>({1}, {head_size / 2}), axis_arg},
+                    {x1_out});
+    builder.AddNode("Slice", {input_arg, builder.MakeInitializer<int64_t>({1}, {head_size / 2}),
+                              builder.MakeInitializer<int64_t>({1}, {std::numeric_limits<int64_t>::max()}), axis_arg},
+                    {x2_out});
+    builder.AddNode("Neg", {x2_out}, {neg_out});
+    builder.AddNode("Concat", {neg_out, x1_out}, {rotated_out}).AddAttribute("axis", int64_t{-1});
+    builder.AddNode("Mul", {input_arg, cos_out}, {x_cos_out});
+    builder.AddNode("Mul", {rotated_out, sin_out}, {rotated_sin_out});
+    builder.AddNode("Add", {x_cos_out, rotated_sin_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.RotaryEmbedding"], 1);
+    EXPECT_EQ(op_to_count["Gather"], 0);
+    EXPECT_EQ(op_to_count["Unsqueeze"], 0);
+    EXPECT_EQ(op_to_count["Slice"], 0);
+    EXPECT_EQ(op_to_count["Neg"], 0);
+    EXPECT_EQ(op_to_count["Concat"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-5 /*per_sample_tolerance*/, 1e-5 /*relative_per_sample_tolerance*/,
+                    std::make_unique<RotaryEmbeddingFusion>());
+}
+
+// ReduceSum/ReduceMean(Gather(weight, indices), axes=[1], keepdims=0) of the recommendation model exports.
+TEST_F(GraphTransformationTests, EmbeddingBagFusion) {
+  for (const char* reduce_op : {"ReduceSum", "ReduceMean"}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* weight_arg = builder.MakeInitializer<float>({16, 8}, -1.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4, 3}, int64_t{0}, int64_t{15});
+      auto* gather_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Gather", {weight_arg, indices_arg}, {gather_out});
+      builder.AddNode(reduce_op, {gather_out, builder.MakeInitializer<int64_t>({1}, {1})}, {output_arg})
+          .AddAttribute("keepdims", int64_t{0});
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.EmbeddingBag"], 1);
+      EXPECT_EQ(op_to_count["Gather"], 0);
+      EXPECT_EQ(op_to_count[reduce_op], 0);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 18,
+                      1e-5 /*per_sample_tolerance*/, 1e-5 /*relative_per_sample_tolerance*/,
+                      std::make_unique<EmbeddingBagFusion>());
+  }
+}
+
+#if !defined(DISABLE_CONTRIB_OPS)
+// Decomposed group normalization of the exported diffusion models, with C = 8 channels in G = 4 groups:
+//   Reshape(X, (0, G, -1)) -> InstanceNormalization -> Reshape(Shape(X) or (0, C, H, W)) -> Mul(gamma) -> Add(beta)
+// optionally followed by SiLU. gamma and beta have the shape (C, 1, 1) or (1, C, 1, 1).
+static void BuildGroupNormTestCase(ModelTestBuilder& builder, NodeArg* input_arg, bool shape_from_input, bool silu,
+                                   int64_t gamma_rank, float norm_scale = 1.0f, float norm_bias = 0.0f) {
+  const std::vector<int64_t> channel_shape = gamma_rank == 4 ? std::vector<int64_t>{1, 8, 1, 1}
+                                                             : std::vector<int64_t>{8, 1, 1};
+  auto* group_shape_arg = builder.MakeInitializer<int64_t>({3}, {0, 4, -1});
+  auto* norm_scale_arg = builder.MakeInitializer<float>({4}, std::vector<float>(4, norm_scale));
+  auto* norm_bias_arg = builder.MakeInitializer<float>({4}, std::vector<float>(4, norm_bias));
+  auto* gamma_arg = builder.MakeInitializer<float>(channel_shape, 0.5f, 1.5f);
+  auto* beta_arg = builder.MakeInitializer<float>(channel_shape, -0.5f, 0.5f);
+  auto* reshape_in_out = builder.MakeIntermediate();
+  auto* norm_out = builder.MakeIntermediate();
+  auto* reshape_out_out = builder.MakeIntermediate();
+  auto* mul_out = builder.MakeIntermediate();
+
+  NodeArg* input_shape_arg = nullptr;
+  if (shape_from_input) {
+    input_shape_arg = builder.MakeIntermediate();
+    builder.AddNode("Shape", {input_arg}, {input_shape_arg});
+  } else {
+    input_shape_arg = builder.MakeInitializer<int64_t>({4}, {0, 8, 4, 4});
+  }
+
+  builder.AddNode("Reshape", {input_arg, group_shape_arg}, {reshape_in_out});
+  builder.AddNode("InstanceNormalization", {reshape_in_out, norm_scale_arg, norm_bias_arg}, {norm_out})
+      .AddAttribute("epsilon", 1e-6f);
+  builder.AddNode("Reshape", {norm_out, input_shape_arg}, {reshape_out_out});
+  builder.AddNode("Mul", {reshape_out_out, gamma_arg}, {mul_out});
+
+  if (silu) {
+    auto* add_out = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeIntermediate();
+    builder.AddNode("Add", {mul_out, beta_arg}, {add_out});
+    builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+    builder.AddNode("Mul", {add_out, sigmoid_out}, {builder.MakeOutput()});
+  } else {
+    builder.AddNode("Add", {beta_arg, mul_out}, {builder.MakeOutput()});
+  }
+}
+
+TEST_F(GraphTransformationTests, GroupNormFusion) {
+  for (bool shape_from_input : {false, true}) {
+    for (bool silu : {false, true}) {
+      for (int64_t gamma_rank : {3, 4}) {
+        auto build_test_case = [&](ModelTestBuilder& builder) {
+          auto* input_arg = builder.MakeInput<float>({2, 8, 4, 4}, -1.0f, 1.0f);
+          BuildGroupNormTestCase(builder, input_arg, shape_from_input, silu, gamma_rank);
+        };
+
+        auto check_graph = [&](InferenceSessionWrapper& session) {
+          auto op_to_count = CountOpsInGraph(session.GetGraph());
+          EXPECT_EQ(op_to_count["com.microsoft.GroupNorm"], 1);
+          EXPECT_EQ(op_to_count["InstanceNormalization"], 0);
+          EXPECT_EQ(op_to_count["Reshape"], 0);
+          EXPECT_EQ(op_to_count["Mul"], 0);
+          EXPECT_EQ(op_to_count["Add"], 0);
+          EXPECT_EQ(op_to_count["Sigmoid"], 0);
+
+          for (const auto& node : session.GetGraph().Nodes()) {
+            if (node.OpType() == "GroupNorm") {
+              EXPECT_EQ(node.GetAttributes().at("groups").i(), 4);
+              EXPECT_EQ(node.GetAttributes().at("epsilon").f(), 1e-6f);
+              EXPECT_EQ(node.GetAttributes().at("activation").i(), silu ? 1 : 0);
+              EXPECT_EQ(node.GetAttributes().at("channels_last").i(), 0);
+            }
+          }
+        };
+
+        TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 18,
+                          1e-5 /*per_sample_tolerance*/, 1e-5 /*relative_per_sample_tolerance*/,
+                          std::make_unique<GroupNormFusion>());
+      }
+    }
+  }
+}
+
+// Shape(X) is not constant folded when the batch dimension is symbolic. It only fed the fused Reshape, so it is
+// removed along with the fused nodes.
+TEST_F(GraphTransformationTests, GroupNormFusionRemovesShapeOfInput) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", 8, 4, 4});
+    BuildGroupNormTestCase(builder, input_arg, true /*shape_from_input*/, true /*silu*/, 3 /*gamma_rank*/);
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Shape"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GroupNorm"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Shape"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Reshape"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == 0);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "GroupNorm") {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("activation").i() == 1);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("channels_last").i() == 0);
+        for (int i = 1; i < 3; i++) {
+          const ONNX_NAMESPACE::TensorProto* channel_initializer =
+              graph_utils::GetConstantInitializer(graph, node.InputDefs()[i]->Name());
+          TEST_RETURN_IF_NOT(channel_initializer != nullptr);
+          TEST_RETURN_IF_NOT(channel_initializer->dims_size() == 1 && channel_initializer->dims(0) == 8);
+        }
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 18, *logger_, std::make_unique<GroupNormFusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+// InstanceNormalization with an affine transform of its own is not a plain group normalization.
+TEST_F(GraphTransformationTests, GroupNormFusionNotAppliedWithNormalizationScaleOrBias) {
+  for (const auto& norm_scale_and_bias : {std::pair{2.0f, 0.0f}, std::pair{1.0f, 0.5f}}) {
+    const float norm_scale = norm_scale_and_bias.first;
+    const float norm_bias = norm_scale_and_bias.second;
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({2, 8, 4, 4}, -1.0f, 1.0f);
+      BuildGroupNormTestCase(builder, input_arg, false /*shape_from_input*/, false /*silu*/, 3 /*gamma_rank*/,
+                             norm_scale, norm_bias);
+    };
+
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GroupNorm"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["InstanceNormalization"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["Reshape"] == 2);
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 18, *logger_, std::make_unique<GroupNormFusion>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  }
+}
+#endif
+
+#if !defined(DISABLE_CONTRIB_OPS)
+TEST_F(GraphTransformationTests, MatMulNBitsWeightQuantization) {
+  constexpr int64_t K = 48;
+  constexpr int64_t N = 8;
+
+  // The values of each block of 16 rows of a column are (q - 8) / 8 for q in 0..15, which the blockwise quantization
+  // represents exactly, so the quantized model computes the same values.
+  std::vector<float> weight(K * N);
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      weight[k * N + n] = static_cast<float>((k + 3 * n) % 16 - 8) / 8.0f;
+    }
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 3, K}, -1.0f, 1.0f);
+    auto* excluded_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* excluded_weight_arg = builder.MakeInitializer<float>({K, K}, -0.1f, 0.1f);
+    auto* weight_arg = builder.MakeInitializer<float>({K, N}, weight);
+
+    // ModelTestBuilder names its first node "node", which is excluded
+    builder.AddNode("MatMul", {input_arg, excluded_weight_arg}, {excluded_out});
+    builder.AddNode("MatMul", {excluded_out, weight_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 1);
+
+    for (const auto& node : session.GetGraph().Nodes()) {
+      if (node.OpType() == "MatMulNBits") {
+        EXPECT_EQ(node.GetAttributes().at("K").i(), K);
+        EXPECT_EQ(node.GetAttributes().at("N").i(), N);
+        EXPECT_EQ(node.GetAttributes().at("block_size").i(), 16);
+      }
+    }
+  };
+
+  auto add_session_options = [](SessionOptions& session_options) {
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+        kOrtSessionOptionsMatMulNBitsWeightQuantization, "1"));
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+        kOrtSessionOptionsMatMulNBitsWeightQuantizationBlockSize, "16"));
+    ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+        kOrtSessionOptionsMatMulNBitsWeightQuantizationExcludedNodes, "node"));
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5 /*per_sample_tolerance*/, 1e-5 /*relative_per_sample_tolerance*/,
+                    nullptr, add_session_options);
+}
+#endif
+
 struct BiasSoftmaxFusionTester {
   std::shared_ptr<Model> p_model_;
   Status model_load_;
@@ -5197,7 +5774,7 @@ struct BiasSoftmaxFusionTester {
       const char* execution_provider = kCudaExecutionProvider) : logger_(logger), graph_transformation_mgr_{5} {
     model_load_ = Model::Load(model_uri, p_model_, nullptr, *logger_);
 
-    // move to cuda since fusion only takes place in that case
+    // assign the nodes to the EP the fusion is tested for
     SetExecutionProvider(execution_provider);
 
     ORT_THROW_IF_ERROR(graph_transformation_mgr_.Register(
@@ -5240,10 +5817,10 @@ struct BiasSoftmaxFusionTester {
   }
 };
 
-TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_GpuOnly) {
+TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_Simple_Cpu) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/bias_softmax_fusion_simple.onnx";
   BiasSoftmaxFusionTester tester(model_uri, logger_.get(), kCpuExecutionProvider);
-  tester.TestNoFusionOccurs();
+  tester.TestFusionOccurs(1, true);
 }
 
 TEST_F(GraphTransformationTests, BiasSoftmaxFusionTest_Simple_Rocm) {
@@ -5699,6 +6276,66 @@ TEST_F(GraphTransformationTests, MatMulIntegerToFloat16Test) {
 
 #endif
 
+#if !defined(DISABLE_CONTRIB_OPS) && !defined(DISABLE_FLOAT8_TYPES)
+TEST_F(GraphTransformationTests, GemmFloat8Fusion) {
+  constexpr int64_t M = 4, K = 3, N = 2;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    std::vector<Float8E4M3FN> b_data;
+    for (int64_t i = 0; i < K * N; ++i) {
+      b_data.push_back(Float8E4M3FN(static_cast<float>(i)));
+    }
+    auto* a_arg = builder.MakeInput<Float8E4M3FN>({{M, K}});
+    auto* b_arg = builder.MakeInitializer<Float8E4M3FN>({K, N}, b_data);
+    auto* a_scale_arg = builder.MakeInitializer<float>({}, {0.5f});
+    auto* b_scale_arg = builder.MakeInitializer<float>({}, {0.25f});
+    auto* dq_a_output = builder.MakeIntermediate();
+    auto* dq_b_output = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("DequantizeLinear", {a_arg, a_scale_arg}, {dq_a_output});
+    builder.AddNode("DequantizeLinear", {b_arg, b_scale_arg}, {dq_b_output});
+    builder.AddNode("MatMul", {dq_a_output, dq_b_output}, {output_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    for (auto& node : graph.Nodes()) {
+      node.SetExecutionProviderType(kCudaExecutionProvider);
+    }
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["DequantizeLinear"] == 2);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "GemmFloat8") {
+        // B is transposed to (N, K) since float 8 GEMMs require transB=1.
+        const ONNX_NAMESPACE::TensorProto* b_t = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+        TEST_RETURN_IF_NOT(b_t != nullptr);
+        TEST_RETURN_IF_NOT(b_t->dims(0) == N && b_t->dims(1) == K);
+        std::vector<uint8_t> b_t_data;
+        ORT_RETURN_IF_ERROR(utils::UnpackInitializerData(*b_t, b_t_data));
+        for (int64_t n = 0; n < N; ++n) {
+          for (int64_t k = 0; k < K; ++k) {
+            TEST_RETURN_IF_NOT(b_t_data[n * K + k] == Float8E4M3FN(static_cast<float>(k * N + n)).val);
+          }
+        }
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 19, *logger_,
+                                        std::make_unique<GemmFloat8Fusion>(
+                                            InlinedHashSet<std::string_view>{kCudaExecutionProvider}),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+#endif  // !defined(DISABLE_CONTRIB_OPS) && !defined(DISABLE_FLOAT8_TYPES)
+
 #ifndef DISABLE_CONTRIB_OPS
 template <typename GraphTransformationCheckFn, typename GraphPreprocessFn>
 static void TestMatMulScaleFusion(
@@ -706,6 +706,70 @@ TEST(QDQTransformerTests, MatMul_S8S8U8) {
   QDQTransformerMatMulTests<int8_t, int8_t, uint8_t>(true);
 }
 
+// 16-bit activations with 8-bit weights are replaced with MatMulIntegerToFloat, a Q of the output is kept.
+template <typename Input1Type, typename Input2Type>
+void QDQTransformerMatMul16BitActivationTests(bool has_output_q) {
+  auto test_case = [&](const std::vector<int64_t>& input1_shape, const std::vector<int64_t>& input2_shape) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input1_arg = builder.MakeInput<float>(input1_shape, -1.f, 1.f);
+      auto* input2_arg = builder.MakeInput<float>(input2_shape, -1.f, 1.f);
+      auto* output_arg = builder.MakeOutput();
+
+      typedef std::numeric_limits<Input1Type> Input1Limits;
+      typedef std::numeric_limits<Input2Type> Input2Limits;
+      const Input1Type input1_zp = static_cast<Input1Type>((Input1Limits::max() + Input1Limits::min()) / 2 + 1);
+      const Input2Type input2_zp = static_cast<Input2Type>((Input2Limits::max() + Input2Limits::min()) / 2 + 1);
+
+      auto* dq1_output = AddQDQNodePair<Input1Type>(builder, input1_arg, .0001f, input1_zp, true);
+      auto* dq2_output = AddQDQNodePair<Input2Type>(builder, input2_arg, .008f, input2_zp, true);
+
+      if (has_output_q) {
+        auto* matmul_op_output = builder.MakeIntermediate();
+        builder.AddNode("MatMul", {dq1_output, dq2_output}, {matmul_op_output});
+
+        auto* q3_output = builder.MakeIntermediate();
+        builder.AddQuantizeLinearNode<uint8_t>(matmul_op_output, .02f, 128, q3_output, true);
+        builder.AddDequantizeLinearNode<uint8_t>(q3_output, .02f, 128, output_arg, true);
+      } else {
+        builder.AddNode("MatMul", {dq1_output, dq2_output}, {output_arg});
+      }
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      const QDQOpKeys qdq_keys = GetQDQOpKeys(true);
+      EXPECT_EQ(op_to_count["com.microsoft.MatMulIntegerToFloat"], 1);
+      EXPECT_EQ(op_to_count["QLinearMatMul"], 0);
+      EXPECT_EQ(op_to_count["MatMul"], 0);
+      EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], has_output_q ? 3 : 2);
+      EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], has_output_q ? 1 : 0);
+    };
+
+    TransformerTester(build_test_case,
+                      check_graph,
+                      TransformerLevel::Level1,
+                      TransformerLevel::Level2,
+                      18 /*opset_version*/,
+                      0.03 /*per_sample_tolerance*/,
+                      0.03 /*relative_per_sample_tolerance*/,
+                      std::make_unique<QDQSelectorActionTransformer>(QDQIsInt8Allowed()));
+  };
+
+  test_case({1, 2, 2}, {1, 2, 4});
+  test_case({1, 23, 13, 13}, {13, 13});
+  test_case({1, 5, 64}, {64, 37});
+}
+
+TEST(QDQTransformerTests, MatMul_S16S8) {
+  QDQTransformerMatMul16BitActivationTests<int16_t, int8_t>(false);
+  QDQTransformerMatMul16BitActivationTests<int16_t, int8_t>(true);
+}
+
+TEST(QDQTransformerTests, MatMul_U16U8) {
+  QDQTransformerMatMul16BitActivationTests<uint16_t, uint8_t>(false);
+  QDQTransformerMatMul16BitActivationTests<uint16_t, uint8_t>(true);
+}
+
 template <typename Input1Type, typename Input2Type, typename OutputType, typename BiasType = int32_t>
 void QDQTransformerGemmTests(bool has_output_q, bool has_bias, bool beta_not_one = false) {
   auto test_case = [&](const std::vector<int64_t>& input1_shape, const std::vector<int64_t>& input2_shape,
@@ -2198,6 +2262,157 @@ TEST(QDQTransformerTests, Sigmoid_U8S8) {
   QDQTransformerSigmoidTests<uint8_t, int8_t>();
 }
 
+template <typename InputType, typename OutputType>
+void QDQTransformerGeluTests() {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, bool use_contrib_qdq, bool use_onnx_gelu) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.f, 1.f);
+      auto* output_arg = builder.MakeOutput();
+      // add QDQ + Gelu
+      auto* dq_output = AddQDQNodePair<InputType>(builder, input_arg, .0035f, 7, use_contrib_qdq);
+      auto* gelu_output = builder.MakeIntermediate();
+      if (use_onnx_gelu) {
+        Node& gelu_node = builder.AddNode("Gelu", {dq_output}, {gelu_output});
+        gelu_node.AddAttribute("approximate", "tanh");
+      } else {
+        builder.AddNode("Gelu", {dq_output}, {gelu_output}, kMSDomain);
+      }
+
+      // add QDQ output
+      auto* q_output = builder.MakeIntermediate();
+      builder.AddQuantizeLinearNode<OutputType>(gelu_output,
+                                                .0038f,
+                                                std::numeric_limits<OutputType>::max() / 2,
+                                                q_output, use_contrib_qdq);
+      builder.AddDequantizeLinearNode<OutputType>(q_output,
+                                                  .0039f,
+                                                  std::numeric_limits<OutputType>::max() / 2,
+                                                  output_arg, use_contrib_qdq);
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      const QDQOpKeys qdq_keys = GetQDQOpKeys(use_contrib_qdq);
+      const std::string gelu_key = use_onnx_gelu ? "Gelu" : "com.microsoft.Gelu";
+      if constexpr (std::is_same<InputType, OutputType>::value) {
+        EXPECT_EQ(op_to_count["com.microsoft.QLinearGelu"], 1);
+        EXPECT_EQ(op_to_count[gelu_key], 0);
+        EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 1);
+        EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 1);
+      } else {
+        EXPECT_EQ(op_to_count["com.microsoft.QLinearGelu"], 0);
+        EXPECT_EQ(op_to_count[gelu_key], 1);
+        EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 2);
+        EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 2);
+      }
+    };
+
+    for (int opset : use_onnx_gelu ? std::vector<int>{20} : std::vector<int>{12, 19}) {
+      TransformerTester(build_test_case,
+                        check_graph,
+                        TransformerLevel::Level1,
+                        TransformerLevel::Level2,
+                        opset,
+                        0.01 /*per_sample_tolerance*/,
+                        0.01 /*relative_per_sample_tolerance*/,
+                        std::make_unique<QDQSelectorActionTransformer>(QDQIsInt8Allowed()));
+    }
+  };
+
+  test_case({1, 12, 37}, false /*use_contrib_qdq*/, false /*use_onnx_gelu*/);
+  test_case({1, 12, 37}, true /*use_contrib_qdq*/, false /*use_onnx_gelu*/);
+  test_case({1, 23, 13, 13}, false /*use_contrib_qdq*/, true /*use_onnx_gelu*/);
+}
+
+TEST(QDQTransformerTests, Gelu_S8S8) {
+  QDQTransformerGeluTests<int8_t, int8_t>();
+}
+
+TEST(QDQTransformerTests, Gelu_U8U8) {
+  QDQTransformerGeluTests<uint8_t, uint8_t>();
+}
+
+TEST(QDQTransformerTests, Gelu_S8U8) {
+  QDQTransformerGeluTests<int8_t, uint8_t>();
+}
+
+template <typename T>
+void QDQTransformerLayerNormTests() {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, bool has_bias, bool quantize_scale) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      const int64_t hidden_size = input_shape.back();
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.f, 1.f);
+      auto* output_arg = builder.MakeOutput();
+      // add QDQ + LayerNormalization
+      auto* dq_output = AddQDQNodePair<T>(builder, input_arg, .0035f, 7);
+      NodeArg* scale_arg = nullptr;
+      if (quantize_scale) {
+        scale_arg = builder.MakeIntermediate();
+        builder.AddDequantizeLinearNode<T>(builder.MakeInitializer<T>({hidden_size}, T(1), T(100)),
+                                           .01f, T(0), scale_arg);
+      } else {
+        scale_arg = builder.MakeInitializer<float>({hidden_size}, .5f, 1.5f);
+      }
+      std::vector<NodeArg*> layer_norm_inputs{dq_output, scale_arg};
+      if (has_bias) {
+        layer_norm_inputs.push_back(builder.MakeInitializer<float>({hidden_size}, -.5f, .5f));
+      }
+      auto* layer_norm_output = builder.MakeIntermediate();
+      Node& layer_norm_node = builder.AddNode("LayerNormalization", layer_norm_inputs, {layer_norm_output});
+      layer_norm_node.AddAttribute("epsilon", 1e-5f);
+
+      // add QDQ output
+      auto* q_output = builder.MakeIntermediate();
+      builder.AddQuantizeLinearNode<T>(layer_norm_output, .02f, std::numeric_limits<T>::max() / 2, q_output);
+      builder.AddDequantizeLinearNode<T>(q_output, .02f, std::numeric_limits<T>::max() / 2, output_arg);
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      const QDQOpKeys qdq_keys = GetQDQOpKeys(false);
+      if (quantize_scale) {
+        EXPECT_EQ(op_to_count["com.microsoft.QLinearLayerNormalization"], 0);
+        EXPECT_EQ(op_to_count["LayerNormalization"], 1);
+      } else {
+        EXPECT_EQ(op_to_count["com.microsoft.QLinearLayerNormalization"], 1);
+        EXPECT_EQ(op_to_count["LayerNormalization"], 0);
+        EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 1);
+        EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 1);
+      }
+    };
+
+    TransformerTester(build_test_case,
+                      check_graph,
+                      TransformerLevel::Level1,
+                      TransformerLevel::Level2,
+                      17 /*opset_version*/,
+                      0.03 /*per_sample_tolerance*/,
+                      0.03 /*relative_per_sample_tolerance*/,
+                      std::make_unique<QDQSelectorActionTransformer>(QDQIsInt8Allowed()));
+    TransformerTester(build_test_case,
+                      check_graph,
+                      TransformerLevel::Level1,
+                      TransformerLevel::Level2,
+                      19 /*opset_version*/,
+                      0.03 /*per_sample_tolerance*/,
+                      0.03 /*relative_per_sample_tolerance*/,
+                      std::make_unique<QDQSelectorActionTransformer>(QDQIsInt8Allowed()));
+  };
+
+  test_case({2, 8, 64}, true /*has_bias*/, false /*quantize_scale*/);
+  test_case({2, 8, 64}, false /*has_bias*/, false /*quantize_scale*/);
+  test_case({1, 5, 768}, true /*has_bias*/, false /*quantize_scale*/);
+  test_case({2, 8, 64}, true /*has_bias*/, true /*quantize_scale*/);
+}
+
+TEST(QDQTransformerTests, LayerNorm_S8S8) {
+  QDQTransformerLayerNormTests<int8_t>();
+}
+
+TEST(QDQTransformerTests, LayerNorm_U8U8) {
+  QDQTransformerLayerNormTests<uint8_t>();
+}
+
 TEST(QDQTransformerTests, ConvTranspose_QBackward) {
   auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
                        const std::vector<int64_t>& perms, bool use_contrib_qdq) {
@@ -59,6 +59,51 @@ TEST(RuleBasedGraphTransformerTest, TestCompatibleProviders) {
   ASSERT_TRUE(dummy_rule1_ptr->IsRewriteRuleInvoked());
 }
 
+namespace {
+// Reports a modification on its first num_modifications invocations and counts how often it is invoked.
+class CountingGraphTransformer : public GraphTransformer {
+ public:
+  CountingGraphTransformer(const std::string& name, int num_modifications)
+      : GraphTransformer(name), num_modifications_(num_modifications) {}
+
+  int NumInvocations() const { return num_invocations_; }
+
+ private:
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/, const logging::Logger&) const override {
+    modified = num_invocations_++ < num_modifications_;
+    return Status::OK();
+  }
+
+  int num_modifications_;
+  mutable int num_invocations_ = 0;
+};
+}  // namespace
+
+TEST(RuleBasedGraphTransformerTest, TestGraphTransformerManagerSkipsUnchangedTransformers) {
+  auto model_uri = ORT_TSTR("testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx");
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  Graph& graph = model->MainGraph();
+
+  auto modifying_transformer = std::make_unique<CountingGraphTransformer>("Modifying", 2);
+  const auto* modifying_transformer_ptr = modifying_transformer.get();
+  auto unchanged_transformer = std::make_unique<CountingGraphTransformer>("Unchanged", 0);
+  const auto* unchanged_transformer_ptr = unchanged_transformer.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(modifying_transformer), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(unchanged_transformer), TransformerLevel::Level2));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2,
+                                                              DefaultLoggingManager().DefaultLogger()));
+
+  // The first transformer modifies the graph in steps 0 and 1 and finds nothing to do in step 2.
+  // The second one runs after each modification, but is skipped in step 2 as the graph has not changed since.
+  ASSERT_EQ(modifying_transformer_ptr->NumInvocations(), 3);
+  ASSERT_EQ(unchanged_transformer_ptr->NumInvocations(), 2);
+}
+
 TEST(RuleBasedGraphTransformerTest, TestSettingStepsInGraphTransformerManager) {
   // steps provided at object construction time
   onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
@@ -0,0 +1,369 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "benchmark_record.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "nlohmann/json.hpp"
+
+#include <core/common/cpuid_info.h>
+#include <core/platform/env.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include "performance_runner.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+constexpr int kSchemaVersion = 1;
+// the significance level of the latency test, low enough that a regression run over the model zoo rarely flags noise
+constexpr double kSignificanceLevel = 0.01;
+
+const char* OperatingSystem() {
+#if defined(_WIN32)
+  return "windows";
+#elif defined(__APPLE__)
+  return "macos";
+#elif defined(__ANDROID__)
+  return "android";
+#elif defined(__linux__)
+  return "linux";
+#else
+  return "unknown";
+#endif
+}
+
+const char* Architecture() {
+#if defined(_M_X64) || defined(__x86_64__)
+  return "x86_64";
+#elif defined(_M_IX86) || defined(__i386__)
+  return "x86";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+  return "arm64";
+#elif defined(_M_ARM) || defined(__arm__)
+  return "arm";
+#else
+  return "unknown";
+#endif
+}
+
+std::string Compiler() {
+  std::ostringstream ss;
+#if defined(__clang__)
+  ss << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined(__GNUC__)
+  ss << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+#elif defined(_MSC_VER)
+  ss << "msvc " << _MSC_FULL_VER;
+#else
+  ss << "unknown";
+#endif
+  return ss.str();
+}
+
+std::string CpuModelName() {
+#if defined(__linux__)
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      const auto colon = line.find(':');
+      if (colon != std::string::npos && colon + 2 <= line.size()) {
+        return line.substr(colon + 2);
+      }
+    }
+  }
+#endif
+  return "unknown";
+}
+
+std::vector<std::string> CpuFeatures() {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  const std::pair<const char*, bool> features[] = {
+      {"sse3", cpuid_info.HasSSE3()},
+      {"sse4_1", cpuid_info.HasSSE4_1()},
+      {"avx", cpuid_info.HasAVX()},
+      {"avx2", cpuid_info.HasAVX2()},
+      {"f16c", cpuid_info.HasF16C()},
+      {"avx512f", cpuid_info.HasAVX512f()},
+      {"avx512_skylake", cpuid_info.HasAVX512Skylake()},
+      {"avx512_bf16", cpuid_info.HasAVX512_BF16()},
+      {"amx_bf16", cpuid_info.HasAMX_BF16()},
+      {"neon_dot", cpuid_info.HasArmNeonDot()},
+      {"neon_i8mm", cpuid_info.HasArmNeon_I8MM()},
+      {"sve_i8mm", cpuid_info.HasArmSVE_I8MM()},
+      {"neon_bf16", cpuid_info.HasArmNeon_BF16()},
+      {"hybrid", cpuid_info.IsHybrid()},
+  };
+  std::vector<std::string> names;
+  for (const auto& [name, supported] : features) {
+    if (supported) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+// FNV-1a, which unlike std::hash gives the same fingerprint with every standard library
+std::string Fingerprint(const std::string& value) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : value) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+  return hex;
+}
+
+nlohmann::json HardwareRecord() {
+  nlohmann::json hardware;
+  hardware["os"] = OperatingSystem();
+  hardware["arch"] = Architecture();
+  hardware["cpu"] = CpuModelName();
+  hardware["physical_cores"] = Env::Default().GetNumPhysicalCpuCores();
+  hardware["logical_cores"] = std::thread::hardware_concurrency();
+  hardware["cpu_features"] = CpuFeatures();
+  hardware["fingerprint"] = Fingerprint(hardware.dump());
+  return hardware;
+}
+
+nlohmann::json BuildRecord() {
+  nlohmann::json build;
+  build["version"] = Ort::GetVersionString();
+  build["build_info"] = Ort::GetBuildInfoString();
+  build["compiler"] = Compiler();
+#ifdef NDEBUG
+  build["debug"] = false;
+#else
+  build["debug"] = true;
+#endif
+  build["providers"] = Ort::GetAvailableProviders();
+  return build;
+}
+
+nlohmann::json ConfigRecord(const PerformanceTestConfig& config) {
+  const auto& run_config = config.run_config;
+  nlohmann::json record;
+  record["intra_op_num_threads"] = run_config.intra_op_num_threads;
+  record["inter_op_num_threads"] = run_config.inter_op_num_threads;
+  record["execution_mode"] = run_config.execution_mode == ExecutionMode::ORT_PARALLEL ? "parallel" : "sequential";
+  record["optimization_level"] = static_cast<int>(run_config.optimization_level);
+  record["concurrent_session_runs"] = run_config.concurrent_session_runs;
+  record["enable_cpu_mem_arena"] = run_config.enable_cpu_mem_arena;
+  record["enable_memory_pattern"] = run_config.enable_memory_pattern;
+  record["generate_model_input_binding"] = run_config.generate_model_input_binding;
+  record["session_config_entries"] = run_config.session_config_entries;
+  return record;
+}
+
+std::vector<double> LatenciesInMilliseconds(const PerformanceResult& result) {
+  std::vector<double> latencies(result.time_costs.size());
+  std::transform(result.time_costs.begin(), result.time_costs.end(), latencies.begin(),
+                 [](double seconds) { return seconds * 1000; });
+  return latencies;
+}
+
+// same rank as PerformanceResult::DumpToFile
+double Percentile(const std::vector<double>& sorted, double fraction) {
+  return sorted[std::min(static_cast<size_t>(sorted.size() * fraction), sorted.size() - 1)];
+}
+
+nlohmann::json LatencyRecord(const std::vector<double>& latencies) {
+  nlohmann::json record;
+  record["count"] = latencies.size();
+  if (latencies.empty()) {
+    return record;
+  }
+
+  std::vector<double> sorted = latencies;
+  std::sort(sorted.begin(), sorted.end());
+  const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+  double sum_of_squares = 0;
+  for (const double latency : sorted) {
+    sum_of_squares += (latency - mean) * (latency - mean);
+  }
+
+  record["mean"] = mean;
+  record["stddev"] = sorted.size() > 1 ? std::sqrt(sum_of_squares / (sorted.size() - 1)) : 0.0;
+  record["min"] = sorted.front();
+  record["p50"] = Percentile(sorted, 0.5);
+  record["p90"] = Percentile(sorted, 0.9);
+  record["p95"] = Percentile(sorted, 0.95);
+  record["p99"] = Percentile(sorted, 0.99);
+  record["max"] = sorted.back();
+  record["samples"] = latencies;
+  return record;
+}
+
+double RelativeChange(double baseline, double value) {
+  return baseline > 0 ? (value - baseline) / baseline : 0.0;
+}
+
+}  // namespace
+
+double MannWhitneyUPValue(const std::vector<double>& x, const std::vector<double>& y) {
+  if (x.empty() || y.empty()) {
+    return 1.0;
+  }
+
+  // rank the values of both, with tied values getting the mean of their ranks
+  std::vector<std::pair<double, bool>> values;  // value, is from x
+  values.reserve(x.size() + y.size());
+  for (const double value : x) {
+    values.emplace_back(value, true);
+  }
+  for (const double value : y) {
+    values.emplace_back(value, false);
+  }
+  std::sort(values.begin(), values.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  const double n1 = static_cast<double>(x.size());
+  const double n2 = static_cast<double>(y.size());
+  const double n = n1 + n2;
+  double rank_sum_x = 0;
+  double tie_correction = 0;
+  for (size_t begin = 0; begin < values.size();) {
+    size_t end = begin + 1;
+    while (end < values.size() && values[end].first == values[begin].first) {
+      ++end;
+    }
+    const double ties = static_cast<double>(end - begin);
+    const double rank = (begin + 1 + end) / 2.0;
+    for (size_t i = begin; i < end; ++i) {
+      if (values[i].second) {
+        rank_sum_x += rank;
+      }
+    }
+    tie_correction += ties * ties * ties - ties;
+    begin = end;
+  }
+
+  const double u = rank_sum_x - n1 * (n1 + 1) / 2;
+  const double variance = n1 * n2 / 12 * ((n + 1) - tie_correction / (n * (n - 1)));
+  if (variance <= 0) {
+    // all the values are equal
+    return 1.0;
+  }
+
+  const double z = (u - n1 * n2 / 2 - 0.5) / std::sqrt(variance);
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+Status WriteBenchmarkRecord(const PerformanceTestConfig& config, const PerformanceResult& result,
+                            const BenchmarkTimings& timings) {
+  const auto& path = config.run_config.benchmark_record_file;
+  std::ofstream outfile(path, std::ofstream::out);
+  if (!outfile.good()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to open benchmark record file '", ToUTF8String(path.c_str()), "'");
+  }
+
+  nlohmann::json record;
+  record["schema_version"] = kSchemaVersion;
+  record["model"] = result.model_name;
+  record["provider"] = config.machine_config.provider_type_name;
+  record["config"] = ConfigRecord(config);
+  record["hardware"] = HardwareRecord();
+  record["build"] = BuildRecord();
+  record["session_creation_ms"] = timings.session_creation_seconds * 1000;
+  record["first_inference_ms"] = timings.first_inference_seconds * 1000;
+  record["latency_ms"] = LatencyRecord(LatenciesInMilliseconds(result));
+  record["memory"]["peak_working_set_bytes"] = result.peak_workingset_size;
+  record["cpu_usage_percent"] = result.average_CPU_usage;
+
+  outfile << record.dump(2) << std::endl;
+  if (!outfile.good()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to write benchmark record file '", ToUTF8String(path.c_str()), "'");
+  }
+  return Status::OK();
+}
+
+Status CompareWithBenchmarkRecord(const PerformanceTestConfig& config, const PerformanceResult& result,
+                                  bool& regressed) {
+  regressed = false;
+  const auto& run_config = config.run_config;
+  const std::string path = ToUTF8String(run_config.baseline_record_file.c_str());
+  std::ifstream infile(run_config.baseline_record_file);
+  if (!infile.good()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to open baseline record file '", path, "'");
+  }
+
+  const auto baseline = nlohmann::json::parse(infile, nullptr, /*allow_exceptions*/ false);
+  if (baseline.is_discarded() || !baseline.is_object()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "baseline record file '", path, "' is not valid JSON");
+  }
+  if (baseline.value("schema_version", 0) != kSchemaVersion) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "baseline record file '", path, "' has schema version ",
+                           baseline.value("schema_version", 0), ", expected ", kSchemaVersion);
+  }
+
+  const auto latency_it = baseline.find("latency_ms");
+  if (latency_it == baseline.end() || !latency_it->contains("samples") || !(*latency_it)["samples"].is_array()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "baseline record file '", path, "' has no latency samples");
+  }
+  const auto baseline_latencies = (*latency_it)["samples"].get<std::vector<double>>();
+  const auto latencies = LatenciesInMilliseconds(result);
+  if (baseline_latencies.empty() || latencies.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "no latencies to compare with the baseline");
+  }
+
+  std::cout << "\nComparison with baseline " << path << ":\n";
+  const auto hardware = HardwareRecord();
+  if (baseline.contains("hardware") && baseline["hardware"].value("fingerprint", "") != hardware["fingerprint"]) {
+    std::cout << "WARNING: the baseline was recorded on other hardware ("
+              << baseline["hardware"].value("cpu", "unknown") << ", "
+              << baseline["hardware"].value("logical_cores", 0) << " logical cores)\n";
+  }
+  if (baseline.value("provider", "") != config.machine_config.provider_type_name ||
+      baseline.value("config", nlohmann::json::object()) != ConfigRecord(config)) {
+    std::cout << "WARNING: the baseline was recorded with another provider or session configuration\n";
+  }
+
+  std::vector<double> sorted_baseline = baseline_latencies;
+  std::vector<double> sorted = latencies;
+  std::sort(sorted_baseline.begin(), sorted_baseline.end());
+  std::sort(sorted.begin(), sorted.end());
+  const double threshold = run_config.regression_threshold;
+
+  const double baseline_p50 = Percentile(sorted_baseline, 0.5);
+  const double p50 = Percentile(sorted, 0.5);
+  const double p50_change = RelativeChange(baseline_p50, p50);
+  const double p_value = MannWhitneyUPValue(latencies, baseline_latencies);
+  const bool latency_regressed = p50_change > threshold && p_value < kSignificanceLevel;
+  std::cout << "P50 latency: " << baseline_p50 << " ms -> " << p50 << " ms (" << std::showpos << p50_change * 100
+            << std::noshowpos << "%), p-value of slowdown: " << p_value
+            << (latency_regressed ? " REGRESSION" : "") << "\n";
+  std::cout << "P90 latency: " << Percentile(sorted_baseline, 0.9) << " ms -> " << Percentile(sorted, 0.9)
+            << " ms (" << std::showpos << RelativeChange(Percentile(sorted_baseline, 0.9), Percentile(sorted, 0.9)) * 100
+            << std::noshowpos << "%)\n";
+
+  bool memory_regressed = false;
+  if (baseline.contains("memory")) {
+    const double baseline_peak = baseline["memory"].value("peak_working_set_bytes", 0.0);
+    const double peak = static_cast<double>(result.peak_workingset_size);
+    const double peak_change = RelativeChange(baseline_peak, peak);
+    memory_regressed = peak_change > threshold;
+    std::cout << "Peak working set size: " << static_cast<size_t>(baseline_peak) << " -> " << result.peak_workingset_size
+              << " bytes (" << std::showpos << peak_change * 100 << std::noshowpos << "%)"
+              << (memory_regressed ? " REGRESSION" : "") << "\n";
+  }
+
+  regressed = latency_regressed || memory_regressed;
+  std::cout << (regressed ? "Performance regressed beyond the threshold of " : "No regression beyond the threshold of ")
+            << threshold * 100 << "%" << std::endl;
+  return Status::OK();
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
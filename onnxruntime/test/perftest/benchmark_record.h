@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <core/common/status.h>
+#include "test_configuration.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+struct PerformanceResult;
+
+// The durations of a run that are not in PerformanceResult.
+struct BenchmarkTimings {
+  double session_creation_seconds{0};
+  double first_inference_seconds{0};
+};
+
+// Writes a run as a benchmark record, a JSON document with what is needed to compare it with a later run:
+//   "schema_version": version of this layout, bumped when a field changes meaning
+//   "model", "provider", "config": what ran, with the session options that affect performance
+//   "hardware": the host, with a "fingerprint" that only matches on hosts where the latencies are comparable
+//   "build": version and build flags of onnxruntime, and the execution providers it was built with
+//   "session_creation_ms", "first_inference_ms"
+//   "latency_ms": mean, stddev and percentiles of the measured runs, and the latency of each run in "samples"
+//   "memory": peak working set of the process
+//   "cpu_usage_percent"
+// The records of the model zoo regression runs are stored as baselines, see model_zoo/run_regression.py.
+Status WriteBenchmarkRecord(const PerformanceTestConfig& config, const PerformanceResult& result,
+                            const BenchmarkTimings& timings);
+
+// Compares a run with the benchmark record of a baseline run, prints the comparison, and sets `regressed` if the
+// run is slower or uses more memory than the baseline beyond noise.
+//
+// Latency regressed if the median is slower than the baseline by more than `regression_threshold` and a one-sided
+// Mann-Whitney U test of the samples of both runs finds the run slower at a 1% significance level. The test only
+// compares the ranks of the samples, so it is not thrown off by the outliers of a noisy host, and requiring both
+// keeps a significant but negligible difference of a long run, or a large but insignificant one of a short run,
+// from being reported. The peak working set regressed if it grew by more than `regression_threshold`.
+// A baseline recorded on other hardware or with another configuration is still compared, with a warning.
+Status CompareWithBenchmarkRecord(const PerformanceTestConfig& config, const PerformanceResult& result,
+                                  bool& regressed);
+
+// Returns the p-value of the one-sided Mann-Whitney U test that the values of `x` tend to be larger than those of
+// `y`, using the normal approximation with continuity and tie corrections. Returns 1 if either is empty.
+double MannWhitneyUPValue(const std::vector<double>& x, const std::vector<double>& y);
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -137,6 +137,23 @@ namespace perftest {
       "\t-D [Disable thread spinning]: disable spinning entirely for thread owned by onnxruntime intra-op thread pool.\n"
       "\t-Z [Force thread to stop spinning between runs]: disallow thread from spinning during runs to reduce cpu usage.\n"
       "\t-n [Exit after session creation]: allow user to measure session creation time to measure impact of enabling any initialization optimizations.\n"
+      "\t-Q [target_qps]: Runs open-loop: requests arrive at this rate whether or not earlier requests completed, and at most\n"
+      "\t\t[parallel runs] of them run at a time while the others wait. The latency of a request is measured from its arrival,\n"
+      "\t\tso the time it waited is included. Runs for [seconds_to_run] or until [repeated_times] requests arrived.\n"
+      "\t-a [poisson|fixed]: The arrival process of the open-loop mode. Default:'poisson'.\n"
+      "\t-w [warmup_seconds]: Requests arriving in the first seconds of the open-loop mode are not measured. Default:0.\n"
+      "\t-J [latency_report_file]: Writes the latency percentiles of the open-loop mode as JSON to this file instead of stdout.\n"
+      "\t-R: Replays the test data sets in order, cycling through them, instead of picking them at random, and reports the\n"
+      "\t\tlatencies of each combination of input shapes.\n"
+      "\t-g [shape_trace_file]: Replays the requests of a shape trace, with one request per line in the format\n"
+      "\t\t'<input name>:<dim 0>,<dim 1>,... <input name>:...', e.g. the sequence lengths seen in production.\n"
+      "\t\tThe inputs are generated, inputs a request doesn't list have their model shape with free dimensions set to 1.\n"
+      "\t\tImplies -R.\n"
+      "\t-j [benchmark_record_file]: Writes the run as a JSON benchmark record with the hardware, the build, the latency\n"
+      "\t\tdistribution and the peak memory, to be stored as a baseline.\n"
+      "\t-B [baseline_record_file]: Compares the run with a benchmark record written by -j. Exits with 2 if the run is\n"
+      "\t\tslower, by a significant difference of the median latency, or uses more memory than the threshold of -l.\n"
+      "\t-l [regression_threshold]: The regression threshold of -B in percent. Default:5.\n"
       "\t-h: help\n");
 }
 #ifdef _WIN32
@@ -199,7 +216,7 @@ static bool ParseSessionConfigs(const std::string& configs_string,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqzn"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:Q:a:w:J:g:j:B:l:AMPIDZRvhsqzn"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -385,6 +402,56 @@ static bool ParseSessionConfigs(const std::string& configs_string,
       case 'n':
         test_config.run_config.exit_after_session_creation = true;
         break;
+      case 'Q':
+        ORT_TRY {
+          test_config.run_config.target_qps = std::stod(ToUTF8String(optarg));
+        }
+        ORT_CATCH(...) {
+          return false;
+        }
+        if (!(test_config.run_config.target_qps > 0)) {
+          return false;
+        }
+        break;
+      case 'a':
+        if (!CompareCString(optarg, ORT_TSTR("poisson"))) {
+          test_config.run_config.arrival_process = ArrivalProcess::kPoisson;
+        } else if (!CompareCString(optarg, ORT_TSTR("fixed"))) {
+          test_config.run_config.arrival_process = ArrivalProcess::kFixedRate;
+        } else {
+          return false;
+        }
+        break;
+      case 'w':
+        test_config.run_config.warmup_in_seconds = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        break;
+      case 'J':
+        test_config.run_config.latency_report_file = optarg;
+        break;
+      case 'R':
+        test_config.run_config.replay_test_data = true;
+        break;
+      case 'g':
+        test_config.run_config.shape_trace_file = optarg;
+        test_config.run_config.replay_test_data = true;
+        break;
+      case 'j':
+        test_config.run_config.benchmark_record_file = optarg;
+        break;
+      case 'B':
+        test_config.run_config.baseline_record_file = optarg;
+        break;
+      case 'l':
+        ORT_TRY {
+          test_config.run_config.regression_threshold = std::stod(ToUTF8String(optarg)) / 100;
+        }
+        ORT_CATCH(...) {
+          return false;
+        }
+        if (!(test_config.run_config.regression_threshold >= 0)) {
+          return false;
+        }
+        break;
       case '?':
       case 'h':
       default:
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+// Values below kSubBucketCount have a bucket each. Above, each power of two range is split into kHalfSubBucketCount
+// buckets, which bounds the relative error to 1 / kHalfSubBucketCount.
+constexpr int kSubBucketBits = 11;
+constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+constexpr uint64_t kHalfSubBucketCount = kSubBucketCount / 2;
+
+int FloorLog2(uint64_t value) {
+  int log2 = 0;
+  while (value >>= 1) {
+    ++log2;
+  }
+  return log2;
+}
+
+}  // namespace
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+
+  // value >> shift is in [kHalfSubBucketCount, kSubBucketCount)
+  const int shift = FloorLog2(value) - (kSubBucketBits - 1);
+  return static_cast<size_t>(kSubBucketCount + (shift - 1) * kHalfSubBucketCount +
+                             ((value >> shift) - kHalfSubBucketCount));
+}
+
+uint64_t LatencyHistogram::BucketHighestValue(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+
+  const uint64_t offset = index - kSubBucketCount;
+  const uint64_t shift = offset / kHalfSubBucketCount + 1;
+  const uint64_t sub_bucket = offset % kHalfSubBucketCount + kHalfSubBucketCount;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  const size_t index = BucketIndex(value);
+  if (index >= counts_.size()) {
+    counts_.resize(index + 1, 0);
+  }
+
+  ++counts_[index];
+  ++total_count_;
+  max_value_ = std::max(max_value_, value);
+  sum_ += static_cast<double>(value);
+}
+
+double LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (total_count_ == 0) {
+    return 0.0;
+  }
+
+  const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  const uint64_t rank = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total_count_))), 1);
+
+  uint64_t cumulative_count = 0;
+  for (size_t index = 0; index < counts_.size(); ++index) {
+    cumulative_count += counts_[index];
+    if (cumulative_count >= rank) {
+      return static_cast<double>(std::min(BucketHighestValue(index), max_value_)) * 1e-9;
+    }
+  }
+  return Max();
+}
+
+double LatencyHistogram::Mean() const {
+  return total_count_ == 0 ? 0.0 : sum_ / static_cast<double>(total_count_) * 1e-9;
+}
+
+double LatencyHistogram::Max() const {
+  return static_cast<double>(max_value_) * 1e-9;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Records latencies in a log-linear histogram in the manner of HdrHistogram. Each value is kept with a relative
+// error below 0.1% in a bounded number of buckets, so recording is O(1) and the memory used does not grow with the
+// number of values. Latencies are recorded in nanoseconds and reported in seconds.
+class LatencyHistogram {
+ public:
+  void Record(std::chrono::nanoseconds latency);
+
+  uint64_t Count() const { return total_count_; }
+
+  // Returns the latency at `percentile` (0 to 100), i.e. the smallest recorded latency that is not exceeded by
+  // `percentile` percent of the values, rounded up to the end of its bucket.
+  double ValueAtPercentile(double percentile) const;
+
+  double Mean() const;
+
+  double Max() const;
+
+ private:
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketHighestValue(size_t index);
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_{0};
+  uint64_t max_value_{0};
+  double sum_{0};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -58,6 +58,11 @@ int real_main(int argc, char* argv[]) {
 
   perf_runner.SerializeResult();
 
+  // a distinct exit code, so that regression runs can tell a regression from a failure
+  if (perf_runner.HasRegressed()) {
+    return 2;
+  }
+
   return 0;
 }
 
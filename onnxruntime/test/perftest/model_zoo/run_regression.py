@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Copyright (c) Microsoft Corporation.  All rights reserved.
+# Licensed under the MIT License.
+"""Runs the models of model_zoo.json through onnxruntime_perf_test and compares them with stored baselines.
+
+Each model writes a benchmark record (-j) to --output_dir and is compared (-B) with the record of the same name in
+--baseline_dir, see benchmark_record.h for the schema and the regression criteria. Exits with 2 if any model
+regressed and with 1 if any model failed. --update_baselines copies the records of the run to --baseline_dir.
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+EXIT_REGRESSED = 2
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--perf_test", required=True, help="Path to onnxruntime_perf_test.")
+    parser.add_argument("--model_root", required=True, help="Directory the model paths of the manifest are relative to.")
+    parser.add_argument("--baseline_dir", required=True, help="Directory of the baseline benchmark records.")
+    parser.add_argument("--output_dir", required=True, help="Directory to write the benchmark records of the run to.")
+    parser.add_argument(
+        "--manifest", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "model_zoo.json")
+    )
+    parser.add_argument("--provider", default="cpu", help="Execution provider, passed to -e.")
+    parser.add_argument("--threshold", type=float, default=5.0, help="Regression threshold in percent.")
+    parser.add_argument("--models", nargs="*", help="Names of the models to run. Default: all.")
+    parser.add_argument("--extra_args", default="", help="Arguments added to every run, e.g. '-x 4'.")
+    parser.add_argument("--update_baselines", action="store_true", help="Store the records of the run as baselines.")
+    return parser.parse_args()
+
+
+def run_model(args, model):
+    model_path = os.path.join(args.model_root, model["path"])
+    if not os.path.exists(model_path):
+        return "missing", None
+
+    record = os.path.join(args.output_dir, model["name"] + ".json")
+    baseline = os.path.join(args.baseline_dir, model["name"] + ".json")
+    command = [args.perf_test, "-e", args.provider, "-m", "times", "-r", str(model.get("repeats", 100)), "-j", record]
+    if os.path.exists(baseline):
+        command += ["-B", baseline, "-l", str(args.threshold)]
+    command += args.extra_args.split() + model.get("args", []) + [model_path]
+
+    print(" ".join(command), flush=True)
+    returncode = subprocess.call(command)
+    if returncode == EXIT_REGRESSED:
+        return "regressed", record
+    if returncode != 0:
+        return "failed", None
+    return ("passed" if os.path.exists(baseline) else "no baseline"), record
+
+
+def main():
+    args = parse_arguments()
+    with open(args.manifest) as f:
+        models = json.load(f)["models"]
+    if args.models:
+        models = [model for model in models if model["name"] in args.models]
+    os.makedirs(args.output_dir, exist_ok=True)
+
+    verdicts = {}
+    for model in models:
+        verdict, record = run_model(args, model)
+        verdicts[model["name"]] = verdict
+        if args.update_baselines and record:
+            os.makedirs(args.baseline_dir, exist_ok=True)
+            shutil.copyfile(record, os.path.join(args.baseline_dir, model["name"] + ".json"))
+
+    print("\nModel zoo regression run:")
+    for name, verdict in verdicts.items():
+        print(f"  {name}: {verdict}")
+    with open(os.path.join(args.output_dir, "summary.json"), "w") as f:
+        json.dump({"threshold_percent": args.threshold, "provider": args.provider, "models": verdicts}, f, indent=2)
+
+    if "failed" in verdicts.values():
+        return 1
+    if "regressed" in verdicts.values() and not args.update_baselines:
+        return EXIT_REGRESSED
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -4,9 +4,13 @@
 
 #include "ort_test_session.h"
 #include <algorithm>
+#include <fstream>
+#include <iostream>
 #include <limits>
+#include <map>
 #include <set>
 #include <list>
+#include <sstream>
 #include <type_traits>
 #include <core/session/onnxruntime_cxx_api.h>
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -33,7 +37,11 @@ std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
   // Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
   const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
   const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
-  auto& input = test_inputs_.at(id);
+  return Run(id);
+}
+
+std::chrono::duration<double> OnnxRuntimeTestSession::Run(size_t test_data_id) {
+  auto& input = test_inputs_.at(test_data_id);
   auto start = std::chrono::high_resolution_clock::now();
   auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
                                     output_names_raw_ptr.data(), output_names_raw_ptr.size());
@@ -871,5 +879,111 @@ bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
   return true;
 }
 
+bool OnnxRuntimeTestSession::PopulateInputTestDataFromShapeTrace(const std::basic_string<ORTCHAR_T>& trace_file,
+                                                                 int32_t seed, std::vector<size_t>& replay_order) {
+  std::ifstream trace(trace_file);
+  if (!trace.good()) {
+    std::cerr << "failed to open shape trace '" << ToUTF8String(trace_file.c_str()) << "'" << std::endl;
+    return false;
+  }
+
+  // the shapes of the inputs that a request doesn't list, free dimensions are treated as 1
+  std::vector<std::vector<int64_t>> default_shapes(input_length_);
+  std::vector<ONNXTensorElementDataType> element_types(input_length_, ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED);
+  for (size_t i = 0; i < static_cast<size_t>(input_length_); i++) {
+    Ort::TypeInfo type_info = session_.GetInputTypeInfo(i);
+    if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
+      auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+      default_shapes[i] = tensor_info.GetShape();
+      std::replace(default_shapes[i].begin(), default_shapes[i].end(), int64_t{-1}, int64_t{1});
+      element_types[i] = tensor_info.GetElementType();
+    }
+  }
+
+  std::map<std::vector<std::vector<int64_t>>, size_t> test_data_ids;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(trace, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::vector<std::vector<int64_t>> shapes = default_shapes;
+    std::istringstream tokens(line);
+    std::string token;
+    bool has_inputs = false;
+    while (tokens >> token) {
+      const size_t delimiter = token.rfind(':');
+      const auto name = token.substr(0, delimiter);
+      const auto input = std::find(input_names_str_.begin(), input_names_str_.end(), name);
+      if (delimiter == std::string::npos || input == input_names_str_.end()) {
+        std::cerr << "shape trace line " << line_number << ": '" << token
+                  << "' is not in the format <input name>:<dims>" << std::endl;
+        return false;
+      }
+
+      std::vector<int64_t> dims;
+      std::istringstream dims_stream(token.substr(delimiter + 1));
+      std::string dim;
+      while (std::getline(dims_stream, dim, ',')) {
+        ORT_TRY {
+          dims.push_back(std::stoll(dim));
+        }
+        ORT_CATCH(...) {
+          std::cerr << "shape trace line " << line_number << ": invalid dimension '" << dim << "'" << std::endl;
+          return false;
+        }
+      }
+      shapes[std::distance(input_names_str_.begin(), input)] = std::move(dims);
+      has_inputs = true;
+    }
+    if (!has_inputs) {
+      continue;
+    }
+
+    const auto [it, inserted] = test_data_ids.emplace(shapes, test_data_ids.size());
+    if (inserted) {
+      for (size_t i = 0; i < static_cast<size_t>(input_length_); i++) {
+        if (element_types[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED) {
+          continue;
+        }
+        auto allocator = Ort::AllocatorWithDefaultOptions();
+        Ort::Value input_tensor = Ort::Value::CreateTensor(allocator, shapes[i].data(), shapes[i].size(),
+                                                           element_types[i]);
+        InitializeTensorWithSeed(seed, input_tensor);
+        PreLoadTestData(it->second, i, std::move(input_tensor));
+      }
+    }
+    replay_order.push_back(it->second);
+  }
+
+  if (replay_order.empty()) {
+    std::cerr << "shape trace '" << ToUTF8String(trace_file.c_str()) << "' has no requests" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::string OnnxRuntimeTestSession::GetInputShapes(size_t test_data_id) const {
+  std::ostringstream shapes;
+  const auto& inputs = test_inputs_.at(test_data_id);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (i != 0) {
+      shapes << " ";
+    }
+    shapes << input_names_str_[i] << ":";
+    if (!inputs[i] || !inputs[i].IsTensor()) {
+      shapes << "?";
+      continue;
+    }
+    const auto dims = inputs[i].GetTensorTypeAndShapeInfo().GetShape();
+    for (size_t d = 0; d < dims.size(); d++) {
+      shapes << (d == 0 ? "" : "x") << dims[d];
+    }
+  }
+  return shapes.str();
+}
+
 }  // namespace perftest
 }  // namespace onnxruntime
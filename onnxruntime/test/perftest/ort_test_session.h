@@ -27,10 +27,25 @@ class OnnxRuntimeTestSession : public TestSession {
 
   bool PopulateGeneratedInputTestData(int32_t seed);
 
+  // Generates the test data of the requests of a shape trace, a text file with one request per line in the format
+  // "<input name>:<dim 0>,<dim 1>,... <input name>:...". Inputs that a request doesn't list have the shape of the
+  // model input with free dimensions set to 1. Empty lines and lines starting with '#' are skipped.
+  // Requests with the same shapes share their test data, replay_order gets the test data id of each request.
+  bool PopulateInputTestDataFromShapeTrace(const std::basic_string<ORTCHAR_T>& trace_file, int32_t seed,
+                                           std::vector<size_t>& replay_order);
+
+  size_t GetTestDataCount() const { return test_inputs_.size(); }
+
+  // Describes the shapes of the inputs of test data set `test_data_id`, e.g. "input_ids:1x128 mask:1x128".
+  std::string GetInputShapes(size_t test_data_id) const;
+
   ~OnnxRuntimeTestSession() = default;
 
   std::chrono::duration<double> Run() override;
 
+  // Runs with test data set `test_data_id`. Unlike Run() this is thread-safe.
+  std::chrono::duration<double> Run(size_t test_data_id);
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
  private:
@@ -7,10 +7,15 @@
 #endif
 
 #include "performance_runner.h"
+#include <deque>
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
+#include "benchmark_record.h"
 #include "utils.h"
 #include "ort_test_session.h"
 #ifdef HAVE_TENSORFLOW
@@ -135,15 +140,19 @@ Status PerformanceRunner::Run() {
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -169,9 +178,53 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (!shape_bucket_histograms_.empty()) {
+    PrintShapeBucketLatencies();
+  }
+
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(WriteLatencyReport());
+  }
+
+  if (!performance_test_config_.run_config.benchmark_record_file.empty()) {
+    BenchmarkTimings timings;
+    timings.session_creation_seconds = session_create_duration.count();
+    timings.first_inference_seconds =
+        std::chrono::duration<double>(initial_inference_result_.end - initial_inference_result_.start).count();
+    ORT_RETURN_IF_ERROR(WriteBenchmarkRecord(performance_test_config_, performance_result_, timings));
+  }
+
+  if (!performance_test_config_.run_config.baseline_record_file.empty()) {
+    ORT_RETURN_IF_ERROR(CompareWithBenchmarkRecord(performance_test_config_, performance_result_, regressed_));
+  }
+
   return Status::OK();
 }
 
+std::chrono::duration<double> PerformanceRunner::RunSession(size_t& shape_bucket) {
+  if (replay_order_.empty()) {
+    return session_->Run();
+  }
+
+  const size_t test_data_id = replay_order_[next_replay_position_++ % replay_order_.size()];
+  shape_bucket = shape_bucket_of_test_data_[test_data_id];
+  return static_cast<OnnxRuntimeTestSession*>(session_.get())->Run(test_data_id);
+}
+
+void PerformanceRunner::PrintShapeBucketLatencies() const {
+  std::cout << "\nLatency by input shapes:\n";
+  for (size_t bucket = 0; bucket < shape_bucket_names_.size(); ++bucket) {
+    const auto& histogram = shape_bucket_histograms_[bucket];
+    std::cout << shape_bucket_names_[bucket] << ": " << histogram.Count() << " runs"
+              << ", Avg: " << histogram.Mean() * 1000 << " ms"
+              << ", P50: " << histogram.ValueAtPercentile(50) * 1000 << " ms"
+              << ", P90: " << histogram.ValueAtPercentile(90) * 1000 << " ms"
+              << ", P99: " << histogram.ValueAtPercentile(99) * 1000 << " ms"
+              << ", Max: " << histogram.Max() * 1000 << " ms\n";
+  }
+  std::cout << std::flush;
+}
+
 Status PerformanceRunner::FixDurationTest() {
   if (performance_test_config_.run_config.concurrent_session_runs <= 1) {
     return RunFixDuration();
@@ -259,6 +312,151 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  using Clock = std::chrono::steady_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  struct Request {
+    Clock::time_point arrival;
+    bool measured;
+  };
+  std::deque<Request> queue;
+  bool arrivals_done = false;
+  Clock::time_point last_completion;
+  int counter = 0;
+  OrtMutex m;
+  OrtCondVar queue_cv, done_cv;
+
+  // The workers bound the number of requests running at a time, the other requests wait in the queue.
+  // A request's latency is measured from its arrival, so the time it waited is included and a slow request
+  // can't hide the latency of the requests arriving behind it.
+  auto tpool = std::make_unique<DefaultThreadPoolType>(run_config.concurrent_session_runs);
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    counter++;
+    tpool->Schedule([this, &queue, &arrivals_done, &last_completion, &counter, &m, &queue_cv, &done_cv]() {
+      while (true) {
+        Request request;
+        {
+          std::unique_lock<OrtMutex> lock(m);
+          queue_cv.wait(lock, [&queue, &arrivals_done]() { return !queue.empty() || arrivals_done; });
+          if (queue.empty()) {
+            break;
+          }
+          request = queue.front();
+          queue.pop_front();
+        }
+
+        const auto service_start = Clock::now();
+        auto status = request.measured ? RunOneIteration<false>() : RunOneIteration<true>();
+        const auto service_end = Clock::now();
+        if (!status.IsOK())
+          std::cerr << status.ErrorMessage();
+
+        if (request.measured) {
+          std::lock_guard<OrtMutex> guard(results_mutex_);
+          latency_histogram_.Record(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(service_end - request.arrival));
+          service_time_histogram_.Record(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(service_end - service_start));
+          last_completion = std::max(last_completion, service_end);
+        }
+      }
+
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<OrtMutex> lg(m);
+      counter--;
+      done_cv.notify_all();
+    });
+  }
+
+  // The requests arrive on schedule whether or not the workers keep up. If this thread wakes up late, the requests
+  // that were due meanwhile are queued at once with their scheduled arrival time.
+  std::exponential_distribution<double> poisson_interval(run_config.target_qps);
+  const double fixed_interval = 1.0 / run_config.target_qps;
+  const auto start = Clock::now();
+  const auto measure_start = start + std::chrono::seconds(run_config.warmup_in_seconds);
+  const auto measure_end = measure_start + std::chrono::seconds(run_config.duration_in_seconds);
+  size_t num_measured = 0;
+  for (auto arrival = start;;) {
+    const bool done = run_config.test_mode == TestMode::kFixDurationMode
+                          ? arrival >= measure_end
+                          : num_measured >= run_config.repeated_times;
+    if (done) {
+      break;
+    }
+
+    const bool measured = arrival >= measure_start;
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lg(m);
+      queue.push_back({arrival, measured});
+    }
+    queue_cv.notify_one();
+    num_measured += measured ? 1 : 0;
+
+    const double interval = run_config.arrival_process == ArrivalProcess::kPoisson
+                                ? poisson_interval(arrival_generator_)
+                                : fixed_interval;
+    arrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+  }
+
+  {
+    std::lock_guard<OrtMutex> lg(m);
+    arrivals_done = true;
+  }
+  queue_cv.notify_all();
+
+  // Join
+  std::unique_lock<OrtMutex> lock(m);
+  done_cv.wait(lock, [&counter]() { return counter == 0; });
+
+  open_loop_measured_seconds_ = std::chrono::duration<double>(last_completion - measure_start).count();
+  return Status::OK();
+}
+
+Status PerformanceRunner::WriteLatencyReport() const {
+  const auto& run_config = performance_test_config_.run_config;
+  std::ofstream outfile;
+  if (!run_config.latency_report_file.empty()) {
+    outfile.open(run_config.latency_report_file, std::ofstream::out);
+    if (!outfile.good()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to open latency report file '",
+                             ToUTF8String(run_config.latency_report_file.c_str()), "'");
+    }
+  }
+  std::ostream& out = outfile.is_open() ? static_cast<std::ostream&>(outfile) : std::cout;
+
+  auto write_latencies = [&out](const LatencyHistogram& histogram) {
+    out << "{\"mean\": " << histogram.Mean() * 1000
+        << ", \"p50\": " << histogram.ValueAtPercentile(50) * 1000
+        << ", \"p90\": " << histogram.ValueAtPercentile(90) * 1000
+        << ", \"p99\": " << histogram.ValueAtPercentile(99) * 1000
+        << ", \"p99.9\": " << histogram.ValueAtPercentile(99.9) * 1000
+        << ", \"max\": " << histogram.Max() * 1000 << "}";
+  };
+
+  const double achieved_qps = open_loop_measured_seconds_ > 0
+                                  ? latency_histogram_.Count() / open_loop_measured_seconds_
+                                  : 0.0;
+  out << "{\n"
+      << "  \"model\": \"" << performance_result_.model_name << "\",\n"
+      << "  \"arrival_process\": \""
+      << (run_config.arrival_process == ArrivalProcess::kPoisson ? "poisson" : "fixed") << "\",\n"
+      << "  \"target_qps\": " << run_config.target_qps << ",\n"
+      << "  \"max_concurrency\": " << run_config.concurrent_session_runs << ",\n"
+      << "  \"warmup_seconds\": " << run_config.warmup_in_seconds << ",\n"
+      << "  \"requests\": " << latency_histogram_.Count() << ",\n"
+      << "  \"achieved_qps\": " << achieved_qps << ",\n"
+      << "  \"latency_ms\": ";
+  write_latencies(latency_histogram_);
+  out << ",\n"
+      << "  \"service_time_ms\": ";
+  write_latencies(service_time_histogram_);
+  out << "\n}" << std::endl;
+
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     const auto& file_path = performance_test_config_.model_info.model_file_path;
@@ -298,7 +496,10 @@ static std::unique_ptr<TestSession> CreateSession(Ort::Env& env, std::random_dev
 
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
-      test_model_info_(CreateModelInfo(test_config)) {
+      test_model_info_(CreateModelInfo(test_config)),
+      arrival_generator_(test_config.run_config.random_seed_for_input_data >= 0
+                             ? static_cast<std::mt19937::result_type>(test_config.run_config.random_seed_for_input_data)
+                             : rd()) {
   session_create_start_ = std::chrono::high_resolution_clock::now();
   session_ = CreateSession(env, rd, test_config, *test_model_info_);
   session_create_end_ = std::chrono::high_resolution_clock::now();
@@ -306,7 +507,30 @@ PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig&
 
 PerformanceRunner::~PerformanceRunner() = default;
 
+bool PerformanceRunner::InitializeReplay() {
+  const auto* ort_session = static_cast<const OnnxRuntimeTestSession*>(session_.get());
+
+  // test data with the same input shapes share a bucket
+  std::map<std::string, size_t> buckets;
+  shape_bucket_of_test_data_.resize(ort_session->GetTestDataCount());
+  for (size_t test_data_id = 0; test_data_id < shape_bucket_of_test_data_.size(); ++test_data_id) {
+    const auto [it, inserted] = buckets.emplace(ort_session->GetInputShapes(test_data_id), buckets.size());
+    if (inserted) {
+      shape_bucket_names_.push_back(it->first);
+    }
+    shape_bucket_of_test_data_[test_data_id] = it->second;
+  }
+  shape_bucket_histograms_.resize(shape_bucket_names_.size());
+  return true;
+}
+
 bool PerformanceRunner::Initialize() {
+  const auto& run_config = performance_test_config_.run_config;
+  if (run_config.replay_test_data && CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) != 0) {
+    std::cout << "replaying test data is only supported with the ort backend" << std::endl;
+    return false;
+  }
+
   std::basic_string<PATH_CHAR_TYPE> test_case_dir;
   auto st = GetDirNameFromFilePath(performance_test_config_.model_info.model_file_path, test_case_dir);
   if (!st.IsOK()) {
@@ -325,6 +549,13 @@ bool PerformanceRunner::Initialize() {
   TestModelInfo* test_model_info = test_model_info_.get();
   test_case_ = CreateOnnxTestCase(narrow_model_name, std::move(test_model_info_), 0.0, 0.0);
 
+  if (!run_config.shape_trace_file.empty()) {
+    return static_cast<OnnxRuntimeTestSession*>(session_.get())
+               ->PopulateInputTestDataFromShapeTrace(run_config.shape_trace_file,
+                                                     run_config.random_seed_for_input_data, replay_order_) &&
+           InitializeReplay();
+  }
+
   if (performance_test_config_.run_config.generate_model_input_binding) {
     return static_cast<OnnxRuntimeTestSession*>(
                session_.get())
@@ -353,6 +584,12 @@ bool PerformanceRunner::Initialize() {
     }
   }
 
+  if (run_config.replay_test_data) {
+    replay_order_.resize(test_data_count);
+    std::iota(replay_order_.begin(), replay_order_.end(), size_t{0});
+    return InitializeReplay();
+  }
+
   return true;
 }
 
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <random>
 #include <chrono>
@@ -17,6 +18,7 @@
 #include <core/platform/ort_mutex.h>
 #include <core/session/onnxruntime_cxx_api.h>
 #include "test_configuration.h"
+#include "latency_histogram.h"
 #include "heap_buffer.h"
 #include "test_session.h"
 #include "OrtValueList.h"
@@ -50,6 +52,9 @@ class PerformanceRunner {
 
   inline const PerformanceResult& GetResult() const { return performance_result_; }
 
+  // Whether the run regressed from the baseline record it was compared with.
+  inline bool HasRegressed() const { return regressed_; }
+
   inline void SerializeResult() const {
     performance_result_.DumpToFile(performance_test_config_.model_info.result_file_path,
                                    performance_test_config_.run_config.f_dump_statistics);
@@ -58,14 +63,19 @@ class PerformanceRunner {
 
  private:
   bool Initialize();
+  bool InitializeReplay();
+
+  // Runs the session with the next test data when replaying, and returns the shape bucket of the test data.
+  std::chrono::duration<double> RunSession(size_t& shape_bucket);
 
   template <bool isWarmup>
   Status RunOneIteration() {
     std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
 
+    size_t shape_bucket = 0;
     auto status = Status::OK();
     ORT_TRY {
-      duration_seconds = session_->Run();
+      duration_seconds = RunSession(shape_bucket);
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -78,6 +88,10 @@ class PerformanceRunner {
       std::lock_guard<OrtMutex> guard(results_mutex_);
       performance_result_.time_costs.emplace_back(duration_seconds.count());
       performance_result_.total_time_cost += duration_seconds.count();
+      if (!shape_bucket_histograms_.empty()) {
+        shape_bucket_histograms_[shape_bucket].Record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration_seconds));
+      }
       if (performance_test_config_.run_config.f_verbose) {
         std::cout << "iteration:" << performance_result_.time_costs.size() << ","
                   << "time_cost:" << performance_result_.time_costs.back() << std::endl;
@@ -90,6 +104,9 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
+  Status WriteLatencyReport() const;
+  void PrintShapeBucketLatencies() const;
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -117,6 +134,21 @@ class PerformanceRunner {
   std::unique_ptr<ITestCase> test_case_;
 
   OrtMutex results_mutex_;
+
+  // open-loop mode results, the latencies measured from the arrival of the requests and the time they ran
+  LatencyHistogram latency_histogram_;
+  LatencyHistogram service_time_histogram_;
+  double open_loop_measured_seconds_{0};
+  std::mt19937 arrival_generator_;
+
+  // replay mode, the ids of the test data to run in order and the latencies by the shapes of the test data
+  std::vector<size_t> replay_order_;
+  std::atomic<size_t> next_replay_position_{0};
+  std::vector<size_t> shape_bucket_of_test_data_;
+  std::vector<std::string> shape_bucket_names_;
+  std::vector<LatencyHistogram> shape_bucket_histograms_;
+
+  bool regressed_{false};
 };
 }  // namespace perftest
 }  // namespace onnxruntime
@@ -19,6 +19,12 @@ enum class TestMode : std::uint8_t {
   KFixRepeatedTimesMode
 };
 
+// How the requests arrive in the open-loop mode
+enum class ArrivalProcess : std::uint8_t {
+  kPoisson = 0,
+  kFixedRate
+};
+
 enum class Platform : std::uint8_t {
   kWindows = 0,
   kLinux
@@ -64,6 +70,21 @@ struct RunConfig {
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
   bool exit_after_session_creation = false;
+  // open-loop mode: requests arrive at target_qps whether or not the earlier ones completed, with at most
+  // concurrent_session_runs of them running. enabled by a target_qps > 0.
+  double target_qps{0};
+  ArrivalProcess arrival_process{ArrivalProcess::kPoisson};
+  size_t warmup_in_seconds{0};
+  std::basic_string<ORTCHAR_T> latency_report_file;
+  // replay the test data in order instead of picking it at random, and break the latencies down by input shapes.
+  // the test data is read from the model directory, or generated from the requests of shape_trace_file if set.
+  bool replay_test_data{false};
+  std::basic_string<ORTCHAR_T> shape_trace_file;
+  // regression runs: the run is written as a benchmark record, and compared with the record of a baseline run.
+  // see benchmark_record.h
+  std::basic_string<ORTCHAR_T> benchmark_record_file;
+  std::basic_string<ORTCHAR_T> baseline_record_file;
+  double regression_threshold{0.05};
 };
 
 struct PerformanceTestConfig {
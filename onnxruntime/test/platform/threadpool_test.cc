@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/platform/threadpool.h"
+#include "core/common/threadpool_cost_calibration.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
 #include "core/util/thread_utils.h"
@@ -14,6 +15,7 @@
 #include <algorithm>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -544,6 +546,245 @@ TEST(ThreadPoolTest, TestStackSize) {
 #endif
 #endif
 
+TEST(ThreadPoolTest, TestNumaNodes) {
+  const auto numa_nodes = Env::Default().GetNumaNodes();
+  // every logical processor belongs to at most one node
+  std::vector<int> processors;
+  for (const auto& node : numa_nodes) {
+    ASSERT_FALSE(node.empty());
+    processors.insert(processors.end(), node.begin(), node.end());
+  }
+  std::sort(processors.begin(), processors.end());
+  ASSERT_TRUE(std::adjacent_find(processors.begin(), processors.end()) == processors.end());
+
+  for (size_t node = 0; node < numa_nodes.size(); node++) {
+    OrtThreadPoolParams tp_params;
+    tp_params.numa_node = static_cast<int>(node);
+    auto tp = concurrency::CreateThreadPool(&Env::Default(), tp_params, concurrency::ThreadPoolType::INTRA_OP);
+    constexpr int num_tasks = 1000;
+    auto test_data = CreateTestData(num_tasks);
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  }
+
+#ifndef ORT_NO_EXCEPTIONS
+  OrtThreadPoolParams tp_params;
+  tp_params.numa_node = static_cast<int>(numa_nodes.size());
+  ASSERT_THROW(concurrency::CreateThreadPool(&Env::Default(), tp_params, concurrency::ThreadPoolType::INTRA_OP),
+               std::exception);
+#endif
+}
+
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  ThreadOptions to;
+  to.adaptive_spinning = true;
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), to, nullptr, 4, true);
+  for (int rep = 0; rep < 20; rep++) {
+    // pauses longer than the longest spin let the workers block and be woken up again
+    if (rep % 5 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    constexpr int num_tasks = 1000;
+    auto test_data = CreateTestData(num_tasks);
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestWakeBlockedWorkers) {
+  // without spinning, the workers block as soon as they run out of work
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, false);
+  for (int rep = 0; rep < 100; rep++) {
+    constexpr int num_tasks = 8;
+    onnxruntime::Barrier b(num_tasks);
+    std::atomic<int> count{0};
+    for (int i = 0; i < num_tasks; i++) {
+      ThreadPool::Schedule(tp.get(), [&]() {
+        count++;
+        b.Notify();
+      });
+    }
+    b.Wait();
+    ASSERT_EQ(count, num_tasks);
+  }
+}
+
+TEST(ThreadPoolTest, TestCoreCapacities) {
+  const auto capacities = Env::Default().GetCoreCapacities();
+  if (capacities.empty()) {
+    return;
+  }
+  ASSERT_EQ(capacities.size(), Env::Default().GetDefaultThreadAffinities().size());
+  for (double capacity : capacities) {
+    ASSERT_GT(capacity, 0.0);
+    ASSERT_LE(capacity, 1.0);
+  }
+  ASSERT_EQ(*std::max_element(capacities.begin(), capacities.end()), 1.0);
+}
+
+TEST(ThreadPoolTest, TestParallelForWithCoreCapacities) {
+  // threads on slower cores claim smaller blocks, every iteration still runs exactly once
+  for (int dynamic_block_base : {0, 4}) {
+    ThreadOptions to;
+    to.affinities.resize(4);
+    to.capacities = {1.0, 1.0, 0.5, 0.25};
+    to.dynamic_block_base_ = dynamic_block_base;
+    auto tp = std::make_unique<ThreadPool>(&Env::Default(), to, nullptr, 4, true);
+
+    constexpr int num_tasks = 100000;
+    auto test_data = CreateTestData(num_tasks);
+    ThreadPool::TryParallelFor(tp.get(), num_tasks, 1000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; i++) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestDegreeOfParallelismLimit) {
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, true);
+  const int degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+  {
+    ThreadPool::DegreeOfParallelismLimit limit(2);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), std::min(degree_of_parallelism, 2));
+    {
+      // the innermost limit applies, zero removes the limit
+      ThreadPool::DegreeOfParallelismLimit unlimited(0);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), degree_of_parallelism);
+    }
+
+    // the limit only applies to the thread which set it
+    int other_thread_degree_of_parallelism = 0;
+    std::thread other_thread([&]() {
+      other_thread_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+    });
+    other_thread.join();
+    ASSERT_EQ(other_thread_degree_of_parallelism, degree_of_parallelism);
+  }
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), degree_of_parallelism);
+
+  // with a limit of one, loops run on the calling thread only
+  ThreadPool::DegreeOfParallelismLimit limit(1);
+  constexpr int num_tasks = 10000;
+  auto test_data = CreateTestData(num_tasks);
+  const auto caller = std::this_thread::get_id();
+  std::atomic<bool> other_thread_used{false};
+  ThreadPool::TryParallelFor(tp.get(), num_tasks, 1000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    if (std::this_thread::get_id() != caller) {
+      other_thread_used = true;
+    }
+    for (std::ptrdiff_t i = first; i < last; i++) {
+      IncrementElement(*test_data, i);
+    }
+  });
+  ValidateTestData(*test_data);
+  ASSERT_FALSE(other_thread_used);
+}
+
+TEST(ThreadPoolTest, TestLowPriorityScope) {
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, true);
+  const int degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp.get());
+  std::atomic<int> higher_priority_runs{0};
+  {
+    ThreadPool::LowPriorityScope low_priority(&higher_priority_runs);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), degree_of_parallelism);
+
+    // the counter is checked each time, so the pool is yielded and taken back as higher priority runs come and go
+    higher_priority_runs = 1;
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 1);
+    {
+      // the innermost scope applies
+      ThreadPool::LowPriorityScope high_priority(nullptr);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), degree_of_parallelism);
+    }
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 1);
+    higher_priority_runs = 0;
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), degree_of_parallelism);
+    higher_priority_runs = 1;
+  }
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), degree_of_parallelism);
+}
+
+#if !defined(ORT_NO_EXCEPTIONS)
+TEST(ThreadPoolTest, TestCancellationScope) {
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, true);
+  constexpr std::ptrdiff_t num_tasks = 100000;
+  bool terminate = false;
+  ThreadPool::CancellationScope cancellation(&terminate);
+
+  // loops complete while the flag is not set
+  std::atomic<std::ptrdiff_t> done{0};
+  ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t) { done++; });
+  ASSERT_EQ(done, num_tasks);
+
+  // setting the flag stops the loop before all blocks ran, and the loop throws
+  done = 0;
+  ASSERT_THROW(ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks,
+                                                [&](std::ptrdiff_t) {
+                                                  if (++done == 100) {
+                                                    terminate = true;
+                                                  }
+                                                }),
+               OnnxRuntimeException);
+  ASSERT_LT(done, num_tasks);
+}
+#endif
+
+TEST(ThreadPoolTest, TestCostCalibration) {
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, true);
+  ThreadPoolCostCalibration calibration;
+  const std::string call_site = "Test";
+  // far more than the work of each unit
+  const onnxruntime::TensorOpCost estimate{0, 0, 1e9};
+  constexpr int num_tasks = 1000;
+  constexpr int num_loops = static_cast<int>(ThreadPoolCostCalibration::kMinSamples);
+  auto test_data = CreateTestData(num_tasks);
+  {
+    ThreadPool::CostCalibrationScope scope(&calibration, call_site);
+    for (int i = 0; i < num_loops; i++) {
+      ThreadPool::TryParallelFor(tp.get(), num_tasks, estimate, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t idx = first; idx < last; idx++) {
+          IncrementElement(*test_data, idx);
+        }
+      });
+    }
+  }
+  ValidateTestData(*test_data, num_loops);
+
+  // later loops of the call site and size are split with the measured cost
+  ASSERT_LT(calibration.GetCost(call_site, num_tasks, estimate).compute_cycles, estimate.compute_cycles);
+  ASSERT_EQ(calibration.GetCost(call_site, num_tasks * 4, estimate).compute_cycles, estimate.compute_cycles);
+  ASSERT_EQ(calibration.GetCost("Other", num_tasks, estimate).compute_cycles, estimate.compute_cycles);
+
+  const std::string json = calibration.ToJson();
+  ASSERT_NE(json.find("{\"call_site\": \"Test\", \"min_size\": 512, \"loops\": 3, "), std::string::npos) << json;
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(ThreadPoolTest, TestProfilingParallelLoops) {
+  auto tp = std::make_unique<ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr, 4, true);
+  constexpr int num_tasks = 1000;
+  auto test_data = CreateTestData(num_tasks);
+  ThreadPool::StartProfiling(tp.get());
+  for (int i = 0; i < 2; i++) {
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t idx) {
+      IncrementElement(*test_data, idx);
+    });
+  }
+  const std::string stats = ThreadPool::StopProfiling(tp.get());
+  ValidateTestData(*test_data, 2);
+
+  // every iteration runs in a block of its own
+  ASSERT_NE(stats.find("\"parallel_loops\": {\"count\": 2, \"iterations\": 2000, "), std::string::npos) << stats;
+  ASSERT_NE(stats.find("\"blocks\": 2000, "), std::string::npos) << stats;
+
+  // the stats are reset when profiling stops
+  ThreadPool::StartProfiling(tp.get());
+  ASSERT_NE(ThreadPool::StopProfiling(tp.get()).find("\"parallel_loops\": {\"count\": 0, "), std::string::npos);
+}
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD) && !defined(ORT_EXTENDED_MINIMAL_BUILD)
 
 #ifndef ORT_NO_EXCEPTIONS
@@ -29,6 +29,7 @@ bool WindowsEnvTester::SetCpuInfo(const CpuInfo& cpu_info) {
     return false;
   }
   cores_.clear();
+  core_efficiency_classes_.clear();
   global_processor_info_map_.clear();
   int global_processor_id = 0;
   for (int group_id = 0; group_id < static_cast<int>(cpu_info.size()); ++group_id) {
@@ -42,6 +43,7 @@ bool WindowsEnvTester::SetCpuInfo(const CpuInfo& cpu_info) {
         global_processor_id++;
       }
       cores_.push_back(std::move(logical_processors));
+      core_efficiency_classes_.push_back(0);
     }
   }
   return true;
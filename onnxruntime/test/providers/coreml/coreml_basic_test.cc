@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+
 #include "core/common/logging/logging.h"
 #include "core/providers/coreml/coreml_execution_provider.h"
 #include "core/providers/coreml/coreml_provider_factory.h"
@@ -192,6 +194,46 @@ TEST(CoreMLExecutionProviderTest, TestOrtFormatModel) {
 #endif
 }
 
+#if defined(__APPLE__)
+TEST(CoreMLExecutionProviderTest, TestCompiledModelCache) {
+  const ORTCHAR_T* model_file_name = ORT_TSTR("testdata/mnist.basic.ort");
+  const std::filesystem::path cache_dir = "coreml_compiled_model_cache_test";
+  std::filesystem::remove_all(cache_dir);
+
+  RandomValueGenerator random{};
+  const std::vector<int64_t> dims = {1, 1, 28, 28};
+  std::vector<float> data = random.Gaussian<float>(dims, 0.0f, 1.f);
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, data, &ml_value);
+
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("Input3", ml_value));
+
+  auto count_cached_models = [&cache_dir]() {
+    size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+      count += entry.path().extension() == ".mlmodelc" ? 1 : 0;
+    }
+    return count;
+  };
+
+  // the first session compiles and caches the models, the second one loads them from the cache
+  RunAndVerifyOutputsWithEP(model_file_name, CurrentTestName(),
+                            std::make_unique<CoreMLExecutionProvider>(s_coreml_flags, cache_dir.string()),
+                            feeds);
+  const size_t num_cached_models = count_cached_models();
+  ASSERT_GT(num_cached_models, 0u);
+
+  RunAndVerifyOutputsWithEP(model_file_name, CurrentTestName(),
+                            std::make_unique<CoreMLExecutionProvider>(s_coreml_flags, cache_dir.string()),
+                            feeds);
+  EXPECT_EQ(count_cached_models(), num_cached_models);
+
+  std::filesystem::remove_all(cache_dir);
+}
+#endif  // defined(__APPLE__)
+
 // Test that we fix invalid names in model inputs, initializers and outputs.
 // Names in CoreML cannot start with [0-9] or contain anything but "[a-z][A-Z][0-9]_"
 TEST(CoreMLExecutionProviderTest, TestNameSanitization) {
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <future>
+#include <numeric>
 #include <thread>
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -1030,16 +1031,22 @@ TEST(Loop, IterationCountAsOutput) {
     return graph.ToGraphProto();
   };
 
-  OpTester test("Loop", 11);
   auto body = create_subgraph();
-  test.AddAttribute<GraphProto>("body", body);
-  test.AddInput<int64_t>("M", {1}, {3});
-  test.AddInput<bool>("cond", {1}, {true});
 
-  test.AddOutput<int64_t>("loop_var_0_final", {3, 1}, {0, 1, 2});
+  // with 40 iterations the buffer the loop output is written to also has to grow while the loop runs
+  for (int64_t num_iterations : {3, 40}) {
+    OpTester test("Loop", 11);
+    test.AddAttribute<GraphProto>("body", body);
+    test.AddInput<int64_t>("M", {1}, {num_iterations});
+    test.AddInput<bool>("cond", {1}, {true});
+
+    std::vector<int64_t> loop_var_0_final(static_cast<size_t>(num_iterations));
+    std::iota(loop_var_0_final.begin(), loop_var_0_final.end(), int64_t{0});
+    test.AddOutput<int64_t>("loop_var_0_final", {num_iterations, 1}, loop_var_0_final);
 
-  // Disable TensorRT on unsupported data type BOOL
-  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+    // Disable TensorRT on unsupported data type BOOL
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
 }
 
 #if defined(USE_CUDA) || defined(USE_ROCM)
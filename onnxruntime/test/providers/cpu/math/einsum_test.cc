@@ -236,6 +236,29 @@ TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input) {
   test.Run();
 }
 
+// The inputs are contracted in the order of least cost, here the last two first
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_Reordered) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {3, 4}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f});
+  test.AddInput<float>("y", {4, 5}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 0.f, 1.f, 2.f,
+                                     3.f, 4.f, 5.f, 6.f, 0.f, 1.f, 2.f, 3.f, 4.f, 5.f});
+  test.AddInput<float>("z", {5}, {1.f, -1.f, 2.f, 0.f, 3.f});
+  test.AddOutput<float>("o", {3}, {83.f, 279.f, 475.f});
+  test.Run();
+}
+
+TEST(Einsum, ExplicitEinsumAsTensorContraction_Multi_Input_Reordered) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "bi,ij,j,b->i");
+  test.AddInput<float>("a", {2, 3}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f});
+  test.AddInput<float>("b", {3, 4}, {0.f, 1.f, 2.f, 3.f, 4.f, 0.f, 1.f, 2.f, 3.f, 4.f, 0.f, 1.f});
+  test.AddInput<float>("c", {4}, {1.f, 2.f, -1.f, 1.f});
+  test.AddInput<float>("d", {2}, {2.f, -1.f});
+  test.AddOutput<float>("o", {3}, {-9.f, -10.f, -12.f});
+  test.Run();
+}
+
 TEST(Einsum, ExplicitEinsumAsBatchedMatmul) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "bij,bjk->bik");
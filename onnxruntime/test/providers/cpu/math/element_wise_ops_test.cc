@@ -1700,6 +1700,35 @@ TEST(MathOpTest, Max_8_2inputbroadcast) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT: Input batch size is inconsistent
 }
 
+// Enough spans for the pairwise broadcasts of the variadic inputs to be split across threads
+TEST(MathOpTest, Max_8_3inputbroadcast_MultipleSpans) {
+  constexpr int64_t rows = 64;
+  constexpr int64_t cols = 32;
+  std::vector<float> data_0(rows * cols);
+  std::vector<float> data_1(cols);
+  std::vector<float> data_2(rows);
+  std::vector<float> expected(rows * cols);
+  for (int64_t c = 0; c < cols; ++c) {
+    data_1[c] = static_cast<float>(c % 7);
+  }
+  for (int64_t r = 0; r < rows; ++r) {
+    data_2[r] = static_cast<float>(r % 5) + 0.5f;
+  }
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      data_0[r * cols + c] = static_cast<float>((r * cols + c) % 11) - 3.0f;
+      expected[r * cols + c] = std::max({data_0[r * cols + c], data_1[c], data_2[r]});
+    }
+  }
+
+  OpTester test("Max", 8);
+  test.AddInput<float>("data_0", {rows, cols}, data_0);
+  test.AddInput<float>("data_1", {1, cols}, data_1);
+  test.AddInput<float>("data_2", {rows, 1}, data_2);
+  test.AddOutput<float>("max", {rows, cols}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT: Input batch size is inconsistent
+}
+
 TEST(MathOpTest, Max_12_Float) {
   OpTester test("Max", 12);
   test.AddInput<float>("data_0", {1, 3},
@@ -683,6 +683,48 @@ TYPED_TEST(GemmOpTypedTests, TestGemmWithAlphaOpset11) {
       .RunWithConfig();
 }
 
+TEST(GemmOpTest, GemmBlockSparseInitializer) {
+  // B is mostly zero blocks, so the CPU EP packs it as block sparse.
+  constexpr int64_t M = 6, K = 5, N = 9;
+  constexpr float alpha = 2.0f, beta = 0.5f;
+  std::vector<float> a_values(M * K);
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    a_values[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  // B is transposed, N x K
+  std::vector<float> b_values(N * K, 0.0f);
+  b_values[2 * K + 1] = 1.5f;
+  b_values[8 * K + 4] = -2.0f;
+  b_values[3 * K + 0] = 1.0f;
+  std::vector<float> c_values(N);
+  for (int64_t n = 0; n < N; ++n) {
+    c_values[n] = static_cast<float>(n);
+  }
+
+  std::vector<float> y_values(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a_values[m * K + k] * b_values[n * K + k];
+      }
+      y_values[m * N + n] = alpha * sum + beta * c_values[n];
+    }
+  }
+
+  OpTester test("Gemm", 13);
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", alpha);
+  test.AddAttribute("beta", beta);
+  test.AddInput<float>("A", {M, K}, a_values);
+  test.AddInput<float>("B", {N, K}, b_values, true);
+  test.AddInput<float>("C", {N}, c_values);
+  test.AddOutput<float>("Y", {M, N}, y_values);
+  test.ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in training builds so no need to test the feature in a training build.
 TEST(GemmOpTest, SharedPrepackedWeights) {
@@ -182,6 +182,21 @@ TEST(MatmulIntegerOpTest, MatMulInteger_int8_t_A_ND_B_ND) {
   test.Run();
 }
 
+TEST(MatmulIntegerOpTest, MatMulInteger_B_ND_Initializer) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {2, 3}, {1, 2, 3, 4, 5, 6});
+  // each matrix of B is pre-packed separately
+  test.AddInput<uint8_t>("T2", {2, 3, 2},
+                         {1, 4, 2, 5, 3, 6,
+                          7, 1, 0, 2, 5, 3},
+                         true);
+  test.AddOutput<int32_t>("T3", {2, 2, 2},
+                          {14, 32, 32, 77,
+                           22, 14, 58, 32});
+
+  test.Run();
+}
+
 TEST(MatmulIntegerOpTest, MatMulInteger_int8_t_A_Has_Zero_Point) {
   if (DefaultCudaExecutionProvider() &&
       !HasCudaEnvironment(530 /*min_cuda_architecture*/)) {
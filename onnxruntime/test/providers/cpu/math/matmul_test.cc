@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
@@ -210,6 +211,55 @@ TEST(MathOpTest, MatMulFloatTypeInitializer) {
   RunMatMulTest<float>(7, false, true);
 }
 
+TEST(MathOpTest, MatMulBlockSparseInitializer) {
+  // B is mostly zero blocks, so the CPU EP packs it as block sparse. N is not a multiple of the block width
+  // and M is not a multiple of the rows computed together.
+  constexpr int64_t M = 5, K = 8, N = 6;
+  std::vector<float> a_values(M * K);
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    a_values[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  std::vector<float> b_values(K * N, 0.0f);
+  b_values[1 * N + 0] = 2.0f;
+  b_values[1 * N + 3] = -1.0f;
+  b_values[4 * N + 5] = 0.5f;
+  b_values[6 * N + 4] = 3.0f;
+
+  std::vector<float> y_values(M * N, 0.0f);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y_values[m * N + n] += a_values[m * K + k] * b_values[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {M, K}, a_values);
+  test.AddInput<float>("B", {K, N}, b_values, true);
+  test.AddOutput<float>("Y", {M, N}, y_values);
+  test.ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+TEST(MathOpTest, MatMulNumaReplicatedWeights) {
+  // the packed B is copied to each NUMA node when there are several, and used as is otherwise
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f), true);
+  test.AddOutput<float>("Y", {2, 3},
+                        {10.0f, 10.0f, 10.0f,
+                         -10.0f, -10.0f, -10.0f});
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsNumaReplicatePrepackedWeights, "1"));
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
 TEST(MathOpTest, MatMulInt32Type) {
   RunMatMulTest<int32_t>(9);
 }
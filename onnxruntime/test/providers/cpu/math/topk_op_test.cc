@@ -861,5 +861,48 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded<double>(k, n, batch_size);
 }
 
+// create input of 2x40000 with many ties and select 50. there are fewer rows than threads on most machines, so
+// each row is split into shards whose top k are merged.
+template <typename T>
+static void TestLongRows(int64_t largest) {
+  constexpr int64_t k = 50;
+  constexpr int64_t n = 2;
+  constexpr int64_t row_size = 40000;
+
+  std::vector<T> input_vals(n * row_size);
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<T>((i * 7919) % 10007);
+  }
+
+  std::vector<int64_t> input_dimensions = {n, row_size};
+  std::vector<T> expected_vals;
+  std::vector<int64_t> expected_indices;
+  std::vector<int64_t> expected_dimensions = {n, k};
+
+  for (int64_t i = 0; i < n; ++i) {
+    const T* row = input_vals.data() + i * row_size;
+    std::vector<int64_t> order(row_size);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [row, largest](int64_t lhs, int64_t rhs) {
+      return largest ? row[lhs] > row[rhs] : row[lhs] < row[rhs];
+    });
+
+    for (int64_t l = 0; l < k; ++l) {
+      expected_vals.push_back(row[order[l]]);
+      expected_indices.push_back(order[l]);
+    }
+  }
+
+  RunTest(11, k, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, -1,
+          largest);
+}
+
+TEST(TopKOperator, LongRowsSharded) {
+  TestLongRows<float>(1);
+  TestLongRows<float>(0);
+  TestLongRows<double>(1);
+  TestLongRows<int64_t>(0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
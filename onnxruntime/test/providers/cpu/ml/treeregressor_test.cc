@@ -760,5 +760,71 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeRegressorBatchedTrees) {
+  // Enough trees and rows to evaluate the ensemble by batches of rows with bitvectors,
+  // including rows with missing values going to the false branch.
+  constexpr int n_trees = 80;
+  std::vector<int64_t> nodes_featureids = {0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0};
+  std::vector<float> nodes_values = {2.5f, 0.4f, 0.2f, 0.6f, 0.0f, 0.8f, 0.0f, 0.0f, 0.0f, 0.0f,
+                                     1.6f, 1.2f, 0.0f, 1.4f, 0.0f, 0.0f, 17.0f, 0.0f, 0.0f};
+  std::vector<int64_t> nodes_treeids(nodes_featureids.size(), 0);
+  std::vector<int64_t> nodes_nodeids = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18};
+  std::vector<int64_t> nodes_falsenodeids = {10, 5, 4, 8, 0, 9, 0, 0, 0, 0, 16, 13, 0, 15, 0, 0, 18, 0, 0};
+  std::vector<int64_t> nodes_truenodeids = {1, 2, 3, 7, 0, 6, 0, 0, 0, 0, 11, 12, 0, 14, 0, 0, 17, 0, 0};
+  std::vector<std::string> nodes_modes(nodes_featureids.size(), "BRANCH_LT");
+  for (int64_t leaf : {4, 6, 7, 8, 9, 12, 14, 15, 17, 18}) {
+    nodes_modes[leaf] = "LEAF";
+  }
+  std::vector<int64_t> target_ids(10, 0);
+  std::vector<int64_t> target_nodeids = {4, 6, 7, 8, 9, 12, 14, 15, 17, 18};
+  std::vector<int64_t> target_treeids(10, 0);
+  std::vector<float> target_weights = {-4.75f, -5.0f, -4.5f, -4.25f, -4.0f, 11.0f, 13.25f, 15.5f, 17.75f, 19.5f};
+
+  _multiply_update_array(nodes_featureids, n_trees);
+  _multiply_update_array(nodes_values, n_trees);
+  _multiply_update_array(nodes_treeids, n_trees, (int64_t)1);
+  _multiply_update_array(nodes_nodeids, n_trees);
+  _multiply_update_array(nodes_falsenodeids, n_trees);
+  _multiply_update_array(nodes_truenodeids, n_trees);
+  _multiply_update_array_string(nodes_modes, n_trees);
+  _multiply_update_array(target_ids, n_trees);
+  _multiply_update_array(target_nodeids, n_trees);
+  _multiply_update_array(target_treeids, n_trees, (int64_t)1);
+  _multiply_update_array(target_weights, n_trees);
+
+  // Strict comparisons: x0 < 2.5, then x1 < 0.4, x1 < 0.2 and x1 < 0.6 lead to leaf 7 (-4.5),
+  // x1 = 0.3 leads to leaf 4 (-4.75), x1 = 0.5 to leaf 6 (-5), and a missing x0 goes
+  // through nodes 10 and 16 to leaf 18 (19.5).
+  const std::vector<float> row_x = {-5.0f, 0.1f, -5.0f, 0.3f, -5.0f, 0.5f,
+                                    std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(),
+                                    20.0f, 1.0f};
+  const std::vector<float> row_y = {-4.5f, -4.75f, -5.0f, 19.5f, 11.0f};
+  constexpr int64_t n_rows = 37;
+  std::vector<float> X, Y;
+  for (int64_t i = 0; i < n_rows; ++i) {
+    const size_t r = static_cast<size_t>(i) % row_y.size();
+    X.push_back(row_x[r * 2]);
+    X.push_back(row_x[r * 2 + 1]);
+    Y.push_back(row_y[r] * n_trees);
+  }
+
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+  test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+  test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+  test.AddAttribute("nodes_treeids", nodes_treeids);
+  test.AddAttribute("nodes_nodeids", nodes_nodeids);
+  test.AddAttribute("nodes_featureids", nodes_featureids);
+  test.AddAttribute("nodes_values", nodes_values);
+  test.AddAttribute("nodes_modes", nodes_modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+  test.AddInput<float>("X", {n_rows, 2}, X);
+  test.AddOutput<float>("Y", {n_rows, 1}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "default_providers.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -728,5 +730,64 @@ TEST(ConvTest, Conv_AutoPad_with_non_default_strides) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// Conv large enough for MLAS to select the Winograd algorithm when it is enabled in the session options.
+TEST(ConvTest, Conv2D_Winograd) {
+  constexpr int64_t C = 16, M = 24, H = 13, W = 11;
+  std::vector<float> X(C * H * W);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(static_cast<int>((i * 37) % 23) - 11) / 8.0f;
+  }
+  std::vector<float> Wt(M * C * 9);
+  for (size_t i = 0; i < Wt.size(); ++i) {
+    Wt[i] = static_cast<float>(static_cast<int>((i * 53) % 19) - 9) / 16.0f;
+  }
+  std::vector<float> B(M);
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<float>(i) / 4.0f - 3.0f;
+  }
+
+  // pads = 1, so the output has the size of the input.
+  std::vector<float> expected(M * H * W);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t oh = 0; oh < H; ++oh) {
+      for (int64_t ow = 0; ow < W; ++ow) {
+        double sum = B[m];
+        for (int64_t c = 0; c < C; ++c) {
+          for (int64_t kh = 0; kh < 3; ++kh) {
+            for (int64_t kw = 0; kw < 3; ++kw) {
+              const int64_t ih = oh + kh - 1;
+              const int64_t iw = ow + kw - 1;
+              if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                sum += static_cast<double>(X[(c * H + ih) * W + iw]) * Wt[((m * C + c) * 3 + kh) * 3 + kw];
+              }
+            }
+          }
+        }
+        expected[(m * H + oh) * W + ow] = static_cast<float>(sum);
+      }
+    }
+  }
+
+  for (const char* use_winograd : {"0", "1"}) {
+    // The second run enables TunableOp in the CPU EP, tuning the algorithm and thread count.
+    for (bool test_tunable_op : {false, true}) {
+      OpTester test("Conv", 11);
+      test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+      test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+      test.AddInput<float>("X", {1, C, H, W}, X);
+      test.AddInput<float>("W", {M, C, 3, 3}, Wt, true);
+      test.AddInput<float>("B", {M}, B, true);
+      test.AddOutput<float>("Y", {1, M, H, W}, expected, /*sort_output*/ false, 1e-4f, 1e-4f);
+
+      SessionOptions so;
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasConvWinograd, use_winograd));
+
+      test.Config(so)
+          .ConfigEp(DefaultCpuExecutionProvider(/*enable_arena*/ true, test_tunable_op))
+          .RunWithConfig();
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
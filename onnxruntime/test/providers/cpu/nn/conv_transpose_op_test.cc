@@ -260,6 +260,37 @@ TEST(ConvTransposeTest, ConvTranspose_2D_OutputShape_1) {
                       {kTensorrtExecutionProvider, kOpenVINOExecutionProvider, kQnnExecutionProvider});
 }
 
+// Each output channel of each group and image gets its own bias.
+TEST(ConvTransposeTest, ConvTranspose_2D_Bias_Group_Batch) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{2, 2},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{2, 2},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      2,                            // group
+      "NOTSET"                      // auto_pad
+  };
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f};
+  vector<int64_t> X_shape = {2, 2, 1, 1};
+  vector<float> W = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                     8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f};
+  vector<int64_t> W_shape = {2, 2, 2, 2};
+  vector<float> B = {1.0f, 2.0f, 3.0f, 4.0f};
+  vector<int64_t> B_shape = {4};
+  vector<int64_t> Y_shape = {2, 4, 2, 2};
+  auto expected_vals = {1.0f, 2.0f, 3.0f, 4.0f,
+                        6.0f, 7.0f, 8.0f, 9.0f,
+                        19.0f, 21.0f, 23.0f, 25.0f,
+                        28.0f, 30.0f, 32.0f, 34.0f,
+                        1.0f, 4.0f, 7.0f, 10.0f,
+                        14.0f, 17.0f, 20.0f, 23.0f,
+                        35.0f, 39.0f, 43.0f, 47.0f,
+                        52.0f, 56.0f, 60.0f, 64.0f};
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
 TEST(ConvTransposeTest, ConvTranspose_2D_OutputShape_1_group_2_for_tranpose_path) {
   ConvTransposeOpAttributes attrs = {
       vector<int64_t>{3, 3},        // kernel_shape
@@ -696,6 +696,24 @@ TEST(QLinearConvTest, Conv2D_U8S8_Pointwise) {
   test.Run();
 }
 
+TEST(QLinearConvTest, Conv2D_U8S8_Pointwise_PerChannel) {
+  // Symmetric pointwise convolutions run as a GEMM instead of the indirect
+  // convolution kernel on AMX capable processors.
+  for (int64_t output_channels : std::initializer_list<int64_t>{16, 96}) {
+    QLinearConvOpTester<uint8_t, int8_t> test;
+    test.GenerateRandomInput({2, 64, 14, 14}, .05f, 4);
+    test.GenerateRandomWeights({output_channels, 64, 1, 1}, .125f, 0);
+    std::vector<float> weight_scales;
+    for (int64_t i = 0; i < output_channels; i++) {
+      weight_scales.push_back(.10f + static_cast<float>(i) * .002f);
+    }
+    test.SetWeightScales(weight_scales);
+    test.GenerateRandomBias();
+    test.SetOutputScaleAndZeroPoint(.55f, 54);
+    test.Run();
+  }
+}
+
 TEST(QLinearConvTest, Conv2D_U8U8_Pointwise) {
   QLinearConvOpTester<uint8_t, uint8_t> test;
   test.GenerateRandomInput({3, 24, 19, 19}, .05f, 4);
@@ -383,5 +383,46 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+// selects more boxes than are compared at once, from several batches and classes. each batch has 40 boxes that don't
+// overlap, followed by a copy of each with a lower score, which is suppressed.
+TEST(NonMaxSuppressionOpTest, ManyBoxes_TwoBatches_TwoClasses) {
+  constexpr int64_t num_batches = 2;
+  constexpr int64_t num_classes = 2;
+  constexpr int64_t num_distinct_boxes = 40;
+  constexpr int64_t num_boxes = 2 * num_distinct_boxes;
+
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  std::vector<int64_t> selected_indices;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t i = 0; i < num_boxes; ++i) {
+      const float x = static_cast<float>(2 * (i % num_distinct_boxes) + batch);
+      boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    }
+
+    for (int64_t class_index = 0; class_index < num_classes; ++class_index) {
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        // the first class prefers the first boxes, the second class the last ones
+        const int64_t rank = class_index == 0 ? i % num_distinct_boxes : num_distinct_boxes - 1 - i % num_distinct_boxes;
+        const float score = 0.9f - 0.01f * static_cast<float>(rank);
+        scores.push_back(i < num_distinct_boxes ? score : score - 0.5f);
+      }
+
+      for (int64_t rank = 0; rank < num_distinct_boxes; ++rank) {
+        const int64_t box = class_index == 0 ? rank : num_distinct_boxes - 1 - rank;
+        selected_indices.insert(selected_indices.end(), {batch, class_index, box});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {100L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddOutput<int64_t>("selected_indices", {num_batches * num_classes * num_distinct_boxes, 3}, selected_indices);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -493,6 +493,56 @@ TEST(ReductionOpTest, ReduceL20DTensor) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// Reduces the middle axis of a [3, 19, 21] tensor, which takes the strided (KRK) fast path for float.
+TEST(ReductionOpTest, ReduceStridedMiddleAxis) {
+  constexpr int64_t d0 = 3, d1 = 19, d2 = 21;
+  std::vector<float> data(d0 * d1 * d2);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(static_cast<int>(i % 23) - 11) * 0.25f;
+  }
+
+  for (const char* op : {"ReduceL2", "ReduceLogSumExp", "ReduceSumSquare", "ReduceMax", "ReduceMean"}) {
+    const std::string op_type(op);
+    std::vector<float> expected(d0 * d2);
+    for (int64_t i = 0; i < d0; ++i) {
+      for (int64_t k = 0; k < d2; ++k) {
+        double sum = 0.0, sum_square = 0.0, maximum = -std::numeric_limits<double>::infinity();
+        for (int64_t j = 0; j < d1; ++j) {
+          const double v = data[(i * d1 + j) * d2 + k];
+          sum += v;
+          sum_square += v * v;
+          maximum = std::max(maximum, v);
+        }
+        double value;
+        if (op_type == "ReduceL2") {
+          value = std::sqrt(sum_square);
+        } else if (op_type == "ReduceLogSumExp") {
+          double sum_exp = 0.0;
+          for (int64_t j = 0; j < d1; ++j) {
+            sum_exp += std::exp(data[(i * d1 + j) * d2 + k] - maximum);
+          }
+          value = std::log(sum_exp) + maximum;
+        } else if (op_type == "ReduceSumSquare") {
+          value = sum_square;
+        } else if (op_type == "ReduceMax") {
+          value = maximum;
+        } else {
+          value = sum / d1;
+        }
+        expected[i * d2 + k] = static_cast<float>(value);
+      }
+    }
+
+    OpTester test(op, 13);
+    test.AddAttribute("axes", std::vector<int64_t>{1});
+    test.AddAttribute("keepdims", static_cast<int64_t>(0));
+    test.AddInput<float>("data", {d0, d1, d2}, data);
+    test.AddOutput<float>("reduced", {d0, d2}, expected);
+    test.SetOutputAbsErr("reduced", 1e-4f);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+}
+
 TEST(ReductionOpTest, ReduceLogSum) {
   OpTester test("ReduceLogSum");
   test.AddAttribute("axes", std::vector<int64_t>{1});
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -104,6 +105,71 @@ TEST(SignalOpsTest, DFT20_Float_inverse) {
   TestInverseFloat(kOpsetVersion20);
 }
 
+// Computes the DFT of each signal of `input` directly, as (real, imaginary) pairs.
+static vector<float> NaiveDFT(const vector<float>& input, int64_t num_signals, int64_t signal_length, bool complex,
+                              bool onesided, bool inverse) {
+  const int64_t components = complex ? 2 : 1;
+  const int64_t output_length = onesided ? (signal_length >> 1) + 1 : signal_length;
+  vector<float> output;
+  for (int64_t b = 0; b < num_signals; b++) {
+    const float* signal = input.data() + b * signal_length * components;
+    for (int64_t k = 0; k < output_length; k++) {
+      double real = 0, imaginary = 0;
+      for (int64_t n = 0; n < signal_length; n++) {
+        const double angle = (inverse ? 2 : -2) * M_PI * static_cast<double>((n * k) % signal_length) / signal_length;
+        const double x_real = signal[n * components];
+        const double x_imaginary = complex ? signal[n * components + 1] : 0;
+        real += x_real * std::cos(angle) - x_imaginary * std::sin(angle);
+        imaginary += x_real * std::sin(angle) + x_imaginary * std::cos(angle);
+      }
+      const double scale = inverse ? 1.0 / signal_length : 1.0;
+      output.push_back(static_cast<float>(real * scale));
+      output.push_back(static_cast<float>(imaginary * scale));
+    }
+  }
+  return output;
+}
+
+// Compares sizes that are transformed by each kind of pass, by several of them, and by Bluestein's algorithm
+// (prime factor above 13) with the DFT computed directly.
+static void TestDFTSizes(bool complex, bool onesided, bool inverse) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t num_batches = 3;
+  for (int64_t signal_length : {1, 2, 3, 6, 7, 12, 13, 17, 30, 64, 100, 400, 401}) {
+    OpTester test("DFT", kOpsetVersion20);
+    vector<int64_t> input_shape{num_batches, signal_length, complex ? 2 : 1};
+    vector<float> input = random.Uniform<float>(input_shape, -1.f, 1.f);
+    vector<float> expected_output = NaiveDFT(input, num_batches, signal_length, complex, onesided, inverse);
+
+    test.AddInput<float>("input", input_shape, input);
+    test.AddInput<int64_t>("", {0}, {});
+    test.AddInput<int64_t>("axis", {1}, {1});
+    test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+    test.AddAttribute<int64_t>("inverse", static_cast<int64_t>(inverse));
+    const int64_t output_length = onesided ? (signal_length >> 1) + 1 : signal_length;
+    test.AddOutput<float>("output", {num_batches, output_length, 2}, expected_output);
+    test.SetOutputAbsErr("output", 0.0005f);
+    test.Run();
+  }
+}
+
+TEST(SignalOpsTest, DFT20_sizes_real) {
+  TestDFTSizes(false, false, false);
+}
+
+TEST(SignalOpsTest, DFT20_sizes_real_onesided) {
+  TestDFTSizes(false, true, false);
+}
+
+TEST(SignalOpsTest, DFT20_sizes_complex) {
+  TestDFTSizes(true, false, false);
+}
+
+TEST(SignalOpsTest, DFT20_sizes_inverse) {
+  TestDFTSizes(false, false, true);
+  TestDFTSizes(true, false, true);
+}
+
 // Tests that FFT(FFT(x), inverse=true) == x
 static void TestDFTInvertible(bool complex, int since_version) {
   // TODO: test dft_length
@@ -221,6 +287,44 @@ TEST(SignalOpsTest, STFTFloat) {
   test.Run();
 }
 
+// Whisper's front end: frames of 400 samples with a hop of 160, over several batches.
+TEST(SignalOpsTest, STFTFloat_MixedRadixWindowed) {
+  OpTester test("STFT", kMinOpsetVersion);
+
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t signal_length = 2000;
+  constexpr int64_t frame_length = 400;
+  constexpr int64_t frame_step = 160;
+  constexpr int64_t num_frames = (signal_length - frame_length) / frame_step + 1;
+  constexpr int64_t output_length = frame_length / 2 + 1;
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<int64_t> signal_shape{batch_size, signal_length, 1};
+  vector<float> signal = random.Uniform<float>(signal_shape, -1.f, 1.f);
+  vector<float> window(frame_length);
+  for (int64_t n = 0; n < frame_length; n++) {
+    window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2 * M_PI * n / frame_length));
+  }
+
+  vector<float> frames;
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t f = 0; f < num_frames; f++) {
+      for (int64_t n = 0; n < frame_length; n++) {
+        frames.push_back(signal[b * signal_length + f * frame_step + n] * window[n]);
+      }
+    }
+  }
+  vector<float> expected_output = NaiveDFT(frames, batch_size * num_frames, frame_length, false, true, false);
+
+  test.AddInput<float>("signal", signal_shape, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", {frame_length}, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+  test.AddOutput<float>("output", {batch_size, num_frames, output_length, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.0005f);
+  test.Run();
+}
+
 TEST(SignalOpsTest, HannWindowFloat) {
   OpTester test("HannWindow", kMinOpsetVersion);
 
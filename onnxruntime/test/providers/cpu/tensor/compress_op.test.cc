@@ -115,6 +115,28 @@ TEST(CompressTest, Compress_default_axis_issue_9247_cumulative_sum_overflow) {
   test.Run();
 }
 
+// large enough condition for the selected values to be copied by several threads
+TEST(CompressTest, Compress_default_axis_large) {
+  OpTester test("Compress", 11);
+
+  constexpr int64_t elements = 100000;
+  std::vector<float> input(elements);
+  std::unique_ptr<bool[]> condition = std::make_unique<bool[]>(elements);
+  std::vector<float> output;
+  for (int64_t i = 0; i < elements; ++i) {
+    input[i] = static_cast<float>(i);
+    condition[i] = i % 3 != 1;
+    if (condition[i]) {
+      output.push_back(input[i]);
+    }
+  }
+
+  test.AddInput<float>("input", {elements}, input);
+  test.AddInput<bool>("condition", {elements}, condition.get(), elements);
+  test.AddOutput<float>("output", {static_cast<int64_t>(output.size())}, output);
+  test.Run();
+}
+
 TEST(CompressTest, Compress0_string) {
   OpTester test("Compress", 9);
 
@@ -4,6 +4,10 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
+
 namespace onnxruntime {
 namespace test {
 
@@ -426,5 +430,38 @@ TEST(ConcatOpTest, Concat4D_2) {
   test.Run();
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Concat accepts strided views at all its inputs, like the output of Expand with zero strides on the broadcast
+// dimensions.
+TEST(ConcatOpTest, StridedInputs) {
+  {
+    KernelComputeTester test("Concat");
+    test.AddAttribute<int64_t>("axis", 0);
+    test.AddInput<float>("input_0", {1, 3}, {4.f, 5.f, 6.f});
+    test.AddInput<float>("input_1", {3, 3}, {1.f, 2.f, 3.f}, {1, 0});
+    test.AddInput<float>("input_2", {2, 3}, {7.f, 8.f, 9.f}, {0, 1});
+    test.AddOutput<float>("output", {6, 3},
+                          {4.f, 5.f, 6.f,
+                           1.f, 1.f, 1.f,
+                           2.f, 2.f, 2.f,
+                           3.f, 3.f, 3.f,
+                           7.f, 8.f, 9.f,
+                           7.f, 8.f, 9.f});
+    test.Run();
+  }
+
+  {
+    KernelComputeTester test("Concat");
+    test.AddAttribute<int64_t>("axis", 1);
+    test.AddInput<float>("input_0", {2, 2}, {1.f, 2.f}, {1, 0});
+    test.AddInput<float>("input_1", {2, 1}, {3.f, 4.f});
+    test.AddOutput<float>("output", {2, 3},
+                          {1.f, 1.f, 3.f,
+                           2.f, 2.f, 4.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
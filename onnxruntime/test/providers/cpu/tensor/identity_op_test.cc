@@ -16,6 +16,20 @@ TEST(Identity, FloatType) {
   test.Run();
 }
 
+// Larger than the pinned staging chunks of the CUDA data transfer and not a multiple of them, so the copies of
+// the input and output are split across both staging buffers with a partial last chunk.
+TEST(Identity, LargeFloatType) {
+  OpTester test("Identity", 9, kOnnxDomain);
+  constexpr int64_t size = 3 * 1024 * 1024 + 17;
+  std::vector<float> data(size);
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<float>(i % 1021);
+  }
+  test.AddInput<float>("X", {size}, data);
+  test.AddOutput<float>("Y", {size}, data);
+  test.Run();
+}
+
 TEST(Identity, StringType) {
   OpTester test("Identity", 10, kOnnxDomain);
   std::vector<int64_t> dims{2, 2};
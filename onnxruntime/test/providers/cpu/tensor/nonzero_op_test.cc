@@ -88,6 +88,30 @@ TEST(NonZeroOpTest, Scalar) {
   }
 }
 
+// large enough input for the non-zero values to be gathered by several threads
+TEST(NonZeroOpTest, Large) {
+  constexpr int64_t rows = 300;
+  constexpr int64_t cols = 1000;
+  std::vector<float> X(rows * cols, 0.f);
+  std::vector<int64_t> row_coords;
+  std::vector<int64_t> col_coords;
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = (r % 3); c < cols; c += 7) {
+      X[r * cols + c] = 1.f;
+      row_coords.push_back(r);
+      col_coords.push_back(c);
+    }
+  }
+
+  std::vector<int64_t> Y(row_coords);
+  Y.insert(Y.end(), col_coords.begin(), col_coords.end());
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<float>("X", {rows, cols}, X);
+  test.AddOutput<int64_t>("Y", {2, static_cast<int64_t>(row_coords.size())}, Y);
+  test.Run();
+}
+
 TEST(NonZeroOpTest, EmptyInput) {
   OpTester test{kOpName, kOpVersion};
   test.AddInput<int32_t>(
@@ -432,6 +432,40 @@ TEST(QuantizeLinearOpTest, Per_Channel_Axis_neg) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT doesn't support support UINT8 for quantization
 }
 
+// per-channel on the last axis of a tensor large enough to be split across threads mid-channel
+TEST(QuantizeLinearOpTest, Per_Channel_Last_Axis_Large) {
+  constexpr int64_t rows = 2000;
+  const std::vector<float> scales{1, 2, 4, 8};
+  const std::vector<uint8_t> zero_points{0, 10, 20, 30};
+  const int64_t channels = static_cast<int64_t>(scales.size());
+
+  std::vector<float> x;
+  std::vector<uint8_t> y;
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < channels; ++c) {
+      const float value = static_cast<float>(8 * (r % 30));
+      x.push_back(value);
+      y.push_back(static_cast<uint8_t>(value / scales[c] + zero_points[c]));
+    }
+  }
+
+  OpTester quantize("QuantizeLinear", 13);
+  quantize.AddAttribute<int64_t>("axis", 1);
+  quantize.AddInput<float>("x", {rows, channels}, x);
+  quantize.AddInput<float>("y_scale", {channels}, scales);
+  quantize.AddInput<uint8_t>("y_zero_point", {channels}, zero_points);
+  quantize.AddOutput<uint8_t>("y", {rows, channels}, y);
+  quantize.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  OpTester dequantize("DequantizeLinear", 13);
+  dequantize.AddAttribute<int64_t>("axis", 1);
+  dequantize.AddInput<uint8_t>("x", {rows, channels}, y);
+  dequantize.AddInput<float>("x_scale", {channels}, scales);
+  dequantize.AddInput<uint8_t>("x_zero_point", {channels}, zero_points);
+  dequantize.AddOutput<float>("y", {rows, channels}, x);
+  dequantize.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #if !defined(DISABLE_FLOAT8_TYPES)
 
 template <typename InT, typename OutT>
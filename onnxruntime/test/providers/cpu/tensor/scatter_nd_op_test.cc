@@ -48,6 +48,30 @@ TEST(ScatterNDOpTest, ScatterND_matrice_int64_int64_neg_indices) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kOpenVINOExecutionProvider});  // Output mismatch with OpenVINO EP
 }
 
+TEST(ScatterNDOpTest, ScatterND_reduction_add_duplicate_indices) {
+  // Several updates of the same slices, large enough for the reduction to be split across threads.
+  constexpr int64_t rows = 4, cols = 5000, num_updates = 6;
+  std::vector<float> data(rows * cols, 1.0f);
+  std::vector<int64_t> indices{1, 3, 1, -3, 0, 3};
+  std::vector<float> updates(num_updates * cols);
+  std::vector<float> expected(data);
+  for (int64_t u = 0; u < num_updates; ++u) {
+    const int64_t row = indices[u] < 0 ? indices[u] + rows : indices[u];
+    for (int64_t c = 0; c < cols; ++c) {
+      updates[u * cols + c] = static_cast<float>(u + 1) + static_cast<float>(c % 7);
+      expected[row * cols + c] += updates[u * cols + c];
+    }
+  }
+
+  OpTester test("ScatterND", 16);
+  test.AddAttribute<std::string>("reduction", "add");
+  test.AddInput<float>("data", {rows, cols}, data);
+  test.AddInput<int64_t>("indices", {num_updates, 1}, indices);
+  test.AddInput<float>("updates", {num_updates, cols}, updates);
+  test.AddOutput<float>("output", {rows, cols}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
 TEST(ScatterNDOpTest, ScatterND_matrice_string_int64) {
   OpTester test1("ScatterND", 11);
   test1.AddInput<std::string>("data", {2, 2, 2}, {"egg", "dance", "bob", "air", "smart", "terry", "laugh", "kite"});
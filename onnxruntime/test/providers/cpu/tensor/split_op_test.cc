@@ -5,6 +5,10 @@
 #include "core/framework/to_tensor_proto_element_type.h"
 #include "test/providers/provider_test_utils.h"
 
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
+
 namespace onnxruntime {
 namespace test {
 
@@ -815,5 +819,28 @@ TEST(SplitOperatorTest, Split18_NumOutputsUnevenSplitAxis1) {
   RunTest<float>(axis, {}, input, outputs, {kTensorrtExecutionProvider, kQnnExecutionProvider}, false, true, num_outputs, false);
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Split accepts a strided view at its input, like the output of Expand with zero strides on the broadcast dimensions.
+TEST(SplitOperatorTest, StridedInput) {
+  {
+    KernelComputeTester test("Split");
+    test.AddAttribute<int64_t>("axis", 1);
+    test.AddInput<float>("input", {3, 4}, {1.f, 2.f, 3.f}, {1, 0});
+    test.AddOutput<float>("output_0", {3, 2}, {1.f, 1.f, 2.f, 2.f, 3.f, 3.f});
+    test.AddOutput<float>("output_1", {3, 2}, {1.f, 1.f, 2.f, 2.f, 3.f, 3.f});
+    test.Run();
+  }
+
+  {
+    KernelComputeTester test("Split");
+    test.AddAttribute<int64_t>("axis", 0);
+    test.AddInput<float>("input", {2, 3}, {1.f, 2.f, 3.f}, {0, 1});
+    test.AddOutput<float>("output_0", {1, 3}, {1.f, 2.f, 3.f});
+    test.AddOutput<float>("output_1", {1, 3}, {1.f, 2.f, 3.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -641,6 +641,39 @@ TEST(TransposeOpTest, NDim) {
   TransposeTest(input_shape, input_vals, &perm, input_shape, expected_vals2);
 }
 
+// Large enough for the blocked N-D transpose to use its vector kernels and to split the work.
+template <class T>
+static void TransposeNDimLargeTest() {
+  std::vector<int64_t> input_shape({3, 37, 5, 41});
+  std::vector<int64_t> perm = {3, 0, 2, 1};
+  std::vector<int64_t> expected_shape({41, 3, 5, 37});
+
+  std::vector<T> input_vals(3 * 37 * 5 * 41);
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<T>(i % 251);
+  }
+
+  std::vector<T> expected_vals;
+  expected_vals.reserve(input_vals.size());
+  for (int64_t d3 = 0; d3 < 41; ++d3) {
+    for (int64_t d0 = 0; d0 < 3; ++d0) {
+      for (int64_t d2 = 0; d2 < 5; ++d2) {
+        for (int64_t d1 = 0; d1 < 37; ++d1) {
+          expected_vals.push_back(input_vals[((d0 * 37 + d1) * 5 + d2) * 41 + d3]);
+        }
+      }
+    }
+  }
+
+  TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals);
+}
+
+TEST(TransposeOpTest, NDimLarge) {
+  TransposeNDimLargeTest<uint8_t>();
+  TransposeNDimLargeTest<int16_t>();
+  TransposeNDimLargeTest<float>();
+}
+
 TEST(TransposeOpTest, DoTransposeImpl) {
   std::vector<int64_t> input_shape({5, 2, 1, 3});
   std::vector<float> input_vals(30);
@@ -370,6 +370,48 @@ TEST(Unique, InvalidAxis) {
   test.Run(OpTester::ExpectResult::kExpectFailure, "[ShapeInferenceError] Invalid value for attribute axis");
 }
 
+// large enough input for the unique values to be found by several threads
+TEST(Unique, Flatten_Large) {
+  constexpr int64_t num_unique = 1000;
+  constexpr int64_t size = 200 * num_unique;
+  const std::vector<int64_t> X_dims{size};
+  std::vector<int64_t> X(size);
+  for (int64_t i = 0; i < size; ++i) {
+    // 7 and num_unique are coprime so the first num_unique values are all different
+    X[i] = (i * 7) % num_unique;
+  }
+
+  const std::vector<int64_t> unique_dims{num_unique};
+  const std::vector<int64_t> counts(num_unique, size / num_unique);
+  std::vector<int64_t> Y(num_unique);
+  std::vector<int64_t> indices(num_unique);
+  std::vector<int64_t> inverse_indices(size);
+
+  // unsorted
+  for (int64_t i = 0; i < num_unique; ++i) {
+    Y[i] = X[i];
+    indices[i] = i;
+  }
+  for (int64_t i = 0; i < size; ++i) {
+    inverse_indices[i] = i % num_unique;
+  }
+
+  RunUniqueTest<int64_t>(X_dims, X, nullptr, false, unique_dims, Y, unique_dims, indices,
+                         X_dims, inverse_indices, unique_dims, counts);
+
+  // sorted. 143 is the inverse of 7 modulo num_unique.
+  for (int64_t i = 0; i < num_unique; ++i) {
+    Y[i] = i;
+    indices[i] = (i * 143) % num_unique;
+  }
+  for (int64_t i = 0; i < size; ++i) {
+    inverse_indices[i] = X[i];
+  }
+
+  RunUniqueTest<int64_t>(X_dims, X, nullptr, true, unique_dims, Y, unique_dims, indices,
+                         X_dims, inverse_indices, unique_dims, counts);
+}
+
 // check empty input is gracefully handled
 TEST(Unique, EmptyInput) {
   const std::vector<int64_t> X_dims{0};
@@ -104,6 +104,30 @@ TEST(StringSplit, OnlyEmptyNoDelimiterInputTest) {
   test.Run();
 }
 
+TEST(StringSplit, ManyStringsTest) {
+  // Enough strings to be split in parallel
+  OpTester test("StringSplit", 20);
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  std::vector<int64_t> num_tokens;
+  for (int i = 0; i < 1000; ++i) {
+    const std::string token = std::to_string(i);
+    if (i % 2 == 0) {
+      input.push_back(token + "  " + token + " ");
+      output.insert(output.end(), {token, token});
+      num_tokens.push_back(2);
+    } else {
+      input.push_back(" " + token);
+      output.insert(output.end(), {token, ""});
+      num_tokens.push_back(1);
+    }
+  }
+  test.AddInput<std::string>("X", {1000}, input);
+  test.AddOutput<std::string>("Y", {1000, 2}, output);
+  test.AddOutput<int64_t>("Z", {1000}, num_tokens);
+  test.Run();
+}
+
 TEST(StringSplit, NoInputTest) {
   OpTester test("StringSplit", 20);
   test.AddInput<std::string>("X", {
@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/framework/allocator.h"
+#include "core/framework/stream_handles.h"
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/cuda_common.h"
 
@@ -113,5 +114,44 @@ TEST(AllocatorTest, CUDAAllocatorFallbackTest) {
   auto last_error = cudaGetLastError();
   EXPECT_EQ(last_error, cudaSuccess) << "Last error should be cleared if handled gracefully";
 }
+
+namespace {
+struct CudaStreamForTest : public Stream {
+  CudaStreamForTest(cudaStream_t stream, const OrtDevice& device) : Stream(stream, device) {}
+};
+}  // namespace
+
+TEST(AllocatorTest, CUDAMemPoolAllocatorTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+
+  CUDAMemPoolAllocator allocator(cuda_device_id, CUDA, 64 * 1024 * 1024);
+  EXPECT_EQ(allocator.Info().alloc_type, OrtDeviceAllocator);
+  EXPECT_TRUE(allocator.IsStreamOrdered());
+  EXPECT_EQ(allocator.Alloc(0), nullptr);
+
+  cudaStream_t cuda_stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+  CudaStreamForTest stream(cuda_stream, allocator.Info().device);
+
+  // The memory freed on a stream is reused by the next allocation of the same size on that stream.
+  void* p0 = allocator.AllocOnStreamOrdered(1024, &stream);
+  EXPECT_TRUE(p0);
+  CUDA_CALL_THROW(cudaMemsetAsync(p0, 0, 1024, cuda_stream));
+  allocator.Free(p0);
+  void* p1 = allocator.AllocOnStreamOrdered(1024, &stream);
+  EXPECT_EQ(p0, p1);
+
+  // Once the stream is released, the buffers still alive are freed synchronously.
+  void* p2 = allocator.Alloc(2048);
+  EXPECT_TRUE(p2);
+  CUDA_CALL_THROW(cudaStreamSynchronize(cuda_stream));
+  allocator.ReleaseStreamOrderedBuffers(&stream);
+  CUDA_CALL_THROW(cudaStreamDestroy(cuda_stream));
+  allocator.Free(p1);
+  allocator.Free(p2);
+
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -75,6 +75,8 @@ struct ProviderInfo_CUDA_TestImpl : ProviderInfo_CUDA {
   void cudaMemcpy_DeviceToHost(void*, const void*, size_t) override {}
 
   int cudaGetDeviceCount() override { return 0; }
+  int cudaPointerGetDevice(const void*) override { return 0; }
+  void cudaStreamSynchronize(void*) override {}
 
   void CUDAExecutionProviderInfo__FromProviderOptions(const ProviderOptions&, CUDAExecutionProviderInfo&) override {}
 
@@ -563,6 +563,17 @@ TEST(NnapiExecutionProviderTest, ActivationOutsideOfPartition) {
                                    << "Exactly one node should have been taken by the NNAPI EP"; });
 }
 
+// test that the minimum partition size does not drop the only NNAPI partition
+TEST(NnapiExecutionProviderTest, MinPartitionSizeKeepsSinglePartition) {
+  constexpr auto* model_file_name = ORT_TSTR("testdata/mnist.basic.ort");
+  const auto nnapi_partitioning_stop_ops = "Relu";
+  TestModelLoad(
+      model_file_name,
+      std::make_unique<NnapiExecutionProvider>(0, nnapi_partitioning_stop_ops, "", /* min_partition_size */ 2),
+      [](const Graph& graph) { ASSERT_EQ(CountAssignedNodes(graph, kNnapiExecutionProvider), 1)
+                                   << "The only NNAPI partition should have been kept"; });
+}
+
 }  // namespace test
 }  // namespace onnxruntime
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
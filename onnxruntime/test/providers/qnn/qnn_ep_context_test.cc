@@ -159,6 +159,94 @@ TEST_F(QnnHTPBackendTests, QnnContextBinaryMultiPartitionSupport2) {
   QnnContextBinaryMultiPartitionTestBody(single_ep_node);
 }
 
+// Creates a model with a copy of ep_context_node as its only node.
+static void SaveEpContextNodeAsModel(const Node& ep_context_node, std::string& model_data) {
+  const std::unordered_map<std::string, int> domain_to_version = {{"", 13}, {kMSDomain, 1}};
+  onnxruntime::Model model("QNN_EP_Shared_Context_TestModel", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), domain_to_version, {},
+                           DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  auto copy_args = [&graph](ConstPointerContainer<std::vector<NodeArg*>> args) {
+    std::vector<NodeArg*> copies;
+    for (const NodeArg* arg : args) {
+      copies.push_back(&graph.GetOrCreateNodeArg(arg->Name(), arg->TypeAsProto()));
+    }
+    return copies;
+  };
+
+  NodeAttributes attributes = ep_context_node.GetAttributes();
+  graph.AddNode(ep_context_node.Name(), ep_context_node.OpType(), "", copy_args(ep_context_node.InputDefs()),
+                copy_args(ep_context_node.OutputDefs()), &attributes, ep_context_node.Domain());
+  ASSERT_STATUS_OK(graph.Resolve());
+  model.ToProto().SerializeToString(&model_data);
+}
+
+// Test that the graphs of a context binary with 2 graphs can be used by 2 sessions that share the QNN context.
+// The session of the 2nd graph has no EPContext node with the context binary, so it can only use the context loaded
+// by the session of the 1st graph.
+TEST_F(QnnHTPBackendTests, QnnContextBinaryShareEpContexts) {
+  ProviderOptions provider_options;
+#if defined(_WIN32)
+  provider_options["backend_path"] = "QnnHtp.dll";
+#else
+  provider_options["backend_path"] = "libQnnHtp.so";
+#endif
+
+  const std::unordered_map<std::string, int> domain_to_version = {{"", 13}, {kMSDomain, 1}};
+
+  auto& logging_manager = DefaultLoggingManager();
+  logging_manager.SetDefaultLoggerSeverity(logging::Severity::kERROR);
+
+  onnxruntime::Model model("QNN_EP_TestModel", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), domain_to_version, {},
+                           logging_manager.DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder helper(graph);
+  BuildGraphWithQAndNonQ(false)(helper);
+  helper.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  // generate the context model with 2 EPContext nodes, the 1st one has the context binary with both graphs
+  const std::string context_binary_file = "./qnn_context_binary_share_ep_contexts_test.onnx";
+  std::remove(context_binary_file.c_str());
+  {
+    Ort::SessionOptions so;
+    so.AddConfigEntry(kOrtSessionOptionEpContextEnable, "1");
+    so.AddConfigEntry(kOrtSessionOptionEpContextFilePath, context_binary_file.c_str());
+    so.AppendExecutionProvider("QNN", provider_options);
+    Ort::Session session(*ort_env, model_data.data(), model_data.size(), so);
+  }
+
+  std::shared_ptr<Model> ctx_model;
+  ASSERT_STATUS_OK(Model::Load(ToPathString(context_binary_file), ctx_model, nullptr,
+                               logging_manager.DefaultLogger()));
+  std::vector<const Node*> ep_context_nodes;
+  for (const auto& node : ctx_model->MainGraph().Nodes()) {
+    if (node.OpType() == "EPContext") {
+      ep_context_nodes.push_back(&node);
+    }
+  }
+  ASSERT_EQ(ep_context_nodes.size(), 2u);
+
+  std::string main_model_data;
+  std::string other_model_data;
+  SaveEpContextNodeAsModel(*ep_context_nodes[0], main_model_data);
+  SaveEpContextNodeAsModel(*ep_context_nodes[1], other_model_data);
+
+  Ort::SessionOptions so;
+  so.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+  so.AppendExecutionProvider("QNN", provider_options);
+
+  Ort::Session main_session(*ort_env, main_model_data.data(), main_model_data.size(), so);
+  Ort::Session other_session(*ort_env, other_model_data.data(), other_model_data.size(), so);
+
+  ASSERT_EQ(std::remove(context_binary_file.c_str()), 0);
+}
+
 // Create a model with Case + Add (quantized)
 // cast_input -> Cast -> Q -> DQ \
 //                                Add -> Q -> DQ -> output
@@ -89,6 +89,29 @@ TEST(XnnpackEP, TestNhwcConvReluClipFusion) {
   RunAndVerifyOutputsWithEP(ort_model_path, "TestNhwcConvReluClipFusion", std::move(ep), feeds, params);
 }
 
+// the Conv, Clip and Relu nodes are connected, so they can be compiled into XNNPACK subgraphs
+TEST(XnnpackEP, TestNhwcConvReluClipFuseSubgraphs) {
+  const ORTCHAR_T* ort_model_path = ORT_MODEL_FOLDER "nhwc_conv_clip_relu.onnx";
+
+  RandomValueGenerator generator;
+  TensorShape input_shape_x{1, 16, 16, 192};
+  std::vector<float> input_x = generator.Uniform<float>(input_shape_x.GetDims(), -128, 128);
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(input_shape_x.GetDims(), input_x.data(), OrtMemoryInfo(), &ml_value_x);
+
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("model_input", ml_value_x));
+
+  EPVerificationParams params;
+  params.ep_node_assignment = ExpectedEPNodeAssignment::All;
+  params.fp32_abs_err = 0.0002f;
+
+  XnnpackExecutionProviderInfo info{{{"fuse_subgraphs", "1"}}, nullptr};
+  RunAndVerifyOutputsWithEP(ort_model_path, "TestNhwcConvReluClipFuseSubgraphs",
+                            std::make_unique<XnnpackExecutionProvider>(info), feeds, params);
+}
+
 // test we can share the cpu ep allocator with the xnnpack EP
 TEST(XnnpackEP, TestAllocatorSharing) {
   auto init_session = [](std::vector<std::shared_ptr<IExecutionProvider>>& eps,
@@ -125,6 +148,57 @@ TEST(XnnpackEP, TestAllocatorSharing) {
   // TODO(leca): should also check there is only 1 allocator in session1.GetSessionState().GetAllocators() which is used by both xnnpack EP and CPU EP
 }
 
+// sessions of the same model using EPs with the shared_weights_cache option should pack the weights once
+TEST(XnnpackEP, TestSharedWeightsCache) {
+  const ORTCHAR_T* ort_model_path = ORT_MODEL_FOLDER "nhwc_conv_clip_relu.onnx";
+
+  RandomValueGenerator generator;
+  TensorShape input_shape_x{1, 16, 16, 192};
+  std::vector<float> input_x = generator.Uniform<float>(input_shape_x.GetDims(), -128, 128);
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(input_shape_x.GetDims(), input_x.data(), OrtMemoryInfo(), &ml_value_x);
+
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("model_input", ml_value_x));
+
+  auto run_session = [&](InferenceSessionWrapper& session, const std::shared_ptr<XnnpackExecutionProvider>& ep,
+                         std::vector<OrtValue>& fetches) {
+    ASSERT_STATUS_OK(session.RegisterExecutionProvider(ep));
+    ASSERT_STATUS_OK(session.Load(ort_model_path));
+    ASSERT_STATUS_OK(session.Initialize());
+
+    std::vector<std::string> output_names;
+    for (const auto* output : *session.GetModelOutputs().second) {
+      output_names.push_back(output->Name());
+    }
+    ASSERT_STATUS_OK(session.Run(feeds, output_names, &fetches));
+  };
+
+  XnnpackExecutionProviderInfo info{{{"shared_weights_cache", "1"}}, nullptr};
+  auto ep1 = std::make_shared<XnnpackExecutionProvider>(info);
+  auto ep2 = std::make_shared<XnnpackExecutionProvider>(info);
+
+  SessionOptions so;
+  InferenceSessionWrapper session1(so, GetEnvironment());
+  InferenceSessionWrapper session2(so, GetEnvironment());
+  std::vector<OrtValue> fetches1;
+  std::vector<OrtValue> fetches2;
+  run_session(session1, ep1, fetches1);
+  // the cache is finalized now, so the second session can only reuse the weights of the first one
+  run_session(session2, ep2, fetches2);
+
+  ASSERT_NE(ep1->GetSharedWeightsCache(), nullptr);
+  ASSERT_EQ(ep1->GetSharedWeightsCache(), ep2->GetSharedWeightsCache());
+
+  ASSERT_EQ(fetches1.size(), fetches2.size());
+  for (size_t i = 0; i < fetches1.size(); ++i) {
+    auto output1 = fetches1[i].Get<Tensor>().DataAsSpan<float>();
+    auto output2 = fetches2[i].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_TRUE(SpanEq(output1, output2));
+  }
+}
+
 TEST(XnnpackEP, TestAddEpUsingPublicApi) {
   {
     // C++ API test
@@ -9,6 +9,7 @@
 #include <atomic>
 #include <mutex>
 #include <algorithm>
+#include <numeric>
 #include <thread>
 
 #include <absl/base/config.h>
@@ -2082,6 +2083,211 @@ TEST(CApiTest, basic_cuda_graph) {
 #endif
 }
 
+#if defined(USE_CUDA)
+TEST(CApiTest, cuda_graph_per_input_shape) {
+  const auto& api = Ort::GetApi();
+  Ort::SessionOptions session_options;
+
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"enable_cuda_graph", "cuda_graph_max_num_graphs"};
+  std::vector<const char*> values{"1", "2"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), keys.size()) == nullptr);
+
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+  Ort::MemoryInfo info_mem("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemTypeDefault);
+  Ort::Allocator allocator(session, info_mem);
+
+  // One binding per batch size, each batch size gets its own graph annotated by the input shape.
+  struct Batch {
+    std::array<int64_t, 2> shape;
+    std::vector<float> x_values;
+    Ort::MemoryAllocation input_data;
+    Ort::MemoryAllocation output_data;
+    std::unique_ptr<Ort::IoBinding> binding;
+  };
+
+  auto make_batch = [&](int64_t batch_size) {
+    Batch batch{{batch_size, 2}, std::vector<float>(static_cast<size_t>(batch_size) * 2),
+                allocator.GetAllocation(static_cast<size_t>(batch_size) * 2 * sizeof(float)),
+                allocator.GetAllocation(static_cast<size_t>(batch_size) * 2 * sizeof(float)), nullptr};
+    std::iota(batch.x_values.begin(), batch.x_values.end(), 1.0f);
+    (void)cudaMemcpy(batch.input_data.get(), batch.x_values.data(), sizeof(float) * batch.x_values.size(),
+                     cudaMemcpyHostToDevice);
+    batch.binding = std::make_unique<Ort::IoBinding>(session);
+    batch.binding->BindInput("X", Ort::Value::CreateTensor(info_mem, reinterpret_cast<float*>(batch.input_data.get()),
+                                                          batch.x_values.size(), batch.shape.data(),
+                                                          batch.shape.size()));
+    batch.binding->BindOutput("Y", Ort::Value::CreateTensor(info_mem, reinterpret_cast<float*>(batch.output_data.get()),
+                                                           batch.x_values.size(), batch.shape.data(),
+                                                           batch.shape.size()));
+    return batch;
+  };
+
+  auto check_batch = [](Batch& batch) {
+    std::vector<float> y_values(batch.x_values.size());
+    (void)cudaMemcpy(y_values.data(), batch.output_data.get(), sizeof(float) * y_values.size(),
+                     cudaMemcpyDeviceToHost);
+    for (size_t i = 0; i < y_values.size(); ++i) {
+      ASSERT_EQ(y_values[i], batch.x_values[i] * batch.x_values[i]);
+    }
+  };
+
+  std::vector<Batch> batches;
+  batches.push_back(make_batch(3));
+  batches.push_back(make_batch(1));
+  batches.push_back(make_batch(4));
+
+  // The first run of each batch size captures its graph, the following ones replay it.
+  // The third batch size evicts the graph of the first one, which is captured again.
+  for (int iteration = 0; iteration < 3; ++iteration) {
+    for (auto& batch : batches) {
+      session.Run(Ort::RunOptions(), *batch.binding);
+      check_batch(batch);
+    }
+  }
+
+  // A user annotation replaces the input shapes.
+  Ort::RunOptions run_options;
+  run_options.AddConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation, "batch_1");
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    session.Run(run_options, *batches[1].binding);
+    check_batch(batches[1]);
+  }
+
+  for (auto& batch : batches) {
+    batch.binding->ClearBoundInputs();
+    batch.binding->ClearBoundOutputs();
+  }
+}
+#endif
+
+#if defined(USE_CUDA)
+TEST(CApiTest, cuda_graph_rebind_buffers) {
+  const auto& api = Ort::GetApi();
+  Ort::SessionOptions session_options;
+
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"enable_cuda_graph"};
+  std::vector<const char*> values{"1"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), keys.size()) == nullptr);
+
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+  Ort::MemoryInfo info_mem("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemTypeDefault);
+  Ort::Allocator allocator(session, info_mem);
+
+  const std::array<int64_t, 2> shape = {3, 2};
+  auto run_with_new_buffers = [&](float scale) {
+    std::array<float, 3 * 2> x_values;
+    for (size_t i = 0; i < x_values.size(); ++i) {
+      x_values[i] = scale * static_cast<float>(i + 1);
+    }
+    auto input_data = allocator.GetAllocation(x_values.size() * sizeof(float));
+    auto output_data = allocator.GetAllocation(x_values.size() * sizeof(float));
+    (void)cudaMemcpy(input_data.get(), x_values.data(), sizeof(float) * x_values.size(), cudaMemcpyHostToDevice);
+
+    Ort::IoBinding binding(session);
+    binding.BindInput("X", Ort::Value::CreateTensor(info_mem, reinterpret_cast<float*>(input_data.get()),
+                                                    x_values.size(), shape.data(), shape.size()));
+    binding.BindOutput("Y", Ort::Value::CreateTensor(info_mem, reinterpret_cast<float*>(output_data.get()),
+                                                     x_values.size(), shape.data(), shape.size()));
+    session.Run(Ort::RunOptions(), binding);
+
+    std::array<float, 3 * 2> y_values;
+    (void)cudaMemcpy(y_values.data(), output_data.get(), sizeof(float) * y_values.size(), cudaMemcpyDeviceToHost);
+    for (size_t i = 0; i < y_values.size(); ++i) {
+      ASSERT_EQ(y_values[i], x_values[i] * x_values[i]);
+    }
+
+    binding.ClearBoundInputs();
+    binding.ClearBoundOutputs();
+  };
+
+  // The first run captures the graph, the next ones replay it with the input and output bound to other buffers.
+  for (int i = 0; i < 4; ++i) {
+    run_with_new_buffers(static_cast<float>(i + 1));
+  }
+}
+#endif
+
+#if defined(USE_CUDA)
+TEST(CApiTest, cuda_graph_per_thread) {
+  const auto& api = Ort::GetApi();
+  Ort::SessionOptions session_options;
+
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"enable_cuda_graph", "enable_cuda_graph_per_thread"};
+  std::vector<const char*> values{"1", "1"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), keys.size()) == nullptr);
+
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+  Ort::MemoryInfo info_mem("Cuda", OrtAllocatorType::OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  Ort::Allocator allocator(session, info_mem);
+
+  // Each thread binds its own buffers and captures its own graph, then replays it concurrently with the others.
+  auto run_thread = [&](float scale, std::atomic<bool>& failed) {
+    const std::array<int64_t, 2> shape = {3, 2};
+    std::array<float, 3 * 2> x_values;
+    for (size_t i = 0; i < x_values.size(); ++i) {
+      x_values[i] = scale * static_cast<float>(i + 1);
+    }
+    auto input_data = allocator.GetAllocation(x_values.size() * sizeof(float));
+    auto output_data = allocator.GetAllocation(x_values.size() * sizeof(float));
+    (void)cudaMemcpy(input_data.get(), x_values.data(), sizeof(float) * x_values.size(), cudaMemcpyHostToDevice);
+
+    Ort::IoBinding binding(session);
+    binding.BindInput("X", Ort::Value::CreateTensor(info_mem, reinterpret_cast<float*>(input_data.get()),
+                                                    x_values.size(), shape.data(), shape.size()));
+    binding.BindOutput("Y", Ort::Value::CreateTensor(info_mem, reinterpret_cast<float*>(output_data.get()),
+                                                     x_values.size(), shape.data(), shape.size()));
+
+    for (int iteration = 0; iteration < 10; ++iteration) {
+      session.Run(Ort::RunOptions(), binding);
+      std::array<float, 3 * 2> y_values;
+      (void)cudaMemcpy(y_values.data(), output_data.get(), sizeof(float) * y_values.size(), cudaMemcpyDeviceToHost);
+      for (size_t i = 0; i < y_values.size(); ++i) {
+        if (y_values[i] != x_values[i] * x_values[i]) {
+          failed = true;
+        }
+      }
+    }
+
+    binding.ClearBoundInputs();
+    binding.ClearBoundOutputs();
+  };
+
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(run_thread, static_cast<float>(i + 1), std::ref(failed));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_FALSE(failed);
+}
+#endif
+
 // The following test uses some ops not supported in the reduced ops build
 #ifndef REDUCED_OPS_BUILD
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
@@ -3858,3 +4064,43 @@ TEST(CApiTest, RunAsyncFail) {
   Ort::RunOptions run_options;
   EXPECT_THROW(session.RunAsync(run_options, input_names, input_tensors, 1, output_names, output_values, 1, CallbackFail, nullptr), std::exception);
 }
+
+TEST(CApiTest, RunAsyncOnInterOpThreadPool) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(1);  // not enough for RunAsync on the intra-op pool
+  session_options.SetInterOpNumThreads(2);
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigRunAsyncOnInterOpThreadPool, "1");
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  const char* input_names[] = {"X"};
+  float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  int64_t x_dim[] = {3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+  Ort::Value input_tensors[1] = {
+      Ort::Value::CreateTensor<float>(memory_info, x_value, 6, x_dim, 2),
+  };
+
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+  Ort::Value output_values[1] = {Ort::Value{nullptr}};
+
+  atomic_wait.store(false);
+  EXPECT_NO_THROW(session.RunAsync(run_options,
+                                   input_names,
+                                   input_tensors,
+                                   1,
+                                   output_names,
+                                   output_values,
+                                   1,
+                                   CallbackSucceed,
+                                   &caller_tid));
+
+  std::chrono::duration<double, std::milli> dur{100};
+  // timeout in about 10 secs
+  for (int i = 0; i < 100 && !atomic_wait.load(); ++i) {
+    std::this_thread::sleep_for(dur);
+  }
+
+  EXPECT_EQ(atomic_wait.load(), true);
+}
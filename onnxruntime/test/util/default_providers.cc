@@ -18,8 +18,12 @@ namespace onnxruntime {
 
 namespace test {
 
-std::unique_ptr<IExecutionProvider> DefaultCpuExecutionProvider(bool enable_arena) {
-  return CPUProviderFactoryCreator::Create(enable_arena)->CreateProvider();
+std::unique_ptr<IExecutionProvider> DefaultCpuExecutionProvider(bool enable_arena, bool test_tunable_op) {
+  auto provider = CPUProviderFactoryCreator::Create(enable_arena)->CreateProvider();
+  if (test_tunable_op) {
+    provider->GetTuningContext()->EnableTunableOpAndTuning();
+  }
+  return provider;
 }
 
 std::unique_ptr<IExecutionProvider> DefaultTensorrtExecutionProvider() {
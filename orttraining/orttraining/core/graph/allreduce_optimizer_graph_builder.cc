@@ -3,6 +3,10 @@
 
 #include "orttraining/core/graph/allreduce_optimizer_graph_builder.h"
 
+#include <algorithm>
+#include <numeric>
+
+#include "core/framework/tensorprotoutils.h"
 #include "orttraining/core/framework/distributed_run_context.h"
 
 namespace onnxruntime {
@@ -19,7 +23,8 @@ static bool IsNcclAvailable() {
 static Status AddNcclAllReduceForGradients(
     std::vector<ArgDef>& gradient_argdefs,
     std::vector<ArgDef>& input_gradient_argdef,
-    GraphAugmenter::GraphDefs& graph_defs) {
+    GraphAugmenter::GraphDefs& graph_defs,
+    const std::string& node_name = "NcclAllReduce") {
   std::vector<ArgDef> allreduce_outputs(gradient_argdefs.size());
   for (size_t i = 0; i < gradient_argdefs.size(); i++) {
     TypeProto* allreduced_gradient_type_proto = graph_defs.CopyTypeProto(gradient_argdefs[i]);
@@ -35,12 +40,51 @@ static Status AddNcclAllReduceForGradients(
                                   allreduce_outputs,
                                   {ONNX_NAMESPACE::MakeAttribute("group_type",
                                                                  static_cast<int64_t>(WorkerGroupType::DataParallel))},
-                                  "NcclAllReduce")});
+                                  node_name)});
 
   gradient_argdefs = allreduce_outputs;
   return Status::OK();
 }
 
+// Splits the gradients into buckets holding about bucket_size_in_bytes bytes of data to reduce. The buckets are
+// filled in the reverse order of the gradients, which is roughly the order the backward pass produces them in, so the
+// reduction of the first buckets can start while the rest of the backward pass runs. A bucket size of 0 puts all the
+// gradients in a single bucket.
+static std::vector<std::vector<size_t>> GetGradientBuckets(const std::vector<ArgDef>& gradient_argdefs,
+                                                           int64_t bucket_size_in_bytes,
+                                                           int64_t element_size_in_bytes) {
+  std::vector<std::vector<size_t>> buckets;
+  if (bucket_size_in_bytes <= 0) {
+    buckets.emplace_back(gradient_argdefs.size());
+    std::iota(buckets.back().begin(), buckets.back().end(), size_t{0});
+    return buckets;
+  }
+
+  int64_t current_bucket_size_in_bytes = 0;
+  for (size_t i = gradient_argdefs.size(); i-- > 0;) {
+    // a gradient with an unknown size gets its own bucket
+    int64_t size_in_bytes = bucket_size_in_bytes;
+    const auto& tensor_type = gradient_argdefs[i].type_proto->tensor_type();
+    if (tensor_type.has_shape()) {
+      const auto& dims = tensor_type.shape().dim();
+      if (std::all_of(dims.begin(), dims.end(), [](const auto& dim) { return utils::HasDimValue(dim); })) {
+        size_in_bytes = std::accumulate(dims.begin(), dims.end(), element_size_in_bytes,
+                                        [](int64_t size, const auto& dim) { return size * dim.dim_value(); });
+      }
+    }
+
+    if (buckets.empty() || current_bucket_size_in_bytes + size_in_bytes > bucket_size_in_bytes) {
+      buckets.emplace_back();
+      current_bucket_size_in_bytes = 0;
+    }
+
+    buckets.back().push_back(i);
+    current_bucket_size_in_bytes += size_in_bytes;
+  }
+
+  return buckets;
+}
+
 AllreduceOptimizerGraphBuilder::AllreduceOptimizerGraphBuilder(
     const OptimizerBuilderRegistry& opt_builder_registry,
     const OptimizerGraphConfig& opt_graph_config,
@@ -74,16 +118,38 @@ Status AllreduceOptimizerGraphBuilder::BuildInternal(
     return graph.GenerateNodeArgName(base_name);
   };
 
-  // add gradient scaling
-  std::vector<ArgDef> output_gradient_argdef;
+  // add gradient scaling and allreduce, for each bucket of gradients
   const auto total_num_accumulations =
       opt_graph_config_.gradient_accumulation_steps * opt_graph_config_.data_parallel_group_size;
   ORT_RETURN_IF_NOT(total_num_accumulations > 0, "total_num_accumulations <= 0");
   const float scale = 1.0f / total_num_accumulations;
-  ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, gradient_argdefs, output_gradient_argdef, graph_defs,
-                                              opt_graph_config_.AllReduceDataType()));
+  const auto allreduce_data_type = opt_graph_config_.AllReduceDataType();
+  const int64_t element_size_in_bytes = allreduce_data_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ? 4 : 2;
+  const auto buckets = GetGradientBuckets(gradient_argdefs, opt_graph_config_.allreduce_bucket_size_in_bytes,
+                                          element_size_in_bytes);
+
+  std::vector<ArgDef> allreduced_gradient_argdefs(gradient_argdefs.size());
+  for (const auto& bucket : buckets) {
+    std::vector<ArgDef> bucket_gradient_argdefs;
+    bucket_gradient_argdefs.reserve(bucket.size());
+    for (size_t i : bucket) {
+      bucket_gradient_argdefs.push_back(gradient_argdefs[i]);
+    }
+
+    std::vector<ArgDef> output_gradient_argdef;
+    ORT_RETURN_IF_ERROR(AddGradientScalingNodes(nodearg_name_generator, scale, bucket_gradient_argdefs,
+                                                output_gradient_argdef, graph_defs, allreduce_data_type));
+
+    ORT_RETURN_IF_ERROR(AddNcclAllReduceForGradients(
+        bucket_gradient_argdefs, output_gradient_argdef, graph_defs,
+        buckets.size() == 1 ? "NcclAllReduce" : nodearg_name_generator("NcclAllReduce")));
+
+    for (size_t i = 0; i < bucket.size(); ++i) {
+      allreduced_gradient_argdefs[bucket[i]] = bucket_gradient_argdefs[i];
+    }
+  }
 
-  ORT_RETURN_IF_ERROR(AddNcclAllReduceForGradients(gradient_argdefs, output_gradient_argdef, graph_defs));
+  gradient_argdefs = std::move(allreduced_gradient_argdefs);
 
   // check if all gradients are finite
   ArgDef global_grad_norm_argdef;
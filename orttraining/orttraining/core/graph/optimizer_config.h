@@ -67,6 +67,8 @@ struct OptimizerGraphConfig {
   bool use_mixed_precision{false};
   MixedPrecisionDataType mixed_precision_type{MixedPrecisionDataType::FP16};
   bool allreduce_in_mixed_precision_type{false};
+  // the size of the gradient buckets reduced by separate allreduce nodes, 0 reduces all the gradients at once
+  int64_t allreduce_bucket_size_in_bytes{0};
   bool use_nccl{false};
   ZeROConfig deepspeed_zero{0};
   int gradient_accumulation_steps{1};
@@ -4,7 +4,10 @@
 #include "orttraining/core/graph/pipeline_transformer.h"
 #include <queue>
 
+#include "core/framework/data_types.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
 #include "orttraining/core/framework/distributed_run_context.h"
 
 using namespace onnxruntime::common;
@@ -1859,5 +1862,84 @@ Status GetDeviceAssignmentMap(const Graph& graph,
   return Status::OK();
 }
 
+// Estimated cost of placing a node on a pipeline stage: the bytes of the initializers it reads first, which have to
+// live on the device of the stage, and the bytes of its outputs with static shapes, as a proxy for its compute.
+size_t GetNodeCost(const Graph& graph, const Node& node, std::unordered_set<std::string>& counted_initializers) {
+  size_t cost = 0;
+  for (const NodeArg* arg : node.InputDefs()) {
+    const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+    if (arg == nullptr || !arg->Exists() || !graph.GetInitializedTensor(arg->Name(), initializer) ||
+        !counted_initializers.insert(arg->Name()).second) {
+      continue;
+    }
+
+    size_t size = 0;
+    if (utils::GetSizeInBytesFromTensorProto<0>(*initializer, &size).IsOK()) {
+      cost += size;
+    }
+  }
+
+  for (const NodeArg* arg : node.OutputDefs()) {
+    if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr || !arg->TypeAsProto()->has_tensor_type()) {
+      continue;
+    }
+
+    // Symbolic dimensions make the size negative.
+    const int64_t num_elements = utils::GetTensorShapeFromTensorShapeProto(*arg->Shape()).Size();
+    if (num_elements > 0) {
+      const auto* element_type = DataTypeImpl::TypeFromProto(*arg->TypeAsProto())->AsTensorType()->GetElementType();
+      cost += static_cast<size_t>(num_elements) * element_type->Size();
+    }
+  }
+
+  return cost;
+}
+
+Status GetBalancedDeviceAssignmentMap(const Graph& graph,
+                                      std::map<const Node*, int>& op_to_stage,
+                                      const int num_stages) {
+  ORT_RETURN_IF_NOT(num_stages > 0, "Number of pipeline stages must be positive.");
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_order = graph_viewer.GetNodesInTopologicalOrder();
+  ORT_RETURN_IF(node_order.size() < static_cast<size_t>(num_stages),
+                "Can't partition ", node_order.size(), " operators into ", num_stages, " pipeline stages.");
+
+  // Every node costs at least 1, so the nodes without static shapes are still spread over the stages.
+  std::unordered_set<std::string> counted_initializers;
+  std::vector<size_t> costs;
+  costs.reserve(node_order.size());
+  size_t total_cost = 0;
+  for (const auto node_index : node_order) {
+    costs.push_back(1 + GetNodeCost(graph, *graph.GetNode(node_index), counted_initializers));
+    total_cost += costs.back();
+  }
+
+  // The nodes are assigned in topological order, so that edges always go forward. A stage ends once the cost of the
+  // nodes assigned so far reaches its share of the total, leaving at least one node for each of the next stages.
+  std::vector<int> stages(graph.NumberOfNodes(), -1);
+  size_t assigned_cost = 0;
+  int stage = 0;
+  for (size_t i = 0; i < node_order.size(); ++i) {
+    stages.at(node_order[i]) = stage;
+    assigned_cost += costs[i];
+
+    const size_t remaining_nodes = node_order.size() - i - 1;
+    const int remaining_stages = num_stages - stage - 1;
+    if (remaining_stages > 0 && (remaining_nodes == static_cast<size_t>(remaining_stages) ||
+                                 assigned_cost * num_stages >= total_cost * (stage + 1))) {
+      ++stage;
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(VerifyAssignment(stages, num_stages, graph));
+
+  for (size_t i = 0, t = graph.NumberOfNodes(); i < t; ++i) {
+    op_to_stage.emplace(graph.GetNode(i), stages.at(i));
+  }
+
+  return Status::OK();
+}
+
 }  // namespace training
 }  // namespace onnxruntime
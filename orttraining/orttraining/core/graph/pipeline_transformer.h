@@ -59,6 +59,20 @@ Status GetDeviceAssignmentMap(const Graph& graph,
                               std::map<const Node*, int>& op_to_stage,
                               const int num_stages);
 
+// Third function to obtain a mapping between operators and stage ids, for
+// when the user gives neither cuts nor a stage map. The operators are split
+// in topological order into num_stages contiguous stages of about the same
+// cost, counting the bytes of the initializers each stage holds and the bytes
+// of the tensors it produces.
+// Input:
+//   - graph is the graph being partitioned into multiple pipeline stages.
+//   - op_to_stage keeps the output of this function, where op_to_stage[node_ptr]
+// is the pipeline stage ID of the pointed node.
+//   - num_stages is the total number of stages.
+Status GetBalancedDeviceAssignmentMap(const Graph& graph,
+                                      std::map<const Node*, int>& op_to_stage,
+                                      const int num_stages);
+
 // This function creates data-dependency from "dependent_node_args"
 // to "node". That is, it makes sure "node" is executed after
 // the generation of "dependent_node_args."
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/common/logging/logging.h"
 #include "core/graph/op.h"
 #include "core/optimizer/rewrite_rule.h"
@@ -46,6 +48,50 @@ static std::vector<GraphEdgeHelper> GetNodeOutputEdges(const Node& node) {
   return output_edges;
 }
 
+// Picks the compression type of a stashed activation from its type and its consumers. The lossless ones are used
+// when they apply, otherwise the user compression type if it supports the activation type. Returns an empty string
+// when the activation can't be compressed.
+static std::string ChooseCompressionType(const Node& node, const NodeArg& activation,
+                                         const std::vector<std::pair<Node*, int>>& consumers,
+                                         const std::string& user_compression_type, const logging::Logger& logger) {
+  const auto elem_type = activation.TypeAsProto()->tensor_type().elem_type();
+
+  if (elem_type == ONNX_NAMESPACE::TensorProto_DataType_BOOL) {
+    LOGS(logger, INFO) << "(Lossless) override compression type to Pack1 for tensor: " << activation.Name();
+    return "GistPack1";
+  }
+
+  const bool is_floating_point = elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+                                 elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 ||
+                                 elem_type == ONNX_NAMESPACE::TensorProto_DataType_DOUBLE;
+
+  // ReluGrad only reads the sign of the Relu output.
+  if (is_floating_point && node.OpType() == "Relu" &&
+      std::all_of(consumers.cbegin(), consumers.cend(),
+                  [](const std::pair<Node*, int>& consumer) { return consumer.first->OpType() == "ReluGrad"; })) {
+    LOGS(logger, INFO) << "(Lossless) override compression type to Binarize for tensor: " << activation.Name();
+    return "GistBinarize";
+  }
+
+  static const std::unordered_map<std::string, std::vector<int>> supported_types = {
+      {"GistBinarize", {ONNX_NAMESPACE::TensorProto_DataType_FLOAT16, ONNX_NAMESPACE::TensorProto_DataType_FLOAT,
+                        ONNX_NAMESPACE::TensorProto_DataType_DOUBLE}},
+      {"GistPack1", {ONNX_NAMESPACE::TensorProto_DataType_FLOAT}},
+      {"GistPack8", {ONNX_NAMESPACE::TensorProto_DataType_FLOAT16, ONNX_NAMESPACE::TensorProto_DataType_FLOAT}},
+      {"GistPack16", {ONNX_NAMESPACE::TensorProto_DataType_FLOAT}},
+      {"GistPackMsfp15", {ONNX_NAMESPACE::TensorProto_DataType_FLOAT}}};
+
+  auto it = supported_types.find(user_compression_type);
+  ORT_ENFORCE(it != supported_types.end(), "Gist compression type not supported: ", user_compression_type);
+  if (std::find(it->second.cbegin(), it->second.cend(), elem_type) == it->second.cend()) {
+    LOGS(logger, INFO) << "Skip " << user_compression_type << " compression for tensor: " << activation.Name()
+                       << " of unsupported type " << elem_type;
+    return "";
+  }
+
+  return user_compression_type;
+}
+
 bool GistEncodeDecode::AddEncodeDecode(Graph& graph, Node& curr_node, std::string compression_type, const logging::Logger& logger) const {
   if (curr_node.OutputDefs().size() < 1) {  // min 1 required for gist applicability (one edge connecting a fw node to a bw node)
     return false;
@@ -73,19 +119,17 @@ bool GistEncodeDecode::AddEncodeDecode(Graph& graph, Node& curr_node, std::strin
   }
 
   std::string user_compression_type = compression_type;
+  bool modified = false;
 
   // Each element in map corresponds to a stash activation
   for (auto& st_act : decode_map) {
     // Create compressed tensor
     NodeArg* curr_node_output_arg = curr_node.MutableOutputDefs()[st_act.first];
     ONNX_NAMESPACE::TypeProto compressed_tensor;
-    compression_type = user_compression_type;
-
-    // Override compression_type for lossless compression case(s) (eg. bool -> Pack1)
-    ONNX_NAMESPACE::DataType type_string = curr_node_output_arg->Type();
-    if (*type_string == "bool" || *type_string == "tensor(bool)") {
-      LOGS(logger, INFO) << "(Lossless) override compression type to Pack1 for tensor: " << curr_node_output_arg->Name();
-      compression_type = "GistPack1";
+    compression_type = ChooseCompressionType(curr_node, *curr_node_output_arg, st_act.second, user_compression_type,
+                                             logger);
+    if (compression_type.empty()) {
+      continue;
     }
 
     if (compression_type == "GistPack1" || compression_type == "GistPack8" || compression_type == "GistPackMsfp15") {
@@ -146,9 +190,11 @@ bool GistEncodeDecode::AddEncodeDecode(Graph& graph, Node& curr_node, std::strin
     for (auto& dest_pair : st_act.second) {
       graph.AddEdge(decode.Index(), dest_pair.first->Index(), 0, dest_pair.second);
     }
+
+    modified = true;
   }
 
-  return true;
+  return modified;
 }
 
 std::vector<std::string> GistEncodeDecode::TargetOpTypes() const noexcept {
@@ -102,11 +102,37 @@ std::string OptimizationTypeToString(OptimizationType type) {
       return "Recompute";
     case OptimizationType::RecomputeWithCompromise:
       return "RecomputeWithCompromise";
+    case OptimizationType::Offload:
+      return "Offload";
     default:
       ORT_THROW("Unknown optimization type.");
   }
 }
 
+std::optional<int64_t> GetTensorElemCount(const NodeArg& node_arg,
+                                          const InlinedHashMap<std::string, int64_t>& dim_values) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    return std::nullopt;
+  }
+
+  int64_t elem_count = 1;
+  for (const auto& dim : shape->dim()) {
+    if (utils::HasDimValue(dim)) {
+      elem_count *= dim.dim_value();
+      continue;
+    }
+
+    auto it = dim_values.find(utils::TrimString(dim.dim_param()));
+    if (it == dim_values.end()) {
+      return std::nullopt;
+    }
+    elem_count *= it->second;
+  }
+
+  return elem_count;
+}
+
 int ParseIntValueFromString(std::string_view str) {
   int int_value = 0;
   auto result = std::from_chars(str.data(), str.data() + str.size(), int_value);
@@ -146,4 +172,27 @@ Status ParseOptimizationConfigFromString(std::string_view memory_optimization_co
   return Status::OK();
 }
 
+Status ParseMemoryBudgetConfigFromString(std::string_view memory_budget_config,
+                                         MemoryBudgetConfig& memory_budget_config_out) {
+  memory_budget_config_out = MemoryBudgetConfig{};
+  if (memory_budget_config.empty()) {
+    return Status::OK();
+  }
+
+  const auto config_strs = utils::SplitString(memory_budget_config, ",");
+  const int mib_to_save = ParseIntValueFromString(config_strs[0]);
+  ORT_RETURN_IF_NOT(mib_to_save >= 0, "Invalid memory to save specified: ", mib_to_save);
+  memory_budget_config_out.bytes_to_save = static_cast<int64_t>(mib_to_save) * 1024 * 1024;
+
+  for (size_t i = 1; i < config_strs.size(); ++i) {
+    const auto dim_config = utils::SplitString(config_strs[i], "=");
+    ORT_RETURN_IF_NOT(dim_config.size() == 2, "Dim value config should be in the format of DimParam=Value.");
+    const int dim_value = ParseIntValueFromString(dim_config[1]);
+    ORT_RETURN_IF_NOT(dim_value >= 0, "Invalid value specified for dim param: ", dim_config[0]);
+    memory_budget_config_out.dim_values[utils::TrimString(std::string(dim_config[0]))] = dim_value;
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime::optimizer::memory_optimizer
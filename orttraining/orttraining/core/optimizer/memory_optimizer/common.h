@@ -4,6 +4,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -38,7 +39,8 @@ enum class OptimizationType {
   None = 0,  // Disabled.
   Recompute = 1,
   RecomputeWithCompromise = 2,
-  TypeMax = 3,
+  Offload = 3,
+  TypeMax = 4,
 };
 
 std::string OptimizationTypeToString(OptimizationType type);
@@ -56,6 +58,17 @@ struct UserConfig {
   int requested_count;
 };
 
+/**
+ * @brief Config of the automatic mode, in which the recompute plans are picked by the memory optimizer instead of
+ * being listed by the user.
+ * bytes_to_save: the stashed activation memory to save, in bytes.
+ * dim_values: the values of the symbolic dimensions, used to compute the size of the activations.
+ */
+struct MemoryBudgetConfig {
+  int64_t bytes_to_save{0};
+  InlinedHashMap<std::string, int64_t> dim_values;
+};
+
 /**
  * @brief Get total element count inn format of a symbolic string.
  * Be noted: this function is used to generate a unique string for a tensor shape.
@@ -68,9 +81,26 @@ struct UserConfig {
  */
 std::string GetTensorElemCountInSymbolicString(const Node* node, size_t output_index);
 
+/**
+ * @brief Get the element count of a tensor.
+ *
+ * @param node_arg The tensor.
+ * @param dim_values The values of the symbolic dimensions.
+ * @return The element count, or std::nullopt if the shape is unknown or has a dimension without a value.
+ */
+std::optional<int64_t> GetTensorElemCount(const NodeArg& node_arg,
+                                          const InlinedHashMap<std::string, int64_t>& dim_values);
+
 int ParseIntValueFromString(std::string_view str);
 
 Status ParseOptimizationConfigFromString(std::string_view memory_optimization_config,
                                          InlinedHashMap<std::string, UserConfig>& cluster_id_to_config_map);
 
+/**
+ * @brief Parse the config of the automatic mode, in the format of
+ * "MiBToSave[,DimParam=Value]*", for example "512,batch=32,seq_len=1024".
+ */
+Status ParseMemoryBudgetConfigFromString(std::string_view memory_budget_config,
+                                         MemoryBudgetConfig& memory_budget_config_out);
+
 }  // namespace onnxruntime::optimizer::memory_optimizer
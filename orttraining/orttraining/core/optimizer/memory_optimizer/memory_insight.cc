@@ -17,6 +17,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/transformer_specific.h"
 
 namespace onnxruntime::optimizer::memory_optimizer {
@@ -304,6 +305,13 @@ Status FindORTModuleMemoryOpportunity(const GraphViewer& graph_viewer,
         memory_opt_planner.AddNodeOptimizationPlan(p_node, std::move(recompute_with_compromise_plan));
       }
     }
+
+    if (probe_config.enable_offload) {
+      std::unique_ptr<NodeOffloadPlan> offload_plan = CheckNodeForOffload(*p_node, candidate_output_args_map, logger);
+      if (offload_plan != nullptr) {
+        memory_opt_planner.AddNodeOptimizationPlan(p_node, std::move(offload_plan));
+      }
+    }
   }
 
   return Status::OK();
@@ -426,6 +434,9 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
         node_cluster_id_to_record_map[node_cluster_id]->actual_recompute_with_compromise_count += 1;
         node_cluster_id_to_record_map[node_cluster_id]->request_recompute_with_compromise_count =
             apply_context->requested_count;
+      } else if (apply_context->type == OptimizationType::Offload) {
+        // The memory records only have columns for recompute, the applied offloads are logged by the optimizer.
+        continue;
       } else {
         ORT_THROW("Unsupported optimization type found.");
       }
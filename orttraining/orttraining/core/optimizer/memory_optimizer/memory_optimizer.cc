@@ -17,6 +17,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/common.h"
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
 
 namespace onnxruntime {
@@ -54,7 +55,8 @@ bool SetSeedForDropoutNode(Node& node) {
 }  // namespace
 
 Status MemoryOptimizer::ParseOptimizationConfigFromString(const std::string& memory_optimizer_config,
-                                                          const std::string& recompute_probe_config) {
+                                                          const std::string& recompute_probe_config,
+                                                          const std::string& memory_budget_config) {
   optimizer_config_ = memory_optimizer_config;
 
   ORT_RETURN_IF_ERROR(optimizer::memory_optimizer::ParseOptimizationConfigFromString(
@@ -65,6 +67,10 @@ Status MemoryOptimizer::ParseOptimizationConfigFromString(const std::string& mem
       recompute_probe_config,
       recompute_probe_config_));
 
+  ORT_RETURN_IF_ERROR(optimizer::memory_optimizer::ParseMemoryBudgetConfigFromString(
+      memory_budget_config,
+      memory_budget_config_));
+
   return Status::OK();
 }
 
@@ -98,10 +104,10 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
           dynamic_cast<optimizer::memory_optimizer::NodeRecomputePlan*>(node_plan.get());
       ORT_ENFORCE(recompute_plan != nullptr);
       ORT_ENFORCE(CreateRecomputeGraph(graph, recompute_plan->GetNodesInTopoOrder(), logger, replacement_node_ptr).IsOK());
-    } else {
+      ORT_ENFORCE(replacement_node_ptr);
+    } else if (apply_context->type != optimizer::memory_optimizer::OptimizationType::Offload) {
       ORT_THROW("unsupported optimization type found.");
     }
-    ORT_ENFORCE(replacement_node_ptr);
 
     graph_is_modified = true;
 
@@ -126,6 +132,15 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
       }
 
       if (!output_edges.empty()) {
+        // The recompute node has the same outputs as the original node, while each offloaded activation is copied
+        // back by its own node.
+        Node* new_src_node_ptr = replacement_node_ptr;
+        int new_src_arg_index = static_cast<int>(output_index);
+        if (apply_context->type == optimizer::memory_optimizer::OptimizationType::Offload) {
+          ORT_ENFORCE(CreateOffloadGraph(graph, *node, output_index, logger, new_src_node_ptr).IsOK());
+          new_src_arg_index = 0;
+        }
+
         // Remove the output edges of the node first
         graph_utils::GraphEdge::RemoveGraphEdges(graph, output_edges);
 
@@ -135,7 +150,7 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
 
           // Add new edge connecting the input with the output nodes directly.
           // This also updates the destination node's input node args
-          graph.AddEdge(replacement_node_ptr->Index(), output_edge.dst_node, static_cast<int>(output_index),
+          graph.AddEdge(new_src_node_ptr->Index(), output_edge.dst_node, new_src_arg_index,
                         output_edge.dst_arg_index);
         }
       }
@@ -155,8 +170,8 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
                         << ", enable_transformer_layer_as_boundary:"
                         << recompute_probe_config_.enable_transformer_layer_as_boundary;
 
-  if (pattern_subgraph_to_user_optimizer_config_map_.empty()) {
-    LOGS(logger, VERBOSE) << "No optimization pattern is specified, skip memory optimization.";
+  if (pattern_subgraph_to_user_optimizer_config_map_.empty() && memory_budget_config_.bytes_to_save <= 0) {
+    LOGS(logger, VERBOSE) << "No optimization pattern or memory budget is specified, skip memory optimization.";
     return Status::OK();
   }
 
@@ -179,15 +194,23 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
                   memory_opt_planner)
                   .IsOK());
 
-  // Finalize the plan according to user config,
+  // Finalize the plan according to user config, or pick the plans for the memory budget if there is no user config,
   // then create a ClusterApplyContext for each unique cluster (having the same node pattern)
   InlinedHashMap<const Node*, std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>>
       node_to_opt_plan_map;
   optimizer::memory_optimizer::NodeToClusterApplyContextMap node_to_apply_context_map;
-  ORT_ENFORCE(memory_opt_planner.FinalizeNodePlansFromUserConfig(pattern_subgraph_to_user_optimizer_config_map_,
-                                                                 node_to_opt_plan_map,
-                                                                 node_to_apply_context_map)
-                  .IsOK());
+  if (!pattern_subgraph_to_user_optimizer_config_map_.empty()) {
+    ORT_ENFORCE(memory_opt_planner.FinalizeNodePlansFromUserConfig(pattern_subgraph_to_user_optimizer_config_map_,
+                                                                   node_to_opt_plan_map,
+                                                                   node_to_apply_context_map)
+                    .IsOK());
+  } else {
+    ORT_ENFORCE(memory_opt_planner.FinalizeNodePlansFromMemoryBudget(memory_budget_config_,
+                                                                     logger,
+                                                                     node_to_opt_plan_map,
+                                                                     node_to_apply_context_map)
+                    .IsOK());
+  }
 
   // The second pass - apply the transformation.
   // Iterate through the nodes in reversed topological order and find the subgraph that can be alleviated.
@@ -329,4 +352,49 @@ Status MemoryOptimizer::CreateRecomputeGraph(Graph& graph,
  ** Recompute related function implementation ends   **
  ******************************************************/
 
+/******************************************************
+ ** Offload related function implementation starts   **
+ ******************************************************/
+
+Status MemoryOptimizer::CreateOffloadGraph(Graph& graph,
+                                           Node& node,
+                                           size_t output_index,
+                                           const logging::Logger& logger,
+                                           Node*& new_output_node_ptr) const {
+  NodeArg* activation = node.MutableOutputDefs()[output_index];
+  NodeArg& host_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation->Name() + "_offload"),
+                                               activation->TypeAsProto());
+  NodeArg& device_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation->Name() + "_reload"),
+                                                 activation->TypeAsProto());
+
+  // The copy to host is scheduled with the default priority, so it runs as soon as the activation is produced and
+  // the device buffer can be freed once the forward pass consumers are done.
+  Node& offload_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_offload"), "MemcpyToHost",
+                                     "Offload of " + activation->Name(), {activation}, {&host_arg});
+  offload_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  graph.AddEdge(node.Index(), offload_node.Index(), static_cast<int>(output_index), 0);
+  graph.AddConsumerNode(activation->Name(), &offload_node);
+  graph.UpdateProducerNode(host_arg.Name(), offload_node.Index());
+
+  // Like the recompute nodes, the copy back to device gets the lowest priority, so it is delayed until the backward
+  // pass consumers need it.
+  Node& reload_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_reload"), "MemcpyFromHost",
+                                    "Reload of " + activation->Name(), {&host_arg}, {&device_arg});
+  reload_node.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_LOW));
+  reload_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  graph.AddEdge(offload_node.Index(), reload_node.Index(), 0, 0);
+  graph.AddConsumerNode(host_arg.Name(), &reload_node);
+  graph.UpdateProducerNode(device_arg.Name(), reload_node.Index());
+
+  LOGS(logger, VERBOSE) << "Offload " << activation->Name() << " of Node " << node.Name() << "(" << node.OpType()
+                        << ") to host memory.";
+
+  new_output_node_ptr = &reload_node;
+  return Status::OK();
+}
+
+/******************************************************
+ ** Offload related function implementation ends     **
+ ******************************************************/
+
 }  // namespace onnxruntime
@@ -24,15 +24,28 @@ Find recompute subgraphs and enable them according to user configs. The way we c
   b. otherwise, stop collecting and return the subgraph (could be empty).
 3. Pick up the input node from the queue, and do 2 again. The process ends when the queue is empty or 2.b happens.
 4. Clone the recomputable subgraphs with lower node priority (to execute) and insert them back to the original graph.
+
+When enabled in the probe config, the stashed activations on devices can also be offloaded instead
+(in orttraining/orttraining/core/optimizer/memory_optimizer/offload_analysis.h): they are copied to host memory after
+they are produced, and copied back with lower node priority before the backward pass consumes them.
 */
 
 class MemoryOptimizer : public GraphTransformer {
  private:
  public:
-  MemoryOptimizer(const std::string& memory_optimizer_config, const std::string& recompute_probe_config)
+  /**
+   * @param memory_optimizer_config The subgraphs to recompute, see kOrtSessionOptionsMemoryOptimizerEnabler.
+   * @param recompute_probe_config The config for recomputable subgraph detecting.
+   * @param memory_budget_config The config of the automatic mode, used when memory_optimizer_config is empty, see
+   *   kOrtSessionOptionsMemoryOptimizerBudget.
+   */
+  MemoryOptimizer(const std::string& memory_optimizer_config, const std::string& recompute_probe_config,
+                  const std::string& memory_budget_config = "")
       : GraphTransformer("MemoryOptimizer") {
     // Parse user-defined configs.
-    ORT_ENFORCE(ParseOptimizationConfigFromString(memory_optimizer_config, recompute_probe_config).IsOK());
+    ORT_ENFORCE(ParseOptimizationConfigFromString(memory_optimizer_config, recompute_probe_config,
+                                                  memory_budget_config)
+                    .IsOK());
   }
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
@@ -40,7 +53,8 @@ class MemoryOptimizer : public GraphTransformer {
   bool ShouldOnlyApplyOnce() const override { return true; }
 
  private:
-  Status ParseOptimizationConfigFromString(const std::string& memory_optimizer_config, const std::string& recompute_probe_config);
+  Status ParseOptimizationConfigFromString(const std::string& memory_optimizer_config, const std::string& recompute_probe_config,
+                                           const std::string& memory_budget_config);
 
   /**
    * @brief Apply graph modifications based on user configs.
@@ -101,10 +115,27 @@ class MemoryOptimizer : public GraphTransformer {
    ** Recompute-related function definition ends   **
    *************************************************/
 
+  /**
+   * @brief Add the nodes copying an activation to host memory after it is produced, and back to device memory
+   * before the backward pass consumes it.
+   *
+   * @param graph Graph to iterate.
+   * @param node The node producing the activation.
+   * @param output_index The output index of the activation.
+   * @param reload_node The node copying the activation back to device memory.
+   * @return Status
+   */
+  Status CreateOffloadGraph(Graph& graph,
+                            Node& node,
+                            size_t output_index,
+                            const logging::Logger& logger,
+                            Node*& reload_node) const;
+
   // User-enabled map of the subgraph string representation to the alleviation type.
   InlinedHashMap<std::string, optimizer::memory_optimizer::UserConfig> pattern_subgraph_to_user_optimizer_config_map_;
   std::string optimizer_config_;
   optimizer::memory_optimizer::ProbeConfig recompute_probe_config_;
+  optimizer::memory_optimizer::MemoryBudgetConfig memory_budget_config_;
 };
 
 }  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
+#include "core/framework/data_types.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+namespace {
+
+size_t GetElementByteCount(const NodeArg& node_arg) {
+  MLDataType ml_data_type = DataTypeImpl::TypeFromProto(*node_arg.TypeAsProto());
+  ORT_ENFORCE(ml_data_type->IsTensorType(), "ml_type must be a tensor type, but it is ",
+              DataTypeImpl::ToString(ml_data_type));
+  return ml_data_type->AsTensorType()->GetElementType()->Size();
+}
+
+}  // namespace
+
+std::string NodeOffloadPlan::GetClusterId() const {
+  return node->OpType() + "+";
+}
+
+std::string NodeOffloadPlan::NormalizeForNodeClusterId() const {
+  std::ostringstream oss;
+  oss << "offload:" << node->OpType() << "-";
+  for (auto& output_index : GetActivationOutputIndices()) {
+    oss << output_index << ":" << GetActivationOutputDimParamString(output_index);
+    oss << ":" << node->OutputDefs()[output_index]->TypeAsProto()->tensor_type().elem_type() << "-";
+  }
+
+  return oss.str();
+}
+
+std::string NodeOffloadPlan::GetMemorySavingSymbolicString() const {
+  // The offloaded activations are moved out of device memory, whether or not they reuse other buffers.
+  std::string saving_str;
+  for (auto output_index : GetActivationOutputIndices()) {
+    if (!saving_str.empty()) {
+      saving_str += " + ";
+    }
+
+    saving_str += "(" + GetActivationOutputDimParamString(output_index) + " * " +
+                  std::to_string(GetElementByteCount(*node->OutputDefs()[output_index])) + ")";
+  }
+
+  ORT_ENFORCE(!saving_str.empty(), "saving_str should not be empty for node: ", node->OpType(), " ", node->Name());
+  return "(" + saving_str + ")";
+}
+
+std::unique_ptr<NodeOffloadPlan> CheckNodeForOffload(const Node& node,
+                                                     const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                                         candidate_output_args_map,
+                                                     const logging::Logger& logger) {
+  // Activations already in host memory have nothing to gain.
+  const auto& provider_type = node.GetExecutionProviderType();
+  if (provider_type.empty() || provider_type == kCpuExecutionProvider) {
+    return nullptr;
+  }
+
+  const auto& output_indices = candidate_output_args_map.at(&node);
+  for (auto output_index : output_indices) {
+    const auto* type_proto = node.OutputDefs()[output_index]->TypeAsProto();
+    if (type_proto == nullptr || !type_proto->has_tensor_type()) {
+      MO_LOG_DEBUG_INFO(logger, "Skip offloading Node " + node.Name() + "(" + node.OpType() +
+                                    ") with non-tensor activation.");
+      return nullptr;
+    }
+  }
+
+  return std::make_unique<NodeOffloadPlan>(&node, output_indices);
+}
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
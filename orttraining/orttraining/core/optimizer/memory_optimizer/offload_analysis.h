@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+/**
+ * @brief A child class used for Offload optimization plan.
+ *
+ * The stashed activations of the node are copied to host memory once the forward pass consumers are done with them,
+ * and copied back to device memory right before their backward pass consumers run. Unlike recompute, any node on a
+ * device can be offloaded, at the cost of the host/device transfers.
+ */
+class NodeOffloadPlan : public NodeOptimizationPlanBase {
+ public:
+  NodeOffloadPlan(const Node* node,
+                  const InlinedVector<size_t>& activation_output_indices)
+      : NodeOptimizationPlanBase(node, activation_output_indices, 1.0f) {}
+
+  OptimizationType GetOptimizationType() const override {
+    return OptimizationType::Offload;
+  }
+
+  /**
+   * @brief Get the cluster id for this offload plan, which is the op type of the node, in the same format as a
+   * single node recompute subgraph string, for example "Gelu+".
+   */
+  std::string GetClusterId() const override;
+
+  std::string NormalizeForNodeClusterId() const override;
+
+  std::string GetMemorySavingSymbolicString() const override;
+};
+
+/**
+ * @brief For the node producing stashed activations, check whether they can be offloaded to host memory.
+ *
+ * @param node The node producing the stashed activations.
+ * @param candidate_output_args_map A map from node to its candidate activations, which are consumed by both fw and
+ *  bw ops.
+ * @param logger Logger.
+ */
+std::unique_ptr<NodeOffloadPlan> CheckNodeForOffload(const Node& node,
+                                                     const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                                         candidate_output_args_map,
+                                                     const logging::Logger& logger);
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
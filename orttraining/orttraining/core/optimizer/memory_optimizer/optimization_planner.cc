@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -9,12 +10,89 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
+#include "core/framework/tensorprotoutils.h"
 
 #include "orttraining/core/optimizer/memory_optimizer/common.h"
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
+#include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
 
 namespace onnxruntime::optimizer::memory_optimizer {
 
+namespace {
+
+std::optional<int64_t> GetElemByteCount(const NodeArg& node_arg) {
+  MLDataType ml_data_type = DataTypeImpl::TypeFromProto(*node_arg.TypeAsProto());
+  if (!ml_data_type->IsTensorType()) {
+    return std::nullopt;
+  }
+
+  return static_cast<int64_t>(ml_data_type->AsTensorType()->GetElementType()->Size());
+}
+
+// The bytes of stashed activations freed by the recompute plan. Like in GetMemorySavingSymbolicString, an output that
+// reuses the buffer of a value that is not recomputed frees nothing.
+std::optional<int64_t> GetSavedBytes(const NodeRecomputePlan& plan,
+                                     const InlinedHashMap<std::string, int64_t>& dim_values) {
+  const auto& nodes = plan.GetNodesInTopoOrder();
+  double saved_bytes = 0;
+  for (auto output_index : plan.GetActivationOutputIndices()) {
+    auto it = plan.reuse_buffers.find(output_index);
+    if (it != plan.reuse_buffers.end() && std::find(nodes.begin(), nodes.end(), it->second.first) == nodes.end()) {
+      continue;
+    }
+
+    const NodeArg& output = *plan.node->OutputDefs()[output_index];
+    const auto elem_count = GetTensorElemCount(output, dim_values);
+    const auto elem_byte_count = GetElemByteCount(output);
+    if (!elem_count.has_value() || !elem_byte_count.has_value()) {
+      return std::nullopt;
+    }
+
+    saved_bytes += static_cast<double>(*elem_count * *elem_byte_count) * plan.GetSaveRatio();
+  }
+
+  return static_cast<int64_t>(saved_bytes);
+}
+
+// A FLOP estimate of running the recompute subgraph once. Most of the recomputable ops are elementwise, so each
+// output element counts as one operation, except for the MatMul ops that also reduce over the inner dimension.
+std::optional<int64_t> GetRecomputeCost(const NodeRecomputePlan& plan,
+                                        const InlinedHashMap<std::string, int64_t>& dim_values) {
+  int64_t cost = 0;
+  for (const Node* node : plan.GetNodesInTopoOrder()) {
+    int64_t ops_per_output_elem = 1;
+    if (node->OpType() == "MatMul" || node->OpType() == "FusedMatMul" || node->OpType() == "Gemm") {
+      const auto* shape = node->InputDefs()[0]->Shape();
+      if (shape == nullptr || shape->dim_size() == 0) {
+        return std::nullopt;
+      }
+
+      // the inner dimension is the last one of A, unless A is transposed, which is rare in the forward pass
+      const auto& inner_dim = shape->dim(shape->dim_size() - 1);
+      if (!utils::HasDimValue(inner_dim)) {
+        return std::nullopt;
+      }
+      ops_per_output_elem = 2 * inner_dim.dim_value();
+    }
+
+    for (const NodeArg* output : node->OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+
+      const auto elem_count = GetTensorElemCount(*output, dim_values);
+      if (!elem_count.has_value()) {
+        return std::nullopt;
+      }
+      cost += *elem_count * ops_per_output_elem;
+    }
+  }
+
+  return cost;
+}
+
+}  // namespace
+
 Status MemoryOptimizationPlanner::UpdateNodePlansFromExecutionPlan(const GraphViewer& graph_viewer,
                                                                    const OrtValueNameIdxMap& ortvalue_name_to_idx_map,
                                                                    const SequentialExecutionPlan& p_seq_exec_plan) {
@@ -108,4 +186,85 @@ Status MemoryOptimizationPlanner::FinalizeNodePlansFromUserConfig(
   return Status::OK();
 }
 
+Status MemoryOptimizationPlanner::FinalizeNodePlansFromMemoryBudget(
+    const MemoryBudgetConfig& memory_budget_config,
+    const logging::Logger& logger,
+    InlinedHashMap<const Node*, std::shared_ptr<NodeOptimizationPlanBase>>& node_to_opt_plan_map,
+    NodeToClusterApplyContextMap& node_to_apply_context_map) const {
+  if (memory_budget_config.bytes_to_save <= 0) {
+    return Status::OK();
+  }
+
+  struct Candidate {
+    std::shared_ptr<NodeOptimizationPlanBase> plan;
+    int64_t saved_bytes;
+    int64_t recompute_cost;
+  };
+
+  // Only the plans without compromise free the whole activations, the others need the user to make the trade-off.
+  InlinedVector<Candidate> candidates;
+  for (const auto& node_to_optimization_plan : node_to_optimization_plans_map) {
+    for (const auto& node_plan : node_to_optimization_plan.second) {
+      if (node_plan->GetOptimizationType() != OptimizationType::Recompute) {
+        continue;
+      }
+
+      const auto& recompute_plan = dynamic_cast<const NodeRecomputePlan&>(*node_plan);
+      const auto saved_bytes = GetSavedBytes(recompute_plan, memory_budget_config.dim_values);
+      const auto recompute_cost = GetRecomputeCost(recompute_plan, memory_budget_config.dim_values);
+      if (!saved_bytes.has_value() || !recompute_cost.has_value()) {
+        MO_LOG_DEBUG_INFO(logger, "Skip plan " + node_plan->GetClusterId() + " of Node " +
+                                      node_to_optimization_plan.first->Name() + " with unknown sizes.");
+        continue;
+      }
+
+      if (*saved_bytes > 0) {
+        candidates.push_back({node_plan, *saved_bytes, *recompute_cost});
+      }
+    }
+  }
+
+  // Sort by recompute cost per saved byte, the node names keep the order deterministic.
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& left, const Candidate& right) {
+    const double left_cost_per_byte = static_cast<double>(left.recompute_cost) / left.saved_bytes;
+    const double right_cost_per_byte = static_cast<double>(right.recompute_cost) / right.saved_bytes;
+    if (left_cost_per_byte != right_cost_per_byte) {
+      return left_cost_per_byte < right_cost_per_byte;
+    }
+    return left.plan->node->Name() < right.plan->node->Name();
+  });
+
+  InlinedHashMap<std::string, std::shared_ptr<ClusterApplyContext>> cluster_id_to_apply_contexts_map;
+  int64_t total_saved_bytes = 0;
+  for (const auto& candidate : candidates) {
+    if (total_saved_bytes >= memory_budget_config.bytes_to_save) {
+      break;
+    }
+
+    // one plan per node
+    const Node* node = candidate.plan->node;
+    if (!node_to_opt_plan_map.insert({node, candidate.plan}).second) {
+      continue;
+    }
+
+    const std::string cluster_id = candidate.plan->GetClusterId();
+    auto& apply_context = cluster_id_to_apply_contexts_map[cluster_id];
+    if (apply_context == nullptr) {
+      apply_context = std::make_shared<ClusterApplyContext>();
+      apply_context->requested_count = -1;
+      apply_context->type = OptimizationType::Recompute;
+    }
+    apply_context->total_frequency++;
+    node_to_apply_context_map[node] = apply_context;
+
+    total_saved_bytes += candidate.saved_bytes;
+  }
+
+  LOGS(logger, INFO) << "Memory budget mode picked " << node_to_opt_plan_map.size() << " recompute plans, saving "
+                     << total_saved_bytes << " bytes of the " << memory_budget_config.bytes_to_save
+                     << " bytes requested.";
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime::optimizer::memory_optimizer
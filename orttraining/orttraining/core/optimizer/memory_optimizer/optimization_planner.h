@@ -124,6 +124,18 @@ class MemoryOptimizationPlanner {
       InlinedHashMap<const Node*, std::shared_ptr<NodeOptimizationPlanBase>>& node_to_opt_plan_map,
       NodeToClusterApplyContextMap& node_to_apply_context_map) const;
 
+  /**
+   * @brief Pick the recompute plans for the automatic mode, in place of the user config.
+   * The plans are sorted by their estimated recompute cost per saved byte, and the cheapest ones are picked until the
+   * requested memory is saved. This is the greedy solution of the knapsack problem of saving the memory for the least
+   * recompute cost. Plans whose activation sizes are unknown with the given dim values are not considered.
+   */
+  Status FinalizeNodePlansFromMemoryBudget(
+      const MemoryBudgetConfig& memory_budget_config,
+      const logging::Logger& logger,
+      InlinedHashMap<const Node*, std::shared_ptr<NodeOptimizationPlanBase>>& node_to_opt_plan_map,
+      NodeToClusterApplyContextMap& node_to_apply_context_map) const;
+
   std::string GenerateNodeClusterId(const Node* node) const {
     ORT_ENFORCE(node_to_optimization_plans_map.find(node) != node_to_optimization_plans_map.end(),
                 "Node not found in node_to_optimization_plans_map.");
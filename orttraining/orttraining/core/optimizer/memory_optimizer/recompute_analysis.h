@@ -24,18 +24,21 @@ enum class ProbeLevel {
 
 /**
  * @brief Configuration to control recompute subgraph detection.
+ * enable_offload: also create offload plans for the stashed activations on devices.
  */
 class ProbeConfig {
  public:
   ProbeConfig() = default;
 
-  ProbeConfig(ProbeLevel level, bool transformer_layer_as_boundary = false) {
+  ProbeConfig(ProbeLevel level, bool transformer_layer_as_boundary = false, bool offload = false) {
     probe_level = level;
     enable_transformer_layer_as_boundary = transformer_layer_as_boundary;
+    enable_offload = offload;
   }
 
   ProbeLevel probe_level{ProbeLevel::Basic};
   bool enable_transformer_layer_as_boundary{false};
+  bool enable_offload{false};
 };
 
 Status ParseProbeConfigFromString(std::string_view recompute_probe_config,
@@ -118,6 +118,7 @@ Status SetupOptimizerParams(
   opt_graph_config.data_parallel_group_size = DistributedRunContext::GroupSize(WorkerGroupType::DataParallel);
   opt_graph_config.gradient_accumulation_steps = config.gradient_accumulation_steps;
   opt_graph_config.allreduce_in_mixed_precision_type = optimizer_config.do_all_reduce_in_mixed_precision_type;
+  opt_graph_config.allreduce_bucket_size_in_bytes = optimizer_config.all_reduce_bucket_size_in_bytes;
   opt_graph_config.use_nccl = optimizer_config.use_nccl;
   opt_graph_config.adasum_reduction_type = optimizer_config.adasum_reduction_type;
   opt_graph_config.enable_grad_norm_clip = optimizer_config.enable_grad_norm_clip;
@@ -235,10 +236,13 @@ Status TrainingSession::PartitionGraphForPipeline(
   if (cut_list.size() > 0) {
     ORT_RETURN_IF_ERROR(
         GetDeviceAssignmentMap(model_->MainGraph(), cut_list, op_to_stage, n_stages));
-  } else {
+  } else if (!pipeline_config.value().op_id_to_stage.empty()) {
     const auto& id_to_stage = pipeline_config.value().op_id_to_stage;
     ORT_RETURN_IF_ERROR(
         GetDeviceAssignmentMap(model_->MainGraph(), id_to_stage, op_to_stage, n_stages));
+  } else {
+    ORT_RETURN_IF_ERROR(
+        GetBalancedDeviceAssignmentMap(model_->MainGraph(), op_to_stage, n_stages));
   }
 
   auto ranks = DistributedRunContext::GetRanks(WorkerGroupType::PipelineParallel);
@@ -1547,10 +1551,13 @@ Status PipelineTrainingSession::PartitionGraphForPipeline(
     if (cut_list.size() > 0) {
       ORT_RETURN_IF_ERROR(
           GetDeviceAssignmentMap(model_->MainGraph(), cut_list, op_to_stage, n_stages));
-    } else {
+    } else if (!pipeline_config.value().op_id_to_stage.empty()) {
       const auto& id_to_stage = pipeline_config.value().op_id_to_stage;
       ORT_RETURN_IF_ERROR(
           GetDeviceAssignmentMap(model_->MainGraph(), id_to_stage, op_to_stage, n_stages));
+    } else {
+      ORT_RETURN_IF_ERROR(
+          GetBalancedDeviceAssignmentMap(model_->MainGraph(), op_to_stage, n_stages));
     }
 
     auto ranks = DistributedRunContext::GetRanks(WorkerGroupType::PipelineParallel);
@@ -184,6 +184,9 @@ class TrainingSession : public InferenceSession {
       bool use_mixed_precision_moments{};
       // Whether to use mixed precision type for the all reduce.
       bool do_all_reduce_in_mixed_precision_type{};
+      // The size of the gradient buckets that are all reduced as soon as their gradients are ready.
+      // 0 means all the gradients are all reduced together.
+      int64_t all_reduce_bucket_size_in_bytes{};
       // Whether to use NCCL.
       bool use_nccl{};
       // Whether to partition the optimizer state.
@@ -237,7 +240,8 @@ class TrainingSession : public InferenceSession {
       // Alternative for partition. We map each operator's string identifier to
       // a stage identifier. We identify operators using the name of any of
       // their outputs. All operators in the graph must be in the domain of this
-      // map.
+      // map. When both cut_list and this map are empty, the graph is split into
+      // stages of about the same size.
       std::map<std::string, int> op_id_to_stage;
 
       // The base path at which to save the intermediate partitioned input model (forward pass only).
@@ -144,8 +144,15 @@ void Accelerator::OrtRun(torch::jit::Stack& stack) {
   // Compile a callable to execute "subgraph_" on the inputs.
   // If such input schema appears before, we can reuse a cached compiled callable.
   torch::jit::CompleteArgumentSpec spec{false, inputs};
-  if (cache_.find(spec) == cache_.end()) {
-    cache_.emplace(spec, Compile(spec, inputs));
+  auto it = cache_.find(spec);
+  if (it == cache_.end()) {
+    // The same trace may have been compiled by another accelerator.
+    auto& compiled_object_cache = CompiledObjectCache::GetInstance();
+    auto compiled = compiled_object_cache.Find(trace_, spec);
+    if (!compiled) {
+      compiled = compiled_object_cache.Add(trace_, spec, Compile(spec, inputs));
+    }
+    it = cache_.emplace(spec, std::move(compiled)).first;
   }
 
   if (DumpInputsOutputs()) {
@@ -153,7 +160,7 @@ void Accelerator::OrtRun(torch::jit::Stack& stack) {
   }
 
   // Run the compiled function!
-  auto outputs = cache_[spec].code(inputs);
+  auto outputs = it->second->code(inputs);
 
   // Discard used inputs.
   torch::jit::drop(stack, inputs.size());
@@ -395,18 +402,36 @@ void Accelerator::ExampleRun(at::ArrayRef<c10::IValue> inputs) {
   }
 }
 
-CompiledObject Accelerator::Compile(
+std::shared_ptr<CompiledObject> CompiledObjectCache::Find(
+    const std::string& trace, const torch::jit::CompleteArgumentSpec& spec) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto trace_it = cache_.find(trace);
+  if (trace_it == cache_.end()) {
+    return nullptr;
+  }
+  auto spec_it = trace_it->second.find(spec);
+  return spec_it == trace_it->second.end() ? nullptr : spec_it->second;
+}
+
+std::shared_ptr<CompiledObject> CompiledObjectCache::Add(
+    const std::string& trace, const torch::jit::CompleteArgumentSpec& spec,
+    std::shared_ptr<CompiledObject> compiled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_[trace].emplace(spec, std::move(compiled)).first->second;
+}
+
+std::shared_ptr<CompiledObject> Accelerator::Compile(
     torch::jit::CompleteArgumentSpec spec, at::ArrayRef<c10::IValue>& args) {
   CheckArgs(args);
   DynamicSettings::GetInstance().SetOnnxFusionFlag(false);
   ExampleRun(args);
   DynamicSettings::GetInstance().SetOnnxFusionFlag(true);
   // Storage of compilation.
-  CompiledObject compiled;
+  auto compiled = std::make_shared<CompiledObject>();
   // Create an empty session.
-  compiled.sess = CreateSession();
+  compiled->sess = CreateSession();
   // Let's get the empty session and initialize it.
-  onnxruntime::InferenceSession& sess = *compiled.sess;
+  onnxruntime::InferenceSession& sess = *compiled->sess;
   // Export subgraph_ to ONNX.
   // The exporter should never fail. If it does, please modify
   // Accelerator::Supported to filter out unsupported operators.
@@ -432,11 +457,20 @@ CompiledObject Accelerator::Compile(
   // Duplicate device info for putting output tensors on the shared device.
   std::vector<OrtDevice> fetches_device_info(fetch_names.size(), shared_device);
 
+  // Whether each input of "subgraph_" is a tensor.
+  std::vector<bool> is_tensor_inputs;
+  for (auto input : subgraph_->inputs()) {
+    is_tensor_inputs.push_back(input->type()->kind() == c10::TypeKind::TensorType);
+  }
+
   // Create a callable which feeds inputs to ORT
   // session's Run(...) and returns outputs.
-  auto code = [this, run_options,
+  // It doesn't capture "this", because other accelerators
+  // may run it from CompiledObjectCache.
+  auto code = [run_options,
                feed_names, fetch_names,
-               fetches_device_info, &sess](at::ArrayRef<c10::IValue>& args) {
+               fetches_device_info, is_tensor_inputs,
+               output_types = output_types_, &sess](at::ArrayRef<c10::IValue>& args) {
     // Inputs of ORT session.
     std::vector<OrtValue> feeds;
     // Outputs of ORT session.
@@ -447,7 +481,7 @@ CompiledObject Accelerator::Compile(
       NvtxRange range("Prepare inputs");
 #endif
       // Prepare inputs.
-      const auto num_inputs = subgraph_->inputs().size();
+      const auto num_inputs = is_tensor_inputs.size();
       for (size_t i = 0; i < num_inputs; ++i) {
         // The value can be either tensor or scalar.
         // Scalar is a tensor with empty shape vector.
@@ -458,7 +492,7 @@ CompiledObject Accelerator::Compile(
           feeds.push_back(CreateOrtScalarValue(args.at(i).toScalar()));
         } else if (args.at(i).isTensor()) {
           // Tensor.
-          ORT_ENFORCE(subgraph_->inputs().at(i)->type()->kind() == c10::TypeKind::TensorType);
+          ORT_ENFORCE(is_tensor_inputs.at(i));
           feeds.push_back(CreateOrtTensorValue(args.at(i).toTensor()));
         } else {
           // Looks like LTC only passes scalars and tensors into backend, so we don't care
@@ -487,12 +521,12 @@ CompiledObject Accelerator::Compile(
       // Convert ORT output to Pytorch format.
       for (size_t i = 0; i < fetches.size(); ++i) {
         // Get the expected type of the i-th output.
-        const c10::TypePtr type = output_types_.at(i);
+        const c10::TypePtr type = output_types.at(i);
         // Convert ORTValue to IValue.
         if (type->isSubtypeOf(*c10::TensorType::get())) {
           ORT_ENFORCE(fetches.at(i).IsTensor(), "Only ORT tensor can be translated to Pytorch tensor.");
           auto value = CreateC10IvalueTensor(fetches.at(i));
-          auto expected_scalar_type = output_types_.at(i)->cast<c10::TensorType>()->scalarType().value();
+          auto expected_scalar_type = output_types.at(i)->cast<c10::TensorType>()->scalarType().value();
           outputs.push_back(value.toTensor().to(expected_scalar_type));
         } else if (type->isSubtypeOf(*c10::NumberType::get())) {
           // ORT represents scalar as tensor without shape.
@@ -508,7 +542,7 @@ CompiledObject Accelerator::Compile(
     return outputs;
   };
 
-  compiled.code = code;
+  compiled->code = code;
   return compiled;
 }
 }  // namespace lazytensor
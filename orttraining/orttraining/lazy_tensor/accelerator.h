@@ -1,6 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/runtime/argument_spec.h>
 #include "core/session/inference_session.h"
@@ -18,13 +23,38 @@ struct CompiledObject {
   std::unique_ptr<onnxruntime::InferenceSession> sess;
 };
 
+// Compiled results shared by all accelerators. They are keyed by the text of the traced subgraph
+// and then by the input schema, so a trace recurring in another JIT graph replays the session
+// compiled the first time, instead of being exported and optimized again.
+class CompiledObjectCache {
+ public:
+  static CompiledObjectCache& GetInstance() {
+    static CompiledObjectCache instance;
+    return instance;
+  }
+  // Return the compiled result of "trace" for "spec", or nullptr if it hasn't been compiled yet.
+  std::shared_ptr<CompiledObject> Find(const std::string& trace, const torch::jit::CompleteArgumentSpec& spec);
+  // Cache "compiled" unless another thread compiled the same trace first,
+  // and return the cached result.
+  std::shared_ptr<CompiledObject> Add(const std::string& trace, const torch::jit::CompleteArgumentSpec& spec,
+                                      std::shared_ptr<CompiledObject> compiled);
+
+ private:
+  CompiledObjectCache() = default;
+  std::mutex mutex_;
+  std::unordered_map<std::string,
+                     std::unordered_map<torch::jit::CompleteArgumentSpec, std::shared_ptr<CompiledObject>>>
+      cache_;
+};
+
 // Custom JIT engine called by Pytorch.
 class Accelerator {
  public:
   Accelerator(const torch::jit::Node* node)
       : subgraph_(node->g(torch::jit::attr::Subgraph)),
         input_types_(subgraph_->inputs().size()),
-        output_types_(subgraph_->outputs().size()) {}
+        output_types_(subgraph_->outputs().size()),
+        trace_(subgraph_->toString(false)) {}
   // Execute a call to the torch::jit::Graph represented by "subgraph_".
   // This function could compile the graph and cache the result
   // for repeated uses.
@@ -47,12 +77,12 @@ class Accelerator {
   void PytorchRun(torch::jit::Stack& stack);
   // Create callable to execute "subgraph_" given "args" as inputs.
   // This calllable is cached for repeated uses.
-  CompiledObject Compile(
+  std::shared_ptr<CompiledObject> Compile(
       torch::jit::CompleteArgumentSpec spec, at::ArrayRef<c10::IValue>& args);
   // The graph to be compiled and executed by ORT.
   std::shared_ptr<torch::jit::Graph> subgraph_;
-  // Previously compiled results.
-  std::unordered_map<torch::jit::CompleteArgumentSpec, CompiledObject> cache_;
+  // Previously compiled results, also stored in CompiledObjectCache.
+  std::unordered_map<torch::jit::CompleteArgumentSpec, std::shared_ptr<CompiledObject>> cache_;
   // Types of the inputs (typed to IValue) we got when compile the subgraph.
   // Since the subgraph is compiled for these type, feeding
   // inputs with different types may fail.
@@ -60,6 +90,8 @@ class Accelerator {
   // Types of the outputs (typed to IValue) by running the subgraph with
   // torch::jit::GraphExecutor.
   std::vector<c10::TypePtr> output_types_;
+  // Text of "subgraph_", the key of its compiled results in CompiledObjectCache.
+  std::string trace_;
 };
 }  // namespace lazytensor
 }  // namespace onnxruntime
@@ -152,6 +152,8 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
       ("use_bfloat16", "Whether to use BFloat16 arithmetic on GPU.", cxxopts::value<bool>()->default_value("false"))
       ("enable_adasum", "Whether to use Adasum for allreduction.", cxxopts::value<bool>()->default_value("false"))
       ("allreduce_in_fp16", "Whether to do AllReduce in fp16. If false, AllReduce will be done in fp32", cxxopts::value<bool>()->default_value("true"))
+      ("allreduce_bucket_size_mb", "The size of the gradient buckets in MB. The AllReduce of a bucket starts as soon as "
+        "its gradients are ready. 0 does a single AllReduce of all the gradients.", cxxopts::value<int>()->default_value("0"))
       ("loss_scale", "Loss scaling, positive power of 2 values can improve fp16 convergence. "
         "Set it 0 to uses dynamic scaling; Other none-zero value will used as static scale",
         cxxopts::value<float>()->default_value("0.0"))
@@ -336,6 +338,7 @@ Status ParseArguments(int argc, char* argv[], BertParameters& params, OrtParamet
     params.use_mixed_precision = flags["use_mixed_precision"].as<bool>();
     params.use_bfloat16 = flags["use_bfloat16"].as<bool>();
     params.allreduce_in_mixed_precision_type = flags["allreduce_in_fp16"].as<bool>() && params.use_mixed_precision;
+    params.allreduce_bucket_size_in_bytes = static_cast<int64_t>(flags["allreduce_bucket_size_mb"].as<int>()) * 1024 * 1024;
     if (params.use_mixed_precision) {
       printf("Mixed precision training is enabled.\n");
     }
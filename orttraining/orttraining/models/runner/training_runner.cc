@@ -152,6 +152,7 @@ Status TrainingRunner::Initialize() {
     opt.weight_int_attributes_generator = params_.optimizer_int_attributes;
     opt.use_mixed_precision_moments = params_.use_mixed_precision_moments;
     opt.do_all_reduce_in_mixed_precision_type = params_.allreduce_in_mixed_precision_type;
+    opt.all_reduce_bucket_size_in_bytes = params_.allreduce_bucket_size_in_bytes;
     opt.use_nccl = params_.use_nccl;
     opt.deepspeed_zero = params_.deepspeed_zero;
     opt.adasum_reduction_type = params_.GetAdasumReductionType();
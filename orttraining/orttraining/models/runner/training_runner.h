@@ -111,6 +111,8 @@ class TrainingRunner {
     bool use_mixed_precision_moments = false;
     bool use_mixed_precision_initializer = true;
     bool allreduce_in_mixed_precision_type = false;
+    // The size of the gradient buckets for AllReduce, 0 means a single bucket.
+    int64_t allreduce_bucket_size_in_bytes = 0;
     bool layernorm_stash_as_fp32 = true;
 
     // GIST configuration
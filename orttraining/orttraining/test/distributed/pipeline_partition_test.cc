@@ -56,6 +56,43 @@ TEST(PipelinePartition, DropoutGraph2stages) {
   EXPECT_EQ(graph.NumberOfNodes(), 6);
 }
 
+TEST(PipelinePartition, DropoutGraph2stagesBalanced) {
+  const int num_stages = 2;
+
+  const auto& log_manager = DefaultLoggingManager();
+  const auto& default_logger = log_manager.DefaultLogger();
+  const auto model_path = ORT_TSTR("testdata/transform/dropout.onnx");
+
+  std::shared_ptr<Model> pModel;
+  auto status = Model::Load(model_path, pModel, nullptr, default_logger);
+  EXPECT_TRUE(status.IsOK()) << "Failed to load model. Error: "
+                             << status.ErrorMessage();
+  auto& graph = pModel->MainGraph();
+  const int num_nodes = graph.NumberOfNodes();
+
+  std::map<const Node*, int> op_to_stage = {};
+  status = GetBalancedDeviceAssignmentMap(graph, op_to_stage, num_stages);
+  ASSERT_TRUE(status.IsOK()) << "Failed to get stage map. Error: "
+                             << status.ErrorMessage();
+  ASSERT_EQ(static_cast<int>(op_to_stage.size()), num_nodes);
+
+  // Both stages are used and edges always go forward.
+  int stage_0_nodes = 0;
+  for (const auto& [node, stage] : op_to_stage) {
+    stage_0_nodes += stage == 0 ? 1 : 0;
+    for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+      EXPECT_LE(stage, op_to_stage.at(&*it));
+    }
+  }
+  EXPECT_GT(stage_0_nodes, 0);
+  EXPECT_LT(stage_0_nodes, num_nodes);
+
+  std::vector<int32_t> rank_ids = {0, 1};
+  status = ApplyPipelinePartitionToMainGraph(graph, op_to_stage, 1, num_stages, rank_ids);
+  EXPECT_TRUE(status.IsOK()) << "Failed to apply partition. Error: "
+                             << status.ErrorMessage();
+}
+
 void LoadAndPartitionWithCuts(const PathString& model_path,
                               int num_stages,
                               int pipeline_stage_id,
@@ -92,6 +92,57 @@ TEST(MemoryOptimizerTests, GeluRecompute) {
   ASSERT_EQ(original_gelu_node->Priority(), static_cast<int>(ExecutionPriority::DEFAULT));
 }
 
+TEST(MemoryOptimizerTests, GeluOffload) {
+  const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
+  auto model_uri = MODEL_FOLDER "recompute_gelu.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, *logger));
+  Graph& graph = model->MainGraph();
+
+  // Only the activations on devices are offloaded.
+  Node* gelu_node{nullptr};
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+    if (node.OpType().compare("Gelu") == 0) {
+      gelu_node = &node;
+    }
+  }
+  ASSERT_NE(gelu_node, nullptr);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+
+  const std::string alleviation_config("Gelu+:3:-1");
+  const std::string probe_config("1:0:1");
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+      std::make_unique<MemoryOptimizer>(alleviation_config, probe_config), TransformerLevel::Level3));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3, *logger));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["com.microsoft.Gelu"] == 1);
+  ASSERT_TRUE(op_to_count["MemcpyToHost"] == 1);
+  ASSERT_TRUE(op_to_count["MemcpyFromHost"] == 1);
+
+  Node* offload_node{nullptr};
+  Node* reload_node{nullptr};
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType().compare("MemcpyToHost") == 0) {
+      offload_node = &node;
+    } else if (node.OpType().compare("MemcpyFromHost") == 0) {
+      reload_node = &node;
+    }
+  }
+
+  ASSERT_EQ(offload_node->InputDefs()[0]->Name(), gelu_node->OutputDefs()[0]->Name());
+  ASSERT_EQ(reload_node->InputDefs()[0]->Name(), offload_node->OutputDefs()[0]->Name());
+
+  // The backward pass consumers read the reloaded activation.
+  ASSERT_GT(reload_node->GetOutputEdgesCount(), 0u);
+  ASSERT_EQ(offload_node->Priority(), static_cast<int>(ExecutionPriority::DEFAULT));
+  ASSERT_EQ(reload_node->Priority(), static_cast<int>(ExecutionPriority::LOCAL_LOW));
+  ASSERT_EQ(reload_node->GetExecutionProviderType(), kCudaExecutionProvider);
+}
+
 TEST(MemoryOptimizerTests, TileRecompute) {
   const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
   auto model_uri = MODEL_FOLDER "recompute_tile.onnx";
@@ -312,5 +363,21 @@ TEST(MemoryOptimizerTests, TransformerPerLayerRecompute) {
   }
 }
 
+TEST(MemoryOptimizerTests, ParseMemoryBudgetConfig) {
+  optimizer::memory_optimizer::MemoryBudgetConfig budget_config;
+  ASSERT_STATUS_OK(optimizer::memory_optimizer::ParseMemoryBudgetConfigFromString("512,batch=32,seq_len=128",
+                                                                                  budget_config));
+  ASSERT_EQ(budget_config.bytes_to_save, int64_t{512} * 1024 * 1024);
+  ASSERT_EQ(budget_config.dim_values.size(), 2u);
+  ASSERT_EQ(budget_config.dim_values.at("batch"), 32);
+  ASSERT_EQ(budget_config.dim_values.at("seq_len"), 128);
+
+  ASSERT_STATUS_OK(optimizer::memory_optimizer::ParseMemoryBudgetConfigFromString("", budget_config));
+  ASSERT_EQ(budget_config.bytes_to_save, 0);
+  ASSERT_TRUE(budget_config.dim_values.empty());
+
+  ASSERT_FALSE(optimizer::memory_optimizer::ParseMemoryBudgetConfigFromString("512,batch", budget_config).IsOK());
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(GistOpTest, Pack1Encoder_float) {
+  OpTester test("GistPack1Encoder", 1, kMSDomain);
+  test.AddInput<float>("X", {2, 5}, {1.0f, 0.0f, 2.0f, -1.0f, 0.5f, 0.0f, 0.0f, 3.0f, -2.0f, 4.0f});
+  // The last byte is padded with zeros, the CUDA kernel reads past the input for it instead.
+  test.AddOutput<uint8_t>("Y", {2}, {0xA9, 0x40});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCudaExecutionProvider});
+}
+
+TEST(GistOpTest, Pack1Decoder_bool) {
+  OpTester test("GistPack1Decoder", 1, kMSDomain);
+  test.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_BOOL));
+  test.AddInput<uint8_t>("X", {2}, {0xA9, 0x40});
+  test.AddOutput<bool>("Y", {16}, {true, false, true, false, true, false, false, true,
+                                   false, true, false, false, false, false, false, false});
+  test.Run();
+}
+
+TEST(GistOpTest, Pack16Decoder_float) {
+  OpTester test("GistPack16Decoder", 1, kMSDomain);
+  test.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  test.AddInput<MLFloat16>("X", {3}, {MLFloat16(1.5f), MLFloat16(-2.0f), MLFloat16(0.0f)});
+  test.AddOutput<float>("Y", {3}, {1.5f, -2.0f, 0.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -416,6 +416,42 @@ Status FromPropertyBag(const PropertyBag& property_bag, flatbuffers::FlatBufferB
   return Status::OK();
 }
 
+/**
+ * @brief Estimate the size of the checkpoint flatbuffer from the size of its tensors, aligned to 1MB.
+ *
+ * The flatbuffer builder doubles its buffer when it runs out of space, copying what was built so far. Starting
+ * with a buffer that fits all the tensors avoids these copies, and the peak memory of holding both buffers.
+ *
+ * @param state parameter/optimizer and other user defined training states.
+ * @param include_optimizer_state Whether to include optimizer state in the checkpoint.
+ * @return The estimated size in bytes.
+ */
+size_t EstimateCheckpointSize(const CheckpointState& state, const bool include_optimizer_state) {
+  const auto tensor_size = [](const OrtValue& value) -> size_t {
+    return value.IsTensor() && value.IsAllocated() ? value.Get<Tensor>().SizeInBytes() : 0U;
+  };
+
+  size_t size = 0U;
+  for (const auto& [name, param] : state.module_checkpoint_state.named_parameters) {
+    size += tensor_size(param->Data());
+  }
+
+  if (include_optimizer_state) {
+    for (const auto& [group_name, group_optimizer_state] :
+         state.optimizer_checkpoint_state.group_named_optimizer_states) {
+      for (const auto& [param_name, param_optimizer_state] : group_optimizer_state->param_named_optimizer_states) {
+        for (const auto& [momentum_name, momentum] : param_optimizer_state) {
+          size += tensor_size(momentum);
+        }
+      }
+    }
+  }
+
+  constexpr size_t m_bytes = 1024 * 1024;
+  size = std::max(size, m_bytes);
+  return ((size + m_bytes - 1) / m_bytes) * m_bytes;
+}
+
 /**
  * @brief Save from a checkpoint state to a checkpoint file.
  *
@@ -426,7 +462,7 @@ Status FromPropertyBag(const PropertyBag& property_bag, flatbuffers::FlatBufferB
  */
 Status FromCheckpointState(
     const CheckpointState& state, const PathString& checkpoint_path, const bool include_optimizer_state) {
-  flatbuffers::FlatBufferBuilder builder(1024);
+  flatbuffers::FlatBufferBuilder builder(EstimateCheckpointSize(state, include_optimizer_state));
 
   // Write weight tensors files.
   flatbuffers::Offset<fbs::ModuleState> module_state;
@@ -460,22 +496,25 @@ namespace load {
 
 /**
  * @brief Load checkpoint flatbuffer from file.
+ *
+ * The file is mapped into memory instead of being read into a buffer, so its pages are only loaded when the
+ * tensors are copied out of the flatbuffer, and they don't add to the memory of the process once they are.
+ *
  * @param checkpoint_path Path to the checkpoint file.
+ * @param checkpoint_memory Memory mapping of the checkpoint file, which must outlive checkpoint_bytes.
  * @param checkpoint_bytes Contents of the checkpoint file in bytes.
- * @param checkpoint_span Checkpoint bytes represented as a span.
  * @return Status of the operation.
  *
  */
-Status FromFile(const PathString& checkpoint_path, InlinedVector<uint8_t>& checkpoint_bytes) {
+Status FromFile(const PathString& checkpoint_path, Env::MappedMemoryPtr& checkpoint_memory,
+                gsl::span<const uint8_t>& checkpoint_bytes) {
   size_t num_bytes = 0;
   ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(checkpoint_path.c_str(), num_bytes));
-  checkpoint_bytes.resize(num_bytes);
-
-  std::ifstream bytes_stream(checkpoint_path, std::ifstream::in | std::ifstream::binary);
-  bytes_stream.read(reinterpret_cast<char*>(checkpoint_bytes.data()), num_bytes);
+  ORT_RETURN_IF_NOT(num_bytes > 0, "Loading checkpoint from ", ToUTF8String(checkpoint_path),
+                    " failed. The file is empty.");
 
-  ORT_RETURN_IF_NOT(bytes_stream, "Loading checkpoint from ", ToUTF8String(checkpoint_path), " failed. Only ",
-                    bytes_stream.gcount(), "/", num_bytes, " bytes could be read.");
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(checkpoint_path.c_str(), 0, num_bytes, checkpoint_memory));
+  checkpoint_bytes = gsl::make_span(reinterpret_cast<const uint8_t*>(checkpoint_memory.get()), num_bytes);
 
   return Status::OK();
 }
@@ -764,8 +803,9 @@ Status SaveCheckpoint(const CheckpointState& states, const PathString& checkpoin
 Status LoadCheckpoint(const PathString& checkpoint_path, CheckpointState& checkpoint_states) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
-  InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
+  Env::MappedMemoryPtr checkpoint_memory;
+  gsl::span<const uint8_t> checkpoint_bytes;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_memory, checkpoint_bytes));
   return load::ToCheckpointState(checkpoint_bytes, checkpoint_states);
 }
 
@@ -780,8 +820,9 @@ Status LoadCheckpointToModel(const PathString& checkpoint_path,
                              ONNX_NAMESPACE::ModelProto& model_proto) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
-  InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
+  Env::MappedMemoryPtr checkpoint_memory;
+  gsl::span<const uint8_t> checkpoint_bytes;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_memory, checkpoint_bytes));
   return load::ToModelProto(checkpoint_bytes, model_proto);
 }
 #endif
@@ -3,6 +3,9 @@
 
 #include "gistdecode_op.h"
 
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
 namespace onnxruntime {
 namespace contrib {
 ONNX_OPERATOR_KERNEL_EX(
@@ -14,7 +17,7 @@ ONNX_OPERATOR_KERNEL_EX(
     GistBinarizeDecoderOp);
 
 Status GistBinarizeDecoderOp::Compute(OpKernelContext* context) const {
-  const auto* X = context->Input<Tensor>(1);
+  const auto* X = context->Input<Tensor>(0);
   ORT_ENFORCE(X != nullptr);
   const TensorShape& shape = X->Shape();
   Tensor* Y = context->Output(0, shape);
@@ -26,5 +29,66 @@ Status GistBinarizeDecoderOp::Compute(OpKernelContext* context) const {
 
   return Status::OK();
 }
+
+#define REGISTER_KERNEL_TYPED_PACK1_DEC(T)                                                 \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                           \
+      GistPack1Decoder,                                                                    \
+      kMSDomain,                                                                           \
+      1,                                                                                   \
+      T,                                                                                   \
+      kCpuExecutionProvider,                                                               \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),            \
+      GistPack1DecoderOp<T>);
+
+REGISTER_KERNEL_TYPED_PACK1_DEC(bool)
+REGISTER_KERNEL_TYPED_PACK1_DEC(float)
+
+template <typename T>
+Status GistPack1DecoderOp<T>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_RETURN_IF(X == nullptr, "X input is unavailable");
+
+  const int64_t packed_count = X->Shape().Size();
+  Tensor* Y = context->Output(0, TensorShape({packed_count * GIST_PACK1_FACTOR}));
+  const uint8_t* src = X->template Data<uint8_t>();
+  T* dst = Y->template MutableData<T>();
+
+  const TensorOpCost cost{1.0, static_cast<double>(sizeof(T) * GIST_PACK1_FACTOR),
+                          static_cast<double>(2 * GIST_PACK1_FACTOR)};
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), packed_count, cost,
+      [src, dst](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const uint8_t in = src[i];
+          T* out = dst + i * GIST_PACK1_FACTOR;
+          for (int j = 0; j < GIST_PACK1_FACTOR; ++j) {
+            out[j] = static_cast<T>((in >> (GIST_PACK1_FACTOR - 1 - j)) & 1);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GistPack16Decoder,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack16DecoderOp<float>);
+
+template <typename T>
+Status GistPack16DecoderOp<T>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_RETURN_IF(X == nullptr, "X input is unavailable");
+
+  Tensor* Y = context->Output(0, X->Shape());
+  MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(X->template Data<MLFloat16>()),
+                               Y->template MutableData<T>(), static_cast<size_t>(X->Shape().Size()));
+
+  return Status::OK();
+}
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -15,5 +15,20 @@ class GistBinarizeDecoderOp final : public OpKernel {
   GistBinarizeDecoderOp(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 };
+
+template <typename T>
+class GistPack1DecoderOp final : public OpKernel {
+ public:
+  static constexpr int GIST_PACK1_FACTOR = 8;
+  GistPack1DecoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+template <typename T>
+class GistPack16DecoderOp final : public OpKernel {
+ public:
+  GistPack16DecoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -3,6 +3,10 @@
 
 #include "gistencode_op.h"
 
+#include <algorithm>
+
+#include "core/platform/threadpool.h"
+
 namespace onnxruntime {
 namespace contrib {
 ONNX_OPERATOR_KERNEL_EX(
@@ -10,7 +14,7 @@ ONNX_OPERATOR_KERNEL_EX(
     kMSDomain,
     1,
     kCpuExecutionProvider,
-    KernelDefBuilder().Alias(0, 0).TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::AllTensorTypes()),
     GistBinarizeEncoderOp);
 
 Status GistBinarizeEncoderOp::Compute(OpKernelContext* context) const {
@@ -18,16 +22,87 @@ Status GistBinarizeEncoderOp::Compute(OpKernelContext* context) const {
   ORT_ENFORCE(X != nullptr);
   const TensorShape& shape = X->Shape();
   Tensor* Y = context->Output(0, shape);
-  Tensor* Y1 = context->Output(1, shape);
-  auto X_type = X->DataType();
   auto* src = X->template Data<float>();
-  auto* dst = Y1->template MutableData<bool>();
+  auto* dst = Y->template MutableData<bool>();
   for (int64_t i = 0; i < X->Shape().Size(); ++i) {
     dst[i] = src[i] > 0.0;
   }
 
-  void* target = Y->MutableDataRaw(X_type);
-  ORT_ENFORCE(target != nullptr);
+  return Status::OK();
+}
+
+#define REGISTER_KERNEL_TYPED_PACK1_ENC(T)                                                 \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                           \
+      GistPack1Encoder,                                                                    \
+      kMSDomain,                                                                           \
+      1,                                                                                   \
+      T,                                                                                   \
+      kCpuExecutionProvider,                                                               \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),            \
+      GistPack1EncoderOp<T>);
+
+REGISTER_KERNEL_TYPED_PACK1_ENC(bool)
+REGISTER_KERNEL_TYPED_PACK1_ENC(float)
+
+template <typename T>
+Status GistPack1EncoderOp<T>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_RETURN_IF(X == nullptr, "X input is unavailable");
+
+  // Same layout as the CUDA kernel: the first element of each group of 8 goes to the most significant bit.
+  const int64_t count = X->Shape().Size();
+  const int64_t packed_count = (count + GIST_PACK1_FACTOR - 1) / GIST_PACK1_FACTOR;
+  Tensor* Y = context->Output(0, TensorShape({packed_count}));
+  const T* src = X->template Data<T>();
+  uint8_t* dst = Y->template MutableData<uint8_t>();
+
+  const TensorOpCost cost{static_cast<double>(sizeof(T) * GIST_PACK1_FACTOR), 1.0,
+                          static_cast<double>(2 * GIST_PACK1_FACTOR)};
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), packed_count, cost,
+      [src, dst, count](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const int64_t first = i * GIST_PACK1_FACTOR;
+          const int64_t n = std::min<int64_t>(GIST_PACK1_FACTOR, count - first);
+          uint8_t out = 0;
+          for (int64_t j = 0; j < n; ++j) {
+            out = static_cast<uint8_t>(out | ((src[first + j] > T{0} ? 1 : 0) << (GIST_PACK1_FACTOR - 1 - j)));
+          }
+
+          dst[i] = out;
+        }
+      });
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GistPack16Encoder,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    GistPack16EncoderOp<float>);
+
+template <typename T>
+Status GistPack16EncoderOp<T>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  ORT_RETURN_IF(X == nullptr, "X input is unavailable");
+
+  Tensor* Y = context->Output(0, X->Shape());
+  const T* src = X->template Data<T>();
+  MLFloat16* dst = Y->template MutableData<MLFloat16>();
+
+  const TensorOpCost cost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(MLFloat16)), 4.0};
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), X->Shape().Size(), cost,
+      [src, dst](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          dst[i] = MLFloat16(static_cast<float>(src[i]));
+        }
+      });
+
   return Status::OK();
 }
 }  // namespace contrib
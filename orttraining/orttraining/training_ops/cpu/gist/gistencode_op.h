@@ -14,5 +14,20 @@ class GistBinarizeEncoderOp final : public OpKernel {
   GistBinarizeEncoderOp(const OpKernelInfo& info) : OpKernel(info) {}
   Status Compute(OpKernelContext* context) const override;
 };
+
+template <typename T>
+class GistPack1EncoderOp final : public OpKernel {
+ public:
+  static constexpr int GIST_PACK1_FACTOR = 8;
+  GistPack1EncoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+template <typename T>
+class GistPack16EncoderOp final : public OpKernel {
+ public:
+  GistPack16EncoderOp(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
 }  // namespace contrib
 }  // namespace onnxruntime
\ No newline at end of file
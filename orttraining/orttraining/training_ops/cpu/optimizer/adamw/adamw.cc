@@ -90,46 +90,56 @@ ONNX_OPERATOR_KERNEL_EX(
     AdamWOptimizer<float>);
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float alpha_correction, float beta_correction) const {
-  // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (MakeEigenArrayMap<T>(weight) * lr * weight_decay_);
-
-  // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
-
-  // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
-
-  // Compute the new weight.
-  auto denom = (MakeEigenArrayMap<T>(momentums_2) / beta_correction).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr * MakeEigenArrayMap<T>(momentums_1)) / (alpha_correction * denom);
-
-  return Status::OK();
+void AdamWOptimizer<T>::AdamWComputeMode0(T* weight_data, const T* gradient_data, T* momentums_1_data,
+                                          T* momentums_2_data, std::ptrdiff_t count,
+                                          float lr, float alpha_correction, float beta_correction) const {
+  // the blocks are small enough for the values to stay in cache between the steps of the update, so the
+  // elements are read and written once from memory
+  for (std::ptrdiff_t block_begin = 0; block_begin < count; block_begin += kBlockSize) {
+    const std::ptrdiff_t block_size = std::min(kBlockSize, count - block_begin);
+    EigenVectorArrayMap<T> weight(weight_data + block_begin, block_size);
+    ConstEigenVectorArrayMap<T> gradient(gradient_data + block_begin, block_size);
+    EigenVectorArrayMap<T> momentums_1(momentums_1_data + block_begin, block_size);
+    EigenVectorArrayMap<T> momentums_2(momentums_2_data + block_begin, block_size);
+
+    // Perform weight decay.
+    weight = weight - (weight * lr * weight_decay_);
+
+    // Compute exponentially-averaged historical gradient.
+    momentums_1 = alpha_ * momentums_1 + (1.f - alpha_) * gradient;
+
+    // Compute exponentially-averaged historical squared gradient.
+    momentums_2 = beta_ * momentums_2 + (1.f - beta_) * gradient * gradient;
+
+    // Compute the new weight.
+    auto denom = (momentums_2 / beta_correction).sqrt() + epsilon_;
+    weight = weight - (lr * momentums_1) / (alpha_correction * denom);
+  }
 }
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float lr_corrected) const {
-  // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
-
-  // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
-
-  auto denom = MakeEigenArrayMap<T>(momentums_2).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr_corrected * MakeEigenArrayMap<T>(momentums_1) / denom);
-
-  // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (lr * weight_decay_ * MakeEigenArrayMap<T>(weight));
-
-  return Status::OK();
+void AdamWOptimizer<T>::AdamWComputeMode1(T* weight_data, const T* gradient_data, T* momentums_1_data,
+                                          T* momentums_2_data, std::ptrdiff_t count,
+                                          float lr, float lr_corrected) const {
+  for (std::ptrdiff_t block_begin = 0; block_begin < count; block_begin += kBlockSize) {
+    const std::ptrdiff_t block_size = std::min(kBlockSize, count - block_begin);
+    EigenVectorArrayMap<T> weight(weight_data + block_begin, block_size);
+    ConstEigenVectorArrayMap<T> gradient(gradient_data + block_begin, block_size);
+    EigenVectorArrayMap<T> momentums_1(momentums_1_data + block_begin, block_size);
+    EigenVectorArrayMap<T> momentums_2(momentums_2_data + block_begin, block_size);
+
+    // Compute exponentially-averaged historical gradient.
+    momentums_1 = alpha_ * momentums_1 + (1.f - alpha_) * gradient;
+
+    // Compute exponentially-averaged historical squared gradient.
+    momentums_2 = beta_ * momentums_2 + (1.f - beta_) * gradient * gradient;
+
+    auto denom = momentums_2.sqrt() + epsilon_;
+    weight = weight - (lr_corrected * momentums_1 / denom);
+
+    // Perform weight decay.
+    weight = weight - (lr * weight_decay_ * weight);
+  }
 }
 
 template <typename T>
@@ -165,22 +175,25 @@ Status AdamWOptimizer<T>::Compute(OpKernelContext* ctx) const {
     //         bias correction is applied on learning rate, then use lr_corrected for subsequent computations.
     //         weight decay is applied after weight is updated.
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-      Tensor& momentums_1 = const_cast<Tensor&>(p.momentums_1->Get(weight_index));
-      Tensor& momentums_2 = const_cast<Tensor&>(p.momentums_2->Get(weight_index));
-
-      if (adam_mode_ == 0) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, lr, alpha_correction, beta_correction));
-      } else if (adam_mode_ == 1) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, lr, lr_corrected));
-      } else {
-        ORT_THROW("Unsupported Adamw optimizer mode.");
-      }
-    }
+    // All the weights are updated in a single parallel pass, see MultiTensorApply.
+    // Each element loads the weight, the gradient and the momentums, and stores the weight and the momentums.
+    const TensorOpCost cost{static_cast<double>(4 * sizeof(T)), static_cast<double>(3 * sizeof(T)), 16.0};
+    MultiTensorApply(
+        ctx->GetOperatorThreadPool(), p.grouped_tensor_sizes, cost,
+        [&](size_t weight_index, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          const auto& pointers = p.grouped_tensor_pointers[weight_index];
+          T* weight = static_cast<T*>(pointers[0]) + begin;
+          const T* gradient = static_cast<const T*>(pointers[1]) + begin;
+          T* momentums_1 = static_cast<T*>(pointers[2]) + begin;
+          T* momentums_2 = static_cast<T*>(pointers[3]) + begin;
+
+          if (adam_mode_ == 0) {
+            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, end - begin, lr, alpha_correction,
+                              beta_correction);
+          } else {
+            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, end - begin, lr, lr_corrected);
+          }
+        });
 
     *updated_flag_ptr = true;
   } else {
@@ -5,6 +5,8 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include <algorithm>
 #include <cmath>
 
 namespace onnxruntime {
@@ -19,6 +21,34 @@ TC compute_bias_correction_coefficient(const TC momentum_update_coefficient, con
   }
 }
 
+// Calls fn(tensor_index, begin, end) on ranges of the elements of a group of tensors, processed in parallel as if the
+// tensors were a single flat buffer. This is the CPU counterpart of the multi tensor apply of the CUDA optimizers: the
+// update of all the tensors is one pass over memory that uses all the threads, whatever the number and the sizes of
+// the tensors. A range never spans two tensors.
+template <typename Fn>
+void MultiTensorApply(concurrency::ThreadPool* tp, const std::vector<int>& tensor_sizes,
+                      const TensorOpCost& cost_per_element, const Fn& fn) {
+  std::vector<std::ptrdiff_t> offsets(tensor_sizes.size() + 1, 0);
+  for (size_t i = 0; i < tensor_sizes.size(); ++i) {
+    offsets[i + 1] = offsets[i] + tensor_sizes[i];
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, offsets.back(), cost_per_element, [&offsets, &fn](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        // the last tensor that starts at or before begin, which skips the empty tensors
+        auto it = std::upper_bound(offsets.cbegin(), offsets.cend(), begin);
+        size_t index = static_cast<size_t>(it - offsets.cbegin()) - 1;
+        while (begin < end) {
+          const std::ptrdiff_t range_end = std::min(end, offsets[index + 1]);
+          if (range_end > begin) {
+            fn(index, begin - offsets[index], range_end - offsets[index]);
+            begin = range_end;
+          }
+          ++index;
+        }
+      });
+}
+
 Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values, const TensorSeq* src_values,
                               TensorSeq* dest_values);
 